@@ -16,13 +16,20 @@
 
 #include "Announce.h"
 
-#ifdef USE_MPI
+#if defined(USE_MPI) || defined(TEMPEST_MPIOMP)
 #include <mpi.h>
 #endif
 
 #include <cstdio>
+#include <cstdlib>
 #include <cstring>
 #include <cstdarg>
+#include <map>
+#include <string>
+#include <vector>
+
+#include <sys/resource.h>
+#include <sys/time.h>
 
 ///////////////////////////////////////////////////////////////////////////////
 
@@ -60,44 +67,654 @@ static bool s_fBlockFlag = false;
 
 ///////////////////////////////////////////////////////////////////////////////
 
+///	<summary>
+///		Flag indicating whether announcements are written to stdout.
+///	</summary>
+static bool s_fOutputEnabled = true;
+
+///	<summary>
+///		Flag indicating whether the calling thread is silenced.
+///	</summary>
+static thread_local bool t_fThreadSilenced = false;
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Write formatted text to stdout if output is enabled.
+///	</summary>
+static void AnnouncePrintf(const char * szFormat, ...) {
+	if (!s_fOutputEnabled) {
+		return;
+	}
+
+	va_list arguments;
+	va_start(arguments, szFormat);
+	vprintf(szFormat, arguments);
+	va_end(arguments);
+}
+
+#if defined(USE_MPI) || defined(TEMPEST_MPIOMP)
+///	<summary>
+///		Returns true if MPI has not been initialized or this is the root
+///		processor of MPI_COMM_WORLD.
+///	</summary>
+static bool AnnounceIsRootRank() {
+	int fInitialized;
+	MPI_Initialized(&fInitialized);
+
+	if (!fInitialized) {
+		return true;
+	}
+
+	// Retrieve the rank of this processor
+	int nRank;
+
+	MPI_Comm_rank(MPI_COMM_WORLD, &nRank);
+
+	return (nRank == 0);
+}
+#endif
+
+///////////////////////////////////////////////////////////////////////////////
+// Profiling
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Flag indicating whether announcement blocks are profiled.
+///	</summary>
+static bool s_fProfilingEnabled = false;
+
+///	<summary>
+///		A profiled announcement block.
+///	</summary>
+struct AnnounceProfileBlock {
+
+	///	<summary>
+	///		Name of the block.
+	///	</summary>
+	std::string strName;
+
+	///	<summary>
+	///		Index of the enclosing block, or -1.
+	///	</summary>
+	int iParent;
+
+	///	<summary>
+	///		Wall and process CPU time at the beginning and end of the block
+	///		(in seconds).
+	///	</summary>
+	double dWallBegin;
+	double dWallEnd;
+	double dCPUBegin;
+	double dCPUEnd;
+
+	///	<summary>
+	///		Peak resident set size at the beginning and end of the block
+	///		(in kilobytes).
+	///	</summary>
+	long lPeakRSSBegin;
+	long lPeakRSSEnd;
+
+	///	<summary>
+	///		Counter totals at the beginning of the block, replaced by the
+	///		change in each counter when the block ends.
+	///	</summary>
+	std::vector<long long> vecCounts;
+};
+
+///	<summary>
+///		Counts accumulated by a single thread.
+///	</summary>
+struct AnnounceProfileThreadStore {
+
+	///	<summary>
+	///		Count of each counter.
+	///	</summary>
+	std::vector<long long> vecCounts;
+};
+
+///	<summary>
+///		All profiled blocks, in order of their beginning.
+///	</summary>
+static std::vector<AnnounceProfileBlock> s_vecProfileBlocks;
+
+///	<summary>
+///		Indices of the profiled blocks that are currently open.
+///	</summary>
+static std::vector<int> s_vecProfileOpenBlocks;
+
+///	<summary>
+///		Wall time at which profiling was first enabled.
+///	</summary>
+static double s_dProfileWallOrigin = -1.0;
+
+///	<summary>
+///		Output file for the profile at exit.
+///	</summary>
+static std::string s_strProfileOutput;
+
+///	<summary>
+///		Names of the registered counters.  Counters may be registered
+///		during static initialization of other translation units and the
+///		names are needed when the profile is written at exit, so the
+///		vector is never destroyed.
+///	</summary>
+static std::vector<std::string> & AnnounceProfileCounterNames() {
+	static std::vector<std::string> * s_pvecCounterNames =
+		new std::vector<std::string>;
+	return *s_pvecCounterNames;
+}
+
+///	<summary>
+///		The counter stores of all threads.  Stores are never released, so
+///		counts from threads that have exited are retained.
+///	</summary>
+static std::vector<AnnounceProfileThreadStore *> & AnnounceProfileThreadStores() {
+	static std::vector<AnnounceProfileThreadStore *> * s_pvecThreadStores =
+		new std::vector<AnnounceProfileThreadStore *>;
+	return *s_pvecThreadStores;
+}
+
+///	<summary>
+///		The counter store of the calling thread.
+///	</summary>
+static thread_local AnnounceProfileThreadStore * t_pProfileThreadStore = NULL;
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Wall time in seconds.
+///	</summary>
+static double AnnounceProfileWallTime() {
+	struct timeval tv;
+	gettimeofday(&tv, NULL);
+	return static_cast<double>(tv.tv_sec) + 1.0e-6 * static_cast<double>(tv.tv_usec);
+}
+
+///	<summary>
+///		Process CPU time (user and system, over all threads) in seconds and
+///		peak resident set size in kilobytes.
+///	</summary>
+static void AnnounceProfileResourceUsage(
+	double & dCPUTime,
+	long & lPeakRSS
+) {
+	struct rusage usage;
+	getrusage(RUSAGE_SELF, &usage);
+
+	dCPUTime =
+		  static_cast<double>(usage.ru_utime.tv_sec)
+		+ 1.0e-6 * static_cast<double>(usage.ru_utime.tv_usec)
+		+ static_cast<double>(usage.ru_stime.tv_sec)
+		+ 1.0e-6 * static_cast<double>(usage.ru_stime.tv_usec);
+
+#if defined(__APPLE__)
+	// ru_maxrss is reported in bytes on macOS
+	lPeakRSS = static_cast<long>(usage.ru_maxrss / 1024);
+#else
+	lPeakRSS = static_cast<long>(usage.ru_maxrss);
+#endif
+}
+
+///	<summary>
+///		Sum the counts of all threads.
+///	</summary>
+static void AnnounceProfileSumCounts(
+	std::vector<long long> & vecCounts
+) {
+#pragma omp critical(AnnounceProfile)
+	{
+		vecCounts.assign(AnnounceProfileCounterNames().size(), 0);
+
+		const std::vector<AnnounceProfileThreadStore *> & vecStores =
+			AnnounceProfileThreadStores();
+
+		for (size_t t = 0; t < vecStores.size(); t++) {
+			const std::vector<long long> & vecThreadCounts =
+				vecStores[t]->vecCounts;
+
+			for (size_t c = 0; c < vecThreadCounts.size(); c++) {
+				vecCounts[c] += vecThreadCounts[c];
+			}
+		}
+	}
+}
+
+///	<summary>
+///		Begin a profiled block.
+///	</summary>
+static void AnnounceProfileStartBlock(const char * szText) {
+	AnnounceProfileBlock block;
+	block.strName = (szText != NULL)?(szText):("(unnamed)");
+	block.iParent =
+		(s_vecProfileOpenBlocks.size() == 0)?(-1):(s_vecProfileOpenBlocks.back());
+	block.dWallEnd = 0.0;
+	block.dCPUEnd = 0.0;
+	block.lPeakRSSEnd = 0;
+
+	AnnounceProfileSumCounts(block.vecCounts);
+	AnnounceProfileResourceUsage(block.dCPUBegin, block.lPeakRSSBegin);
+	block.dWallBegin = AnnounceProfileWallTime();
+
+	s_vecProfileOpenBlocks.push_back(static_cast<int>(s_vecProfileBlocks.size()));
+	s_vecProfileBlocks.push_back(block);
+}
+
+///	<summary>
+///		End the innermost open profiled block.
+///	</summary>
+static void AnnounceProfileEndBlock() {
+	if (s_vecProfileOpenBlocks.size() == 0) {
+		return;
+	}
+
+	AnnounceProfileBlock & block =
+		s_vecProfileBlocks[s_vecProfileOpenBlocks.back()];
+
+	block.dWallEnd = AnnounceProfileWallTime();
+	AnnounceProfileResourceUsage(block.dCPUEnd, block.lPeakRSSEnd);
+
+	std::vector<long long> vecCounts;
+	AnnounceProfileSumCounts(vecCounts);
+
+	block.vecCounts.resize(vecCounts.size(), 0);
+	for (size_t c = 0; c < vecCounts.size(); c++) {
+		block.vecCounts[c] = vecCounts[c] - block.vecCounts[c];
+	}
+
+	s_vecProfileOpenBlocks.pop_back();
+}
+
+///	<summary>
+///		Close all open profiled blocks.
+///	</summary>
+static void AnnounceProfileCloseOpenBlocks() {
+	while (s_vecProfileOpenBlocks.size() != 0) {
+		AnnounceProfileEndBlock();
+	}
+}
+
+///	<summary>
+///		Write a string as a quoted JSON string.
+///	</summary>
+static void AnnounceProfileWriteJSONString(
+	FILE * fp,
+	const std::string & str
+) {
+	fputc('"', fp);
+	for (size_t i = 0; i < str.length(); i++) {
+		const unsigned char c = static_cast<unsigned char>(str[i]);
+		if ((c == '"') || (c == '\\')) {
+			fputc('\\', fp);
+			fputc(c, fp);
+		} else if (c < 0x20) {
+			fprintf(fp, "\\u%04x", c);
+		} else {
+			fputc(c, fp);
+		}
+	}
+	fputc('"', fp);
+}
+
+///	<summary>
+///		Write the profile to the output file at exit.
+///	</summary>
+static void AnnounceProfileWriteAtExit() {
+	if (s_strProfileOutput == "") {
+		return;
+	}
+
+	if (s_strProfileOutput == "-") {
+		AnnounceWriteProfileTree(stdout);
+		fflush(stdout);
+		return;
+	}
+
+	FILE * fp = fopen(s_strProfileOutput.c_str(), "w");
+	if (fp == NULL) {
+		fprintf(stderr, "Unable to open profile output file \"%s\"\n",
+			s_strProfileOutput.c_str());
+		return;
+	}
+
+	const std::string strExt = ".json";
+	if ((s_strProfileOutput.length() > strExt.length()) &&
+	    (s_strProfileOutput.compare(
+			s_strProfileOutput.length() - strExt.length(),
+			strExt.length(), strExt) == 0)
+	) {
+		AnnounceWriteProfileTrace(fp);
+	} else {
+		AnnounceWriteProfileTree(fp);
+	}
+
+	fclose(fp);
+}
+
+///	<summary>
+///		Enable profiling from the TEMPESTREMAP_PROFILE environment variable
+///		at startup.
+///	</summary>
+struct AnnounceProfileEnvironmentInitializer {
+	AnnounceProfileEnvironmentInitializer() {
+		const char * szFile = getenv("TEMPESTREMAP_PROFILE");
+		if ((szFile != NULL) && (szFile[0] != '\0')) {
+			AnnounceSetProfileOutput(szFile);
+		}
+	}
+};
+
+static AnnounceProfileEnvironmentInitializer s_initProfileEnvironment;
+
+///////////////////////////////////////////////////////////////////////////////
+
+void AnnounceSetProfilingEnabled(bool fProfilingEnabled) {
+	if (fProfilingEnabled && (s_dProfileWallOrigin < 0.0)) {
+		s_dProfileWallOrigin = AnnounceProfileWallTime();
+	}
+	s_fProfilingEnabled = fProfilingEnabled;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+bool AnnounceGetProfilingEnabled() {
+	return s_fProfilingEnabled;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+int AnnounceRegisterCounter(const char * szName) {
+	int iCounter;
+
+#pragma omp critical(AnnounceProfile)
+	{
+		std::vector<std::string> & vecCounterNames =
+			AnnounceProfileCounterNames();
+
+		iCounter = static_cast<int>(vecCounterNames.size());
+		for (int i = 0; i < vecCounterNames.size(); i++) {
+			if (vecCounterNames[i] == szName) {
+				iCounter = i;
+				break;
+			}
+		}
+		if (iCounter == vecCounterNames.size()) {
+			vecCounterNames.push_back(szName);
+		}
+	}
+
+	return iCounter;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void AnnounceCount(int iCounter, long long lCount) {
+	if (!s_fProfilingEnabled) {
+		return;
+	}
+
+	AnnounceProfileThreadStore * pStore = t_pProfileThreadStore;
+	if (pStore == NULL) {
+		pStore = new AnnounceProfileThreadStore;
+#pragma omp critical(AnnounceProfile)
+		{
+			pStore->vecCounts.resize(AnnounceProfileCounterNames().size(), 0);
+			AnnounceProfileThreadStores().push_back(pStore);
+		}
+		t_pProfileThreadStore = pStore;
+	}
+
+	if (iCounter >= pStore->vecCounts.size()) {
+#pragma omp critical(AnnounceProfile)
+		{
+			pStore->vecCounts.resize(iCounter + 1, 0);
+		}
+	}
+
+	pStore->vecCounts[iCounter] += lCount;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void AnnounceWriteProfileTree(FILE * fp) {
+	AnnounceProfileCloseOpenBlocks();
+
+	const std::vector<std::string> & vecCounterNames =
+		AnnounceProfileCounterNames();
+
+	// Merge blocks with the same name and parent
+	std::vector<std::string> vecNodeName;
+	std::vector<int> vecNodeParent;
+	std::vector<int> vecNodeCalls;
+	std::vector<double> vecNodeWall;
+	std::vector<double> vecNodeCPU;
+	std::vector<long> vecNodeRSS;
+	std::vector< std::vector<long long> > vecNodeCounts;
+	std::vector< std::vector<int> > vecNodeChildren(1);
+
+	std::map<std::pair<int, std::string>, int> mapNodes;
+	std::vector<int> vecBlockNode(s_vecProfileBlocks.size());
+
+	for (size_t b = 0; b < s_vecProfileBlocks.size(); b++) {
+		const AnnounceProfileBlock & block = s_vecProfileBlocks[b];
+
+		// Node 0 is the root; all other nodes are offset by one
+		int iParentNode = (block.iParent == (-1))?(0):(vecBlockNode[block.iParent]);
+
+		std::pair<int, std::string> key(iParentNode, block.strName);
+		std::map<std::pair<int, std::string>, int>::iterator iter =
+			mapNodes.find(key);
+
+		int iNode;
+		if (iter == mapNodes.end()) {
+			iNode = static_cast<int>(vecNodeName.size()) + 1;
+			mapNodes.insert(std::pair<std::pair<int, std::string>, int>(key, iNode));
+
+			vecNodeName.push_back(block.strName);
+			vecNodeParent.push_back(iParentNode);
+			vecNodeCalls.push_back(0);
+			vecNodeWall.push_back(0.0);
+			vecNodeCPU.push_back(0.0);
+			vecNodeRSS.push_back(0);
+			vecNodeCounts.push_back(std::vector<long long>(vecCounterNames.size(), 0));
+			vecNodeChildren.push_back(std::vector<int>());
+			vecNodeChildren[iParentNode].push_back(iNode);
+
+		} else {
+			iNode = iter->second;
+		}
+
+		vecBlockNode[b] = iNode;
+
+		vecNodeCalls[iNode-1]++;
+		vecNodeWall[iNode-1] += block.dWallEnd - block.dWallBegin;
+		vecNodeCPU[iNode-1] += block.dCPUEnd - block.dCPUBegin;
+		vecNodeRSS[iNode-1] += block.lPeakRSSEnd - block.lPeakRSSBegin;
+		for (size_t c = 0; c < block.vecCounts.size(); c++) {
+			vecNodeCounts[iNode-1][c] += block.vecCounts[c];
+		}
+	}
+
+	fprintf(fp, "Profile: wall time (s), CPU time (s), calls, "
+		"peak RSS growth (MB), counters\n");
+
+	// Totals since profiling was enabled, including counts made outside
+	// of any block
+	{
+		double dCPUTime;
+		long lPeakRSS;
+		AnnounceProfileResourceUsage(dCPUTime, lPeakRSS);
+
+		std::vector<long long> vecCounts;
+		AnnounceProfileSumCounts(vecCounts);
+
+		fprintf(fp, "(total): %.6f, %.6f, 1, %.3f",
+			AnnounceProfileWallTime() - s_dProfileWallOrigin,
+			dCPUTime,
+			static_cast<double>(lPeakRSS) / 1024.0);
+
+		for (size_t c = 0; c < vecCounterNames.size(); c++) {
+			if (vecCounts[c] != 0) {
+				fprintf(fp, ", %s=%lld",
+					vecCounterNames[c].c_str(), vecCounts[c]);
+			}
+		}
+		fprintf(fp, "\n");
+	}
+
+	// Depth-first traversal
+	std::vector< std::pair<int, int> > vecStack;
+	for (int i = static_cast<int>(vecNodeChildren[0].size()) - 1; i >= 0; i--) {
+		vecStack.push_back(std::pair<int, int>(vecNodeChildren[0][i], 0));
+	}
+
+	while (vecStack.size() != 0) {
+		const int iNode = vecStack.back().first;
+		const int iDepth = vecStack.back().second;
+		vecStack.pop_back();
+
+		for (int d = 0; d < iDepth; d++) {
+			fprintf(fp, "..");
+		}
+		fprintf(fp, "%s: %.6f, %.6f, %i, %.3f",
+			vecNodeName[iNode-1].c_str(),
+			vecNodeWall[iNode-1],
+			vecNodeCPU[iNode-1],
+			vecNodeCalls[iNode-1],
+			static_cast<double>(vecNodeRSS[iNode-1]) / 1024.0);
+
+		for (size_t c = 0; c < vecCounterNames.size(); c++) {
+			if (vecNodeCounts[iNode-1][c] != 0) {
+				fprintf(fp, ", %s=%lld",
+					vecCounterNames[c].c_str(), vecNodeCounts[iNode-1][c]);
+			}
+		}
+		fprintf(fp, "\n");
+
+		const std::vector<int> & vecChildren = vecNodeChildren[iNode];
+		for (int i = static_cast<int>(vecChildren.size()) - 1; i >= 0; i--) {
+			vecStack.push_back(std::pair<int, int>(vecChildren[i], iDepth + 1));
+		}
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void AnnounceWriteProfileTrace(FILE * fp) {
+	AnnounceProfileCloseOpenBlocks();
+
+	const std::vector<std::string> & vecCounterNames =
+		AnnounceProfileCounterNames();
+
+	fprintf(fp, "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [\n");
+
+	for (size_t b = 0; b < s_vecProfileBlocks.size(); b++) {
+		const AnnounceProfileBlock & block = s_vecProfileBlocks[b];
+
+		fprintf(fp, "{\"name\": ");
+		AnnounceProfileWriteJSONString(fp, block.strName);
+		fprintf(fp, ", \"ph\": \"X\", \"pid\": 0, \"tid\": 0, "
+			"\"ts\": %.3f, \"dur\": %.3f, \"args\": {\"cpu_s\": %.6f, "
+			"\"peak_rss_growth_kb\": %li",
+			1.0e6 * (block.dWallBegin - s_dProfileWallOrigin),
+			1.0e6 * (block.dWallEnd - block.dWallBegin),
+			block.dCPUEnd - block.dCPUBegin,
+			block.lPeakRSSEnd - block.lPeakRSSBegin);
+
+		for (size_t c = 0; c < block.vecCounts.size(); c++) {
+			if (block.vecCounts[c] != 0) {
+				fprintf(fp, ", ");
+				AnnounceProfileWriteJSONString(fp, vecCounterNames[c]);
+				fprintf(fp, ": %lld", block.vecCounts[c]);
+			}
+		}
+
+		fprintf(fp, "}}%s\n", (b == s_vecProfileBlocks.size()-1)?(""):(","));
+	}
+
+	fprintf(fp, "]}\n");
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void AnnounceSetProfileOutput(const char * szFile) {
+	if (s_strProfileOutput == "") {
+		atexit(AnnounceProfileWriteAtExit);
+	}
+	s_strProfileOutput = (szFile != NULL)?(szFile):("");
+
+	AnnounceSetProfilingEnabled(s_strProfileOutput != "");
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
 void AnnounceSetVerbosityLevel(int iVerbosityLevel) {
 	g_iVerbosityLevel = iVerbosityLevel;
 }
 
 ///////////////////////////////////////////////////////////////////////////////
 
+void AnnounceSetOutputEnabled(bool fOutputEnabled) {
+	s_fOutputEnabled = fOutputEnabled;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+bool AnnounceGetOutputEnabled() {
+	return s_fOutputEnabled;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void AnnounceSetThreadSilenced(bool fThreadSilenced) {
+	t_fThreadSilenced = fThreadSilenced;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+bool AnnounceGetThreadSilenced() {
+	return t_fThreadSilenced;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
 void AnnounceStartBlock(const char * szText) {
+	// Silenced threads neither output nor track blocks
+	if (t_fThreadSilenced) {
+		return;
+	}
+
+	// Record the block in the profile
+	if (s_fProfilingEnabled) {
+		AnnounceProfileStartBlock(szText);
+	}
 
 	// Do not start a block at maximum indentation level
 	if (s_nIndentationLevel == MaximumIndentationLevel) {
 		return;
 	}
 
-#ifdef USE_MPI
-	// Retrieve the rank of this processor
-	int nRank;
-
-	MPI_Comm_rank(MPI_COMM_WORLD, &nRank);
-
-	if (nRank > 0) {
+#if defined(USE_MPI) || defined(TEMPEST_MPIOMP)
+	// Only output from the root processor
+	if (!AnnounceIsRootRank()) {
 		return;
 	}
 #endif
 
 	// Check the block flag
 	if (s_fBlockFlag) {
-		printf("\n");
+		AnnouncePrintf("\n");
 	}
 
 	// Add indentation
 	int i;
 	for (i = 0; i < s_nIndentationLevel; i++) {
-		printf("..");
+		AnnouncePrintf("..");
 	}
 
 	// Output the text
 	if (szText != NULL) {
-		printf("%s", szText);
+		AnnouncePrintf("%s", szText);
 		s_fBlockFlag = true;
 	}
 	s_nIndentationLevel++;
@@ -121,18 +738,22 @@ void AnnounceStartBlock(
 ///////////////////////////////////////////////////////////////////////////////
 
 void AnnounceEndBlock(const char * szText) {
-	// Do not remove a block at minimum indentation level
-	if (s_nIndentationLevel == 0) {
+	// Silenced threads neither output nor track blocks
+	if (t_fThreadSilenced) {
 		return;
 	}
 
-#ifdef USE_MPI
-	// Retrieve the rank of this processor
-	int nRank;
+	// Close the block in the profile
+	AnnounceProfileEndBlock();
 
-	MPI_Comm_rank(MPI_COMM_WORLD, &nRank);
+	// Do not remove a block at minimum indentation level
+	if (s_nIndentationLevel == 0) {
+		return;
+	}
 
-	if (nRank > 0) {
+#if defined(USE_MPI) || defined(TEMPEST_MPIOMP)
+	// Only output from the root processor
+	if (!AnnounceIsRootRank()) {
 		return;
 	}
 #endif
@@ -142,15 +763,15 @@ void AnnounceEndBlock(const char * szText) {
 		if (s_fBlockFlag) {
 			s_fBlockFlag = false;
 
-			printf(".. ");
-			printf("%s", szText);
-			printf("\n");
+			AnnouncePrintf(".. ");
+			AnnouncePrintf("%s", szText);
+			AnnouncePrintf("\n");
 
 		} else {
 			Announce(szText);
 		}
 	} else if (s_fBlockFlag) {
-		printf("\n");
+		AnnouncePrintf("\n");
 	}
 
 
@@ -175,21 +796,21 @@ void AnnounceEndBlock(
 ///////////////////////////////////////////////////////////////////////////////
 
 void Announce(const char * szText, ...) {
+	// Silenced threads neither output nor track blocks
+	if (t_fThreadSilenced) {
+		return;
+	}
 
-#ifdef USE_MPI
-	// Retrieve the rank of this processor
-	int nRank;
-
-	MPI_Comm_rank(MPI_COMM_WORLD, &nRank);
-
-	if (nRank > 0) {
+#if defined(USE_MPI) || defined(TEMPEST_MPIOMP)
+	// Only output from the root processor
+	if (!AnnounceIsRootRank()) {
 		return;
 	}
 #endif
 
 	// Turn off the block flag
 	if (s_fBlockFlag) {
-		printf("\n");
+		AnnouncePrintf("\n");
 		s_fBlockFlag = false;
 	}
 
@@ -215,10 +836,10 @@ void Announce(const char * szText, ...) {
 	// Output with proper indentation
 	int i;
 	for (i = 0; i < s_nIndentationLevel; i++) {
-		printf("..");
+		AnnouncePrintf("..");
 	}
-	printf("%s", szBuffer);
-	printf("\n");
+	AnnouncePrintf("%s", szBuffer);
+	AnnouncePrintf("\n");
 
 	fflush(NULL);
 }
@@ -230,14 +851,14 @@ void Announce(
 	const char * szText,
 	...
 ) {
+	// Silenced threads neither output nor track blocks
+	if (t_fThreadSilenced) {
+		return;
+	}
 
-#ifdef USE_MPI
-	// Retrieve the rank of this processor
-	int nRank;
-
-	MPI_Comm_rank(MPI_COMM_WORLD, &nRank);
-
-	if (nRank > 0) {
+#if defined(USE_MPI) || defined(TEMPEST_MPIOMP)
+	// Only output from the root processor
+	if (!AnnounceIsRootRank()) {
 		return;
 	}
 #endif
@@ -249,7 +870,7 @@ void Announce(
 
 	// Turn off the block flag
 	if (s_fBlockFlag) {
-		printf("\n");
+		AnnouncePrintf("\n");
 		s_fBlockFlag = false;
 	}
 
@@ -275,10 +896,10 @@ void Announce(
 	// Output with proper indentation
 	int i;
 	for (i = 0; i < s_nIndentationLevel; i++) {
-		printf("..");
+		AnnouncePrintf("..");
 	}
-	printf("%s", szBuffer);
-	printf("\n");
+	AnnouncePrintf("%s", szBuffer);
+	AnnouncePrintf("\n");
 
 	fflush(NULL);
 }
@@ -286,21 +907,21 @@ void Announce(
 ///////////////////////////////////////////////////////////////////////////////
 
 void AnnounceBanner(const char * szText) {
+	// Silenced threads neither output nor track blocks
+	if (t_fThreadSilenced) {
+		return;
+	}
 
-#ifdef USE_MPI
-	// Retrieve the rank of this processor
-	int nRank;
-
-	MPI_Comm_rank(MPI_COMM_WORLD, &nRank);
-
-	if (nRank > 0) {
+#if defined(USE_MPI) || defined(TEMPEST_MPIOMP)
+	// Only output from the root processor
+	if (!AnnounceIsRootRank()) {
 		return;
 	}
 #endif
 
 	// Turn off the block flag
 	if (s_fBlockFlag) {
-		printf("\n");
+		AnnouncePrintf("\n");
 		s_fBlockFlag = false;
 	}
 
@@ -308,26 +929,26 @@ void AnnounceBanner(const char * szText) {
 	int i;
 	if (szText == NULL) {
 		for (i = 0; i < BannerSize; i++) {
-			printf("-");
+			AnnouncePrintf("-");
 		}
-		printf("\n");
+		AnnouncePrintf("\n");
 		fflush(NULL);
 		return;
 	}
 
 	// Text in banner
 	int nLen = strlen(szText) + 2;
-	printf("--");
+	AnnouncePrintf("--");
 	if (nLen > BannerSize - 2) {
-		printf("%s", szText);
-		printf("--");
+		AnnouncePrintf("%s", szText);
+		AnnouncePrintf("--");
 	} else {
-		printf(" %s ", szText);
+		AnnouncePrintf(" %s ", szText);
 		for (i = 0; i < BannerSize - nLen - 2; i++) {
-			printf("-");
+			AnnouncePrintf("-");
 		}
 	}
-	printf("\n");
+	AnnouncePrintf("\n");
 	fflush(NULL);
 }
 
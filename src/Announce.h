@@ -34,6 +34,32 @@ extern int g_iVerbosityLevel;
 ///	</summary>
 void AnnounceSetVerbosityLevel(int iVerbosityLevel);
 
+///	<summary>
+///		Enable or disable all announcement output.  Blocks are still
+///		tracked while output is disabled, so output may be re-enabled at
+///		any point.
+///	</summary>
+void AnnounceSetOutputEnabled(bool fOutputEnabled);
+
+///	<summary>
+///		Determine if announcement output is enabled.
+///	</summary>
+bool AnnounceGetOutputEnabled();
+
+///	<summary>
+///		Silence all announcements and profiling blocks made by the calling
+///		thread.  Unlike AnnounceSetOutputEnabled() a silenced thread does
+///		not track blocks, so independent tasks (such as maps generated
+///		concurrently) may run on silenced threads without sharing the
+///		indentation level.
+///	</summary>
+void AnnounceSetThreadSilenced(bool fThreadSilenced);
+
+///	<summary>
+///		Determine if the calling thread is silenced.
+///	</summary>
+bool AnnounceGetThreadSilenced();
+
 ///	<summary>
 ///		Begin a new announcement block.
 ///	</summary>
@@ -71,5 +97,55 @@ void AnnounceBanner(const char * szText = NULL);
 
 ///////////////////////////////////////////////////////////////////////////////
 
+///	<summary>
+///		Enable or disable profiling.  While profiling is enabled every
+///		announcement block records its wall time, process CPU time, growth
+///		of the peak resident set size and the change in each counter.
+///		Profiling is enabled at startup if the TEMPESTREMAP_PROFILE
+///		environment variable names an output file (see
+///		AnnounceSetProfileOutput).  Blocks are recorded on the thread that
+///		opens them and should be opened outside of parallel regions.
+///	</summary>
+void AnnounceSetProfilingEnabled(bool fProfilingEnabled);
+
+///	<summary>
+///		Determine if profiling is enabled.
+///	</summary>
+bool AnnounceGetProfilingEnabled();
+
+///	<summary>
+///		Register a named profiling counter, returning its index.
+///		Registering the same name again returns the same index.
+///	</summary>
+int AnnounceRegisterCounter(const char * szName);
+
+///	<summary>
+///		Add to a profiling counter.  Counts are accumulated in a store
+///		local to the calling thread, so this may be called from within
+///		parallel regions; the stores are summed at block boundaries.
+///	</summary>
+void AnnounceCount(int iCounter, long long lCount = 1);
+
+///	<summary>
+///		Write the recorded blocks as a tree, merging blocks with the same
+///		name and parent.
+///	</summary>
+void AnnounceWriteProfileTree(FILE * fp);
+
+///	<summary>
+///		Write the recorded blocks in Chrome trace event format, which can
+///		be loaded in chrome://tracing or Perfetto.
+///	</summary>
+void AnnounceWriteProfileTrace(FILE * fp);
+
+///	<summary>
+///		Enable profiling and write the profile to szFile at exit.  Files
+///		ending in ".json" are written as a Chrome trace and other files as
+///		a tree; "-" writes the tree to stdout.
+///	</summary>
+void AnnounceSetProfileOutput(const char * szFile);
+
+///////////////////////////////////////////////////////////////////////////////
+
 #endif
 
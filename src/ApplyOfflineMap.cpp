@@ -19,6 +19,14 @@
 #include "OfflineMap.h"
 #include "netcdfcpp.h"
 
+#include <fstream>
+#include <sstream>
+#include <glob.h>
+
+#if defined(TEMPEST_MPIOMP)
+#include <mpi.h>
+#endif
+
 ///////////////////////////////////////////////////////////////////////////////
 
 static void ParseVariableList(
@@ -54,6 +62,242 @@ static void ParseVariableList(
 
 ///////////////////////////////////////////////////////////////////////////////
 
+///	<summary>
+///		Parse a list of vector variables, each given by its eastward and
+///		northward components separated by a colon (e.g. "U:V,U850:V850").
+///	</summary>
+static void ParseVectorVariableList(
+	const std::string & strVectorVariables,
+	std::vector< std::pair<std::string, std::string> > & vecVectorVariables
+) {
+	std::vector< std::string > vecVectorStrings;
+	ParseVariableList(strVectorVariables, vecVectorStrings);
+
+	for (int v = 0; v < vecVectorStrings.size(); v++) {
+		const std::string & strVector = vecVectorStrings[v];
+
+		size_t iColon = strVector.find(':');
+		if ((iColon == std::string::npos) ||
+		    (iColon == 0) ||
+		    (iColon == strVector.length()-1) ||
+		    (strVector.find(':', iColon+1) != std::string::npos)
+		) {
+			_EXCEPTION1("Invalid vector variable \"%s\" (expected U:V)",
+				strVector.c_str());
+		}
+
+		vecVectorVariables.push_back(
+			std::pair<std::string, std::string>(
+				strVector.substr(0, iColon),
+				strVector.substr(iColon+1)));
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Read the weights of the offline map strInputMap, through its image in
+///		the cache directory strMapCache if it is not empty.
+///	</summary>
+static void ReadWeightsForApply(
+	OfflineMap & mapRemap,
+	const std::string & strInputMap,
+	const std::string & strMapCache
+) {
+	if (strMapCache == "") {
+		mapRemap.ReadWeights(strInputMap);
+	} else {
+		mapRemap.ReadWeightsCached(strInputMap, strMapCache);
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Read the offline map strInputMap, composed with strInputMapNext if
+///		it is not empty, and optionally convert its weights to single
+///		precision.
+///	</summary>
+static void ReadOfflineMapForApply(
+	OfflineMap & mapRemap,
+	const std::string & strInputMap,
+	const std::string & strInputMapNext,
+	const std::string & strMapCache,
+	bool fSinglePrecision,
+	int nThreads
+) {
+	if (strInputMapNext == "") {
+		ReadWeightsForApply(mapRemap, strInputMap, strMapCache);
+
+	// Compose chained maps into a single operator, so that data on the
+	// intermediate mesh is never formed
+	} else {
+		AnnounceStartBlock("Composing offline maps");
+
+		OfflineMap mapRemapFirst;
+		ReadWeightsForApply(mapRemapFirst, strInputMap, strMapCache);
+
+		OfflineMap mapRemapNext;
+		ReadWeightsForApply(mapRemapNext, strInputMapNext, strMapCache);
+
+		mapRemap.SetComposition(mapRemapFirst, mapRemapNext, nThreads);
+
+		Announce("Composed map has %lu nonzero entries",
+			mapRemap.GetSparseMatrix().GetNonZeroCount());
+
+		AnnounceEndBlock(NULL);
+	}
+
+	// Store the weights in single precision
+	if (fSinglePrecision) {
+		mapRemap.ConvertToSinglePrecision();
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Copy the requested variables of strInputData that are not remapped
+///		to strOutputData.
+///	</summary>
+static void PreserveVariablesForApply(
+	OfflineMap & mapRemap,
+	const std::string & strInputData,
+	const std::string & strOutputData,
+	const std::vector< std::string > & vecPreserveVariableStrings,
+	bool fPreserveAll
+) {
+	if (fPreserveAll) {
+		AnnounceStartBlock("Preserving variables");
+		mapRemap.PreserveAllVariables(strInputData, strOutputData);
+		AnnounceEndBlock(NULL);
+
+	} else if (vecPreserveVariableStrings.size() != 0) {
+		AnnounceStartBlock("Preserving variables");
+		mapRemap.PreserveVariables(
+			strInputData,
+			strOutputData,
+			vecPreserveVariableStrings);
+		AnnounceEndBlock(NULL);
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Get the rank of this processor and the number of processors in
+///		MPI_COMM_WORLD, or zero and one if MPI is not in use.
+///	</summary>
+static void GetProcessorRankAndCount(
+	int & nRank,
+	int & nSize
+) {
+	nRank = 0;
+	nSize = 1;
+
+#if defined(TEMPEST_MPIOMP)
+	int fMPIInitialized;
+	MPI_Initialized(&fMPIInitialized);
+
+	if (fMPIInitialized) {
+		MPI_Comm_rank(MPI_COMM_WORLD, &nRank);
+		MPI_Comm_size(MPI_COMM_WORLD, &nSize);
+	}
+#endif
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Build the list of input and output data files of a batch.  Each
+///		line of strInputDataList names an input file, optionally followed
+///		by its output file; blank lines and lines beginning with '#' are
+///		ignored.  Files matching strInputDataGlob are appended in sorted
+///		order.  Output files that are not named are placed in
+///		strOutputDir with the name of the input file.
+///	</summary>
+static void BuildBatchFileList(
+	const std::string & strInputDataList,
+	const std::string & strInputDataGlob,
+	const std::string & strOutputDir,
+	std::vector< std::string > & vecInputFiles,
+	std::vector< std::string > & vecOutputFiles
+) {
+	std::vector< std::string > vecExplicitOutput;
+
+	if (strInputDataList != "") {
+		std::ifstream ifList(strInputDataList.c_str());
+		if (!ifList.is_open()) {
+			_EXCEPTION1("Unable to open input data list \"%s\"",
+				strInputDataList.c_str());
+		}
+
+		std::string strLine;
+		while (std::getline(ifList, strLine)) {
+			std::istringstream issLine(strLine);
+
+			std::string strInput;
+			std::string strOutput;
+			if (!(issLine >> strInput) || (strInput[0] == '#')) {
+				continue;
+			}
+			issLine >> strOutput;
+
+			vecInputFiles.push_back(strInput);
+			vecExplicitOutput.push_back(strOutput);
+		}
+	}
+
+	if (strInputDataGlob != "") {
+		glob_t globResult;
+		int iGlobError =
+			glob(strInputDataGlob.c_str(), 0, NULL, &globResult);
+
+		if (iGlobError == 0) {
+			for (size_t i = 0; i < globResult.gl_pathc; i++) {
+				vecInputFiles.push_back(globResult.gl_pathv[i]);
+				vecExplicitOutput.push_back("");
+			}
+		}
+		globfree(&globResult);
+
+		if ((iGlobError != 0) && (iGlobError != GLOB_NOMATCH)) {
+			_EXCEPTION1("Unable to expand input data pattern \"%s\"",
+				strInputDataGlob.c_str());
+		}
+	}
+
+	if (vecInputFiles.size() == 0) {
+		_EXCEPTIONT("No input data files in batch");
+	}
+
+	vecOutputFiles.resize(vecInputFiles.size());
+	for (size_t f = 0; f < vecInputFiles.size(); f++) {
+		if (vecExplicitOutput[f] != "") {
+			vecOutputFiles[f] = vecExplicitOutput[f];
+			continue;
+		}
+		if (strOutputDir == "") {
+			_EXCEPTION1("No output file for \"%s\": specify --out_dir",
+				vecInputFiles[f].c_str());
+		}
+
+		const std::string & strInput = vecInputFiles[f];
+		size_t iSlash = strInput.find_last_of('/');
+		std::string strBaseName =
+			(iSlash == std::string::npos)?(strInput):(strInput.substr(iSlash+1));
+
+		vecOutputFiles[f] = strOutputDir + "/" + strBaseName;
+
+		if (vecOutputFiles[f] == strInput) {
+			_EXCEPTION1("Output file would overwrite input file \"%s\"",
+				strInput.c_str());
+		}
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
 extern "C" 
 int ApplyOfflineMap(
 	std::string strInputData,
@@ -67,7 +311,14 @@ int ApplyOfflineMap(
 	bool fOutputDouble,
 	std::string strPreserveVariables,
 	bool fPreserveAll,
-	double dFillValueOverride
+	double dFillValueOverride,
+	int nThreads,
+	std::string strInputMapNext,
+	bool fSinglePrecision,
+	bool fAsyncIO,
+	bool fDeviceApply,
+	std::string strMapCache,
+	std::string strVectorVariables
 ) {
 
 	NcError error(NcError::silent_nonfatal);
@@ -84,11 +335,18 @@ try {
 	if (strOutputData == "") {
 		_EXCEPTIONT("No output data specified");
 	}
+	if (nThreads < 1) {
+		_EXCEPTIONT("--nthreads must be at least 1");
+	}
 
 	// Parse variable list
 	std::vector< std::string > vecVariableStrings;
 	ParseVariableList(strVariables, vecVariableStrings);
 
+	// Parse vector variable list
+	std::vector< std::pair<std::string, std::string> > vecVectorVariables;
+	ParseVectorVariableList(strVectorVariables, vecVectorVariables);
+
 	// Parse preserve variable list
 	std::vector< std::string > vecPreserveVariableStrings;
 	ParseVariableList(strPreserveVariables, vecPreserveVariableStrings);
@@ -112,6 +370,16 @@ try {
 		_EXCEPTIONT("No input data specified for --map2");
 	}
 
+	// OfflineMap
+	OfflineMap mapRemap;
+	ReadOfflineMapForApply(
+		mapRemap,
+		strInputMap,
+		strInputMapNext,
+		strMapCache,
+		fSinglePrecision,
+		nThreads);
+
 	// Apply OfflineMap to data
 	if (strInputMap2 == "") {
 		AnnounceStartBlock("Applying offline map to data");
@@ -119,10 +387,10 @@ try {
 		AnnounceStartBlock("Applying first offline map to data");
 	}
 
-	// OfflineMap
-	OfflineMap mapRemap;
-	mapRemap.Read(strInputMap);
 	mapRemap.SetFillValueOverride(static_cast<float>(dFillValueOverride));
+	mapRemap.SetThreadCount(nThreads);
+	mapRemap.SetAsyncIO(fAsyncIO);
+	mapRemap.SetDeviceApply(fDeviceApply);
 
 	mapRemap.Apply(
 		strInputData,
@@ -130,7 +398,8 @@ try {
 		vecVariableStrings,
 		strNColName,
 		fOutputDouble,
-		false);
+		false,
+		vecVectorVariables);
 	AnnounceEndBlock(NULL);
 
 	if (strInputMap2.size()) {
@@ -138,18 +407,26 @@ try {
 
 		// OfflineMap
 		OfflineMap mapRemap2;
-		mapRemap2.Read(strInputMap2);
+		ReadWeightsForApply(mapRemap2, strInputMap2, strMapCache);
+		mapRemap2.SetThreadCount(nThreads);
+		mapRemap2.SetAsyncIO(fAsyncIO);
+		mapRemap2.SetDeviceApply(fDeviceApply);
 
-		// Verify consistency of maps
-		SparseMatrix<double> & smatRemap  = mapRemap .GetSparseMatrix();
-		SparseMatrix<double> & smatRemap2 = mapRemap2.GetSparseMatrix();
-		if ((smatRemap.GetRows() != smatRemap2.GetRows()) ||
-			(smatRemap.GetColumns() != smatRemap2.GetColumns())
+		// Verify consistency of maps (the first map may no longer hold
+		// double precision weights, so compare the grid sizes)
+		if ((mapRemap.GetTargetAreas().GetRows() !=
+			 mapRemap2.GetTargetAreas().GetRows()) ||
+			(mapRemap.GetSourceAreas().GetRows() !=
+			 mapRemap2.GetSourceAreas().GetRows())
 		) {
 			_EXCEPTIONT("Mismatch in dimensions of input maps "
 				"--map and --map2");
 		}
 
+		if (fSinglePrecision) {
+			mapRemap2.ConvertToSinglePrecision();
+		}
+
 		mapRemap2.Apply(
 			strInputData2,
 			strOutputData,
@@ -162,20 +439,339 @@ try {
 	}
 
 	// Copy variables from input file to output file
-	if (fPreserveAll) {
-		AnnounceStartBlock("Preserving variables");
-		mapRemap.PreserveAllVariables(strInputData, strOutputData);
-		AnnounceEndBlock(NULL);
+	PreserveVariablesForApply(
+		mapRemap,
+		strInputData,
+		strOutputData,
+		vecPreserveVariableStrings,
+		fPreserveAll);
+
+} catch(Exception & e) {
+	Announce(e.ToString().c_str());
+	return (-1);
+
+} catch(...) {
+	return (-2);
+}
+	return 0;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+extern "C"
+int ApplyOfflineMapBatch(
+	std::string strInputDataList,
+	std::string strInputDataGlob,
+	std::string strOutputDir,
+	std::string strInputMap,
+	std::string strVariables,
+	std::string strNColName,
+	bool fOutputDouble,
+	std::string strPreserveVariables,
+	bool fPreserveAll,
+	double dFillValueOverride,
+	int nThreads,
+	std::string strInputMapNext,
+	bool fSinglePrecision,
+	bool fAsyncIO,
+	bool fDeviceApply,
+	std::string strMapCache,
+	std::string strVectorVariables
+) {
+
+	NcError error(NcError::silent_nonfatal);
+
+	int nRank;
+	int nSize;
+	GetProcessorRankAndCount(nRank, nSize);
+
+	std::vector< std::string > vecVariableStrings;
+	std::vector< std::pair<std::string, std::string> > vecVectorVariables;
+	std::vector< std::string > vecPreserveVariableStrings;
+
+	std::vector< std::string > vecInputFiles;
+	std::vector< std::string > vecOutputFiles;
+
+	OfflineMap mapRemap;
+
+	int iSetupError = 0;
+
+try {
+
+	// Check parameters
+	if (strInputMap == "") {
+		_EXCEPTIONT("No map specified");
+	}
+	if ((strInputDataList == "") && (strInputDataGlob == "")) {
+		_EXCEPTIONT("No input data list or pattern specified");
+	}
+	if (nThreads < 1) {
+		_EXCEPTIONT("--nthreads must be at least 1");
+	}
+
+	// Parse variable lists
+	ParseVariableList(strVariables, vecVariableStrings);
+	ParseVectorVariableList(strVectorVariables, vecVectorVariables);
+	ParseVariableList(strPreserveVariables, vecPreserveVariableStrings);
+
+	if (fPreserveAll && (vecPreserveVariableStrings.size() != 0)) {
+		_EXCEPTIONT("--preserveall and --preserve cannot both be specified");
+	}
+
+	// Every processor builds the same list of files
+	BuildBatchFileList(
+		strInputDataList,
+		strInputDataGlob,
+		strOutputDir,
+		vecInputFiles,
+		vecOutputFiles);
+
+	Announce("Remapping %lu files on %i processors with %i threads each",
+		vecInputFiles.size(), nSize, nThreads);
+
+	// The map is read once on each processor and shared by all files
+	AnnounceStartBlock("Reading offline map");
+	ReadOfflineMapForApply(
+		mapRemap,
+		strInputMap,
+		strInputMapNext,
+		strMapCache,
+		fSinglePrecision,
+		nThreads);
+
+	mapRemap.SetFillValueOverride(static_cast<float>(dFillValueOverride));
+	mapRemap.SetThreadCount(nThreads);
+	mapRemap.SetAsyncIO(fAsyncIO);
+	mapRemap.SetDeviceApply(fDeviceApply);
+	AnnounceEndBlock(NULL);
+
+} catch(Exception & e) {
+	printf("ERROR: %s\n", e.ToString().c_str());
+	iSetupError = 1;
+
+} catch(...) {
+	iSetupError = 1;
+}
+
+	// Fail on all processors together if any could not read the map
+#if defined(TEMPEST_MPIOMP)
+	if (nSize > 1) {
+		int iLocalSetupError = iSetupError;
+		MPI_Allreduce(
+			&iLocalSetupError, &iSetupError, 1, MPI_INT, MPI_MAX,
+			MPI_COMM_WORLD);
+	}
+#endif
+
+	if (iSetupError) {
+		return (-1);
+	}
+
+	const int nFiles = static_cast<int>(vecInputFiles.size());
+
+#if defined(TEMPEST_MPIOMP)
+	// Files are handed out dynamically from a counter on the root
+	// processor, so that processors that finish early take more files
+	int iNextFileCounter = 0;
+	MPI_Win winNextFile;
+	if (nSize > 1) {
+		MPI_Win_create(
+			&iNextFileCounter, sizeof(int), sizeof(int),
+			MPI_INFO_NULL, MPI_COMM_WORLD, &winNextFile);
+	}
+#endif
+
+	// Number of files that could not be remapped on this processor
+	int nFailures = 0;
+
+	int iNextFile = 0;
+	for (;;) {
+		int f = iNextFile++;
+
+#if defined(TEMPEST_MPIOMP)
+		if (nSize > 1) {
+			int iOne = 1;
+			MPI_Win_lock(MPI_LOCK_SHARED, 0, 0, winNextFile);
+			MPI_Fetch_and_op(
+				&iOne, &f, MPI_INT, 0, 0, MPI_SUM, winNextFile);
+			MPI_Win_unlock(0, winNextFile);
+		}
+#endif
+
+		if (f >= nFiles) {
+			break;
+		}
+
+		std::string strAnnounce =
+			"Remapping " + vecInputFiles[f] + " to " + vecOutputFiles[f];
+		AnnounceStartBlock(strAnnounce.c_str());
+
+		// A file that cannot be remapped does not stop the batch
+		try {
+			mapRemap.Apply(
+				vecInputFiles[f],
+				vecOutputFiles[f],
+				vecVariableStrings,
+				strNColName,
+				fOutputDouble,
+				false,
+				vecVectorVariables);
+
+			PreserveVariablesForApply(
+				mapRemap,
+				vecInputFiles[f],
+				vecOutputFiles[f],
+				vecPreserveVariableStrings,
+				fPreserveAll);
+
+		} catch(Exception & e) {
+			printf("ERROR: Unable to remap \"%s\": %s\n",
+				vecInputFiles[f].c_str(), e.ToString().c_str());
+			nFailures++;
+
+		} catch(...) {
+			printf("ERROR: Unable to remap \"%s\"\n",
+				vecInputFiles[f].c_str());
+			nFailures++;
+		}
 
-	} else if (vecPreserveVariableStrings.size() != 0) {
-		AnnounceStartBlock("Preserving variables");
-		mapRemap.PreserveVariables(
-			strInputData,
-			strOutputData,
-			vecPreserveVariableStrings);
 		AnnounceEndBlock(NULL);
 	}
 
+	// All processors return the same status
+#if defined(TEMPEST_MPIOMP)
+	if (nSize > 1) {
+		MPI_Win_free(&winNextFile);
+
+		int nLocalFailures = nFailures;
+		MPI_Allreduce(
+			&nLocalFailures, &nFailures, 1, MPI_INT, MPI_SUM,
+			MPI_COMM_WORLD);
+	}
+#endif
+
+	if (nFailures != 0) {
+		Announce("ERROR: %i of %i files could not be remapped",
+			nFailures, nFiles);
+		return (-1);
+	}
+	return 0;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Set the thread count of a caller-owned OfflineMap for the lifetime
+///		of this object and restore the previous thread count afterwards,
+///		so that the array entry points do not change the caller's map.
+///	</summary>
+class OfflineMapThreadCountScope {
+public:
+	OfflineMapThreadCountScope(
+		OfflineMap & mapRemap,
+		int nThreads
+	) :
+		m_mapRemap(mapRemap),
+		m_nThreadsPrevious(mapRemap.GetThreadCount())
+	{
+		m_mapRemap.SetThreadCount(nThreads);
+	}
+
+	~OfflineMapThreadCountScope() {
+		m_mapRemap.SetThreadCount(m_nThreadsPrevious);
+	}
+
+private:
+	OfflineMap & m_mapRemap;
+	int m_nThreadsPrevious;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+extern "C"
+int ApplyOfflineMapToArray(
+	OfflineMap& mapRemap,
+	const double* pSource,
+	int nSourceCells,
+	ptrdiff_t sSourceFieldStride,
+	ptrdiff_t sSourceCellStride,
+	double* pTarget,
+	int nTargetCells,
+	ptrdiff_t sTargetFieldStride,
+	ptrdiff_t sTargetCellStride,
+	int nFields,
+	int nThreads
+) {
+try {
+	OfflineMapThreadCountScope scopeThreads(mapRemap, nThreads);
+	mapRemap.Apply(
+		pSource, nSourceCells, sSourceFieldStride, sSourceCellStride,
+		pTarget, nTargetCells, sTargetFieldStride, sTargetCellStride,
+		nFields);
+
+} catch(Exception & e) {
+	Announce(e.ToString().c_str());
+	return (-1);
+
+} catch(...) {
+	return (-2);
+}
+	return 0;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+extern "C"
+int ApplyOfflineMapToArrayFloat(
+	OfflineMap& mapRemap,
+	const float* pSource,
+	int nSourceCells,
+	ptrdiff_t sSourceFieldStride,
+	ptrdiff_t sSourceCellStride,
+	float* pTarget,
+	int nTargetCells,
+	ptrdiff_t sTargetFieldStride,
+	ptrdiff_t sTargetCellStride,
+	int nFields,
+	int nThreads
+) {
+try {
+	OfflineMapThreadCountScope scopeThreads(mapRemap, nThreads);
+	mapRemap.Apply(
+		pSource, nSourceCells, sSourceFieldStride, sSourceCellStride,
+		pTarget, nTargetCells, sTargetFieldStride, sTargetCellStride,
+		nFields);
+
+} catch(Exception & e) {
+	Announce(e.ToString().c_str());
+	return (-1);
+
+} catch(...) {
+	return (-2);
+}
+	return 0;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+extern "C"
+int ApplyOfflineMapVectorToArray(
+	OfflineMap& mapRemap,
+	const double* pSourceU,
+	const double* pSourceV,
+	int nSourceCells,
+	double* pTargetU,
+	double* pTargetV,
+	int nTargetCells,
+	int nFields,
+	int nThreads
+) {
+try {
+	OfflineMapThreadCountScope scopeThreads(mapRemap, nThreads);
+	mapRemap.ApplyVector(
+		pSourceU, pSourceV, nSourceCells,
+		pTargetU, pTargetV, nTargetCells,
+		nFields);
 
 } catch(Exception & e) {
 	Announce(e.ToString().c_str());
@@ -21,6 +21,10 @@
 
 #include "TempestRemapAPI.h"
 
+#if defined(TEMPEST_MPIOMP)
+#include <mpi.h>
+#endif
+
 ///////////////////////////////////////////////////////////////////////////////
 
 int main(int argc, char** argv) {
@@ -28,12 +32,27 @@ int main(int argc, char** argv) {
 	// Input data file
 	std::string strInputData;
 
+	// File listing input data files (and optionally output files) of a batch
+	std::string strInputDataList;
+
+	// Pattern matching input data files of a batch
+	std::string strInputDataGlob;
+
+	// Directory of output data files of a batch
+	std::string strOutputDir;
+
 	// Input map file
 	std::string strInputMap;
 
+	// Map file applied to the output of the first map
+	std::string strInputMapNext;
+
 	// List of variables
 	std::string strVariables;
 
+	// List of vector variables (eastward:northward component pairs)
+	std::string strVectorVariables;
+
 	// Input data file (second instance)
 	std::string strInputData2;
 
@@ -61,11 +80,31 @@ int main(int argc, char** argv) {
 	// Fill value override
 	double dFillValueOverride;
 
+	// Number of threads used to remap data slices
+	int nThreads;
+
+	// Store the map weights in single precision
+	bool fSinglePrecision;
+
+	// Overlap NetCDF I/O with remapping
+	bool fAsyncIO;
+
+	// Remap data slices on a GPU
+	bool fDeviceApply;
+
+	// Directory of map images shared between processes
+	std::string strMapCache;
+
 	// Parse the command line
 	BeginCommandLine()
 		CommandLineString(strInputData, "in_data", "");
+		CommandLineString(strInputDataList, "in_data_list", "");
+		CommandLineString(strInputDataGlob, "in_data_glob", "");
+		CommandLineString(strOutputDir, "out_dir", "");
 		CommandLineString(strInputMap, "map", "");
+		CommandLineString(strInputMapNext, "map_next", "");
 		CommandLineString(strVariables, "var", "");
+		CommandLineString(strVectorVariables, "vec", "");
 		CommandLineString(strInputData2, "in_data2", "");
 		CommandLineString(strInputMap2, "map2", "");
 		CommandLineString(strVariables2, "var2", "");
@@ -75,21 +114,64 @@ int main(int argc, char** argv) {
 		CommandLineString(strPreserveVariables, "preserve", "");
 		CommandLineBool(fPreserveAll, "preserveall");
 		CommandLineDouble(dFillValueOverride, "fillvalue", 0.0);
+		CommandLineInt(nThreads, "nthreads", 1);
+		CommandLineBool(fSinglePrecision, "single_precision");
+		CommandLineBool(fAsyncIO, "async_io");
+		CommandLineBool(fDeviceApply, "device");
+		CommandLineString(strMapCache, "map_cache", "");
 
 		ParseCommandLine(argc, argv);
 	EndCommandLine(argv)
 
+	const bool fBatch = (strInputDataList != "") || (strInputDataGlob != "");
+
+	if (fBatch &&
+	    ((strInputData != "") || (strInputData2 != "") || (strOutputData != ""))
+	) {
+		_EXCEPTIONT("--in_data_list and --in_data_glob cannot be combined "
+			"with --in_data, --in_data2 or --out_data");
+	}
+	if (!fBatch && (strOutputDir != "")) {
+		_EXCEPTIONT("--out_dir requires --in_data_list or --in_data_glob");
+	}
+
+#if defined(TEMPEST_MPIOMP)
+	// Files of a batch are distributed across all processors
+	MPI_Init(&argc, &argv);
+#endif
+
 	AnnounceBanner();
 
 	// Calculate metadata
-	int err = ApplyOfflineMap ( strInputData, strInputMap, strVariables, strInputData2, 
+	int err;
+	if (fBatch) {
+		err = ApplyOfflineMapBatch ( strInputDataList, strInputDataGlob, strOutputDir,
+								strInputMap, strVariables, strNColName,
+								fOutputDouble, strPreserveVariables, fPreserveAll, dFillValueOverride,
+								nThreads, strInputMapNext, fSinglePrecision, fAsyncIO,
+								fDeviceApply, strMapCache, strVectorVariables );
+	} else {
+		err = ApplyOfflineMap ( strInputData, strInputMap, strVariables, strInputData2, 
 								strInputMap2, strVariables2, strOutputData, strNColName, 
-								fOutputDouble, strPreserveVariables, fPreserveAll, dFillValueOverride );
-	if (err) exit(err);
+								fOutputDouble, strPreserveVariables, fPreserveAll, dFillValueOverride,
+								nThreads, strInputMapNext, fSinglePrecision, fAsyncIO,
+								fDeviceApply, strMapCache, strVectorVariables );
+	}
+
+	if (err) {
+#if defined(TEMPEST_MPIOMP)
+		MPI_Finalize();
+#endif
+		exit(err);
+	}
 
 	// Done
 	AnnounceBanner();
 
+#if defined(TEMPEST_MPIOMP)
+	MPI_Finalize();
+#endif
+
 	return 0;
 }
 
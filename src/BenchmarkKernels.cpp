@@ -0,0 +1,1154 @@
+///////////////////////////////////////////////////////////////////////////////
+///
+///	\file    BenchmarkKernels.cpp
+///	\author  agent
+///	\version October 15, 2026
+///
+///	<remarks>
+///		Copyright 2026 agent
+///
+///		This file is distributed as part of the Tempest source code package.
+///		Permission is granted to use, copy, modify and distribute this
+///		source code and its documentation under the terms of the GNU General
+///		Public License.  This software is provided "as is" without express
+///		or implied warranty.
+///	</remarks>
+
+#include "Announce.h"
+#include "CommandLine.h"
+#include "Defines.h"
+#include "Exception.h"
+#include "GridElements.h"
+#include "GridElementsExact.h"
+#include "MeshUtilitiesExact.h"
+#include "MeshUtilitiesFuzzy.h"
+#include "OverlapMesh.h"
+#include "SparseMatrix.h"
+#include "STLStringHelper.h"
+#include "TempestRemapAPI.h"
+
+#include "netcdfcpp.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Wall clock time in seconds.
+///	</summary>
+static double BenchmarkTime() {
+	return std::chrono::duration<double>(
+		std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Split a comma-separated list.
+///	</summary>
+static void ParseBenchmarkList(
+	const std::string & strList,
+	std::vector<std::string> & vecItems
+) {
+	vecItems.clear();
+
+	size_t iBegin = 0;
+	for (;;) {
+		size_t iEnd = strList.find(',', iBegin);
+		if (iEnd == std::string::npos) {
+			iEnd = strList.length();
+		}
+		if (iEnd > iBegin) {
+			vecItems.push_back(strList.substr(iBegin, iEnd - iBegin));
+		}
+		if (iEnd == strList.length()) {
+			break;
+		}
+		iBegin = iEnd + 1;
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Generate an in-memory mesh of the given type [cs|rll|ico|icod] and
+///		resolution, with the same meaning of the resolution as in
+///		BenchmarkRemap.
+///	</summary>
+static void GenerateKernelBenchmarkMesh(
+	const std::string & strType,
+	int nResolution,
+	Mesh & mesh,
+	int nThreads
+) {
+	int err;
+	if (strType == "cs") {
+		err = GenerateCSMesh(
+			mesh, nResolution, false, "", "Netcdf4", nThreads);
+
+	} else if (strType == "rll") {
+		err = GenerateRLLMesh(
+			mesh, 2 * nResolution, nResolution,
+			0.0, 360.0, -90.0, 90.0,
+			false, false, false,
+			"", "", "Netcdf4", false);
+
+	} else if (strType == "ico") {
+		err = GenerateICOMesh(
+			mesh, nResolution, false, "", "Netcdf4", nThreads);
+
+	} else if (strType == "icod") {
+		err = GenerateICOMesh(
+			mesh, nResolution, true, "", "Netcdf4", nThreads);
+
+	} else {
+		_EXCEPTION1("Invalid mesh type (%s), expected [cs|rll|ico|icod]",
+			strType.c_str());
+	}
+
+	if (err) {
+		_EXCEPTION1("Unable to generate %s mesh", strType.c_str());
+	}
+
+	mesh.RemoveZeroEdges();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Synthetic inputs shared by all kernels, built once from the
+///		source and target meshes and their overlap mesh.
+///	</summary>
+struct KernelBenchmarkInput {
+
+	///	<summary>
+	///		Source, target and overlap meshes.
+	///	</summary>
+	Mesh meshSource;
+	Mesh meshTarget;
+	Mesh meshOverlap;
+
+	///	<summary>
+	///		Source and target Face of each overlap Face.
+	///	</summary>
+	std::vector<int> vecSourceFace;
+	std::vector<int> vecTargetFace;
+
+	///	<summary>
+	///		Nodes of the source and target meshes in fixed point.
+	///	</summary>
+	std::vector<NodeExact> vecSourceNodesExact;
+	std::vector<NodeExact> vecTargetNodesExact;
+
+	///	<summary>
+	///		Corner nodes of every overlap Face, in order, as they are
+	///		inserted into the NodeMap during overlap mesh generation.
+	///	</summary>
+	NodeVector vecCornerNodes;
+
+	///	<summary>
+	///		NodeMap of vecCornerNodes.
+	///	</summary>
+	NodeMap * pNodeMap;
+
+	///	<summary>
+	///		First-order conservative map from the overlap areas, in
+	///		assembly form and frozen (compressed row) form.
+	///	</summary>
+	SparseMatrix<double> matAssembly;
+	SparseMatrix<double> matFrozen;
+
+	///	<summary>
+	///		Source fields, one per row.
+	///	</summary>
+	DataArray2D<double> dataSource;
+
+	///	<summary>
+	///		Target fields, one per row.
+	///	</summary>
+	DataArray2D<double> dataTarget;
+
+	///	<summary>
+	///		Number of threads used by threaded kernels.
+	///	</summary>
+	int nThreads;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Construct a NodeMap with the configured implementation.
+///	</summary>
+static NodeMap * NewKernelBenchmarkNodeMap() {
+#if defined(OVERLAPMESH_RETAIN_REPEATED_NODES)
+	return new NodeMap();
+#endif
+#if defined(OVERLAPMESH_USE_UNSORTED_MAP)
+	return new NodeMap();
+#endif
+#if defined(OVERLAPMESH_USE_NODE_MULTIMAP)
+	return new NodeMap(ReferenceTolerance, OVERLAPMESH_BIN_WIDTH);
+#endif
+#if defined(OVERLAPMESH_USE_NODE_HASH)
+	return new NodeMap(ReferenceTolerance, OVERLAPMESH_HASH_CELL_WIDTH);
+#endif
+}
+
+///	<summary>
+///		Name of the configured NodeMap implementation.
+///	</summary>
+static const char * KernelBenchmarkNodeMapName() {
+#if defined(OVERLAPMESH_RETAIN_REPEATED_NODES)
+	return "std::map";
+#endif
+#if defined(OVERLAPMESH_USE_UNSORTED_MAP)
+	return "std::unordered_map";
+#endif
+#if defined(OVERLAPMESH_USE_NODE_MULTIMAP)
+	return "node_multimap_3d";
+#endif
+#if defined(OVERLAPMESH_USE_NODE_HASH)
+	return "node_hash_3d";
+#endif
+}
+
+///	<summary>
+///		Insert the nodes of vecNodes that are not already present into
+///		nodemap, as in overlap mesh generation.  Returns the sum of the
+///		indices of all nodes.
+///	</summary>
+static double InsertKernelBenchmarkNodes(
+	const NodeVector & vecNodes,
+	NodeMap & nodemap
+) {
+	double dChecksum = 0.0;
+	for (size_t i = 0; i < vecNodes.size(); i++) {
+		NodeMapConstIterator iter = nodemap.find(vecNodes[i]);
+		if (iter != nodemap.end()) {
+			dChecksum += static_cast<double>(iter->second);
+		} else {
+			int ixNode = static_cast<int>(nodemap.size());
+			nodemap.insert(NodeMapPair(vecNodes[i], ixNode));
+			dChecksum += static_cast<double>(ixNode);
+		}
+	}
+	return dChecksum;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Build the synthetic inputs of the kernels.
+///	</summary>
+static void BuildKernelBenchmarkInput(
+	const std::string & strSourceType,
+	int nSourceResolution,
+	const std::string & strTargetType,
+	int nTargetResolution,
+	int nFields,
+	int nThreads,
+	KernelBenchmarkInput & input
+) {
+	input.nThreads = nThreads;
+
+	// Meshes
+	GenerateKernelBenchmarkMesh(
+		strSourceType, nSourceResolution, input.meshSource, nThreads);
+	GenerateKernelBenchmarkMesh(
+		strTargetType, nTargetResolution, input.meshTarget, nThreads);
+
+	input.meshSource.CalculateFaceAreas(false, nThreads);
+	input.meshTarget.CalculateFaceAreas(false, nThreads);
+
+	input.meshSource.ConstructReverseNodeArray(nThreads);
+	input.meshSource.ConstructEdgeMap(false);
+	input.meshSource.ConstructFaceNeighbors(nThreads);
+	input.meshTarget.ConstructEdgeMap(false);
+	input.meshTarget.ConstructFaceNeighbors(nThreads);
+
+	// Overlap mesh
+	input.meshOverlap.type = Mesh::MeshType_Overlap;
+
+	GenerateOverlapMesh_v2(
+		input.meshSource,
+		input.meshTarget,
+		input.meshOverlap,
+		OverlapMeshMethod_Fuzzy,
+		false,
+		false,
+		nThreads);
+
+	const int nOverlapFaces = static_cast<int>(input.meshOverlap.faces.size());
+	if (nOverlapFaces == 0) {
+		_EXCEPTIONT("Overlap mesh has no faces");
+	}
+
+	input.vecSourceFace = input.meshOverlap.vecSourceFaceIx;
+	input.vecTargetFace = input.meshOverlap.vecTargetFaceIx;
+
+	// Fixed point nodes
+	input.vecSourceNodesExact.resize(input.meshSource.nodes.size());
+	for (size_t i = 0; i < input.meshSource.nodes.size(); i++) {
+		const Node & node = input.meshSource.nodes[i];
+		input.vecSourceNodesExact[i] = NodeExact(node.x, node.y, node.z);
+	}
+
+	input.vecTargetNodesExact.resize(input.meshTarget.nodes.size());
+	for (size_t i = 0; i < input.meshTarget.nodes.size(); i++) {
+		const Node & node = input.meshTarget.nodes[i];
+		input.vecTargetNodesExact[i] = NodeExact(node.x, node.y, node.z);
+	}
+
+	// Corner nodes of the overlap faces
+	for (int i = 0; i < nOverlapFaces; i++) {
+		const Face & face = input.meshOverlap.faces[i];
+		for (int k = 0; k < face.edges.size(); k++) {
+			input.vecCornerNodes.push_back(input.meshOverlap.nodes[face[k]]);
+		}
+	}
+
+	input.pNodeMap = NewKernelBenchmarkNodeMap();
+	InsertKernelBenchmarkNodes(input.vecCornerNodes, *(input.pNodeMap));
+
+	// First-order conservative map
+	input.meshOverlap.CalculateFaceAreas(false, nThreads);
+
+	for (int i = 0; i < nOverlapFaces; i++) {
+		const int ixSource = input.vecSourceFace[i];
+		const int ixTarget = input.vecTargetFace[i];
+
+		input.matAssembly(ixTarget, ixSource) +=
+			input.meshOverlap.vecFaceArea[i]
+			/ input.meshTarget.vecFaceArea[ixTarget];
+	}
+
+	input.matFrozen = input.matAssembly;
+	input.matFrozen.Freeze();
+	input.matFrozen.Distribute(nThreads);
+
+	// Smooth synthetic fields
+	const int nSourceCount = static_cast<int>(input.meshSource.faces.size());
+	const int nTargetCount = static_cast<int>(input.meshTarget.faces.size());
+
+	input.dataSource.Allocate(nFields, nSourceCount);
+	input.dataTarget.Allocate(nFields, nTargetCount);
+
+	for (int f = 0; f < nFields; f++) {
+		for (int i = 0; i < nSourceCount; i++) {
+			input.dataSource[f][i] =
+				2.0 + sin(0.001 * static_cast<double>(f * nSourceCount + i));
+		}
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Kernels.  Each kernel performs one pass over its synthetic input,
+// returning the number of operations in sOps and a checksum of its results
+// which is compared between variants of the same kernel.
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Intersections of every source edge with every target edge of each
+///		overlapping pair of faces, in floating point.
+///	</summary>
+static double KernelEdgeIntersectionsFuzzy(
+	KernelBenchmarkInput & input,
+	size_t & sOps
+) {
+	MeshUtilitiesFuzzy utils;
+
+	const NodeVector & nodesSource = input.meshSource.nodes;
+	const NodeVector & nodesTarget = input.meshTarget.nodes;
+
+	std::vector<Node> vecIntersections;
+
+	double dChecksum = 0.0;
+	sOps = 0;
+
+	for (size_t p = 0; p < input.vecSourceFace.size(); p++) {
+		const Face & faceSource = input.meshSource.faces[input.vecSourceFace[p]];
+		const Face & faceTarget = input.meshTarget.faces[input.vecTargetFace[p]];
+
+		for (int i = 0; i < faceSource.edges.size(); i++) {
+			const Edge & edgeSource = faceSource.edges[i];
+			for (int j = 0; j < faceTarget.edges.size(); j++) {
+				const Edge & edgeTarget = faceTarget.edges[j];
+
+				vecIntersections.clear();
+				utils.CalculateEdgeIntersections(
+					nodesSource[edgeSource[0]],
+					nodesSource[edgeSource[1]],
+					edgeSource.type,
+					nodesTarget[edgeTarget[0]],
+					nodesTarget[edgeTarget[1]],
+					edgeTarget.type,
+					vecIntersections);
+
+				dChecksum += static_cast<double>(vecIntersections.size());
+				sOps++;
+			}
+		}
+	}
+
+	return dChecksum;
+}
+
+///	<summary>
+///		As KernelEdgeIntersectionsFuzzy, in fixed point.
+///	</summary>
+static double KernelEdgeIntersectionsExact(
+	KernelBenchmarkInput & input,
+	size_t & sOps
+) {
+	MeshUtilitiesExact utils;
+
+	const std::vector<NodeExact> & nodesSource = input.vecSourceNodesExact;
+	const std::vector<NodeExact> & nodesTarget = input.vecTargetNodesExact;
+
+	std::vector<NodeExact> vecIntersections;
+
+	double dChecksum = 0.0;
+	sOps = 0;
+
+	for (size_t p = 0; p < input.vecSourceFace.size(); p++) {
+		const Face & faceSource = input.meshSource.faces[input.vecSourceFace[p]];
+		const Face & faceTarget = input.meshTarget.faces[input.vecTargetFace[p]];
+
+		for (int i = 0; i < faceSource.edges.size(); i++) {
+			const Edge & edgeSource = faceSource.edges[i];
+			for (int j = 0; j < faceTarget.edges.size(); j++) {
+				const Edge & edgeTarget = faceTarget.edges[j];
+
+				vecIntersections.clear();
+				utils.CalculateEdgeIntersections(
+					nodesSource[edgeSource[0]],
+					nodesSource[edgeSource[1]],
+					edgeSource.type,
+					nodesTarget[edgeTarget[0]],
+					nodesTarget[edgeTarget[1]],
+					edgeTarget.type,
+					vecIntersections);
+
+				dChecksum += static_cast<double>(vecIntersections.size());
+				sOps++;
+			}
+		}
+	}
+
+	return dChecksum;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Location of every corner of the target face of each overlapping
+///		pair of faces with respect to the source face.
+///	</summary>
+template <class MeshUtilities>
+static double KernelContainsNode(
+	KernelBenchmarkInput & input,
+	size_t & sOps
+) {
+	MeshUtilities utils;
+
+	const NodeVector & nodesSource = input.meshSource.nodes;
+	const NodeVector & nodesTarget = input.meshTarget.nodes;
+
+	double dChecksum = 0.0;
+	sOps = 0;
+
+	for (size_t p = 0; p < input.vecSourceFace.size(); p++) {
+		const Face & faceSource = input.meshSource.faces[input.vecSourceFace[p]];
+		const Face & faceTarget = input.meshTarget.faces[input.vecTargetFace[p]];
+
+		for (int j = 0; j < faceTarget.edges.size(); j++) {
+			Face::NodeLocation loc;
+			int ixLocation;
+
+			utils.ContainsNode(
+				faceSource,
+				nodesSource,
+				nodesTarget[faceTarget[j]],
+				loc,
+				ixLocation);
+
+			dChecksum += static_cast<double>(loc);
+			sOps++;
+		}
+	}
+
+	return dChecksum;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Overlap polygon of each overlapping pair of faces.
+///	</summary>
+static double KernelOverlapFace(
+	KernelBenchmarkInput & input,
+	size_t & sOps
+) {
+	OverlapFaceWorkspace workspace;
+
+	double dChecksum = 0.0;
+	sOps = 0;
+
+	for (size_t p = 0; p < input.vecSourceFace.size(); p++) {
+		workspace.nodevecOutput.clear();
+
+		GenerateOverlapFace<MeshUtilitiesFuzzy, Node>(
+			input.meshSource,
+			input.meshTarget,
+			input.vecSourceFace[p],
+			input.vecTargetFace[p],
+			workspace);
+
+		dChecksum += static_cast<double>(workspace.nodevecOutput.size());
+		sOps++;
+	}
+
+	return dChecksum;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Area of every overlap face by quadrature, one face at a time.
+///	</summary>
+static double KernelFaceAreaQuadrature(
+	KernelBenchmarkInput & input,
+	size_t & sOps
+) {
+	const FaceVector & faces = input.meshOverlap.faces;
+	const NodeVector & nodes = input.meshOverlap.nodes;
+
+	double dChecksum = 0.0;
+	for (size_t i = 0; i < faces.size(); i++) {
+		dChecksum += CalculateFaceAreaQuadratureMethod(faces[i], nodes);
+	}
+
+	sOps = faces.size();
+	return dChecksum;
+}
+
+///	<summary>
+///		Area of every overlap face by quadrature, vectorized across faces.
+///	</summary>
+static double KernelFaceAreaQuadratureBatch(
+	KernelBenchmarkInput & input,
+	size_t & sOps
+) {
+	const FaceVector & faces = input.meshOverlap.faces;
+	const NodeVector & nodes = input.meshOverlap.nodes;
+
+	DataArray1D<double> vecFaceArea(faces.size());
+	CalculateFaceAreasQuadratureMethod(
+		faces, nodes, vecFaceArea, input.nThreads);
+
+	double dChecksum = 0.0;
+	for (size_t i = 0; i < faces.size(); i++) {
+		dChecksum += vecFaceArea[i];
+	}
+
+	sOps = faces.size();
+	return dChecksum;
+}
+
+///	<summary>
+///		Area of every overlap face by Karney's method.
+///	</summary>
+static double KernelFaceAreaKarney(
+	KernelBenchmarkInput & input,
+	size_t & sOps
+) {
+	const FaceVector & faces = input.meshOverlap.faces;
+	const NodeVector & nodes = input.meshOverlap.nodes;
+
+	double dChecksum = 0.0;
+	for (size_t i = 0; i < faces.size(); i++) {
+		dChecksum += CalculateFaceAreaKarneysMethod(faces[i], nodes);
+	}
+
+	sOps = faces.size();
+	return dChecksum;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Sum of all target fields.
+///	</summary>
+static double KernelTargetChecksum(
+	const KernelBenchmarkInput & input
+) {
+	double dChecksum = 0.0;
+	for (int f = 0; f < input.dataTarget.GetRows(); f++) {
+		for (int j = 0; j < input.dataTarget.GetColumns(); j++) {
+			dChecksum += input.dataTarget[f][j];
+		}
+	}
+	return dChecksum;
+}
+
+///	<summary>
+///		Map applied to each field in turn, traversing the assembly form.
+///	</summary>
+static double KernelSparseApplyAssembly(
+	KernelBenchmarkInput & input,
+	size_t & sOps
+) {
+	const int nSourceCount = static_cast<int>(input.dataSource.GetColumns());
+	const int nTargetCount = static_cast<int>(input.dataTarget.GetColumns());
+
+	DataArray1D<double> dataIn(nSourceCount, false);
+	DataArray1D<double> dataOut(nTargetCount, false);
+
+	for (int f = 0; f < input.dataSource.GetRows(); f++) {
+		dataIn.AttachToData(input.dataSource(f));
+		dataOut.AttachToData(input.dataTarget(f));
+		input.matAssembly.Apply(dataIn, dataOut);
+		dataIn.Detach();
+		dataOut.Detach();
+	}
+
+	sOps = input.matAssembly.GetNonZeroCount() * input.dataSource.GetRows();
+	return KernelTargetChecksum(input);
+}
+
+///	<summary>
+///		Map applied to each field in turn, traversing the frozen form.
+///	</summary>
+static double KernelSparseApplyFrozen(
+	KernelBenchmarkInput & input,
+	size_t & sOps
+) {
+	const int nSourceCount = static_cast<int>(input.dataSource.GetColumns());
+	const int nTargetCount = static_cast<int>(input.dataTarget.GetColumns());
+
+	DataArray1D<double> dataIn(nSourceCount, false);
+	DataArray1D<double> dataOut(nTargetCount, false);
+
+	for (int f = 0; f < input.dataSource.GetRows(); f++) {
+		dataIn.AttachToData(input.dataSource(f));
+		dataOut.AttachToData(input.dataTarget(f));
+		input.matFrozen.Apply(dataIn, dataOut);
+		dataIn.Detach();
+		dataOut.Detach();
+	}
+
+	sOps = input.matFrozen.GetNonZeroCount() * input.dataSource.GetRows();
+	return KernelTargetChecksum(input);
+}
+
+///	<summary>
+///		Map applied to all fields at once with the register-blocked kernel.
+///	</summary>
+static double KernelSparseApplyBlock(
+	KernelBenchmarkInput & input,
+	size_t & sOps
+) {
+	input.matFrozen.Apply(
+		input.dataSource, input.dataTarget, input.nThreads);
+
+	sOps = input.matFrozen.GetNonZeroCount() * input.dataSource.GetRows();
+	return KernelTargetChecksum(input);
+}
+
+///	<summary>
+///		Map applied to all fields at once with the strided kernel.
+///	</summary>
+static double KernelSparseApplyStrided(
+	KernelBenchmarkInput & input,
+	size_t & sOps
+) {
+	const int nSourceCount = static_cast<int>(input.dataSource.GetColumns());
+	const int nTargetCount = static_cast<int>(input.dataTarget.GetColumns());
+
+	input.matFrozen.Apply<double>(
+		input.dataSource(0), nSourceCount, 1,
+		input.dataTarget(0), nTargetCount, 1,
+		static_cast<int>(input.dataSource.GetRows()),
+		nTargetCount,
+		input.nThreads);
+
+	sOps = input.matFrozen.GetNonZeroCount() * input.dataSource.GetRows();
+	return KernelTargetChecksum(input);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Edge map of the source mesh.
+///	</summary>
+static double KernelConstructEdgeMap(
+	KernelBenchmarkInput & input,
+	size_t & sOps
+) {
+	input.meshSource.edgemap.clear();
+	input.meshSource.ConstructEdgeMap(false);
+
+	sOps = input.meshSource.faces.size();
+	return static_cast<double>(input.meshSource.edgemap.size());
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Insertion of the corner nodes of the overlap faces into an empty
+///		NodeMap.
+///	</summary>
+static double KernelNodeMapInsert(
+	KernelBenchmarkInput & input,
+	size_t & sOps
+) {
+	NodeMap * pNodeMap = NewKernelBenchmarkNodeMap();
+
+	double dChecksum =
+		InsertKernelBenchmarkNodes(input.vecCornerNodes, *pNodeMap);
+
+	delete pNodeMap;
+
+	sOps = input.vecCornerNodes.size();
+	return dChecksum;
+}
+
+///	<summary>
+///		Lookup of the corner nodes of the overlap faces in a NodeMap that
+///		contains them.
+///	</summary>
+static double KernelNodeMapFind(
+	KernelBenchmarkInput & input,
+	size_t & sOps
+) {
+	const NodeMap & nodemap = *(input.pNodeMap);
+
+	double dChecksum = 0.0;
+	for (size_t i = 0; i < input.vecCornerNodes.size(); i++) {
+		NodeMapConstIterator iter = nodemap.find(input.vecCornerNodes[i]);
+		if (iter != nodemap.end()) {
+			dChecksum += static_cast<double>(iter->second);
+		}
+	}
+
+	sOps = input.vecCornerNodes.size();
+	return dChecksum;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Sign of the triple product of the corners of each target face, in
+///		fixed point without the floating point filter.
+///	</summary>
+static double KernelFixedPointTripleProduct(
+	KernelBenchmarkInput & input,
+	size_t & sOps
+) {
+	const std::vector<NodeExact> & nodes = input.vecTargetNodesExact;
+
+	double dChecksum = 0.0;
+	sOps = 0;
+
+	for (size_t i = 0; i < input.meshTarget.faces.size(); i++) {
+		const Face & face = input.meshTarget.faces[i];
+		const int nEdges = static_cast<int>(face.edges.size());
+
+		for (int k = 0; k < nEdges; k++) {
+			dChecksum += static_cast<double>(Sign(
+				DotProductX(
+					CrossProductX(
+						nodes[face[k]],
+						nodes[face[(k+1) % nEdges]]),
+					nodes[face[(k+2) % nEdges]])));
+			sOps++;
+		}
+	}
+
+	return dChecksum;
+}
+
+///	<summary>
+///		As KernelFixedPointTripleProduct, through SignOfTripleProduct(),
+///		which applies the floating point filter when it is enabled.
+///	</summary>
+static double KernelFixedPointTripleProductFiltered(
+	KernelBenchmarkInput & input,
+	size_t & sOps
+) {
+	const NodeVector & nodes = input.meshTarget.nodes;
+
+	double dChecksum = 0.0;
+	sOps = 0;
+
+	for (size_t i = 0; i < input.meshTarget.faces.size(); i++) {
+		const Face & face = input.meshTarget.faces[i];
+		const int nEdges = static_cast<int>(face.edges.size());
+
+		for (int k = 0; k < nEdges; k++) {
+			dChecksum += static_cast<double>(SignOfTripleProduct(
+				nodes[face[k]],
+				nodes[face[(k+1) % nEdges]],
+				nodes[face[(k+2) % nEdges]]));
+			sOps++;
+		}
+	}
+
+	return dChecksum;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		A kernel of the benchmark.
+///	</summary>
+typedef double (*KernelBenchmarkFunction)(
+	KernelBenchmarkInput & input,
+	size_t & sOps);
+
+///	<summary>
+///		Name, group and function of each kernel.  Kernels of the same
+///		group are variants of one operation; variants of the sparse and
+///		face area kernels produce the same checksum, while the fuzzy and
+///		exact geometric predicates may differ on degenerate inputs.
+///	</summary>
+struct KernelBenchmarkEntry {
+	const char * szName;
+	const char * szGroup;
+	KernelBenchmarkFunction pFunction;
+};
+
+static const KernelBenchmarkEntry KernelBenchmarkTable[] = {
+	{"edge_intersections_fuzzy", "edge_intersections", KernelEdgeIntersectionsFuzzy},
+	{"edge_intersections_exact", "edge_intersections", KernelEdgeIntersectionsExact},
+	{"contains_node_fuzzy", "contains_node", KernelContainsNode<MeshUtilitiesFuzzy>},
+	{"contains_node_exact", "contains_node", KernelContainsNode<MeshUtilitiesExact>},
+	{"overlap_face", "overlap_face", KernelOverlapFace},
+	{"face_area_quadrature", "face_area", KernelFaceAreaQuadrature},
+	{"face_area_quadrature_batch", "face_area", KernelFaceAreaQuadratureBatch},
+	{"face_area_karney", "face_area", KernelFaceAreaKarney},
+	{"sparse_apply_assembly", "sparse_apply", KernelSparseApplyAssembly},
+	{"sparse_apply_frozen", "sparse_apply", KernelSparseApplyFrozen},
+	{"sparse_apply_block", "sparse_apply", KernelSparseApplyBlock},
+	{"sparse_apply_strided", "sparse_apply", KernelSparseApplyStrided},
+	{"construct_edge_map", "construct_edge_map", KernelConstructEdgeMap},
+	{"nodemap_insert", "nodemap_insert", KernelNodeMapInsert},
+	{"nodemap_find", "nodemap_find", KernelNodeMapFind},
+	{"fixed_point_triple_product", "triple_product", KernelFixedPointTripleProduct},
+	{"fixed_point_triple_product_filtered", "triple_product", KernelFixedPointTripleProductFiltered}
+};
+
+static const int KernelBenchmarkCount =
+	sizeof(KernelBenchmarkTable) / sizeof(KernelBenchmarkEntry);
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Timings of one kernel.
+///	</summary>
+struct KernelBenchmarkResult {
+
+	///	<summary>
+	///		Index of the kernel in KernelBenchmarkTable.
+	///	</summary>
+	int iKernel;
+
+	///	<summary>
+	///		Number of operations per pass.
+	///	</summary>
+	size_t sOps;
+
+	///	<summary>
+	///		Checksum of the results of the kernel.
+	///	</summary>
+	double dChecksum;
+
+	///	<summary>
+	///		Time of each pass (in seconds).
+	///	</summary>
+	std::vector<double> vecTimes;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Write the benchmark results as JSON.  The compile-time selection
+///		of data structures and kernels is recorded so that results from
+///		different builds can be compared.
+///	</summary>
+static void WriteKernelBenchmarkJSON(
+	FILE * fp,
+	const std::string & strSourceType,
+	int nSourceResolution,
+	const std::string & strTargetType,
+	int nTargetResolution,
+	const KernelBenchmarkInput & input,
+	int nRepeat,
+	const std::vector<KernelBenchmarkResult> & vecResults
+) {
+#if defined(USE_EXACT_ARITHMETIC_FILTER)
+	const char * szExactFilter = "true";
+#else
+	const char * szExactFilter = "false";
+#endif
+
+	fprintf(fp, "{\n");
+	fprintf(fp, "  \"benchmark\": \"BenchmarkKernels\",\n");
+	fprintf(fp, "  \"source_mesh\": {\"type\": \"%s\", \"resolution\": %i, "
+		"\"faces\": %i},\n",
+		strSourceType.c_str(), nSourceResolution,
+		static_cast<int>(input.meshSource.faces.size()));
+	fprintf(fp, "  \"target_mesh\": {\"type\": \"%s\", \"resolution\": %i, "
+		"\"faces\": %i},\n",
+		strTargetType.c_str(), nTargetResolution,
+		static_cast<int>(input.meshTarget.faces.size()));
+	fprintf(fp, "  \"overlap_faces\": %i,\n",
+		static_cast<int>(input.meshOverlap.faces.size()));
+	fprintf(fp, "  \"nnz\": %lu,\n", input.matFrozen.GetNonZeroCount());
+	fprintf(fp, "  \"fields\": %i,\n",
+		static_cast<int>(input.dataSource.GetRows()));
+	fprintf(fp, "  \"nthreads\": %i,\n", input.nThreads);
+	fprintf(fp, "  \"repeat\": %i,\n", nRepeat);
+	fprintf(fp, "  \"config\": {\"node_map\": \"%s\", "
+		"\"exact_arithmetic_filter\": %s},\n",
+		KernelBenchmarkNodeMapName(), szExactFilter);
+	fprintf(fp, "  \"kernels\": [\n");
+
+	for (int r = 0; r < vecResults.size(); r++) {
+		const KernelBenchmarkResult & result = vecResults[r];
+		const KernelBenchmarkEntry & entry =
+			KernelBenchmarkTable[result.iKernel];
+
+		double dMin = result.vecTimes[0];
+		double dMax = result.vecTimes[0];
+		double dSum = 0.0;
+		for (int i = 0; i < result.vecTimes.size(); i++) {
+			dMin = std::min(dMin, result.vecTimes[i]);
+			dMax = std::max(dMax, result.vecTimes[i]);
+			dSum += result.vecTimes[i];
+		}
+
+		double dNsPerOp = 0.0;
+		if (result.sOps != 0) {
+			dNsPerOp = 1.0e9 * dMin / static_cast<double>(result.sOps);
+		}
+
+		fprintf(fp, "    {\"name\": \"%s\", \"group\": \"%s\", "
+			"\"ops\": %lu, \"checksum\": %.15e, \"ns_per_op\": %.6e, "
+			"\"min\": %.6e, \"mean\": %.6e, \"max\": %.6e, \"samples\": [",
+			entry.szName, entry.szGroup, result.sOps, result.dChecksum,
+			dNsPerOp, dMin,
+			dSum / static_cast<double>(result.vecTimes.size()), dMax);
+
+		for (int i = 0; i < result.vecTimes.size(); i++) {
+			fprintf(fp, "%s%.6e", (i == 0)?(""):(", "), result.vecTimes[i]);
+		}
+
+		fprintf(fp, "]}%s\n", (r == vecResults.size()-1)?(""):(","));
+	}
+
+	fprintf(fp, "  ]\n");
+	fprintf(fp, "}\n");
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+int main(int argc, char** argv) {
+
+	NcError error(NcError::silent_nonfatal);
+
+try {
+	// Source mesh type and resolution
+	std::string strSourceType;
+	int nSourceResolution;
+
+	// Target mesh type and resolution
+	std::string strTargetType;
+	int nTargetResolution;
+
+	// Comma-separated list of kernels
+	std::string strKernels;
+
+	// Number of timed passes of each kernel
+	int nRepeat;
+
+	// Number of fields to remap in the sparse kernels
+	int nFields;
+
+	// Number of threads
+	int nThreads;
+
+	// Output JSON file
+	std::string strOutputFile;
+
+	// Show announcements from mesh generation
+	bool fVerbose;
+
+	// Parse the command line
+	BeginCommandLine()
+		CommandLineStringD(strSourceType, "src_mesh", "cs", "[cs|rll|ico|icod]");
+		CommandLineInt(nSourceResolution, "src_res", 32);
+		CommandLineStringD(strTargetType, "tgt_mesh", "rll", "[cs|rll|ico|icod]");
+		CommandLineInt(nTargetResolution, "tgt_res", 90);
+		CommandLineStringD(strKernels, "kernels", "all", "comma-separated names or groups");
+		CommandLineInt(nRepeat, "repeat", 5);
+		CommandLineInt(nFields, "fields", 8);
+		CommandLineInt(nThreads, "nthreads", 1);
+		CommandLineString(strOutputFile, "out", "benchmark_kernels.json");
+		CommandLineBool(fVerbose, "verbose");
+
+		ParseCommandLine(argc, argv);
+	EndCommandLine(argv)
+
+	AnnounceBanner();
+
+	// Check arguments
+	STLStringHelper::ToLower(strSourceType);
+	STLStringHelper::ToLower(strTargetType);
+	STLStringHelper::ToLower(strKernels);
+
+	if ((nSourceResolution < 1) || (nTargetResolution < 1)) {
+		_EXCEPTIONT("--src_res and --tgt_res must be at least 1");
+	}
+	if (nRepeat < 1) {
+		_EXCEPTIONT("--repeat must be at least 1");
+	}
+	if (nFields < 1) {
+		_EXCEPTIONT("--fields must be at least 1");
+	}
+	if (nThreads < 1) {
+		_EXCEPTIONT("--nthreads must be at least 1");
+	}
+	if (strOutputFile == "") {
+		_EXCEPTIONT("Output file (--out) must be specified");
+	}
+
+	// Select kernels by name or group
+	std::vector<std::string> vecKernels;
+	ParseBenchmarkList(strKernels, vecKernels);
+
+	std::vector<bool> vecSelected(KernelBenchmarkCount, false);
+	for (int i = 0; i < vecKernels.size(); i++) {
+		bool fFound = false;
+		for (int k = 0; k < KernelBenchmarkCount; k++) {
+			if ((vecKernels[i] == "all") ||
+			    (vecKernels[i] == KernelBenchmarkTable[k].szName) ||
+			    (vecKernels[i] == KernelBenchmarkTable[k].szGroup)
+			) {
+				vecSelected[k] = true;
+				fFound = true;
+			}
+		}
+		if (!fFound) {
+			_EXCEPTION1("Invalid --kernels value (%s)", vecKernels[i].c_str());
+		}
+	}
+
+	// Build synthetic inputs
+	AnnounceStartBlock("Generating inputs");
+
+	KernelBenchmarkInput input;
+
+	bool fOutputEnabled = AnnounceGetOutputEnabled();
+	AnnounceSetOutputEnabled(fVerbose);
+
+	try {
+		BuildKernelBenchmarkInput(
+			strSourceType, nSourceResolution,
+			strTargetType, nTargetResolution,
+			nFields, nThreads, input);
+
+	} catch(...) {
+		AnnounceSetOutputEnabled(fOutputEnabled);
+		throw;
+	}
+
+	AnnounceSetOutputEnabled(fOutputEnabled);
+
+	Announce("Source faces:  %i", static_cast<int>(input.meshSource.faces.size()));
+	Announce("Target faces:  %i", static_cast<int>(input.meshTarget.faces.size()));
+	Announce("Overlap faces: %i", static_cast<int>(input.meshOverlap.faces.size()));
+	Announce("NodeMap:       %s", KernelBenchmarkNodeMapName());
+	AnnounceEndBlock("Done");
+
+	// Time each kernel after one untimed pass
+	AnnounceStartBlock("Running kernels");
+
+	std::vector<KernelBenchmarkResult> vecResults;
+
+	for (int k = 0; k < KernelBenchmarkCount; k++) {
+		if (!vecSelected[k]) {
+			continue;
+		}
+
+		KernelBenchmarkResult result;
+		result.iKernel = k;
+		result.dChecksum =
+			KernelBenchmarkTable[k].pFunction(input, result.sOps);
+
+		for (int r = 0; r < nRepeat; r++) {
+			size_t sOps;
+			double dTime = BenchmarkTime();
+			KernelBenchmarkTable[k].pFunction(input, sOps);
+			result.vecTimes.push_back(BenchmarkTime() - dTime);
+		}
+
+		double dMin = *std::min_element(
+			result.vecTimes.begin(), result.vecTimes.end());
+
+		double dNsPerOp = 0.0;
+		if (result.sOps != 0) {
+			dNsPerOp = 1.0e9 * dMin / static_cast<double>(result.sOps);
+		}
+
+		Announce("%-36s %12lu ops %12.3f ns/op (checksum %1.10e)",
+			KernelBenchmarkTable[k].szName, result.sOps, dNsPerOp,
+			result.dChecksum);
+
+		vecResults.push_back(result);
+	}
+
+	AnnounceEndBlock("Done");
+
+	// Write results
+	AnnounceStartBlock("Writing results");
+	Announce("Output file: %s", strOutputFile.c_str());
+
+	FILE * fp = fopen(strOutputFile.c_str(), "w");
+	if (fp == NULL) {
+		_EXCEPTION1("Unable to open output file \"%s\"", strOutputFile.c_str());
+	}
+
+	WriteKernelBenchmarkJSON(
+		fp,
+		strSourceType, nSourceResolution,
+		strTargetType, nTargetResolution,
+		input, nRepeat,
+		vecResults);
+
+	fclose(fp);
+
+	delete input.pNodeMap;
+
+	AnnounceEndBlock("Done");
+
+	return (0);
+
+} catch(Exception & e) {
+	AnnounceSetOutputEnabled(true);
+	Announce(e.ToString().c_str());
+	return (-1);
+
+} catch(...) {
+	return (-2);
+}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
@@ -0,0 +1,628 @@
+///////////////////////////////////////////////////////////////////////////////
+///
+///	\file    BenchmarkRemap.cpp
+///	\author  agent
+///	\version October 14, 2026
+///
+///	<remarks>
+///		Copyright 2026 agent
+///
+///		This file is distributed as part of the Tempest source code package.
+///		Permission is granted to use, copy, modify and distribute this
+///		source code and its documentation under the terms of the GNU General
+///		Public License.  This software is provided "as is" without express
+///		or implied warranty.
+///	</remarks>
+
+#include "Announce.h"
+#include "CommandLine.h"
+#include "Exception.h"
+#include "GridElements.h"
+#include "OverlapMesh.h"
+#include "OfflineMap.h"
+#include "OfflineMapGenerator.h"
+#include "STLStringHelper.h"
+#include "TempestRemapAPI.h"
+
+#include "netcdfcpp.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Names of the timed stages of the remap pipeline, in order.
+///	</summary>
+static const char * BenchmarkStageNames[] = {
+	"mesh_read",
+	"face_areas",
+	"edge_map",
+	"overlap",
+	"map_build",
+	"apply",
+	"total"
+};
+
+static const int BenchmarkStageCount = 7;
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Wall clock time in seconds.
+///	</summary>
+static double BenchmarkTime() {
+	return std::chrono::duration<double>(
+		std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Split a comma-separated list.
+///	</summary>
+static void ParseBenchmarkList(
+	const std::string & strList,
+	std::vector<std::string> & vecItems
+) {
+	vecItems.clear();
+
+	size_t iBegin = 0;
+	for (;;) {
+		size_t iEnd = strList.find(',', iBegin);
+		if (iEnd == std::string::npos) {
+			iEnd = strList.length();
+		}
+		if (iEnd > iBegin) {
+			vecItems.push_back(strList.substr(iBegin, iEnd - iBegin));
+		}
+		if (iEnd == strList.length()) {
+			break;
+		}
+		iBegin = iEnd + 1;
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Split a comma-separated list of positive integers.
+///	</summary>
+static void ParseBenchmarkIntList(
+	const std::string & strList,
+	const char * szName,
+	std::vector<int> & vecItems
+) {
+	std::vector<std::string> vecStrings;
+	ParseBenchmarkList(strList, vecStrings);
+
+	vecItems.clear();
+	for (int i = 0; i < vecStrings.size(); i++) {
+		int nValue = atoi(vecStrings[i].c_str());
+		if (nValue < 1) {
+			_EXCEPTION2("Invalid --%s value (%s), expected positive integers",
+				szName, vecStrings[i].c_str());
+		}
+		vecItems.push_back(nValue);
+	}
+	if (vecItems.size() == 0) {
+		_EXCEPTION1("--%s must contain at least one value", szName);
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Generate a mesh of the given type [cs|rll|ico|icod] and resolution
+///		and write it to strFile.  The resolution is the number of elements
+///		along each cube edge for cs, the number of latitudes (with twice
+///		as many longitudes) for rll and the refinement level for ico and
+///		its dual icod.
+///	</summary>
+static void GenerateBenchmarkMesh(
+	const std::string & strType,
+	int nResolution,
+	const std::string & strFile,
+	int nThreads
+) {
+	Mesh mesh;
+
+	int err;
+	if (strType == "cs") {
+		err = GenerateCSMesh(
+			mesh, nResolution, false, strFile, "Netcdf4", nThreads);
+
+	} else if (strType == "rll") {
+		err = GenerateRLLMesh(
+			mesh, 2 * nResolution, nResolution,
+			0.0, 360.0, -90.0, 90.0,
+			false, false, false,
+			"", strFile, "Netcdf4", false);
+
+	} else if (strType == "ico") {
+		err = GenerateICOMesh(
+			mesh, nResolution, false, strFile, "Netcdf4", nThreads);
+
+	} else if (strType == "icod") {
+		err = GenerateICOMesh(
+			mesh, nResolution, true, strFile, "Netcdf4", nThreads);
+
+	} else {
+		_EXCEPTION1("Invalid mesh type (%s), expected [cs|rll|ico|icod]",
+			strType.c_str());
+	}
+
+	if (err) {
+		_EXCEPTION1("Unable to generate mesh \"%s\"", strFile.c_str());
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Timings and statistics for one configuration of the benchmark.
+///	</summary>
+struct BenchmarkResult {
+
+	///	<summary>
+	///		Overlap mesh method.
+	///	</summary>
+	std::string strMethod;
+
+	///	<summary>
+	///		Polynomial order on the source and target meshes.
+	///	</summary>
+	int nPin;
+	int nPout;
+
+	///	<summary>
+	///		Number of faces in the source, target and overlap meshes.
+	///	</summary>
+	int nSourceFaces;
+	int nTargetFaces;
+	int nOverlapFaces;
+
+	///	<summary>
+	///		Number of source and target degrees of freedom.
+	///	</summary>
+	int nSourceCount;
+	int nTargetCount;
+
+	///	<summary>
+	///		Number of nonzero entries in the map.
+	///	</summary>
+	size_t sNonZeros;
+
+	///	<summary>
+	///		Time of each stage for each repetition (in seconds).
+	///	</summary>
+	std::vector< std::vector<double> > vecStageTimes;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Run the remap pipeline once, appending the time of each stage to
+///		result.
+///	</summary>
+static void RunBenchmarkPipeline(
+	const std::string & strSourceFile,
+	const std::string & strTargetFile,
+	const OfflineMapOptions & options,
+	int nFields,
+	BenchmarkResult & result
+) {
+	OverlapMeshMethod method;
+	if (options.strOverlapMethod == "fuzzy") {
+		method = OverlapMeshMethod_Fuzzy;
+	} else if (options.strOverlapMethod == "exact") {
+		method = OverlapMeshMethod_Exact;
+	} else if (options.strOverlapMethod == "mixed") {
+		method = OverlapMeshMethod_Mixed;
+	} else if (options.strOverlapMethod == "bvh") {
+		method = OverlapMeshMethod_BVH;
+	} else {
+		_EXCEPTION1("Invalid --method value (%s), expected [fuzzy|exact|mixed|bvh]",
+			options.strOverlapMethod.c_str());
+	}
+
+	const int nThreads = options.nThreads;
+
+	double dTime[BenchmarkStageCount];
+
+	const double dTimeBegin = BenchmarkTime();
+
+	// Read meshes
+	double dTimeStage = BenchmarkTime();
+
+	Mesh meshSource(strSourceFile);
+	meshSource.RemoveZeroEdges();
+
+	Mesh meshTarget(strTargetFile);
+	meshTarget.RemoveZeroEdges();
+
+	dTime[0] = BenchmarkTime() - dTimeStage;
+
+	// Face areas
+	dTimeStage = BenchmarkTime();
+	meshSource.CalculateFaceAreas(options.fSourceConcave, nThreads);
+	meshTarget.CalculateFaceAreas(options.fTargetConcave, nThreads);
+	dTime[1] = BenchmarkTime() - dTimeStage;
+
+	// Edge map, reverse node array and face neighbors
+	dTimeStage = BenchmarkTime();
+	meshSource.ConstructReverseNodeArray(nThreads);
+	meshSource.ConstructEdgeMap(false);
+	meshSource.ConstructFaceNeighbors(nThreads);
+	meshTarget.ConstructEdgeMap(false);
+	meshTarget.ConstructFaceNeighbors(nThreads);
+	dTime[2] = BenchmarkTime() - dTimeStage;
+
+	// Overlap mesh
+	dTimeStage = BenchmarkTime();
+
+	Mesh meshOverlap;
+	meshOverlap.type = Mesh::MeshType_Overlap;
+
+	GenerateOverlapMesh_v2(
+		meshSource,
+		meshTarget,
+		meshOverlap,
+		method,
+		false,
+		false,
+		nThreads);
+
+	dTime[3] = BenchmarkTime() - dTimeStage;
+
+	// Offline map
+	dTimeStage = BenchmarkTime();
+
+	OfflineMap mapRemap;
+	GenerateOfflineMapWithOptions(
+		mapRemap,
+		meshSource,
+		meshTarget,
+		meshOverlap,
+		options,
+		true);
+
+	dTime[4] = BenchmarkTime() - dTimeStage;
+
+	// Apply the map to synthetic fields
+	const int nSourceCount =
+		static_cast<int>(mapRemap.GetSourceAreas().GetRows());
+	const int nTargetCount =
+		static_cast<int>(mapRemap.GetTargetAreas().GetRows());
+
+	std::vector<double> vecSource(
+		static_cast<size_t>(nSourceCount) * nFields);
+	std::vector<double> vecTarget(
+		static_cast<size_t>(nTargetCount) * nFields);
+
+	for (size_t i = 0; i < vecSource.size(); i++) {
+		vecSource[i] = 2.0 + sin(0.001 * static_cast<double>(i));
+	}
+
+	dTimeStage = BenchmarkTime();
+	mapRemap.Apply(
+		&(vecSource[0]), nSourceCount, nSourceCount, 1,
+		&(vecTarget[0]), nTargetCount, nTargetCount, 1,
+		nFields);
+	dTime[5] = BenchmarkTime() - dTimeStage;
+
+	dTime[6] = BenchmarkTime() - dTimeBegin;
+
+	// Store results
+	result.nSourceFaces = static_cast<int>(meshSource.faces.size());
+	result.nTargetFaces = static_cast<int>(meshTarget.faces.size());
+	result.nOverlapFaces = static_cast<int>(meshOverlap.faces.size());
+	result.nSourceCount = nSourceCount;
+	result.nTargetCount = nTargetCount;
+	result.sNonZeros = mapRemap.GetSparseMatrix().GetNonZeroCount();
+
+	result.vecStageTimes.resize(BenchmarkStageCount);
+	for (int s = 0; s < BenchmarkStageCount; s++) {
+		result.vecStageTimes[s].push_back(dTime[s]);
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Write the benchmark results as JSON.
+///	</summary>
+static void WriteBenchmarkJSON(
+	FILE * fp,
+	const std::string & strSourceType,
+	int nSourceResolution,
+	const std::string & strTargetType,
+	int nTargetResolution,
+	const std::string & strInputType,
+	const std::string & strOutputType,
+	int nThreads,
+	int nFields,
+	int nRepeat,
+	double dGenerateTime,
+	const std::vector<BenchmarkResult> & vecResults
+) {
+	fprintf(fp, "{\n");
+	fprintf(fp, "  \"benchmark\": \"BenchmarkRemap\",\n");
+	fprintf(fp, "  \"source_mesh\": {\"type\": \"%s\", \"resolution\": %i},\n",
+		strSourceType.c_str(), nSourceResolution);
+	fprintf(fp, "  \"target_mesh\": {\"type\": \"%s\", \"resolution\": %i},\n",
+		strTargetType.c_str(), nTargetResolution);
+	fprintf(fp, "  \"in_type\": \"%s\",\n", strInputType.c_str());
+	fprintf(fp, "  \"out_type\": \"%s\",\n", strOutputType.c_str());
+	fprintf(fp, "  \"nthreads\": %i,\n", nThreads);
+	fprintf(fp, "  \"fields\": %i,\n", nFields);
+	fprintf(fp, "  \"repeat\": %i,\n", nRepeat);
+	fprintf(fp, "  \"mesh_generate\": %.6e,\n", dGenerateTime);
+	fprintf(fp, "  \"results\": [\n");
+
+	for (int r = 0; r < vecResults.size(); r++) {
+		const BenchmarkResult & result = vecResults[r];
+
+		fprintf(fp, "    {\n");
+		fprintf(fp, "      \"method\": \"%s\",\n", result.strMethod.c_str());
+		fprintf(fp, "      \"in_np\": %i,\n", result.nPin);
+		fprintf(fp, "      \"out_np\": %i,\n", result.nPout);
+		fprintf(fp, "      \"source_faces\": %i,\n", result.nSourceFaces);
+		fprintf(fp, "      \"target_faces\": %i,\n", result.nTargetFaces);
+		fprintf(fp, "      \"overlap_faces\": %i,\n", result.nOverlapFaces);
+		fprintf(fp, "      \"source_dofs\": %i,\n", result.nSourceCount);
+		fprintf(fp, "      \"target_dofs\": %i,\n", result.nTargetCount);
+		fprintf(fp, "      \"nnz\": %lu,\n", result.sNonZeros);
+		fprintf(fp, "      \"stages\": {\n");
+
+		for (int s = 0; s < BenchmarkStageCount; s++) {
+			const std::vector<double> & vecTimes = result.vecStageTimes[s];
+
+			double dMin = vecTimes[0];
+			double dMax = vecTimes[0];
+			double dSum = 0.0;
+			for (int i = 0; i < vecTimes.size(); i++) {
+				dMin = std::min(dMin, vecTimes[i]);
+				dMax = std::max(dMax, vecTimes[i]);
+				dSum += vecTimes[i];
+			}
+
+			fprintf(fp, "        \"%s\": {\"min\": %.6e, \"mean\": %.6e, "
+				"\"max\": %.6e, \"samples\": [",
+				BenchmarkStageNames[s], dMin,
+				dSum / static_cast<double>(vecTimes.size()), dMax);
+
+			for (int i = 0; i < vecTimes.size(); i++) {
+				fprintf(fp, "%s%.6e", (i == 0)?(""):(", "), vecTimes[i]);
+			}
+
+			fprintf(fp, "]}%s\n", (s == BenchmarkStageCount-1)?(""):(","));
+		}
+
+		fprintf(fp, "      }\n");
+		fprintf(fp, "    }%s\n", (r == vecResults.size()-1)?(""):(","));
+	}
+
+	fprintf(fp, "  ]\n");
+	fprintf(fp, "}\n");
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+int main(int argc, char** argv) {
+
+	NcError error(NcError::silent_nonfatal);
+
+try {
+	// Source mesh type and resolution
+	std::string strSourceType;
+	int nSourceResolution;
+
+	// Target mesh type and resolution
+	std::string strTargetType;
+	int nTargetResolution;
+
+	// Discretization of the source and target meshes
+	std::string strInputType;
+	std::string strOutputType;
+
+	// Comma-separated lists of polynomial orders
+	std::string strInputOrders;
+	std::string strOutputOrders;
+
+	// Comma-separated list of overlap mesh methods
+	std::string strMethods;
+
+	// Number of repetitions of each configuration
+	int nRepeat;
+
+	// Number of fields to remap in the apply stage
+	int nFields;
+
+	// Number of threads
+	int nThreads;
+
+	// Directory for generated mesh files
+	std::string strWorkDir;
+
+	// Output JSON file
+	std::string strOutputFile;
+
+	// Show announcements from the remap pipeline
+	bool fVerbose;
+
+	// Profile output file
+	std::string strProfileFile;
+
+	// Parse the command line
+	BeginCommandLine()
+		CommandLineStringD(strSourceType, "src_mesh", "cs", "[cs|rll|ico|icod]");
+		CommandLineInt(nSourceResolution, "src_res", 32);
+		CommandLineStringD(strTargetType, "tgt_mesh", "rll", "[cs|rll|ico|icod]");
+		CommandLineInt(nTargetResolution, "tgt_res", 90);
+		CommandLineStringD(strInputType, "in_type", "fv", "[fv|cgll|dgll]");
+		CommandLineStringD(strOutputType, "out_type", "fv", "[fv|cgll|dgll]");
+		CommandLineString(strInputOrders, "in_np", "2");
+		CommandLineString(strOutputOrders, "out_np", "2");
+		CommandLineStringD(strMethods, "method", "exact", "[fuzzy|exact|mixed|bvh], comma-separated");
+		CommandLineInt(nRepeat, "repeat", 3);
+		CommandLineInt(nFields, "fields", 1);
+		CommandLineInt(nThreads, "nthreads", 1);
+		CommandLineString(strWorkDir, "work_dir", ".");
+		CommandLineString(strOutputFile, "out", "benchmark.json");
+		CommandLineBool(fVerbose, "verbose");
+		CommandLineStringD(strProfileFile, "profile", "", "(tree, or Chrome trace if .json)");
+
+		ParseCommandLine(argc, argv);
+	EndCommandLine(argv)
+
+	AnnounceBanner();
+
+	// Check arguments
+	STLStringHelper::ToLower(strSourceType);
+	STLStringHelper::ToLower(strTargetType);
+	STLStringHelper::ToLower(strInputType);
+	STLStringHelper::ToLower(strOutputType);
+	STLStringHelper::ToLower(strMethods);
+
+	if ((nSourceResolution < 1) || (nTargetResolution < 1)) {
+		_EXCEPTIONT("--src_res and --tgt_res must be at least 1");
+	}
+	if (nRepeat < 1) {
+		_EXCEPTIONT("--repeat must be at least 1");
+	}
+	if (nFields < 1) {
+		_EXCEPTIONT("--fields must be at least 1");
+	}
+	if (nThreads < 1) {
+		_EXCEPTIONT("--nthreads must be at least 1");
+	}
+	if (strOutputFile == "") {
+		_EXCEPTIONT("Output file (--out) must be specified");
+	}
+	if (strProfileFile != "") {
+		AnnounceSetProfileOutput(strProfileFile.c_str());
+	}
+
+	std::vector<int> vecInputOrders;
+	ParseBenchmarkIntList(strInputOrders, "in_np", vecInputOrders);
+
+	std::vector<int> vecOutputOrders;
+	ParseBenchmarkIntList(strOutputOrders, "out_np", vecOutputOrders);
+
+	std::vector<std::string> vecMethods;
+	ParseBenchmarkList(strMethods, vecMethods);
+	if (vecMethods.size() == 0) {
+		_EXCEPTIONT("--method must contain at least one value");
+	}
+
+	// Generate meshes
+	char szFile[64];
+
+	snprintf(szFile, sizeof(szFile), "/bench_src_%s%i.g",
+		strSourceType.c_str(), nSourceResolution);
+	std::string strSourceFile = strWorkDir + szFile;
+
+	snprintf(szFile, sizeof(szFile), "/bench_tgt_%s%i.g",
+		strTargetType.c_str(), nTargetResolution);
+	std::string strTargetFile = strWorkDir + szFile;
+
+	AnnounceStartBlock("Generating meshes");
+	double dGenerateTime = BenchmarkTime();
+	GenerateBenchmarkMesh(
+		strSourceType, nSourceResolution, strSourceFile, nThreads);
+	GenerateBenchmarkMesh(
+		strTargetType, nTargetResolution, strTargetFile, nThreads);
+	dGenerateTime = BenchmarkTime() - dGenerateTime;
+	AnnounceEndBlock("Done");
+
+	// Run each configuration
+	std::vector<BenchmarkResult> vecResults;
+
+	for (int m = 0; m < vecMethods.size(); m++) {
+	for (int i = 0; i < vecInputOrders.size(); i++) {
+	for (int o = 0; o < vecOutputOrders.size(); o++) {
+		OfflineMapOptions options;
+		options.strSourceType = strInputType;
+		options.strTargetType = strOutputType;
+		options.nPin = vecInputOrders[i];
+		options.nPout = vecOutputOrders[o];
+		options.strOverlapMethod = vecMethods[m];
+		options.nThreads = nThreads;
+
+		BenchmarkResult result;
+		result.strMethod = vecMethods[m];
+		result.nPin = vecInputOrders[i];
+		result.nPout = vecOutputOrders[o];
+
+		char szConfig[128];
+		snprintf(szConfig, sizeof(szConfig), "Method %s, in_np %i, out_np %i",
+			vecMethods[m].c_str(), vecInputOrders[i], vecOutputOrders[o]);
+		AnnounceStartBlock(szConfig);
+
+		for (int r = 0; r < nRepeat; r++) {
+			bool fOutputEnabled = AnnounceGetOutputEnabled();
+			AnnounceSetOutputEnabled(fVerbose);
+
+			try {
+				RunBenchmarkPipeline(
+					strSourceFile, strTargetFile, options, nFields, result);
+
+			} catch(...) {
+				AnnounceSetOutputEnabled(fOutputEnabled);
+				throw;
+			}
+
+			AnnounceSetOutputEnabled(fOutputEnabled);
+
+			Announce("Run %i: total %1.6f s", r, result.vecStageTimes[6][r]);
+		}
+
+		AnnounceEndBlock(NULL);
+
+		vecResults.push_back(result);
+	}
+	}
+	}
+
+	// Write results
+	AnnounceStartBlock("Writing results");
+	Announce("Output file: %s", strOutputFile.c_str());
+
+	FILE * fp = fopen(strOutputFile.c_str(), "w");
+	if (fp == NULL) {
+		_EXCEPTION1("Unable to open output file \"%s\"", strOutputFile.c_str());
+	}
+
+	WriteBenchmarkJSON(
+		fp,
+		strSourceType, nSourceResolution,
+		strTargetType, nTargetResolution,
+		strInputType, strOutputType,
+		nThreads, nFields, nRepeat,
+		dGenerateTime,
+		vecResults);
+
+	fclose(fp);
+
+	AnnounceEndBlock("Done");
+
+	return (0);
+
+} catch(Exception & e) {
+	AnnounceSetOutputEnabled(true);
+	Announce(e.ToString().c_str());
+	return (-1);
+
+} catch(...) {
+	return (-2);
+}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
@@ -22,11 +22,284 @@
 #include "Announce.h"
 #include "DataArray1D.h"
 #include "DataArray3D.h"
+#include "ReproducibleSum.h"
 
 #include "netcdfcpp.h"
 
+#include <algorithm>
 #include <cmath>
+#include <cstdio>
+#include <cfloat>
 #include <iostream>
+#include <string>
+#include <vector>
+
+///////////////////////////////////////////////////////////////////////////////
+
+static void ParseVariableList(
+	const std::string & strVariables,
+	std::vector< std::string > & vecVariableStrings
+) {
+	int iVarBegin = 0;
+	int iVarCurrent = 0;
+
+	// Parse variable name
+	for (;;) {
+		if ((iVarCurrent >= strVariables.length()) ||
+			(strVariables[iVarCurrent] == ',') ||
+			(strVariables[iVarCurrent] == ' ')
+		) {
+			if (iVarCurrent > iVarBegin) {
+				vecVariableStrings.push_back(
+					strVariables.substr(iVarBegin, iVarCurrent - iVarBegin));
+			}
+			if (iVarCurrent >= strVariables.length()) {
+				break;
+			}
+
+			iVarBegin = iVarCurrent + 1;
+		}
+
+		iVarCurrent++;
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		A sum accumulated with Neumaier's compensated summation, so that the
+///		result is insensitive to the order and grouping of the terms.
+///	</summary>
+class CompensatedSum {
+
+public:
+	///	<summary>
+	///		Constructor.
+	///	</summary>
+	CompensatedSum() :
+		m_dSum(0.0),
+		m_dCorrection(0.0)
+	{ }
+
+	///	<summary>
+	///		Add a term to the sum.
+	///	</summary>
+	inline void Add(double d) {
+		double dT = m_dSum + d;
+		if (fabs(m_dSum) >= fabs(d)) {
+			m_dCorrection += (m_dSum - dT) + d;
+		} else {
+			m_dCorrection += (d - dT) + m_dSum;
+		}
+		m_dSum = dT;
+	}
+
+	///	<summary>
+	///		Add another partial sum to the sum.
+	///	</summary>
+	void Add(const CompensatedSum & sum) {
+		Add(sum.m_dSum);
+		m_dCorrection += sum.m_dCorrection;
+	}
+
+	///	<summary>
+	///		Get the value of the sum.
+	///	</summary>
+	double Get() const {
+		return (m_dSum + m_dCorrection);
+	}
+
+protected:
+	///	<summary>
+	///		Running sum and accumulated rounding error.
+	///	</summary>
+	double m_dSum;
+	double m_dCorrection;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Extrema and area-weighted sums of a field A and its difference from
+///		a reference field B, accumulated over partial ranges of the data.
+///	</summary>
+struct DiffNormAccumulator {
+
+	///	<summary>
+	///		Constructor.
+	///	</summary>
+	DiffNormAccumulator() :
+		dMinA(DBL_MAX),
+		dMaxA(-DBL_MAX),
+		dMinB(DBL_MAX),
+		dMaxB(-DBL_MAX),
+		dDiffLi(0.0),
+		dRefLi(0.0)
+	{ }
+
+	///	<summary>
+	///		Accumulate values of A and B with the given weight.
+	///	</summary>
+	void Add(
+		const double * dA,
+		const double * dB,
+		const double * dWeight,
+		size_t sCount
+	) {
+		for (size_t i = 0; i < sCount; i++) {
+			if (dA[i] > dMaxA) {
+				dMaxA = dA[i];
+			}
+			if (dA[i] < dMinA) {
+				dMinA = dA[i];
+			}
+			if (dB[i] > dMaxB) {
+				dMaxB = dB[i];
+			}
+			if (dB[i] < dMinB) {
+				dMinB = dB[i];
+			}
+
+			double dDiff = fabs(dA[i] - dB[i]);
+
+			sumDiffL1.Add(dDiff * dWeight[i]);
+			sumDiffL2.Add(dDiff * dDiff * dWeight[i]);
+
+			if (dDiff > dDiffLi) {
+				dDiffLi = dDiff;
+			}
+
+			sumRefL1.Add(dB[i] * dWeight[i]);
+			sumRefL2.Add(dB[i] * dB[i] * dWeight[i]);
+
+			if (dB[i] > dRefLi) {
+				dRefLi = dB[i];
+			}
+		}
+	}
+
+	///	<summary>
+	///		Combine with another partial result.
+	///	</summary>
+	void Add(
+		const DiffNormAccumulator & acc
+	) {
+		dMinA = std::min(dMinA, acc.dMinA);
+		dMaxA = std::max(dMaxA, acc.dMaxA);
+		dMinB = std::min(dMinB, acc.dMinB);
+		dMaxB = std::max(dMaxB, acc.dMaxB);
+
+		sumDiffL1.Add(acc.sumDiffL1);
+		sumDiffL2.Add(acc.sumDiffL2);
+		dDiffLi = std::max(dDiffLi, acc.dDiffLi);
+
+		sumRefL1.Add(acc.sumRefL1);
+		sumRefL2.Add(acc.sumRefL2);
+		dRefLi = std::max(dRefLi, acc.dRefLi);
+	}
+
+	///	<summary>
+	///		Extrema of A and B.
+	///	</summary>
+	double dMinA;
+	double dMaxA;
+	double dMinB;
+	double dMaxB;
+
+	///	<summary>
+	///		Weighted L1 and L2 sums and maximum of |A - B|.
+	///	</summary>
+	CompensatedSum sumDiffL1;
+	CompensatedSum sumDiffL2;
+	double dDiffLi;
+
+	///	<summary>
+	///		Weighted L1 and L2 sums and maximum of B.
+	///	</summary>
+	CompensatedSum sumRefL1;
+	CompensatedSum sumRefL2;
+	double dRefLi;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Error norms of one slice of one variable.
+///	</summary>
+struct DiffNormResult {
+	std::string strVariable;
+	long lSlice;
+
+	double dNormL1;
+	double dNormL2;
+	double dNormLi;
+	double dNormLmin;
+	double dNormLmax;
+
+	double dSumL1;
+	double dSumL2;
+	double dSumLi;
+
+	double dMinA;
+	double dMaxA;
+	double dMinB;
+	double dMaxB;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Accumulate sCount values of A and B into acc.  The range is divided
+///		into fixed blocks that are accumulated in parallel and combined by
+///		a fixed tree, so that the result does not depend on nThreads.
+///	</summary>
+static void AccumulateDiffNorms(
+	const double * dA,
+	const double * dB,
+	const double * dWeight,
+	size_t sCount,
+	int nThreads,
+	DiffNormAccumulator & acc
+) {
+	acc.Add(
+		ReproducibleReduce<DiffNormAccumulator>(
+			sCount,
+			nThreads,
+			[&](size_t sBegin, size_t sEnd) -> DiffNormAccumulator {
+				DiffNormAccumulator accBlock;
+				accBlock.Add(
+					dA + sBegin, dB + sBegin, dWeight + sBegin, sEnd - sBegin);
+				return accBlock;
+			},
+			[](DiffNormAccumulator & accA, const DiffNormAccumulator & accB) {
+				accA.Add(accB);
+			}));
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Determine if the trailing dimensions of var match the data layout.
+///	</summary>
+static bool HasDataDimensions(
+	NcVar * var,
+	const std::vector<long> & vecDataDimSizes
+) {
+	int nDims = var->num_dims();
+	int nDataDims = static_cast<int>(vecDataDimSizes.size());
+
+	if (nDims < nDataDims) {
+		return false;
+	}
+	for (int d = 0; d < nDataDims; d++) {
+		if (var->get_dim(nDims - nDataDims + d)->size()
+			!= vecDataDimSizes[d]
+		) {
+			return false;
+		}
+	}
+	return true;
+}
 
 ///////////////////////////////////////////////////////////////////////////////
 
@@ -41,9 +314,12 @@ try {
 	// Second data file
 	std::string strFileB;
 
-	// Variable to compare
+	// Variables to compare
 	std::string strVariableName;
 
+	// Compare all variables on the mesh
+	bool fAllVariables;
+
 	// Mesh file to use
 	std::string strMeshFile;
 
@@ -56,27 +332,51 @@ try {
 	// Use bubble function
 	bool fBubble;
 
+	// Cache file for the GLL meta data
+	std::string strMetaCache;
+
 	// Output filename
 	std::string strOutputFile;
 
+	// Output table filename
+	std::string strTableFile;
+
 	// Contains concave faces
 	bool fContainsConcaveFaces;
 
+	// Maximum number of values of each variable read at once
+	int nChunkSize;
+
+	// Number of threads
+	int nThreads;
+
 	// Parse the command line
 	BeginCommandLine()
 		CommandLineString(strFileA, "a", "");
 		CommandLineString(strFileB, "b", "");
 		CommandLineString(strVariableName, "var", "Psi");
+		CommandLineBool(fAllVariables, "allvars");
 		CommandLineBool(fGLL, "gll");
 		CommandLineInt(nP, "np", 4);
 		CommandLineBool(fBubble, "bubble");
+		CommandLineString(strMetaCache, "meta_cache", "");
 		CommandLineString(strMeshFile, "mesh", "");
 		CommandLineString(strOutputFile, "outfile", "");
+		CommandLineString(strTableFile, "table", "");
 		CommandLineBool(fContainsConcaveFaces, "concave");
+		CommandLineInt(nChunkSize, "chunk_size", 1048576);
+		CommandLineInt(nThreads, "nthreads", 1);
 
 		ParseCommandLine(argc, argv);
 	EndCommandLine(argv)
 
+	if (nThreads < 1) {
+		_EXCEPTIONT("--nthreads must be at least 1");
+	}
+	if (nChunkSize < 1) {
+		_EXCEPTIONT("--chunk_size must be at least 1");
+	}
+
 	// Input mesh
 	AnnounceStartBlock("Loading Mesh");
 	Mesh mesh(strMeshFile);
@@ -133,11 +433,16 @@ try {
 
 	AnnounceEndBlock("Done");
 
+	// Face areas are needed for the weights and for the bubble adjustment
+	AnnounceStartBlock("Calculating weights");
+
+	mesh.CalculateFaceAreas(fContainsConcaveFaces, nThreads);
+
 	// Get Mesh information
 	int nTotalDataSize = 1;
 
 	DataArray1D<double> dataUniqueJacobian;
-	
+
 	// Finite volumes
 	if (!fGLL) {
 		// Total data size
@@ -147,11 +452,14 @@ try {
 
 	// Finite elements
 	} else {
-		// Calculate pointwise areas
+		// Calculate pointwise areas once for all variables
 		DataArray3D<int> dataGLLnodes;
 		DataArray3D<double> dataGLLJacobian;
 
-		GenerateMetaData(mesh, nP, fBubble, dataGLLnodes, dataGLLJacobian);
+		GenerateMetaDataCached(
+			mesh, nP, fBubble,
+			dataGLLnodes, dataGLLJacobian,
+			strMetaCache, nThreads);
 
 		GenerateUniqueJacobian(
 			dataGLLnodes, dataGLLJacobian, dataUniqueJacobian);
@@ -169,171 +477,263 @@ try {
 		nTotalDataSize = vecOutputDimSizes[0];
 	}
 
-	// Load data from file A
-	AnnounceStartBlock("Loading data from file A");
+	const double * dWeight =
+		(fGLL)?(&(dataUniqueJacobian[0])):(&(mesh.vecFaceArea[0]));
 
-	DataArray1D<double> dDataA(nTotalDataSize);
+	AnnounceEndBlock("Done");
 
+	// Open data files
 	NcFile ncFileA(strFileA.c_str(), NcFile::ReadOnly);
 	if (!ncFileA.is_valid()) {
 		_EXCEPTION1("Unable to open file \"%s\"", strFileA.c_str());
 	}
 
-	NcVar * varA = ncFileA.get_var(strVariableName.c_str());
-	if (varA == NULL) {
-		_EXCEPTION2("File \"%s\" does not contain variable \"%s\"",
-			strFileA.c_str(), strVariableName.c_str());
+	NcFile ncFileB(strFileB.c_str(), NcFile::ReadOnly);
+	if (!ncFileB.is_valid()) {
+		_EXCEPTION1("Unable to open file \"%s\"", strFileB.c_str());
 	}
 
-	varA->get(&(dDataA[0]), &(vecOutputDimSizes[0]));
-
-	int nVarASize = varA->get_dim(0)->size();
+	// Variables to compare
+	std::vector<std::string> vecVariableStrings;
 
-	ncFileA.close();
+	if (fAllVariables) {
+		for (int v = 0; v < ncFileA.num_vars(); v++) {
+			NcVar * varA = ncFileA.get_var(v);
+			std::string strName = varA->name();
 
-	AnnounceEndBlock("Done");
+			// Skip coordinate variables and HOMME format metadata
+			if ((strName == "lat") || (strName == "lon") || (strName == "area")) {
+				continue;
+			}
+			if ((varA->type() == ncChar) || (varA->type() == ncByte)) {
+				continue;
+			}
+			if (!HasDataDimensions(varA, vecOutputDimSizes)) {
+				continue;
+			}
+			if (ncFileB.get_var(strName.c_str()) == NULL) {
+				continue;
+			}
+			vecVariableStrings.push_back(strName);
+		}
 
-	// Load data from file B
-	AnnounceStartBlock("Loading data from file B");
+		if (vecVariableStrings.size() == 0) {
+			_EXCEPTION2("No variables on the mesh found in both \"%s\" and \"%s\"",
+				strFileA.c_str(), strFileB.c_str());
+		}
 
-	DataArray1D<double> dDataB(nTotalDataSize);
+	} else {
+		ParseVariableList(strVariableName, vecVariableStrings);
 
-	NcFile ncFileB(strFileB.c_str(), NcFile::ReadOnly);
-	if (!ncFileB.is_valid()) {
-		_EXCEPTION1("Unable to open file \"%s\"", strFileB.c_str());
+		if (vecVariableStrings.size() == 0) {
+			_EXCEPTIONT("No variables specified with --var");
+		}
 	}
 
-	NcVar * varB = ncFileB.get_var(strVariableName.c_str());
-	if (varB == NULL) {
-		_EXCEPTION2("File \"%s\" does not contain variable \"%s\"",
-			strFileB.c_str(), strVariableName.c_str());
+	// Data is read in chunks of whole rows of the first data dimension
+	const int nDataDims = static_cast<int>(vecOutputDimSizes.size());
+
+	long lRowSize = 1;
+	for (int d = 1; d < nDataDims; d++) {
+		lRowSize *= vecOutputDimSizes[d];
 	}
 
-	varB->get(&(dDataB[0]), &(vecOutputDimSizes[0]));
+	long lChunkRows = std::max(1L, static_cast<long>(nChunkSize) / lRowSize);
+	if (lChunkRows > vecOutputDimSizes[0]) {
+		lChunkRows = vecOutputDimSizes[0];
+	}
 
-	int nVarBSize = varB->get_dim(0)->size();
+	DataArray1D<double> dDataA(lChunkRows * lRowSize);
+	DataArray1D<double> dDataB(lChunkRows * lRowSize);
 
-	ncFileB.close();
+	std::vector<DiffNormResult> vecResults;
 
-	AnnounceEndBlock("Done");
+	// Loop over all variables
+	for (int v = 0; v < vecVariableStrings.size(); v++) {
 
-	// Check sizes
-	if (nVarASize != nVarBSize) {
-		_EXCEPTION2("Variable size mismatch [%i,%i]", nVarASize, nVarBSize);
-	}
+		const std::string & strVariable = vecVariableStrings[v];
 
-	// Calculate the difference and store in dDataA
-	double dMaxA = dDataA[0];
-	double dMinA = dDataA[0];
+		std::string strBlock = "Comparing variable \"" + strVariable + "\"";
+		AnnounceStartBlock(strBlock.c_str());
 
-	double dMaxB = dDataB[0];
-	double dMinB = dDataB[0];
-
-	for (int i = 0; i < nTotalDataSize; i++) {
-		if (dDataA[i] > dMaxA) {
-			dMaxA = dDataA[i];
-		}
-		if (dDataA[i] < dMinA) {
-			dMinA = dDataA[i];
+		NcVar * varA = ncFileA.get_var(strVariable.c_str());
+		if (varA == NULL) {
+			_EXCEPTION2("File \"%s\" does not contain variable \"%s\"",
+				strFileA.c_str(), strVariable.c_str());
 		}
 
-		if (dMinA == 0.0) {
-			_EXCEPTIONT("Zero minimum field value");
+		NcVar * varB = ncFileB.get_var(strVariable.c_str());
+		if (varB == NULL) {
+			_EXCEPTION2("File \"%s\" does not contain variable \"%s\"",
+				strFileB.c_str(), strVariable.c_str());
 		}
 
-		if (dDataB[i] > dMaxB) {
-			dMaxB = dDataB[i];
+		if (!HasDataDimensions(varA, vecOutputDimSizes)) {
+			_EXCEPTION2("Variable \"%s\" in file \"%s\" is not on the mesh",
+				strVariable.c_str(), strFileA.c_str());
 		}
-		if (dDataB[i] < dMinB) {
-			dMinB = dDataB[i];
+		if (!HasDataDimensions(varB, vecOutputDimSizes)) {
+			_EXCEPTION2("Variable \"%s\" in file \"%s\" is not on the mesh",
+				strVariable.c_str(), strFileB.c_str());
 		}
 
-		dDataA[i] = fabs(dDataA[i] - dDataB[i]);
-	}
-
-	// Min / Max Norm
-	double dNormLmin;
-	double dNormLmax;
-
-	if (dMaxB == dMinB) {
-		dNormLmin = dMinB - dMinA;
-		dNormLmax = dMaxA - dMaxB;
-	} else {
-		dNormLmin = (dMinB - dMinA) / (dMaxB - dMinB);
-		dNormLmax = (dMaxA - dMaxB) / (dMaxB - dMinB);
-	}
+		// Check sizes of the leading dimensions
+		if (varA->num_dims() != varB->num_dims()) {
+			_EXCEPTION3("Variable \"%s\" dimension count mismatch [%i,%i]",
+				strVariable.c_str(), varA->num_dims(), varB->num_dims());
+		}
 
-	// Norms and Sums
-	double dNormL1 = 0.0;
-	double dNormL2 = 0.0;
-	double dNormLi = 0.0;
+		const int nDims = varA->num_dims();
+		const int nLeadingDims = nDims - nDataDims;
 
-	double dSumL1 = 0.0;
-	double dSumL2 = 0.0;
-	double dSumLi = 0.0;
+		long lSlices = 1;
+		for (int d = 0; d < nLeadingDims; d++) {
+			long lSizeA = varA->get_dim(d)->size();
+			long lSizeB = varB->get_dim(d)->size();
+			if (lSizeA != lSizeB) {
+				_EXCEPTION3("Variable \"%s\" size mismatch [%li,%li]",
+					strVariable.c_str(), lSizeA, lSizeB);
+			}
+			lSlices *= lSizeA;
+		}
 
-	// Use face areas
-	if (!fGLL) {
-		mesh.CalculateFaceAreas(fContainsConcaveFaces);
+		std::vector<long> vecCur(nDims, 0);
+		std::vector<long> vecCount(nDims, 1);
+		for (int d = 0; d < nDataDims; d++) {
+			vecCount[nLeadingDims + d] = vecOutputDimSizes[d];
+		}
 
-		for (int i = 0; i < nTotalDataSize; i++) {
-			dNormL1 += dDataA[i] * mesh.vecFaceArea[i];
-			dNormL2 += dDataA[i] * dDataA[i] * mesh.vecFaceArea[i];
+		// Loop over all slices of the leading dimensions
+		for (long s = 0; s < lSlices; s++) {
 
-			if (dDataA[i] > dNormLi) {
-				dNormLi = dDataA[i];
+			long lIndex = s;
+			for (int d = nLeadingDims - 1; d >= 0; d--) {
+				long lSize = varA->get_dim(d)->size();
+				vecCur[d] = lIndex % lSize;
+				lIndex /= lSize;
 			}
 
-			dSumL1 += dDataB[i] * mesh.vecFaceArea[i];
-			dSumL2 += dDataB[i] * dDataB[i] * mesh.vecFaceArea[i];
-
-			if (dDataB[i] > dSumLi) {
-				dSumLi = dDataB[i];
+			DiffNormAccumulator acc;
+
+			for (long r = 0; r < vecOutputDimSizes[0]; r += lChunkRows) {
+				long lRows = std::min(lChunkRows, vecOutputDimSizes[0] - r);
+
+				vecCur[nLeadingDims] = r;
+				vecCount[nLeadingDims] = lRows;
+
+				varA->set_cur(&(vecCur[0]));
+				if (!varA->get(&(dDataA[0]), &(vecCount[0]))) {
+					_EXCEPTION2("Unable to read variable \"%s\" from \"%s\"",
+						strVariable.c_str(), strFileA.c_str());
+				}
+
+				varB->set_cur(&(vecCur[0]));
+				if (!varB->get(&(dDataB[0]), &(vecCount[0]))) {
+					_EXCEPTION2("Unable to read variable \"%s\" from \"%s\"",
+						strVariable.c_str(), strFileB.c_str());
+				}
+
+				AccumulateDiffNorms(
+					&(dDataA[0]),
+					&(dDataB[0]),
+					dWeight + r * lRowSize,
+					static_cast<size_t>(lRows * lRowSize),
+					nThreads,
+					acc);
 			}
-		}
-
-		dNormL1 = dNormL1 / dSumL1;
-		dNormL2 = sqrt(dNormL2 / dSumL2);
-		dNormLi = dNormLi / dSumLi;
-
-	} else {
 
-		// Calculate differences
-		for (int i = 0; i < nTotalDataSize; i++) {
-			dNormL1 += dDataA[i] * dataUniqueJacobian[i];
-			dNormL2 += dDataA[i] * dDataA[i] * dataUniqueJacobian[i];
+			if (acc.dMinA == 0.0) {
+				_EXCEPTIONT("Zero minimum field value");
+			}
 
-			if (dDataA[i] > dNormLi) {
-				dNormLi = dDataA[i];
+			DiffNormResult result;
+			result.strVariable = strVariable;
+			result.lSlice = s;
+
+			result.dMinA = acc.dMinA;
+			result.dMaxA = acc.dMaxA;
+			result.dMinB = acc.dMinB;
+			result.dMaxB = acc.dMaxB;
+
+			// Min / Max Norm
+			if (acc.dMaxB == acc.dMinB) {
+				result.dNormLmin = acc.dMinB - acc.dMinA;
+				result.dNormLmax = acc.dMaxA - acc.dMaxB;
+			} else {
+				result.dNormLmin = (acc.dMinB - acc.dMinA) / (acc.dMaxB - acc.dMinB);
+				result.dNormLmax = (acc.dMaxA - acc.dMaxB) / (acc.dMaxB - acc.dMinB);
 			}
 
-			dSumL1 += dDataB[i] * dataUniqueJacobian[i];
-			dSumL2 += dDataB[i] * dDataB[i] * dataUniqueJacobian[i];
+			// Norms and Sums
+			result.dSumL1 = acc.sumRefL1.Get();
+			result.dSumL2 = acc.sumRefL2.Get();
+			result.dSumLi = acc.dRefLi;
 
-			if (dDataB[i] > dSumLi) {
-				dSumLi = dDataB[i];
-			}
+			result.dNormL1 = acc.sumDiffL1.Get() / result.dSumL1;
+			result.dNormL2 = sqrt(acc.sumDiffL2.Get() / result.dSumL2);
+			result.dNormLi = acc.dDiffLi / result.dSumLi;
+
+			vecResults.push_back(result);
 		}
 
-		dNormL1 = dNormL1 / dSumL1;
-		dNormL2 = sqrt(dNormL2 / dSumL2);
-		dNormLi = dNormLi / dSumLi;
+		AnnounceEndBlock("Done");
 	}
 
 	// Announce results
-	AnnounceStartBlock("Results:");
-	Announce("L1:   %1.15e | %1.15e", dNormL1, dSumL1);
-	Announce("L2:   %1.15e | %1.15e", dNormL2, dSumL2);
-	Announce("Li:   %1.15e | %1.15e", dNormLi, dSumLi);
-	Announce("Lmin: %1.15e | %1.5e %1.5e", dNormLmin, dMinA, dMinB);
-	Announce("Lmax: %1.15e | %1.5e %1.5e", dNormLmax, dMaxA, dMaxB);
-	AnnounceEndBlock(NULL);
+	if (vecResults.size() == 1) {
+		const DiffNormResult & result = vecResults[0];
+
+		AnnounceStartBlock("Results:");
+		Announce("L1:   %1.15e | %1.15e", result.dNormL1, result.dSumL1);
+		Announce("L2:   %1.15e | %1.15e", result.dNormL2, result.dSumL2);
+		Announce("Li:   %1.15e | %1.15e", result.dNormLi, result.dSumLi);
+		Announce("Lmin: %1.15e | %1.5e %1.5e", result.dNormLmin, result.dMinA, result.dMinB);
+		Announce("Lmax: %1.15e | %1.5e %1.5e", result.dNormLmax, result.dMaxA, result.dMaxB);
+		AnnounceEndBlock(NULL);
+
+	} else {
+		AnnounceStartBlock("Results:");
+		Announce("%-16s %8s %22s %22s %22s %22s %22s",
+			"variable", "slice", "L1", "L2", "Li", "Lmin", "Lmax");
+		for (int i = 0; i < vecResults.size(); i++) {
+			const DiffNormResult & result = vecResults[i];
+			Announce("%-16s %8li %22.15e %22.15e %22.15e %22.15e %22.15e",
+				result.strVariable.c_str(), result.lSlice,
+				result.dNormL1, result.dNormL2, result.dNormLi,
+				result.dNormLmin, result.dNormLmax);
+		}
+		AnnounceEndBlock(NULL);
+	}
 
 	// Print results to file
 	if (strOutputFile != "") {
 		FILE * fp = fopen(strOutputFile.c_str(), "a");
-		fprintf(fp, "%1.15e %1.15e %1.15e %1.15e %1.15e\n",
-			dNormL1, dNormL2, dNormLi, dNormLmin, dNormLmax);
+		if (fp == NULL) {
+			_EXCEPTION1("Unable to open output file \"%s\"", strOutputFile.c_str());
+		}
+		for (int i = 0; i < vecResults.size(); i++) {
+			const DiffNormResult & result = vecResults[i];
+			fprintf(fp, "%1.15e %1.15e %1.15e %1.15e %1.15e\n",
+				result.dNormL1, result.dNormL2, result.dNormLi,
+				result.dNormLmin, result.dNormLmax);
+		}
+		fclose(fp);
+	}
+
+	// Print table of results to file
+	if (strTableFile != "") {
+		FILE * fp = fopen(strTableFile.c_str(), "w");
+		if (fp == NULL) {
+			_EXCEPTION1("Unable to open table file \"%s\"", strTableFile.c_str());
+		}
+		fprintf(fp, "variable slice L1 L2 Li Lmin Lmax\n");
+		for (int i = 0; i < vecResults.size(); i++) {
+			const DiffNormResult & result = vecResults[i];
+			fprintf(fp, "%s %li %1.15e %1.15e %1.15e %1.15e %1.15e\n",
+				result.strVariable.c_str(), result.lSlice,
+				result.dNormL1, result.dNormL2, result.dNormLi,
+				result.dNormLmin, result.dNormLmax);
+		}
 		fclose(fp);
 	}
 
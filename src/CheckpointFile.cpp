@@ -0,0 +1,280 @@
+///////////////////////////////////////////////////////////////////////////////
+///
+///	\file    CheckpointFile.cpp
+///	\author  agent
+///	\version October 15, 2026
+///
+///	<remarks>
+///		Copyright 2026 agent
+///
+///		This file is distributed as part of the Tempest source code package.
+///		Permission is granted to use, copy, modify and distribute this
+///		source code and its documentation under the terms of the GNU General
+///		Public License.  This software is provided "as is" without express
+///		or implied warranty.
+///	</remarks>
+
+#include "CheckpointFile.h"
+#include "Announce.h"
+
+#include <chrono>
+#include <stdint.h>
+
+#include <sys/types.h>
+#include <unistd.h>
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Identifier at the beginning of every checkpoint file.
+///	</summary>
+static const char CheckpointFileMagic[8] =
+	{ 'T', 'R', 'C', 'K', 'P', 'T', '0', '1' };
+
+///	<summary>
+///		Offset basis and prime of the 64-bit FNV-1a hash, used as the
+///		checksum of each record.
+///	</summary>
+static const uint64_t CheckpointFNV1aOffsetBasis = 14695981039346656037ULL;
+static const uint64_t CheckpointFNV1aPrime = 1099511628211ULL;
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Checksum of a record.
+///	</summary>
+static uint64_t CheckpointChecksum(
+	const std::vector<char> & vecRecord
+) {
+	uint64_t uHash = CheckpointFNV1aOffsetBasis;
+	for (size_t i = 0; i < vecRecord.size(); i++) {
+		uHash ^= static_cast<uint64_t>(static_cast<unsigned char>(vecRecord[i]));
+		uHash *= CheckpointFNV1aPrime;
+	}
+	return uHash;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// CheckpointFile
+///////////////////////////////////////////////////////////////////////////////
+
+CheckpointFile::CheckpointFile() :
+	m_fp(NULL),
+	m_fReading(false),
+	m_lValidEnd(0),
+	m_dInterval(0.0),
+	m_dLastWriteTime(0.0)
+{ }
+
+///////////////////////////////////////////////////////////////////////////////
+
+CheckpointFile::~CheckpointFile() {
+	if (m_fp != NULL) {
+		fclose(m_fp);
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+double CheckpointFile::WallTime() {
+	return std::chrono::duration<double>(
+		std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void CheckpointFile::Open(
+	const std::string & strFile,
+	const std::string & strKey,
+	bool fRestart,
+	double dInterval
+) {
+	if (m_fp != NULL) {
+		_EXCEPTIONT("CheckpointFile is already open");
+	}
+
+	m_strFile = strFile;
+	m_dInterval = dInterval;
+	m_dLastWriteTime = WallTime();
+	m_fReading = false;
+
+	// Resume from an existing file with a complete header
+	if (fRestart) {
+		m_fp = fopen(strFile.c_str(), "r+b");
+		if (m_fp == NULL) {
+			Announce("Checkpoint file %s not found; starting from the "
+				"beginning", strFile.c_str());
+
+		} else {
+			char szMagic[8];
+			uint64_t uKeyLength;
+
+			bool fValid =
+				(fread(szMagic, 1, 8, m_fp) == 8)
+				&& (memcmp(szMagic, CheckpointFileMagic, 8) == 0)
+				&& (fread(&uKeyLength, sizeof(uint64_t), 1, m_fp) == 1)
+				&& (uKeyLength < (1 << 20));
+
+			std::string strFileKey;
+			if (fValid) {
+				strFileKey.resize(uKeyLength);
+				if (uKeyLength != 0) {
+					fValid = (fread(&(strFileKey[0]), 1, uKeyLength, m_fp)
+						== uKeyLength);
+				}
+			}
+
+			if (fValid) {
+				if (strFileKey != strKey) {
+					fclose(m_fp);
+					m_fp = NULL;
+					_EXCEPTION1("Checkpoint file %s was written for a "
+						"different computation", strFile.c_str());
+				}
+
+				m_fReading = true;
+				m_lValidEnd = ftell(m_fp);
+				return;
+			}
+
+			fclose(m_fp);
+			m_fp = NULL;
+
+			Announce("Checkpoint file %s is incomplete; starting from the "
+				"beginning", strFile.c_str());
+		}
+	}
+
+	// Begin a new file
+	m_fp = fopen(strFile.c_str(), "w+b");
+	if (m_fp == NULL) {
+		_EXCEPTION1("Unable to open checkpoint file \"%s\"", strFile.c_str());
+	}
+
+	uint64_t uKeyLength = strKey.size();
+
+	bool fWritten =
+		(fwrite(CheckpointFileMagic, 1, 8, m_fp) == 8)
+		&& (fwrite(&uKeyLength, sizeof(uint64_t), 1, m_fp) == 1)
+		&& (fwrite(strKey.c_str(), 1, strKey.size(), m_fp) == strKey.size())
+		&& (fflush(m_fp) == 0)
+		&& (fsync(fileno(m_fp)) == 0);
+
+	if (!fWritten) {
+		_EXCEPTION1("Unable to write checkpoint file \"%s\"", strFile.c_str());
+	}
+
+	m_lValidEnd = ftell(m_fp);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+bool CheckpointFile::ReadRecord(
+	std::vector<char> & vecRecord
+) {
+	if (!m_fReading) {
+		return false;
+	}
+
+	uint64_t uLength;
+	uint64_t uChecksum;
+
+	// Records are never larger than the rest of the file
+	if (fseek(m_fp, 0, SEEK_END) != 0) {
+		_EXCEPTION1("Unable to read checkpoint file \"%s\"", m_strFile.c_str());
+	}
+	const long lFileEnd = ftell(m_fp);
+	fseek(m_fp, m_lValidEnd, SEEK_SET);
+
+	bool fValid =
+		(fread(&uLength, sizeof(uint64_t), 1, m_fp) == 1)
+		&& (uLength <= static_cast<uint64_t>(lFileEnd - m_lValidEnd));
+
+	if (fValid) {
+		vecRecord.resize(uLength);
+		if (uLength != 0) {
+			fValid = (fread(&(vecRecord[0]), 1, uLength, m_fp) == uLength);
+		}
+	}
+	if (fValid) {
+		fValid =
+			(fread(&uChecksum, sizeof(uint64_t), 1, m_fp) == 1)
+			&& (uChecksum == CheckpointChecksum(vecRecord));
+	}
+
+	if (!fValid) {
+		vecRecord.clear();
+		EndRead();
+		return false;
+	}
+
+	m_lValidEnd = ftell(m_fp);
+	return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void CheckpointFile::EndRead() {
+	fflush(m_fp);
+	if (ftruncate(fileno(m_fp), m_lValidEnd) != 0) {
+		_EXCEPTION1("Unable to truncate checkpoint file \"%s\"",
+			m_strFile.c_str());
+	}
+	fseek(m_fp, m_lValidEnd, SEEK_SET);
+
+	m_fReading = false;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+bool CheckpointFile::IsDue() const {
+	return (WallTime() - m_dLastWriteTime >= m_dInterval);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void CheckpointFile::WriteRecord(
+	const std::vector<char> & vecRecord
+) {
+	if (m_fp == NULL) {
+		_EXCEPTIONT("CheckpointFile is not open");
+	}
+	if (m_fReading) {
+		_EXCEPTIONT("All checkpoint records must be read before writing");
+	}
+
+	uint64_t uLength = vecRecord.size();
+	uint64_t uChecksum = CheckpointChecksum(vecRecord);
+
+	bool fWritten =
+		(fwrite(&uLength, sizeof(uint64_t), 1, m_fp) == 1)
+		&& ((uLength == 0)
+			|| (fwrite(&(vecRecord[0]), 1, uLength, m_fp) == uLength))
+		&& (fwrite(&uChecksum, sizeof(uint64_t), 1, m_fp) == 1)
+		&& (fflush(m_fp) == 0)
+		&& (fsync(fileno(m_fp)) == 0);
+
+	if (!fWritten) {
+		_EXCEPTION1("Unable to write checkpoint file \"%s\"",
+			m_strFile.c_str());
+	}
+
+	m_lValidEnd = ftell(m_fp);
+	m_dLastWriteTime = WallTime();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void CheckpointFile::Remove() {
+	if (m_fp == NULL) {
+		return;
+	}
+
+	fclose(m_fp);
+	m_fp = NULL;
+
+	remove(m_strFile.c_str());
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
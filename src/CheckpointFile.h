@@ -0,0 +1,189 @@
+///////////////////////////////////////////////////////////////////////////////
+///
+///	\file    CheckpointFile.h
+///	\author  agent
+///	\version October 15, 2026
+///
+///	<remarks>
+///		Copyright 2026 agent
+///
+///		This file is distributed as part of the Tempest source code package.
+///		Permission is granted to use, copy, modify and distribute this
+///		source code and its documentation under the terms of the GNU General
+///		Public License.  This software is provided "as is" without express
+///		or implied warranty.
+///	</remarks>
+
+#ifndef _CHECKPOINTFILE_H_
+#define _CHECKPOINTFILE_H_
+
+#include "Exception.h"
+
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		An append-only binary file of records describing completed work,
+///		used to resume long computations after they are interrupted.  The
+///		file begins with a key describing the computation, and each record
+///		is stored with its length and a checksum and is flushed to disk
+///		when written.  On restart the records are read back in order, and
+///		a record left incomplete by an interruption is discarded.
+///	</summary>
+class CheckpointFile {
+
+public:
+	///	<summary>
+	///		Constructor.
+	///	</summary>
+	CheckpointFile();
+
+	///	<summary>
+	///		Destructor.
+	///	</summary>
+	~CheckpointFile();
+
+private:
+	///	<summary>
+	///		Copy constructor (not implemented).
+	///	</summary>
+	CheckpointFile(const CheckpointFile &);
+
+	///	<summary>
+	///		Assignment operator (not implemented).
+	///	</summary>
+	CheckpointFile & operator=(const CheckpointFile &);
+
+public:
+	///	<summary>
+	///		Open the checkpoint file strFile for a computation described by
+	///		strKey.  If fRestart is true and strFile exists its records are
+	///		made available to ReadRecord(), and it is an error if its key
+	///		differs from strKey.  Otherwise strFile is created empty.
+	///		Records are due to be written every dInterval seconds.
+	///	</summary>
+	void Open(
+		const std::string & strFile,
+		const std::string & strKey,
+		bool fRestart,
+		double dInterval
+	);
+
+	///	<summary>
+	///		Determine if the file is open.
+	///	</summary>
+	bool IsOpen() const {
+		return (m_fp != NULL);
+	}
+
+	///	<summary>
+	///		Read the next record written before a restart.  Returns false
+	///		after the last complete record, at which point any incomplete
+	///		record is removed and the file is ready for WriteRecord().
+	///	</summary>
+	bool ReadRecord(
+		std::vector<char> & vecRecord
+	);
+
+	///	<summary>
+	///		Determine if dInterval seconds have passed since the file was
+	///		opened or a record was last written.
+	///	</summary>
+	bool IsDue() const;
+
+	///	<summary>
+	///		Append a record and flush it to disk.  All records written
+	///		before a restart must have been read first.
+	///	</summary>
+	void WriteRecord(
+		const std::vector<char> & vecRecord
+	);
+
+	///	<summary>
+	///		Close and remove the file, once the computation is complete.
+	///	</summary>
+	void Remove();
+
+public:
+	///	<summary>
+	///		Append a value to a record.
+	///	</summary>
+	template <typename T>
+	static void Put(
+		std::vector<char> & vecRecord,
+		const T & value
+	) {
+		const size_t sPos = vecRecord.size();
+		vecRecord.resize(sPos + sizeof(T));
+		memcpy(&(vecRecord[sPos]), &value, sizeof(T));
+	}
+
+	///	<summary>
+	///		Read a value from a record at position sPos, advancing sPos.
+	///	</summary>
+	template <typename T>
+	static T Get(
+		const std::vector<char> & vecRecord,
+		size_t & sPos
+	) {
+		if (sPos + sizeof(T) > vecRecord.size()) {
+			_EXCEPTIONT("Read past the end of a checkpoint record");
+		}
+		T value;
+		memcpy(&value, &(vecRecord[sPos]), sizeof(T));
+		sPos += sizeof(T);
+		return value;
+	}
+
+protected:
+	///	<summary>
+	///		Wall time in seconds.
+	///	</summary>
+	static double WallTime();
+
+	///	<summary>
+	///		Discard everything after the last complete record and prepare
+	///		the file for writing.
+	///	</summary>
+	void EndRead();
+
+protected:
+	///	<summary>
+	///		Name of the checkpoint file.
+	///	</summary>
+	std::string m_strFile;
+
+	///	<summary>
+	///		Checkpoint file.
+	///	</summary>
+	FILE * m_fp;
+
+	///	<summary>
+	///		True while records written before a restart are being read.
+	///	</summary>
+	bool m_fReading;
+
+	///	<summary>
+	///		Offset of the end of the last complete record.
+	///	</summary>
+	long m_lValidEnd;
+
+	///	<summary>
+	///		Interval between records (in seconds).
+	///	</summary>
+	double m_dInterval;
+
+	///	<summary>
+	///		Wall time of the last record written.
+	///	</summary>
+	double m_dLastWriteTime;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+#endif
+
@@ -23,6 +23,8 @@
 
 #include <cmath>
 #include <iostream>
+#include <vector>
+#include <algorithm>
 
 #include "netcdfcpp.h"
 
@@ -163,36 +165,65 @@ void Generate1DOverlapMap(
 
 ///////////////////////////////////////////////////////////////////////////////
 
+static void ParseVariableList(
+	const std::string & strVariables,
+	std::vector< std::string > & vecVariableStrings
+) {
+	int iVarBegin = 0;
+	int iVarCurrent = 0;
+
+	// Parse variable name
+	for (;;) {
+		if ((iVarCurrent >= strVariables.length()) ||
+			(strVariables[iVarCurrent] == ',') ||
+			(strVariables[iVarCurrent] == ' ')
+		) {
+			if (iVarCurrent > iVarBegin) {
+				vecVariableStrings.push_back(
+					strVariables.substr(iVarBegin, iVarCurrent - iVarBegin));
+			}
+			if (iVarCurrent >= strVariables.length()) {
+				break;
+			}
+
+			iVarBegin = iVarCurrent + 1;
+		}
+
+		iVarCurrent++;
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
 template<typename T>
 inline void FindReplace(
-	DataArray2D<T> & data,
+	T * data,
+	size_t sSize,
 	const T & find,
 	const T & replace
 ) {
-	const int nX = data.GetRows();
-	const int nY = data.GetColumns();
-
-	for (int i = 0; i < nX; i++) {
-	for (int j = 0; j < nY; j++) {
-		if (data[i][j] == find) {
-			data[i][j] = replace;
+	for (size_t i = 0; i < sSize; i++) {
+		if (data[i] == find) {
+			data[i] = replace;
 		}
 	}
-	}
 }
 
 ///////////////////////////////////////////////////////////////////////////////
 
 template<typename T>
 inline double TotalMatrix(
-	const DataArray2D<T> & data,
+	const T * data,
 	const DataArray1D<double> & dXEdge,
 	const DataArray1D<double> & dYEdge
 ) {
+	const int nX = dXEdge.GetRows() - 1;
+	const int nY = dYEdge.GetRows() - 1;
+
 	double dTotal = 0.0;
-	for (int i = 0; i < data.GetRows(); i++) {
-	for (int j = 0; j < data.GetColumns(); j++) {
-		dTotal += static_cast<double>(data[i][j])
+	for (int i = 0; i < nX; i++) {
+	for (int j = 0; j < nY; j++) {
+		dTotal += static_cast<double>(data[i * nY + j])
 			* fabs(dXEdge[i+1] - dXEdge[i])
 			* fabs(dYEdge[j+1] - dYEdge[j]);
 	}
@@ -203,47 +234,327 @@ inline double TotalMatrix(
 
 ///////////////////////////////////////////////////////////////////////////////
 
-template<typename T, typename Tout = T>
+///	<summary>
+///		Apply the separable map to one nX x nY slice stored with Y
+///		contiguous.  The Y map is applied along each contiguous row into
+///		the nX x nYout workspace dTemp, and the X map is then applied as a
+///		linear combination of whole rows of dTemp, so that both passes
+///		access memory contiguously.
+///	</summary>
+template<typename T, typename Tout>
 inline void ApplyMap(
-	const DataArray2D<T> & dataIn,
+	const T * dataIn,
+	int nX,
+	int nY,
 	const ConservativeMap1D & mapX,
 	const ConservativeMap1D & mapY,
-	DataArray2D<Tout> & dataOut
+	DataArray1D<double> & dTemp,
+	DataArray1D<double> & dRow,
+	Tout * dataOut
 ) {
-	const int nX = dataIn.GetRows();
-	const int nY = dataIn.GetColumns();
+	const int nXout = static_cast<int>(mapX.size());
+	const int nYout = static_cast<int>(mapY.size());
 
-	const int nXout = dataOut.GetRows();
-	const int nYout = dataOut.GetColumns();
+	if (dTemp.GetRows() < static_cast<size_t>(nX) * nYout) {
+		dTemp.Allocate(static_cast<size_t>(nX) * nYout);
+	}
+	if (dRow.GetRows() < nYout) {
+		dRow.Allocate(nYout);
+	}
 
-	for (int i = 0; i < nXout; i++) {
-	for (int j = 0; j < nYout; j++) {
+	// Y pass along contiguous rows
+	for (int i = 0; i < nX; i++) {
+		const T * pIn = dataIn + static_cast<size_t>(i) * nY;
+		double * pTemp = &(dTemp[0]) + static_cast<size_t>(i) * nYout;
+
+		for (int j = 0; j < nYout; j++) {
+			double dOut = 0.0;
+			for (int iy = 0; iy < mapY[j].size(); iy++) {
+				dOut += mapY[j][iy].second
+					* static_cast<double>(pIn[mapY[j][iy].first]);
+			}
+			pTemp[j] = dOut;
+		}
+	}
 
-		double dOut = 0.0;
+	// X pass as combinations of rows
+	for (int i = 0; i < nXout; i++) {
+		double * pRow = &(dRow[0]);
+		for (int j = 0; j < nYout; j++) {
+			pRow[j] = 0.0;
+		}
 
 		for (int ix = 0; ix < mapX[i].size(); ix++) {
-		for (int iy = 0; iy < mapY[j].size(); iy++) {
+			const double dCoeffX = mapX[i][ix].second;
+			const double * pTemp =
+				&(dTemp[0]) + static_cast<size_t>(mapX[i][ix].first) * nYout;
 
-			const int ii = mapX[i][ix].first;
-			const int jj = mapY[j][iy].first;
+			for (int j = 0; j < nYout; j++) {
+				pRow[j] += dCoeffX * pTemp[j];
+			}
+		}
 
-			const double dCoeffX = mapX[i][ix].second;
-			const double dCoeffY = mapY[j][iy].second;
-/*
-			if (ii >= dataIn.GetRows()) {
-				_EXCEPTION();
+		Tout * pOut = dataOut + static_cast<size_t>(i) * nYout;
+		for (int j = 0; j < nYout; j++) {
+			pOut[j] = static_cast<Tout>(pRow[j]);
+		}
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Coarsen all slices of varData into varDataOut.  Slices are read and
+///		written in chunks along the innermost non-spatial dimension of at
+///		most sChunkSize input values, and the slices of each chunk are
+///		remapped in parallel.
+///	</summary>
+template<typename T, typename Tout>
+void CoarsenVariable(
+	NcVar * varData,
+	NcVar * varDataOut,
+	const ConservativeMap1D & matX1D,
+	const ConservativeMap1D & matY1D,
+	const DataArray1D<double> & dXedge,
+	const DataArray1D<double> & dYedge,
+	const DataArray1D<double> & dXedgeout,
+	const DataArray1D<double> & dYedgeout,
+	bool fFindReplace,
+	T find,
+	T replace,
+	bool fValidate,
+	size_t sChunkSize,
+	int nThreads
+) {
+	const int nDims = varData->num_dims();
+
+	const int nX = static_cast<int>(varData->get_dim(nDims-2)->size());
+	const int nY = static_cast<int>(varData->get_dim(nDims-1)->size());
+
+	const int nXout = static_cast<int>(matX1D.size());
+	const int nYout = static_cast<int>(matY1D.size());
+
+	const size_t sSliceSize = static_cast<size_t>(nX) * nY;
+	const size_t sSliceSizeOut = static_cast<size_t>(nXout) * nYout;
+
+	// Slices are chunked along dimension nDims-3
+	long lChunkDimSize = 1;
+	long nOuterSlices = 1;
+	if (nDims > 2) {
+		lChunkDimSize = varData->get_dim(nDims-3)->size();
+		for (int d = 0; d < nDims-3; d++) {
+			nOuterSlices *= varData->get_dim(d)->size();
+		}
+	}
+
+	long lChunkSlices = static_cast<long>(sChunkSize / sSliceSize);
+	if (lChunkSlices < 1) {
+		lChunkSlices = 1;
+	}
+	if (lChunkSlices > lChunkDimSize) {
+		lChunkSlices = lChunkDimSize;
+	}
+
+	Announce("%li data instance(s) found, %li per chunk",
+		nOuterSlices * lChunkDimSize, lChunkSlices);
+
+	std::vector<T> vecDataIn(lChunkSlices * sSliceSize);
+	std::vector<Tout> vecDataOut(lChunkSlices * sSliceSizeOut);
+
+	std::vector<double> vecMassIn(lChunkSlices);
+	std::vector<double> vecMassOut(lChunkSlices);
+
+	DataArray1D<long> lDataIx(nDims);
+	DataArray1D<long> lDataSize(nDims);
+	DataArray1D<long> lDataSizeOut(nDims);
+
+	for (int d = 0; d < nDims; d++) {
+		lDataSize[d] = 1;
+	}
+	lDataSize[nDims-2] = nX;
+	lDataSize[nDims-1] = nY;
+
+	lDataSizeOut = lDataSize;
+	lDataSizeOut[nDims-2] = nXout;
+	lDataSizeOut[nDims-1] = nYout;
+
+	for (long s = 0; s < nOuterSlices; s++) {
+	for (long c = 0; c < lChunkDimSize; c += lChunkSlices) {
+
+		const long lSlices = std::min(lChunkSlices, lChunkDimSize - c);
+
+		// Index of the first slice of this chunk
+		long lIndex = s;
+		for (int d = nDims-4; d >= 0; d--) {
+			lDataIx[d] = lIndex % varData->get_dim(d)->size();
+			lIndex /= varData->get_dim(d)->size();
+		}
+		if (nDims > 2) {
+			lDataIx[nDims-3] = c;
+			lDataSize[nDims-3] = lSlices;
+			lDataSizeOut[nDims-3] = lSlices;
+		}
+		lDataIx[nDims-2] = 0;
+		lDataIx[nDims-1] = 0;
+
+		// Read data
+		varData->set_cur((long*)(lDataIx));
+		if (!varData->get(&(vecDataIn[0]), lDataSize)) {
+			_EXCEPTION1("Unable to read variable \"%s\"", varData->name());
+		}
+
+		// Remap each slice of the chunk
+#pragma omp parallel num_threads(nThreads)
+		{
+			DataArray1D<double> dTemp;
+			DataArray1D<double> dRow;
+
+#pragma omp for schedule(dynamic, 1)
+			for (long k = 0; k < lSlices; k++) {
+				T * pIn = &(vecDataIn[0]) + k * sSliceSize;
+				Tout * pOut = &(vecDataOut[0]) + k * sSliceSizeOut;
+
+				if (fFindReplace) {
+					FindReplace<T>(pIn, sSliceSize, find, replace);
+				}
+				if (fValidate) {
+					vecMassIn[k] = TotalMatrix<T>(pIn, dXedge, dYedge);
+				}
+
+				ApplyMap<T,Tout>(
+					pIn, nX, nY, matX1D, matY1D, dTemp, dRow, pOut);
+
+				if (fValidate) {
+					vecMassOut[k] = TotalMatrix<Tout>(pOut, dXedgeout, dYedgeout);
+				}
 			}
-			if (jj >= dataIn.GetColumns()) {
-				_EXCEPTION();
+		}
+
+		if (fValidate) {
+			for (long k = 0; k < lSlices; k++) {
+				Announce("Instance %li: input mass %1.15e, output mass %1.15e",
+					s * lChunkDimSize + c + k, vecMassIn[k], vecMassOut[k]);
 			}
-*/
-			dOut += dCoeffX * dCoeffY * static_cast<double>(dataIn[ii][jj]);
 		}
+
+		// Write data
+		varDataOut->set_cur((long*)(lDataIx));
+		if (!varDataOut->put(&(vecDataOut[0]), lDataSizeOut)) {
+			_EXCEPTION1("Unable to write variable \"%s\"", varDataOut->name());
+		}
+	}
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Coarsen all slices of varData into a new variable of ncfileout,
+///		dispatching on the type of varData.
+///	</summary>
+static void CoarsenVariable(
+	NcVar * varData,
+	NcFile & ncfileout,
+	NcDim * dimXout,
+	NcDim * dimYout,
+	const ConservativeMap1D & matX1D,
+	const ConservativeMap1D & matY1D,
+	const DataArray1D<double> & dXedge,
+	const DataArray1D<double> & dYedge,
+	const DataArray1D<double> & dXedgeout,
+	const DataArray1D<double> & dYedgeout,
+	const std::string & strFind,
+	const std::string & strReplace,
+	bool fValidate,
+	bool fOutputDouble,
+	size_t sChunkSize,
+	int nThreads
+) {
+	const int nDims = varData->num_dims();
+
+	// Output dimensions, shared between variables
+	DataArray1D<NcDim*> vecDimOut(nDims);
+	for (int d = 0; d < nDims-2; d++) {
+		NcDim * dimIn = varData->get_dim(d);
+		NcDim * dimOut = ncfileout.get_dim(dimIn->name());
+		if (dimOut == NULL) {
+			dimOut = ncfileout.add_dim(dimIn->name(), dimIn->size());
+		} else if (dimOut->size() != dimIn->size()) {
+			_EXCEPTION1("Dimension \"%s\" has inconsistent size", dimIn->name());
 		}
+		vecDimOut[d] = dimOut;
+	}
+	vecDimOut[nDims-2] = dimXout;
+	vecDimOut[nDims-1] = dimYout;
+
+	const NcDim ** pvardims = (const NcDim **)(&(vecDimOut[0]));
 
-		dataOut[i][j] = static_cast<Tout>(dOut);
+	NcType vartype = varData->type();
+	if (fOutputDouble) {
+		vartype = ncDouble;
 	}
+	if ((vartype != ncByte) && (vartype != ncShort) && (vartype != ncInt) &&
+		(vartype != ncFloat) && (vartype != ncDouble)
+	) {
+		_EXCEPTIONT("Invalid datatype");
+	}
+
+	NcVar * varDataOut =
+		ncfileout.add_var(varData->name(), vartype, nDims, pvardims);
+	if (varDataOut == NULL) {
+		_EXCEPTIONT("Unable to create output variable");
+	}
+
+	// Copy variable attributes
+	CopyNcVarAttributes(varData, varDataOut);
+
+	const bool fFindReplace = (strFind != "");
+	const double dFind = atof(strFind.c_str());
+	const double dReplace = atof(strReplace.c_str());
+
+#define COARSENVARIABLE(T, Tout) \
+	CoarsenVariable<T,Tout>( \
+		varData, varDataOut, matX1D, matY1D, \
+		dXedge, dYedge, dXedgeout, dYedgeout, \
+		fFindReplace, static_cast<T>(dFind), static_cast<T>(dReplace), \
+		fValidate, sChunkSize, nThreads);
+
+	if (varData->type() == ncByte) {
+		if (fOutputDouble) {
+			COARSENVARIABLE(ncbyte, double);
+		} else {
+			COARSENVARIABLE(ncbyte, ncbyte);
+		}
+
+	} else if (varData->type() == ncShort) {
+		if (fOutputDouble) {
+			COARSENVARIABLE(short, double);
+		} else {
+			COARSENVARIABLE(short, short);
+		}
+
+	} else if (varData->type() == ncInt) {
+		if (fOutputDouble) {
+			COARSENVARIABLE(int, double);
+		} else {
+			COARSENVARIABLE(int, int);
+		}
+
+	} else if (varData->type() == ncFloat) {
+		if (fOutputDouble) {
+			COARSENVARIABLE(float, double);
+		} else {
+			COARSENVARIABLE(float, float);
+		}
+
+	} else if (varData->type() == ncDouble) {
+		COARSENVARIABLE(double, double);
+
+	} else {
+		_EXCEPTIONT("Invalid datatype");
 	}
+
+#undef COARSENVARIABLE
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -277,8 +588,11 @@ try {
 	// Output filename
 	std::string strOutputFile;
 
-	// Variable to remap
-	std::string strVariable;
+	// Variables to remap
+	std::string strVariables;
+
+	// Remap all variables on the X and Y dimensions
+	bool fAllVariables;
 
 	// Name of x dimension
 	std::string strVarNameX;
@@ -298,6 +612,12 @@ try {
 	// Output double
 	bool fOutputDouble;
 
+	// Maximum number of input values read at once
+	int nChunkSize;
+
+	// Number of threads
+	int nThreads;
+
 	// Parse the command line
 	BeginCommandLine()
 		CommandLineInt(nXout, "nx", 64);
@@ -308,13 +628,16 @@ try {
 		//CommandLineDouble(dYEnd, "yend", 0.0);
 		CommandLineString(strInputFile, "in", "");
 		CommandLineString(strOutputFile, "out", "");
-		CommandLineString(strVariable, "var", "");
+		CommandLineString(strVariables, "var", "");
+		CommandLineBool(fAllVariables, "allvars");
 		CommandLineString(strVarNameX, "xvarname", "lon");
 		CommandLineString(strVarNameY, "yvarname", "lat");
 		CommandLineString(strFind, "find", "");
 		CommandLineString(strReplace, "replace", "");
 		CommandLineBool(fValidate, "validate");
 		CommandLineBool(fOutputDouble, "doubleout");
+		CommandLineInt(nChunkSize, "chunk_size", 16777216);
+		CommandLineInt(nThreads, "nthreads", 1);
 
 		ParseCommandLine(argc, argv);
 	EndCommandLine(argv)
@@ -326,15 +649,24 @@ try {
 	if (strOutputFile == "") {
 		_EXCEPTIONT("No output file specified");
 	}
-	if (strVariable == "") {
+	if ((strVariables == "") && (!fAllVariables)) {
 		_EXCEPTIONT("No data variable specified");
 	}
+	if ((strVariables != "") && (fAllVariables)) {
+		_EXCEPTIONT("Only one of --var and --allvars may be specified");
+	}
 	if (nXout <= 0) {
 		_EXCEPTIONT("At least one X output volume required");
 	}
 	if (nYout <= 0) {
 		_EXCEPTIONT("At least one Y output volume required");
 	}
+	if (nChunkSize < 1) {
+		_EXCEPTIONT("--chunk_size must be at least 1");
+	}
+	if (nThreads < 1) {
+		_EXCEPTIONT("--nthreads must be at least 1");
+	}
 
 	// Load NetCDF input file
 	NcFile ncfilein(strInputFile.c_str(), NcFile::ReadOnly);
@@ -367,23 +699,76 @@ try {
 		_EXCEPTIONT("Only double or float type supported for dimension variables");
 	}
 
-	// Load variable
-	NcVar * varData = ncfilein.get_var(strVariable.c_str());
-	if (varData == NULL) {
-		_EXCEPTION1("Unable to find variable \"%s\" in input file",
-			strVariable.c_str());
+	// Load variables
+	std::vector<NcVar *> vecVarData;
+
+	NcDim * dimX = NULL;
+	NcDim * dimY = NULL;
+
+	if (fAllVariables) {
+		if ((varX->num_dims() != 1) || (varY->num_dims() != 1)) {
+			_EXCEPTIONT("--allvars requires one-dimensional X and Y variables");
+		}
+		dimX = varX->get_dim(0);
+		dimY = varY->get_dim(0);
+
+		for (int v = 0; v < ncfilein.num_vars(); v++) {
+			NcVar * var = ncfilein.get_var(v);
+			if ((var == varX) || (var == varY)) {
+				continue;
+			}
+			const int nDims = var->num_dims();
+			if ((nDims >= 2) &&
+				(var->get_dim(nDims-2) == dimX) &&
+				(var->get_dim(nDims-1) == dimY)
+			) {
+				vecVarData.push_back(var);
+			}
+		}
+		if (vecVarData.size() == 0) {
+			_EXCEPTION2("No variables found on dimensions (%s, %s)",
+				dimX->name(), dimY->name());
+		}
+
+	} else {
+		std::vector<std::string> vecVariableStrings;
+		ParseVariableList(strVariables, vecVariableStrings);
+
+		for (int v = 0; v < vecVariableStrings.size(); v++) {
+			NcVar * var = ncfilein.get_var(vecVariableStrings[v].c_str());
+			if (var == NULL) {
+				_EXCEPTION1("Unable to find variable \"%s\" in input file",
+					vecVariableStrings[v].c_str());
+			}
+			vecVarData.push_back(var);
+		}
+		if (vecVarData.size() == 0) {
+			_EXCEPTIONT("No data variable specified");
+		}
 	}
 
 	// Identify relevant dimensions
 	AnnounceBanner();
 	AnnounceStartBlock("Identifying relevant dimensions");
 
-	int iVarDims = varData->num_dims();
-	if (iVarDims < 2) {
-		_EXCEPTIONT("Input variable must have at least 2 dimensions");
+	for (int v = 0; v < vecVarData.size(); v++) {
+		const int iVarDims = vecVarData[v]->num_dims();
+		if (iVarDims < 2) {
+			_EXCEPTION1("Input variable \"%s\" must have at least 2 dimensions",
+				vecVarData[v]->name());
+		}
+		if (v == 0) {
+			dimX = vecVarData[v]->get_dim(iVarDims-2);
+			dimY = vecVarData[v]->get_dim(iVarDims-1);
+
+		} else if (
+			(vecVarData[v]->get_dim(iVarDims-2) != dimX) ||
+			(vecVarData[v]->get_dim(iVarDims-1) != dimY)
+		) {
+			_EXCEPTION3("Input variable \"%s\" must have trailing dimensions (%s, %s)",
+				vecVarData[v]->name(), dimX->name(), dimY->name());
+		}
 	}
-	NcDim * dimX = varData->get_dim(iVarDims-2);
-	NcDim * dimY = varData->get_dim(iVarDims-1);
 
 	if (dimX->size() <= 1) {
 		_EXCEPTION1("Dimension %s must have size >= 1 (storage order?)",
@@ -541,36 +926,6 @@ try {
 	varYout->put(dYout, nYout);
 	CopyNcVarAttributes(varY, varYout);
 
-	// Data size of one input instance
-	DataArray1D<long> lDataSize(varData->num_dims());
-	int nData = 1;
-	for (int d = 0; d < varData->num_dims()-2; d++) {
-		nData *= varData->get_dim(d)->size();
-		lDataSize[d] = 1;
-	}
-	lDataSize[varData->num_dims()-2] = nX;
-	lDataSize[varData->num_dims()-1] = nY;
-
-	// Data size of one output instance
-	DataArray1D<long> lDataSizeOut = lDataSize;
-	lDataSizeOut[varData->num_dims()-2] = nXout;
-	lDataSizeOut[varData->num_dims()-1] = nYout;
-
-	Announce("%i data instance(s) found", nData);
-
-	// Pointer to output dimensions
-	DataArray1D<NcDim*> vecDimOut(varData->num_dims());
-	for (int d = 0; d < varData->num_dims()-2; d++) {
-		vecDimOut[d] =
-			ncfileout.add_dim(
-				varData->get_dim(d)->name(),
-				varData->get_dim(d)->size());
-	}
-	vecDimOut[varData->num_dims()-2] = dimXout;
-	vecDimOut[varData->num_dims()-1] = dimYout;
-
-	const NcDim ** pvardims = (const NcDim **)(&(vecDimOut[0]));
-
 	AnnounceEndBlock("Done");
 
 	// Generate 1D maps
@@ -584,259 +939,33 @@ try {
 
 	AnnounceEndBlock("Done");
 
-	// Load data
-	AnnounceStartBlock("Begin remapping");
-
-	DataArray2D<char> dByteData;
-	DataArray2D<short> dShortData;
-	DataArray2D<int> dIntData;
-	DataArray2D<float> dFloatData;
-	DataArray2D<double> dDoubleData;
-
-	DataArray2D<char> dByteDataOut;
-	DataArray2D<short> dShortDataOut;
-	DataArray2D<int> dIntDataOut;
-	DataArray2D<float> dFloatDataOut;
-	DataArray2D<double> dDoubleDataOut;
-
-	char bFindByte = 0;
-	char bReplaceByte = 0;
-
-	short sFindShort = 0;
-	short sReplaceShort = 0;
-
-	int iFindInt = 0;
-	int iReplaceInt = 0;
-
-	float dFindFloat = 0.0f;
-	float dReplaceFloat = 0.0f;
-
-	double dFindDouble = 0.0;
-	double dReplaceDouble = 0.0;
-
-	NcVar * varDataOut = NULL;
-
-	if (varData->type() == ncByte) {
-		dByteData.Allocate(nX, nY);
-		dByteDataOut.Allocate(nXout, nYout);
-
-		if (strFind != "") {
-			bFindByte = (char)atoi(strFind.c_str());
-		}
-		if (strReplace != "") {
-			bReplaceByte = (char)atoi(strReplace.c_str());
-		}
-
-	} else if (varData->type() == ncShort) {
-		dShortData.Allocate(nX, nY);
-		dShortDataOut.Allocate(nXout, nYout);
-
-		if (strFind != "") {
-			sFindShort = (short)atoi(strFind.c_str());
-		}
-		if (strReplace != "") {
-			sReplaceShort = (short)atoi(strReplace.c_str());
-		}
-
-	} else if (varData->type() == ncInt) {
-		dIntData.Allocate(nX, nY);
-		dIntDataOut.Allocate(nXout, nYout);
-
-		if (strFind != "") {
-			iFindInt = (int)atoi(strFind.c_str());
-		}
-		if (strReplace != "") {
-			iReplaceInt = (int)atoi(strReplace.c_str());
-		}
-
-	} else if (varData->type() == ncFloat) {
-		dFloatData.Allocate(nX, nY);
-		dFloatDataOut.Allocate(nXout, nYout);
-
-		if (strFind != "") {
-			dFindFloat = (float)atof(strFind.c_str());
-		}
-		if (strReplace != "") {
-			dReplaceFloat = (float)atof(strReplace.c_str());
-		}
-
-	} else if (varData->type() == ncDouble) {
-		dDoubleData.Allocate(nX, nY);
-		dDoubleDataOut.Allocate(nXout, nYout);
-
-		if (strFind != "") {
-			dFindDouble = (double)atof(strFind.c_str());
-		}
-		if (strReplace != "") {
-			dReplaceDouble = (double)atof(strReplace.c_str());
-		}
-
-	} else {
-		_EXCEPTIONT("Invalid datatype");
-	}
-
-	if (fOutputDouble) {
-		dDoubleDataOut.Allocate(nXout, nYout);
-	}
-
-	NcType vartype = varData->type();
-	if (fOutputDouble) {
-		vartype = ncDouble;
-	}
-	varDataOut = ncfileout.add_var(strVariable.c_str(), vartype, vecDimOut.GetRows(), pvardims);
-	if (varDataOut == NULL) {
-		_EXCEPTIONT("Unable to create output variable");
-	}
-
-	// Copy variable attributes
-	CopyNcVarAttributes(varData, varDataOut);
-
 	// Remap
-	for (int i = 0; i < nData; i++) {
-		char szBuffer[256];
-		sprintf(szBuffer, "Remapping data instance %i", i);
-		AnnounceStartBlock(szBuffer);
-
-		DataArray1D<long> lDataIx(varData->num_dims());
-		lDataIx[varData->num_dims()-1] = 0;
-		lDataIx[varData->num_dims()-2] = 0;
-
-		int iData = i;
-		for (int d = varData->num_dims()-2; d >= 0; d--) {
-			lDataIx[d] = iData % varData->get_dim(d)->size();
-			iData /= varData->get_dim(d)->size();
-		}
-
-		varData->set_cur((long*)(lDataIx));
-		varDataOut->set_cur((long*)(lDataIx));
-
-		double dTotalMassIn = 0.0;
-		double dTotalMassOut = 0.0;
-
-		// Read data
-		{
-			Announce("Reading data");
-			if (varData->type() == ncByte) {
-				varData->get(&(dByteData[0][0]), lDataSize);
-			} else if (varData->type() == ncShort) {
-				varData->get(&(dShortData[0][0]), lDataSize);
-			} else if (varData->type() == ncInt) {
-				varData->get(&(dIntData[0][0]), lDataSize);
-			} else if (varData->type() == ncFloat) {
-				varData->get(&(dFloatData[0][0]), lDataSize);
-			} else if (varData->type() == ncDouble) {
-				varData->get(&(dDoubleData[0][0]), lDataSize);
-			} else {
-				_EXCEPTIONT("Invalid datatype");
-			}
-		}
-
-		// Apply find and replace
-		if (strFind != "") {
-			Announce("Applying find and replace");
-
-			if (varData->type() == ncByte) {
-				FindReplace<char>(dByteData, bFindByte, bReplaceByte);
-			} else if (varData->type() == ncShort) {
-				FindReplace<short>(dShortData, sFindShort, sReplaceShort);
-			} else if (varData->type() == ncInt) {
-				FindReplace<int>(dIntData, iFindInt, iReplaceInt);
-			} else if (varData->type() == ncShort) {
-				FindReplace<float>(dFloatData, dFindFloat, dReplaceFloat);
-			} else if (varData->type() == ncDouble) {
-				FindReplace<double>(dDoubleData, dFindDouble, dReplaceDouble);
-			}
-		}
-
-		// Apply maps
-		{
-			if (fValidate) {
-				if (varData->type() == ncByte) {
-					dTotalMassIn = TotalMatrix<char>(dByteData, dXedge, dYedge);
-				} else if (varData->type() == ncShort) {
-					dTotalMassIn = TotalMatrix<short>(dShortData, dXedge, dYedge);
-				} else if (varData->type() == ncInt) {
-					dTotalMassIn = TotalMatrix<int>(dIntData, dXedge, dYedge);
-				} else if (varData->type() == ncFloat) {
-					dTotalMassIn = TotalMatrix<float>(dFloatData, dXedge, dYedge);
-				} else if (varData->type() == ncDouble) {
-					dTotalMassIn = TotalMatrix<double>(dDoubleData, dXedge, dYedge);
-				} else {
-					_EXCEPTIONT("Invalid datatype");
-				}
-				Announce("Input mass: %1.15e", dTotalMassIn);
-			}
-
-			Announce("Applying map");
-
-			if (varData->type() == ncByte) {
-				if (fOutputDouble) {
-					ApplyMap<char,double>(dByteData, matX1D, matY1D, dDoubleDataOut);
-				} else {
-					ApplyMap<char>(dByteData, matX1D, matY1D, dByteDataOut);
-				}
-
-			} else if (varData->type() == ncShort) {
-				if (fOutputDouble) {
-					ApplyMap<short,double>(dShortData, matX1D, matY1D, dDoubleDataOut);
-				} else {
-					ApplyMap<short>(dShortData, matX1D, matY1D, dShortDataOut);
-				}
-
-			} else if (varData->type() == ncInt) {
-				if (fOutputDouble) {
-					ApplyMap<int,double>(dIntData, matX1D, matY1D, dDoubleDataOut);
-				} else {
-					ApplyMap<int>(dIntData, matX1D, matY1D, dIntDataOut);
-				}
-
-			} else if (varData->type() == ncShort) {
-				if (fOutputDouble) {
-					ApplyMap<float,double>(dFloatData, matX1D, matY1D, dDoubleDataOut);
-				} else {
-					ApplyMap<float>(dFloatData, matX1D, matY1D, dFloatDataOut);
-				}
-
-			} else if (varData->type() == ncDouble) {
-				ApplyMap<double>(dDoubleData, matX1D, matY1D, dDoubleDataOut);
-			}
-
-			if (fValidate) {
-				if ((fOutputDouble) || (varData->type() == ncDouble)) {
-					dTotalMassOut = TotalMatrix<double>(dDoubleDataOut, dXedgeout, dYedgeout);
-				} else if (varData->type() == ncByte) {
-					dTotalMassOut = TotalMatrix<char>(dByteDataOut, dXedgeout, dYedgeout);
-				} else if (varData->type() == ncShort) {
-					dTotalMassOut = TotalMatrix<short>(dShortDataOut, dXedgeout, dYedgeout);
-				} else if (varData->type() == ncInt) {
-					dTotalMassOut = TotalMatrix<int>(dIntDataOut, dXedgeout, dYedgeout);
-				} else if (varData->type() == ncFloat) {
-					dTotalMassOut = TotalMatrix<float>(dFloatDataOut, dXedgeout, dYedgeout);
-				} else {
-					_EXCEPTIONT("Invalid datatype");
-				}
-				Announce("Output mass: %1.15e", dTotalMassOut);
-			}
-
-		}
+	AnnounceStartBlock("Begin remapping");
 
-		// Write
-		{
-			Announce("Writing data");
-			if ((fOutputDouble) || (varData->type() == ncDouble)) {
-				varDataOut->put(&(dDoubleDataOut[0][0]), lDataSizeOut);
-			} else if (varData->type() == ncByte) {
-				varDataOut->put(&(dByteDataOut[0][0]), lDataSizeOut);
-			} else if (varData->type() == ncShort) {
-				varDataOut->put(&(dShortDataOut[0][0]), lDataSizeOut);
-			} else if (varData->type() == ncInt) {
-				varDataOut->put(&(dIntDataOut[0][0]), lDataSizeOut);
-			} else if (varData->type() == ncFloat) {
-				varDataOut->put(&(dFloatDataOut[0][0]), lDataSizeOut);
-			} else {
-				_EXCEPTIONT("Invalid datatype");
-			}
-		}
+	for (int v = 0; v < vecVarData.size(); v++) {
+		std::string strBlock = "Remapping variable ";
+		strBlock += vecVarData[v]->name();
+		AnnounceStartBlock(strBlock.c_str());
+
+		CoarsenVariable(
+			vecVarData[v],
+			ncfileout,
+			dimXout,
+			dimYout,
+			matX1D,
+			matY1D,
+			dXedge,
+			dYedge,
+			dXedgeout,
+			dYedgeout,
+			strFind,
+			strReplace,
+			fValidate,
+			fOutputDouble,
+			static_cast<size_t>(nChunkSize),
+			nThreads);
+
+		AnnounceEndBlock("Done");
 	}
 
 	AnnounceEndBlock("Done");
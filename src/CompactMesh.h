@@ -0,0 +1,263 @@
+///////////////////////////////////////////////////////////////////////////////
+///
+///	\file    CompactMesh.h
+///	\author  agent
+///	\version October 14, 2026
+///
+///	<remarks>
+///		Copyright 2026 agent
+///
+///		This file is distributed as part of the Tempest source code package.
+///		Permission is granted to use, copy, modify and distribute this
+///		source code and its documentation under the terms of the GNU General
+///		Public License.  This software is provided "as is" without express
+///		or implied warranty.
+///	</remarks>
+
+#ifndef _COMPACTMESH_H_
+#define _COMPACTMESH_H_
+
+#include "GridElements.h"
+#include "Exception.h"
+
+#include <vector>
+#include <limits>
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		A compact, allocation-free representation of the nodes and faces
+///		of a Mesh.  Node coordinates are stored as separate x, y and z
+///		arrays and Face connectivity is stored in compressed row form, with
+///		one edge type byte per edge.  Edge j of Face i connects local nodes
+///		j and j+1 (mod the number of nodes of the Face).  IndexType may be
+///		chosen as a 32-bit integer to halve the size of the connectivity
+///		arrays for meshes that fit.
+///	</summary>
+template<typename IndexType = int>
+class CompactMesh {
+
+public:
+	///	<summary>
+	///		Default constructor.
+	///	</summary>
+	CompactMesh() {
+		m_vecFaceOffsets.push_back(0);
+	}
+
+	///	<summary>
+	///		Constructor from a Mesh.
+	///	</summary>
+	CompactMesh(
+		const Mesh & mesh
+	) {
+		FromMesh(mesh);
+	}
+
+public:
+	///	<summary>
+	///		Build the compact representation of the nodes and faces of the
+	///		given Mesh, replacing the current contents.
+	///	</summary>
+	void FromMesh(
+		const Mesh & mesh
+	) {
+		const size_t sNodes = mesh.nodes.size();
+		const size_t sFaces = mesh.faces.size();
+
+		size_t sFaceNodes = 0;
+		for (size_t i = 0; i < sFaces; i++) {
+			sFaceNodes += mesh.faces[i].edges.size();
+		}
+
+		const size_t sIndexMax =
+			static_cast<size_t>(std::numeric_limits<IndexType>::max());
+
+		if ((sNodes > sIndexMax) || (sFaceNodes > sIndexMax)) {
+			_EXCEPTION1("Mesh too large for CompactMesh index type "
+				"(%lu face nodes)", sFaceNodes);
+		}
+
+		m_dX.resize(sNodes);
+		m_dY.resize(sNodes);
+		m_dZ.resize(sNodes);
+
+		for (size_t i = 0; i < sNodes; i++) {
+			m_dX[i] = mesh.nodes[i].x;
+			m_dY[i] = mesh.nodes[i].y;
+			m_dZ[i] = mesh.nodes[i].z;
+		}
+
+		m_vecFaceOffsets.resize(sFaces + 1);
+		m_vecFaceNodes.resize(sFaceNodes);
+		m_vecEdgeType.resize(sFaceNodes);
+
+		size_t ix = 0;
+		m_vecFaceOffsets[0] = 0;
+
+		for (size_t i = 0; i < sFaces; i++) {
+			const EdgeVector & edges = mesh.faces[i].edges;
+
+			for (size_t j = 0; j < edges.size(); j++) {
+				m_vecFaceNodes[ix] = static_cast<IndexType>(edges[j][0]);
+				m_vecEdgeType[ix] = static_cast<unsigned char>(edges[j].type);
+				ix++;
+			}
+
+			m_vecFaceOffsets[i+1] = static_cast<IndexType>(ix);
+		}
+	}
+
+	///	<summary>
+	///		Replace the nodes and faces of the given Mesh with the contents
+	///		of this CompactMesh.  No other data members of the Mesh are
+	///		modified.
+	///	</summary>
+	void ToMesh(
+		Mesh & mesh
+	) const {
+		const int nNodes = GetNodeCount();
+		const int nFaces = GetFaceCount();
+
+		mesh.nodes.resize(nNodes);
+		for (int i = 0; i < nNodes; i++) {
+			mesh.nodes[i] = Node(m_dX[i], m_dY[i], m_dZ[i]);
+		}
+
+		mesh.faces.clear();
+		mesh.faces.reserve(nFaces);
+
+		for (int i = 0; i < nFaces; i++) {
+			const int nEdges = GetFaceNodeCount(i);
+			const IndexType * pNodes = GetFaceNodes(i);
+			const unsigned char * pTypes = GetEdgeTypes(i);
+
+			mesh.faces.push_back(Face(nEdges));
+
+			Face & face = mesh.faces.back();
+			for (int j = 0; j < nEdges; j++) {
+				face.SetNode(j, static_cast<int>(pNodes[j]));
+				face.edges[j].type = static_cast<Edge::Type>(pTypes[j]);
+			}
+		}
+	}
+
+	///	<summary>
+	///		Clear the contents of this CompactMesh.
+	///	</summary>
+	void Clear() {
+		m_dX.clear();
+		m_dY.clear();
+		m_dZ.clear();
+		m_vecFaceOffsets.clear();
+		m_vecFaceOffsets.push_back(0);
+		m_vecFaceNodes.clear();
+		m_vecEdgeType.clear();
+	}
+
+public:
+	///	<summary>
+	///		Get the number of nodes.
+	///	</summary>
+	int GetNodeCount() const {
+		return static_cast<int>(m_dX.size());
+	}
+
+	///	<summary>
+	///		Get the number of faces.
+	///	</summary>
+	int GetFaceCount() const {
+		return static_cast<int>(m_vecFaceOffsets.size()) - 1;
+	}
+
+	///	<summary>
+	///		Get the specified node as a Node.
+	///	</summary>
+	Node GetNode(int ix) const {
+		return Node(m_dX[ix], m_dY[ix], m_dZ[ix]);
+	}
+
+	///	<summary>
+	///		Get the x, y or z coordinate array of all nodes.
+	///	</summary>
+	const Real * GetX() const {
+		return m_dX.data();
+	}
+
+	const Real * GetY() const {
+		return m_dY.data();
+	}
+
+	const Real * GetZ() const {
+		return m_dZ.data();
+	}
+
+	///	<summary>
+	///		Get the number of nodes (equivalently, edges) of a face.
+	///	</summary>
+	int GetFaceNodeCount(int ixFace) const {
+		return static_cast<int>(
+			m_vecFaceOffsets[ixFace+1] - m_vecFaceOffsets[ixFace]);
+	}
+
+	///	<summary>
+	///		Get the node indices of a face, in counter-clockwise order.
+	///	</summary>
+	const IndexType * GetFaceNodes(int ixFace) const {
+		return m_vecFaceNodes.data() + m_vecFaceOffsets[ixFace];
+	}
+
+	///	<summary>
+	///		Get the Edge::Type of each edge of a face.
+	///	</summary>
+	const unsigned char * GetEdgeTypes(int ixFace) const {
+		return m_vecEdgeType.data() + m_vecFaceOffsets[ixFace];
+	}
+
+	///	<summary>
+	///		Get the compressed row offsets into the face node array; the
+	///		array has one more entry than the number of faces.
+	///	</summary>
+	const std::vector<IndexType> & GetFaceOffsets() const {
+		return m_vecFaceOffsets;
+	}
+
+	///	<summary>
+	///		Get the approximate memory footprint of this CompactMesh in bytes.
+	///	</summary>
+	size_t GetByteSize() const {
+		return
+			  3 * m_dX.size() * sizeof(Real)
+			+ m_vecFaceOffsets.size() * sizeof(IndexType)
+			+ m_vecFaceNodes.size() * sizeof(IndexType)
+			+ m_vecEdgeType.size() * sizeof(unsigned char);
+	}
+
+protected:
+	///	<summary>
+	///		Coordinates of each node.
+	///	</summary>
+	std::vector<Real> m_dX;
+	std::vector<Real> m_dY;
+	std::vector<Real> m_dZ;
+
+	///	<summary>
+	///		Offset of the first node of each face in m_vecFaceNodes.
+	///	</summary>
+	std::vector<IndexType> m_vecFaceOffsets;
+
+	///	<summary>
+	///		Node indices of all faces, concatenated.
+	///	</summary>
+	std::vector<IndexType> m_vecFaceNodes;
+
+	///	<summary>
+	///		Edge::Type of each edge, parallel to m_vecFaceNodes.
+	///	</summary>
+	std::vector<unsigned char> m_vecEdgeType;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+#endif
+
@@ -0,0 +1,709 @@
+///////////////////////////////////////////////////////////////////////////////
+///
+///	\file    CompactOverlapMesh.cpp
+///	\author  agent
+///	\version October 15, 2026
+///
+///	<remarks>
+///		Copyright 2026 agent
+///
+///		This file is distributed as part of the Tempest source code package.
+///		Permission is granted to use, copy, modify and distribute this
+///		source code and its documentation under the terms of the GNU General
+///		Public License.  This software is provided "as is" without express
+///		or implied warranty.
+///	</remarks>
+
+#include "CompactOverlapMesh.h"
+#include "Defines.h"
+#include "Exception.h"
+#include "node_hash_3d.h"
+
+#include <cstdio>
+#include <cstdlib>
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Constants for the 64-bit FNV-1a hash of node coordinates.
+///	</summary>
+static const uint64_t FNV1aOffsetBasis = 14695981039346656037ULL;
+static const uint64_t FNV1aPrime = 1099511628211ULL;
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Predicate accepting the index of a Node that is bitwise identical
+///		to a given Node.  Only such Nodes are stored implicitly, so that
+///		expansion reproduces the overlap mesh exactly.
+///	</summary>
+class IdenticalNodePredicate {
+
+public:
+	///	<summary>
+	///		Constructor.
+	///	</summary>
+	IdenticalNodePredicate(
+		const NodeVector & nodes,
+		const Node & node
+	) :
+		m_nodes(nodes),
+		m_node(node)
+	{ }
+
+	///	<summary>
+	///		Check if the Node with the given index is identical to m_node.
+	///	</summary>
+	bool operator()(size_t ix) const {
+		return (
+		    (m_nodes[ix].x == m_node.x) &&
+		    (m_nodes[ix].y == m_node.y) &&
+		    (m_nodes[ix].z == m_node.z));
+	}
+
+protected:
+	///	<summary>
+	///		Vector of candidate Nodes.
+	///	</summary>
+	const NodeVector & m_nodes;
+
+	///	<summary>
+	///		Node being searched for.
+	///	</summary>
+	const Node & m_node;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// CompactOverlapMesh
+///////////////////////////////////////////////////////////////////////////////
+
+CompactOverlapMesh::CompactOverlapMesh() :
+	m_nSourceNodes(0),
+	m_nTargetNodes(0),
+	m_ullSourceHash(0),
+	m_ullTargetHash(0)
+{
+	m_vecFaceOffsets.push_back(0);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void CompactOverlapMesh::Clear() {
+	m_nSourceNodes = 0;
+	m_nTargetNodes = 0;
+	m_ullSourceHash = 0;
+	m_ullTargetHash = 0;
+	m_strSourceMesh.clear();
+	m_strTargetMesh.clear();
+	m_vecNodeOrigin.clear();
+	m_dX.clear();
+	m_dY.clear();
+	m_dZ.clear();
+	m_vecFaceOffsets.clear();
+	m_vecFaceOffsets.push_back(0);
+	m_vecFaceNodes.clear();
+	m_vecEdgeType.clear();
+	m_vecSourceFaceIx.clear();
+	m_vecTargetFaceIx.clear();
+	m_vecFaceArea.clear();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+uint64_t CompactOverlapMesh::HashNodes(
+	const NodeVector & nodes
+) {
+	uint64_t uHash = FNV1aOffsetBasis;
+	for (size_t i = 0; i < nodes.size(); i++) {
+		const Real dCoord[3] = { nodes[i].x, nodes[i].y, nodes[i].z };
+		const unsigned char * p =
+			reinterpret_cast<const unsigned char *>(dCoord);
+		for (size_t b = 0; b < sizeof(dCoord); b++) {
+			uHash ^= static_cast<uint64_t>(p[b]);
+			uHash *= FNV1aPrime;
+		}
+	}
+	return uHash;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void CompactOverlapMesh::FromMesh(
+	const Mesh & meshOverlap,
+	const Mesh & meshSource,
+	const Mesh & meshTarget,
+	int nThreads
+) {
+	const int nOverlapNodes = static_cast<int>(meshOverlap.nodes.size());
+	const int nOverlapFaces = static_cast<int>(meshOverlap.faces.size());
+
+	if (meshOverlap.vecSourceFaceIx.size() != nOverlapFaces) {
+		_EXCEPTIONT("Overlap mesh is missing source face indices");
+	}
+	if (meshOverlap.vecTargetFaceIx.size() != nOverlapFaces) {
+		_EXCEPTIONT("Overlap mesh is missing target face indices");
+	}
+
+	Clear();
+
+	m_nSourceNodes = static_cast<int>(meshSource.nodes.size());
+	m_nTargetNodes = static_cast<int>(meshTarget.nodes.size());
+	m_ullSourceHash = HashNodes(meshSource.nodes);
+	m_ullTargetHash = HashNodes(meshTarget.nodes);
+	m_strSourceMesh = meshSource.strFileName;
+	m_strTargetMesh = meshTarget.strFileName;
+
+	// Find the origin of each overlap Node
+	const node_bins_3d<Node> binsSource(
+		meshSource.nodes,
+		ReferenceTolerance,
+		MESH_NODE_HASH_CELL_WIDTH,
+		nThreads);
+
+	const node_bins_3d<Node> binsTarget(
+		meshTarget.nodes,
+		ReferenceTolerance,
+		MESH_NODE_HASH_CELL_WIDTH,
+		nThreads);
+
+	m_vecNodeOrigin.resize(nOverlapNodes);
+
+#pragma omp parallel for num_threads(nThreads)
+	for (int i = 0; i < nOverlapNodes; i++) {
+		const Node & node = meshOverlap.nodes[i];
+
+		size_t ix = binsSource.find_first_if(
+			node, binsSource.size(),
+			IdenticalNodePredicate(meshSource.nodes, node));
+
+		if (ix != binsSource.size()) {
+			m_vecNodeOrigin[i] = static_cast<int>(ix);
+			continue;
+		}
+
+		ix = binsTarget.find_first_if(
+			node, binsTarget.size(),
+			IdenticalNodePredicate(meshTarget.nodes, node));
+
+		if (ix != binsTarget.size()) {
+			m_vecNodeOrigin[i] = m_nSourceNodes + static_cast<int>(ix);
+			continue;
+		}
+
+		m_vecNodeOrigin[i] = (-1);
+	}
+
+	// Store coordinates of new Nodes
+	const int nImplicitNodes = m_nSourceNodes + m_nTargetNodes;
+	for (int i = 0; i < nOverlapNodes; i++) {
+		if (m_vecNodeOrigin[i] != (-1)) {
+			continue;
+		}
+		m_vecNodeOrigin[i] = nImplicitNodes + static_cast<int>(m_dX.size());
+		m_dX.push_back(meshOverlap.nodes[i].x);
+		m_dY.push_back(meshOverlap.nodes[i].y);
+		m_dZ.push_back(meshOverlap.nodes[i].z);
+	}
+
+	// Store Faces
+	m_vecFaceOffsets.resize(nOverlapFaces + 1);
+	m_vecFaceOffsets[0] = 0;
+	for (int i = 0; i < nOverlapFaces; i++) {
+		m_vecFaceOffsets[i+1] =
+			m_vecFaceOffsets[i]
+			+ static_cast<int>(meshOverlap.faces[i].edges.size());
+	}
+
+	m_vecFaceNodes.resize(m_vecFaceOffsets[nOverlapFaces]);
+
+	bool fAllGreatCircleArcs = true;
+	for (int i = 0; i < nOverlapFaces; i++) {
+		const Face & face = meshOverlap.faces[i];
+		for (int k = 0; k < face.edges.size(); k++) {
+			m_vecFaceNodes[m_vecFaceOffsets[i] + k] = face[k];
+			if (face.edges[k].type != Edge::Type_GreatCircleArc) {
+				fAllGreatCircleArcs = false;
+			}
+		}
+	}
+
+	if (!fAllGreatCircleArcs) {
+		m_vecEdgeType.resize(m_vecFaceNodes.size());
+		for (int i = 0; i < nOverlapFaces; i++) {
+			const Face & face = meshOverlap.faces[i];
+			for (int k = 0; k < face.edges.size(); k++) {
+				m_vecEdgeType[m_vecFaceOffsets[i] + k] =
+					static_cast<unsigned char>(face.edges[k].type);
+			}
+		}
+	}
+
+	m_vecSourceFaceIx = meshOverlap.vecSourceFaceIx;
+	m_vecTargetFaceIx = meshOverlap.vecTargetFaceIx;
+
+	if (meshOverlap.vecFaceArea.GetRows() == nOverlapFaces) {
+		m_vecFaceArea.resize(nOverlapFaces);
+		for (int i = 0; i < nOverlapFaces; i++) {
+			m_vecFaceArea[i] = meshOverlap.vecFaceArea[i];
+		}
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+bool CompactOverlapMesh::MatchesMeshes(
+	const Mesh & meshSource,
+	const Mesh & meshTarget
+) const {
+	if (meshSource.nodes.size() != m_nSourceNodes) {
+		return false;
+	}
+	if (meshTarget.nodes.size() != m_nTargetNodes) {
+		return false;
+	}
+	if (HashNodes(meshSource.nodes) != m_ullSourceHash) {
+		return false;
+	}
+	if (HashNodes(meshTarget.nodes) != m_ullTargetHash) {
+		return false;
+	}
+	return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+Node CompactOverlapMesh::GetNode(
+	int ix,
+	const NodeVector & nodesSource,
+	const NodeVector & nodesTarget
+) const {
+	const int iOrigin = m_vecNodeOrigin[ix];
+
+	if (iOrigin < m_nSourceNodes) {
+		return nodesSource[iOrigin];
+	}
+	if (iOrigin < m_nSourceNodes + m_nTargetNodes) {
+		return nodesTarget[iOrigin - m_nSourceNodes];
+	}
+
+	const int iNew = iOrigin - m_nSourceNodes - m_nTargetNodes;
+	return Node(m_dX[iNew], m_dY[iNew], m_dZ[iNew]);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void CompactOverlapMesh::ToMesh(
+	const Mesh & meshSource,
+	const Mesh & meshTarget,
+	Mesh & meshOverlap,
+	int nThreads
+) const {
+	if (!MatchesMeshes(meshSource, meshTarget)) {
+		_EXCEPTIONT("Source and target meshes do not match the meshes "
+			"used to generate this compact overlap mesh");
+	}
+
+	const int nOverlapNodes = GetNodeCount();
+	const int nOverlapFaces = GetFaceCount();
+
+	meshOverlap.Clear();
+	meshOverlap.type = Mesh::MeshType_Overlap;
+
+	// Expand Nodes
+	meshOverlap.nodes.resize(nOverlapNodes);
+
+#pragma omp parallel for num_threads(nThreads)
+	for (int i = 0; i < nOverlapNodes; i++) {
+		meshOverlap.nodes[i] =
+			GetNode(i, meshSource.nodes, meshTarget.nodes);
+	}
+
+	// Expand Faces
+	meshOverlap.faces.resize(nOverlapFaces);
+
+#pragma omp parallel for num_threads(nThreads)
+	for (int i = 0; i < nOverlapFaces; i++) {
+		const int nEdges = m_vecFaceOffsets[i+1] - m_vecFaceOffsets[i];
+
+		Face face(nEdges);
+		for (int k = 0; k < nEdges; k++) {
+			face.SetNode(k, m_vecFaceNodes[m_vecFaceOffsets[i] + k]);
+		}
+		if (m_vecEdgeType.size() != 0) {
+			for (int k = 0; k < nEdges; k++) {
+				face.edges[k].type = static_cast<Edge::Type>(
+					m_vecEdgeType[m_vecFaceOffsets[i] + k]);
+			}
+		}
+		meshOverlap.faces[i] = face;
+	}
+
+	meshOverlap.vecSourceFaceIx = m_vecSourceFaceIx;
+	meshOverlap.vecTargetFaceIx = m_vecTargetFaceIx;
+
+	if (m_vecFaceArea.size() == nOverlapFaces) {
+		meshOverlap.vecFaceArea.Allocate(nOverlapFaces);
+		for (int i = 0; i < nOverlapFaces; i++) {
+			meshOverlap.vecFaceArea[i] = m_vecFaceArea[i];
+		}
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+size_t CompactOverlapMesh::GetByteSize() const {
+	return
+		m_vecNodeOrigin.size() * sizeof(int)
+		+ (m_dX.size() + m_dY.size() + m_dZ.size()) * sizeof(Real)
+		+ m_vecFaceOffsets.size() * sizeof(int)
+		+ m_vecFaceNodes.size() * sizeof(int)
+		+ m_vecEdgeType.size() * sizeof(unsigned char)
+		+ m_vecSourceFaceIx.size() * sizeof(int)
+		+ m_vecTargetFaceIx.size() * sizeof(int)
+		+ m_vecFaceArea.size() * sizeof(double);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void CompactOverlapMesh::Write(
+	const std::string & strFile,
+	NcFile::FileFormat eFileFormat
+) const {
+	const int nOverlapNodes = GetNodeCount();
+	const int nOverlapFaces = GetFaceCount();
+	const int nNewNodes = GetNewNodeCount();
+	const int nFaceNodes = static_cast<int>(m_vecFaceNodes.size());
+
+	if (nOverlapFaces <= 0) {
+		_EXCEPTIONT("Compact overlap mesh contains no faces");
+	}
+
+	NcFile ncOut(strFile.c_str(), NcFile::Replace, NULL, 0, eFileFormat);
+	if (!ncOut.is_valid()) {
+		_EXCEPTION1("Unable to open grid file \"%s\" for writing",
+			strFile.c_str());
+	}
+
+	// Global attributes
+	char szHash[32];
+
+	ncOut.add_att("overlap_compact", "true");
+	ncOut.add_att("source_mesh", m_strSourceMesh.c_str());
+	ncOut.add_att("target_mesh", m_strTargetMesh.c_str());
+	ncOut.add_att("source_node_count", m_nSourceNodes);
+	ncOut.add_att("target_node_count", m_nTargetNodes);
+
+	snprintf(szHash, sizeof(szHash), "%016llx",
+		static_cast<unsigned long long>(m_ullSourceHash));
+	ncOut.add_att("source_node_hash", szHash);
+
+	snprintf(szHash, sizeof(szHash), "%016llx",
+		static_cast<unsigned long long>(m_ullTargetHash));
+	ncOut.add_att("target_node_hash", szHash);
+
+	// Dimensions (zero-length dimensions are omitted, since they would be
+	// interpreted as unlimited)
+	NcDim * dimNodes = ncOut.add_dim("num_nodes", nOverlapNodes);
+	NcDim * dimElements = ncOut.add_dim("num_elem", nOverlapFaces);
+	NcDim * dimFaceNodes = ncOut.add_dim("num_face_nodes", nFaceNodes);
+	NcDim * dimDim = ncOut.add_dim("num_dim", 3);
+
+	NcDim * dimNewNodes = NULL;
+	if (nNewNodes != 0) {
+		dimNewNodes = ncOut.add_dim("num_new_nodes", nNewNodes);
+	}
+
+	// Node origins and coordinates of new Nodes
+	NcVar * varNodeOrigin = ncOut.add_var("node_origin", ncInt, dimNodes);
+	if (varNodeOrigin == NULL) {
+		_EXCEPTIONT("Error creating variable \"node_origin\"");
+	}
+	varNodeOrigin->put(&(m_vecNodeOrigin[0]), nOverlapNodes);
+
+	if (nNewNodes != 0) {
+		NcVar * varCoord =
+			ncOut.add_var("coord_new", ncDouble, dimDim, dimNewNodes);
+		if (varCoord == NULL) {
+			_EXCEPTIONT("Error creating variable \"coord_new\"");
+		}
+
+		varCoord->set_cur(0, 0);
+		varCoord->put(&(m_dX[0]), 1, nNewNodes);
+		varCoord->set_cur(1, 0);
+		varCoord->put(&(m_dY[0]), 1, nNewNodes);
+		varCoord->set_cur(2, 0);
+		varCoord->put(&(m_dZ[0]), 1, nNewNodes);
+	}
+
+	// Faces
+	{
+		std::vector<short> vecFaceSize(nOverlapFaces);
+		for (int i = 0; i < nOverlapFaces; i++) {
+			const int nEdges = m_vecFaceOffsets[i+1] - m_vecFaceOffsets[i];
+			if (nEdges > 32767) {
+				_EXCEPTION1("Overlap face %i has too many edges", i);
+			}
+			vecFaceSize[i] = static_cast<short>(nEdges);
+		}
+
+		NcVar * varFaceSize = ncOut.add_var("face_size", ncShort, dimElements);
+		if (varFaceSize == NULL) {
+			_EXCEPTIONT("Error creating variable \"face_size\"");
+		}
+		varFaceSize->put(&(vecFaceSize[0]), nOverlapFaces);
+	}
+
+	NcVar * varFaceNodes = ncOut.add_var("face_nodes", ncInt, dimFaceNodes);
+	if (varFaceNodes == NULL) {
+		_EXCEPTIONT("Error creating variable \"face_nodes\"");
+	}
+	varFaceNodes->put(&(m_vecFaceNodes[0]), nFaceNodes);
+
+	if (m_vecEdgeType.size() != 0) {
+		NcVar * varEdgeType =
+			ncOut.add_var("edge_type", ncByte, dimFaceNodes);
+		if (varEdgeType == NULL) {
+			_EXCEPTIONT("Error creating variable \"edge_type\"");
+		}
+		varEdgeType->put(
+			reinterpret_cast<const ncbyte *>(&(m_vecEdgeType[0])),
+			nFaceNodes);
+	}
+
+	// Parent Faces (1-based, as in the Exodus overlap format)
+	{
+		std::vector<int> vecParent(nOverlapFaces);
+
+		NcVar * varParentA = ncOut.add_var("el_parent_a", ncInt, dimElements);
+		if (varParentA == NULL) {
+			_EXCEPTIONT("Error creating variable \"el_parent_a\"");
+		}
+		for (int i = 0; i < nOverlapFaces; i++) {
+			vecParent[i] = m_vecSourceFaceIx[i] + 1;
+		}
+		varParentA->put(&(vecParent[0]), nOverlapFaces);
+
+		NcVar * varParentB = ncOut.add_var("el_parent_b", ncInt, dimElements);
+		if (varParentB == NULL) {
+			_EXCEPTIONT("Error creating variable \"el_parent_b\"");
+		}
+		for (int i = 0; i < nOverlapFaces; i++) {
+			vecParent[i] = m_vecTargetFaceIx[i] + 1;
+		}
+		varParentB->put(&(vecParent[0]), nOverlapFaces);
+	}
+
+	if (m_vecFaceArea.size() == nOverlapFaces) {
+		NcVar * varArea = ncOut.add_var("el_area", ncDouble, dimElements);
+		if (varArea == NULL) {
+			_EXCEPTIONT("Error creating variable \"el_area\"");
+		}
+		varArea->put(&(m_vecFaceArea[0]), nOverlapFaces);
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+bool CompactOverlapMesh::IsCompactOverlapFile(
+	const std::string & strFile
+) {
+	NcError error(NcError::silent_nonfatal);
+
+	NcFile ncFile(strFile.c_str(), NcFile::ReadOnly);
+	if (!ncFile.is_valid()) {
+		return false;
+	}
+
+	NcAtt * attCompact = ncFile.get_att("overlap_compact");
+	if (attCompact == NULL) {
+		return false;
+	}
+	delete attCompact;
+
+	return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void CompactOverlapMesh::Read(
+	const std::string & strFile
+) {
+	Clear();
+
+	NcFile ncFile(strFile.c_str(), NcFile::ReadOnly);
+	if (!ncFile.is_valid()) {
+		_EXCEPTION1("Unable to open grid file \"%s\" for reading",
+			strFile.c_str());
+	}
+
+	// Global attributes
+	NcAtt * attCompact = ncFile.get_att("overlap_compact");
+	if (attCompact == NULL) {
+		_EXCEPTION1("Grid file \"%s\" is not a compact overlap mesh",
+			strFile.c_str());
+	}
+	delete attCompact;
+
+	const char * szAttNames[6] = {
+		"source_mesh", "target_mesh",
+		"source_node_count", "target_node_count",
+		"source_node_hash", "target_node_hash" };
+
+	NcAtt * att[6];
+	for (int a = 0; a < 6; a++) {
+		att[a] = ncFile.get_att(szAttNames[a]);
+		if (att[a] == NULL) {
+			_EXCEPTION2("Compact overlap mesh \"%s\" is missing attribute "
+				"\"%s\"", strFile.c_str(), szAttNames[a]);
+		}
+	}
+
+	char * szValue;
+
+	szValue = att[0]->as_string(0);
+	m_strSourceMesh = szValue;
+	delete[] szValue;
+
+	szValue = att[1]->as_string(0);
+	m_strTargetMesh = szValue;
+	delete[] szValue;
+
+	m_nSourceNodes = att[2]->as_int(0);
+	m_nTargetNodes = att[3]->as_int(0);
+
+	szValue = att[4]->as_string(0);
+	m_ullSourceHash = strtoull(szValue, NULL, 16);
+	delete[] szValue;
+
+	szValue = att[5]->as_string(0);
+	m_ullTargetHash = strtoull(szValue, NULL, 16);
+	delete[] szValue;
+
+	for (int a = 0; a < 6; a++) {
+		delete att[a];
+	}
+
+	// Dimensions
+	NcDim * dimNodes = ncFile.get_dim("num_nodes");
+	NcDim * dimElements = ncFile.get_dim("num_elem");
+	NcDim * dimFaceNodes = ncFile.get_dim("num_face_nodes");
+	if ((dimNodes == NULL) || (dimElements == NULL) || (dimFaceNodes == NULL)) {
+		_EXCEPTION1("Compact overlap mesh \"%s\" is missing dimension "
+			"\"num_nodes\", \"num_elem\" or \"num_face_nodes\"",
+			strFile.c_str());
+	}
+
+	const int nOverlapNodes = dimNodes->size();
+	const int nOverlapFaces = dimElements->size();
+	const int nFaceNodes = dimFaceNodes->size();
+
+	NcDim * dimNewNodes = ncFile.get_dim("num_new_nodes");
+	const int nNewNodes = (dimNewNodes == NULL)?(0):(dimNewNodes->size());
+
+	// Node origins and coordinates of new Nodes
+	NcVar * varNodeOrigin = ncFile.get_var("node_origin");
+	if (varNodeOrigin == NULL) {
+		_EXCEPTION1("Compact overlap mesh \"%s\" is missing variable "
+			"\"node_origin\"", strFile.c_str());
+	}
+	m_vecNodeOrigin.resize(nOverlapNodes);
+	varNodeOrigin->get(&(m_vecNodeOrigin[0]), nOverlapNodes);
+
+	const int nImplicitNodes = m_nSourceNodes + m_nTargetNodes;
+	for (int i = 0; i < nOverlapNodes; i++) {
+		if ((m_vecNodeOrigin[i] < 0) ||
+		    (m_vecNodeOrigin[i] >= nImplicitNodes + nNewNodes)
+		) {
+			_EXCEPTION2("Compact overlap mesh \"%s\" node origin %i "
+				"out of range", strFile.c_str(), m_vecNodeOrigin[i]);
+		}
+	}
+
+	if (nNewNodes != 0) {
+		NcVar * varCoord = ncFile.get_var("coord_new");
+		if (varCoord == NULL) {
+			_EXCEPTION1("Compact overlap mesh \"%s\" is missing variable "
+				"\"coord_new\"", strFile.c_str());
+		}
+
+		m_dX.resize(nNewNodes);
+		m_dY.resize(nNewNodes);
+		m_dZ.resize(nNewNodes);
+
+		varCoord->set_cur(0, 0);
+		varCoord->get(&(m_dX[0]), 1, nNewNodes);
+		varCoord->set_cur(1, 0);
+		varCoord->get(&(m_dY[0]), 1, nNewNodes);
+		varCoord->set_cur(2, 0);
+		varCoord->get(&(m_dZ[0]), 1, nNewNodes);
+	}
+
+	// Faces
+	NcVar * varFaceSize = ncFile.get_var("face_size");
+	NcVar * varFaceNodes = ncFile.get_var("face_nodes");
+	if ((varFaceSize == NULL) || (varFaceNodes == NULL)) {
+		_EXCEPTION1("Compact overlap mesh \"%s\" is missing variable "
+			"\"face_size\" or \"face_nodes\"", strFile.c_str());
+	}
+
+	{
+		std::vector<short> vecFaceSize(nOverlapFaces);
+		varFaceSize->get(&(vecFaceSize[0]), nOverlapFaces);
+
+		m_vecFaceOffsets.resize(nOverlapFaces + 1);
+		m_vecFaceOffsets[0] = 0;
+		for (int i = 0; i < nOverlapFaces; i++) {
+			m_vecFaceOffsets[i+1] = m_vecFaceOffsets[i] + vecFaceSize[i];
+		}
+		if (m_vecFaceOffsets[nOverlapFaces] != nFaceNodes) {
+			_EXCEPTION1("Compact overlap mesh \"%s\" face sizes are "
+				"inconsistent with \"num_face_nodes\"", strFile.c_str());
+		}
+	}
+
+	m_vecFaceNodes.resize(nFaceNodes);
+	varFaceNodes->get(&(m_vecFaceNodes[0]), nFaceNodes);
+
+	for (int i = 0; i < nFaceNodes; i++) {
+		if ((m_vecFaceNodes[i] < 0) || (m_vecFaceNodes[i] >= nOverlapNodes)) {
+			_EXCEPTION2("Compact overlap mesh \"%s\" face node %i "
+				"out of range", strFile.c_str(), m_vecFaceNodes[i]);
+		}
+	}
+
+	NcVar * varEdgeType = ncFile.get_var("edge_type");
+	if (varEdgeType != NULL) {
+		m_vecEdgeType.resize(nFaceNodes);
+		varEdgeType->get(
+			reinterpret_cast<ncbyte *>(&(m_vecEdgeType[0])),
+			nFaceNodes);
+	}
+
+	// Parent Faces
+	NcVar * varParentA = ncFile.get_var("el_parent_a");
+	NcVar * varParentB = ncFile.get_var("el_parent_b");
+	if ((varParentA == NULL) || (varParentB == NULL)) {
+		_EXCEPTION1("Compact overlap mesh \"%s\" is missing variable "
+			"\"el_parent_a\" or \"el_parent_b\"", strFile.c_str());
+	}
+
+	m_vecSourceFaceIx.resize(nOverlapFaces);
+	varParentA->get(&(m_vecSourceFaceIx[0]), nOverlapFaces);
+
+	m_vecTargetFaceIx.resize(nOverlapFaces);
+	varParentB->get(&(m_vecTargetFaceIx[0]), nOverlapFaces);
+
+	for (int i = 0; i < nOverlapFaces; i++) {
+		m_vecSourceFaceIx[i]--;
+		m_vecTargetFaceIx[i]--;
+	}
+
+	NcVar * varArea = ncFile.get_var("el_area");
+	if (varArea != NULL) {
+		m_vecFaceArea.resize(nOverlapFaces);
+		varArea->get(&(m_vecFaceArea[0]), nOverlapFaces);
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
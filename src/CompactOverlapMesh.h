@@ -0,0 +1,245 @@
+///////////////////////////////////////////////////////////////////////////////
+///
+///	\file    CompactOverlapMesh.h
+///	\author  agent
+///	\version October 15, 2026
+///
+///	<remarks>
+///		Copyright 2026 agent
+///
+///		This file is distributed as part of the Tempest source code package.
+///		Permission is granted to use, copy, modify and distribute this
+///		source code and its documentation under the terms of the GNU General
+///		Public License.  This software is provided "as is" without express
+///		or implied warranty.
+///	</remarks>
+
+#ifndef _COMPACTOVERLAPMESH_H_
+#define _COMPACTOVERLAPMESH_H_
+
+#include "GridElements.h"
+#include "netcdfcpp.h"
+
+#include <string>
+#include <vector>
+#include <stdint.h>
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		A compact representation of an overlap mesh in which nodes are
+///		stored implicitly.  Every overlap node is either a node of the
+///		source mesh, a node of the target mesh or a new node at the
+///		intersection of a source and a target edge; only the coordinates
+///		of new nodes are stored, and each node records its origin as a
+///		single index: [0, nSource) for source nodes, [nSource, nSource +
+///		nTarget) for target nodes and nSource + nTarget + i for new node i.
+///		Faces are stored in compressed row form, as in CompactMesh, with
+///		edge types only stored when some edge is not a great circle arc.
+///	</summary>
+///	<remarks>
+///		The node counts and a hash of the node coordinates of the source
+///		and target meshes are recorded so that the overlap mesh is only
+///		expanded against the meshes it was built from.  Expansion with
+///		those meshes reproduces the original overlap mesh exactly.
+///	</remarks>
+class CompactOverlapMesh {
+
+public:
+	///	<summary>
+	///		Constructor.
+	///	</summary>
+	CompactOverlapMesh();
+
+public:
+	///	<summary>
+	///		Build the compact representation of meshOverlap, whose Faces
+	///		were generated from meshSource and meshTarget.
+	///	</summary>
+	void FromMesh(
+		const Mesh & meshOverlap,
+		const Mesh & meshSource,
+		const Mesh & meshTarget,
+		int nThreads = 1
+	);
+
+	///	<summary>
+	///		Expand this compact overlap mesh into meshOverlap, using the
+	///		nodes of meshSource and meshTarget.
+	///	</summary>
+	void ToMesh(
+		const Mesh & meshSource,
+		const Mesh & meshTarget,
+		Mesh & meshOverlap,
+		int nThreads = 1
+	) const;
+
+	///	<summary>
+	///		Check if meshSource and meshTarget have the nodes this compact
+	///		overlap mesh was built from.
+	///	</summary>
+	bool MatchesMeshes(
+		const Mesh & meshSource,
+		const Mesh & meshTarget
+	) const;
+
+	///	<summary>
+	///		Get the coordinates of an overlap node, given the nodes of the
+	///		source and target meshes.
+	///	</summary>
+	Node GetNode(
+		int ix,
+		const NodeVector & nodesSource,
+		const NodeVector & nodesTarget
+	) const;
+
+	///	<summary>
+	///		Write this compact overlap mesh to a NetCDF file.
+	///	</summary>
+	void Write(
+		const std::string & strFile,
+		NcFile::FileFormat eFileFormat = NcFile::Classic
+	) const;
+
+	///	<summary>
+	///		Read a compact overlap mesh from a NetCDF file.
+	///	</summary>
+	void Read(
+		const std::string & strFile
+	);
+
+	///	<summary>
+	///		Set the file names of the source and target meshes recorded in
+	///		the output file.
+	///	</summary>
+	void SetMeshFiles(
+		const std::string & strSourceMesh,
+		const std::string & strTargetMesh
+	) {
+		m_strSourceMesh = strSourceMesh;
+		m_strTargetMesh = strTargetMesh;
+	}
+
+	///	<summary>
+	///		Check if the given NetCDF file contains a compact overlap mesh.
+	///	</summary>
+	static bool IsCompactOverlapFile(
+		const std::string & strFile
+	);
+
+	///	<summary>
+	///		Clear the contents of this compact overlap mesh.
+	///	</summary>
+	void Clear();
+
+public:
+	///	<summary>
+	///		Get the number of overlap nodes.
+	///	</summary>
+	int GetNodeCount() const {
+		return static_cast<int>(m_vecNodeOrigin.size());
+	}
+
+	///	<summary>
+	///		Get the number of new (intersection) nodes.
+	///	</summary>
+	int GetNewNodeCount() const {
+		return static_cast<int>(m_dX.size());
+	}
+
+	///	<summary>
+	///		Get the number of overlap faces.
+	///	</summary>
+	int GetFaceCount() const {
+		return static_cast<int>(m_vecFaceOffsets.size()) - 1;
+	}
+
+	///	<summary>
+	///		Get the file name of the source mesh, if known.
+	///	</summary>
+	const std::string & GetSourceMeshFile() const {
+		return m_strSourceMesh;
+	}
+
+	///	<summary>
+	///		Get the file name of the target mesh, if known.
+	///	</summary>
+	const std::string & GetTargetMeshFile() const {
+		return m_strTargetMesh;
+	}
+
+	///	<summary>
+	///		Get the approximate memory footprint of this object in bytes.
+	///	</summary>
+	size_t GetByteSize() const;
+
+	///	<summary>
+	///		Hash of the coordinates of a vector of nodes.
+	///	</summary>
+	static uint64_t HashNodes(
+		const NodeVector & nodes
+	);
+
+protected:
+	///	<summary>
+	///		Number of nodes on the source and target meshes.
+	///	</summary>
+	int m_nSourceNodes;
+	int m_nTargetNodes;
+
+	///	<summary>
+	///		Hash of the nodes of the source and target meshes.
+	///	</summary>
+	uint64_t m_ullSourceHash;
+	uint64_t m_ullTargetHash;
+
+	///	<summary>
+	///		File names of the source and target meshes.
+	///	</summary>
+	std::string m_strSourceMesh;
+	std::string m_strTargetMesh;
+
+	///	<summary>
+	///		Origin of each overlap node.
+	///	</summary>
+	std::vector<int> m_vecNodeOrigin;
+
+	///	<summary>
+	///		Coordinates of each new node.
+	///	</summary>
+	std::vector<Real> m_dX;
+	std::vector<Real> m_dY;
+	std::vector<Real> m_dZ;
+
+	///	<summary>
+	///		Offset of the first node of each face in m_vecFaceNodes.
+	///	</summary>
+	std::vector<int> m_vecFaceOffsets;
+
+	///	<summary>
+	///		Overlap node indices of all faces, concatenated.
+	///	</summary>
+	std::vector<int> m_vecFaceNodes;
+
+	///	<summary>
+	///		Edge::Type of each edge, parallel to m_vecFaceNodes, or empty
+	///		if all edges are great circle arcs.
+	///	</summary>
+	std::vector<unsigned char> m_vecEdgeType;
+
+	///	<summary>
+	///		Source and target face of each overlap face.
+	///	</summary>
+	std::vector<int> m_vecSourceFaceIx;
+	std::vector<int> m_vecTargetFaceIx;
+
+	///	<summary>
+	///		Area of each overlap face, or empty if not available.
+	///	</summary>
+	std::vector<double> m_vecFaceArea;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+#endif
+
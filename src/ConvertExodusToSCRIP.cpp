@@ -38,10 +38,18 @@ try {
 	// Output scrip filename
 	std::string strOutputFile;
 
+	// Number of threads
+	int nThreads;
+
+	// Load the full mesh before writing
+	bool fInMemory;
+
 	// Parse the command line
 	BeginCommandLine()
 		CommandLineString(strInputFile,  "in",  "");
 		CommandLineString(strOutputFile, "out", "");
+		CommandLineInt(nThreads, "nthreads", 1);
+		CommandLineBool(fInMemory, "in_memory");
 		
 		ParseCommandLine(argc, argv);
 	EndCommandLine(argv)
@@ -55,25 +63,34 @@ try {
 	if (strOutputFile == "") {
 		_EXCEPTIONT("No output file specified"); 
 	}
+	if (nThreads < 1) {
+		_EXCEPTIONT("--nthreads must be at least 1");
+	}
 
 	//---------------------------------------------------------------------------
 	//---------------------------------------------------------------------------
 
-	// Load input mesh
-	std::cout << std::endl;
-	std::cout << "..Loading input mesh" << std::endl;
+	NcFile::FileFormat eOutputFormat = NcFile::Offset64Bits;
 
-	Mesh meshIn(strInputFile);
-	meshIn.RemoveZeroEdges(); 		// Do we need this?
+	// Load the input mesh and write it
+	if (fInMemory) {
+		std::cout << std::endl;
+		std::cout << "..Loading input mesh" << std::endl;
 
-	// Generate new mesh
-	// std::cout << "..Generating SCRIP format data" << std::endl;
-	// Mesh meshOut;
+		Mesh meshIn(strInputFile);
+		meshIn.RemoveZeroEdges(); 		// Do we need this?
 
-	// Write the mesh	
-	std::cout << "..Writing mesh" << std::endl;
-	NcFile::FileFormat eOutputFormat = NcFile::Offset64Bits;
-	meshIn.WriteScrip(strOutputFile, eOutputFormat);
+		std::cout << "..Writing mesh" << std::endl;
+		meshIn.WriteScrip(strOutputFile, eOutputFormat, 0, nThreads);
+
+	// Convert the input mesh a chunk of elements at a time
+	} else {
+		std::cout << std::endl;
+		std::cout << "..Converting mesh" << std::endl;
+
+		ConvertExodusToScripStreaming(
+			strInputFile, strOutputFile, eOutputFormat, 0, nThreads);
+	}
 
 	std::cout << "..Done writing" << std::endl;
 
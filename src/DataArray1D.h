@@ -20,9 +20,11 @@
 ///////////////////////////////////////////////////////////////////////////////
 
 #include "Exception.h"
+#include "DataArrayAllocator.h"
 
 #include <cstdlib>
 #include <cstring>
+#include <utility>
 
 template <typename T>
 class DataArray1D {
@@ -35,6 +37,7 @@ public:
 	///	</summary>
 	DataArray1D() :
 		m_fOwnsData(true),
+		m_iPoolClass(-1),
 		m_sSize(0),
 		m_data(NULL)
 	{ }
@@ -44,14 +47,16 @@ public:
 	///	</summary>
 	DataArray1D(
 		size_t sSize,
-		bool fAllocate = true
+		bool fAllocate = true,
+		DataArrayStorage eStorage = DataArrayStorage_Heap
 	) :
 		m_fOwnsData(true),
+		m_iPoolClass(-1),
 		m_sSize(sSize),
 		m_data(NULL)
 	{
 		if (fAllocate) {
-			Allocate(sSize);
+			Allocate(sSize, true, eStorage);
 		}
 	}
 
@@ -60,12 +65,29 @@ public:
 	///	</summary>
 	DataArray1D(const DataArray1D<T> & da) :
 		m_fOwnsData(true),
+		m_iPoolClass(-1),
 		m_sSize(0),
 		m_data(NULL)
 	{
 		Assign(da);
 	}
 
+	///	<summary>
+	///		Move constructor, which takes the data of da and leaves it
+	///		empty.
+	///	</summary>
+	DataArray1D(DataArray1D<T> && da) noexcept :
+		m_fOwnsData(da.m_fOwnsData),
+		m_iPoolClass(da.m_iPoolClass),
+		m_sSize(da.m_sSize),
+		m_data(da.m_data)
+	{
+		da.m_fOwnsData = true;
+		da.m_iPoolClass = (-1);
+		da.m_sSize = 0;
+		da.m_data = NULL;
+	}
+
 	///	<summary>
 	///		Destructor.
 	///	</summary>
@@ -88,10 +110,15 @@ public:
 	}
 
 	///	<summary>
-	///		Allocate data in this DataArray1D.
+	///		Allocate data in this DataArray1D, aligned to DataArrayAlignment.
+	///		If fZero is false the data is left uninitialized, so that its
+	///		pages are first touched by the threads that fill it.  Pooled
+	///		storage should be requested only for short-lived arrays.
 	///	</summary>
 	void Allocate(
-		size_t sSize
+		size_t sSize,
+		bool fZero = true,
+		DataArrayStorage eStorage = DataArrayStorage_Heap
 	) {
 		if (!m_fOwnsData) {
 			_EXCEPTIONT("Attempting to Allocate() on attached DataArray1D");
@@ -107,14 +134,23 @@ public:
 		if ((m_data == NULL) || (m_sSize != sSize)) {
 			m_sSize = sSize;
 
-			m_data = reinterpret_cast<T *>(malloc(GetByteSize()));
+			m_data = reinterpret_cast<T *>(
+				DataArrayAllocate(GetByteSize(), eStorage, m_iPoolClass));
+		}
 
-			if (m_data == NULL) {
-				_EXCEPTION1("Failed malloc call (%lu bytes)", GetByteSize());
-			}
+		if (fZero) {
+			Zero();
 		}
+	}
 
-		Zero();
+	///	<summary>
+	///		Exchange the data of this DataArray1D with another.
+	///	</summary>
+	void Swap(DataArray1D<T> & da) {
+		std::swap(m_fOwnsData, da.m_fOwnsData);
+		std::swap(m_iPoolClass, da.m_iPoolClass);
+		std::swap(m_sSize, da.m_sSize);
+		std::swap(m_data, da.m_data);
 	}
 
 	///	<summary>
@@ -155,9 +191,10 @@ public:
 	///	</summary>
 	virtual void Detach() {
 		if ((m_fOwnsData) && (m_data != NULL)) {
-			delete[] m_data;
+			DataArrayFree(m_data, m_iPoolClass);
 		}
 		m_fOwnsData = true;
+		m_iPoolClass = (-1);
 		m_data = NULL;
 	}
 
@@ -204,14 +241,14 @@ public:
 				"to attached DataArray1D (undefined behavior)");
 		}
 
-		// Allocate if necessary
+		// Allocate if necessary; the data is overwritten below
 		if (!IsAttached()) {
-			Allocate(da.m_sSize);
+			Allocate(da.m_sSize, false);
 		}
 		if (IsAttached() && m_fOwnsData) {
 			if (m_sSize != da.m_sSize) {
 				Deallocate();
-				Allocate(da.m_sSize);
+				Allocate(da.m_sSize, false);
 			}
 		}
 
@@ -232,6 +269,25 @@ public:
 		return (*this);
 	}
 
+	///	<summary>
+	///		Move assignment operator.  The data of da is taken if this
+	///		array owns its data, and is otherwise copied.
+	///	</summary>
+	DataArray1D<T> & operator= (DataArray1D<T> && da) {
+		if (this == &da) {
+			return (*this);
+		}
+		if (IsAttached() && !m_fOwnsData) {
+			Assign(da);
+			return (*this);
+		}
+
+		Detach();
+		m_sSize = 0;
+		Swap(da);
+		return (*this);
+	}
+
 public:
 	///	<summary>
 	///		Zero the data content of this object.
@@ -331,6 +387,12 @@ private:
 	///	</summary>
 	bool m_fOwnsData;
 
+	///	<summary>
+	///		The pool size class of the data, or (-1) if it was allocated
+	///		from the heap.
+	///	</summary>
+	int m_iPoolClass;
+
 	///	<summary>
 	///		The number of rows in this DataArray1D.
 	///	</summary>
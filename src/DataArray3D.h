@@ -20,10 +20,12 @@
 ///////////////////////////////////////////////////////////////////////////////
 
 #include "Exception.h"
+#include "DataArrayAllocator.h"
 #include "Subscript.h"
 
 #include <cstdlib>
 #include <cstring>
+#include <utility>
 
 template <typename T>
 class DataArray3D {
@@ -36,6 +38,7 @@ public:
 	///	</summary>
 	DataArray3D() :
 		m_fOwnsData(true),
+		m_iPoolClass(-1),
 		m_data1D(NULL)
 	{
 		m_sSize[0] = 0;
@@ -50,9 +53,11 @@ public:
 		size_t sSize0,
 		size_t sSize1,
 		size_t sSize2,
-		bool fAllocate = true
+		bool fAllocate = true,
+		DataArrayStorage eStorage = DataArrayStorage_Heap
 	) :
 		m_fOwnsData(true),
+		m_iPoolClass(-1),
 		m_data1D(NULL)
 	{
 		m_sSize[0] = sSize0;
@@ -60,7 +65,7 @@ public:
 		m_sSize[2] = sSize2;
 
 		if (fAllocate) {
-			Allocate(sSize0, sSize1, sSize2);
+			Allocate(sSize0, sSize1, sSize2, true, eStorage);
 		}
 	}
 
@@ -69,6 +74,7 @@ public:
 	///	</summary>
 	DataArray3D(const DataArray3D<T> & da) :
 		m_fOwnsData(true),
+		m_iPoolClass(-1),
 		m_data1D(NULL)
 	{
 		if (da.IsAttached()) {
@@ -89,6 +95,27 @@ public:
 		}
 	}
 
+	///	<summary>
+	///		Move constructor, which takes the data of da and leaves it
+	///		empty.
+	///	</summary>
+	DataArray3D(DataArray3D<T> && da) noexcept :
+		m_fOwnsData(da.m_fOwnsData),
+		m_iPoolClass(da.m_iPoolClass),
+		m_data1D(da.m_data1D)
+	{
+		m_sSize[0] = da.m_sSize[0];
+		m_sSize[1] = da.m_sSize[1];
+		m_sSize[2] = da.m_sSize[2];
+
+		da.m_fOwnsData = true;
+		da.m_iPoolClass = (-1);
+		da.m_sSize[0] = 0;
+		da.m_sSize[1] = 0;
+		da.m_sSize[2] = 0;
+		da.m_data1D = NULL;
+	}
+
 	///	<summary>
 	///		Destructor.
 	///	</summary>
@@ -110,12 +137,16 @@ public:
 	}
 
 	///	<summary>
-	///		Allocate data in this DataArray3D.
+	///		Allocate data in this DataArray3D, aligned to DataArrayAlignment.
+	///		If fZero is false the data is left uninitialized.  Pooled
+	///		storage should be requested only for short-lived arrays.
 	///	</summary>
 	void Allocate(
 		size_t sSize0,
 		size_t sSize1,
-		size_t sSize2
+		size_t sSize2,
+		bool fZero = true,
+		DataArrayStorage eStorage = DataArrayStorage_Heap
 	) {
 		if (!m_fOwnsData) {
 			_EXCEPTIONT("Attempting to Allocate() on attached DataArray3D");
@@ -139,14 +170,13 @@ public:
 			m_sSize[1] = sSize1;
 			m_sSize[2] = sSize2;
 
-			m_data1D = reinterpret_cast<T *>(malloc(GetByteSize()));
-
-			if (m_data1D == NULL) {
-				_EXCEPTION1("Failed malloc call (%lu bytes)", GetByteSize());
-			}
+			m_data1D = reinterpret_cast<T *>(
+				DataArrayAllocate(GetByteSize(), eStorage, m_iPoolClass));
 		}
 
-		Zero();
+		if (fZero) {
+			Zero();
+		}
 	}
 
 	///	<summary>
@@ -191,9 +221,10 @@ public:
 	///	</summary>
 	virtual void Detach() {
 		if ((m_fOwnsData) && (m_data1D != NULL)) {
-			delete[] m_data1D;
+			DataArrayFree(m_data1D, m_iPoolClass);
 		}
 		m_fOwnsData = true;
+		m_iPoolClass = (-1);
 		m_data1D = NULL;
 	}
 
@@ -264,9 +295,9 @@ public:
 				"to attached DataArray3D (undefined behavior)");
 		}
 
-		// Allocate if necessary
+		// Allocate if necessary; the data is overwritten below
 		if (!IsAttached()) {
-			Allocate(da.m_sSize[0], da.m_sSize[1], da.m_sSize[2]);
+			Allocate(da.m_sSize[0], da.m_sSize[1], da.m_sSize[2], false);
 		}
 		if (IsAttached() && m_fOwnsData) {
 			if ((m_sSize[0] != da.m_sSize[0]) ||
@@ -277,7 +308,8 @@ public:
 				Allocate(
 					da.m_sSize[0],
 					da.m_sSize[1],
-					da.m_sSize[2]);
+					da.m_sSize[2],
+					false);
 			}
 		}
 
@@ -304,6 +336,33 @@ public:
 		return (*this);
 	}
 
+	///	<summary>
+	///		Move assignment operator.  The data of da is taken if this
+	///		array owns its data, and is otherwise copied.
+	///	</summary>
+	DataArray3D<T> & operator= (DataArray3D<T> && da) {
+		if (this == &da) {
+			return (*this);
+		}
+		if (IsAttached() && !m_fOwnsData) {
+			Assign(da);
+			return (*this);
+		}
+
+		Detach();
+		m_sSize[0] = 0;
+		m_sSize[1] = 0;
+		m_sSize[2] = 0;
+
+		std::swap(m_fOwnsData, da.m_fOwnsData);
+		std::swap(m_iPoolClass, da.m_iPoolClass);
+		std::swap(m_sSize[0], da.m_sSize[0]);
+		std::swap(m_sSize[1], da.m_sSize[1]);
+		std::swap(m_sSize[2], da.m_sSize[2]);
+		std::swap(m_data1D, da.m_data1D);
+		return (*this);
+	}
+
 public:
 	///	<summary>
 	///		Zero the data content of this object.
@@ -516,6 +575,12 @@ private:
 	///	</summary>
 	bool m_fOwnsData;
 
+	///	<summary>
+	///		The pool size class of the data, or (-1) if it was allocated
+	///		from the heap.
+	///	</summary>
+	int m_iPoolClass;
+
 	///	<summary>
 	///		The size of each dimension of this DataArray3D.
 	///	</summary>
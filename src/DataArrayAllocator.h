@@ -0,0 +1,259 @@
+///////////////////////////////////////////////////////////////////////////////
+///
+///	\file    DataArrayAllocator.h
+///	\author  agent
+///	\version October 14, 2026
+///
+///	<remarks>
+///		Copyright 2026 agent
+///
+///		This file is distributed as part of the Tempest source code package.
+///		Permission is granted to use, copy, modify and distribute this
+///		source code and its documentation under the terms of the GNU General
+///		Public License.  This software is provided "as is" without express
+///		or implied warranty.
+///	</remarks>
+
+#ifndef _DATAARRAYALLOCATOR_H_
+#define _DATAARRAYALLOCATOR_H_
+
+#include "Exception.h"
+
+#include <cstdlib>
+#include <vector>
+
+#if defined(WIN32) || defined(__WIN32__) || defined(_WIN32)
+#include <malloc.h>
+#endif
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Alignment of the storage of DataArray1D, DataArray2D and
+///		DataArray3D, in bytes.
+///	</summary>
+static const size_t DataArrayAlignment = 64;
+
+///	<summary>
+///		Size of the smallest block in the thread-local pool, in bytes.
+///		Blocks double in size from one size class to the next.
+///	</summary>
+static const size_t DataArrayPoolMinBlockSize = 64;
+
+///	<summary>
+///		Number of size classes in the thread-local pool (64 B to 1 MiB).
+///		Larger requests are always served from the heap.
+///	</summary>
+static const int DataArrayPoolSizeClasses = 15;
+
+///	<summary>
+///		Maximum number of free blocks retained in each size class of the
+///		thread-local pool.
+///	</summary>
+static const size_t DataArrayPoolMaxFreeBlocks = 32;
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Storage requested for a DataArray.  Pooled storage is intended for
+///		short-lived arrays allocated repeatedly in hot loops: blocks are
+///		rounded up to a power of two and returned to a pool belonging to
+///		the thread that releases them, to be reused by later allocations
+///		on that thread.
+///	</summary>
+enum DataArrayStorage {
+	DataArrayStorage_Heap = 0,
+	DataArrayStorage_Pooled = 1
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Allocate sBytes of storage aligned to DataArrayAlignment.
+///	</summary>
+inline void * DataArrayAlignedMalloc(
+	size_t sBytes
+) {
+	void * ptr = NULL;
+
+#if defined(WIN32) || defined(__WIN32__) || defined(_WIN32)
+	ptr = _aligned_malloc(sBytes, DataArrayAlignment);
+#else
+	if (posix_memalign(&ptr, DataArrayAlignment, sBytes) != 0) {
+		ptr = NULL;
+	}
+#endif
+
+	if (ptr == NULL) {
+		_EXCEPTION1("Failed aligned malloc call (%lu bytes)", sBytes);
+	}
+	return ptr;
+}
+
+///	<summary>
+///		Release storage allocated by DataArrayAlignedMalloc().
+///	</summary>
+inline void DataArrayAlignedFree(
+	void * ptr
+) {
+#if defined(WIN32) || defined(__WIN32__) || defined(_WIN32)
+	_aligned_free(ptr);
+#else
+	free(ptr);
+#endif
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		A thread-local pool of aligned blocks in power of two size classes.
+///	</summary>
+class DataArrayPool {
+
+public:
+	///	<summary>
+	///		Get the size class of a block of sBytes, or (-1) if the block
+	///		is too large to be pooled.
+	///	</summary>
+	static int GetSizeClass(
+		size_t sBytes
+	) {
+		size_t sBlockSize = DataArrayPoolMinBlockSize;
+		for (int c = 0; c < DataArrayPoolSizeClasses; c++) {
+			if (sBytes <= sBlockSize) {
+				return c;
+			}
+			sBlockSize *= 2;
+		}
+		return (-1);
+	}
+
+	///	<summary>
+	///		Get the size of blocks in size class iClass, in bytes.
+	///	</summary>
+	static size_t GetBlockSize(
+		int iClass
+	) {
+		return (DataArrayPoolMinBlockSize << iClass);
+	}
+
+	///	<summary>
+	///		Get the pool of the calling thread, or NULL if it has already
+	///		been destroyed at thread exit.
+	///	</summary>
+	static DataArrayPool * GetThreadPool() {
+		if (IsDestroyed()) {
+			return NULL;
+		}
+		static thread_local DataArrayPool s_pool;
+		return (&s_pool);
+	}
+
+public:
+	///	<summary>
+	///		Destructor, which releases all free blocks.
+	///	</summary>
+	~DataArrayPool() {
+		for (int c = 0; c < DataArrayPoolSizeClasses; c++) {
+			for (size_t i = 0; i < m_vecFreeBlocks[c].size(); i++) {
+				DataArrayAlignedFree(m_vecFreeBlocks[c][i]);
+			}
+		}
+		IsDestroyed() = true;
+	}
+
+	///	<summary>
+	///		Get a block of size class iClass.
+	///	</summary>
+	void * Allocate(
+		int iClass
+	) {
+		std::vector<void *> & vecFree = m_vecFreeBlocks[iClass];
+		if (vecFree.size() != 0) {
+			void * ptr = vecFree.back();
+			vecFree.pop_back();
+			return ptr;
+		}
+		return DataArrayAlignedMalloc(GetBlockSize(iClass));
+	}
+
+	///	<summary>
+	///		Return a block of size class iClass to the pool.
+	///	</summary>
+	void Free(
+		void * ptr,
+		int iClass
+	) {
+		std::vector<void *> & vecFree = m_vecFreeBlocks[iClass];
+		if (vecFree.size() >= DataArrayPoolMaxFreeBlocks) {
+			DataArrayAlignedFree(ptr);
+			return;
+		}
+		vecFree.push_back(ptr);
+	}
+
+protected:
+	///	<summary>
+	///		A flag indicating the pool of the calling thread has been
+	///		destroyed, so that arrays released later are freed directly.
+	///	</summary>
+	static bool & IsDestroyed() {
+		static thread_local bool s_fDestroyed = false;
+		return s_fDestroyed;
+	}
+
+protected:
+	///	<summary>
+	///		Free blocks in each size class.
+	///	</summary>
+	std::vector<void *> m_vecFreeBlocks[DataArrayPoolSizeClasses];
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Allocate aligned storage of sBytes for a DataArray.  On return
+///		iPoolClass holds the size class of a pooled block, or (-1) if the
+///		storage was allocated from the heap.
+///	</summary>
+inline void * DataArrayAllocate(
+	size_t sBytes,
+	DataArrayStorage eStorage,
+	int & iPoolClass
+) {
+	iPoolClass = (-1);
+
+	if (eStorage == DataArrayStorage_Pooled) {
+		const int iClass = DataArrayPool::GetSizeClass(sBytes);
+		DataArrayPool * pPool = DataArrayPool::GetThreadPool();
+		if ((iClass != (-1)) && (pPool != NULL)) {
+			iPoolClass = iClass;
+			return pPool->Allocate(iClass);
+		}
+	}
+
+	return DataArrayAlignedMalloc(sBytes);
+}
+
+///	<summary>
+///		Release storage allocated by DataArrayAllocate().
+///	</summary>
+inline void DataArrayFree(
+	void * ptr,
+	int iPoolClass
+) {
+	if (iPoolClass != (-1)) {
+		DataArrayPool * pPool = DataArrayPool::GetThreadPool();
+		if (pPool != NULL) {
+			pPool->Free(ptr, iPoolClass);
+			return;
+		}
+	}
+
+	DataArrayAlignedFree(ptr);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+#endif
+
@@ -45,9 +45,14 @@ static const Real ReferenceTolerance = 1.0e-12;
 // node_multimap_3d which is guaranteed to produce no coincident nodes (but
 // is the slowest).
 //
+// If OVERLAPMESH_USE_NODE_HASH is specified node removal will use the
+// node_hash_3d open-addressing spatial hash, which is guaranteed to produce
+// no coincident nodes and is the fastest.
+//
 //#define OVERLAPMESH_RETAIN_REPEATED_NODES
-#define OVERLAPMESH_USE_UNSORTED_MAP
+//#define OVERLAPMESH_USE_UNSORTED_MAP
 //#define OVERLAPMESH_USE_NODE_MULTIMAP
+#define OVERLAPMESH_USE_NODE_HASH
 
 ///////////////////////////////////////////////////////////////////////////////
 //
@@ -56,6 +61,51 @@ static const Real ReferenceTolerance = 1.0e-12;
 //
 #define OVERLAPMESH_BIN_WIDTH 1.0e-1
 
+///////////////////////////////////////////////////////////////////////////////
+//
+// This define specifies the cell width for the node_hash_3d.  Cells should be
+// much wider than ReferenceTolerance and narrower than the spacing between
+// distinct overlap nodes.
+//
+#define OVERLAPMESH_HASH_CELL_WIDTH 1.0e-6
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// This define specifies the cell width of the spatial hash used to detect
+// coincident nodes when reading and generating meshes.
+//
+#define MESH_NODE_HASH_CELL_WIDTH 1.0e-6
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// If EDGEMAP_USE_UNSORTED_MAP is specified the EdgeMap of each Mesh will be
+// an std::unordered_map() keyed on the unordered pair of node indices, rather
+// than an std::map().  Iteration order over the EdgeMap is then unspecified.
+//
+#define EDGEMAP_USE_UNSORTED_MAP
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// If OVERLAPMESH_USE_STRUCTURED is specified GenerateOverlapMesh_v2 detects
+// pairs of nested equiangular cubed sphere meshes and compatible latitude-
+// longitude meshes and generates their overlap mesh in closed form (see
+// StructuredOverlapMesh.h).
+//
+#define OVERLAPMESH_USE_STRUCTURED
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// If OVERLAPMESH_INSTRUMENT is specified GenerateOverlapMesh_v2 records, for
+// each source face, the number of target faces visited, the number of edge
+// intersections computed, the number of target faces searched to find the
+// first overlap, NodeMap hits and misses and the time taken, and reports
+// totals, histograms and the slowest source faces.  If the environment
+// variable TEMPESTREMAP_OVERLAP_PROFILE names a file the per-face records
+// are also written to it as CSV.  When not specified the instrumentation is
+// compiled out.
+//
+//#define OVERLAPMESH_INSTRUMENT
+
 ///////////////////////////////////////////////////////////////////////////////
 //
 // This define specifies that exact arithmetic should be used in the overlap
@@ -63,6 +113,15 @@ static const Real ReferenceTolerance = 1.0e-12;
 //
 #define USE_EXACT_ARITHMETIC
 
+///////////////////////////////////////////////////////////////////////////////
+//
+// If USE_EXACT_ARITHMETIC_FILTER is specified the sign of exact expressions
+// is first determined in floating point arithmetic with a bound on the
+// rounding error, and exact arithmetic is only used when this bound does not
+// determine the sign.
+//
+#define USE_EXACT_ARITHMETIC_FILTER
+
 ///////////////////////////////////////////////////////////////////////////////
 //
 // Defines required by Triangle package
@@ -0,0 +1,207 @@
+///////////////////////////////////////////////////////////////////////////////
+///
+///	\file    DenseMatrixProduct.cpp
+///	\author  agent
+///	\version October 14, 2026
+///
+///	<remarks>
+///		Copyright 2026 agent
+///
+///		This file is distributed as part of the Tempest source code package.
+///		Permission is granted to use, copy, modify and distribute this
+///		source code and its documentation under the terms of the GNU General
+///		Public License.  This software is provided "as is" without express
+///		or implied warranty.
+///	</remarks>
+
+#include "DenseMatrixProduct.h"
+#include "Exception.h"
+
+///////////////////////////////////////////////////////////////////////////////
+
+#if defined(TEMPEST_LAPACK_USE_GEMM)
+extern "C" {
+	///	General matrix matrix multiply
+	int dgemm_(
+		char * transa,
+		char * transb,
+		int * m,
+		int * n,
+		int * k,
+		double * alpha,
+		double * a,
+		int * lda,
+		double * b,
+		int * ldb,
+		double * beta,
+		double * c,
+		int * ldc);
+};
+#endif
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Compute C += A * B with the inner dimension fixed at compile time,
+///		so that the sum over k is fully unrolled.
+///	</summary>
+template <int K>
+static void DenseMatrixProductAddFixed(
+	int m,
+	int n,
+	const double * dA,
+	int lda,
+	const double * dB,
+	int ldb,
+	double * dC,
+	int ldc
+) {
+	for (int i = 0; i < m; i++) {
+		const double * dAi = dA + i * lda;
+		double * dCi = dC + i * ldc;
+
+		for (int j = 0; j < n; j++) {
+			double dSum = dCi[j];
+			for (int k = 0; k < K; k++) {
+				dSum += dAi[k] * dB[k * ldb + j];
+			}
+			dCi[j] = dSum;
+		}
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Compute C += A * B for any inner dimension, with the innermost loop
+///		running along the rows of B and C.
+///	</summary>
+static void DenseMatrixProductAddGeneral(
+	int m,
+	int n,
+	int k,
+	const double * dA,
+	int lda,
+	const double * dB,
+	int ldb,
+	double * dC,
+	int ldc
+) {
+	for (int i = 0; i < m; i++) {
+		const double * dAi = dA + i * lda;
+		double * dCi = dC + i * ldc;
+
+		for (int l = 0; l < k; l++) {
+			const double dAil = dAi[l];
+			const double * dBl = dB + l * ldb;
+
+			for (int j = 0; j < n; j++) {
+				dCi[j] += dAil * dBl[j];
+			}
+		}
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void DenseMatrixProductAdd(
+	int m,
+	int n,
+	int k,
+	const double * dA,
+	int lda,
+	const double * dB,
+	int ldb,
+	double * dC,
+	int ldc
+) {
+	if ((m < 0) || (n < 0) || (k < 0)) {
+		_EXCEPTION3("Invalid matrix product dimensions (%i, %i, %i)", m, n, k);
+	}
+	if ((m == 0) || (n == 0) || (k == 0)) {
+		return;
+	}
+
+#if defined(TEMPEST_LAPACK_USE_GEMM)
+	// The row-major product C = A * B is the column-major product
+	// C^T = B^T * A^T, so dgemm is called with the operands exchanged
+	if (static_cast<double>(m) * static_cast<double>(n)
+	        * static_cast<double>(k) >= DenseMatrixProductGEMMMinSize
+	) {
+		char trans = 'n';
+		double dOne = 1.0;
+
+		dgemm_(
+			&trans,
+			&trans,
+			&n,
+			&m,
+			&k,
+			&dOne,
+			const_cast<double *>(dB),
+			&ldb,
+			const_cast<double *>(dA),
+			&lda,
+			&dOne,
+			dC,
+			&ldc);
+
+		return;
+	}
+#endif
+
+	switch (k) {
+		case 1:
+			DenseMatrixProductAddFixed<1>(m, n, dA, lda, dB, ldb, dC, ldc);
+			break;
+		case 4:
+			DenseMatrixProductAddFixed<4>(m, n, dA, lda, dB, ldb, dC, ldc);
+			break;
+		case 9:
+			DenseMatrixProductAddFixed<9>(m, n, dA, lda, dB, ldb, dC, ldc);
+			break;
+		case 16:
+			DenseMatrixProductAddFixed<16>(m, n, dA, lda, dB, ldb, dC, ldc);
+			break;
+		default:
+			DenseMatrixProductAddGeneral(m, n, k, dA, lda, dB, ldb, dC, ldc);
+			break;
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void DenseMatrixProductAdd(
+	const DataArray2D<double> & dA,
+	const DataArray2D<double> & dB,
+	DataArray2D<double> & dC
+) {
+	if ((dA.GetColumns() != dB.GetRows()) ||
+	    (dC.GetRows() != dA.GetRows()) ||
+	    (dC.GetColumns() != dB.GetColumns())
+	) {
+		_EXCEPTION6("Incompatible matrix product dimensions "
+			"(%lu x %lu) * (%lu x %lu) -> (%lu x %lu)",
+			dA.GetRows(), dA.GetColumns(),
+			dB.GetRows(), dB.GetColumns(),
+			dC.GetRows(), dC.GetColumns());
+	}
+
+	if (dC.GetTotalSize() == 0) {
+		return;
+	}
+
+	DenseMatrixProductAdd(
+		static_cast<int>(dA.GetRows()),
+		static_cast<int>(dB.GetColumns()),
+		static_cast<int>(dA.GetColumns()),
+		(dA.GetTotalSize() == 0)?(NULL):(&(dA(0,0))),
+		static_cast<int>(dA.GetColumns()),
+		(dB.GetTotalSize() == 0)?(NULL):(&(dB(0,0))),
+		static_cast<int>(dB.GetColumns()),
+		&(dC(0,0)),
+		static_cast<int>(dC.GetColumns()));
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
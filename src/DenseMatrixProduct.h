@@ -0,0 +1,75 @@
+///////////////////////////////////////////////////////////////////////////////
+///
+///	\file    DenseMatrixProduct.h
+///	\author  agent
+///	\version October 14, 2026
+///
+///	<remarks>
+///		Copyright 2026 agent
+///
+///		This file is distributed as part of the Tempest source code package.
+///		Permission is granted to use, copy, modify and distribute this
+///		source code and its documentation under the terms of the GNU General
+///		Public License.  This software is provided "as is" without express
+///		or implied warranty.
+///	</remarks>
+
+#ifndef _DENSEMATRIXPRODUCT_H_
+#define _DENSEMATRIXPRODUCT_H_
+
+#include "DataArray2D.h"
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Minimum number of multiply-adds (m * n * k) for which a product is
+///		dispatched to dgemm when built with TEMPEST_LAPACK_USE_GEMM.
+///		Smaller products are computed by the built-in kernels, which avoid
+///		the call overhead of the BLAS.
+///	</summary>
+static const int DenseMatrixProductGEMMMinSize = 4096;
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Compute C += A * B, where A is an m x k matrix with row stride lda,
+///		B is a k x n matrix with row stride ldb and C is an m x n matrix
+///		with row stride ldc, all stored in row-major order.
+///
+///		Products with k of 1, 4, 9 or 16 (the number of coefficients of
+///		the finite volume reconstructions) use kernels unrolled over k, and
+///		other products use a kernel vectorized over the columns of C.  Both
+///		accumulate each entry of C in order of increasing k, so results are
+///		identical to the naive triple loop.  When built with
+///		TEMPEST_LAPACK_USE_GEMM, products of at least
+///		DenseMatrixProductGEMMMinSize multiply-adds are instead computed by
+///		dgemm, whose results may differ in the last bits.
+///	</summary>
+void DenseMatrixProductAdd(
+	int m,
+	int n,
+	int k,
+	const double * dA,
+	int lda,
+	const double * dB,
+	int ldb,
+	double * dC,
+	int ldc
+);
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Compute C += A * B for DataArray2D operands.  C must already be
+///		allocated with the rows of A and the columns of B.
+///	</summary>
+void DenseMatrixProductAdd(
+	const DataArray2D<double> & dA,
+	const DataArray2D<double> & dB,
+	DataArray2D<double> & dC
+);
+
+///////////////////////////////////////////////////////////////////////////////
+
+#endif
+
@@ -0,0 +1,324 @@
+///////////////////////////////////////////////////////////////////////////////
+///
+///	\file    FaceLocator.cpp
+///	\author  agent
+///	\version October 14, 2026
+///
+///	<remarks>
+///		Copyright 2026 agent
+///
+///		This file is distributed as part of the Tempest source code package.
+///		Permission is granted to use, copy, modify and distribute this
+///		source code and its documentation under the terms of the GNU General
+///		Public License.  This software is provided "as is" without express
+///		or implied warranty.
+///	</remarks>
+
+#include "FaceLocator.h"
+
+#include "Exception.h"
+
+#include <algorithm>
+#include <cmath>
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Relative padding applied to the radius of each bounding cap, to
+///		account for the curvature of edges between sampled points.
+///	</summary>
+static const Real FaceCapRadiusPadding = 0.05;
+
+///	<summary>
+///		Chordal radius of a cap covering the entire unit sphere.
+///	</summary>
+static const Real FullSphereChordRadius = 2.0;
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Comparator which orders Face indices by one coordinate of the
+///		center of their bounding cap.
+///	</summary>
+class FaceCapCenterComparator {
+
+public:
+	FaceCapCenterComparator(
+		const NodeVector & vecCapCenter,
+		int iAxis
+	) :
+		m_vecCapCenter(vecCapCenter),
+		m_iAxis(iAxis)
+	{ }
+
+	bool operator()(int ixA, int ixB) const {
+		const Node & nodeA = m_vecCapCenter[ixA];
+		const Node & nodeB = m_vecCapCenter[ixB];
+
+		if (m_iAxis == 0) {
+			return (nodeA.x < nodeB.x);
+		} else if (m_iAxis == 1) {
+			return (nodeA.y < nodeB.y);
+		}
+		return (nodeA.z < nodeB.z);
+	}
+
+protected:
+	const NodeVector & m_vecCapCenter;
+
+	int m_iAxis;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+void FaceLocator::CalculateFaceCap(
+	const Face & face,
+	const NodeVector & nodes,
+	Node & nodeCenter,
+	Real & dRadius
+) {
+	const int nEdges = static_cast<int>(face.edges.size());
+
+	if (nEdges == 0) {
+		_EXCEPTIONT("Face with no edges cannot be indexed");
+	}
+
+	// Sample each corner and the midpoint of each edge
+	NodeVector vecSamples;
+	vecSamples.reserve(2 * nEdges);
+
+	for (int i = 0; i < nEdges; i++) {
+		const Edge & edge = face.edges[i];
+
+		const Node & node0 = nodes[edge[0]];
+		const Node & node1 = nodes[edge[1]];
+
+		vecSamples.push_back(node0);
+
+		if (edge.type == Edge::Type_ConstantLatitude) {
+			Real dHorizMag = sqrt(1.0 - node0.z * node0.z);
+
+			Node nodeMid(
+				0.5 * (node0.x + node1.x),
+				0.5 * (node0.y + node1.y),
+				0.0);
+
+			Real dMidMag = sqrt(nodeMid.x * nodeMid.x + nodeMid.y * nodeMid.y);
+			if (dMidMag > ReferenceTolerance) {
+				nodeMid.x *= dHorizMag / dMidMag;
+				nodeMid.y *= dHorizMag / dMidMag;
+			}
+			nodeMid.z = node0.z;
+
+			vecSamples.push_back(nodeMid);
+
+		} else {
+			Node nodeMid = node0 + node1;
+
+			if (nodeMid.Magnitude() > ReferenceTolerance) {
+				vecSamples.push_back(nodeMid.Normalized());
+			}
+		}
+	}
+
+	// Center of the cap
+	Node nodeSum;
+	for (int i = 0; i < vecSamples.size(); i++) {
+		nodeSum = nodeSum + vecSamples[i];
+	}
+
+	Real dSumMag = nodeSum.Magnitude();
+	if (dSumMag < ReferenceTolerance) {
+		nodeCenter = Node(0.0, 0.0, 1.0);
+		dRadius = FullSphereChordRadius;
+		return;
+	}
+	nodeCenter = nodeSum / dSumMag;
+
+	// Chordal radius of the cap
+	dRadius = 0.0;
+	for (int i = 0; i < vecSamples.size(); i++) {
+		Real dDist = (vecSamples[i] - nodeCenter).Magnitude();
+		if (dDist > dRadius) {
+			dRadius = dDist;
+		}
+	}
+
+	dRadius = dRadius * (1.0 + FaceCapRadiusPadding) + ReferenceTolerance;
+
+	// Caps larger than a hemisphere are not convex; cover the sphere
+	if (dRadius >= sqrt(2.0)) {
+		dRadius = FullSphereChordRadius;
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+int FaceLocator::BuildTree(
+	int ixBegin,
+	int ixEnd
+) {
+	int ixNode = static_cast<int>(m_vecTree.size());
+	m_vecTree.push_back(TreeNode());
+
+	// Bounding sphere of all caps in this range
+	Node nodeCenter;
+	Node nodeMin = m_vecCapCenter[m_vecFaceIx[ixBegin]];
+	Node nodeMax = nodeMin;
+
+	for (int i = ixBegin; i < ixEnd; i++) {
+		const Node & nodeCap = m_vecCapCenter[m_vecFaceIx[i]];
+
+		nodeCenter = nodeCenter + nodeCap;
+
+		nodeMin.x = std::min(nodeMin.x, nodeCap.x);
+		nodeMin.y = std::min(nodeMin.y, nodeCap.y);
+		nodeMin.z = std::min(nodeMin.z, nodeCap.z);
+		nodeMax.x = std::max(nodeMax.x, nodeCap.x);
+		nodeMax.y = std::max(nodeMax.y, nodeCap.y);
+		nodeMax.z = std::max(nodeMax.z, nodeCap.z);
+	}
+	nodeCenter = nodeCenter / static_cast<Real>(ixEnd - ixBegin);
+
+	Real dRadius = 0.0;
+	for (int i = ixBegin; i < ixEnd; i++) {
+		int ixFace = m_vecFaceIx[i];
+
+		Real dExtent =
+			(m_vecCapCenter[ixFace] - nodeCenter).Magnitude()
+			+ m_vecCapRadius[ixFace];
+
+		if (dExtent > dRadius) {
+			dRadius = dExtent;
+		}
+	}
+
+	TreeNode & node = m_vecTree[ixNode];
+	node.nodeCenter = nodeCenter;
+	node.dRadius = dRadius;
+	node.ixBegin = ixBegin;
+	node.ixEnd = ixEnd;
+	node.ixLeft = (-1);
+	node.ixRight = (-1);
+
+	if (ixEnd - ixBegin <= LeafSize) {
+		return ixNode;
+	}
+
+	// Split at the median along the axis of largest extent
+	Node nodeExtent = nodeMax - nodeMin;
+
+	int iAxis = 0;
+	if ((nodeExtent.y >= nodeExtent.x) && (nodeExtent.y >= nodeExtent.z)) {
+		iAxis = 1;
+	} else if ((nodeExtent.z >= nodeExtent.x) && (nodeExtent.z >= nodeExtent.y)) {
+		iAxis = 2;
+	}
+
+	int ixMid = ixBegin + (ixEnd - ixBegin) / 2;
+
+	std::nth_element(
+		m_vecFaceIx.begin() + ixBegin,
+		m_vecFaceIx.begin() + ixMid,
+		m_vecFaceIx.begin() + ixEnd,
+		FaceCapCenterComparator(m_vecCapCenter, iAxis));
+
+	// m_vecTree may be reallocated by the recursive calls
+	int ixLeft = BuildTree(ixBegin, ixMid);
+	int ixRight = BuildTree(ixMid, ixEnd);
+
+	m_vecTree[ixNode].ixLeft = ixLeft;
+	m_vecTree[ixNode].ixRight = ixRight;
+
+	return ixNode;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void FaceLocator::Build(
+	const Mesh & mesh
+) {
+	Clear();
+
+	m_nFaces = static_cast<int>(mesh.faces.size());
+
+	if (m_nFaces == 0) {
+		return;
+	}
+
+	m_vecCapCenter.resize(m_nFaces);
+	m_vecCapRadius.resize(m_nFaces);
+	m_vecFaceIx.resize(m_nFaces);
+
+	for (int i = 0; i < m_nFaces; i++) {
+		CalculateFaceCap(
+			mesh.faces[i],
+			mesh.nodes,
+			m_vecCapCenter[i],
+			m_vecCapRadius[i]);
+
+		m_vecFaceIx[i] = i;
+	}
+
+	m_vecTree.reserve(2 * (m_nFaces / LeafSize + 1));
+
+	BuildTree(0, m_nFaces);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void FaceLocator::Clear() {
+	m_nFaces = 0;
+	m_vecCapCenter.clear();
+	m_vecCapRadius.clear();
+	m_vecFaceIx.clear();
+	m_vecTree.clear();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void FaceLocator::FindCandidateFaces(
+	const Node & node,
+	std::vector<int> & vecFaceIndices
+) const {
+	vecFaceIndices.clear();
+
+	if (m_vecTree.size() == 0) {
+		return;
+	}
+
+	// Depth-first traversal of the hierarchy
+	std::vector<int> vecStack;
+	vecStack.reserve(64);
+	vecStack.push_back(0);
+
+	while (vecStack.size() != 0) {
+		const TreeNode & nodeTree = m_vecTree[vecStack.back()];
+		vecStack.pop_back();
+
+		Real dDist = (node - nodeTree.nodeCenter).Magnitude();
+		if (dDist > nodeTree.dRadius + ReferenceTolerance) {
+			continue;
+		}
+
+		if (nodeTree.ixLeft != (-1)) {
+			vecStack.push_back(nodeTree.ixRight);
+			vecStack.push_back(nodeTree.ixLeft);
+			continue;
+		}
+
+		for (int i = nodeTree.ixBegin; i < nodeTree.ixEnd; i++) {
+			int ixFace = m_vecFaceIx[i];
+
+			Real dFaceDist = (node - m_vecCapCenter[ixFace]).Magnitude();
+			if (dFaceDist <= m_vecCapRadius[ixFace] + ReferenceTolerance) {
+				vecFaceIndices.push_back(ixFace);
+			}
+		}
+	}
+
+	std::sort(vecFaceIndices.begin(), vecFaceIndices.end());
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
@@ -0,0 +1,154 @@
+///////////////////////////////////////////////////////////////////////////////
+///
+///	\file    FaceLocator.h
+///	\author  agent
+///	\version October 14, 2026
+///
+///	<remarks>
+///		Copyright 2026 agent
+///
+///		This file is distributed as part of the Tempest source code package.
+///		Permission is granted to use, copy, modify and distribute this
+///		source code and its documentation under the terms of the GNU General
+///		Public License.  This software is provided "as is" without express
+///		or implied warranty.
+///	</remarks>
+
+#ifndef _FACELOCATOR_H_
+#define _FACELOCATOR_H_
+
+#include "GridElements.h"
+
+#include <vector>
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		A spatial index over the Faces of a Mesh, used to find the Faces
+///		that may contain a given Node on the unit sphere.  Each Face is
+///		bounded by a spherical cap (stored as a center on the sphere and a
+///		chordal radius) and the caps are organized in a bounding sphere
+///		hierarchy built by median splits.
+///	</summary>
+class FaceLocator {
+
+public:
+	///	<summary>
+	///		Maximum number of Faces stored in a leaf of the hierarchy.
+	///	</summary>
+	static const int LeafSize = 8;
+
+public:
+	///	<summary>
+	///		Default constructor.
+	///	</summary>
+	FaceLocator() :
+		m_nFaces(0)
+	{ }
+
+	///	<summary>
+	///		Constructor that builds the index over the given Mesh.
+	///	</summary>
+	FaceLocator(
+		const Mesh & mesh
+	) :
+		m_nFaces(0)
+	{
+		Build(mesh);
+	}
+
+public:
+	///	<summary>
+	///		Build the index over the Faces of the given Mesh.  The index
+	///		must be rebuilt if the Mesh is subsequently modified.
+	///	</summary>
+	void Build(
+		const Mesh & mesh
+	);
+
+	///	<summary>
+	///		Clear the contents of the index.
+	///	</summary>
+	void Clear();
+
+	///	<summary>
+	///		Get the number of Faces in the index.
+	///	</summary>
+	int GetFaceCount() const {
+		return m_nFaces;
+	}
+
+	///	<summary>
+	///		Find the indices of all Faces whose bounding cap contains the
+	///		given Node.  Indices are returned in ascending order.
+	///	</summary>
+	void FindCandidateFaces(
+		const Node & node,
+		std::vector<int> & vecFaceIndices
+	) const;
+
+protected:
+	///	<summary>
+	///		Compute the bounding cap of the given Face.
+	///	</summary>
+	static void CalculateFaceCap(
+		const Face & face,
+		const NodeVector & nodes,
+		Node & nodeCenter,
+		Real & dRadius
+	);
+
+	///	<summary>
+	///		Recursively build the hierarchy over m_vecFaceIx[ixBegin, ixEnd)
+	///		and return the index of the new tree node.
+	///	</summary>
+	int BuildTree(
+		int ixBegin,
+		int ixEnd
+	);
+
+protected:
+	///	<summary>
+	///		A node of the bounding sphere hierarchy.  Leaves have ixLeft
+	///		equal to -1 and reference m_vecFaceIx[ixBegin, ixEnd).
+	///	</summary>
+	struct TreeNode {
+		Node nodeCenter;
+		Real dRadius;
+		int ixBegin;
+		int ixEnd;
+		int ixLeft;
+		int ixRight;
+	};
+
+	///	<summary>
+	///		Number of Faces in the index.
+	///	</summary>
+	int m_nFaces;
+
+	///	<summary>
+	///		Center of the bounding cap of each Face.
+	///	</summary>
+	NodeVector m_vecCapCenter;
+
+	///	<summary>
+	///		Chordal radius of the bounding cap of each Face.
+	///	</summary>
+	std::vector<Real> m_vecCapRadius;
+
+	///	<summary>
+	///		Face indices, permuted so that each tree node references a
+	///		contiguous range.
+	///	</summary>
+	std::vector<int> m_vecFaceIx;
+
+	///	<summary>
+	///		Nodes of the hierarchy; the root is the first entry.
+	///	</summary>
+	std::vector<TreeNode> m_vecTree;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+#endif
+
@@ -15,11 +15,18 @@
 ///	</remarks>
 
 #include "FiniteElementTools.h"
-#include "PolynomialInterp.h"
+#include "LagrangeBasisTable.h"
 #include "GridElements.h"
 #include "GaussLobattoQuadrature.h"
+#include "Announce.h"
+#include "Exception.h"
+#include "OmpExceptionCapture.h"
 
-#include <map>
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
 
 ///////////////////////////////////////////////////////////////////////////////
 
@@ -152,9 +159,160 @@ void ApplyLocalMap(
 
 ///////////////////////////////////////////////////////////////////////////////
 
-void ApplyInverseMap(
+///	<summary>
+///		Get the Cartesian component of a Node with the given index.
+///	</summary>
+static double NodeComponent(
+	const Node & node,
+	int iComponent
+) {
+	if (iComponent == 0) {
+		return node.x;
+	} else if (iComponent == 1) {
+		return node.y;
+	}
+	return node.z;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Choose the Cartesian component of largest magnitude of the first
+///		corner of a Face, whose tangent plane is used to invert the map.
+///	</summary>
+static int GetInverseMapTangentPlane(
+	const Node & nodeRef
+) {
+	if ((fabs(nodeRef.x) >= fabs(nodeRef.y)) &&
+		(fabs(nodeRef.x) >= fabs(nodeRef.z))
+	) {
+		return 0;
+
+	} else if (
+		(fabs(nodeRef.y) >= fabs(nodeRef.x)) &&
+		(fabs(nodeRef.y) >= fabs(nodeRef.z))
+	) {
+		return 1;
+	}
+	return 2;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Invert the local map in closed form.  The map sends (alpha, beta) to
+///		the bilinear interpolant X of the corners, normalized to the unit
+///		sphere, so node is its image exactly when X is parallel to node.
+///		Eliminating the component iTangentPlane this is the inverse of a
+///		planar bilinear map, whose solution is a root of a quadratic.
+///		Returns false if no suitable root exists.
+///	</summary>
+static bool ApplyInverseMapAnalytic(
+	const Node nodeCorner[4],
+	int iTangentPlane,
+	const Node & node,
+	double & dAlpha,
+	double & dBeta
+) {
+	const int i1 = (iTangentPlane == 0)?(1):(0);
+	const int i2 = (iTangentPlane == 2)?(1):(2);
+
+	const double dPm = NodeComponent(node, iTangentPlane);
+	const double dP1 = NodeComponent(node, i1);
+	const double dP2 = NodeComponent(node, i2);
+
+	// Components of the cross product of each corner with node
+	double dQ[4][2];
+	for (int k = 0; k < 4; k++) {
+		const double dXm = NodeComponent(nodeCorner[k], iTangentPlane);
+		dQ[k][0] = NodeComponent(nodeCorner[k], i1) * dPm - dXm * dP1;
+		dQ[k][1] = NodeComponent(nodeCorner[k], i2) * dPm - dXm * dP2;
+	}
+
+	// Solve Q0 + alpha E + beta F + alpha beta G = 0
+	const double dE[2] = {dQ[1][0] - dQ[0][0], dQ[1][1] - dQ[0][1]};
+	const double dF[2] = {dQ[3][0] - dQ[0][0], dQ[3][1] - dQ[0][1]};
+	const double dG[2] = {
+		dQ[0][0] - dQ[1][0] + dQ[2][0] - dQ[3][0],
+		dQ[0][1] - dQ[1][1] + dQ[2][1] - dQ[3][1]};
+
+	const double dK2 = dF[0] * dG[1] - dF[1] * dG[0];
+	const double dK1 =
+		  (dQ[0][0] * dG[1] - dQ[0][1] * dG[0])
+		+ (dF[0] * dE[1] - dF[1] * dE[0]);
+	const double dK0 = dQ[0][0] * dE[1] - dQ[0][1] * dE[0];
+
+	if (fabs(dK2) <= 1.0e-12 * fabs(dK1)) {
+		if (dK1 == 0.0) {
+			return false;
+		}
+		dBeta = - dK0 / dK1;
+
+	} else {
+		const double dDisc = dK1 * dK1 - 4.0 * dK2 * dK0;
+		if (dDisc < 0.0) {
+			return false;
+		}
+
+		// Numerically stable roots, choosing the one nearest the element
+		const double dQuad =
+			-0.5 * (dK1 + ((dK1 >= 0.0)?(sqrt(dDisc)):(-sqrt(dDisc))));
+
+		const double dRoot0 = dQuad / dK2;
+		if (dQuad == 0.0) {
+			dBeta = dRoot0;
+		} else {
+			const double dRoot1 = dK0 / dQuad;
+			if (fabs(dRoot0 - 0.5) <= fabs(dRoot1 - 0.5)) {
+				dBeta = dRoot0;
+			} else {
+				dBeta = dRoot1;
+			}
+		}
+	}
+
+	// Recover alpha from the better conditioned equation
+	const double dDenom0 = dE[0] + dBeta * dG[0];
+	const double dDenom1 = dE[1] + dBeta * dG[1];
+
+	if (fabs(dDenom0) >= fabs(dDenom1)) {
+		if (dDenom0 == 0.0) {
+			return false;
+		}
+		dAlpha = - (dQ[0][0] + dBeta * dF[0]) / dDenom0;
+	} else {
+		dAlpha = - (dQ[0][1] + dBeta * dF[1]) / dDenom1;
+	}
+
+	// The interpolant must lie in the same hemisphere as node
+	double dDot = 0.0;
+	for (int k = 0; k < 4; k++) {
+		double dW;
+		if (k == 0) {
+			dW = (1.0 - dAlpha) * (1.0 - dBeta);
+		} else if (k == 1) {
+			dW = dAlpha * (1.0 - dBeta);
+		} else if (k == 2) {
+			dW = dAlpha * dBeta;
+		} else {
+			dW = (1.0 - dAlpha) * dBeta;
+		}
+		dDot += dW * DotProduct(nodeCorner[k], node);
+	}
+
+	return (dDot > 0.0);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Refine a solution of the inverse map by Newton's method, stopping
+///		once the update is below InverseMapTolerance.
+///	</summary>
+static void ApplyInverseMapNewton(
 	const Face & face,
 	const NodeVector & nodes,
+	int iTangentPlane,
 	const Node & node,
 	double & dAlpha,
 	double & dBeta
@@ -164,43 +322,13 @@ void ApplyInverseMap(
 	Node nodeDx1G;
 	Node nodeDx2G;
 
-	// First guess
-	dAlpha = 0.5;
-	dBeta = 0.5;
-
 	// Map matrix
 	double dMap[2][2];
 
 	double dF[2];
 
-	// Fix the Cartesian components to use in iteration
-	int iTangentPlane = 0;
-	{
-		const Node & nodeRef = nodes[face[0]];
-		if ((fabs(nodeRef.x) >= fabs(nodeRef.y)) &&
-			(fabs(nodeRef.x) >= fabs(nodeRef.z))
-		) {
-			iTangentPlane = 0;
-
-		} else if (
-			(fabs(nodeRef.y) >= fabs(nodeRef.x)) &&
-			(fabs(nodeRef.y) >= fabs(nodeRef.z))
-		) {
-			iTangentPlane = 1;
-
-		} else {
-			iTangentPlane = 2;
-		}
-	}
-
 	// Apply 10 loops of Newton's method to converge
 	for (int i = 0; i < 10; i++) {
-/*
-		nodes[face[0]].Print("f0");
-		nodes[face[1]].Print("f1");
-		nodes[face[2]].Print("f2");
-		nodes[face[3]].Print("f3");
-*/
 		// Apply forward map
 		ApplyLocalMap(
 			face, nodes,
@@ -208,8 +336,6 @@ void ApplyInverseMap(
 			nodeG, nodeDx1G, nodeDx2G);
 
 		// Pick the two Cartesian components with greatest chance of success
-		const Node & nodeRef = nodes[face[0]];
-
 		if (iTangentPlane == 0) {
 			dMap[0][0] = nodeDx1G.y;
 			dMap[0][1] = nodeDx2G.y;
@@ -264,234 +390,595 @@ void ApplyInverseMap(
 
 ///////////////////////////////////////////////////////////////////////////////
 
+void ApplyInverseMap(
+	const Face & face,
+	const NodeVector & nodes,
+	const Node & node,
+	double & dAlpha,
+	double & dBeta
+) {
+	ApplyInverseMap(face, nodes, 1, &node, &dAlpha, &dBeta);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void ApplyInverseMap(
+	const Face & face,
+	const NodeVector & nodes,
+	int nPoints,
+	const Node * pNodes,
+	double * dAlpha,
+	double * dBeta
+) {
+	// Quantities of the Face shared by all points
+	const Node nodeCorner[4] = {
+		nodes[face[0]], nodes[face[1]], nodes[face[2]], nodes[face[3]]};
+
+	const int iTangentPlane = GetInverseMapTangentPlane(nodeCorner[0]);
+
+	for (int k = 0; k < nPoints; k++) {
+
+		// Closed form initial guess, falling back to the element center
+		if (!ApplyInverseMapAnalytic(
+				nodeCorner, iTangentPlane, pNodes[k], dAlpha[k], dBeta[k])
+		) {
+			dAlpha[k] = 0.5;
+			dBeta[k] = 0.5;
+		}
+
+		ApplyInverseMapNewton(
+			face, nodes, iTangentPlane, pNodes[k], dAlpha[k], dBeta[k]);
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Number the GLL nodes of a conforming quadrilateral mesh from its
+///		topology.  GLL nodes at element corners are identified by mesh node,
+///		GLL nodes on element edges by the mesh edge and their position along
+///		it, and interior GLL nodes are unique to each element.  Nodes are
+///		numbered (starting at 1) in order of first appearance over faces,
+///		then GLL indices j and i, which is the numbering obtained by
+///		comparing GLL node coordinates.  Returns the number of unique nodes.
+///	</summary>
+static int GenerateGLLNodeNumbering(
+	const Mesh & mesh,
+	int nP,
+	DataArray3D<int> & dataGLLnodes
+) {
+	const int nNodes = static_cast<int>(mesh.nodes.size());
+	const int nElements = static_cast<int>(mesh.faces.size());
+
+	// Number of GLL nodes on the interior of each edge
+	const int nEdgeInterior = std::max(nP - 2, 0);
+
+	// Table of edges in compressed row form, keyed on the lesser node
+	// index of each edge.  Edges shared by two faces appear twice; the
+	// first entry is used for numbering.
+	std::vector<int> vecEdgeOffsets(nNodes + 1, 0);
+
+	for (int k = 0; k < nElements; k++) {
+		const Face & face = mesh.faces[k];
+		for (int e = 0; e < 4; e++) {
+			const int ixNode0 = face[e];
+			const int ixNode1 = face[(e+1)%4];
+			if (ixNode0 != ixNode1) {
+				vecEdgeOffsets[std::min(ixNode0, ixNode1) + 1]++;
+			}
+		}
+	}
+	for (int n = 0; n < nNodes; n++) {
+		vecEdgeOffsets[n+1] += vecEdgeOffsets[n];
+	}
+
+	std::vector<int> vecEdgeOtherNode(vecEdgeOffsets[nNodes]);
+	std::vector<int> vecEdgeFill(vecEdgeOffsets.begin(), vecEdgeOffsets.end() - 1);
+
+	for (int k = 0; k < nElements; k++) {
+		const Face & face = mesh.faces[k];
+		for (int e = 0; e < 4; e++) {
+			const int ixNode0 = face[e];
+			const int ixNode1 = face[(e+1)%4];
+			if (ixNode0 != ixNode1) {
+				vecEdgeOtherNode[vecEdgeFill[std::min(ixNode0, ixNode1)]++] =
+					std::max(ixNode0, ixNode1);
+			}
+		}
+	}
+
+	// GLL node indices associated with each mesh node and edge entry
+	std::vector<int> vecNodeGLL(nNodes, 0);
+	std::vector<int> vecEdgeGLL(vecEdgeOffsets[nNodes] * nEdgeInterior, 0);
+
+	int nGLLNodes = 0;
+
+	for (int k = 0; k < nElements; k++) {
+		const Face & face = mesh.faces[k];
+
+		for (int j = 0; j < nP; j++) {
+		for (int i = 0; i < nP; i++) {
+			const bool fEdgeI = ((i == 0) || (i == nP-1));
+			const bool fEdgeJ = ((j == 0) || (j == nP-1));
+
+			int * pGLL = NULL;
+
+			// Element corner
+			if (fEdgeI && fEdgeJ) {
+				int ixCorner;
+				if (j == 0) {
+					ixCorner = (i == 0)?(0):(1);
+				} else {
+					ixCorner = (i == 0)?(3):(2);
+				}
+				pGLL = &(vecNodeGLL[face[ixCorner]]);
+
+			// Element edge, from node ixNode0 to ixNode1 at position t
+			} else if (fEdgeI || fEdgeJ) {
+				int ixNode0;
+				int ixNode1;
+				int t;
+
+				if (j == 0) {
+					ixNode0 = face[0];
+					ixNode1 = face[1];
+					t = i;
+				} else if (i == nP-1) {
+					ixNode0 = face[1];
+					ixNode1 = face[2];
+					t = j;
+				} else if (j == nP-1) {
+					ixNode0 = face[3];
+					ixNode1 = face[2];
+					t = i;
+				} else {
+					ixNode0 = face[0];
+					ixNode1 = face[3];
+					t = j;
+				}
+
+				// GLL nodes on a degenerate edge coincide with its node
+				if (ixNode0 == ixNode1) {
+					pGLL = &(vecNodeGLL[ixNode0]);
+
+				} else {
+					if (ixNode0 > ixNode1) {
+						std::swap(ixNode0, ixNode1);
+						t = nP - 1 - t;
+					}
+
+					int ixEdge = vecEdgeOffsets[ixNode0];
+					while (vecEdgeOtherNode[ixEdge] != ixNode1) {
+						ixEdge++;
+					}
+
+					pGLL = &(vecEdgeGLL[ixEdge * nEdgeInterior + t - 1]);
+				}
+			}
+
+			// Element interior nodes and new nodes are assigned the next index
+			if (pGLL == NULL) {
+				nGLLNodes++;
+				dataGLLnodes[j][i][k] = nGLLNodes;
+
+			} else {
+				if (*pGLL == 0) {
+					nGLLNodes++;
+					*pGLL = nGLLNodes;
+				}
+				dataGLLnodes[j][i][k] = *pGLL;
+			}
+		}
+		}
+	}
+
+	return nGLLNodes;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Calculate the GLL Jacobian of one element, applying the bubble
+///		adjustment if requested, and return the numerical area of the
+///		element.
+///	</summary>
+static double GenerateMetaDataElementJacobian(
+	const Mesh & mesh,
+	int k,
+	int nP,
+	bool fBubble,
+	const DataArray1D<double> & dG,
+	const DataArray1D<double> & dW,
+	DataArray3D<double> & dataGLLJacobian
+) {
+	const Face & face = mesh.faces[k];
+	const NodeVector & nodevec = mesh.nodes;
+
+	double dFaceNumericalArea = 0.0;
+
+	for (int j = 0; j < nP; j++) {
+	for (int i = 0; i < nP; i++) {
+
+		// Get local map vectors
+		Node nodeGLL;
+		Node dDx1G;
+		Node dDx2G;
+
+		ApplyLocalMap(
+			face,
+			nodevec,
+			dG[i],
+			dG[j],
+			nodeGLL,
+			dDx1G,
+			dDx2G);
+
+		// Cross product gives local Jacobian
+		Node nodeCross = CrossProduct(dDx1G, dDx2G);
+
+		double dJacobian = sqrt(
+			  nodeCross.x * nodeCross.x
+			+ nodeCross.y * nodeCross.y
+			+ nodeCross.z * nodeCross.z);
+
+		// Element area weighted by local GLL weights
+		dJacobian *= dW[i] * dW[j];
+
+		if (dJacobian <= 0.0) {
+			_EXCEPTIONT("Nonpositive Jacobian detected");
+		}
+
+		dFaceNumericalArea += dJacobian;
+
+		dataGLLJacobian[j][i][k] = dJacobian;
+	}
+	}
+
+	// Apply bubble adjustment to area
+	if (fBubble && (dFaceNumericalArea != mesh.vecFaceArea[k])) {
+
+		// Use uniform bubble for linear elements
+		if (nP < 3) {
+			double dMassDifference = mesh.vecFaceArea[k] - dFaceNumericalArea;
+			for (int j = 0; j < nP; j++) {
+			for (int i = 0; i < nP; i++) {
+				dataGLLJacobian[j][i][k] +=
+					dMassDifference * dW[i] * dW[j];
+			}
+			}
+
+			dFaceNumericalArea += dMassDifference;
+
+		// Use HOMME bubble for higher order elements
+		} else {
+			double dMassDifference = mesh.vecFaceArea[k] - dFaceNumericalArea;
+
+			double dInteriorMassSum = 0;
+			for (int i = 1; i < nP-1; i++) {
+			for (int j = 1; j < nP-1; j++) {
+				dInteriorMassSum += dataGLLJacobian[i][j][k];
+			}
+			}
+
+			// Check that dInteriorMassSum is not too small
+			if (std::abs(dInteriorMassSum) < 1e-15) {
+				_EXCEPTIONT("--bubble correction cannot be performed, "
+					"sum of inner weights is too small");
+			}
+
+			dInteriorMassSum = dMassDifference / dInteriorMassSum;
+			for (int j = 1; j < nP-1; j++) {
+			for (int i = 1; i < nP-1; i++) {
+				dataGLLJacobian[j][i][k] *= 1.0 + dInteriorMassSum;
+			}
+			}
+
+			dFaceNumericalArea += dMassDifference;
+		}
+	}
+
+	return dFaceNumericalArea;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
 double GenerateMetaData(
 	const Mesh & mesh,
 	int nP,
 	bool fBubble,
 	DataArray3D<int> & dataGLLnodes,
-	DataArray3D<double> & dataGLLJacobian
+	DataArray3D<double> & dataGLLJacobian,
+	int nThreads
 ) {
+	if (nThreads < 1) {
+		_EXCEPTIONT("Thread count must be at least 1");
+	}
 
 	// Number of Faces
 	int nElements = static_cast<int>(mesh.faces.size());
 
+	// Verify all elements are quadrilaterals
+	for (int k = 0; k < nElements; k++) {
+		if (mesh.faces[k].edges.size() != 4) {
+			_EXCEPTIONT("Mesh must only contain quadrilateral elements");
+		}
+	}
+
+	// Verify face areas are available
+	if (fBubble) {
+		if (mesh.vecFaceArea.GetRows() != nElements) {
+			_EXCEPTIONT("Face area information unavailable or incorrect");
+		}
+	}
+
 	// Initialize data structures
 	dataGLLnodes.Allocate(nP, nP, nElements);
 	dataGLLJacobian.Allocate(nP, nP, nElements);
 
-	std::map<Node, int> mapNodes;
-
 	// GLL Quadrature nodes
-	DataArray1D<double> dG;
-	DataArray1D<double> dW;
-	GaussLobattoQuadrature::GetPoints(nP, 0.0, 1.0, dG, dW);
+	const GaussLobattoQuadrature::Points & pointsGLL =
+		GaussLobattoQuadrature::GetCachedPoints(nP, 0.0, 1.0);
 
-	// Accumulated Jacobian
-	double dAccumulatedJacobian = 0.0;
+	const DataArray1D<double> & dG = pointsGLL.dG;
+	const DataArray1D<double> & dW = pointsGLL.dW;
 
-	// Growing array of Jacobian values
-	std::vector<double> vecGLLJacobian;
+	// Number the GLL nodes
+	GenerateGLLNodeNumbering(mesh, nP, dataGLLnodes);
 
-	// Verify face areas are available
-	if (fBubble) {
-		if (mesh.vecFaceArea.GetRows() != nElements) {
-			_EXCEPTIONT("Face area information unavailable or incorrect");
-		}
+	// Calculate the Jacobian of each element
+	std::vector<double> vecFaceNumericalArea(nElements);
+
+	OmpExceptionCapture capture;
+
+#pragma omp parallel for schedule(dynamic, 256) num_threads(nThreads)
+	for (int k = 0; k < nElements; k++) {
+		capture.Run([&]() {
+			vecFaceNumericalArea[k] =
+				GenerateMetaDataElementJacobian(
+					mesh, k, nP, fBubble, dG, dW, dataGLLJacobian);
+		});
 	}
 
-	// Write metadata
+	capture.Rethrow();
+
+	// Accumulated Jacobian, summed in element order
+	double dAccumulatedJacobian = 0.0;
 	for (int k = 0; k < nElements; k++) {
-		const Face & face = mesh.faces[k];
-		const NodeVector & nodevec = mesh.nodes;
+		dAccumulatedJacobian += vecFaceNumericalArea[k];
+	}
 
-		if (face.edges.size() != 4) {
-			_EXCEPTIONT("Mesh must only contain quadrilateral elements");
-		}
+	return dAccumulatedJacobian;
+}
 
-		double dFaceNumericalArea = 0.0;
+///////////////////////////////////////////////////////////////////////////////
 
-		for (int j = 0; j < nP; j++) {
-		for (int i = 0; i < nP; i++) {
-/*
-			double dXc =
-				  nodevec[face[0]].x * (1.0 - dG[i]) * (1.0 - dG[j])
-				+ nodevec[face[1]].x *        dG[i]  * (1.0 - dG[j])
-				+ nodevec[face[2]].x *        dG[i]  *        dG[j]
-				+ nodevec[face[3]].x * (1.0 - dG[i]) *        dG[j];
-
-			double dYc =
-				  nodevec[face[0]].y * (1.0 - dG[i]) * (1.0 - dG[j])
-				+ nodevec[face[1]].y *        dG[i]  * (1.0 - dG[j])
-				+ nodevec[face[2]].y *        dG[i]  *        dG[j]
-				+ nodevec[face[3]].y * (1.0 - dG[i]) *        dG[j];
-
-			double dZc =
-				  nodevec[face[0]].z * (1.0 - dG[i]) * (1.0 - dG[j])
-				+ nodevec[face[1]].z *        dG[i]  * (1.0 - dG[j])
-				+ nodevec[face[2]].z *        dG[i]  *        dG[j]
-				+ nodevec[face[3]].z * (1.0 - dG[i]) *        dG[j];
-
-			double dR = sqrt(dXc * dXc + dYc * dYc + dZc * dZc);
-
-			// Check if this Node exists in the NodeMap
-			Node nodeGLL;
-			nodeGLL.x = dXc / dR;
-			nodeGLL.y = dYc / dR;
-			nodeGLL.z = dZc / dR;
-
-			// Calculate Jacobian
-
-			// Pointwise basis vectors in Cartesian geometry
-			Node dDx1F(
-				(1.0 - dG[j]) * (nodevec[face[1]].x - nodevec[face[0]].x)
-				+      dG[j]  * (nodevec[face[2]].x - nodevec[face[3]].x),
-				(1.0 - dG[j]) * (nodevec[face[1]].y - nodevec[face[0]].y)
-				+      dG[j]  * (nodevec[face[2]].y - nodevec[face[3]].y),
-				(1.0 - dG[j]) * (nodevec[face[1]].z - nodevec[face[0]].z)
-				+      dG[j]  * (nodevec[face[2]].z - nodevec[face[3]].z));
-
-			Node dDx2F(
-				(1.0 - dG[i]) * (nodevec[face[3]].x - nodevec[face[0]].x)
-				+      dG[i]  * (nodevec[face[2]].x - nodevec[face[1]].x),
-				(1.0 - dG[i]) * (nodevec[face[3]].y - nodevec[face[0]].y)
-				+      dG[i]  * (nodevec[face[2]].y - nodevec[face[1]].y),
-				(1.0 - dG[i]) * (nodevec[face[3]].z - nodevec[face[0]].z)
-				+      dG[i]  * (nodevec[face[2]].z - nodevec[face[1]].z));
-
-			// Pointwise basis vectors in spherical geometry
-			double dDenomTerm = 1.0 / (dR * dR * dR);
-
-			Node dDx1G(
-				- dXc * (dYc * dDx1F.y + dZc * dDx1F.z)
-					+ (dYc * dYc + dZc * dZc) * dDx1F.x,
-				- dYc * (dXc * dDx1F.x + dZc * dDx1F.z)
-					+ (dXc * dXc + dZc * dZc) * dDx1F.y,
-				- dZc * (dXc * dDx1F.x + dYc * dDx1F.y)
-					+ (dXc * dXc + dYc * dYc) * dDx1F.z);
-
-			Node dDx2G(
-				- dXc * (dYc * dDx2F.y + dZc * dDx2F.z)
-					+ (dYc * dYc + dZc * dZc) * dDx2F.x,
-				- dYc * (dXc * dDx2F.x + dZc * dDx2F.z)
-					+ (dXc * dXc + dZc * dZc) * dDx2F.y,
-				- dZc * (dXc * dDx2F.x + dYc * dDx2F.y)
-					+ (dXc * dXc + dYc * dYc) * dDx2F.z);
-
-			dDx1G.x *= dDenomTerm;
-			dDx1G.y *= dDenomTerm;
-			dDx1G.z *= dDenomTerm;
-
-			dDx2G.x *= dDenomTerm;
-			dDx2G.y *= dDenomTerm;
-			dDx2G.z *= dDenomTerm;
-*/
-			// Get local map vectors
-			Node nodeGLL;
-			Node dDx1G;
-			Node dDx2G;
-
-			ApplyLocalMap(
-				face,
-				nodevec,
-				dG[i],
-				dG[j],
-				nodeGLL,
-				dDx1G,
-				dDx2G);
-
-			// Determine if this is a unique Node
-			std::map<Node, int>::const_iterator iter = mapNodes.find(nodeGLL);
-			if (iter == mapNodes.end()) {
-
-				// Insert new unique node into map
-				int ixNode = static_cast<int>(mapNodes.size());
-				mapNodes.insert(std::pair<Node, int>(nodeGLL, ixNode));
-				dataGLLnodes[j][i][k] = ixNode + 1;
+///	<summary>
+///		Identifier at the start of every meta data cache file.
+///	</summary>
+static const char MetaDataCacheMagic[8] =
+	{ 'T', 'R', 'G', 'L', 'L', 'M', 'D', '\0' };
 
-			} else {
-				dataGLLnodes[j][i][k] = iter->second + 1;
-			}
+///	<summary>
+///		Version of the meta data cache file format.  Increment whenever the
+///		layout changes so that stale files are ignored.
+///	</summary>
+static const int MetaDataCacheVersion = 1;
 
-			// Cross product gives local Jacobian
-			Node nodeCross = CrossProduct(dDx1G, dDx2G);
+///	<summary>
+///		Write a block of data to a meta data cache file.
+///	</summary>
+static void WriteMetaDataCacheBlock(
+	FILE * fp,
+	const void * pData,
+	size_t sSize,
+	size_t sCount,
+	const std::string & strFile
+) {
+	if (sCount == 0) {
+		return;
+	}
+	if (fwrite(pData, sSize, sCount, fp) != sCount) {
+		fclose(fp);
+		_EXCEPTION1("Error writing meta data cache file \"%s\"",
+			strFile.c_str());
+	}
+}
 
-			double dJacobian = sqrt(
-				  nodeCross.x * nodeCross.x
-				+ nodeCross.y * nodeCross.y
-				+ nodeCross.z * nodeCross.z);
+///	<summary>
+///		Read a block of data from a meta data cache file.
+///	</summary>
+static bool ReadMetaDataCacheBlock(
+	FILE * fp,
+	void * pData,
+	size_t sSize,
+	size_t sCount
+) {
+	if (sCount == 0) {
+		return true;
+	}
+	return (fread(pData, sSize, sCount, fp) == sCount);
+}
 
-			// Element area weighted by local GLL weights
-			dJacobian *= dW[i] * dW[j];
+///	<summary>
+///		Write meta data generated by GenerateMetaData to a cache file.  The
+///		file is tagged with the content hash of the mesh, the order and the
+///		bubble setting.  With bubble the face areas are also stored, since
+///		the Jacobian depends on them.
+///	</summary>
+static void WriteMetaDataCache(
+	const std::string & strFile,
+	const Mesh & mesh,
+	int nP,
+	bool fBubble,
+	const DataArray3D<int> & dataGLLnodes,
+	const DataArray3D<double> & dataGLLJacobian,
+	double dNumericalArea
+) {
+	FILE * fp = fopen(strFile.c_str(), "wb");
+	if (fp == NULL) {
+		_EXCEPTION1("Unable to open meta data cache file \"%s\" for writing",
+			strFile.c_str());
+	}
 
-			if (dJacobian <= 0.0) {
-				_EXCEPTIONT("Nonpositive Jacobian detected");
-			}
+	unsigned long long ullHash = mesh.CalculateContentHash();
+
+	int nElements = static_cast<int>(mesh.faces.size());
+	int iBubble = (fBubble)?(1):(0);
+
+	WriteMetaDataCacheBlock(fp, MetaDataCacheMagic, sizeof(char), 8, strFile);
+	WriteMetaDataCacheBlock(fp, &MetaDataCacheVersion, sizeof(int), 1, strFile);
+	WriteMetaDataCacheBlock(fp, &ullHash, sizeof(unsigned long long), 1, strFile);
+	WriteMetaDataCacheBlock(fp, &nElements, sizeof(int), 1, strFile);
+	WriteMetaDataCacheBlock(fp, &nP, sizeof(int), 1, strFile);
+	WriteMetaDataCacheBlock(fp, &iBubble, sizeof(int), 1, strFile);
+	WriteMetaDataCacheBlock(fp, &dNumericalArea, sizeof(double), 1, strFile);
+
+	if (fBubble && (nElements != 0)) {
+		WriteMetaDataCacheBlock(fp, &(mesh.vecFaceArea[0]), sizeof(double), nElements, strFile);
+	}
 
-			dFaceNumericalArea += dJacobian;
+	if (nElements != 0) {
+		WriteMetaDataCacheBlock(fp, &(dataGLLnodes[0][0][0]), sizeof(int), dataGLLnodes.GetTotalSize(), strFile);
+		WriteMetaDataCacheBlock(fp, &(dataGLLJacobian[0][0][0]), sizeof(double), dataGLLJacobian.GetTotalSize(), strFile);
+	}
 
-			dataGLLJacobian[j][i][k] = dJacobian;
-		}
+	fclose(fp);
+}
+
+///	<summary>
+///		Read meta data written by WriteMetaDataCache.  Returns false, leaving
+///		the arrays unchanged, if the file is missing, invalid or was written
+///		for a different mesh, order or bubble setting.
+///	</summary>
+static bool ReadMetaDataCache(
+	const std::string & strFile,
+	const Mesh & mesh,
+	int nP,
+	bool fBubble,
+	DataArray3D<int> & dataGLLnodes,
+	DataArray3D<double> & dataGLLJacobian,
+	double & dNumericalArea
+) {
+	FILE * fp = fopen(strFile.c_str(), "rb");
+	if (fp == NULL) {
+		return false;
+	}
+
+	// Header
+	char szMagic[8];
+	int iVersion;
+	unsigned long long ullHash;
+	int nElements;
+	int nPIn;
+	int iBubble;
+	double dNumericalAreaIn;
+
+	bool fValid =
+		ReadMetaDataCacheBlock(fp, szMagic, sizeof(char), 8)
+		&& ReadMetaDataCacheBlock(fp, &iVersion, sizeof(int), 1)
+		&& ReadMetaDataCacheBlock(fp, &ullHash, sizeof(unsigned long long), 1)
+		&& ReadMetaDataCacheBlock(fp, &nElements, sizeof(int), 1)
+		&& ReadMetaDataCacheBlock(fp, &nPIn, sizeof(int), 1)
+		&& ReadMetaDataCacheBlock(fp, &iBubble, sizeof(int), 1)
+		&& ReadMetaDataCacheBlock(fp, &dNumericalAreaIn, sizeof(double), 1);
+
+	if (!fValid ||
+		(memcmp(szMagic, MetaDataCacheMagic, 8) != 0) ||
+		(iVersion != MetaDataCacheVersion)
+	) {
+		Announce("Meta data cache file \"%s\" is not valid; ignoring",
+			strFile.c_str());
+		fclose(fp);
+		return false;
+	}
+	if ((nElements != mesh.faces.size()) ||
+		(nPIn != nP) ||
+		(iBubble != ((fBubble)?(1):(0))) ||
+		(ullHash != mesh.CalculateContentHash())
+	) {
+		Announce("Meta data cache file \"%s\" does not match mesh; ignoring",
+			strFile.c_str());
+		fclose(fp);
+		return false;
+	}
+
+	// Face areas used for the bubble adjustment must be identical
+	if (fBubble && (nElements != 0)) {
+		std::vector<double> vecFaceAreaIn(nElements);
+		fValid = ReadMetaDataCacheBlock(fp, &(vecFaceAreaIn[0]), sizeof(double), nElements);
+
+		if (fValid && (memcmp(&(vecFaceAreaIn[0]), &(mesh.vecFaceArea[0]),
+				nElements * sizeof(double)) != 0)
+		) {
+			Announce("Meta data cache file \"%s\" does not match mesh; ignoring",
+				strFile.c_str());
+			fclose(fp);
+			return false;
 		}
+	}
 
-		// Apply bubble adjustment to area
-		if (fBubble && (dFaceNumericalArea != mesh.vecFaceArea[k])) {
-
-			// Use uniform bubble for linear elements
-			if (nP < 3) {
-				double dMassDifference = mesh.vecFaceArea[k] - dFaceNumericalArea;
-				for (int j = 0; j < nP; j++) {
-				for (int i = 0; i < nP; i++) {
-					dataGLLJacobian[j][i][k] +=
-						dMassDifference * dW[i] * dW[j];
- 				}
-				}
+	// Read into temporaries so that the arrays are unchanged on failure
+	DataArray3D<int> dataGLLnodesIn;
+	DataArray3D<double> dataGLLJacobianIn;
 
-				dFaceNumericalArea += dMassDifference;
+	if (fValid && (nElements != 0)) {
+		dataGLLnodesIn.Allocate(nP, nP, nElements);
+		dataGLLJacobianIn.Allocate(nP, nP, nElements);
 
-			// Use HOMME bubble for higher order elements
-			} else {
-			    double dMassDifference = mesh.vecFaceArea[k] - dFaceNumericalArea;
+		fValid =
+			ReadMetaDataCacheBlock(fp, &(dataGLLnodesIn[0][0][0]), sizeof(int), dataGLLnodesIn.GetTotalSize())
+			&& ReadMetaDataCacheBlock(fp, &(dataGLLJacobianIn[0][0][0]), sizeof(double), dataGLLJacobianIn.GetTotalSize());
+	}
 
-			    double dInteriorMassSum = 0;
-				for (int i = 1; i < nP-1; i++) {
-				for (int j = 1; j < nP-1; j++) {
-						dInteriorMassSum += dataGLLJacobian[i][j][k];
-				}
-				}
+	fclose(fp);
 
-				// Check that dInteriorMassSum is not too small
-				if (std::abs(dInteriorMassSum) < 1e-15) {
-					_EXCEPTIONT("--bubble correction cannot be performed, "
-						"sum of inner weights is too small");
-				}
+	if (!fValid) {
+		Announce("Meta data cache file \"%s\" is truncated; ignoring",
+			strFile.c_str());
+		return false;
+	}
 
-				dInteriorMassSum = dMassDifference / dInteriorMassSum;
-				for (int j = 1; j < nP-1; j++) {
-				for (int i = 1; i < nP-1; i++) {
-					dataGLLJacobian[j][i][k] *= 1.0 + dInteriorMassSum;
-				}
-				}
-/*
-				double dNewMassSum = 0;
-				for (int j = 0; j < nP; j++) {
-				for (int i = 0; i < nP; i++) {
-					dNewMassSum += dataGLLJacobian[j][i][k];
-				}
-				}
+	dataGLLnodes = dataGLLnodesIn;
+	dataGLLJacobian = dataGLLJacobianIn;
+	dNumericalArea = dNumericalAreaIn;
 
-				std::cout << "New mass  -  true mass " << dNewMassSum - mesh.vecFaceArea[k] << "\n";
+	return true;
+}
 
-				std::cout << "New mass = " << dNewMassSum << ", true mass = " << mesh.vecFaceArea[k] << "\n";
-*/
-				dFaceNumericalArea += dMassDifference;
-			}
+///////////////////////////////////////////////////////////////////////////////
+
+double GenerateMetaDataCached(
+	const Mesh & mesh,
+	int nP,
+	bool fBubble,
+	DataArray3D<int> & dataGLLnodes,
+	DataArray3D<double> & dataGLLJacobian,
+	const std::string & strCacheFile,
+	int nThreads
+) {
+	double dNumericalArea;
+
+	if (strCacheFile != "") {
+		if (ReadMetaDataCache(
+				strCacheFile, mesh, nP, fBubble,
+				dataGLLnodes, dataGLLJacobian, dNumericalArea)
+		) {
+			Announce("Loaded %s", strCacheFile.c_str());
+			return dNumericalArea;
 		}
+	}
 
-		// Accumulate area from element
-		dAccumulatedJacobian += dFaceNumericalArea;
+	dNumericalArea =
+		GenerateMetaData(
+			mesh, nP, fBubble, dataGLLnodes, dataGLLJacobian, nThreads);
+
+	if (strCacheFile != "") {
+		WriteMetaDataCache(
+			strCacheFile, mesh, nP, fBubble,
+			dataGLLnodes, dataGLLJacobian, dNumericalArea);
 	}
 
-	return dAccumulatedJacobian;
+	return dNumericalArea;
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -564,119 +1051,76 @@ void GenerateDiscontinuousJacobian(
 ///////////////////////////////////////////////////////////////////////////////
 
 ///	<summary>
-///		Global coefficient arrays (kept global to minimize reallocation)
+///		Get the coefficients of the 1D basis of order nP used to sample a
+///		finite element at the point dX in [0,1].
 ///	</summary>
-DataArray1D<double> g_dCoeffAlpha;
-DataArray1D<double> g_dCoeffBeta;
-
-void SampleGLLFiniteElement(
+static inline void SampleGLLBasis1D(
 	int nMonotoneType,
 	int nP,
-	double dAlpha,
-	double dBeta,
-	DataArray2D<double> & dCoeff
+	double dX,
+	double * dCoeff1D
 ) {
-	// Interpolation coefficients
-	g_dCoeffAlpha.Allocate(nP);
-	g_dCoeffBeta.Allocate(nP);
+	for (int i = 0; i < nP; i++) {
+		dCoeff1D[i] = 0.0;
+	}
 
 	// Non-monotone interpolation
 	if (nMonotoneType == 0) {
 
 		if (nP > 4) {
-			// GLL Quadrature nodes on [0,1]
-			DataArray1D<double> dG;
-			GetDefaultNodalLocations(nP, dG);
-			//DataArray1D<double> dW;
-			//GaussLobattoQuadrature::GetPoints(nP, 0.0, 1.0, dG, dW);
-
-			// Get interpolation coefficients in each direction
-			PolynomialInterp::LagrangianPolynomialCoeffs(
-				nP, dG, g_dCoeffAlpha, dAlpha);
-
-			PolynomialInterp::LagrangianPolynomialCoeffs(
-				nP, dG, g_dCoeffBeta, dBeta);
+			// Lagrange basis through the GLL nodes on [0,1], shared by all
+			// calls with the same nP
+			LagrangeBasisTable::Get(nP).Evaluate(dX, dCoeff1D);
+			return;
 		}
 
-		// Map dAlpha and dBeta to [-1,1]
-		dAlpha = 2.0 * dAlpha - 1.0;
-		dBeta  = 2.0 * dBeta  - 1.0;
+		// Map dX to [-1,1]
+		dX = 2.0 * dX - 1.0;
 
 		// Second order monotone interpolation
 		if (nP == 2) {
-			g_dCoeffAlpha[0] = 0.5 * (1.0 - dAlpha);
-			g_dCoeffAlpha[1] = 0.5 * (1.0 + dAlpha);
-
-			g_dCoeffBeta[0] = 0.5 * (1.0 - dBeta);
-			g_dCoeffBeta[1] = 0.5 * (1.0 + dBeta);
+			dCoeff1D[0] = 0.5 * (1.0 - dX);
+			dCoeff1D[1] = 0.5 * (1.0 + dX);
 
 		// Third order interpolation
 		} else if (nP == 3) {
-			g_dCoeffAlpha[0] = 0.5 * (dAlpha * dAlpha - dAlpha);
-			g_dCoeffAlpha[1] = 1.0 - dAlpha * dAlpha;
-			g_dCoeffAlpha[2] = 0.5 * (dAlpha * dAlpha + dAlpha);
-
-			g_dCoeffBeta[0] = 0.5 * (dBeta * dBeta - dBeta);
-			g_dCoeffBeta[1] = 1.0 - dBeta * dBeta;
-			g_dCoeffBeta[2] = 0.5 * (dBeta * dBeta + dBeta);
+			dCoeff1D[0] = 0.5 * (dX * dX - dX);
+			dCoeff1D[1] = 1.0 - dX * dX;
+			dCoeff1D[2] = 0.5 * (dX * dX + dX);
 
 		// Fourth order interpolation
 		} else if (nP == 4) {
-			g_dCoeffAlpha[0] = -1.0/8.0
-				* (dAlpha - 1.0) * (5.0 * dAlpha * dAlpha - 1.0);
-			g_dCoeffAlpha[1] = - sqrt(5.0)/8.0
-				* (sqrt(5.0) - 5.0 * dAlpha)
-				* (dAlpha * dAlpha - 1.0);
-			g_dCoeffAlpha[2] = - sqrt(5.0)/8.0
-				* (sqrt(5.0) + 5.0 * dAlpha)
-				* (dAlpha * dAlpha - 1.0);
-			g_dCoeffAlpha[3] =  1.0/8.0
-				* (dAlpha + 1.0) * (5.0 * dAlpha * dAlpha - 1.0);
-
-			g_dCoeffBeta[0] = -1.0/8.0
-				* (dBeta - 1.0) * (5.0 * dBeta * dBeta - 1.0);
-			g_dCoeffBeta[1] = - sqrt(5.0)/8.0
-				* (sqrt(5.0) - 5.0 * dBeta)
-				* (dBeta * dBeta - 1.0);
-			g_dCoeffBeta[2] = - sqrt(5.0)/8.0
-				* (sqrt(5.0) + 5.0 * dBeta)
-				* (dBeta * dBeta - 1.0);
-			g_dCoeffBeta[3] =  1.0/8.0
-				* (dBeta + 1.0) * (5.0 * dBeta * dBeta - 1.0);
+			dCoeff1D[0] = -1.0/8.0
+				* (dX - 1.0) * (5.0 * dX * dX - 1.0);
+			dCoeff1D[1] = - sqrt(5.0)/8.0
+				* (sqrt(5.0) - 5.0 * dX)
+				* (dX * dX - 1.0);
+			dCoeff1D[2] = - sqrt(5.0)/8.0
+				* (sqrt(5.0) + 5.0 * dX)
+				* (dX * dX - 1.0);
+			dCoeff1D[3] =  1.0/8.0
+				* (dX + 1.0) * (5.0 * dX * dX - 1.0);
 		}
 
 	// Standard monotone interpolation
 	} else if (nMonotoneType == 1) {
 
-		// Map dAlpha and dBeta to [-1,1]
-		dAlpha = 2.0 * dAlpha - 1.0;
-		dBeta  = 2.0 * dBeta  - 1.0;
+		// Map dX to [-1,1]
+		dX = 2.0 * dX - 1.0;
 
 		// Second order monotone interpolation
 		if (nP == 2) {
-
-			g_dCoeffAlpha[0] = 0.5 * (1.0 - dAlpha);
-			g_dCoeffAlpha[1] = 0.5 * (1.0 + dAlpha);
-
-			g_dCoeffBeta[0] = 0.5 * (1.0 - dBeta);
-			g_dCoeffBeta[1] = 0.5 * (1.0 + dBeta);
+			dCoeff1D[0] = 0.5 * (1.0 - dX);
+			dCoeff1D[1] = 0.5 * (1.0 + dX);
 
 		// Third order monotone interpolation
 		} else if (nP == 3) {
-
-			if (dAlpha < 0.0) {
-				g_dCoeffAlpha[0] = dAlpha * dAlpha;
-				g_dCoeffAlpha[1] = 1.0 - dAlpha * dAlpha;
-			} else {
-				g_dCoeffAlpha[1] = 1.0 - dAlpha * dAlpha;
-				g_dCoeffAlpha[2] = dAlpha * dAlpha;
-			}
-			if (dBeta < 0.0) {
-				g_dCoeffBeta[0] = dBeta * dBeta;
-				g_dCoeffBeta[1] = 1.0 - dBeta * dBeta;
+			if (dX < 0.0) {
+				dCoeff1D[0] = dX * dX;
+				dCoeff1D[1] = 1.0 - dX * dX;
 			} else {
-				g_dCoeffBeta[1] = 1.0 - dBeta * dBeta;
-				g_dCoeffBeta[2] = dBeta * dBeta;
+				dCoeff1D[1] = 1.0 - dX * dX;
+				dCoeff1D[2] = dX * dX;
 			}
 
 		// Fourth order monotone interpolation
@@ -694,38 +1138,21 @@ void SampleGLLFiniteElement(
 			const double dC1 = 0.0;
 			const double dD1 = (5.0 / 4.0) * sqrt(5.0);
 
-			if ((dAlpha >= -dGLL1) && (dAlpha <= dGLL1)) {
-				g_dCoeffAlpha[1] =
-					dA1 + dAlpha * (dB1 + dAlpha * (dC1 + dAlpha * dD1));
-				g_dCoeffAlpha[2] =
-					1.0 - g_dCoeffAlpha[1];
-			} else if (dAlpha < -dGLL1) {
-				g_dCoeffAlpha[0] =
-					dA0 + dAlpha * (dB0 + dAlpha * (dC0 + dAlpha * dD0));
-				g_dCoeffAlpha[1] =
-					1.0 - g_dCoeffAlpha[0];
-			} else {
-				g_dCoeffAlpha[3] =
-					dA0 - dAlpha * (dB0 - dAlpha * (dC0 - dAlpha * dD0));
-				g_dCoeffAlpha[2] =
-					1.0 - g_dCoeffAlpha[3];
-			}
-
-			if ((dBeta >= -dGLL1) && (dBeta <= dGLL1)) {
-				g_dCoeffBeta[1] =
-					dA1 + dBeta * (dB1 + dBeta * (dC1 + dBeta * dD1));
-				g_dCoeffBeta[2] =
-					1.0 - g_dCoeffBeta[1];
-			} else if (dBeta < -dGLL1) {
-				g_dCoeffBeta[0] =
-					dA0 + dBeta * (dB0 + dBeta * (dC0 + dBeta * dD0));
-				g_dCoeffBeta[1] =
-					1.0 - g_dCoeffBeta[0];
+			if ((dX >= -dGLL1) && (dX <= dGLL1)) {
+				dCoeff1D[1] =
+					dA1 + dX * (dB1 + dX * (dC1 + dX * dD1));
+				dCoeff1D[2] =
+					1.0 - dCoeff1D[1];
+			} else if (dX < -dGLL1) {
+				dCoeff1D[0] =
+					dA0 + dX * (dB0 + dX * (dC0 + dX * dD0));
+				dCoeff1D[1] =
+					1.0 - dCoeff1D[0];
 			} else {
-				g_dCoeffBeta[3] =
-					dA0 - dBeta * (dB0 - dBeta * (dC0 - dBeta * dD0));
-				g_dCoeffBeta[2] =
-					1.0 - g_dCoeffBeta[3];
+				dCoeff1D[3] =
+					dA0 - dX * (dB0 - dX * (dC0 - dX * dD0));
+				dCoeff1D[2] =
+					1.0 - dCoeff1D[3];
 			}
 
 		} else {
@@ -735,72 +1162,37 @@ void SampleGLLFiniteElement(
 	// Piecewise constant monotone interpolation
 	} else if (nMonotoneType == 2) {
 
-		// Map dAlpha and dBeta to [-1,1]
-		dAlpha = 2.0 * dAlpha - 1.0;
-		dBeta  = 2.0 * dBeta  - 1.0;
+		// Map dX to [-1,1]
+		dX = 2.0 * dX - 1.0;
 
 		// Second order monotone interpolation
 		if (nP == 2) {
-
-			g_dCoeffAlpha.Zero();
-			g_dCoeffBeta.Zero();
-
-			if (dAlpha < 0.0) {
-				g_dCoeffAlpha[0] = 1.0;
+			if (dX < 0.0) {
+				dCoeff1D[0] = 1.0;
 			} else {
-				g_dCoeffAlpha[1] = 1.0;
-			}
-			if (dBeta < 0.0) {
-				g_dCoeffBeta[0] = 1.0;
-			} else {
-				g_dCoeffBeta[1] = 1.0;
+				dCoeff1D[1] = 1.0;
 			}
 
 		// Third order monotone interpolation
 		} else if (nP == 3) {
-
-			g_dCoeffAlpha.Zero();
-			g_dCoeffBeta.Zero();
-
-			if (dAlpha < -2.0/3.0) {
-				g_dCoeffAlpha[0] = 1.0;
-			} else if (dAlpha <= 2.0/3.0) {
-				g_dCoeffAlpha[1] = 1.0;
+			if (dX < -2.0/3.0) {
+				dCoeff1D[0] = 1.0;
+			} else if (dX <= 2.0/3.0) {
+				dCoeff1D[1] = 1.0;
 			} else {
-				g_dCoeffAlpha[2] = 1.0;
-			}
-			if (dBeta < -2.0/3.0) {
-				g_dCoeffBeta[0] = 1.0;
-			} else if (dBeta <= 2.0/3.0) {
-				g_dCoeffBeta[1] = 1.0;
-			} else {
-				g_dCoeffBeta[2] = 1.0;
+				dCoeff1D[2] = 1.0;
 			}
 
 		// Fourth order monotone interpolation
 		} else if (nP == 4) {
-
-			g_dCoeffAlpha.Zero();
-			g_dCoeffBeta.Zero();
-
-			if (dAlpha < -5.0/6.0) {
-				g_dCoeffAlpha[0] = 1.0;
-			} else if (dAlpha <= 0.0) {
-				g_dCoeffAlpha[1] = 1.0;
-			} else if (dAlpha <= 5.0/6.0) {
-				g_dCoeffAlpha[2] = 1.0;
-			} else {
-				g_dCoeffAlpha[3] = 1.0;
-			}
-
-			if (dBeta < -5.0/6.0) {
-				g_dCoeffBeta[0] = 1.0;
-			} else if (dBeta <= 0.0) {
-				g_dCoeffBeta[1] = 1.0;
-			} else if (dBeta <= 5.0/6.0) {
-				g_dCoeffBeta[2] = 1.0;
+			if (dX < -5.0/6.0) {
+				dCoeff1D[0] = 1.0;
+			} else if (dX <= 0.0) {
+				dCoeff1D[1] = 1.0;
+			} else if (dX <= 5.0/6.0) {
+				dCoeff1D[2] = 1.0;
 			} else {
-				g_dCoeffBeta[3] = 1.0;
+				dCoeff1D[3] = 1.0;
 			}
 
 		} else {
@@ -810,35 +1202,22 @@ void SampleGLLFiniteElement(
 	// Piecewise linear monotone interpolation
 	} else if (nMonotoneType == 3) {
 
-		// Map dAlpha and dBeta to [-1,1]
-		dAlpha = 2.0 * dAlpha - 1.0;
-		dBeta  = 2.0 * dBeta  - 1.0;
+		// Map dX to [-1,1]
+		dX = 2.0 * dX - 1.0;
 
 		// Second order monotone interpolation
 		if (nP == 2) {
-
-			g_dCoeffAlpha[0] = 0.5 * (1.0 - dAlpha);
-			g_dCoeffAlpha[1] = 0.5 * (1.0 + dAlpha);
-
-			g_dCoeffBeta[0] = 0.5 * (1.0 - dBeta);
-			g_dCoeffBeta[1] = 0.5 * (1.0 + dBeta);
+			dCoeff1D[0] = 0.5 * (1.0 - dX);
+			dCoeff1D[1] = 0.5 * (1.0 + dX);
 
 		// Third order monotone interpolation
 		} else if (nP == 3) {
-
-			if (dAlpha < 0.0) {
-				g_dCoeffAlpha[0] = - dAlpha;
-				g_dCoeffAlpha[1] = 1.0 + dAlpha;
+			if (dX < 0.0) {
+				dCoeff1D[0] = - dX;
+				dCoeff1D[1] = 1.0 + dX;
 			} else {
-				g_dCoeffAlpha[1] = 1.0 - dAlpha;
-				g_dCoeffAlpha[2] = dAlpha;
-			}
-			if (dBeta < 0.0) {
-				g_dCoeffBeta[0] = - dBeta;
-				g_dCoeffBeta[1] = 1.0 + dBeta;
-			} else {
-				g_dCoeffBeta[1] = 1.0 - dBeta;
-				g_dCoeffBeta[2] = dBeta;
+				dCoeff1D[1] = 1.0 - dX;
+				dCoeff1D[2] = dX;
 			}
 
 		// Fourth order monotone interpolation
@@ -848,38 +1227,21 @@ void SampleGLLFiniteElement(
 
 			const double dA = 5.0 + sqrt(5.0);
 
-			if (dAlpha < -dGLL1) {
-				g_dCoeffAlpha[0] =
-					-1.0 / 20.0 * dA * (5.0 * dAlpha + sqrt(5.0));
-				g_dCoeffAlpha[1] =
-					1.0 / 4.0 * dA * (dAlpha + 1.0);
+			if (dX < -dGLL1) {
+				dCoeff1D[0] =
+					-1.0 / 20.0 * dA * (5.0 * dX + sqrt(5.0));
+				dCoeff1D[1] =
+					1.0 / 4.0 * dA * (dX + 1.0);
 
-			} else if (dAlpha < dGLL1) {
-				g_dCoeffAlpha[1] = 0.5 * (1.0 - sqrt(5.0) * dAlpha);
-				g_dCoeffAlpha[2] = 0.5 * (1.0 + sqrt(5.0) * dAlpha);
+			} else if (dX < dGLL1) {
+				dCoeff1D[1] = 0.5 * (1.0 - sqrt(5.0) * dX);
+				dCoeff1D[2] = 0.5 * (1.0 + sqrt(5.0) * dX);
 
 			} else {
-				g_dCoeffAlpha[2] =
-					- 1.0 / 4.0 * dA * (dAlpha - 1.0);
-				g_dCoeffAlpha[3] =
-					- 1.0 / 20.0 * dA * (-5.0 * dAlpha + sqrt(5.0));
-			}
-
-			if (dBeta < -dGLL1) {
-				g_dCoeffBeta[0] =
-					-1.0 / 20.0 * dA * (5.0 * dBeta + sqrt(5.0));
-				g_dCoeffBeta[1] =
-					1.0 / 4.0 * dA * (dBeta + 1.0);
-
-			} else if (dBeta < dGLL1) {
-				g_dCoeffBeta[1] = 0.5 * (1.0 - sqrt(5.0) * dBeta);
-				g_dCoeffBeta[2] = 0.5 * (1.0 + sqrt(5.0) * dBeta);
-
-			} else {
-				g_dCoeffBeta[2] =
-					- 1.0 / 4.0 * dA * (dBeta - 1.0);
-				g_dCoeffBeta[3] =
-					- 1.0 / 20.0 * dA * (-5.0 * dBeta + sqrt(5.0));
+				dCoeff1D[2] =
+					- 1.0 / 4.0 * dA * (dX - 1.0);
+				dCoeff1D[3] =
+					- 1.0 / 20.0 * dA * (-5.0 * dX + sqrt(5.0));
 			}
 
 		} else {
@@ -889,85 +1251,188 @@ void SampleGLLFiniteElement(
 	} else {
 		_EXCEPTIONT("Invalid monotone type");
 	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void SampleGLLFiniteElement(
+	int nMonotoneType,
+	int nP,
+	double dAlpha,
+	double dBeta,
+	DataArray2D<double> & dCoeff
+) {
+	// Interpolation coefficients; these are local so that this function
+	// may be called concurrently from multiple threads
+	DataArray1D<double> dCoeffAlpha(nP, true, DataArrayStorage_Pooled);
+	DataArray1D<double> dCoeffBeta(nP, true, DataArrayStorage_Pooled);
+
+	SampleGLLBasis1D(nMonotoneType, nP, dAlpha, &(dCoeffAlpha[0]));
+	SampleGLLBasis1D(nMonotoneType, nP, dBeta, &(dCoeffBeta[0]));
 
 	// Combine coefficients
 	dCoeff.Allocate(nP, nP);
 
 	for (int i = 0; i < nP; i++) {
 	for (int j = 0; j < nP; j++) {
-		dCoeff[j][i] = g_dCoeffAlpha[i] * g_dCoeffBeta[j];
+		dCoeff[j][i] = dCoeffAlpha[i] * dCoeffBeta[j];
 	}
 	}
-/*
-	// DEBUG: Override
-	if (fMonotone && (nP == 4)) {
+}
 
-		const double dGLL1 = 1.0/sqrt(5.0);
+///////////////////////////////////////////////////////////////////////////////
 
-		if ((dAlpha < -dGLL1) && (dBeta < -dGLL1)) {
-			dCoeff[0][0] = 0.090903957942705;
-			dCoeff[1][0] = 0.251678634003417;
-			dCoeff[0][1] = 0.251678634003417;
-			dCoeff[1][1] = 0.405738774050462;
-			return;
-		}
-		if ((dAlpha < -dGLL1) && (dBeta < dGLL1)) {
-			dCoeff[1][0] = 0.125362728546156;
-			dCoeff[2][0] = 0.125362728546156;
-			dCoeff[1][1] = 0.374637271453844;
-			dCoeff[2][1] = 0.374637271453844;
-			return;
-		}
-		if (dAlpha < -dGLL1) {
-			dCoeff[2][0] = 0.251678634003417;
-			dCoeff[3][0] = 0.090903957942705;
-			dCoeff[3][1] = 0.251678634003417;
-			dCoeff[2][1] = 0.405738774050462;
-			return;
-		}
-		if ((dAlpha < dGLL1) && (dBeta < -dGLL1)) {
-			dCoeff[0][1] = 0.125362728546156;
-			dCoeff[0][2] = 0.125362728546156;
-			dCoeff[1][1] = 0.374637271453844;
-			dCoeff[1][2] = 0.374637271453844;
-			return;
-		}
-		if ((dAlpha < dGLL1) && (dBeta < dGLL1)) {
-			dCoeff[1][1] = 0.25;
-			dCoeff[1][2] = 0.25;
-			dCoeff[2][1] = 0.25;
-			dCoeff[2][2] = 0.25;
-			return;
+template <int nP>
+void SampleGLLFiniteElement(
+	int nMonotoneType,
+	double dAlpha,
+	double dBeta,
+	double (&dCoeff)[nP][nP]
+) {
+	double dCoeffAlpha[nP];
+	double dCoeffBeta[nP];
+
+	SampleGLLBasis1D(nMonotoneType, nP, dAlpha, dCoeffAlpha);
+	SampleGLLBasis1D(nMonotoneType, nP, dBeta, dCoeffBeta);
+
+	// Combine coefficients
+	for (int i = 0; i < nP; i++) {
+	for (int j = 0; j < nP; j++) {
+		dCoeff[j][i] = dCoeffAlpha[i] * dCoeffBeta[j];
+	}
+	}
+}
+
+template void SampleGLLFiniteElement<2>(
+	int, double, double, double (&)[2][2]);
+template void SampleGLLFiniteElement<3>(
+	int, double, double, double (&)[3][3]);
+template void SampleGLLFiniteElement<4>(
+	int, double, double, double (&)[4][4]);
+
+///////////////////////////////////////////////////////////////////////////////
+
+void ProjectConsistencyConservation(
+	const DataArray1D<double> & vecSourceArea,
+	const DataArray1D<double> & vecTargetArea,
+	DataArray2D<double> & dCoeff
+) {
+	const int nRows = dCoeff.GetRows();
+	const int nCols = dCoeff.GetColumns();
+
+	if ((nRows == 0) || (nCols == 0)) {
+		return;
+	}
+
+	// Sum of squared target areas
+	double dP = 0.0;
+	for (int i = 0; i < nRows; i++) {
+		dP += vecTargetArea[i] * vecTargetArea[i];
+	}
+
+	if ((nCols > 1) && !(dP > 0.0)) {
+		_EXCEPTIONT("Unable to enforce conservation with zero target area");
+	}
+
+	// Consistency residuals (A) and conservation residuals (B).  The
+	// constraint matrix has one row per row and column of dCoeff, so the
+	// Schur complement of the KKT system reduces to these scalar sums.
+	DataArray1D<double> dRowResidual(nRows, true, DataArrayStorage_Pooled);
+	DataArray1D<double> dColResidual(nCols, true, DataArrayStorage_Pooled);
+
+	double dA = 0.0;
+	for (int i = 0; i < nRows; i++) {
+		double dRowSum = 0.0;
+		for (int j = 0; j < nCols; j++) {
+			dRowSum += dCoeff[i][j];
 		}
-		if (dAlpha < dGLL1) {
-			dCoeff[3][1] = 0.125362728546156;
-			dCoeff[3][2] = 0.125362728546156;
-			dCoeff[2][1] = 0.374637271453844;
-			dCoeff[2][2] = 0.374637271453844;
-			return;
+		dRowResidual[i] = dRowSum - 1.0;
+		dA += vecTargetArea[i] * dRowResidual[i];
+	}
+
+	double dB = 0.0;
+	for (int j = 0; j < nCols - 1; j++) {
+		double dColSum = 0.0;
+		for (int i = 0; i < nRows; i++) {
+			dColSum += vecTargetArea[i] * dCoeff[i][j];
 		}
-		if (dBeta < -dGLL1) {
-			dCoeff[0][2] = 0.251678634003417;
-			dCoeff[0][3] = 0.090903957942705;
-			dCoeff[1][3] = 0.251678634003417;
-			dCoeff[1][2] = 0.405738774050462;
-			return;
+		dColResidual[j] = dColSum - vecSourceArea[j];
+		dB += dColResidual[j];
+	}
+
+	// Lagrange multipliers: the solution is
+	//   dCoeff[i][j] - dLambda[i] - vecTargetArea[i] * dMu[j]
+	// with dMu[nCols-1] = 0
+	const double dMuSum =
+		(nCols > 1)?
+			((static_cast<double>(nCols) * dB
+			 - static_cast<double>(nCols - 1) * dA) / dP):(0.0);
+
+	const double dWeightedLambda =
+		(dA - dP * dMuSum) / static_cast<double>(nCols);
+
+	DataArray1D<double> & dMu = dColResidual;
+	for (int j = 0; j < nCols - 1; j++) {
+		dMu[j] = (dColResidual[j] - dWeightedLambda) / dP;
+	}
+	dMu[nCols-1] = 0.0;
+
+	for (int i = 0; i < nRows; i++) {
+		const double dLambda =
+			(dRowResidual[i] - vecTargetArea[i] * dMuSum)
+			/ static_cast<double>(nCols);
+
+		for (int j = 0; j < nCols; j++) {
+			dCoeff[i][j] -= dLambda + vecTargetArea[i] * dMu[j];
 		}
-		if (dBeta < dGLL1) {
-			dCoeff[1][3] = 0.125362728546156;
-			dCoeff[2][3] = 0.125362728546156;
-			dCoeff[1][2] = 0.374637271453844;
-			dCoeff[2][2] = 0.374637271453844;
-			return;
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void BlendMonotoneCoefficients(
+	const DataArray1D<double> & vecSourceArea,
+	DataArray2D<double> & dCoeff
+) {
+	const int nRows = dCoeff.GetRows();
+	const int nCols = dCoeff.GetColumns();
+
+	// Calculate total element Jacobian
+	double dTotalJacobian = 0.0;
+	for (int j = 0; j < vecSourceArea.GetRows(); j++) {
+		dTotalJacobian += vecSourceArea[j];
+	}
+
+	// Low-order remap coefficients are the same in every row
+	DataArray1D<double> dMonoCoeff(nCols, true, DataArrayStorage_Pooled);
+	for (int j = 0; j < nCols; j++) {
+		dMonoCoeff[j] = vecSourceArea[j] / dTotalJacobian;
+	}
+
+	// Compute scaling factor
+	double dA = 0.0;
+	for (int i = 0; i < nRows; i++) {
+	for (int j = 0; j < nCols; j++) {
+		if (dCoeff[i][j] < 0.0) {
+			double dNewA =
+				- dCoeff[i][j] / fabs(dMonoCoeff[j] - dCoeff[i][j]);
+
+			if (dNewA > dA) {
+				dA = dNewA;
+			}
 		}
+	}
+	}
 
-		dCoeff[3][2] = 0.251678634003417;
-		dCoeff[3][3] = 0.090903957942705;
-		dCoeff[2][3] = 0.251678634003417;
-		dCoeff[2][2] = 0.405738774050462;
+	if (dA == 0.0) {
 		return;
 	}
-*/
+
+	for (int i = 0; i < nRows; i++) {
+	for (int j = 0; j < nCols; j++) {
+		dCoeff[i][j] = (1.0 - dA) * dCoeff[i][j] + dA * dMonoCoeff[j];
+	}
+	}
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -20,6 +20,8 @@
 #include "DataArray3D.h"
 #include "GridElements.h"
 
+#include <string>
+
 ///////////////////////////////////////////////////////////////////////////////
 
 static const double InverseMapTolerance = 1.0e-13;
@@ -79,17 +81,52 @@ void ApplyInverseMap(
 	double & dBeta
 );
 
+///	<summary>
+///		Apply the inverse map to nPoints points pNodes in the same Face.
+///		Each point is inverted in closed form and then refined by Newton's
+///		method, which typically terminates after a single iteration.
+///	</summary>
+void ApplyInverseMap(
+	const Face & face,
+	const NodeVector & nodes,
+	int nPoints,
+	const Node * pNodes,
+	double * dAlpha,
+	double * dBeta
+);
+
 ///////////////////////////////////////////////////////////////////////////////
 
 ///	<summary>
-///		Generate Mesh meta data for a spectral element grid.
+///		Generate Mesh meta data for a spectral element grid.  GLL nodes are
+///		numbered from the mesh topology, so coincident nodes must have been
+///		removed from the mesh.  Returns the numerical area of the mesh.
 ///	</summary>
 double GenerateMetaData(
 	const Mesh & mesh,
 	int nP,
 	bool fBubble,
 	DataArray3D<int> & dataGLLnodes,
-	DataArray3D<double> & dataGLLJacobian
+	DataArray3D<double> & dataGLLJacobian,
+	int nThreads = 1
+);
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Generate Mesh meta data for a spectral element grid, reusing the meta
+///		data in strCacheFile if it was generated for the same mesh, order and
+///		bubble setting.  Otherwise the meta data is generated and written to
+///		strCacheFile.  No cache is used if strCacheFile is empty.
+///	</summary>
+double GenerateMetaDataCached(
+	const Mesh & mesh,
+	int nP,
+	bool fBubble,
+	DataArray3D<int> & dataGLLnodes,
+	DataArray3D<double> & dataGLLJacobian,
+	const std::string & strCacheFile,
+	int nThreads = 1
 );
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -127,5 +164,132 @@ void SampleGLLFiniteElement(
 	DataArray2D<double> & dCoeff
 );
 
+///	<summary>
+///		Get the coefficients for sampling a 2D finite element of fixed
+///		order nP at the specified point.  Instantiated for nP = 2, 3 and 4.
+///	</summary>
+template <int nP>
+void SampleGLLFiniteElement(
+	int nMonotoneType,
+	double dAlpha,
+	double dBeta,
+	double (&dCoeff)[nP][nP]
+);
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Coefficients for sampling a 2D finite element, stored on the stack
+///		for a fixed order nP so that loops over them may be unrolled.
+///		GLLSampleCoeff<0> is the fallback for orders only known at runtime.
+///	</summary>
+template <int nP>
+class GLLSampleCoeff {
+
+public:
+	///	<summary>
+	///		Constructor.
+	///	</summary>
+	GLLSampleCoeff(int) { }
+
+	///	<summary>
+	///		Sample the finite element at the specified point.
+	///	</summary>
+	void Sample(
+		int nMonotoneType,
+		double dAlpha,
+		double dBeta
+	) {
+		SampleGLLFiniteElement<nP>(nMonotoneType, dAlpha, dBeta, m_dCoeff);
+	}
+
+	///	<summary>
+	///		Coefficients of row p.
+	///	</summary>
+	const double * operator[](int p) const {
+		return m_dCoeff[p];
+	}
+
+protected:
+	///	<summary>
+	///		Sample coefficients.
+	///	</summary>
+	double m_dCoeff[nP][nP];
+};
+
+///	<summary>
+///		Coefficients for sampling a 2D finite element of runtime order.
+///	</summary>
+template <>
+class GLLSampleCoeff<0> {
+
+public:
+	///	<summary>
+	///		Constructor.
+	///	</summary>
+	GLLSampleCoeff(int nP) :
+		m_nP(nP),
+		m_dCoeff(nP, nP)
+	{ }
+
+	///	<summary>
+	///		Sample the finite element at the specified point.
+	///	</summary>
+	void Sample(
+		int nMonotoneType,
+		double dAlpha,
+		double dBeta
+	) {
+		SampleGLLFiniteElement(nMonotoneType, m_nP, dAlpha, dBeta, m_dCoeff);
+	}
+
+	///	<summary>
+	///		Coefficients of row p.
+	///	</summary>
+	const double * operator[](int p) const {
+		return &(m_dCoeff[p][0]);
+	}
+
+protected:
+	///	<summary>
+	///		Order of the finite element.
+	///	</summary>
+	int m_nP;
+
+	///	<summary>
+	///		Sample coefficients.
+	///	</summary>
+	DataArray2D<double> m_dCoeff;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Replace dCoeff by the nearest coefficients in the L2 norm that are
+///		consistent (each row sums to one) and conservative (the sum of each
+///		column weighted by vecTargetArea equals vecSourceArea).  The last
+///		conservation condition is linearly dependent on the others and is
+///		dropped.  The projection is computed in closed form, in
+///		O(rows * columns) operations.
+///	</summary>
+void ProjectConsistencyConservation(
+	const DataArray1D<double> & vecSourceArea,
+	const DataArray1D<double> & vecTargetArea,
+	DataArray2D<double> & dCoeff
+);
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Blend dCoeff with the low-order coefficients that distribute each
+///		row in proportion to vecSourceArea, using the smallest weight on the
+///		low-order coefficients for which no coefficient is negative.  The
+///		blend preserves consistency and conservation.
+///	</summary>
+void BlendMonotoneCoefficients(
+	const DataArray1D<double> & vecSourceArea,
+	DataArray2D<double> & dCoeff
+);
+
 ///////////////////////////////////////////////////////////////////////////////
 
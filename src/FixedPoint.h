@@ -23,12 +23,18 @@
 #include <vector>
 #include <iostream>
 #include <cstring>
+#include <cmath>
+#include <cfloat>
 
 #include "Defines.h"
 #include "Exception.h"
 
 ///////////////////////////////////////////////////////////////////////////////
 
+class FixedPointFilter;
+
+///////////////////////////////////////////////////////////////////////////////
+
 ///	<summary>
 ///		A fixed point number, used for exact arithmetic.
 ///	</summary>
@@ -471,6 +477,160 @@ protected:
 	///		Array of 15-digit integers representing the floating point number.
 	///	</summary>
 	int64_t m_vecDigits[Digits];
+
+	friend class FixedPointFilter;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		A floating point approximation of a FixedPoint expression together
+///		with a bound on its absolute error.  The sign of the exact expression
+///		is known whenever the magnitude of the approximation exceeds the
+///		error bound.
+///	</summary>
+class FixedPointFilter {
+
+public:
+	///	<summary>
+	///		Bound on the absolute error of FixedPoint::Set, which truncates
+	///		its argument to 16 decimal digits.
+	///	</summary>
+	static double SetError() {
+		return 4.0e-16;
+	}
+
+	///	<summary>
+	///		Bound on the relative error of the conversion of a FixedPoint.
+	///	</summary>
+	static double ConversionError() {
+		return (4.0 * static_cast<double>(FixedPoint::Digits) * DBL_EPSILON);
+	}
+
+public:
+	///	<summary>
+	///		Default constructor.
+	///	</summary>
+	FixedPointFilter() :
+		m_dValue(0.0),
+		m_dError(0.0)
+	{ }
+
+	///	<summary>
+	///		Constructor from an approximation and error bound.
+	///	</summary>
+	FixedPointFilter(
+		double dValue,
+		double dError
+	) :
+		m_dValue(dValue),
+		m_dError(dError)
+	{ }
+
+	///	<summary>
+	///		Constructor from a FixedPoint.
+	///	</summary>
+	explicit FixedPointFilter(const FixedPoint & fp) {
+		const double dBase = static_cast<double>(FixedPoint::MaximumDigit);
+
+		// Scale of the most significant digit
+		double dScale = 1.0;
+		for (int i = fp.m_iDecimal; i < FixedPoint::Digits-1; i++) {
+			dScale *= dBase;
+		}
+		for (int i = FixedPoint::Digits-1; i < fp.m_iDecimal; i++) {
+			dScale /= dBase;
+		}
+
+		// Sum digits from most to least significant
+		m_dValue = 0.0;
+		for (int i = FixedPoint::Digits-1; i >= 0; i--) {
+			m_dValue += static_cast<double>(fp.m_vecDigits[i]) * dScale;
+			dScale /= dBase;
+		}
+		if (fp.m_iSign < 0) {
+			m_dValue = - m_dValue;
+		}
+
+		m_dError = fabs(m_dValue) * ConversionError();
+	}
+
+	///	<summary>
+	///		Approximation of the FixedPoint obtained from FixedPoint::Set(d).
+	///	</summary>
+	static FixedPointFilter FromSet(double d) {
+		if (fabs(d) > 1.0) {
+			_EXCEPTIONT("FixedPoint cannot be set by value larger than 1");
+		}
+		return FixedPointFilter(d, (d == 0.0)?(0.0):(SetError()));
+	}
+
+public:
+	///	<summary>
+	///		Sum operator.
+	///	</summary>
+	inline FixedPointFilter operator+(const FixedPointFilter & fpf) const {
+		double dValue = m_dValue + fpf.m_dValue;
+		return FixedPointFilter(dValue,
+			(m_dError + fpf.m_dError + fabs(dValue) * DBL_EPSILON)
+			* (1.0 + 4.0 * DBL_EPSILON));
+	}
+
+	///	<summary>
+	///		Difference operator.
+	///	</summary>
+	inline FixedPointFilter operator-(const FixedPointFilter & fpf) const {
+		double dValue = m_dValue - fpf.m_dValue;
+		return FixedPointFilter(dValue,
+			(m_dError + fpf.m_dError + fabs(dValue) * DBL_EPSILON)
+			* (1.0 + 4.0 * DBL_EPSILON));
+	}
+
+	///	<summary>
+	///		Product operator.
+	///	</summary>
+	inline FixedPointFilter operator*(const FixedPointFilter & fpf) const {
+		double dValue = m_dValue * fpf.m_dValue;
+		return FixedPointFilter(dValue,
+			(fabs(m_dValue) * fpf.m_dError
+			 + fabs(fpf.m_dValue) * m_dError
+			 + m_dError * fpf.m_dError
+			 + fabs(dValue) * DBL_EPSILON)
+			* (1.0 + 4.0 * DBL_EPSILON));
+	}
+
+public:
+	///	<summary>
+	///		Returns true if the exact value is known to be positive.
+	///	</summary>
+	bool IsPositive() const {
+		return (m_dValue > m_dError);
+	}
+
+	///	<summary>
+	///		Returns true if the exact value is known to be negative.
+	///	</summary>
+	bool IsNegative() const {
+		return (m_dValue < -m_dError);
+	}
+
+	///	<summary>
+	///		Returns true if the exact value is known to be zero.
+	///	</summary>
+	bool IsZero() const {
+		return ((m_dValue == 0.0) && (m_dError == 0.0));
+	}
+
+protected:
+	///	<summary>
+	///		Floating point approximation.
+	///	</summary>
+	double m_dValue;
+
+	///	<summary>
+	///		Bound on the absolute error of the approximation.
+	///	</summary>
+	double m_dError;
 };
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -19,6 +19,9 @@
 #include "LegendrePolynomial.h"
 
 #include "Exception.h"
+#include "KeyedCache.h"
+
+#include <tuple>
 
 ///////////////////////////////////////////////////////////////////////////////
 
@@ -222,3 +225,25 @@ void GaussLobattoQuadrature::GetPoints(
 
 ///////////////////////////////////////////////////////////////////////////////
 
+const GaussLobattoQuadrature::Points & GaussLobattoQuadrature::GetCachedPoints(
+	int nCount,
+	double dXi0,
+	double dXi1
+) {
+	static KeyedCache<std::tuple<int, double, double>, Points> s_cache;
+
+	return s_cache.Get(
+		std::make_tuple(nCount, dXi0, dXi1),
+		[&]() -> Points {
+			Points points;
+			if ((dXi0 == -1.0) && (dXi1 == 1.0)) {
+				GetPoints(nCount, points.dG, points.dW);
+			} else {
+				GetPoints(nCount, dXi0, dXi1, points.dG, points.dW);
+			}
+			return points;
+		});
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
@@ -48,6 +48,27 @@ public:
 		DataArray1D<double> & dG,
 		DataArray1D<double> & dW
 	);
+public:
+	///	<summary>
+	///		Quadrature points and their corresponding weights.
+	///	</summary>
+	struct Points {
+		DataArray1D<double> dG;
+		DataArray1D<double> dW;
+	};
+
+	///	<summary>
+	///		Return the Gauss-Lobatto quadrature points and their corresponding
+	///		weights for the given number of points and reference element
+	///		from a process-wide cache.  The returned Points are computed on
+	///		first use and remain valid for the lifetime of the program.
+	///		This function may be called concurrently from multiple threads.
+	///	</summary>
+	static const Points & GetCachedPoints(
+		int nCount,
+		double dXi0 = -1.0,
+		double dXi1 = 1.0
+	);
 };
 
 ///////////////////////////////////////////////////////////////////////////////
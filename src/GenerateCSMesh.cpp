@@ -27,15 +27,52 @@
 
 ///////////////////////////////////////////////////////////////////////////////
 
-int InsertCSSubNode(
-	int ix0,
-	int ix1,
-	Real alpha,
-	NodeVector & nodes
+///	<summary>
+///		Number of nodes in a cubed sphere mesh with the given resolution:
+///		8 corners, nResolution-1 nodes along each of the 12 cube edges and
+///		(nResolution-1)^2 interior nodes on each of the 6 panels.
+///	</summary>
+inline int CSMeshNodeCount(
+	int nResolution
+) {
+	return 6 * nResolution * nResolution + 2;
+}
+
+///	<summary>
+///		Number of faces in a cubed sphere mesh with the given resolution.
+///	</summary>
+inline int CSMeshFaceCount(
+	int nResolution
+) {
+	return 6 * nResolution * nResolution;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Equiangular position of the i-th of nResolution subintervals along
+///		a cube edge, as a fraction of the Cartesian edge length.
+///	</summary>
+inline Real CSEdgeAlpha(
+	int i,
+	int nResolution
+) {
+	Real alpha =
+		static_cast<Real>(i) / static_cast<Real>(nResolution);
+
+	return 0.5 * (tan(0.25 * M_PI * (2.0 * alpha - 1.0)) + 1.0);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+Node CSSubNode(
+	const Node & node0,
+	const Node & node1,
+	Real alpha
 ) {
-	Real dX = nodes[ix0].x + (nodes[ix1].x - nodes[ix0].x) * alpha;
-	Real dY = nodes[ix0].y + (nodes[ix1].y - nodes[ix0].y) * alpha;
-	Real dZ = nodes[ix0].z + (nodes[ix1].z - nodes[ix0].z) * alpha;
+	Real dX = node0.x + (node1.x - node0.x) * alpha;
+	Real dY = node0.y + (node1.y - node0.y) * alpha;
+	Real dZ = node0.z + (node1.z - node0.z) * alpha;
 
 	// Project to sphere
 	Real dRadius = sqrt(dX*dX + dY*dY + dZ*dZ);
@@ -44,48 +81,76 @@ int InsertCSSubNode(
 	dY /= dRadius;
 	dZ /= dRadius;
 
-	// Index
-	int ix = nodes.size();
-
-	// Insert node
-	nodes.push_back(Node(dX, dY, dZ));
-
-	return ix;
+	return Node(dX, dY, dZ);
 }
 
 ///////////////////////////////////////////////////////////////////////////////
 
+///	<summary>
+///		Generate the nResolution-1 nodes along the edge from node ix0 to
+///		node ix1, storing them in nodes starting at index ixFirst.
+///	</summary>
 void GenerateCSMultiEdgeVertices(
-	int nRefineLevel,
+	int nResolution,
 	int ix0,
 	int ix1,
+	int ixFirst,
 	NodeVector & nodes,
 	MultiEdge & edge
 ) {
-	edge.clear();
-	edge.push_back(ix0);
+	edge.resize(nResolution+1);
+	edge[0] = ix0;
 
-	int i;
-	for (i = 1; i < nRefineLevel; i++) {
+	for (int i = 1; i < nResolution; i++) {
+		nodes[ixFirst+i-1] =
+			CSSubNode(nodes[ix0], nodes[ix1], CSEdgeAlpha(i, nResolution));
 
-		// Nodes along line in Cartesian geometry
-		Real alpha =
-			static_cast<Real>(i) / static_cast<Real>(nRefineLevel);
+		edge[i] = ixFirst+i-1;
+	}
 
-		alpha = 0.5 * (tan(0.25 * M_PI * (2.0 * alpha - 1.0)) + 1.0);
+	edge[nResolution] = ix1;
+}
 
-		// Insert node along edge
-		int ixNode = InsertCSSubNode(ix0, ix1, alpha, nodes);
+///////////////////////////////////////////////////////////////////////////////
 
-		// Add node to edge
-		edge.push_back(ixNode);
+///	<summary>
+///		Index of the node in row j and column i of a panel, where rows 0
+///		and nResolution are edge0 and edge3, and interior rows span edge1
+///		to edge2 with interior nodes stored row by row from ixFirstNode.
+///	</summary>
+inline int CSPanelNodeIndex(
+	int nResolution,
+	int j,
+	int i,
+	const MultiEdge & edge0,
+	const MultiEdge & edge1,
+	const MultiEdge & edge2,
+	const MultiEdge & edge3,
+	int ixFirstNode
+) {
+	if (j == 0) {
+		return edge0[i];
 	}
-
-	edge.push_back(ix1);
+	if (j == nResolution) {
+		return edge3[i];
+	}
+	if (i == 0) {
+		return edge1[j];
+	}
+	if (i == nResolution) {
+		return edge2[j];
+	}
+	return ixFirstNode + (j-1) * (nResolution-1) + (i-1);
 }
 
 ///////////////////////////////////////////////////////////////////////////////
 
+///	<summary>
+///		Generate the interior nodes and the faces of one panel, storing the
+///		(nResolution-1)^2 interior nodes from index ixFirstNode and the
+///		nResolution^2 faces from index ixFirstFace.  Rows of the panel are
+///		independent and are generated in parallel.
+///	</summary>
 void GenerateFacesFromQuad(
 	int nResolution,
 	int iPanel,
@@ -93,48 +158,52 @@ void GenerateFacesFromQuad(
 	const MultiEdge & edge1,
 	const MultiEdge & edge2,
 	const MultiEdge & edge3,
+	int ixFirstNode,
+	int ixFirstFace,
 	NodeVector & nodes,
-	FaceVector & vecFaces
+	FaceVector & vecFaces,
+	int nThreads
 ) {
-	MultiEdge edgeTop;
-	MultiEdge edgeBot = edge0;
+	// Generate interior nodes along each row
+#pragma omp parallel for num_threads(nThreads)
+	for (int j = 1; j < nResolution; j++) {
+		const Node & node0 = nodes[edge1[j]];
+		const Node & node1 = nodes[edge2[j]];
 
-	for (int j = 0; j < nResolution; j++) {
+		const int ixRow = ixFirstNode + (j-1) * (nResolution-1);
 
-		// Generate top level edge
-		if (j != nResolution-1) {
-			int ix0 = edge1[j+1];
-			int ix1 = edge2[j+1];
-
-			GenerateCSMultiEdgeVertices(nResolution, ix0, ix1, nodes, edgeTop);
-
-		} else {
-			edgeTop = edge3;
+		for (int i = 1; i < nResolution; i++) {
+			nodes[ixRow+i-1] =
+				CSSubNode(node0, node1, CSEdgeAlpha(i, nResolution));
 		}
+	}
 
-		// Generate face
+	// Generate faces
+#pragma omp parallel for num_threads(nThreads)
+	for (int j = 0; j < nResolution; j++) {
 		for (int i = 0; i < nResolution; i++) {
-			Face face(4);
-			face.SetNode(0, edgeBot[i+1]);
-			face.SetNode(1, edgeTop[i+1]);
-			face.SetNode(2, edgeTop[i]);
-			face.SetNode(3, edgeBot[i]);
-
-			vecFaces.push_back(face);
+			Face & face = vecFaces[ixFirstFace + j * nResolution + i];
+			face.edges.resize(4);
+
+			face.SetNode(0, CSPanelNodeIndex(nResolution, j, i+1,
+				edge0, edge1, edge2, edge3, ixFirstNode));
+			face.SetNode(1, CSPanelNodeIndex(nResolution, j+1, i+1,
+				edge0, edge1, edge2, edge3, ixFirstNode));
+			face.SetNode(2, CSPanelNodeIndex(nResolution, j+1, i,
+				edge0, edge1, edge2, edge3, ixFirstNode));
+			face.SetNode(3, CSPanelNodeIndex(nResolution, j, i,
+				edge0, edge1, edge2, edge3, ixFirstNode));
 		}
-
-		// Increment row
-		edgeBot = edgeTop;
 	}
 }
 
-
 ///////////////////////////////////////////////////////////////////////////////
 // 
 // Input Parameters:
 // Number of elements in mesh: int nResolution;
 // Alternate arrangement: bool fAlt;
 // Output filename:  std::string strOutputFile;
+// Number of threads: int nThreads;
 // 
 // Output Parameters: Mesh*
 // 
@@ -144,7 +213,8 @@ int GenerateCSMesh(
 	int nResolution,
 	bool fAlt,
 	std::string strOutputFile,
-	std::string strOutputFormat
+	std::string strOutputFormat,
+	int nThreads
 ) {
 
 	NcError error(NcError::silent_nonfatal);
@@ -172,36 +242,60 @@ try {
 	FaceVector & faces = mesh.faces;
     mesh.type = Mesh::MeshType_CubedSphere;
 
+	if (nResolution < 1) {
+		_EXCEPTION1("Invalid \"res\" value (%i), expected a positive integer",
+			nResolution);
+	}
+	if (nThreads < 1) {
+		_EXCEPTIONT("Number of threads must be at least 1");
+	}
+
+	// All nodes and faces are stored in precomputed index ranges: cube
+	// corners, then the nodes along each cube edge, then the interior nodes
+	// of each panel in the order panels are generated.
+	nodes.clear();
+	nodes.resize(CSMeshNodeCount(nResolution));
+
+	faces.clear();
+	faces.resize(CSMeshFaceCount(nResolution));
+
+	const int nEdgeNodes = nResolution - 1;
+	const int nPanelNodes = (nResolution - 1) * (nResolution - 1);
+	const int nPanelFaces = nResolution * nResolution;
+
+	const int ixFirstEdgeNode = 8;
+	const int ixFirstPanelNode = ixFirstEdgeNode + 12 * nEdgeNodes;
+
 	// Generate corner points
 	Real dInvDeltaX = 1.0 / sqrt(3.0);
 
-	nodes.push_back(Node(+dInvDeltaX, -dInvDeltaX, -dInvDeltaX));
-	nodes.push_back(Node(+dInvDeltaX, +dInvDeltaX, -dInvDeltaX));
-	nodes.push_back(Node(-dInvDeltaX, +dInvDeltaX, -dInvDeltaX));
-	nodes.push_back(Node(-dInvDeltaX, -dInvDeltaX, -dInvDeltaX));
-	nodes.push_back(Node(+dInvDeltaX, -dInvDeltaX, +dInvDeltaX));
-	nodes.push_back(Node(+dInvDeltaX, +dInvDeltaX, +dInvDeltaX));
-	nodes.push_back(Node(-dInvDeltaX, +dInvDeltaX, +dInvDeltaX));
-	nodes.push_back(Node(-dInvDeltaX, -dInvDeltaX, +dInvDeltaX));
+	nodes[0] = Node(+dInvDeltaX, -dInvDeltaX, -dInvDeltaX);
+	nodes[1] = Node(+dInvDeltaX, +dInvDeltaX, -dInvDeltaX);
+	nodes[2] = Node(-dInvDeltaX, +dInvDeltaX, -dInvDeltaX);
+	nodes[3] = Node(-dInvDeltaX, -dInvDeltaX, -dInvDeltaX);
+	nodes[4] = Node(+dInvDeltaX, -dInvDeltaX, +dInvDeltaX);
+	nodes[5] = Node(+dInvDeltaX, +dInvDeltaX, +dInvDeltaX);
+	nodes[6] = Node(-dInvDeltaX, +dInvDeltaX, +dInvDeltaX);
+	nodes[7] = Node(-dInvDeltaX, -dInvDeltaX, +dInvDeltaX);
 
 	// Generate edges
+	static const int CubeEdgeCorners[12][2] = {
+		{0, 1}, {1, 2}, {2, 3}, {3, 0},
+		{0, 4}, {1, 5}, {2, 6}, {3, 7},
+		{4, 5}, {5, 6}, {6, 7}, {7, 4}};
+
 	MultiEdgeVector vecMultiEdges;
 	vecMultiEdges.resize(12);
 
-	GenerateCSMultiEdgeVertices(nResolution, 0, 1, nodes, vecMultiEdges[0]);
-	GenerateCSMultiEdgeVertices(nResolution, 1, 2, nodes, vecMultiEdges[1]);
-	GenerateCSMultiEdgeVertices(nResolution, 2, 3, nodes, vecMultiEdges[2]);
-	GenerateCSMultiEdgeVertices(nResolution, 3, 0, nodes, vecMultiEdges[3]);
-
-	GenerateCSMultiEdgeVertices(nResolution, 0, 4, nodes, vecMultiEdges[4]);
-	GenerateCSMultiEdgeVertices(nResolution, 1, 5, nodes, vecMultiEdges[5]);
-	GenerateCSMultiEdgeVertices(nResolution, 2, 6, nodes, vecMultiEdges[6]);
-	GenerateCSMultiEdgeVertices(nResolution, 3, 7, nodes, vecMultiEdges[7]);
-
-	GenerateCSMultiEdgeVertices(nResolution, 4, 5, nodes, vecMultiEdges[8]);
-	GenerateCSMultiEdgeVertices(nResolution, 5, 6, nodes, vecMultiEdges[9]);
-	GenerateCSMultiEdgeVertices(nResolution, 6, 7, nodes, vecMultiEdges[10]);
-	GenerateCSMultiEdgeVertices(nResolution, 7, 4, nodes, vecMultiEdges[11]);
+	for (int e = 0; e < 12; e++) {
+		GenerateCSMultiEdgeVertices(
+			nResolution,
+			CubeEdgeCorners[e][0],
+			CubeEdgeCorners[e][1],
+			ixFirstEdgeNode + e * nEdgeNodes,
+			nodes,
+			vecMultiEdges[e]);
+	}
 
 	// Generate equatorial faces
 	GenerateFacesFromQuad(
@@ -211,8 +305,11 @@ try {
 		vecMultiEdges[4],
 		vecMultiEdges[5],
 		vecMultiEdges[8],
+		ixFirstPanelNode,
+		0,
 		nodes,
-		faces);
+		faces,
+		nThreads);
 
 	GenerateFacesFromQuad(
 		nResolution,
@@ -221,8 +318,11 @@ try {
 		vecMultiEdges[5],
 		vecMultiEdges[6],
 		vecMultiEdges[9],
+		ixFirstPanelNode + nPanelNodes,
+		nPanelFaces,
 		nodes,
-		faces);
+		faces,
+		nThreads);
 
 	GenerateFacesFromQuad(
 		nResolution,
@@ -231,8 +331,11 @@ try {
 		vecMultiEdges[6],
 		vecMultiEdges[7],
 		vecMultiEdges[10],
+		ixFirstPanelNode + 2 * nPanelNodes,
+		2 * nPanelFaces,
 		nodes,
-		faces);
+		faces,
+		nThreads);
 
 	GenerateFacesFromQuad(
 		nResolution,
@@ -241,8 +344,11 @@ try {
 		vecMultiEdges[7],
 		vecMultiEdges[4],
 		vecMultiEdges[11],
+		ixFirstPanelNode + 3 * nPanelNodes,
+		3 * nPanelFaces,
 		nodes,
-		faces);
+		faces,
+		nThreads);
 
 	// Generate south polar face
 	GenerateFacesFromQuad(
@@ -252,8 +358,11 @@ try {
 		vecMultiEdges[3],
 		vecMultiEdges[1].Flip(),
 		vecMultiEdges[0],
+		ixFirstPanelNode + 4 * nPanelNodes,
+		4 * nPanelFaces,
 		nodes,
-		faces);
+		faces,
+		nThreads);
 
 	// Generate north polar face
 	GenerateFacesFromQuad(
@@ -263,11 +372,15 @@ try {
 		vecMultiEdges[11].Flip(),
 		vecMultiEdges[9],
 		vecMultiEdges[10].Flip(),
+		ixFirstPanelNode + 5 * nPanelNodes,
+		5 * nPanelFaces,
 		nodes,
-		faces);
+		faces,
+		nThreads);
 
 	// Alternative arrangement of nodes on Faces
 	if (fAlt) {
+#pragma omp parallel for num_threads(nThreads)
 		for (int i = 0; i < faces.size(); i++) {
 			int ix[4];
 			for (int j = 0; j < 4; j++) {
@@ -286,7 +399,7 @@ try {
 		std::cout << "..Writing mesh to file [" << strOutputFile.c_str() << "] ";
 		std::cout << std::endl;
 
-		mesh.Write(strOutputFile, eOutputFormat);
+		mesh.Write(strOutputFile, eOutputFormat, 0, nThreads);
 	}
 
 	// Announce
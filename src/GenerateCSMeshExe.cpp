@@ -40,19 +40,23 @@ int main(int argc, char** argv) {
 	// NetCDF format
 	std::string strOutputFormat;
 
+	// Number of threads used to generate the mesh
+	int nThreads;
+
 	// Parse the command line
 	BeginCommandLine()
 		CommandLineInt(nResolution, "res", 10);
 		CommandLineBool(fAlt, "alt");
 		CommandLineString(strOutputFile, "file", "outCSMesh.g");
 		CommandLineString(strOutputFormat, "out_format", "Netcdf4");
+		CommandLineInt(nThreads, "nthreads", 1);
 
 		ParseCommandLine(argc, argv);
 	EndCommandLine(argv)
 
 	// Call the actual mesh generator
     Mesh mesh;
-	int err = GenerateCSMesh(mesh, nResolution, fAlt, strOutputFile, strOutputFormat);
+	int err = GenerateCSMesh(mesh, nResolution, fAlt, strOutputFile, strOutputFormat, nThreads);
 	if (err) exit(err);
 	else return 0;
 }
@@ -0,0 +1,182 @@
+///////////////////////////////////////////////////////////////////////////////
+///
+///	\file    GenerateComposedMap.cpp
+///	\author  agent
+///	\version October 14, 2026
+///
+///	<remarks>
+///		Copyright 2026 agent
+///
+///		This file is distributed as part of the Tempest source code package.
+///		Permission is granted to use, copy, modify and distribute this
+///		source code and its documentation under the terms of the GNU General
+///		Public License.  This software is provided "as is" without express
+///		or implied warranty.
+///	</remarks>
+
+#include "CommandLine.h"
+#include "Announce.h"
+#include "OfflineMap.h"
+
+#include "netcdfcpp.h"
+
+#include <iostream>
+
+///////////////////////////////////////////////////////////////////////////////
+
+typedef std::map<std::string, std::string> AttributeMap;
+typedef AttributeMap::value_type AttributePair;
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Replace all attributes of mapAttributes with names ending in one of
+///		the given extensions by the corresponding attributes of
+///		mapAttributesTarget.
+///	</summary>
+void CopyTargetAttributes(
+	AttributeMap & mapAttributes,
+	const AttributeMap & mapAttributesTarget,
+	const std::string & strExtDst,
+	const std::string & strExtB
+) {
+	AttributeMap::const_iterator iterAtt = mapAttributesTarget.begin();
+	for (; iterAtt != mapAttributesTarget.end(); iterAtt++) {
+		const std::string & strName = iterAtt->first;
+
+		bool fTarget = false;
+		if ((strName.length() > strExtDst.length()) &&
+		    (strName.substr(strName.length()-strExtDst.length()) == strExtDst)
+		) {
+			fTarget = true;
+		}
+		if ((strName.length() > strExtB.length()) &&
+		    (strName.substr(strName.length()-strExtB.length()) == strExtB)
+		) {
+			fTarget = true;
+		}
+
+		if (fTarget) {
+			mapAttributes[strName] = iterAtt->second;
+		}
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+int main(int argc, char** argv) {
+
+	NcError error(NcError::silent_nonfatal);
+
+try {
+	// First map file (source mesh to intermediate mesh)
+	std::string strInputMapFile1;
+
+	// Second map file (intermediate mesh to target mesh)
+	std::string strInputMapFile2;
+
+	// Map file for output
+	std::string strOutputMapFile;
+
+	// Do not verify the mesh
+	bool fNoCheck;
+
+	// Check monotonicity
+	bool fCheckMonotone;
+
+	// Number of threads used to compute the composed map
+	int nThreads;
+
+	// Parse the command line
+	BeginCommandLine()
+		CommandLineString(strInputMapFile1, "map1", "");
+		CommandLineString(strInputMapFile2, "map2", "");
+		CommandLineString(strOutputMapFile, "out", "");
+		CommandLineBool(fNoCheck, "nocheck");
+		CommandLineBool(fCheckMonotone, "checkmono");
+		CommandLineInt(nThreads, "nthreads", 1);
+
+		ParseCommandLine(argc, argv);
+	EndCommandLine(argv)
+
+	// Check arguments
+	if (strInputMapFile1 == "") {
+		_EXCEPTIONT("First input map file (--map1) must be specified");
+	}
+	if (strInputMapFile2 == "") {
+		_EXCEPTIONT("Second input map file (--map2) must be specified");
+	}
+	if (strOutputMapFile == "") {
+		_EXCEPTIONT("Output map file (--out) must be specified");
+	}
+	if (nThreads < 1) {
+		_EXCEPTIONT("--nthreads must be at least 1");
+	}
+
+	// Atribute maps
+	AttributeMap mapAttributes;
+	AttributeMap mapAttributes2;
+
+	// Load maps from file
+	AnnounceStartBlock("Loading first input map");
+	OfflineMap mapIn1;
+	NcFile::FileFormat eFileFormat;
+	mapIn1.Read(strInputMapFile1, &mapAttributes, &eFileFormat);
+	AnnounceEndBlock("Done");
+
+	AnnounceStartBlock("Loading second input map");
+	OfflineMap mapIn2;
+	mapIn2.Read(strInputMapFile2, &mapAttributes2);
+	AnnounceEndBlock("Done");
+
+	// Generate composed map
+	AnnounceStartBlock("Generating composed map");
+	OfflineMap mapOut;
+	mapOut.SetComposition(mapIn1, mapIn2, nThreads);
+	Announce("Composed map has %lu nonzero entries",
+		mapOut.GetSparseMatrix().GetNonZeroCount());
+	AnnounceEndBlock("Done");
+
+	// Verify map
+	if (!fNoCheck) {
+		AnnounceStartBlock("Verifying map");
+		mapOut.SetThreadCount(nThreads);
+		mapOut.Verify(1.0e-8, 1.0e-8, fCheckMonotone, 1.0e-12);
+		AnnounceEndBlock("Done");
+	}
+
+	// Target attributes are taken from the second map
+	CopyTargetAttributes(mapAttributes, mapAttributes2, "_dst", "_b");
+
+	mapAttributes.erase("Title");
+	mapAttributes["composed_from"] =
+		strInputMapFile1 + " :: " + strInputMapFile2;
+
+	// Find version name
+	AttributeMap::iterator iterVersion = mapAttributes.find("version");
+	if (iterVersion == mapAttributes.end()) {
+		mapAttributes.insert(
+			AttributePair("version", "GenerateComposedMap 1.0 : 2026-10-14"));
+	} else {
+		iterVersion->second =
+			"GenerateComposedMap 1.0 : 2026-10-14 :: " + iterVersion->second;
+	}
+
+	// Write map to file
+	AnnounceStartBlock("Writing composed map");
+	mapOut.Write(strOutputMapFile, mapAttributes, eFileFormat);
+	AnnounceEndBlock("Done");
+
+	return (0);
+
+} catch(Exception & e) {
+	Announce(e.ToString().c_str());
+	return (-1);
+
+} catch(...) {
+	return (-2);
+}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
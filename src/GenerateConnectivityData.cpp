@@ -2,6 +2,7 @@
 #include "Exception.h"
 #include "Announce.h"
 
+#include <algorithm>
 #include <vector>
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -36,3 +37,301 @@ extern "C" int GenerateConnectivityData(Mesh& meshIn, std::vector< std::set<int>
 
     return 0;
 }
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Sort each row of a compressed row array, remove duplicate entries
+///		and compact the array.
+///	</summary>
+static void SortAndCompactRows(
+	std::vector<int> & vecRowPtr,
+	std::vector<int> & vecNeighbors,
+	int nThreads
+) {
+	const int nRows = static_cast<int>(vecRowPtr.size()) - 1;
+
+	std::vector<int> vecRowCount(nRows + 1, 0);
+
+#pragma omp parallel for schedule(dynamic, 1024) num_threads(nThreads)
+	for (int i = 0; i < nRows; i++) {
+		std::vector<int>::iterator iterBegin =
+			vecNeighbors.begin() + vecRowPtr[i];
+		std::vector<int>::iterator iterEnd =
+			vecNeighbors.begin() + vecRowPtr[i+1];
+
+		std::sort(iterBegin, iterEnd);
+		vecRowCount[i+1] =
+			static_cast<int>(std::unique(iterBegin, iterEnd) - iterBegin);
+	}
+
+	for (int i = 0; i < nRows; i++) {
+		vecRowCount[i+1] += vecRowCount[i];
+	}
+
+	if (vecRowCount[nRows] == vecRowPtr[nRows]) {
+		return;
+	}
+
+	std::vector<int> vecCompact(vecRowCount[nRows]);
+
+#pragma omp parallel for schedule(dynamic, 1024) num_threads(nThreads)
+	for (int i = 0; i < nRows; i++) {
+		std::copy(
+			vecNeighbors.begin() + vecRowPtr[i],
+			vecNeighbors.begin() + vecRowPtr[i]
+				+ (vecRowCount[i+1] - vecRowCount[i]),
+			vecCompact.begin() + vecRowCount[i]);
+	}
+
+	vecRowPtr.swap(vecRowCount);
+	vecNeighbors.swap(vecCompact);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Face adjacency across edges, from the list of mesh edges sorted by
+///		node index.  Faces whose edges have the same pair of end nodes are
+///		neighbors.
+///	</summary>
+static void GenerateEdgeConnectivityCSR(
+	const Mesh & meshIn,
+	std::vector<int> & vecRowPtr,
+	std::vector<int> & vecNeighbors,
+	int nThreads
+) {
+	const int nElements = static_cast<int>(meshIn.faces.size());
+	const int nNodes = static_cast<int>(meshIn.nodes.size());
+
+	// Count the edges with the smallest node index at each node
+	std::vector<int> vecNodeBegin(nNodes + 1, 0);
+
+	for (int f = 0; f < nElements; f++) {
+		const Face & face = meshIn.faces[f];
+		for (int k = 0; k < face.edges.size(); k++) {
+			int ixNode0 = face.edges[k][0];
+			int ixNode1 = face.edges[k][1];
+			if (ixNode0 == ixNode1) {
+				continue;
+			}
+			if ((ixNode0 < 0) || (ixNode0 >= nNodes) ||
+				(ixNode1 < 0) || (ixNode1 >= nNodes)
+			) {
+				_EXCEPTION2("Node index (%i) out of range in face %i",
+					((ixNode0 < 0) || (ixNode0 >= nNodes))?(ixNode0):(ixNode1), f);
+			}
+			vecNodeBegin[std::min(ixNode0, ixNode1)+1]++;
+		}
+	}
+
+	for (int i = 0; i < nNodes; i++) {
+		vecNodeBegin[i+1] += vecNodeBegin[i];
+	}
+
+	// Bucket edges by their smallest node index, storing the other node
+	// index and the face index, with faces in ascending order
+	const int nEdges = vecNodeBegin[nNodes];
+
+	std::vector< std::pair<int,int> > vecEdges(nEdges);
+	{
+		std::vector<int> vecNext(vecNodeBegin.begin(), vecNodeBegin.end() - 1);
+
+		for (int f = 0; f < nElements; f++) {
+			const Face & face = meshIn.faces[f];
+			for (int k = 0; k < face.edges.size(); k++) {
+				int ixNode0 = face.edges[k][0];
+				int ixNode1 = face.edges[k][1];
+				if (ixNode0 == ixNode1) {
+					continue;
+				}
+				if (ixNode0 > ixNode1) {
+					std::swap(ixNode0, ixNode1);
+				}
+				vecEdges[vecNext[ixNode0]++] = std::pair<int,int>(ixNode1, f);
+			}
+		}
+	}
+
+	// Sort each bucket by the other node index, so that faces sharing an
+	// edge are adjacent, and count the neighbors of each face
+	std::vector<int> vecFaceCount(nElements + 1, 0);
+
+#pragma omp parallel for schedule(dynamic, 1024) num_threads(nThreads)
+	for (int i = 0; i < nNodes; i++) {
+		std::sort(
+			vecEdges.begin() + vecNodeBegin[i],
+			vecEdges.begin() + vecNodeBegin[i+1]);
+
+		for (int j = vecNodeBegin[i]; j < vecNodeBegin[i+1]; ) {
+			int jEnd = j + 1;
+			while ((jEnd < vecNodeBegin[i+1]) &&
+			       (vecEdges[jEnd].first == vecEdges[j].first)
+			) {
+				jEnd++;
+			}
+			for (int m = j; m < jEnd; m++) {
+				const int ixFace = vecEdges[m].second;
+
+				int nCount = 0;
+				for (int n = j; n < jEnd; n++) {
+					if (vecEdges[n].second != ixFace) {
+						nCount++;
+					}
+				}
+				if (nCount != 0) {
+#pragma omp atomic
+					vecFaceCount[ixFace+1] += nCount;
+				}
+			}
+			j = jEnd;
+		}
+	}
+
+	for (int f = 0; f < nElements; f++) {
+		vecFaceCount[f+1] += vecFaceCount[f];
+	}
+
+	// Fill the neighbors of each face
+	vecNeighbors.resize(vecFaceCount[nElements]);
+	{
+		std::vector<int> vecNext(vecFaceCount.begin(), vecFaceCount.end() - 1);
+
+#pragma omp parallel for schedule(dynamic, 1024) num_threads(nThreads)
+		for (int i = 0; i < nNodes; i++) {
+			for (int j = vecNodeBegin[i]; j < vecNodeBegin[i+1]; ) {
+				int jEnd = j + 1;
+				while ((jEnd < vecNodeBegin[i+1]) &&
+				       (vecEdges[jEnd].first == vecEdges[j].first)
+				) {
+					jEnd++;
+				}
+				for (int m = j; m < jEnd; m++) {
+					const int ixFace = vecEdges[m].second;
+					for (int n = j; n < jEnd; n++) {
+						if (vecEdges[n].second == ixFace) {
+							continue;
+						}
+						int ix;
+#pragma omp atomic capture
+						ix = vecNext[ixFace]++;
+
+						vecNeighbors[ix] = vecEdges[n].second;
+					}
+				}
+				j = jEnd;
+			}
+		}
+	}
+
+	vecRowPtr.swap(vecFaceCount);
+
+	// Faces that share more than one edge are listed once
+	SortAndCompactRows(vecRowPtr, vecNeighbors, nThreads);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Face adjacency across nodes, from the reverse node array.
+///	</summary>
+static void GenerateNodeConnectivityCSR(
+	Mesh & meshIn,
+	std::vector<int> & vecRowPtr,
+	std::vector<int> & vecNeighbors,
+	int nThreads
+) {
+	const int nElements = static_cast<int>(meshIn.faces.size());
+
+	if (meshIn.revnodearray.size() != meshIn.nodes.size()) {
+		meshIn.ConstructReverseNodeArray(nThreads);
+	}
+
+	const ReverseNodeArray & revnodearray = meshIn.revnodearray;
+
+	// Count the faces sharing a node with each face
+	vecRowPtr.resize(nElements + 1);
+	vecRowPtr[0] = 0;
+
+#pragma omp parallel for schedule(dynamic, 1024) num_threads(nThreads)
+	for (int f = 0; f < nElements; f++) {
+		const Face & face = meshIn.faces[f];
+
+		int nCount = 0;
+		for (int k = 0; k < face.edges.size(); k++) {
+			nCount += static_cast<int>(revnodearray[face[k]].size());
+		}
+		vecRowPtr[f+1] = nCount;
+	}
+
+	for (int f = 0; f < nElements; f++) {
+		vecRowPtr[f+1] += vecRowPtr[f];
+	}
+
+	// Fill all faces sharing a node, excluding the face itself
+	vecNeighbors.resize(vecRowPtr[nElements]);
+
+#pragma omp parallel for schedule(dynamic, 1024) num_threads(nThreads)
+	for (int f = 0; f < nElements; f++) {
+		const Face & face = meshIn.faces[f];
+
+		int ix = vecRowPtr[f];
+		for (int k = 0; k < face.edges.size(); k++) {
+			ReverseNodeArray::FaceRange range = revnodearray[face[k]];
+			for (const int * p = range.begin(); p != range.end(); p++) {
+				vecNeighbors[ix++] = ((*p == f)?(-1):(*p));
+			}
+		}
+	}
+
+	SortAndCompactRows(vecRowPtr, vecNeighbors, nThreads);
+
+	// Remove the face itself, which sorts first in each row
+	std::vector<int> vecRowPtrNew(nElements + 1, 0);
+	for (int f = 0; f < nElements; f++) {
+		int nCount = vecRowPtr[f+1] - vecRowPtr[f];
+		if ((nCount != 0) && (vecNeighbors[vecRowPtr[f]] == (-1))) {
+			nCount--;
+		}
+		vecRowPtrNew[f+1] = vecRowPtrNew[f] + nCount;
+	}
+
+	std::vector<int> vecNeighborsNew(vecRowPtrNew[nElements]);
+
+#pragma omp parallel for schedule(dynamic, 1024) num_threads(nThreads)
+	for (int f = 0; f < nElements; f++) {
+		int nCount = vecRowPtrNew[f+1] - vecRowPtrNew[f];
+		std::copy(
+			vecNeighbors.begin() + vecRowPtr[f+1] - nCount,
+			vecNeighbors.begin() + vecRowPtr[f+1],
+			vecNeighborsNew.begin() + vecRowPtrNew[f]);
+	}
+
+	vecRowPtr.swap(vecRowPtrNew);
+	vecNeighbors.swap(vecNeighborsNew);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+extern "C" int GenerateConnectivityDataCSR(
+	Mesh & meshIn,
+	std::vector<int> & vecRowPtr,
+	std::vector<int> & vecNeighbors,
+	bool fNodeAdjacency,
+	int nThreads
+) {
+	if (nThreads < 1) {
+		_EXCEPTIONT("Thread count must be at least 1");
+	}
+
+	if (fNodeAdjacency) {
+		GenerateNodeConnectivityCSR(meshIn, vecRowPtr, vecNeighbors, nThreads);
+	} else {
+		GenerateEdgeConnectivityCSR(meshIn, vecRowPtr, vecNeighbors, nThreads);
+	}
+
+	return 0;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
@@ -20,16 +20,99 @@
 #include "GaussLobattoQuadrature.h"
 #include "Exception.h"
 #include "Announce.h"
+#include "TempestRemapAPI.h"
 
 #include "netcdfcpp.h"
 
 #include <cmath>
+#include <cstdio>
 #include <iostream>
+#include <vector>
 
 ///////////////////////////////////////////////////////////////////////////////
 
-extern "C"
-int GenerateConnectivityData(Mesh& meshIn, std::vector< std::set<int> >& vecConnectivity);
+///	<summary>
+///		Write the connectivity in METIS graph format: a header line with
+///		the number of faces and the number of undirected edges, followed by
+///		one line per face listing its one-based neighbors.
+///	</summary>
+static void WriteConnectivityMETIS(
+	const std::string & strOutputFile,
+	const std::vector<int> & vecRowPtr,
+	const std::vector<int> & vecNeighbors
+) {
+	const size_t nFaces = vecRowPtr.size() - 1;
+
+	FILE * fp = fopen(strOutputFile.c_str(), "w");
+	if (fp == NULL) {
+		_EXCEPTION1("Unable to open output file \"%s\"", strOutputFile.c_str());
+	}
+
+	fprintf(fp, "%lu %lu\n", nFaces, vecNeighbors.size() / 2);
+	for (size_t f = 0; f < nFaces; f++) {
+		for (int j = vecRowPtr[f]; j < vecRowPtr[f+1]; j++) {
+			fprintf(fp, (j == vecRowPtr[f])?("%i"):(" %i"), vecNeighbors[j] + 1);
+		}
+		fprintf(fp, "\n");
+	}
+	fclose(fp);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Write the connectivity in the KaHIP / ParHIP binary graph format.
+///		All values are unsigned 64-bit integers: the format version (3), the
+///		number of faces n and the number of directed edges m, followed by
+///		n+1 byte offsets from the start of the file to the neighbors of
+///		each face and the m zero-based neighbor indices.
+///	</summary>
+static void WriteConnectivityBinary(
+	const std::string & strOutputFile,
+	const std::vector<int> & vecRowPtr,
+	const std::vector<int> & vecNeighbors
+) {
+	typedef unsigned long long ULL;
+
+	const size_t nFaces = vecRowPtr.size() - 1;
+
+	FILE * fp = fopen(strOutputFile.c_str(), "wb");
+	if (fp == NULL) {
+		_EXCEPTION1("Unable to open output file \"%s\"", strOutputFile.c_str());
+	}
+
+	ULL header[3];
+	header[0] = 3;
+	header[1] = static_cast<ULL>(nFaces);
+	header[2] = static_cast<ULL>(vecNeighbors.size());
+
+	bool fSuccess = (fwrite(header, sizeof(ULL), 3, fp) == 3);
+
+	const ULL ullEdgeBegin = (3 + nFaces + 1) * sizeof(ULL);
+
+	std::vector<ULL> vecBuffer(nFaces + 1);
+	for (size_t f = 0; f <= nFaces; f++) {
+		vecBuffer[f] = ullEdgeBegin + static_cast<ULL>(vecRowPtr[f]) * sizeof(ULL);
+	}
+	fSuccess = fSuccess &&
+		(fwrite(&(vecBuffer[0]), sizeof(ULL), nFaces + 1, fp) == nFaces + 1);
+
+	vecBuffer.resize(vecNeighbors.size());
+	for (size_t j = 0; j < vecNeighbors.size(); j++) {
+		vecBuffer[j] = static_cast<ULL>(vecNeighbors[j]);
+	}
+	if (vecBuffer.size() != 0) {
+		fSuccess = fSuccess &&
+			(fwrite(&(vecBuffer[0]), sizeof(ULL), vecBuffer.size(), fp)
+				== vecBuffer.size());
+	}
+
+	if ((fclose(fp) != 0) || !fSuccess) {
+		_EXCEPTION1("Error writing output file \"%s\"", strOutputFile.c_str());
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
 
 int main(int argc, char** argv) {
 
@@ -42,6 +125,15 @@ try {
 	// Output mesh filename
 	std::string strOutputFile;
 
+	// Output format
+	std::string strOutputFormat;
+
+	// Adjacency type
+	std::string strAdjacency;
+
+	// Number of threads
+	int nThreads;
+
 	// Polynomial degree per element
 	int nP = 2;
 
@@ -49,6 +141,9 @@ try {
 	BeginCommandLine()
 		CommandLineString(strInputFile, "in", "");
 		CommandLineString(strOutputFile, "out", "");
+		CommandLineStringD(strOutputFormat, "out_format", "text", "[text|metis|binary]");
+		CommandLineStringD(strAdjacency, "adjacency", "edge", "[edge|node]");
+		CommandLineInt(nThreads, "nthreads", 1);
 		//CommandLineInt(nP, "np", 2);
 		//CommandLineBool(fCGLL, "cgll");
 
@@ -68,6 +163,18 @@ try {
 		std::cout << "ERROR: --np must be >= 2" << std::endl;
 		return (-1);
 	}
+	if ((strOutputFormat != "text") &&
+		(strOutputFormat != "metis") &&
+		(strOutputFormat != "binary")
+	) {
+		_EXCEPTIONT("--out_format must be \"text\", \"metis\" or \"binary\"");
+	}
+	if ((strAdjacency != "edge") && (strAdjacency != "node")) {
+		_EXCEPTIONT("--adjacency must be \"edge\" or \"node\"");
+	}
+	if (nThreads < 1) {
+		_EXCEPTIONT("--nthreads must be at least 1");
+	}
 
 	AnnounceBanner();
 
@@ -79,25 +186,38 @@ try {
 
 	AnnounceEndBlock("Done");
 
-	// Construct edge map
-	AnnounceStartBlock("Constructing edge map");
+	// Build connectivity from the sorted edge list or reverse node array
+	AnnounceStartBlock("Constructing connectivity");
 
-	meshIn.ConstructEdgeMap();
+	std::vector<int> vecRowPtr;
+	std::vector<int> vecNeighbors;
 
-	AnnounceEndBlock("Done");
+	int err = GenerateConnectivityDataCSR(
+		meshIn, vecRowPtr, vecNeighbors,
+		(strAdjacency == "node"), nThreads);
+	if (err) return err;
 
-	// Build connectivity vector using edge map
-	AnnounceStartBlock("Constructing connectivity");
-
-    std::vector< std::set<int> > vecConnectivity;
-    int err = GenerateConnectivityData(meshIn, vecConnectivity);
-    if (err) return err;
+	const size_t nFaces = vecRowPtr.size() - 1;
 
 	AnnounceEndBlock("Done");
 
 	// Open output file
 	AnnounceStartBlock("Writing connectivity file");
 
+	// Graph formats for partitioners
+	if (strOutputFormat == "metis") {
+		WriteConnectivityMETIS(strOutputFile, vecRowPtr, vecNeighbors);
+		AnnounceEndBlock("Done");
+		AnnounceBanner();
+		return (0);
+	}
+	if (strOutputFormat == "binary") {
+		WriteConnectivityBinary(strOutputFile, vecRowPtr, vecNeighbors);
+		AnnounceEndBlock("Done");
+		AnnounceBanner();
+		return (0);
+	}
+
 	NcFile ncmesh(strInputFile.c_str(), NcFile::ReadOnly);
 
 	NcVar * varLat = ncmesh.get_var("grid_center_lat");
@@ -115,16 +235,16 @@ try {
 	} else {
 		Announce("grid_center_lat found in file, loading values");
 
-		if (varLat->get_dim(0)->size() != vecConnectivity.size()) {
+		if (varLat->get_dim(0)->size() != nFaces) {
 			_EXCEPTIONT("grid_center_lat dimension mismatch");
 		}
-		if (varLon->get_dim(0)->size() != vecConnectivity.size()) {
+		if (varLon->get_dim(0)->size() != nFaces) {
 			_EXCEPTIONT("grid_center_lon dimension mismatch");
 		}
 
-		dAllLats.Allocate(vecConnectivity.size());
+		dAllLats.Allocate(nFaces);
 		varLat->set_cur((long)0);
-		varLat->get(dAllLats, vecConnectivity.size());
+		varLat->get(dAllLats, nFaces);
 
 		NcAtt * attLatUnits = varLat->get_att("units");
 		std::string strLatUnits = attLatUnits->as_string(0);
@@ -132,9 +252,9 @@ try {
 			fConvertLatToDegrees = false;
 		}
 
-		dAllLons.Allocate(vecConnectivity.size());
+		dAllLons.Allocate(nFaces);
 		varLon->set_cur((long)0);
-		varLon->get(dAllLons, vecConnectivity.size());
+		varLon->get(dAllLons, nFaces);
 
 		NcAtt * attLonUnits = varLon->get_att("units");
 		std::string strLonUnits = attLonUnits->as_string(0);
@@ -146,8 +266,8 @@ try {
 
 	// Write connectiivty file
 	FILE * fp = fopen(strOutputFile.c_str(), "w");
-	fprintf(fp, "%lu\n", vecConnectivity.size());
-	for (size_t f = 0; f < vecConnectivity.size(); f++) {
+	fprintf(fp, "%lu\n", nFaces);
+	for (size_t f = 0; f < nFaces; f++) {
 		double dLon;
 		double dLat;
 
@@ -185,13 +305,12 @@ try {
 
 		fprintf(fp, "%1.14f,", dLon);
 		fprintf(fp, "%1.14f,", dLat);
-		fprintf(fp, "%lu", vecConnectivity[f].size());
+		fprintf(fp, "%i", vecRowPtr[f+1] - vecRowPtr[f]);
 
-		std::set<int>::const_iterator iter = vecConnectivity[f].begin();
-		for (; iter != vecConnectivity[f].end(); iter++) {
-			fprintf(fp, ",%i", *iter);
+		for (int j = vecRowPtr[f]; j < vecRowPtr[f+1]; j++) {
+			fprintf(fp, ",%i", vecNeighbors[j] + 1);
 		}
-		if (f != vecConnectivity.size()-1) {
+		if (f != nFaces-1) {
 			fprintf(fp,"\n");
 		}
 	}
@@ -47,15 +47,38 @@ typedef std::vector<LonLatNode> LonLatNodeVector;
 
 ///////////////////////////////////////////////////////////////////////////////
 
-int InsertSubNode(
-	int ix0,
-	int ix1,
-	double alpha,
-	NodeVector & vecNodes
+///	<summary>
+///		Number of nodes in an icosahedral mesh with the given refinement
+///		level: 12 vertices, nRefineLevel-1 nodes along each of the 30
+///		icosahedron edges and (nRefineLevel-1)(nRefineLevel-2)/2 interior
+///		nodes on each of the 20 icosahedron faces.
+///	</summary>
+inline int ICOMeshNodeCount(
+	int nRefineLevel
+) {
+	return 10 * nRefineLevel * nRefineLevel + 2;
+}
+
+///	<summary>
+///		Number of faces in an icosahedral mesh with the given refinement
+///		level.
+///	</summary>
+inline int ICOMeshFaceCount(
+	int nRefineLevel
+) {
+	return 20 * nRefineLevel * nRefineLevel;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+Node SubNode(
+	const Node & node0,
+	const Node & node1,
+	double alpha
 ) {
-	double dDeltaX = (vecNodes[ix1].x - vecNodes[ix0].x);
-	double dDeltaY = (vecNodes[ix1].y - vecNodes[ix0].y);
-	double dDeltaZ = (vecNodes[ix1].z - vecNodes[ix0].z);
+	double dDeltaX = (node1.x - node0.x);
+	double dDeltaY = (node1.y - node0.y);
+	double dDeltaZ = (node1.z - node0.z);
 	double dCartLength =
 		sqrt(dDeltaX*dDeltaX + dDeltaY*dDeltaY + dDeltaZ*dDeltaZ);
 
@@ -66,9 +89,9 @@ int InsertSubNode(
 
 	alpha = sin(dAlphaTheta) / sin(dBeta) / dCartLength;
 
-	double dX = vecNodes[ix0].x + (vecNodes[ix1].x - vecNodes[ix0].x) * alpha;
-	double dY = vecNodes[ix0].y + (vecNodes[ix1].y - vecNodes[ix0].y) * alpha;
-	double dZ = vecNodes[ix0].z + (vecNodes[ix1].z - vecNodes[ix0].z) * alpha;
+	double dX = node0.x + (node1.x - node0.x) * alpha;
+	double dY = node0.y + (node1.y - node0.y) * alpha;
+	double dZ = node0.z + (node1.z - node0.z) * alpha;
 
 	// Project to sphere
 	double dRadius = sqrt(dX*dX + dY*dY + dZ*dZ);
@@ -77,13 +100,7 @@ int InsertSubNode(
 	dY /= dRadius;
 	dZ /= dRadius;
 
-	// Index
-	int ix = vecNodes.size();
-
-	// Insert node
-	vecNodes.push_back(Node(dX, dY, dZ));
-
-	return ix;
+	return Node(dX, dY, dZ);
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -116,15 +133,21 @@ int InsertTriFaceCentroidNode(
 
 ///////////////////////////////////////////////////////////////////////////////
 
+///	<summary>
+///		Generate the nRefineLevel-1 nodes along the great circle arc from
+///		node ix0 to node ix1, storing them in vecNodes starting at index
+///		ixFirst.
+///	</summary>
 void GenerateEdgeVertices(
 	int nRefineLevel,
 	int ix0,
 	int ix1,
+	int ixFirst,
 	NodeVector & vecNodes,
 	MultiEdge & edge
 ) {
-	edge.clear();
-	edge.push_back(ix0);
+	edge.resize(nRefineLevel+1);
+	edge[0] = ix0;
 
 	for (int i = 1; i < nRefineLevel; i++) {
 
@@ -133,80 +156,108 @@ void GenerateEdgeVertices(
 			static_cast<double>(i) / static_cast<double>(nRefineLevel);
 
 		// Insert node along edge
-		int ixNode = InsertSubNode(ix0, ix1, alpha, vecNodes);
+		vecNodes[ixFirst+i-1] = SubNode(vecNodes[ix0], vecNodes[ix1], alpha);
 
 		// Add node to edge
-		edge.push_back(ixNode);
+		edge[i] = ixFirst+i-1;
 	}
 
-	edge.push_back(ix1);
+	edge[nRefineLevel] = ix1;
 }
 
 ///////////////////////////////////////////////////////////////////////////////
 
-void GenerateFacesFromTriangle(
+///	<summary>
+///		Index of node i in row j of a refined triangle, where row j has
+///		j+1 nodes, row nRefineLevel is edge2, interior rows span edge0 to
+///		edge1 and interior nodes are stored row by row from ixFirstNode.
+///	</summary>
+inline int TrianglePanelNodeIndex(
 	int nRefineLevel,
+	int j,
+	int i,
 	const MultiEdge & edge0,
 	const MultiEdge & edge1,
 	const MultiEdge & edge2,
-	NodeVector & vecNodes,
-	FaceVector & vecFaces
+	int ixFirstNode
 ) {
-	int i;
-	int j;
-	int k;
-
-	int ixEndNode;
+	if (j == nRefineLevel) {
+		return edge2[i];
+	}
+	if (i == 0) {
+		return edge0[j];
+	}
+	if (i == j) {
+		return edge1[j];
+	}
+	return ixFirstNode + (j-1) * (j-2) / 2 + (i-1);
+}
 
-	int ixInt;
+///////////////////////////////////////////////////////////////////////////////
 
-	// MultiEdges
-	MultiEdge edgeBot;
-	MultiEdge edgeMid;
-	MultiEdge edgeTop;
+///	<summary>
+///		Generate the interior nodes and the faces of one icosahedron face,
+///		storing the interior nodes from index ixFirstNode and the
+///		nRefineLevel^2 faces from index ixFirstFace.  Rows of the triangle
+///		are independent and are generated in parallel.
+///	</summary>
+void GenerateFacesFromTriangle(
+	int nRefineLevel,
+	const MultiEdge & edge0,
+	const MultiEdge & edge1,
+	const MultiEdge & edge2,
+	int ixFirstNode,
+	int ixFirstFace,
+	NodeVector & vecNodes,
+	FaceVector & vecFaces,
+	int nThreads
+) {
+	// Generate interior vertices of each row
+#pragma omp parallel for schedule(dynamic, 16) num_threads(nThreads)
+	for (int j = 2; j < nRefineLevel; j++) {
+		const Node & node0 = vecNodes[edge0[j]];
+		const Node & node1 = vecNodes[edge1[j]];
 
-	// Initial bottom edge
-	edgeBot.push_back(edge0[0]);
+		const int ixRow = ixFirstNode + (j-1) * (j-2) / 2;
 
-	// Loop over all refined faces
-	for (j = 0; j < nRefineLevel; j++) {
+		for (int i = 1; i < j; i++) {
+			double alpha =
+				static_cast<double>(i) / static_cast<double>(j);
 
-		// Generate top level vertices
-		if (j == nRefineLevel-1) {
-			edgeTop = edge2;
-		} else {
-			GenerateEdgeVertices(
-				j+1, edge0[j+1], edge1[j+1], vecNodes, edgeTop);
+			vecNodes[ixRow+i-1] = SubNode(node0, node1, alpha);
 		}
+	}
+
+	// Generate faces
+#pragma omp parallel for schedule(dynamic, 16) num_threads(nThreads)
+	for (int j = 0; j < nRefineLevel; j++) {
+		for (int i = 0; i < 2*j+1; i++) {
+			Face & face = vecFaces[ixFirstFace + j * j + i];
+			face.edges.resize(3);
 
-		// Generate faces
-		for (i = 0; i < 2*j+1; i++) {
 			// Downward pointing faces
 			if (i % 2 == 0) {
 				int ix = i/2;
 
-				Face face(3);
-				face.SetNode(0, edgeBot[ix]);
-				face.SetNode(1, edgeTop[ix]);
-				face.SetNode(2, edgeTop[ix+1]);
-
-				vecFaces.push_back(face);
+				face.SetNode(0, TrianglePanelNodeIndex(
+					nRefineLevel, j, ix, edge0, edge1, edge2, ixFirstNode));
+				face.SetNode(1, TrianglePanelNodeIndex(
+					nRefineLevel, j+1, ix, edge0, edge1, edge2, ixFirstNode));
+				face.SetNode(2, TrianglePanelNodeIndex(
+					nRefineLevel, j+1, ix+1, edge0, edge1, edge2, ixFirstNode));
 
 			// Upward pointing faces
 			} else {
 				int ix = (i-1)/2;
 
-				Face face(3);
-				face.SetNode(0, edgeTop[ix+1]);
-				face.SetNode(1, edgeBot[ix+1]);
-				face.SetNode(2, edgeBot[ix]);
-
-				vecFaces.push_back(face);
+				face.SetNode(0, TrianglePanelNodeIndex(
+					nRefineLevel, j+1, ix+1, edge0, edge1, edge2, ixFirstNode));
+				face.SetNode(1, TrianglePanelNodeIndex(
+					nRefineLevel, j, ix+1, edge0, edge1, edge2, ixFirstNode));
+				face.SetNode(2, TrianglePanelNodeIndex(
+					nRefineLevel, j, ix, edge0, edge1, edge2, ixFirstNode));
 			}
 		}
-
-		// New bottom edge
-		edgeBot = edgeTop;
 	}
 }
 
@@ -235,7 +286,8 @@ void ConvertFromLonLatToCartesian(
 void GenerateIcosahedralQuadGrid(
 	int nRefineLevel,
 	NodeVector & vecNodes,
-	FaceVector & vecFaces
+	FaceVector & vecFaces,
+	int nThreads
 ) {
 	// Latitude of nodes (Northern Hemisphere)
 	const double NodeLat = atan(0.5);
@@ -259,87 +311,103 @@ void GenerateIcosahedralQuadGrid(
 	// Convert icosahedral nodes to Cartesian geometry
 	ConvertFromLonLatToCartesian(vecLonLatNodes, vecNodes);
 
-	// Vector of edges
-	MultiEdgeVector vecEdges;
-	vecEdges.resize(30);
+	// All nodes and faces are stored in precomputed index ranges:
+	// icosahedron vertices, then the nodes along each icosahedron edge,
+	// then the interior nodes of each icosahedron face in the order faces
+	// are generated.
+	vecNodes.resize(ICOMeshNodeCount(nRefineLevel));
 
-	// Generate vertices along edges
-	for (int i = 0; i < 5; i++) {
-		GenerateEdgeVertices(
-			nRefineLevel, 0, i+1, vecNodes, vecEdges[i]);
-	}
+	vecFaces.clear();
+	vecFaces.resize(ICOMeshFaceCount(nRefineLevel));
+
+	const int nEdgeNodes = nRefineLevel - 1;
+	const int nTriangleNodes = (nRefineLevel - 1) * (nRefineLevel - 2) / 2;
+	const int nTriangleFaces = nRefineLevel * nRefineLevel;
+
+	const int ixFirstEdgeNode = 12;
+	const int ixFirstTriangleNode = ixFirstEdgeNode + 30 * nEdgeNodes;
+
+	// Endpoints of each icosahedron edge
+	int ixEdgeEndpoints[30][2];
 
 	for (int i = 0; i < 5; i++) {
-		GenerateEdgeVertices(
-			nRefineLevel, i+1, ((i+1)%5)+1, vecNodes, vecEdges[i+5]);
+		ixEdgeEndpoints[i][0] = 0;
+		ixEdgeEndpoints[i][1] = i+1;
+
+		ixEdgeEndpoints[i+5][0] = i+1;
+		ixEdgeEndpoints[i+5][1] = ((i+1)%5)+1;
+
+		ixEdgeEndpoints[2*i+10][0] = i+1;
+		ixEdgeEndpoints[2*i+10][1] = i+6;
+
+		ixEdgeEndpoints[2*i+11][0] = i+6;
+		ixEdgeEndpoints[2*i+11][1] = ((i+1)%5)+1;
+
+		ixEdgeEndpoints[i+20][0] = i+6;
+		ixEdgeEndpoints[i+20][1] = ((i+1)%5)+6;
+
+		ixEdgeEndpoints[i+25][0] = i+6;
+		ixEdgeEndpoints[i+25][1] = 11;
 	}
 
-	GenerateEdgeVertices(nRefineLevel, 1, 6, vecNodes, vecEdges[10]);
-	GenerateEdgeVertices(nRefineLevel, 6, 2, vecNodes, vecEdges[11]);
-	GenerateEdgeVertices(nRefineLevel, 2, 7, vecNodes, vecEdges[12]);
-	GenerateEdgeVertices(nRefineLevel, 7, 3, vecNodes, vecEdges[13]);
-	GenerateEdgeVertices(nRefineLevel, 3, 8, vecNodes, vecEdges[14]);
-	GenerateEdgeVertices(nRefineLevel, 8, 4, vecNodes, vecEdges[15]);
-	GenerateEdgeVertices(nRefineLevel, 4, 9, vecNodes, vecEdges[16]);
-	GenerateEdgeVertices(nRefineLevel, 9, 5, vecNodes, vecEdges[17]);
-	GenerateEdgeVertices(nRefineLevel, 5, 10, vecNodes, vecEdges[18]);
-	GenerateEdgeVertices(nRefineLevel, 10, 1, vecNodes, vecEdges[19]);
+	// Generate vertices along edges
+	MultiEdgeVector vecEdges;
+	vecEdges.resize(30);
 
-	for (int i = 0; i < 5; i++) {
+	for (int e = 0; e < 30; e++) {
 		GenerateEdgeVertices(
-			nRefineLevel, i+6, ((i+1)%5)+6, vecNodes, vecEdges[i+20]);
+			nRefineLevel,
+			ixEdgeEndpoints[e][0],
+			ixEdgeEndpoints[e][1],
+			ixFirstEdgeNode + e * nEdgeNodes,
+			vecNodes,
+			vecEdges[e]);
 	}
 
+	// Bounding edges of each icosahedron face
+	MultiEdgeVector vecTriangleEdges;
+	vecTriangleEdges.reserve(60);
+
+	// South polar faces
 	for (int i = 0; i < 5; i++) {
-		GenerateEdgeVertices(
-			nRefineLevel, i+6, 11, vecNodes, vecEdges[i+25]);
+		vecTriangleEdges.push_back(vecEdges[i]);
+		vecTriangleEdges.push_back(vecEdges[(i+1)%5]);
+		vecTriangleEdges.push_back(vecEdges[i+5]);
 	}
 
-	// Generate south polar faces
+	// South equatorial faces
 	for (int i = 0; i < 5; i++) {
-		GenerateFacesFromTriangle(
-			nRefineLevel,
-			vecEdges[i],
-			vecEdges[(i+1)%5],
-			vecEdges[i+5],
-			vecNodes,
-			vecFaces
-		);
+		vecTriangleEdges.push_back(vecEdges[2*i+10]);
+		vecTriangleEdges.push_back(vecEdges[i+5]);
+		vecTriangleEdges.push_back(vecEdges[2*i+11]);
 	}
 
-	// Generate south equatorial faces
+	// North equatorial faces
 	for (int i = 0; i < 5; i++) {
-		GenerateFacesFromTriangle(
-			nRefineLevel,
-			vecEdges[2*i+10],
-			vecEdges[i+5],
-			vecEdges[2*i+11],
-			vecNodes,
-			vecFaces
-		);
+		vecTriangleEdges.push_back(vecEdges[i+20]);
+		vecTriangleEdges.push_back(vecEdges[2*i+11]);
+		vecTriangleEdges.push_back(vecEdges[2*((i+1)%5)+10].Flip());
 	}
 
-	// Generate north equatorial faces
+	// North polar faces
 	for (int i = 0; i < 5; i++) {
-		GenerateFacesFromTriangle(
-			nRefineLevel,
-			vecEdges[i+20],
-			vecEdges[2*i+11],
-			vecEdges[2*((i+1)%5)+10].Flip(),
-			vecNodes,
-			vecFaces
-		);
+		vecTriangleEdges.push_back(vecEdges[i+25]);
+		vecTriangleEdges.push_back(vecEdges[i+20]);
+		vecTriangleEdges.push_back(vecEdges[((i+1)%5)+25].Flip());
 	}
 
-	// Generate north polar faces
-	for (int i = 0; i < 5; i++) {
+	// Generate faces
+	for (int t = 0; t < 20; t++) {
 		GenerateFacesFromTriangle(
 			nRefineLevel,
-			vecEdges[i+25],
-			vecEdges[i+20],
-			vecEdges[((i+1)%5)+25].Flip(),
+			vecTriangleEdges[3*t],
+			vecTriangleEdges[3*t+1],
+			vecTriangleEdges[3*t+2],
+			ixFirstTriangleNode + t * nTriangleNodes,
+			t * nTriangleFaces,
 			vecNodes,
-			vecFaces
+			vecFaces,
+			nThreads
 		);
 	}
 }
@@ -347,21 +415,26 @@ void GenerateIcosahedralQuadGrid(
 ///////////////////////////////////////////////////////////////////////////////
 
 void Dual(
-	Mesh & mesh
+	Mesh & mesh,
+	int nThreads
 ) {
 	const int EdgeCountHexagon = 6;
 
 	// Generate ReverseNodeArray
-	mesh.ConstructReverseNodeArray();
+	mesh.ConstructReverseNodeArray(nThreads);
 
 	// Backup Nodes and Faces
 	NodeVector nodesOld = mesh.nodes;
 	FaceVector facesOld = mesh.faces;
 
 	mesh.nodes.clear();
+	mesh.nodes.resize(facesOld.size());
+
 	mesh.faces.clear();
+	mesh.faces.resize(nodesOld.size());
 
 	// Generate new Node array
+#pragma omp parallel for num_threads(nThreads)
 	for (int i = 0; i < facesOld.size(); i++) {
 		Node node;
 		for (int j = 0; j < facesOld[i].edges.size(); j++) {
@@ -380,10 +453,11 @@ void Dual(
 		node.y /= dMag;
 		node.z /= dMag;
 
-		mesh.nodes.push_back(node);
+		mesh.nodes[i] = node;
 	}
 
 	// Generate new Face array
+#pragma omp parallel for num_threads(nThreads)
 	for (int i = 0; i < nodesOld.size(); i++) {
 		const int nEdges = mesh.revnodearray[i].size();
 
@@ -391,7 +465,8 @@ void Dual(
 		Face faceTemp(EdgeCountHexagon);
 
 		int ixNode = 0;
-		std::set<int>::const_iterator iter = mesh.revnodearray[i].begin();
+		ReverseNodeArray::FaceRange::const_iterator iter =
+			mesh.revnodearray[i].begin();
 		for (; iter != mesh.revnodearray[i].end(); iter++) {
 			faceTemp.SetNode(ixNode, *iter);
 			ixNode++;
@@ -454,14 +529,14 @@ void Dual(
 			face.SetNode(j, face[nEdges-1]);
 		}
 
-		mesh.faces.push_back(face);
+		mesh.faces[i] = face;
 	}
 }
 
 ///////////////////////////////////////////////////////////////////////////////
 
 extern "C" 
-int GenerateICOMesh(Mesh& mesh, int nResolution, bool fDual, std::string strOutputFile, std::string strOutputFormat)
+int GenerateICOMesh(Mesh& mesh, int nResolution, bool fDual, std::string strOutputFile, std::string strOutputFormat, int nThreads)
 {
 
 	NcError error(NcError::silent_nonfatal);
@@ -478,17 +553,24 @@ try {
 			"expected [Classic|Offset64Bits|Netcdf4|Netcdf4Classic]",
 			strOutputFormat.c_str());
 	}
-
+	if (nResolution < 1) {
+		_EXCEPTION1("Invalid \"res\" value (%i), expected a positive integer",
+			nResolution);
+	}
+	if (nThreads < 1) {
+		_EXCEPTIONT("Number of threads must be at least 1");
+	}
 
 	// Generate Mesh
 	AnnounceBanner();
 	AnnounceStartBlock("Generating Mesh");
-	GenerateIcosahedralQuadGrid(nResolution, mesh.nodes, mesh.faces);
+	GenerateIcosahedralQuadGrid(
+		nResolution, mesh.nodes, mesh.faces, nThreads);
 	AnnounceEndBlock("Done");
 
 	// Generate the dual grid
 	if (fDual) {
-		Dual(mesh);
+		Dual(mesh, nThreads);
         mesh.type = Mesh::MeshType_IcosaHedralDual;
 	}
     else mesh.type = Mesh::MeshType_IcosaHedral;
@@ -499,7 +581,7 @@ try {
 		Announce("Mesh size: Nodes [%i] Elements [%i]",
 			mesh.nodes.size(), mesh.faces.size());
 
-		mesh.Write(strOutputFile, eOutputFormat);
+		mesh.Write(strOutputFile, eOutputFormat, 0, nThreads);
 		
 		AnnounceEndBlock("Done");
 	}
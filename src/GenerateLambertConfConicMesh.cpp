@@ -20,22 +20,88 @@
 
 #include <cmath>
 #include <iostream>
+#include <algorithm>
 
 #include "netcdfcpp.h"
 
 ///////////////////////////////////////////////////////////////////////////////
 
+///	<summary>
+///		Number of points converted together by
+///		ConvertLambertConfConicToRLLBatch.
+///	</summary>
+static const int LambertProjectionBatchSize = 64;
+
+///	<summary>
+///		Constants of the Lambert conformal conic projection.
+///	</summary>
+struct LambertConfConicProjection {
+
+	///	<summary>
+	///		Central longitude (rad).
+	///	</summary>
+	double dLon0;
+
+	///	<summary>
+	///		Cone constant, its inverse and its sign.
+	///	</summary>
+	double dN;
+	double dInvN;
+	double dSignN;
+
+	///	<summary>
+	///		Scale constant F.
+	///	</summary>
+	double dF;
+
+	///	<summary>
+	///		Radius of the reference latitude.
+	///	</summary>
+	double dRho0;
+};
+
+///	<summary>
+///		Convert a batch of at most LambertProjectionBatchSize projected
+///		coordinates (in Earth radii) to RLL (in radians).
+///	</summary>
+static void ConvertLambertConfConicToRLLBatch(
+	const LambertConfConicProjection & proj,
+	int nPoints,
+	const double * dXX,
+	const double * dYY,
+	double * dLambda,
+	double * dPhi
+) {
+#pragma omp simd
+	for (int k = 0; k < nPoints; k++) {
+		const double dRhoY = proj.dRho0 - dYY[k];
+
+		double dTheta = atan2(dXX[k], dRhoY);
+		double dRho = proj.dSignN * sqrt(dXX[k] * dXX[k] + dRhoY * dRhoY);
+
+		dLambda[k] = proj.dLon0 + dTheta / proj.dN;
+		dPhi[k] = 2.0 * atan(pow(proj.dF / dRho, proj.dInvN)) - 0.5 * M_PI;
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
 extern "C" int GenerateLambertConfConicMesh(  Mesh& mesh, int nNCol, int nNRow,
 												double dLon0, double dLat0, 
 												double dLat1, double dLat2, 
 												double dXLL, double dYLL, double dDX, 
-												std::string strOutputFile
+												std::string strOutputFile,
+												int nThreads
 ) {
 
 	NcError error(NcError::silent_nonfatal);
 
 try {
 
+	if (nThreads < 1) {
+		_EXCEPTIONT("Thread count must be at least 1");
+	}
+
 	// Verify latitude box is increasing
 	if (dLat1 >= dLat2) {
 		_EXCEPTIONT("--lat1 must be less than --lat2");
@@ -69,44 +135,77 @@ try {
 	NodeVector & nodes = mesh.nodes;
 	FaceVector & faces = mesh.faces;
 
+	LambertConfConicProjection proj;
+	proj.dLon0 = dLon0;
+	proj.dN = dN;
+	proj.dInvN = 1.0 / dN;
+	proj.dSignN = dN / fabs(dN);
+	proj.dF = dF;
+	proj.dRho0 = dRho0;
+
 	// Announce
 	AnnounceStartBlock("Distributing nodes");
 
-	// Add all nodal locations
+	// Add all nodal locations, a batch of each row at a time
+	const int nRowNodes = nNCol + 1;
+
+	nodes.resize(static_cast<size_t>(nNRow + 1) * nRowNodes);
+
+#pragma omp parallel for schedule(dynamic, 16) num_threads(nThreads)
 	for (int i = 0; i <= nNRow; i++) {
-	for (int j = 0; j <= nNCol; j++) {
+		double dXX[LambertProjectionBatchSize];
+		double dYY[LambertProjectionBatchSize];
+		double dLambda[LambertProjectionBatchSize];
+		double dPhi[LambertProjectionBatchSize];
+
+		for (int j0 = 0; j0 < nRowNodes; j0 += LambertProjectionBatchSize) {
+			const int nBatch =
+				std::min(LambertProjectionBatchSize, nRowNodes - j0);
+
+			for (int k = 0; k < nBatch; k++) {
+				dXX[k] = dXLL + dDX * static_cast<double>(i);
+				dYY[k] = dYLL + dDX * static_cast<double>(j0 + k);
+			}
+
+			ConvertLambertConfConicToRLLBatch(
+				proj, nBatch, dXX, dYY, dLambda, dPhi);
+
+			const size_t ixNode = static_cast<size_t>(i) * nRowNodes + j0;
+
+			for (int k = 0; k < nBatch; k++) {
+				nodes[ixNode + k] =
+					Node(
+						cos(dPhi[k]) * cos(dLambda[k]),
+						cos(dPhi[k]) * sin(dLambda[k]),
+						sin(dPhi[k]));
+			}
+		}
+	}
+
+	// Announce the corners
+	for (int c = 0; c < 4; c++) {
+		const int i = (c < 2)?(0):(nNRow);
+		const int j = (c % 2 == 0)?(0):(nNCol);
 
 		double dXX = dXLL + dDX * static_cast<double>(i);
 		double dYY = dYLL + dDX * static_cast<double>(j);
 
-		double dTheta = atan2(dXX, dRho0 - dYY);
-		double dRho = dN / fabs(dN)
-			* sqrt(dXX * dXX + (dRho0 - dYY) * (dRho0 - dYY));
+		double dLambda;
+		double dPhi;
 
-		double dLambda = dLon0 + dTheta / dN;
-		double dPhi = 2.0 * atan( pow(dF / dRho, 1.0/dN)) - 0.5 * M_PI;
+		ConvertLambertConfConicToRLLBatch(
+			proj, 1, &dXX, &dYY, &dLambda, &dPhi);
 
-		if ((i == 0) || (i == nNRow)) {
-			if ((j == 0) || (j == nNCol)) {
-				Announce("Corner: %3.3f %3.3f",
-					dLambda * 180.0 / M_PI, dPhi * 180.0 / M_PI);
+		Announce("Corner: %3.3f %3.3f",
+			dLambda * 180.0 / M_PI, dPhi * 180.0 / M_PI);
 /*
-				double dRho2 = dF * pow(1/tan(0.25 * M_PI + 0.5 * dPhi), dN);
-				double dXX2 = dRho2 * sin(dN * (dLambda - dLon0));
-				double dYY2 = dRho0 - dRho2 * cos(dN * (dLambda - dLon0));
+		double dRho2 = dF * pow(1/tan(0.25 * M_PI + 0.5 * dPhi), dN);
+		double dXX2 = dRho2 * sin(dN * (dLambda - dLon0));
+		double dYY2 = dRho0 - dRho2 * cos(dN * (dLambda - dLon0));
 
-				printf("%1.5e %1.5e : %1.5e %1.5e\n",
-					dXX, dYY, dXX2, dYY2);
+		printf("%1.5e %1.5e : %1.5e %1.5e\n",
+			dXX, dYY, dXX2, dYY2);
 */
-			}
-		}
-
-		double dX = cos(dPhi) * cos(dLambda);
-		double dY = cos(dPhi) * sin(dLambda);
-		double dZ = sin(dPhi);
-
-		nodes.push_back(Node(dX, dY, dZ));
-	}
 	}
 
 	// Announce
@@ -114,18 +213,19 @@ try {
 	AnnounceStartBlock("Assigning faces");
 
 	// Add all faces 
+	faces.resize(static_cast<size_t>(nNRow) * nNCol, Face(4));
+
+#pragma omp parallel for num_threads(nThreads)
 	for (int j = 0; j < nNRow; j++) {
 		int iThisYNodeIx =  j    * (nNCol + 1);
 		int iNextYNodeIx = (j+1) * (nNCol + 1);
 
 		for (int i = 0; i < nNCol; i++) {
-			Face face(4);
+			Face & face = faces[static_cast<size_t>(j) * nNCol + i];
 			face.SetNode(0, iThisYNodeIx + i);
 			face.SetNode(1, iThisYNodeIx + (i + 1));
 			face.SetNode(2, iNextYNodeIx + (i + 1));
 			face.SetNode(3, iNextYNodeIx + i);
-
-			faces.push_back(face);
 		}
 	}
 
@@ -252,7 +352,7 @@ try {
 		Announce("Writing mesh to file [%s]", strOutputFile.c_str());
 
 		// Output the mesh
-		mesh.Write(strOutputFile);
+		mesh.Write(strOutputFile, NcFile::Classic, 0, nThreads);
 
 		// Add rectilinear properties
 		NcFile ncOutput(strOutputFile.c_str(), NcFile::Write);
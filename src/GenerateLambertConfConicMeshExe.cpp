@@ -58,6 +58,9 @@ int main(int argc, char** argv) {
 	// Output filename
 	std::string strOutputFile;
 
+	// Number of threads
+	int nThreads;
+
 	// Parse the command line
 	BeginCommandLine()
 		CommandLineInt(nNCol, "ncol", 5268);
@@ -70,6 +73,7 @@ int main(int argc, char** argv) {
 		CommandLineDoubleD(dYLL,  "yll", 1785000.0, "(meters)");
 		CommandLineDoubleD(dDX,   "dx", 1000.0, "(meters)");
 		CommandLineString(strOutputFile, "file", "outLCCMesh.g");
+		CommandLineInt(nThreads, "nthreads", 1);
 
 		ParseCommandLine(argc, argv);
 	EndCommandLine(argv)
@@ -79,7 +83,7 @@ int main(int argc, char** argv) {
 
 	// Calculate metadata
     Mesh mesh;
-    int err = GenerateLambertConfConicMesh(mesh, nNCol, nNRow, dLon0, dLat0, dLat1, dLat2, dXLL, dYLL, dDX, strOutputFile);
+    int err = GenerateLambertConfConicMesh(mesh, nNCol, nNRow, dLon0, dLat0, dLat1, dLat2, dXLL, dYLL, dDX, strOutputFile, nThreads);
 	if (err) exit(err);
 
 	// Done
@@ -15,9 +15,12 @@
 ///	</remarks>
 
 #include "Announce.h"
+#include "CheckpointFile.h"
 #include "CommandLine.h"
 #include "Exception.h"
 #include "GridElements.h"
+#include "CompactOverlapMesh.h"
+#include "GeneratedMapCache.h"
 #include "OverlapMesh.h"
 #include "DataArray3D.h"
 #include "FiniteElementTools.h"
@@ -29,9 +32,16 @@
 #include "OfflineMap.h"
 #include "LinearRemapSE0.h"
 #include "LinearRemapFV.h"
+#include "LinearRemapNonConservative.h"
+#include "MemoryPlan.h"
+#include "OfflineMapGenerator.h"
+#include "TempestRemapAPI.h"
 
 #include "netcdfcpp.h"
 #include <cmath>
+#include <cstdio>
+#include <vector>
+#include <algorithm>
 
 ///////////////////////////////////////////////////////////////////////////////
 
@@ -125,28 +135,526 @@ void LoadMetaDataFile(
 
 ///////////////////////////////////////////////////////////////////////////////
 
-extern "C"
-int GenerateOfflineMapWithMeshes(
-	OfflineMap& mapRemap,
-	Mesh& meshInput,
-	Mesh& meshOutput,
-	Mesh& meshOverlap,
-	std::string strInputMeta,
-	std::string strOutputMeta,
-	std::string strInputType, std::string strOutputType,
-	int nPin, int nPout,
-	bool fBubble, int fMonotoneTypeID,
-	bool fVolumetric, bool fNoConservation, bool fNoCheck,
-	std::string strVariables, std::string strOutputMap,
-	std::string strInputData, std::string strOutputData,
-	std::string strNColName, bool fOutputDouble,
-	std::string strOutputFormat,
-	std::string strPreserveVariables, bool fPreserveAll, double dFillValueOverride,
-	bool fInputConcave, bool fOutputConcave
+static void VerifyOverlapMeshCorrespondence(
+	const Mesh & meshInput,
+	const Mesh & meshOutput,
+	Mesh & meshOverlap
 ) {
-	NcError error(NcError::silent_nonfatal);
+	int ixSourceFaceMax = (-1);
+	int ixTargetFaceMax = (-1);
+
+	if (meshOverlap.vecSourceFaceIx.size() !=
+		meshOverlap.vecTargetFaceIx.size()
+	) {
+		_EXCEPTIONT("Invalid overlap mesh:\n"
+			"    Possible mesh file corruption?");
+	}
 
-try {
+	for (int i = 0; i < meshOverlap.vecSourceFaceIx.size(); i++) {
+		if (meshOverlap.vecSourceFaceIx[i] + 1 > ixSourceFaceMax) {
+			ixSourceFaceMax = meshOverlap.vecSourceFaceIx[i] + 1;
+		}
+		if (meshOverlap.vecTargetFaceIx[i] + 1 > ixTargetFaceMax) {
+			ixTargetFaceMax = meshOverlap.vecTargetFaceIx[i] + 1;
+		}
+	}
+
+	// Check for forward correspondence in overlap mesh
+	if (ixSourceFaceMax == meshInput.faces.size() //&&
+		//(ixTargetFaceMax == meshOutput.faces.size())
+	) {
+		Announce("Overlap mesh forward correspondence found");
+
+	// Check for reverse correspondence in overlap mesh
+	} else if (
+		ixSourceFaceMax == meshOutput.faces.size() //&&
+		//(ixTargetFaceMax == meshInput.faces.size())
+	) {
+		Announce("Overlap mesh reverse correspondence found (reversing)");
+
+		// Reorder overlap mesh
+		meshOverlap.ExchangeFirstAndSecondMesh();
+
+	// No correspondence found
+	} else {
+		_EXCEPTION2("Invalid overlap mesh:\n"
+			"    No correspondence found with input and output meshes (%i,%i)",
+			ixSourceFaceMax, ixTargetFaceMax);
+	}
+
+	// Index the overlap faces by source and target face, sorting them by
+	// source face if needed
+	meshOverlap.ConstructOverlapFaceIndex(
+		static_cast<int>(meshInput.faces.size()),
+		static_cast<int>(meshOutput.faces.size()));
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Load an overlap mesh from file.  Compact overlap meshes are expanded
+///		using the input and output meshes when they are the meshes the
+///		overlap mesh was generated from, avoiding a second read of either.
+///	</summary>
+static void LoadOverlapMesh(
+	const std::string & strOverlapMesh,
+	const Mesh & meshInput,
+	const Mesh & meshOutput,
+	Mesh & meshOverlap,
+	int nThreads
+) {
+	if (!CompactOverlapMesh::IsCompactOverlapFile(strOverlapMesh)) {
+		meshOverlap.Read(strOverlapMesh);
+		return;
+	}
+
+	Announce("Compact overlap mesh detected");
+
+	CompactOverlapMesh meshCompact;
+	meshCompact.Read(strOverlapMesh);
+
+	if (meshCompact.MatchesMeshes(meshInput, meshOutput)) {
+		meshCompact.ToMesh(meshInput, meshOutput, meshOverlap, nThreads);
+
+	} else if (meshCompact.MatchesMeshes(meshOutput, meshInput)) {
+		meshCompact.ToMesh(meshOutput, meshInput, meshOverlap, nThreads);
+
+	} else {
+		meshOverlap.Read(strOverlapMesh);
+		return;
+	}
+
+	meshOverlap.strFileName = strOverlapMesh;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+static void ReadFaceIndexFile(
+	const std::string & strFaceIndexFile,
+	std::vector<int> & vecFaceIx
+) {
+	FILE * fp = fopen(strFaceIndexFile.c_str(), "r");
+	if (fp == NULL) {
+		_EXCEPTION1("Unable to open face index file \"%s\"",
+			strFaceIndexFile.c_str());
+	}
+
+	int ix;
+	while (fscanf(fp, "%d", &ix) == 1) {
+		vecFaceIx.push_back(ix);
+	}
+
+	bool fEOF = (feof(fp) != 0);
+
+	fclose(fp);
+
+	if (!fEOF) {
+		_EXCEPTION1("Invalid entry in face index file \"%s\"",
+			strFaceIndexFile.c_str());
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+static void AppendChangedAreaFaces(
+	const DataArray1D<double> & dPreviousAreas,
+	const Mesh & mesh,
+	std::vector<int> & vecFaceIx
+) {
+	if (dPreviousAreas.GetRows() != mesh.faces.size()) {
+		_EXCEPTION2("Previous map has %i faces but mesh has %i faces",
+			dPreviousAreas.GetRows(), static_cast<int>(mesh.faces.size()));
+	}
+
+	for (int i = 0; i < mesh.faces.size(); i++) {
+		if (mesh.vecFaceArea[i] != dPreviousAreas[i]) {
+			vecFaceIx.push_back(i);
+		}
+	}
+
+	std::sort(vecFaceIx.begin(), vecFaceIx.end());
+	vecFaceIx.erase(
+		std::unique(vecFaceIx.begin(), vecFaceIx.end()),
+		vecFaceIx.end());
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Generate the finite volume reconstruction stencils of the input
+///		mesh unless they are stored in the mesh already.  If strPrepared
+///		is given the stencils are first read from this prepared mesh file,
+///		and are written to it after they are generated.
+///	</summary>
+static void PrepareReconstructionStencils(
+	Mesh & meshInput,
+	int nOrder,
+	const std::string & strPrepared,
+	int nThreads
+) {
+	if (strPrepared != "") {
+		Mesh meshPrepared;
+		meshPrepared.nodes = meshInput.nodes;
+		meshPrepared.faces = meshInput.faces;
+
+		if (meshPrepared.ReadPrepared(strPrepared)) {
+			meshInput.facestencils.swap(meshPrepared.facestencils);
+		}
+	}
+
+	AnnounceStartBlock("Constructing reconstruction stencils");
+	bool fGenerated =
+		ConstructReconstructionStencils(meshInput, nOrder, nThreads);
+	AnnounceEndBlock(NULL);
+
+	if (fGenerated && (strPrepared != "")) {
+		meshInput.WritePrepared(strPrepared);
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Get the fit array cache of pSourceData if it was built for meshInput
+///		with the reconstruction order and quadrature rule of the given
+///		remap, or NULL otherwise.
+///	</summary>
+static const FVFitArrayCache * GetSourceFitArrayCache(
+	const OfflineMapSourceData * pSourceData,
+	const Mesh & meshInput,
+	int nOrder,
+	bool fFiniteElementTarget,
+	bool fVolumetric
+) {
+	if (pSourceData == NULL) {
+		return NULL;
+	}
+
+	const int nTriQuadRuleOrder =
+		GetFVFitArrayTriQuadRuleOrder(fFiniteElementTarget, fVolumetric);
+
+	if (!pSourceData->cacheFitArrays.Matches(
+		nOrder, nTriQuadRuleOrder, meshInput.faces.size())
+	) {
+		return NULL;
+	}
+
+	return &(pSourceData->cacheFitArrays);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Determine if pSourceData holds finite element meta data for
+///		meshInput at order nP.
+///	</summary>
+static bool HasSourceMetaData(
+	const OfflineMapSourceData * pSourceData,
+	const Mesh & meshInput,
+	int nP,
+	bool fBubble
+) {
+	if (pSourceData == NULL) {
+		return false;
+	}
+
+	return (pSourceData->nP == nP)
+		&& (pSourceData->fBubble == fBubble)
+		&& (pSourceData->dataGLLNodes.IsAttached())
+		&& (pSourceData->dataGLLNodes.GetSubColumns() == meshInput.faces.size());
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Generate a non-conservative offline map from a finite volume source
+///		mesh to the faces or GLL nodes of the target mesh without an
+///		overlap mesh (see LinearRemapNonConservative()).
+///	</summary>
+static void GenerateOfflineMapNonConservative(
+	OfflineMap & mapRemap,
+	Mesh & meshInput,
+	Mesh & meshOutput,
+	const OfflineMapOptions & options,
+	NonConservativeMethod eMethod,
+	bool fInputPrepared
+) {
+	const int nThreads = options.nThreads;
+
+	std::string strOutputType = options.strTargetType;
+	STLStringHelper::ToLower(strOutputType);
+
+	// Calculate Face areas
+	if (fInputPrepared) {
+		meshInput.SumFaceAreas(nThreads);
+
+	} else {
+		AnnounceStartBlock("Calculating input mesh Face areas");
+		double dTotalAreaInput =
+			meshInput.CalculateFaceAreas(options.fSourceConcave, nThreads);
+		Announce("Input Mesh Geometric Area: %1.15e", dTotalAreaInput);
+		AnnounceEndBlock(NULL);
+	}
+
+	mapRemap.SetSourceAreas(meshInput.vecFaceArea);
+	if (meshInput.vecMask.IsAttached()) {
+		mapRemap.SetSourceMask(meshInput.vecMask);
+	}
+
+	AnnounceStartBlock("Calculating output mesh Face areas");
+	double dTotalAreaOutput =
+		meshOutput.CalculateFaceAreas(options.fTargetConcave, nThreads);
+	Announce("Output Mesh Geometric Area: %1.15e", dTotalAreaOutput);
+	AnnounceEndBlock(NULL);
+
+	mapRemap.InitializeSourceCoordinatesFromMeshFV(meshInput);
+
+	// Target nodes are Face centers or GLL nodes
+	NodeVector nodesTarget;
+
+	if (strOutputType == "fv") {
+		mapRemap.SetTargetAreas(meshOutput.vecFaceArea);
+		if (meshOutput.vecMask.IsAttached()) {
+			mapRemap.SetTargetMask(meshOutput.vecMask);
+		}
+
+		mapRemap.InitializeTargetCoordinatesFromMeshFV(meshOutput);
+
+		GetNonConservativeTargetNodesFV(meshOutput, nodesTarget);
+
+	} else {
+		DataArray3D<int> dataGLLNodes;
+		DataArray3D<double> dataGLLJacobian;
+
+		if (options.strTargetMeta != "") {
+			AnnounceStartBlock("Loading meta data file");
+			LoadMetaDataFile(
+				options.strTargetMeta, dataGLLNodes, dataGLLJacobian);
+			AnnounceEndBlock(NULL);
+
+		} else {
+			AnnounceStartBlock("Generating output mesh meta data");
+			double dNumericalArea =
+				GenerateMetaDataCached(
+					meshOutput,
+					options.nPout,
+					options.fBubble,
+					dataGLLNodes,
+					dataGLLJacobian,
+					options.strTargetMetaCache,
+					nThreads);
+
+			Announce("Output Mesh Numerical Area: %1.15e", dNumericalArea);
+			AnnounceEndBlock(NULL);
+		}
+
+		mapRemap.InitializeTargetCoordinatesFromMeshFE(
+			meshOutput, options.nPout, dataGLLNodes);
+
+		const bool fContinuous = (strOutputType == "cgll");
+
+		if (fContinuous) {
+			GenerateUniqueJacobian(
+				dataGLLNodes,
+				dataGLLJacobian,
+				mapRemap.GetTargetAreas());
+
+		} else {
+			GenerateDiscontinuousJacobian(
+				dataGLLJacobian,
+				mapRemap.GetTargetAreas());
+		}
+
+		GetNonConservativeTargetNodesGLL(
+			meshOutput, options.nPout, dataGLLNodes, fContinuous, nodesTarget);
+	}
+
+	// Generate remap weights
+	AnnounceStartBlock("Calculating offline map");
+	LinearRemapNonConservative(
+		meshInput,
+		nodesTarget,
+		eMethod,
+		mapRemap,
+		nThreads);
+	AnnounceEndBlock(NULL);
+
+	// Remove small and masked weights
+	if ((options.dPruneThreshold > 0.0) || options.fPruneMasked) {
+		mapRemap.SetThreadCount(nThreads);
+		mapRemap.Prune(options.dPruneThreshold, options.fPruneMasked);
+	}
+
+	// Verify consistency and monotonicity; conservation is reported but
+	// is not expected to hold
+	if (!options.fNoCheck) {
+		AnnounceStartBlock("Verifying map");
+		mapRemap.SetThreadCount(nThreads);
+		mapRemap.Verify(
+			1.0e-8, 1.0e-8,
+			(eMethod != NonConservativeMethod_Patch), 1.0e-12);
+		AnnounceEndBlock(NULL);
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Generate a finite volume to finite volume offline map on copies of
+///		the meshes whose faces have been reordered along a space-filling
+///		curve, then express the map, areas, masks and coordinates in the
+///		original face ordering.
+///	</summary>
+static void GenerateOfflineMapReordered(
+	OfflineMap & mapRemap,
+	Mesh & meshInput,
+	Mesh & meshOutput,
+	Mesh & meshOverlap,
+	const OfflineMapOptions & options,
+	bool fInputPrepared,
+	bool fOverlapPrepared
+) {
+	// Overlap face indices must refer to the input mesh first
+	VerifyOverlapMeshCorrespondence(meshInput, meshOutput, meshOverlap);
+
+	// Coordinates are generated from the meshes in their original ordering
+	mapRemap.InitializeSourceCoordinatesFromMeshFV(meshInput);
+	mapRemap.InitializeTargetCoordinatesFromMeshFV(meshOutput);
+
+	// Reorder copies of the meshes
+	AnnounceStartBlock("Reordering mesh faces");
+	Mesh meshInputReordered = meshInput;
+	meshInputReordered.ReorderFaces();
+
+	Mesh meshOutputReordered = meshOutput;
+	meshOutputReordered.ReorderFaces();
+
+	Mesh meshOverlapReordered = meshOverlap;
+	meshOverlapReordered.RenumberOverlapFaces(
+		meshInputReordered.vecFaceOriginalIx,
+		meshOutputReordered.vecFaceOriginalIx);
+	AnnounceEndBlock(NULL);
+
+	OfflineMapOptions optionsReordered = options;
+	optionsReordered.fReorderFaces = false;
+
+	GenerateOfflineMapWithOptions(
+		mapRemap,
+		meshInputReordered,
+		meshOutputReordered,
+		meshOverlapReordered,
+		optionsReordered,
+		fInputPrepared,
+		fOverlapPrepared);
+
+	const std::vector<int> & vecInputOriginalIx =
+		meshInputReordered.vecFaceOriginalIx;
+	const std::vector<int> & vecOutputOriginalIx =
+		meshOutputReordered.vecFaceOriginalIx;
+
+	// Restore the original ordering of the map
+	SparseMatrix<double> & smatRemap = mapRemap.GetSparseMatrix();
+
+	DataArray1D<int> dataRows;
+	DataArray1D<int> dataCols;
+	DataArray1D<double> dataEntries;
+	smatRemap.GetEntries(dataRows, dataCols, dataEntries);
+
+	for (int i = 0; i < dataRows.GetRows(); i++) {
+		dataRows[i] = vecOutputOriginalIx[dataRows[i]];
+		dataCols[i] = vecInputOriginalIx[dataCols[i]];
+	}
+
+	smatRemap.SetEntries(dataRows, dataCols, dataEntries);
+
+	// Restore the original ordering of the face areas
+	meshInput.vecFaceArea.Allocate(meshInput.faces.size());
+	for (int i = 0; i < vecInputOriginalIx.size(); i++) {
+		meshInput.vecFaceArea[vecInputOriginalIx[i]] =
+			meshInputReordered.vecFaceArea[i];
+	}
+
+	meshOutput.vecFaceArea.Allocate(meshOutput.faces.size());
+	for (int i = 0; i < vecOutputOriginalIx.size(); i++) {
+		meshOutput.vecFaceArea[vecOutputOriginalIx[i]] =
+			meshOutputReordered.vecFaceArea[i];
+	}
+
+	mapRemap.SetSourceAreas(meshInput.vecFaceArea);
+	mapRemap.SetTargetAreas(meshOutput.vecFaceArea);
+
+	if (meshInput.vecMask.IsAttached()) {
+		mapRemap.SetSourceMask(meshInput.vecMask);
+	}
+	if (meshOutput.vecMask.IsAttached()) {
+		mapRemap.SetTargetMask(meshOutput.vecMask);
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Build the key of a checkpoint of the finite volume to finite volume
+///		map generated from the given meshes and options.  The key covers
+///		the contents of the meshes and every option that affects the
+///		weights, so that a restart cannot resume from another computation.
+///	</summary>
+static std::string BuildOfflineMapCheckpointKey(
+	const Mesh & meshInput,
+	const Mesh & meshOutput,
+	const Mesh & meshOverlap,
+	const OfflineMapOptions & options
+) {
+	char szKey[512];
+	snprintf(szKey, sizeof(szKey),
+		"offline_map fvfv source=%016llx target=%016llx overlap=%016llx "
+		"np=%i mono_type=%i volumetric=%i no_conserve=%i "
+		"concave_src=%i concave_dst=%i",
+		meshInput.CalculateContentHash(),
+		meshOutput.CalculateContentHash(),
+		meshOverlap.CalculateContentHash(),
+		options.nPin,
+		options.nMonotoneType,
+		static_cast<int>(options.fVolumetric),
+		static_cast<int>(options.fNoConservation),
+		static_cast<int>(options.fSourceConcave),
+		static_cast<int>(options.fTargetConcave));
+
+	return std::string(szKey);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void GenerateOfflineMapWithOptions(
+	OfflineMap & mapRemap,
+	Mesh & meshInput,
+	Mesh & meshOutput,
+	Mesh & meshOverlap,
+	const OfflineMapOptions & options,
+	bool fInputPrepared,
+	bool fOverlapPrepared,
+	const OfflineMapSourceData * pSourceData
+) {
+	const int nThreads = options.nThreads;
+
+	if (nThreads < 1) {
+		_EXCEPTIONT("--nthreads must be at least 1");
+	}
+
+	std::string strInputMeta = options.strSourceMeta;
+	std::string strOutputMeta = options.strTargetMeta;
+	std::string strInputType = options.strSourceType;
+	std::string strOutputType = options.strTargetType;
+
+	const int nPin = options.nPin;
+	const int nPout = options.nPout;
+	const bool fBubble = options.fBubble;
+	const bool fVolumetric = options.fVolumetric;
+	const bool fNoConservation = options.fNoConservation;
+	const bool fInputConcave = options.fSourceConcave;
+	const bool fOutputConcave = options.fTargetConcave;
+
+	bool fNoCheck = options.fNoCheck;
 
     // Input / Output types
     enum DiscretizationType {
@@ -155,14 +663,6 @@ try {
         DiscretizationType_DGLL
     };
 
-    // Check command line parameters (data arguments)
-    if ((strInputData != "") && (strOutputData == "")) {
-        _EXCEPTIONT("--in_data specified without --out_data");
-    }
-    if ((strInputData == "") && (strOutputData != "")) {
-        _EXCEPTIONT("--out_data specified without --in_data");
-    }
-
     // Check metadata parameters
     if ((strInputMeta != "") && (strInputType == "fv")) {
         _EXCEPTIONT("--in_meta cannot be used with --in_type fv");
@@ -171,17 +671,6 @@ try {
         _EXCEPTIONT("--out_meta cannot be used with --out_type fv");
     }
 
-    // Check command line parameters (data type arguments)
-    STLStringHelper::ToLower(strOutputFormat);
-
-	NcFile::FileFormat eOutputFormat =
-		GetNcFileFormatFromString(strOutputFormat);
-	if (eOutputFormat == NcFile::BadFormat) {
-		_EXCEPTION1("Invalid \"out_format\" value (%s), "
-			"expected [Classic|Offset64Bits|Netcdf4|Netcdf4Classic]",
-			strOutputFormat.c_str());
-	}
-   
     STLStringHelper::ToLower(strInputType);
     STLStringHelper::ToLower(strOutputType);
 
@@ -211,7 +700,7 @@ try {
     }
 
     // Monotonicity flags
-    int nMonotoneType = fMonotoneTypeID;
+    int nMonotoneType = options.nMonotoneType;
 
 /*
     // Volumetric
@@ -236,23 +725,84 @@ try {
 	    AnnounceEndBlock(NULL);
 	}
 
-    // Parse variable list
-    std::vector< std::string > vecVariableStrings;
-    ParseVariableList(strVariables, vecVariableStrings);
+    // Threads used to initialize coordinates
+    mapRemap.SetThreadCount(nThreads);
 
-    // Parse preserve variable list
-    std::vector< std::string > vecPreserveVariableStrings;
-    ParseVariableList(strPreserveVariables, vecPreserveVariableStrings);
+    // Checkpoints record the partial map of finite volume to finite
+    // volume maps, which take the longest to compute
+    if (options.strCheckpointFile != "") {
+        if ((eInputType != DiscretizationType_FV) ||
+            (eOutputType != DiscretizationType_FV)
+        ) {
+            _EXCEPTIONT("--checkpoint requires --in_type fv and --out_type fv");
+        }
+        if (ParseNonConservativeMethod(options.strMethod)
+            != NonConservativeMethod_Conservative
+        ) {
+            _EXCEPTIONT("--checkpoint requires --method conserve");
+        }
+    }
+    if (options.fRestart && (options.strCheckpointFile == "")) {
+        _EXCEPTIONT("--restart requires --checkpoint");
+    }
 
-    if (fPreserveAll && (vecPreserveVariableStrings.size() != 0)) {
-        _EXCEPTIONT("--preserveall and --preserve cannot both be specified");
+    // Non-conservative maps are generated without the overlap mesh
+    const NonConservativeMethod eMethod =
+        ParseNonConservativeMethod(options.strMethod);
+
+    if (eMethod != NonConservativeMethod_Conservative) {
+        if (eInputType != DiscretizationType_FV) {
+            _EXCEPTION1("--method %s requires --in_type fv",
+                options.strMethod.c_str());
+        }
+        if (options.fReorderFaces) {
+            _EXCEPTION1("--method %s cannot be used with --reorder",
+                options.strMethod.c_str());
+        }
+
+        GenerateOfflineMapNonConservative(
+            mapRemap,
+            meshInput,
+            meshOutput,
+            options,
+            eMethod,
+            fInputPrepared);
+
+        return;
+    }
+
+    // Compute the map on meshes reordered for locality
+    if (options.fReorderFaces) {
+        if ((eInputType != DiscretizationType_FV) ||
+            (eOutputType != DiscretizationType_FV)
+        ) {
+            _EXCEPTIONT("Face reordering requires --in_type fv and "
+                "--out_type fv");
+        }
+
+        GenerateOfflineMapReordered(
+            mapRemap,
+            meshInput,
+            meshOutput,
+            meshOverlap,
+            options,
+            fInputPrepared,
+            fOverlapPrepared);
+
+        return;
     }
 
     // Calculate Face areas
-    AnnounceStartBlock("Calculating input mesh Face areas");
-    double dTotalAreaInput = meshInput.CalculateFaceAreas(fInputConcave);
-    Announce("Input Mesh Geometric Area: %1.15e", dTotalAreaInput);
-    AnnounceEndBlock(NULL);
+    double dTotalAreaInput = 0.0;
+    if (fInputPrepared) {
+        dTotalAreaInput = meshInput.SumFaceAreas(nThreads);
+
+    } else {
+        AnnounceStartBlock("Calculating input mesh Face areas");
+        dTotalAreaInput = meshInput.CalculateFaceAreas(fInputConcave, nThreads);
+        Announce("Input Mesh Geometric Area: %1.15e", dTotalAreaInput);
+        AnnounceEndBlock(NULL);
+    }
 
     // Input mesh areas
     if (eInputType == DiscretizationType_FV) {
@@ -264,7 +814,7 @@ try {
 
     // Calculate Face areas
     AnnounceStartBlock("Calculating output mesh Face areas");
-    Real dTotalAreaOutput = meshOutput.CalculateFaceAreas(fOutputConcave);
+    Real dTotalAreaOutput = meshOutput.CalculateFaceAreas(fOutputConcave, nThreads);
     Announce("Output Mesh Geometric Area: %1.15e", dTotalAreaOutput);
     AnnounceEndBlock(NULL);
 
@@ -277,56 +827,25 @@ try {
     }
 
     // Verify that overlap mesh is in the correct order
-    int ixSourceFaceMax = (-1);
-    int ixTargetFaceMax = (-1);
+    VerifyOverlapMeshCorrespondence(meshInput, meshOutput, meshOverlap);
 
-    if (meshOverlap.vecSourceFaceIx.size() !=
-        meshOverlap.vecTargetFaceIx.size()
-    ) {
-        _EXCEPTIONT("Invalid overlap mesh:\n"
-            "    Possible mesh file corruption?");
-    }
+    AnnounceEndBlock(NULL);
 
-    for (int i = 0; i < meshOverlap.vecSourceFaceIx.size(); i++) {
-        if (meshOverlap.vecSourceFaceIx[i] + 1 > ixSourceFaceMax) {
-            ixSourceFaceMax = meshOverlap.vecSourceFaceIx[i] + 1;
-        }
-        if (meshOverlap.vecTargetFaceIx[i] + 1 > ixTargetFaceMax) {
-            ixTargetFaceMax = meshOverlap.vecTargetFaceIx[i] + 1;
+    // Calculate Face areas
+    Real dTotalAreaOverlap = 0.0;
+    if (fOverlapPrepared) {
+        if (meshOverlap.vecFaceArea.GetRows() != meshOverlap.faces.size()) {
+            _EXCEPTIONT("Overlap mesh Face areas have not been computed");
         }
-    }
-
-    // Check for forward correspondence in overlap mesh
-    if (ixSourceFaceMax == meshInput.faces.size() //&&
-        //(ixTargetFaceMax == meshOutput.faces.size())
-    ) {
-        Announce("Overlap mesh forward correspondence found");
-
-    // Check for reverse correspondence in overlap mesh
-    } else if (
-        ixSourceFaceMax == meshOutput.faces.size() //&&
-        //(ixTargetFaceMax == meshInput.faces.size())
-    ) {
-        Announce("Overlap mesh reverse correspondence found (reversing)");
+        dTotalAreaOverlap = meshOverlap.SumFaceAreas(nThreads);
 
-        // Reorder overlap mesh
-        meshOverlap.ExchangeFirstAndSecondMesh();
-
-    // No correspondence found
     } else {
-        _EXCEPTION2("Invalid overlap mesh:\n"
-            "    No correspondence found with input and output meshes (%i,%i)",
-            ixSourceFaceMax, ixTargetFaceMax);
+        AnnounceStartBlock("Calculating overlap mesh Face areas");
+        dTotalAreaOverlap = meshOverlap.CalculateFaceAreas(false, nThreads);
+        Announce("Overlap Mesh Area: %1.15e", dTotalAreaOverlap);
+        AnnounceEndBlock(NULL);
     }
 
-    AnnounceEndBlock(NULL);
-
-    // Calculate Face areas
-    AnnounceStartBlock("Calculating overlap mesh Face areas");
-    Real dTotalAreaOverlap = meshOverlap.CalculateFaceAreas(false);
-    Announce("Overlap Mesh Area: %1.15e", dTotalAreaOverlap);
-    AnnounceEndBlock(NULL);
-
     // Partial cover
     if (fabs(dTotalAreaOverlap - dTotalAreaInput) > 1.0e-10) {
         if (!fNoCheck) {
@@ -352,16 +871,44 @@ try {
     ) {
 
         // Generate reverse node array and edge map
-        meshInput.ConstructReverseNodeArray();
-        meshInput.ConstructEdgeMap();
+        if (!fInputPrepared) {
+            meshInput.ConstructReverseNodeArray();
+            meshInput.ConstructEdgeMap();
+            meshInput.ConstructFaceNeighbors(nThreads);
+        }
+
+        PrepareReconstructionStencils(
+            meshInput, nPin, options.strSourcePrepared, nThreads);
 
         // Initialize coordinates for map
         mapRemap.InitializeSourceCoordinatesFromMeshFV(meshInput);
         mapRemap.InitializeTargetCoordinatesFromMeshFV(meshOutput);
 
+        // Checkpoint the partial map
+        CheckpointFile checkpoint;
+        if (options.strCheckpointFile != "") {
+            checkpoint.Open(
+                options.strCheckpointFile,
+                BuildOfflineMapCheckpointKey(
+                    meshInput, meshOutput, meshOverlap, options),
+                options.fRestart,
+                options.dCheckpointInterval);
+        }
+
         // Construct OfflineMap
         AnnounceStartBlock("Calculating offline map");
-        LinearRemapFVtoFV(meshInput, meshOutput, meshOverlap, nPin, mapRemap);
+        LinearRemapFVtoFV(
+            meshInput,
+            meshOutput,
+            meshOverlap,
+            nPin,
+            mapRemap,
+            nThreads,
+            GetSourceFitArrayCache(
+                pSourceData, meshInput, nPin, false, fVolumetric),
+            checkpoint.IsOpen() ? (&checkpoint) : NULL);
+
+        checkpoint.Remove();
 
     // Finite volume input / Finite element output
     } else if (eInputType == DiscretizationType_FV) {
@@ -376,12 +923,14 @@ try {
         } else {
             AnnounceStartBlock("Generating output mesh meta data");
             double dNumericalArea =
-                GenerateMetaData(
+                GenerateMetaDataCached(
                     meshOutput,
                     nPout,
                     fBubble,
                     dataGLLNodes,
-                    dataGLLJacobian);
+                    dataGLLJacobian,
+                    options.strTargetMetaCache,
+                    nThreads);
 
             Announce("Output Mesh Numerical Area: %1.15e", dNumericalArea);
             AnnounceEndBlock(NULL);
@@ -408,8 +957,14 @@ try {
         }
 
         // Generate reverse node array and edge map
-        meshInput.ConstructReverseNodeArray();
-        meshInput.ConstructEdgeMap();
+        if (!fInputPrepared) {
+            meshInput.ConstructReverseNodeArray();
+            meshInput.ConstructEdgeMap();
+            meshInput.ConstructFaceNeighbors(nThreads);
+        }
+
+        PrepareReconstructionStencils(
+            meshInput, nPin, options.strSourcePrepared, nThreads);
 
         // Generate remap weights
         AnnounceStartBlock("Calculating offline map");
@@ -426,7 +981,10 @@ try {
                 mapRemap,
                 nMonotoneType,
                 fContinuous,
-                fNoConservation);
+                fNoConservation,
+                nThreads,
+                GetSourceFitArrayCache(
+                    pSourceData, meshInput, nPin, true, fVolumetric));
 
         } else {
             LinearRemapFVtoGLL(
@@ -440,7 +998,10 @@ try {
                 mapRemap,
                 nMonotoneType,
                 fContinuous,
-                fNoConservation);
+                fNoConservation,
+                nThreads,
+                GetSourceFitArrayCache(
+                    pSourceData, meshInput, nPin, true, fVolumetric));
         }
 
     // Finite element input / Finite volume output
@@ -456,15 +1017,21 @@ try {
             LoadMetaDataFile(strInputMeta, dataGLLNodes, dataGLLJacobian);
             AnnounceEndBlock(NULL);
 
+        } else if (HasSourceMetaData(pSourceData, meshInput, nPin, fBubble)) {
+            dataGLLNodes = pSourceData->dataGLLNodes;
+            dataGLLJacobian = pSourceData->dataGLLJacobian;
+
         } else {
             AnnounceStartBlock("Generating input mesh meta data");
             double dNumericalArea =
-                GenerateMetaData(
+                GenerateMetaDataCached(
                     meshInput,
                     nPin,
                     fBubble,
                     dataGLLNodes,
-                    dataGLLJacobian);
+                    dataGLLJacobian,
+                    options.strSourceMetaCache,
+                    nThreads);
 
             Announce("Input Mesh Numerical Area: %1.15e", dNumericalArea);
             AnnounceEndBlock(NULL);
@@ -517,7 +1084,8 @@ try {
             nMonotoneType,
             fContinuousIn,
             fNoConservation,
-            mapRemap
+            mapRemap,
+            nThreads
         );
 
     // Finite element input / Finite element output
@@ -538,15 +1106,21 @@ try {
                 strInputMeta, dataGLLNodesIn, dataGLLJacobianIn);
             AnnounceEndBlock(NULL);
 
+        } else if (HasSourceMetaData(pSourceData, meshInput, nPin, fBubble)) {
+            dataGLLNodesIn = pSourceData->dataGLLNodes;
+            dataGLLJacobianIn = pSourceData->dataGLLJacobian;
+
         } else {
             AnnounceStartBlock("Generating input mesh meta data");
             double dNumericalAreaIn =
-                GenerateMetaData(
+                GenerateMetaDataCached(
                     meshInput,
                     nPin,
                     fBubble,
                     dataGLLNodesIn,
-                    dataGLLJacobianIn);
+                    dataGLLJacobianIn,
+                    options.strSourceMetaCache,
+                    nThreads);
 
             Announce("Input Mesh Numerical Area: %1.15e", dNumericalAreaIn);
             AnnounceEndBlock(NULL);
@@ -567,12 +1141,14 @@ try {
         } else {
             AnnounceStartBlock("Generating output mesh meta data");
             double dNumericalAreaOut =
-                GenerateMetaData(
+                GenerateMetaDataCached(
                     meshOutput,
                     nPout,
                     fBubble,
                     dataGLLNodesOut,
-                    dataGLLJacobianOut);
+                    dataGLLJacobianOut,
+                    options.strTargetMetaCache,
+                    nThreads);
 
             Announce("Output Mesh Numerical Area: %1.15e", dNumericalAreaOut);
             AnnounceEndBlock(NULL);
@@ -637,69 +1213,365 @@ try {
             fContinuousIn,
             fContinuousOut,
             fNoConservation,
-            mapRemap
+            mapRemap,
+            nThreads
         );
 
     } else {
         _EXCEPTIONT("Not implemented");
     }
 
+    // Assembly is complete; compress the map
+    mapRemap.GetSparseMatrix().Freeze();
+
+    // Remove small and masked weights
+    if ((options.dPruneThreshold > 0.0) || options.fPruneMasked) {
+        mapRemap.SetThreadCount(options.nThreads);
+        mapRemap.Prune(options.dPruneThreshold, options.fPruneMasked);
+    }
+
 //#pragma warning "NOTE: VERIFICATION DISABLED"
 
     // Verify consistency, conservation and monotonicity
     if (!fNoCheck) {
         AnnounceStartBlock("Verifying map");
-        mapRemap.IsConsistent(1.0e-8);
-        mapRemap.IsConservative(1.0e-8);
-
-        if (nMonotoneType != 0) {
-            mapRemap.IsMonotone(1.0e-12);
-        }
+        mapRemap.SetThreadCount(options.nThreads);
+        mapRemap.Verify(1.0e-8, 1.0e-8, (nMonotoneType != 0), 1.0e-12);
         AnnounceEndBlock(NULL);
     }
 
     AnnounceEndBlock(NULL);
+}
 
-    // Initialize element dimensions from input/output Mesh
-    AnnounceStartBlock("Writing output");
-
-    // Output the Offline Map
-    if (strOutputMap != "") {
-        AnnounceStartBlock("Writing offline map");
+///////////////////////////////////////////////////////////////////////////////
 
-		typedef std::map<std::string, std::string> AttributeMap;
-		typedef AttributeMap::value_type AttributePair;
+///	<summary>
+///		Write an offline map generated with the given options, together
+///		with the attributes describing how it was generated.
+///	</summary>
+static void WriteOfflineMapFile(
+	OfflineMap & mapRemap,
+	const std::string & strOutputMap,
+	const Mesh & meshInput,
+	const Mesh & meshOutput,
+	const std::string & strOverlapFile,
+	const OfflineMapOptions & options,
+	NcFile::FileFormat eOutputFormat
+) {
+	typedef std::map<std::string, std::string> AttributeMap;
+	typedef AttributeMap::value_type AttributePair;
 
-		AttributeMap mapAttributes;
+	AttributeMap mapAttributes;
 
-		mapAttributes.insert(AttributePair("domain_a", meshInput.strFileName));
-		mapAttributes.insert(AttributePair("domain_b", meshOutput.strFileName));
-		mapAttributes.insert(AttributePair("grid_file_src", meshInput.strFileName));
-		mapAttributes.insert(AttributePair("grid_file_dst", meshOutput.strFileName));
-		mapAttributes.insert(AttributePair("grid_file_ovr", meshOverlap.strFileName));
-		if (strInputMeta != "") {
-			mapAttributes.insert(AttributePair("meta_src", strInputMeta));
-		}
-		if (strOutputMeta != "") {
-			mapAttributes.insert(AttributePair("meta_dst", strOutputMeta));
+	mapAttributes.insert(AttributePair("domain_a", meshInput.strFileName));
+	mapAttributes.insert(AttributePair("domain_b", meshOutput.strFileName));
+	mapAttributes.insert(AttributePair("grid_file_src", meshInput.strFileName));
+	mapAttributes.insert(AttributePair("grid_file_dst", meshOutput.strFileName));
+	if (strOverlapFile != "") {
+		mapAttributes.insert(AttributePair("grid_file_ovr", strOverlapFile));
+	}
+	if (options.strSourceMeta != "") {
+		mapAttributes.insert(AttributePair("meta_src", options.strSourceMeta));
+	}
+	if (options.strTargetMeta != "") {
+		mapAttributes.insert(AttributePair("meta_dst", options.strTargetMeta));
+	}
+	mapAttributes.insert(AttributePair("type_src", options.strSourceType));
+	mapAttributes.insert(AttributePair("type_dst", options.strTargetType));
+	mapAttributes.insert(AttributePair("np_src", std::to_string((long long)options.nPin)));
+	mapAttributes.insert(AttributePair("np_dst", std::to_string((long long)options.nPout)));
+	mapAttributes.insert(AttributePair("bubble", (options.fBubble)?("true"):("false")));
+	mapAttributes.insert(AttributePair("mono_type", std::to_string((long long)options.nMonotoneType)));
+	if (options.fVolumetric) {
+		mapAttributes.insert(AttributePair("volumetric", "true"));
+	}
+	if (options.fNoConservation) {
+		mapAttributes.insert(AttributePair("no_conserve", "true"));
+	}
+	if (options.dPruneThreshold > 0.0) {
+		char szThreshold[32];
+		snprintf(szThreshold, sizeof(szThreshold), "%1.5e", options.dPruneThreshold);
+		mapAttributes.insert(AttributePair("prune_threshold", szThreshold));
+	}
+	if (options.fPruneMasked) {
+		mapAttributes.insert(AttributePair("prune_masked", "true"));
+	}
+	if (ParseNonConservativeMethod(options.strMethod)
+		!= NonConservativeMethod_Conservative
+	) {
+		mapAttributes.insert(AttributePair("method", options.strMethod));
+	}
+	mapAttributes.insert(AttributePair("concave_src", (options.fSourceConcave)?("true"):("false")));
+	mapAttributes.insert(AttributePair("concave_dst", (options.fTargetConcave)?("true"):("false")));
+	mapAttributes.insert(AttributePair("version", g_strVersion));
+
+	mapRemap.SetThreadCount(options.nThreads);
+	mapRemap.Write(strOutputMap, mapAttributes, eOutputFormat);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Build the key in a GeneratedMapCache of the map generated from the
+///		given meshes and options.  The key covers the contents of the
+///		meshes and meta data files, the file names recorded in the
+///		attributes of the map and every option that affects the map file,
+///		but not the number of threads or whether the map is checked.
+///	</summary>
+static void BuildOfflineMapCacheKey(
+	GeneratedMapCache & cache,
+	const OfflineMap & mapRemap,
+	const Mesh & meshInput,
+	const Mesh & meshOutput,
+	const Mesh & meshOverlap,
+	const OfflineMapOptions & options,
+	const std::string & strOutputFormat
+) {
+	cache.AddKey("version", g_strVersion);
+
+	cache.AddMeshKey("mesh_src", meshInput, options.nThreads);
+	cache.AddMeshKey("mesh_dst", meshOutput, options.nThreads);
+	cache.AddMeshKey("mesh_ovr", meshOverlap, options.nThreads);
+	cache.AddFileKey("meta_src", options.strSourceMeta);
+	cache.AddFileKey("meta_dst", options.strTargetMeta);
+
+	// Cached maps carry the provenance attributes of the run that wrote
+	// them, so these must match the attributes of this run
+	cache.AddKey("grid_file_src", meshInput.strFileName);
+	cache.AddKey("grid_file_dst", meshOutput.strFileName);
+	cache.AddKey("grid_file_ovr", meshOverlap.strFileName);
+	cache.AddKey("meta_file_src", options.strSourceMeta);
+	cache.AddKey("meta_file_dst", options.strTargetMeta);
+
+	for (int s = 0; s < 2; s++) {
+		const std::vector<int> & vecDimSizes =
+			(s == 0)?(mapRemap.GetSourceDimensionSizes())
+			        :(mapRemap.GetTargetDimensionSizes());
+		const std::vector<std::string> & vecDimNames =
+			(s == 0)?(mapRemap.GetSourceDimensionNames())
+			        :(mapRemap.GetTargetDimensionNames());
+
+		std::string strDims;
+		for (int d = 0; d < vecDimSizes.size(); d++) {
+			if (d != 0) {
+				strDims += ",";
+			}
+			if (d < vecDimNames.size()) {
+				strDims += vecDimNames[d] + ":";
+			}
+			strDims += std::to_string((long long)vecDimSizes[d]);
 		}
-		mapAttributes.insert(AttributePair("type_src", strInputType));
-		mapAttributes.insert(AttributePair("type_dst", strOutputType));
-		mapAttributes.insert(AttributePair("np_src", std::to_string((long long)nPin)));
-		mapAttributes.insert(AttributePair("np_dst", std::to_string((long long)nPout)));
-		mapAttributes.insert(AttributePair("bubble", (fBubble)?("true"):("false")));
-		mapAttributes.insert(AttributePair("mono_type", std::to_string((long long)fMonotoneTypeID)));
-		if (fVolumetric) {
-			mapAttributes.insert(AttributePair("volumetric", "true"));
+		cache.AddKey((s == 0)?("dims_src"):("dims_dst"), strDims);
+	}
+
+	std::string strSourceType = options.strSourceType;
+	std::string strTargetType = options.strTargetType;
+	STLStringHelper::ToLower(strSourceType);
+	STLStringHelper::ToLower(strTargetType);
+
+	cache.AddKey("type_src", strSourceType);
+	cache.AddKey("type_dst", strTargetType);
+	cache.AddKey("np_src", options.nPin);
+	cache.AddKey("np_dst", options.nPout);
+	cache.AddKey("bubble", static_cast<int>(options.fBubble));
+	cache.AddKey("mono_type", options.nMonotoneType);
+	cache.AddKey("volumetric", static_cast<int>(options.fVolumetric));
+	cache.AddKey("no_conserve", static_cast<int>(options.fNoConservation));
+	cache.AddKey("concave_src", static_cast<int>(options.fSourceConcave));
+	cache.AddKey("concave_dst", static_cast<int>(options.fTargetConcave));
+	cache.AddKey("reorder", static_cast<int>(options.fReorderFaces));
+	cache.AddKey("prune_threshold", options.dPruneThreshold);
+	cache.AddKey("prune_masked", static_cast<int>(options.fPruneMasked));
+	if (ParseNonConservativeMethod(options.strMethod)
+		!= NonConservativeMethod_Conservative
+	) {
+		std::string strMethod = options.strMethod;
+		STLStringHelper::ToLower(strMethod);
+		cache.AddKey("method", strMethod);
+	}
+
+	int nDeflateLevel;
+	int nQuantizeBits;
+	mapRemap.GetWriteCompression(nDeflateLevel, nQuantizeBits);
+
+	cache.AddKey("out_format", strOutputFormat);
+	cache.AddKey("out_deflate", nDeflateLevel);
+	cache.AddKey("out_quantize", nQuantizeBits);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+extern "C"
+int GenerateOfflineMapWithMeshes(
+	OfflineMap& mapRemap,
+	Mesh& meshInput,
+	Mesh& meshOutput,
+	Mesh& meshOverlap,
+	std::string strInputMeta,
+	std::string strOutputMeta,
+	std::string strInputType, std::string strOutputType,
+	int nPin, int nPout,
+	bool fBubble, int fMonotoneTypeID,
+	bool fVolumetric, bool fNoConservation, bool fNoCheck,
+	std::string strVariables, std::string strOutputMap,
+	std::string strInputData, std::string strOutputData,
+	std::string strNColName, bool fOutputDouble,
+	std::string strOutputFormat,
+	std::string strPreserveVariables, bool fPreserveAll, double dFillValueOverride,
+	bool fInputConcave, bool fOutputConcave,
+	int nThreads,
+	bool fReorderFaces,
+	std::string strInputMetaCache,
+	std::string strOutputMetaCache,
+	std::string strInputPrepared,
+	double dPruneThreshold,
+	bool fPruneMasked,
+	std::string strMapCacheDir,
+	std::string strMethod,
+	std::string strCheckpointFile,
+	bool fRestart,
+	double dCheckpointInterval
+) {
+	NcError error(NcError::silent_nonfatal);
+
+try {
+
+	if (nThreads < 1) {
+		_EXCEPTIONT("--nthreads must be at least 1");
+	}
+
+    // Check command line parameters (data arguments)
+    if ((strInputData != "") && (strOutputData == "")) {
+        _EXCEPTIONT("--in_data specified without --out_data");
+    }
+    if ((strInputData == "") && (strOutputData != "")) {
+        _EXCEPTIONT("--out_data specified without --in_data");
+    }
+
+    // Check command line parameters (data type arguments)
+    STLStringHelper::ToLower(strOutputFormat);
+
+	NcFile::FileFormat eOutputFormat =
+		GetNcFileFormatFromString(strOutputFormat);
+	if (eOutputFormat == NcFile::BadFormat) {
+		_EXCEPTION1("Invalid \"out_format\" value (%s), "
+			"expected [Classic|Offset64Bits|Netcdf4|Netcdf4Classic]",
+			strOutputFormat.c_str());
+	}
+   
+    // Parse variable list
+    std::vector< std::string > vecVariableStrings;
+    ParseVariableList(strVariables, vecVariableStrings);
+
+    // Parse preserve variable list
+    std::vector< std::string > vecPreserveVariableStrings;
+    ParseVariableList(strPreserveVariables, vecPreserveVariableStrings);
+
+    if (fPreserveAll && (vecPreserveVariableStrings.size() != 0)) {
+        _EXCEPTIONT("--preserveall and --preserve cannot both be specified");
+    }
+
+    // Generate the offline map
+    OfflineMapOptions options;
+    options.strSourceType = strInputType;
+    options.strTargetType = strOutputType;
+    options.strSourceMeta = strInputMeta;
+    options.strTargetMeta = strOutputMeta;
+    options.strSourceMetaCache = strInputMetaCache;
+    options.strTargetMetaCache = strOutputMetaCache;
+    options.strSourcePrepared = strInputPrepared;
+    options.nPin = nPin;
+    options.nPout = nPout;
+    options.fBubble = fBubble;
+    options.nMonotoneType = fMonotoneTypeID;
+    options.fVolumetric = fVolumetric;
+    options.fNoConservation = fNoConservation;
+    options.fNoCheck = fNoCheck;
+    options.fSourceConcave = fInputConcave;
+    options.fTargetConcave = fOutputConcave;
+    options.nThreads = nThreads;
+    options.fReorderFaces = fReorderFaces;
+    options.dPruneThreshold = dPruneThreshold;
+    options.fPruneMasked = fPruneMasked;
+    options.strMethod = strMethod;
+    options.strCheckpointFile = strCheckpointFile;
+    options.fRestart = fRestart;
+    options.dCheckpointInterval = dCheckpointInterval;
+
+    // Copy a map generated from identical inputs from the map cache
+    GeneratedMapCache cache;
+
+    if (strMapCacheDir != "") {
+        if (strOutputMap == "") {
+            _EXCEPTIONT("--map_cache_dir requires --out_map");
+        }
+        if (strInputData != "") {
+            _EXCEPTIONT("--map_cache_dir cannot be combined with --in_data");
+        }
+
+        AnnounceStartBlock("Checking map cache");
+        cache.Open(strMapCacheDir);
+        BuildOfflineMapCacheKey(
+            cache, mapRemap, meshInput, meshOutput, meshOverlap,
+            options, strOutputFormat);
+
+        const bool fCached = cache.Lookup();
+        if (fCached) {
+            Announce("Using cached map %s", cache.GetMapPath().c_str());
+            GeneratedMapCache::Copy(cache.GetMapPath(), strOutputMap);
+        } else {
+            Announce("Map not in cache");
+        }
+        AnnounceEndBlock(NULL);
+
+        if (fCached) {
+            return (0);
+        }
+    }
+
+    // Overlap Face areas are stored in overlap mesh files written by
+    // GenerateOverlapMesh and need not be recomputed
+    const bool fOverlapPrepared =
+        (meshOverlap.vecFaceArea.GetRows() == meshOverlap.faces.size());
+
+    GenerateOfflineMapWithOptions(
+        mapRemap, meshInput, meshOutput, meshOverlap, options,
+        false, fOverlapPrepared);
+
+    // Initialize element dimensions from input/output Mesh
+    AnnounceStartBlock("Writing output");
+
+    // Output the Offline Map
+    if (strOutputMap != "") {
+        AnnounceStartBlock("Writing offline map");
+
+		// Maps are written into the cache and copied to the output
+		std::string strWriteMap = strOutputMap;
+		if (strMapCacheDir != "") {
+			strWriteMap = cache.GetTemporaryPath();
 		}
-		if (fNoConservation) {
-			mapAttributes.insert(AttributePair("no_conserve", "true"));
+
+		try {
+			WriteOfflineMapFile(
+				mapRemap,
+				strWriteMap,
+				meshInput,
+				meshOutput,
+				meshOverlap.strFileName,
+				options,
+				eOutputFormat);
+
+		} catch(...) {
+			if (strMapCacheDir != "") {
+				remove(strWriteMap.c_str());
+			}
+			throw;
 		}
-		mapAttributes.insert(AttributePair("concave_src", (fInputConcave)?("true"):("false")));
-		mapAttributes.insert(AttributePair("concave_dst", (fOutputConcave)?("true"):("false")));
-		mapAttributes.insert(AttributePair("version", g_strVersion));
 
-        mapRemap.Write(strOutputMap, mapAttributes, eOutputFormat);
+		if (strMapCacheDir != "") {
+			cache.Commit();
+			GeneratedMapCache::Copy(cache.GetMapPath(), strOutputMap);
+		}
         AnnounceEndBlock(NULL);
     }
 
@@ -708,6 +1580,7 @@ try {
         AnnounceStartBlock("Applying offline map to data");
 
         mapRemap.SetFillValueOverride(static_cast<float>(dFillValueOverride));
+        mapRemap.SetThreadCount(nThreads);
         mapRemap.Apply(
             strInputData,
             strOutputData,
@@ -760,7 +1633,12 @@ int GenerateOfflineMap( OfflineMap& mapRemap, std::string strInputMesh, std::str
 						std::string strNColName, bool fOutputDouble,
                                                 std::string strOutputFormat,
 						std::string strPreserveVariables, bool fPreserveAll, double dFillValueOverride,
-						bool fInputConcave, bool fOutputConcave )
+						bool fInputConcave, bool fOutputConcave,
+						int nThreads, bool fReorderFaces, bool fCachePrepared,
+						double dPruneThreshold, bool fPruneMasked,
+						std::string strMapCacheDir, std::string strMethod,
+						std::string strCheckpointFile, bool fRestart,
+						double dCheckpointInterval, double dMemoryLimitMB )
 {
 	NcError error(NcError::silent_nonfatal);
 
@@ -781,8 +1659,12 @@ try {
 		_EXCEPTIONT("No output mesh (--out_mesh) specified");
 	}
 
-	// Overlap mesh
-	if (strOverlapMesh == "") {
+	// Overlap mesh, which is not used by non-conservative maps
+	const bool fConservative =
+		(ParseNonConservativeMethod(strMethod)
+			== NonConservativeMethod_Conservative);
+
+	if (fConservative && (strOverlapMesh == "")) {
 		_EXCEPTIONT("No overlap mesh specified");
 	}
 
@@ -806,10 +1688,63 @@ try {
 	meshOutput.RemoveZeroEdges();
 	AnnounceEndBlock(NULL);
 
+	// Plan the remaining stages within the memory limit
+	if (dMemoryLimitMB > 0.0) {
+		OfflineMapOptions optionsPlan;
+		optionsPlan.strSourceType = strInputType;
+		optionsPlan.strTargetType = strOutputType;
+		optionsPlan.nPin = nPin;
+		optionsPlan.nPout = nPout;
+		optionsPlan.nThreads = nThreads;
+		optionsPlan.fReorderFaces = fReorderFaces;
+		optionsPlan.strMethod = strMethod;
+
+		OfflineMapMemoryPlan plan;
+		PlanOfflineMapMemory(
+			meshInput,
+			meshOutput,
+			fConservative ? strOverlapMesh : "",
+			optionsPlan,
+			(strInputData != ""),
+			dMemoryLimitMB,
+			mapRemap.GetBatchSize(),
+			plan);
+
+		AnnounceOfflineMapMemoryPlan(plan);
+
+		nThreads = plan.nThreads;
+		fReorderFaces = plan.fReorderFaces;
+		mapRemap.SetBatchSize(plan.nApplyBatchSize);
+	}
+
 	// Load overlap mesh
-	AnnounceStartBlock("Loading overlap mesh");
-	Mesh meshOverlap(strOverlapMesh);
-	meshOverlap.RemoveZeroEdges();
+	Mesh meshOverlap;
+	if (fConservative) {
+		AnnounceStartBlock("Loading overlap mesh");
+		LoadOverlapMesh(
+			strOverlapMesh, meshInput, meshOutput, meshOverlap, nThreads);
+		meshOverlap.RemoveZeroEdges();
+	}
+
+	// Cache finite element meta data in <mesh>.np#.meta.prep sidecar files;
+	// these are only used for finite element meshes
+	std::string strInputMetaCache;
+	std::string strOutputMetaCache;
+
+	// Cache finite volume reconstruction stencils in the <mesh>.prep
+	// prepared mesh file of the input mesh
+	std::string strInputPrepared;
+
+	if (fCachePrepared) {
+		strInputPrepared = strInputMesh + ".prep";
+
+		char szCacheExt[32];
+		snprintf(szCacheExt, sizeof(szCacheExt), ".np%i.meta.prep", nPin);
+		strInputMetaCache = strInputMesh + szCacheExt;
+
+		snprintf(szCacheExt, sizeof(szCacheExt), ".np%i.meta.prep", nPout);
+		strOutputMetaCache = strOutputMesh + szCacheExt;
+	}
 
     int err = GenerateOfflineMapWithMeshes(mapRemap, meshInput, meshOutput, meshOverlap,
                                             strInputMeta, strOutputMeta,
@@ -821,7 +1756,14 @@ try {
                                             strInputData, strOutputData,
                                             strNColName, fOutputDouble, strOutputFormat,
                                             strPreserveVariables, fPreserveAll, dFillValueOverride,
-                                            fInputConcave, fOutputConcave );
+                                            fInputConcave, fOutputConcave,
+                                            nThreads, fReorderFaces,
+                                            strInputMetaCache, strOutputMetaCache,
+                                            strInputPrepared,
+                                            dPruneThreshold, fPruneMasked,
+                                            strMapCacheDir, strMethod,
+                                            strCheckpointFile, fRestart,
+                                            dCheckpointInterval );
 
     return err;
 
@@ -836,6 +1778,550 @@ try {
 
 ///////////////////////////////////////////////////////////////////////////////
 
+extern "C"
+int GenerateRemapWeights(
+	OfflineMap & mapRemap,
+	std::string strInputMesh,
+	std::string strOutputMesh,
+	std::string strOverlapMesh,
+	std::string strOverlapMethod,
+	std::string strInputMeta, std::string strOutputMeta,
+	std::string strInputType, std::string strOutputType,
+	int nPin, int nPout,
+	bool fBubble, int fMonotoneTypeID,
+	bool fVolumetric, bool fNoConservation, bool fNoCheck,
+	bool fInputConcave, bool fOutputConcave,
+	bool fAllowNoOverlap,
+	std::string strOutputMap,
+	std::string strOutputFormat,
+	int nThreads,
+	bool fReorderFaces
+) {
+	NcError error(NcError::silent_nonfatal);
+
+try {
+
+	// Check command line parameters (mesh arguments)
+	if (strInputMesh == "") {
+		_EXCEPTIONT("No input mesh (--in_mesh) specified");
+	}
+	if (strOutputMesh == "") {
+		_EXCEPTIONT("No output mesh (--out_mesh) specified");
+	}
+	if (nThreads < 1) {
+		_EXCEPTIONT("--nthreads must be at least 1");
+	}
+
+	// Check command line parameters (data type arguments)
+	STLStringHelper::ToLower(strOutputFormat);
+
+	NcFile::FileFormat eOutputFormat =
+		GetNcFileFormatFromString(strOutputFormat);
+	if (eOutputFormat == NcFile::BadFormat) {
+		_EXCEPTION1("Invalid \"out_format\" value (%s), "
+			"expected [Classic|Offset64Bits|Netcdf4|Netcdf4Classic]",
+			strOutputFormat.c_str());
+	}
+
+	// Initialize dimension information from file
+	AnnounceStartBlock("Initializing dimensions of map");
+	Announce("Input mesh");
+	mapRemap.InitializeSourceDimensionsFromFile(strInputMesh);
+	Announce("Output mesh");
+	mapRemap.InitializeTargetDimensionsFromFile(strOutputMesh);
+	AnnounceEndBlock(NULL);
+
+	// Load input mesh
+	AnnounceStartBlock("Loading input mesh");
+	Mesh meshInput(strInputMesh);
+	meshInput.RemoveZeroEdges();
+	AnnounceEndBlock(NULL);
+
+	// Load output mesh
+	AnnounceStartBlock("Loading output mesh");
+	Mesh meshOutput(strOutputMesh);
+	meshOutput.RemoveZeroEdges();
+	AnnounceEndBlock(NULL);
+
+	// The overlap mesh is generated from convex copies of concave meshes,
+	// but its face indices refer to the original meshes
+	Mesh meshInputConvex;
+	if (fInputConcave) {
+		ConvexifyMesh(meshInput, meshInputConvex, true, nThreads);
+	}
+
+	Mesh meshOutputConvex;
+	if (fOutputConcave) {
+		ConvexifyMesh(meshOutput, meshOutputConvex, true, nThreads);
+	}
+
+	Mesh & meshOverlapInput = (fInputConcave)?(meshInputConvex):(meshInput);
+	Mesh & meshOverlapOutput = (fOutputConcave)?(meshOutputConvex):(meshOutput);
+
+	// Construct the edge map on both meshes
+	AnnounceStartBlock("Constructing edge map on input mesh");
+	meshOverlapInput.ConstructEdgeMap();
+	AnnounceEndBlock(NULL);
+
+	AnnounceStartBlock("Constructing edge map on output mesh");
+	meshOverlapOutput.ConstructEdgeMap();
+	AnnounceEndBlock(NULL);
+
+	// Generate the overlap mesh in memory, writing it only if requested
+	Mesh meshOverlap;
+	GenerateOverlapWithMeshes(
+		meshOverlapInput,
+		meshOverlapOutput,
+		meshOverlap,
+		strOverlapMesh,
+		strOutputFormat,
+		strOverlapMethod,
+		fInputConcave,
+		fOutputConcave,
+		fAllowNoOverlap,
+		false,
+		nThreads);
+
+	if (meshOverlap.faces.size() == 0) {
+		_EXCEPTIONT("Unable to generate the overlap mesh");
+	}
+
+	meshOverlap.RemoveZeroEdges();
+
+	// Overlap Face areas are computed as the overlap mesh is generated
+	const bool fOverlapPrepared =
+		(meshOverlap.vecFaceArea.GetRows() == meshOverlap.faces.size());
+
+	// Generate the offline map
+	OfflineMapOptions options;
+	options.strSourceType = strInputType;
+	options.strTargetType = strOutputType;
+	options.strSourceMeta = strInputMeta;
+	options.strTargetMeta = strOutputMeta;
+	options.nPin = nPin;
+	options.nPout = nPout;
+	options.fBubble = fBubble;
+	options.nMonotoneType = fMonotoneTypeID;
+	options.fVolumetric = fVolumetric;
+	options.fNoConservation = fNoConservation;
+	options.fNoCheck = fNoCheck;
+	options.fSourceConcave = fInputConcave;
+	options.fTargetConcave = fOutputConcave;
+	options.strOverlapMethod = strOverlapMethod;
+	options.fAllowNoOverlap = fAllowNoOverlap;
+	options.nThreads = nThreads;
+	options.fReorderFaces = fReorderFaces;
+
+	GenerateOfflineMapWithOptions(
+		mapRemap,
+		meshInput,
+		meshOutput,
+		meshOverlap,
+		options,
+		false,
+		fOverlapPrepared);
+
+	// Output the Offline Map
+	if (strOutputMap != "") {
+		AnnounceStartBlock("Writing offline map");
+		WriteOfflineMapFile(
+			mapRemap,
+			strOutputMap,
+			meshInput,
+			meshOutput,
+			strOverlapMesh,
+			options,
+			eOutputFormat);
+		AnnounceEndBlock(NULL);
+	}
+
+	return (0);
+
+} catch(Exception & e) {
+	Announce(e.ToString().c_str());
+	return (-1);
+
+} catch(...) {
+	return (-1);
+}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+extern "C"
+int GenerateRemapWeightsMultiTarget(
+	std::string strInputMesh,
+	std::string strOutputMeshes,
+	std::string strOutputMaps,
+	std::string strOverlapMethod,
+	std::string strInputMeta,
+	std::string strInputType, std::string strOutputType,
+	int nPin, int nPout,
+	bool fBubble, int fMonotoneTypeID,
+	bool fVolumetric, bool fNoConservation, bool fNoCheck,
+	bool fAllowNoOverlap,
+	std::string strOutputFormat,
+	int nOutputDeflate, int nOutputQuantizeBits,
+	int nThreads,
+	int nConcurrentTargets,
+	bool fCacheFitArrays
+) {
+	NcError error(NcError::silent_nonfatal);
+
+try {
+
+	// Check command line parameters (mesh arguments)
+	if (strInputMesh == "") {
+		_EXCEPTIONT("No input mesh (--in_mesh) specified");
+	}
+
+	std::vector<std::string> vecOutputMeshes;
+	ParseVariableList(strOutputMeshes, vecOutputMeshes);
+
+	std::vector<std::string> vecOutputMaps;
+	ParseVariableList(strOutputMaps, vecOutputMaps);
+
+	if (vecOutputMeshes.size() == 0) {
+		_EXCEPTIONT("No output mesh (--out_mesh) specified");
+	}
+	if (vecOutputMaps.size() != vecOutputMeshes.size()) {
+		_EXCEPTION2("Number of output maps (%i) does not match "
+			"number of output meshes (%i)",
+			static_cast<int>(vecOutputMaps.size()),
+			static_cast<int>(vecOutputMeshes.size()));
+	}
+	if (nThreads < 1) {
+		_EXCEPTIONT("--nthreads must be at least 1");
+	}
+	if (nConcurrentTargets < 1) {
+		_EXCEPTIONT("--ntargets must be at least 1");
+	}
+
+	// Check command line parameters (data type arguments)
+	STLStringHelper::ToLower(strOutputFormat);
+
+	NcFile::FileFormat eOutputFormat =
+		GetNcFileFormatFromString(strOutputFormat);
+	if (eOutputFormat == NcFile::BadFormat) {
+		_EXCEPTION1("Invalid \"out_format\" value (%s), "
+			"expected [Classic|Offset64Bits|Netcdf4|Netcdf4Classic]",
+			strOutputFormat.c_str());
+	}
+
+	const int nTargets = static_cast<int>(vecOutputMeshes.size());
+
+	// Options shared by all maps
+	OfflineMapOptions options;
+	options.strSourceType = strInputType;
+	options.strTargetType = strOutputType;
+	options.strSourceMeta = strInputMeta;
+	options.nPin = nPin;
+	options.nPout = nPout;
+	options.fBubble = fBubble;
+	options.nMonotoneType = fMonotoneTypeID;
+	options.fVolumetric = fVolumetric;
+	options.fNoConservation = fNoConservation;
+	options.fNoCheck = fNoCheck;
+	options.strOverlapMethod = strOverlapMethod;
+	options.fAllowNoOverlap = fAllowNoOverlap;
+	options.fCacheSourceFitArrays = fCacheFitArrays;
+	options.nThreads = nThreads;
+
+	// Load and prepare the input mesh once
+	AnnounceStartBlock("Preparing input mesh");
+	Mesh meshInput(strInputMesh);
+
+	OfflineMapGenerator generator(options);
+	generator.SetSourceMesh(meshInput);
+	AnnounceEndBlock(NULL);
+
+	// Load output meshes and initialize map dimensions
+	AnnounceStartBlock("Loading output meshes");
+	std::vector<Mesh> vecMeshOutput(nTargets);
+	std::vector<OfflineMap> vecMapRemap(nTargets);
+
+	for (int i = 0; i < nTargets; i++) {
+		Announce("%s", vecOutputMeshes[i].c_str());
+		vecMeshOutput[i].Read(vecOutputMeshes[i]);
+
+		vecMapRemap[i].InitializeSourceDimensionsFromFile(strInputMesh);
+		vecMapRemap[i].InitializeTargetDimensionsFromFile(vecOutputMeshes[i]);
+		vecMapRemap[i].SetWriteCompression(nOutputDeflate, nOutputQuantizeBits);
+	}
+	AnnounceEndBlock(NULL);
+
+	// Generate all offline maps
+	AnnounceStartBlock("Calculating offline maps");
+
+	std::vector<const Mesh *> vecTargets(nTargets);
+	std::vector<OfflineMap *> vecMaps(nTargets);
+	for (int i = 0; i < nTargets; i++) {
+		vecTargets[i] = &(vecMeshOutput[i]);
+		vecMaps[i] = &(vecMapRemap[i]);
+	}
+
+	generator.Generate(vecTargets, vecMaps, nConcurrentTargets);
+	AnnounceEndBlock(NULL);
+
+	// Output the offline maps
+	AnnounceStartBlock("Writing offline maps");
+	for (int i = 0; i < nTargets; i++) {
+		Announce("%s", vecOutputMaps[i].c_str());
+		WriteOfflineMapFile(
+			vecMapRemap[i],
+			vecOutputMaps[i],
+			meshInput,
+			vecMeshOutput[i],
+			"",
+			options,
+			eOutputFormat);
+	}
+	AnnounceEndBlock(NULL);
+
+	return (0);
+
+} catch(Exception & e) {
+	Announce(e.ToString().c_str());
+	return (-1);
+
+} catch(...) {
+	return (-1);
+}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+extern "C"
+int GenerateOfflineMapUpdate(
+	OfflineMap & mapRemap,
+	std::string strInputMap,
+	std::string strInputMesh,
+	std::string strOutputMesh,
+	std::string strOverlapMesh,
+	std::string strChangedSourceFaces,
+	std::string strChangedTargetFaces,
+	int nPin,
+	bool fNoCheck,
+	std::string strOutputMap,
+	std::string strOutputFormat,
+	bool fInputConcave,
+	bool fOutputConcave,
+	int nThreads
+) {
+	NcError error(NcError::silent_nonfatal);
+
+try {
+
+	if (nThreads < 1) {
+		_EXCEPTIONT("--nthreads must be at least 1");
+	}
+
+	// Check command line parameters (mesh arguments)
+	if (strInputMap == "") {
+		_EXCEPTIONT("No previous map (--in_map) specified");
+	}
+	if (strInputMesh == "") {
+		_EXCEPTIONT("No input mesh (--in_mesh) specified");
+	}
+	if (strOutputMesh == "") {
+		_EXCEPTIONT("No output mesh (--out_mesh) specified");
+	}
+	if (strOverlapMesh == "") {
+		_EXCEPTIONT("No overlap mesh specified");
+	}
+
+	STLStringHelper::ToLower(strOutputFormat);
+
+	NcFile::FileFormat eOutputFormat =
+		GetNcFileFormatFromString(strOutputFormat);
+	if (eOutputFormat == NcFile::BadFormat) {
+		_EXCEPTION1("Invalid \"out_format\" value (%s), "
+			"expected [Classic|Offset64Bits|Netcdf4|Netcdf4Classic]",
+			strOutputFormat.c_str());
+	}
+
+	// Load the previous map
+	AnnounceStartBlock("Loading previous map");
+
+	typedef std::map<std::string, std::string> AttributeMap;
+
+	AttributeMap mapAttributes;
+
+	mapRemap.Read(strInputMap, &mapAttributes);
+
+	AttributeMap::const_iterator iterAttribute;
+
+	iterAttribute = mapAttributes.find("type_src");
+	if ((iterAttribute != mapAttributes.end()) && (iterAttribute->second != "fv")) {
+		_EXCEPTION1("Only maps with type_src \"fv\" can be updated (found \"%s\")",
+			iterAttribute->second.c_str());
+	}
+	iterAttribute = mapAttributes.find("type_dst");
+	if ((iterAttribute != mapAttributes.end()) && (iterAttribute->second != "fv")) {
+		_EXCEPTION1("Only maps with type_dst \"fv\" can be updated (found \"%s\")",
+			iterAttribute->second.c_str());
+	}
+	iterAttribute = mapAttributes.find("np_src");
+	if ((iterAttribute != mapAttributes.end()) &&
+	    (iterAttribute->second != std::to_string((long long)nPin))
+	) {
+		_EXCEPTION2("Previous map has np_src %s, but --in_np is %i",
+			iterAttribute->second.c_str(), nPin);
+	}
+
+	// Areas of the previous map, used to detect changed Faces
+	DataArray1D<double> dPreviousSourceAreas(mapRemap.GetSourceAreas());
+	DataArray1D<double> dPreviousTargetAreas(mapRemap.GetTargetAreas());
+
+	AnnounceEndBlock(NULL);
+
+	// Load input mesh
+	AnnounceStartBlock("Loading input mesh");
+	Mesh meshInput(strInputMesh);
+	meshInput.RemoveZeroEdges();
+	AnnounceEndBlock(NULL);
+
+	// Load output mesh
+	AnnounceStartBlock("Loading output mesh");
+	Mesh meshOutput(strOutputMesh);
+	meshOutput.RemoveZeroEdges();
+	AnnounceEndBlock(NULL);
+
+	// Load overlap mesh
+	AnnounceStartBlock("Loading overlap mesh");
+	Mesh meshOverlap;
+	LoadOverlapMesh(
+		strOverlapMesh, meshInput, meshOutput, meshOverlap, nThreads);
+	meshOverlap.RemoveZeroEdges();
+
+	VerifyOverlapMeshCorrespondence(meshInput, meshOutput, meshOverlap);
+
+	AnnounceEndBlock(NULL);
+
+	// Calculate Face areas
+	AnnounceStartBlock("Calculating mesh Face areas");
+	meshInput.CalculateFaceAreas(fInputConcave, nThreads);
+	meshOutput.CalculateFaceAreas(fOutputConcave, nThreads);
+	if (meshOverlap.vecFaceArea.GetRows() != meshOverlap.faces.size()) {
+		meshOverlap.CalculateFaceAreas(false, nThreads);
+	}
+	AnnounceEndBlock(NULL);
+
+	// Changed Faces are those listed explicitly and those whose area
+	// differs from the area stored in the previous map
+	AnnounceStartBlock("Finding changed faces");
+
+	std::vector<int> vecChangedSourceFaces;
+	std::vector<int> vecChangedTargetFaces;
+
+	if (strChangedSourceFaces != "") {
+		ReadFaceIndexFile(strChangedSourceFaces, vecChangedSourceFaces);
+	}
+	if (strChangedTargetFaces != "") {
+		ReadFaceIndexFile(strChangedTargetFaces, vecChangedTargetFaces);
+	}
+
+	AppendChangedAreaFaces(
+		dPreviousSourceAreas, meshInput, vecChangedSourceFaces);
+	AppendChangedAreaFaces(
+		dPreviousTargetAreas, meshOutput, vecChangedTargetFaces);
+
+	Announce("Changed source faces: %i",
+		static_cast<int>(vecChangedSourceFaces.size()));
+	Announce("Changed target faces: %i",
+		static_cast<int>(vecChangedTargetFaces.size()));
+
+	AnnounceEndBlock(NULL);
+
+	// Map weights do not depend on the masks, so only the rows of the map
+	// which depend on changed Faces need to be recomputed
+	if ((vecChangedSourceFaces.size() == 0) &&
+	    (vecChangedTargetFaces.size() == 0)
+	) {
+		Announce("No changed faces; reusing all weights of previous map");
+
+	} else {
+		AnnounceStartBlock("Updating offline map");
+
+		// Generate reverse node array and edge map
+		meshInput.ConstructReverseNodeArray();
+		meshInput.ConstructEdgeMap();
+		meshInput.ConstructFaceNeighbors(nThreads);
+		ConstructReconstructionStencils(meshInput, nPin, nThreads);
+
+		LinearRemapFVtoFV_Update(
+			meshInput,
+			meshOutput,
+			meshOverlap,
+			nPin,
+			vecChangedSourceFaces,
+			vecChangedTargetFaces,
+			mapRemap,
+			nThreads);
+
+		AnnounceEndBlock(NULL);
+	}
+
+	// Update the areas, masks and coordinates of the map
+	mapRemap.SetSourceAreas(meshInput.vecFaceArea);
+	if (meshInput.vecMask.IsAttached()) {
+		mapRemap.SetSourceMask(meshInput.vecMask);
+	}
+
+	mapRemap.SetTargetAreas(meshOutput.vecFaceArea);
+	if (meshOutput.vecMask.IsAttached()) {
+		mapRemap.SetTargetMask(meshOutput.vecMask);
+	}
+
+	mapRemap.SetThreadCount(nThreads);
+	mapRemap.InitializeSourceCoordinatesFromMeshFV(meshInput);
+	mapRemap.InitializeTargetCoordinatesFromMeshFV(meshOutput);
+
+	mapRemap.GetSparseMatrix().Freeze();
+
+	// Verify consistency and conservation
+	if (!fNoCheck) {
+		AnnounceStartBlock("Verifying map");
+		mapRemap.SetThreadCount(nThreads);
+		mapRemap.Verify(1.0e-8, 1.0e-8, false, 0.0);
+		AnnounceEndBlock(NULL);
+	}
+
+	// Output the Offline Map
+	if (strOutputMap != "") {
+		AnnounceStartBlock("Writing offline map");
+
+		// Title is written by OfflineMap::Write
+		mapAttributes.erase("Title");
+
+		mapAttributes["domain_a"] = meshInput.strFileName;
+		mapAttributes["domain_b"] = meshOutput.strFileName;
+		mapAttributes["grid_file_src"] = meshInput.strFileName;
+		mapAttributes["grid_file_dst"] = meshOutput.strFileName;
+		mapAttributes["grid_file_ovr"] = meshOverlap.strFileName;
+		mapAttributes["concave_src"] = (fInputConcave)?("true"):("false");
+		mapAttributes["concave_dst"] = (fOutputConcave)?("true"):("false");
+		mapAttributes["updated_from"] = strInputMap;
+		mapAttributes["version"] = g_strVersion;
+
+		mapRemap.SetThreadCount(nThreads);
+		mapRemap.Write(strOutputMap, mapAttributes, eOutputFormat);
+		AnnounceEndBlock(NULL);
+	}
+
+	return (0);
+
+} catch(Exception & e) {
+	Announce(e.ToString().c_str());
+	return (-1);
+
+} catch(...) {
+	return (-1);
+}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
 #ifdef TEMPEST_DRIVER_MODE
 
 int main(int argc, char** argv) {
@@ -924,6 +2410,9 @@ int main(int argc, char** argv) {
 	// Output mesh contains concave elements
 	bool fOutputConcave;
 
+	// Number of threads used to compute Face areas and apply the map
+	int nThreads;
+
 	// Parse the command line
 	BeginCommandLine()
 		CommandLineString(strInputMesh, "in_mesh", "");
@@ -956,6 +2445,7 @@ int main(int argc, char** argv) {
 		CommandLineDouble(dFillValueOverride, "fillvalue", 0.0);
 		CommandLineBool(fInputConcave, "in_concave");
 		CommandLineBool(fOutputConcave, "out_concave");
+		CommandLineInt(nThreads, "nthreads", 1);
 
 		ParseCommandLine(argc, argv);
 	EndCommandLine(argv)
@@ -977,7 +2467,8 @@ int main(int argc, char** argv) {
                                     fVolumetric, fNoConservation, fNoCheck,
                                     strVariables, strOutputMap, strInputData, strOutputData,
                                     strNColName, fOutputDouble, strOutputFormat, strPreserveVariables, fPreserveAll, dFillValueOverride,
-                                    fInputConcave, fOutputConcave );
+                                    fInputConcave, fOutputConcave,
+                                    nThreads );
 
 	if (err) exit(err);
 
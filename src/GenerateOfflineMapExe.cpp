@@ -111,6 +111,54 @@ int main(int argc, char** argv) {
 	// Output mesh contains concave elements
 	bool fOutputConcave;
 
+	// Number of threads used to compute Face areas and apply the map
+	int nThreads;
+
+	// Reorder mesh faces along a space-filling curve for locality
+	bool fReorderFaces;
+
+	// Cache finite element meta data in <mesh>.np#.meta.prep sidecar files
+	bool fCachePrepared;
+
+	// Remove weights of magnitude below this threshold
+	double dPruneThreshold;
+
+	// Remove weights in masked rows and columns
+	bool fPruneMasked;
+
+	// Directory of maps keyed by the contents of their inputs
+	std::string strMapCacheDir;
+
+	// Map method, where methods other than conserve need no overlap mesh
+	std::string strMethod;
+
+	// File in which the partial map is checkpointed
+	std::string strCheckpointFile;
+
+	// Interval between checkpoints (in seconds)
+	double dCheckpointInterval;
+
+	// Resume from the checkpoint file
+	bool fRestart;
+
+	// Memory limit (in MB) used to plan map generation
+	double dMemoryLimitMB;
+
+	// Deflate level of the sparse matrix in NetCDF-4 output
+	int nOutputDeflate;
+
+	// Number of mantissa bits of the map weights retained on output
+	int nOutputQuantizeBits;
+
+	// Previous map file to update
+	std::string strInputMap;
+
+	// File listing changed source faces
+	std::string strChangedSourceFaces;
+
+	// File listing changed target faces
+	std::string strChangedTargetFaces;
+
 	// Parse the command line
 	BeginCommandLine()
 		CommandLineString(strInputMesh, "in_mesh", "");
@@ -138,11 +186,27 @@ int main(int argc, char** argv) {
 		CommandLineString(strNColName, "ncol_name", "ncol");
 		CommandLineBool(fOutputDouble, "out_double");
 		CommandLineString(strOutputFormat, "out_format","Netcdf4");
+		CommandLineInt(nOutputDeflate, "out_deflate", 0);
+		CommandLineInt(nOutputQuantizeBits, "out_quantize", 0);
 		CommandLineString(strPreserveVariables, "preserve", "");
 		CommandLineBool(fPreserveAll, "preserveall");
 		CommandLineDouble(dFillValueOverride, "fillvalue", 0.0);
 		CommandLineBool(fInputConcave, "in_concave");
 		CommandLineBool(fOutputConcave, "out_concave");
+		CommandLineInt(nThreads, "nthreads", 1);
+		CommandLineBool(fReorderFaces, "reorder");
+		CommandLineBool(fCachePrepared, "cache_prepared");
+		CommandLineDouble(dPruneThreshold, "prune", 0.0);
+		CommandLineBool(fPruneMasked, "prune_masked");
+		CommandLineString(strMapCacheDir, "map_cache_dir", "");
+		CommandLineStringD(strMethod, "method", "conserve", "[conserve|nn|bilin|patch]");
+		CommandLineString(strCheckpointFile, "checkpoint", "");
+		CommandLineDouble(dCheckpointInterval, "checkpoint_interval", 600.0);
+		CommandLineBool(fRestart, "restart");
+		CommandLineDouble(dMemoryLimitMB, "memory_limit", 0.0);
+		CommandLineString(strInputMap, "in_map", "");
+		CommandLineString(strChangedSourceFaces, "changed_src", "");
+		CommandLineString(strChangedTargetFaces, "changed_tgt", "");
 
 		ParseCommandLine(argc, argv);
 	EndCommandLine(argv)
@@ -154,8 +218,37 @@ int main(int argc, char** argv) {
 	if (fMonotoneType2) nMonotoneTypeID=2;
 	if (fMonotoneType3) nMonotoneTypeID=3;
 
-	// Call the actual mesh generator
     OfflineMap mapRemap;
+    mapRemap.SetWriteCompression(nOutputDeflate, nOutputQuantizeBits);
+
+	// Update an existing map
+	if (strInputMap != "") {
+		if (fReorderFaces) {
+			_EXCEPTIONT("--reorder cannot be used with --in_map");
+		}
+
+		int err = GenerateOfflineMapUpdate(
+				mapRemap,
+				strInputMap,
+				strInputMesh, strOutputMesh, strOverlapMesh,
+				strChangedSourceFaces, strChangedTargetFaces,
+				nPin,
+				fNoCheck,
+				strOutputMap,
+				strOutputFormat,
+				fInputConcave, fOutputConcave,
+				nThreads);
+
+		if (err) exit(err);
+
+		return 0;
+	}
+
+	if ((strChangedSourceFaces != "") || (strChangedTargetFaces != "")) {
+		_EXCEPTIONT("--changed_src and --changed_tgt require --in_map");
+	}
+
+	// Call the actual mesh generator
 	int err = GenerateOfflineMap(
 			mapRemap,
 			strInputMesh, strOutputMesh, strOverlapMesh,
@@ -177,7 +270,18 @@ int main(int argc, char** argv) {
 			strPreserveVariables,
 			fPreserveAll,
 			dFillValueOverride,
-			fInputConcave, fOutputConcave);
+			fInputConcave, fOutputConcave,
+			nThreads,
+			fReorderFaces,
+			fCachePrepared,
+			dPruneThreshold,
+			fPruneMasked,
+			strMapCacheDir,
+			strMethod,
+			strCheckpointFile,
+			fRestart,
+			dCheckpointInterval,
+			dMemoryLimitMB);
 
 	if (err) exit(err);
 
@@ -20,6 +20,7 @@
 #include "Exception.h"
 #include "GridElements.h"
 #include "OverlapMesh.h"
+#include "CompactOverlapMesh.h"
 
 #include "netcdfcpp.h"
 #include "NetCDFUtilities.h"
@@ -28,6 +29,31 @@
 
 ///////////////////////////////////////////////////////////////////////////////
 
+///	<summary>
+///		Get the rank of this processor and the number of processors in
+///		MPI_COMM_WORLD, or zero and one if MPI is not in use.
+///	</summary>
+static void GetProcessorRankAndCount (
+	int & nRank,
+	int & nSize
+) {
+	nRank = 0;
+	nSize = 1;
+
+#if defined(TEMPEST_MPIOMP)
+	int fMPIInitialized;
+	MPI_Initialized ( &fMPIInitialized );
+
+	if ( fMPIInitialized )
+	{
+		MPI_Comm_rank ( MPI_COMM_WORLD, &nRank );
+		MPI_Comm_size ( MPI_COMM_WORLD, &nSize );
+	}
+#endif
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
 extern "C"
 int GenerateOverlapWithMeshes (
 	Mesh & meshA,
@@ -39,7 +65,16 @@ int GenerateOverlapWithMeshes (
 	const bool fHasConcaveFacesA,
 	const bool fHasConcaveFacesB,
 	const bool fAllowNoOverlap,
-	const bool fVerbose
+	const bool fVerbose,
+	const int nThreads,
+	const int nOutputDeflate,
+	const bool fReuseSeeds,
+	const bool fCandidatePairs,
+	const bool fCompactOutput,
+	const double dStreamMemoryMB,
+	std::string strCheckpointFile,
+	const bool fRestart,
+	const double dCheckpointInterval
 ) {
 
     NcError error ( NcError::silent_nonfatal );
@@ -73,20 +108,125 @@ int GenerateOverlapWithMeshes (
         {
             method = OverlapMeshMethod_Mixed;
         }
+        else if ( strMethod == "bvh" )
+        {
+            method = OverlapMeshMethod_BVH;
+        }
         else
         {
             _EXCEPTIONT ( "Invalid \"method\" value" );
         }
 
+        if ( nThreads < 1 )
+        {
+            _EXCEPTIONT ( "--nthreads must be at least 1" );
+        }
+
         meshOverlap.type = Mesh::MeshType_Overlap;
 
+        // Distribute the overlap mesh across processors if running
+        // under MPI with more than one processor
+        int nRank;
+        int nSize;
+        GetProcessorRankAndCount ( nRank, nSize );
+
+        // Stream the overlap mesh to disk within a memory budget
+        if ( dStreamMemoryMB > 0.0 )
+        {
+            if ( strOverlapMesh.size() == 0 )
+            {
+                _EXCEPTIONT ( "Streamed output requires an overlap mesh file" );
+            }
+            if ( nSize > 1 )
+            {
+                _EXCEPTIONT ( "Streamed output is not supported under MPI" );
+            }
+            if ( fCompactOutput || fCandidatePairs )
+            {
+                _EXCEPTIONT ( "Streamed output cannot be combined with "
+                    "compact output or candidate pairs" );
+            }
+
+            AnnounceStartBlock ( "Construct and write overlap mesh" );
+            GenerateOverlapMesh_Streamed (
+				meshA, meshB,
+				strOverlapMesh,
+				eOutputFormat,
+				method,
+				fAllowNoOverlap,
+				dStreamMemoryMB,
+				nThreads,
+				fReuseSeeds );
+            AnnounceEndBlock ( NULL );
+
+            return 0;
+        }
+
+        // Checkpoint completed source faces
+        if ( strCheckpointFile.size() != 0 )
+        {
+            if ( nSize > 1 )
+            {
+                _EXCEPTIONT ( "Checkpoints are not supported under MPI" );
+            }
+            if ( fCandidatePairs || ( dStreamMemoryMB > 0.0 ) )
+            {
+                _EXCEPTIONT ( "Checkpoints cannot be combined with "
+                    "candidate pairs or streamed output" );
+            }
+        }
+        else if ( fRestart )
+        {
+            _EXCEPTIONT ( "--restart requires --checkpoint" );
+        }
+
         AnnounceStartBlock ( "Construct overlap mesh" );
-        GenerateOverlapMesh_v2 (
-			meshA, meshB,
-			meshOverlap,
-			method,
-			fAllowNoOverlap,
-			fVerbose );
+        if ( strCheckpointFile.size() != 0 )
+        {
+            GenerateOverlapMesh_Checkpointed (
+				meshA, meshB,
+				meshOverlap,
+				method,
+				fAllowNoOverlap,
+				strCheckpointFile,
+				fRestart,
+				dCheckpointInterval,
+				nThreads,
+				fReuseSeeds );
+        }
+        else if ( nSize > 1 )
+        {
+#if defined(TEMPEST_MPIOMP)
+            GenerateOverlapMesh_MPI (
+				meshA, meshB,
+				meshOverlap,
+				method,
+				fAllowNoOverlap,
+				nThreads,
+				MPI_COMM_WORLD,
+				fReuseSeeds );
+#endif
+        }
+        else if ( fCandidatePairs )
+        {
+            GenerateOverlapMesh_Pairs (
+				meshA, meshB,
+				meshOverlap,
+				method,
+				fAllowNoOverlap,
+				nThreads );
+        }
+        else
+        {
+            GenerateOverlapMesh_v2 (
+				meshA, meshB,
+				meshOverlap,
+				method,
+				fAllowNoOverlap,
+				fVerbose,
+				nThreads,
+				fReuseSeeds );
+        }
         AnnounceEndBlock ( NULL );
 
         /*
@@ -108,7 +248,7 @@ int GenerateOverlapWithMeshes (
 
             // Equalize nearly coincident nodes on these Meshes
             AnnounceStartBlock("Equalize coicident Nodes");
-            EqualizeCoincidentNodes(meshA, meshB);
+            EqualizeCoincidentNodes(meshA, meshB, nThreads);
             AnnounceEndBlock(NULL);
 
             // Construct the overlap mesh
@@ -119,14 +259,37 @@ int GenerateOverlapWithMeshes (
             AnnounceEndBlock(NULL);
         */
 
-        // Write the overlap mesh
-        if ( strOverlapMesh.size() )
+        // Write the overlap mesh (only assembled on the root processor)
+        if ( strOverlapMesh.size() && ( nRank == 0 ) )
         {
             AnnounceStartBlock("Writing overlap mesh");
-            meshOverlap.Write(strOverlapMesh.c_str(), eOutputFormat);
+            if ( fCompactOutput )
+            {
+                // Only store Nodes that are not Nodes of mesh A or B
+                CompactOverlapMesh meshCompact;
+                meshCompact.FromMesh ( meshOverlap, meshA, meshB, nThreads );
+                meshCompact.Write ( strOverlapMesh, eOutputFormat );
+
+                Announce ( "Compact format: %i of %i nodes stored (%1.2f MB)",
+                    meshCompact.GetNewNodeCount(),
+                    meshCompact.GetNodeCount(),
+                    static_cast<double>(meshCompact.GetByteSize())
+                        / (1024.0 * 1024.0) );
+            }
+            else
+            {
+                meshOverlap.Write(
+                    strOverlapMesh.c_str(), eOutputFormat, nOutputDeflate, nThreads);
+            }
             AnnounceEndBlock(NULL);
         }
 
+        // The checkpoint is no longer needed once the output is written
+        if ( strCheckpointFile.size() != 0 )
+        {
+            remove ( strCheckpointFile.c_str() );
+        }
+
         return 0;
 
     }
@@ -156,7 +319,18 @@ int GenerateOverlapMesh(
 	const bool fHasConcaveFacesA,
 	const bool fHasConcaveFacesB,
 	const bool fAllowNoOverlap,
-	const bool fVerbose
+	const bool fVerbose,
+	const int nThreads,
+	const bool fCachePrepared,
+	const int nOutputDeflate,
+	const bool fReuseSeeds,
+	const bool fCandidatePairs,
+	const double dValidateSample,
+	const bool fCompactOutput,
+	const double dStreamMemoryMB,
+	std::string strCheckpointFile,
+	const bool fRestart,
+	const double dCheckpointInterval
 ) {
 
     NcError error ( NcError::silent_nonfatal );
@@ -176,7 +350,8 @@ int GenerateOverlapMesh(
 
         // Load input mesh
         AnnounceStartBlock ( "Loading mesh A" );
-        Mesh meshA ( strMeshA );
+        Mesh meshA;
+        meshA.Read ( strMeshA, false );
         meshA.RemoveZeroEdges();
         AnnounceEndBlock ( NULL );
 
@@ -184,20 +359,21 @@ int GenerateOverlapMesh(
         if ( fHasConcaveFacesA )
         {
             Mesh meshTemp = meshA;
-            ConvexifyMesh ( meshTemp, meshA, fVerbose );
+            ConvexifyMesh ( meshTemp, meshA, fVerbose, nThreads );
         }
 
         // Validate mesh
         if ( !fNoValidate )
         {
             AnnounceStartBlock ( "Validate mesh A" );
-            meshA.Validate();
+            meshA.Validate(nThreads, dValidateSample);
             AnnounceEndBlock ( NULL );
         }
 
         // Load output mesh
         AnnounceStartBlock ( "Loading mesh B" );
-        Mesh meshB ( strMeshB );
+        Mesh meshB;
+        meshB.Read ( strMeshB, false );
         meshB.RemoveZeroEdges();
         AnnounceEndBlock ( NULL );
 
@@ -205,25 +381,81 @@ int GenerateOverlapMesh(
         if ( fHasConcaveFacesB )
         {
             Mesh meshTemp = meshB;
-            ConvexifyMesh ( meshTemp, meshB, fVerbose );
+            ConvexifyMesh ( meshTemp, meshB, fVerbose, nThreads );
         }
 
         // Validate mesh
         if ( !fNoValidate )
         {
             AnnounceStartBlock ( "Validate mesh B" );
-            meshB.Validate();
+            meshB.Validate(nThreads, dValidateSample);
+            AnnounceEndBlock ( NULL );
+        }
+
+        // Load the edge map from the prepared mesh files if available
+        std::string strPreparedA = strMeshA + ".prep";
+        std::string strPreparedB = strMeshB + ".prep";
+
+        // Only the root processor writes prepared mesh files
+        int nRank;
+        int nSize;
+        GetProcessorRankAndCount ( nRank, nSize );
+
+        const bool fWritePrepared = fCachePrepared && ( nRank == 0 );
+
+        if ( fCachePrepared )
+        {
+            AnnounceStartBlock ( "Loading prepared mesh files" );
+            if ( meshA.ReadPrepared ( strPreparedA ) )
+            {
+                Announce ( "Loaded %s", strPreparedA.c_str() );
+            }
+            if ( meshB.ReadPrepared ( strPreparedB ) )
+            {
+                Announce ( "Loaded %s", strPreparedB.c_str() );
+            }
             AnnounceEndBlock ( NULL );
         }
 
         // Construct the edge map on both meshes
-        AnnounceStartBlock ( "Constructing edge map on mesh A" );
-        meshA.ConstructEdgeMap();
-        AnnounceEndBlock ( NULL );
+        if ( meshA.edgemap.size() == 0 )
+        {
+            AnnounceStartBlock ( "Constructing edge map on mesh A" );
+            meshA.ConstructEdgeMap();
+            AnnounceEndBlock ( NULL );
 
-        AnnounceStartBlock ( "Constructing edge map on mesh B" );
-        meshB.ConstructEdgeMap();
-        AnnounceEndBlock ( NULL );
+            if ( fWritePrepared )
+            {
+                meshA.WritePrepared ( strPreparedA );
+            }
+        }
+
+        // Mesh B is searched face by face, so also tabulate its face
+        // neighbors
+        bool fPreparedB = false;
+
+        if ( meshB.edgemap.size() == 0 )
+        {
+            AnnounceStartBlock ( "Constructing edge map on mesh B" );
+            meshB.ConstructEdgeMap();
+            AnnounceEndBlock ( NULL );
+
+            fPreparedB = true;
+        }
+
+        if ( meshB.faceneighbors.size() != meshB.faces.size() )
+        {
+            AnnounceStartBlock ( "Constructing face neighbors on mesh B" );
+            meshB.ConstructFaceNeighbors ( nThreads );
+            AnnounceEndBlock ( NULL );
+
+            fPreparedB = true;
+        }
+
+        if ( fPreparedB && fWritePrepared )
+        {
+            meshB.WritePrepared ( strPreparedB );
+        }
 
         int err =
 			GenerateOverlapWithMeshes (
@@ -235,7 +467,16 @@ int GenerateOverlapMesh(
 				fHasConcaveFacesA,
 				fHasConcaveFacesB,
 				fAllowNoOverlap,
-				fVerbose);
+				fVerbose,
+				nThreads,
+				nOutputDeflate,
+				fReuseSeeds,
+				fCandidatePairs,
+				fCompactOutput,
+				dStreamMemoryMB,
+				strCheckpointFile,
+				fRestart,
+				dCheckpointInterval);
 
         return err;
 
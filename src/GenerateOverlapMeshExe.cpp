@@ -20,6 +20,10 @@
 
 #include "TempestRemapAPI.h"
 
+#if defined(TEMPEST_MPIOMP)
+#include <mpi.h>
+#endif
+
 ///////////////////////////////////////////////////////////////////////////////
 
 int main(int argc, char** argv) {
@@ -42,6 +46,9 @@ int main(int argc, char** argv) {
 	// No validation of the meshes
 	bool fNoValidate;
 
+	// Fraction of nodes and faces of each mesh checked by validation
+	double dValidateSample;
+
 	// Concave elements may be present in mesh A
 	bool fHasConcaveFacesA;
 
@@ -55,22 +62,68 @@ int main(int argc, char** argv) {
 	// Verbose
 	bool fVerbose;
 
+	// Number of threads used to generate the overlap mesh
+	int nThreads;
+
+	// Cache derived mesh structures in <mesh>.prep sidecar files
+	bool fCachePrepared;
+
+	// Deflate level of the overlap mesh in NetCDF-4 output
+	int nOutputDeflate;
+
+	// Seed the search from each source face using the previous source face
+	bool fReuseSeeds;
+
+	// Clip candidate pairs from bounding caps in bulk (ignored under MPI)
+	bool fCandidatePairs;
+
+	// Only store overlap nodes that are not nodes of mesh A or mesh B
+	bool fCompactOutput;
+
+	// Stream the overlap mesh to disk within this memory budget (MB)
+	double dStreamMemoryMB;
+
+	// Record completed source faces in this checkpoint file
+	std::string strCheckpointFile;
+
+	// Seconds between checkpoints
+	double dCheckpointInterval;
+
+	// Resume from the checkpoint file
+	bool fRestart;
+
 	// Parse the command line
 	BeginCommandLine()
 		CommandLineString(strMeshA, "a", "");
 		CommandLineString(strMeshB, "b", "");
 		CommandLineString(strOverlapMesh, "out", "overlap.g");
 		CommandLineString(strOutputFormat, "out_format", "netcdf4");
-		CommandLineStringD(strMethod, "method", "fuzzy", "(fuzzy|exact|mixed)");
+		CommandLineStringD(strMethod, "method", "fuzzy", "(fuzzy|exact|mixed|bvh)");
 		CommandLineBool(fNoValidate, "novalidate");
+		CommandLineDouble(dValidateSample, "validate_sample", 1.0);
 		CommandLineBool(fHasConcaveFacesA, "concavea");
 		CommandLineBool(fHasConcaveFacesB, "concaveb");
 		CommandLineBool(fAllowNoOverlap, "allow_no_overlap");
 		CommandLineBool(fVerbose, "verbose");
+		CommandLineInt(nThreads, "nthreads", 1);
+		CommandLineBool(fCachePrepared, "cache_prepared");
+		CommandLineInt(nOutputDeflate, "out_deflate", 0);
+		CommandLineBool(fReuseSeeds, "reuse_seeds");
+		CommandLineBool(fCandidatePairs, "pairs");
+		CommandLineBool(fCompactOutput, "out_compact");
+		CommandLineDouble(dStreamMemoryMB, "out_stream_mb", 0.0);
+		CommandLineString(strCheckpointFile, "checkpoint", "");
+		CommandLineDouble(dCheckpointInterval, "checkpoint_interval", 600.0);
+		CommandLineBool(fRestart, "restart");
 
 		ParseCommandLine(argc, argv);
 	EndCommandLine(argv)
 
+#if defined(TEMPEST_MPIOMP)
+	// Source faces are distributed across all processors
+	MPI_Init(&argc, &argv);
+#endif
+
 	AnnounceBanner();
 
 	// Call the actual mesh generator
@@ -82,12 +135,32 @@ int main(int argc, char** argv) {
 			strMethod, fNoValidate,
 			fHasConcaveFacesA, fHasConcaveFacesB,
 			fAllowNoOverlap,
-			fVerbose);
-
-	if (err) exit(err);
+			fVerbose,
+			nThreads,
+			fCachePrepared,
+			nOutputDeflate,
+			fReuseSeeds,
+			fCandidatePairs,
+			dValidateSample,
+			fCompactOutput,
+			dStreamMemoryMB,
+			strCheckpointFile,
+			fRestart,
+			dCheckpointInterval);
+
+	if (err) {
+#if defined(TEMPEST_MPIOMP)
+		MPI_Finalize();
+#endif
+		exit(err);
+	}
 
 	AnnounceBanner();
 
+#if defined(TEMPEST_MPIOMP)
+	MPI_Finalize();
+#endif
+
 	return 0;
 }
 
@@ -0,0 +1,220 @@
+///////////////////////////////////////////////////////////////////////////////
+///
+///	\file    GenerateRemapWeightsExe.cpp
+///	\author  Paul Ullrich
+///	\author  agent
+///	\version October 14, 2026
+///
+///	<remarks>
+///		Copyright 2000-2014 Paul Ullrich
+///		Copyright 2026 agent
+///
+///		This file is distributed as part of the Tempest source code package.
+///		Permission is granted to use, copy, modify and distribute this
+///		source code and its documentation under the terms of the GNU General
+///		Public License.  This software is provided "as is" without express
+///		or implied warranty.
+///	</remarks>
+
+#include "Announce.h"
+#include "CommandLine.h"
+#include "Exception.h"
+#include "GridElements.h"
+#include "OfflineMap.h"
+
+#include "TempestRemapAPI.h"
+
+///////////////////////////////////////////////////////////////////////////////
+
+int main(int argc, char** argv) {
+
+	// Input mesh file
+	std::string strInputMesh;
+
+	// Output mesh file
+	std::string strOutputMesh;
+
+	// Optional overlap mesh file to write
+	std::string strOverlapMesh;
+
+	// Overlap mesh method
+	std::string strOverlapMethod;
+
+	// Input metadata file
+	std::string strInputMeta;
+
+	// Output metadata file
+	std::string strOutputMeta;
+
+	// Input data type
+	std::string strInputType;
+
+	// Output data type
+	std::string strOutputType;
+
+	// Order of polynomial in each element
+	int nPin;
+
+	// Order of polynomial in each output element
+	int nPout;
+
+	// Use bubble on interior of spectral element nodes
+	bool fBubble;
+
+	// Enforce monotonicity
+	bool fMonotoneType1;
+
+	// Enforce monotonicity
+	bool fMonotoneType2;
+
+	// Enforce monotonicity
+	bool fMonotoneType3;
+
+	// Volumetric remapping
+	bool fVolumetric;
+
+	// No conservation
+	bool fNoConservation;
+
+	// Turn off checking for conservation / consistency
+	bool fNoCheck;
+
+	// Input mesh contains concave elements
+	bool fInputConcave;
+
+	// Output mesh contains concave elements
+	bool fOutputConcave;
+
+	// Allow source faces with no overlap
+	bool fAllowNoOverlap;
+
+	// Output map file
+	std::string strOutputMap;
+
+	// Output format
+	std::string strOutputFormat;
+
+	// Deflate level of the sparse matrix in NetCDF-4 output
+	int nOutputDeflate;
+
+	// Number of mantissa bits of the map weights retained on output
+	int nOutputQuantizeBits;
+
+	// Number of threads
+	int nThreads;
+
+	// Reorder mesh faces along a space-filling curve for locality
+	bool fReorderFaces;
+
+	// Number of maps generated at once with multiple output meshes
+	int nConcurrentTargets;
+
+	// Share the reconstruction fit arrays of the input mesh between maps
+	bool fCacheFitArrays;
+
+	// Parse the command line
+	BeginCommandLine()
+		CommandLineString(strInputMesh, "in_mesh", "");
+		CommandLineString(strOutputMesh, "out_mesh", "");
+		CommandLineString(strOverlapMesh, "ov_mesh", "");
+		CommandLineStringD(strOverlapMethod, "method", "exact", "[fuzzy|exact|mixed|bvh]");
+		CommandLineString(strInputMeta, "in_meta", "");
+		CommandLineString(strOutputMeta, "out_meta", "");
+		CommandLineStringD(strInputType, "in_type", "fv", "[fv|cgll|dgll]");
+		CommandLineStringD(strOutputType, "out_type", "fv", "[fv|cgll|dgll]");
+
+		// Optional arguments
+		CommandLineInt(nPin, "in_np", 4);
+		CommandLineInt(nPout, "out_np", 4);
+		CommandLineBool(fBubble, "bubble");
+		CommandLineBool(fMonotoneType1, "mono");
+		CommandLineBool(fMonotoneType2, "mono2");
+		CommandLineBool(fMonotoneType3, "mono3");
+		CommandLineBool(fVolumetric, "volumetric");
+		CommandLineBool(fNoConservation, "noconserve");
+		CommandLineBool(fNoCheck, "nocheck");
+		CommandLineBool(fInputConcave, "in_concave");
+		CommandLineBool(fOutputConcave, "out_concave");
+		CommandLineBool(fAllowNoOverlap, "allow_no_overlap");
+		CommandLineString(strOutputMap, "out_map", "");
+		CommandLineString(strOutputFormat, "out_format", "Netcdf4");
+		CommandLineInt(nOutputDeflate, "out_deflate", 0);
+		CommandLineInt(nOutputQuantizeBits, "out_quantize", 0);
+		CommandLineInt(nThreads, "nthreads", 1);
+		CommandLineBool(fReorderFaces, "reorder");
+		CommandLineInt(nConcurrentTargets, "ntargets", 1);
+		CommandLineBool(fCacheFitArrays, "cache_fit");
+
+		ParseCommandLine(argc, argv);
+	EndCommandLine(argv)
+
+	AnnounceBanner();
+
+	int nMonotoneTypeID=0;
+	if (fMonotoneType1) nMonotoneTypeID=1;
+	if (fMonotoneType2) nMonotoneTypeID=2;
+	if (fMonotoneType3) nMonotoneTypeID=3;
+
+	// Generate maps to a comma-separated list of output meshes, preparing
+	// the input mesh once
+	if (strOutputMesh.find(',') != std::string::npos) {
+		if ((strOverlapMesh != "") || (strOutputMeta != "") ||
+			fInputConcave || fOutputConcave || fReorderFaces
+		) {
+			_EXCEPTIONT("--ov_mesh, --out_meta, --in_concave, --out_concave "
+				"and --reorder cannot be used with multiple output meshes");
+		}
+
+		int err = GenerateRemapWeightsMultiTarget(
+				strInputMesh, strOutputMesh, strOutputMap,
+				strOverlapMethod,
+				strInputMeta,
+				strInputType, strOutputType,
+				nPin, nPout,
+				fBubble,
+				nMonotoneTypeID,
+				fVolumetric,
+				fNoConservation,
+				fNoCheck,
+				fAllowNoOverlap,
+				strOutputFormat,
+				nOutputDeflate, nOutputQuantizeBits,
+				nThreads,
+				nConcurrentTargets,
+				fCacheFitArrays);
+
+		if (err) exit(err);
+
+		return 0;
+	}
+
+	OfflineMap mapRemap;
+	mapRemap.SetWriteCompression(nOutputDeflate, nOutputQuantizeBits);
+
+	// Generate the overlap mesh and the offline map
+	int err = GenerateRemapWeights(
+			mapRemap,
+			strInputMesh, strOutputMesh, strOverlapMesh,
+			strOverlapMethod,
+			strInputMeta, strOutputMeta,
+			strInputType, strOutputType,
+			nPin, nPout,
+			fBubble,
+			nMonotoneTypeID,
+			fVolumetric,
+			fNoConservation,
+			fNoCheck,
+			fInputConcave, fOutputConcave,
+			fAllowNoOverlap,
+			strOutputMap,
+			strOutputFormat,
+			nThreads,
+			fReorderFaces);
+
+	if (err) exit(err);
+
+	return 0;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
@@ -0,0 +1,213 @@
+///////////////////////////////////////////////////////////////////////////////
+///
+///	\file    GenerateSubMap.cpp
+///	\author  agent
+///	\version October 15, 2026
+///
+///	<remarks>
+///		Copyright 2026 agent
+///
+///		This file is distributed as part of the Tempest source code package.
+///		Permission is granted to use, copy, modify and distribute this
+///		source code and its documentation under the terms of the GNU General
+///		Public License.  This software is provided "as is" without express
+///		or implied warranty.
+///	</remarks>
+
+#include "CommandLine.h"
+#include "Announce.h"
+#include "OfflineMap.h"
+
+#include "netcdfcpp.h"
+
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+
+///////////////////////////////////////////////////////////////////////////////
+
+typedef std::map<std::string, std::string> AttributeMap;
+typedef AttributeMap::value_type AttributePair;
+
+///////////////////////////////////////////////////////////////////////////////
+
+int main(int argc, char** argv) {
+
+	NcError error(NcError::silent_nonfatal);
+
+try {
+	// Map file for input
+	std::string strInputMapFile;
+
+	// Map file for output
+	std::string strOutputMapFile;
+
+	// File listing target rows (zero-based) to retain
+	std::string strTargetRowsFile;
+
+	// Longitude-latitude box of target cells to retain
+	std::string strBox;
+
+	// Retain only unmasked target cells
+	bool fMask;
+
+	// Parse the command line
+	BeginCommandLine()
+		CommandLineString(strInputMapFile, "in", "");
+		CommandLineString(strOutputMapFile, "out", "");
+		CommandLineString(strTargetRowsFile, "rows", "");
+		CommandLineStringD(strBox, "box", "", "lonmin,lonmax,latmin,latmax");
+		CommandLineBool(fMask, "mask");
+
+		ParseCommandLine(argc, argv);
+	EndCommandLine(argv)
+
+	// Check arguments
+	if (strInputMapFile == "") {
+		_EXCEPTIONT("Input map file (--in) must be specified");
+	}
+	if (strOutputMapFile == "") {
+		_EXCEPTIONT("Output map file (--out) must be specified");
+	}
+	if ((strTargetRowsFile == "") && (strBox == "") && (!fMask)) {
+		_EXCEPTIONT("At least one of --rows, --box or --mask must be specified");
+	}
+
+	double dBox[4];
+	if (strBox != "") {
+		if (sscanf(strBox.c_str(), "%lf,%lf,%lf,%lf",
+			&(dBox[0]), &(dBox[1]), &(dBox[2]), &(dBox[3])) != 4
+		) {
+			_EXCEPTIONT("--box must be of the form lonmin,lonmax,latmin,latmax");
+		}
+	}
+
+	// Atribute map
+	AttributeMap mapAttributes;
+
+	// Load map from file
+	AnnounceStartBlock("Loading input map");
+	OfflineMap mapIn;
+	NcFile::FileFormat eFileFormat;
+	mapIn.Read(strInputMapFile, &mapAttributes, &eFileFormat);
+	AnnounceEndBlock("Done");
+
+	const int nB = static_cast<int>(mapIn.GetTargetAreas().GetRows());
+
+	// Select target rows; each criterion restricts the selection
+	AnnounceStartBlock("Selecting target cells");
+
+	std::vector<int> vecTargetRows;
+	if (strTargetRowsFile != "") {
+		std::ifstream ifRows(strTargetRowsFile.c_str());
+		if (!ifRows.is_open()) {
+			_EXCEPTION1("Unable to open target rows file \"%s\"",
+				strTargetRowsFile.c_str());
+		}
+		int iRow;
+		while (ifRows >> iRow) {
+			vecTargetRows.push_back(iRow);
+		}
+		if (!ifRows.eof()) {
+			_EXCEPTION1("Invalid entry in target rows file \"%s\"",
+				strTargetRowsFile.c_str());
+		}
+		Announce("%lu target cells listed", vecTargetRows.size());
+
+	} else {
+		vecTargetRows.resize(nB);
+		for (int i = 0; i < nB; i++) {
+			vecTargetRows[i] = i;
+		}
+	}
+
+	std::vector<char> fRetain(nB, 1);
+
+	if (strBox != "") {
+		std::vector<int> vecBoxRows;
+		mapIn.GetTargetRowsInBox(
+			dBox[0], dBox[1], dBox[2], dBox[3], vecBoxRows);
+
+		std::fill(fRetain.begin(), fRetain.end(), 0);
+		for (size_t s = 0; s < vecBoxRows.size(); s++) {
+			fRetain[vecBoxRows[s]] = 1;
+		}
+		Announce("%lu target cells in box", vecBoxRows.size());
+	}
+
+	if (fMask) {
+		const DataArray1D<int> & iTargetMask = mapIn.GetTargetMask();
+		if (iTargetMask.GetRows() == nB) {
+			for (int i = 0; i < nB; i++) {
+				if (iTargetMask[i] == 0) {
+					fRetain[i] = 0;
+				}
+			}
+		} else {
+			Announce("WARNING: Map has no target mask; --mask ignored");
+		}
+	}
+
+	std::vector<int> vecSubRows;
+	for (size_t s = 0; s < vecTargetRows.size(); s++) {
+		const int i = vecTargetRows[s];
+		if ((i < 0) || (i >= nB)) {
+			_EXCEPTION2("Target row %i out of range [0, %i)", i, nB);
+		}
+		if (fRetain[i]) {
+			vecSubRows.push_back(i);
+		}
+	}
+
+	Announce("%lu of %i target cells retained", vecSubRows.size(), nB);
+	AnnounceEndBlock("Done");
+
+	// Generate sub-map
+	AnnounceStartBlock("Generating sub-map");
+	OfflineMap mapOut;
+	mapOut.SetSubMap(mapIn, vecSubRows);
+
+	Announce("Non-zeros    : %lu of %lu",
+		mapOut.GetSparseMatrix().GetNonZeroCount(),
+		mapIn.GetSparseMatrix().GetNonZeroCount());
+	Announce("Source cells : %lu of %lu (offset %i in source data)",
+		mapOut.GetSourceAreas().GetRows(),
+		mapIn.GetSourceAreas().GetRows(),
+		mapOut.GetSourceGridOffset());
+	AnnounceEndBlock("Done");
+
+	// Record the extent of the sub-map
+	mapAttributes["subset_of"] = strInputMapFile;
+	if (strBox != "") {
+		mapAttributes["subset_box"] = strBox;
+	}
+
+	// Find version name
+	AttributeMap::iterator iterVersion = mapAttributes.find("version");
+	if (iterVersion == mapAttributes.end()) {
+		mapAttributes.insert(
+			AttributePair("version", "GenerateSubMap 1.0 : 2026-10-15"));
+	} else {
+		iterVersion->second =
+			"GenerateSubMap 1.0 : 2026-10-15 :: " + iterVersion->second;
+	}
+
+	// Write map to file
+	AnnounceStartBlock("Writing sub-map");
+	mapOut.Write(strOutputMapFile, mapAttributes, eFileFormat);
+	AnnounceEndBlock("Done");
+
+	return (0);
+
+} catch(Exception & e) {
+	Announce(e.ToString().c_str());
+	return (-1);
+
+} catch(...) {
+	return (-2);
+}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
@@ -22,12 +22,15 @@
 #include "GaussLobattoQuadrature.h"
 #include "Exception.h"
 #include "Announce.h"
+#include "DataArray2D.h"
 #include "DataArray3D.h"
 
 #include "netcdfcpp.h"
 
+#include <algorithm>
 #include <cmath>
 #include <iostream>
+#include <vector>
 
 ///////////////////////////////////////////////////////////////////////////////
 
@@ -50,6 +53,22 @@ public:
 		double dLon,
 		double dLat
 	) = 0;
+
+	///	<summary>
+	///		Evaluate the test function at nPoints points.  Test functions
+	///		override this with a loop over an inline evaluation, so that a
+	///		block of points costs one virtual call.
+	///	</summary>
+	virtual void Evaluate(
+		int nPoints,
+		const double * dLon,
+		const double * dLat,
+		double * dValues
+	) {
+		for (int i = 0; i < nPoints; i++) {
+			dValues[i] = (*this)(dLon[i], dLat[i]);
+		}
+	}
 };
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -63,12 +82,30 @@ public:
 	///	<summary>
 	///		Evaluate the test function.
 	///	<summary>
-	virtual double operator()(
+	static inline double Value(
 		double dLon,
 		double dLat
 	) {
 		return (2.0 + cos(dLat) * cos(dLat) * cos(2.0 * dLon));
 	}
+
+	virtual double operator()(
+		double dLon,
+		double dLat
+	) {
+		return Value(dLon, dLat);
+	}
+
+	virtual void Evaluate(
+		int nPoints,
+		const double * dLon,
+		const double * dLat,
+		double * dValues
+	) {
+		for (int i = 0; i < nPoints; i++) {
+			dValues[i] = Value(dLon[i], dLat[i]);
+		}
+	}
 };
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -82,13 +119,31 @@ public:
 	///	<summary>
 	///		Evaluate the test function.
 	///	</summary>
-	virtual double operator()(
+	static inline double Value(
 		double dLon,
 		double dLat
 	) {
 		return (2.0 + pow(sin(2.0 * dLat), 16.0) * cos(16.0 * dLon));
 		//return (2.0 + pow(cos(2.0 * dLat), 16.0) * cos(16.0 * dLon));
 	}
+
+	virtual double operator()(
+		double dLon,
+		double dLat
+	) {
+		return Value(dLon, dLat);
+	}
+
+	virtual void Evaluate(
+		int nPoints,
+		const double * dLon,
+		const double * dLat,
+		double * dValues
+	) {
+		for (int i = 0; i < nPoints; i++) {
+			dValues[i] = Value(dLon[i], dLat[i]);
+		}
+	}
 };
 
 ///	<summary>
@@ -106,6 +161,17 @@ public:
 	) {
           return 1;
 	}
+
+	virtual void Evaluate(
+		int nPoints,
+		const double * dLon,
+		const double * dLat,
+		double * dValues
+	) {
+		for (int i = 0; i < nPoints; i++) {
+			dValues[i] = 1.0;
+		}
+	}
 };
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -120,7 +186,7 @@ public:
 	///		Find the rotated longitude and latitude of a point on a sphere
 	///		with pole at (dLonC, dLatC).
 	///	</summary>
-	void RotatedSphereCoord(
+	static inline void RotatedSphereCoord(
 		double dLonC,
 		double dLatC,
 		double & dLonT,
@@ -146,7 +212,7 @@ public:
 	///	<summary>
 	///		Evaluate the test function.
 	///	</summary>
-	virtual double operator()(
+	static inline double Value(
 		double dLon,
 		double dLat
 	) {
@@ -171,10 +237,45 @@ public:
 
 		return (1.0 - tanh(dRho / dD * sin(dLon - dOmega * dT)));
 	}
+
+	virtual double operator()(
+		double dLon,
+		double dLat
+	) {
+		return Value(dLon, dLat);
+	}
+
+	virtual void Evaluate(
+		int nPoints,
+		const double * dLon,
+		const double * dLat,
+		double * dValues
+	) {
+		for (int i = 0; i < nPoints; i++) {
+			dValues[i] = Value(dLon[i], dLat[i]);
+		}
+	}
 };
 
 ///////////////////////////////////////////////////////////////////////////////
 
+///	<summary>
+///		Longitude in [0, 2pi) and latitude of a point on the unit sphere.
+///	</summary>
+static inline void UnitNodeToLonLat(
+	const Node & node,
+	double & dLon,
+	double & dLat
+) {
+	dLon = atan2(node.y, node.x);
+	if (dLon < 0.0) {
+		dLon += 2.0 * M_PI;
+	}
+	dLat = asin(node.z);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
 int main(int argc, char** argv) {
 
 	NcError error(NcError::silent_nonfatal);
@@ -210,6 +311,9 @@ try {
 	// Contains concave faces
 	bool fContainsConcaveFaces;
 
+	// Number of threads
+	int nThreads;
+
 	// Parse the command line
 	BeginCommandLine()
 		CommandLineString(strMeshFile, "mesh", "");
@@ -222,6 +326,7 @@ try {
 		CommandLineString(strTestData, "out", "testdata.nc");
 		CommandLineBool(fFlipRectilinear, "fliprectilinear");
 		CommandLineBool(fContainsConcaveFaces, "concave");
+		CommandLineInt(nThreads, "nthreads", 1);
 
 		ParseCommandLine(argc, argv);
 	EndCommandLine(argv)
@@ -230,6 +335,9 @@ try {
 	if (fGLLIntegrate && fGLL) {
 		_EXCEPTIONT("--gll and --gllint are exclusive arguments");
 	}
+	if (nThreads < 1) {
+		_EXCEPTIONT("--nthreads must be at least 1");
+	}
 
 	// Announce
 	Announce("=========================================================");
@@ -239,7 +347,8 @@ try {
 
 	Announce("Using triangular quadrature of order %i", TriQuadratureOrder);
 
-	TriangularQuadratureRule triquadrule(TriQuadratureOrder);
+	const TriangularQuadratureRule & triquadrule =
+		TriangularQuadratureRule::Get(TriQuadratureOrder);
 
 	const int TriQuadraturePoints = triquadrule.GetPoints();
 
@@ -355,7 +464,7 @@ try {
 	DataArray1D<double> dNodeArea;
 
 	// Calculate element areas
-	mesh.CalculateFaceAreas(fContainsConcaveFaces);
+	mesh.CalculateFaceAreas(fContainsConcaveFaces, nThreads);
 
 	// Sample as element averages
 	if ((!fGLLIntegrate) && (!fGLL)) {
@@ -363,58 +472,60 @@ try {
 		// Resize the array
 		dVar.Allocate(mesh.faces.size());
 
-		// Loop through all Faces
-		for (int i = 0; i < mesh.faces.size(); i++) {
-
-			const Face & face = mesh.faces[i];
-
-			// Loop through all sub-triangles
-			for (int j = 0; j < face.edges.size()-2; j++) {
-
-				const Node & node0 = mesh.nodes[face[0]];
-				const Node & node1 = mesh.nodes[face[j+1]];
-				const Node & node2 = mesh.nodes[face[j+2]];
-
-				// Triangle area
-				Face faceTri(3);
-				faceTri.SetNode(0, face[0]);
-				faceTri.SetNode(1, face[j+1]);
-				faceTri.SetNode(2, face[j+2]);
-
-				double dTriangleArea = CalculateFaceArea(faceTri, mesh.nodes);
-
-				// Calculate the element average
-				double dTotalSample = 0.0;
-
-				// Loop through all quadrature points
-				for (int k = 0; k < TriQuadraturePoints; k++) {
-					Node node(
-						  TriQuadratureG[k][0] * node0.x
-						+ TriQuadratureG[k][1] * node1.x
-						+ TriQuadratureG[k][2] * node2.x,
-						  TriQuadratureG[k][0] * node0.y
-						+ TriQuadratureG[k][1] * node1.y
-						+ TriQuadratureG[k][2] * node2.y,
-						  TriQuadratureG[k][0] * node0.z
-						+ TriQuadratureG[k][1] * node1.z
-						+ TriQuadratureG[k][2] * node2.z);
-
-					double dMagnitude = node.Magnitude();
-					node.x /= dMagnitude;
-					node.y /= dMagnitude;
-					node.z /= dMagnitude;
-
-					double dLon = atan2(node.y, node.x);
-					if (dLon < 0.0) {
-						dLon += 2.0 * M_PI;
+		const int nFaces = static_cast<int>(mesh.faces.size());
+
+		// Faces are distinct entries of dVar (also when flipped), so they
+		// are sampled independently.  The quadrature points of all
+		// sub-triangles of a Face are evaluated as one block.
+#pragma omp parallel num_threads(nThreads)
+		{
+			std::vector<double> vecLon;
+			std::vector<double> vecLat;
+			std::vector<double> vecSample;
+
+#pragma omp for schedule(dynamic, 256)
+			for (int i = 0; i < nFaces; i++) {
+
+				const Face & face = mesh.faces[i];
+
+				const int nTriangles = static_cast<int>(face.edges.size()) - 2;
+				const int nPoints = nTriangles * TriQuadraturePoints;
+
+				vecLon.resize(nPoints);
+				vecLat.resize(nPoints);
+				vecSample.resize(nPoints);
+
+				// Quadrature points of all sub-triangles
+				for (int j = 0; j < nTriangles; j++) {
+
+					const Node & node0 = mesh.nodes[face[0]];
+					const Node & node1 = mesh.nodes[face[j+1]];
+					const Node & node2 = mesh.nodes[face[j+2]];
+
+					for (int k = 0; k < TriQuadraturePoints; k++) {
+						Node node(
+							  TriQuadratureG[k][0] * node0.x
+							+ TriQuadratureG[k][1] * node1.x
+							+ TriQuadratureG[k][2] * node2.x,
+							  TriQuadratureG[k][0] * node0.y
+							+ TriQuadratureG[k][1] * node1.y
+							+ TriQuadratureG[k][2] * node2.y,
+							  TriQuadratureG[k][0] * node0.z
+							+ TriQuadratureG[k][1] * node1.z
+							+ TriQuadratureG[k][2] * node2.z);
+
+						double dMagnitude = node.Magnitude();
+						node.x /= dMagnitude;
+						node.y /= dMagnitude;
+						node.z /= dMagnitude;
+
+						const int ix = j * TriQuadraturePoints + k;
+						UnitNodeToLonLat(node, vecLon[ix], vecLat[ix]);
 					}
-					double dLat = asin(node.z);
-
-					double dSample = (*pTest)(dLon, dLat);
-
-					dTotalSample += dSample * TriQuadratureW[k] * dTriangleArea;
 				}
 
+				pTest->Evaluate(nPoints, &(vecLon[0]), &(vecLat[0]), &(vecSample[0]));
+
 				// Flip the rectilinear coordinate
 				int iv = i;
 				if (fFlipRectilinear) {
@@ -423,8 +534,29 @@ try {
 
 					iv = i0 * vecOutputDimSizes[1] + i1;
 				}
-				dVar[iv] += dTotalSample / mesh.vecFaceArea[i];
-				//dVar[i] += dTotalSample / mesh.vecFaceArea[i];
+
+				// Loop through all sub-triangles
+				for (int j = 0; j < nTriangles; j++) {
+
+					// Triangle area
+					Face faceTri(3);
+					faceTri.SetNode(0, face[0]);
+					faceTri.SetNode(1, face[j+1]);
+					faceTri.SetNode(2, face[j+2]);
+
+					double dTriangleArea = CalculateFaceArea(faceTri, mesh.nodes);
+
+					// Calculate the element average
+					double dTotalSample = 0.0;
+
+					for (int k = 0; k < TriQuadraturePoints; k++) {
+						dTotalSample +=
+							vecSample[j * TriQuadraturePoints + k]
+							* TriQuadratureW[k] * dTriangleArea;
+					}
+
+					dVar[iv] += dTotalSample / mesh.vecFaceArea[i];
+				}
 			}
 		}
 
@@ -491,13 +623,30 @@ try {
 		dVar.Allocate(iMaxNode);
 		dNodeArea.Allocate(iMaxNode);
 
-		// Sample data
-		for (int k = 0; k < nElements; k++) {
+		// Elements are sampled in parallel in blocks of ElementBlockSize,
+		// and the samples of each block are then gathered into the shared
+		// nodes serially in element order
+		const int ElementBlockSize = std::min(nElements, 65536);
 
-			const Face & face = mesh.faces[k];
+		// Sample data at GLL nodes.  Nodes shared between elements are
+		// sampled by each element, and the value from the last element
+		// is retained, as when sampling serially.
+		if (fGLL) {
+			const int nNodesPerElement = nP * nP;
+
+			DataArray2D<double> dElementLon(ElementBlockSize, nNodesPerElement);
+			DataArray2D<double> dElementLat(ElementBlockSize, nNodesPerElement);
+			DataArray2D<double> dElementSample(ElementBlockSize, nNodesPerElement);
+
+			for (int kBegin = 0; kBegin < nElements; kBegin += ElementBlockSize) {
+			const int kEnd = std::min(nElements, kBegin + ElementBlockSize);
+
+#pragma omp parallel for num_threads(nThreads) schedule(dynamic, 256)
+			for (int k = kBegin; k < kEnd; k++) {
+
+				const Face & face = mesh.faces[k];
+				const int kb = k - kBegin;
 
-			// Sample data at GLL nodes
-			if (fGLL) {
 				for (int i = 0; i < nP; i++) {
 				for (int j = 0; j < nP; j++) {
 
@@ -515,56 +664,50 @@ try {
 						dDx1G,
 						dDx2G);
 
-					// Sample data at this point
-					double dNodeLon = atan2(node.y, node.x);
-					if (dNodeLon < 0.0) {
-						dNodeLon += 2.0 * M_PI;
-					}
-					double dNodeLat = asin(node.z);
+					UnitNodeToLonLat(
+						node,
+						dElementLon[kb][i * nP + j],
+						dElementLat[kb][i * nP + j]);
+				}
+				}
+
+				pTest->Evaluate(
+					nNodesPerElement,
+					dElementLon[kb],
+					dElementLat[kb],
+					dElementSample[kb]);
+			}
 
-					double dSample = (*pTest)(dNodeLon, dNodeLat);
+			for (int k = kBegin; k < kEnd; k++) {
+				const int kb = k - kBegin;
+				for (int i = 0; i < nP; i++) {
+				for (int j = 0; j < nP; j++) {
+					const int ixNode = dataGLLNodes[j][i][k] - 1;
+					const int ixLocal = i * nP + j;
 
-					dVar[dataGLLNodes[j][i][k]-1] = dSample;
+					dVar[ixNode] = dElementSample[kb][ixLocal];
 
 					if (fHOMMEFormat) {
-						dLat[dataGLLNodes[j][i][k]-1] = dNodeLat * 180.0 / M_PI;
-						dLon[dataGLLNodes[j][i][k]-1] = dNodeLon * 180.0 / M_PI;
-						dArea[dataGLLNodes[j][i][k]-1] += dataGLLJacobian[j][i][k];
+						dLat[ixNode] = dElementLat[kb][ixLocal] * 180.0 / M_PI;
+						dLon[ixNode] = dElementLon[kb][ixLocal] * 180.0 / M_PI;
+						dArea[ixNode] += dataGLLJacobian[j][i][k];
 					}
 				}
 				}
+			}
+			}
 
-			// High-order Gaussian integration over basis function
-			} else {
-				DataArray2D<double> dCoeff(nP, nP);
+		// High-order Gaussian integration over basis function
+		} else {
+			const int nGaussPoints = nGaussP * nGaussP;
 
+			// Basis function values at each Gauss point, which are the
+			// same for every element
+			DataArray3D<double> dGaussCoeff(nGaussPoints, nP, nP);
+			{
+				DataArray2D<double> dCoeff(nP, nP);
 				for (int p = 0; p < nGaussP; p++) {
 				for (int q = 0; q < nGaussP; q++) {
-
-					// Apply local map
-					Node node;
-					Node dDx1G;
-					Node dDx2G;
-
-					ApplyLocalMap(
-						face,
-						mesh.nodes,
-						dGaussG[p],
-						dGaussG[q],
-						node,
-						dDx1G,
-						dDx2G);
-
-					// Cross product gives local Jacobian
-					Node nodeCross = CrossProduct(dDx1G, dDx2G);
-
-					double dJacobian = sqrt(
-						  nodeCross.x * nodeCross.x
-						+ nodeCross.y * nodeCross.y
-						+ nodeCross.z * nodeCross.z);
-
-					// Find components of quadrature point in basis
-					// of the first Face
 					SampleGLLFiniteElement(
 						0,
 						nP,
@@ -572,38 +715,113 @@ try {
 						dGaussG[q],
 						dCoeff);
 
-					// Sample data at this point
-					double dNodeLon = atan2(node.y, node.x);
-					if (dNodeLon < 0.0) {
-						dNodeLon += 2.0 * M_PI;
+					for (int i = 0; i < nP; i++) {
+					for (int j = 0; j < nP; j++) {
+						dGaussCoeff[p * nGaussP + q][i][j] = dCoeff[i][j];
+					}
+					}
+				}
+				}
+			}
+
+			// Integrals over each element, accumulated into the shared
+			// nodes in element order so the result does not depend on the
+			// number of threads
+			DataArray3D<double> dElementVar(ElementBlockSize, nP, nP);
+			DataArray3D<double> dElementArea(ElementBlockSize, nP, nP);
+
+			for (int kBegin = 0; kBegin < nElements; kBegin += ElementBlockSize) {
+			const int kEnd = std::min(nElements, kBegin + ElementBlockSize);
+
+#pragma omp parallel num_threads(nThreads)
+			{
+				std::vector<double> vecLon(nGaussPoints);
+				std::vector<double> vecLat(nGaussPoints);
+				std::vector<double> vecSample(nGaussPoints);
+				std::vector<double> vecJacobian(nGaussPoints);
+
+#pragma omp for schedule(dynamic, 256)
+				for (int k = kBegin; k < kEnd; k++) {
+
+					const Face & face = mesh.faces[k];
+					const int kb = k - kBegin;
+
+					for (int p = 0; p < nGaussP; p++) {
+					for (int q = 0; q < nGaussP; q++) {
+
+						// Apply local map
+						Node node;
+						Node dDx1G;
+						Node dDx2G;
+
+						ApplyLocalMap(
+							face,
+							mesh.nodes,
+							dGaussG[p],
+							dGaussG[q],
+							node,
+							dDx1G,
+							dDx2G);
+
+						// Cross product gives local Jacobian
+						Node nodeCross = CrossProduct(dDx1G, dDx2G);
+
+						const int ix = p * nGaussP + q;
+
+						vecJacobian[ix] = sqrt(
+							  nodeCross.x * nodeCross.x
+							+ nodeCross.y * nodeCross.y
+							+ nodeCross.z * nodeCross.z);
+
+						UnitNodeToLonLat(node, vecLon[ix], vecLat[ix]);
+					}
 					}
-					double dNodeLat = asin(node.z);
 
-					double dSample = (*pTest)(dNodeLon, dNodeLat);
+					pTest->Evaluate(
+						nGaussPoints, &(vecLon[0]), &(vecLat[0]), &(vecSample[0]));
 
 					// Integrate
 					for (int i = 0; i < nP; i++) {
 					for (int j = 0; j < nP; j++) {
+						dElementVar[kb][i][j] = 0.0;
+						dElementArea[kb][i][j] = 0.0;
+					}
+					}
+
+					for (int p = 0; p < nGaussP; p++) {
+					for (int q = 0; q < nGaussP; q++) {
+						const int ix = p * nGaussP + q;
 
-						double dNodalArea =
-							dCoeff[i][j]
-							* dGaussW[p]
-							* dGaussW[q]
-							* dJacobian;
+						for (int i = 0; i < nP; i++) {
+						for (int j = 0; j < nP; j++) {
 
-						dVar[dataGLLNodes[i][j][k]-1] +=
-							dSample * dNodalArea;
+							double dNodalArea =
+								dGaussCoeff[ix][i][j]
+								* dGaussW[p]
+								* dGaussW[q]
+								* vecJacobian[ix];
 
-						dNodeArea[dataGLLNodes[i][j][k]-1] +=
-							dNodalArea;
+							dElementVar[kb][i][j] += vecSample[ix] * dNodalArea;
+							dElementArea[kb][i][j] += dNodalArea;
+						}
+						}
 					}
 					}
+				}
+			}
 
+			for (int k = kBegin; k < kEnd; k++) {
+				const int kb = k - kBegin;
+				for (int i = 0; i < nP; i++) {
+				for (int j = 0; j < nP; j++) {
+					dVar[dataGLLNodes[i][j][k]-1] += dElementVar[kb][i][j];
+					dNodeArea[dataGLLNodes[i][j][k]-1] += dElementArea[kb][i][j];
 				}
 				}
 			}
+			}
 		}
-	
+
 		// Divide by area
 		if (fGLLIntegrate) {
 			for (int i = 0; i < dVar.GetRows(); i++) {
@@ -104,6 +104,13 @@ try {
 	// Check monotonicity
 	bool fCheckMonotone;
 
+	// Number of threads
+	int nThreads;
+
+	// Maximum number of sparse matrix entries held in memory (0 to load
+	// the full map)
+	int nMaxEntries;
+
 	// Parse the command line
 	BeginCommandLine()
 		CommandLineString(strInputMapFile, "in", "");
@@ -111,6 +118,8 @@ try {
 		CommandLineString(strOutputMapFile, "out", "");
 		CommandLineBool(fNoCheck, "nocheck");
 		CommandLineBool(fCheckMonotone, "checkmono");
+		CommandLineInt(nThreads, "nthreads", 1);
+		CommandLineInt(nMaxEntries, "max_entries", 0);
 
 		ParseCommandLine(argc, argv);
 	EndCommandLine(argv)
@@ -125,32 +134,43 @@ try {
 	if (strOutputMapFile == "") {
 		_EXCEPTIONT("Output map file (--out) must be specified");
 	}
+	if (nThreads < 1) {
+		_EXCEPTIONT("--nthreads must be at least 1");
+	}
+	if (nMaxEntries < 0) {
+		_EXCEPTIONT("--max_entries must be nonnegative");
+	}
 
 	// Atribute map
 	AttributeMap mapAttributes;
 
-	// Load map from file
+	// Load map from file, without the sparse matrix if it is to be
+	// transposed out of core
 	AnnounceStartBlock("Loading input map");
 	OfflineMap mapIn;
 	NcFile::FileFormat eFileFormat;
-	mapIn.Read(strInputMapFile, &mapAttributes, &eFileFormat);
+	if (nMaxEntries == 0) {
+		mapIn.Read(strInputMapFile, &mapAttributes, &eFileFormat);
+	} else {
+		mapIn.ReadGrid(strInputMapFile, &mapAttributes, &eFileFormat);
+	}
 	AnnounceEndBlock("Done");
 
 	// Generate transpose map
 	AnnounceStartBlock("Generating transpose map");
 	OfflineMap mapOut;
-	mapOut.SetTranspose(mapIn);
+	mapOut.SetTranspose(mapIn, nThreads);
 	AnnounceEndBlock("Done");
 
 	// Verify map
-	if (!fNoCheck) {
-		AnnounceStartBlock("Verifying map");
-		mapOut.IsConsistent(1.0e-8);
-		mapOut.IsConservative(1.0e-8);
+	if ((nMaxEntries != 0) && (!fNoCheck)) {
+		Announce("WARNING: Map verification is not available with "
+			"--max_entries; use --nocheck to suppress this warning");
 
-		if (fCheckMonotone) {
-			mapOut.IsMonotone(1.0e-12);
-		}
+	} else if (!fNoCheck) {
+		AnnounceStartBlock("Verifying map");
+		mapOut.SetThreadCount(nThreads);
+		mapOut.Verify(1.0e-8, 1.0e-8, fCheckMonotone, 1.0e-12);
 		AnnounceEndBlock("Done");
 	}
 
@@ -170,7 +190,17 @@ try {
 
 	// Write map to file
 	AnnounceStartBlock("Writing transpose map");
-	mapOut.Write(strOutputMapFile, mapAttributes, eFileFormat);
+	if (nMaxEntries == 0) {
+		mapOut.SetThreadCount(nThreads);
+		mapOut.Write(strOutputMapFile, mapAttributes, eFileFormat);
+	} else {
+		mapOut.WriteTransposeOfFile(
+			strInputMapFile,
+			strOutputMapFile,
+			mapAttributes,
+			eFileFormat,
+			static_cast<size_t>(nMaxEntries));
+	}
 	AnnounceEndBlock("Done");
 
 	return (0);
@@ -21,8 +21,8 @@
 
 #include <cmath>
 #include <iostream>
-#include <complex>
 #include <cfloat>
+#include <algorithm>
 
 #include "netcdfcpp.h"
 
@@ -154,14 +154,48 @@ void ConvertUTMtoRLL_Coeff(
 }
 
 ///	<summary>
-///		Convert a coordinate from UTM to RLL.
+///		Number of points converted together by ConvertUTMtoRLLBatch.
 ///	</summary>
-void ConvertUTMtoRLL(
+static const int UTMProjectionBatchSize = 64;
+
+///	<summary>
+///		Constants of the UTM to RLL projection in one zone, precomputed so
+///		that batches of points can be converted together.
+///	</summary>
+struct UTMtoRLLProjection {
+
+	///	<summary>
+	///		Origin longitude (rad).
+	///	</summary>
+	double dL0;
+
+	///	<summary>
+	///		Northing of the origin latitude (m).
+	///	</summary>
+	double dYS;
+
+	///	<summary>
+	///		Scaled semi-major axis (m).
+	///	</summary>
+	double dN;
+
+	///	<summary>
+	///		Ellipsoid eccentricity.
+	///	</summary>
+	double dE1;
+
+	///	<summary>
+	///		Transverse mercator reverse coefficients.
+	///	</summary>
+	double dC[5];
+};
+
+///	<summary>
+///		Initialize the UTM to RLL projection constants for a zone.
+///	</summary>
+void InitializeUTMtoRLLProjection(
 	int nZone,
-	double dX,
-	double dY,
-	double & dLon,
-	double & dLat
+	UTMtoRLLProjection & proj
 ) {
 	// Conversion from rad to degree
 	static const double dD0 = 180.0 / M_PI;
@@ -172,18 +206,9 @@ void ConvertUTMtoRLL(
 	// Flattening of the ellipsoid from WGS84 standard
 	static const double dF1 = 298.257223563;
 
-	// Maximum iteration for latitude computation
-	static const int nMaxIter = 100;
-
-	// Minimum residue for latitude computation
-	static const double dEps = 1.0e-11;
-
 	// UTM scale factor
 	static const double dK0 = 0.9996;
 
-	// UTM false East (m)
-	static const double dX0 = 500000.0;
-
 	// UTM false North (m)
 	const double dY0 = 1.0e7 * static_cast<double>(nZone < 0);
 
@@ -191,62 +216,130 @@ void ConvertUTMtoRLL(
 	static const double dP0 = 0.0;
 
 	// UTM origin longitude (rad)
-	const double dL0 = (6.0 * fabs(static_cast<double>(nZone)) - 183.0) / dD0;
+	proj.dL0 = (6.0 * fabs(static_cast<double>(nZone)) - 183.0) / dD0;
 
 	// Ellipsoid eccentricity
 	const double dE1x = dA1 * (1.0 - 1.0/dF1);
-	const double dE1 = sqrt((dA1 * dA1 - dE1x * dE1x)/(dA1 * dA1));
+	proj.dE1 = sqrt((dA1 * dA1 - dE1x * dE1x)/(dA1 * dA1));
 
-	const double dN = dK0 * dA1;
+	proj.dN = dK0 * dA1;
 
 	// Computing parameters for Mercator Transverse projection
 	double dC[5];
 
-	ConvertUTMtoRLL_Coeff(dE1, 0, dC);
+	ConvertUTMtoRLL_Coeff(proj.dE1, 0, dC);
 
-	const double dYS =
-		dY0 - dN * (
+	proj.dYS =
+		dY0 - proj.dN * (
 			  dC[0] * dP0
 			+ dC[1] * sin(2.0 * dP0)
 			+ dC[2] * sin(4.0 * dP0)
 			+ dC[3] * sin(6.0 * dP0)
 			+ dC[4] * sin(8.0 * dP0));
 
-	ConvertUTMtoRLL_Coeff(dE1, 1, dC);
+	ConvertUTMtoRLL_Coeff(proj.dE1, 1, proj.dC);
+}
+
+///	<summary>
+///		Convert a batch of at most UTMProjectionBatchSize coordinates from
+///		UTM to RLL (in radians).  The complex series of the reverse
+///		transverse mercator projection is expanded into real arithmetic,
+///		with the multiple angles generated by recurrence, and the latitude
+///		iteration advances all points together until every one has
+///		converged, so that the inner loops vectorize.  Returns false if
+///		the latitude iteration does not converge.
+///	</summary>
+bool ConvertUTMtoRLLBatch(
+	const UTMtoRLLProjection & proj,
+	int nPoints,
+	const double * dX,
+	const double * dY,
+	double * dLon,
+	double * dLat
+) {
+	// Maximum iteration for latitude computation
+	static const int nMaxIter = 100;
+
+	// Minimum residue for latitude computation
+	static const double dEps = 1.0e-11;
+
+	// UTM false East (m)
+	static const double dX0 = 500000.0;
+
+	if (nPoints > UTMProjectionBatchSize) {
+		_EXCEPTIONT("Batch size exceeded");
+	}
+
+	const double dScale = 1.0 / (proj.dN * proj.dC[0]);
 
-	std::complex<double> dZT((dY - dYS)/dN/dC[0], (dX - dX0)/dN/dC[0]);
+	// Exponential of the isometric latitude of each point
+	double dExpL[UTMProjectionBatchSize];
 
-	std::complex<double> dZ =
-		dZT
-		- dC[1] * sin(2.0 * dZT)
-		- dC[2] * sin(4.0 * dZT)
-		- dC[3] * sin(6.0 * dZT)
-		- dC[4] * sin(8.0 * dZT);
+#pragma omp simd
+	for (int k = 0; k < nPoints; k++) {
 
-	double dL = dZ.real();
-	double dLS = dZ.imag();
+		// z = zt - sum_m C[m] sin(2 m zt) with zt = a + i b, using
+		// sin(a + i b) = sin(a) cosh(b) + i cos(a) sinh(b)
+		const double dA = (dY[k] - proj.dYS) * dScale;
+		const double dB = (dX[k] - dX0) * dScale;
 
-	double dl = dL0 + atan(sinh(dLS) / cos(dL));
-	double dp = asin(sin(dL) / cosh(dLS));
+		const double dSin2A = sin(2.0 * dA);
+		const double dCos2A = cos(2.0 * dA);
+		const double dExp2B = exp(2.0 * dB);
+		const double dExpM2B = 1.0 / dExp2B;
 
-	dL = log(tan(M_PI/4.0 + dp/2.0));
+		double dSinMA = dSin2A;
+		double dCosMA = dCos2A;
+		double dExpMB = dExp2B;
+		double dExpMMB = dExpM2B;
 
-	dp = 2.0 * atan(exp(dL)) - M_PI/2.0;
-	
-	int i = 0;
-	double dp0 = DBL_MAX;
-	while (((dp0 == DBL_MAX) || (fabs(dp - dp0) > dEps)) && (i < nMaxIter)) {
-		dp0 = dp;
-		double dES = dE1 * sin(dp0);
-		dp = pow(2.0 * atan((1.0 + dES) / (1.0 - dES)), dE1/2.0) * exp(dL) - M_PI/2.0;
-		i++;
+		double dL = dA;
+		double dLS = dB;
+
+		for (int m = 1; m < 5; m++) {
+			dL  -= proj.dC[m] * dSinMA * 0.5 * (dExpMB + dExpMMB);
+			dLS -= proj.dC[m] * dCosMA * 0.5 * (dExpMB - dExpMMB);
+
+			const double dSinNext = dSinMA * dCos2A + dCosMA * dSin2A;
+			dCosMA = dCosMA * dCos2A - dSinMA * dSin2A;
+			dSinMA = dSinNext;
+			dExpMB *= dExp2B;
+			dExpMMB *= dExpM2B;
+		}
+
+		dLon[k] = proj.dL0 + atan(sinh(dLS) / cos(dL));
+
+		const double dp = asin(sin(dL) / cosh(dLS));
+
+		dExpL[k] = tan(M_PI/4.0 + dp/2.0);
+
+		dLat[k] = 2.0 * atan(dExpL[k]) - M_PI/2.0;
 	}
-	if (i == nMaxIter) {
-		_EXCEPTIONT("Convergence failure");
+
+	// Calculate latitude from the isometric latitude
+	const double dHalfE1 = 0.5 * proj.dE1;
+
+	for (int i = 0; i < nMaxIter; i++) {
+		double dMaxDelta = 0.0;
+
+#pragma omp simd reduction(max:dMaxDelta)
+		for (int k = 0; k < nPoints; k++) {
+			const double dp0 = dLat[k];
+			const double dES = proj.dE1 * sin(dp0);
+			const double dp =
+				2.0 * atan(pow((1.0 + dES) / (1.0 - dES), dHalfE1) * dExpL[k])
+				- M_PI/2.0;
+
+			dMaxDelta = std::max(dMaxDelta, fabs(dp - dp0));
+			dLat[k] = dp;
+		}
+
+		if (dMaxDelta <= dEps) {
+			return true;
+		}
 	}
 
-	dLat = dp;
-	dLon = dl;
+	return false;
 
 /*
 	% constants
@@ -297,6 +390,24 @@ end
 */
 }
 
+///	<summary>
+///		Convert a coordinate from UTM to RLL.
+///	</summary>
+void ConvertUTMtoRLL(
+	int nZone,
+	double dX,
+	double dY,
+	double & dLon,
+	double & dLat
+) {
+	UTMtoRLLProjection proj;
+	InitializeUTMtoRLLProjection(nZone, proj);
+
+	if (!ConvertUTMtoRLLBatch(proj, 1, &dX, &dY, &dLon, &dLat)) {
+		_EXCEPTIONT("Convergence failure");
+	}
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -309,6 +420,7 @@ end
 // YLL Corner of the mesh: double dYLLCorner;
 // Cell size of the mesh: double dCellSize;
 // Output filename: std::string strOutputFile;
+// Number of threads: int nThreads;
 // 
 // Output Parameters: Mesh*
 // 
@@ -322,7 +434,8 @@ int GenerateUTMMesh(
 	double dYLLCorner,
 	double dCellSize,
 	std::string strOutputFile,
-	bool fVerbose
+	bool fVerbose,
+	int nThreads
 ) {
 
 	NcError error(NcError::silent_nonfatal);
@@ -336,41 +449,72 @@ try {
 	NodeVector & nodes = mesh.nodes;
 	FaceVector & faces = mesh.faces;
 
-	// Loop through all nodes
-	for (int j = 0; j < nRows+1; j++) {
-	for (int i = 0; i < nCols+1; i++) {
-		double dXLL = dXLLCorner + static_cast<double>(i) * dCellSize;
-		double dYLL = dYLLCorner + static_cast<double>(j) * dCellSize;
+	if (nThreads < 1) {
+		_EXCEPTIONT("Thread count must be at least 1");
+	}
 
-		double dLon;
-		double dLat;
+	// Projection constants of this zone
+	UTMtoRLLProjection proj;
+	InitializeUTMtoRLLProjection(nZone, proj);
 
-		ConvertUTMtoRLL(nZone, dXLL, dYLL, dLon, dLat);
+	// Convert each row of nodes a batch at a time
+	const int nRowNodes = nCols + 1;
 
-		//printf("%i %1.5e %1.5e\n", nodes.size(), dLon, dLat);
+	nodes.resize(static_cast<size_t>(nRows + 1) * nRowNodes);
 
-		double dX = cos(dLat) * cos(dLon);
-		double dY = cos(dLat) * sin(dLon);
-		double dZ = sin(dLat);
+	int iConvergenceFailure = 0;
 
-		nodes.push_back(Node(dX, dY, dZ));
+#pragma omp parallel for schedule(dynamic, 16) num_threads(nThreads)
+	for (int j = 0; j < nRows+1; j++) {
+		double dXLL[UTMProjectionBatchSize];
+		double dYLL[UTMProjectionBatchSize];
+		double dLon[UTMProjectionBatchSize];
+		double dLat[UTMProjectionBatchSize];
+
+		for (int i0 = 0; i0 < nRowNodes; i0 += UTMProjectionBatchSize) {
+			const int nBatch = std::min(UTMProjectionBatchSize, nRowNodes - i0);
+
+			for (int k = 0; k < nBatch; k++) {
+				dXLL[k] = dXLLCorner + static_cast<double>(i0 + k) * dCellSize;
+				dYLL[k] = dYLLCorner + static_cast<double>(j) * dCellSize;
+			}
+
+			if (!ConvertUTMtoRLLBatch(proj, nBatch, dXLL, dYLL, dLon, dLat)) {
+#pragma omp atomic write
+				iConvergenceFailure = 1;
+			}
+
+			const size_t ixNode = static_cast<size_t>(j) * nRowNodes + i0;
+
+			for (int k = 0; k < nBatch; k++) {
+				nodes[ixNode + k] =
+					Node(
+						cos(dLat[k]) * cos(dLon[k]),
+						cos(dLat[k]) * sin(dLon[k]),
+						sin(dLat[k]));
+			}
+		}
 	}
+
+	if (iConvergenceFailure) {
+		_EXCEPTIONT("Convergence failure");
 	}
 
 	// Generate faces
+	faces.resize(static_cast<size_t>(nRows) * nCols, Face(4));
+
+#pragma omp parallel for num_threads(nThreads)
 	for (int j = 0; j < nRows; j++) {
 
 		int iThisLatNodeIx =  j    * (nCols + 1);
 		int iNextLatNodeIx = (j+1) * (nCols + 1);
 
 		for (int i = 0; i < nCols; i++) {
-			Face face(4);
+			Face & face = faces[static_cast<size_t>(j) * nCols + i];
 			face.SetNode(0, iThisLatNodeIx + i);
 			face.SetNode(1, iThisLatNodeIx + (i + 1) % (nCols + 1));
 			face.SetNode(2, iNextLatNodeIx + (i + 1) % (nCols + 1));
 			face.SetNode(3, iNextLatNodeIx + i);
-
-			faces.push_back(face);
 		}
 	}
 
@@ -393,7 +537,7 @@ try {
 		std::cout << "..Writing mesh to file [" << strOutputFile.c_str() << "] ";
 		std::cout << std::endl;
 
-		mesh.Write(strOutputFile);
+		mesh.Write(strOutputFile, NcFile::Classic, 0, nThreads);
 
 		NcFile ncOutput(strOutputFile.c_str(), NcFile::Write);
 		ncOutput.add_att("rectilinear", "true");
@@ -52,6 +52,9 @@ int main(int argc, char** argv) {
 	// Verbose output
 	bool fVerbose;
 
+	// Number of threads
+	int nThreads;
+
 	// Parse the command line
 	BeginCommandLine()
 	CommandLineInt(nZone, "zone", 0);
@@ -62,6 +65,7 @@ int main(int argc, char** argv) {
 	CommandLineDouble(dCellSize, "cellsize", 1000.0);
 	CommandLineString(strOutputFile, "file", "outUTMMesh.g");
 	CommandLineBool(fVerbose, "verbose");
+	CommandLineInt(nThreads, "nthreads", 1);
 
 	ParseCommandLine(argc, argv);
 	EndCommandLine(argv)
@@ -76,13 +80,16 @@ int main(int argc, char** argv) {
 	if (dCellSize <= 0.0) {
 		_EXCEPTIONT("--cellsize must be positive");
 	}
+	if (nThreads < 1) {
+		_EXCEPTIONT("--nthreads must be at least 1");
+	}
 
 	std::cout << "=========================================================";
 	std::cout << std::endl;
 
 	// Call the actual mesh generator
 	Mesh mesh;
-	int err = GenerateUTMMesh(mesh, nZone, nCols, nRows, dXLLCorner, dYLLCorner, dCellSize, strOutputFile, fVerbose);
+	int err = GenerateUTMMesh(mesh, nZone, nCols, nRows, dXLLCorner, dYLLCorner, dCellSize, strOutputFile, fVerbose, nThreads);
 	if (err) exit(err);
 
 	return 0;
@@ -124,12 +124,14 @@ try {
 	// Data structures used for generating connectivity
 	DataArray3D<int> dataGLLnodes(nP, nP, nElements);
 	std::vector<Node> vecNodes;
-	std::map<Node, int> mapFaces;
+	node_hash_3d<Node, int> mapFaces(
+		ReferenceTolerance, MESH_NODE_HASH_CELL_WIDTH);
 
 	// Data structure for 
 
 	// Data structure used for avoiding coincident nodes on the fly
-	std::map<Node, int> mapNewNodes;
+	node_hash_3d<Node, int> mapNewNodes(
+		ReferenceTolerance, MESH_NODE_HASH_CELL_WIDTH);
 
 	// Generate new mesh
 	std::cout << "..Generating sub-volumes" << std::endl;
@@ -171,14 +173,15 @@ try {
 					dDx2G);
 
 				// Determine if this is a unique Node
-				std::map<Node, int>::const_iterator iter =
+				node_hash_3d<Node, int>::const_iterator iter =
 					mapFaces.find(nodeGLL);
 
 				if (iter == mapFaces.end()) {
 
 					// Insert new unique node into map
 					int ixNode = static_cast<int>(mapFaces.size());
-					mapFaces.insert(std::pair<Node, int>(nodeGLL, ixNode));
+					mapFaces.insert(
+						node_hash_3d<Node, int>::value_type(nodeGLL, ixNode));
 					dataGLLnodes[q][p][f] = ixNode + 1;
 					vecNodes.push_back(nodeGLL);
 
@@ -205,11 +208,12 @@ try {
 						node0, node1, node2, node3,
 						dAccumW[px], dAccumW[qx]);
 	
-				std::map<Node, int>::const_iterator iterNode =
+				node_hash_3d<Node, int>::const_iterator iterNode =
 					mapNewNodes.find(nodeOut);
 				if (iterNode == mapNewNodes.end()) {
 					mapNewNodes.insert(
-						std::pair<Node, int>(nodeOut, meshOut.nodes.size()));
+						node_hash_3d<Node, int>::value_type(
+							nodeOut, static_cast<int>(meshOut.nodes.size())));
 					faceNew.SetNode(i, meshOut.nodes.size());
 					meshOut.nodes.push_back(nodeOut);
 				} else {
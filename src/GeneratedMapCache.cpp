@@ -0,0 +1,457 @@
+///////////////////////////////////////////////////////////////////////////////
+///
+///	\file    GeneratedMapCache.cpp
+///	\author  agent
+///	\version October 15, 2026
+///
+///	<remarks>
+///		Copyright 2026 agent
+///
+///		This file is distributed as part of the Tempest source code package.
+///		Permission is granted to use, copy, modify and distribute this
+///		source code and its documentation under the terms of the GNU General
+///		Public License.  This software is provided "as is" without express
+///		or implied warranty.
+///	</remarks>
+
+#include "GeneratedMapCache.h"
+#include "Exception.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Offset basis and prime of the 64-bit FNV-1a hash.
+///	</summary>
+static const uint64_t FNV1aOffsetBasis = 14695981039346656037ULL;
+static const uint64_t FNV1aPrime = 1099511628211ULL;
+
+///	<summary>
+///		Number of nodes or faces hashed together as one block.  Blocks are
+///		hashed in parallel and their hashes combined in order, so the hash
+///		of a Mesh does not depend on the number of threads.
+///	</summary>
+static const int MeshHashBlockSize = 65536;
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Update a 64-bit FNV-1a hash with sBytes bytes of data.
+///	</summary>
+static uint64_t FNV1aUpdate(
+	uint64_t uHash,
+	const void * pData,
+	size_t sBytes
+) {
+	const unsigned char * p = reinterpret_cast<const unsigned char *>(pData);
+	for (size_t i = 0; i < sBytes; i++) {
+		uHash ^= static_cast<uint64_t>(p[i]);
+		uHash *= FNV1aPrime;
+	}
+	return uHash;
+}
+
+///	<summary>
+///		Update a 64-bit FNV-1a hash with a value.
+///	</summary>
+template <typename T>
+static uint64_t FNV1aUpdateValue(
+	uint64_t uHash,
+	const T & value
+) {
+	return FNV1aUpdate(uHash, &value, sizeof(T));
+}
+
+///	<summary>
+///		Update a 64-bit FNV-1a hash with the size and contents of an array.
+///	</summary>
+template <typename T>
+static uint64_t FNV1aUpdateArray(
+	uint64_t uHash,
+	const T * pData,
+	size_t sCount
+) {
+	uHash = FNV1aUpdateValue(uHash, static_cast<uint64_t>(sCount));
+	if (sCount != 0) {
+		uHash = FNV1aUpdate(uHash, pData, sCount * sizeof(T));
+	}
+	return uHash;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Compute a hash of everything in a Mesh that may affect a map:
+///		its type, nodes, faces, parent faces, stored face areas, mask and
+///		MultiFaceMap.
+///	</summary>
+static uint64_t HashMeshContents(
+	const Mesh & mesh,
+	int nThreads
+) {
+	const int nNodes = static_cast<int>(mesh.nodes.size());
+	const int nFaces = static_cast<int>(mesh.faces.size());
+
+	const int nNodeBlocks = (nNodes + MeshHashBlockSize - 1) / MeshHashBlockSize;
+	const int nFaceBlocks = (nFaces + MeshHashBlockSize - 1) / MeshHashBlockSize;
+
+	std::vector<uint64_t> vecBlockHash(nNodeBlocks + nFaceBlocks);
+
+#pragma omp parallel for schedule(dynamic, 1) num_threads(nThreads)
+	for (int b = 0; b < nNodeBlocks + nFaceBlocks; b++) {
+		uint64_t uHash = FNV1aOffsetBasis;
+
+		if (b < nNodeBlocks) {
+			const int iEnd = std::min(nNodes, (b + 1) * MeshHashBlockSize);
+			for (int i = b * MeshHashBlockSize; i < iEnd; i++) {
+				const Node & node = mesh.nodes[i];
+				uHash = FNV1aUpdateValue(uHash, static_cast<double>(node.x));
+				uHash = FNV1aUpdateValue(uHash, static_cast<double>(node.y));
+				uHash = FNV1aUpdateValue(uHash, static_cast<double>(node.z));
+			}
+
+		} else {
+			const int bFace = b - nNodeBlocks;
+			const int iEnd = std::min(nFaces, (bFace + 1) * MeshHashBlockSize);
+			for (int i = bFace * MeshHashBlockSize; i < iEnd; i++) {
+				const Face & face = mesh.faces[i];
+				const int nEdges = static_cast<int>(face.edges.size());
+
+				uHash = FNV1aUpdateValue(uHash, nEdges);
+				for (int k = 0; k < nEdges; k++) {
+					uHash = FNV1aUpdateValue(uHash, face[k]);
+					uHash = FNV1aUpdateValue(uHash,
+						static_cast<int>(face.edges[k].type));
+				}
+			}
+		}
+
+		vecBlockHash[b] = uHash;
+	}
+
+	uint64_t uHash = FNV1aOffsetBasis;
+	uHash = FNV1aUpdateValue(uHash, static_cast<int>(mesh.type));
+	uHash = FNV1aUpdateValue(uHash, nNodes);
+	uHash = FNV1aUpdateValue(uHash, nFaces);
+	uHash = FNV1aUpdateArray(uHash, vecBlockHash.data(), vecBlockHash.size());
+
+	uHash = FNV1aUpdateArray(uHash,
+		mesh.vecSourceFaceIx.data(), mesh.vecSourceFaceIx.size());
+	uHash = FNV1aUpdateArray(uHash,
+		mesh.vecTargetFaceIx.data(), mesh.vecTargetFaceIx.size());
+	uHash = FNV1aUpdateArray(uHash,
+		mesh.vecMultiFaceMap.data(), mesh.vecMultiFaceMap.size());
+
+	// Stored face areas are used in place of computed areas
+	if (mesh.vecFaceArea.GetRows() == mesh.faces.size()) {
+		uHash = FNV1aUpdateArray(uHash,
+			&(mesh.vecFaceArea[0]), mesh.vecFaceArea.GetRows());
+	} else {
+		uHash = FNV1aUpdateArray(uHash, (const double *)NULL, 0);
+	}
+
+	if (mesh.vecMask.GetRows() != 0) {
+		uHash = FNV1aUpdateArray(uHash,
+			&(mesh.vecMask[0]), mesh.vecMask.GetRows());
+	} else {
+		uHash = FNV1aUpdateArray(uHash, (const int *)NULL, 0);
+	}
+
+	return uHash;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Compute a hash of the contents of a file.
+///	</summary>
+static uint64_t HashFileContents(
+	const std::string & strFile
+) {
+	FILE * fp = fopen(strFile.c_str(), "rb");
+	if (fp == NULL) {
+		_EXCEPTION1("Unable to open \"%s\"", strFile.c_str());
+	}
+
+	std::vector<char> vecBuffer(1 << 20);
+
+	uint64_t uHash = FNV1aOffsetBasis;
+	for (;;) {
+		const size_t sRead = fread(&(vecBuffer[0]), 1, vecBuffer.size(), fp);
+		uHash = FNV1aUpdate(uHash, &(vecBuffer[0]), sRead);
+		if (sRead < vecBuffer.size()) {
+			break;
+		}
+	}
+
+	const bool fError = (ferror(fp) != 0);
+	fclose(fp);
+
+	if (fError) {
+		_EXCEPTION1("Error reading \"%s\"", strFile.c_str());
+	}
+
+	return uHash;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Format a 64-bit hash in hexadecimal.
+///	</summary>
+static std::string FormatHash(
+	uint64_t uHash
+) {
+	char szHash[32];
+	snprintf(szHash, sizeof(szHash), "%016llx",
+		static_cast<unsigned long long>(uHash));
+	return std::string(szHash);
+}
+
+///	<summary>
+///		Suffix of temporary files written by this process.
+///	</summary>
+static std::string TemporarySuffix() {
+	char szSuffix[32];
+	snprintf(szSuffix, sizeof(szSuffix), ".tmp.%ld",
+		static_cast<long>(getpid()));
+	return std::string(szSuffix);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+GeneratedMapCache::GeneratedMapCache()
+{ }
+
+///////////////////////////////////////////////////////////////////////////////
+
+void GeneratedMapCache::Open(
+	const std::string & strCacheDir
+) {
+	if (strCacheDir == "") {
+		_EXCEPTIONT("No map cache directory specified");
+	}
+
+	if ((mkdir(strCacheDir.c_str(), 0777) != 0) && (errno != EEXIST)) {
+		_EXCEPTION2("Unable to create map cache directory \"%s\" (%s)",
+			strCacheDir.c_str(), strerror(errno));
+	}
+
+	m_strCacheDir = strCacheDir;
+	if (m_strCacheDir[m_strCacheDir.length()-1] != '/') {
+		m_strCacheDir += "/";
+	}
+
+	m_strKey = "";
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void GeneratedMapCache::AddKey(
+	const std::string & strName,
+	const std::string & strValue
+) {
+	if ((strName.find('\n') != std::string::npos) ||
+	    (strValue.find('\n') != std::string::npos)
+	) {
+		_EXCEPTION1("Invalid map cache key \"%s\"", strName.c_str());
+	}
+
+	m_strKey += strName + " = " + strValue + "\n";
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void GeneratedMapCache::AddKey(
+	const std::string & strName,
+	int iValue
+) {
+	AddKey(strName, std::to_string((long long)iValue));
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void GeneratedMapCache::AddKey(
+	const std::string & strName,
+	double dValue
+) {
+	char szValue[64];
+	snprintf(szValue, sizeof(szValue), "%a", dValue);
+	AddKey(strName, std::string(szValue));
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void GeneratedMapCache::AddMeshKey(
+	const std::string & strName,
+	const Mesh & mesh,
+	int nThreads
+) {
+	AddKey(strName, FormatHash(HashMeshContents(mesh, nThreads)));
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void GeneratedMapCache::AddFileKey(
+	const std::string & strName,
+	const std::string & strFile
+) {
+	if (strFile == "") {
+		AddKey(strName, std::string(""));
+	} else {
+		AddKey(strName, FormatHash(HashFileContents(strFile)));
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+std::string GeneratedMapCache::GetKeyHash() const {
+	return FormatHash(
+		FNV1aUpdate(FNV1aOffsetBasis, m_strKey.c_str(), m_strKey.length()));
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+std::string GeneratedMapCache::GetMapPath() const {
+	return (m_strCacheDir + GetKeyHash() + ".nc");
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+std::string GeneratedMapCache::GetTemporaryPath() const {
+	return (GetMapPath() + TemporarySuffix());
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+bool GeneratedMapCache::Lookup() const {
+	const std::string strMap = GetMapPath();
+	const std::string strKeyFile = m_strCacheDir + GetKeyHash() + ".key";
+
+	if (access(strMap.c_str(), R_OK) != 0) {
+		return false;
+	}
+
+	// The stored key must match exactly, so that colliding hashes are
+	// never mistaken for each other
+	FILE * fp = fopen(strKeyFile.c_str(), "rb");
+	if (fp == NULL) {
+		return false;
+	}
+
+	std::string strStoredKey;
+	char szBuffer[4096];
+	for (;;) {
+		const size_t sRead = fread(szBuffer, 1, sizeof(szBuffer), fp);
+		strStoredKey.append(szBuffer, sRead);
+		if (sRead < sizeof(szBuffer)) {
+			break;
+		}
+	}
+	fclose(fp);
+
+	return (strStoredKey == m_strKey);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void GeneratedMapCache::Commit() const {
+	const std::string strMap = GetMapPath();
+	const std::string strTempMap = GetTemporaryPath();
+	const std::string strKeyFile = m_strCacheDir + GetKeyHash() + ".key";
+	const std::string strTempKeyFile = strKeyFile + TemporarySuffix();
+
+	FILE * fp = fopen(strTempKeyFile.c_str(), "wb");
+	if (fp == NULL) {
+		_EXCEPTION2("Unable to create map cache key \"%s\" (%s)",
+			strTempKeyFile.c_str(), strerror(errno));
+	}
+
+	bool fSuccess =
+		(fwrite(m_strKey.c_str(), 1, m_strKey.length(), fp)
+			== m_strKey.length());
+	fSuccess = (fclose(fp) == 0) && fSuccess;
+
+	if (!fSuccess) {
+		remove(strTempKeyFile.c_str());
+		_EXCEPTION1("Unable to write map cache key \"%s\"",
+			strTempKeyFile.c_str());
+	}
+
+	if (rename(strTempKeyFile.c_str(), strKeyFile.c_str()) != 0) {
+		remove(strTempKeyFile.c_str());
+		_EXCEPTION2("Unable to rename map cache key to \"%s\" (%s)",
+			strKeyFile.c_str(), strerror(errno));
+	}
+
+	// Cached maps are read-only
+	chmod(strTempMap.c_str(), 0444);
+
+	if (rename(strTempMap.c_str(), strMap.c_str()) != 0) {
+		remove(strTempMap.c_str());
+		_EXCEPTION2("Unable to rename cached map to \"%s\" (%s)",
+			strMap.c_str(), strerror(errno));
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void GeneratedMapCache::Copy(
+	const std::string & strSource,
+	const std::string & strTarget
+) {
+	if ((remove(strTarget.c_str()) != 0) && (errno != ENOENT)) {
+		_EXCEPTION2("Unable to replace \"%s\" (%s)",
+			strTarget.c_str(), strerror(errno));
+	}
+
+	FILE * fpSource = fopen(strSource.c_str(), "rb");
+	if (fpSource == NULL) {
+		_EXCEPTION2("Unable to open \"%s\" (%s)",
+			strSource.c_str(), strerror(errno));
+	}
+
+	FILE * fpTarget = fopen(strTarget.c_str(), "wb");
+	if (fpTarget == NULL) {
+		fclose(fpSource);
+		_EXCEPTION2("Unable to create \"%s\" (%s)",
+			strTarget.c_str(), strerror(errno));
+	}
+
+	std::vector<char> vecBuffer(1 << 20);
+
+	bool fSuccess = true;
+	for (;;) {
+		const size_t sRead =
+			fread(&(vecBuffer[0]), 1, vecBuffer.size(), fpSource);
+		if (fwrite(&(vecBuffer[0]), 1, sRead, fpTarget) != sRead) {
+			fSuccess = false;
+			break;
+		}
+		if (sRead < vecBuffer.size()) {
+			fSuccess = (ferror(fpSource) == 0);
+			break;
+		}
+	}
+
+	fclose(fpSource);
+	fSuccess = (fclose(fpTarget) == 0) && fSuccess;
+
+	if (!fSuccess) {
+		remove(strTarget.c_str());
+		_EXCEPTION2("Unable to copy \"%s\" to \"%s\"",
+			strSource.c_str(), strTarget.c_str());
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
@@ -0,0 +1,152 @@
+///////////////////////////////////////////////////////////////////////////////
+///
+///	\file    GeneratedMapCache.h
+///	\author  agent
+///	\version October 15, 2026
+///
+///	<remarks>
+///		Copyright 2026 agent
+///
+///		This file is distributed as part of the Tempest source code package.
+///		Permission is granted to use, copy, modify and distribute this
+///		source code and its documentation under the terms of the GNU General
+///		Public License.  This software is provided "as is" without express
+///		or implied warranty.
+///	</remarks>
+
+#ifndef _GENERATEDMAPCACHE_H_
+#define _GENERATEDMAPCACHE_H_
+
+#include "GridElements.h"
+
+#include <string>
+#include <stdint.h>
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		A content-addressed cache of generated offline map files.  Each
+///		map is keyed by a list of named values describing everything that
+///		determines its contents, including hashes of the contents of its
+///		meshes and meta data files.  The map is stored in the cache
+///		directory as <hash>.nc, where <hash> is the hash of the key, next
+///		to the full key in <hash>.key, which must match exactly for a hit.
+///	</summary>
+///	<remarks>
+///		Cached maps are made read-only and handed out as copies, so that
+///		modifying an output map cannot change the map in the cache.  The
+///		attributes of a cached map name the mesh files of the
+///		run that generated it, so these names are part of the key.
+///	</remarks>
+class GeneratedMapCache {
+
+public:
+	///	<summary>
+	///		Constructor.
+	///	</summary>
+	GeneratedMapCache();
+
+public:
+	///	<summary>
+	///		Begin a key for a map in the cache directory strCacheDir, which
+	///		is created if it does not exist.
+	///	</summary>
+	void Open(
+		const std::string & strCacheDir
+	);
+
+	///	<summary>
+	///		Add a named value to the key.
+	///	</summary>
+	void AddKey(
+		const std::string & strName,
+		const std::string & strValue
+	);
+
+	///	<summary>
+	///		Add a named integer to the key.
+	///	</summary>
+	void AddKey(
+		const std::string & strName,
+		int iValue
+	);
+
+	///	<summary>
+	///		Add a named floating point value to the key, exactly.
+	///	</summary>
+	void AddKey(
+		const std::string & strName,
+		double dValue
+	);
+
+	///	<summary>
+	///		Add a hash of the contents of a Mesh to the key.
+	///	</summary>
+	void AddMeshKey(
+		const std::string & strName,
+		const Mesh & mesh,
+		int nThreads = 1
+	);
+
+	///	<summary>
+	///		Add a hash of the contents of a file to the key, or an empty
+	///		value if strFile is empty.
+	///	</summary>
+	void AddFileKey(
+		const std::string & strName,
+		const std::string & strFile
+	);
+
+	///	<summary>
+	///		Determine if a map with the current key is in the cache.
+	///	</summary>
+	bool Lookup() const;
+
+	///	<summary>
+	///		Get the path of the cached map with the current key.
+	///	</summary>
+	std::string GetMapPath() const;
+
+	///	<summary>
+	///		Get the path to which a map with the current key should be
+	///		written before it is committed to the cache.
+	///	</summary>
+	std::string GetTemporaryPath() const;
+
+	///	<summary>
+	///		Move the map written to GetTemporaryPath() into the cache.  The
+	///		key is written before the map is renamed into place, so other
+	///		processes never see a partial map or a map without its key.
+	///	</summary>
+	void Commit() const;
+
+	///	<summary>
+	///		Copy strSource to strTarget, replacing any existing strTarget.
+	///	</summary>
+	static void Copy(
+		const std::string & strSource,
+		const std::string & strTarget
+	);
+
+protected:
+	///	<summary>
+	///		Get the hash of the current key, in hexadecimal.
+	///	</summary>
+	std::string GetKeyHash() const;
+
+protected:
+	///	<summary>
+	///		Cache directory, with a trailing slash.
+	///	</summary>
+	std::string m_strCacheDir;
+
+	///	<summary>
+	///		Current key, as lines of "name = value".
+	///	</summary>
+	std::string m_strKey;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+#endif
+
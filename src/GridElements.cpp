@@ -16,6 +16,7 @@
 
 #include "Defines.h"
 #include "GridElements.h"
+#include "CompactOverlapMesh.h"
 
 #include "DataArray2D.h"
 #include "Announce.h"
@@ -23,15 +24,26 @@
 #include "GaussQuadrature.h"
 #include "STLStringHelper.h"
 #include "MeshUtilitiesFuzzy.h"
+#include "OmpExceptionCapture.h"
+#include "ReproducibleSum.h"
 
 #include <ctime>
 #include <cmath>
 #include <cstring>
+#include <cstdio>
 #include <algorithm>
 #include "netcdfcpp.h"
 
 #include "triangle.h"
 
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Number of cells (SCRIP) or nodes (Exodus) read from a mesh file at
+///		a time, bounding the size of temporary buffers in Mesh::Read.
+///	</summary>
+static const int MeshReadChunkSize = 65536;
+
 ///////////////////////////////////////////////////////////////////////////////
 /// Face
 ///////////////////////////////////////////////////////////////////////////////
@@ -71,6 +83,10 @@ void Mesh::Clear() {
 	faces.clear();
 	edgemap.clear();
 	revnodearray.clear();
+	faceneighbors.clear();
+	facestencils.clear();
+	vecFaceOriginalIx.clear();
+	overlapfaceindex.clear();
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -79,6 +95,16 @@ void Mesh::ConstructEdgeMap(bool verbose) {
 
 	// Construct the edge map
 	edgemap.clear();
+
+#if defined(EDGEMAP_USE_UNSORTED_MAP)
+	// Each interior edge is shared by two faces
+	size_t sHalfEdges = 0;
+	for (int i = 0; i < faces.size(); i++) {
+		sHalfEdges += faces[i].edges.size();
+	}
+	edgemap.reserve(sHalfEdges / 2 + 1);
+#endif
+
 	for (int i = 0; i < faces.size(); i++) {
 		const Face & face = faces[i];
 
@@ -104,28 +130,164 @@ void Mesh::ConstructEdgeMap(bool verbose) {
 
 ///////////////////////////////////////////////////////////////////////////////
 
-void Mesh::ConstructReverseNodeArray() {
+void Mesh::ConstructReverseNodeArray(
+	int nThreads
+) {
+	if (nThreads < 1) {
+		_EXCEPTIONT("Thread count must be at least 1");
+	}
+
+	const int nNodes = static_cast<int>(nodes.size());
+	const int nFaces = static_cast<int>(faces.size());
+
+	// Count the distinct faces adjacent to each node
+	std::vector<int> vecOffsets(nNodes + 1, 0);
+
+#pragma omp parallel for num_threads(nThreads)
+	for (int i = 0; i < nFaces; i++) {
+		const Face & face = faces[i];
+		for (int k = 0; k < face.edges.size(); k++) {
+			int ixNode = face.edges[k][0];
+
+			bool fRepeated = false;
+			for (int j = 0; j < k; j++) {
+				if (face.edges[j][0] == ixNode) {
+					fRepeated = true;
+					break;
+				}
+			}
+			if (fRepeated) {
+				continue;
+			}
+
+#pragma omp atomic
+			vecOffsets[ixNode+1]++;
+		}
+	}
 
-	// Initialize the object
-	revnodearray.resize(nodes.size());
-	for (int i = 0; i < revnodearray.size(); i++) {
-		revnodearray[i].clear();
+	for (int i = 0; i < nNodes; i++) {
+		vecOffsets[i+1] += vecOffsets[i];
 	}
 
-	// Build set for each node
-	for (int i = 0; i < faces.size(); i++) {
-		for (int k = 0; k < faces[i].edges.size(); k++) {
-			int ixNode = faces[i].edges[k][0];
-			revnodearray[ixNode].insert(i);
+	// Fill face indices; faces are visited in order when serial
+	std::vector<int> vecFaceIx(vecOffsets[nNodes]);
+	std::vector<int> vecNext(vecOffsets.begin(), vecOffsets.end() - 1);
+
+#pragma omp parallel for num_threads(nThreads)
+	for (int i = 0; i < nFaces; i++) {
+		const Face & face = faces[i];
+		for (int k = 0; k < face.edges.size(); k++) {
+			int ixNode = face.edges[k][0];
+
+			bool fRepeated = false;
+			for (int j = 0; j < k; j++) {
+				if (face.edges[j][0] == ixNode) {
+					fRepeated = true;
+					break;
+				}
+			}
+			if (fRepeated) {
+				continue;
+			}
+
+			int ix;
+#pragma omp atomic capture
+			ix = vecNext[ixNode]++;
+
+			vecFaceIx[ix] = i;
+		}
+	}
+
+	// Restore ascending order within each node after a threaded fill
+	if (nThreads > 1) {
+#pragma omp parallel for schedule(dynamic, 1024) num_threads(nThreads)
+		for (int i = 0; i < nNodes; i++) {
+			std::sort(
+				vecFaceIx.begin() + vecOffsets[i],
+				vecFaceIx.begin() + vecOffsets[i+1]);
+		}
+	}
+
+	revnodearray.Swap(vecOffsets, vecFaceIx);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void Mesh::ConstructFaceNeighbors(
+	int nThreads
+) {
+	FaceNeighborTable table;
+	ConstructFaceNeighbors(table, nThreads);
+	faceneighbors.swap(table);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void Mesh::ConstructFaceNeighbors(
+	FaceNeighborTable & table,
+	int nThreads
+) const {
+	if (nThreads < 1) {
+		_EXCEPTIONT("Thread count must be at least 1");
+	}
+	if ((edgemap.size() == 0) && (faces.size() != 0)) {
+		_EXCEPTIONT("EdgeMap is required");
+	}
+
+	const int nFaces = static_cast<int>(faces.size());
+
+	int nWidth = 0;
+	for (int i = 0; i < nFaces; i++) {
+		if (faces[i].edges.size() > nWidth) {
+			nWidth = static_cast<int>(faces[i].edges.size());
+		}
+	}
+
+	std::vector<int> vecFaceIx(
+		static_cast<size_t>(nFaces) * nWidth, InvalidFace);
+
+	// Errors are recorded as markers and reported by GetNeighbor()
+#pragma omp parallel for num_threads(nThreads) schedule(static)
+	for (int i = 0; i < nFaces; i++) {
+		const Face & face = faces[i];
+		int * piFace = &(vecFaceIx[static_cast<size_t>(i) * nWidth]);
+
+		for (int k = 0; k < face.edges.size(); k++) {
+			if (face.edges[k][0] == face.edges[k][1]) {
+				continue;
+			}
+
+			EdgeMapConstIterator iter = edgemap.find(face.edges[k]);
+			if (iter == edgemap.end()) {
+				piFace[k] = FaceNeighborMissingEdge;
+				continue;
+			}
+
+			const FacePair & facepair = iter->second;
+
+			if (facepair[0] == i) {
+				piFace[k] = facepair[1];
+			} else if (facepair[1] == i) {
+				piFace[k] = facepair[0];
+			} else {
+				piFace[k] = FaceNeighborEdgeMapError;
+			}
 		}
 	}
+
+	table.Swap(nWidth, vecFaceIx);
 }
 
 ///////////////////////////////////////////////////////////////////////////////
 
 Real Mesh::CalculateFaceAreas(
-	bool fContainsConcaveFaces
+	bool fContainsConcaveFaces,
+	int nThreads
 ) {
+	if (nThreads < 1) {
+		_EXCEPTIONT("Thread count must be at least 1");
+	}
+
 	int nCount = 0;
 	vecFaceArea.Allocate(faces.size());
 
@@ -145,8 +307,10 @@ Real Mesh::CalculateFaceAreas(
 
 	} else {
 
+		CalculateFaceAreasQuadratureMethod(
+			faces, nodes, vecFaceArea, nThreads);
+
 		for (int i = 0; i < faces.size(); i++) {
-			vecFaceArea[i] = CalculateFaceArea(faces[i], nodes);
 			if (vecFaceArea[i] < 1.0e-13) {
 				nCount++;
 			}
@@ -157,31 +321,21 @@ Real Mesh::CalculateFaceAreas(
 		}
 	}
 
-	// Calculate accumulated area carefully
-	static const int Jump = 10;
-	std::vector<double> vecFaceAreaBak;
-	vecFaceAreaBak.resize(vecFaceArea.GetRows());
-	memcpy(&(vecFaceAreaBak[0]), &(vecFaceArea[0]),
-		vecFaceArea.GetRows() * sizeof(double));
-
-	for (;;) {
-		if (vecFaceAreaBak.size() == 1) {
-			break;
-		}
-		for (int i = 0; i <= (vecFaceAreaBak.size()-1) / Jump; i++) {
-			int ixRef = Jump * i;
-			vecFaceAreaBak[i] = vecFaceAreaBak[ixRef];
-			for (int j = 1; j < Jump; j++) {
-				if (ixRef + j >= vecFaceAreaBak.size()) {
-					break;
-				}
-				vecFaceAreaBak[i] += vecFaceAreaBak[ixRef + j];
-			}
-		}
-		vecFaceAreaBak.resize((vecFaceAreaBak.size()-1) / Jump + 1);
+	return SumFaceAreas(nThreads);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+Real Mesh::SumFaceAreas(
+	int nThreads
+) const {
+	if (vecFaceArea.GetRows() == 0) {
+		return 0.0;
 	}
 
-	return vecFaceAreaBak[0];
+	// Calculate accumulated area carefully
+	return ReproducibleSum(
+		&(vecFaceArea[0]), vecFaceArea.GetRows(), nThreads);
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -197,8 +351,6 @@ Real Mesh::CalculateFaceAreasFromOverlap(
 	vecFaceArea.Allocate(faces.size());
 
 	// Loop over all Faces in meshOverlap
-	double dTotalArea = 0.0;
-
 	for (int i = 0; i < meshOverlap.faces.size(); i++) {
 		int ixFirstFace = meshOverlap.vecSourceFaceIx[i];
 
@@ -208,9 +360,8 @@ Real Mesh::CalculateFaceAreasFromOverlap(
 		}
 
 		vecFaceArea[ixFirstFace] += meshOverlap.vecFaceArea[i];
-		dTotalArea += meshOverlap.vecFaceArea[i];
 	}
-	return dTotalArea;
+	return meshOverlap.SumFaceAreas();
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -248,32 +399,111 @@ void Mesh::ExchangeFirstAndSecondMesh() {
 		vecSourceFaceIx.push_back(iterReorder->first);
 		vecTargetFaceIx.push_back(vecSourceFaceIxOld[iterReorder->second]);
 	}
+
+	// Reorder Face areas
+	if (vecFaceArea.GetRows() == facesOld.size()) {
+		DataArray1D<double> vecFaceAreaOld = vecFaceArea;
+
+		int ix = 0;
+		iterReorder = multimapReorder.begin();
+		for (; iterReorder != multimapReorder.end(); iterReorder++) {
+			vecFaceArea[ix] = vecFaceAreaOld[iterReorder->second];
+			ix++;
+		}
+	}
+
+	overlapfaceindex.clear();
 }
 
 ///////////////////////////////////////////////////////////////////////////////
 
-void Mesh::RemoveCoincidentNodes() {
+///	<summary>
+///		Predicate selecting nodes that have been tagged as unique.
+///	</summary>
+class UniqueNodePredicate {
+public:
+	UniqueNodePredicate(
+		const std::vector<bool> & vecUnique
+	) :
+		m_vecUnique(vecUnique)
+	{ }
+
+	bool operator()(size_t ix) const {
+		return m_vecUnique[ix];
+	}
 
-	// Put nodes into a map, tagging uniques
-	std::map<Node, int> mapNodes;
+private:
+	const std::vector<bool> & m_vecUnique;
+};
 
-	std::vector<int> vecNodeIndex;
-	std::vector<int> vecUniques;
+///////////////////////////////////////////////////////////////////////////////
 
-	vecNodeIndex.reserve(nodes.size());
-	vecUniques.reserve(nodes.size());
+///	<summary>
+///		Find the groups of coincident nodes in a NodeVector.  On return
+///		vecNodeIndex holds the index of the group of each node, and
+///		vecUniques the first member of each group, in order.
+///	</summary>
+static void FindCoincidentNodes(
+	const NodeVector & nodes,
+	std::vector<int> & vecNodeIndex,
+	std::vector<int> & vecUniques,
+	int nThreads
+) {
+	const int nNodes = static_cast<int>(nodes.size());
 
-	for (int i = 0; i < nodes.size(); i++) {
-		std::map<Node, int>::const_iterator iter = mapNodes.find(nodes[i]);
+	node_bins_3d<Node> binsNodes(
+		nodes, ReferenceTolerance, MESH_NODE_HASH_CELL_WIDTH, nThreads);
+
+	// First earlier node coincident with each node
+	std::vector<int> vecFirstCoincident(nNodes);
+
+#pragma omp parallel for schedule(dynamic, 4096) num_threads(nThreads)
+	for (int i = 0; i < nNodes; i++) {
+		vecFirstCoincident[i] =
+			static_cast<int>(binsNodes.find_first(nodes[i], i));
+	}
+
+	// Tag uniques in order, so that each node is replaced by the first
+	// unique node it is coincident with.  Only when that is not the first
+	// coincident node (coincidence within tolerance is not transitive)
+	// are the earlier nodes searched again.
+	vecNodeIndex.resize(nNodes);
+	vecUniques.clear();
+	vecUniques.reserve(nNodes);
+
+	std::vector<bool> vecUnique(nNodes, false);
+
+	for (int i = 0; i < nNodes; i++) {
+		int ixFirst = vecFirstCoincident[i];
 
-		if (iter != mapNodes.end()) {
-			vecNodeIndex[i] = vecNodeIndex[iter->second];
+		if ((ixFirst != nNodes) && (!vecUnique[ixFirst])) {
+			ixFirst = static_cast<int>(
+				binsNodes.find_first_if(nodes[i], i, UniqueNodePredicate(vecUnique)));
+		}
+
+		if (ixFirst != nNodes) {
+			vecNodeIndex[i] = vecNodeIndex[ixFirst];
 		} else {
-			mapNodes.insert(std::pair<Node, int>(nodes[i], i));
+			vecUnique[i] = true;
 			vecNodeIndex[i] = vecUniques.size();
 			vecUniques.push_back(i);
 		}
 	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void Mesh::RemoveCoincidentNodes(
+	int nThreads
+) {
+	if (nThreads < 1) {
+		_EXCEPTIONT("Thread count must be at least 1");
+	}
+
+	std::vector<int> vecNodeIndex;
+	std::vector<int> vecUniques;
+
+	FindCoincidentNodes(nodes, vecNodeIndex, vecUniques, nThreads);
 
 	if (vecUniques.size() == nodes.size()) {
 		return;
@@ -290,7 +520,10 @@ void Mesh::RemoveCoincidentNodes() {
 	}
 
 	// Adjust node indices in Faces
-	for (int i = 0; i < faces.size(); i++) {
+	const int nFaces = static_cast<int>(faces.size());
+
+#pragma omp parallel for num_threads(nThreads)
+	for (int i = 0; i < nFaces; i++) {
 	for (int j = 0; j < faces[i].edges.size(); j++) {
 		faces[i].edges[j].node[0] =
 			vecNodeIndex[faces[i].edges[j].node[0]];
@@ -302,153 +535,633 @@ void Mesh::RemoveCoincidentNodes() {
 
 ///////////////////////////////////////////////////////////////////////////////
 
-void Mesh::Write(
-	const std::string & strFile,
-	NcFile::FileFormat eFileFormat
-) const {
-	const int ParamFour = 4;
-	const int ParamLenString = 33;
-
-	// Temporarily change error reporting
-	NcError error_temp(NcError::verbose_fatal);
-
-	// Determine block sizes
-	std::vector<int> vecBlockSizes;
-	std::vector<int> vecBlockSizeFaces;
-	{
-		std::map<int, int> mapBlockSizes;
-		std::map<int, int>::iterator iterBlockSize;
-		int iBlock;
-		char szBuffer[ParamLenString];
-
-		for (int i = 0; i < faces.size(); i++) {
-			iterBlockSize = mapBlockSizes.find(faces[i].edges.size());
-
-			if (iterBlockSize == mapBlockSizes.end()) {
-				mapBlockSizes.insert(
-					std::pair<int,int>(faces[i].edges.size(), 1));
-			} else {
-				(iterBlockSize->second)++;
-			}
+///	<summary>
+///		Number of cells along each edge of a cube panel at which Face
+///		centroids are quantized for ReorderFaces.
+///	</summary>
+static const unsigned int MeshFaceCurveCells = (1 << 16);
+
+///	<summary>
+///		Calculate the position of a point along a space-filling curve on the
+///		sphere.  The point is projected gnomonically onto the face of the
+///		circumscribed cube, and the curve index on that panel is appended to
+///		the panel index.
+///	</summary>
+static unsigned long long CalculateFaceCurveKey(
+	const Node & node,
+	MeshFaceOrdering eOrdering
+) {
+	const double dAX = fabs(node.x);
+	const double dAY = fabs(node.y);
+	const double dAZ = fabs(node.z);
+
+	// Project onto the cube panel with the largest coordinate
+	unsigned long long iPanel = 0;
+	double dA = 0.0;
+	double dB = 0.0;
+
+	if ((dAX >= dAY) && (dAX >= dAZ)) {
+		if (dAX != 0.0) {
+			iPanel = (node.x > 0.0)?(0):(2);
+			dA = node.y / dAX;
+			dB = node.z / dAX;
 		}
+	} else if (dAY >= dAZ) {
+		iPanel = (node.y > 0.0)?(1):(3);
+		dA = node.x / dAY;
+		dB = node.z / dAY;
+	} else {
+		iPanel = (node.z > 0.0)?(4):(5);
+		dA = node.x / dAZ;
+		dB = node.y / dAZ;
+	}
 
-		vecBlockSizes.resize(mapBlockSizes.size());
-		vecBlockSizeFaces.resize(mapBlockSizes.size());
-
-		AnnounceStartBlock("Nodes per element");
-		iterBlockSize = mapBlockSizes.begin();
-		iBlock = 1;
-		for (; iterBlockSize != mapBlockSizes.end(); iterBlockSize++) {
-			vecBlockSizes[iBlock-1] = iterBlockSize->first;
-			vecBlockSizeFaces[iBlock-1] = iterBlockSize->second;
+	// Quantize panel coordinates
+	const unsigned int nCells = MeshFaceCurveCells;
 
-			Announce("Block %i (%i nodes): %i",
-				iBlock, vecBlockSizes[iBlock-1], vecBlockSizeFaces[iBlock-1]);
+	unsigned int iA =
+		static_cast<unsigned int>(0.5 * (dA + 1.0) * static_cast<double>(nCells));
+	unsigned int iB =
+		static_cast<unsigned int>(0.5 * (dB + 1.0) * static_cast<double>(nCells));
 
-			iBlock++;
-		}
-		AnnounceEndBlock(NULL);
+	if (iA >= nCells) {
+		iA = nCells - 1;
 	}
-
-	// Output to a NetCDF Exodus file
-	NcFile ncOut(strFile.c_str(), NcFile::Replace, NULL, 0, eFileFormat);
-	if (!ncOut.is_valid()) {
-		_EXCEPTION1("Unable to open grid file \"%s\" for writing",
-			strFile.c_str());
+	if (iB >= nCells) {
+		iB = nCells - 1;
 	}
 
-	// Auxiliary Exodus dimensions
-	NcDim * dimLenString = ncOut.add_dim("len_string", ParamLenString);
-	NcDim * dimLenLine = ncOut.add_dim("len_line", 81);
-	NcDim * dimFour = ncOut.add_dim("four", ParamFour);
-	NcDim * dimTime = ncOut.add_dim("time_step");
-	NcDim * dimDimension = ncOut.add_dim("num_dim", 3);
-
-	// Number of nodes
-	int nNodeCount = nodes.size();
-	NcDim * dimNodes = ncOut.add_dim("num_nodes", nNodeCount);
+	// Index along the curve
+	unsigned long long iCurve = 0;
 
-	// Number of elements
-	int nElementCount = faces.size();
-	NcDim * dimElements = ncOut.add_dim("num_elem", nElementCount);
+	if (eOrdering == MeshFaceOrdering_Morton) {
+		for (unsigned int b = 0; (1u << b) < nCells; b++) {
+			iCurve |= static_cast<unsigned long long>((iA >> b) & 1u) << (2 * b);
+			iCurve |= static_cast<unsigned long long>((iB >> b) & 1u) << (2 * b + 1);
+		}
 
-	// Other dimensions
-	NcDim * dimNumQARec = ncOut.add_dim("num_qa_rec", 1);
+	} else {
+		for (unsigned int s = nCells / 2; s > 0; s /= 2) {
+			const unsigned int rx = ((iA & s) > 0)?(1):(0);
+			const unsigned int ry = ((iB & s) > 0)?(1):(0);
+
+			iCurve += static_cast<unsigned long long>(s)
+				* static_cast<unsigned long long>(s)
+				* static_cast<unsigned long long>((3 * rx) ^ ry);
+
+			// Rotate the quadrant
+			if (ry == 0) {
+				if (rx == 1) {
+					iA = nCells - 1 - iA;
+					iB = nCells - 1 - iB;
+				}
+				std::swap(iA, iB);
+			}
+		}
+	}
 
-	// Global attributes
-	ncOut.add_att("api_version", 5.00f);
-	ncOut.add_att("version", 5.00f);
-	ncOut.add_att("floating_point_word_size", 8);
-	ncOut.add_att("file_size", 0);
+	return ((iPanel << 32) | iCurve);
+}
 
-	// Current time
-	{
-		time_t t = time(0);
-		struct tm * timestruct = localtime(&t);
+///////////////////////////////////////////////////////////////////////////////
 
-		char szDate[ParamLenString];
-		char szTime[ParamLenString];
+void Mesh::ReorderFaces(
+	MeshFaceOrdering eOrdering
+) {
+	if (vecSourceFaceIx.size() != 0) {
+		_EXCEPTIONT("Overlap meshes cannot be reordered");
+	}
 
-		strftime(szDate, sizeof(szDate), "%m/%d/%Y", timestruct);
-		strftime(szTime, sizeof(szTime), "%X", timestruct);
+	const int nFaces = faces.size();
 
-		char szTitle[128];
-		sprintf(szTitle, "tempest(%s) %s: %s", strFile.c_str(), szDate, szTime);
-		ncOut.add_att("title", szTitle);
+	// Position of each Face centroid along the curve
+	std::vector< std::pair<unsigned long long, int> > vecFaceKeys;
+	vecFaceKeys.resize(nFaces);
 
-		// Time_whole (unused)
-		NcVar * varTimeWhole = ncOut.add_var("time_whole", ncDouble, dimTime);
-		if (varTimeWhole == NULL) {
-			_EXCEPTIONT("Error creating variable \"time_whole\"");
+	for (int i = 0; i < nFaces; i++) {
+		Node nodeCentroid(0.0, 0.0, 0.0);
+		for (int j = 0; j < faces[i].edges.size(); j++) {
+			const Node & node = nodes[faces[i][j]];
+			nodeCentroid.x += node.x;
+			nodeCentroid.y += node.y;
+			nodeCentroid.z += node.z;
 		}
 
-		// QA records
-		char szQARecord[ParamFour][ParamLenString]
-			= {"Tempest", "14.0", "", ""};
+		vecFaceKeys[i].first = CalculateFaceCurveKey(nodeCentroid, eOrdering);
+		vecFaceKeys[i].second = i;
+	}
 
-		strcpy(szQARecord[2], szDate);
-		strcpy(szQARecord[3], szTime);
+	// Ties are broken by the current index
+	std::sort(vecFaceKeys.begin(), vecFaceKeys.end());
 
-		NcVar * varQARecords =
-			ncOut.add_var("qa_records", ncChar,
-				dimNumQARec, dimFour, dimLenString);
+	// Reorder Faces
+	FaceVector facesOld = faces;
+	for (int i = 0; i < nFaces; i++) {
+		faces[i] = facesOld[vecFaceKeys[i].second];
+	}
 
-		if (varQARecords == NULL) {
-			_EXCEPTIONT("Error creating variable \"qa_records\"");
+	if (vecFaceArea.GetRows() == nFaces) {
+		DataArray1D<double> vecFaceAreaOld = vecFaceArea;
+		for (int i = 0; i < nFaces; i++) {
+			vecFaceArea[i] = vecFaceAreaOld[vecFaceKeys[i].second];
 		}
-
-		varQARecords->set_cur(0, 0, 0);
-		varQARecords->put(&(szQARecord[0][0]), 1, 4, ParamLenString);
 	}
 
-	// Coordinate names
-	{
-		char szCoordNames[3][ParamLenString] = {"x", "y", "z"};
-
-		NcVar * varCoordNames =
-			ncOut.add_var("coor_names", ncChar, dimDimension, dimLenString);
-
-		if (varCoordNames == NULL) {
-			_EXCEPTIONT("Error creating variable \"coor_names\"");
+	if (vecMask.GetRows() == nFaces) {
+		DataArray1D<int> vecMaskOld = vecMask;
+		for (int i = 0; i < nFaces; i++) {
+			vecMask[i] = vecMaskOld[vecFaceKeys[i].second];
 		}
-
-		varCoordNames->set_cur(0, 0, 0);
-		varCoordNames->put(&(szCoordNames[0][0]), 3, ParamLenString);
 	}
 
-	// Element blocks
-	NcDim * dimNumElementBlocks =
-		ncOut.add_dim("num_el_blk", vecBlockSizes.size());
+	if (vecMultiFaceMap.size() == nFaces) {
+		std::vector<int> vecMultiFaceMapOld = vecMultiFaceMap;
+		for (int i = 0; i < nFaces; i++) {
+			vecMultiFaceMap[i] = vecMultiFaceMapOld[vecFaceKeys[i].second];
+		}
+	}
 
-	if (dimNumElementBlocks == NULL) {
-		_EXCEPTIONT("Error creating dimension \"num_el_blk\"");
+	// Compose with any previous reordering
+	std::vector<int> vecFaceOriginalIxOld = vecFaceOriginalIx;
+	vecFaceOriginalIx.resize(nFaces);
+	for (int i = 0; i < nFaces; i++) {
+		if (vecFaceOriginalIxOld.size() == nFaces) {
+			vecFaceOriginalIx[i] = vecFaceOriginalIxOld[vecFaceKeys[i].second];
+		} else {
+			vecFaceOriginalIx[i] = vecFaceKeys[i].second;
+		}
 	}
 
-	std::vector<NcDim *> vecElementBlockDim;
-	std::vector<NcDim *> vecNodesPerElementDim;
-	std::vector<NcDim *> vecAttBlockDim;
+	// Renumber Nodes in order of first use, followed by unused Nodes
+	std::vector<int> vecNodeIndex;
+	vecNodeIndex.resize(nodes.size(), (-1));
 
-	vecElementBlockDim.resize(vecBlockSizes.size());
+	int nNextNode = 0;
+	for (int i = 0; i < nFaces; i++) {
+	for (int j = 0; j < faces[i].edges.size(); j++) {
+		const int ixNode = faces[i][j];
+		if (vecNodeIndex[ixNode] == (-1)) {
+			vecNodeIndex[ixNode] = nNextNode;
+			nNextNode++;
+		}
+	}
+	}
+	for (int i = 0; i < nodes.size(); i++) {
+		if (vecNodeIndex[i] == (-1)) {
+			vecNodeIndex[i] = nNextNode;
+			nNextNode++;
+		}
+	}
+
+	NodeVector nodesOld = nodes;
+	for (int i = 0; i < nodes.size(); i++) {
+		nodes[vecNodeIndex[i]] = nodesOld[i];
+	}
+
+	// Adjust node indices in Faces
+	for (int i = 0; i < faces.size(); i++) {
+	for (int j = 0; j < faces[i].edges.size(); j++) {
+		faces[i].edges[j].node[0] =
+			vecNodeIndex[faces[i].edges[j].node[0]];
+		faces[i].edges[j].node[1] =
+			vecNodeIndex[faces[i].edges[j].node[1]];
+	}
+	}
+
+	// Rebuild derived structures
+	if (edgemap.size() != 0) {
+		ConstructEdgeMap(false);
+	}
+	if (revnodearray.size() != 0) {
+		ConstructReverseNodeArray();
+	}
+	if (faceneighbors.size() != 0) {
+		ConstructFaceNeighbors();
+	}
+	facestencils.clear();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void Mesh::RenumberOverlapFaces(
+	const std::vector<int> & vecFirstOriginalIx,
+	const std::vector<int> & vecSecondOriginalIx
+) {
+	// Verify all vectors are the same size
+	if ((faces.size() != vecSourceFaceIx.size()) ||
+		(faces.size() != vecTargetFaceIx.size())
+	) {
+		_EXCEPTIONT("Overlap mesh face index vectors have incorrect size");
+	}
+
+	// Invert the reorderings
+	std::vector<int> vecFirstNewIx(vecFirstOriginalIx.size());
+	for (int i = 0; i < vecFirstOriginalIx.size(); i++) {
+		vecFirstNewIx[vecFirstOriginalIx[i]] = i;
+	}
+
+	std::vector<int> vecSecondNewIx(vecSecondOriginalIx.size());
+	for (int i = 0; i < vecSecondOriginalIx.size(); i++) {
+		vecSecondNewIx[vecSecondOriginalIx[i]] = i;
+	}
+
+	// Reorder vectors
+	FaceVector facesOld = faces;
+
+	std::vector<int> vecTargetFaceIxOld = vecTargetFaceIx;
+
+	// Reordering map
+	std::multimap<int,int> multimapReorder;
+	for (int i = 0; i < vecSourceFaceIx.size(); i++) {
+		int ixFirst = vecSourceFaceIx[i];
+		if (vecFirstNewIx.size() != 0) {
+			if ((ixFirst < 0) || (ixFirst >= vecFirstNewIx.size())) {
+				_EXCEPTION1("Overlap mesh first face index (%i) out of range",
+					ixFirst);
+			}
+			ixFirst = vecFirstNewIx[ixFirst];
+		}
+		multimapReorder.insert(std::pair<int,int>(ixFirst, i));
+	}
+
+	// Apply reordering
+	faces.clear();
+	vecSourceFaceIx.clear();
+	vecTargetFaceIx.clear();
+
+	std::multimap<int,int>::const_iterator iterReorder
+		= multimapReorder.begin();
+
+	for (; iterReorder != multimapReorder.end(); iterReorder++) {
+		int ixSecond = vecTargetFaceIxOld[iterReorder->second];
+		if ((vecSecondNewIx.size() != 0) && (ixSecond >= 0)) {
+			if (ixSecond >= vecSecondNewIx.size()) {
+				_EXCEPTION1("Overlap mesh second face index (%i) out of range",
+					ixSecond);
+			}
+			ixSecond = vecSecondNewIx[ixSecond];
+		}
+
+		faces.push_back(facesOld[iterReorder->second]);
+		vecSourceFaceIx.push_back(iterReorder->first);
+		vecTargetFaceIx.push_back(ixSecond);
+	}
+
+	if (vecFaceArea.GetRows() == facesOld.size()) {
+		DataArray1D<double> vecFaceAreaOld = vecFaceArea;
+		int ix = 0;
+		iterReorder = multimapReorder.begin();
+		for (; iterReorder != multimapReorder.end(); iterReorder++) {
+			vecFaceArea[ix] = vecFaceAreaOld[iterReorder->second];
+			ix++;
+		}
+	}
+
+	// Rebuild derived structures
+	if (edgemap.size() != 0) {
+		ConstructEdgeMap(false);
+	}
+	if (revnodearray.size() != 0) {
+		ConstructReverseNodeArray();
+	}
+	if (faceneighbors.size() != 0) {
+		ConstructFaceNeighbors();
+	}
+	facestencils.clear();
+	overlapfaceindex.clear();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void OverlapFaceIndex::Construct(
+	const std::vector<int> & vecSourceFaceIx,
+	const std::vector<int> & vecTargetFaceIx,
+	int nSourceFaces,
+	int nTargetFaces
+) {
+	const int nOverlapFaces = static_cast<int>(vecSourceFaceIx.size());
+
+	if (vecTargetFaceIx.size() != nOverlapFaces) {
+		_EXCEPTIONT("Overlap mesh face index vectors have incorrect size");
+	}
+
+	clear();
+
+	// Overlap faces of each source face are contiguous
+	m_vecSourceOffsets.resize(nSourceFaces + 1, 0);
+
+	int ixFirstPrev = 0;
+	for (int i = 0; i < nOverlapFaces; i++) {
+		const int ixFirst = vecSourceFaceIx[i];
+
+		if ((ixFirst < 0) || (ixFirst >= nSourceFaces)) {
+			clear();
+			_EXCEPTION1("Overlap mesh first face index (%i) out of range",
+				ixFirst);
+		}
+		if (ixFirst < ixFirstPrev) {
+			clear();
+			_EXCEPTIONT("Overlap mesh faces are not sorted by first mesh face");
+		}
+		ixFirstPrev = ixFirst;
+
+		m_vecSourceOffsets[ixFirst+1]++;
+	}
+
+	for (int ixFirst = 0; ixFirst < nSourceFaces; ixFirst++) {
+		m_vecSourceOffsets[ixFirst+1] += m_vecSourceOffsets[ixFirst];
+	}
+
+	// Counting sort of overlap faces by target face
+	m_vecTargetOffsets.resize(nTargetFaces + 1, 0);
+
+	for (int i = 0; i < nOverlapFaces; i++) {
+		const int ixSecond = vecTargetFaceIx[i];
+
+		if (ixSecond < 0) {
+			continue;
+		}
+		if (ixSecond >= nTargetFaces) {
+			clear();
+			_EXCEPTION1("Overlap mesh second face index (%i) out of range",
+				ixSecond);
+		}
+
+		m_vecTargetOffsets[ixSecond+1]++;
+	}
+
+	for (int ixSecond = 0; ixSecond < nTargetFaces; ixSecond++) {
+		m_vecTargetOffsets[ixSecond+1] += m_vecTargetOffsets[ixSecond];
+	}
+
+	m_vecTargetFaceIx.resize(m_vecTargetOffsets[nTargetFaces]);
+
+	std::vector<int> vecNext(
+		m_vecTargetOffsets.begin(), m_vecTargetOffsets.end() - 1);
+
+	for (int i = 0; i < nOverlapFaces; i++) {
+		const int ixSecond = vecTargetFaceIx[i];
+
+		if (ixSecond >= 0) {
+			m_vecTargetFaceIx[vecNext[ixSecond]++] = i;
+		}
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void Mesh::ConstructOverlapFaceIndex(
+	int nFirstFaces,
+	int nSecondFaces
+) {
+	if ((faces.size() != vecSourceFaceIx.size()) ||
+		(faces.size() != vecTargetFaceIx.size())
+	) {
+		_EXCEPTIONT("Overlap mesh face index vectors have incorrect size");
+	}
+
+	// Sort overlap faces by first mesh face if needed
+	for (int i = 1; i < vecSourceFaceIx.size(); i++) {
+		if (vecSourceFaceIx[i] < vecSourceFaceIx[i-1]) {
+			RenumberOverlapFaces(std::vector<int>(), std::vector<int>());
+			break;
+		}
+	}
+
+	overlapfaceindex.Construct(
+		vecSourceFaceIx,
+		vecTargetFaceIx,
+		nFirstFaces,
+		nSecondFaces);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Maximum number of Faces or Nodes converted and written to a mesh
+///		file at a time.
+///	</summary>
+static const int MeshWriteChunkSize = 262144;
+
+///	<summary>
+///		Determine if mesh variables of the given file format are chunked.
+///		Chunking and compression are only available in NetCDF-4 files.
+///	</summary>
+static bool IsChunkedMeshFormat(
+	NcFile::FileFormat eFileFormat
+) {
+	return ((eFileFormat == NcFile::Netcdf4) ||
+	        (eFileFormat == NcFile::Netcdf4Classic));
+}
+
+///	<summary>
+///		Chunk a NetCDF-4 mesh variable along dimension iChunkDim, with
+///		one entry along each preceding dimension and all entries along
+///		each following dimension, and enable the shuffle and deflate
+///		filters if nDeflateLevel is nonzero.
+///	</summary>
+static void DefineMeshVariableStorage(
+	NcFile & ncOut,
+	NcVar * var,
+	int iChunkDim,
+	int nDeflateLevel
+) {
+	const int nDims = var->num_dims();
+
+	std::vector<size_t> vecChunkSizes(nDims);
+	for (int d = 0; d < nDims; d++) {
+		long lSize = var->get_dim(d)->size();
+		if (lSize == 0) {
+			return;
+		}
+		if (d < iChunkDim) {
+			vecChunkSizes[d] = 1;
+		} else if (d == iChunkDim) {
+			vecChunkSizes[d] = static_cast<size_t>(
+				std::min(lSize, static_cast<long>(MeshWriteChunkSize)));
+		} else {
+			vecChunkSizes[d] = static_cast<size_t>(lSize);
+		}
+	}
+
+	int iStatus = nc_def_var_chunking(
+		ncOut.id(), var->id(), NC_CHUNKED, &(vecChunkSizes[0]));
+	if (iStatus != NC_NOERR) {
+		_EXCEPTION2("Unable to chunk variable \"%s\": %s",
+			var->name(), nc_strerror(iStatus));
+	}
+
+	if (nDeflateLevel != 0) {
+		iStatus = nc_def_var_deflate(
+			ncOut.id(), var->id(), 1, 1, nDeflateLevel);
+		if (iStatus != NC_NOERR) {
+			_EXCEPTION2("Unable to compress variable \"%s\": %s",
+				var->name(), nc_strerror(iStatus));
+		}
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void Mesh::Write(
+	const std::string & strFile,
+	NcFile::FileFormat eFileFormat,
+	int nDeflateLevel,
+	int nThreads
+) const {
+	const int ParamFour = 4;
+	const int ParamLenString = 33;
+
+	if ((nDeflateLevel < 0) || (nDeflateLevel > 9)) {
+		_EXCEPTION1("Invalid deflate level (%i)", nDeflateLevel);
+	}
+
+	// Temporarily change error reporting
+	NcError error_temp(NcError::verbose_fatal);
+
+	const bool fChunked = IsChunkedMeshFormat(eFileFormat);
+	if (!fChunked && (nDeflateLevel != 0)) {
+		Announce("WARNING: Deflate requires NetCDF-4 output; "
+			"mesh written without compression");
+	}
+
+	// Determine block sizes
+	std::vector<int> vecBlockSizes;
+	std::vector<int> vecBlockSizeFaces;
+	{
+		std::map<int, int> mapBlockSizes;
+		std::map<int, int>::iterator iterBlockSize;
+		int iBlock;
+		char szBuffer[ParamLenString];
+
+		for (int i = 0; i < faces.size(); i++) {
+			iterBlockSize = mapBlockSizes.find(faces[i].edges.size());
+
+			if (iterBlockSize == mapBlockSizes.end()) {
+				mapBlockSizes.insert(
+					std::pair<int,int>(faces[i].edges.size(), 1));
+			} else {
+				(iterBlockSize->second)++;
+			}
+		}
+
+		vecBlockSizes.resize(mapBlockSizes.size());
+		vecBlockSizeFaces.resize(mapBlockSizes.size());
+
+		AnnounceStartBlock("Nodes per element");
+		iterBlockSize = mapBlockSizes.begin();
+		iBlock = 1;
+		for (; iterBlockSize != mapBlockSizes.end(); iterBlockSize++) {
+			vecBlockSizes[iBlock-1] = iterBlockSize->first;
+			vecBlockSizeFaces[iBlock-1] = iterBlockSize->second;
+
+			Announce("Block %i (%i nodes): %i",
+				iBlock, vecBlockSizes[iBlock-1], vecBlockSizeFaces[iBlock-1]);
+
+			iBlock++;
+		}
+		AnnounceEndBlock(NULL);
+	}
+
+	// Output to a NetCDF Exodus file
+	NcFile ncOut(strFile.c_str(), NcFile::Replace, NULL, 0, eFileFormat);
+	if (!ncOut.is_valid()) {
+		_EXCEPTION1("Unable to open grid file \"%s\" for writing",
+			strFile.c_str());
+	}
+
+	// Auxiliary Exodus dimensions
+	NcDim * dimLenString = ncOut.add_dim("len_string", ParamLenString);
+	NcDim * dimLenLine = ncOut.add_dim("len_line", 81);
+	NcDim * dimFour = ncOut.add_dim("four", ParamFour);
+	NcDim * dimTime = ncOut.add_dim("time_step");
+	NcDim * dimDimension = ncOut.add_dim("num_dim", 3);
+
+	// Number of nodes
+	int nNodeCount = nodes.size();
+	NcDim * dimNodes = ncOut.add_dim("num_nodes", nNodeCount);
+
+	// Number of elements
+	int nElementCount = faces.size();
+	NcDim * dimElements = ncOut.add_dim("num_elem", nElementCount);
+
+	// Other dimensions
+	NcDim * dimNumQARec = ncOut.add_dim("num_qa_rec", 1);
+
+	// Global attributes
+	ncOut.add_att("api_version", 5.00f);
+	ncOut.add_att("version", 5.00f);
+	ncOut.add_att("floating_point_word_size", 8);
+	ncOut.add_att("file_size", 0);
+
+	// Current time
+	{
+		time_t t = time(0);
+		struct tm * timestruct = localtime(&t);
+
+		char szDate[ParamLenString];
+		char szTime[ParamLenString];
+
+		strftime(szDate, sizeof(szDate), "%m/%d/%Y", timestruct);
+		strftime(szTime, sizeof(szTime), "%X", timestruct);
+
+		char szTitle[128];
+		sprintf(szTitle, "tempest(%s) %s: %s", strFile.c_str(), szDate, szTime);
+		ncOut.add_att("title", szTitle);
+
+		// Time_whole (unused)
+		NcVar * varTimeWhole = ncOut.add_var("time_whole", ncDouble, dimTime);
+		if (varTimeWhole == NULL) {
+			_EXCEPTIONT("Error creating variable \"time_whole\"");
+		}
+
+		// QA records
+		char szQARecord[ParamFour][ParamLenString]
+			= {"Tempest", "14.0", "", ""};
+
+		strcpy(szQARecord[2], szDate);
+		strcpy(szQARecord[3], szTime);
+
+		NcVar * varQARecords =
+			ncOut.add_var("qa_records", ncChar,
+				dimNumQARec, dimFour, dimLenString);
+
+		if (varQARecords == NULL) {
+			_EXCEPTIONT("Error creating variable \"qa_records\"");
+		}
+
+		varQARecords->set_cur(0, 0, 0);
+		varQARecords->put(&(szQARecord[0][0]), 1, 4, ParamLenString);
+	}
+
+	// Coordinate names
+	{
+		char szCoordNames[3][ParamLenString] = {"x", "y", "z"};
+
+		NcVar * varCoordNames =
+			ncOut.add_var("coor_names", ncChar, dimDimension, dimLenString);
+
+		if (varCoordNames == NULL) {
+			_EXCEPTIONT("Error creating variable \"coor_names\"");
+		}
+
+		varCoordNames->set_cur(0, 0, 0);
+		varCoordNames->put(&(szCoordNames[0][0]), 3, ParamLenString);
+	}
+
+	// Element blocks
+	NcDim * dimNumElementBlocks =
+		ncOut.add_dim("num_el_blk", vecBlockSizes.size());
+
+	if (dimNumElementBlocks == NULL) {
+		_EXCEPTIONT("Error creating dimension \"num_el_blk\"");
+	}
+
+	std::vector<NcDim *> vecElementBlockDim;
+	std::vector<NcDim *> vecNodesPerElementDim;
+	std::vector<NcDim *> vecAttBlockDim;
+
+	vecElementBlockDim.resize(vecBlockSizes.size());
 	vecNodesPerElementDim.resize(vecBlockSizes.size());
 	vecAttBlockDim.resize(vecBlockSizes.size());
 
@@ -524,13 +1237,10 @@ void Mesh::Write(
 
 	// Attributes
 	{
-		for (int n = 0; n < vecBlockSizes.size(); n++) {
-			std::vector<double> dAttrib;
-			dAttrib.resize(vecBlockSizeFaces[n]);
-			for (int i = 0; i < vecBlockSizeFaces[n]; i++) {
-				dAttrib[i] = 1.0;
-			}
+		std::vector<double> dAttrib(
+			std::min(nElementCount, MeshWriteChunkSize), 1.0);
 
+		for (int n = 0; n < vecBlockSizes.size(); n++) {
 			char szAttribName[ParamLenString];
 			sprintf(szAttribName, "attrib%i", n+1);
 
@@ -544,58 +1254,77 @@ void Mesh::Write(
 				_EXCEPTION1("Error creating variable \"%s\"", szAttribName);
 			}
 
-			varAttrib->set_cur((long)0);
-			varAttrib->put(&(dAttrib[0]), vecBlockSizeFaces[n]);
+			if (fChunked) {
+				DefineMeshVariableStorage(ncOut, varAttrib, 0, nDeflateLevel);
+			}
+
+			for (int i = 0; i < vecBlockSizeFaces[n]; i += MeshWriteChunkSize) {
+				const int nChunk =
+					std::min(MeshWriteChunkSize, vecBlockSizeFaces[n] - i);
+
+				varAttrib->set_cur((long)i);
+				varAttrib->put(&(dAttrib[0]), nChunk);
+			}
 		}
 	}
 
 	// Face-specific variables
 	{
-		// Face nodes (1-indexed)
-		std::vector<NcVar*> vecConnectVar;
-		vecConnectVar.resize(vecBlockSizes.size());
+		const int nBlocks = vecBlockSizes.size();
+
+		const bool fHasParentA = (vecSourceFaceIx.size() != 0);
+		const bool fHasParentB = (vecTargetFaceIx.size() != 0);
+
+		// Overlap meshes also store their Face areas, so that they need
+		// not be recomputed when the overlap mesh is read
+		const bool fHasArea =
+			fHasParentA && fHasParentB &&
+			(vecFaceArea.GetRows() == faces.size());
+
+		// Faces sorted by block, with the Faces of block n stored in
+		// entries [vecBlockBegin[n], vecBlockBegin[n+1]) of vecBlockFaces
+		std::vector<int> vecBlockBegin(nBlocks + 1, 0);
+		for (int n = 0; n < nBlocks; n++) {
+			vecBlockBegin[n+1] = vecBlockBegin[n] + vecBlockSizeFaces[n];
+		}
 
-		std::vector< DataArray2D<int> > vecConnect;
-		vecConnect.resize(vecBlockSizes.size());
+		std::vector<int> vecBlockFaces(nElementCount);
+		{
+			std::vector<int> vecNext(
+				vecBlockBegin.begin(), vecBlockBegin.end() - 1);
 
-		// Number of elements added to each connectivity array
-		std::vector<int> vecConnectCount;
-		vecConnectCount.resize(vecBlockSizes.size());
+			for (int i = 0; i < nElementCount; i++) {
+				const int iBlock =
+					std::lower_bound(
+						vecBlockSizes.begin(),
+						vecBlockSizes.end(),
+						static_cast<int>(faces[i].edges.size()))
+					- vecBlockSizes.begin();
+
+				vecBlockFaces[vecNext[iBlock]++] = i;
+			}
+		}
 
-		// Global ids
-		std::vector<NcVar*> vecGlobalIdVar;
-		vecGlobalIdVar.resize(vecBlockSizes.size());
+		// Face nodes (1-indexed)
+		std::vector<NcVar*> vecConnectVar(nBlocks);
 
-		std::vector< DataArray1D<int> > vecGlobalId;
-		vecGlobalId.resize(vecBlockSizes.size());
+		// Global ids
+		std::vector<NcVar*> vecGlobalIdVar(nBlocks);
 
 		// Edge types
-		std::vector<NcVar*> vecEdgeTypeVar;
-		vecEdgeTypeVar.resize(vecBlockSizes.size());
-
-		std::vector< DataArray2D<int> > vecEdgeType;
-		vecEdgeType.resize(vecBlockSizes.size());
+		std::vector<NcVar*> vecEdgeTypeVar(nBlocks);
 
 		// Parent on source mesh
-		std::vector<NcVar*> vecFaceParentAVar;
-		vecFaceParentAVar.resize(vecBlockSizes.size());
-
-		std::vector< DataArray1D<int> > vecFaceParentA;
-		vecFaceParentA.resize(vecBlockSizes.size());
+		std::vector<NcVar*> vecFaceParentAVar(nBlocks);
 
 		// Parent on target mesh
-		std::vector<NcVar*> vecFaceParentBVar;
-		vecFaceParentBVar.resize(vecBlockSizes.size());
+		std::vector<NcVar*> vecFaceParentBVar(nBlocks);
 
-		std::vector< DataArray1D<int> > vecFaceParentB;
-		vecFaceParentB.resize(vecBlockSizes.size());
+		// Face areas
+		std::vector<NcVar*> vecFaceAreaVar(nBlocks);
 
-		// Initialize block-local storage arrays and create output variables
-		for (int n = 0; n < vecBlockSizes.size(); n++) {
-			vecConnect[n].Allocate(vecBlockSizeFaces[n], vecBlockSizes[n]);
-			vecGlobalId[n].Allocate(vecBlockSizeFaces[n]);
-			vecEdgeType[n].Allocate(vecBlockSizeFaces[n], vecBlockSizes[n]);
-	
+		// Create output variables
+		for (int n = 0; n < nBlocks; n++) {
 			char szConnectVarName[ParamLenString];
 			sprintf(szConnectVarName, "connect%i", n+1);
 			vecConnectVar[n] =
@@ -638,9 +1367,16 @@ void Mesh::Write(
 					szEdgeTypeVarName);
 			}
 
-			if (vecSourceFaceIx.size() != 0) {
-				vecFaceParentA[n].Allocate(vecBlockSizeFaces[n]);
+			if (fChunked) {
+				DefineMeshVariableStorage(
+					ncOut, vecConnectVar[n], 0, nDeflateLevel);
+				DefineMeshVariableStorage(
+					ncOut, vecGlobalIdVar[n], 0, nDeflateLevel);
+				DefineMeshVariableStorage(
+					ncOut, vecEdgeTypeVar[n], 0, nDeflateLevel);
+			}
 
+			if (fHasParentA) {
 				char szParentAVarName[ParamLenString];
 				sprintf(szParentAVarName, "el_parent_a%i", n+1);
 				vecFaceParentAVar[n] =
@@ -652,11 +1388,14 @@ void Mesh::Write(
 					_EXCEPTION1("Error creating variable \"%s\"",
 						szParentAVarName);
 				}
-			}
 
-			if (vecTargetFaceIx.size() != 0) {
-				vecFaceParentB[n].Allocate(vecBlockSizeFaces[n]);
+				if (fChunked) {
+					DefineMeshVariableStorage(
+						ncOut, vecFaceParentAVar[n], 0, nDeflateLevel);
+				}
+			}
 
+			if (fHasParentB) {
 				char szParentBVarName[ParamLenString];
 				sprintf(szParentBVarName, "el_parent_b%i", n+1);
 				vecFaceParentBVar[n] =
@@ -668,72 +1407,120 @@ void Mesh::Write(
 					_EXCEPTION1("Error creating variable \"%s\"",
 						szParentBVarName);
 				}
-			}
-		}
 
-		// Rebuild global data structures in local block arrays
-		for (int i = 0; i < nElementCount; i++) {
-			int iBlock = 0;
-			for (; iBlock < vecBlockSizes.size(); iBlock++) {
-				if (vecBlockSizes[iBlock] == faces[i].edges.size()) {
-					break;
+				if (fChunked) {
+					DefineMeshVariableStorage(
+						ncOut, vecFaceParentBVar[n], 0, nDeflateLevel);
 				}
 			}
-			if (iBlock == vecBlockSizes.size()) {
-				_EXCEPTIONT("Logic error");
-			}
 
-			int iLocal = vecConnectCount[iBlock];
-			for (int k = 0; k < faces[i].edges.size(); k++) {
-				vecConnect[iBlock][iLocal][k] = faces[i][k] + 1;
+			if (fHasArea) {
+				char szAreaVarName[ParamLenString];
+				sprintf(szAreaVarName, "el_area%i", n+1);
+				vecFaceAreaVar[n] =
+					ncOut.add_var(
+						szAreaVarName, ncDouble,
+						vecElementBlockDim[n]);
+
+				if (vecFaceAreaVar[n] == NULL) {
+					_EXCEPTION1("Error creating variable \"%s\"",
+						szAreaVarName);
+				}
 
-				vecEdgeType[iBlock][iLocal][k] =
-					static_cast<int>(faces[i].edges[k].type);
+				if (fChunked) {
+					DefineMeshVariableStorage(
+						ncOut, vecFaceAreaVar[n], 0, nDeflateLevel);
+				}
 			}
+		}
 
-			vecGlobalId[iBlock][iLocal] = i + 1;
+		// Write data to NetCDF file one chunk of each block at a time,
+		// rebuilding the chunk from the global data structures in parallel
+		for (int n = 0; n < nBlocks; n++) {
+			const int nFaceNodes = vecBlockSizes[n];
+			const int nChunkMax =
+				std::min(vecBlockSizeFaces[n], MeshWriteChunkSize);
+
+			std::vector<int> vecConnect(nChunkMax * nFaceNodes);
+			std::vector<int> vecEdgeType(nChunkMax * nFaceNodes);
+			std::vector<int> vecGlobalId(nChunkMax);
+			std::vector<int> vecFaceParentA(fHasParentA ? nChunkMax : 0);
+			std::vector<int> vecFaceParentB(fHasParentB ? nChunkMax : 0);
+			std::vector<double> vecFaceAreaChunk(fHasArea ? nChunkMax : 0);
+
+			for (int iLocalBegin = 0;
+			     iLocalBegin < vecBlockSizeFaces[n];
+			     iLocalBegin += MeshWriteChunkSize
+			) {
+				const int nChunk =
+					std::min(MeshWriteChunkSize,
+						vecBlockSizeFaces[n] - iLocalBegin);
+
+				const int * piFaces =
+					&(vecBlockFaces[vecBlockBegin[n] + iLocalBegin]);
+
+#pragma omp parallel for num_threads(nThreads)
+				for (int j = 0; j < nChunk; j++) {
+					const int i = piFaces[j];
+					const Face & face = faces[i];
+
+					for (int k = 0; k < nFaceNodes; k++) {
+						vecConnect[j * nFaceNodes + k] = face[k] + 1;
+
+						vecEdgeType[j * nFaceNodes + k] =
+							static_cast<int>(face.edges[k].type);
+					}
 
-			if (vecSourceFaceIx.size() != 0) {
-				vecFaceParentA[iBlock][iLocal] = vecSourceFaceIx[i] + 1;
-			}
-			if (vecTargetFaceIx.size() != 0) {
-				vecFaceParentB[iBlock][iLocal] = vecTargetFaceIx[i] + 1;
-			}
+					vecGlobalId[j] = i + 1;
 
-			vecConnectCount[iBlock]++;
-		}
+					if (fHasParentA) {
+						vecFaceParentA[j] = vecSourceFaceIx[i] + 1;
+					}
+					if (fHasParentB) {
+						vecFaceParentB[j] = vecTargetFaceIx[i] + 1;
+					}
+					if (fHasArea) {
+						vecFaceAreaChunk[j] = vecFaceArea[i];
+					}
+				}
 
-		// Write data to NetCDF file
-		for (int n = 0; n < vecBlockSizes.size(); n++) {
-			vecConnectVar[n]->set_cur(0, 0);
-			vecConnectVar[n]->put(
-				&(vecConnect[n][0][0]),
-				vecBlockSizeFaces[n],
-				vecBlockSizes[n]);
-
-			vecGlobalIdVar[n]->set_cur((long)0);
-			vecGlobalIdVar[n]->put(
-				&(vecGlobalId[n][0]),
-				vecBlockSizeFaces[n]);
-
-			vecEdgeTypeVar[n]->set_cur(0, 0);
-			vecEdgeTypeVar[n]->put(
-				&(vecEdgeType[n][0][0]),
-				vecBlockSizeFaces[n],
-				vecBlockSizes[n]);
+				vecConnectVar[n]->set_cur((long)iLocalBegin, 0);
+				vecConnectVar[n]->put(
+					&(vecConnect[0]),
+					nChunk,
+					nFaceNodes);
+
+				vecGlobalIdVar[n]->set_cur((long)iLocalBegin);
+				vecGlobalIdVar[n]->put(
+					&(vecGlobalId[0]),
+					nChunk);
+
+				vecEdgeTypeVar[n]->set_cur((long)iLocalBegin, 0);
+				vecEdgeTypeVar[n]->put(
+					&(vecEdgeType[0]),
+					nChunk,
+					nFaceNodes);
+
+				if (fHasParentA) {
+					vecFaceParentAVar[n]->set_cur((long)iLocalBegin);
+					vecFaceParentAVar[n]->put(
+						&(vecFaceParentA[0]),
+						nChunk);
+				}
 
-			if (vecSourceFaceIx.size() != 0) {
-				vecFaceParentAVar[n]->set_cur((long)0);
-				vecFaceParentAVar[n]->put(
-					&(vecFaceParentA[n][0]),
-					vecBlockSizeFaces[n]);
-			}
+				if (fHasParentB) {
+					vecFaceParentBVar[n]->set_cur((long)iLocalBegin);
+					vecFaceParentBVar[n]->put(
+						&(vecFaceParentB[0]),
+						nChunk);
+				}
 
-			if (vecTargetFaceIx.size() != 0) {
-				vecFaceParentBVar[n]->set_cur((long)0);
-				vecFaceParentBVar[n]->put(
-					&(vecFaceParentB[n][0]),
-					vecBlockSizeFaces[n]);
+				if (fHasArea) {
+					vecFaceAreaVar[n]->set_cur((long)iLocalBegin);
+					vecFaceAreaVar[n]->put(
+						&(vecFaceAreaChunk[0]),
+						nChunk);
+				}
 			}
 		}
 	}
@@ -747,23 +1534,94 @@ void Mesh::Write(
 			_EXCEPTIONT("Error creating variable \"coord\"");
 		}
 
-		DataArray1D<double> dCoord(nNodeCount);
+		if (fChunked) {
+			DefineMeshVariableStorage(ncOut, varNodes, 1, nDeflateLevel);
+		}
 
-		for (int i = 0; i < nNodeCount; i++) {
-			dCoord[i] = static_cast<double>(nodes[i].x);
+		DataArray1D<double> dCoord(std::min(nNodeCount, MeshWriteChunkSize));
+
+		for (int d = 0; d < 3; d++) {
+			for (int iBegin = 0; iBegin < nNodeCount; iBegin += MeshWriteChunkSize) {
+				const int nChunk =
+					std::min(MeshWriteChunkSize, nNodeCount - iBegin);
+
+#pragma omp parallel for num_threads(nThreads)
+				for (int j = 0; j < nChunk; j++) {
+					const Node & node = nodes[iBegin + j];
+					if (d == 0) {
+						dCoord[j] = static_cast<double>(node.x);
+					} else if (d == 1) {
+						dCoord[j] = static_cast<double>(node.y);
+					} else {
+						dCoord[j] = static_cast<double>(node.z);
+					}
+				}
+
+				varNodes->set_cur((long)d, (long)iBegin);
+				varNodes->put(dCoord, 1, nChunk);
+			}
 		}
-		varNodes->set_cur(0, 0);
-		varNodes->put(dCoord, 1, nNodeCount);
-		for (int i = 0; i < nNodeCount; i++) {
-			dCoord[i] = static_cast<double>(nodes[i].y);
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Calculate the SCRIP center and corner coordinates (in degrees) of
+///		a Face.  Corner longitudes are shifted by 360 degrees to lie
+///		within 180 degrees of the center, corners at the poles take the
+///		longitude of the center, and unused corners up to nCornersMax are
+///		set to zero.
+///	</summary>
+static void CalculateScripFaceCoordinates(
+	const Face & face,
+	const NodeVector & nodes,
+	int nCornersMax,
+	double & dCenterLon,
+	double & dCenterLat,
+	double * dCornerLon,
+	double * dCornerLat
+) {
+	Node center(0,0,0);
+	int nCorners = face.edges.size();
+	for (int j=0; j<nCorners; ++j) {
+		const Node & corner = nodes[ face[j] ];
+		XYZtoRLL_Deg(
+			corner.x, corner.y, corner.z,
+			dCornerLon[j],
+			dCornerLat[j]);
+		center = center + corner;
+	}
+	for (int j=nCorners; j<nCornersMax; ++j) {
+		dCornerLon[j] = 0.0;
+		dCornerLat[j] = 0.0;
+	}
+	center = center / nCorners;
+	double dMag = sqrt(center.x * center.x + 
+					   center.y * center.y + 
+					   center.z * center.z);
+	center.x /= dMag;
+	center.y /= dMag;
+	center.z /= dMag;
+	XYZtoRLL_Deg(
+		center.x, center.y, center.z,
+		dCenterLon,
+		dCenterLat);
+	// Adjust corner logitudes
+	double lonDiff;
+	for (int j=0; j<nCorners; ++j) {
+		// First check for polar point
+		if (dCornerLat[j]==90. || dCornerLat[j]==-90.) {
+			dCornerLon[j] = dCenterLon;
 		}
-		varNodes->set_cur(1, 0);
-		varNodes->put(dCoord, 1, nNodeCount);
-		for (int i = 0; i < nNodeCount; i++) {
-			dCoord[i] = static_cast<double>(nodes[i].z);
+		// Next check for corners that wrap around prime meridian
+		lonDiff = dCenterLon - dCornerLon[j];
+		if (lonDiff>180) {
+			dCornerLon[j] = dCornerLon[j] + (double)360.0;
+		}
+		if (lonDiff<-180) {
+			dCornerLon[j] = dCornerLon[j] - (double)360.0;
 		}
-		varNodes->set_cur(2, 0);
-		varNodes->put(dCoord, 1, nNodeCount);
 	}
 }
 
@@ -771,13 +1629,25 @@ void Mesh::Write(
 
 void Mesh::WriteScrip(
 	const std::string & strFile,
-	NcFile::FileFormat eFileFormat
+	NcFile::FileFormat eFileFormat,
+	int nDeflateLevel,
+	int nThreads
 ) const {
 	const int ParamLenString = 33;
 
+	if ((nDeflateLevel < 0) || (nDeflateLevel > 9)) {
+		_EXCEPTION1("Invalid deflate level (%i)", nDeflateLevel);
+	}
+
 	// Temporarily change error reporting
 	NcError error_temp(NcError::verbose_fatal);
 
+	const bool fChunked = IsChunkedMeshFormat(eFileFormat);
+	if (!fChunked && (nDeflateLevel != 0)) {
+		Announce("WARNING: Deflate requires NetCDF-4 output; "
+			"mesh written without compression");
+	}
+
 	//---------------------------------------------------------------------------
 	// Determine block sizes
 	std::vector<int> vecBlockSizes;
@@ -840,17 +1710,26 @@ void Mesh::WriteScrip(
 	ncOut.add_att("file_size", 0);
 	//---------------------------------------------------------------------------
 	// Grid Area
+	const int nChunkMax = std::min(nElementCount, MeshWriteChunkSize);
 	{
 		NcVar * varArea = ncOut.add_var("grid_area", ncDouble, dimGridSize);
 		if (varArea == NULL) {
 			_EXCEPTIONT("Error creating variable \"grid_area\"");
 		}
-		DataArray1D<double> area(nElementCount);
-		for (int i=0; i<nElementCount; i++) {
-			area[i] = static_cast<double>( CalculateFaceArea(faces[i], nodes) );
+		if (fChunked) {
+			DefineMeshVariableStorage(ncOut, varArea, 0, nDeflateLevel);
+		}
+		DataArray1D<double> area(nChunkMax);
+		for (int iBegin = 0; iBegin < nElementCount; iBegin += MeshWriteChunkSize) {
+			const int nChunk = std::min(MeshWriteChunkSize, nElementCount - iBegin);
+#pragma omp parallel for num_threads(nThreads)
+			for (int j=0; j<nChunk; j++) {
+				area[j] = static_cast<double>(
+					CalculateFaceArea(faces[iBegin + j], nodes) );
+			}
+			varArea->set_cur((long)iBegin);
+			varArea->put(area, nChunk);
 		}
-		varArea->set_cur((long)0);
-		varArea->put(area, nElementCount);
 		varArea->add_att("units", "radians^2");
 	}
 	//---------------------------------------------------------------------------
@@ -872,106 +1751,569 @@ void Mesh::WriteScrip(
 		if (varCornerLon == NULL) {
 			_EXCEPTIONT("Error creating variable \"grid_corner_lon\"");
 		}
+		if (fChunked) {
+			DefineMeshVariableStorage(ncOut, varCenterLat, 0, nDeflateLevel);
+			DefineMeshVariableStorage(ncOut, varCenterLon, 0, nDeflateLevel);
+			DefineMeshVariableStorage(ncOut, varCornerLat, 0, nDeflateLevel);
+			DefineMeshVariableStorage(ncOut, varCornerLon, 0, nDeflateLevel);
+		}
 
-		DataArray1D<double> centerLat(nElementCount);
-		DataArray1D<double> centerLon(nElementCount);
-		DataArray2D<double> cornerLat(nElementCount, nCornersMax);
-		DataArray2D<double> cornerLon(nElementCount, nCornersMax);
-		Node corner(0,0,0);
-		for (int i=0; i<nElementCount; i++) {
-			Node center(0,0,0);
-			// int nCorners = faces[i].edges.size()+1;
-			int nCorners = faces[i].edges.size();
-			for (int j=0; j<nCorners; ++j) {
-				corner = nodes[ faces[i][j] ];
-				XYZtoRLL_Deg(
-					corner.x, corner.y, corner.z,
-					cornerLon[i][j],
-					cornerLat[i][j]);
-				center = center + corner;
-			}
-			center = center / nCorners;
-			double dMag = sqrt(center.x * center.x + 
-							   center.y * center.y + 
-							   center.z * center.z);
-			center.x /= dMag;
-			center.y /= dMag;
-			center.z /= dMag;
-			XYZtoRLL_Deg(
-				center.x, center.y, center.z,
-				centerLon[i],
-				centerLat[i]);
-			// Adjust corner logitudes
-			double lonDiff;
-			for (int j=0; j<nCorners; ++j) {
-				// First check for polar point
-				if (cornerLat[i][j]==90. || cornerLat[i][j]==-90.) {
-					cornerLon[i][j] = centerLon[i];
-				}
-				// Next check for corners that wrap around prime meridian
-				lonDiff = centerLon[i] - cornerLon[i][j];
-				if (lonDiff>180) {
-					cornerLon[i][j] = cornerLon[i][j] + (double)360.0;
-				}
-				if (lonDiff<-180) {
-					cornerLon[i][j] = cornerLon[i][j] - (double)360.0;
-				}
+		// Coordinates are converted and written one chunk of faces at a time
+		DataArray1D<double> centerLat(nChunkMax);
+		DataArray1D<double> centerLon(nChunkMax);
+		DataArray2D<double> cornerLat(nChunkMax, nCornersMax);
+		DataArray2D<double> cornerLon(nChunkMax, nCornersMax);
+		for (int iBegin = 0; iBegin < nElementCount; iBegin += MeshWriteChunkSize) {
+			const int nChunk = std::min(MeshWriteChunkSize, nElementCount - iBegin);
+#pragma omp parallel for num_threads(nThreads)
+			for (int i=0; i<nChunk; i++) {
+				CalculateScripFaceCoordinates(
+					faces[iBegin + i], nodes, nCornersMax,
+					centerLon[i], centerLat[i],
+					cornerLon[i], cornerLat[i]);
 			}
+			varCenterLat->set_cur((long)iBegin);
+			varCenterLat->put(centerLat, nChunk);
+
+			varCenterLon->set_cur((long)iBegin);
+			varCenterLon->put(centerLon, nChunk);
+
+			varCornerLat->set_cur((long)iBegin, 0);
+			varCornerLat->put(&(cornerLat[0][0]), nChunk, nCornersMax);
+
+			varCornerLon->set_cur((long)iBegin, 0);
+			varCornerLon->put(&(cornerLon[0][0]), nChunk, nCornersMax);
 		}
-		varCenterLat->set_cur((long)0);
-		varCenterLat->put(centerLat, nElementCount);
 		varCenterLat->add_att("units", "degrees");
 		varCenterLat->add_att("_FillValue", 9.96920996838687e+36 );
 
-		varCenterLon->set_cur((long)0);
-		varCenterLon->put(centerLon, nElementCount);
-		varCenterLon->add_att("units", "degrees");
-		varCenterLon->add_att("_FillValue", 9.96920996838687e+36 );
+		varCenterLon->add_att("units", "degrees");
+		varCenterLon->add_att("_FillValue", 9.96920996838687e+36 );
+
+		varCornerLat->add_att("units", "degrees");
+		varCornerLon->add_att("units", "degrees");
+		varCornerLat->add_att("_FillValue", 9.96920996838687e+36 );
+		varCornerLon->add_att("_FillValue", 9.96920996838687e+36 );
+	}
+	//---------------------------------------------------------------------------
+	// Grid mask
+	{
+		NcVar * varMask = ncOut.add_var("grid_imask", ncDouble, dimGridSize);
+		if (varMask == NULL) {
+			_EXCEPTIONT("Error creating variable \"grid_imask\"");
+		}
+		if (fChunked) {
+			DefineMeshVariableStorage(ncOut, varMask, 0, nDeflateLevel);
+		}
+		DataArray1D<double> mask(nChunkMax);
+		for (int i = 0; i < nChunkMax; i++) {
+			mask[i] = static_cast<double>( 1 );
+		}
+		for (int iBegin = 0; iBegin < nElementCount; iBegin += MeshWriteChunkSize) {
+			const int nChunk = std::min(MeshWriteChunkSize, nElementCount - iBegin);
+			varMask->set_cur((long)iBegin);
+			varMask->put(mask, nChunk);
+		}
+		varMask->add_att("_FillValue", 9.96920996838687e+36 );
+	}
+	//---------------------------------------------------------------------------
+	// Grid dims
+	{
+		NcVar * varDims = ncOut.add_var("grid_dims", ncInt, dimGridRank);
+		if (varDims == NULL) {
+			_EXCEPTIONT("Error creating variable \"grid_dims\"");
+		}
+		DataArray1D<int> rank(1);
+		rank(0) = 1;
+		varDims->set_cur((long)0);
+		varDims->put(rank, 1);
+	}
+	//---------------------------------------------------------------------------
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Read the nNodeCount nodes of an Exodus mesh file from its "coord"
+///		variable, a chunk of nodes at a time.
+///	</summary>
+static void ReadExodusNodes(
+	NcFile & ncFile,
+	const std::string & strFile,
+	int nNodeCount,
+	NodeVector & nodes
+) {
+	nodes.resize(nNodeCount);
+
+	NcVar * varNodes = ncFile.get_var("coord");
+	if (varNodes == NULL) {
+		_EXCEPTION1("Exodus Grid file \"%s\" is missing variable "
+				"\"coord\"", strFile.c_str());
+	}
+
+	const int nChunkSize = std::max(1, std::min(MeshReadChunkSize, nNodeCount));
+
+	DataArray1D<double> dNodeCoords(nChunkSize);
+
+	for (int i0 = 0; i0 < nNodeCount; i0 += nChunkSize) {
+		int nChunkNodes = std::min(nChunkSize, nNodeCount - i0);
+
+		varNodes->set_cur(0, i0);
+		varNodes->get(&(dNodeCoords[0]), 1, nChunkNodes);
+		for (int i = 0; i < nChunkNodes; i++) {
+			nodes[i0 + i].x = static_cast<Real>(dNodeCoords[i]);
+		}
+
+		varNodes->set_cur(1, i0);
+		varNodes->get(&(dNodeCoords[0]), 1, nChunkNodes);
+		for (int i = 0; i < nChunkNodes; i++) {
+			nodes[i0 + i].y = static_cast<Real>(dNodeCoords[i]);
+		}
+
+		varNodes->set_cur(2, i0);
+		varNodes->get(&(dNodeCoords[0]), 1, nChunkNodes);
+		for (int i = 0; i < nChunkNodes; i++) {
+			nodes[i0 + i].z = static_cast<Real>(dNodeCoords[i]);
+		}
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		An element block of an Exodus mesh file.
+///	</summary>
+struct ExodusElementBlock {
+
+	///	<summary>
+	///		Number of nodes per element.
+	///	</summary>
+	int nNodesPerElement;
+
+	///	<summary>
+	///		Number of elements.
+	///	</summary>
+	int nElementCount;
+
+	///	<summary>
+	///		Connectivity variable.
+	///	</summary>
+	NcVar * varConnect;
+
+	///	<summary>
+	///		Global id variable, or NULL if elements are numbered in order.
+	///	</summary>
+	NcVar * varGlobalId;
+};
+
+///	<summary>
+///		Read the connectivity and global ids of elements [i0, i0 + nChunk)
+///		of an Exodus element block, with connectivity converted to
+///		zero-based indices of the first coincident node.
+///	</summary>
+static void ReadExodusElementChunk(
+	const std::string & strFile,
+	const ExodusElementBlock & block,
+	int i0,
+	int nChunk,
+	const std::vector<int> & vecNodeFirst,
+	DataArray2D<int> & iConnect,
+	DataArray1D<int> & iGlobalId
+) {
+	const int nNodeCount = static_cast<int>(vecNodeFirst.size());
+
+	block.varConnect->set_cur(i0, 0);
+	block.varConnect->get(
+		&(iConnect[0][0]), nChunk, block.nNodesPerElement);
+
+	for (int i = 0; i < nChunk; i++) {
+	for (int k = 0; k < block.nNodesPerElement; k++) {
+		const int ixNode = iConnect[i][k] - 1;
+		if ((ixNode < 0) || (ixNode >= nNodeCount)) {
+			_EXCEPTION3("Exodus Grid file \"%s\" has node index %i out of "
+				"range [1,%i]", strFile.c_str(), iConnect[i][k], nNodeCount);
+		}
+		iConnect[i][k] = vecNodeFirst[ixNode];
+	}
+	}
+
+	if (block.varGlobalId == NULL) {
+		for (int i = 0; i < nChunk; i++) {
+			iGlobalId[i] = i0 + i + 1;
+		}
+	} else {
+		block.varGlobalId->set_cur((long)i0);
+		block.varGlobalId->get(&(iGlobalId[0]), nChunk);
+	}
+}
+
+///	<summary>
+///		Number of corners of an element after zero edges are removed.
+///	</summary>
+static int CountExodusElementCorners(
+	const int * iConnect,
+	int nNodesPerElement
+) {
+	int nCorners = 0;
+	for (int k = 0; k < nNodesPerElement; k++) {
+		if (iConnect[k] != iConnect[(k+1) % nNodesPerElement]) {
+			nCorners++;
+		}
+	}
+	return nCorners;
+}
+
+///	<summary>
+///		Build the Face of an element with zero edges removed, as
+///		Face::RemoveZeroEdges() would.
+///	</summary>
+static void BuildExodusElementFace(
+	const int * iConnect,
+	int nNodesPerElement,
+	Face & face
+) {
+	face = Face(CountExodusElementCorners(iConnect, nNodesPerElement));
+
+	int j = 0;
+	for (int k = 0; k < nNodesPerElement; k++) {
+		if (iConnect[k] != iConnect[(k+1) % nNodesPerElement]) {
+			face.SetNode(j, iConnect[k]);
+			j++;
+		}
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void ConvertExodusToScripStreaming(
+	const std::string & strInputFile,
+	const std::string & strOutputFile,
+	NcFile::FileFormat eFileFormat,
+	int nDeflateLevel,
+	int nThreads
+) {
+	const int ParamLenString = 33;
+
+	if ((nDeflateLevel < 0) || (nDeflateLevel > 9)) {
+		_EXCEPTION1("Invalid deflate level (%i)", nDeflateLevel);
+	}
+	if (nThreads < 1) {
+		_EXCEPTIONT("Thread count must be at least 1");
+	}
+
+	const bool fChunked = IsChunkedMeshFormat(eFileFormat);
+	if (!fChunked && (nDeflateLevel != 0)) {
+		Announce("WARNING: Deflate requires NetCDF-4 output; "
+			"mesh written without compression");
+	}
+
+	//---------------------------------------------------------------------------
+	// Open the Exodus file
+	NcFile ncIn(strInputFile.c_str(), NcFile::ReadOnly);
+	if (!ncIn.is_valid()) {
+		_EXCEPTION1("Unable to open grid file \"%s\" for reading",
+			strInputFile.c_str());
+	}
+
+	NcAtt * attVersion = ncIn.get_att("version");
+	if (attVersion == NULL) {
+		_EXCEPTION1("Exodus Grid file \"%s\" is missing attribute "
+				"\"version\"", strInputFile.c_str());
+	}
+	if (attVersion->type() != ncFloat) {
+		_EXCEPTIONT("Exodus Grid type is not of type float");
+	}
+	float flVersion = attVersion->as_float(0);
+
+	NcDim * dimNodes = ncIn.get_dim("num_nodes");
+	if (dimNodes == NULL) {
+		_EXCEPTION1("Exodus Grid file \"%s\" is missing dimension "
+				"\"num_nodes\"", strInputFile.c_str());
+	}
+	int nNodeCount = dimNodes->size();
+
+	NcDim * dimElementBlocks = ncIn.get_dim("num_el_blk");
+	if (dimElementBlocks == NULL) {
+		_EXCEPTION1("Exodus Grid file \"%s\" is missing dimension "
+				"\"num_el_blk\"", strInputFile.c_str());
+	}
+	int nElementBlocks = dimElementBlocks->size();
+
+	NcDim * dimElements = ncIn.get_dim("num_elem");
+	if (dimElements == NULL) {
+		_EXCEPTION1("Exodus Grid file \"%s\" is missing dimension "
+				"\"num_elem\"", strInputFile.c_str());
+	}
+	int nElementCount = dimElements->size();
+
+	Announce("Mesh size: Nodes [%i] Elements [%i]",
+		nNodeCount, nElementCount);
+
+	std::vector<ExodusElementBlock> vecBlocks(nElementBlocks);
+	int nNodesPerElementMax = 0;
+	int nBlockElementMax = 0;
+
+	for (int n = 0; n < nElementBlocks; n++) {
+		ExodusElementBlock & block = vecBlocks[n];
+
+		char szNodesPerElement[ParamLenString];
+		sprintf(szNodesPerElement, "num_nod_per_el%i", n+1);
+		NcDim * dimNodesPerElement = ncIn.get_dim(szNodesPerElement);
+		if (dimNodesPerElement == NULL) {
+			_EXCEPTION2("Exodus Grid file \"%s\" is missing dimension "
+				"\"%s\"", strInputFile.c_str(), szNodesPerElement);
+		}
+		block.nNodesPerElement = dimNodesPerElement->size();
+
+		char szElementsInBlock[ParamLenString];
+		sprintf(szElementsInBlock, "num_el_in_blk%i", n+1);
+		NcDim * dimBlockElements = ncIn.get_dim(szElementsInBlock);
+		if (dimBlockElements == NULL) {
+			_EXCEPTION2("Exodus Grid file \"%s\" is missing dimension "
+					"\"%s\"", strInputFile.c_str(), szElementsInBlock);
+		}
+		block.nElementCount = dimBlockElements->size();
+
+		char szConnect[ParamLenString];
+		sprintf(szConnect, "connect%i", n+1);
+		block.varConnect = ncIn.get_var(szConnect);
+		if (block.varConnect == NULL) {
+			_EXCEPTION2("Exodus Grid file \"%s\" is missing variable "
+					"\"%s\"", strInputFile.c_str(), szConnect);
+		}
+
+		// Earlier version didn't have global_id
+		block.varGlobalId = NULL;
+		if (flVersion != 4.98f) {
+			char szGlobalId[ParamLenString];
+			sprintf(szGlobalId, "global_id%i", n+1);
+			block.varGlobalId = ncIn.get_var(szGlobalId);
+			if (block.varGlobalId == NULL) {
+				_EXCEPTION2("Exodus Grid file \"%s\" is missing variable "
+						"\"%s\"", strInputFile.c_str(), szGlobalId);
+			}
+		}
+
+		nNodesPerElementMax =
+			std::max(nNodesPerElementMax, block.nNodesPerElement);
+		nBlockElementMax =
+			std::max(nBlockElementMax, block.nElementCount);
+	}
+
+	//---------------------------------------------------------------------------
+	// Load nodes and find coincident nodes; each node is replaced by the
+	// first node it is coincident with
+	NodeVector nodes;
+	ReadExodusNodes(ncIn, strInputFile, nNodeCount, nodes);
+
+	std::vector<int> vecNodeFirst;
+	{
+		std::vector<int> vecUniques;
+		FindCoincidentNodes(nodes, vecNodeFirst, vecUniques, nThreads);
+
+		if (vecUniques.size() != nodes.size()) {
+			Announce("%i duplicate nodes detected",
+				nodes.size() - vecUniques.size());
+		}
+
+		for (int i = 0; i < nNodeCount; i++) {
+			vecNodeFirst[i] = vecUniques[vecNodeFirst[i]];
+		}
+	}
+
+	const int nChunkMax =
+		std::max(1, std::min(MeshReadChunkSize, nBlockElementMax));
+
+	DataArray2D<int> iConnect(nChunkMax, std::max(1, nNodesPerElementMax));
+	DataArray1D<int> iGlobalId(nChunkMax);
+
+	//---------------------------------------------------------------------------
+	// First pass over connectivity to determine the number of corners of
+	// each element, which sizes the grid_corners dimension
+	int nCornersMax = 0;
+	{
+		std::map<int, int> mapBlockSizes;
+
+		for (int n = 0; n < nElementBlocks; n++) {
+			const ExodusElementBlock & block = vecBlocks[n];
+
+			for (int i0 = 0; i0 < block.nElementCount; i0 += nChunkMax) {
+				const int nChunk = std::min(nChunkMax, block.nElementCount - i0);
+
+				ReadExodusElementChunk(
+					strInputFile, block, i0, nChunk, vecNodeFirst,
+					iConnect, iGlobalId);
+
+				for (int i = 0; i < nChunk; i++) {
+					if ((iGlobalId[i] < 1) || (iGlobalId[i] > nElementCount)) {
+						_EXCEPTION2("global_id %i out of range [1,%i]",
+							iGlobalId[i], nElementCount);
+					}
+					mapBlockSizes[CountExodusElementCorners(
+						iConnect[i], block.nNodesPerElement)]++;
+				}
+			}
+		}
+
+		AnnounceStartBlock("Nodes per element");
+		std::map<int, int>::const_iterator iterBlockSize =
+			mapBlockSizes.begin();
+		int iBlock = 1;
+		for (; iterBlockSize != mapBlockSizes.end(); iterBlockSize++) {
+			Announce("Block %i (%i nodes): %i",
+				iBlock, iterBlockSize->first, iterBlockSize->second);
+			nCornersMax = std::max(nCornersMax, iterBlockSize->first);
+			iBlock++;
+		}
+		AnnounceEndBlock(NULL);
+	}
+
+	//---------------------------------------------------------------------------
+	// Define the SCRIP file
+	NcError error_temp(NcError::verbose_fatal);
+
+	NcFile ncOut(strOutputFile.c_str(), NcFile::Replace, NULL, 0, eFileFormat);
+	if (!ncOut.is_valid()) {
+		_EXCEPTION1("Unable to open grid file \"%s\" for writing",
+			strOutputFile.c_str());
+	}
+
+	NcDim * dimGridSize   = ncOut.add_dim("grid_size",    nElementCount);
+	NcDim * dimGridCorner = ncOut.add_dim("grid_corners", nCornersMax);
+	NcDim * dimGridRank   = ncOut.add_dim("grid_rank",    1);
+
+	ncOut.add_att("api_version", 5.00f);
+	ncOut.add_att("version", 5.00f);
+	ncOut.add_att("floating_point_word_size", 8);
+	ncOut.add_att("file_size", 0);
+
+	NcVar * varArea = ncOut.add_var("grid_area", ncDouble, dimGridSize);
+	NcVar * varCenterLat = ncOut.add_var("grid_center_lat", ncDouble, dimGridSize);
+	NcVar * varCenterLon = ncOut.add_var("grid_center_lon", ncDouble, dimGridSize);
+	NcVar * varCornerLat = ncOut.add_var("grid_corner_lat", ncDouble, dimGridSize, dimGridCorner);
+	NcVar * varCornerLon = ncOut.add_var("grid_corner_lon", ncDouble, dimGridSize, dimGridCorner);
+	NcVar * varMask = ncOut.add_var("grid_imask", ncDouble, dimGridSize);
+	NcVar * varDims = ncOut.add_var("grid_dims", ncInt, dimGridRank);
+
+	NcVar * vecVars[] = {
+		varArea, varCenterLat, varCenterLon,
+		varCornerLat, varCornerLon, varMask, varDims };
+	const char * szVarNames[] = {
+		"grid_area", "grid_center_lat", "grid_center_lon",
+		"grid_corner_lat", "grid_corner_lon", "grid_imask", "grid_dims" };
+
+	for (int v = 0; v < 7; v++) {
+		if (vecVars[v] == NULL) {
+			_EXCEPTION1("Error creating variable \"%s\"", szVarNames[v]);
+		}
+		if (fChunked && (v < 6)) {
+			DefineMeshVariableStorage(ncOut, vecVars[v], 0, nDeflateLevel);
+		}
+	}
+
+	varArea->add_att("units", "radians^2");
+	varCenterLat->add_att("units", "degrees");
+	varCenterLat->add_att("_FillValue", 9.96920996838687e+36 );
+	varCenterLon->add_att("units", "degrees");
+	varCenterLon->add_att("_FillValue", 9.96920996838687e+36 );
+	varCornerLat->add_att("units", "degrees");
+	varCornerLon->add_att("units", "degrees");
+	varCornerLat->add_att("_FillValue", 9.96920996838687e+36 );
+	varCornerLon->add_att("_FillValue", 9.96920996838687e+36 );
+	varMask->add_att("_FillValue", 9.96920996838687e+36 );
+
+	//---------------------------------------------------------------------------
+	// Second pass over connectivity: convert and write a chunk at a time
+	std::vector<Face> vecFaces(nChunkMax);
+
+	DataArray1D<double> area(nChunkMax);
+	DataArray1D<double> centerLat(nChunkMax);
+	DataArray1D<double> centerLon(nChunkMax);
+	DataArray2D<double> cornerLat(nChunkMax, std::max(1, nCornersMax));
+	DataArray2D<double> cornerLon(nChunkMax, std::max(1, nCornersMax));
+
+	for (int n = 0; n < nElementBlocks; n++) {
+		const ExodusElementBlock & block = vecBlocks[n];
+
+		for (int i0 = 0; i0 < block.nElementCount; i0 += nChunkMax) {
+			const int nChunk = std::min(nChunkMax, block.nElementCount - i0);
+
+			ReadExodusElementChunk(
+				strInputFile, block, i0, nChunk, vecNodeFirst,
+				iConnect, iGlobalId);
+
+#pragma omp parallel for num_threads(nThreads)
+			for (int i = 0; i < nChunk; i++) {
+				BuildExodusElementFace(
+					iConnect[i], block.nNodesPerElement, vecFaces[i]);
+
+				area[i] = static_cast<double>(
+					CalculateFaceArea(vecFaces[i], nodes));
+
+				CalculateScripFaceCoordinates(
+					vecFaces[i], nodes, nCornersMax,
+					centerLon[i], centerLat[i],
+					cornerLon[i], cornerLat[i]);
+			}
+
+			// Elements numbered consecutively are written as one hyperslab
+			bool fConsecutive = true;
+			for (int i = 1; i < nChunk; i++) {
+				if (iGlobalId[i] != iGlobalId[0] + i) {
+					fConsecutive = false;
+					break;
+				}
+			}
+
+			const int nRun = (fConsecutive)?(nChunk):(1);
+			for (int i = 0; i < nChunk; i += nRun) {
+				const long lBegin = static_cast<long>(iGlobalId[i] - 1);
+
+				varArea->set_cur(lBegin);
+				varArea->put(&(area[i]), nRun);
+
+				varCenterLat->set_cur(lBegin);
+				varCenterLat->put(&(centerLat[i]), nRun);
+
+				varCenterLon->set_cur(lBegin);
+				varCenterLon->put(&(centerLon[i]), nRun);
+
+				varCornerLat->set_cur(lBegin, 0);
+				varCornerLat->put(&(cornerLat[i][0]), nRun, nCornersMax);
 
-		for (int i=0; i<nElementCount; i++) {
-			varCornerLat->set_cur(i,0);
-			varCornerLat->put(cornerLat[i], 1, nCornersMax);
-			varCornerLon->set_cur(i,0);
-			varCornerLon->put(cornerLon[i], 1, nCornersMax);
+				varCornerLon->set_cur(lBegin, 0);
+				varCornerLon->put(&(cornerLon[i][0]), nRun, nCornersMax);
+			}
 		}
-		varCornerLat->add_att("units", "degrees");
-		varCornerLon->add_att("units", "degrees");
-		varCornerLat->add_att("_FillValue", 9.96920996838687e+36 );
-		varCornerLon->add_att("_FillValue", 9.96920996838687e+36 );
 	}
+
 	//---------------------------------------------------------------------------
-	// Grid mask
+	// Grid mask and dims
 	{
-		NcVar * varMask = ncOut.add_var("grid_imask", ncDouble, dimGridSize);
-		if (varMask == NULL) {
-			_EXCEPTIONT("Error creating variable \"grid_imask\"");
-		}
-		DataArray1D<double> mask(nElementCount);
-		for (int i = 0; i < nElementCount; i++) {
+		const int nMaskChunk = std::max(1, std::min(MeshWriteChunkSize, nElementCount));
+		DataArray1D<double> mask(nMaskChunk);
+		for (int i = 0; i < nMaskChunk; i++) {
 			mask[i] = static_cast<double>( 1 );
 		}
-		varMask->set_cur((long)0);
-		varMask->put(mask, nElementCount);
-		varMask->add_att("_FillValue", 9.96920996838687e+36 );
-	}
-	//---------------------------------------------------------------------------
-	// Grid dims
-	{
-		NcVar * varDims = ncOut.add_var("grid_dims", ncInt, dimGridRank);
-		if (varDims == NULL) {
-			_EXCEPTIONT("Error creating variable \"grid_dims\"");
+		for (int iBegin = 0; iBegin < nElementCount; iBegin += nMaskChunk) {
+			const int nChunk = std::min(nMaskChunk, nElementCount - iBegin);
+			varMask->set_cur((long)iBegin);
+			varMask->put(mask, nChunk);
 		}
+
 		DataArray1D<int> rank(1);
 		rank(0) = 1;
 		varDims->set_cur((long)0);
 		varDims->put(rank, 1);
 	}
-	//---------------------------------------------------------------------------
 }
 
 ///////////////////////////////////////////////////////////////////////////////
 
-void Mesh::Read(const std::string & strFile) {
+void Mesh::Read(
+	const std::string & strFile,
+	bool fReadMask
+) {
 
 	const int ParamFour = 4;
 	const int ParamLenString = 33;
@@ -983,6 +2325,29 @@ void Mesh::Read(const std::string & strFile) {
 	if (strFile == "") {
 		_EXCEPTIONT("No grid file specified for reading");
 	}
+
+	// Compact overlap meshes are expanded using their source and target meshes
+	if (CompactOverlapMesh::IsCompactOverlapFile(strFile)) {
+		Announce("Compact overlap mesh detected");
+
+		CompactOverlapMesh meshCompact;
+		meshCompact.Read(strFile);
+
+		if ((meshCompact.GetSourceMeshFile() == "") ||
+		    (meshCompact.GetTargetMeshFile() == "")
+		) {
+			_EXCEPTION1("Compact overlap mesh \"%s\" does not record its "
+				"source and target meshes", strFile.c_str());
+		}
+
+		Mesh meshSource(meshCompact.GetSourceMeshFile());
+		Mesh meshTarget(meshCompact.GetTargetMeshFile());
+
+		meshCompact.ToMesh(meshSource, meshTarget, *this);
+		strFileName = strFile;
+		return;
+	}
+
 	NcFile ncFile(strFile.c_str(), NcFile::ReadOnly);
 	if (!ncFile.is_valid()) {
 		_EXCEPTION1("Unable to open grid file \"%s\" for reading",
@@ -1031,17 +2396,8 @@ void Mesh::Read(const std::string & strFile) {
 		int nGridSize = static_cast<int>(dimGridSize->size());
 		int nGridCorners = static_cast<int>(dimGridCorners->size());
 
-		DataArray2D<double> dCornerLat(nGridSize, nGridCorners);
-		DataArray2D<double> dCornerLon(nGridSize, nGridCorners);
-
-		varGridCornerLat->set_cur(0, 0);
-		varGridCornerLat->get(&(dCornerLat[0][0]), nGridSize, nGridCorners);
-
-		varGridCornerLon->set_cur(0, 0);
-		varGridCornerLon->get(&(dCornerLon[0][0]), nGridSize, nGridCorners);
-
 		faces.resize(nGridSize);
-		nodes.resize(nGridSize * nGridCorners);
+		nodes.clear();
 
 		// Check for units attribute; if "degrees" then convert to radians
 		bool fConvertLonToRadians = false;
@@ -1068,7 +2424,7 @@ void Mesh::Read(const std::string & strFile) {
 
 		// Load mask variable
 		NcVar * varMask = ncFile.get_var("grid_imask");
-		if (varMask != NULL) {
+		if ((varMask != NULL) && fReadMask) {
 			if (varMask->num_dims() != 1) {
 				_EXCEPTIONT("Unknown format of variable \"grid_imask\": "
 					"More than one dimension");
@@ -1086,48 +2442,78 @@ void Mesh::Read(const std::string & strFile) {
 			varMask->get(&(vecMask[0]), nGridSize);
 		}
 
-		// Current global node index
-		int ixNode = 0;
+		// Read corners a chunk of cells at a time, removing coincident
+		// nodes as they are encountered.  SCRIP does not reference a node
+		// table, so without this the full corner arrays would be needed.
+		const int nChunkSize = std::max(1, std::min(MeshReadChunkSize, nGridSize));
 
-		for (int i = 0; i < nGridSize; i++) {
+		DataArray2D<double> dCornerLat(nChunkSize, nGridCorners);
+		DataArray2D<double> dCornerLon(nChunkSize, nGridCorners);
 
-			// Create a new Face
-			Face faceNew(nGridCorners);
-			for (int j = 0; j < nGridCorners; j++) {
-				faceNew.SetNode(j, ixNode + j);
-			}
-			faces[i] = faceNew;
+		node_hash_3d<Node, int> mapNodes(
+			ReferenceTolerance, MESH_NODE_HASH_CELL_WIDTH);
 
-			// Insert Face corners into node table
-			for (int j = 0; j < nGridCorners; j++) {
-				double dLon = dCornerLon[i][j];
-				double dLat = dCornerLat[i][j];
+		int nDuplicateNodes = 0;
 
-				if (fConvertLonToRadians) {
-					dLon = dLon / 180.0 * M_PI;
-				}
-				if (fConvertLatToRadians) {
-					dLat = dLat / 180.0 * M_PI;
-				}
+		for (int i0 = 0; i0 < nGridSize; i0 += nChunkSize) {
+			int nChunkCells = std::min(nChunkSize, nGridSize - i0);
 
-				if (dLat > 0.5 * M_PI) {
-					dLat = 0.5 * M_PI;
-				}
-				if (dLat < -0.5 * M_PI) {
-					dLat = -0.5 * M_PI;
-				}
+			varGridCornerLat->set_cur(i0, 0);
+			varGridCornerLat->get(&(dCornerLat[0][0]), nChunkCells, nGridCorners);
+
+			varGridCornerLon->set_cur(i0, 0);
+			varGridCornerLon->get(&(dCornerLon[0][0]), nChunkCells, nGridCorners);
+
+			for (int i = 0; i < nChunkCells; i++) {
+
+				// Create a new Face
+				Face faceNew(nGridCorners);
+
+				// Insert Face corners into node table
+				for (int j = 0; j < nGridCorners; j++) {
+					double dLon = dCornerLon[i][j];
+					double dLat = dCornerLat[i][j];
 
-				nodes[ixNode].x = cos(dLon) * cos(dLat);
-				nodes[ixNode].y = sin(dLon) * cos(dLat);
-				nodes[ixNode].z = sin(dLat);
+					if (fConvertLonToRadians) {
+						dLon = dLon / 180.0 * M_PI;
+					}
+					if (fConvertLatToRadians) {
+						dLat = dLat / 180.0 * M_PI;
+					}
+
+					if (dLat > 0.5 * M_PI) {
+						dLat = 0.5 * M_PI;
+					}
+					if (dLat < -0.5 * M_PI) {
+						dLat = -0.5 * M_PI;
+					}
+
+					Node node(
+						cos(dLon) * cos(dLat),
+						sin(dLon) * cos(dLat),
+						sin(dLat));
+
+					std::pair<node_hash_3d<Node, int>::const_iterator, bool> prInsert =
+						mapNodes.insert(
+							node_hash_3d<Node, int>::value_type(
+								node, static_cast<int>(nodes.size())));
+
+					faceNew.SetNode(j, prInsert.first->second);
 
-				ixNode++;
+					if (prInsert.second) {
+						nodes.push_back(node);
+					} else {
+						nDuplicateNodes++;
+					}
+				}
+
+				faces[i0 + i] = faceNew;
 			}
 		}
 
-		// SCRIP does not reference a node table, so we must remove
-		// coincident nodes.
-		RemoveCoincidentNodes();
+		if (nDuplicateNodes != 0) {
+			Announce("%i duplicate nodes detected", nDuplicateNodes);
+		}
 
 		// Output size
 		Announce("Mesh size: Nodes [%i] Elements [%i]",
@@ -1178,6 +2564,10 @@ void Mesh::Read(const std::string & strFile) {
 		// Allocate faces
 		faces.resize(nTotalElementCount);
 
+		// Face areas are only retained if present in every block
+		std::vector<double> vecFaceAreaIn;
+		bool fHasArea = (nElementBlocks > 0);
+
 		// Loop over all blocks
 		for (int n = 0; n < nElementBlocks; n++) {
 
@@ -1210,6 +2600,8 @@ void Mesh::Read(const std::string & strFile) {
 			DataArray1D<int> iParentA(nElementCount);
 			DataArray1D<int> iParentB(nElementCount);
 
+			DataArray1D<double> dArea(nElementCount);
+
 			// Load in nodes for all elements in this block
 			char szConnect[ParamLenString];
 			sprintf(szConnect, "connect%i", n+1);
@@ -1314,6 +2706,28 @@ void Mesh::Read(const std::string & strFile) {
 					nElementCount);
 			}
 
+			// Load in area for all elements in this block
+			if (fHasArea) {
+				char szArea[ParamLenString];
+				sprintf(szArea, "el_area%i", n+1);
+
+				NcVar * varArea = ncFile.get_var(szArea);
+				if (varArea == NULL) {
+					fHasArea = false;
+					vecFaceAreaIn.clear();
+
+				} else {
+					if (vecFaceAreaIn.size() == 0) {
+						vecFaceAreaIn.resize(nTotalElementCount);
+					}
+
+					varArea->set_cur((long)0);
+					varArea->get(
+						&(dArea[0]),
+						nElementCount);
+				}
+			}
+
 			// Put local data into global structures
 			for (int i = 0; i < nElementCount; i++) {
 				if (iGlobalId[i] - 1 >= nTotalElementCount) {
@@ -1334,6 +2748,17 @@ void Mesh::Read(const std::string & strFile) {
 				if (vecTargetFaceIx.size() != 0) {
 					vecTargetFaceIx[iGlobalId[i] - 1] = iParentB[i] - 1;
 				}
+
+				if (fHasArea) {
+					vecFaceAreaIn[iGlobalId[i] - 1] = dArea[i];
+				}
+			}
+		}
+
+		if (fHasArea) {
+			vecFaceArea.Allocate(nTotalElementCount);
+			for (int i = 0; i < nTotalElementCount; i++) {
+				vecFaceArea[i] = vecFaceAreaIn[i];
 			}
 		}
 
@@ -1352,31 +2777,406 @@ void Mesh::Read(const std::string & strFile) {
 		}
 
 		// Load in node array
-		{
-			nodes.resize(nNodeCount);
+		ReadExodusNodes(ncFile, strFile, nNodeCount, nodes);
 
-			NcVar * varNodes = ncFile.get_var("coord");
-			if (varNodes == NULL) {
-				_EXCEPTION1("Exodus Grid file \"%s\" is missing variable "
-						"\"coord\"", strFile.c_str());
-			}
+	 // Remove coincident nodes.
+	 RemoveCoincidentNodes();
+	}
+}
 
-			DataArray2D<double> dNodeCoords(3, nNodeCount);
+///////////////////////////////////////////////////////////////////////////////
 
-			// Load in node array
-			varNodes->set_cur(0, 0);
-			varNodes->get(&(dNodeCoords[0][0]), 3, nNodeCount);
+///	<summary>
+///		Identifier at the start of every prepared mesh file.
+///	</summary>
+static const char PreparedMeshMagic[8] =
+	{ 'T', 'R', 'P', 'R', 'E', 'P', '\0', '\0' };
+
+///	<summary>
+///		Version of the prepared mesh file format.  Increment whenever the
+///		layout changes so that stale files are ignored.
+///	</summary>
+static const int PreparedMeshVersion = 1;
+
+///	<summary>
+///		Flags indicating which structures are stored in a prepared mesh file.
+///	</summary>
+static const int PreparedMeshHasEdgeMap = 1;
+static const int PreparedMeshHasReverseNodeArray = 2;
+static const int PreparedMeshHasFaceAreas = 4;
+static const int PreparedMeshHasFaceNeighbors = 8;
+static const int PreparedMeshHasFaceStencils = 16;
+
+///	<summary>
+///		Update a 64-bit FNV-1a hash with a block of bytes.
+///	</summary>
+static void UpdateFNV1aHash(
+	unsigned long long & ullHash,
+	const void * pData,
+	size_t sBytes
+) {
+	const unsigned char * pBytes = static_cast<const unsigned char *>(pData);
+	for (size_t i = 0; i < sBytes; i++) {
+		ullHash ^= static_cast<unsigned long long>(pBytes[i]);
+		ullHash *= 1099511628211ULL;
+	}
+}
 
-			for (int i = 0; i < nNodeCount; i++) {
-				nodes[i].x = static_cast<Real>(dNodeCoords[0][i]);
-				nodes[i].y = static_cast<Real>(dNodeCoords[1][i]);
-				nodes[i].z = static_cast<Real>(dNodeCoords[2][i]);
-			}
+///	<summary>
+///		Write a block of data to a prepared mesh file.
+///	</summary>
+static void WritePreparedBlock(
+	FILE * fp,
+	const void * pData,
+	size_t sSize,
+	size_t sCount,
+	const std::string & strFile
+) {
+	if (sCount == 0) {
+		return;
+	}
+	if (fwrite(pData, sSize, sCount, fp) != sCount) {
+		fclose(fp);
+		_EXCEPTION1("Error writing prepared mesh file \"%s\"", strFile.c_str());
+	}
+}
+
+///	<summary>
+///		Read a block of data from a prepared mesh file.
+///	</summary>
+static bool ReadPreparedBlock(
+	FILE * fp,
+	void * pData,
+	size_t sSize,
+	size_t sCount
+) {
+	if (sCount == 0) {
+		return true;
+	}
+	return (fread(pData, sSize, sCount, fp) == sCount);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+unsigned long long Mesh::CalculateContentHash() const {
+	unsigned long long ullHash = 14695981039346656037ULL;
+
+	int nNodes = static_cast<int>(nodes.size());
+	int nFaces = static_cast<int>(faces.size());
+
+	UpdateFNV1aHash(ullHash, &nNodes, sizeof(int));
+	UpdateFNV1aHash(ullHash, &nFaces, sizeof(int));
+
+	for (int i = 0; i < nNodes; i++) {
+		double dCoord[3];
+		dCoord[0] = static_cast<double>(nodes[i].x);
+		dCoord[1] = static_cast<double>(nodes[i].y);
+		dCoord[2] = static_cast<double>(nodes[i].z);
+		UpdateFNV1aHash(ullHash, dCoord, 3 * sizeof(double));
+	}
+
+	for (int i = 0; i < nFaces; i++) {
+		int nEdges = static_cast<int>(faces[i].edges.size());
+		UpdateFNV1aHash(ullHash, &nEdges, sizeof(int));
+
+		for (int k = 0; k < nEdges; k++) {
+			int iEdge[3];
+			iEdge[0] = faces[i].edges[k][0];
+			iEdge[1] = faces[i].edges[k][1];
+			iEdge[2] = static_cast<int>(faces[i].edges[k].type);
+			UpdateFNV1aHash(ullHash, iEdge, 3 * sizeof(int));
 		}
+	}
 
-	 // Remove coincident nodes.
-	 RemoveCoincidentNodes();
+	return ullHash;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void Mesh::WritePrepared(
+	const std::string & strFile
+) const {
+	FILE * fp = fopen(strFile.c_str(), "wb");
+	if (fp == NULL) {
+		_EXCEPTION1("Unable to open prepared mesh file \"%s\" for writing",
+			strFile.c_str());
+	}
+
+	int iFlags = 0;
+	if (edgemap.size() != 0) {
+		iFlags |= PreparedMeshHasEdgeMap;
+	}
+	if ((revnodearray.size() != 0) && (revnodearray.size() == nodes.size())) {
+		iFlags |= PreparedMeshHasReverseNodeArray;
+	}
+	if (vecFaceArea.IsAttached() && (vecFaceArea.GetRows() == faces.size())) {
+		iFlags |= PreparedMeshHasFaceAreas;
+	}
+	if ((faceneighbors.size() != 0) && (faceneighbors.size() == faces.size())) {
+		iFlags |= PreparedMeshHasFaceNeighbors;
+	}
+	if ((facestencils.size() != 0) && (facestencils.size() == faces.size())) {
+		iFlags |= PreparedMeshHasFaceStencils;
+	}
+
+	// Header
+	unsigned long long ullHash = CalculateContentHash();
+
+	int nNodes = static_cast<int>(nodes.size());
+	int nFaces = static_cast<int>(faces.size());
+
+	WritePreparedBlock(fp, PreparedMeshMagic, sizeof(char), 8, strFile);
+	WritePreparedBlock(fp, &PreparedMeshVersion, sizeof(int), 1, strFile);
+	WritePreparedBlock(fp, &ullHash, sizeof(unsigned long long), 1, strFile);
+	WritePreparedBlock(fp, &nNodes, sizeof(int), 1, strFile);
+	WritePreparedBlock(fp, &nFaces, sizeof(int), 1, strFile);
+	WritePreparedBlock(fp, &iFlags, sizeof(int), 1, strFile);
+
+	// EdgeMap as (node0, node1, type, face0, face1) in iteration order
+	if (iFlags & PreparedMeshHasEdgeMap) {
+		int nEdges = static_cast<int>(edgemap.size());
+
+		std::vector<int> vecEdgeData;
+		vecEdgeData.reserve(5 * nEdges);
+
+		EdgeMapConstIterator iter = edgemap.begin();
+		for (; iter != edgemap.end(); iter++) {
+			vecEdgeData.push_back(iter->first[0]);
+			vecEdgeData.push_back(iter->first[1]);
+			vecEdgeData.push_back(static_cast<int>(iter->first.type));
+			vecEdgeData.push_back(iter->second[0]);
+			vecEdgeData.push_back(iter->second[1]);
+		}
+
+		WritePreparedBlock(fp, &nEdges, sizeof(int), 1, strFile);
+		WritePreparedBlock(fp, vecEdgeData.data(), sizeof(int), vecEdgeData.size(), strFile);
+	}
+
+	// ReverseNodeArray in compressed row form
+	if (iFlags & PreparedMeshHasReverseNodeArray) {
+		const std::vector<int> & vecOffsets = revnodearray.GetOffsets();
+		const std::vector<int> & vecFaceIx = revnodearray.GetFaceIndices();
+
+		WritePreparedBlock(fp, vecOffsets.data(), sizeof(int), vecOffsets.size(), strFile);
+		WritePreparedBlock(fp, vecFaceIx.data(), sizeof(int), vecFaceIx.size(), strFile);
 	}
+
+	// Face areas
+	if (iFlags & PreparedMeshHasFaceAreas) {
+		WritePreparedBlock(fp, &(vecFaceArea[0]), sizeof(double), nFaces, strFile);
+	}
+
+	// FaceNeighborTable as its width followed by its entries
+	if (iFlags & PreparedMeshHasFaceNeighbors) {
+		int nWidth = faceneighbors.GetWidth();
+		const std::vector<int> & vecFaceIx = faceneighbors.GetFaceIndices();
+
+		WritePreparedBlock(fp, &nWidth, sizeof(int), 1, strFile);
+		WritePreparedBlock(fp, vecFaceIx.data(), sizeof(int), vecFaceIx.size(), strFile);
+	}
+
+	// FaceStencilTable as its type and required size followed by its
+	// compressed row arrays
+	if (iFlags & PreparedMeshHasFaceStencils) {
+		int iStencilKey[2];
+		iStencilKey[0] = static_cast<int>(facestencils.GetType());
+		iStencilKey[1] = facestencils.GetRequiredFaceSetSize();
+
+		const std::vector<int> & vecOffsets = facestencils.GetOffsets();
+		const std::vector<int> & vecFaceIx = facestencils.GetFaceIndices();
+		const std::vector<int> & vecDistance = facestencils.GetDistances();
+
+		WritePreparedBlock(fp, iStencilKey, sizeof(int), 2, strFile);
+		WritePreparedBlock(fp, vecOffsets.data(), sizeof(int), vecOffsets.size(), strFile);
+		WritePreparedBlock(fp, vecFaceIx.data(), sizeof(int), vecFaceIx.size(), strFile);
+		WritePreparedBlock(fp, vecDistance.data(), sizeof(int), vecDistance.size(), strFile);
+	}
+
+	fclose(fp);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+bool Mesh::ReadPrepared(
+	const std::string & strFile
+) {
+	FILE * fp = fopen(strFile.c_str(), "rb");
+	if (fp == NULL) {
+		return false;
+	}
+
+	// Header
+	char szMagic[8];
+	int iVersion;
+	unsigned long long ullHash;
+	int nNodes;
+	int nFaces;
+	int iFlags;
+
+	bool fValid =
+		ReadPreparedBlock(fp, szMagic, sizeof(char), 8)
+		&& ReadPreparedBlock(fp, &iVersion, sizeof(int), 1)
+		&& ReadPreparedBlock(fp, &ullHash, sizeof(unsigned long long), 1)
+		&& ReadPreparedBlock(fp, &nNodes, sizeof(int), 1)
+		&& ReadPreparedBlock(fp, &nFaces, sizeof(int), 1)
+		&& ReadPreparedBlock(fp, &iFlags, sizeof(int), 1);
+
+	if (!fValid || (memcmp(szMagic, PreparedMeshMagic, 8) != 0)) {
+		Announce("Prepared mesh file \"%s\" is not valid; ignoring",
+			strFile.c_str());
+		fclose(fp);
+		return false;
+	}
+	if (iVersion != PreparedMeshVersion) {
+		Announce("Prepared mesh file \"%s\" has version %i (expected %i); ignoring",
+			strFile.c_str(), iVersion, PreparedMeshVersion);
+		fclose(fp);
+		return false;
+	}
+	if ((nNodes != nodes.size()) ||
+		(nFaces != faces.size()) ||
+		(ullHash != CalculateContentHash())
+	) {
+		Announce("Prepared mesh file \"%s\" does not match mesh; ignoring",
+			strFile.c_str());
+		fclose(fp);
+		return false;
+	}
+
+	// Read into temporaries so that the Mesh is unchanged on failure
+	EdgeMap edgemapIn;
+	ReverseNodeArray revnodearrayIn;
+	DataArray1D<double> vecFaceAreaIn;
+	FaceNeighborTable faceneighborsIn;
+	FaceStencilTable facestencilsIn;
+
+	if (iFlags & PreparedMeshHasEdgeMap) {
+		int nEdges;
+		fValid = ReadPreparedBlock(fp, &nEdges, sizeof(int), 1) && (nEdges >= 0);
+
+		std::vector<int> vecEdgeData;
+		if (fValid) {
+			vecEdgeData.resize(5 * nEdges);
+			fValid = ReadPreparedBlock(fp, vecEdgeData.data(), sizeof(int), vecEdgeData.size());
+		}
+
+#if defined(EDGEMAP_USE_UNSORTED_MAP)
+		edgemapIn.reserve(nEdges);
+#endif
+
+		// Edges were written in iteration order; for a sorted EdgeMap each
+		// insertion is then at the end
+		for (int i = 0; fValid && (i < nEdges); i++) {
+			const int * pEdge = &(vecEdgeData[5*i]);
+
+			Edge edge(pEdge[0], pEdge[1], static_cast<Edge::Type>(pEdge[2]));
+
+			FacePair facepair;
+			facepair.face[0] = pEdge[3];
+			facepair.face[1] = pEdge[4];
+
+			edgemapIn.insert(edgemapIn.end(), EdgeMapPair(edge, facepair));
+		}
+	}
+
+	if (fValid && (iFlags & PreparedMeshHasReverseNodeArray)) {
+		std::vector<int> vecOffsets(nNodes + 1);
+		fValid = ReadPreparedBlock(fp, &(vecOffsets[0]), sizeof(int), vecOffsets.size())
+			&& (vecOffsets[0] == 0) && (vecOffsets[nNodes] >= 0);
+
+		std::vector<int> vecFaceIx;
+		if (fValid) {
+			vecFaceIx.resize(vecOffsets[nNodes]);
+			fValid = ReadPreparedBlock(fp, vecFaceIx.data(), sizeof(int), vecFaceIx.size());
+		}
+
+		if (fValid) {
+			revnodearrayIn.Swap(vecOffsets, vecFaceIx);
+		}
+	}
+
+	if (fValid && (iFlags & PreparedMeshHasFaceAreas)) {
+		vecFaceAreaIn.Allocate(nFaces);
+		fValid = ReadPreparedBlock(fp, &(vecFaceAreaIn[0]), sizeof(double), nFaces);
+	}
+
+	if (fValid && (iFlags & PreparedMeshHasFaceNeighbors)) {
+		int nWidth;
+		fValid = ReadPreparedBlock(fp, &nWidth, sizeof(int), 1) && (nWidth > 0);
+
+		std::vector<int> vecFaceIx;
+		if (fValid) {
+			vecFaceIx.resize(static_cast<size_t>(nFaces) * nWidth);
+			fValid = ReadPreparedBlock(fp, vecFaceIx.data(), sizeof(int), vecFaceIx.size());
+		}
+
+		if (fValid) {
+			faceneighborsIn.Swap(nWidth, vecFaceIx);
+		}
+	}
+
+	if (fValid && (iFlags & PreparedMeshHasFaceStencils)) {
+		int iStencilKey[2];
+		fValid = ReadPreparedBlock(fp, iStencilKey, sizeof(int), 2)
+			&& ((iStencilKey[0] == FaceStencilType_ByEdge)
+				|| (iStencilKey[0] == FaceStencilType_ByNode))
+			&& (iStencilKey[1] > 0);
+
+		std::vector<int> vecOffsets;
+		if (fValid) {
+			vecOffsets.resize(nFaces + 1);
+			fValid = ReadPreparedBlock(fp, &(vecOffsets[0]), sizeof(int), vecOffsets.size())
+				&& (vecOffsets[0] == 0) && (vecOffsets[nFaces] >= 0);
+		}
+
+		std::vector<int> vecFaceIx;
+		std::vector<int> vecDistance;
+		if (fValid) {
+			vecFaceIx.resize(vecOffsets[nFaces]);
+			vecDistance.resize(vecOffsets[nFaces]);
+			fValid = ReadPreparedBlock(fp, vecFaceIx.data(), sizeof(int), vecFaceIx.size())
+				&& ReadPreparedBlock(fp, vecDistance.data(), sizeof(int), vecDistance.size());
+		}
+
+		if (fValid) {
+			facestencilsIn.Swap(
+				static_cast<FaceStencilType>(iStencilKey[0]),
+				iStencilKey[1],
+				vecOffsets,
+				vecFaceIx,
+				vecDistance);
+		}
+	}
+
+	fclose(fp);
+
+	if (!fValid) {
+		Announce("Prepared mesh file \"%s\" is truncated; ignoring",
+			strFile.c_str());
+		return false;
+	}
+
+	// Install the structures that were stored
+	if (iFlags & PreparedMeshHasEdgeMap) {
+		edgemap.swap(edgemapIn);
+	}
+	if (iFlags & PreparedMeshHasReverseNodeArray) {
+		revnodearray.swap(revnodearrayIn);
+	}
+	if (iFlags & PreparedMeshHasFaceNeighbors) {
+		faceneighbors.swap(faceneighborsIn);
+	}
+	if (iFlags & PreparedMeshHasFaceStencils) {
+		facestencils.swap(facestencilsIn);
+	}
+	if (iFlags & PreparedMeshHasFaceAreas) {
+		vecFaceArea.Allocate(nFaces);
+		for (int i = 0; i < nFaces; i++) {
+			vecFaceArea[i] = vecFaceAreaIn[i];
+		}
+	}
+
+	return true;
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -1387,164 +3187,317 @@ void Mesh::RemoveZeroEdges() {
 	for (int i = 0; i < faces.size(); i++) {
 		faces[i].RemoveZeroEdges();
 	}
-}
 
-///////////////////////////////////////////////////////////////////////////////
+	// Edge indices of the FaceNeighborTable may have shifted
+	if (faceneighbors.size() != 0) {
+		ConstructFaceNeighbors();
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Hash of a Node or Face index, used to select a deterministic,
+///		spatially unstructured sample for Mesh::Validate.
+///	</summary>
+static unsigned int ValidateSampleHash(
+	unsigned int ix
+) {
+	ix ^= (ix >> 16);
+	ix *= 0x7FEB352DU;
+	ix ^= (ix >> 15);
+	ix *= 0x846CA68BU;
+	ix ^= (ix >> 16);
+	return ix;
+}
+
+///	<summary>
+///		Validate that the edges of Face i are cyclic and oriented
+///		counter-clockwise.  On failure returns false and sets strError,
+///		along with any diagnostic output in strDetail.
+///	</summary>
+static bool ValidateFace(
+	const NodeVector & nodes,
+	const Face & face,
+	int i,
+	std::string & strError,
+	std::string & strDetail
+) {
+	const int nEdges = face.edges.size();
+
+	for (int j = 0; j < nEdges; j++) {
+
+		// Check for zero edges
+		for(;;) {
+			if (face.edges[j][0] == face.edges[j][1]) {
+				j++;
+			} else {
+				break;
+			}
+			if (j == nEdges) {
+				break;
+			}
+		}
+
+		if (j == nEdges) {
+			break;
+		}
+
+		// Find the next non-zero edge
+		int jNext = (j + 1) % nEdges;
+
+		for(;;) {
+			if (face.edges[jNext][0] == face.edges[jNext][1]) {
+				jNext++;
+			} else {
+				break;
+			}
+			if (jNext == nEdges) {
+				jNext = 0;
+			}
+			if (jNext == ((j + 1) % nEdges)) {
+				strError = "Mesh validation failed: No edge information on Face";
+				return false;
+			}
+		}
+
+		// Get edges
+		const Edge & edge0 = face.edges[j];
+		const Edge & edge1 = face.edges[(j + 1) % nEdges];
+
+		if (edge0[1] != edge1[0]) {
+			strError = "Mesh validation failed: Edge cyclicity error";
+			return false;
+		}
+
+		const Node & node0 = nodes[edge0[0]];
+		const Node & node1 = nodes[edge0[1]];
+		const Node & node2 = nodes[edge1[1]];
+
+		// Vectors along edges
+		Node nodeD1 = node0 - node1;
+		Node nodeD2 = node2 - node1;
+
+		// Compute cross-product
+		Node nodeCross(CrossProduct(nodeD1, nodeD2));
+
+		// Dot cross product with radial vector
+		Real dDot = DotProduct(node1, nodeCross);
+/*
+#ifdef USE_EXACT_ARITHMETIC
+		FixedPoint dDotX = DotProductX(node1, nodeCross);
+
+		printf("%1.15e : ", nodeCross.x); nodeCross.fx.Print(); printf("\n");
+
+		if (fabs(nodeCross.x - nodeCross.fx.ToReal()) > ReferenceTolerance) {
+			printf("X0: %1.15e : ", node0.x); node0.fx.Print(); printf("\n");
+			printf("Y0: %1.15e : ", node0.y); node0.fy.Print(); printf("\n");
+			printf("Z0: %1.15e : ", node0.z); node0.fz.Print(); printf("\n");
+			printf("X1: %1.15e : ", node1.x); node1.fx.Print(); printf("\n");
+			printf("Y1: %1.15e : ", node1.y); node1.fy.Print(); printf("\n");
+			printf("Z1: %1.15e : ", node1.z); node1.fz.Print(); printf("\n");
+			printf("X2: %1.15e : ", node2.x); node2.fx.Print(); printf("\n");
+			printf("Y2: %1.15e : ", node2.y); node2.fy.Print(); printf("\n");
+			printf("Z2: %1.15e : ", node2.z); node2.fz.Print(); printf("\n");
+
+			printf("X1: %1.15e : ", nodeD1.x); nodeD1.fx.Print(); printf("\n");
+			printf("Y1: %1.15e : ", nodeD1.y); nodeD1.fy.Print(); printf("\n");
+			printf("Z1: %1.15e : ", nodeD1.z); nodeD1.fz.Print(); printf("\n");
+			printf("X2: %1.15e : ", nodeD2.x); nodeD2.fx.Print(); printf("\n");
+			printf("Y2: %1.15e : ", nodeD2.y); nodeD2.fy.Print(); printf("\n");
+			printf("Z2: %1.15e : ", nodeD2.z); nodeD2.fz.Print(); printf("\n");
+			_EXCEPTIONT("FixedPoint mismatch (X)");
+		}
+		if (fabs(nodeCross.y - nodeCross.fy.ToReal()) > ReferenceTolerance) {
+			_EXCEPTIONT("FixedPoint mismatch (Y)");
+		}
+		if (fabs(nodeCross.z - nodeCross.fz.ToReal()) > ReferenceTolerance) {
+			_EXCEPTIONT("FixedPoint mismatch (Z)");
+		}
+
+#endif
+*/
+		if (dDot > 0.0) {
+			char szBuffer[1024];
+
+			Real dR0 = sqrt(
+				node0.x * node0.x + node0.y * node0.y + node0.z * node0.z);
+			Real dLat0 = asin(node0.z / dR0);
+			Real dLon0 = atan2(node0.y, node0.x);
+
+			Real dR1 = sqrt(
+				node1.x * node1.x + node1.y * node1.y + node1.z * node1.z);
+			Real dLat1 = asin(node1.z / dR1);
+			Real dLon1 = atan2(node1.y, node1.x);
+
+			Real dR2 = sqrt(
+				node2.x * node2.x + node2.y * node2.y + node2.z * node2.z);
+			Real dLat2 = asin(node2.z / dR2);
+			Real dLon2 = atan2(node2.y, node2.x);
+
+			snprintf(szBuffer, sizeof(szBuffer),
+				"\nError detected (orientation):\n"
+				"  Face %i, Edge %i, Orientation %1.5e\n"
+				"  (x,y,z):\n"
+				"    n0: %1.5e %1.5e %1.5e\n"
+				"    n1: %1.5e %1.5e %1.5e\n"
+				"    n2: %1.5e %1.5e %1.5e\n"
+				"  (lambda, phi):\n"
+				"    n0: %1.5e %1.5e\n"
+				"    n1: %1.5e %1.5e\n"
+				"    n2: %1.5e %1.5e\n"
+				"  X-Product:\n"
+				"    %1.5e %1.5e %1.5e\n",
+				i, j, dDot,
+				node0.x, node0.y, node0.z,
+				node1.x, node1.y, node1.z,
+				node2.x, node2.y, node2.z,
+				dLon0, dLat0,
+				dLon1, dLat1,
+				dLon2, dLat2,
+				nodeCross.x, nodeCross.y, nodeCross.z);
+
+			strDetail = szBuffer;
+			strError =
+				"Mesh validation failed: Clockwise or concave face detected";
+			return false;
+		}
+	}
+
+	return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void Mesh::Validate(
+	int nThreads,
+	double dSampleFraction
+) const {
+	if (nThreads < 1) {
+		_EXCEPTIONT("Thread count must be at least 1");
+	}
+	if (!(dSampleFraction > 0.0) || (dSampleFraction > 1.0)) {
+		_EXCEPTION1("Validation sample fraction (%1.5e) must be in (0,1]",
+			dSampleFraction);
+	}
+
+	const int nNodes = static_cast<int>(nodes.size());
+	const int nFaces = static_cast<int>(faces.size());
+
+	// Nodes and Faces whose index hashes below this threshold are checked
+	const bool fSample = (dSampleFraction < 1.0);
+
+	const unsigned long long ullSampleThreshold =
+		static_cast<unsigned long long>(dSampleFraction * 4294967296.0);
 
-void Mesh::Validate() const {
+	// An error found by any thread stops the others early; the error of
+	// the lowest index is reported
+	OmpExceptionCapture capture;
+
+	int nSampledNodes = 0;
+	int nSampledFaces = 0;
 
 	// Valid that Nodes have magnitude 1
-	for (int i = 0; i < nodes.size(); i++) {
+#pragma omp parallel for reduction(+:nSampledNodes) num_threads(nThreads)
+	for (int i = 0; i < nNodes; i++) {
+		if (capture.HasError()) {
+			continue;
+		}
+		if (fSample &&
+		    (ValidateSampleHash(static_cast<unsigned int>(i)) >= ullSampleThreshold)
+		) {
+			continue;
+		}
+
+		nSampledNodes++;
+
 		double dMag = nodes[i].Magnitude();
 
 		if (fabs(dMag - 1.0) > ReferenceTolerance) {
-			_EXCEPTION5("Mesh validation failed: "
+			char szError[256];
+			snprintf(szError, sizeof(szError), "Mesh validation failed: "
 				"Node[%i] of non-unit magnitude detected (%1.10e, %1.10e, %1.10e) = %1.10e",
 				i, nodes[i].x, nodes[i].y, nodes[i].z, dMag);
-
+			capture.Capture(i, szError);
 		}
 	}
 
-	// Validate that edges are oriented counter-clockwise
-	for (int i = 0; i < faces.size(); i++) {
-		const Face & face = faces[i];
-
-		const int nEdges = face.edges.size();
-
-		for (int j = 0; j < nEdges; j++) {
-
-			// Check for zero edges
-			for(;;) {
-				if (face.edges[j][0] == face.edges[j][1]) {
-					j++;
-				} else {
-					break;
-				}
-				if (j == nEdges) {
-					break;
-				}
-			}
-
-			if (j == nEdges) {
-				break;
-			}
-
-			// Find the next non-zero edge
-			int jNext = (j + 1) % nEdges;
-
-			for(;;) {
-				if (face.edges[jNext][0] == face.edges[jNext][1]) {
-					jNext++;
-				} else {
-					break;
-				}
-				if (jNext == nEdges) {
-					jNext = 0;
-				}
-				if (jNext == ((j + 1) % nEdges)) {
-					_EXCEPTIONT("Mesh validation failed: "
-						"No edge information on Face");
-				}
-			}
-
-			// Get edges
-			const Edge & edge0 = face.edges[j];
-			const Edge & edge1 = face.edges[(j + 1) % nEdges];
-
-			if (edge0[1] != edge1[0]) {
-				_EXCEPTIONT("Mesh validation failed: Edge cyclicity error");
-			}
+	capture.Rethrow();
 
-			const Node & node0 = nodes[edge0[0]];
-			const Node & node1 = nodes[edge0[1]];
-			const Node & node2 = nodes[edge1[1]];
+	// Validate that edges are oriented counter-clockwise
+#pragma omp parallel for schedule(dynamic, 1024) reduction(+:nSampledFaces) num_threads(nThreads)
+	for (int i = 0; i < nFaces; i++) {
+		if (capture.HasError()) {
+			continue;
+		}
+		if (fSample &&
+		    (ValidateSampleHash(static_cast<unsigned int>(i)) >= ullSampleThreshold)
+		) {
+			continue;
+		}
 
-			// Vectors along edges
-			Node nodeD1 = node0 - node1;
-			Node nodeD2 = node2 - node1;
+		nSampledFaces++;
 
-			// Compute cross-product
-			Node nodeCross(CrossProduct(nodeD1, nodeD2));
+		std::string strFaceError;
+		std::string strFaceDetail;
 
-			// Dot cross product with radial vector
-			Real dDot = DotProduct(node1, nodeCross);
-/*
-#ifdef USE_EXACT_ARITHMETIC
-			FixedPoint dDotX = DotProductX(node1, nodeCross);
+		if (!ValidateFace(nodes, faces[i], i, strFaceError, strFaceDetail)) {
+			capture.Capture(i, strFaceError);
+		}
+	}
 
-			printf("%1.15e : ", nodeCross.x); nodeCross.fx.Print(); printf("\n");
+	// Details are only printed for the Face whose error is reported
+	if (capture.HasError()) {
+		const int i = capture.GetErrorIndex();
 
-			if (fabs(nodeCross.x - nodeCross.fx.ToReal()) > ReferenceTolerance) {
-				printf("X0: %1.15e : ", node0.x); node0.fx.Print(); printf("\n");
-				printf("Y0: %1.15e : ", node0.y); node0.fy.Print(); printf("\n");
-				printf("Z0: %1.15e : ", node0.z); node0.fz.Print(); printf("\n");
-				printf("X1: %1.15e : ", node1.x); node1.fx.Print(); printf("\n");
-				printf("Y1: %1.15e : ", node1.y); node1.fy.Print(); printf("\n");
-				printf("Z1: %1.15e : ", node1.z); node1.fz.Print(); printf("\n");
-				printf("X2: %1.15e : ", node2.x); node2.fx.Print(); printf("\n");
-				printf("Y2: %1.15e : ", node2.y); node2.fy.Print(); printf("\n");
-				printf("Z2: %1.15e : ", node2.z); node2.fz.Print(); printf("\n");
+		std::string strFaceError;
+		std::string strFaceDetail;
+		ValidateFace(nodes, faces[i], i, strFaceError, strFaceDetail);
 
-				printf("X1: %1.15e : ", nodeD1.x); nodeD1.fx.Print(); printf("\n");
-				printf("Y1: %1.15e : ", nodeD1.y); nodeD1.fy.Print(); printf("\n");
-				printf("Z1: %1.15e : ", nodeD1.z); nodeD1.fz.Print(); printf("\n");
-				printf("X2: %1.15e : ", nodeD2.x); nodeD2.fx.Print(); printf("\n");
-				printf("Y2: %1.15e : ", nodeD2.y); nodeD2.fy.Print(); printf("\n");
-				printf("Z2: %1.15e : ", nodeD2.z); nodeD2.fz.Print(); printf("\n");
-				_EXCEPTIONT("FixedPoint mismatch (X)");
-			}
-			if (fabs(nodeCross.y - nodeCross.fy.ToReal()) > ReferenceTolerance) {
-				_EXCEPTIONT("FixedPoint mismatch (Y)");
-			}
-			if (fabs(nodeCross.z - nodeCross.fz.ToReal()) > ReferenceTolerance) {
-				_EXCEPTIONT("FixedPoint mismatch (Z)");
-			}
+		if (strFaceDetail.length() != 0) {
+			printf("%s", strFaceDetail.c_str());
+		}
+	}
 
-#endif
-*/
-			if (dDot > 0.0) {
-				printf("\nError detected (orientation):\n");
-				printf("  Face %i, Edge %i, Orientation %1.5e\n",
-					i, j, dDot);
+	capture.Rethrow();
 
-				printf("  (x,y,z):\n");
-				printf("    n0: %1.5e %1.5e %1.5e\n", node0.x, node0.y, node0.z);
-				printf("    n1: %1.5e %1.5e %1.5e\n", node1.x, node1.y, node1.z);
-				printf("    n2: %1.5e %1.5e %1.5e\n", node2.x, node2.y, node2.z);
+	if (fSample) {
+		Announce("Validated a sample of %i/%i nodes and %i/%i faces",
+			nSampledNodes, nNodes, nSampledFaces, nFaces);
+	}
+}
 
-				Real dR0 = sqrt(
-					node0.x * node0.x + node0.y * node0.y + node0.z * node0.z);
-				Real dLat0 = asin(node0.z / dR0);
-				Real dLon0 = atan2(node0.y, node0.x);
+///////////////////////////////////////////////////////////////////////////////
+// General purpose functions
+///////////////////////////////////////////////////////////////////////////////
 
-				Real dR1 = sqrt(
-					node1.x * node1.x + node1.y * node1.y + node1.z * node1.z);
-				Real dLat1 = asin(node1.z / dR1);
-				Real dLon1 = atan2(node1.y, node1.x);
+void XYZtoRLL_Deg_Batch(
+	int nPoints,
+	const double * dX,
+	const double * dY,
+	const double * dZ,
+	double * dLon,
+	double * dLat
+) {
+#pragma omp simd
+	for (int k = 0; k < nPoints; k++) {
+		const bool fPole = !(fabs(dZ[k]) < 1.0 - ReferenceTolerance);
 
-				Real dR2 = sqrt(
-					node2.x * node2.x + node2.y * node2.y + node2.z * node2.z);
-				Real dLat2 = asin(node2.z / dR2);
-				Real dLon2 = atan2(node2.y, node2.x);
+		// Poles are evaluated away from the boundary of the domain of asin
+		// and then replaced
+		double dLonK = atan2(dY[k], dX[k]);
+		double dLatK = asin(fPole ? 0.0 : dZ[k]);
 
-				printf("  (lambda, phi):\n");
-				printf("    n0: %1.5e %1.5e\n", dLon0, dLat0);
-				printf("    n1: %1.5e %1.5e\n", dLon1, dLat1);
-				printf("    n2: %1.5e %1.5e\n", dLon2, dLat2);
+		dLonK = (dLonK < 0.0) ? (dLonK + 2.0 * M_PI) : dLonK;
 
-				printf("  X-Product:\n");
-				printf("    %1.5e %1.5e %1.5e\n",
-					nodeCross.x, nodeCross.y, nodeCross.z);
+		dLonK = dLonK / M_PI * 180.0;
+		dLatK = dLatK / M_PI * 180.0;
 
-				_EXCEPTIONT(
-					"Mesh validation failed: Clockwise or concave face detected");
-			}
-		}
+		dLon[k] = fPole ? 0.0 : dLonK;
+		dLat[k] = fPole ? ((dZ[k] > 0.0) ? 90.0 : -90.0) : dLatK;
 	}
 }
 
-///////////////////////////////////////////////////////////////////////////////
-// General purpose functions
 ///////////////////////////////////////////////////////////////////////////////
 
 bool IsPositivelyOrientedEdge(
@@ -1677,23 +3630,29 @@ void GetLocalDirection(
 
 void EqualizeCoincidentNodes(
 	const Mesh & meshFirst,
-	Mesh & meshSecond
+	Mesh & meshSecond,
+	int nThreads
 ) {
-	// Sort nodes
-	std::map<Node, int> setSortedFirstNodes;
-	for (int i = 0; i < meshFirst.nodes.size(); i++) {
-		setSortedFirstNodes.insert(
-			std::pair<Node, int>(meshFirst.nodes[i], i));
+	if (nThreads < 1) {
+		_EXCEPTIONT("Thread count must be at least 1");
 	}
 
+	// Bin nodes
+	node_bins_3d<Node> binsFirstNodes(
+		meshFirst.nodes, ReferenceTolerance, MESH_NODE_HASH_CELL_WIDTH, nThreads);
+
 	// For each node in meshSecond determine if a corresponding node
 	// exists in meshFirst.
-	for (int i = 0; i < meshSecond.nodes.size(); i++) {
-		std::map<Node, int>::const_iterator iter =
-			setSortedFirstNodes.find(meshSecond.nodes[i]);
+	const int nSecondNodes = static_cast<int>(meshSecond.nodes.size());
 
-		if (iter != setSortedFirstNodes.end()) {
-			meshSecond.nodes[i] = iter->first;
+#pragma omp parallel for schedule(dynamic, 4096) num_threads(nThreads)
+	for (int i = 0; i < nSecondNodes; i++) {
+		size_t ixFirst =
+			binsFirstNodes.find_first(
+				meshSecond.nodes[i], meshFirst.nodes.size());
+
+		if (ixFirst != meshFirst.nodes.size()) {
+			meshSecond.nodes[i] = meshFirst.nodes[ixFirst];
 		}
 	}
 }
@@ -1728,28 +3687,34 @@ void EqualizeCoincidentNodes(
 int BuildCoincidentNodeVector(
 	const Mesh & meshFirst,
 	const Mesh & meshSecond,
-	std::vector<int> & vecSecondToFirstCoincident
+	std::vector<int> & vecSecondToFirstCoincident,
+	int nThreads
 ) {
+	if (nThreads < 1) {
+		_EXCEPTIONT("Thread count must be at least 1");
+	}
+
 	int nCoincidentNodes = 0;
 
-	// Sort nodes
-	std::map<Node, int> setSortedFirstNodes;
-	for (int i = 0; i < meshFirst.nodes.size(); i++) {
-		setSortedFirstNodes.insert(
-			std::pair<Node, int>(meshFirst.nodes[i], i));
-	}
+	// Bin nodes
+	node_bins_3d<Node> binsFirstNodes(
+		meshFirst.nodes, ReferenceTolerance, MESH_NODE_HASH_CELL_WIDTH, nThreads);
 
 	// Resize array
 	vecSecondToFirstCoincident.resize(meshSecond.nodes.size(), InvalidNode);
 
 	// For each node in meshSecond determine if a corresponding node
 	// exists in meshFirst.
-	for (int i = 0; i < meshSecond.nodes.size(); i++) {
-		std::map<Node, int>::const_iterator iter =
-			setSortedFirstNodes.find(meshSecond.nodes[i]);
+	const int nSecondNodes = static_cast<int>(meshSecond.nodes.size());
 
-		if (iter != setSortedFirstNodes.end()) {
-			vecSecondToFirstCoincident[i] = iter->second;
+#pragma omp parallel for schedule(dynamic, 4096) reduction(+:nCoincidentNodes) num_threads(nThreads)
+	for (int i = 0; i < nSecondNodes; i++) {
+		size_t ixFirst =
+			binsFirstNodes.find_first(
+				meshSecond.nodes[i], meshFirst.nodes.size());
+
+		if (ixFirst != meshFirst.nodes.size()) {
+			vecSecondToFirstCoincident[i] = static_cast<int>(ixFirst);
 			nCoincidentNodes++;
 		}
 	}
@@ -1759,17 +3724,33 @@ int BuildCoincidentNodeVector(
 
 ///////////////////////////////////////////////////////////////////////////////
 
+///	<summary>
+///		Number of Gaussian quadrature points in each direction used to
+///		integrate the area of each sub-triangle of a Face.
+///	</summary>
+static const int FaceAreaQuadratureOrder = 6;
+
+///	<summary>
+///		Number of Faces processed together by the batched Face area kernel.
+///	</summary>
+static const int FaceAreaBatchSize = 64;
+
+///////////////////////////////////////////////////////////////////////////////
+
 Real CalculateFaceAreaQuadratureMethod(
 	const Face & face,
 	const NodeVector & nodes
 ) {
 	int nTriangles = face.edges.size() - 2;
 
-	const int nOrder = 6;
+	const int nOrder = FaceAreaQuadratureOrder;
+
+	// Initialized once; avoids entering the cache lock for every Face
+	static const GaussQuadrature::Points & s_points =
+		GaussQuadrature::GetCachedPoints(nOrder, 0.0, 1.0);
 
-	DataArray1D<double> dG;
-	DataArray1D<double> dW;
-	GaussQuadrature::GetPoints(nOrder, 0.0, 1.0, dG, dW);
+	const DataArray1D<double> & dG = s_points.dG;
+	const DataArray1D<double> & dW = s_points.dW;
 
 	double dFaceArea = 0.0;
 
@@ -1864,6 +3845,189 @@ Real CalculateFaceAreaQuadratureMethod(
 
 ///////////////////////////////////////////////////////////////////////////////
 
+///	<summary>
+///		One sub-triangle from each of a batch of Faces, stored with one
+///		array per coordinate so that the quadrature can be evaluated
+///		across Faces in SIMD lanes.
+///	</summary>
+struct FaceAreaBatch {
+	int nLanes;
+	int ixFace[FaceAreaBatchSize];
+
+	double dX1[FaceAreaBatchSize];
+	double dY1[FaceAreaBatchSize];
+	double dZ1[FaceAreaBatchSize];
+
+	double dX2[FaceAreaBatchSize];
+	double dY2[FaceAreaBatchSize];
+	double dZ2[FaceAreaBatchSize];
+
+	double dX3[FaceAreaBatchSize];
+	double dY3[FaceAreaBatchSize];
+	double dZ3[FaceAreaBatchSize];
+
+	double dArea[FaceAreaBatchSize];
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Add the quadrature contribution of each sub-triangle in the batch
+///		to dArea.  The arithmetic matches CalculateFaceAreaQuadratureMethod
+///		term by term so that both produce identical areas.
+///	</summary>
+static void AccumulateFaceAreaBatch(
+	FaceAreaBatch & batch,
+	const DataArray1D<double> & dG,
+	const DataArray1D<double> & dW
+) {
+	const int nOrder = dW.GetRows();
+	const int nLanes = batch.nLanes;
+
+	for (int p = 0; p < nOrder; p++) {
+	for (int q = 0; q < nOrder; q++) {
+
+		const double dA = dG[p];
+		const double dB = dG[q];
+		const double dWeight = dW[p] * dW[q];
+
+#pragma omp simd
+		for (int k = 0; k < nLanes; k++) {
+			const double dX1 = batch.dX1[k];
+			const double dY1 = batch.dY1[k];
+			const double dZ1 = batch.dZ1[k];
+			const double dX2 = batch.dX2[k];
+			const double dY2 = batch.dY2[k];
+			const double dZ2 = batch.dZ2[k];
+			const double dX3 = batch.dX3[k];
+			const double dY3 = batch.dY3[k];
+			const double dZ3 = batch.dZ3[k];
+
+			const double dFx = (1.0 - dB) * ((1.0 - dA) * dX1 + dA * dX2) + dB * dX3;
+			const double dFy = (1.0 - dB) * ((1.0 - dA) * dY1 + dA * dY2) + dB * dY3;
+			const double dFz = (1.0 - dB) * ((1.0 - dA) * dZ1 + dA * dZ2) + dB * dZ3;
+
+			const double dDaFx = (1.0 - dB) * (dX2 - dX1);
+			const double dDaFy = (1.0 - dB) * (dY2 - dY1);
+			const double dDaFz = (1.0 - dB) * (dZ2 - dZ1);
+
+			const double dDbFx = - (1.0 - dA) * dX1 - dA * dX2 + dX3;
+			const double dDbFy = - (1.0 - dA) * dY1 - dA * dY2 + dY3;
+			const double dDbFz = - (1.0 - dA) * dZ1 - dA * dZ2 + dZ3;
+
+			const double dR = sqrt(dFx * dFx + dFy * dFy + dFz * dFz);
+
+			const double dDenomTerm = 1.0 / (dR * dR * dR);
+
+			const double dDaGx = (dDaFx * (dFy * dFy + dFz * dFz)
+				- dFx * (dDaFy * dFy + dDaFz * dFz)) * dDenomTerm;
+			const double dDaGy = (dDaFy * (dFx * dFx + dFz * dFz)
+				- dFy * (dDaFx * dFx + dDaFz * dFz)) * dDenomTerm;
+			const double dDaGz = (dDaFz * (dFx * dFx + dFy * dFy)
+				- dFz * (dDaFx * dFx + dDaFy * dFy)) * dDenomTerm;
+
+			const double dDbGx = (dDbFx * (dFy * dFy + dFz * dFz)
+				- dFx * (dDbFy * dFy + dDbFz * dFz)) * dDenomTerm;
+			const double dDbGy = (dDbFy * (dFx * dFx + dFz * dFz)
+				- dFy * (dDbFx * dFx + dDbFz * dFz)) * dDenomTerm;
+			const double dDbGz = (dDbFz * (dFx * dFx + dFy * dFy)
+				- dFz * (dDbFx * dFx + dDbFy * dFy)) * dDenomTerm;
+
+			const double dCrossX = dDaGy * dDbGz - dDaGz * dDbGy;
+			const double dCrossY = dDaGz * dDbGx - dDaGx * dDbGz;
+			const double dCrossZ = dDaGx * dDbGy - dDaGy * dDbGx;
+
+			const double dJacobian = sqrt(
+				  dCrossX * dCrossX
+				+ dCrossY * dCrossY
+				+ dCrossZ * dCrossZ);
+
+			batch.dArea[k] += dWeight * dJacobian;
+		}
+	}
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void CalculateFaceAreasQuadratureMethod(
+	const FaceVector & faces,
+	const NodeVector & nodes,
+	DataArray1D<double> & vecFaceArea,
+	int nThreads
+) {
+	if (nThreads < 1) {
+		_EXCEPTIONT("Thread count must be at least 1");
+	}
+
+	const int nFaces = static_cast<int>(faces.size());
+
+	vecFaceArea.Allocate(nFaces);
+
+	const GaussQuadrature::Points & points =
+		GaussQuadrature::GetCachedPoints(FaceAreaQuadratureOrder, 0.0, 1.0);
+
+	const int nBatches = (nFaces + FaceAreaBatchSize - 1) / FaceAreaBatchSize;
+
+#pragma omp parallel num_threads(nThreads)
+	{
+		FaceAreaBatch batch;
+
+#pragma omp for schedule(dynamic)
+		for (int b = 0; b < nBatches; b++) {
+			const int ixBegin = b * FaceAreaBatchSize;
+			const int ixEnd = std::min(ixBegin + FaceAreaBatchSize, nFaces);
+
+			// Sub-triangle j of every Face that has one, accumulated into
+			// the running area of that Face in the same order as the
+			// scalar method
+			for (int j = 0; ; j++) {
+				batch.nLanes = 0;
+
+				for (int i = ixBegin; i < ixEnd; i++) {
+					const Face & face = faces[i];
+
+					if (static_cast<int>(face.edges.size()) - 2 <= j) {
+						continue;
+					}
+
+					const Node & node1 = nodes[face[0]];
+					const Node & node2 = nodes[face[j+1]];
+					const Node & node3 = nodes[face[j+2]];
+
+					const int k = batch.nLanes;
+
+					batch.ixFace[k] = i;
+					batch.dX1[k] = node1.x;
+					batch.dY1[k] = node1.y;
+					batch.dZ1[k] = node1.z;
+					batch.dX2[k] = node2.x;
+					batch.dY2[k] = node2.y;
+					batch.dZ2[k] = node2.z;
+					batch.dX3[k] = node3.x;
+					batch.dY3[k] = node3.y;
+					batch.dZ3[k] = node3.z;
+					batch.dArea[k] = vecFaceArea[i];
+
+					batch.nLanes++;
+				}
+
+				if (batch.nLanes == 0) {
+					break;
+				}
+
+				AccumulateFaceAreaBatch(batch, points.dG, points.dW);
+
+				for (int k = 0; k < batch.nLanes; k++) {
+					vecFaceArea[batch.ixFace[k]] = batch.dArea[k];
+				}
+			}
+		}
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
 Real CalculateFaceAreaKarneysMethod(
 	const Face & face,
 	const NodeVector & nodes
@@ -2042,42 +4206,104 @@ Real CalculateFaceArea(
 
 ///////////////////////////////////////////////////////////////////////////////
 
-bool ConvexifyFace(
-	Mesh & mesh,
-	Mesh & meshout,
-	int iFace,
-	bool fRemoveConcaveFaces,
-	bool fVerbose
-)
-{
-	Face & face = mesh.faces[iFace];
-	const int nNodes = face.edges.size()-1;
-	if(fVerbose) {
-		Announce("ConvexifyFace via Triangle package");
-		Announce("iFace=%i	nNodes: %i", iFace, nNodes);
+///	<summary>
+///		Number of distinct nodes on the boundary of a Face.  Polygons read
+///		from shapefiles repeat the first node at the end of the ring, and
+///		this closing node is not counted.
+///	</summary>
+static int GetFaceRingNodeCount(
+	const Face & face,
+	const NodeVector & nodes
+) {
+	int nNodes = static_cast<int>(face.edges.size());
+	if ((nNodes > 1) &&
+		((face[nNodes-1] == face[0]) ||
+		 ((nodes[face[nNodes-1]].x == nodes[face[0]].x) &&
+		  (nodes[face[nNodes-1]].y == nodes[face[0]].y) &&
+		  (nodes[face[nNodes-1]].z == nodes[face[0]].z)))
+	) {
+		nNodes--;
 	}
+	return nNodes;
+}
+
+///////////////////////////////////////////////////////////////////////////////
 
+///	<summary>
+///		Buffers for the Triangle package, reused across Faces.
+///	</summary>
+struct ConvexifyWorkspace {
+
+	///	<summary>
+	///		Input points in the tangent plane and boundary segments.
+	///	</summary>
+	std::vector<REAL> vecPointList;
+	std::vector<int> vecSegmentList;
+};
+
+///	<summary>
+///		Triangulation of one concave Face.  Triangle vertices less than the
+///		number of ring nodes refer to the Face nodes, and the remaining
+///		vertices refer to vecNewNodes.
+///	</summary>
+struct ConvexifiedFace {
+
+	///	<summary>
+	///		Nodes added in the interior of the Face.
+	///	</summary>
+	NodeVector vecNewNodes;
+
+	///	<summary>
+	///		Vertices of the triangles, three per triangle.
+	///	</summary>
+	std::vector<int> vecTriangles;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Triangulate the first nNodes nodes of face with the Triangle package
+///		in the tangent plane at the Face center.  No nodes are added on the
+///		boundary of the Face.
+///	</summary>
+static void TriangulateFace(
+	const Face & face,
+	int nNodes,
+	const NodeVector & nodes,
+	bool fVerbose,
+	ConvexifyWorkspace & workspace,
+	ConvexifiedFace & result
+) {
 	// get center of this face and the local up vector, Z
 	Node center(0,0,0);
-	for (int i=0; i<nNodes; ++i) center = center + mesh.nodes[face[i]];
+	for (int i=0; i<nNodes; ++i) center = center + nodes[face[i]];
 	center = center / nNodes;
 	Node localZ = center.Normalized();
 
 	// construct tangent space X and Y unit vectors
-	Node node0 =(mesh.nodes[face[0]]- center).Normalized();
+	Node node0 =(nodes[face[0]]- center).Normalized();
 	Node localY = CrossProduct(localZ,node0);
 	Node localX = CrossProduct(localY,localZ);
 
-	// get orthographic projection of nodes onto the tangent plane
-	NodeVector planarNodes;
+	// fill in 2d point list with the orthographic projection of nodes
+	// onto the tangent plane, and the segment list
+	workspace.vecPointList.resize(nNodes * 2);
+	workspace.vecSegmentList.resize(nNodes * 2);
+
 	for (int i=0; i<nNodes; ++i) {
-		Node node3D = mesh.nodes[face[i]];
-		Node node2D( DotProduct(node3D,localX), DotProduct(node3D,localY), 0);
-		planarNodes.push_back(node2D);
+		const Node & node3D = nodes[face[i]];
+		workspace.vecPointList[i*2+0] = DotProduct(node3D,localX);
+		workspace.vecPointList[i*2+1] = DotProduct(node3D,localY);
+
+		workspace.vecSegmentList[i*2+0] = i;
+		workspace.vecSegmentList[i*2+1] = (i+1)%nNodes;
 	}
 
 	// fill in triangleio data structures
 	struct triangulateio in, out, vorout;
+	memset(&in, 0, sizeof(struct triangulateio));
+	memset(&out, 0, sizeof(struct triangulateio));
+	memset(&vorout, 0, sizeof(struct triangulateio));
 
 	// initialize data structure for input planar straight-line graph (PSLG)
 	in.numberofpoints           = nNodes;
@@ -2085,91 +4311,113 @@ bool ConvexifyFace(
 	in.numberofsegments         = nNodes;
 	in.numberofholes            = 0;
 	in.numberofregions          = 0;
-	in.pointlist                = (REAL *) malloc(in.numberofpoints * 2 * sizeof(REAL));
-	in.segmentlist              = (int  *) malloc(in.numberofsegments * 2 * sizeof(int));;
-	in.pointattributelist       = (REAL *) NULL;
-	in.pointmarkerlist          = (int  *) NULL;
-	in.trianglelist             = (int  *) NULL;
-	in.triangleattributelist    = (REAL *) NULL;
-	in.neighborlist             = (int  *) NULL;
-	in.segmentmarkerlist        = (int  *) NULL;
-	in.edgelist                 = (int  *) NULL;
-	in.edgemarkerlist           = (int  *) NULL;
-
-	// initialize data structure for output triangulation
-	out.pointlist               = (REAL *) NULL;
-	out.pointattributelist      = (REAL *) NULL;
-	out.pointmarkerlist         = (int  *) NULL;
-	out.trianglelist            = (int  *) NULL;
-	out.triangleattributelist   = (REAL *) NULL;
-	out.neighborlist            = (int  *) NULL;
-	out.segmentlist             = (int  *) NULL;
-	out.segmentmarkerlist       = (int  *) NULL;
-	out.edgelist                = (int  *) NULL;
-	out.edgemarkerlist          = (int  *) NULL;
-
-	// initialize data structure for output Voronoi diagram (unused)
-	vorout.pointlist            = (REAL *) NULL;
-	vorout.pointattributelist   = (REAL *) NULL;
-	vorout.edgelist             = (int  *) NULL;
-	vorout.normlist             = (REAL *) NULL;
-
-	// fill in 2d point list
-	for(int i=0; i<nNodes; ++i) {
-		Node n = planarNodes[i];
-		in.pointlist[i*2+0] = n.x;
-		in.pointlist[i*2+1] = n.y;
-	}
-
-	// fill in segment list
-	for(int i=0; i<nNodes; ++i) {
-		Node n = planarNodes[i];
-		in.segmentlist[i*2+0] = i;
-		in.segmentlist[i*2+1] = (i+1)%nNodes;
-	}
+	in.pointlist                = &(workspace.vecPointList[0]);
+	in.segmentlist              = &(workspace.vecSegmentList[0]);
 
 	// set options for triangulate function call:
 	// p   -> triangulate area in the boundary (PSLG)
 	// q5  -> set min triangle angle to 5dg
-	// j   -> jettison unused nodes
 	// z   -> number nodes starting from zero
 	// Y   -> no new nodes on the boundary (so it remains conforming)
 	// Q,V -> quiet or verbose output
+	//
+	// Unused nodes are not jettisoned, so the input nodes are the first
+	// nNodes output nodes.
 
 	if (fVerbose) {
-		char options[256] ="pq5jzYV";
+		char options[256] ="pq5zYV";
 		triangulate(options, &in, &out, &vorout);
 	}
 	else {
-		char options[256] ="pq5jzYQ";
+		char options[256] ="pq5zYQ";
 		triangulate(options, &in, &out, &vorout);
 	}
 
-	// project new planar nodes onto the unit sphere
-	NodeVector newNodes;
+	// the input nodes are reused and new planar nodes are projected onto
+	// the unit sphere
+	std::vector<int> vecVertexIx(out.numberofpoints);
+
+	result.vecNewNodes.clear();
 	for (int i=0; i<out.numberofpoints; ++i) {
+		if ((i < nNodes) &&
+			(out.pointlist[2*i] == workspace.vecPointList[2*i]) &&
+			(out.pointlist[2*i+1] == workspace.vecPointList[2*i+1])
+		) {
+			vecVertexIx[i] = i;
+			continue;
+		}
+
 		Node n(out.pointlist[2*i], out.pointlist[2*i+1],0.0);
 		Real z = sqrt(1.0 - n.x*n.x - n.y*n.y);
 		Node node3D = localZ * z + (localX * n.x) + (localY * n.y);
 		node3D = node3D.Normalized();
-		newNodes.push_back(node3D);
+
+		vecVertexIx[i] = nNodes + static_cast<int>(result.vecNewNodes.size());
+		result.vecNewNodes.push_back(node3D);
+	}
+
+	// new triangles
+	result.vecTriangles.resize(out.numberoftriangles * 3);
+	for (int i=0; i<out.numberoftriangles * 3; ++i) {
+		result.vecTriangles[i] = vecVertexIx[out.trianglelist[i]];
+	}
+
+	// release arrays allocated by Triangle
+	trifree((VOID *) out.pointlist);
+	trifree((VOID *) out.pointattributelist);
+	trifree((VOID *) out.pointmarkerlist);
+	trifree((VOID *) out.trianglelist);
+	trifree((VOID *) out.triangleattributelist);
+	trifree((VOID *) out.neighborlist);
+	trifree((VOID *) out.segmentlist);
+	trifree((VOID *) out.segmentmarkerlist);
+	trifree((VOID *) out.edgelist);
+	trifree((VOID *) out.edgemarkerlist);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+bool ConvexifyFace(
+	Mesh & mesh,
+	Mesh & meshout,
+	int iFace,
+	bool fRemoveConcaveFaces,
+	bool fVerbose
+)
+{
+	Face face = mesh.faces[iFace];
+	const int nNodes = GetFaceRingNodeCount(face, mesh.nodes);
+	if(fVerbose) {
+		Announce("ConvexifyFace via Triangle package");
+		Announce("iFace=%i	nNodes: %i", iFace, nNodes);
 	}
 
+	ConvexifyWorkspace workspace;
+	ConvexifiedFace result;
+
+	TriangulateFace(face, nNodes, mesh.nodes, fVerbose, workspace, result);
+
 	// delete concave face from the mesh
 	if (fRemoveConcaveFaces) {
 		mesh.faces.erase(mesh.faces.begin() + iFace);
 	}
 
-	// append new nodes to end of node vector
+	// append face nodes and new nodes to end of node vector
 	int size = meshout.nodes.size();
-	meshout.nodes.insert(meshout.nodes.end(), newNodes.begin(), newNodes.end());
+	for (int i=0; i<nNodes; ++i) {
+		meshout.nodes.push_back(mesh.nodes[face[i]]);
+	}
+	meshout.nodes.insert(
+		meshout.nodes.end(),
+		result.vecNewNodes.begin(),
+		result.vecNewNodes.end());
 
 	// add new triangles to the mesh
-	for (int i=0; i<out.numberoftriangles; ++i) {
+	for (int i=0; i<result.vecTriangles.size(); i+=3) {
 		Face newFace(3);
-		newFace.SetNode(0, size+out.trianglelist[i*3+0]);
-		newFace.SetNode(1, size+out.trianglelist[i*3+1]);
-		newFace.SetNode(2, size+out.trianglelist[i*3+2]);
+		newFace.SetNode(0, size+result.vecTriangles[i+0]);
+		newFace.SetNode(1, size+result.vecTriangles[i+1]);
+		newFace.SetNode(2, size+result.vecTriangles[i+2]);
 		meshout.faces.push_back(newFace);
 	}
 
@@ -2433,31 +4681,181 @@ bool ConvexifyFaceBayazit(
 
 ///////////////////////////////////////////////////////////////////////////////
 
-void ConvexifyMesh(
-	Mesh & mesh,
-	bool fVerbose
+///	<summary>
+///		Detect the concave Faces of a Mesh and triangulate them in
+///		parallel.  vecRingNodes receives the number of distinct boundary
+///		nodes of each Face, vecConcaveIx the indices of the concave Faces
+///		in ascending order and vecConvexified their triangulations.
+///	</summary>
+static void TriangulateConcaveFaces(
+	const Mesh & mesh,
+	std::vector<int> & vecRingNodes,
+	std::vector<int> & vecConcaveIx,
+	std::vector<ConvexifiedFace> & vecConvexified,
+	bool fVerbose,
+	int nThreads
 ) {
-	char szBuffer[256];
+	if (nThreads < 1) {
+		_EXCEPTIONT("Thread count must be at least 1");
+	}
 
-	// Loop through all Faces in the Mesh
-	int nFaces = mesh.faces.size();
+	const int nFaces = static_cast<int>(mesh.faces.size());
+
+	// Identify concave faces
+	vecRingNodes.resize(nFaces);
+	std::vector<char> vecConcave(nFaces, 0);
+
+#pragma omp parallel for schedule(dynamic, 1024) num_threads(nThreads)
 	for (int f = 0; f < nFaces; f++) {
-		if (fVerbose) {
-			sprintf(szBuffer, "Face %i", f);
-			AnnounceStartBlock(szBuffer);
+		const Face & face = mesh.faces[f];
+
+		int nNodes = GetFaceRingNodeCount(face, mesh.nodes);
+		vecRingNodes[f] = nNodes;
+
+		if (nNodes <= 3) {
+			continue;
+		}
+		if (nNodes == face.edges.size()) {
+			vecConcave[f] = IsFaceConcave(face, mesh.nodes);
+		} else {
+			Face faceRing(nNodes);
+			for (int i = 0; i < nNodes; i++) {
+				faceRing.SetNode(i, face[i]);
+			}
+			vecConcave[f] = IsFaceConcave(faceRing, mesh.nodes);
 		}
+	}
 
-		// Adjust current Face index
-		bool fConcaveFace = ConvexifyFace(mesh, mesh, f, true, fVerbose);
-		if (fConcaveFace) {
-			f--;
-			nFaces--;
+	vecConcaveIx.clear();
+	for (int f = 0; f < nFaces; f++) {
+		if (vecConcave[f]) {
+			vecConcaveIx.push_back(f);
 		}
+	}
 
-		if (fVerbose) {
-			AnnounceEndBlock("Done");
+	if (fVerbose) {
+		Announce("%i of %i faces are concave", vecConcaveIx.size(), nFaces);
+	}
+
+	// Triangulate concave faces
+	const int nConcave = static_cast<int>(vecConcaveIx.size());
+
+	vecConvexified.resize(nConcave);
+
+#pragma omp parallel num_threads(nThreads)
+	{
+		ConvexifyWorkspace workspace;
+
+#pragma omp for schedule(dynamic, 16)
+		for (int i = 0; i < nConcave; i++) {
+			const int f = vecConcaveIx[i];
+			TriangulateFace(
+				mesh.faces[f], vecRingNodes[f], mesh.nodes,
+				false, workspace, vecConvexified[i]);
+		}
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Append a Face with its first nNodes nodes.
+///	</summary>
+static void AppendRingFace(
+	const Face & face,
+	int nNodes,
+	FaceVector & faces
+) {
+	if (nNodes == face.edges.size()) {
+		faces.push_back(face);
+		return;
+	}
+
+	Face faceRing(nNodes);
+	for (int i = 0; i < nNodes; i++) {
+		faceRing.SetNode(i, face[i]);
+	}
+	faces.push_back(faceRing);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Append the triangles of a convexified Face, whose new nodes begin
+///		at index ixNewNodeBegin.
+///	</summary>
+static void AppendConvexifiedFace(
+	const Face & face,
+	int nNodes,
+	const ConvexifiedFace & convexified,
+	int ixNewNodeBegin,
+	FaceVector & faces
+) {
+	for (int i = 0; i < convexified.vecTriangles.size(); i += 3) {
+		Face faceNew(3);
+		for (int k = 0; k < 3; k++) {
+			int ix = convexified.vecTriangles[i+k];
+			if (ix < nNodes) {
+				faceNew.SetNode(k, face[ix]);
+			} else {
+				faceNew.SetNode(k, ixNewNodeBegin + ix - nNodes);
+			}
+		}
+		faces.push_back(faceNew);
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void ConvexifyMesh(
+	Mesh & mesh,
+	bool fVerbose,
+	int nThreads
+) {
+	std::vector<int> vecRingNodes;
+	std::vector<int> vecConcaveIx;
+	std::vector<ConvexifiedFace> vecConvexified;
+
+	TriangulateConcaveFaces(
+		mesh, vecRingNodes, vecConcaveIx, vecConvexified,
+		fVerbose, nThreads);
+
+	if (vecConcaveIx.size() == 0) {
+		return;
+	}
+
+	// Convex faces retain their order and are followed by the triangles
+	// of each concave face in order
+	const int nFaces = static_cast<int>(mesh.faces.size());
+
+	FaceVector facesNew;
+	facesNew.reserve(nFaces);
+
+	for (int f = 0, i = 0; f < nFaces; f++) {
+		if ((i < vecConcaveIx.size()) && (vecConcaveIx[i] == f)) {
+			i++;
+			continue;
 		}
+		AppendRingFace(mesh.faces[f], vecRingNodes[f], facesNew);
 	}
+
+	for (int i = 0; i < vecConcaveIx.size(); i++) {
+		const int f = vecConcaveIx[i];
+
+		AppendConvexifiedFace(
+			mesh.faces[f], vecRingNodes[f], vecConvexified[i],
+			static_cast<int>(mesh.nodes.size()), facesNew);
+
+		mesh.nodes.insert(
+			mesh.nodes.end(),
+			vecConvexified[i].vecNewNodes.begin(),
+			vecConvexified[i].vecNewNodes.end());
+	}
+
+	mesh.faces.swap(facesNew);
+
+	// clean up duplicate nodes on the boundaries of faces
+	mesh.RemoveCoincidentNodes(nThreads);
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -2465,12 +4863,19 @@ void ConvexifyMesh(
 void ConvexifyMesh(
 	Mesh & mesh,
 	Mesh & meshout,
-	bool fVerbose
+	bool fVerbose,
+	int nThreads
 ) {
-	char szBuffer[256];
+	std::vector<int> vecRingNodes;
+	std::vector<int> vecConcaveIx;
+	std::vector<ConvexifiedFace> vecConvexified;
+
+	TriangulateConcaveFaces(
+		mesh, vecRingNodes, vecConcaveIx, vecConvexified,
+		fVerbose, nThreads);
 
 	// Copy all nodes to output mesh
-	meshout.nodes.clear();
+	meshout.nodes = mesh.nodes;
 
 	// Remove all Faces from output mesh
 	meshout.faces.clear();
@@ -2478,38 +4883,38 @@ void ConvexifyMesh(
 	// Clear the MultiFaceMap
 	meshout.vecMultiFaceMap.clear();
 
-	// Loop through all Faces in the input Mesh
-	int nFaces = mesh.faces.size();
-	for (int f = 0; f < nFaces; f++) {
-		if (fVerbose) {
-			sprintf(szBuffer, "Face %i", f);
-			AnnounceStartBlock(szBuffer);
-		}
+	// Each face is replaced by its triangles if concave
+	const int nFaces = static_cast<int>(mesh.faces.size());
 
-		// Adjust current Face index
-		int nMeshSize = meshout.faces.size();
+	meshout.faces.reserve(nFaces);
+	meshout.vecMultiFaceMap.reserve(nFaces);
 
-		bool fConcaveFace = ConvexifyFace(mesh, meshout, f, false, fVerbose);
+	for (int f = 0, i = 0; f < nFaces; f++) {
+		if ((i < vecConcaveIx.size()) && (vecConcaveIx[i] == f)) {
+			AppendConvexifiedFace(
+				mesh.faces[f], vecRingNodes[f], vecConvexified[i],
+				static_cast<int>(meshout.nodes.size()), meshout.faces);
 
-		if (fConcaveFace) {
-			int nAddedFaces = meshout.faces.size() - nMeshSize;
-			for (int i = 0; i < nAddedFaces; i++) {
-				meshout.vecMultiFaceMap.push_back(f);
-			}
+			meshout.nodes.insert(
+				meshout.nodes.end(),
+				vecConvexified[i].vecNewNodes.begin(),
+				vecConvexified[i].vecNewNodes.end());
+
+			i++;
 
 		} else {
-			meshout.faces.push_back(mesh.faces[f]);
-			meshout.vecMultiFaceMap.push_back(f);
+			AppendRingFace(mesh.faces[f], vecRingNodes[f], meshout.faces);
 		}
 
-		if (fVerbose) {
-			AnnounceEndBlock("Done");
-		}
+		meshout.vecMultiFaceMap.resize(meshout.faces.size(), f);
 	}
 
 	if (meshout.vecMultiFaceMap.size() != meshout.faces.size()) {
 		_EXCEPTIONT("Logic error");
 	}
+
+	// clean up duplicate nodes on the boundaries of faces
+	meshout.RemoveCoincidentNodes(nThreads);
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -25,15 +25,17 @@
 #include <set>
 #include <map>
 #include <string>
+#include <utility>
 #include <cmath>
 #include <cassert>
 
-#if defined(OVERLAPMESH_USE_UNSORTED_MAP)
+#if defined(OVERLAPMESH_USE_UNSORTED_MAP) || defined(EDGEMAP_USE_UNSORTED_MAP)
 #include <unordered_map>
 #endif
 #if defined(OVERLAPMESH_USE_NODE_MULTIMAP)
 #include "node_multimap_3d.h"
 #endif
+#include "node_hash_3d.h"
 
 #include "Exception.h"
 #include "DataArray1D.h"
@@ -77,26 +79,6 @@ public:
 		z(_z)
 	{ }
 
-	///	<summary>
-	///		Copy constructor.
-	///	</summary>
-	Node(const Node & node) {
-		x = node.x;
-		y = node.y;
-		z = node.z;
-	}
-
-	///	<summary>
-	///		Assignment operator.
-	///	</summary>
-	const Node & operator=(const Node & node) {
-		x = node.x;
-		y = node.y;
-		z = node.z;
-
-		return (*this);
-	}
-
 	///	<summary>
 	///		Comparator operator using floating point tolerance.
 	///	</summary>
@@ -235,6 +217,10 @@ typedef std::map<Node, int> NodeMap;
 typedef node_multimap_3d<Node, int> NodeMap;
 #endif
 
+#if defined(OVERLAPMESH_USE_NODE_HASH)
+typedef node_hash_3d<Node, int> NodeMap;
+#endif
+
 #if defined(OVERLAPMESH_USE_UNSORTED_MAP)
 ///	<summary>
 ///		Hasher for a Node.
@@ -328,12 +314,6 @@ public:
 		type = _type;
 	}
 
-	///	<summary>
-	///		Virtual destructor.
-	///	</summary>
-	virtual ~Edge()
-	{ }
-
 	///	<summary>
 	///		Flip the order of the nodes stored in the segment.  Note that this
 	///		does not affect the comparator properties of the segment, and so
@@ -528,7 +508,42 @@ public:
 
 typedef std::vector<Edge> EdgeVector;
 
+#if defined(EDGEMAP_USE_UNSORTED_MAP)
+///	<summary>
+///		Hasher for an Edge, independent of Edge orientation and type.
+///	</summary>
+struct EdgeHash {
+	std::size_t operator()(const Edge & edge) const {
+		int ixNodeSmall;
+		int ixNodeBig;
+		edge.GetOrderedNodes(ixNodeSmall, ixNodeBig);
+
+		unsigned long long ullKey =
+			(static_cast<unsigned long long>(static_cast<unsigned int>(ixNodeSmall)) << 32)
+			| static_cast<unsigned long long>(static_cast<unsigned int>(ixNodeBig));
+
+		ullKey ^= (ullKey >> 33);
+		ullKey *= 0xff51afd7ed558ccdULL;
+		ullKey ^= (ullKey >> 33);
+
+		return static_cast<std::size_t>(ullKey);
+	}
+};
+
+///	<summary>
+///		Equality of Edges as unordered pairs of nodes, consistent with
+///		Edge::operator<, which also ignores Edge type.
+///	</summary>
+struct EdgeNodesEqual {
+	bool operator()(const Edge & edge0, const Edge & edge1) const {
+		return !((edge0 < edge1) || (edge1 < edge0));
+	}
+};
+
+typedef std::unordered_map<Edge, FacePair, EdgeHash, EdgeNodesEqual> EdgeMap;
+#else
 typedef std::map<Edge, FacePair> EdgeMap;
+#endif
 
 typedef EdgeMap::value_type EdgeMapPair;
 
@@ -620,8 +635,556 @@ typedef std::vector<Face> FaceVector;
 
 ///	<summary>
 ///		A reverse node array stores all faces associated with a given node.
+///		Face indices are stored in compressed row form: the faces adjacent
+///		to node i are m_vecFaceIx[m_vecOffsets[i] .. m_vecOffsets[i+1]),
+///		in ascending order and without repeats.
 ///	</summary>
-typedef std::vector< std::set<int> > ReverseNodeArray;
+class ReverseNodeArray {
+
+public:
+	///	<summary>
+	///		A read-only view of the faces adjacent to one node.
+	///	</summary>
+	class FaceRange {
+
+	public:
+		typedef const int * const_iterator;
+
+		FaceRange(
+			const int * pBegin,
+			const int * pEnd
+		) :
+			m_pBegin(pBegin),
+			m_pEnd(pEnd)
+		{ }
+
+		const_iterator begin() const {
+			return m_pBegin;
+		}
+
+		const_iterator end() const {
+			return m_pEnd;
+		}
+
+		size_t size() const {
+			return static_cast<size_t>(m_pEnd - m_pBegin);
+		}
+
+		int operator[](int i) const {
+			return m_pBegin[i];
+		}
+
+	protected:
+		const int * m_pBegin;
+		const int * m_pEnd;
+	};
+
+public:
+	///	<summary>
+	///		Number of nodes in the array.
+	///	</summary>
+	size_t size() const {
+		if (m_vecOffsets.size() == 0) {
+			return 0;
+		}
+		return (m_vecOffsets.size() - 1);
+	}
+
+	///	<summary>
+	///		Remove all entries.
+	///	</summary>
+	void clear() {
+		m_vecOffsets.clear();
+		m_vecFaceIx.clear();
+	}
+
+	///	<summary>
+	///		Faces adjacent to the given node.
+	///	</summary>
+	FaceRange operator[](int ixNode) const {
+		const int * pFaceIx = m_vecFaceIx.data();
+		return FaceRange(
+			pFaceIx + m_vecOffsets[ixNode],
+			pFaceIx + m_vecOffsets[ixNode+1]);
+	}
+
+	///	<summary>
+	///		Faces adjacent to the given node as a std::set.
+	///	</summary>
+	void GetFaceSet(
+		int ixNode,
+		std::set<int> & setFaces
+	) const {
+		FaceRange range = (*this)[ixNode];
+		setFaces.clear();
+		setFaces.insert(range.begin(), range.end());
+	}
+
+	///	<summary>
+	///		Offsets of each node into the face index array (size + 1 entries).
+	///	</summary>
+	const std::vector<int> & GetOffsets() const {
+		return m_vecOffsets;
+	}
+
+	///	<summary>
+	///		Concatenated face indices of all nodes.
+	///	</summary>
+	const std::vector<int> & GetFaceIndices() const {
+		return m_vecFaceIx;
+	}
+
+	///	<summary>
+	///		Take ownership of the given compressed row arrays.
+	///	</summary>
+	void Swap(
+		std::vector<int> & vecOffsets,
+		std::vector<int> & vecFaceIx
+	) {
+		m_vecOffsets.swap(vecOffsets);
+		m_vecFaceIx.swap(vecFaceIx);
+	}
+
+	///	<summary>
+	///		Swap contents with another ReverseNodeArray.
+	///	</summary>
+	void swap(ReverseNodeArray & revnodearray) {
+		m_vecOffsets.swap(revnodearray.m_vecOffsets);
+		m_vecFaceIx.swap(revnodearray.m_vecFaceIx);
+	}
+
+protected:
+	///	<summary>
+	///		Offsets into m_vecFaceIx for each node.
+	///	</summary>
+	std::vector<int> m_vecOffsets;
+
+	///	<summary>
+	///		Face indices adjacent to each node.
+	///	</summary>
+	std::vector<int> m_vecFaceIx;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Markers in a FaceNeighborTable for an edge that is missing from the
+///		EdgeMap or whose FacePair does not contain the Face.
+///	</summary>
+static const int FaceNeighborMissingEdge = (-2);
+static const int FaceNeighborEdgeMapError = (-3);
+
+///	<summary>
+///		A dense table of the Face across each edge of each Face, with one
+///		row of GetWidth() entries per Face, so that walks over a Mesh do
+///		not look up the EdgeMap.  Boundary edges, zero-length edges and the
+///		padding of Faces with fewer than GetWidth() edges hold InvalidFace.
+///	</summary>
+class FaceNeighborTable {
+
+public:
+	///	<summary>
+	///		Constructor.
+	///	</summary>
+	FaceNeighborTable() :
+		m_nWidth(0)
+	{ }
+
+public:
+	///	<summary>
+	///		Number of Faces in the table.
+	///	</summary>
+	size_t size() const {
+		if (m_nWidth == 0) {
+			return 0;
+		}
+		return (m_vecFaceIx.size() / m_nWidth);
+	}
+
+	///	<summary>
+	///		Remove all entries.
+	///	</summary>
+	void clear() {
+		m_nWidth = 0;
+		m_vecFaceIx.clear();
+	}
+
+	///	<summary>
+	///		Number of entries for each Face.
+	///	</summary>
+	int GetWidth() const {
+		return m_nWidth;
+	}
+
+	///	<summary>
+	///		Entry for edge i of the given Face, which may be one of the
+	///		FaceNeighbor markers.
+	///	</summary>
+	int operator()(int ixFace, int i) const {
+		return m_vecFaceIx[static_cast<size_t>(ixFace) * m_nWidth + i];
+	}
+
+	///	<summary>
+	///		Face across edge i of the given Face, or InvalidFace for a
+	///		boundary edge.  Throws if the EdgeMap did not contain the edge.
+	///	</summary>
+	int GetNeighbor(int ixFace, int i) const {
+		const int iFace = (*this)(ixFace, i);
+
+		if (iFace == FaceNeighborMissingEdge) {
+			_EXCEPTION2("Edge %i of Face %i is missing from EdgeMap", i, ixFace);
+		}
+		if (iFace == FaceNeighborEdgeMapError) {
+			_EXCEPTION2("EdgeMap error at edge %i of Face %i", i, ixFace);
+		}
+		return iFace;
+	}
+
+	///	<summary>
+	///		All entries, Face by Face.
+	///	</summary>
+	const std::vector<int> & GetFaceIndices() const {
+		return m_vecFaceIx;
+	}
+
+	///	<summary>
+	///		Take ownership of the given entries.
+	///	</summary>
+	void Swap(
+		int nWidth,
+		std::vector<int> & vecFaceIx
+	) {
+		m_nWidth = nWidth;
+		m_vecFaceIx.swap(vecFaceIx);
+	}
+
+	///	<summary>
+	///		Swap contents with another FaceNeighborTable.
+	///	</summary>
+	void swap(FaceNeighborTable & faceneighbors) {
+		int nWidth = m_nWidth;
+		m_nWidth = faceneighbors.m_nWidth;
+		faceneighbors.m_nWidth = nWidth;
+		m_vecFaceIx.swap(faceneighbors.m_vecFaceIx);
+	}
+
+protected:
+	///	<summary>
+	///		Number of entries for each Face.
+	///	</summary>
+	int m_nWidth;
+
+	///	<summary>
+	///		Face across each edge of each Face.
+	///	</summary>
+	std::vector<int> m_vecFaceIx;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Adjacency used to grow reconstruction stencils.
+///	</summary>
+enum FaceStencilType : int {
+	FaceStencilType_None = 0,
+	FaceStencilType_ByEdge = 1,
+	FaceStencilType_ByNode = 2
+};
+
+///	<summary>
+///		The reconstruction stencil of every Face of a Mesh, as generated by
+///		GetAdjacentFaceVectorByEdge or GetAdjacentFaceVectorByNode for one
+///		required stencil size, in compressed row form.  The stencil of Face
+///		i is m_vecFaceIx[m_vecOffsets[i] .. m_vecOffsets[i+1]) with the
+///		distance metric of each entry in m_vecDistance.
+///	</summary>
+class FaceStencilTable {
+
+public:
+	///	<summary>
+	///		Constructor.
+	///	</summary>
+	FaceStencilTable() :
+		m_eType(FaceStencilType_None),
+		m_nRequiredFaceSetSize(0)
+	{ }
+
+public:
+	///	<summary>
+	///		Number of Faces in the table.
+	///	</summary>
+	size_t size() const {
+		if (m_vecOffsets.size() == 0) {
+			return 0;
+		}
+		return (m_vecOffsets.size() - 1);
+	}
+
+	///	<summary>
+	///		Remove all entries.
+	///	</summary>
+	void clear() {
+		m_eType = FaceStencilType_None;
+		m_nRequiredFaceSetSize = 0;
+		m_vecOffsets.clear();
+		m_vecFaceIx.clear();
+		m_vecDistance.clear();
+	}
+
+	///	<summary>
+	///		Adjacency used to generate the table.
+	///	</summary>
+	FaceStencilType GetType() const {
+		return m_eType;
+	}
+
+	///	<summary>
+	///		Required stencil size used to generate the table.
+	///	</summary>
+	int GetRequiredFaceSetSize() const {
+		return m_nRequiredFaceSetSize;
+	}
+
+	///	<summary>
+	///		Returns true if the table holds stencils of nFaces Faces
+	///		generated with the given adjacency and required size.
+	///	</summary>
+	bool Matches(
+		FaceStencilType eType,
+		int nRequiredFaceSetSize,
+		size_t nFaces
+	) const {
+		return (m_eType == eType)
+			&& (m_nRequiredFaceSetSize == nRequiredFaceSetSize)
+			&& (size() == nFaces)
+			&& (nFaces != 0);
+	}
+
+	///	<summary>
+	///		Offset of the stencil of the given Face.
+	///	</summary>
+	int StencilBegin(int ixFace) const {
+		return m_vecOffsets[ixFace];
+	}
+
+	///	<summary>
+	///		One past the end of the stencil of the given Face.
+	///	</summary>
+	int StencilEnd(int ixFace) const {
+		return m_vecOffsets[ixFace+1];
+	}
+
+	///	<summary>
+	///		Offsets of each Face into the stencil arrays (size + 1 entries).
+	///	</summary>
+	const std::vector<int> & GetOffsets() const {
+		return m_vecOffsets;
+	}
+
+	///	<summary>
+	///		Concatenated stencil Face indices of all Faces.
+	///	</summary>
+	const std::vector<int> & GetFaceIndices() const {
+		return m_vecFaceIx;
+	}
+
+	///	<summary>
+	///		Distance metric of each stencil entry.
+	///	</summary>
+	const std::vector<int> & GetDistances() const {
+		return m_vecDistance;
+	}
+
+	///	<summary>
+	///		Take ownership of the given compressed row arrays.
+	///	</summary>
+	void Swap(
+		FaceStencilType eType,
+		int nRequiredFaceSetSize,
+		std::vector<int> & vecOffsets,
+		std::vector<int> & vecFaceIx,
+		std::vector<int> & vecDistance
+	) {
+		m_eType = eType;
+		m_nRequiredFaceSetSize = nRequiredFaceSetSize;
+		m_vecOffsets.swap(vecOffsets);
+		m_vecFaceIx.swap(vecFaceIx);
+		m_vecDistance.swap(vecDistance);
+	}
+
+	///	<summary>
+	///		Swap contents with another FaceStencilTable.
+	///	</summary>
+	void swap(FaceStencilTable & facestencils) {
+		std::swap(m_eType, facestencils.m_eType);
+		std::swap(m_nRequiredFaceSetSize, facestencils.m_nRequiredFaceSetSize);
+		m_vecOffsets.swap(facestencils.m_vecOffsets);
+		m_vecFaceIx.swap(facestencils.m_vecFaceIx);
+		m_vecDistance.swap(facestencils.m_vecDistance);
+	}
+
+protected:
+	///	<summary>
+	///		Adjacency used to generate the table.
+	///	</summary>
+	FaceStencilType m_eType;
+
+	///	<summary>
+	///		Required stencil size used to generate the table.
+	///	</summary>
+	int m_nRequiredFaceSetSize;
+
+	///	<summary>
+	///		Offsets into m_vecFaceIx for each Face.
+	///	</summary>
+	std::vector<int> m_vecOffsets;
+
+	///	<summary>
+	///		Stencil Face indices of each Face.
+	///	</summary>
+	std::vector<int> m_vecFaceIx;
+
+	///	<summary>
+	///		Distance metric of each stencil entry.
+	///	</summary>
+	std::vector<int> m_vecDistance;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Index of the Faces of an overlap Mesh associated with each Face of
+///		the first (source) and second (target) Meshes.  The overlap Faces
+///		must be sorted by first mesh Face, so the overlap Faces of first
+///		mesh Face i are [SourceBegin(i), SourceEnd(i)).  The overlap Faces
+///		of each second mesh Face are stored in compressed row form in
+///		ascending order.
+///	</summary>
+class OverlapFaceIndex {
+
+public:
+	///	<summary>
+	///		Build the index from the first and second mesh Face indices of
+	///		an overlap Mesh.  Entries of vecTargetFaceIx that are negative
+	///		are not indexed.
+	///	</summary>
+	void Construct(
+		const std::vector<int> & vecSourceFaceIx,
+		const std::vector<int> & vecTargetFaceIx,
+		int nSourceFaces,
+		int nTargetFaces
+	);
+
+	///	<summary>
+	///		Remove all entries.
+	///	</summary>
+	void clear() {
+		m_vecSourceOffsets.clear();
+		m_vecTargetOffsets.clear();
+		m_vecTargetFaceIx.clear();
+	}
+
+	///	<summary>
+	///		Number of first mesh Faces in the index.
+	///	</summary>
+	size_t GetSourceFaceCount() const {
+		if (m_vecSourceOffsets.size() == 0) {
+			return 0;
+		}
+		return (m_vecSourceOffsets.size() - 1);
+	}
+
+	///	<summary>
+	///		Number of second mesh Faces in the index.
+	///	</summary>
+	size_t GetTargetFaceCount() const {
+		if (m_vecTargetOffsets.size() == 0) {
+			return 0;
+		}
+		return (m_vecTargetOffsets.size() - 1);
+	}
+
+	///	<summary>
+	///		First overlap Face associated with first mesh Face ixFirst.
+	///	</summary>
+	int SourceBegin(int ixFirst) const {
+		return m_vecSourceOffsets[ixFirst];
+	}
+
+	///	<summary>
+	///		One past the last overlap Face associated with first mesh Face
+	///		ixFirst.
+	///	</summary>
+	int SourceEnd(int ixFirst) const {
+		return m_vecSourceOffsets[ixFirst+1];
+	}
+
+	///	<summary>
+	///		Number of overlap Faces associated with first mesh Face ixFirst.
+	///	</summary>
+	int SourceCount(int ixFirst) const {
+		return (m_vecSourceOffsets[ixFirst+1] - m_vecSourceOffsets[ixFirst]);
+	}
+
+	///	<summary>
+	///		Overlap Faces associated with second mesh Face ixSecond.
+	///	</summary>
+	ReverseNodeArray::FaceRange TargetFaces(int ixSecond) const {
+		const int * pFaceIx = m_vecTargetFaceIx.data();
+		return ReverseNodeArray::FaceRange(
+			pFaceIx + m_vecTargetOffsets[ixSecond],
+			pFaceIx + m_vecTargetOffsets[ixSecond+1]);
+	}
+
+	///	<summary>
+	///		Offsets of each first mesh Face into the overlap Faces
+	///		(GetSourceFaceCount() + 1 entries).
+	///	</summary>
+	const std::vector<int> & GetSourceOffsets() const {
+		return m_vecSourceOffsets;
+	}
+
+	///	<summary>
+	///		Offsets of each second mesh Face into GetTargetFaceIndices()
+	///		(GetTargetFaceCount() + 1 entries).
+	///	</summary>
+	const std::vector<int> & GetTargetOffsets() const {
+		return m_vecTargetOffsets;
+	}
+
+	///	<summary>
+	///		Concatenated overlap Face indices of all second mesh Faces.
+	///	</summary>
+	const std::vector<int> & GetTargetFaceIndices() const {
+		return m_vecTargetFaceIx;
+	}
+
+protected:
+	///	<summary>
+	///		Offsets into the overlap Faces for each first mesh Face.
+	///	</summary>
+	std::vector<int> m_vecSourceOffsets;
+
+	///	<summary>
+	///		Offsets into m_vecTargetFaceIx for each second mesh Face.
+	///	</summary>
+	std::vector<int> m_vecTargetOffsets;
+
+	///	<summary>
+	///		Overlap Face indices associated with each second mesh Face.
+	///	</summary>
+	std::vector<int> m_vecTargetFaceIx;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Space-filling curves used to order the Faces of a Mesh.
+///	</summary>
+enum MeshFaceOrdering {
+	MeshFaceOrdering_Hilbert,
+	MeshFaceOrdering_Morton
+};
 
 ///////////////////////////////////////////////////////////////////////////////
 
@@ -692,12 +1255,35 @@ public:
 	///	</summary>
 	ReverseNodeArray revnodearray;
 
+	///	<summary>
+	///		FaceNeighborTable for this mesh.
+	///	</summary>
+	FaceNeighborTable faceneighbors;
+
+	///	<summary>
+	///		Reconstruction stencils of the Faces of this mesh, if they have
+	///		been constructed.
+	///	</summary>
+	FaceStencilTable facestencils;
+
 	///	<summary>
 	///		Indices of the original Faces for this mesh (for use when
 	///		the original mesh has been subdivided).
 	///	</summary>
 	std::vector<int> vecMultiFaceMap;
 
+	///	<summary>
+	///		Index of each Face prior to ReorderFaces(), or empty if the
+	///		Faces have not been reordered.
+	///	</summary>
+	std::vector<int> vecFaceOriginalIx;
+
+	///	<summary>
+	///		Index of overlap Faces by first and second mesh Face, for an
+	///		overlap Mesh.
+	///	</summary>
+	OverlapFaceIndex overlapfaceindex;
+
 public:
 	///	<summary>
 	///		Default constructor.
@@ -726,15 +1312,43 @@ public:
 	///	<summary>
 	///		Construct the ReverseNodeArray from the NodeVector and FaceVector.
 	///	</summary>
-	void ConstructReverseNodeArray();
+	void ConstructReverseNodeArray(
+		int nThreads = 1
+	);
+
+	///	<summary>
+	///		Construct the FaceNeighborTable from the EdgeMap, which must
+	///		have been constructed.
+	///	</summary>
+	void ConstructFaceNeighbors(
+		int nThreads = 1
+	);
+
+	///	<summary>
+	///		Construct a FaceNeighborTable from the EdgeMap into the given
+	///		table, leaving the Mesh unchanged.
+	///	</summary>
+	void ConstructFaceNeighbors(
+		FaceNeighborTable & table,
+		int nThreads = 1
+	) const;
 
 	///	<summary>
 	///		Calculate Face areas.
 	///	</summary>
 	Real CalculateFaceAreas(
-		bool fContainsConcaveFaces
+		bool fContainsConcaveFaces,
+		int nThreads = 1
 	);
 
+	///	<summary>
+	///		Sum the Face areas in vecFaceArea, accumulating in groups to
+	///		limit roundoff.  The result does not depend on nThreads.
+	///	</summary>
+	Real SumFaceAreas(
+		int nThreads = 1
+	) const;
+
 	///	<summary>
 	///		Calculate Face areas from an Overlap mesh.
 	///	</summary>
@@ -749,26 +1363,107 @@ public:
 
 	///	<summary>
 	///		Remove coincident nodes from the Mesh and adjust indices in faces.
+	///		Each group of coincident nodes is replaced by its first member.
+	///	</summary>
+	void RemoveCoincidentNodes(
+		int nThreads = 1
+	);
+
+	///	<summary>
+	///		Reorder Faces along a space-filling curve through the Face
+	///		centroids, so that Faces which are close on the sphere are
+	///		close in memory, and renumber Nodes in order of first use.
+	///		The original index of each Face is recorded in
+	///		vecFaceOriginalIx.  Face areas, masks and the EdgeMap,
+	///		ReverseNodeArray and FaceNeighborTable (if constructed) are
+	///		updated, and the FaceStencilTable is cleared.
+	///	</summary>
+	void ReorderFaces(
+		MeshFaceOrdering eOrdering = MeshFaceOrdering_Hilbert
+	);
+
+	///	<summary>
+	///		Renumber the first and second mesh Face indices of this overlap
+	///		Mesh for first and second Meshes that have been reordered by
+	///		ReorderFaces(), given their vecFaceOriginalIx (empty if the
+	///		Mesh was not reordered), and sort the overlap Faces by first
+	///		mesh Face.
+	///	</summary>
+	void RenumberOverlapFaces(
+		const std::vector<int> & vecFirstOriginalIx,
+		const std::vector<int> & vecSecondOriginalIx
+	);
+
+	///	<summary>
+	///		Construct the OverlapFaceIndex of this overlap Mesh over first
+	///		and second Meshes with the given number of Faces.  If the
+	///		overlap Faces are not sorted by first mesh Face they are first
+	///		sorted with RenumberOverlapFaces().
 	///	</summary>
-	void RemoveCoincidentNodes();
+	void ConstructOverlapFaceIndex(
+		int nFirstFaces,
+		int nSecondFaces
+	);
 
 	///	<summary>
-	///		Write the mesh to a NetCDF file.
+	///		Write the mesh to a NetCDF file.  Variables are converted on
+	///		nThreads threads and written in bounded chunks of Faces and
+	///		Nodes.  In NetCDF-4 files variables are chunked on disk, and a
+	///		nonzero nDeflateLevel enables the shuffle and deflate filters.
 	///	</summary>
 	void Write(
 		const std::string & strFile,
-		NcFile::FileFormat eFileFormat = NcFile::Classic
+		NcFile::FileFormat eFileFormat = NcFile::Classic,
+		int nDeflateLevel = 0,
+		int nThreads = 1
 	) const;
 
+	///	<summary>
+	///		Write the mesh to a NetCDF file in SCRIP format, with the same
+	///		chunking, compression and threading as Write().
+	///	</summary>
 	void WriteScrip(
 		const std::string & strFile,
-		NcFile::FileFormat eFileFormat = NcFile::Classic
+		NcFile::FileFormat eFileFormat = NcFile::Classic,
+		int nDeflateLevel = 0,
+		int nThreads = 1
+	) const;
+
+	///	<summary>
+	///		Read the mesh from a NetCDF file.  Cell data is read in chunks
+	///		so temporary storage stays small for large meshes.  The mask
+	///		variable is skipped if fReadMask is false.
+	///	</summary>
+	void Read(
+		const std::string & strFile,
+		bool fReadMask = true
+	);
+
+	///	<summary>
+	///		Calculate a 64-bit hash of the Nodes and Faces of the Mesh, used
+	///		to verify that a prepared mesh file matches this Mesh.
+	///	</summary>
+	unsigned long long CalculateContentHash() const;
+
+	///	<summary>
+	///		Write the derived structures of this Mesh (EdgeMap,
+	///		ReverseNodeArray, FaceNeighborTable, FaceStencilTable and Face
+	///		areas, whichever have been computed) to a binary prepared mesh
+	///		file.
+	///	</summary>
+	void WritePrepared(
+		const std::string & strFile
 	) const;
 
 	///	<summary>
-	///		Read the mesh from a NetCDF file.
+	///		Read derived structures from a prepared mesh file written by
+	///		WritePrepared.  Returns false, leaving the Mesh unchanged, if the
+	///		file does not exist, has a different format version, or was
+	///		written for a Mesh with different contents.
 	///	</summary>
-	void Read(const std::string & strFile);
+	bool ReadPrepared(
+		const std::string & strFile
+	);
 
 	///	<summary>
 	///		Remove zero edges from all Faces.
@@ -776,13 +1471,40 @@ public:
 	void RemoveZeroEdges();
 
 	///	<summary>
-	///		Validate the Mesh.
+	///		Validate the Mesh, checking that Nodes have unit magnitude and
+	///		that Faces are cyclic and oriented counter-clockwise.  Threads
+	///		stop at the first error found.  With dSampleFraction below one
+	///		only a deterministic sample of that fraction of the Nodes and
+	///		Faces is checked.
 	///	</summary>
-	void Validate() const;
+	void Validate(
+		int nThreads = 1,
+		double dSampleFraction = 1.0
+	) const;
 };
 
 ///////////////////////////////////////////////////////////////////////////////
 
+///	<summary>
+///		Convert an Exodus mesh file to a SCRIP mesh file without loading
+///		the Faces of the mesh.  Only the node coordinates are held in
+///		memory; connectivity is read one chunk of elements at a time,
+///		converted to SCRIP coordinates and areas over nThreads threads,
+///		and written as hyperslabs of the output variables.  Coincident
+///		nodes and zero edges are removed as they would be by Mesh::Read()
+///		and Mesh::RemoveZeroEdges(), so the output matches that of
+///		Mesh::WriteScrip() on the loaded mesh.
+///	</summary>
+void ConvertExodusToScripStreaming(
+	const std::string & strInputFile,
+	const std::string & strOutputFile,
+	NcFile::FileFormat eFileFormat = NcFile::Classic,
+	int nDeflateLevel = 0,
+	int nThreads = 1
+);
+
+///////////////////////////////////////////////////////////////////////////////
+
 ///	<summary>
 ///		Location data returned from FindFaceFromNode()
 ///		Generate a PathSegmentVector describing the path around the face
@@ -846,6 +1568,22 @@ inline void XYZtoRLL_Deg(
 	}
 }
 
+///	<summary>
+///		Calculate latitude and longitude, in degrees, of nPoints normalized
+///		3D Cartesian coordinates.  The result is identical to that of
+///		XYZtoRLL_Deg() on each point, but the loop has no branches so that
+///		the compiler can vectorize it, calling vector versions of atan2 and
+///		asin where a vector math library is available.
+///	</summary>
+void XYZtoRLL_Deg_Batch(
+	int nPoints,
+	const double * dX,
+	const double * dY,
+	const double * dZ,
+	double * dLon,
+	double * dLat
+);
+
 ///	<summary>
 ///		Calculate the dot product between two Nodes.
 ///	</summary>
@@ -931,7 +1669,8 @@ void GetLocalDirection(
 ///	</summary>
 void EqualizeCoincidentNodes(
 	const Mesh & meshFirst,
-	Mesh & meshSecond
+	Mesh & meshSecond,
+	int nThreads = 1
 );
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -947,7 +1686,8 @@ void EqualizeCoincidentNodes(
 
 ///	<summary>
 ///		Build the mapping function for nodes on meshSecond which are
-///		coincident with nodes on meshFirst.
+///		coincident with nodes on meshFirst.  Each such node is mapped to
+///		the first coincident node on meshFirst.
 ///	</summary>
 ///	<returns>
 ///		The number of coincident nodes on meshSecond.
@@ -955,7 +1695,8 @@ void EqualizeCoincidentNodes(
 int BuildCoincidentNodeVector(
 	const Mesh & meshFirst,
 	const Mesh & meshSecond,
-	std::vector<int> & vecSecondToFirstCoincident
+	std::vector<int> & vecSecondToFirstCoincident,
+	int nThreads = 1
 );
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -988,6 +1729,39 @@ Real CalculateFaceArea(
 	const NodeVector & nodes
 );
 
+///	<summary>
+///		Calculate the area of a single Face by quadrature over its
+///		sub-triangles (the method used by CalculateFaceArea).
+///	</summary>
+Real CalculateFaceAreaQuadratureMethod(
+	const Face & face,
+	const NodeVector & nodes
+);
+
+///	<summary>
+///		Calculate the area of a single Face using Karney's method.
+///	</summary>
+Real CalculateFaceAreaKarneysMethod(
+	const Face & face,
+	const NodeVector & nodes
+);
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Calculate the area of every Face in a FaceVector using the same
+///		quadrature as CalculateFaceArea.  Sub-triangles of consecutive
+///		Faces are gathered into contiguous coordinate arrays so that the
+///		quadrature vectorizes across Faces, and batches are distributed
+///		over nThreads OpenMP threads.
+///	</summary>
+void CalculateFaceAreasQuadratureMethod(
+	const FaceVector & faces,
+	const NodeVector & nodes,
+	DataArray1D<double> & vecFaceArea,
+	int nThreads = 1
+);
+
 ///////////////////////////////////////////////////////////////////////////////
 
 ///	<summary>
@@ -1010,23 +1784,30 @@ bool ConvexifyFace(
 
 ///	<summary>
 ///		Convert all concave Faces into the Mesh into Concave faces via
-///		subdivision.
+///		subdivision.  Concave Faces are removed and their triangles are
+///		appended to the Mesh.  Faces are triangulated in parallel and the
+///		result does not depend on nThreads.
 ///	</summary>
 void ConvexifyMesh(
 	Mesh & mesh,
-	bool fVerbose = false
+	bool fVerbose = false,
+	int nThreads = 1
 );
 
 ///////////////////////////////////////////////////////////////////////////////
 
 ///	<summary>
 ///		Convert concave Mesh meshin to convex Mesh meshout by dividing
-///		Faces and populating the MultiFaceMap.
+///		Faces and populating the MultiFaceMap.  Convex Faces are copied and
+///		concave Faces are replaced by their triangles in place.  Faces are
+///		triangulated in parallel and the result does not depend on
+///		nThreads.
 ///	</summary>
 void ConvexifyMesh(
 	Mesh & meshin,
 	Mesh & meshout,
-	bool fVerbose = false
+	bool fVerbose = false,
+	int nThreads = 1
 );
 
 ///////////////////////////////////////////////////////////////////////////////
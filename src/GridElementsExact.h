@@ -224,4 +224,171 @@ inline NodeExact ScalarProductX(
 
 ///////////////////////////////////////////////////////////////////////////////
 
+///	<summary>
+///		Floating point approximation of the coordinates of a NodeExact.
+///	</summary>
+class NodeExactFilter {
+
+public:
+	///	<summary>
+	///		Approximate Cartesian coordinates (x,y,z) of this Node.
+	///	</summary>
+	FixedPointFilter fx;
+	FixedPointFilter fy;
+	FixedPointFilter fz;
+
+public:
+	///	<summary>
+	///		Default constructor.
+	///	</summary>
+	NodeExactFilter() { }
+
+	///	<summary>
+	///		Constructor from a NodeExact.
+	///	</summary>
+	explicit NodeExactFilter(const NodeExact & node) :
+		fx(node.fx),
+		fy(node.fy),
+		fz(node.fz)
+	{ }
+
+	///	<summary>
+	///		Constructor from a Node, approximating NodeExact(node).
+	///	</summary>
+	explicit NodeExactFilter(const Node & node) :
+		fx(FixedPointFilter::FromSet(node.x)),
+		fy(FixedPointFilter::FromSet(node.y)),
+		fz(FixedPointFilter::FromSet(node.z))
+	{ }
+};
+
+///	<summary>
+///		Calculate the approximate dot product between two Nodes.
+///	</summary>
+inline FixedPointFilter DotProductF(
+	const NodeExactFilter & node1,
+	const NodeExactFilter & node2
+) {
+	return (node1.fx * node2.fx + node1.fy * node2.fy + node1.fz * node2.fz);
+}
+
+///	<summary>
+///		Calculate the approximate cross product between two Nodes.
+///	</summary>
+inline NodeExactFilter CrossProductF(
+	const NodeExactFilter & node1,
+	const NodeExactFilter & node2
+) {
+	NodeExactFilter nodeCross;
+	nodeCross.fx = node1.fy * node2.fz - node1.fz * node2.fy;
+	nodeCross.fy = node1.fz * node2.fx - node1.fx * node2.fz;
+	nodeCross.fz = node1.fx * node2.fy - node1.fy * node2.fx;
+	return nodeCross;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Sign (-1, 0 or +1) of a FixedPoint.
+///	</summary>
+inline int Sign(
+	const FixedPoint & fp
+) {
+	if (fp.IsPositive()) {
+		return (+1);
+	}
+	if (fp.IsNegative()) {
+		return (-1);
+	}
+	return 0;
+}
+
+///	<summary>
+///		Sign (-1, 0 or +1) of the exact value of fp1 * fp2 - fp3 * fp4.
+///	</summary>
+inline int SignOfDifferenceOfProducts(
+	const FixedPoint & fp1,
+	const FixedPoint & fp2,
+	const FixedPoint & fp3,
+	const FixedPoint & fp4
+) {
+#ifdef USE_EXACT_ARITHMETIC_FILTER
+	FixedPointFilter fpf =
+		FixedPointFilter(fp1) * FixedPointFilter(fp2)
+		- FixedPointFilter(fp3) * FixedPointFilter(fp4);
+
+	if (fpf.IsPositive()) {
+		return (+1);
+	}
+	if (fpf.IsNegative()) {
+		return (-1);
+	}
+	if (fpf.IsZero()) {
+		return 0;
+	}
+#endif
+	return Sign(fp1 * fp2 - fp3 * fp4);
+}
+
+///	<summary>
+///		Sign (-1, 0 or +1) of the exact value of
+///		DotProductX(CrossProductX(node1, node2), node3).
+///	</summary>
+inline int SignOfTripleProduct(
+	const NodeExact & node1,
+	const NodeExact & node2,
+	const NodeExact & node3
+) {
+#ifdef USE_EXACT_ARITHMETIC_FILTER
+	FixedPointFilter fpf =
+		DotProductF(
+			CrossProductF(NodeExactFilter(node1), NodeExactFilter(node2)),
+			NodeExactFilter(node3));
+
+	if (fpf.IsPositive()) {
+		return (+1);
+	}
+	if (fpf.IsNegative()) {
+		return (-1);
+	}
+	if (fpf.IsZero()) {
+		return 0;
+	}
+#endif
+	return Sign(DotProductX(CrossProductX(node1, node2), node3));
+}
+
+///	<summary>
+///		Sign (-1, 0 or +1) of the exact value of
+///		DotProductX(CrossProductX(node1, node2), node3), with the Nodes
+///		converted to NodeExact.  The conversion is avoided whenever the
+///		floating point filter determines the sign.
+///	</summary>
+inline int SignOfTripleProduct(
+	const Node & node1,
+	const Node & node2,
+	const Node & node3
+) {
+#ifdef USE_EXACT_ARITHMETIC_FILTER
+	FixedPointFilter fpf =
+		DotProductF(
+			CrossProductF(NodeExactFilter(node1), NodeExactFilter(node2)),
+			NodeExactFilter(node3));
+
+	if (fpf.IsPositive()) {
+		return (+1);
+	}
+	if (fpf.IsNegative()) {
+		return (-1);
+	}
+	if (fpf.IsZero()) {
+		return 0;
+	}
+#endif
+	return Sign(DotProductX(
+		CrossProductX(NodeExact(node1), NodeExact(node2)), NodeExact(node3)));
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
 #endif
@@ -0,0 +1,92 @@
+///////////////////////////////////////////////////////////////////////////////
+///
+///	\file    KeyedCache.h
+///	\author  agent
+///	\version October 15, 2026
+///
+///	<remarks>
+///		Copyright 2026 agent
+///
+///		This file is distributed as part of the Tempest source code package.
+///		Permission is granted to use, copy, modify and distribute this
+///		source code and its documentation under the terms of the GNU General
+///		Public License.  This software is provided "as is" without express
+///		or implied warranty.
+///	</remarks>
+
+#ifndef _KEYEDCACHE_H_
+#define _KEYEDCACHE_H_
+
+#include <cstddef>
+#include <map>
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		A thread-safe cache of values computed on first use for each key
+///		and kept for the life of the process.  Values are never modified
+///		or removed, so references to them remain valid.
+///	</summary>
+template <typename Key, typename Value>
+class KeyedCache {
+
+public:
+	///	<summary>
+	///		Get the value of key, calling fnCompute() to compute it if it is
+	///		not yet in the cache.  fnCompute() is called outside of the
+	///		critical section, so that it may throw and may itself use a
+	///		KeyedCache.  If several threads compute the same value at once,
+	///		the first to finish is kept.
+	///	</summary>
+	template <typename F>
+	const Value & Get(
+		const Key & key,
+		const F & fnCompute
+	) {
+		const Value * pValue = NULL;
+
+#pragma omp critical(KeyedCache)
+		{
+			typename ValueMap::const_iterator iter = m_mapValues.find(key);
+			if (iter != m_mapValues.end()) {
+				pValue = &(iter->second);
+			}
+		}
+
+		if (pValue != NULL) {
+			return (*pValue);
+		}
+
+		const Value value = fnCompute();
+
+		// Entries of a std::map are never relocated, so the reference
+		// remains valid as other entries are inserted
+#pragma omp critical(KeyedCache)
+		{
+			typename ValueMap::iterator iter = m_mapValues.find(key);
+			if (iter == m_mapValues.end()) {
+				iter = m_mapValues.insert(
+					typename ValueMap::value_type(key, value)).first;
+			}
+			pValue = &(iter->second);
+		}
+
+		return (*pValue);
+	}
+
+private:
+	///	<summary>
+	///		Map from keys to values.
+	///	</summary>
+	typedef std::map<Key, Value> ValueMap;
+
+	///	<summary>
+	///		The values computed so far.
+	///	</summary>
+	ValueMap m_mapValues;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+#endif
+
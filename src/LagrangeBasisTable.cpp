@@ -0,0 +1,100 @@
+///////////////////////////////////////////////////////////////////////////////
+///
+///	\file    LagrangeBasisTable.cpp
+///	\author  agent
+///	\version October 14, 2026
+///
+///	<remarks>
+///		Copyright 2026 agent
+///
+///		This file is distributed as part of the Tempest source code package.
+///		Permission is granted to use, copy, modify and distribute this
+///		source code and its documentation under the terms of the GNU General
+///		Public License.  This software is provided "as is" without express
+///		or implied warranty.
+///	</remarks>
+
+#include "LagrangeBasisTable.h"
+
+#include "GaussLobattoQuadrature.h"
+#include "GaussQuadrature.h"
+#include "PolynomialInterp.h"
+#include "Exception.h"
+#include "KeyedCache.h"
+
+#include <tuple>
+
+///////////////////////////////////////////////////////////////////////////////
+
+LagrangeBasisTable::LagrangeBasisTable(
+	int nP,
+	PointType ePointType,
+	int nPoints
+) :
+	m_nP(nP),
+	m_nPoints(nPoints)
+{
+	if (nP < 1) {
+		_EXCEPTION1("Invalid number of nodes (%i)", nP);
+	}
+	if (nPoints < 1) {
+		_EXCEPTION1("Invalid number of points (%i)", nPoints);
+	}
+
+	// Nodes are identical to those of GetDefaultNodalLocations()
+	m_dNodes = GaussLobattoQuadrature::GetCachedPoints(nP, 0.0, 1.0).dG;
+
+	m_dNodeDifferences.Allocate(nP, nP);
+	for (int i = 0; i < nP; i++) {
+	for (int j = 0; j < nP; j++) {
+		m_dNodeDifferences[i][j] = m_dNodes[i] - m_dNodes[j];
+	}
+	}
+
+	// Quadrature points
+	if (ePointType == PointType_GaussLobatto) {
+		const GaussLobattoQuadrature::Points & points =
+			GaussLobattoQuadrature::GetCachedPoints(nPoints, 0.0, 1.0);
+		m_dPoints = points.dG;
+		m_dWeights = points.dW;
+
+	} else if (ePointType == PointType_Gauss) {
+		const GaussQuadrature::Points & points =
+			GaussQuadrature::GetCachedPoints(nPoints, 0.0, 1.0);
+		m_dPoints = points.dG;
+		m_dWeights = points.dW;
+
+	} else {
+		_EXCEPTIONT("Invalid PointType");
+	}
+
+	// Basis values and derivatives at each point
+	m_dValues.Allocate(nPoints, nP);
+	m_dDerivatives.Allocate(nPoints, nP);
+
+	for (int k = 0; k < nPoints; k++) {
+		Evaluate(m_dPoints[k], &(m_dValues[k][0]));
+
+		PolynomialInterp::DiffLagrangianPolynomialCoeffs(
+			nP, m_dNodes, &(m_dDerivatives[k][0]), m_dPoints[k]);
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+const LagrangeBasisTable & LagrangeBasisTable::Get(
+	int nP,
+	PointType ePointType,
+	int nPoints
+) {
+	static KeyedCache<std::tuple<int, int, int>, LagrangeBasisTable> s_cache;
+
+	return s_cache.Get(
+		std::make_tuple(nP, static_cast<int>(ePointType), nPoints),
+		[&]() -> LagrangeBasisTable {
+			return LagrangeBasisTable(nP, ePointType, nPoints);
+		});
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
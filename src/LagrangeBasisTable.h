@@ -0,0 +1,194 @@
+///////////////////////////////////////////////////////////////////////////////
+///
+///	\file    LagrangeBasisTable.h
+///	\author  agent
+///	\version October 14, 2026
+///
+///	<remarks>
+///		Copyright 2026 agent
+///
+///		This file is distributed as part of the Tempest source code package.
+///		Permission is granted to use, copy, modify and distribute this
+///		source code and its documentation under the terms of the GNU General
+///		Public License.  This software is provided "as is" without express
+///		or implied warranty.
+///	</remarks>
+
+#ifndef _LAGRANGEBASISTABLE_H_
+#define _LAGRANGEBASISTABLE_H_
+
+#include "DataArray1D.h"
+#include "DataArray2D.h"
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		The Lagrange basis through the nP Gauss-Lobatto nodes on [0,1],
+///		tabulated at the points of a quadrature rule on [0,1].  Values and
+///		first derivatives of all basis functions at one point are stored
+///		contiguously.  The node differences are also stored, so that the
+///		basis may be evaluated at an arbitrary point without recomputing
+///		the nodes.
+///	</summary>
+class LagrangeBasisTable {
+
+public:
+	///	<summary>
+	///		Quadrature rules at whose points the basis is tabulated.
+	///	</summary>
+	enum PointType {
+		PointType_GaussLobatto = 0,
+		PointType_Gauss = 1
+	};
+
+public:
+	///	<summary>
+	///		Build the table of the basis of nP nodes at the nPoints points
+	///		of the quadrature rule ePointType.
+	///	</summary>
+	LagrangeBasisTable(
+		int nP,
+		PointType ePointType,
+		int nPoints
+	);
+
+	///	<summary>
+	///		Return the table of the basis of nP nodes at its own nodes
+	///		(for which the values are the identity and the derivatives form
+	///		the differentiation matrix) from a process-wide cache.
+	///		This function may be called concurrently from multiple threads.
+	///	</summary>
+	static const LagrangeBasisTable & Get(
+		int nP
+	) {
+		return Get(nP, PointType_GaussLobatto, nP);
+	}
+
+	///	<summary>
+	///		Return the table of the basis of nP nodes at the nPoints points
+	///		of the quadrature rule ePointType from a process-wide cache.
+	///		The returned table is computed on first use and remains valid
+	///		for the lifetime of the program.  This function may be called
+	///		concurrently from multiple threads.
+	///	</summary>
+	static const LagrangeBasisTable & Get(
+		int nP,
+		PointType ePointType,
+		int nPoints
+	);
+
+public:
+	///	<summary>
+	///		Number of nodes (basis functions).
+	///	</summary>
+	int GetNodeCount() const {
+		return m_nP;
+	}
+
+	///	<summary>
+	///		Number of tabulated points.
+	///	</summary>
+	int GetPointCount() const {
+		return m_nPoints;
+	}
+
+	///	<summary>
+	///		Gauss-Lobatto nodes on [0,1].
+	///	</summary>
+	const DataArray1D<double> & GetNodes() const {
+		return m_dNodes;
+	}
+
+	///	<summary>
+	///		Quadrature points on [0,1].
+	///	</summary>
+	const DataArray1D<double> & GetPoints() const {
+		return m_dPoints;
+	}
+
+	///	<summary>
+	///		Quadrature weights on [0,1].
+	///	</summary>
+	const DataArray1D<double> & GetWeights() const {
+		return m_dWeights;
+	}
+
+	///	<summary>
+	///		Values of all nP basis functions at point iPoint.
+	///	</summary>
+	const double * GetValues(
+		int iPoint
+	) const {
+		return &(m_dValues[iPoint][0]);
+	}
+
+	///	<summary>
+	///		First derivatives of all nP basis functions at point iPoint.
+	///	</summary>
+	const double * GetDerivatives(
+		int iPoint
+	) const {
+		return &(m_dDerivatives[iPoint][0]);
+	}
+
+	///	<summary>
+	///		Evaluate all nP basis functions at dX.  The result is identical
+	///		to PolynomialInterp::LagrangianPolynomialCoeffs() through the
+	///		nodes of the table.
+	///	</summary>
+	void Evaluate(
+		double dX,
+		double * dCoeffs
+	) const {
+		for (int i = 0; i < m_nP; i++) {
+			const double * dDiff = &(m_dNodeDifferences[i][0]);
+
+			dCoeffs[i] = 1.0;
+			for (int j = 0; j < m_nP; j++) {
+				if (i == j) {
+					continue;
+				}
+				dCoeffs[i] *= (dX - m_dNodes[j]) / dDiff[j];
+			}
+		}
+	}
+
+protected:
+	///	<summary>
+	///		Number of nodes.
+	///	</summary>
+	int m_nP;
+
+	///	<summary>
+	///		Number of tabulated points.
+	///	</summary>
+	int m_nPoints;
+
+	///	<summary>
+	///		Gauss-Lobatto nodes on [0,1].
+	///	</summary>
+	DataArray1D<double> m_dNodes;
+
+	///	<summary>
+	///		Differences between nodes, m_dNodes[i] - m_dNodes[j].
+	///	</summary>
+	DataArray2D<double> m_dNodeDifferences;
+
+	///	<summary>
+	///		Quadrature points and weights on [0,1].
+	///	</summary>
+	DataArray1D<double> m_dPoints;
+	DataArray1D<double> m_dWeights;
+
+	///	<summary>
+	///		Values and first derivatives of the basis, indexed by point and
+	///		then by basis function.
+	///	</summary>
+	DataArray2D<double> m_dValues;
+	DataArray2D<double> m_dDerivatives;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+#endif
+
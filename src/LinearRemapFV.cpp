@@ -21,13 +21,19 @@
 #include "GaussLobattoQuadrature.h"
 #include "TriangularQuadrature.h"
 #include "MeshUtilitiesFuzzy.h"
+#include "DenseMatrixProduct.h"
 #include "OverlapMesh.h"
+#include "CheckpointFile.h"
+#include "KeyedCache.h"
+#include "OmpExceptionCapture.h"
 
 #include "Announce.h"
 #include "MathHelper.h"
 
 #include <cstring>
 #include <map>
+#include <vector>
+#include <algorithm>
 
 ///////////////////////////////////////////////////////////////////////////////
 
@@ -80,39 +86,26 @@ extern "C" {
 		int * ipiv,
 		int * info);
 
-	///	Compute the matrix inverse from the LU factorization from CLAPACK
-	int dgetri_(
+	///	Solve a linear system using the LU factorization from CLAPACK
+	int dgetrs_(
+		char * trans,
 		int * n,
+		int * nrhs,
 		double * a,
 		int * lda,
 		int * ipiv,
-		double * work,
-		int * lwork,
+		double * b,
+		int * ldb,
 		int * info);
 
-	/// Matrix vector multiply
-	int dgemv_(
-		char * trans,
-		int * m,
-		int * n,
-		double * alpha,
-		double * a,
-		int * lda,
-		double * x,
-		int * incx,
-		double * beta,
-		double * y,
-		int * incy);
-
-	/// Symmetric positive definite matrix solver from CLAPACK
-	int dposv_(
-		char * uplo,
+	///	Compute the matrix inverse from the LU factorization from CLAPACK
+	int dgetri_(
 		int * n,
-		int * nrhs,
 		double * a,
 		int * lda,
-		double * b,
-		int * ldb,
+		int * ipiv,
+		double * work,
+		int * lwork,
 		int * info);
 
 	/// Symmetric matrix solver from CLAPACK
@@ -212,14 +205,149 @@ Node GetReferenceNode(
 
 ///////////////////////////////////////////////////////////////////////////////
 
+///	<summary>
+///		Local coordinate system of a Face, used to evaluate the polynomial
+///		reconstruction.  A displacement from the reference node of the Face
+///		is expressed in the basis formed by the vectors nodeA1 and nodeA2
+///		from the reference node to the second and third nodes of the Face
+///		and their normal nodeC = nodeA1 x nodeA2.  Since nodeC is orthogonal
+///		to nodeA1 and nodeA2 the 3x3 system has a closed-form inverse, which
+///		is computed once per Face rather than solving the system at every
+///		sample point.
+///	</summary>
+class FaceLocalCoordinates {
+
+public:
+	///	<summary>
+	///		Constructor.
+	///	</summary>
+	FaceLocalCoordinates(
+		const Face & face,
+		const NodeVector & nodes
+	) {
+		m_nodeRef = ::GetReferenceNode(face, nodes);
+
+		Node nodeA1 = nodes[face[1]] - m_nodeRef;
+		Node nodeA2 = nodes[face[2]] - m_nodeRef;
+
+		Node nodeC = CrossProduct(nodeA1, nodeA2);
+
+		// Determinant of the matrix with columns nodeA1, nodeA2 and nodeC
+		double dDet = DotProduct(nodeC, nodeC);
+
+		m_fSingular = (dDet == 0.0);
+		if (m_fSingular) {
+			return;
+		}
+
+		// Rows of the inverse are the dual basis vectors
+		Node nodeDual0 = CrossProduct(nodeA2, nodeC) / dDet;
+		Node nodeDual1 = CrossProduct(nodeC, nodeA1) / dDet;
+		Node nodeDual2 = nodeC / dDet;
+
+		m_dInv[0][0] = nodeDual0.x; m_dInv[0][1] = nodeDual0.y; m_dInv[0][2] = nodeDual0.z;
+		m_dInv[1][0] = nodeDual1.x; m_dInv[1][1] = nodeDual1.y; m_dInv[1][2] = nodeDual1.z;
+		m_dInv[2][0] = nodeDual2.x; m_dInv[2][1] = nodeDual2.y; m_dInv[2][2] = nodeDual2.z;
+	}
+
+public:
+	///	<summary>
+	///		Get the reference node of the Face.
+	///	</summary>
+	const Node & GetReferenceNode() const {
+		return m_nodeRef;
+	}
+
+	///	<summary>
+	///		Returns true if the Face is degenerate, in which case ToLocal
+	///		leaves its argument unchanged.
+	///	</summary>
+	bool IsSingular() const {
+		return m_fSingular;
+	}
+
+	///	<summary>
+	///		Replace a displacement from the reference node with its
+	///		components in the local basis.
+	///	</summary>
+	void ToLocal(
+		double * dX
+	) const {
+		if (m_fSingular) {
+			return;
+		}
+
+		double dX0 = m_dInv[0][0] * dX[0] + m_dInv[0][1] * dX[1] + m_dInv[0][2] * dX[2];
+		double dX1 = m_dInv[1][0] * dX[0] + m_dInv[1][1] * dX[1] + m_dInv[1][2] * dX[2];
+		double dX2 = m_dInv[2][0] * dX[0] + m_dInv[2][1] * dX[1] + m_dInv[2][2] * dX[2];
+
+		dX[0] = dX0;
+		dX[1] = dX1;
+		dX[2] = dX2;
+	}
+
+private:
+	///	<summary>
+	///		Reference node of the Face.
+	///	</summary>
+	Node m_nodeRef;
+
+	///	<summary>
+	///		Inverse of the matrix with columns nodeA1, nodeA2 and nodeC.
+	///	</summary>
+	double m_dInv[3][3];
+
+	///	<summary>
+	///		Flag indicating the Face is degenerate.
+	///	</summary>
+	bool m_fSingular;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Append the stencil of the given Face stored in a FaceStencilTable.
+///	</summary>
+static void AppendFaceStencil(
+	const FaceStencilTable & facestencils,
+	int iFaceInitial,
+	AdjacentFaceVector & vecFaces
+) {
+	const std::vector<int> & vecFaceIx = facestencils.GetFaceIndices();
+	const std::vector<int> & vecDistance = facestencils.GetDistances();
+
+	const int ixBegin = facestencils.StencilBegin(iFaceInitial);
+	const int ixEnd = facestencils.StencilEnd(iFaceInitial);
+
+	vecFaces.reserve(vecFaces.size() + (ixEnd - ixBegin));
+	for (int i = ixBegin; i < ixEnd; i++) {
+		vecFaces.push_back(FaceDistancePair(vecFaceIx[i], vecDistance[i]));
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
 void GetAdjacentFaceVectorByEdge(
 	const Mesh & mesh,
 	int iFaceInitial,
 	int nRequiredFaceSetSize,
 	AdjacentFaceVector & vecFaces
 ) {
-	// Ensure the ReverseNodeArray has been constructed
-	if (mesh.edgemap.size() == 0) {
+	// Use the FaceStencilTable if it holds stencils of this size
+	if (mesh.facestencils.Matches(
+			FaceStencilType_ByEdge, nRequiredFaceSetSize, mesh.faces.size())
+	) {
+		AppendFaceStencil(mesh.facestencils, iFaceInitial, vecFaces);
+		return;
+	}
+
+	// Use the FaceNeighborTable if it has been constructed, and otherwise
+	// ensure the EdgeMap has been constructed
+	const bool fHasFaceNeighbors =
+		(mesh.faceneighbors.size() != 0)
+		&& (mesh.faceneighbors.size() == mesh.faces.size());
+
+	if (!fHasFaceNeighbors && (mesh.edgemap.size() == 0)) {
 		_EXCEPTIONT("EdgeMap is required");
 	}
 
@@ -256,17 +384,24 @@ void GetAdjacentFaceVectorByEdge(
 
 			const Face & faceCurrent = mesh.faces[*iterCurrentFace];
 			for (int i = 0; i < faceCurrent.edges.size(); i++) {
-				const FacePair & facepair =
-					mesh.edgemap.find(faceCurrent.edges[i])->second;
 
 				// New face index
 				int iNewFace;
-				if (facepair[0] == *iterCurrentFace) {
-					iNewFace = facepair[1];
-				} else if (facepair[1] == *iterCurrentFace) {
-					iNewFace = facepair[0];
+				if (fHasFaceNeighbors) {
+					iNewFace =
+						mesh.faceneighbors.GetNeighbor(*iterCurrentFace, i);
+
 				} else {
-					_EXCEPTIONT("Logic error");
+					const FacePair & facepair =
+						mesh.edgemap.find(faceCurrent.edges[i])->second;
+
+					if (facepair[0] == *iterCurrentFace) {
+						iNewFace = facepair[1];
+					} else if (facepair[1] == *iterCurrentFace) {
+						iNewFace = facepair[0];
+					} else {
+						_EXCEPTIONT("Logic error");
+					}
 				}
 
 				if (iNewFace == InvalidFace) {
@@ -298,6 +433,14 @@ void GetAdjacentFaceVectorByNode(
 	int nRequiredFaceSetSize,
 	AdjacentFaceVector & vecFaces
 ) {
+	// Use the FaceStencilTable if it holds stencils of this size
+	if (mesh.facestencils.Matches(
+			FaceStencilType_ByNode, nRequiredFaceSetSize, mesh.faces.size())
+	) {
+		AppendFaceStencil(mesh.facestencils, iFaceInitial, vecFaces);
+		return;
+	}
+
 	// Ensure the ReverseNodeArray has been constructed
 	if (mesh.revnodearray.size() == 0) {
 		_EXCEPTIONT("ReverseNodeArray is required");
@@ -339,10 +482,11 @@ void GetAdjacentFaceVectorByNode(
 		std::set<int>::const_iterator iterNode = setPerimeterNodesOld.begin();
 
 		for (; iterNode != setPerimeterNodesOld.end(); iterNode++) {
-			const std::set<int> & setAdjFaces =
+			ReverseNodeArray::FaceRange setAdjFaces =
 				mesh.revnodearray[*iterNode];
 
-			std::set<int>::const_iterator iterFace = setAdjFaces.begin();
+			ReverseNodeArray::FaceRange::const_iterator iterFace =
+				setAdjFaces.begin();
 			for (; iterFace != setAdjFaces.end(); iterFace++) {
 
 				// Verify this Face has not already been added
@@ -371,6 +515,122 @@ void GetAdjacentFaceVectorByNode(
 
 ///////////////////////////////////////////////////////////////////////////////
 
+///	<summary>
+///		Number of Faces whose stencils are generated together.
+///	</summary>
+static const int FaceStencilChunkSize = 1024;
+
+bool ConstructFaceStencils(
+	Mesh & mesh,
+	FaceStencilType eType,
+	int nRequiredFaceSetSize,
+	int nThreads
+) {
+	const int nFaces = static_cast<int>(mesh.faces.size());
+
+	if (mesh.facestencils.Matches(eType, nRequiredFaceSetSize, nFaces)) {
+		return false;
+	}
+	if ((eType != FaceStencilType_ByEdge) && (eType != FaceStencilType_ByNode)) {
+		_EXCEPTIONT("Invalid FaceStencilType");
+	}
+
+	mesh.facestencils.clear();
+
+	// Stencils of each chunk of Faces are generated independently and then
+	// concatenated
+	const int nChunks = (nFaces + FaceStencilChunkSize - 1) / FaceStencilChunkSize;
+
+	std::vector<int> vecOffsets(nFaces + 1, 0);
+	std::vector< std::vector<int> > vecChunkFaceIx(nChunks);
+	std::vector< std::vector<int> > vecChunkDistance(nChunks);
+
+	OmpExceptionCapture capture;
+
+#pragma omp parallel for schedule(dynamic) num_threads(nThreads)
+	for (int c = 0; c < nChunks; c++) {
+		const int ixFaceBegin = c * FaceStencilChunkSize;
+		const int ixFaceEnd = std::min(ixFaceBegin + FaceStencilChunkSize, nFaces);
+
+		capture.Run([&]() {
+			AdjacentFaceVector vecAdjFaces;
+
+			for (int ixFace = ixFaceBegin; ixFace < ixFaceEnd; ixFace++) {
+				vecAdjFaces.clear();
+
+				if (eType == FaceStencilType_ByEdge) {
+					GetAdjacentFaceVectorByEdge(
+						mesh, ixFace, nRequiredFaceSetSize, vecAdjFaces);
+				} else {
+					GetAdjacentFaceVectorByNode(
+						mesh, ixFace, nRequiredFaceSetSize, vecAdjFaces);
+				}
+
+				vecOffsets[ixFace+1] = static_cast<int>(vecAdjFaces.size());
+
+				for (int i = 0; i < vecAdjFaces.size(); i++) {
+					vecChunkFaceIx[c].push_back(vecAdjFaces[i].first);
+					vecChunkDistance[c].push_back(vecAdjFaces[i].second);
+				}
+			}
+		});
+	}
+
+	capture.Rethrow();
+
+	for (int i = 0; i < nFaces; i++) {
+		vecOffsets[i+1] += vecOffsets[i];
+	}
+
+	std::vector<int> vecFaceIx;
+	std::vector<int> vecDistance;
+	vecFaceIx.reserve(vecOffsets[nFaces]);
+	vecDistance.reserve(vecOffsets[nFaces]);
+
+	for (int c = 0; c < nChunks; c++) {
+		vecFaceIx.insert(vecFaceIx.end(),
+			vecChunkFaceIx[c].begin(), vecChunkFaceIx[c].end());
+		vecDistance.insert(vecDistance.end(),
+			vecChunkDistance[c].begin(), vecChunkDistance[c].end());
+
+		std::vector<int>().swap(vecChunkFaceIx[c]);
+		std::vector<int>().swap(vecChunkDistance[c]);
+	}
+
+	mesh.facestencils.Swap(
+		eType,
+		nRequiredFaceSetSize,
+		vecOffsets,
+		vecFaceIx,
+		vecDistance);
+
+	return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+bool ConstructReconstructionStencils(
+	Mesh & meshInput,
+	int nOrder,
+	int nThreads
+) {
+	// Number of coefficients needed at this order
+#ifdef RECTANGULAR_TRUNCATION
+	int nCoefficients = nOrder * nOrder;
+#endif
+#ifdef TRIANGULAR_TRUNCATION 
+	int nCoefficients = nOrder * (nOrder + 1) / 2;
+#endif
+
+	return ConstructFaceStencils(
+		meshInput,
+		FaceStencilType_ByEdge,
+		nCoefficients,
+		nThreads);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
 ///	<summary>
 ///		Build the integration array, an operator that integrates a polynomial
 ///		reconstruction over all overlap faces.
@@ -401,7 +661,9 @@ void BuildIntegrationArray(
 	const Face & faceFirst = meshInput.faces[ixFirstFace];
 
 	// Coordinate axes
-	Node nodeRef = GetReferenceNode(faceFirst, meshInput.nodes);
+	FaceLocalCoordinates coords(faceFirst, meshInput.nodes);
+
+	const Node & nodeRef = coords.GetReferenceNode();
 /*
 	Node node0 = meshInput.nodes[faceFirst[0]];
 	Node node1 = meshInput.nodes[faceFirst[1]];
@@ -417,19 +679,6 @@ void BuildIntegrationArray(
 		0.5 * (node1.y + node2.y) - nodeRef.y,
 		0.5 * (node1.z + node2.z) - nodeRef.z);
 */
-	Node nodeA1 = meshInput.nodes[faceFirst[1]] - nodeRef;
-	Node nodeA2 = meshInput.nodes[faceFirst[2]] - nodeRef;
-
-	Node nodeC = CrossProduct(nodeA1, nodeA2);
-
-	// Fit matrix
-	DataArray2D<double> dFit(3,3);
-
-	dFit(0,0) = nodeA1.x; dFit(0,1) = nodeA1.y; dFit(0,2) = nodeA1.z;
-	dFit(1,0) = nodeA2.x; dFit(1,1) = nodeA2.y; dFit(1,2) = nodeA2.z;
-	dFit(2,0) = nodeC.x;  dFit(2,1) = nodeC.y;  dFit(2,2) = nodeC.z;
-
-	DataArray2D<double> dFitTemp;
 /*
 	// Number of overlapping Faces and triangles
 	int nOverlapFaces = 0;
@@ -462,7 +711,7 @@ void BuildIntegrationArray(
 	}
 
 	// Build integration array
-	dIntArray.Allocate(nCoefficients, nOverlapFaces);
+	dIntArray.Allocate(nCoefficients, nOverlapFaces, true, DataArrayStorage_Pooled);
 
 	// Loop through all overlap Faces
 	for (int i = 0; i < nOverlapFaces; i++) {
@@ -510,16 +759,7 @@ void BuildIntegrationArray(
 				dX[2] -= nodeRef.z;
 
 				// Find the coefficients for this point
-				int n = 3;
-				int nrhs = 1;
-				int lda = 3;
-				int ipiv[3];
-				int ldb = 3;
-				int info;
-
-				dFitTemp = dFit;
-				dgesv_(
-					&n, &nrhs, &(dFitTemp(0,0)), &lda, ipiv, dX, &ldb, &info);
+				coords.ToLocal(dX);
 
 				// Sample this point
 				int ixp = 0;
@@ -575,15 +815,21 @@ void BuildFitArray(
 	int nAdjFaces = vecAdjFaces.size();
 
 	// Initialize arrays,
-	dFitArray.Allocate(nCoefficients, nAdjFaces);
-	dFitWeights.Allocate(nAdjFaces);
+	dFitArray.Allocate(nCoefficients, nAdjFaces, true, DataArrayStorage_Pooled);
+	dFitWeights.Allocate(nAdjFaces, true, DataArrayStorage_Pooled);
 
 	// Triangular quadrature rule
 	const DataArray2D<double> & dG = triquadrule.GetG();
 	const DataArray1D<double> & dW = triquadrule.GetW();
 
 	// Coordinate axes
-	Node nodeRef = GetReferenceNode(faceFirst, mesh.nodes);
+	FaceLocalCoordinates coords(faceFirst, mesh.nodes);
+
+	if (coords.IsSingular()) {
+		_EXCEPTIONT("Degenerate Face in local coordinate system");
+	}
+
+	const Node & nodeRef = coords.GetReferenceNode();
 /*
 	Node node0 = mesh.nodes[faceFirst[0]];
 	Node node1 = mesh.nodes[faceFirst[1]];
@@ -599,18 +845,6 @@ void BuildFitArray(
 		0.5 * (node1.y + node2.y) - nodeRef.y,
 		0.5 * (node1.z + node2.z) - nodeRef.z);
 */
-	Node nodeA1 = mesh.nodes[faceFirst[1]] - nodeRef;
-	Node nodeA2 = mesh.nodes[faceFirst[2]] - nodeRef;
-
-	Node nodeC = CrossProduct(nodeA1, nodeA2);
-
-	// Fit matrix
-	DataArray2D<double> dFit(3,3);
-
-	dFit(0,0) = nodeA1.x; dFit(0,1) = nodeA1.y; dFit(0,2) = nodeA1.z;
-	dFit(1,0) = nodeA2.x; dFit(1,1) = nodeA2.y; dFit(1,2) = nodeA2.z;
-	dFit(2,0) = nodeC.x;  dFit(2,1) = nodeC.y;  dFit(2,2) = nodeC.z;
-
 	// Loop through all adjacent Faces
 	for (int iAdjFace = 0; iAdjFace < vecAdjFaces.size(); iAdjFace++) {
 
@@ -658,22 +892,7 @@ void BuildFitArray(
 				dX[2] -= nodeRef.z;
 
 				// Find the coefficients for this point
-				int n = 3;
-				int nrhs = 1;
-				int lda = 3;
-				int ipiv[9];
-				int ldb = 3;
-				int info;
-
-#pragma message "Pre-triangularize this matrix for efficiency"
-				DataArray2D<double> dFitTemp;
-				dFitTemp = dFit;
-				dgesv_(
-					&n, &nrhs, &(dFitTemp(0,0)), &lda, ipiv, dX, &ldb, &info);
-
-				if (info != 0) {
-					_EXCEPTIONT("Solve failure in dgesv");
-				}
+				coords.ToLocal(dX);
 
 				// Loop through all coefficients
 				int ixp = 0;
@@ -719,6 +938,225 @@ void BuildFitArray(
 
 ///////////////////////////////////////////////////////////////////////////////
 
+int GetFVFitArrayTriQuadRuleOrder(
+	bool fFiniteElementTarget,
+	bool fVolumetric
+) {
+	// NOTE: Reducing the quadrature rule order of LinearRemapFVtoGLL
+	// greatly affects error norms
+	if (fFiniteElementTarget && !fVolumetric) {
+		return 8;
+	}
+	return 4;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// FVFitArrayCache
+///////////////////////////////////////////////////////////////////////////////
+
+void FVFitArrayCache::Construct(
+	const Mesh & meshInput,
+	int nOrder,
+	int nTriQuadRuleOrder,
+	int nThreads
+) {
+	clear();
+
+	// Number of coefficients needed at this order
+#ifdef RECTANGULAR_TRUNCATION
+	const int nCoefficients = nOrder * nOrder;
+#endif
+#ifdef TRIANGULAR_TRUNCATION 
+	const int nCoefficients = nOrder * (nOrder + 1) / 2;
+#endif
+
+	// Stencil size and fit weight exponent used by all FV remaps
+	const int nRequiredFaceSetSize = nCoefficients;
+
+	const int nFitWeightsExponent = nOrder + 2;
+
+	const TriangularQuadratureRule & triquadrule =
+		TriangularQuadratureRule::Get(nTriQuadRuleOrder);
+
+	const int nFaces = static_cast<int>(meshInput.faces.size());
+
+	// Stencil sizes
+	std::vector<int> vecAdjOffsets(nFaces + 1, 0);
+
+	OmpExceptionCapture capture;
+
+#pragma omp parallel for schedule(dynamic, 256) num_threads(nThreads)
+	for (int ixFirst = 0; ixFirst < nFaces; ixFirst++) {
+		capture.Run([&]() {
+			AdjacentFaceVector vecAdjFaces;
+
+			GetAdjacentFaceVectorByEdge(
+				meshInput,
+				ixFirst,
+				nRequiredFaceSetSize,
+				vecAdjFaces);
+
+			vecAdjOffsets[ixFirst+1] = static_cast<int>(vecAdjFaces.size());
+		});
+	}
+
+	capture.Rethrow();
+
+	for (int i = 0; i < nFaces; i++) {
+		vecAdjOffsets[i+1] += vecAdjOffsets[i];
+	}
+
+	std::vector<double> vecFitArray(
+		static_cast<size_t>(vecAdjOffsets[nFaces]) * nCoefficients);
+	std::vector<double> vecFitWeights(vecAdjOffsets[nFaces]);
+
+	// Build the fit arrays without a constraint
+#pragma omp parallel for schedule(dynamic, 256) num_threads(nThreads)
+	for (int ixFirst = 0; ixFirst < nFaces; ixFirst++) {
+		capture.Run([&]() {
+			AdjacentFaceVector vecAdjFaces;
+
+			GetAdjacentFaceVectorByEdge(
+				meshInput,
+				ixFirst,
+				nRequiredFaceSetSize,
+				vecAdjFaces);
+
+			DataArray1D<double> dConstraint;
+			DataArray2D<double> dFitArray;
+			DataArray1D<double> dFitWeights;
+
+			BuildFitArray(
+				meshInput,
+				triquadrule,
+				ixFirst,
+				vecAdjFaces,
+				nOrder,
+				nFitWeightsExponent,
+				dConstraint,
+				dFitArray,
+				dFitWeights);
+
+			const int nAdjFaces = static_cast<int>(vecAdjFaces.size());
+			const int ixAdjBegin = vecAdjOffsets[ixFirst];
+
+			double * pFitArray =
+				&(vecFitArray[static_cast<size_t>(ixAdjBegin) * nCoefficients]);
+
+			for (int p = 0; p < nCoefficients; p++) {
+			for (int i = 0; i < nAdjFaces; i++) {
+				pFitArray[p * nAdjFaces + i] = dFitArray(p,i);
+			}
+			}
+			for (int i = 0; i < nAdjFaces; i++) {
+				vecFitWeights[ixAdjBegin + i] = dFitWeights[i];
+			}
+		});
+	}
+
+	capture.Rethrow();
+
+	m_nOrder = nOrder;
+	m_nTriQuadRuleOrder = nTriQuadRuleOrder;
+	m_nCoefficients = nCoefficients;
+	m_vecAdjOffsets.swap(vecAdjOffsets);
+	m_vecFitArray.swap(vecFitArray);
+	m_vecFitWeights.swap(vecFitWeights);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void FVFitArrayCache::clear() {
+	m_nOrder = 0;
+	m_nTriQuadRuleOrder = 0;
+	m_nCoefficients = 0;
+	m_vecAdjOffsets.clear();
+	m_vecFitArray.clear();
+	m_vecFitWeights.clear();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void FVFitArrayCache::GetFitArray(
+	int ixFirst,
+	int nAdjFaces,
+	const DataArray1D<double> & dConstraint,
+	DataArray2D<double> & dFitArray,
+	DataArray1D<double> & dFitWeights
+) const {
+	const int ixAdjBegin = m_vecAdjOffsets[ixFirst];
+
+	if (m_vecAdjOffsets[ixFirst+1] - ixAdjBegin != nAdjFaces) {
+		_EXCEPTION1("Stencil of Face %i does not match FVFitArrayCache", ixFirst);
+	}
+
+	dFitArray.Allocate(m_nCoefficients, nAdjFaces, false, DataArrayStorage_Pooled);
+	dFitWeights.Allocate(nAdjFaces, false, DataArrayStorage_Pooled);
+
+	const double * pFitArray =
+		&(m_vecFitArray[static_cast<size_t>(ixAdjBegin) * m_nCoefficients]);
+
+	for (int p = 0; p < m_nCoefficients; p++) {
+	for (int i = 0; i < nAdjFaces; i++) {
+		dFitArray(p,i) = pFitArray[p * nAdjFaces + i];
+	}
+	}
+	for (int i = 0; i < nAdjFaces; i++) {
+		dFitWeights[i] = m_vecFitWeights[ixAdjBegin + i];
+	}
+
+	// BuildFitArray replaces the first column with the constraint before
+	// applying the fit weights
+	if (dConstraint.GetRows() != 0) {
+		for (int p = 0; p < m_nCoefficients; p++) {
+			dFitArray(p,0) = dConstraint[p];
+			dFitArray(p,0) *= dFitWeights[0];
+		}
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Build the fit array of Face ixFirst, copying the parts which do not
+///		depend on the constraint from pFitCache if it is not NULL.
+///	</summary>
+static void BuildFitArrayCached(
+	const FVFitArrayCache * pFitCache,
+	const Mesh & mesh,
+	const TriangularQuadratureRule & triquadrule,
+	int ixFirst,
+	const AdjacentFaceVector & vecAdjFaces,
+	int nOrder,
+	int nFitWeightsExponent,
+	const DataArray1D<double> & dConstraint,
+	DataArray2D<double> & dFitArray,
+	DataArray1D<double> & dFitWeights
+) {
+	if (pFitCache != NULL) {
+		pFitCache->GetFitArray(
+			ixFirst,
+			static_cast<int>(vecAdjFaces.size()),
+			dConstraint,
+			dFitArray,
+			dFitWeights);
+
+	} else {
+		BuildFitArray(
+			mesh,
+			triquadrule,
+			ixFirst,
+			vecAdjFaces,
+			nOrder,
+			nFitWeightsExponent,
+			dConstraint,
+			dFitArray,
+			dFitWeights);
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
 void InvertFitArray_Corrected(
 	const DataArray1D<double> & dConstraint,
 	DataArray2D<double> & dFitArray,
@@ -741,7 +1179,7 @@ void InvertFitArray_Corrected(
 	}
 
 	// Allocate inverse
-	dFitArrayPlus.Allocate(nAdjFaces, nCoefficients);
+	dFitArrayPlus.Allocate(nAdjFaces, nCoefficients, true, DataArrayStorage_Pooled);
 
 /*
 	// Invert the fit array using Moore-Penrose pseudoinverse
@@ -820,40 +1258,48 @@ void InvertFitArray_Corrected(
 */
 
 	// Compute Moore-Penrose pseudoinverse via QR method
-	DataArray2D<double> dFit2(nCoefficients, nCoefficients);
+	DataArray2D<double> dFit2(nCoefficients, nCoefficients, true, DataArrayStorage_Pooled);
 
+	// The product is symmetric, so only the upper triangle is computed
 	for (int j = 0; j < nCoefficients; j++) {
-	for (int k = 0; k < nCoefficients; k++) {
-	for (int l = 0; l < nAdjFaces; l++) {
-		dFit2(j,k) += dFitArray(j,l) * dFitArray(k,l);
+	for (int k = j; k < nCoefficients; k++) {
+		for (int l = 0; l < nAdjFaces; l++) {
+			dFit2(j,k) += dFitArray(j,l) * dFitArray(k,l);
+		}
+		dFit2(k,j) = dFit2(j,k);
+	}
 	}
+
+	// Calculate pseudoinverse of FitArray by solving the normal equations
+	// with each adjacent Face as a right-hand side, rather than forming
+	// the inverse of the product explicitly.  Row j of dFitArrayPlus is
+	// column j of dFitArray on input and the solution on output.
+	for (int j = 0; j < nAdjFaces; j++) {
+	for (int k = 0; k < nCoefficients; k++) {
+		dFitArrayPlus(j,k) = dFitArray(k,j);
 	}
 	}
 
-	// Calculate pseudoinverse of FitArray
-	int m = nCoefficients;
+	char trans = 'N';
 	int n = nCoefficients;
+	int nrhs = nAdjFaces;
 	int lda = nCoefficients;
+	int ldb = nCoefficients;
 	int info;
 
-	DataArray1D<int> iPIV(nCoefficients);
+	DataArray1D<int> iPIV(nCoefficients, true, DataArrayStorage_Pooled);
 
-	DataArray1D<double> dWork(nCoefficients);
+	dgetrf_(&n, &n, &(dFit2(0,0)), &lda, &(iPIV[0]), &info);
+	if (info != 0) {
+		_EXCEPTION1("Error in dgetrf: %i", info);
+	}
 
-	int lWork = nCoefficients;
-
-	dgetrf_(&m, &n, &(dFit2(0,0)), &lda, &(iPIV[0]), &info);
-
-	dgetri_(&n, &(dFit2(0,0)), &lda, &(iPIV[0]), &(dWork[0]), &lWork, &info);
-
-	// Calculate pseudoinverse
-	for (int j = 0; j < nAdjFaces; j++) {
-	for (int k = 0; k < nCoefficients; k++) {
-	for (int l = 0; l < nCoefficients; l++) {
-		dFitArrayPlus(j,k) += dFitArray(l,j) * dFit2(l,k);
-	}
-	}
-	}
+	dgetrs_(
+		&trans, &n, &nrhs, &(dFit2(0,0)), &lda, &(iPIV[0]),
+		&(dFitArrayPlus(0,0)), &ldb, &info);
+	if (info != 0) {
+		_EXCEPTION1("Error in dgetrs: %i", info);
+	}
 
 	for (int j = 0; j < nAdjFaces; j++) {
 	for (int k = 0; k < nCoefficients; k++) {
@@ -916,7 +1362,7 @@ void InvertFitArray_LeastSquares(
 	}
 
 	// Allocate inverse
-	dFitArrayPlus.Allocate(nAdjFaces, nCoefficients);
+	dFitArrayPlus.Allocate(nAdjFaces, nCoefficients, true, DataArrayStorage_Pooled);
 
 	// Special case: First order
 	if (nCoefficients == 1) {
@@ -925,7 +1371,7 @@ void InvertFitArray_LeastSquares(
 	}
 
 	// Compute QR factorization of the constraint
-	DataArray2D<double> dQ(nCoefficients, nCoefficients);
+	DataArray2D<double> dQ(nCoefficients, nCoefficients, true, DataArrayStorage_Pooled);
 
 	double dR;
 
@@ -936,7 +1382,7 @@ void InvertFitArray_LeastSquares(
 
 		double tau;
 
-		DataArray1D<double> dWork(nCoefficients);
+		DataArray1D<double> dWork(nCoefficients, true, DataArrayStorage_Pooled);
 		int lwork = nCoefficients;
 
 		int info;
@@ -959,7 +1405,7 @@ void InvertFitArray_LeastSquares(
 	}
 
 	// Calculate G = F * Q 
-	DataArray2D<double> dGG(nCoefficients, nAdjFaces);
+	DataArray2D<double> dGG(nCoefficients, nAdjFaces, true, DataArrayStorage_Pooled);
 
 	for (int i = 0; i < nCoefficients; i++) {
 	for (int j = 0; j < nAdjFaces; j++) {
@@ -970,7 +1416,7 @@ void InvertFitArray_LeastSquares(
 	}
 
 	// Calculate Moore-Penrose pseudoinverse of G(:,2:p)
-	DataArray2D<double> dGxPlus(nAdjFaces, nCoefficients-1);
+	DataArray2D<double> dGxPlus(nAdjFaces, nCoefficients-1, true, DataArrayStorage_Pooled);
 
 	{
 		// Gx2 = G(:, 2:p)^T * G(:,2:p)
@@ -989,9 +1435,9 @@ void InvertFitArray_LeastSquares(
 		int lda = nCoefficients-1;
 		int info;
 
-		DataArray1D<int> iPIV(nCoefficients-1);
+		DataArray1D<int> iPIV(nCoefficients-1, true, DataArrayStorage_Pooled);
 
-		DataArray1D<double> dWork(nCoefficients-1);
+		DataArray1D<double> dWork(nCoefficients-1, true, DataArrayStorage_Pooled);
 
 		int lWork = nCoefficients-1;
 
@@ -1010,10 +1456,10 @@ void InvertFitArray_LeastSquares(
 	}
 
 	// Z = G+ * (I - G(:,1) * R^{-1} * e0T)
-	DataArray2D<double> dZ(nAdjFaces, nCoefficients-1);
+	DataArray2D<double> dZ(nAdjFaces, nCoefficients-1, true, DataArrayStorage_Pooled);
 
 	{
-		DataArray2D<double> dSubZ(nAdjFaces, nAdjFaces);
+		DataArray2D<double> dSubZ(nAdjFaces, nAdjFaces, true, DataArrayStorage_Pooled);
 
 		for (int i = 0; i < nAdjFaces; i++) {
 			dSubZ(i,i) = 1.0;
@@ -1053,23 +1499,253 @@ void InvertFitArray_LeastSquares(
 
 ///////////////////////////////////////////////////////////////////////////////
 
+///	<summary>
+///		Number of source faces in each chunk of work in LinearRemapFVtoFV
+///		and LinearRemapFVtoGLL.  Chunks are merged into the map in source
+///		face order so that the map does not depend on the thread count.
+///	</summary>
+static const int LinearRemapFVChunkSize = 256;
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Append a checkpoint record of the map entries of chunks
+///		[cBegin, cEnd) of source faces.
+///	</summary>
+static void WriteMapCheckpointRecord(
+	CheckpointFile & checkpoint,
+	const std::vector< std::vector< SparseMatrixEntry<double> > > & vecChunkEntries,
+	int cBegin,
+	int cEnd
+) {
+	std::vector<char> vecRecord;
+	CheckpointFile::Put<int>(vecRecord, cBegin);
+	CheckpointFile::Put<int>(vecRecord, cEnd);
+
+	for (int c = cBegin; c < cEnd; c++) {
+		const std::vector< SparseMatrixEntry<double> > & vecEntries =
+			vecChunkEntries[c];
+
+		CheckpointFile::Put<int>(vecRecord, static_cast<int>(vecEntries.size()));
+		for (size_t i = 0; i < vecEntries.size(); i++) {
+			CheckpointFile::Put<int>(vecRecord, vecEntries[i].iRow);
+			CheckpointFile::Put<int>(vecRecord, vecEntries[i].iCol);
+			CheckpointFile::Put<double>(vecRecord, vecEntries[i].value);
+		}
+	}
+
+	checkpoint.WriteRecord(vecRecord);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Restore the map entries of the chunks of a checkpoint record
+///		written by WriteMapCheckpointRecord(), which must begin at chunk
+///		cBegin.  Returns the end of the range of chunks in the record.
+///	</summary>
+static int ReadMapCheckpointRecord(
+	const std::vector<char> & vecRecord,
+	int cBegin,
+	std::vector< std::vector< SparseMatrixEntry<double> > > & vecChunkEntries
+) {
+	size_t sPos = 0;
+
+	const int cRecordBegin = CheckpointFile::Get<int>(vecRecord, sPos);
+	const int cRecordEnd = CheckpointFile::Get<int>(vecRecord, sPos);
+
+	if ((cRecordBegin != cBegin) ||
+		(cRecordEnd <= cRecordBegin) ||
+		(cRecordEnd > vecChunkEntries.size())
+	) {
+		_EXCEPTION2("Checkpoint record for chunks [%i, %i) does not "
+			"continue the map", cRecordBegin, cRecordEnd);
+	}
+
+	for (int c = cRecordBegin; c < cRecordEnd; c++) {
+		const int nEntries = CheckpointFile::Get<int>(vecRecord, sPos);
+
+		std::vector< SparseMatrixEntry<double> > & vecEntries =
+			vecChunkEntries[c];
+
+		vecEntries.reserve(nEntries);
+		for (int i = 0; i < nEntries; i++) {
+			const int iRow = CheckpointFile::Get<int>(vecRecord, sPos);
+			const int iCol = CheckpointFile::Get<int>(vecRecord, sPos);
+			const double dValue = CheckpointFile::Get<double>(vecRecord, sPos);
+
+			vecEntries.push_back(
+				SparseMatrixEntry<double>(iRow, iCol, dValue));
+		}
+	}
+
+	if (sPos != vecRecord.size()) {
+		_EXCEPTIONT("Checkpoint record has trailing data");
+	}
+
+	return cRecordEnd;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Compute the contribution of source face ixFirst, which is overlapped
+///		by overlap faces [ixOverlapBegin, ixOverlapEnd), to the FV to FV
+///		remapping operator and append it to vecEntries.
+///	</summary>
+static void LinearRemapFVtoFVFace(
+	const Mesh & meshInput,
+	const Mesh & meshOutput,
+	const Mesh & meshOverlap,
+	const TriangularQuadratureRule & triquadrule,
+	int nOrder,
+	int nCoefficients,
+	int nRequiredFaceSetSize,
+	int nFitWeightsExponent,
+	const FVFitArrayCache * pFitCache,
+	int ixFirst,
+	int ixOverlapBegin,
+	int ixOverlapEnd,
+	std::vector< SparseMatrixEntry<double> > & vecEntries
+) {
+	int nOverlapFaces = ixOverlapEnd - ixOverlapBegin;
+
+	// Build integration array
+	DataArray2D<double> dIntArray;
+
+	BuildIntegrationArray(
+		meshInput,
+		meshOverlap,
+		triquadrule,
+		ixFirst,
+		ixOverlapBegin,
+		ixOverlapEnd,
+		nOrder,
+		dIntArray);
+
+	// Set of Faces to use in building the reconstruction and associated
+	// distance metric.
+	AdjacentFaceVector vecAdjFaces;
+
+	GetAdjacentFaceVectorByEdge(
+		meshInput,
+		ixFirst,
+		nRequiredFaceSetSize,
+		vecAdjFaces);
+
+	// Number of adjacent Faces
+	int nAdjFaces = vecAdjFaces.size();
+
+	// Determine the conservative constraint equation
+	DataArray1D<double> dConstraint(nCoefficients, true, DataArrayStorage_Pooled);
+
+	double dFirstArea = meshInput.vecFaceArea[ixFirst];
+
+	for (int p = 0; p < nCoefficients; p++) {
+		for (int j = 0; j < nOverlapFaces; j++) {
+			dConstraint[p] += dIntArray(p,j);
+		}
+		dConstraint[p] /= dFirstArea;
+	}
+
+	// Build the fit array from the integration operator
+	DataArray2D<double> dFitArray;
+	DataArray1D<double> dFitWeights;
+	DataArray2D<double> dFitArrayPlus;
+
+	BuildFitArrayCached(
+		pFitCache,
+		meshInput,
+		triquadrule,
+		ixFirst,
+		vecAdjFaces,
+		nOrder,
+		nFitWeightsExponent,
+		dConstraint,
+		dFitArray,
+		dFitWeights
+	);
+
+	// Compute the inverse fit array
+	InvertFitArray_Corrected(
+		dConstraint,
+		dFitArray,
+		dFitWeights,
+		dFitArrayPlus
+	);
+
+	// Multiply integration array and fit array
+	DataArray2D<double> dComposedArray(nAdjFaces, nOverlapFaces, true, DataArrayStorage_Pooled);
+
+	DenseMatrixProductAdd(dFitArrayPlus, dIntArray, dComposedArray);
+
+/*
+	for (int j = 0; j < nOverlapFaces; j++) {
+		dComposedArray(0,j) = meshOverlap.vecFaceArea[ixOverlapBegin + j];
+	}
+
+	for (int i = 0; i < nAdjFaces; i++) {
+	for (int j = 0; j < nOverlapFaces; j++) {
+	for (int k = 1; k < nCoefficients; k++) {
+		double dOverlapArea =
+			meshOverlap.vecFaceArea[ixOverlapBegin + j];
+
+		dComposedArray(i,j) +=
+			(dIntArray(k,j) - dConstraint[k] * dOverlapArea)
+				* dFitArrayPlus(i,k);
+	}
+	}
+	}
+*/
+
+	// Put composed array into the list of map entries
+	for (int i = 0; i < vecAdjFaces.size(); i++) {
+	for (int j = 0; j < nOverlapFaces; j++) {
+		int ixFirstFace = vecAdjFaces[i].first;
+		int ixSecondFace = meshOverlap.vecTargetFaceIx[ixOverlapBegin + j];
+
+		vecEntries.push_back(SparseMatrixEntry<double>(
+			ixSecondFace,
+			ixFirstFace,
+			dComposedArray(i,j)
+			/ meshOutput.vecFaceArea[ixSecondFace]));
+	}
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
 void LinearRemapFVtoFV(
 	const Mesh & meshInput,
 	const Mesh & meshOutput,
 	const Mesh & meshOverlap,
 	int nOrder,
-	OfflineMap & mapRemap
+	OfflineMap & mapRemap,
+	int nThreads,
+	const FVFitArrayCache * pFitCache,
+	CheckpointFile * pCheckpoint
 ) {
 	// Order of triangular quadrature rule
-	const int TriQuadRuleOrder = 4;
+	const int TriQuadRuleOrder =
+		GetFVFitArrayTriQuadRuleOrder(false, false);
 
 	// Verify ReverseNodeArray has been calculated
 	if (meshInput.revnodearray.size() == 0) {
 		_EXCEPTIONT("ReverseNodeArray has not been calculated for meshInput");
 	}
 
+	if (nThreads < 1) {
+		_EXCEPTIONT("Thread count must be at least 1");
+	}
+	if ((pFitCache != NULL) &&
+		!pFitCache->Matches(nOrder, TriQuadRuleOrder, meshInput.faces.size())
+	) {
+		_EXCEPTIONT("FVFitArrayCache does not match meshInput and nOrder");
+	}
+
 	// Triangular quadrature rule
-	TriangularQuadratureRule triquadrule(TriQuadRuleOrder);
+	const TriangularQuadratureRule & triquadrule =
+		TriangularQuadratureRule::Get(TriQuadRuleOrder);
 
 	// Get SparseMatrix represntation of the OfflineMap
 	SparseMatrix<double> & smatMap = mapRemap.GetSparseMatrix();
@@ -1095,353 +1771,392 @@ void LinearRemapFVtoFV(
 	Announce("Required adjacency set size: %i", nRequiredFaceSetSize);
 	Announce("Fit weights exponent: %i", nFitWeightsExponent);
 
-	// Current overlap face
-	int ixOverlap = 0;
+	const int nInputFaces = static_cast<int>(meshInput.faces.size());
 
-	// Loop through all faces on meshInput
-	for (int ixFirst = 0; ixFirst < meshInput.faces.size(); ixFirst++) {
+	// The overlap faces associated with each face of meshInput are stored
+	// contiguously in source face order
+	if (meshOverlap.overlapfaceindex.GetSourceFaceCount() !=
+		meshInput.faces.size()
+	) {
+		_EXCEPTIONT("OverlapFaceIndex has not been constructed for meshOverlap");
+	}
 
-		// Output every 100 elements
-		if (ixFirst % 1000 == 0) {
-			Announce("Element %i/%i", ixFirst, meshInput.faces.size());
-		}
+	const std::vector<int> & vecOverlapBegin =
+		meshOverlap.overlapfaceindex.GetSourceOffsets();
 
-		// This Face
-		const Face & faceFirst = meshInput.faces[ixFirst];
+	// Loop through all faces on meshInput in chunks of contiguous faces,
+	// buffering the map entries of each chunk and accumulating them into
+	// the map in source face order
+	const int nChunks =
+		(nInputFaces + LinearRemapFVChunkSize - 1) / LinearRemapFVChunkSize;
 
-		// Find the set of Faces that overlap faceFirst
-		int ixOverlapBegin = ixOverlap;
-		int ixOverlapEnd = ixOverlapBegin;
-	
-		for (; ixOverlapEnd < meshOverlap.faces.size(); ixOverlapEnd++) {
+	// Chunks are processed in rounds to report progress.  The entries of
+	// completed rounds are assembled into the map once they outnumber its
+	// nonzeros, which bounds the number of buffered entries held in memory
+	// at once by the size of the map.
+	const int nChunksPerRound = 4 * nThreads;
 
-			if (meshOverlap.vecSourceFaceIx[ixOverlapEnd] != ixFirst) {
-				break;
-			}
-		}
+	int cAssembled = 0;
 
-		int nOverlapFaces = ixOverlapEnd - ixOverlapBegin;
+	std::vector< std::vector< SparseMatrixEntry<double> > >
+		vecChunkEntries(nChunks);
 
-		// Build integration array
-		DataArray2D<double> dIntArray;
+	// Restore the chunks completed before a restart
+	int cResume = 0;
 
-		BuildIntegrationArray(
-			meshInput,
-			meshOverlap,
-			triquadrule,
-			ixFirst,
-			ixOverlapBegin,
-			ixOverlapEnd,
-			nOrder,
-			dIntArray);
+	if (pCheckpoint != NULL) {
+		std::vector<char> vecRecord;
+		while (pCheckpoint->ReadRecord(vecRecord)) {
+			cResume =
+				ReadMapCheckpointRecord(vecRecord, cResume, vecChunkEntries);
+		}
+		if (cResume != 0) {
+			Announce("Restarting from element %i",
+				std::min(cResume * LinearRemapFVChunkSize, nInputFaces));
+		}
+	}
 
-		// Set of Faces to use in building the reconstruction and associated
-		// distance metric.
-		AdjacentFaceVector vecAdjFaces;
+	int cCheckpoint = cResume;
+
+	for (int c0 = cResume; c0 < nChunks; c0 += nChunksPerRound) {
+		const int c1 = std::min(c0 + nChunksPerRound, nChunks);
+
+		// Record the chunks completed since the last checkpoint
+		if ((pCheckpoint != NULL) && (c0 != cCheckpoint) &&
+			pCheckpoint->IsDue()
+		) {
+			WriteMapCheckpointRecord(
+				*pCheckpoint, vecChunkEntries, cCheckpoint, c0);
+			cCheckpoint = c0;
+		}
+
+		Announce("Element %i/%i", c0 * LinearRemapFVChunkSize, nInputFaces);
+
+		OmpExceptionCapture capture;
+
+#pragma omp parallel for schedule(dynamic) num_threads(nThreads)
+		for (int c = c0; c < c1; c++) {
+			const int ixFirstBegin = c * LinearRemapFVChunkSize;
+			const int ixFirstEnd =
+				std::min(ixFirstBegin + LinearRemapFVChunkSize, nInputFaces);
+
+			capture.Run([&]() {
+				for (int ixFirst = ixFirstBegin; ixFirst < ixFirstEnd; ixFirst++) {
+					LinearRemapFVtoFVFace(
+						meshInput,
+						meshOutput,
+						meshOverlap,
+						triquadrule,
+						nOrder,
+						nCoefficients,
+						nRequiredFaceSetSize,
+						nFitWeightsExponent,
+						pFitCache,
+						ixFirst,
+						vecOverlapBegin[ixFirst],
+						vecOverlapBegin[ixFirst+1],
+						vecChunkEntries[c]);
+				}
+			});
+		}
 
-		GetAdjacentFaceVectorByEdge(
-			meshInput,
-			ixFirst,
-			nRequiredFaceSetSize,
-			vecAdjFaces);
+		capture.Rethrow();
 
-		// Number of adjacent Faces
-		int nAdjFaces = vecAdjFaces.size();
+		// Chunks are only assembled once they have been recorded, since
+		// the next checkpoint record is written from their buffers
+		cAssembled = static_cast<int>(
+			smatMap.AssembleEntriesIfBuffered(
+				vecChunkEntries,
+				cAssembled,
+				(pCheckpoint != NULL)?(cCheckpoint):(c1),
+				nThreads));
+	}
 
-		// Determine the conservative constraint equation
-		DataArray1D<double> dConstraint(nCoefficients);
+	// Assemble the map entries of the remaining chunks in source face order
+	smatMap.AssembleEntries(vecChunkEntries, cAssembled, nChunks, nThreads);
+}
 
-		double dFirstArea = meshInput.vecFaceArea[ixFirst];
+///////////////////////////////////////////////////////////////////////////////
 
-		for (int p = 0; p < nCoefficients; p++) {
-			for (int j = 0; j < nOverlapFaces; j++) {
-				dConstraint[p] += dIntArray(p,j);
-			}
-			dConstraint[p] /= dFirstArea;
-		}
+void LinearRemapFVtoFV_Update(
+	const Mesh & meshInput,
+	const Mesh & meshOutput,
+	const Mesh & meshOverlap,
+	int nOrder,
+	const std::vector<int> & vecChangedSourceFaces,
+	const std::vector<int> & vecChangedTargetFaces,
+	OfflineMap & mapRemap,
+	int nThreads
+) {
+	// Order of triangular quadrature rule
+	const int TriQuadRuleOrder = 4;
 
-		// Build the fit array from the integration operator
-		DataArray2D<double> dFitArray;
-		DataArray1D<double> dFitWeights;
-		DataArray2D<double> dFitArrayPlus;
+	// Verify ReverseNodeArray has been calculated
+	if (meshInput.revnodearray.size() == 0) {
+		_EXCEPTIONT("ReverseNodeArray has not been calculated for meshInput");
+	}
+	if (meshInput.edgemap.size() == 0) {
+		_EXCEPTIONT("EdgeMap has not been calculated for meshInput");
+	}
 
-		BuildFitArray(
-			meshInput,
-			triquadrule,
-			ixFirst,
-			vecAdjFaces,
-			nOrder,
-			nFitWeightsExponent,
-			dConstraint,
-			dFitArray,
-			dFitWeights
-		);
+	if (nThreads < 1) {
+		_EXCEPTIONT("Thread count must be at least 1");
+	}
 
-		// Compute the inverse fit array
-		InvertFitArray_Corrected(
-			dConstraint,
-			dFitArray,
-			dFitWeights,
-			dFitArrayPlus
-		);
+	const int nInputFaces = static_cast<int>(meshInput.faces.size());
+	const int nOutputFaces = static_cast<int>(meshOutput.faces.size());
 
-		// Multiply integration array and fit array
-		DataArray2D<double> dComposedArray(nAdjFaces, nOverlapFaces);
+	// Get SparseMatrix represntation of the OfflineMap
+	SparseMatrix<double> & smatMap = mapRemap.GetSparseMatrix();
 
-		for (int i = 0; i < nAdjFaces; i++) {
-		for (int j = 0; j < nOverlapFaces; j++) {
-		for (int k = 0; k < nCoefficients; k++) {
-			dComposedArray(i,j) += dIntArray(k,j) * dFitArrayPlus(i,k);
-		}
-		}
-		}
+	if ((smatMap.GetRows() > nOutputFaces) ||
+	    (smatMap.GetColumns() > nInputFaces)
+	) {
+		_EXCEPTION4("Previous map (%i x %i) does not match meshes (%i x %i)",
+			smatMap.GetRows(), smatMap.GetColumns(),
+			nOutputFaces, nInputFaces);
+	}
 
-/*
-		for (int j = 0; j < nOverlapFaces; j++) {
-			dComposedArray(0,j) = meshOverlap.vecFaceArea[ixOverlap + j];
-		}
+	// Triangular quadrature rule
+	const TriangularQuadratureRule & triquadrule =
+		TriangularQuadratureRule::Get(TriQuadRuleOrder);
 
-		for (int i = 0; i < nAdjFaces; i++) {
-		for (int j = 0; j < nOverlapFaces; j++) {
-		for (int k = 1; k < nCoefficients; k++) {
-			double dOverlapArea =
-				meshOverlap.vecFaceArea[ixOverlap + j];
+	// Number of elements needed
+#ifdef RECTANGULAR_TRUNCATION
+	const int nCoefficients = nOrder * nOrder;
+#endif
+#ifdef TRIANGULAR_TRUNCATION 
+	const int nCoefficients = nOrder * (nOrder + 1) / 2;
+#endif
 
-			dComposedArray(i,j) +=
-				(dIntArray(k,j) - dConstraint[k] * dOverlapArea)
-					* dFitArrayPlus(i,k);
-		}
-		}
-		}
-*/
+	// Number of faces you need
+	const int nRequiredFaceSetSize = nCoefficients;
 
-		// Put composed array into map
-		for (int i = 0; i < vecAdjFaces.size(); i++) {
-		for (int j = 0; j < nOverlapFaces; j++) {
-			int ixFirstFace = vecAdjFaces[i].first;
-			int ixSecondFace = meshOverlap.vecTargetFaceIx[ixOverlap + j];
+	// Fit weight exponent
+	const int nFitWeightsExponent = nOrder + 2;
 
-			smatMap(ixSecondFace, ixFirstFace) +=
-				dComposedArray(i,j)
-				/ meshOutput.vecFaceArea[ixSecondFace];
-		}
-		}
+	// Flag the changed Faces
+	std::vector<char> vecSourceChanged(nInputFaces, 0);
+	std::vector<char> vecTargetChanged(nOutputFaces, 0);
 
-		// Increment the current overlap index
-		ixOverlap += nOverlapFaces;
+	for (int i = 0; i < vecChangedSourceFaces.size(); i++) {
+		if ((vecChangedSourceFaces[i] < 0) ||
+		    (vecChangedSourceFaces[i] >= nInputFaces)
+		) {
+			_EXCEPTION1("Changed source face index (%i) out of range",
+				vecChangedSourceFaces[i]);
+		}
+		vecSourceChanged[vecChangedSourceFaces[i]] = 1;
+	}
+	for (int i = 0; i < vecChangedTargetFaces.size(); i++) {
+		if ((vecChangedTargetFaces[i] < 0) ||
+		    (vecChangedTargetFaces[i] >= nOutputFaces)
+		) {
+			_EXCEPTION1("Changed target face index (%i) out of range",
+				vecChangedTargetFaces[i]);
+		}
+		vecTargetChanged[vecChangedTargetFaces[i]] = 1;
 	}
-}
 
-///////////////////////////////////////////////////////////////////////////////
+	// A source Face is affected if its reconstruction stencil, which
+	// includes the Face itself, contains a changed source Face
+	std::vector<char> vecSourceAffected(nInputFaces, 0);
 
-void ForceIntArrayConsistencyConservation(
-	const DataArray1D<double> & vecSourceArea,
-	const DataArray1D<double> & vecTargetArea,
-	DataArray2D<double> & dCoeff,
-	bool fMonotone
-) {
+	OmpExceptionCapture capture;
 
-	// Number of free coefficients
-	int nCoeff = dCoeff.GetRows() * dCoeff.GetColumns();
+#pragma omp parallel for schedule(dynamic, 256) num_threads(nThreads)
+	for (int ixFirst = 0; ixFirst < nInputFaces; ixFirst++) {
+		capture.Run([&]() {
+			AdjacentFaceVector vecAdjFaces;
 
-	// Number of conditions
-	int nCondConservation = dCoeff.GetColumns();
-	int nCondConsistency  = dCoeff.GetRows();
+			GetAdjacentFaceVectorByEdge(
+				meshInput,
+				ixFirst,
+				nRequiredFaceSetSize,
+				vecAdjFaces);
 
-	// One condition is dropped due to linear dependence
-	int nCond = nCondConservation + nCondConsistency - 1;
+			for (int i = 0; i < vecAdjFaces.size(); i++) {
+				if (vecSourceChanged[vecAdjFaces[i].first]) {
+					vecSourceAffected[ixFirst] = 1;
+					break;
+				}
+			}
+		});
+	}
 
-	// Product matrix
-	DataArray2D<double> dCCt(nCond, nCond);
-	DataArray2D<double> dC(nCoeff, nCond);
-	DataArray1D<double> dRHS(nCoeff + nCond);
+	capture.Rethrow();
 
-	// RHS
-	int ix = 0;
-	for (int i = 0; i < dCoeff.GetRows(); i++) {
-	for (int j = 0; j < dCoeff.GetColumns(); j++) {
-		dRHS[ix] = dCoeff(i,j);
-		ix++;
-	}
-	}
+	// Rows of the map to recompute: changed target Faces, target Faces
+	// overlapping an affected source Face, and rows of the previous map
+	// which referenced an affected source Face
+	std::vector<char> vecRowRecompute(vecTargetChanged);
 
-	// Consistency
-	ix = 0;
-	for (int i = 0; i < dCoeff.GetRows(); i++) {
-		for (int j = 0; j < dCoeff.GetColumns(); j++) {
-			dC(i * dCoeff.GetColumns() + j,ix) = 1.0;
+	for (int i = 0; i < meshOverlap.faces.size(); i++) {
+		if (vecSourceAffected[meshOverlap.vecSourceFaceIx[i]]) {
+			vecRowRecompute[meshOverlap.vecTargetFaceIx[i]] = 1;
 		}
-		dRHS[nCoeff + ix] = 1.0;
-		ix++;
 	}
 
-	// Conservation
-	for (int j = 0; j < dCoeff.GetColumns()-1; j++) {
-		for (int i = 0; i < dCoeff.GetRows(); i++) {
-			dC(i * dCoeff.GetColumns() + j,ix) = vecTargetArea[i];
+	DataArray1D<int> dataRows;
+	DataArray1D<int> dataCols;
+	DataArray1D<double> dataEntries;
+
+	smatMap.GetEntries(dataRows, dataCols, dataEntries);
+
+	for (int i = 0; i < dataRows.GetRows(); i++) {
+		if (vecSourceAffected[dataCols[i]]) {
+			vecRowRecompute[dataRows[i]] = 1;
 		}
-		dRHS[nCoeff + ix] = vecSourceArea[j];
-		ix++;
 	}
 
-	// Calculate CCt
-	double dP = 0.0;
-	for (int i = 0; i < dCoeff.GetRows(); i++) {
-		dP += vecTargetArea[i] * vecTargetArea[i];
-	}
+	// Every source Face which overlaps a recomputed row contributes to it
+	std::vector<char> vecSourceRecompute(nInputFaces, 0);
 
-	for (int i = 0; i < dCoeff.GetRows(); i++) {
-		dCCt(i,i) = static_cast<double>(dCoeff.GetColumns());
-		for (int j = 0; j < dCoeff.GetColumns()-1; j++) {
-			dCCt(i,dCoeff.GetRows() + j) = vecTargetArea[i];
-			dCCt(dCoeff.GetRows() + j,i) = vecTargetArea[i];
+	for (int i = 0; i < meshOverlap.faces.size(); i++) {
+		if (vecRowRecompute[meshOverlap.vecTargetFaceIx[i]]) {
+			vecSourceRecompute[meshOverlap.vecSourceFaceIx[i]] = 1;
 		}
 	}
 
-	for (int i = 0; i < dCoeff.GetColumns()-1; i++) {
-		int ix = dCoeff.GetRows() + i;
-		dCCt(ix,ix) = dP;
-	}
-/*
-	for (int i = 0; i < nCond; i++) {
-	for (int j = 0; j < nCond; j++) {
-		for (int k = 0; k < nCoeff; k++) {
-			dCCt(i,j) += dC(k,i) * dC(k,j);
+	std::vector<int> vecRecomputeFaces;
+	for (int ixFirst = 0; ixFirst < nInputFaces; ixFirst++) {
+		if (vecSourceRecompute[ixFirst]) {
+			vecRecomputeFaces.push_back(ixFirst);
 		}
 	}
+
+	int nRecomputeRows = 0;
+	for (int i = 0; i < nOutputFaces; i++) {
+		nRecomputeRows += vecRowRecompute[i];
 	}
-*/
-/*
-	FILE * fp = fopen("cct.dat", "w");
-	for (int i = 0; i < nCond; i++) {
-		for (int j = 0; j < nCond; j++) {
-			fprintf(fp, "%1.15e\t", dCCt(i,j));
-		}
-		fprintf(fp, "\n");
+
+	Announce("Changed faces: %i source, %i target",
+		static_cast<int>(vecChangedSourceFaces.size()),
+		static_cast<int>(vecChangedTargetFaces.size()));
+	Announce("Recomputing %i/%i rows from %i/%i source faces",
+		nRecomputeRows, nOutputFaces,
+		static_cast<int>(vecRecomputeFaces.size()), nInputFaces);
+
+	// The overlap faces associated with each face of meshInput are stored
+	// contiguously in source face order
+	if (meshOverlap.overlapfaceindex.GetSourceFaceCount() !=
+		meshInput.faces.size()
+	) {
+		_EXCEPTIONT("OverlapFaceIndex has not been constructed for meshOverlap");
 	}
-	fclose(fp);
-	_EXCEPTION();
-*/
-	// Calculate C*r1 - r2
-	char trans = 'n';
-	int m = nCond;
-	int n = nCoeff;
-	int lda = m;
-	int incx = 1;
-	int incy = 1;
-	double posone = 1.0;
-	double negone = -1.0;
-	dgemv_(
-		&trans,
-		&m,
-		&n,
-		&posone,
-		&(dC(0,0)),
-		&lda,
-		&(dRHS[0]),
-		&incx,
-		&negone,
-		&(dRHS[nCoeff]),
-		&incy);
 
-	// Solve the general system
-	int nrhs = 1;
-	int ldb = nCond;
+	const std::vector<int> & vecOverlapBegin =
+		meshOverlap.overlapfaceindex.GetSourceOffsets();
 
-	int nInfo;
-/*
-	DataArray1D<int> iPIV(nCond);
+	// Recompute the contributions of each source Face to the recomputed
+	// rows.  Entries are accumulated in source face order, as in
+	// LinearRemapFVtoFV, so the updated rows are identical to those of a
+	// fully regenerated map.
+	const int nRecomputeFaces = static_cast<int>(vecRecomputeFaces.size());
 
-	dgesv_(
-		&m,
-		&nrhs,
-		&(dCCt(0,0)),
-		&lda,
-		&(iPIV[0]),
-		&(dRHS[nCoeff]),
-		&ldb,
-		&nInfo);
-*/
-	char uplo = 'U';
-	dposv_(
-		&uplo,
-		&m,
-		&nrhs,
-		&(dCCt(0,0)),
-		&lda,
-		&(dRHS[nCoeff]),
-		&ldb,
-		&nInfo);
+	const int nChunks =
+		(nRecomputeFaces + LinearRemapFVChunkSize - 1) / LinearRemapFVChunkSize;
 
-	if (nInfo != 0) {
-		_EXCEPTION1("Unable to solve SPD Schur system: %i\n", nInfo);
-	}
+	std::vector< std::vector< SparseMatrixEntry<double> > >
+		vecChunkEntries(nChunks);
 
-	// Obtain coefficients
-	trans = 't';
-	dgemv_(
-		&trans,
-		&m,
-		&n,
-		&negone,
-		&(dC(0,0)),
-		&lda,
-		&(dRHS[nCoeff]),
-		&incx,
-		&posone,
-		&(dRHS[0]),
-		&incy);
-
-	// Store coefficients in array
-	ix = 0;
-	for (int i = 0; i < dCoeff.GetRows(); i++) {
-	for (int j = 0; j < dCoeff.GetColumns(); j++) {
-		dCoeff(i,j) = dRHS[ix];
-		ix++;
-	}
-	}
+#pragma omp parallel for schedule(dynamic) num_threads(nThreads)
+	for (int c = 0; c < nChunks; c++) {
+		const int iBegin = c * LinearRemapFVChunkSize;
+		const int iEnd =
+			std::min(iBegin + LinearRemapFVChunkSize, nRecomputeFaces);
 
-	// Force monotonicity
-	if (fMonotone) {
+		capture.Run([&]() {
+			std::vector< SparseMatrixEntry<double> > vecFaceEntries;
 
-		// Calculate total element Jacobian
-		double dTotalJacobian = 0.0;
-		for (int i = 0; i < vecSourceArea.GetRows(); i++) {
-			dTotalJacobian += vecSourceArea[i];
-		}
-
-		// Determine low-order remap coefficients
-		DataArray2D<double> dMonoCoeff(dCoeff.GetRows(), dCoeff.GetColumns());
+			for (int i = iBegin; i < iEnd; i++) {
+				const int ixFirst = vecRecomputeFaces[i];
 
-		for (int i = 0; i < dCoeff.GetRows(); i++) {
-		for (int j = 0; j < dCoeff.GetColumns(); j++) {
-			dMonoCoeff(i,j) =
-				vecSourceArea[j]
-				/ dTotalJacobian;
-		}
-		}
+				vecFaceEntries.clear();
 
-		// Compute scaling factor
-		double dA = 0.0;
-		for (int i = 0; i < dCoeff.GetRows(); i++) {
-		for (int j = 0; j < dCoeff.GetColumns(); j++) {
-			if (dCoeff(i,j) < 0.0) {
-				double dNewA =
-					- dCoeff(i,j) / fabs(dMonoCoeff(i,j) - dCoeff(i,j));
+				LinearRemapFVtoFVFace(
+					meshInput,
+					meshOutput,
+					meshOverlap,
+					triquadrule,
+					nOrder,
+					nCoefficients,
+					nRequiredFaceSetSize,
+					nFitWeightsExponent,
+					NULL,
+					ixFirst,
+					vecOverlapBegin[ixFirst],
+					vecOverlapBegin[ixFirst+1],
+					vecFaceEntries);
 
-				if (dNewA > dA) {
-					dA = dNewA;
+				for (int j = 0; j < vecFaceEntries.size(); j++) {
+					if (vecRowRecompute[vecFaceEntries[j].iRow]) {
+						vecChunkEntries[c].push_back(vecFaceEntries[j]);
+					}
 				}
 			}
-		}
-		}
+		});
+	}
+
+	capture.Rethrow();
+
+	SparseMatrix<double> smatRecomputed;
+	smatRecomputed.AssembleEntries(vecChunkEntries, nThreads);
 
-		for (int i = 0; i < dCoeff.GetRows(); i++) {
-		for (int j = 0; j < dCoeff.GetColumns(); j++) {
-			dCoeff(i,j) = (1.0 - dA) * dCoeff(i,j) + dA * dMonoCoeff(i,j);
+	// Replace the recomputed rows of the previous map
+	DataArray1D<int> dataNewRows;
+	DataArray1D<int> dataNewCols;
+	DataArray1D<double> dataNewEntries;
+
+	smatRecomputed.GetEntries(dataNewRows, dataNewCols, dataNewEntries);
+
+	size_t sKept = 0;
+	for (int i = 0; i < dataRows.GetRows(); i++) {
+		if (!vecRowRecompute[dataRows[i]]) {
+			sKept++;
 		}
+	}
+
+	const size_t sEntries = sKept + dataNewRows.GetRows();
+
+	DataArray1D<int> dataMergedRows(sEntries);
+	DataArray1D<int> dataMergedCols(sEntries);
+	DataArray1D<double> dataMergedEntries(sEntries);
+
+	size_t ix = 0;
+	for (int i = 0; i < dataRows.GetRows(); i++) {
+		if (!vecRowRecompute[dataRows[i]]) {
+			dataMergedRows[ix] = dataRows[i];
+			dataMergedCols[ix] = dataCols[i];
+			dataMergedEntries[ix] = dataEntries[i];
+			ix++;
 		}
 	}
+	for (int i = 0; i < dataNewRows.GetRows(); i++) {
+		dataMergedRows[ix] = dataNewRows[i];
+		dataMergedCols[ix] = dataNewCols[i];
+		dataMergedEntries[ix] = dataNewEntries[i];
+		ix++;
+	}
+
+	smatMap.SetEntries(dataMergedRows, dataMergedCols, dataMergedEntries);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void ForceIntArrayConsistencyConservation(
+	const DataArray1D<double> & vecSourceArea,
+	const DataArray1D<double> & vecTargetArea,
+	DataArray2D<double> & dCoeff,
+	bool fMonotone
+) {
+	// Project onto the consistency and conservation conditions
+	ProjectConsistencyConservation(vecSourceArea, vecTargetArea, dCoeff);
+
+	// Force monotonicity
+	if (fMonotone) {
+		BlendMonotoneCoefficients(vecSourceArea, dCoeff);
+	}
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -1489,7 +2204,8 @@ void LinearRemapFVtoGLL_Simple(
 	GaussLobattoQuadrature::GetPoints(nP, 0.0, 1.0, dG, dW);
 
 	// Triangular quadrature rule
-	TriangularQuadratureRule triquadrule(TriQuadRuleOrder);
+	const TriangularQuadratureRule & triquadrule =
+		TriangularQuadratureRule::Get(TriQuadRuleOrder);
 
 	// Number of elements needed
 #ifdef RECTANGULAR_TRUNCATION
@@ -1504,9 +2220,13 @@ void LinearRemapFVtoGLL_Simple(
 	// Set of found nodes
 	std::set<int> setFoundNodes;
 
-	// Loop through all faces on meshInput
-	int ixOverlap = 0;
+	if (meshOverlap.overlapfaceindex.GetSourceFaceCount() !=
+		meshInput.faces.size()
+	) {
+		_EXCEPTIONT("OverlapFaceIndex has not been constructed for meshOverlap");
+	}
 
+	// Loop through all faces on meshInput
 	for (int ixFirst = 0; ixFirst < meshInput.faces.size(); ixFirst++) {
 
 		// Output every 100 elements
@@ -1521,19 +2241,9 @@ void LinearRemapFVtoGLL_Simple(
 		double dFirstArea = meshInput.vecFaceArea[ixFirst];
 
 		// Coordinate axes
-		Node nodeRef = GetReferenceNode(faceFirst, meshInput.nodes);
-
-		Node nodeA1 = meshInput.nodes[faceFirst[1]] - nodeRef;
-		Node nodeA2 = meshInput.nodes[faceFirst[2]] - nodeRef;
-
-		Node nodeC = CrossProduct(nodeA1, nodeA2);
-
-		// Fit matrix
-		DataArray2D<double> dFit(3,3);
+		FaceLocalCoordinates coords(faceFirst, meshInput.nodes);
 
-		dFit(0,0) = nodeA1.x; dFit(0,1) = nodeA1.y; dFit(0,2) = nodeA1.z;
-		dFit(1,0) = nodeA2.x; dFit(1,1) = nodeA2.y; dFit(1,2) = nodeA2.z;
-		dFit(2,0) = nodeC.x;  dFit(2,1) = nodeC.y;  dFit(2,2) = nodeC.z;
+		const Node & nodeRef = coords.GetReferenceNode();
 
 		// Set of Faces to use in building the reconstruction and associated
 		// distance metric.
@@ -1576,19 +2286,11 @@ void LinearRemapFVtoGLL_Simple(
 			dFitArrayPlus
 		);
 
-		// Number of overlapping Faces
-		int nOverlapFaces = 0;
-		int ixOverlapTemp = ixOverlap;
-		for (; ixOverlapTemp < meshOverlap.faces.size(); ixOverlapTemp++) {
-
-			const Face & faceOverlap = meshOverlap.faces[ixOverlapTemp];
-
-			if (meshOverlap.vecSourceFaceIx[ixOverlapTemp] != ixFirst) {
-				break;
-			}
-
-			nOverlapFaces++;
-		}
+		// Overlapping Faces
+		const int ixOverlap =
+			meshOverlap.overlapfaceindex.SourceBegin(ixFirst);
+		const int nOverlapFaces =
+			meshOverlap.overlapfaceindex.SourceCount(ixFirst);
 
 		// Loop through all Overlap Faces
 		for (int i = 0; i < nOverlapFaces; i++) {
@@ -1670,17 +2372,7 @@ void LinearRemapFVtoGLL_Simple(
 					printf("%i %1.15e %1.15e\n", ixSecondNode, dLon, dLat);
 				}
 */
-				int n = 3;
-				int nrhs = 1;
-				int lda = 3;
-				int ipiv[3];
-				int ldb = 3;
-				int info;
-
-				DataArray2D<double> dFitTemp;
-				dFitTemp = dFit;
-				dgesv_(
-					&n, &nrhs, &(dFitTemp(0,0)), &lda, ipiv, dX, &ldb, &info);
+				coords.ToLocal(dX);
 
 				// Sample the reconstruction at this point
 				int ixp = 0;
@@ -1709,10 +2401,248 @@ void LinearRemapFVtoGLL_Simple(
 			}
 			}
 		}
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Get the edges of the nP x nP sub-volumes of the reference element
+///		[0,1] x [0,1] used by LinearRemapFVtoGLL_Volumetric.  The edges are
+///		the accumulated Gauss-Lobatto weights, so that each sub-volume has
+///		the reference area of its quadrature point.  Edges are computed on
+///		first use for each nP and shared by all later calls.
+///	</summary>
+static const DataArray1D<double> & GetGLLSubVolumeEdges(
+	int nP
+) {
+	static KeyedCache<int, DataArray1D<double> > s_cache;
+
+	return s_cache.Get(nP, [&]() -> DataArray1D<double> {
+		const DataArray1D<double> & dW =
+			GaussLobattoQuadrature::GetCachedPoints(nP, 0.0, 1.0).dW;
+
+		DataArray1D<double> dAccumW(nP+1);
+		dAccumW[0] = 0.0;
+		for (int i = 1; i < nP+1; i++) {
+			dAccumW[i] = dAccumW[i-1] + dW[i-1];
+		}
+		if (fabs(dAccumW[nP] - 1.0) > 1.0e-14) {
+			_EXCEPTIONT("Logic error in accumulated weight");
+		}
+		return dAccumW;
+	});
+}
 
-		// Increment the current overlap index
-		ixOverlap += nOverlapFaces;
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Scratch storage for LinearRemapFVtoGLL_VolumetricFace, reused for
+///		every source face processed by one thread.
+///	</summary>
+struct VolumetricFaceWorkspace {
+
+	///	<summary>
+	///		Scratch buffers used to compute overlap polygons.
+	///	</summary>
+	OverlapFaceWorkspace overlap;
+
+	///	<summary>
+	///		Division of the target sub-volumes overlapping the source face.
+	///		Only the first nOverlapFaces * nP * nP faces are in use for the
+	///		current source face; the remainder keep their storage.
+	///	</summary>
+	Mesh meshThisElement;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Compute the contribution of source face ixFirst to the volumetric
+///		FV to GLL remapping operator and append it to vecEntries.
+///		meshTargetSubElement holds the nP x nP sub-volumes of each target
+///		face and dRedistributionMaps the redistribution operator of each
+///		target face.
+///	</summary>
+static void LinearRemapFVtoGLL_VolumetricFace(
+	const Mesh & meshInput,
+	const Mesh & meshOverlap,
+	const Mesh & meshTargetSubElement,
+	const std::vector< DataArray2D<double> > & dRedistributionMaps,
+	const DataArray3D<int> & dataGLLNodes,
+	const DataArray1D<double> & dataGLLNodalArea,
+	const TriangularQuadratureRule & triquadrule,
+	int nOrder,
+	int nCoefficients,
+	int nRequiredFaceSetSize,
+	int nFitWeightsExponent,
+	const FVFitArrayCache * pFitCache,
+	int nP,
+	int ixFirst,
+	VolumetricFaceWorkspace & workspace,
+	std::vector< SparseMatrixEntry<double> > & vecEntries
+) {
+	const int nSubVolumes = nP * nP;
+
+	// Find the set of Faces that overlap faceFirst
+	int ixOverlapBegin =
+		meshOverlap.overlapfaceindex.SourceBegin(ixFirst);
+	int ixOverlapEnd =
+		meshOverlap.overlapfaceindex.SourceEnd(ixFirst);
+
+	int nOverlapFaces = ixOverlapEnd - ixOverlapBegin;
+
+	const int nSubFaces = nOverlapFaces * nSubVolumes;
+
+	// Divide the target sub-volumes associated with this finite volume.
+	Mesh & meshThisElement = workspace.meshThisElement;
+	if (meshThisElement.faces.size() < nSubFaces) {
+		meshThisElement.faces.resize(nSubFaces);
+	}
+	meshThisElement.nodes.clear();
+	meshThisElement.vecTargetFaceIx.resize(nSubFaces);
+
+	int ixSubFace = 0;
+	for (int i = ixOverlapBegin; i < ixOverlapEnd; i++) {
+
+		int iTargetFace = meshOverlap.vecTargetFaceIx[i];
+
+		int iSubElementBegin = iTargetFace * nSubVolumes;
+
+		for (int p = 0; p < nP; p++) {
+		for (int q = 0; q < nP; q++) {
+
+			// Calculate overlap polygon between sub-element
+			// and finite volume
+			GenerateOverlapFace<MeshUtilitiesFuzzy, Node>(
+				meshInput,
+				meshTargetSubElement,
+				ixFirst,
+				iSubElementBegin + p * nP + q,
+				workspace.overlap);
+
+			const NodeVector & nodevecOutput = workspace.overlap.nodevecOutput;
 
+			Face & faceNew = meshThisElement.faces[ixSubFace];
+			if (faceNew.edges.size() != nodevecOutput.size()) {
+				faceNew = Face(nodevecOutput.size());
+			}
+			for (int n = 0; n < nodevecOutput.size(); n++) {
+				meshThisElement.nodes.push_back(nodevecOutput[n]);
+				faceNew.SetNode(n, meshThisElement.nodes.size()-1);
+			}
+
+			meshThisElement.vecTargetFaceIx[ixSubFace] =
+				dataGLLNodes(p,q,iTargetFace) - 1;
+
+			ixSubFace++;
+		}
+		}
+	}
+
+	// Build integration array
+	DataArray2D<double> dIntArray;
+
+	BuildIntegrationArray(
+		meshInput,
+		meshThisElement,
+		triquadrule,
+		ixFirst,
+		0,
+		nSubFaces,
+		nOrder,
+		dIntArray);
+
+	// Set of Faces to use in building the reconstruction and associated
+	// distance metric.
+	AdjacentFaceVector vecAdjFaces;
+
+	GetAdjacentFaceVectorByEdge(
+		meshInput,
+		ixFirst,
+		nRequiredFaceSetSize,
+		vecAdjFaces);
+
+	// Number of adjacent Faces
+	int nAdjFaces = vecAdjFaces.size();
+
+	// Determine the conservative constraint equation
+	DataArray1D<double> dConstraint(nCoefficients, true, DataArrayStorage_Pooled);
+
+	double dFirstArea = meshInput.vecFaceArea[ixFirst];
+
+	for (int p = 0; p < nCoefficients; p++) {
+		for (int j = 0; j < nSubFaces; j++) {
+			dConstraint[p] += dIntArray(p,j);
+		}
+		dConstraint[p] /= dFirstArea;
+	}
+
+	// Least squares arrays
+	DataArray2D<double> dFitArray;
+	DataArray1D<double> dFitWeights;
+	DataArray2D<double> dFitArrayPlus;
+
+	BuildFitArrayCached(
+		pFitCache,
+		meshInput,
+		triquadrule,
+		ixFirst,
+		vecAdjFaces,
+		nOrder,
+		nFitWeightsExponent,
+		dConstraint,
+		dFitArray,
+		dFitWeights
+	);
+
+	// Compute the inverse fit array
+	InvertFitArray_Corrected(
+		dConstraint,
+		dFitArray,
+		dFitWeights,
+		dFitArrayPlus
+	);
+
+	// Multiply integration array and fit array
+	DataArray2D<double> dComposedArray(nAdjFaces, nSubFaces, true, DataArrayStorage_Pooled);
+
+	DenseMatrixProductAdd(dFitArrayPlus, dIntArray, dComposedArray);
+
+	// Apply redistribution operator
+	DataArray2D<double> dRedistributedArray(nAdjFaces, nSubFaces, true, DataArrayStorage_Pooled);
+
+	for (int i = 0; i < nAdjFaces; i++) {
+	for (int j = 0; j < nSubFaces; j++) {
+		int ixSubElement = j % nSubVolumes;
+		int ixElement = j / nSubVolumes;
+
+		int ixSecondFace =
+			meshOverlap.vecTargetFaceIx[ixOverlapBegin + ixElement];
+
+		const DataArray2D<double> & dRedistributionMap =
+			dRedistributionMaps[ixSecondFace];
+
+		for (int k = 0; k < nSubVolumes; k++) {
+			dRedistributedArray(i,j) +=
+				dComposedArray(i,ixElement * nSubVolumes + k)
+				* dRedistributionMap(ixSubElement,k);
+		}
+	}
+	}
+
+	// Put composed array into the list of map entries
+	for (int i = 0; i < nAdjFaces; i++) {
+	for (int j = 0; j < nSubFaces; j++) {
+		int ixFirstFace = vecAdjFaces[i].first;
+		int ixSecondNode = meshThisElement.vecTargetFaceIx[j];
+
+		vecEntries.push_back(SparseMatrixEntry<double>(
+			ixSecondNode,
+			ixFirstFace,
+			dRedistributedArray(i,j)
+			/ dataGLLNodalArea[ixSecondNode]));
+	}
 	}
 }
 
@@ -1729,18 +2659,30 @@ void LinearRemapFVtoGLL_Volumetric(
 	OfflineMap & mapRemap,
 	int nMonotoneType,
 	bool fContinuous,
-	bool fNoConservation
+	bool fNoConservation,
+	int nThreads,
+	const FVFitArrayCache * pFitCache
 ) {
 	// Order of triangular quadrature rule
-	const int TriQuadRuleOrder = 4;
+	const int TriQuadRuleOrder =
+		GetFVFitArrayTriQuadRuleOrder(true, true);
 
 	// Verify ReverseNodeArray has been calculated
 	if (meshInput.revnodearray.size() == 0) {
 		_EXCEPTIONT("ReverseNodeArray has not been calculated for meshInput");
 	}
+	if (nThreads < 1) {
+		_EXCEPTIONT("Thread count must be at least 1");
+	}
+	if ((pFitCache != NULL) &&
+		!pFitCache->Matches(nOrder, TriQuadRuleOrder, meshInput.faces.size())
+	) {
+		_EXCEPTIONT("FVFitArrayCache does not match meshInput and nOrder");
+	}
 
 	// Triangular quadrature rule
-	TriangularQuadratureRule triquadrule(TriQuadRuleOrder);
+	const TriangularQuadratureRule & triquadrule =
+		TriangularQuadratureRule::Get(TriQuadRuleOrder);
 
 	// Fit weight exponent
 	int nFitWeightsExponent = nOrder + 2;
@@ -1748,12 +2690,6 @@ void LinearRemapFVtoGLL_Volumetric(
 	// Order of the finite element method
 	int nP = dataGLLNodes.GetRows();
 
-	// Gauss-Lobatto quadrature nodes and weights
-	DataArray1D<double> dG;
-	DataArray1D<double> dW;
-
-	GaussLobattoQuadrature::GetPoints(nP, 0.0, 1.0, dG, dW);
-
 	// Get SparseMatrix represntation of the OfflineMap
 	SparseMatrix<double> & smatMap = mapRemap.GetSparseMatrix();
 
@@ -1768,335 +2704,567 @@ void LinearRemapFVtoGLL_Volumetric(
 //#pragma message "This should be a command-line parameter"
 	int nRequiredFaceSetSize = nCoefficients;
 
-	// Accumulated weight vector
-	DataArray1D<double> dAccumW(nP+1);
-	dAccumW[0] = 0.0;
-	for (int i = 1; i < nP+1; i++) {
-		dAccumW[i] = dAccumW[i-1] + dW[i-1];
-	}
-	if (fabs(dAccumW[dAccumW.GetRows()-1] - 1.0) > 1.0e-14) {
-		_EXCEPTIONT("Logic error in accumulated weight");
-	}
+	// Edges of the sub-volumes in the reference element
+	const DataArray1D<double> & dAccumW = GetGLLSubVolumeEdges(nP);
 
-	// Create sub-element mesh and redistribution map
+	// Create sub-element mesh and redistribution map.  The sub-volumes of
+	// each target face share the (nP+1) x (nP+1) lattice of nodes at the
+	// sub-volume edges, and each target face writes only to its own nodes,
+	// faces and redistribution map.
 	Announce("Generating sub-element mesh");
-	Mesh meshTargetSubElement;
 
-	DataArray1D<double> dFiniteVolumeArea(nP * nP);
-	DataArray1D<double> dQuadratureArea(nP * nP);
-	std::vector< DataArray2D<double> > dRedistributionMaps;
-	dRedistributionMaps.resize(meshOutput.faces.size());
+	const int nOutputFaces = static_cast<int>(meshOutput.faces.size());
+	const int nSubVolumes = nP * nP;
+	const int nLatticeNodes = (nP + 1) * (nP + 1);
 
-	for (int ixSecond = 0; ixSecond < meshOutput.faces.size(); ixSecond++) {
+	Mesh meshTargetSubElement;
+	meshTargetSubElement.nodes.resize(nOutputFaces * nLatticeNodes);
+	meshTargetSubElement.faces.resize(nOutputFaces * nSubVolumes, Face(4));
 
-		const Face & faceSecond = meshOutput.faces[ixSecond];
+	std::vector< DataArray2D<double> > dRedistributionMaps;
+	dRedistributionMaps.resize(nOutputFaces);
 
-		const Node & nodeOutput0 = meshOutput.nodes[faceSecond[0]];
-		const Node & nodeOutput1 = meshOutput.nodes[faceSecond[1]];
-		const Node & nodeOutput2 = meshOutput.nodes[faceSecond[2]];
-		const Node & nodeOutput3 = meshOutput.nodes[faceSecond[3]];
+	OmpExceptionCapture capture;
 
-		for (int q = 0; q < nP; q++) {
-		for (int p = 0; p < nP; p++) {
+#pragma omp parallel num_threads(nThreads)
+	{
+		// Scratch arrays, allocated once per thread
+		DataArray1D<double> dFiniteVolumeArea(nSubVolumes);
+		DataArray1D<double> dQuadratureArea(nSubVolumes);
+
+#pragma omp for schedule(dynamic, 16)
+		for (int ixSecond = 0; ixSecond < nOutputFaces; ixSecond++) {
+			capture.Run([&]() {
+				const Face & faceSecond = meshOutput.faces[ixSecond];
+
+				const Node & nodeOutput0 = meshOutput.nodes[faceSecond[0]];
+				const Node & nodeOutput1 = meshOutput.nodes[faceSecond[1]];
+				const Node & nodeOutput2 = meshOutput.nodes[faceSecond[2]];
+				const Node & nodeOutput3 = meshOutput.nodes[faceSecond[3]];
+
+				const int ixNodeBegin = ixSecond * nLatticeNodes;
+
+				for (int q = 0; q < nP+1; q++) {
+				for (int p = 0; p < nP+1; p++) {
+					meshTargetSubElement.nodes[ixNodeBegin + q * (nP+1) + p] =
+						InterpolateQuadrilateralNode(
+							nodeOutput0, nodeOutput1, nodeOutput2, nodeOutput3,
+							dAccumW[p], dAccumW[q]);
+				}
+				}
 
-			Node node0 =
-				InterpolateQuadrilateralNode(
-					nodeOutput0, nodeOutput1, nodeOutput2, nodeOutput3,
-					dAccumW[p], dAccumW[q]);
+				for (int q = 0; q < nP; q++) {
+				for (int p = 0; p < nP; p++) {
+					const int ixNode = ixNodeBegin + q * (nP+1) + p;
 
-			Node node1 =
-				InterpolateQuadrilateralNode(
-					nodeOutput0, nodeOutput1, nodeOutput2, nodeOutput3,
-					dAccumW[p+1], dAccumW[q]);
+					Face & faceNew =
+						meshTargetSubElement.faces[ixSecond * nSubVolumes + q * nP + p];
 
-			Node node2 =
-				InterpolateQuadrilateralNode(
-					nodeOutput0, nodeOutput1, nodeOutput2, nodeOutput3,
-					dAccumW[p+1], dAccumW[q+1]);
+					faceNew.SetNode(0, ixNode);
+					faceNew.SetNode(1, ixNode + 1);
+					faceNew.SetNode(2, ixNode + nP + 2);
+					faceNew.SetNode(3, ixNode + nP + 1);
 
-			Node node3 =
-				InterpolateQuadrilateralNode(
-					nodeOutput0, nodeOutput1, nodeOutput2, nodeOutput3,
-					dAccumW[p], dAccumW[q+1]);
+					dFiniteVolumeArea[q * nP + p] =
+						CalculateFaceArea(
+							faceNew, meshTargetSubElement.nodes);
 
-			int nNodeStart = meshTargetSubElement.nodes.size();
-			meshTargetSubElement.nodes.push_back(node0);
-			meshTargetSubElement.nodes.push_back(node1);
-			meshTargetSubElement.nodes.push_back(node2);
-			meshTargetSubElement.nodes.push_back(node3);
+					dQuadratureArea[q * nP + p] =
+						dataGLLJacobian(q,p,ixSecond);
+				}
+				}
 
-			Face faceNew(4);
-			faceNew.SetNode(0, nNodeStart);
-			faceNew.SetNode(1, nNodeStart+1);
-			faceNew.SetNode(2, nNodeStart+2);
-			faceNew.SetNode(3, nNodeStart+3);
+				DataArray2D<double> & dRedistributionMap =
+					dRedistributionMaps[ixSecond];
 
-			meshTargetSubElement.faces.push_back(faceNew);
+				dRedistributionMap.Allocate(nSubVolumes, nSubVolumes);
+				for (int i = 0; i < nSubVolumes; i++) {
+					dRedistributionMap(i,i) = 1.0;
+				}
 
-			dFiniteVolumeArea[q * nP + p] =
-				CalculateFaceArea(
-					faceNew, meshTargetSubElement.nodes);
+				if (!fNoConservation) {
+					ForceIntArrayConsistencyConservation(
+						dFiniteVolumeArea,
+						dQuadratureArea,
+						dRedistributionMap,
+						(nMonotoneType != 0));
+				}
 
-			dQuadratureArea[q * nP + p] =
-				dataGLLJacobian(q,p,ixSecond);
-		}
+				for (int i = 0; i < nSubVolumes; i++) {
+				for (int j = 0; j < nSubVolumes; j++) {
+					dRedistributionMap(i,j) *=
+						dQuadratureArea[i] / dFiniteVolumeArea[j];
+				}
+				}
+			});
 		}
+	}
 
-		dRedistributionMaps[ixSecond].Allocate(nP * nP, nP * nP);
-		for (int i = 0; i < nP * nP; i++) {
-			dRedistributionMaps[ixSecond](i,i) = 1.0;
-		}
+	capture.Rethrow();
 
-		if (!fNoConservation) {
-			ForceIntArrayConsistencyConservation(
-				dFiniteVolumeArea,
-				dQuadratureArea,
-				dRedistributionMaps[ixSecond],
-				(nMonotoneType != 0));
-		}
-/*
-		double dSumQuadArea = 0.0;
-		double dSumFVArea = 0.0;
-		for (int i = 0; i < nP * nP; i++) {
-			dSumQuadArea += dQuadratureArea[i];
-			dSumFVArea += dFiniteVolumeArea[i];
-		}
-		if (fabs(dSumQuadArea - dSumFVArea) > 1.0e-14) {
-			printf("%1.15e\n", dSumQuadArea - dSumFVArea);
-			_EXCEPTION();
-		}
-*/
-		for (int i = 0; i < nP * nP; i++) {
-		for (int j = 0; j < nP * nP; j++) {
-			dRedistributionMaps[ixSecond](i,j) *=
-				dQuadratureArea[i] / dFiniteVolumeArea[j];
-		}
-		}
-/*
-		for (int i = 0; i < nP * nP; i++) {
-			double dSum = 0.0;
-			for (int j = 0; j < nP * nP; j++) {
-				dSum += dRedistributionMaps(ixSecond,i,j) * dFiniteVolumeArea[j];
+	if (meshOverlap.overlapfaceindex.GetSourceFaceCount() !=
+		meshInput.faces.size()
+	) {
+		_EXCEPTIONT("OverlapFaceIndex has not been constructed for meshOverlap");
+	}
+
+	const int nInputFaces = static_cast<int>(meshInput.faces.size());
+
+	// Loop through all faces on meshInput in chunks of contiguous faces,
+	// buffering the map entries of each chunk and accumulating them into
+	// the map in source face order
+	const int nChunks =
+		(nInputFaces + LinearRemapFVChunkSize - 1) / LinearRemapFVChunkSize;
+
+	// Chunks are processed in rounds to report progress.  The entries of
+	// completed rounds are assembled into the map once they outnumber its
+	// nonzeros, which bounds the number of buffered entries held in memory
+	// at once by the size of the map.
+	const int nChunksPerRound = 4 * nThreads;
+
+	int cAssembled = 0;
+
+	std::vector< std::vector< SparseMatrixEntry<double> > >
+		vecChunkEntries(nChunks);
+
+	for (int c0 = 0; c0 < nChunks; c0 += nChunksPerRound) {
+		const int c1 = std::min(c0 + nChunksPerRound, nChunks);
+
+		Announce("Element %i/%i", c0 * LinearRemapFVChunkSize, nInputFaces);
+
+#pragma omp parallel num_threads(nThreads)
+		{
+			// Scratch buffers, reused for every source face on this thread
+			VolumetricFaceWorkspace workspace;
+
+#pragma omp for schedule(dynamic)
+			for (int c = c0; c < c1; c++) {
+				const int ixFirstBegin = c * LinearRemapFVChunkSize;
+				const int ixFirstEnd =
+					std::min(ixFirstBegin + LinearRemapFVChunkSize, nInputFaces);
+
+				capture.Run([&]() {
+					for (int ixFirst = ixFirstBegin; ixFirst < ixFirstEnd; ixFirst++) {
+						LinearRemapFVtoGLL_VolumetricFace(
+							meshInput,
+							meshOverlap,
+							meshTargetSubElement,
+							dRedistributionMaps,
+							dataGLLNodes,
+							dataGLLNodalArea,
+							triquadrule,
+							nOrder,
+							nCoefficients,
+							nRequiredFaceSetSize,
+							nFitWeightsExponent,
+							pFitCache,
+							nP,
+							ixFirst,
+							workspace,
+							vecChunkEntries[c]);
+					}
+				});
 			}
-			printf("%i %1.15e %1.15e\n", i, dSum, dQuadratureArea[i]);
-		}
-		_EXCEPTION();
-*/
-/*
-		for (int i = 0; i < nP * nP; i++) {
-		for (int j = 0; j < nP * nP; j++) {
-			printf("%i %i %1.15e\n", i, j, dRedistributionMaps(ixSecond,i,j));
 		}
-		}
-		_EXCEPTION();
-*/
-	}
 
-	// Current overlap face
-	int ixOverlap = 0;
+		capture.Rethrow();
 
-	// Loop through all faces on meshInput
-	for (int ixFirst = 0; ixFirst < meshInput.faces.size(); ixFirst++) {
+		cAssembled = static_cast<int>(
+			smatMap.AssembleEntriesIfBuffered(
+				vecChunkEntries, cAssembled, c1, nThreads));
+	}
 
-		// Output every 100 elements
-		if (ixFirst % 1000 == 0) {
-                        Announce("Element %i/%i", ixFirst, meshInput.faces.size());
-		}
+	// Assemble the map entries of the remaining chunks in source face order
+	smatMap.AssembleEntries(vecChunkEntries, cAssembled, nChunks, nThreads);
+}
 
-		// This Face
-		const Face & faceFirst = meshInput.faces[ixFirst];
+///////////////////////////////////////////////////////////////////////////////
 
-		// Find the set of Faces that overlap faceFirst
-		int ixOverlapBegin = ixOverlap;
-		int ixOverlapEnd = ixOverlapBegin;
-	
-		for (; ixOverlapEnd < meshOverlap.faces.size(); ixOverlapEnd++) {
+///	<summary>
+///		Compute the integration array of the FV to GLL remapping operator
+///		over the nOverlapFaces overlap faces, starting at ixOverlap, that
+///		are associated with source face ixFirst.  dPowX and dPowY are
+///		scratch arrays.  NP is the order of the finite element if fixed at
+///		compile time, or 0 otherwise.
+///	</summary>
+template <int NP>
+static void BuildFVtoGLLIntegrationArray(
+	const Mesh & meshInput,
+	const Mesh & meshOutput,
+	const Mesh & meshOverlap,
+	const DataArray3D<double> & dataGLLJacobian,
+	const TriangularQuadratureRule & triquadrule,
+	int nOrder,
+	int nPRuntime,
+	int nMonotoneType,
+	int ixFirst,
+	int ixOverlap,
+	int nOverlapFaces,
+	DataArray1D<double> & dPowX,
+	DataArray1D<double> & dPowY,
+	DataArray3D<double> & dGlobalIntArray
+) {
+	// Order of the finite element
+	const int nP = (NP > 0)?(NP):(nPRuntime);
 
-			if (meshOverlap.vecSourceFaceIx[ixOverlapEnd] != ixFirst) {
-				break;
-			}
-		}
+	// Sample coefficients
+	GLLSampleCoeff<NP> dSampleCoeff(nP);
 
-		int nOverlapFaces = ixOverlapEnd - ixOverlapBegin;
+	const DataArray2D<double> & dG = triquadrule.GetG();
+	const DataArray1D<double> & dW = triquadrule.GetW();
 
-		// Create a new Mesh representing the division of target finite
-		// elements associated with this finite volume.
-		Mesh meshThisElement;
-		meshThisElement.faces.reserve(nOverlapFaces * nP * nP);
-		meshThisElement.vecTargetFaceIx.reserve(nOverlapFaces * nP * nP);
+	// This Face
+	const Face & faceFirst = meshInput.faces[ixFirst];
 
-		for (int i = ixOverlapBegin; i < ixOverlapEnd; i++) {
+	// Area of the First Face
+	double dFirstArea = meshInput.vecFaceArea[ixFirst];
 
-			int iTargetFace = meshOverlap.vecTargetFaceIx[i];
+	// Coordinate axes
+	FaceLocalCoordinates coords(faceFirst, meshInput.nodes);
 
-			int iSubElementBegin =  iTargetFace      * nP * nP;
-			int iSubElementEnd   = (iTargetFace + 1) * nP * nP;
+	const Node & nodeRef = coords.GetReferenceNode();
 
-			int iSubElement = iSubElementBegin;
-			for (int p = 0; p < nP; p++) {
-			for (int q = 0; q < nP; q++) {
+	// Loop through all Overlap Faces
+	for (int i = 0; i < nOverlapFaces; i++) {
 
-				// Calculate overlap polygon between sub-element
-				// and finite volume
-				NodeVector nodevecOutput;
+		// Quantities from the overlap Mesh
+		const Face & faceOverlap = meshOverlap.faces[ixOverlap + i];
 
-				GenerateOverlapFace<MeshUtilitiesFuzzy, Node>(
-					meshInput,
-					meshTargetSubElement,
-					ixFirst,
-					iSubElementBegin + p * nP + q,
-					nodevecOutput);
-/*
-				if (nodevecOutput.size() < 3) {
-					continue;
-				}
+		const NodeVector & nodesOverlap = meshOverlap.nodes;
 
-				Face faceNew(nodevecOutput.size());
-				for (int n = 0; n < nodevecOutput.size(); n++) {
-					faceNew.SetNode(n, n);
-				}
-				Real dArea = CalculateFaceArea(faceNew, nodevecOutput);
+		int nOverlapTriangles = faceOverlap.edges.size() - 2;
 
-				if (dArea < 1.0e-13) {
-					continue;
-				}
-*/
-/*
-				if (dataGLLNodes[p][q][iTargetFace] - 1 == 3) {
-					printf("%1.15e %1.15e %1.15e\n", dArea, dataGLLJacobian[p][q][iTargetFace], dataGLLNodalArea[dataGLLNodes[p][q][iTargetFace] - 1]);
-				}
-*/
-				Face faceNew(nodevecOutput.size());
-				for (int n = 0; n < nodevecOutput.size(); n++) {
-					meshThisElement.nodes.push_back(nodevecOutput[n]);
-					faceNew.SetNode(n, meshThisElement.nodes.size()-1);
-				}
+		// Quantities from the Second Mesh
+		int ixSecond = meshOverlap.vecTargetFaceIx[ixOverlap + i];
 
-				meshThisElement.faces.push_back(faceNew);
+		const NodeVector & nodesSecond = meshOutput.nodes;
 
-				meshThisElement.vecTargetFaceIx.push_back(
-					dataGLLNodes(p,q,iTargetFace) - 1);
+		const Face & faceSecond = meshOutput.faces[ixSecond];
 
-				iSubElement++;
-			}
-			}
-		}
+		// Loop over all sub-triangles of this Overlap Face
+		for (int j = 0; j < nOverlapTriangles; j++) {
 
-		if (meshThisElement.faces.size() != nOverlapFaces * nP * nP) {
-			_EXCEPTIONT("Logic error");
-		}
+			// Cornerpoints of triangle
+			const Node & node0 = nodesOverlap[faceOverlap[0]];
+			const Node & node1 = nodesOverlap[faceOverlap[j+1]];
+			const Node & node2 = nodesOverlap[faceOverlap[j+2]];
 
-		// Build integration array
-		DataArray2D<double> dIntArray;
+			// Calculate the area of the modified Face
+			Face faceTri(3);
+			faceTri.SetNode(0, faceOverlap[0]);
+			faceTri.SetNode(1, faceOverlap[j+1]);
+			faceTri.SetNode(2, faceOverlap[j+2]);
 
-		BuildIntegrationArray(
-			meshInput,
-			meshThisElement,
-			triquadrule,
-			ixFirst,
-			0,
-			meshThisElement.faces.size(),
-			nOrder,
-			dIntArray);
+			double dTriArea =
+				CalculateFaceArea(faceTri, nodesOverlap);
 
-		// Set of Faces to use in building the reconstruction and associated
-		// distance metric.
-		AdjacentFaceVector vecAdjFaces;
+			for (int k = 0; k < triquadrule.GetPoints(); k++) {
 
-		GetAdjacentFaceVectorByEdge(
-			meshInput,
-			ixFirst,
-			nRequiredFaceSetSize,
-			vecAdjFaces);
+				// Get the nodal location of this point
+				double dX[3];
 
-		// Number of adjacent Faces
-		int nAdjFaces = vecAdjFaces.size();
+				dX[0] = dG(k,0) * node0.x + dG(k,1) * node1.x + dG(k,2) * node2.x;
+				dX[1] = dG(k,0) * node0.y + dG(k,1) * node1.y + dG(k,2) * node2.y;
+				dX[2] = dG(k,0) * node0.z + dG(k,1) * node1.z + dG(k,2) * node2.z;
 
-		// Determine the conservative constraint equation
-		DataArray1D<double> dConstraint(nCoefficients);
+				double dMag =
+					sqrt(dX[0] * dX[0] + dX[1] * dX[1] + dX[2] * dX[2]);
 
-		double dFirstArea = meshInput.vecFaceArea[ixFirst];
+				dX[0] /= dMag;
+				dX[1] /= dMag;
+				dX[2] /= dMag;
 
-		for (int p = 0; p < nCoefficients; p++) {
-			for (int j = 0; j < meshThisElement.faces.size(); j++) {
-				dConstraint[p] += dIntArray(p,j);
-			}
-			dConstraint[p] /= dFirstArea;
-		}
+				Node nodeQuadrature(dX[0], dX[1], dX[2]);
 
-		// Least squares arrays
-		DataArray2D<double> dFitArray;
-		DataArray1D<double> dFitWeights;
-		DataArray2D<double> dFitArrayPlus;
+				dX[0] -= nodeRef.x;
+				dX[1] -= nodeRef.y;
+				dX[2] -= nodeRef.z;
 
-		BuildFitArray(
-			meshInput,
-			triquadrule,
-			ixFirst,
-			vecAdjFaces,
-			nOrder,
-			nFitWeightsExponent,
-			dConstraint,
-			dFitArray,
-			dFitWeights
-		);
+				// Find the coefficients for this point of the polynomial
+				coords.ToLocal(dX);
 
-		// Compute the inverse fit array
-		InvertFitArray_Corrected(
-			dConstraint,
-			dFitArray,
-			dFitWeights,
-			dFitArrayPlus
-		);
+				// Monomials at this point, shared by all GLL nodes
+				dPowX[0] = 1.0;
+				dPowY[0] = 1.0;
+				for (int p = 1; p < nOrder; p++) {
+					dPowX[p] = dPowX[p-1] * dX[0];
+					dPowY[p] = dPowY[p-1] * dX[1];
+				}
 
-		// Multiply integration array and fit array
-		DataArray2D<double> dComposedArray(nAdjFaces, meshThisElement.faces.size());
+				// Find the components of this quadrature point in the basis
+				// of the finite element.
+				double dAlpha;
+				double dBeta;
 
-		for (int i = 0; i < nAdjFaces; i++) {
-		for (int j = 0; j < meshThisElement.faces.size(); j++) {
-		for (int k = 0; k < nCoefficients; k++) {
-			dComposedArray(i,j) += dIntArray(k,j) * dFitArrayPlus(i,k);
-		}
-		}
-		}
+				ApplyInverseMap(
+					faceSecond,
+					nodesSecond,
+					nodeQuadrature,
+					dAlpha,
+					dBeta);
+/*
+				// Check inverse map value
+				if ((dAlpha < -1.0e-12) || (dAlpha > 1.0 + 1.0e-12) ||
+					(dBeta  < -1.0e-12) || (dBeta  > 1.0 + 1.0e-12)
+				) {
+					_EXCEPTION2("Inverse Map out of range (%1.5e %1.5e)",
+						dAlpha, dBeta);
+				}
+*/
+				// Sample the finite element at this point
+				dSampleCoeff.Sample(nMonotoneType, dAlpha, dBeta);
+
+				// Sample this point in the GLL element
+				int ixs = 0;
+				for (int s = 0; s < nP; s++) {
+				for (int t = 0; t < nP; t++) {
+/*
+					int ixu = 0;
+					for (int u = 0; u < nP; u++) {
+					for (int v = 0; v < nP; v++) {
+						dMassMatrix(ixSecond,ixs,ixu) +=
+							  dSampleCoeff(s,t)
+							* dSampleCoeff(u,v)
+							* dW[k]
+							* dTriArea;
 
-		// Apply redistribution operator
-		DataArray2D<double> dRedistributedArray(nAdjFaces, meshThisElement.faces.size());
+						ixu++;
+					}
+					}
+*/
+					int ixp = 0;
 
-		for (int i = 0; i < nAdjFaces; i++) {
-		for (int j = 0; j < meshThisElement.faces.size(); j++) {
-			int ixSubElement = j % (nP * nP);
-			int ixElement = j / (nP * nP);
+#ifdef RECTANGULAR_TRUNCATION
+					for (int p = 0; p < nOrder; p++) {
+					for (int q = 0; q < nOrder; q++) {
+#endif
+#ifdef TRIANGULAR_TRUNCATION 
+					for (int p = 0; p < nOrder; p++) {
+					for (int q = 0; q < nOrder - p; q++) {
+#endif
 
-			int ixSecondFace =
-				meshOverlap.vecTargetFaceIx[ixOverlap + ixElement];
+						dGlobalIntArray(ixp,ixOverlap + i,ixs) +=
+							  dSampleCoeff[s][t]
+							* dPowX[p]
+							* dPowY[q]
+							* dW[k]
+							* dTriArea
+							/ dataGLLJacobian(s,t,ixSecond);
 
-			for (int k = 0; k < nP * nP; k++) {
-				dRedistributedArray(i,j) +=
-					dComposedArray(i,ixElement * nP * nP + k)
-					* dRedistributionMaps[ixSecondFace](ixSubElement,k);
+						ixp++;
+					}
+					}
+					ixs++;
+				}
+				}
 			}
 		}
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Pointer to an instantiation of BuildFVtoGLLIntegrationArray.
+///	</summary>
+typedef void (*BuildFVtoGLLIntegrationArrayFunction)(
+	const Mesh &,
+	const Mesh &,
+	const Mesh &,
+	const DataArray3D<double> &,
+	const TriangularQuadratureRule &,
+	int,
+	int,
+	int,
+	int,
+	int,
+	int,
+	DataArray1D<double> &,
+	DataArray1D<double> &,
+	DataArray3D<double> &);
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Compose the fit operator of source face ixFirst with the
+///		integration array of its nOverlapFaces overlap faces, starting at
+///		ixOverlap, and append the resulting FV to GLL map entries to
+///		vecEntries.
+///	</summary>
+static void ComposeFVtoGLLFace(
+	const Mesh & meshInput,
+	const Mesh & meshOverlap,
+	const DataArray3D<int> & dataGLLNodes,
+	const DataArray3D<double> & dataGLLJacobian,
+	const DataArray1D<double> & dataGLLNodalArea,
+	const TriangularQuadratureRule & triquadrule,
+	const DataArray3D<double> & dGlobalIntArray,
+	int nOrder,
+	int nP,
+	int nCoefficients,
+	int nRequiredFaceSetSize,
+	int nFitWeightsExponent,
+	const FVFitArrayCache * pFitCache,
+	bool fContinuous,
+	int ixFirst,
+	int ixOverlap,
+	int nOverlapFaces,
+	std::vector< SparseMatrixEntry<double> > & vecEntries
+) {
+	// This Face
+	const Face & faceFirst = meshInput.faces[ixFirst];
+
+	// Area of the First Face
+	double dFirstArea = meshInput.vecFaceArea[ixFirst];
+
+/*
+	// Verify equal partition of mass in integration array
+	double dTotal = 0.0;
+	for (int i = 0; i < nOverlapFaces; i++) {
+		int ixSecond = meshOverlap.vecTargetFaceIx[ixOverlap + i];
+
+		for (int s = 0; s < nP * nP; s++) {
+			dTotal += dGlobalIntArray[0][ixOverlap + i][s]
+				* dataGLLJacobian[s/nP][s%nP][ixSecond]
+				/ dFirstArea;
 		}
+	}
+	if (fabs(dTotal - 1.0) > 1.0e-8) {
+		printf("%1.15e\n", dTotal);
+		_EXCEPTION();
+	}
+*/
+	// Determine the conservative constraint equation
+	DataArray1D<double> dConstraint(nCoefficients, true, DataArrayStorage_Pooled);
 
-		// Put composed array into map
-		for (int i = 0; i < vecAdjFaces.size(); i++) {
-		for (int j = 0; j < meshThisElement.faces.size(); j++) {
-			int ixFirstFace = vecAdjFaces[i].first;
-			int ixSecondNode = meshThisElement.vecTargetFaceIx[j];
+	for (int p = 0; p < nCoefficients; p++) {
+	for (int i = 0; i < nOverlapFaces; i++) {
+		int ixSecond = meshOverlap.vecTargetFaceIx[ixOverlap + i];
 
-			smatMap(ixSecondNode, ixFirstFace) +=
-				dRedistributedArray(i,j)
-				/ dataGLLNodalArea[ixSecondNode];
-				// meshThisElement.vecFaceArea[j];
-				// dataGLLJacobian(ixS,ixT,ixSecondElement);
+		for (int s = 0; s < nP * nP; s++) {
+			dConstraint[p] += dGlobalIntArray[p][ixOverlap + i][s]
+				* dataGLLJacobian[s/nP][s%nP][ixSecond]
+				/ dFirstArea;
 		}
+	}
+	}
+
+/*
+	for (int p = 0; p < nCoefficients; p++) {
+	for (int j = 0; j < nOverlapFaces * nP * nP; j++) {
+		dConstraint[p] += dIntArray[p][j] / dFirstArea;
+	}
+	}
+*/
+	// Set of Faces to use in building the reconstruction and associated
+	// distance metric.
+	AdjacentFaceVector vecAdjFaces;
+
+	GetAdjacentFaceVectorByEdge(
+		meshInput,
+		ixFirst,
+		nRequiredFaceSetSize,
+		vecAdjFaces);
+
+	// Number of adjacent Faces
+	int nAdjFaces = vecAdjFaces.size();
+
+	for (int x = 0; x < nAdjFaces; x++) {
+		if (vecAdjFaces[x].first == (-1)) {
+			_EXCEPTION();
 		}
+	}
 
-		// Increment the current overlap index
-		ixOverlap += nOverlapFaces;
+	// Build the fit operator
+	DataArray2D<double> dFitArray;
+	DataArray1D<double> dFitWeights;
+	DataArray2D<double> dFitArrayPlus;
+
+	BuildFitArrayCached(
+		pFitCache,
+		meshInput,
+		triquadrule,
+		ixFirst,
+		vecAdjFaces,
+		nOrder,
+		nFitWeightsExponent,
+		dConstraint,
+		dFitArray,
+		dFitWeights
+	);
+
+	// Compute the inverse fit array
+	InvertFitArray_Corrected(
+		dConstraint,
+		dFitArray,
+		dFitWeights,
+		dFitArrayPlus
+	);
+
+/*
+	DataArray1D<double> dRowSum;
+	dRowSum.Initialize(nCoefficients);
+
+	for (int i = 0; i < nAdjFaces; i++) {
+	for (int k = 0; k < nCoefficients; k++) {
+		dRowSum[k] += dFitArrayPlus[i][k];
+	}
+	}
+
+	for (int k = 0; k < nCoefficients; k++) {
+		printf("%1.15e\n", dRowSum[k]);
+	}
+	_EXCEPTION();
+*/
+	// Multiply integration array and fit array
+	DataArray2D<double> dComposedArray(nAdjFaces, nOverlapFaces * nP * nP, true, DataArrayStorage_Pooled);
+
+	// Row k of the integration array for these overlap faces is contiguous
+	// in dGlobalIntArray, starting at entry (k, ixOverlap, 0)
+	DenseMatrixProductAdd(
+		nAdjFaces,
+		nOverlapFaces * nP * nP,
+		nCoefficients,
+		&(dFitArrayPlus(0,0)),
+		static_cast<int>(dFitArrayPlus.GetColumns()),
+		&(dGlobalIntArray(0,ixOverlap,0)),
+		static_cast<int>(
+			dGlobalIntArray.GetColumns() * dGlobalIntArray.GetSubColumns()),
+		&(dComposedArray(0,0)),
+		static_cast<int>(dComposedArray.GetColumns()));
+
+	// Put composed array into the list of map entries
+	for (int i = 0; i < vecAdjFaces.size(); i++) {
+	for (int j = 0; j < nOverlapFaces; j++) {
+		int ixFirstFace = vecAdjFaces[i].first;
+		int ixSecondFace = meshOverlap.vecTargetFaceIx[ixOverlap + j];
+
+		for (int s = 0; s < nP; s++) {
+		for (int t = 0; t < nP; t++) {
+
+			int jx = j * nP * nP + s * nP + t;
+
+			if (fContinuous) {
+				int ixSecondNode = dataGLLNodes[s][t][ixSecondFace] - 1;
+
+				vecEntries.push_back(SparseMatrixEntry<double>(
+					ixSecondNode,
+					ixFirstFace,
+					dComposedArray[i][jx]
+					* dataGLLJacobian[s][t][ixSecondFace]
+					/ dataGLLNodalArea[ixSecondNode]));
+
+			} else {
+				int ixSecondNode = ixSecondFace * nP * nP + s * nP + t;
 
-		//_EXCEPTION();
+				vecEntries.push_back(SparseMatrixEntry<double>(
+					ixSecondNode,
+					ixFirstFace,
+					dComposedArray[i][jx]));
+			}
+		}
+		}
+	}
 	}
 }
 
@@ -2113,11 +3281,13 @@ void LinearRemapFVtoGLL(
 	OfflineMap & mapRemap,
 	int nMonotoneType,
 	bool fContinuous,
-	bool fNoConservation
+	bool fNoConservation,
+	int nThreads,
+	const FVFitArrayCache * pFitCache
 ) {
-	// NOTE: Reducing this quadrature rule order greatly affects error norms
 	// Order of triangular quadrature rule
-	const int TriQuadRuleOrder = 8;
+	const int TriQuadRuleOrder =
+		GetFVFitArrayTriQuadRuleOrder(true, false);
 
 	// Verify ReverseNodeArray has been calculated
 	if (meshInput.revnodearray.size() == 0) {
@@ -2126,12 +3296,18 @@ void LinearRemapFVtoGLL(
 	if (meshInput.edgemap.size() == 0) {
 		_EXCEPTIONT("EdgeMap has not been calculated for meshInput");
 	}
+	if (nThreads < 1) {
+		_EXCEPTIONT("Thread count must be at least 1");
+	}
+	if ((pFitCache != NULL) &&
+		!pFitCache->Matches(nOrder, TriQuadRuleOrder, meshInput.faces.size())
+	) {
+		_EXCEPTIONT("FVFitArrayCache does not match meshInput and nOrder");
+	}
 
 	// Triangular quadrature rule
-	TriangularQuadratureRule triquadrule(TriQuadRuleOrder);
-
-	const DataArray2D<double> & dG = triquadrule.GetG();
-	const DataArray1D<double> & dW = triquadrule.GetW();
+	const TriangularQuadratureRule & triquadrule =
+		TriangularQuadratureRule::Get(TriQuadRuleOrder);
 
 	// Get SparseMatrix represntation of the OfflineMap
 	SparseMatrix<double> & smatMap = mapRemap.GetSparseMatrix();
@@ -2142,9 +3318,6 @@ void LinearRemapFVtoGLL(
 	// Order of the finite element method
 	int nP = dataGLLNodes.GetRows();
 
-	// Sample coefficients
-	DataArray2D<double> dSampleCoeff(nP, nP);
-
 	// Number of elements needed
 #ifdef RECTANGULAR_TRUNCATION
 	int nCoefficients = nOrder * nOrder;
@@ -2161,8 +3334,13 @@ void LinearRemapFVtoGLL(
 	Announce("Required adjacency set size: %i", nRequiredFaceSetSize);
 	Announce("Fit weights exponent: %i", nFitWeightsExponent);
 
-	// Current overlap face
-	int ixOverlap = 0;
+	if ((meshOverlap.overlapfaceindex.GetSourceFaceCount() !=
+			meshInput.faces.size()) ||
+		(meshOverlap.overlapfaceindex.GetTargetFaceCount() !=
+			meshOutput.faces.size())
+	) {
+		_EXCEPTIONT("OverlapFaceIndex has not been constructed for meshOverlap");
+	}
 
 	// Build the integration array for each element on meshOverlap
 	DataArray3D<double> dGlobalIntArray(
@@ -2179,210 +3357,62 @@ void LinearRemapFVtoGLL(
 */
 	// Number of overlap Faces per source Face
 	DataArray1D<int> nAllOverlapFaces(meshInput.faces.size());
-	DataArray1D<int> nAllTotalOverlapTriangles(meshInput.faces.size());
 
 	for (int ixFirst = 0; ixFirst < meshInput.faces.size(); ixFirst++) {
-
-		int ixOverlapTemp = ixOverlap;
-		for (; ixOverlapTemp < meshOverlap.faces.size(); ixOverlapTemp++) {
-
-			const Face & faceOverlap = meshOverlap.faces[ixOverlapTemp];
-
-			if (meshOverlap.vecSourceFaceIx[ixOverlapTemp] != ixFirst) {
-				break;
-			}
-
-			nAllOverlapFaces[ixFirst]++;
-			nAllTotalOverlapTriangles[ixFirst] += faceOverlap.edges.size() - 2;
-		}
-
-		// Increment the current overlap index
-		ixOverlap += nAllOverlapFaces[ixFirst];
+		nAllOverlapFaces[ixFirst] =
+			meshOverlap.overlapfaceindex.SourceCount(ixFirst);
 	}
 
-	// Loop through all faces on meshInput
-	ixOverlap = 0;
-
-	for (int ixFirst = 0; ixFirst < meshInput.faces.size(); ixFirst++) {
-
-		// Output every 100 elements
-		if (ixFirst % 1000 == 0) {
-                        Announce("Element %i/%i", ixFirst, meshInput.faces.size());
-		}
-
-		// This Face
-		const Face & faceFirst = meshInput.faces[ixFirst];
-
-		// Area of the First Face
-		double dFirstArea = meshInput.vecFaceArea[ixFirst];
-
-		// Coordinate axes
-		Node nodeRef = GetReferenceNode(faceFirst, meshInput.nodes);
-
-		Node nodeA1 = meshInput.nodes[faceFirst[1]] - nodeRef;
-		Node nodeA2 = meshInput.nodes[faceFirst[2]] - nodeRef;
-
-		Node nodeC = CrossProduct(nodeA1, nodeA2);
-
-		// Fit matrix
-		DataArray2D<double> dFit(3,3);
-
-		dFit(0,0) = nodeA1.x; dFit(0,1) = nodeA1.y; dFit(0,2) = nodeA1.z;
-		dFit(1,0) = nodeA2.x; dFit(1,1) = nodeA2.y; dFit(1,2) = nodeA2.z;
-		dFit(2,0) = nodeC.x;  dFit(2,1) = nodeC.y;  dFit(2,2) = nodeC.z;
-
-		// Number of overlapping Faces and triangles
-		int nOverlapFaces = nAllOverlapFaces[ixFirst];
-		int nTotalOverlapTriangles = nAllTotalOverlapTriangles[ixFirst];
-
-		// Loop through all Overlap Faces
-		for (int i = 0; i < nOverlapFaces; i++) {
-
-			// Quantities from the overlap Mesh
-			const Face & faceOverlap = meshOverlap.faces[ixOverlap + i];
-
-			const NodeVector & nodesOverlap = meshOverlap.nodes;
-
-			int nOverlapTriangles = faceOverlap.edges.size() - 2;
-
-			// Quantities from the Second Mesh
-			int ixSecond = meshOverlap.vecTargetFaceIx[ixOverlap + i];
-
-			const NodeVector & nodesSecond = meshOutput.nodes;
-
-			const Face & faceSecond = meshOutput.faces[ixSecond];
-
-			// Loop over all sub-triangles of this Overlap Face
-			for (int j = 0; j < nOverlapTriangles; j++) {
-
-				// Cornerpoints of triangle
-				const Node & node0 = nodesOverlap[faceOverlap[0]];
-				const Node & node1 = nodesOverlap[faceOverlap[j+1]];
-				const Node & node2 = nodesOverlap[faceOverlap[j+2]];
-
-				// Calculate the area of the modified Face
-				Face faceTri(3);
-				faceTri.SetNode(0, faceOverlap[0]);
-				faceTri.SetNode(1, faceOverlap[j+1]);
-				faceTri.SetNode(2, faceOverlap[j+2]);
-
-				double dTriArea =
-					CalculateFaceArea(faceTri, nodesOverlap);
-
-				for (int k = 0; k < triquadrule.GetPoints(); k++) {
-
-					// Get the nodal location of this point
-					double dX[3];
-
-					dX[0] = dG(k,0) * node0.x + dG(k,1) * node1.x + dG(k,2) * node2.x;
-					dX[1] = dG(k,0) * node0.y + dG(k,1) * node1.y + dG(k,2) * node2.y;
-					dX[2] = dG(k,0) * node0.z + dG(k,1) * node1.z + dG(k,2) * node2.z;
-
-					double dMag =
-						sqrt(dX[0] * dX[0] + dX[1] * dX[1] + dX[2] * dX[2]);
-
-					dX[0] /= dMag;
-					dX[1] /= dMag;
-					dX[2] /= dMag;
-
-					Node nodeQuadrature(dX[0], dX[1], dX[2]);
-
-					dX[0] -= nodeRef.x;
-					dX[1] -= nodeRef.y;
-					dX[2] -= nodeRef.z;
-
-					// Find the coefficients for this point of the polynomial
-					int n = 3;
-					int nrhs = 1;
-					int lda = 3;
-					int ipiv[3];
-					int ldb = 3;
-					int info;
-
-					DataArray2D<double> dFitTemp;
-					dFitTemp = dFit;
-					dgesv_(
-						&n, &nrhs, &(dFitTemp(0,0)), &lda, ipiv, dX, &ldb, &info);
-
-					// Find the components of this quadrature point in the basis
-					// of the finite element.
-					double dAlpha;
-					double dBeta;
-
-					ApplyInverseMap(
-						faceSecond,
-						nodesSecond,
-						nodeQuadrature,
-						dAlpha,
-						dBeta);
-/*
-					// Check inverse map value
-					if ((dAlpha < -1.0e-12) || (dAlpha > 1.0 + 1.0e-12) ||
-						(dBeta  < -1.0e-12) || (dBeta  > 1.0 + 1.0e-12)
-					) {
-						_EXCEPTION2("Inverse Map out of range (%1.5e %1.5e)",
-							dAlpha, dBeta);
-					}
-*/
-					// Sample the finite element at this point
-					SampleGLLFiniteElement(
-						nMonotoneType,
-						nP,
-						dAlpha,
-						dBeta,
-						dSampleCoeff);
-
-					// Sample this point in the GLL element
-					int ixs = 0;
-					for (int s = 0; s < nP; s++) {
-					for (int t = 0; t < nP; t++) {
-/*
-						int ixu = 0;
-						for (int u = 0; u < nP; u++) {
-						for (int v = 0; v < nP; v++) {
-							dMassMatrix(ixSecond,ixs,ixu) +=
-								  dSampleCoeff(s,t)
-								* dSampleCoeff(u,v)
-								* dW[k]
-								* dTriArea;
+	// Index of the first overlap Face associated with each source Face
+	const std::vector<int> & vecOverlapBegin =
+		meshOverlap.overlapfaceindex.GetSourceOffsets();
 
-							ixu++;
-						}
-						}
-*/
-						int ixp = 0;
+	OmpExceptionCapture capture;
 
-#ifdef RECTANGULAR_TRUNCATION
-						for (int p = 0; p < nOrder; p++) {
-						for (int q = 0; q < nOrder; q++) {
-#endif
-#ifdef TRIANGULAR_TRUNCATION 
-						for (int p = 0; p < nOrder; p++) {
-						for (int q = 0; q < nOrder - p; q++) {
-#endif
+	// Use the kernel specialized to the order of the finite element, if
+	// available
+	BuildFVtoGLLIntegrationArrayFunction fnBuildIntArray;
+	switch (nP) {
+		case 2: fnBuildIntArray = BuildFVtoGLLIntegrationArray<2>; break;
+		case 3: fnBuildIntArray = BuildFVtoGLLIntegrationArray<3>; break;
+		case 4: fnBuildIntArray = BuildFVtoGLLIntegrationArray<4>; break;
+		default: fnBuildIntArray = BuildFVtoGLLIntegrationArray<0>; break;
+	}
 
-							dGlobalIntArray(ixp,ixOverlap + i,ixs) +=
-								  dSampleCoeff(s,t)
-								* IPow(dX[0], p)
-								* IPow(dX[1], q)
-								* dW[k]
-								* dTriArea
-								/ dataGLLJacobian(s,t,ixSecond);
+	// Loop through all faces on meshInput; each source Face writes only
+	// to the integration array of its own overlap Faces
+	Announce("Building integration array");
 
-							ixp++;
-						}
-						}
-						ixs++;
-					}
-					}
-				}
-			}
+#pragma omp parallel num_threads(nThreads)
+	{
+		// Scratch arrays, allocated once per thread
+		DataArray1D<double> dPowX(nOrder);
+		DataArray1D<double> dPowY(nOrder);
+
+#pragma omp for schedule(dynamic, 16)
+		for (int ixFirst = 0; ixFirst < meshInput.faces.size(); ixFirst++) {
+			capture.Run([&]() {
+				(*fnBuildIntArray)(
+					meshInput,
+					meshOutput,
+					meshOverlap,
+					dataGLLJacobian,
+					triquadrule,
+					nOrder,
+					nP,
+					nMonotoneType,
+					ixFirst,
+					vecOverlapBegin[ixFirst],
+					nAllOverlapFaces[ixFirst],
+					dPowX,
+					dPowY,
+					dGlobalIntArray);
+			});
 		}
-
-		// Increment the current overlap index
-		ixOverlap += nOverlapFaces;
 	}
 
+	capture.Rethrow();
+
 /*
 	// Calculate inverse mass matrix over all target elements
 	ixOverlap = 0;
@@ -2456,14 +3486,6 @@ void LinearRemapFVtoGLL(
 		ixOverlap += nOverlapFaces;
 	}
 */
-	// Reverse map
-	std::vector< std::vector<int> > vecReverseFaceIx;
-	vecReverseFaceIx.resize(meshOutput.faces.size());
-	for (int i = 0; i < meshOverlap.faces.size(); i++) {
-		int ixSecond = meshOverlap.vecTargetFaceIx[i];
-
-		vecReverseFaceIx[ixSecond].push_back(i);
-	}
 /*
 	for (int ixOverlap = 0; ixOverlap < meshOverlap.faces.size(); ixOverlap++) {
 		int ixSecond = meshOverlap.vecTargetFaceIx[ixOverlap];
@@ -2477,109 +3499,118 @@ void LinearRemapFVtoGLL(
 		}
 	}
 */
-	// Force consistency and conservation
+	// Force consistency and conservation; each overlap Face is associated
+	// with a single target Face, so target Faces are independent
+#pragma omp parallel for schedule(dynamic, 16) num_threads(nThreads)
 	for (int ixSecond = 0; ixSecond < meshOutput.faces.size(); ixSecond++) {
+		capture.Run([&]() {
+			// Overlap Faces associated with this target Face
+			ReverseNodeArray::FaceRange vecReverseFaceIx =
+				meshOverlap.overlapfaceindex.TargetFaces(ixSecond);
 
-		if (vecReverseFaceIx[ixSecond].size() == 0) {
-			continue;
-		}
+			if (vecReverseFaceIx.size() == 0) {
+				return;
+			}
 
-		DataArray2D<double> dCoeff(
-			nP * nP,
-			vecReverseFaceIx[ixSecond].size());
+			DataArray2D<double> dCoeff(
+				nP * nP,
+				vecReverseFaceIx.size());
 
-		for (int i = 0; i < vecReverseFaceIx[ixSecond].size(); i++) {
-			int ixOverlap = vecReverseFaceIx[ixSecond][i];
+			for (int i = 0; i < vecReverseFaceIx.size(); i++) {
+				int ixOverlap = vecReverseFaceIx[i];
 
-			for (int s = 0; s < nP * nP; s++) {
-				dCoeff[s][i] = dGlobalIntArray(0,ixOverlap,s);
+				for (int s = 0; s < nP * nP; s++) {
+					dCoeff[s][i] = dGlobalIntArray(0,ixOverlap,s);
+				}
 			}
-		}
 
-		// Target areas
-		DataArray1D<double> vecTargetArea(nP * nP);
+			// Target areas
+			DataArray1D<double> vecTargetArea(nP * nP);
 
-		for (int s = 0; s < nP * nP; s++) {
-			vecTargetArea[s] =
-				dataGLLJacobian(s/nP,s%nP,ixSecond);
-		}
+			for (int s = 0; s < nP * nP; s++) {
+				vecTargetArea[s] =
+					dataGLLJacobian(s/nP,s%nP,ixSecond);
+			}
 
-		// Source areas
-		DataArray1D<double> vecSourceArea(vecReverseFaceIx[ixSecond].size());
+			// Source areas
+			DataArray1D<double> vecSourceArea(vecReverseFaceIx.size());
 
-		for (int i = 0; i < vecReverseFaceIx[ixSecond].size(); i++) {
-			int ixOverlap = vecReverseFaceIx[ixSecond][i];
-			vecSourceArea[i] = meshOverlap.vecFaceArea[ixOverlap];
-		}
+			for (int i = 0; i < vecReverseFaceIx.size(); i++) {
+				int ixOverlap = vecReverseFaceIx[i];
+				vecSourceArea[i] = meshOverlap.vecFaceArea[ixOverlap];
+			}
 
-		if (!fNoConservation) {
-			ForceIntArrayConsistencyConservation(
-				vecSourceArea,
-				vecTargetArea,
-				dCoeff,
-				(nMonotoneType != 0));
-		}
+			if (!fNoConservation) {
+				ForceIntArrayConsistencyConservation(
+					vecSourceArea,
+					vecTargetArea,
+					dCoeff,
+					(nMonotoneType != 0));
+			}
 /*
-		for (int i = 0; i < dCoeff.GetRows(); i++) {
-			double dConsistency = 0.0;
-			for (int j = 0; j < dCoeff.GetColumns(); j++) {
-				dConsistency += dCoeff(i,j);
+			for (int i = 0; i < dCoeff.GetRows(); i++) {
+				double dConsistency = 0.0;
+				for (int j = 0; j < dCoeff.GetColumns(); j++) {
+					dConsistency += dCoeff(i,j);
+				}
+				//printf("%1.15e\n", dConsistency);
 			}
-			//printf("%1.15e\n", dConsistency);
-		}
 */
-		for (int i = 0; i < vecReverseFaceIx[ixSecond].size(); i++) {
-			int ixOverlap = vecReverseFaceIx[ixSecond][i];
+			for (int i = 0; i < vecReverseFaceIx.size(); i++) {
+				int ixOverlap = vecReverseFaceIx[i];
 
-			for (int s = 0; s < nP * nP; s++) {
-				//printf("%1.15e %1.15e\n", dGlobalIntArray[0][ixOverlap][s], dCoeff[s][i]);
-				dGlobalIntArray(0,ixOverlap,s) = dCoeff(s,i);
+				for (int s = 0; s < nP * nP; s++) {
+					//printf("%1.15e %1.15e\n", dGlobalIntArray[0][ixOverlap][s], dCoeff[s][i]);
+					dGlobalIntArray(0,ixOverlap,s) = dCoeff(s,i);
+				}
 			}
-		}
 
 /*
-		for (int i = 0; i < dCoeff.GetRows(); i++) {
-			double dConsistency = 0.0;
-			for (int j = 0; j < dCoeff.GetColumns(); j++) {
-				dConsistency += dCoeff(i,j);
+			for (int i = 0; i < dCoeff.GetRows(); i++) {
+				double dConsistency = 0.0;
+				for (int j = 0; j < dCoeff.GetColumns(); j++) {
+					dConsistency += dCoeff(i,j);
+				}
+				printf("%1.15e\n", dConsistency);
 			}
-			printf("%1.15e\n", dConsistency);
-		}
 
-		for (int i = 0; i < dCoeff.GetRows(); i++) {
-			int ixFirst = vecReverseFaceIx(ixSecond,i)
+			for (int i = 0; i < dCoeff.GetRows(); i++) {
+				int ixFirst = vecReverseFaceIx(ixSecond,i)
 
-			for (int s = 0; s < dCoeff.GetColumns(); s++) {
-				vecTargetArea[i] += dCoeff(i,s)
-					* dataGLLJacobian(s/nP,s%nP,ixSecond)
-					 meshInput.vecFaceArea[ixFirst];
+				for (int s = 0; s < dCoeff.GetColumns(); s++) {
+					vecTargetArea[i] += dCoeff(i,s)
+						* dataGLLJacobian(s/nP,s%nP,ixSecond)
+						 meshInput.vecFaceArea[ixFirst];
+				}
+				printf("%1.15e\n", vecTargetArea[i]);
 			}
-			printf("%1.15e\n", vecTargetArea[i]);
-		}
 */
 /*
-		double dConsistency = 0.0;
-		double dConservation = 0.0;
+			double dConsistency = 0.0;
+			double dConservation = 0.0;
 
-		int ixFirst = meshOverlap.vecSourceFaceIx[i];
-		int ixSecond = meshOverlap.vecTargetFaceIx[i];
+			int ixFirst = meshOverlap.vecSourceFaceIx[i];
+			int ixSecond = meshOverlap.vecTargetFaceIx[i];
 
-		for (int s = 0; s < nP * nP; s++) {
-			//dConsistency += dGlobalIntArray(0,i,s)
-			dConservation += dGlobalIntArray(0,i,s)
-				* dataGLLJacobian(s/nP,s%nP,ixSecond)
-				/ meshInput.vecFaceArea[ixFirst];
+			for (int s = 0; s < nP * nP; s++) {
+				//dConsistency += dGlobalIntArray(0,i,s)
+				dConservation += dGlobalIntArray(0,i,s)
+					* dataGLLJacobian(s/nP,s%nP,ixSecond)
+					/ meshInput.vecFaceArea[ixFirst];
 
-			printf("%1.15e\n", dataGLLJacobian(s/nP,s%nP,ixSecond));
-		}
+				printf("%1.15e\n", dataGLLJacobian(s/nP,s%nP,ixSecond));
+			}
 
-		//printf("Consistency: %1.15e\n", dConsistency);
-		printf("Conservation: %1.15e\n", dConservation);
+			//printf("Consistency: %1.15e\n", dConsistency);
+			printf("Conservation: %1.15e\n", dConservation);
 
-		_EXCEPTION();
+			_EXCEPTION();
 */
+		});
 	}
 
+	capture.Rethrow();
+
 /*
 	// Check consistency
 	DataArray2D<double> dIntSums(meshOutput.faces.size(), nP * nP);
@@ -2622,254 +3653,113 @@ void LinearRemapFVtoGLL(
 	for (int i = 0; i < meshOverlap.faces.size(); i++) {
 	for (int s = 0; s < nP * nP; s++) {
 		dOverlapMass[i] += dGlobalIntArray[0][i][s];
-	}
-	}
-*/
-	// Impose conservative and consistent conditions on integration array
-	//_EXCEPTION();
-
-	// Construct finite-volume fit matrix and compose with integration operator
-	ixOverlap = 0;
-
-	for (int ixFirst = 0; ixFirst < meshInput.faces.size(); ixFirst++) {
-
-		// Output every 100 elements
-		if (ixFirst % 1000 == 0) {
-                        Announce("Element %i/%i", ixFirst, meshInput.faces.size());
-		}
-
-		// This Face
-		const Face & faceFirst = meshInput.faces[ixFirst];
-
-		// Area of the First Face
-		double dFirstArea = meshInput.vecFaceArea[ixFirst];
-
-		// Number of overlapping Faces and triangles
-		int nOverlapFaces = nAllOverlapFaces[ixFirst];
-		int nTotalOverlapTriangles = nAllTotalOverlapTriangles[ixFirst];
-/*
-		// Verify equal partition of mass in integration array
-		double dTotal = 0.0;
-		for (int i = 0; i < nOverlapFaces; i++) {
-			int ixSecond = meshOverlap.vecTargetFaceIx[ixOverlap + i];
-
-			for (int s = 0; s < nP * nP; s++) {
-				dTotal += dGlobalIntArray[0][ixOverlap + i][s]
-					* dataGLLJacobian[s/nP][s%nP][ixSecond]
-					/ dFirstArea;
-			}
-		}
-		if (fabs(dTotal - 1.0) > 1.0e-8) {
-			printf("%1.15e\n", dTotal);
-			_EXCEPTION();
-		}
-*/
-		// Determine the conservative constraint equation
-		DataArray1D<double> dConstraint(nCoefficients);
-
-		for (int p = 0; p < nCoefficients; p++) {
-		for (int i = 0; i < nOverlapFaces; i++) {
-			int ixSecond = meshOverlap.vecTargetFaceIx[ixOverlap + i];
-
-			for (int s = 0; s < nP * nP; s++) {
-				dConstraint[p] += dGlobalIntArray[p][ixOverlap + i][s]
-					* dataGLLJacobian[s/nP][s%nP][ixSecond]
-					/ dFirstArea;
-			}
-		}
-		}
-
-/*
-		for (int p = 0; p < nCoefficients; p++) {
-		for (int j = 0; j < nOverlapFaces * nP * nP; j++) {
-			dConstraint[p] += dIntArray[p][j] / dFirstArea;
-		}
-		}
-*/
-		// Set of Faces to use in building the reconstruction and associated
-		// distance metric.
-		AdjacentFaceVector vecAdjFaces;
-
-		GetAdjacentFaceVectorByEdge(
-			meshInput,
-			ixFirst,
-			nRequiredFaceSetSize,
-			vecAdjFaces);
-
-		// Number of adjacent Faces
-		int nAdjFaces = vecAdjFaces.size();
-
-		for (int x = 0; x < nAdjFaces; x++) {
-			if (vecAdjFaces[x].first == (-1)) {
-				_EXCEPTION();
-			}
-		}
-
-		// Build the fit operator
-		DataArray2D<double> dFitArray;
-		DataArray1D<double> dFitWeights;
-		DataArray2D<double> dFitArrayPlus;
-
-		BuildFitArray(
-			meshInput,
-			triquadrule,
-			ixFirst,
-			vecAdjFaces,
-			nOrder,
-			nFitWeightsExponent,
-			dConstraint,
-			dFitArray,
-			dFitWeights
-		);
-
-		// Compute the inverse fit array
-		InvertFitArray_Corrected(
-			dConstraint,
-			dFitArray,
-			dFitWeights,
-			dFitArrayPlus
-		);
-
-/*
-		DataArray1D<double> dRowSum;
-		dRowSum.Initialize(nCoefficients);
-
-		for (int i = 0; i < nAdjFaces; i++) {
-		for (int k = 0; k < nCoefficients; k++) {
-			dRowSum[k] += dFitArrayPlus[i][k];
-		}
-		}
-
-		for (int k = 0; k < nCoefficients; k++) {
-			printf("%1.15e\n", dRowSum[k]);
-		}
-		_EXCEPTION();
-*/
-		// Multiply integration array and fit array
-		DataArray2D<double> dComposedArray(nAdjFaces, nOverlapFaces * nP * nP);
-
-		for (int j = 0; j < nOverlapFaces; j++) {
-			int ixSecond = meshOverlap.vecTargetFaceIx[ixOverlap + j];
-
-			for (int i = 0; i < nAdjFaces; i++) {
-			for (int s = 0; s < nP * nP; s++) {
-			for (int k = 0; k < nCoefficients; k++) {
-				dComposedArray[i][j * nP * nP + s] +=
-					dGlobalIntArray[k][ixOverlap + j][s]
-					* dFitArrayPlus[i][k];
-			}
-			}
-			}
-		}
-
-		// Put composed array into map
-		for (int i = 0; i < vecAdjFaces.size(); i++) {
-		for (int j = 0; j < nOverlapFaces; j++) {
-			int ixFirstFace = vecAdjFaces[i].first;
-			int ixSecondFace = meshOverlap.vecTargetFaceIx[ixOverlap + j];
-
-			for (int s = 0; s < nP; s++) {
-			for (int t = 0; t < nP; t++) {
-
-				int jx = j * nP * nP + s * nP + t;
-
-				if (fContinuous) {
-					int ixSecondNode = dataGLLNodes[s][t][ixSecondFace] - 1;
-
-					smatMap(ixSecondNode, ixFirstFace) +=
-						dComposedArray[i][jx]
-						* dataGLLJacobian[s][t][ixSecondFace]
-						/ dataGLLNodalArea[ixSecondNode];
-
-				} else {
-					int ixSecondNode = ixSecondFace * nP * nP + s * nP + t;
+	}
+	}
+*/
+	// Impose conservative and consistent conditions on integration array
+	//_EXCEPTION();
 
-					smatMap(ixSecondNode, ixFirstFace) +=
-						dComposedArray[i][jx];
+	// Construct finite-volume fit matrix and compose with integration
+	// operator in chunks of contiguous source faces, buffering the map
+	// entries of each chunk and accumulating them in source face order
+	const int nInputFaces = static_cast<int>(meshInput.faces.size());
+
+	const int nChunks =
+		(nInputFaces + LinearRemapFVChunkSize - 1) / LinearRemapFVChunkSize;
+
+	// Chunks are processed in rounds to report progress.  The entries of
+	// completed rounds are assembled into the map once they outnumber its
+	// nonzeros, which bounds the number of buffered entries held in memory
+	// at once by the size of the map.
+	const int nChunksPerRound = 4 * nThreads;
+
+	int cAssembled = 0;
+
+	std::vector< std::vector< SparseMatrixEntry<double> > >
+		vecChunkEntries(nChunks);
+
+	for (int c0 = 0; c0 < nChunks; c0 += nChunksPerRound) {
+		const int c1 = std::min(c0 + nChunksPerRound, nChunks);
+
+		Announce("Element %i/%i", c0 * LinearRemapFVChunkSize, nInputFaces);
+
+#pragma omp parallel for schedule(dynamic) num_threads(nThreads)
+		for (int c = c0; c < c1; c++) {
+			const int ixFirstBegin = c * LinearRemapFVChunkSize;
+			const int ixFirstEnd =
+				std::min(ixFirstBegin + LinearRemapFVChunkSize, nInputFaces);
+
+			capture.Run([&]() {
+				for (int ixFirst = ixFirstBegin; ixFirst < ixFirstEnd; ixFirst++) {
+					ComposeFVtoGLLFace(
+						meshInput,
+						meshOverlap,
+						dataGLLNodes,
+						dataGLLJacobian,
+						dataGLLNodalArea,
+						triquadrule,
+						dGlobalIntArray,
+						nOrder,
+						nP,
+						nCoefficients,
+						nRequiredFaceSetSize,
+						nFitWeightsExponent,
+						pFitCache,
+						fContinuous,
+						ixFirst,
+						vecOverlapBegin[ixFirst],
+						nAllOverlapFaces[ixFirst],
+						vecChunkEntries[c]);
 				}
-			}
-			}
-		}
+			});
 		}
 
-		// Increment the current overlap index
-		ixOverlap += nOverlapFaces;
+		capture.Rethrow();
+
+		cAssembled = static_cast<int>(
+			smatMap.AssembleEntriesIfBuffered(
+				vecChunkEntries, cAssembled, c1, nThreads));
 	}
+
+	// Assemble the map entries of the remaining chunks in source face order
+	smatMap.AssembleEntries(vecChunkEntries, cAssembled, nChunks, nThreads);
 }
 
 ///////////////////////////////////////////////////////////////////////////////
 
-void LinearRemapGLLtoGLL2(
+///	<summary>
+///		Integrate the products of the input and output finite element
+///		basis functions over each overlap face, accumulating the
+///		integration array of LinearRemapGLLtoGLL2 and the area of each
+///		output node within each overlap face and output face.  NPIN and
+///		NPOUT are the orders of the input and output finite elements if
+///		fixed at compile time, or 0 otherwise.
+///	</summary>
+template <int NPIN, int NPOUT>
+static void BuildGLLtoGLLIntegrationArray(
 	const Mesh & meshInput,
 	const Mesh & meshOutput,
 	const Mesh & meshOverlap,
-	const DataArray3D<int> & dataGLLNodesIn,
-	const DataArray3D<double> & dataGLLJacobianIn,
-	const DataArray3D<int> & dataGLLNodesOut,
-	const DataArray3D<double> & dataGLLJacobianOut,
-	const DataArray1D<double> & dataNodalAreaOut,
-	int nPin,
-	int nPout,
+	const TriangularQuadratureRule & triquadrule,
+	int nPinRuntime,
+	int nPoutRuntime,
 	int nMonotoneType,
-	bool fContinuousIn,
-	bool fContinuousOut,
-	bool fNoConservation,
-	OfflineMap & mapRemap
+	DataArray3D<double> & dGlobalIntArray,
+	DataArray2D<double> & dOverlapOutputArea,
+	DataArray2D<double> & dGeometricOutputArea
 ) {
-	// Triangular quadrature rule
-	TriangularQuadratureRule triquadrule(8);
+	// Orders of the input and output finite elements
+	const int nPin = (NPIN > 0)?(NPIN):(nPinRuntime);
+	const int nPout = (NPOUT > 0)?(NPOUT):(nPoutRuntime);
 
 	const DataArray2D<double> & dG = triquadrule.GetG();
 	const DataArray1D<double> & dW = triquadrule.GetW();
 
-	// Get SparseMatrix represntation of the OfflineMap
-	SparseMatrix<double> & smatMap = mapRemap.GetSparseMatrix();
-
 	// Sample coefficients
-	DataArray2D<double> dSampleCoeffIn(nPin, nPin);
-	DataArray2D<double> dSampleCoeffOut(nPout, nPout);
-
-	// Build the integration array for each element on meshOverlap
-	DataArray3D<double> dGlobalIntArray(
-		nPin * nPin,
-		meshOverlap.faces.size(),
-		nPout * nPout);
-
-	// Number of overlap Faces per source Face
-	DataArray1D<int> nAllOverlapFaces(meshInput.faces.size());
-
-	int ixOverlap = 0;
-
-	for (int ixFirst = 0; ixFirst < meshInput.faces.size(); ixFirst++) {
-
-		int ixOverlapTemp = ixOverlap;
-		for (; ixOverlapTemp < meshOverlap.faces.size(); ixOverlapTemp++) {
-
-			const Face & faceOverlap = meshOverlap.faces[ixOverlapTemp];
-
-			if (meshOverlap.vecSourceFaceIx[ixOverlapTemp] != ixFirst) {
-				break;
-			}
-
-			nAllOverlapFaces[ixFirst]++;
-		}
-
-		// Increment the current overlap index
-		ixOverlap += nAllOverlapFaces[ixFirst];
-	}
-
-	// Geometric area of each output node
-	DataArray2D<double> dGeometricOutputArea(
-		meshOutput.faces.size(), nPout * nPout);
-
-	// Area of each overlap element in the output basis
-	DataArray2D<double> dOverlapOutputArea(
-		meshOverlap.faces.size(), nPout * nPout);
+	GLLSampleCoeff<NPIN> dSampleCoeffIn(nPin);
+	GLLSampleCoeff<NPOUT> dSampleCoeffOut(nPout);
 
 	// Loop through all faces on meshInput
-	ixOverlap = 0;
-
-	Announce("Building conservative distribution maps");
 	for (int ixFirst = 0; ixFirst < meshInput.faces.size(); ixFirst++) {
 
 		// Output every 100 elements
@@ -2882,8 +3772,11 @@ void LinearRemapGLLtoGLL2(
 
 		const NodeVector & nodesFirst = meshInput.nodes;
 
-		// Number of overlapping Faces and triangles
-		int nOverlapFaces = nAllOverlapFaces[ixFirst];
+		// Overlapping Faces
+		const int ixOverlap =
+			meshOverlap.overlapfaceindex.SourceBegin(ixFirst);
+		const int nOverlapFaces =
+			meshOverlap.overlapfaceindex.SourceCount(ixFirst);
 /*
 		// Calculate total element Jacobian
 		double dTotalJacobian = 0.0;
@@ -2987,20 +3880,10 @@ void LinearRemapGLLtoGLL2(
 					}
 */
 					// Sample the First finite element at this point
-					SampleGLLFiniteElement(
-						nMonotoneType,
-						nPin,
-						dAlphaIn,
-						dBetaIn,
-						dSampleCoeffIn);
+					dSampleCoeffIn.Sample(nMonotoneType, dAlphaIn, dBetaIn);
 
 					// Sample the Second finite element at this point
-					SampleGLLFiniteElement(
-						nMonotoneType,
-						nPout,
-						dAlphaOut,
-						dBetaOut,
-						dSampleCoeffOut);
+					dSampleCoeffOut.Sample(nMonotoneType, dAlphaOut, dBetaOut);
 
 					// Overlap output area
 					for (int s = 0; s < nPout; s++) {
@@ -3044,161 +3927,284 @@ void LinearRemapGLLtoGLL2(
 				}
 			}
 		}
+	}
+}
 
-		// Coefficients
-		DataArray2D<double> dCoeff(nOverlapFaces * nPout * nPout, nPin * nPin);
+///////////////////////////////////////////////////////////////////////////////
 
-		for (int i = 0; i < nOverlapFaces; i++) {
+///	<summary>
+///		Pointer to an instantiation of BuildGLLtoGLLIntegrationArray.
+///	</summary>
+typedef void (*BuildGLLtoGLLIntegrationArrayFunction)(
+	const Mesh &,
+	const Mesh &,
+	const Mesh &,
+	const TriangularQuadratureRule &,
+	int,
+	int,
+	int,
+	DataArray3D<double> &,
+	DataArray2D<double> &,
+	DataArray2D<double> &);
 
-			int ixSecondFace = meshOverlap.vecTargetFaceIx[ixOverlap + i];
+///////////////////////////////////////////////////////////////////////////////
 
-			int ixp = 0;
-			for (int p = 0; p < nPin; p++) {
-			for (int q = 0; q < nPin; q++) {
+void LinearRemapGLLtoGLL2(
+	const Mesh & meshInput,
+	const Mesh & meshOutput,
+	const Mesh & meshOverlap,
+	const DataArray3D<int> & dataGLLNodesIn,
+	const DataArray3D<double> & dataGLLJacobianIn,
+	const DataArray3D<int> & dataGLLNodesOut,
+	const DataArray3D<double> & dataGLLJacobianOut,
+	const DataArray1D<double> & dataNodalAreaOut,
+	int nPin,
+	int nPout,
+	int nMonotoneType,
+	bool fContinuousIn,
+	bool fContinuousOut,
+	bool fNoConservation,
+	OfflineMap & mapRemap,
+	int nThreads
+) {
+	if (nThreads < 1) {
+		_EXCEPTIONT("Thread count must be at least 1");
+	}
 
-				int ixs = 0;
-				for (int s = 0; s < nPout; s++) {
-				for (int t = 0; t < nPout; t++) {
-					dCoeff[i * nPout * nPout + ixs][ixp] =
-						dGlobalIntArray[ixp][ixOverlap + i][ixs]
-						/ dOverlapOutputArea[ixOverlap + i][s * nPout + t];
+	// Triangular quadrature rule
+	const TriangularQuadratureRule & triquadrule =
+		TriangularQuadratureRule::Get(8);
 
-					ixs++;
-				}
-				}
+	// Get SparseMatrix represntation of the OfflineMap
+	SparseMatrix<double> & smatMap = mapRemap.GetSparseMatrix();
 
-				ixp++;
-			}
-			}
-		}
+	// Build the integration array for each element on meshOverlap
+	DataArray3D<double> dGlobalIntArray(
+		nPin * nPin,
+		meshOverlap.faces.size(),
+		nPout * nPout);
 
-		// Source areas
-		DataArray1D<double> vecSourceArea(nPin * nPin);
+	if (meshOverlap.overlapfaceindex.GetSourceFaceCount() !=
+		meshInput.faces.size()
+	) {
+		_EXCEPTIONT("OverlapFaceIndex has not been constructed for meshOverlap");
+	}
 
-		for (int p = 0; p < nPin; p++) {
-		for (int q = 0; q < nPin; q++) {
-			vecSourceArea[p * nPin + q] =
-				dataGLLJacobianIn[p][q][ixFirst];
-		}
+	// Geometric area of each output node
+	DataArray2D<double> dGeometricOutputArea(
+		meshOutput.faces.size(), nPout * nPout);
+
+	// Area of each overlap element in the output basis
+	DataArray2D<double> dOverlapOutputArea(
+		meshOverlap.faces.size(), nPout * nPout);
+
+	// Use the kernel specialized to the input and output orders, if
+	// available; only maps between elements of equal order are specialized
+	BuildGLLtoGLLIntegrationArrayFunction fnBuildIntArray =
+		BuildGLLtoGLLIntegrationArray<0,0>;
+
+	if (nPin == nPout) {
+		switch (nPin) {
+			case 2: fnBuildIntArray = BuildGLLtoGLLIntegrationArray<2,2>; break;
+			case 3: fnBuildIntArray = BuildGLLtoGLLIntegrationArray<3,3>; break;
+			case 4: fnBuildIntArray = BuildGLLtoGLLIntegrationArray<4,4>; break;
 		}
+	}
+
+	// Loop through all faces on meshInput
+	Announce("Building conservative distribution maps");
+	(*fnBuildIntArray)(
+		meshInput,
+		meshOutput,
+		meshOverlap,
+		triquadrule,
+		nPin,
+		nPout,
+		nMonotoneType,
+		dGlobalIntArray,
+		dOverlapOutputArea,
+		dGeometricOutputArea);
+
+	// Force consistency and conservation; each source Face updates only
+	// the integration array of its own overlap Faces
+	OmpExceptionCapture capture;
+
+#pragma omp parallel for schedule(dynamic, 16) num_threads(nThreads)
+	for (int ixFirst = 0; ixFirst < meshInput.faces.size(); ixFirst++) {
+		capture.Run([&]() {
+			// Overlapping Faces
+			const int ixOverlap =
+				meshOverlap.overlapfaceindex.SourceBegin(ixFirst);
+			const int nOverlapFaces =
+				meshOverlap.overlapfaceindex.SourceCount(ixFirst);
 
-		// Target areas
-		DataArray1D<double> vecTargetArea(nOverlapFaces * nPout * nPout);
+			// Coefficients
+			DataArray2D<double> dCoeff(
+				nOverlapFaces * nPout * nPout, nPin * nPin,
+				true, DataArrayStorage_Pooled);
 
-		for (int i = 0; i < nOverlapFaces; i++) {
-			int ixSecond = meshOverlap.vecTargetFaceIx[ixOverlap + i];
+			for (int i = 0; i < nOverlapFaces; i++) {
 
-			int ixs = 0;
-			for (int s = 0; s < nPout; s++) {
-			for (int t = 0; t < nPout; t++) {
+				int ixSecondFace = meshOverlap.vecTargetFaceIx[ixOverlap + i];
 
-				vecTargetArea[i * nPout * nPout + ixs] =
-					dOverlapOutputArea[ixOverlap + i][nPout * s + t];
+				int ixp = 0;
+				for (int p = 0; p < nPin; p++) {
+				for (int q = 0; q < nPin; q++) {
 
-				ixs++;
-			}
-			}
-		}
+					int ixs = 0;
+					for (int s = 0; s < nPout; s++) {
+					for (int t = 0; t < nPout; t++) {
+						dCoeff[i * nPout * nPout + ixs][ixp] =
+							dGlobalIntArray[ixp][ixOverlap + i][ixs]
+							/ dOverlapOutputArea[ixOverlap + i][s * nPout + t];
 
-		// Force consistency and conservation
-		if (!fNoConservation) {
-			ForceIntArrayConsistencyConservation(
-				vecSourceArea,
-				vecTargetArea,
-				dCoeff,
-				(nMonotoneType != 0));
-		}
+						ixs++;
+					}
+					}
 
-		// Update global coefficients
-		for (int i = 0; i < nOverlapFaces; i++) {
+					ixp++;
+				}
+				}
+			}
+
+			// Source areas
+			DataArray1D<double> vecSourceArea(
+				nPin * nPin, true, DataArrayStorage_Pooled);
 
-			int ixp = 0;
 			for (int p = 0; p < nPin; p++) {
 			for (int q = 0; q < nPin; q++) {
+				vecSourceArea[p * nPin + q] =
+					dataGLLJacobianIn[p][q][ixFirst];
+			}
+			}
+
+			// Target areas
+			DataArray1D<double> vecTargetArea(
+				nOverlapFaces * nPout * nPout, true, DataArrayStorage_Pooled);
+
+			for (int i = 0; i < nOverlapFaces; i++) {
 
 				int ixs = 0;
 				for (int s = 0; s < nPout; s++) {
 				for (int t = 0; t < nPout; t++) {
 
-					dGlobalIntArray[ixp][ixOverlap + i][ixs] =
-						dCoeff[i * nPout * nPout + ixs][ixp]
-						* dOverlapOutputArea[ixOverlap + i][s * nPout + t];
+					vecTargetArea[i * nPout * nPout + ixs] =
+						dOverlapOutputArea[ixOverlap + i][nPout * s + t];
 
 					ixs++;
 				}
 				}
+			}
 
-				ixp++;
+			// Force consistency and conservation
+			if (!fNoConservation) {
+				ForceIntArrayConsistencyConservation(
+					vecSourceArea,
+					vecTargetArea,
+					dCoeff,
+					(nMonotoneType != 0));
 			}
+
+			// Update global coefficients
+			for (int i = 0; i < nOverlapFaces; i++) {
+
+				int ixp = 0;
+				for (int p = 0; p < nPin; p++) {
+				for (int q = 0; q < nPin; q++) {
+
+					int ixs = 0;
+					for (int s = 0; s < nPout; s++) {
+					for (int t = 0; t < nPout; t++) {
+
+						dGlobalIntArray[ixp][ixOverlap + i][ixs] =
+							dCoeff[i * nPout * nPout + ixs][ixp]
+							* dOverlapOutputArea[ixOverlap + i][s * nPout + t];
+
+						ixs++;
+					}
+					}
+
+					ixp++;
+				}
+				}
 			}
-		}
 /*
-		// Check column sums (conservation)
-		for (int i = 0; i < nPin * nPin; i++) {
-			double dColSum = 0.0;
-			for (int j = 0; j < nOverlapFaces * nPout * nPout; j++) {
-				dColSum += dCoeff[j][i] * vecTargetArea[j];
+			// Check column sums (conservation)
+			for (int i = 0; i < nPin * nPin; i++) {
+				double dColSum = 0.0;
+				for (int j = 0; j < nOverlapFaces * nPout * nPout; j++) {
+					dColSum += dCoeff[j][i] * vecTargetArea[j];
+				}
+				printf("Col %i: %1.15e\n", i, dColSum / vecSourceArea[i]);
 			}
-			printf("Col %i: %1.15e\n", i, dColSum / vecSourceArea[i]);
-		}
 
-		// Check row sums (consistency)
-		for (int j = 0; j < nOverlapFaces * nPout * nPout; j++) {
-			double dRowSum = 0.0;
-			for (int i = 0; i < nPin * nPin; i++) {
-				dRowSum += dCoeff[j][i];
+			// Check row sums (consistency)
+			for (int j = 0; j < nOverlapFaces * nPout * nPout; j++) {
+				double dRowSum = 0.0;
+				for (int i = 0; i < nPin * nPin; i++) {
+					dRowSum += dCoeff[j][i];
+				}
+				printf("Row %i: %1.15e\n", j, dRowSum);
 			}
-			printf("Row %i: %1.15e\n", j, dRowSum);
-		}
-		_EXCEPTION();
+			_EXCEPTION();
 */
-
-		// Increment the current overlap index
-		ixOverlap += nOverlapFaces;
+		});
 	}
 
-	// Build redistribution map within target element
+	capture.Rethrow();
+
+	// Build redistribution map within target element; target Faces are
+	// independent
 	Announce("Building redistribution maps on target mesh");
-	DataArray1D<double> dRedistSourceArea(nPout * nPout);
-	DataArray1D<double> dRedistTargetArea(nPout * nPout);
 	std::vector< DataArray2D<double> > dRedistributionMaps;
 	dRedistributionMaps.resize(meshOutput.faces.size());
 
-	for (int ixSecond = 0; ixSecond < meshOutput.faces.size(); ixSecond++) {
-
-		dRedistributionMaps[ixSecond].Allocate(
-			nPout * nPout, nPout * nPout);
-
-		for (int i = 0; i < nPout * nPout; i++) {
-			dRedistributionMaps[ixSecond][i][i] = 1.0;
-		}
-
-		for (int s = 0; s < nPout * nPout; s++) {
-			dRedistSourceArea[s] =
-				dGeometricOutputArea[ixSecond][s];
-		}
+#pragma omp parallel num_threads(nThreads)
+	{
+		// Scratch arrays, allocated once per thread
+		DataArray1D<double> dRedistSourceArea(nPout * nPout);
+		DataArray1D<double> dRedistTargetArea(nPout * nPout);
+
+#pragma omp for schedule(dynamic, 16)
+		for (int ixSecond = 0; ixSecond < meshOutput.faces.size(); ixSecond++) {
+			capture.Run([&]() {
+				dRedistributionMaps[ixSecond].Allocate(
+					nPout * nPout, nPout * nPout);
+
+				for (int i = 0; i < nPout * nPout; i++) {
+					dRedistributionMaps[ixSecond][i][i] = 1.0;
+				}
 
-		for (int s = 0; s < nPout * nPout; s++) {
-			dRedistTargetArea[s] =
-				dataGLLJacobianOut[s/nPout][s%nPout][ixSecond];
-		}
+				for (int s = 0; s < nPout * nPout; s++) {
+					dRedistSourceArea[s] =
+						dGeometricOutputArea[ixSecond][s];
+				}
 
-		if (!fNoConservation) {
-			ForceIntArrayConsistencyConservation(
-				dRedistSourceArea,
-				dRedistTargetArea,
-				dRedistributionMaps[ixSecond],
-				(nMonotoneType != 0));
+				for (int s = 0; s < nPout * nPout; s++) {
+					dRedistTargetArea[s] =
+						dataGLLJacobianOut[s/nPout][s%nPout][ixSecond];
+				}
 
-			for (int s = 0; s < nPout * nPout; s++) {
-			for (int t = 0; t < nPout * nPout; t++) {
-				dRedistributionMaps[ixSecond][s][t] *=
-					dRedistTargetArea[s] / dRedistSourceArea[t];
-			}
-			}
+				if (!fNoConservation) {
+					ForceIntArrayConsistencyConservation(
+						dRedistSourceArea,
+						dRedistTargetArea,
+						dRedistributionMaps[ixSecond],
+						(nMonotoneType != 0));
+
+					for (int s = 0; s < nPout * nPout; s++) {
+					for (int t = 0; t < nPout * nPout; t++) {
+						dRedistributionMaps[ixSecond][s][t] *=
+							dRedistTargetArea[s] / dRedistSourceArea[t];
+					}
+					}
+				}
+			});
 		}
 	}
 
+	capture.Rethrow();
+
 	// Construct the total geometric area
 	DataArray1D<double> dTotalGeometricArea(dataNodalAreaOut.GetRows());
 	for (int ixSecond = 0; ixSecond < meshOutput.faces.size(); ixSecond++) {
@@ -3211,14 +4217,16 @@ void LinearRemapGLLtoGLL2(
 	}
 
 	// Compose the integration operator with the output map
-	ixOverlap = 0;
-
 	Announce("Assembling map");
 
 	// Map from source DOFs to target DOFs with redistribution applied
 	DataArray2D<double> dRedistributedOp(
 		nPin * nPin, nPout * nPout);
 
+	// Map entries in source face order, assembled into the map at the end
+	std::vector< std::vector< SparseMatrixEntry<double> > > vecMapEntries(1);
+	std::vector< SparseMatrixEntry<double> > & vecEntries = vecMapEntries[0];
+
 	for (int ixFirst = 0; ixFirst < meshInput.faces.size(); ixFirst++) {
 
 		// Output every 100 elements
@@ -3229,8 +4237,11 @@ void LinearRemapGLLtoGLL2(
 		// This Face
 		const Face & faceFirst = meshInput.faces[ixFirst];
 
-		// Number of overlapping Faces and triangles
-		int nOverlapFaces = nAllOverlapFaces[ixFirst];
+		// Overlapping Faces
+		const int ixOverlap =
+			meshOverlap.overlapfaceindex.SourceBegin(ixFirst);
+		const int nOverlapFaces =
+			meshOverlap.overlapfaceindex.SourceCount(ixFirst);
 
 		// Put composed array into map
 		for (int j = 0; j < nOverlapFaces; j++) {
@@ -3267,13 +4278,17 @@ void LinearRemapGLLtoGLL2(
 						ixSecondNode = dataGLLNodesOut[s][t][ixSecondFace] - 1;
 
 						if (!fNoConservation) {
-							smatMap(ixSecondNode, ixFirstNode) +=
+							vecEntries.push_back(SparseMatrixEntry<double>(
+								ixSecondNode,
+								ixFirstNode,
 								dRedistributedOp[ixp][ixs]
-								/ dataNodalAreaOut[ixSecondNode];
+								/ dataNodalAreaOut[ixSecondNode]));
 						} else {
-							smatMap(ixSecondNode, ixFirstNode) +=
+							vecEntries.push_back(SparseMatrixEntry<double>(
+								ixSecondNode,
+								ixFirstNode,
 								dRedistributedOp[ixp][ixs]
-								/ dTotalGeometricArea[ixSecondNode];
+								/ dTotalGeometricArea[ixSecondNode]));
 						}
 
 					} else {
@@ -3281,13 +4296,17 @@ void LinearRemapGLLtoGLL2(
 							ixSecondFace * nPout * nPout + s * nPout + t;
 
 						if (!fNoConservation) {
-							smatMap(ixSecondNode, ixFirstNode) +=
+							vecEntries.push_back(SparseMatrixEntry<double>(
+								ixSecondNode,
+								ixFirstNode,
 								dRedistributedOp[ixp][ixs]
-								/ dataGLLJacobianOut[s][t][ixSecondFace];
+								/ dataGLLJacobianOut[s][t][ixSecondFace]));
 						} else {
-							smatMap(ixSecondNode, ixFirstNode) +=
+							vecEntries.push_back(SparseMatrixEntry<double>(
+								ixSecondNode,
+								ixFirstNode,
 								dRedistributedOp[ixp][ixs]
-								/ dGeometricOutputArea[ixSecondFace][s * nPout + t];
+								/ dGeometricOutputArea[ixSecondFace][s * nPout + t]));
 						}
 					}
 
@@ -3299,10 +4318,9 @@ void LinearRemapGLLtoGLL2(
 			}
 			}
 		}
-
-		// Increment the current overlap index
-		ixOverlap += nOverlapFaces;
 	}
+
+	smatMap.AssembleEntries(vecMapEntries, nThreads);
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -3338,35 +4356,23 @@ void LinearRemapGLLtoGLL2_Pointwise(
 	// Sample coefficients
 	DataArray2D<double> dSampleCoeffIn(nPin, nPin);
 
-	// Number of overlap Faces per source Face
-	DataArray1D<int> nAllOverlapFaces(meshInput.faces.size());
-
-	int ixOverlap = 0;
-
-	for (int ixFirst = 0; ixFirst < meshInput.faces.size(); ixFirst++) {
-
-		int ixOverlapTemp = ixOverlap;
-		for (; ixOverlapTemp < meshOverlap.faces.size(); ixOverlapTemp++) {
-
-			const Face & faceOverlap = meshOverlap.faces[ixOverlapTemp];
-
-			if (meshOverlap.vecSourceFaceIx[ixOverlapTemp] != ixFirst) {
-				break;
-			}
-
-			nAllOverlapFaces[ixFirst]++;
-		}
-
-		// Increment the current overlap index
-		ixOverlap += nAllOverlapFaces[ixFirst];
+	if (meshOverlap.overlapfaceindex.GetSourceFaceCount() !=
+		meshInput.faces.size()
+	) {
+		_EXCEPTIONT("OverlapFaceIndex has not been constructed for meshOverlap");
 	}
 
 	// Number of times this point was found
 	DataArray1D<bool> fSecondNodeFound(dataNodalAreaOut.GetRows());
 
-	// Loop through all faces on meshInput
-	ixOverlap = 0;
+	// Nodes of one second Face that are sampled, their indices and their
+	// inverse mapped coordinates
+	std::vector<Node> vecPointNodes;
+	std::vector<int> vecPointIndex;
+	std::vector<double> vecAlphaIn;
+	std::vector<double> vecBetaIn;
 
+	// Loop through all faces on meshInput
 	for (int ixFirst = 0; ixFirst < meshInput.faces.size(); ixFirst++) {
 
 		// Output every 100 elements
@@ -3379,8 +4385,11 @@ void LinearRemapGLLtoGLL2_Pointwise(
 
 		const NodeVector & nodesFirst = meshInput.nodes;
 
-		// Number of overlapping Faces and triangles
-		int nOverlapFaces = nAllOverlapFaces[ixFirst];
+		// Overlapping Faces
+		const int ixOverlap =
+			meshOverlap.overlapfaceindex.SourceBegin(ixFirst);
+		const int nOverlapFaces =
+			meshOverlap.overlapfaceindex.SourceCount(ixFirst);
 
 		// Loop through all Overlap Faces
 		for (int i = 0; i < nOverlapFaces; i++) {
@@ -3399,8 +4408,11 @@ void LinearRemapGLLtoGLL2_Pointwise(
 
 			const Face & faceSecond = meshOutput.faces[ixSecond];
 
-			// Loop through all nodes on the second face
-			int ixs = 0;
+			// Nodes on the second face that have not been found, which are
+			// inverse mapped together
+			vecPointNodes.clear();
+			vecPointIndex.clear();
+
 			for (int s = 0; s < nPout; s++) {
 			for (int t = 0; t < nPout; t++) {
 
@@ -3435,17 +4447,39 @@ void LinearRemapGLLtoGLL2_Pointwise(
 					dDx1G,
 					dDx2G);
 
-				// Find the components of this quadrature point in the basis
-				// of the first Face.
-				double dAlphaIn;
-				double dBetaIn;
+				vecPointNodes.push_back(node);
+				vecPointIndex.push_back(ixSecondNode);
+			}
+			}
 
-				ApplyInverseMap(
-					faceFirst,
-					nodesFirst,
-					node,
-					dAlphaIn,
-					dBetaIn);
+			const int nPoints = static_cast<int>(vecPointNodes.size());
+			if (nPoints == 0) {
+				continue;
+			}
+
+			// Find the components of these points in the basis of the
+			// first Face.
+			vecAlphaIn.resize(nPoints);
+			vecBetaIn.resize(nPoints);
+
+			ApplyInverseMap(
+				faceFirst,
+				nodesFirst,
+				nPoints,
+				&(vecPointNodes[0]),
+				&(vecAlphaIn[0]),
+				&(vecBetaIn[0]));
+
+			for (int k = 0; k < nPoints; k++) {
+				const int ixSecondNode = vecPointIndex[k];
+
+				const double dAlphaIn = vecAlphaIn[k];
+				const double dBetaIn = vecBetaIn[k];
+
+				// Check if this node has been found already
+				if (fSecondNodeFound[ixSecondNode]) {
+					continue;
+				}
 
 				// Check if this node is within the first Face
 				if ((dAlphaIn < -1.0e-10) || (dAlphaIn > 1.0 + 1.0e-10) ||
@@ -3483,11 +4517,7 @@ void LinearRemapGLLtoGLL2_Pointwise(
 				}
 				}
 			}
-			}
 		}
-
-		// Increment the current overlap index
-		ixOverlap += nOverlapFaces;
 	}
 
 	// Check for missing samples
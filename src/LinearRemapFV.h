@@ -21,23 +21,217 @@
 #include "DataArray2D.h"
 #include "DataArray3D.h"
 
+#include <vector>
+
 ///////////////////////////////////////////////////////////////////////////////
 
 class Mesh;
 class OfflineMap;
+class CheckpointFile;
+
+enum FaceStencilType : int;
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Generate the reconstruction stencil of every Face of the Mesh with
+///		the given adjacency and required size on nThreads threads and
+///		store them in mesh.facestencils, where they are used by subsequent
+///		map generation.  Nothing is done if the stored stencils match.
+///		Returns true if the stencils were generated.
+///	</summary>
+bool ConstructFaceStencils(
+	Mesh & mesh,
+	FaceStencilType eType,
+	int nRequiredFaceSetSize,
+	int nThreads = 1
+);
+
+///	<summary>
+///		Generate the stencils used by the finite volume reconstructions of
+///		order nOrder on meshInput.  Returns true if the stencils were
+///		generated rather than already stored.
+///	</summary>
+bool ConstructReconstructionStencils(
+	Mesh & meshInput,
+	int nOrder,
+	int nThreads = 1
+);
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Order of the triangular quadrature rule used to build the fit arrays
+///		of LinearRemapFVtoFV (fFiniteElementTarget false),
+///		LinearRemapFVtoGLL_Volumetric (fVolumetric true) or
+///		LinearRemapFVtoGLL.
+///	</summary>
+int GetFVFitArrayTriQuadRuleOrder(
+	bool fFiniteElementTarget,
+	bool fVolumetric
+);
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		The fit arrays of the finite volume reconstructions of order nOrder
+///		on a source mesh, as built by BuildFitArray.  Only the first column
+///		of a fit array, the conservation constraint, depends on the overlap
+///		mesh, so the remaining columns and the fit weights can be reused for
+///		maps to any number of target meshes.
+///	</summary>
+class FVFitArrayCache {
+
+public:
+	///	<summary>
+	///		Constructor.
+	///	</summary>
+	FVFitArrayCache() :
+		m_nOrder(0),
+		m_nTriQuadRuleOrder(0),
+		m_nCoefficients(0)
+	{ }
+
+public:
+	///	<summary>
+	///		Build the fit arrays of all Faces of meshInput with the
+	///		triangular quadrature rule of order nTriQuadRuleOrder (4 for
+	///		LinearRemapFVtoFV and LinearRemapFVtoGLL_Volumetric, 8 for
+	///		LinearRemapFVtoGLL) on nThreads threads.  The Face areas and
+	///		EdgeMap of meshInput must have been constructed.
+	///	</summary>
+	void Construct(
+		const Mesh & meshInput,
+		int nOrder,
+		int nTriQuadRuleOrder,
+		int nThreads = 1
+	);
+
+	///	<summary>
+	///		Remove all entries.
+	///	</summary>
+	void clear();
+
+	///	<summary>
+	///		Returns true if the cache holds fit arrays of order nOrder built
+	///		with the given quadrature rule for a mesh with nFaces Faces.
+	///	</summary>
+	bool Matches(
+		int nOrder,
+		int nTriQuadRuleOrder,
+		size_t nFaces
+	) const {
+		return (m_nOrder == nOrder)
+			&& (m_nTriQuadRuleOrder == nTriQuadRuleOrder)
+			&& (m_vecAdjOffsets.size() == nFaces + 1)
+			&& (nFaces != 0);
+	}
+
+	///	<summary>
+	///		Number of Faces in the cache.
+	///	</summary>
+	size_t size() const {
+		if (m_vecAdjOffsets.size() == 0) {
+			return 0;
+		}
+		return (m_vecAdjOffsets.size() - 1);
+	}
+
+	///	<summary>
+	///		Approximate storage used by the cache in bytes.
+	///	</summary>
+	size_t GetMemoryBytes() const {
+		return m_vecAdjOffsets.size() * sizeof(int)
+			+ m_vecFitArray.size() * sizeof(double)
+			+ m_vecFitWeights.size() * sizeof(double);
+	}
+
+	///	<summary>
+	///		Copy the fit array and fit weights of Face ixFirst, whose
+	///		stencil has nAdjFaces Faces, replacing the first column with
+	///		the given constraint (if it has any rows) exactly as
+	///		BuildFitArray does.
+	///	</summary>
+	void GetFitArray(
+		int ixFirst,
+		int nAdjFaces,
+		const DataArray1D<double> & dConstraint,
+		DataArray2D<double> & dFitArray,
+		DataArray1D<double> & dFitWeights
+	) const;
+
+protected:
+	///	<summary>
+	///		Order of the reconstructions.
+	///	</summary>
+	int m_nOrder;
+
+	///	<summary>
+	///		Order of the triangular quadrature rule.
+	///	</summary>
+	int m_nTriQuadRuleOrder;
+
+	///	<summary>
+	///		Number of coefficients of each reconstruction.
+	///	</summary>
+	int m_nCoefficients;
+
+	///	<summary>
+	///		Offsets of each Face into the stencil entries (size + 1 entries).
+	///	</summary>
+	std::vector<int> m_vecAdjOffsets;
+
+	///	<summary>
+	///		Fit arrays of all Faces, each stored row by row.
+	///	</summary>
+	std::vector<double> m_vecFitArray;
+
+	///	<summary>
+	///		Fit weights of all stencil entries.
+	///	</summary>
+	std::vector<double> m_vecFitWeights;
+};
 
 ///////////////////////////////////////////////////////////////////////////////
 
 ///	<summary>
 ///		Generate the OfflineMap for remapping from finite volumes to finite
-///		volumes.
+///		volumes.  Source faces are processed in parallel on nThreads
+///		threads; the resulting map does not depend on the thread count.
+///		If pFitCache is not NULL the fit arrays are taken from it.  If
+///		pCheckpoint is not NULL the entries of chunks of source faces
+///		recorded in it before a restart are reused, and the entries of
+///		newly completed chunks are recorded in it when it is due.
 ///	</summary>
 void LinearRemapFVtoFV(
 	const Mesh & meshInput,
 	const Mesh & meshOutput,
 	const Mesh & meshOverlap,
 	int nOrder,
-	OfflineMap & mapRemap
+	OfflineMap & mapRemap,
+	int nThreads = 1,
+	const FVFitArrayCache * pFitCache = NULL,
+	CheckpointFile * pCheckpoint = NULL
+);
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Update an OfflineMap generated by LinearRemapFVtoFV after the given
+///		source and target Faces have changed.  Faces are assumed to have
+///		kept their indices and connectivity.  Only the rows of the map
+///		which may depend on a changed Face are recomputed, and the result
+///		is identical to regenerating the map with LinearRemapFVtoFV.
+///	</summary>
+void LinearRemapFVtoFV_Update(
+	const Mesh & meshInput,
+	const Mesh & meshOutput,
+	const Mesh & meshOverlap,
+	int nOrder,
+	const std::vector<int> & vecChangedSourceFaces,
+	const std::vector<int> & vecChangedTargetFaces,
+	OfflineMap & mapRemap,
+	int nThreads = 1
 );
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -64,7 +258,9 @@ void LinearRemapFVtoGLL_Simple(
 
 ///	<summary>
 ///		Generate the OfflineMap for remapping from finite volumes to finite
-///		elements using a new experimental method.
+///		elements using a new experimental method, using nThreads threads.
+///		The resulting map does not depend on the thread count.  If
+///		pFitCache is not NULL the fit arrays are taken from it.
 ///	</summary>
 void LinearRemapFVtoGLL_Volumetric(
 	const Mesh & meshInput,
@@ -77,14 +273,18 @@ void LinearRemapFVtoGLL_Volumetric(
 	OfflineMap & mapRemap,
 	int nMonotoneType,
 	bool fContinuous,
-	bool fNoConservation
+	bool fNoConservation,
+	int nThreads = 1,
+	const FVFitArrayCache * pFitCache = NULL
 );
 
 ///////////////////////////////////////////////////////////////////////////////
 
 ///	<summary>
 ///		Generate the OfflineMap for remapping from finite volumes to finite
-///		elements.
+///		elements, using nThreads threads.  The resulting map does not
+///		depend on the thread count.  If pFitCache is not NULL the fit
+///		arrays are taken from it.
 ///	</summary>
 void LinearRemapFVtoGLL(
 	const Mesh & meshInput,
@@ -97,14 +297,17 @@ void LinearRemapFVtoGLL(
 	OfflineMap & mapRemap,
 	int nMonotoneType,
 	bool fContinuous,
-	bool fNoConservation
+	bool fNoConservation,
+	int nThreads = 1,
+	const FVFitArrayCache * pFitCache = NULL
 );
 
 ///////////////////////////////////////////////////////////////////////////////
 
 ///	<summary>
 ///		Generate the OfflineMap for remapping from finite elements to finite
-///		elements.
+///		elements, using nThreads threads for the consistency, conservation
+///		and monotonicity corrections.
 ///	</summary>
 void LinearRemapGLLtoGLL2(
 	const Mesh & meshInput,
@@ -121,7 +324,8 @@ void LinearRemapGLLtoGLL2(
 	bool fContinuousIn,
 	bool fContinuousOut,
 	bool fNoConservation,
-	OfflineMap & mapRemap
+	OfflineMap & mapRemap,
+	int nThreads = 1
 );
 
 ///////////////////////////////////////////////////////////////////////////////
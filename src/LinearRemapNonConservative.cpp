@@ -0,0 +1,518 @@
+///////////////////////////////////////////////////////////////////////////////
+///
+///	\file    LinearRemapNonConservative.cpp
+///	\author  agent
+///	\version October 15, 2026
+///
+///	<remarks>
+///		Copyright 2026 agent
+///
+///		This file is distributed as part of the Tempest source code package.
+///		Permission is granted to use, copy, modify and distribute this
+///		source code and its documentation under the terms of the GNU General
+///		Public License.  This software is provided "as is" without express
+///		or implied warranty.
+///	</remarks>
+
+#include "LinearRemapNonConservative.h"
+#include "OfflineMap.h"
+#include "FaceLocator.h"
+#include "FiniteElementTools.h"
+#include "MeshUtilitiesFuzzy.h"
+#include "NodeKDTree.h"
+#include "SparseMatrix.h"
+#include "STLStringHelper.h"
+
+#include "Announce.h"
+#include "Exception.h"
+#include "OmpExceptionCapture.h"
+
+#include <cmath>
+#include <vector>
+#include <algorithm>
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Number of target nodes in each chunk of work.  Chunks are merged
+///		into the map in target order so that the map does not depend on
+///		the thread count.
+///	</summary>
+static const int NonConservativeChunkSize = 4096;
+
+///	<summary>
+///		Number of nearby source face centers used to build the fan of
+///		triangles around the nearest center for bilinear interpolation.
+///	</summary>
+static const int NonConservativeBilinearCenters = 9;
+
+///	<summary>
+///		Number of nearby source face centers used in the least squares fit
+///		for patch interpolation.
+///	</summary>
+static const int NonConservativePatchCenters = 9;
+
+///	<summary>
+///		Tolerance on barycentric coordinates of a target node in a triangle.
+///	</summary>
+static const double NonConservativeBarycentricTolerance = 1.0e-12;
+
+///////////////////////////////////////////////////////////////////////////////
+
+NonConservativeMethod ParseNonConservativeMethod(
+	const std::string & strMethod
+) {
+	std::string strMethodLower = strMethod;
+	STLStringHelper::ToLower(strMethodLower);
+
+	if ((strMethodLower == "") || (strMethodLower == "conserve")) {
+		return NonConservativeMethod_Conservative;
+	} else if (strMethodLower == "nn") {
+		return NonConservativeMethod_NearestNeighbor;
+	} else if (strMethodLower == "bilin") {
+		return NonConservativeMethod_Bilinear;
+	} else if (strMethodLower == "patch") {
+		return NonConservativeMethod_Patch;
+	}
+
+	_EXCEPTION1("Invalid \"method\" value (%s), "
+		"expected [conserve|nn|bilin|patch]", strMethod.c_str());
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Get the center of a Face, projected to the unit sphere.
+///	</summary>
+static Node GetFaceCenter(
+	const Face & face,
+	const NodeVector & nodes
+) {
+	Node nodeCenter(0.0, 0.0, 0.0);
+	for (int i = 0; i < face.edges.size(); i++) {
+		nodeCenter = nodeCenter + nodes[face[i]];
+	}
+	return nodeCenter.Normalized();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void GetNonConservativeTargetNodesFV(
+	const Mesh & meshTarget,
+	NodeVector & nodesTarget
+) {
+	nodesTarget.resize(meshTarget.faces.size());
+	for (int i = 0; i < meshTarget.faces.size(); i++) {
+		nodesTarget[i] = GetFaceCenter(meshTarget.faces[i], meshTarget.nodes);
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void GetNonConservativeTargetNodesGLL(
+	const Mesh & meshTarget,
+	int nP,
+	const DataArray3D<int> & dataGLLNodes,
+	bool fContinuous,
+	NodeVector & nodesTarget
+) {
+	const int nFaces = static_cast<int>(meshTarget.faces.size());
+
+	if (dataGLLNodes.GetSubColumns() != nFaces) {
+		_EXCEPTIONT("Mismatch between meshTarget and dataGLLNodes");
+	}
+
+	if (fContinuous) {
+		int iMaxNodeIx = 0;
+		for (int i = 0; i < nP; i++) {
+		for (int j = 0; j < nP; j++) {
+		for (int k = 0; k < nFaces; k++) {
+			if (dataGLLNodes[i][j][k] > iMaxNodeIx) {
+				iMaxNodeIx = dataGLLNodes[i][j][k];
+			}
+		}
+		}
+		}
+		nodesTarget.resize(iMaxNodeIx);
+
+	} else {
+		nodesTarget.resize(nFaces * nP * nP);
+	}
+
+	DataArray1D<double> dG;
+	GetDefaultNodalLocations(nP, dG);
+
+	for (int i = 0; i < nP; i++) {
+	for (int j = 0; j < nP; j++) {
+	for (int k = 0; k < nFaces; k++) {
+		Node node;
+		ApplyLocalMap(
+			meshTarget.faces[k],
+			meshTarget.nodes,
+			dG[j],
+			dG[i],
+			node);
+
+		if (fContinuous) {
+			nodesTarget[dataGLLNodes[i][j][k] - 1] = node.Normalized();
+		} else {
+			nodesTarget[k * nP * nP + j * nP + i] = node.Normalized();
+		}
+	}
+	}
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Gnomonic projection of nodes onto the plane tangent to the unit
+///		sphere at a target node.
+///	</summary>
+class TangentPlaneProjection {
+
+public:
+	///	<summary>
+	///		Constructor.
+	///	</summary>
+	TangentPlaneProjection(
+		const Node & nodeTarget
+	) :
+		m_nodeNormal(nodeTarget)
+	{
+		Node nodeAxis(0.0, 0.0, 1.0);
+		if (fabs(nodeTarget.z) > 0.9) {
+			nodeAxis = Node(1.0, 0.0, 0.0);
+		}
+		m_nodeE1 = CrossProduct(nodeAxis, nodeTarget).Normalized();
+		m_nodeE2 = CrossProduct(nodeTarget, m_nodeE1);
+	}
+
+	///	<summary>
+	///		Project node onto the tangent plane.  Returns false if node is
+	///		not in the hemisphere centered on the target node.
+	///	</summary>
+	bool Project(
+		const Node & node,
+		double & dX,
+		double & dY
+	) const {
+		const double dDot = DotProduct(node, m_nodeNormal);
+		if (dDot <= 0.0) {
+			return false;
+		}
+		dX = DotProduct(node, m_nodeE1) / dDot;
+		dY = DotProduct(node, m_nodeE2) / dDot;
+		return true;
+	}
+
+protected:
+	///	<summary>
+	///		Normal and orthonormal basis of the tangent plane.
+	///	</summary>
+	Node m_nodeNormal;
+	Node m_nodeE1;
+	Node m_nodeE2;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Compute bilinear weights for the target node from the fan of
+///		triangles around the nearest of the source face centers
+///		vecCenterIx, which are ordered by increasing distance.  Returns
+///		false if no triangle of the fan contains the target node.
+///	</summary>
+static bool ComputeBilinearWeights(
+	const TangentPlaneProjection & proj,
+	const NodeVector & nodesCenter,
+	const std::vector<int> & vecCenterIx,
+	int ixRow,
+	std::vector< SparseMatrixEntry<double> > & vecEntries
+) {
+	const int nCenters = static_cast<int>(vecCenterIx.size());
+
+	std::vector<double> vecX(nCenters);
+	std::vector<double> vecY(nCenters);
+	std::vector<bool> vecProjected(nCenters);
+
+	for (int i = 0; i < nCenters; i++) {
+		vecProjected[i] =
+			proj.Project(nodesCenter[vecCenterIx[i]], vecX[i], vecY[i]);
+	}
+	if (!vecProjected[0]) {
+		return false;
+	}
+
+	// Order the centers around the nearest center (the apex) by angle
+	std::vector< std::pair<double, int> > vecAngle;
+	for (int i = 1; i < nCenters; i++) {
+		if (!vecProjected[i]) {
+			continue;
+		}
+		vecAngle.push_back(
+			std::pair<double, int>(
+				atan2(vecY[i] - vecY[0], vecX[i] - vecX[0]), i));
+	}
+	std::sort(vecAngle.begin(), vecAngle.end());
+
+	if (vecAngle.size() < 2) {
+		return false;
+	}
+
+	// The target node is at the origin of the tangent plane
+	for (int i = 0; i < vecAngle.size(); i++) {
+		const int ia = vecAngle[i].second;
+		const int ib = vecAngle[(i + 1) % vecAngle.size()].second;
+
+		const double dAx = vecX[ia] - vecX[0];
+		const double dAy = vecY[ia] - vecY[0];
+		const double dBx = vecX[ib] - vecX[0];
+		const double dBy = vecY[ib] - vecY[0];
+
+		const double dDet = dAx * dBy - dAy * dBx;
+		if (dDet <= 0.0) {
+			continue;
+		}
+
+		const double dPx = - vecX[0];
+		const double dPy = - vecY[0];
+
+		const double dWa = (dPx * dBy - dPy * dBx) / dDet;
+		const double dWb = (dAx * dPy - dAy * dPx) / dDet;
+		const double dW0 = 1.0 - dWa - dWb;
+
+		if ((dWa < -NonConservativeBarycentricTolerance) ||
+			(dWb < -NonConservativeBarycentricTolerance) ||
+			(dW0 < -NonConservativeBarycentricTolerance)
+		) {
+			continue;
+		}
+
+		vecEntries.push_back(
+			SparseMatrixEntry<double>(ixRow, vecCenterIx[0], dW0));
+		vecEntries.push_back(
+			SparseMatrixEntry<double>(ixRow, vecCenterIx[ia], dWa));
+		vecEntries.push_back(
+			SparseMatrixEntry<double>(ixRow, vecCenterIx[ib], dWb));
+
+		return true;
+	}
+
+	return false;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Compute the weights of a linear least squares fit through the
+///		source face centers vecCenterIx, evaluated at the target node.
+///		Returns false if the fit is singular.
+///	</summary>
+static bool ComputePatchWeights(
+	const TangentPlaneProjection & proj,
+	const NodeVector & nodesCenter,
+	const std::vector<int> & vecCenterIx,
+	int ixRow,
+	std::vector< SparseMatrixEntry<double> > & vecEntries
+) {
+	const int nCenters = static_cast<int>(vecCenterIx.size());
+
+	std::vector<double> vecX(nCenters);
+	std::vector<double> vecY(nCenters);
+	std::vector<bool> vecProjected(nCenters);
+
+	// Normal matrix of the fit f = a + b x + c y
+	double dM[3][3] = {{0.0, 0.0, 0.0}, {0.0, 0.0, 0.0}, {0.0, 0.0, 0.0}};
+
+	for (int i = 0; i < nCenters; i++) {
+		vecProjected[i] =
+			proj.Project(nodesCenter[vecCenterIx[i]], vecX[i], vecY[i]);
+		if (!vecProjected[i]) {
+			continue;
+		}
+
+		const double dRow[3] = { 1.0, vecX[i], vecY[i] };
+		for (int p = 0; p < 3; p++) {
+		for (int q = 0; q < 3; q++) {
+			dM[p][q] += dRow[p] * dRow[q];
+		}
+		}
+	}
+
+	// First row of the inverse of the (symmetric) normal matrix
+	const double dC0 = dM[1][1] * dM[2][2] - dM[1][2] * dM[2][1];
+	const double dC1 = dM[1][2] * dM[2][0] - dM[1][0] * dM[2][2];
+	const double dC2 = dM[1][0] * dM[2][1] - dM[1][1] * dM[2][0];
+
+	const double dDet = dM[0][0] * dC0 + dM[0][1] * dC1 + dM[0][2] * dC2;
+
+	if (dDet <= 1.0e-12 * dM[0][0] * dM[1][1] * dM[2][2]) {
+		return false;
+	}
+
+	for (int i = 0; i < nCenters; i++) {
+		if (!vecProjected[i]) {
+			continue;
+		}
+		const double dW = (dC0 + dC1 * vecX[i] + dC2 * vecY[i]) / dDet;
+
+		vecEntries.push_back(
+			SparseMatrixEntry<double>(ixRow, vecCenterIx[i], dW));
+	}
+
+	return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void LinearRemapNonConservative(
+	const Mesh & meshSource,
+	const NodeVector & nodesTarget,
+	NonConservativeMethod method,
+	OfflineMap & mapRemap,
+	int nThreads
+) {
+	if (nThreads < 1) {
+		_EXCEPTIONT("Thread count must be at least 1");
+	}
+	if (method == NonConservativeMethod_Conservative) {
+		_EXCEPTIONT("Conservative maps require an overlap mesh");
+	}
+
+	const int nSourceFaces = static_cast<int>(meshSource.faces.size());
+	const int nTargetNodes = static_cast<int>(nodesTarget.size());
+
+	// Source face centers and the KD tree over them
+	AnnounceStartBlock("Building source mesh search trees");
+
+	NodeVector nodesCenter(nSourceFaces);
+	for (int i = 0; i < nSourceFaces; i++) {
+		nodesCenter[i] = GetFaceCenter(meshSource.faces[i], meshSource.nodes);
+	}
+
+	NodeKDTree<int> treeCenter(nodesCenter);
+
+	FaceLocator locator(meshSource);
+
+	AnnounceEndBlock(NULL);
+
+	int nCenters = 1;
+	if (method == NonConservativeMethod_Bilinear) {
+		nCenters = NonConservativeBilinearCenters;
+	} else if (method == NonConservativeMethod_Patch) {
+		nCenters = NonConservativePatchCenters;
+	}
+
+	// Compute the weights of each chunk of target nodes
+	AnnounceStartBlock("Computing weights");
+
+	const int nChunks =
+		(nTargetNodes + NonConservativeChunkSize - 1) / NonConservativeChunkSize;
+
+	std::vector< std::vector< SparseMatrixEntry<double> > >
+		vecChunkEntries(nChunks);
+
+	std::vector<int> vecChunkUncovered(nChunks, 0);
+	std::vector<int> vecChunkFallback(nChunks, 0);
+
+	OmpExceptionCapture capture;
+
+#pragma omp parallel num_threads(nThreads)
+	{
+		MeshUtilitiesFuzzy meshutil;
+
+		std::vector<int> vecCandidates;
+		std::vector<int> vecCenterIx;
+
+#pragma omp for schedule(dynamic)
+		for (int c = 0; c < nChunks; c++) {
+			const int iBegin = c * NonConservativeChunkSize;
+			const int iEnd =
+				std::min(iBegin + NonConservativeChunkSize, nTargetNodes);
+
+			std::vector< SparseMatrixEntry<double> > & vecEntries =
+				vecChunkEntries[c];
+
+			capture.Run([&]() {
+				for (int i = iBegin; i < iEnd; i++) {
+					const Node & nodeTarget = nodesTarget[i];
+
+					// Only target nodes within the source mesh are mapped
+					locator.FindCandidateFaces(nodeTarget, vecCandidates);
+
+					bool fCovered = false;
+					for (int j = 0; j < vecCandidates.size(); j++) {
+						Face::NodeLocation loc;
+						int ixLocation;
+
+						meshutil.ContainsNode(
+							meshSource.faces[vecCandidates[j]],
+							meshSource.nodes,
+							nodeTarget,
+							loc,
+							ixLocation);
+
+						if (loc != Face::NodeLocation_Exterior) {
+							fCovered = true;
+							break;
+						}
+					}
+
+					if (!fCovered) {
+						vecChunkUncovered[c]++;
+						continue;
+					}
+
+					treeCenter.FindKNearest(nodeTarget, nCenters, vecCenterIx);
+
+					bool fComputed = false;
+					if (method == NonConservativeMethod_Bilinear) {
+						fComputed =
+							ComputeBilinearWeights(
+								TangentPlaneProjection(nodeTarget),
+								nodesCenter, vecCenterIx, i, vecEntries);
+
+					} else if (method == NonConservativeMethod_Patch) {
+						fComputed =
+							ComputePatchWeights(
+								TangentPlaneProjection(nodeTarget),
+								nodesCenter, vecCenterIx, i, vecEntries);
+					}
+
+					// Nearest neighbor, or fallback for degenerate stencils
+					if (!fComputed) {
+						if (method != NonConservativeMethod_NearestNeighbor) {
+							vecChunkFallback[c]++;
+						}
+						vecEntries.push_back(
+							SparseMatrixEntry<double>(i, vecCenterIx[0], 1.0));
+					}
+				}
+			});
+		}
+	}
+
+	capture.Rethrow();
+
+	int nUncovered = 0;
+	int nFallback = 0;
+	for (int c = 0; c < nChunks; c++) {
+		nUncovered += vecChunkUncovered[c];
+		nFallback += vecChunkFallback[c];
+	}
+	if (nUncovered != 0) {
+		Announce("%i target nodes are outside of the source mesh", nUncovered);
+	}
+	if (nFallback != 0) {
+		Announce("%i target nodes use nearest neighbor weights", nFallback);
+	}
+
+	AnnounceEndBlock(NULL);
+
+	// Assemble the map entries of all chunks in target order
+	mapRemap.GetSparseMatrix().AssembleEntries(vecChunkEntries, nThreads);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
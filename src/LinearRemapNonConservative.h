@@ -0,0 +1,103 @@
+///////////////////////////////////////////////////////////////////////////////
+///
+///	\file    LinearRemapNonConservative.h
+///	\author  agent
+///	\version October 15, 2026
+///
+///	<remarks>
+///		Copyright 2026 agent
+///
+///		This file is distributed as part of the Tempest source code package.
+///		Permission is granted to use, copy, modify and distribute this
+///		source code and its documentation under the terms of the GNU General
+///		Public License.  This software is provided "as is" without express
+///		or implied warranty.
+///	</remarks>
+
+#ifndef _LINEARREMAPNONCONSERVATIVE_H_
+#define _LINEARREMAPNONCONSERVATIVE_H_
+
+///////////////////////////////////////////////////////////////////////////////
+
+#include "GridElements.h"
+#include "DataArray3D.h"
+
+#include <string>
+
+class OfflineMap;
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Method used to generate a map without an overlap mesh.  Source
+///		values are taken to be located at the centers of source faces.
+///	</summary>
+enum NonConservativeMethod {
+	NonConservativeMethod_Conservative,
+	NonConservativeMethod_NearestNeighbor,
+	NonConservativeMethod_Bilinear,
+	NonConservativeMethod_Patch
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Parse a map method [conserve|nn|bilin|patch].
+///	</summary>
+NonConservativeMethod ParseNonConservativeMethod(
+	const std::string & strMethod
+);
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Get the center of each Face of a finite volume target mesh, in the
+///		order of the target degrees of freedom.
+///	</summary>
+void GetNonConservativeTargetNodesFV(
+	const Mesh & meshTarget,
+	NodeVector & nodesTarget
+);
+
+///	<summary>
+///		Get the location of each GLL node of a finite element target mesh,
+///		in the order of the target degrees of freedom.  Continuous nodes
+///		are ordered by their index in dataGLLNodes.
+///	</summary>
+void GetNonConservativeTargetNodesGLL(
+	const Mesh & meshTarget,
+	int nP,
+	const DataArray3D<int> & dataGLLNodes,
+	bool fContinuous,
+	NodeVector & nodesTarget
+);
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Generate the OfflineMap from a finite volume source mesh to the
+///		target nodes nodesTarget without an overlap mesh.  Each target node
+///		is located in the source mesh with a FaceLocator, and target nodes
+///		outside of the source mesh receive no weights.  Weights are then
+///		computed from the centers of nearby source faces found with a KD
+///		tree:
+///		  NearestNeighbor: the value of the nearest center.
+///		  Bilinear: barycentric interpolation on the triangle of the fan
+///		    of nearby centers around the nearest center that contains the
+///		    target node, or the nearest value if there is none.
+///		  Patch: a linear least squares fit through the nearest centers.
+///		The weights of each row sum to one, but the map is not conservative.
+///		The map does not depend on nThreads.
+///	</summary>
+void LinearRemapNonConservative(
+	const Mesh & meshSource,
+	const NodeVector & nodesTarget,
+	NonConservativeMethod method,
+	OfflineMap & mapRemap,
+	int nThreads = 1
+);
+
+///////////////////////////////////////////////////////////////////////////////
+
+#endif
+
@@ -20,98 +20,13 @@
 #include "GaussLobattoQuadrature.h"
 #include "TriangularQuadrature.h"
 #include "MeshUtilitiesFuzzy.h"
+#include "OmpExceptionCapture.h"
 
 #include "Announce.h"
 
-///////////////////////////////////////////////////////////////////////////////
-
-
-extern "C" {
-/*
-	/// Routine from DQED.h to solve constrained bounded least squares problems
-	void dbocls_(
-		double * w,
-		int * mdw,
-		int * mcon,
-		int * mrows,
-		int * ncols,
-		double * bl,
-		double * bu,
-		int * ind,
-		int * iopt,
-		double * x,
-		double * rnormc,
-		double * rnorm,
-		int * mode,
-		double * rw,
-		int * iw);
-*/
-	/// Matrix vector multiply
-	int dgemv_(
-		char * trans,
-		int * m,
-		int * n,
-		double * alpha,
-		double * a,
-		int * lda,
-		double * x,
-		int * incx,
-		double * beta,
-		double * y,
-		int * incy);
-
-	///	General matrix solver from CLAPACK
-	int dgesv_(
-		int * n,
-		int * nrhs,
-		double * a,
-		int * lda,
-		int * ipiv,
-		double * b,
-		int * ldb,
-		int * info);
-
-	/// Symmetric positive definite matrix solver from CLAPACK
-	int dposv_(
-		char * uplo,
-		int * n,
-		int * nrhs,
-		double * a,
-		int * lda,
-		double * b,
-		int * ldb,
-		int * info);
-
-	/// Symmetric matrix solver from CLAPACK
-	int dsysv_(
-		char * uplo,
-		int * n,
-		int * nrhs,
-		double * a,
-		int * lda,
-		int * ipiv,
-		double * b,
-		int * ldb,
-		double * work,
-		int * lwork,
-		int * info);
-
-	/// Constrained least squares solver
-	int dgglse_(
-		int * m,
-		int * n,
-		int * p,
-		double * a,
-		int * lda,
-		double * b,
-		int * ldb,
-		double * c,
-		double * d,
-		double * x,
-		double * work,
-		int * lwork,
-		int * info);
-}
+#include <vector>
+#include <algorithm>
+#include <cmath>
 
 ///////////////////////////////////////////////////////////////////////////////
 
@@ -175,169 +90,94 @@ void LinearRemapSE0(
 
 ///////////////////////////////////////////////////////////////////////////////
 
+///	<summary>
+///		Maximum number of active set iterations in
+///		ForceConsistencyConservation.
+///	</summary>
+static const int ForceConservationMaxIterations = 100;
+
+///////////////////////////////////////////////////////////////////////////////
+
 void ForceConsistencyConservation(
 	const DataArray1D<double> & vecSourceArea,
 	const DataArray1D<double> & vecTargetArea,
 	DataArray2D<double> & dCoeff,
 	bool fMonotone
 ) {
-	int ncols = dCoeff.GetRows() * dCoeff.GetColumns();
-	int mrows = dCoeff.GetRows() * dCoeff.GetColumns();
-	//int mcon = dCoeff.GetRows() + dCoeff.GetColumns();
-	int mcon = dCoeff.GetColumns();
-
-	int mdw = mcon + mrows;
-
-	// Allocate arrays
-	DataArray2D<double> dW(ncols+mcon+1, mdw);
-
-	DataArray1D<double> dBL(ncols + mcon);
-	DataArray1D<double> dBU(ncols + mcon);
-	DataArray1D<double> dX(2*(ncols+mcon)+2);
-	DataArray1D<double> dRW(6 * ncols + 5 * mcon);
-	DataArray1D<int> iInd(ncols + mcon);
-
-	DataArray1D<int> iOpt(32);
-	iOpt[0] = 99;
-
-	DataArray1D<int> iIW(2*(ncols+mcon));
-
-	double dRNormC = -1.0;
-	double dRNorm = -1.0;
-	int iMode = -1;
-
-	// Matrix elements
-	int ix = 0;
-/*
-	// Consistency
-	for (int i = 0; i < dCoeff.GetRows(); i++) {
-		for (int j = 0; j < dCoeff.GetColumns(); j++) {
-			dW[i * dCoeff.GetColumns() + j][ix] = 1.0;
-		}
-		ix++;
-	}
-*/
-	// Conservation
-	for (int j = 0; j < dCoeff.GetColumns(); j++) {
-		for (int i = 0; i < dCoeff.GetRows(); i++) {
-			dW[i * dCoeff.GetColumns() + j][ix] = vecTargetArea[i];
-		}
-		ix++;
-	}
-
-	// Least squares problem:
-	// Minimize L2 error between high-order coefficients and new coefficients
-	ix = 0;
+	// Replace dCoeff by the nearest coefficients in the L2 norm that are
+	// conservative, and within [0,1] if fMonotone.  The conditions on each
+	// column are independent.  Without bounds each column is shifted along
+	// vecTargetArea; with bounds, coefficients that leave [0,1] are fixed
+	// at the bound and the column is projected again over the remaining
+	// coefficients.
+	const int nRows = dCoeff.GetRows();
+	const int nCols = dCoeff.GetColumns();
+
+	std::vector<bool> vecFixed(nRows);
+
+	for (int j = 0; j < nCols; j++) {
+
+		std::fill(vecFixed.begin(), vecFixed.end(), false);
+
+		int iter = 0;
+		for (; iter < ForceConservationMaxIterations; iter++) {
+
+			// Project onto the conservation condition over free coefficients
+			double dResidual = - vecSourceArea[j];
+			double dP = 0.0;
+			for (int i = 0; i < nRows; i++) {
+				dResidual += vecTargetArea[i] * dCoeff[i][j];
+				if (!vecFixed[i]) {
+					dP += vecTargetArea[i] * vecTargetArea[i];
+				}
+			}
 
-	for (int i = 0; i < dCoeff.GetRows(); i++) {
-	for (int j = 0; j < dCoeff.GetColumns(); j++) {
-		dW[ix][ix + mcon] = 1.0;
-		dW[ncols][ix + mcon] = dCoeff[i][j];
-		ix++;
-	}
-	}
+			if (!(dP > 0.0)) {
+				if (fabs(dResidual) > 0.0) {
+					_EXCEPTION1("Unable to enforce conservation of "
+						"column %i", j);
+				}
+				break;
+			}
 
-	FILE * fp = fopen("w.txt", "w");
-	for (int i = 0; i < dW.GetRows(); i++) {
-		for (int j = 0; j < dW.GetColumns(); j++) {
-			fprintf(fp, "%1.10e ", dW[i][j]);
-		}
-		fprintf(fp, "\n");
-	}
-	fclose(fp);
+			const double dMu = dResidual / dP;
+			for (int i = 0; i < nRows; i++) {
+				if (!vecFixed[i]) {
+					dCoeff[i][j] -= dMu * vecTargetArea[i];
+				}
+			}
 
-	// Apply constraints
-	ix = 0;
+			if (!fMonotone) {
+				break;
+			}
 
-	// Monotonicity
-	if (fMonotone) {
-		for (int i = 0; i < ncols; i++) {
-			dBL[ix] = 0.0;
-			dBU[ix] = 1.0;
-			iInd[ix] = 3;
-			ix++;
-		}
+			// Fix coefficients that violate the bounds
+			bool fViolation = false;
+			for (int i = 0; i < nRows; i++) {
+				if (vecFixed[i]) {
+					continue;
+				}
+				if (dCoeff[i][j] < 0.0) {
+					dCoeff[i][j] = 0.0;
+					vecFixed[i] = true;
+					fViolation = true;
+				} else if (dCoeff[i][j] > 1.0) {
+					dCoeff[i][j] = 1.0;
+					vecFixed[i] = true;
+					fViolation = true;
+				}
+			}
 
-	} else {
-		for (int i = 0; i < ncols; i++) {
-			iInd[ix] = 4;
-			ix++;
+			if (!fViolation) {
+				break;
+			}
 		}
-	}
-/*
-	// Consistency
-	for (int i = 0; i < dCoeff.GetRows(); i++) {
-		dBL[ix] = 1.0;
-		dBU[ix] = 1.0;
-		iInd[ix] = 3;
-		ix++;
-	}
-*/
-	// Conservation
-	for (int j = 0; j < dCoeff.GetColumns(); j++) {
-		dBL[ix] = vecSourceArea[j];
-		dBU[ix] = vecSourceArea[j];
-		iInd[ix] = 3;
-		ix++;
-	}
-/*
-	for (int i = 0; i < dBL.GetRows(); i++) {
-		printf("B%i: %1.15e %1.15e %i\n", i, dBL[i], dBU[i], iInd[i]);
-	}
-*/
-	// Solve least squares problem
-	DataArray2D<double> dWin = dW;
-/*
-	dbocls_(
-		&(dW[0][0]),
-		&mdw,
-		&mcon,
-		&mrows,
-		&ncols,
-		dBL,
-		dBU,
-		iInd,
-		iOpt,
-		dX,
-		&dRNormC,
-		&dRNorm,
-		&iMode,
-		dRW,
-		iIW);
-*/
-	if (iMode >= 0) {
-		printf("\nSUCCESS (%i)\n", iMode);
-	} else {
-		_EXCEPTION1("\nFAIL (%i)\n", iMode);
-	}
 
-	printf("\nNorm: %1.15e %1.15e\n", dRNorm, dRNormC);
-/*
-	ix = 0;
-	for (int i = 0; i < dCoeff.GetColumns(); i++) {
-		double dProduct = 0.0;
-		for (int j = 0; j < dCoeff.GetColumns() * dCoeff.GetRows(); j++) {
-			dProduct += dWin[j][i] * dX[j];
+		if (iter == ForceConservationMaxIterations) {
+			_EXCEPTION1("Active set iteration did not converge in "
+				"column %i", j);
 		}
-		printf("%1.15e %1.15e\n", dProduct, vecSourceArea[i]);
-	}
-
-	for (int i = 0; i < dX.GetRows(); i++) {
-		printf("X%i: %1.15e\n", i, dX[i]);
-	}
-
-	for (int i = 0; i < dBL.GetRows(); i++) {
-		printf("B%i: %1.15e %1.15e %i\n", i, dBL[i], dBU[i], iInd[i]);
-	}
-
-	for (int i = 0; i < dCoeff.GetRows(); i++) {
-	for (int j = 0; j < dCoeff.GetColumns(); j++) {
-		//printf("%1.15e %1.15e\n", dCoeff[i][j], dX[ix]);
-		printf("%1.15e, ", dX[ix]);
-		ix++;
-	}
 	}
-*/
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -348,155 +188,7 @@ void ForceConsistencyConservation2(
 	DataArray2D<double> & dCoeff,
 	bool fMonotone
 ) {
-	// Number of free coefficients
-	int nCoeff = dCoeff.GetRows() * dCoeff.GetColumns();
-
-	// Number of conditions
-	int nCondConservation = dCoeff.GetColumns();
-	int nCondConsistency  = dCoeff.GetRows();
-
-	// One condition is dropped due to linear dependence
-	int nCond = nCondConservation + nCondConsistency - 1;
-
-	// The Lagrangian matrix and RHS vector
-	DataArray2D<double> dLagrangian(nCoeff + nCond, nCoeff + nCond);
-
-	DataArray1D<double> dRHS(nCoeff + nCond);
-
-	// Build the Lagrangian matrix
-	int ix = 0;
-
-	for (int i = 0; i < dCoeff.GetRows(); i++) {
-	for (int j = 0; j < dCoeff.GetColumns(); j++) {
-
-		// Least squares conditions
-		dLagrangian[ix][ix] = 1.0;
-		dLagrangian[nCoeff + i][ix] = - 1.0;
-
-		if (j != dCoeff.GetColumns()-1) {
-			dLagrangian[nCoeff + nCondConsistency + j][ix] = - vecTargetArea[i];
-		}
-
-		// Consistency
-		dLagrangian[ix][nCoeff + i] = -1.0;
-
-		// Conservation
-		if (j != dCoeff.GetColumns()-1) {
-			dLagrangian[ix][nCoeff + nCondConsistency + j] = - vecTargetArea[i];
-		}
-
-		// RHS vector
-		dRHS[ix] = dCoeff[i][j];
-
-		ix++;
-	}
-	}
-
-	FILE * fp = fopen("lagrangian.dat", "w");
-	for (int i = 0; i < dLagrangian.GetRows(); i++) {
-		for (int j = 0; j < dLagrangian.GetColumns(); j++) {
-			fprintf(fp, "%1.15e\t", dLagrangian[i][j]);
-		}
-		fprintf(fp, "\n");
-	}
-	fclose(fp);
-
-	// Consistency and conservation of RHS vector
-	for (int i = 0; i < dCoeff.GetRows(); i++) {
-		dRHS[nCoeff + i] = -1.0;
-	}
-	for (int i = 0; i < dCoeff.GetColumns()-1; i++) {
-		dRHS[nCoeff + nCondConsistency + i] = - vecSourceArea[i];
-	}
-
-	// Solve the system
-	DataArray1D<int> iPIV(dLagrangian.GetRows());
-
-	int n = dLagrangian.GetRows();
-	int nRHS = 1;
-	int nLDA = n;
-	int nLDB = n;
-	int nInfo;
-/*
-	dgesv_(
-		&n,
-		&nRHS,
-		&(dLagrangian[0][0]),
-		&nLDA,
-		&(iPIV[0]),
-		&(dRHS[0]),
-		&nLDB,
-		&nInfo);
-*/
-	char uplo = 'U';
-
-	int lWork = n;
-	DataArray1D<double> dWork(lWork);
-
-	dsysv_(
-		&uplo,
-		&n,
-		&nRHS,
-		&(dLagrangian[0][0]),
-		&nLDA,
-		&(iPIV[0]),
-		&(dRHS[0]),
-		&nLDB,
-		&(dWork[0]),
-		&lWork,
-		&nInfo);
-
-	if (nInfo != 0) {
-		_EXCEPTION1("Cannot solve target system: %i", nInfo);
-	}
-
-	/*
-	printf("Info: %i\n", nInfo);
-
-	// Output the result
-	ix = 0;
-	for (int i = 0; i < dCoeff.GetRows(); i++) {
-	for (int j = 0; j < dCoeff.GetColumns(); j++) {
-		printf("%1.15e %1.15e\n", dCoeff[i][j], dRHS[ix]);
-		ix++;
-	}
-	}
-
-	// Verify consistency
-	ix = 0;
-	for (int i = 0; i < dCoeff.GetRows(); i++) {
-		double dRowSum = 0.0;
-		for (int j = 0; j < dCoeff.GetColumns(); j++) {
-			dRowSum += dRHS[ix];
-			ix++;
-		}
-		printf("Row %i: %1.15e\n", i, dRowSum);
-	}
-
-	// Verify conservation
-	ix = 0;
-	DataArray1D<double> dColumnSums(dCoeff.GetColumns());
-
-	for (int i = 0; i < dCoeff.GetRows(); i++) {
-		double dRowSum = 0.0;
-		for (int j = 0; j < dCoeff.GetColumns(); j++) {
-			dColumnSums[j] += dRHS[ix] * vecTargetArea[i];
-			ix++;
-		}
-	}
-	for (int j = 0; j < dCoeff.GetColumns(); j++) {
-		printf("Column %i: %1.15e %1.15e\n", j, dColumnSums[j], vecSourceArea[j]);
-	}
-	*/
-
-	// Store coefficients in array
-	ix = 0;
-	for (int i = 0; i < dCoeff.GetRows(); i++) {
-	for (int j = 0; j < dCoeff.GetColumns(); j++) {
-		dCoeff[i][j] = dRHS[ix];
-		ix++;
-	}
-	}
+	ProjectConsistencyConservation(vecSourceArea, vecTargetArea, dCoeff);
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -507,229 +199,69 @@ void ForceConsistencyConservation3(
 	DataArray2D<double> & dCoeff,
 	bool fMonotone
 ) {
-
-	// Number of free coefficients
-	int nCoeff = dCoeff.GetRows() * dCoeff.GetColumns();
-
-	// Number of conditions
-	int nCondConservation = dCoeff.GetColumns();
-	int nCondConsistency  = dCoeff.GetRows();
-
-	// One condition is dropped due to linear dependence
-	int nCond = nCondConservation + nCondConsistency - 1;
-
-	// Product matrix
-	DataArray2D<double> dCCt(nCond, nCond);
-	DataArray2D<double> dC(nCoeff, nCond);
-
-	DataArray1D<double> dRHS(nCoeff + nCond);
-
-	// RHS
-	int ix = 0;
-	for (int i = 0; i < dCoeff.GetRows(); i++) {
-	for (int j = 0; j < dCoeff.GetColumns(); j++) {
-		dRHS[ix] = dCoeff[i][j];
-		ix++;
-	}
-	}
-
-	// Consistency
-	ix = 0;
-	for (int i = 0; i < dCoeff.GetRows(); i++) {
-		for (int j = 0; j < dCoeff.GetColumns(); j++) {
-			dC[i * dCoeff.GetColumns() + j][ix] = 1.0;
-		}
-		dRHS[nCoeff + ix] = 1.0;
-		ix++;
-	}
-
-	// Conservation
-	for (int j = 0; j < dCoeff.GetColumns()-1; j++) {
-		for (int i = 0; i < dCoeff.GetRows(); i++) {
-			dC[i * dCoeff.GetColumns() + j][ix] = vecTargetArea[i];
-		}
-		dRHS[nCoeff + ix] = vecSourceArea[j];
-		ix++;
-	}
-
-	// Calculate CCt
-	double dP = 0.0;
-	for (int i = 0; i < dCoeff.GetRows(); i++) {
-		dP += vecTargetArea[i] * vecTargetArea[i];
-	}
-
-	for (int i = 0; i < dCoeff.GetRows(); i++) {
-		dCCt[i][i] = static_cast<double>(dCoeff.GetColumns());
-		for (int j = 0; j < dCoeff.GetColumns()-1; j++) {
-			dCCt[i][dCoeff.GetRows() + j] = vecTargetArea[i];
-			dCCt[dCoeff.GetRows() + j][i] = vecTargetArea[i];
-		}
-	}
-
-	for (int i = 0; i < dCoeff.GetColumns()-1; i++) {
-		int ix = dCoeff.GetRows() + i;
-		dCCt[ix][ix] = dP;
-	}
-/*
-	for (int i = 0; i < nCond; i++) {
-	for (int j = 0; j < nCond; j++) {
-		for (int k = 0; k < nCoeff; k++) {
-			dCCt[i][j] += dC[k][i] * dC[k][j];
-		}
-	}
-	}
-*/
-/*
-	FILE * fp = fopen("cct.dat", "w");
-	for (int i = 0; i < nCond; i++) {
-		for (int j = 0; j < nCond; j++) {
-			fprintf(fp, "%1.15e\t", dCCt[i][j]);
-		}
-		fprintf(fp, "\n");
-	}
-	fclose(fp);
-	_EXCEPTION();
-*/
-	// Calculate C*r1 - r2
-	char trans = 'n';
-	int m = nCond;
-	int n = nCoeff;
-	int lda = m;
-	int incx = 1;
-	int incy = 1;
-	double posone = 1.0;
-	double negone = -1.0;
-	dgemv_(
-		&trans,
-		&m,
-		&n,
-		&posone,
-		&(dC[0][0]),
-		&lda,
-		&(dRHS[0]),
-		&incx,
-		&negone,
-		&(dRHS[nCoeff]),
-		&incy);
-
-	// Solve the general system
-	int nrhs = 1;
-	int ldb = nCond;
-
-	int nInfo;
-/*
-	DataArray1D<int> iPIV(nCond);
-
-	dgesv_(
-		&m,
-		&nrhs,
-		&(dCCt[0][0]),
-		&lda,
-		&(iPIV[0]),
-		&(dRHS[nCoeff]),
-		&ldb,
-		&nInfo);
-*/
-	char uplo = 'U';
-	dposv_(
-		&uplo,
-		&m,
-		&nrhs,
-		&(dCCt[0][0]),
-		&lda,
-		&(dRHS[nCoeff]),
-		&ldb,
-		&nInfo);
-
-	if (nInfo != 0) {
-		_EXCEPTION1("Unable to solve SPD Schur system: %i\n", nInfo);
-	}
-
-	// Obtain coefficients
-	trans = 't';
-	dgemv_(
-		&trans,
-		&m,
-		&n,
-		&negone,
-		&(dC[0][0]),
-		&lda,
-		&(dRHS[nCoeff]),
-		&incx,
-		&posone,
-		&(dRHS[0]),
-		&incy);
-
-	// Store coefficients in array
-	ix = 0;
-	for (int i = 0; i < dCoeff.GetRows(); i++) {
-	for (int j = 0; j < dCoeff.GetColumns(); j++) {
-		dCoeff[i][j] = dRHS[ix];
-		ix++;
-	}
-	}
+	ProjectConsistencyConservation(vecSourceArea, vecTargetArea, dCoeff);
 
 	// Force monotonicity
 	if (fMonotone) {
+		BlendMonotoneCoefficients(vecSourceArea, dCoeff);
+	}
+}
 
-		// Calculate total element Jacobian
-		double dTotalJacobian = 0.0;
-		for (int i = 0; i < vecSourceArea.GetRows(); i++) {
-			dTotalJacobian += vecSourceArea[i];
-		}
-
-		// Determine low-order remap coefficients
-		DataArray2D<double> dMonoCoeff(dCoeff.GetRows(), dCoeff.GetColumns());
-
-		for (int i = 0; i < dCoeff.GetRows(); i++) {
-		for (int j = 0; j < dCoeff.GetColumns(); j++) {
-			dMonoCoeff[i][j] =
-				vecSourceArea[j]
-				/ dTotalJacobian;
-		}
-		}
+///////////////////////////////////////////////////////////////////////////////
 
-		// Compute scaling factor
-		double dA = 0.0;
-		for (int i = 0; i < dCoeff.GetRows(); i++) {
-		for (int j = 0; j < dCoeff.GetColumns(); j++) {
-			if (dCoeff[i][j] < 0.0) {
-				double dNewA =
-					- dCoeff[i][j] / fabs(dMonoCoeff[i][j] - dCoeff[i][j]);
+///	<summary>
+///		Number of source faces in each chunk of work in LinearRemapSE4.
+///		Chunks are merged into the map in source face order so that the
+///		map does not depend on the thread count.
+///	</summary>
+static const int LinearRemapSE4ChunkSize = 256;
 
-				if (dNewA > dA) {
-					dA = dNewA;
-				}
-			}
-		}
-		}
+///////////////////////////////////////////////////////////////////////////////
 
-		for (int i = 0; i < dCoeff.GetRows(); i++) {
-		for (int j = 0; j < dCoeff.GetColumns(); j++) {
-			dCoeff[i][j] = (1.0 - dA) * dCoeff[i][j] + dA * dMonoCoeff[i][j];
-		}
-		}
-	}
-}
+///	<summary>
+///		Scratch arrays used by LinearRemapSE4Face, allocated once per chunk
+///		of source faces.
+///	</summary>
+struct LinearRemapSE4Workspace {
+	LinearRemapSE4Workspace(
+		int nP
+	) :
+		vecSourceArea(nP * nP)
+	{ }
+
+	DataArray1D<double> vecSourceArea;
+	DataArray1D<double> vecTargetArea;
+	DataArray2D<double> dCoeff;
+	DataArray3D<double> dRemapCoeff;
+};
 
 ///////////////////////////////////////////////////////////////////////////////
 
-void LinearRemapSE4(
+///	<summary>
+///		Compute the remap coefficients of source face ixFirst, which is
+///		overlapped by the nOverlapFaces overlap faces starting at ixOverlap,
+///		and append them to vecEntries.  NP is the order of the source
+///		finite element if fixed at compile time, or 0 otherwise.
+///	</summary>
+template <int NP>
+static void LinearRemapSE4Face(
 	const Mesh & meshInput,
 	const Mesh & meshOutput,
 	const Mesh & meshOverlap,
 	const DataArray3D<int> & dataGLLNodes,
 	const DataArray3D<double> & dataGLLJacobian,
+	const TriangularQuadratureRule & triquadrule,
 	int nMonotoneType,
 	bool fContinuousIn,
 	bool fNoConservation,
-	OfflineMap & mapRemap
+	int ixFirst,
+	int ixOverlap,
+	int nOverlapFaces,
+	LinearRemapSE4Workspace & workspace,
+	std::vector< SparseMatrixEntry<double> > & vecEntries
 ) {
 	// Order of the polynomial interpolant
-	int nP = dataGLLNodes.GetRows();
-
-	// Triangular quadrature rule
-	TriangularQuadratureRule triquadrule(4);
+	const int nP = (NP > 0)?(NP):(dataGLLNodes.GetRows());
 
 	int TriQuadraturePoints = triquadrule.GetPoints();
 
@@ -737,880 +269,482 @@ void LinearRemapSE4(
 
 	const DataArray1D<double> & TriQuadratureW = triquadrule.GetW();
 
-	// Sample coefficients
-	DataArray2D<double> dSampleCoeff(nP, nP);
-
-	// GLL Quadrature nodes on quadrilateral elements
-	DataArray1D<double> dG;
-	DataArray1D<double> dW;
-	GaussLobattoQuadrature::GetPoints(nP, 0.0, 1.0, dG, dW);
-
-	// Get SparseMatrix represntation of the OfflineMap
-	SparseMatrix<double> & smatMap = mapRemap.GetSparseMatrix();
-
 	// NodeVector from meshOverlap
 	const NodeVector & nodesOverlap = meshOverlap.nodes;
 	const NodeVector & nodesFirst   = meshInput.nodes;
 
-	// Vector of source areas
-	DataArray1D<double> vecSourceArea(nP * nP);
-
-	DataArray1D<double> vecTargetArea;
-
-	DataArray2D<double> dCoeff;
-
-	// Current Overlap Face
-	int ixOverlap = 0;
-
-	// Loop over all input Faces
-	for (int ixFirst = 0; ixFirst < meshInput.faces.size(); ixFirst++) {
+	// Scratch arrays
+	GLLSampleCoeff<NP> dSampleCoeff(nP);
+	DataArray1D<double> & vecSourceArea = workspace.vecSourceArea;
+	DataArray1D<double> & vecTargetArea = workspace.vecTargetArea;
+	DataArray2D<double> & dCoeff = workspace.dCoeff;
+	DataArray3D<double> & dRemapCoeff = workspace.dRemapCoeff;
 
-		const Face & faceFirst = meshInput.faces[ixFirst];
+	const Face & faceFirst = meshInput.faces[ixFirst];
 
-		if (faceFirst.edges.size() != 4) {
-			_EXCEPTIONT("Only quadrilateral elements allowed for SE remapping");
-		}
+	if (faceFirst.edges.size() != 4) {
+		_EXCEPTIONT("Only quadrilateral elements allowed for SE remapping");
+	}
 
-		// Output every 100 elements
-		if (ixFirst % 1000 == 0) {
-			Announce("Element %i/%i", ixFirst,meshInput.faces.size());
-		}
+	// No overlaps
+	if (nOverlapFaces == 0) {
+		return;
+	}
 
-		// Number of overlapping Faces and triangles
-		int nOverlapFaces = 0;
-		int nTotalOverlapTriangles = 0;
+	// Allocate remap coefficients array for meshFirst Face
+	dRemapCoeff.Allocate(nP, nP, nOverlapFaces);
+
+	// Sub-triangle of an Overlap Face
+	Face faceTri(3);
+
+	// Find the local remap coefficients
+	for (int j = 0; j < nOverlapFaces; j++) {
+		const Face & faceOverlap = meshOverlap.faces[ixOverlap + j];
+
+		int nOverlapTriangles = faceOverlap.edges.size() - 2;
+
+		// Loop over all sub-triangles of this Overlap Face
+		for (int k = 0; k < nOverlapTriangles; k++) {
+
+			// Cornerpoints of triangle
+			const Node & node0 = nodesOverlap[faceOverlap[0]];
+			const Node & node1 = nodesOverlap[faceOverlap[k+1]];
+			const Node & node2 = nodesOverlap[faceOverlap[k+2]];
+
+			// Calculate the area of the modified Face
+			faceTri.SetNode(0, faceOverlap[0]);
+			faceTri.SetNode(1, faceOverlap[k+1]);
+			faceTri.SetNode(2, faceOverlap[k+2]);
+
+			double dTriangleArea =
+				CalculateFaceArea(faceTri, nodesOverlap);
+
+			// Coordinates of quadrature Node
+			for (int l = 0; l < TriQuadraturePoints; l++) {
+				Node nodeQuadrature;
+				nodeQuadrature.x =
+					  TriQuadratureG[l][0] * node0.x
+					+ TriQuadratureG[l][1] * node1.x
+					+ TriQuadratureG[l][2] * node2.x;
+
+				nodeQuadrature.y =
+					  TriQuadratureG[l][0] * node0.y
+					+ TriQuadratureG[l][1] * node1.y
+					+ TriQuadratureG[l][2] * node2.y;
+
+				nodeQuadrature.z =
+					  TriQuadratureG[l][0] * node0.z
+					+ TriQuadratureG[l][1] * node1.z
+					+ TriQuadratureG[l][2] * node2.z;
+
+				double dMag = sqrt(
+					  nodeQuadrature.x * nodeQuadrature.x
+					+ nodeQuadrature.y * nodeQuadrature.y
+					+ nodeQuadrature.z * nodeQuadrature.z);
+
+				nodeQuadrature.x /= dMag;
+				nodeQuadrature.y /= dMag;
+				nodeQuadrature.z /= dMag;
+
+				// Find components of quadrature point in basis
+				// of the first Face
+				double dAlpha;
+				double dBeta;
+
+				ApplyInverseMap(
+					faceFirst,
+					nodesFirst,
+					nodeQuadrature,
+					dAlpha,
+					dBeta);
+
+				// Check inverse map value
+				if ((dAlpha < -InverseMapTolerance)      ||
+					(dAlpha > 1.0 + InverseMapTolerance) ||
+					(dBeta  < -InverseMapTolerance)      ||
+					(dBeta  > 1.0 + InverseMapTolerance)
+				) {
+					printf("\n==== BEGIN DEBUGGING INFO ====\n");
+					printf("WARNING (%s, Line %u) Inverse map out of range\n",
+						__FILE__, __LINE__);
+					int ixSecond = meshOverlap.vecTargetFaceIx[ixOverlap + j];
+					printf("Source face ix %i, Target face ix %i, Overlap face ix %i\n",
+						ixFirst, ixSecond, ixOverlap + j);
+					printf("Face nodes:\n");
+					for (int x = 0; x < faceFirst.edges.size(); x++) {
+						nodesFirst[faceFirst[x]].Print("");
+					}
+					printf("Quadrature node:\n");
+					nodeQuadrature.Print("");
+					printf("Alpha, Beta: %1.15e %1.15e\n", dAlpha, dBeta);
+					printf("==== END DEBUGGING INFO ====\n");
+					//_EXCEPTION2("Inverse Map out of range (%1.5e %1.5e)",
+					//	dAlpha, dBeta);
+				}
 
-		// Determine how many overlap Faces and triangles are present
-		int ixOverlapTemp = ixOverlap;
-		for (; ixOverlapTemp < meshOverlap.faces.size(); ixOverlapTemp++) {
+				// Sample the finite element at this point
+				dSampleCoeff.Sample(nMonotoneType, dAlpha, dBeta);
 
-			const Face & faceOverlap = meshOverlap.faces[ixOverlapTemp];
+				// Add sample coefficients to the map
+				for (int p = 0; p < nP; p++) {
+				for (int q = 0; q < nP; q++) {
 
-			if (meshOverlap.vecSourceFaceIx[ixOverlapTemp] != ixFirst) {
-				break;
+					dRemapCoeff[p][q][j] +=
+						TriQuadratureW[l]
+						* dTriangleArea
+						* dSampleCoeff[p][q]
+						/ meshOverlap.vecFaceArea[ixOverlap + j];
+				}
+				}
 			}
-
-			nOverlapFaces++;
-			nTotalOverlapTriangles += faceOverlap.edges.size() - 2;
 		}
+	}
 
-		// No overlaps
-		if (nOverlapFaces == 0) {
-			continue;
-		}
-
-		// Allocate remap coefficients array for meshFirst Face
-		DataArray3D<double> dRemapCoeff(nP, nP, nOverlapFaces);
-
-		// Find the local remap coefficients
+	// Force consistency and conservation
+	if (!fNoConservation) {
+		double dTargetArea = 0.0;
 		for (int j = 0; j < nOverlapFaces; j++) {
-			const Face & faceOverlap = meshOverlap.faces[ixOverlap + j];
-
-			int nOverlapTriangles = faceOverlap.edges.size() - 2;
-
-			// Loop over all sub-triangles of this Overlap Face
-			for (int k = 0; k < nOverlapTriangles; k++) {
-
-				// Cornerpoints of triangle
-				const Node & node0 = nodesOverlap[faceOverlap[0]];
-				const Node & node1 = nodesOverlap[faceOverlap[k+1]];
-				const Node & node2 = nodesOverlap[faceOverlap[k+2]];
-
-				// Calculate the area of the modified Face
-				Face faceTri(3);
-				faceTri.SetNode(0, faceOverlap[0]);
-				faceTri.SetNode(1, faceOverlap[k+1]);
-				faceTri.SetNode(2, faceOverlap[k+2]);
-
-				double dTriangleArea =
-					CalculateFaceArea(faceTri, nodesOverlap);
-
-				// Coordinates of quadrature Node
-				for (int l = 0; l < TriQuadraturePoints; l++) {
-					Node nodeQuadrature;
-					nodeQuadrature.x =
-						  TriQuadratureG[l][0] * node0.x
-						+ TriQuadratureG[l][1] * node1.x
-						+ TriQuadratureG[l][2] * node2.x;
-
-					nodeQuadrature.y =
-						  TriQuadratureG[l][0] * node0.y
-						+ TriQuadratureG[l][1] * node1.y
-						+ TriQuadratureG[l][2] * node2.y;
-
-					nodeQuadrature.z =
-						  TriQuadratureG[l][0] * node0.z
-						+ TriQuadratureG[l][1] * node1.z
-						+ TriQuadratureG[l][2] * node2.z;
-
-					double dMag = sqrt(
-						  nodeQuadrature.x * nodeQuadrature.x
-						+ nodeQuadrature.y * nodeQuadrature.y
-						+ nodeQuadrature.z * nodeQuadrature.z);
-
-					nodeQuadrature.x /= dMag;
-					nodeQuadrature.y /= dMag;
-					nodeQuadrature.z /= dMag;
-
-					// Find components of quadrature point in basis
-					// of the first Face
-					double dAlpha;
-					double dBeta;
-
-					ApplyInverseMap(
-						faceFirst,
-						nodesFirst,
-						nodeQuadrature,
-						dAlpha,
-						dBeta);
-
-					// Check inverse map value
-					if ((dAlpha < -InverseMapTolerance)      ||
-						(dAlpha > 1.0 + InverseMapTolerance) ||
-						(dBeta  < -InverseMapTolerance)      ||
-						(dBeta  > 1.0 + InverseMapTolerance)
-					) {
-						printf("\n==== BEGIN DEBUGGING INFO ====\n");
-						printf("WARNING (%s, Line %u) Inverse map out of range\n",
-							__FILE__, __LINE__);
-						int ixSecond = meshOverlap.vecTargetFaceIx[ixOverlap + j];
-						printf("Source face ix %i, Target face ix %i, Overlap face ix %i\n",
-							ixFirst, ixSecond, ixOverlap + j);
-						printf("Face nodes:\n");
-						for (int x = 0; x < faceFirst.edges.size(); x++) {
-							nodesFirst[faceFirst[x]].Print("");
-						}
-						printf("Quadrature node:\n");
-						nodeQuadrature.Print("");
-						printf("Alpha, Beta: %1.15e %1.15e\n", dAlpha, dBeta);
-						printf("==== END DEBUGGING INFO ====\n");
-						//_EXCEPTION2("Inverse Map out of range (%1.5e %1.5e)",
-						//	dAlpha, dBeta);
-					}
+			dTargetArea += meshOverlap.vecFaceArea[ixOverlap + j];
+		}
 
-					// Sample the finite element at this point
-					SampleGLLFiniteElement(
-						nMonotoneType,
-						nP,
-						dAlpha,
-						dBeta,
-						dSampleCoeff);
-
-					// Add sample coefficients to the map
-					for (int p = 0; p < nP; p++) {
-					for (int q = 0; q < nP; q++) {
-
-						dRemapCoeff[p][q][j] +=
-							TriQuadratureW[l]
-							* dTriangleArea
-							* dSampleCoeff[p][q]
-							/ meshOverlap.vecFaceArea[ixOverlap + j];
-					}
-					}
-				}
-			}
+		for (int p = 0; p < nP; p++) {
+		for (int q = 0; q < nP; q++) {
+			vecSourceArea[p * nP + q] = dataGLLJacobian[p][q][ixFirst];
+		}
 		}
 
-		// Force consistency and conservation
-		if (!fNoConservation) {
-			double dTargetArea = 0.0;
+		// Source elements are completely covered by target volumes
+		if (fabs(meshInput.vecFaceArea[ixFirst] - dTargetArea) <= 1.0e-10) {
+			vecTargetArea.Allocate(nOverlapFaces);
 			for (int j = 0; j < nOverlapFaces; j++) {
-				dTargetArea += meshOverlap.vecFaceArea[ixOverlap + j];
+				vecTargetArea[j] = meshOverlap.vecFaceArea[ixOverlap + j];
 			}
 
+			dCoeff.Allocate(nOverlapFaces, nP * nP);
+
+			for (int j = 0; j < nOverlapFaces; j++) {
 			for (int p = 0; p < nP; p++) {
 			for (int q = 0; q < nP; q++) {
-				vecSourceArea[p * nP + q] = dataGLLJacobian[p][q][ixFirst];
+				dCoeff[j][p * nP + q] = dRemapCoeff[p][q][j];
+			}
 			}
 			}
 
-			// Source elements are completely covered by target volumes
-			if (fabs(meshInput.vecFaceArea[ixFirst] - dTargetArea) <= 1.0e-10) {
-				vecTargetArea.Allocate(nOverlapFaces);
-				for (int j = 0; j < nOverlapFaces; j++) {
-					vecTargetArea[j] = meshOverlap.vecFaceArea[ixOverlap + j];
-				}
-
-				dCoeff.Allocate(nOverlapFaces, nP * nP);
+		// Target volumes only partially cover source elements
+		} else if (meshInput.vecFaceArea[ixFirst] - dTargetArea > 1.0e-10) {
+			double dExtraneousArea = meshInput.vecFaceArea[ixFirst] - dTargetArea;
 
-				for (int j = 0; j < nOverlapFaces; j++) {
-				for (int p = 0; p < nP; p++) {
-				for (int q = 0; q < nP; q++) {
-					dCoeff[j][p * nP + q] = dRemapCoeff[p][q][j];
-				}
-				}
-				}
+			vecTargetArea.Allocate(nOverlapFaces+1);
+			for (int j = 0; j < nOverlapFaces; j++) {
+				vecTargetArea[j] = meshOverlap.vecFaceArea[ixOverlap + j];
+			}
+			vecTargetArea[nOverlapFaces] = dExtraneousArea;
 
-			// Target volumes only partially cover source elements
-			} else if (meshInput.vecFaceArea[ixFirst] - dTargetArea > 1.0e-10) {
-				double dExtraneousArea = meshInput.vecFaceArea[ixFirst] - dTargetArea;
+			Announce("Partial volume: %i (%1.10e / %1.10e)",
+				ixFirst, dTargetArea, meshInput.vecFaceArea[ixFirst]);
 
-				vecTargetArea.Allocate(nOverlapFaces+1);
-				for (int j = 0; j < nOverlapFaces; j++) {
-					vecTargetArea[j] = meshOverlap.vecFaceArea[ixOverlap + j];
-				}
-				vecTargetArea[nOverlapFaces] = dExtraneousArea;
+			if (dTargetArea > meshInput.vecFaceArea[ixFirst]) {
+				_EXCEPTIONT("Partial element area exceeds total element area");
+			}
 
-				Announce("Partial volume: %i (%1.10e / %1.10e)",
-					ixFirst, dTargetArea, meshInput.vecFaceArea[ixFirst]);
+			dCoeff.Allocate(nOverlapFaces+1, nP * nP);
 
-				if (dTargetArea > meshInput.vecFaceArea[ixFirst]) {
-					_EXCEPTIONT("Partial element area exceeds total element area");
-				}
-
-				dCoeff.Allocate(nOverlapFaces+1, nP * nP);
-
-				for (int j = 0; j < nOverlapFaces; j++) {
-				for (int p = 0; p < nP; p++) {
-				for (int q = 0; q < nP; q++) {
-					dCoeff[j][p * nP + q] = dRemapCoeff[p][q][j];
-				}
-				}
-				}
-				for (int p = 0; p < nP; p++) {
-				for (int q = 0; q < nP; q++) {
-					dCoeff[nOverlapFaces][p * nP + q] =
-						dataGLLJacobian[p][q][ixFirst];
-				}
-				}
-				for (int j = 0; j < nOverlapFaces; j++) {
-				for (int p = 0; p < nP; p++) {
-				for (int q = 0; q < nP; q++) {
-					dCoeff[nOverlapFaces][p * nP + q] -=
-						dRemapCoeff[p][q][j]
-						* meshOverlap.vecFaceArea[ixOverlap + j];
-				}
-				}
-				}
-				for (int p = 0; p < nP; p++) {
-				for (int q = 0; q < nP; q++) {
-					dCoeff[nOverlapFaces][p * nP + q] /= dExtraneousArea;
-				}
-				}
-
-			// Source elements only partially cover target volumes
-			} else {
-				printf("\n==== BEGIN DEBUGGING INFO ====\n");
-				printf("EXCEPTION (%s, Line %u) Target grid must be a subset of source grid\n",
-					__FILE__, __LINE__);
-				printf("Source face ix %i, Overlap face ix [%i,%i]\n",
-					ixFirst, ixOverlap, ixOverlap+nOverlapFaces-1);
-				printf("Target faces / overlap area:\n");
-				for (int j = 0; j < nOverlapFaces; j++) {
-					printf("  (%i) (%i) %1.15e\n",
-						ixOverlap + j,
-						meshOverlap.vecTargetFaceIx[ixOverlap + j],
-						meshOverlap.vecFaceArea[ixOverlap + j]);
-				}
-				printf("Source nodes / source area:\n");
-				for (int p = 0; p < nP; p++) {
-				for (int q = 0; q < nP; q++) {
-					printf("  (%i,%i) %1.15e\n", p, q, dataGLLJacobian[p][q][ixFirst]);
-				}
-				}
-				printf("==== END DEBUGGING INFO ====\n");
-
-				_EXCEPTION2("Target grid must be a subset of source grid:"
-					"\nInput mesh area (%1.15e) Target area (%1.15e)",
-					meshInput.vecFaceArea[ixFirst],
-					dTargetArea);
+			for (int j = 0; j < nOverlapFaces; j++) {
+			for (int p = 0; p < nP; p++) {
+			for (int q = 0; q < nP; q++) {
+				dCoeff[j][p * nP + q] = dRemapCoeff[p][q][j];
+			}
+			}
+			}
+			for (int p = 0; p < nP; p++) {
+			for (int q = 0; q < nP; q++) {
+				dCoeff[nOverlapFaces][p * nP + q] =
+					dataGLLJacobian[p][q][ixFirst];
+			}
 			}
-
-			ForceConsistencyConservation3(
-				vecSourceArea,
-				vecTargetArea,
-				dCoeff,
-				(nMonotoneType != 0));
-
 			for (int j = 0; j < nOverlapFaces; j++) {
 			for (int p = 0; p < nP; p++) {
 			for (int q = 0; q < nP; q++) {
-				dRemapCoeff[p][q][j] = dCoeff[j][p * nP + q];
+				dCoeff[nOverlapFaces][p * nP + q] -=
+					dRemapCoeff[p][q][j]
+					* meshOverlap.vecFaceArea[ixOverlap + j];
 			}
 			}
 			}
-		}
-
-		// Put these remap coefficients into the SparseMatrix map
-		for (int j = 0; j < nOverlapFaces; j++) {
-			int ixSecondFace = meshOverlap.vecTargetFaceIx[ixOverlap + j];
-
 			for (int p = 0; p < nP; p++) {
 			for (int q = 0; q < nP; q++) {
-
-				if (fContinuousIn) {
-					int ixFirstNode = dataGLLNodes[p][q][ixFirst] - 1;
-
-					smatMap(ixSecondFace, ixFirstNode) +=
-						dRemapCoeff[p][q][j]
-						* meshOverlap.vecFaceArea[ixOverlap + j]
-						/ meshOutput.vecFaceArea[ixSecondFace];
-
-				} else {
-					int ixFirstNode = ixFirst * nP * nP + p * nP + q;
-
-					smatMap(ixSecondFace, ixFirstNode) +=
-						dRemapCoeff[p][q][j]
-						* meshOverlap.vecFaceArea[ixOverlap + j]
-						/ meshOutput.vecFaceArea[ixSecondFace];
-				}
+				dCoeff[nOverlapFaces][p * nP + q] /= dExtraneousArea;
 			}
 			}
-		}
 
-		// Increment the current overlap index
-		ixOverlap += nOverlapFaces;
-	}
-}
-
-///////////////////////////////////////////////////////////////////////////////
-
-void LinearRemapGLLtoGLL_Pointwise(
-	const Mesh & meshInput,
-	const Mesh & meshOutput,
-	const Mesh & meshOverlap,
-	const DataArray3D<int> & dataGLLNodesIn,
-	const DataArray3D<double> & dataGLLJacobianIn,
-	const DataArray3D<int> & dataGLLNodesOut,
-	const DataArray3D<double> & dataGLLJacobianOut,
-	const DataArray1D<double> & dataNodalAreaOut,
-	int nPin,
-	int nPout,
-	int nMonotoneType,
-	bool fContinuousIn,
-	bool fContinuousOut,
-	OfflineMap & mapRemap
-) {
-
-	// Triangular quadrature rule
-	TriangularQuadratureRule triquadrule(4);
-
-	const DataArray2D<double> & dG = triquadrule.GetG();
-	const DataArray1D<double> & dW = triquadrule.GetW();
-
-	// Sample coefficients
-	DataArray2D<double> dSampleCoeffIn(nPin, nPin);
-	DataArray2D<double> dSampleCoeffOut(nPout, nPout);
-
-	// Build the integration array for each element on meshOverlap
-	DataArray3D<double> dGlobalIntArray(
-		nPout * nPout,
-		meshOverlap.faces.size(),
-		nPin * nPin);
-
-	DataArray2D<double> dConstantIntArray(
-		meshOverlap.faces.size(),
-		nPin * nPin);
-
-	// Number of overlap Faces per source Face
-	DataArray1D<int> nAllOverlapFaces(meshInput.faces.size());
-
-	int ixOverlap = 0;
-
-	for (int ixFirst = 0; ixFirst < meshInput.faces.size(); ixFirst++) {
-
-		int ixOverlapTemp = ixOverlap;
-		for (; ixOverlapTemp < meshOverlap.faces.size(); ixOverlapTemp++) {
-
-			const Face & faceOverlap = meshOverlap.faces[ixOverlapTemp];
-
-			if (meshOverlap.vecSourceFaceIx[ixOverlapTemp] != ixFirst) {
-				break;
+		// Source elements only partially cover target volumes
+		} else {
+			printf("\n==== BEGIN DEBUGGING INFO ====\n");
+			printf("EXCEPTION (%s, Line %u) Target grid must be a subset of source grid\n",
+				__FILE__, __LINE__);
+			printf("Source face ix %i, Overlap face ix [%i,%i]\n",
+				ixFirst, ixOverlap, ixOverlap+nOverlapFaces-1);
+			printf("Target faces / overlap area:\n");
+			for (int j = 0; j < nOverlapFaces; j++) {
+				printf("  (%i) (%i) %1.15e\n",
+					ixOverlap + j,
+					meshOverlap.vecTargetFaceIx[ixOverlap + j],
+					meshOverlap.vecFaceArea[ixOverlap + j]);
 			}
-
-			nAllOverlapFaces[ixFirst]++;
-		}
-
-		// Increment the current overlap index
-		ixOverlap += nAllOverlapFaces[ixFirst];
-	}
-
-	// Mesh utilities
-	MeshUtilitiesFuzzy meshutil;
-
-	// Construct overlap
-	ixOverlap = 0;
-
-	int ixTotal = 0;
-
-	std::set< std::pair<int, int> > setFound;
-
-	for (int ixFirst = 0; ixFirst < meshInput.faces.size(); ixFirst++) {
-
-		// Output every 100 elements
-		if (ixFirst % 1000 == 0) {
-                  Announce("Element %i/%i", ixFirst,meshInput.faces.size());
-		}
-
-		// Quantities from the First Mesh
-		const Face & faceFirst = meshInput.faces[ixFirst];
-
-		const NodeVector & nodesFirst = meshInput.nodes;
-
-		// Number of overlapping Faces and triangles
-		int nOverlapFaces = nAllOverlapFaces[ixFirst];
-
-		// Loop through all Overlap Faces
-		for (int i = 0; i < nOverlapFaces; i++) {
-
-			// Quantities from the overlap Mesh
-			const Face & faceOverlap = meshOverlap.faces[ixOverlap + i];
-
-			const NodeVector & nodesOverlap = meshOverlap.nodes;
-
-			int nOverlapTriangles = faceOverlap.edges.size() - 2;
-
-			// Quantities from the Second Mesh
-			int ixSecond = meshOverlap.vecTargetFaceIx[ixOverlap + i];
-
-			const NodeVector & nodesSecond = meshOutput.nodes;
-
-			const Face & faceSecond = meshOutput.faces[ixSecond];
-
-			// Loop over all sub-triangles of this Overlap Face
-			for (int j = 0; j < nOverlapTriangles; j++) {
-
-				// Cornerpoints of triangle
-				const Node & node0 = nodesOverlap[faceOverlap[0]];
-				const Node & node1 = nodesOverlap[faceOverlap[j+1]];
-				const Node & node2 = nodesOverlap[faceOverlap[j+2]];
-
-				// Calculate the area of the modified Face
-				Face faceTri(3);
-				faceTri.SetNode(0, faceOverlap[0]);
-				faceTri.SetNode(1, faceOverlap[j+1]);
-				faceTri.SetNode(2, faceOverlap[j+2]);
-
-				double dTriArea =
-					CalculateFaceArea(faceTri, nodesOverlap);
-
-				for (int k = 0; k < triquadrule.GetPoints(); k++) {
-
-					// Get the nodal location of this point
-					double dX[3];
-
-					dX[0] = dG(k,0) * node0.x + dG(k,1) * node1.x + dG(k,2) * node2.x;
-					dX[1] = dG(k,0) * node0.y + dG(k,1) * node1.y + dG(k,2) * node2.y;
-					dX[2] = dG(k,0) * node0.z + dG(k,1) * node1.z + dG(k,2) * node2.z;
-
-					double dMag =
-						sqrt(dX[0] * dX[0] + dX[1] * dX[1] + dX[2] * dX[2]);
-
-					dX[0] /= dMag;
-					dX[1] /= dMag;
-					dX[2] /= dMag;
-
-					Node nodeQuadrature(dX[0], dX[1], dX[2]);
-
-					// Find the components of this quadrature point in the basis
-					// of the first Face.
-					double dAlphaIn;
-					double dBetaIn;
-
-					ApplyInverseMap(
-						faceFirst,
-						nodesFirst,
-						nodeQuadrature,
-						dAlphaIn,
-						dBetaIn);
-
-					// Find the components of this quadrature point in the basis
-					// of the second Face.
-					double dAlphaOut;
-					double dBetaOut;
-
-					ApplyInverseMap(
-						faceSecond,
-						nodesSecond,
-						nodeQuadrature,
-						dAlphaOut,
-						dBetaOut);
-
-					// Check inverse map value
-					if ((dAlphaIn < -InverseMapTolerance)      ||
-						(dAlphaIn > 1.0 + InverseMapTolerance) ||
-						(dBetaIn  < -InverseMapTolerance)      ||
-						(dBetaIn  > 1.0 + InverseMapTolerance)
-					) {
-						printf("\n==== BEGIN DEBUGGING INFO ====\n");
-						printf("WARNING (%s, Line %u) Inverse map out of range\n",
-							__FILE__, __LINE__);
-						printf("Source face ix %i, Target face ix %i, Overlap face ix %i\n",
-							ixFirst, ixSecond, ixOverlap + i);
-						printf("Face nodes:\n");
-						for (int x = 0; x < faceFirst.edges.size(); x++) {
-							nodesFirst[faceFirst[x]].Print("");
-						}
-						printf("Quadrature node:\n");
-						nodeQuadrature.Print("");
-						printf("Alpha, Beta: %1.15e %1.15e\n", dAlphaIn, dBetaIn);
-						printf("==== END DEBUGGING INFO ====\n");
-						//_EXCEPTION2("Inverse Map out of range (%1.5e %1.5e)",
-						//	dAlphaIn, dBetaIn);
-					}
-
-					// Check inverse map value
-					if ((dAlphaOut < -InverseMapTolerance)      ||
-						(dAlphaOut > 1.0 + InverseMapTolerance) ||
-						(dBetaOut  < -InverseMapTolerance)      ||
-						(dBetaOut  > 1.0 + InverseMapTolerance)
-					) {
-						printf("\n==== BEGIN DEBUGGING INFO ====\n");
-						printf("WARNING (%s, Line %u) Inverse map out of range\n",
-							__FILE__, __LINE__);
-						printf("Source face ix %i, Target face ix %i, Overlap face ix %i\n",
-							ixFirst, ixSecond, ixOverlap + i);
-						printf("Face nodes:\n");
-						for (int x = 0; x < faceSecond.edges.size(); x++) {
-							nodesSecond[faceSecond[x]].Print("");
-						}
-						printf("Quadrature node:\n");
-						nodeQuadrature.Print("");
-						printf("Alpha, Beta: %1.15e %1.15e\n", dAlphaOut, dBetaOut);
-						printf("==== END DEBUGGING INFO ====\n");
-						//_EXCEPTION2("Inverse Map out of range (%1.5e %1.5e)",
-						//	dAlphaOut, dBetaOut);
-					}
-
-					// Sample the First finite element at this point
-					SampleGLLFiniteElement(
-						nMonotoneType,
-						nPin,
-						dAlphaIn,
-						dBetaIn,
-						dSampleCoeffIn);
-
-					// Sample the Second finite element at this point
-					SampleGLLFiniteElement(
-						nMonotoneType,
-						nPout,
-						dAlphaOut,
-						dBetaOut,
-						dSampleCoeffOut);
-
-					// Compute overlap integral
-					int ixs = 0;
-					for (int s = 0; s < nPin; s++) {
-					for (int t = 0; t < nPin; t++) {
-						dConstantIntArray[ixOverlap + i][ixs] +=
-							  dSampleCoeffIn[s][t]
-							* dW[k]
-							* dTriArea
-							/ meshOverlap.vecFaceArea[ixOverlap + i];
-					}
-					}
-				}
+			printf("Source nodes / source area:\n");
+			for (int p = 0; p < nP; p++) {
+			for (int q = 0; q < nP; q++) {
+				printf("  (%i,%i) %1.15e\n", p, q, dataGLLJacobian[p][q][ixFirst]);
 			}
-
-			{
-
-				// Sample pointwise
-				DataArray1D<double> dGL;
-				DataArray1D<double> dWL;
-
-				GaussLobattoQuadrature::GetPoints(nPout, 0.0, 1.0, dGL, dWL);
-
-				int ixp = 0;
-				for (int p = 0; p < nPout; p++) {
-				for (int q = 0; q < nPout; q++) {
-
-					Node node;
-					Node dDx1G;
-					Node dDx2G;
-
-					ApplyLocalMap(
-						faceSecond,
-						nodesSecond,
-						dGL[p],
-						dGL[q],
-						node,
-						dDx1G,
-						dDx2G);
-
-					Face::NodeLocation loc;
-					int ixLocation;
-
-					meshutil.ContainsNode(
-						faceFirst,
-						nodesFirst,
-						node,
-						loc,
-						ixLocation);
-
-					if (loc == Face::NodeLocation_Exterior) {
-						ixp++;
-						continue;
-					}
-
-					std::pair<int,int> pairFound(ixSecond, p * nPout + q);
-
-					if (setFound.find(pairFound) != setFound.end()) {
-						ixp++;
-						continue;
-					} else {
-						setFound.insert(pairFound);
-					}
-
-					ixTotal++;
-
-					// Find the components of this quadrature point in the
-					// basis of the input Face.
-					double dAlphaIn;
-					double dBetaIn;
-
-					ApplyInverseMap(
-						faceFirst,
-						nodesFirst,
-						node,
-						dAlphaIn,
-						dBetaIn);
-
-					// Check inverse map value
-					if ((dAlphaIn < -InverseMapTolerance)      ||
-						(dAlphaIn > 1.0 + InverseMapTolerance) ||
-						(dBetaIn  < -InverseMapTolerance)      ||
-						(dBetaIn  > 1.0 + InverseMapTolerance)
-					) {
-						printf("\n==== BEGIN DEBUGGING INFO ====\n");
-						printf("WARNING (%s, Line %u) Inverse map out of range\n",
-							__FILE__, __LINE__);
-						printf("Source face ix %i, Target face ix %i, Overlap face ix %i\n",
-							ixFirst, ixSecond, ixOverlap + i);
-						printf("Face nodes:\n");
-						for (int x = 0; x < faceFirst.edges.size(); x++) {
-							nodesFirst[faceFirst[x]].Print("");
-						}
-						printf("Quadrature node:\n");
-						node.Print("");
-						printf("Alpha, Beta: %1.15e %1.15e\n", dAlphaIn, dBetaIn);
-						printf("==== END DEBUGGING INFO ====\n");
-						//_EXCEPTION2("Inverse Map out of range (%1.5e %1.5e)",
-						//	dAlphaIn, dBetaIn);
-					}
-
-					// Sample the First finite element at this point
-					SampleGLLFiniteElement(
-						nMonotoneType,
-						nPin,
-						dAlphaIn,
-						dBetaIn,
-						dSampleCoeffIn);
-
-					int ixs = 0;
-					for (int s = 0; s < nPin; s++) {
-					for (int t = 0; t < nPin; t++) {
-
-						if (dGlobalIntArray[ixp][ixOverlap + i][ixs] != 0.0) {
-							_EXCEPTION();
-						}
-
-						dGlobalIntArray[ixp][ixOverlap + i][ixs] +=
-							dSampleCoeffIn[s][t];
-
-						ixs++;
-					}
-					}
-
-					ixp++;
-				}
-				}
-
 			}
+			printf("==== END DEBUGGING INFO ====\n");
 
+			_EXCEPTION2("Target grid must be a subset of source grid:"
+				"\nInput mesh area (%1.15e) Target area (%1.15e)",
+				meshInput.vecFaceArea[ixFirst],
+				dTargetArea);
 		}
 
-		// Force consistency and conservation of ConstantIntArray
-		DataArray1D<double> dSourceArea(nPin * nPin);
+		ForceConsistencyConservation3(
+			vecSourceArea,
+			vecTargetArea,
+			dCoeff,
+			(nMonotoneType != 0));
 
-		for (int s = 0; s < nPin; s++) {
-		for (int t = 0; t < nPin; t++) {
-			dSourceArea[s * nPin + t] = dataGLLJacobianIn[s][t][ixFirst];
+		for (int j = 0; j < nOverlapFaces; j++) {
+		for (int p = 0; p < nP; p++) {
+		for (int q = 0; q < nP; q++) {
+			dRemapCoeff[p][q][j] = dCoeff[j][p * nP + q];
 		}
 		}
-
-		DataArray1D<double> dTargetArea(nOverlapFaces);
-		for (int i = 0; i < nOverlapFaces; i++) {
-			dTargetArea[i] = meshOverlap.vecFaceArea[ixOverlap + i];
 		}
+	}
 
-		DataArray2D<double> dCoeff(nOverlapFaces, nPin * nPin);
+	// Put these remap coefficients into the list of map entries
+	for (int j = 0; j < nOverlapFaces; j++) {
+		int ixSecondFace = meshOverlap.vecTargetFaceIx[ixOverlap + j];
 
-		for (int i = 0; i < nOverlapFaces; i++) {
-		for (int s = 0; s < nPin; s++) {
-		for (int t = 0; t < nPin; t++) {
-			dCoeff[i][s * nPin + t] =
-				dConstantIntArray[ixOverlap + i][s * nPin + t];
-		}
-		}
-		}
-
-		ForceConsistencyConservation3(
-			dSourceArea,
-			dTargetArea,
-			dCoeff,
-			(nMonotoneType != 0));
+		for (int p = 0; p < nP; p++) {
+		for (int q = 0; q < nP; q++) {
 
-		for (int i = 0; i < nOverlapFaces; i++) {
-			int ixSecondFace = meshOverlap.vecTargetFaceIx[ixOverlap + i];
+			if (fContinuousIn) {
+				int ixFirstNode = dataGLLNodes[p][q][ixFirst] - 1;
 
-			for (int s = 0; s < nPin; s++) {
-			for (int t = 0; t < nPin; t++) {
-				dConstantIntArray[ixOverlap + i][s * nPin + t] =
-					dCoeff[i][s * nPin + t]
-					* meshOverlap.vecFaceArea[ixOverlap + i]
-					/ meshOutput.vecFaceArea[ixSecondFace];
+				vecEntries.push_back(SparseMatrixEntry<double>(
+					ixSecondFace,
+					ixFirstNode,
+					dRemapCoeff[p][q][j]
+					* meshOverlap.vecFaceArea[ixOverlap + j]
+					/ meshOutput.vecFaceArea[ixSecondFace]));
 
-			}
+			} else {
+				int ixFirstNode = ixFirst * nP * nP + p * nP + q;
+
+				vecEntries.push_back(SparseMatrixEntry<double>(
+					ixSecondFace,
+					ixFirstNode,
+					dRemapCoeff[p][q][j]
+					* meshOverlap.vecFaceArea[ixOverlap + j]
+					/ meshOutput.vecFaceArea[ixSecondFace]));
 			}
 		}
+		}
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Pointer to an instantiation of LinearRemapSE4Face.
+///	</summary>
+typedef void (*LinearRemapSE4FaceFunction)(
+	const Mesh &,
+	const Mesh &,
+	const Mesh &,
+	const DataArray3D<int> &,
+	const DataArray3D<double> &,
+	const TriangularQuadratureRule &,
+	int,
+	bool,
+	bool,
+	int,
+	int,
+	int,
+	LinearRemapSE4Workspace &,
+	std::vector< SparseMatrixEntry<double> > &);
 
-		// Increment the current overlap index
-		ixOverlap += nOverlapFaces;
+///////////////////////////////////////////////////////////////////////////////
+
+void LinearRemapSE4(
+	const Mesh & meshInput,
+	const Mesh & meshOutput,
+	const Mesh & meshOverlap,
+	const DataArray3D<int> & dataGLLNodes,
+	const DataArray3D<double> & dataGLLJacobian,
+	int nMonotoneType,
+	bool fContinuousIn,
+	bool fNoConservation,
+	OfflineMap & mapRemap,
+	int nThreads
+) {
+	if (nThreads < 1) {
+		_EXCEPTIONT("Thread count must be at least 1");
 	}
 
-	// Reverse map
-	std::vector< std::vector<int> > vecReverseFaceIx;
-	vecReverseFaceIx.resize(meshOutput.faces.size());
-	for (int i = 0; i < meshOverlap.faces.size(); i++) {
-		int ixSecond = meshOverlap.vecTargetFaceIx[i];
+	// Order of the polynomial interpolant
+	int nP = dataGLLNodes.GetRows();
 
-		vecReverseFaceIx[ixSecond].push_back(i);
+	// Use the kernel specialized to this order, if available
+	LinearRemapSE4FaceFunction fnRemapFace;
+	switch (nP) {
+		case 2: fnRemapFace = LinearRemapSE4Face<2>; break;
+		case 3: fnRemapFace = LinearRemapSE4Face<3>; break;
+		case 4: fnRemapFace = LinearRemapSE4Face<4>; break;
+		default: fnRemapFace = LinearRemapSE4Face<0>; break;
 	}
 
-	// Force consistency and conservation on linear sub-map
-	int ixDistBegin = 0;
-
-	for (int ixSecond = 0; ixSecond < meshOutput.faces.size(); ixSecond++) {
-
-		// Coefficients
-		DataArray2D<double> dCoeff(
-			nPout * nPout,
-			vecReverseFaceIx[ixSecond].size() * nPin * nPin);
-
-		for (int i = 0; i < vecReverseFaceIx[ixSecond].size(); i++) {
-
-			int ixOverlap = vecReverseFaceIx[ixSecond][i];
-
-			int ixs = 0;
-			for (int s = 0; s < nPin; s++) {
-			for (int t = 0; t < nPin; t++) {
-
-				int ixp = 0;
-				for (int p = 0; p < nPout; p++) {
-				for (int q = 0; q < nPout; q++) {
-					dCoeff[ixp][i * nPin * nPin + ixs] =
-						dGlobalIntArray[ixp][ixOverlap][ixs];
+	// Triangular quadrature rule
+	const TriangularQuadratureRule & triquadrule =
+		TriangularQuadratureRule::Get(4);
 
-					ixp++;
-				}
-				}
+	// Get SparseMatrix represntation of the OfflineMap
+	SparseMatrix<double> & smatMap = mapRemap.GetSparseMatrix();
 
-				ixs++;
-			}
-			}
-		}
+	const int nInputFaces = static_cast<int>(meshInput.faces.size());
 
-		// Source areas
-		DataArray1D<double> dSourceArea(
-			vecReverseFaceIx[ixSecond].size() * nPin * nPin);
+	if (meshOverlap.overlapfaceindex.GetSourceFaceCount() !=
+		meshInput.faces.size()
+	) {
+		_EXCEPTIONT("OverlapFaceIndex has not been constructed for meshOverlap");
+	}
 
-		for (int i = 0; i < vecReverseFaceIx[ixSecond].size(); i++) {
+	// Index of the first overlap Face associated with each source Face
+	const std::vector<int> & vecOverlapBegin =
+		meshOverlap.overlapfaceindex.GetSourceOffsets();
 
-			int ixOverlap = vecReverseFaceIx[ixSecond][i];
+	// Loop over all input Faces in chunks of contiguous faces, buffering
+	// the map entries of each chunk and accumulating them into the map
+	// in source face order
+	const int nChunks =
+		(nInputFaces + LinearRemapSE4ChunkSize - 1) / LinearRemapSE4ChunkSize;
 
-			int ixs = 0;
-			for (int s = 0; s < nPin; s++) {
-			for (int t = 0; t < nPin; t++) {
-				dSourceArea[i * nPin * nPin + ixs] =
-					dConstantIntArray[ixOverlap][ixs];
+	// Chunks are processed in rounds to report progress.  The entries of
+	// completed rounds are assembled into the map once they outnumber its
+	// nonzeros, which bounds the number of buffered entries held in memory
+	// at once by the size of the map.
+	const int nChunksPerRound = 4 * nThreads;
 
-				ixs++;
-			}
-			}
-		}
+	int cAssembled = 0;
 
-		// Target areas
-		double dTotalTargetArea = 0.0;
+	std::vector< std::vector< SparseMatrixEntry<double> > >
+		vecChunkEntries(nChunks);
 
-		DataArray1D<double> dTargetArea(nPout * nPout);
+	for (int c0 = 0; c0 < nChunks; c0 += nChunksPerRound) {
+		const int c1 = std::min(c0 + nChunksPerRound, nChunks);
 
-		{
-			int ixp = 0;
-			for (int p = 0; p < nPout; p++) {
-			for (int q = 0; q < nPout; q++) {
+		Announce("Element %i/%i", c0 * LinearRemapSE4ChunkSize, nInputFaces);
 
-				dTargetArea[ixp] =
-					dataGLLJacobianOut[p][q][ixSecond]
-					/ meshOutput.vecFaceArea[ixSecond];
+		OmpExceptionCapture capture;
 
-				ixp++;
-			}
-			}
-		}
+#pragma omp parallel for schedule(dynamic) num_threads(nThreads)
+		for (int c = c0; c < c1; c++) {
+			const int ixFirstBegin = c * LinearRemapSE4ChunkSize;
+			const int ixFirstEnd =
+				std::min(ixFirstBegin + LinearRemapSE4ChunkSize, nInputFaces);
 
-		// Force consistency and conservation
-		ForceConsistencyConservation3(
-			dSourceArea,
-			dTargetArea,
-			dCoeff,
-			(nMonotoneType != 0));
+			capture.Run([&]() {
+				LinearRemapSE4Workspace workspace(nP);
 
-/*
-		// Check column sums (conservation)
-		for (int i = 0; i < dCoeff.GetColumns(); i++) {
-			double dColSum = 0.0;
-			for (int j = 0; j < dCoeff.GetRows(); j++) {
-				dColSum += dCoeff[j][i] * dTargetArea[j];
-			}
-			printf("Col %i: %1.15e\n", i, dColSum / dSourceArea[i]);
+				for (int ixFirst = ixFirstBegin; ixFirst < ixFirstEnd; ixFirst++) {
+					(*fnRemapFace)(
+						meshInput,
+						meshOutput,
+						meshOverlap,
+						dataGLLNodes,
+						dataGLLJacobian,
+						triquadrule,
+						nMonotoneType,
+						fContinuousIn,
+						fNoConservation,
+						ixFirst,
+						vecOverlapBegin[ixFirst],
+						vecOverlapBegin[ixFirst+1] - vecOverlapBegin[ixFirst],
+						workspace,
+						vecChunkEntries[c]);
+				}
+			});
 		}
 
-		// Check row sums (consistency)
-		for (int j = 0; j < dCoeff.GetRows(); j++) {
-			double dRowSum = 0.0;
-			for (int i = 0; i < dCoeff.GetColumns(); i++) {
-				dRowSum += dCoeff[j][i];
-			}
-			printf("Row %i: %1.15e\n", j, dRowSum);
-		}
-		_EXCEPTION();
-*/
-/*
-		// Coefficients
-		for (int i = 0; i < vecReverseFaceIx[ixSecond].size(); i++) {
+		capture.Rethrow();
 
-			ixOverlap = vecReverseFaceIx[ixSecond][i];
+		cAssembled = static_cast<int>(
+			smatMap.AssembleEntriesIfBuffered(
+				vecChunkEntries, cAssembled, c1, nThreads));
+	}
 
-			if ((ixOverlap < 0) || (ixOverlap > dGlobalIntArray.GetColumns())) {
-				_EXCEPTION();
-			}
+	// Assemble the map entries of the remaining chunks in source face order
+	smatMap.AssembleEntries(vecChunkEntries, cAssembled, nChunks, nThreads);
+}
 
-			int ixs = 0;
-			for (int s = 0; s < nPin; s++) {
-			for (int t = 0; t < nPin; t++) {
+///////////////////////////////////////////////////////////////////////////////
 
-				int ixp = 0;
-				for (int p = 0; p < nPout; p++) {
-				for (int q = 0; q < nPout; q++) {
-					dGlobalIntArray[ixp][ixOverlap][ixs] =
-						dCoeff[ixp][i * nPin * nPin + ixs];
+///	<summary>
+///		Implementation of LinearRemapGLLtoGLL_Pointwise.  NPIN is the order
+///		of the input finite element if fixed at compile time, or 0
+///		otherwise.
+///	</summary>
+template <int NPIN>
+static void LinearRemapGLLtoGLL_PointwiseOrder(
+	const Mesh & meshInput,
+	const Mesh & meshOutput,
+	const Mesh & meshOverlap,
+	const DataArray3D<int> & dataGLLNodesIn,
+	const DataArray3D<double> & dataGLLJacobianIn,
+	const DataArray3D<int> & dataGLLNodesOut,
+	const DataArray3D<double> & dataGLLJacobianOut,
+	const DataArray1D<double> & dataNodalAreaOut,
+	int nPinRuntime,
+	int nPout,
+	int nMonotoneType,
+	bool fContinuousIn,
+	bool fContinuousOut,
+	OfflineMap & mapRemap
+) {
+	// Order of the input finite element
+	const int nPin = (NPIN > 0)?(NPIN):(nPinRuntime);
 
-					ixp++;
-				}
-				}
+	// Sample coefficients
+	GLLSampleCoeff<NPIN> dSampleCoeffIn(nPin);
 
-				ixs++;
-			}
-			}
-		}
-*/
-	}
+	// Sample points on the output element
+	const DataArray1D<double> & dGL =
+		GaussLobattoQuadrature::GetCachedPoints(nPout, 0.0, 1.0).dG;
 
 	// Get SparseMatrix represntation of the OfflineMap
 	SparseMatrix<double> & smatMap = mapRemap.GetSparseMatrix();
 
-	// Compose the integration operator with the output map
-	ixOverlap = 0;
+	// Mesh utilities
+	MeshUtilitiesFuzzy meshutil;
+
+	// Output nodes that have already been sampled, so that nodes on the
+	// boundary between input elements are only counted once
+	std::vector<bool> vecFound(meshOutput.faces.size() * nPout * nPout, false);
+
+	// Output nodes of one overlap Face that are sampled, their index on the
+	// output element and their inverse mapped coordinates
+	std::vector<Node> vecPointNodes;
+	std::vector<int> vecPointIndex;
+	std::vector<double> vecAlphaIn;
+	std::vector<double> vecBetaIn;
+
+	// Each output node contributes one row of sample coefficients, which is
+	// inserted as soon as it is computed, so storage is bounded by the
+	// number of nonzeros in the map.
+	if (meshOverlap.overlapfaceindex.GetSourceFaceCount() !=
+		meshInput.faces.size()
+	) {
+		_EXCEPTIONT("OverlapFaceIndex has not been constructed for meshOverlap");
+	}
 
 	for (int ixFirst = 0; ixFirst < meshInput.faces.size(); ixFirst++) {
 
@@ -1619,66 +753,185 @@ void LinearRemapGLLtoGLL_Pointwise(
                   Announce("Element %i/%i", ixFirst,meshInput.faces.size());
 		}
 
-		// This Face
+		// Quantities from the First Mesh
 		const Face & faceFirst = meshInput.faces[ixFirst];
 
-		// Number of overlapping Faces and triangles
-		int nOverlapFaces = nAllOverlapFaces[ixFirst];
+		const NodeVector & nodesFirst = meshInput.nodes;
 
-		// Put composed array into map
-		for (int i = 0; i < nOverlapFaces; i++) {
-			int ixSecond = meshOverlap.vecTargetFaceIx[ixOverlap + i];
+		// Loop through all Overlap Faces
+		const int ixOverlapBegin =
+			meshOverlap.overlapfaceindex.SourceBegin(ixFirst);
+		const int ixOverlapEnd =
+			meshOverlap.overlapfaceindex.SourceEnd(ixFirst);
 
-			int ixs = 0;
-			for (int s = 0; s < nPin; s++) {
-			for (int t = 0; t < nPin; t++) {
+		for (int ixOverlap = ixOverlapBegin; ixOverlap < ixOverlapEnd; ixOverlap++) {
 
-				int ixFirstNode;
-				if (fContinuousIn) {
-					ixFirstNode = dataGLLNodesIn[s][t][ixFirst] - 1;
+			// Quantities from the Second Mesh
+			int ixSecond = meshOverlap.vecTargetFaceIx[ixOverlap];
+
+			const NodeVector & nodesSecond = meshOutput.nodes;
+
+			const Face & faceSecond = meshOutput.faces[ixSecond];
+
+			// Output nodes within the First Face that have not been
+			// sampled, which are inverse mapped together
+			vecPointNodes.clear();
+			vecPointIndex.clear();
+
+			for (int p = 0; p < nPout; p++) {
+			for (int q = 0; q < nPout; q++) {
+
+				Node node;
+				Node dDx1G;
+				Node dDx2G;
+
+				ApplyLocalMap(
+					faceSecond,
+					nodesSecond,
+					dGL[p],
+					dGL[q],
+					node,
+					dDx1G,
+					dDx2G);
+
+				Face::NodeLocation loc;
+				int ixLocation;
+
+				meshutil.ContainsNode(
+					faceFirst,
+					nodesFirst,
+					node,
+					loc,
+					ixLocation);
+
+				if (loc == Face::NodeLocation_Exterior) {
+					continue;
+				}
+
+				const int ixFound = (ixSecond * nPout + p) * nPout + q;
+
+				if (vecFound[ixFound]) {
+					continue;
+				}
+				vecFound[ixFound] = true;
+
+				vecPointNodes.push_back(node);
+				vecPointIndex.push_back(p * nPout + q);
+			}
+			}
+
+			const int nPoints = static_cast<int>(vecPointNodes.size());
+			if (nPoints == 0) {
+				continue;
+			}
+
+			// Find the components of these points in the basis of the
+			// input Face.
+			vecAlphaIn.resize(nPoints);
+			vecBetaIn.resize(nPoints);
+
+			ApplyInverseMap(
+				faceFirst,
+				nodesFirst,
+				nPoints,
+				&(vecPointNodes[0]),
+				&(vecAlphaIn[0]),
+				&(vecBetaIn[0]));
+
+			// Sample pointwise
+			for (int k = 0; k < nPoints; k++) {
+				const int p = vecPointIndex[k] / nPout;
+				const int q = vecPointIndex[k] % nPout;
+
+				const Node & node = vecPointNodes[k];
+
+				const double dAlphaIn = vecAlphaIn[k];
+				const double dBetaIn = vecBetaIn[k];
+
+				// Check inverse map value
+				if ((dAlphaIn < -InverseMapTolerance)      ||
+					(dAlphaIn > 1.0 + InverseMapTolerance) ||
+					(dBetaIn  < -InverseMapTolerance)      ||
+					(dBetaIn  > 1.0 + InverseMapTolerance)
+				) {
+					printf("\n==== BEGIN DEBUGGING INFO ====\n");
+					printf("WARNING (%s, Line %u) Inverse map out of range\n",
+						__FILE__, __LINE__);
+					printf("Source face ix %i, Target face ix %i, Overlap face ix %i\n",
+						ixFirst, ixSecond, ixOverlap);
+					printf("Face nodes:\n");
+					for (int x = 0; x < faceFirst.edges.size(); x++) {
+						nodesFirst[faceFirst[x]].Print("");
+					}
+					printf("Quadrature node:\n");
+					node.Print("");
+					printf("Alpha, Beta: %1.15e %1.15e\n", dAlphaIn, dBetaIn);
+					printf("==== END DEBUGGING INFO ====\n");
+					//_EXCEPTION2("Inverse Map out of range (%1.5e %1.5e)",
+					//	dAlphaIn, dBetaIn);
+				}
+
+				// Sample the First finite element at this point
+				dSampleCoeffIn.Sample(nMonotoneType, dAlphaIn, dBetaIn);
+
+				// Put sample coefficients into map
+				int ixSecondNode;
+				if (fContinuousOut) {
+					ixSecondNode = dataGLLNodesOut[p][q][ixSecond] - 1;
 				} else {
-					ixFirstNode = ixFirst * nPin * nPin + s * nPin + t;
+					ixSecondNode = ixSecond * nPout * nPout + p * nPout + q;
 				}
 
-				int ixp = 0;
-				for (int p = 0; p < nPout; p++) {
-				for (int q = 0; q < nPout; q++) {
+				for (int s = 0; s < nPin; s++) {
+				for (int t = 0; t < nPin; t++) {
 
-					int ixSecondNode;
-					if (fContinuousOut) {
-						ixSecondNode = dataGLLNodesOut[p][q][ixSecond] - 1;
+					int ixFirstNode;
+					if (fContinuousIn) {
+						ixFirstNode = dataGLLNodesIn[s][t][ixFirst] - 1;
+					} else {
+						ixFirstNode = ixFirst * nPin * nPin + s * nPin + t;
+					}
 
+					if (fContinuousOut) {
 						smatMap(ixSecondNode, ixFirstNode) +=
-							dGlobalIntArray[ixp][ixOverlap + i][ixs]
+							dSampleCoeffIn[s][t]
 							* dataGLLJacobianOut[p][q][ixSecond]
 							/ dataNodalAreaOut[ixSecondNode];
-							// dataIntAreaOut[ixSecondNode];
-
 					} else {
-						ixSecondNode = ixSecond * nPout * nPout + p * nPout + q;
-					
 						smatMap(ixSecondNode, ixFirstNode) +=
-							dGlobalIntArray[ixp][ixOverlap + i][ixs];
-							// dataIntAreaOut[ixSecondNode];
+							dSampleCoeffIn[s][t];
 					}
-
-					ixp++;
 				}
 				}
-
-				ixs++;
-			}
 			}
 		}
-
-		// Increment the current overlap index
-		ixOverlap += nOverlapFaces;
 	}
 }
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Pointer to an instantiation of LinearRemapGLLtoGLL_PointwiseOrder
+///		or LinearRemapGLLtoGLL_IntegratedOrder.
+///	</summary>
+typedef void (*LinearRemapGLLtoGLLFunction)(
+	const Mesh &,
+	const Mesh &,
+	const Mesh &,
+	const DataArray3D<int> &,
+	const DataArray3D<double> &,
+	const DataArray3D<int> &,
+	const DataArray3D<double> &,
+	const DataArray1D<double> &,
+	int,
+	int,
+	int,
+	bool,
+	bool,
+	OfflineMap &);
 
 ///////////////////////////////////////////////////////////////////////////////
 
-void LinearRemapGLLtoGLL_Integrated(
+void LinearRemapGLLtoGLL_Pointwise(
 	const Mesh & meshInput,
 	const Mesh & meshOutput,
 	const Mesh & meshOverlap,
@@ -1694,16 +947,70 @@ void LinearRemapGLLtoGLL_Integrated(
 	bool fContinuousOut,
 	OfflineMap & mapRemap
 ) {
+	// Use the kernel specialized to the input order, if available
+	LinearRemapGLLtoGLLFunction fnRemap;
+	switch (nPin) {
+		case 2: fnRemap = LinearRemapGLLtoGLL_PointwiseOrder<2>; break;
+		case 3: fnRemap = LinearRemapGLLtoGLL_PointwiseOrder<3>; break;
+		case 4: fnRemap = LinearRemapGLLtoGLL_PointwiseOrder<4>; break;
+		default: fnRemap = LinearRemapGLLtoGLL_PointwiseOrder<0>; break;
+	}
+
+	(*fnRemap)(
+		meshInput,
+		meshOutput,
+		meshOverlap,
+		dataGLLNodesIn,
+		dataGLLJacobianIn,
+		dataGLLNodesOut,
+		dataGLLJacobianOut,
+		dataNodalAreaOut,
+		nPin,
+		nPout,
+		nMonotoneType,
+		fContinuousIn,
+		fContinuousOut,
+		mapRemap);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Implementation of LinearRemapGLLtoGLL_Integrated.  NPIN and NPOUT
+///		are the orders of the input and output finite elements if fixed
+///		at compile time, or 0 otherwise.
+///	</summary>
+template <int NPIN, int NPOUT>
+static void LinearRemapGLLtoGLL_IntegratedOrder(
+	const Mesh & meshInput,
+	const Mesh & meshOutput,
+	const Mesh & meshOverlap,
+	const DataArray3D<int> & dataGLLNodesIn,
+	const DataArray3D<double> & dataGLLJacobianIn,
+	const DataArray3D<int> & dataGLLNodesOut,
+	const DataArray3D<double> & dataGLLJacobianOut,
+	const DataArray1D<double> & dataNodalAreaOut,
+	int nPinRuntime,
+	int nPoutRuntime,
+	int nMonotoneType,
+	bool fContinuousIn,
+	bool fContinuousOut,
+	OfflineMap & mapRemap
+) {
+	// Orders of the input and output finite elements
+	const int nPin = (NPIN > 0)?(NPIN):(nPinRuntime);
+	const int nPout = (NPOUT > 0)?(NPOUT):(nPoutRuntime);
 
 	// Triangular quadrature rule
-	TriangularQuadratureRule triquadrule(4);
+	const TriangularQuadratureRule & triquadrule =
+		TriangularQuadratureRule::Get(4);
 
 	const DataArray2D<double> & dG = triquadrule.GetG();
 	const DataArray1D<double> & dW = triquadrule.GetW();
 
 	// Sample coefficients
-	DataArray2D<double> dSampleCoeffIn(nPin, nPin);
-	DataArray2D<double> dSampleCoeffOut(nPout, nPout);
+	GLLSampleCoeff<NPIN> dSampleCoeffIn(nPin);
+	GLLSampleCoeff<NPOUT> dSampleCoeffOut(nPout);
 
 	// Build the integration array for each element on meshOverlap
 	DataArray3D<double> dGlobalIntArray(
@@ -1715,34 +1022,16 @@ void LinearRemapGLLtoGLL_Integrated(
 		meshOverlap.faces.size(),
 		nPin * nPin);
 
-	// Number of overlap Faces per source Face
-	DataArray1D<int> nAllOverlapFaces(meshInput.faces.size());
-
-	int ixOverlap = 0;
-
-	for (int ixFirst = 0; ixFirst < meshInput.faces.size(); ixFirst++) {
-
-		int ixOverlapTemp = ixOverlap;
-		for (; ixOverlapTemp < meshOverlap.faces.size(); ixOverlapTemp++) {
-
-			const Face & faceOverlap = meshOverlap.faces[ixOverlapTemp];
-
-			if (meshOverlap.vecSourceFaceIx[ixOverlapTemp] != ixFirst) {
-				break;
-			}
-
-			nAllOverlapFaces[ixFirst]++;
-		}
-
-		// Increment the current overlap index
-		ixOverlap += nAllOverlapFaces[ixFirst];
+	if (meshOverlap.overlapfaceindex.GetSourceFaceCount() !=
+		meshInput.faces.size()
+	) {
+		_EXCEPTIONT("OverlapFaceIndex has not been constructed for meshOverlap");
 	}
 
 	// Mesh utilities
 	MeshUtilitiesFuzzy meshutil;
 
 	// Construct overlap
-	ixOverlap = 0;
 
 	int ixTotal = 0;
 
@@ -1760,8 +1049,11 @@ void LinearRemapGLLtoGLL_Integrated(
 
 		const NodeVector & nodesFirst = meshInput.nodes;
 
-		// Number of overlapping Faces and triangles
-		int nOverlapFaces = nAllOverlapFaces[ixFirst];
+		// Overlapping Faces
+		const int ixOverlap =
+			meshOverlap.overlapfaceindex.SourceBegin(ixFirst);
+		const int nOverlapFaces =
+			meshOverlap.overlapfaceindex.SourceCount(ixFirst);
 
 		// Loop through all Overlap Faces
 		for (int i = 0; i < nOverlapFaces; i++) {
@@ -1886,20 +1178,10 @@ void LinearRemapGLLtoGLL_Integrated(
 					}
 
 					// Sample the First finite element at this point
-					SampleGLLFiniteElement(
-						nMonotoneType,
-						nPin,
-						dAlphaIn,
-						dBetaIn,
-						dSampleCoeffIn);
+					dSampleCoeffIn.Sample(nMonotoneType, dAlphaIn, dBetaIn);
 
 					// Sample the Second finite element at this point
-					SampleGLLFiniteElement(
-						nMonotoneType,
-						nPout,
-						dAlphaOut,
-						dBetaOut,
-						dSampleCoeffOut);
+					dSampleCoeffOut.Sample(nMonotoneType, dAlphaOut, dBetaOut);
 
 					// Compute overlap integral
 					int ixs = 0;
@@ -1978,18 +1260,12 @@ void LinearRemapGLLtoGLL_Integrated(
 			}
 			}
 		}
-
-		// Increment the current overlap index
-		ixOverlap += nOverlapFaces;
 	}
 
-	// Reverse map
-	std::vector< std::vector<int> > vecReverseFaceIx;
-	vecReverseFaceIx.resize(meshOutput.faces.size());
-	for (int i = 0; i < meshOverlap.faces.size(); i++) {
-		int ixSecond = meshOverlap.vecTargetFaceIx[i];
-
-		vecReverseFaceIx[ixSecond].push_back(i);
+	if (meshOverlap.overlapfaceindex.GetTargetFaceCount() !=
+		meshOutput.faces.size()
+	) {
+		_EXCEPTIONT("OverlapFaceIndex has not been constructed for meshOverlap");
 	}
 
 	// Force consistency and conservation on linear sub-map
@@ -1997,14 +1273,18 @@ void LinearRemapGLLtoGLL_Integrated(
 
 	for (int ixSecond = 0; ixSecond < meshOutput.faces.size(); ixSecond++) {
 
+		// Overlap Faces associated with this target Face
+		ReverseNodeArray::FaceRange vecReverseFaceIx =
+			meshOverlap.overlapfaceindex.TargetFaces(ixSecond);
+
 		// Coefficients
 		DataArray2D<double> dCoeff(
 			nPout * nPout,
-			vecReverseFaceIx[ixSecond].size() * nPin * nPin);
+			vecReverseFaceIx.size() * nPin * nPin);
 
-		for (int i = 0; i < vecReverseFaceIx[ixSecond].size(); i++) {
+		for (int i = 0; i < vecReverseFaceIx.size(); i++) {
 
-			int ixOverlap = vecReverseFaceIx[ixSecond][i];
+			int ixOverlap = vecReverseFaceIx[i];
 
 			int ixs = 0;
 			for (int s = 0; s < nPin; s++) {
@@ -2027,11 +1307,11 @@ void LinearRemapGLLtoGLL_Integrated(
 
 		// Source areas
 		DataArray1D<double> dSourceArea(
-			vecReverseFaceIx[ixSecond].size() * nPin * nPin);
+			vecReverseFaceIx.size() * nPin * nPin);
 
-		for (int i = 0; i < vecReverseFaceIx[ixSecond].size(); i++) {
+		for (int i = 0; i < vecReverseFaceIx.size(); i++) {
 
-			int ixOverlap = vecReverseFaceIx[ixSecond][i];
+			int ixOverlap = vecReverseFaceIx[i];
 
 			int ixs = 0;
 			for (int s = 0; s < nPin; s++) {
@@ -2091,9 +1371,9 @@ void LinearRemapGLLtoGLL_Integrated(
 */
 
 		// Coefficients
-		for (int i = 0; i < vecReverseFaceIx[ixSecond].size(); i++) {
+		for (int i = 0; i < vecReverseFaceIx.size(); i++) {
 
-			ixOverlap = vecReverseFaceIx[ixSecond][i];
+			int ixOverlap = vecReverseFaceIx[i];
 
 			if ((ixOverlap < 0) || (ixOverlap > dGlobalIntArray.GetColumns())) {
 				_EXCEPTION();
@@ -2124,7 +1404,6 @@ void LinearRemapGLLtoGLL_Integrated(
 	SparseMatrix<double> & smatMap = mapRemap.GetSparseMatrix();
 
 	// Compose the integration operator with the output map
-	ixOverlap = 0;
 
 	for (int ixFirst = 0; ixFirst < meshInput.faces.size(); ixFirst++) {
 
@@ -2136,8 +1415,11 @@ void LinearRemapGLLtoGLL_Integrated(
 		// This Face
 		const Face & faceFirst = meshInput.faces[ixFirst];
 
-		// Number of overlapping Faces and triangles
-		int nOverlapFaces = nAllOverlapFaces[ixFirst];
+		// Overlapping Faces
+		const int ixOverlap =
+			meshOverlap.overlapfaceindex.SourceBegin(ixFirst);
+		const int nOverlapFaces =
+			meshOverlap.overlapfaceindex.SourceCount(ixFirst);
 
 		// Put composed array into map
 		for (int i = 0; i < nOverlapFaces; i++) {
@@ -2184,10 +1466,55 @@ void LinearRemapGLLtoGLL_Integrated(
 			}
 			}
 		}
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void LinearRemapGLLtoGLL_Integrated(
+	const Mesh & meshInput,
+	const Mesh & meshOutput,
+	const Mesh & meshOverlap,
+	const DataArray3D<int> & dataGLLNodesIn,
+	const DataArray3D<double> & dataGLLJacobianIn,
+	const DataArray3D<int> & dataGLLNodesOut,
+	const DataArray3D<double> & dataGLLJacobianOut,
+	const DataArray1D<double> & dataNodalAreaOut,
+	int nPin,
+	int nPout,
+	int nMonotoneType,
+	bool fContinuousIn,
+	bool fContinuousOut,
+	OfflineMap & mapRemap
+) {
+	// Use the kernel specialized to the input and output orders, if
+	// available; only maps between elements of equal order are specialized
+	LinearRemapGLLtoGLLFunction fnRemap =
+		LinearRemapGLLtoGLL_IntegratedOrder<0,0>;
 
-		// Increment the current overlap index
-		ixOverlap += nOverlapFaces;
+	if (nPin == nPout) {
+		switch (nPin) {
+			case 2: fnRemap = LinearRemapGLLtoGLL_IntegratedOrder<2,2>; break;
+			case 3: fnRemap = LinearRemapGLLtoGLL_IntegratedOrder<3,3>; break;
+			case 4: fnRemap = LinearRemapGLLtoGLL_IntegratedOrder<4,4>; break;
+		}
 	}
+
+	(*fnRemap)(
+		meshInput,
+		meshOutput,
+		meshOverlap,
+		dataGLLNodesIn,
+		dataGLLJacobianIn,
+		dataGLLNodesOut,
+		dataGLLJacobianOut,
+		dataNodalAreaOut,
+		nPin,
+		nPout,
+		nMonotoneType,
+		fContinuousIn,
+		fContinuousOut,
+		mapRemap);
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -43,7 +43,8 @@ void LinearRemapSE0(
 
 ///	<summary>
 ///		Generate the OfflineMap for cubic conserative element-average
-///		spectral element to element average remapping.
+///		spectral element to element average remapping, using nThreads
+///		threads.  The resulting map does not depend on the thread count.
 ///	</summary>
 void LinearRemapSE4(
 	const Mesh & meshInput,
@@ -54,7 +55,8 @@ void LinearRemapSE4(
 	int nMonotoneType,
 	bool fContinuousIn,
 	bool fNoConservation,
-	OfflineMap & mapRemap
+	OfflineMap & mapRemap,
+	int nThreads = 1
 );
 
 ///////////////////////////////////////////////////////////////////////////////
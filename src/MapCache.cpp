@@ -0,0 +1,195 @@
+///////////////////////////////////////////////////////////////////////////////
+///
+///	\file    MapCache.cpp
+///	\author  agent
+///	\version October 14, 2026
+///
+///	<remarks>
+///		Copyright 2026 agent
+///
+///		This file is distributed as part of the Tempest source code package.
+///		Permission is granted to use, copy, modify and distribute this
+///		source code and its documentation under the terms of the GNU General
+///		Public License.  This software is provided "as is" without express
+///		or implied warranty.
+///	</remarks>
+
+#include "CommandLine.h"
+#include "Announce.h"
+#include "Exception.h"
+#include "OfflineMap.h"
+#include "OfflineMapCache.h"
+
+#include "netcdfcpp.h"
+
+#include <cstdio>
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Status of a map image relative to its source map.
+///	</summary>
+static const char * GetImageStatus(
+	const OfflineMapImage & image,
+	bool fVerify
+) {
+	if (!image.IsCurrent()) {
+		return "stale";
+	}
+	if (fVerify) {
+		const OfflineMapImageHeader & header = image.GetHeader();
+
+		if (image.ComputePayloadChecksum() != header.uPayloadChecksum) {
+			return "corrupt";
+		}
+		if (OfflineMapImage::ComputeFileChecksum(image.GetSourcePath())
+		        != header.uSourceChecksum
+		) {
+			return "stale";
+		}
+	}
+	return "current";
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+int main(int argc, char** argv) {
+
+	NcError error(NcError::silent_nonfatal);
+
+try {
+	// Cache directory
+	std::string strCacheDir;
+
+	// Map file whose image is built
+	std::string strBuildMap;
+
+	// Map file whose image is removed
+	std::string strRemoveMap;
+
+	// List the images in the cache
+	bool fList;
+
+	// Recompute the checksums of all images and their source maps
+	bool fVerify;
+
+	// Remove all images that are stale or corrupt
+	bool fPurge;
+
+	// Parse the command line
+	BeginCommandLine()
+		CommandLineString(strCacheDir, "cache_dir", "");
+		CommandLineString(strBuildMap, "build", "");
+		CommandLineString(strRemoveMap, "remove", "");
+		CommandLineBool(fList, "list");
+		CommandLineBool(fVerify, "verify");
+		CommandLineBool(fPurge, "purge");
+
+		ParseCommandLine(argc, argv);
+	EndCommandLine(argv)
+
+	if (strCacheDir == "") {
+		strCacheDir = OfflineMapImage::GetDefaultCacheDirectory();
+	}
+
+	if ((strBuildMap == "") && (strRemoveMap == "") &&
+	    !fList && !fVerify && !fPurge
+	) {
+		_EXCEPTIONT("One of --build, --remove, --list, --verify or --purge "
+			"must be specified");
+	}
+
+	AnnounceBanner();
+
+	Announce("Cache directory \"%s\"", strCacheDir.c_str());
+
+	// Build an image
+	if (strBuildMap != "") {
+		AnnounceStartBlock("Building map image");
+		Announce("Reading \"%s\"", strBuildMap.c_str());
+
+		const std::string strImage =
+			OfflineMapImage::GetImagePath(strCacheDir, strBuildMap);
+
+		OfflineMap mapRemap;
+		mapRemap.ReadWeights(strBuildMap);
+		mapRemap.WriteWeightsImage(strImage, strBuildMap);
+
+		Announce("Wrote \"%s\"", strImage.c_str());
+		AnnounceEndBlock("Done");
+	}
+
+	// Remove an image
+	if (strRemoveMap != "") {
+		const std::string strImage =
+			OfflineMapImage::GetImagePath(strCacheDir, strRemoveMap);
+
+		if (remove(strImage.c_str()) != 0) {
+			_EXCEPTION1("Unable to remove \"%s\"", strImage.c_str());
+		}
+		Announce("Removed \"%s\"", strImage.c_str());
+	}
+
+	// List, verify or purge images
+	if (fList || fVerify || fPurge) {
+		std::vector<std::string> vecImages;
+		OfflineMapImage::ListImages(strCacheDir, vecImages);
+
+		AnnounceStartBlock("Listing map images");
+		Announce("%lu images in cache", vecImages.size());
+
+		for (size_t i = 0; i < vecImages.size(); i++) {
+			std::string strStatus;
+			std::string strSource;
+			unsigned long ulNonZeros = 0;
+			unsigned long ulSize = 0;
+
+			OfflineMapImage image;
+			try {
+				if (!image.Open(vecImages[i])) {
+					continue;
+				}
+				strStatus = GetImageStatus(image, fVerify);
+				strSource = image.GetSourcePath();
+				ulNonZeros =
+					static_cast<unsigned long>(image.GetHeader().sNonZeros);
+				ulSize = static_cast<unsigned long>(image.GetHeader().uImageSize);
+				image.Close();
+
+			} catch(Exception & e) {
+				strStatus = "corrupt";
+			}
+
+			Announce("%s [%s]", vecImages[i].c_str(), strStatus.c_str());
+			if (strSource != "") {
+				Announce("  source %s (%lu nonzeros, %lu bytes)",
+					strSource.c_str(), ulNonZeros, ulSize);
+			}
+
+			if (fPurge && (strStatus != "current")) {
+				if (remove(vecImages[i].c_str()) != 0) {
+					_EXCEPTION1("Unable to remove \"%s\"",
+						vecImages[i].c_str());
+				}
+				Announce("  removed");
+			}
+		}
+
+		AnnounceEndBlock("Done");
+	}
+
+	AnnounceBanner();
+
+	return (0);
+
+} catch(Exception & e) {
+	Announce(e.ToString().c_str());
+	return (-1);
+
+} catch(...) {
+	return (-2);
+}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
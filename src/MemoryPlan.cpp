@@ -0,0 +1,495 @@
+///////////////////////////////////////////////////////////////////////////////
+///
+///	\file    MemoryPlan.cpp
+///	\author  agent
+///	\version October 15, 2026
+///
+///	<remarks>
+///		Copyright 2026 agent
+///
+///		This file is distributed as part of the Tempest source code package.
+///		Permission is granted to use, copy, modify and distribute this
+///		source code and its documentation under the terms of the GNU General
+///		Public License.  This software is provided "as is" without express
+///		or implied warranty.
+///	</remarks>
+
+#include "MemoryPlan.h"
+#include "CompactOverlapMesh.h"
+#include "LinearRemapNonConservative.h"
+#include "STLStringHelper.h"
+#include "Announce.h"
+#include "Exception.h"
+
+#include "netcdfcpp.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <set>
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Bytes in a MB.
+///	</summary>
+static const double MemoryPlanBytesPerMB = 1024.0 * 1024.0;
+
+///	<summary>
+///		Overhead of each heap allocation and of each node of a std::set or
+///		hash table (in bytes).
+///	</summary>
+static const double MemoryPlanAllocationBytes = 16.0;
+static const double MemoryPlanContainerNodeBytes = 32.0;
+
+///	<summary>
+///		Number of overlap mesh Faces per source and target Face, used when
+///		the overlap mesh file does not record its size.  Overlap meshes of
+///		unrelated meshes typically have about one overlap Face per source
+///		and target Face, so this overestimates.
+///	</summary>
+static const double MemoryPlanOverlapFacesPerFace = 2.0;
+
+///	<summary>
+///		Average number of edges of an overlap mesh Face.
+///	</summary>
+static const double MemoryPlanOverlapEdgesPerFace = 5.0;
+
+///	<summary>
+///		Scratch memory of each thread computing the map, covering local
+///		fit arrays, quadrature and thread stacks (in MB).
+///	</summary>
+static const double MemoryPlanThreadScratchMB = 16.0;
+
+///	<summary>
+///		Peak bytes per map entry while entry buffers are assembled into
+///		compressed rows (see SparseMatrix::AssembleEntries()), and bytes
+///		per entry of the assembled map.
+///	</summary>
+static const double MemoryPlanAssemblyBytesPerEntry = 32.0;
+static const double MemoryPlanMapBytesPerEntry = 12.0;
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Bytes of a Mesh with the given counts, including the edge map and
+///		reverse node array if fConnectivity is true.
+///	</summary>
+static double MeshBytes(
+	double dFaces,
+	double dNodes,
+	double dEdgesPerFace,
+	bool fConnectivity
+) {
+	double dBytes =
+		dNodes * sizeof(Node)
+		+ dFaces * (sizeof(Face) + MemoryPlanAllocationBytes
+			+ dEdgesPerFace * sizeof(Edge) + sizeof(double));
+
+	if (fConnectivity) {
+		const double dEdges = 0.5 * dFaces * dEdgesPerFace;
+
+		// Edge map
+		dBytes += dEdges
+			* (sizeof(Edge) + sizeof(FacePair) + MemoryPlanContainerNodeBytes);
+
+		// Reverse node array
+		dBytes += dNodes * (sizeof(std::set<int>) + MemoryPlanAllocationBytes)
+			+ dFaces * dEdgesPerFace
+				* (sizeof(int) + MemoryPlanContainerNodeBytes);
+	}
+
+	return dBytes;
+}
+
+///	<summary>
+///		Average number of edges per Face of a Mesh.
+///	</summary>
+static double EdgesPerFace(
+	const Mesh & mesh
+) {
+	if (mesh.faces.size() == 0) {
+		return 0.0;
+	}
+	size_t sEdges = 0;
+	for (size_t i = 0; i < mesh.faces.size(); i++) {
+		sEdges += mesh.faces[i].edges.size();
+	}
+	return static_cast<double>(sEdges) / static_cast<double>(mesh.faces.size());
+}
+
+///	<summary>
+///		Maximum number of edges of a Face of a Mesh.
+///	</summary>
+static int MaxEdgesPerFace(
+	const Mesh & mesh
+) {
+	size_t sMaxEdges = 0;
+	for (size_t i = 0; i < mesh.faces.size(); i++) {
+		if (mesh.faces[i].edges.size() > sMaxEdges) {
+			sMaxEdges = mesh.faces[i].edges.size();
+		}
+	}
+	return static_cast<int>(sMaxEdges);
+}
+
+///	<summary>
+///		Read the number of Faces and Nodes of an overlap mesh from the
+///		dimensions of its file.  Returns false if they are not recorded.
+///	</summary>
+static bool ReadOverlapMeshSize(
+	const std::string & strOverlapMesh,
+	int & nFaces,
+	int & nNodes
+) {
+	NcFile ncFile(strOverlapMesh.c_str(), NcFile::ReadOnly);
+	if (!ncFile.is_valid()) {
+		_EXCEPTION1("Unable to open overlap mesh file \"%s\"",
+			strOverlapMesh.c_str());
+	}
+
+	NcDim * dimElements = NULL;
+	NcDim * dimNodes = NULL;
+	for (int d = 0; d < ncFile.num_dims(); d++) {
+		NcDim * dim = ncFile.get_dim(d);
+		std::string strDimName = dim->name();
+		if (strDimName == "num_elem") {
+			dimElements = dim;
+		}
+		if (strDimName == "num_nodes") {
+			dimNodes = dim;
+		}
+	}
+	if ((dimElements == NULL) || (dimNodes == NULL)) {
+		return false;
+	}
+
+	nFaces = static_cast<int>(dimElements->size());
+	nNodes = static_cast<int>(dimNodes->size());
+	return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Sizes of the data held by each stage of map generation (in bytes),
+///		which do not depend on the choices of the plan.
+///	</summary>
+struct OfflineMapMemorySizes {
+
+	///	<summary>
+	///		Source and target meshes with their connectivity, and their
+	///		finite element meta data.
+	///	</summary>
+	double dMeshes;
+
+	///	<summary>
+	///		Overlap mesh, and the compact overlap mesh held while it is
+	///		expanded.
+	///	</summary>
+	double dOverlap;
+	double dCompactOverlap;
+
+	///	<summary>
+	///		Source and target coordinates and areas of the map.
+	///	</summary>
+	double dCoordinates;
+
+	///	<summary>
+	///		Map entry buffers while they are assembled, and the assembled
+	///		map.
+	///	</summary>
+	double dAssembly;
+	double dMap;
+
+	///	<summary>
+	///		Buffers of one data slice when applying the map.
+	///	</summary>
+	double dApplySlice;
+
+	///	<summary>
+	///		Faces are reordered for this map if requested.
+	///	</summary>
+	bool fReorderable;
+};
+
+///	<summary>
+///		Estimate the peak memory of each stage of a plan.
+///	</summary>
+static void EvaluateOfflineMapMemoryPlan(
+	const OfflineMapMemorySizes & sizes,
+	bool fApplyToData,
+	OfflineMapMemoryPlan & plan
+) {
+	plan.vecStages.clear();
+
+	char szStrategy[128];
+
+	// Overlap mesh
+	const double dLoaded = sizes.dMeshes + sizes.dOverlap;
+
+	if (sizes.dOverlap != 0.0) {
+		plan.vecStages.push_back(MemoryPlanStage(
+			"Load overlap mesh",
+			(dLoaded + sizes.dCompactOverlap) / MemoryPlanBytesPerMB,
+			(sizes.dCompactOverlap != 0.0)
+				? "expand compact file in memory"
+				: "in memory"));
+	}
+
+	// Map computation; reordering copies all three meshes
+	double dCompute =
+		dLoaded + sizes.dCoordinates + sizes.dAssembly
+		+ plan.nThreads * MemoryPlanThreadScratchMB * MemoryPlanBytesPerMB;
+
+	const bool fReorder = (plan.fReorderFaces && sizes.fReorderable);
+	if (fReorder) {
+		dCompute += dLoaded;
+	}
+
+	snprintf(szStrategy, sizeof(szStrategy), "%i thread%s%s",
+		plan.nThreads,
+		(plan.nThreads == 1) ? "" : "s",
+		fReorder ? ", faces reordered" : "");
+
+	plan.vecStages.push_back(MemoryPlanStage(
+		"Compute map", dCompute / MemoryPlanBytesPerMB, szStrategy));
+
+	// Writing streams the map in chunks
+	const double dWrite = dLoaded + sizes.dCoordinates + sizes.dMap;
+
+	plan.vecStages.push_back(MemoryPlanStage(
+		"Write map", dWrite / MemoryPlanBytesPerMB, "chunked"));
+
+	// Applying the map holds one block of slices; the block is never
+	// smaller than the thread count
+	if (fApplyToData) {
+		const int nBatchSize = std::max(plan.nApplyBatchSize, plan.nThreads);
+
+		snprintf(szStrategy, sizeof(szStrategy), "blocks of %i slice%s",
+			nBatchSize, (nBatchSize == 1) ? "" : "s");
+
+		plan.vecStages.push_back(MemoryPlanStage(
+			"Apply map",
+			(dWrite + nBatchSize * sizes.dApplySlice) / MemoryPlanBytesPerMB,
+			szStrategy));
+	}
+
+	plan.dPeakMB = 0.0;
+	for (size_t s = 0; s < plan.vecStages.size(); s++) {
+		plan.dPeakMB = std::max(plan.dPeakMB, plan.vecStages[s].dPeakMB);
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void PlanOfflineMapMemory(
+	const Mesh & meshInput,
+	const Mesh & meshOutput,
+	const std::string & strOverlapMesh,
+	const OfflineMapOptions & options,
+	bool fApplyToData,
+	double dLimitMB,
+	int nApplyBatchSize,
+	OfflineMapMemoryPlan & plan
+) {
+	if (dLimitMB <= 0.0) {
+		_EXCEPTIONT("Memory limit must be positive");
+	}
+
+	std::string strSourceType = options.strSourceType;
+	std::string strTargetType = options.strTargetType;
+	STLStringHelper::ToLower(strSourceType);
+	STLStringHelper::ToLower(strTargetType);
+
+	const bool fSourceFV = (strSourceType == "fv");
+	const bool fTargetFV = (strTargetType == "fv");
+
+	const double dSourceFaces = static_cast<double>(meshInput.faces.size());
+	const double dTargetFaces = static_cast<double>(meshOutput.faces.size());
+
+	// Degrees of freedom; continuous finite element nodes are shared
+	// between neighboring faces
+	const int nPin = options.nPin;
+	const int nPout = options.nPout;
+
+	double dSourceDofs = dSourceFaces;
+	if (strSourceType == "dgll") {
+		dSourceDofs = dSourceFaces * nPin * nPin;
+	} else if (strSourceType == "cgll") {
+		dSourceDofs = dSourceFaces * (nPin - 1) * (nPin - 1) + 2.0;
+	}
+
+	double dTargetDofs = dTargetFaces;
+	if (strTargetType == "dgll") {
+		dTargetDofs = dTargetFaces * nPout * nPout;
+	} else if (strTargetType == "cgll") {
+		dTargetDofs = dTargetFaces * (nPout - 1) * (nPout - 1) + 2.0;
+	}
+
+	OfflineMapMemorySizes sizes;
+
+	// Meshes and their finite element meta data
+	sizes.dMeshes =
+		MeshBytes(dSourceFaces, meshInput.nodes.size(),
+			EdgesPerFace(meshInput), true)
+		+ MeshBytes(dTargetFaces, meshOutput.nodes.size(),
+			EdgesPerFace(meshOutput), true);
+
+	if (!fSourceFV) {
+		sizes.dMeshes +=
+			dSourceFaces * nPin * nPin * (sizeof(int) + sizeof(double));
+	}
+	if (!fTargetFV) {
+		sizes.dMeshes +=
+			dTargetFaces * nPout * nPout * (sizeof(int) + sizeof(double));
+	}
+
+	// Overlap mesh
+	const NonConservativeMethod eMethod =
+		ParseNonConservativeMethod(options.strMethod);
+
+	plan.nOverlapFaces = 0;
+	plan.fOverlapFacesEstimated = false;
+
+	sizes.dOverlap = 0.0;
+	sizes.dCompactOverlap = 0.0;
+
+	if (eMethod == NonConservativeMethod_Conservative) {
+		int nOverlapNodes = 0;
+		if ((strOverlapMesh == "") ||
+		    !ReadOverlapMeshSize(
+				strOverlapMesh, plan.nOverlapFaces, nOverlapNodes)
+		) {
+			plan.nOverlapFaces = static_cast<int>(
+				MemoryPlanOverlapFacesPerFace * (dSourceFaces + dTargetFaces));
+			nOverlapNodes = plan.nOverlapFaces;
+			plan.fOverlapFacesEstimated = true;
+		}
+
+		// Overlap meshes also index their faces by source and target face
+		sizes.dOverlap =
+			MeshBytes(plan.nOverlapFaces, nOverlapNodes,
+				MemoryPlanOverlapEdgesPerFace, false)
+			+ plan.nOverlapFaces * 5.0 * sizeof(int);
+
+		if ((strOverlapMesh != "") &&
+		    CompactOverlapMesh::IsCompactOverlapFile(strOverlapMesh)
+		) {
+			sizes.dCompactOverlap =
+				plan.nOverlapFaces
+					* (MemoryPlanOverlapEdgesPerFace + 2.0) * sizeof(int)
+				+ nOverlapNodes * sizeof(Node);
+		}
+	}
+
+	// Map entries generated before repeated entries are combined
+	const double dOverlapFaces = static_cast<double>(plan.nOverlapFaces);
+	const double dStencilFaces = nPin * (nPin + 1);
+
+	double dEntries;
+	if (eMethod == NonConservativeMethod_NearestNeighbor) {
+		dEntries = dTargetDofs;
+	} else if (eMethod == NonConservativeMethod_Bilinear) {
+		dEntries = 3.0 * dTargetDofs;
+	} else if (eMethod == NonConservativeMethod_Patch) {
+		dEntries = 9.0 * dTargetDofs;
+	} else if (fSourceFV && fTargetFV) {
+		dEntries = dOverlapFaces * dStencilFaces;
+	} else if (fSourceFV) {
+		dEntries = dOverlapFaces * dStencilFaces * nPout * nPout;
+	} else if (fTargetFV) {
+		dEntries = dOverlapFaces * nPin * nPin;
+	} else {
+		dEntries = dOverlapFaces * nPin * nPin * nPout * nPout;
+	}
+
+	plan.sMapEntries = static_cast<size_t>(dEntries);
+
+	sizes.dAssembly = dEntries * MemoryPlanAssemblyBytesPerEntry;
+	sizes.dMap =
+		dEntries * MemoryPlanMapBytesPerEntry + dTargetDofs * sizeof(int);
+
+	// Coordinates hold the corners, center, area and coverage of each
+	// degree of freedom
+	const int nSourceCorners = fSourceFV ? MaxEdgesPerFace(meshInput) : 4;
+	const int nTargetCorners = fTargetFV ? MaxEdgesPerFace(meshOutput) : 4;
+
+	sizes.dCoordinates =
+		dSourceDofs * (nSourceCorners + 2) * 2 * sizeof(double)
+		+ dTargetDofs * (nTargetCorners + 2) * 2 * sizeof(double);
+
+	// Input and output values of one slice as read and remapped
+	sizes.dApplySlice = (dSourceDofs + dTargetDofs) * 2 * sizeof(double);
+
+	// Only finite volume to finite volume maps are reordered
+	sizes.fReorderable =
+		fSourceFV && fTargetFV
+		&& (eMethod == NonConservativeMethod_Conservative);
+
+	// Start from the requested plan and reduce it until it fits
+	plan.dLimitMB = dLimitMB;
+	plan.nThreads = options.nThreads;
+	plan.fReorderFaces = options.fReorderFaces;
+	plan.nApplyBatchSize = std::max(nApplyBatchSize, 1);
+
+	EvaluateOfflineMapMemoryPlan(sizes, fApplyToData, plan);
+
+	if ((plan.dPeakMB > dLimitMB) && plan.fReorderFaces && sizes.fReorderable) {
+		plan.fReorderFaces = false;
+		EvaluateOfflineMapMemoryPlan(sizes, fApplyToData, plan);
+	}
+	while ((plan.dPeakMB > dLimitMB) && (plan.nApplyBatchSize > 1)) {
+		plan.nApplyBatchSize /= 2;
+		EvaluateOfflineMapMemoryPlan(sizes, fApplyToData, plan);
+	}
+	while ((plan.dPeakMB > dLimitMB) && (plan.nThreads > 1)) {
+		plan.nThreads--;
+		EvaluateOfflineMapMemoryPlan(sizes, fApplyToData, plan);
+	}
+
+	if (plan.dPeakMB > dLimitMB) {
+		AnnounceOfflineMapMemoryPlan(plan);
+
+		for (size_t s = 0; s < plan.vecStages.size(); s++) {
+			if (plan.vecStages[s].dPeakMB > dLimitMB) {
+				_EXCEPTION3("Stage \"%s\" needs an estimated %1.1f MB, "
+					"which exceeds the memory limit of %1.1f MB",
+					plan.vecStages[s].strName.c_str(),
+					plan.vecStages[s].dPeakMB,
+					dLimitMB);
+			}
+		}
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void AnnounceOfflineMapMemoryPlan(
+	const OfflineMapMemoryPlan & plan
+) {
+	char szTitle[64];
+	snprintf(szTitle, sizeof(szTitle),
+		"Memory plan (limit %1.1f MB)", plan.dLimitMB);
+
+	AnnounceStartBlock(szTitle);
+
+	if (plan.nOverlapFaces != 0) {
+		Announce("Overlap faces: %i%s", plan.nOverlapFaces,
+			plan.fOverlapFacesEstimated ? " (estimated)" : "");
+	}
+	Announce("Map entries: %lu (estimated)",
+		static_cast<unsigned long>(plan.sMapEntries));
+
+	for (size_t s = 0; s < plan.vecStages.size(); s++) {
+		Announce("%-18s %10.1f MB  %s",
+			plan.vecStages[s].strName.c_str(),
+			plan.vecStages[s].dPeakMB,
+			plan.vecStages[s].strStrategy.c_str());
+	}
+	Announce("%-18s %10.1f MB", "Peak", plan.dPeakMB);
+
+	AnnounceEndBlock(NULL);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
@@ -0,0 +1,166 @@
+///////////////////////////////////////////////////////////////////////////////
+///
+///	\file    MemoryPlan.h
+///	\author  agent
+///	\version October 15, 2026
+///
+///	<remarks>
+///		Copyright 2026 agent
+///
+///		This file is distributed as part of the Tempest source code package.
+///		Permission is granted to use, copy, modify and distribute this
+///		source code and its documentation under the terms of the GNU General
+///		Public License.  This software is provided "as is" without express
+///		or implied warranty.
+///	</remarks>
+
+#ifndef _MEMORYPLAN_H_
+#define _MEMORYPLAN_H_
+
+#include "GridElements.h"
+#include "OfflineMapGenerator.h"
+
+#include <string>
+#include <vector>
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Estimated peak memory and chosen strategy of one stage of map
+///		generation.
+///	</summary>
+struct MemoryPlanStage {
+
+	///	<summary>
+	///		Constructor.
+	///	</summary>
+	MemoryPlanStage(
+		const std::string & _strName,
+		double _dPeakMB,
+		const std::string & _strStrategy
+	) :
+		strName(_strName),
+		dPeakMB(_dPeakMB),
+		strStrategy(_strStrategy)
+	{ }
+
+	///	<summary>
+	///		Name of the stage.
+	///	</summary>
+	std::string strName;
+
+	///	<summary>
+	///		Estimated memory in use at the end of the stage (in MB).
+	///	</summary>
+	double dPeakMB;
+
+	///	<summary>
+	///		Description of the strategy chosen for the stage.
+	///	</summary>
+	std::string strStrategy;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		A plan for generating an offline map within a memory limit.
+///	</summary>
+struct OfflineMapMemoryPlan {
+
+	///	<summary>
+	///		Constructor.
+	///	</summary>
+	OfflineMapMemoryPlan() :
+		dLimitMB(0.0),
+		dPeakMB(0.0),
+		nOverlapFaces(0),
+		fOverlapFacesEstimated(false),
+		sMapEntries(0),
+		nThreads(1),
+		fReorderFaces(false),
+		nApplyBatchSize(1)
+	{ }
+
+	///	<summary>
+	///		Memory limit (in MB).
+	///	</summary>
+	double dLimitMB;
+
+	///	<summary>
+	///		Estimated peak memory over all stages (in MB).
+	///	</summary>
+	double dPeakMB;
+
+	///	<summary>
+	///		Number of overlap mesh Faces, which is estimated from the
+	///		source and target meshes if the overlap mesh file does not
+	///		record it.
+	///	</summary>
+	int nOverlapFaces;
+	bool fOverlapFacesEstimated;
+
+	///	<summary>
+	///		Estimated number of map entries generated before repeated
+	///		entries are combined.
+	///	</summary>
+	size_t sMapEntries;
+
+	///	<summary>
+	///		Number of threads used to generate and apply the map.
+	///	</summary>
+	int nThreads;
+
+	///	<summary>
+	///		Compute the map on copies of the meshes reordered for locality.
+	///	</summary>
+	bool fReorderFaces;
+
+	///	<summary>
+	///		Number of data slices remapped at once when applying the map.
+	///	</summary>
+	int nApplyBatchSize;
+
+	///	<summary>
+	///		Stages of map generation, in order.
+	///	</summary>
+	std::vector<MemoryPlanStage> vecStages;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Plan the generation of the offline map from meshInput to meshOutput
+///		with the overlap mesh in file strOverlapMesh (which is empty for
+///		non-conservative maps) within dLimitMB of memory.  The input and
+///		output meshes must already be loaded, but the overlap mesh is only
+///		sized from its file.  The peak memory of each stage is estimated
+///		from the face and node counts of the meshes and from the number of
+///		map entries implied by the discretizations and their orders.  The
+///		number of threads, face reordering and the batch size used when
+///		applying the map to data (nApplyBatchSize, at most its value on
+///		input) are then reduced until the estimate fits in dLimitMB.  An
+///		Exception is thrown if the map cannot be generated within the
+///		limit even with these reductions.
+///	</summary>
+void PlanOfflineMapMemory(
+	const Mesh & meshInput,
+	const Mesh & meshOutput,
+	const std::string & strOverlapMesh,
+	const OfflineMapOptions & options,
+	bool fApplyToData,
+	double dLimitMB,
+	int nApplyBatchSize,
+	OfflineMapMemoryPlan & plan
+);
+
+///	<summary>
+///		Announce each stage of a memory plan.
+///	</summary>
+void AnnounceOfflineMapMemoryPlan(
+	const OfflineMapMemoryPlan & plan
+);
+
+///////////////////////////////////////////////////////////////////////////////
+
+#endif
+
@@ -17,92 +17,74 @@
 #include "MeshUtilities.h"
 
 #include "Exception.h"
+#include "OmpExceptionCapture.h"
+
+#include <string>
 
 ///////////////////////////////////////////////////////////////////////////////
 
-void MeshUtilities::FindFaceFromNode(
+bool MeshUtilities::AddFaceIfContainsNode(
 	const Mesh & mesh,
+	int ixFace,
 	const Node & node,
 	FindFaceStruct & aFindFaceStruct
-) {
-	// Reset the FaceStruct
-	aFindFaceStruct.vecFaceIndices.clear();
-	aFindFaceStruct.vecFaceLocations.clear();
-	aFindFaceStruct.loc = Face::NodeLocation_Undefined;
-
-	// Loop through all faces to find overlaps
-	// Note: This algorithm can likely be dramatically improved
-	for (int l = 0; l < mesh.faces.size(); l++) {
-		Face::NodeLocation loc;
-		int ixLocation;
-
-		ContainsNode(
-			mesh.faces[l],
-			mesh.nodes,
-			node,
-			loc,
-			ixLocation);
-
-		if (loc == Face::NodeLocation_Exterior) {
-			continue;
-		}
+) const {
+	Face::NodeLocation loc;
+	int ixLocation;
+
+	ContainsNode(
+		mesh.faces[ixFace],
+		mesh.nodes,
+		node,
+		loc,
+		ixLocation);
+
+	if (loc == Face::NodeLocation_Exterior) {
+		return false;
+	}
 
 #ifdef VERBOSE
-		printf("%i\n", l);
-		printf("n: %1.5e %1.5e %1.5e\n", node.x, node.y, node.z);
-		printf("n0: %1.5e %1.5e %1.5e\n",
-			mesh.nodes[mesh.faces[l][0]].x,
-			mesh.nodes[mesh.faces[l][0]].y,
-			mesh.nodes[mesh.faces[l][0]].z);
-		printf("n1: %1.5e %1.5e %1.5e\n",
-			mesh.nodes[mesh.faces[l][1]].x,
-			mesh.nodes[mesh.faces[l][1]].y,
-			mesh.nodes[mesh.faces[l][1]].z);
-		printf("n2: %1.5e %1.5e %1.5e\n",
-			mesh.nodes[mesh.faces[l][2]].x,
-			mesh.nodes[mesh.faces[l][2]].y,
-			mesh.nodes[mesh.faces[l][2]].z);
-		printf("n3: %1.5e %1.5e %1.5e\n",
-			mesh.nodes[mesh.faces[l][3]].x,
-			mesh.nodes[mesh.faces[l][3]].y,
-			mesh.nodes[mesh.faces[l][3]].z);
+	printf("%i\n", ixFace);
+	printf("n: %1.5e %1.5e %1.5e\n", node.x, node.y, node.z);
+	printf("n0: %1.5e %1.5e %1.5e\n",
+		mesh.nodes[mesh.faces[ixFace][0]].x,
+		mesh.nodes[mesh.faces[ixFace][0]].y,
+		mesh.nodes[mesh.faces[ixFace][0]].z);
+	printf("n1: %1.5e %1.5e %1.5e\n",
+		mesh.nodes[mesh.faces[ixFace][1]].x,
+		mesh.nodes[mesh.faces[ixFace][1]].y,
+		mesh.nodes[mesh.faces[ixFace][1]].z);
+	printf("n2: %1.5e %1.5e %1.5e\n",
+		mesh.nodes[mesh.faces[ixFace][2]].x,
+		mesh.nodes[mesh.faces[ixFace][2]].y,
+		mesh.nodes[mesh.faces[ixFace][2]].z);
+	printf("n3: %1.5e %1.5e %1.5e\n",
+		mesh.nodes[mesh.faces[ixFace][3]].x,
+		mesh.nodes[mesh.faces[ixFace][3]].y,
+		mesh.nodes[mesh.faces[ixFace][3]].z);
 #endif
 
-		if (aFindFaceStruct.loc == Face::NodeLocation_Undefined) {
-			aFindFaceStruct.loc = loc;
-		}
-
-		// Node is in the interior of this face
-		if (loc == Face::NodeLocation_Interior) {
-			if (loc != aFindFaceStruct.loc) {
-				_EXCEPTIONT("No consensus on location of Node");
-			}
+	if (aFindFaceStruct.loc == Face::NodeLocation_Undefined) {
+		aFindFaceStruct.loc = loc;
+	}
 
-			aFindFaceStruct.vecFaceIndices.push_back(l);
-			aFindFaceStruct.vecFaceLocations.push_back(ixLocation);
-			break;
-		}
+	if (loc != aFindFaceStruct.loc) {
+		_EXCEPTIONT("No consensus on location of Node");
+	}
 
-		// Node is on the edge of this face
-		if (loc == Face::NodeLocation_Edge) {
-			if (loc != aFindFaceStruct.loc) {
-				_EXCEPTIONT("No consensus on location of Node");
-			}
+	aFindFaceStruct.vecFaceIndices.push_back(ixFace);
+	aFindFaceStruct.vecFaceLocations.push_back(ixLocation);
 
-			aFindFaceStruct.vecFaceIndices.push_back(l);
-			aFindFaceStruct.vecFaceLocations.push_back(ixLocation);
-		}
+	// Node is in the interior of this face
+	return (loc == Face::NodeLocation_Interior);
+}
 
-		// Node is at the corner of this face
-		if (loc == Face::NodeLocation_Corner) {
-			if (loc != aFindFaceStruct.loc) {
-				_EXCEPTIONT("No consensus on location of Node");
-			}
+///////////////////////////////////////////////////////////////////////////////
 
-			aFindFaceStruct.vecFaceIndices.push_back(l);
-			aFindFaceStruct.vecFaceLocations.push_back(ixLocation);
-		}
-	}
+void MeshUtilities::VerifyFindFaceStruct(
+	const Node & node,
+	const FindFaceStruct & aFindFaceStruct
+) const {
 
 	// Edges can only have two adjacent Faces
 	if (aFindFaceStruct.loc == Face::NodeLocation_Edge) {
@@ -126,3 +108,123 @@ void MeshUtilities::FindFaceFromNode(
 
 ///////////////////////////////////////////////////////////////////////////////
 
+void MeshUtilities::FindFaceFromNode(
+	const Mesh & mesh,
+	const Node & node,
+	FindFaceStruct & aFindFaceStruct
+) {
+	// Reset the FaceStruct
+	aFindFaceStruct.vecFaceIndices.clear();
+	aFindFaceStruct.vecFaceLocations.clear();
+	aFindFaceStruct.loc = Face::NodeLocation_Undefined;
+
+	// Loop through all faces to find overlaps
+	// Note: Use the FaceLocator overload when many Nodes must be located
+	for (int l = 0; l < mesh.faces.size(); l++) {
+		if (AddFaceIfContainsNode(mesh, l, node, aFindFaceStruct)) {
+			break;
+		}
+	}
+
+	VerifyFindFaceStruct(node, aFindFaceStruct);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void MeshUtilities::FindFaceFromNode(
+	const Mesh & mesh,
+	const FaceLocator & locator,
+	const Node & node,
+	FindFaceStruct & aFindFaceStruct
+) const {
+	if (locator.GetFaceCount() != mesh.faces.size()) {
+		_EXCEPTIONT("FaceLocator was not built over this Mesh");
+	}
+
+	// Reset the FaceStruct
+	aFindFaceStruct.vecFaceIndices.clear();
+	aFindFaceStruct.vecFaceLocations.clear();
+	aFindFaceStruct.loc = Face::NodeLocation_Undefined;
+
+	// Only test Faces whose bounding cap contains the Node, in the same
+	// order as the exhaustive search
+	std::vector<int> vecCandidates;
+	locator.FindCandidateFaces(node, vecCandidates);
+
+	for (int i = 0; i < vecCandidates.size(); i++) {
+		if (AddFaceIfContainsNode(mesh, vecCandidates[i], node, aFindFaceStruct)) {
+			break;
+		}
+	}
+
+	VerifyFindFaceStruct(node, aFindFaceStruct);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void MeshUtilities::FindEdgeIntersectionCandidates(
+	const Node & nodeBegin,
+	const Node & nodeEnd,
+	Edge::Type typeBegin,
+	const Face & face,
+	const NodeVector & nodevec,
+	std::vector<bool> & vecCandidate
+) const {
+	vecCandidate.assign(face.edges.size(), true);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void MeshUtilities::FindFaceFromNodes(
+	const Mesh & mesh,
+	const FaceLocator & locator,
+	const NodeVector & nodevec,
+	std::vector<FindFaceStruct> & vecFindFaceStruct,
+	int nThreads
+) const {
+	if (nThreads < 1) {
+		_EXCEPTIONT("Thread count must be at least 1");
+	}
+	if (locator.GetFaceCount() != mesh.faces.size()) {
+		_EXCEPTIONT("FaceLocator was not built over this Mesh");
+	}
+
+	const int nNodes = static_cast<int>(nodevec.size());
+
+	vecFindFaceStruct.resize(nNodes);
+
+	OmpExceptionCapture capture;
+
+#pragma omp parallel num_threads(nThreads)
+	{
+		std::vector<int> vecCandidates;
+
+#pragma omp for schedule(dynamic, 256)
+		for (int n = 0; n < nNodes; n++) {
+			FindFaceStruct & aFindFaceStruct = vecFindFaceStruct[n];
+
+			aFindFaceStruct.vecFaceIndices.clear();
+			aFindFaceStruct.vecFaceLocations.clear();
+			aFindFaceStruct.loc = Face::NodeLocation_Undefined;
+
+			capture.Run([&]() {
+				locator.FindCandidateFaces(nodevec[n], vecCandidates);
+
+				for (int i = 0; i < vecCandidates.size(); i++) {
+					if (AddFaceIfContainsNode(
+							mesh, vecCandidates[i], nodevec[n], aFindFaceStruct)
+					) {
+						break;
+					}
+				}
+
+				VerifyFindFaceStruct(nodevec[n], aFindFaceStruct);
+			});
+		}
+	}
+
+	capture.Rethrow();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
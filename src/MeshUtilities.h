@@ -18,6 +18,9 @@
 #define _MESHUTILITIES_H_
 
 #include "GridElements.h"
+#include "FaceLocator.h"
+
+#include <vector>
 
 ///////////////////////////////////////////////////////////////////////////////
 
@@ -45,6 +48,68 @@ public:
 		FindFaceStruct & aFindFaceStruct
 	);
 
+	///	<summary>
+	///		Find all Face indices that contain this Node, only testing the
+	///		candidate Faces returned by a FaceLocator built over mesh.
+	///	</summary>
+	void FindFaceFromNode(
+		const Mesh & mesh,
+		const FaceLocator & locator,
+		const Node & node,
+		FindFaceStruct & aFindFaceStruct
+	) const;
+
+	///	<summary>
+	///		Find all Face indices that contain each Node of nodevec, using a
+	///		FaceLocator built over mesh.  Nodes are located in parallel when
+	///		nThreads is greater than one.
+	///	</summary>
+	void FindFaceFromNodes(
+		const Mesh & mesh,
+		const FaceLocator & locator,
+		const NodeVector & nodevec,
+		std::vector<FindFaceStruct> & vecFindFaceStruct,
+		int nThreads = 1
+	) const;
+
+	///	<summary>
+	///		Flag the edges of face which may intersect the edge connecting
+	///		nodeBegin and nodeEnd with type typeBegin.  An edge that is not
+	///		flagged is guaranteed to have no intersection with this edge, so
+	///		the call to CalculateEdgeIntersections may be skipped.  The
+	///		default implementation flags all edges.
+	///	</summary>
+	void FindEdgeIntersectionCandidates(
+		const Node & nodeBegin,
+		const Node & nodeEnd,
+		Edge::Type typeBegin,
+		const Face & face,
+		const NodeVector & nodevec,
+		std::vector<bool> & vecCandidate
+	) const;
+
+protected:
+	///	<summary>
+	///		Test if the Face with index ixFace contains node and update
+	///		aFindFaceStruct accordingly.  Returns true if the Node is in the
+	///		interior of the Face, in which case the search can stop.
+	///	</summary>
+	bool AddFaceIfContainsNode(
+		const Mesh & mesh,
+		int ixFace,
+		const Node & node,
+		FindFaceStruct & aFindFaceStruct
+	) const;
+
+	///	<summary>
+	///		Verify that the Faces found for a Node on an edge or corner
+	///		are consistent with a valid mesh.
+	///	</summary>
+	void VerifyFindFaceStruct(
+		const Node & node,
+		const FindFaceStruct & aFindFaceStruct
+	) const;
+
 };
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -26,16 +26,24 @@ bool MeshUtilitiesExact::AreNodesEqual(
 	const NodeExact & node0,
 	const NodeExact & node1
 ) {
-	NodeExact nodeCross = CrossProductX(node0, node1);
-
-	if (nodeCross.fx.IsZero() &&
-		nodeCross.fy.IsZero() &&
-		nodeCross.fz.IsZero()
+	// Components of the cross product
+	if (SignOfDifferenceOfProducts(
+			node0.fy, node1.fz, node0.fz, node1.fy) != 0
+	) {
+		return false;
+	}
+	if (SignOfDifferenceOfProducts(
+			node0.fz, node1.fx, node0.fx, node1.fz) != 0
+	) {
+		return false;
+	}
+	if (SignOfDifferenceOfProducts(
+			node0.fx, node1.fy, node0.fy, node1.fx) != 0
 	) {
-		return true;
+		return false;
 	}
 
-	return false;
+	return true;
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -60,57 +68,20 @@ void MeshUtilitiesExact::ContainsNode(
 		}
 
 		// Check which side of the Face this Edge is on
-		NodeExact na(nodevec[face.edges[i][0]]);
-		NodeExact nb(nodevec[face.edges[i][1]]);
-
 		if (face.edges[i].type == Edge::Type_GreatCircleArc) {
 
-			FixedPoint fpDotNorm = DotProductX(CrossProductX(na, nb), node);
-/*
-			Node nx = CrossProductX(na, nb);
-			nx.PrintMX();
-			FixedPoint fpX = nx.fx * node.fx;
-			FixedPoint fpY = nx.fy * node.fy;
-			FixedPoint fpZ = nx.fz * node.fz;
-
-			printf("NOW:\n");
-			FixedPoint fpDot = fpX + fpZ;
-
-			node.PrintMX(); printf("\n");
-			fpX.Print(); printf("\n");
-			fpY.Print(); printf("\n");
-			fpZ.Print(); printf("\n");
-*/
-/*
-			printf("a := Vector("); na.PrintMX(); printf(");");
-			printf("b := Vector("); na.PrintMX(); printf(");");
-			printf("N: "); fpDotNorm.Print(); printf("\n");
-*/
-/*
-			Node nodeCross = CrossProduct(na, nb);
-			Node nodeCrossX = CrossProductX(na, nb);
-			long double dDotNorm = DotProduct(CrossProduct(na, nb), node);
-
-			FixedPoint fp0 = nodeCrossX.fx * node.fx;
-			FixedPoint fp1 = nodeCrossX.fy * node.fy;
-			FixedPoint fp2 = nodeCrossX.fz * node.fz;
+			int iSignDotNorm =
+				SignOfTripleProduct(
+					nodevec[face.edges[i][0]],
+					nodevec[face.edges[i][1]],
+					node);
 
-			printf("(X) %1.15e : ", nodeCross.x); nodeCrossX.fx.Print(); printf("\n");
-			printf("(Y) %1.15e : ", nodeCross.y); nodeCrossX.fy.Print(); printf("\n");
-			printf("(Z) %1.15e : ", nodeCross.z); nodeCrossX.fz.Print(); printf("\n");
-
-			printf("(X) %1.15e : ", nodeCross.x * node.x); fp0.Print(); printf("\n");
-			printf("(Y) %1.15e : ", nodeCross.y * node.y); fp1.Print(); printf("\n");
-			printf("(Z) %1.15e : ", nodeCross.z * node.z); fp2.Print(); printf("\n");
-
-			printf("%1.15e : ", dDotNorm); fpDotNorm.Print(); printf("\n");
-*/
-			if (fpDotNorm.IsNegative()) {
+			if (iSignDotNorm < 0) {
 				loc = Face::NodeLocation_Exterior;
 				ixLocation = 0;
 				return;
 			}
-			if (fpDotNorm.IsZero()) {
+			if (iSignDotNorm == 0) {
 				setContainedEdgeIx.insert(i);
 			}
 
@@ -234,20 +205,14 @@ bool MeshUtilitiesExact::CalculateEdgeIntersections(
 		nodeN21xN22.PrintMX();
 */
 		// Check for coincident lines
-		FixedPoint fpDot11 = DotProductX(nodeN21xN22, node11);
-		FixedPoint fpDot12 = DotProductX(nodeN21xN22, node12);
-		FixedPoint fpDot21 = DotProductX(nodeN11xN12, node21);
-		FixedPoint fpDot22 = DotProductX(nodeN11xN12, node22);
+		bool fp11_isZero = (SignOfTripleProduct(node21, node22, node11) == 0);
+		bool fp12_isZero = (SignOfTripleProduct(node21, node22, node12) == 0);
+		bool fp21_isZero = (SignOfTripleProduct(node11, node12, node21) == 0);
+		bool fp22_isZero = (SignOfTripleProduct(node11, node12, node22) == 0);
 
 		// A line which is coincident with both planes
 		NodeExact nodeLine;
 
-		// Determine if either fpDot1 or fpDot2 are zero
-		bool fp11_isZero = fpDot11.IsZero();
-		bool fp12_isZero = fpDot12.IsZero();
-		bool fp21_isZero = fpDot21.IsZero();
-		bool fp22_isZero = fpDot22.IsZero();
-
 /*
 		printf("B: %i %i %i %i\n",
 			fp11_isZero,
@@ -309,84 +274,86 @@ bool MeshUtilitiesExact::CalculateEdgeIntersections(
 		bool fFirstPosModeInRange = true;
 		bool fSecondPosModeInRange = true;
 
-		FixedPoint fpDenom;
-		FixedPoint fpC;
-		FixedPoint fpD;
+		int iSignDenom;
+		int iSignC;
+		int iSignD;
 
 		// Determine if nodeLine is in the fan of [node11, node12]
 		if (! nodeN11xN12.fx.IsZero()) {
-			fpDenom = nodeN11xN12.fx;
+			iSignDenom = Sign(nodeN11xN12.fx);
 
-			fpC = nodeLine.fy * node12.fz - nodeLine.fz * node12.fy;
-			fpD = nodeLine.fz * node11.fy - nodeLine.fy * node11.fz;
+			iSignC = SignOfDifferenceOfProducts(
+				nodeLine.fy, node12.fz, nodeLine.fz, node12.fy);
+			iSignD = SignOfDifferenceOfProducts(
+				nodeLine.fz, node11.fy, nodeLine.fy, node11.fz);
 
 		} else if (! nodeN11xN12.fy.IsZero()) {
-			fpDenom = nodeN11xN12.fy;
+			iSignDenom = Sign(nodeN11xN12.fy);
 
-			fpC = nodeLine.fz * node12.fx - nodeLine.fx * node12.fz;
-			fpD = nodeLine.fx * node11.fz - nodeLine.fz * node11.fx;
+			iSignC = SignOfDifferenceOfProducts(
+				nodeLine.fz, node12.fx, nodeLine.fx, node12.fz);
+			iSignD = SignOfDifferenceOfProducts(
+				nodeLine.fx, node11.fz, nodeLine.fz, node11.fx);
 
 		} else if (! nodeN11xN12.fz.IsZero()) {
-			fpDenom = nodeN11xN12.fz;
+			iSignDenom = Sign(nodeN11xN12.fz);
 
-			fpC = nodeLine.fx * node12.fy - nodeLine.fy * node12.fx;
-			fpD = nodeLine.fy * node11.fx - nodeLine.fx * node11.fy;
+			iSignC = SignOfDifferenceOfProducts(
+				nodeLine.fx, node12.fy, nodeLine.fy, node12.fx);
+			iSignD = SignOfDifferenceOfProducts(
+				nodeLine.fy, node11.fx, nodeLine.fx, node11.fy);
 
 		} else {
 			_EXCEPTIONT("Zero Cross product detected");
 		}
 
-		if (fpC.IsNegative() && fpD.IsPositive()) {
+		if ((iSignC < 0) && (iSignD > 0)) {
 			return false;
-		} else if (fpC.IsPositive() && fpD.IsNegative()) {
+		} else if ((iSignC > 0) && (iSignD < 0)) {
 			return false;
-		} else if (fpC.IsNonNegative() && fpD.IsNonNegative()) {
-			fFirstPosModeInRange = fpDenom.IsPositive();
+		} else if ((iSignC >= 0) && (iSignD >= 0)) {
+			fFirstPosModeInRange = (iSignDenom > 0);
 		} else {
-			fFirstPosModeInRange = fpDenom.IsNegative();
+			fFirstPosModeInRange = (iSignDenom < 0);
 		}
-/*
-		fpC.Print(); printf("\n");
-		fpD.Print(); printf("\n");
-		fpDenom.Print(); printf("\n");
-*/
 		// If we have reached this point then nodeLine is in the fan
 		// of [node11, node12].  Now determine if nodeLine is in the
 		// fan of [node21, node22].
 		if (! nodeN21xN22.fx.IsZero()) {
-			fpDenom = nodeN21xN22.fx;
+			iSignDenom = Sign(nodeN21xN22.fx);
 
-			fpC = nodeLine.fy * node22.fz - nodeLine.fz * node22.fy;
-			fpD = nodeLine.fz * node21.fy - nodeLine.fy * node21.fz;
+			iSignC = SignOfDifferenceOfProducts(
+				nodeLine.fy, node22.fz, nodeLine.fz, node22.fy);
+			iSignD = SignOfDifferenceOfProducts(
+				nodeLine.fz, node21.fy, nodeLine.fy, node21.fz);
 
 		} else if (! nodeN21xN22.fy.IsZero()) {
-			fpDenom = nodeN21xN22.fy;
+			iSignDenom = Sign(nodeN21xN22.fy);
 
-			fpC = nodeLine.fz * node22.fx - nodeLine.fx * node22.fz;
-			fpD = nodeLine.fx * node21.fz - nodeLine.fz * node21.fx;
+			iSignC = SignOfDifferenceOfProducts(
+				nodeLine.fz, node22.fx, nodeLine.fx, node22.fz);
+			iSignD = SignOfDifferenceOfProducts(
+				nodeLine.fx, node21.fz, nodeLine.fz, node21.fx);
 
 		} else if (! nodeN21xN22.fz.IsZero()) {
-			fpDenom = nodeN21xN22.fz;
+			iSignDenom = Sign(nodeN21xN22.fz);
 
-			fpC = nodeLine.fx * node22.fy - nodeLine.fy * node22.fx;
-			fpD = nodeLine.fy * node21.fx - nodeLine.fx * node21.fy;
+			iSignC = SignOfDifferenceOfProducts(
+				nodeLine.fx, node22.fy, nodeLine.fy, node22.fx);
+			iSignD = SignOfDifferenceOfProducts(
+				nodeLine.fy, node21.fx, nodeLine.fx, node21.fy);
 
 		} else {
 			_EXCEPTIONT("Zero Cross product detected");
 		}
-/*
-		fpC.Print(); printf("\n");
-		fpD.Print(); printf("\n");
-		fpDenom.Print(); printf("\n");
-*/
-		if (fpC.IsNegative() && fpD.IsPositive()) {
+		if ((iSignC < 0) && (iSignD > 0)) {
 			return false;
-		} else if (fpC.IsPositive() && fpD.IsNegative()) {
+		} else if ((iSignC > 0) && (iSignD < 0)) {
 			return false;
-		} else if (fpC.IsNonNegative() && fpD.IsNonNegative()) {
-			fSecondPosModeInRange = fpDenom.IsPositive();
+		} else if ((iSignC >= 0) && (iSignD >= 0)) {
+			fSecondPosModeInRange = (iSignDenom > 0);
 		} else {
-			fSecondPosModeInRange = fpDenom.IsNegative();
+			fSecondPosModeInRange = (iSignDenom < 0);
 		}
 
 		// Verify fans are not antipodal
@@ -462,7 +429,7 @@ int MeshUtilitiesExact::FindFaceNearNode(
 	NodeExact nodeBegin = mesh.nodes[ixNode];
 
 	// Get the set of faces adjacent this node
-	const std::set<int> & setNearbyFaces = mesh.revnodearray[ixNode];
+	ReverseNodeArray::FaceRange setNearbyFaces = mesh.revnodearray[ixNode];
 
 	if (setNearbyFaces.size() < 3) {
 		_EXCEPTIONT("Insufficient Faces at Corner; at least three Faces expected");
@@ -485,7 +452,7 @@ int MeshUtilitiesExact::FindFaceNearNode(
 	printf("BENorm: "); fpDotNeNb.Print(); printf("\n");
 */
 	// Loop through all faces
-	std::set<int>::const_iterator iter = setNearbyFaces.begin();
+	ReverseNodeArray::FaceRange::const_iterator iter = setNearbyFaces.begin();
 	for (; iter != setNearbyFaces.end(); iter++) {
 
 		const Face & face = mesh.faces[*iter];
@@ -574,38 +541,44 @@ int MeshUtilitiesExact::FindFaceNearNode(
 		}
 */
 		// Determine if nodeLocalE is in the fan of [nodeLocal0, nodeLocal2]
-		FixedPoint fpDenom;
-		FixedPoint fp2;
-		FixedPoint fp0;
+		int iSignDenom;
+		int iSign2;
+		int iSign0;
 		if (! nodeLocalCross.fx.IsZero()) {
-			fpDenom = nodeLocalCross.fx;
+			iSignDenom = Sign(nodeLocalCross.fx);
 
-			fp2 = nodeLocalE.fy * nodeLocal2.fz - nodeLocalE.fz * nodeLocal2.fy;
-			fp0 = nodeLocalE.fz * nodeLocal0.fy - nodeLocalE.fy * nodeLocal0.fz;
+			iSign2 = SignOfDifferenceOfProducts(
+				nodeLocalE.fy, nodeLocal2.fz, nodeLocalE.fz, nodeLocal2.fy);
+			iSign0 = SignOfDifferenceOfProducts(
+				nodeLocalE.fz, nodeLocal0.fy, nodeLocalE.fy, nodeLocal0.fz);
 
 		} else if (! nodeLocalCross.fy.IsZero()) {
-			fpDenom = nodeLocalCross.fy;
+			iSignDenom = Sign(nodeLocalCross.fy);
 
-			fp2 = nodeLocalE.fz * nodeLocal2.fx - nodeLocalE.fx * nodeLocal2.fz;
-			fp0 = nodeLocalE.fx * nodeLocal0.fz - nodeLocalE.fz * nodeLocal0.fx;
+			iSign2 = SignOfDifferenceOfProducts(
+				nodeLocalE.fz, nodeLocal2.fx, nodeLocalE.fx, nodeLocal2.fz);
+			iSign0 = SignOfDifferenceOfProducts(
+				nodeLocalE.fx, nodeLocal0.fz, nodeLocalE.fz, nodeLocal0.fx);
 
 		} else if (! nodeLocalCross.fz.IsZero()) {
-			fpDenom = nodeLocalCross.fz;
+			iSignDenom = Sign(nodeLocalCross.fz);
 
-			fp2 = nodeLocalE.fx * nodeLocal2.fy - nodeLocalE.fy * nodeLocal2.fx;
-			fp0 = nodeLocalE.fy * nodeLocal0.fx - nodeLocalE.fx * nodeLocal0.fy;
+			iSign2 = SignOfDifferenceOfProducts(
+				nodeLocalE.fx, nodeLocal2.fy, nodeLocalE.fy, nodeLocal2.fx);
+			iSign0 = SignOfDifferenceOfProducts(
+				nodeLocalE.fy, nodeLocal0.fx, nodeLocalE.fx, nodeLocal0.fy);
 
 		} else {
 			_EXCEPTIONT("Zero Cross product detected");
 		}
 
-		if (fpDenom.IsPositive()) {
-			if (fp2.IsNonNegative() && fp0.IsPositive()) {
+		if (iSignDenom > 0) {
+			if ((iSign2 >= 0) && (iSign0 > 0)) {
 				return (*iter);
 			}
 
 		} else {
-			if (fp2.IsNonPositive() && fp0.IsNegative()) {
+			if ((iSign2 <= 0) && (iSign0 < 0)) {
 				return (*iter);
 			}
 		}
@@ -704,11 +677,13 @@ int MeshUtilitiesExact::FindFaceNearNode(
 			FixedPoint fpDotNbNb = DotProductX(nodeBegin, nodeBegin);
 			FixedPoint fpDotNeNb = DotProductX(nodeEnd, nodeBegin);
 
-			FixedPoint fpAlign = fpDotNeNn * fpDotNbNb - fpDotNeNb * fpDotNbNn;
+			int iSignAlign =
+				SignOfDifferenceOfProducts(
+					fpDotNeNn, fpDotNbNb, fpDotNeNb, fpDotNbNn);
 
-			if (fpAlign.IsPositive()) {
+			if (iSignAlign > 0) {
 				return aFindFaceStruct.vecFaceIndices[0];
-			} else if (fpAlign.IsNegative()) {
+			} else if (iSignAlign < 0) {
 				return aFindFaceStruct.vecFaceIndices[1];
 			} else {
 				_EXCEPTIONT("Logic error");
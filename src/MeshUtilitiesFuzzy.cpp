@@ -56,15 +56,8 @@ int MeshUtilitiesFuzzy::FindNodeEdgeSide(
 	static const Real Tolerance = ReferenceTolerance;
 
 	if (edgetype == Edge::Type_GreatCircleArc) {
-		Real dDotNorm = DotProduct(CrossProduct(nodeBegin, nodeEnd), nodeTest);
-
-		if (dDotNorm <= - Tolerance) {
-			return (-1);
-		}
-		if (dDotNorm < Tolerance) {
-			return (0);
-		}
-		return (+1);
+		return FindNodeGreatCircleSide(
+			CrossProduct(nodeBegin, nodeEnd), nodeTest);
 
 	} else if (edgetype == Edge::Type_ConstantLatitude) {
 		Real dAlignment = (nodeBegin.x * nodeEnd.y - nodeEnd.x * nodeBegin.y);
@@ -173,8 +166,6 @@ bool MeshUtilitiesFuzzy::CalculateEdgeIntersectionsSemiClip(
 	Edge::Type typeSecond,
 	std::vector<Node> & nodeIntersections
 ) {
-	static const Real Tolerance = ReferenceTolerance;
-
 	// Make a locally modifyable version of the Nodes
 	Node node11;
 	Node node12;
@@ -201,9 +192,6 @@ bool MeshUtilitiesFuzzy::CalculateEdgeIntersectionsSemiClip(
 	}
 
 	// Check for coincident nodes
-	if (AreNodesEqual(node11, node12)) {
-		_EXCEPTIONT("Coincident nodes used to define edge");
-	}
 	if (AreNodesEqual(node21, node22)) {
 		_EXCEPTIONT("Coincident nodes used to define edge");
 	}
@@ -215,113 +203,189 @@ bool MeshUtilitiesFuzzy::CalculateEdgeIntersectionsSemiClip(
 	if ((typeFirst  == Edge::Type_GreatCircleArc) &&
 		(typeSecond == Edge::Type_GreatCircleArc)
 	) {
-		// Cross products
-		Node nodeN11xN12(CrossProduct(node11, node12));
-		Node nodeN21xN22(CrossProduct(node21, node22));
-
-		// Check for coincident lines
-		Real dDot11 = DotProduct(nodeN21xN22, node11);
-		Real dDot12 = DotProduct(nodeN21xN22, node12);
-		Real dDot21 = DotProduct(nodeN11xN12, node21);
-		Real dDot22 = DotProduct(nodeN11xN12, node22);
-/*
-		printf("%1.15e %1.15e %1.15e %1.15e\n",
-			dDot11, dDot12, dDot21, dDot22);
+		Node nodeIntersection;
+
+		int iIntersect =
+			CalculateGreatCircleIntersectionSemiClip(
+				node11,
+				node12,
+				node21,
+				node22,
+				CrossProduct(node21, node22),
+				nodeIntersection);
+
+		if (iIntersect == (-1)) {
+			return true;
+		}
+		if (iIntersect == 1) {
+			nodeIntersections.push_back(nodeIntersection);
+		}
+		return false;
 
-		printf("\n");
-		node11.Print("n11");
-		node12.Print("n12");
-		node21.Print("n21");
-		node22.Print("n22");
-*/
-		// A line which is coincident with both planes
-		Node nodeLine;
+	} else {
+		_EXCEPTIONT("Not implemented");
+	}
+}
 
-		// Coincident planes
-		if ((fabs(dDot11) < Tolerance) &&
-			(fabs(dDot21) < Tolerance)
-		) {
-			return true;
+///////////////////////////////////////////////////////////////////////////////
 
-		// node11 is coplanar with the second arc
-		} else if (fabs(dDot11) < Tolerance) {
-			nodeLine = node11;
+int MeshUtilitiesFuzzy::CalculateGreatCircleIntersectionSemiClip(
+	const Node & node11,
+	const Node & node12,
+	const Node & node21,
+	const Node & node22,
+	const Node & nodeN21xN22,
+	Node & nodeIntersection
+) {
+	static const Real Tolerance = ReferenceTolerance;
 
-		// node12 is coplanar with the second arc
-		} else if (fabs(dDot12) < Tolerance) {
-			nodeLine = node12;
+	// Check for coincident nodes
+	if (AreNodesEqual(node11, node12)) {
+		_EXCEPTIONT("Coincident nodes used to define edge");
+	}
 
-		// node21 is coplanar with the first arc
-		} else if (fabs(dDot21) < Tolerance) {
-			nodeLine = node21;
+	// Cross product
+	Node nodeN11xN12(CrossProduct(node11, node12));
 
-		// node22 is coplanar with the first arc
-		} else if (fabs(dDot22) < Tolerance) {
-			nodeLine = node22;
+	// Check for coincident lines
+	Real dDot11 = DotProduct(nodeN21xN22, node11);
+	Real dDot12 = DotProduct(nodeN21xN22, node12);
+	Real dDot21 = DotProduct(nodeN11xN12, node21);
+	Real dDot22 = DotProduct(nodeN11xN12, node22);
 
-		// Line of intersection is the cross product of cross products
-		} else {
-			nodeLine = CrossProduct(nodeN11xN12, nodeN21xN22);
+	// A line which is coincident with both planes
+	Node nodeLine;
 
-			// Verify coplanarity
-			Real dDotDebug1 = DotProduct(nodeLine, nodeN11xN12);
-			Real dDotDebug2 = DotProduct(nodeLine, nodeN21xN22);
+	// Coincident planes
+	if ((fabs(dDot11) < Tolerance) &&
+		(fabs(dDot21) < Tolerance)
+	) {
+		return (-1);
 
-			if ((fabs(dDotDebug1) > Tolerance) ||
-				(fabs(dDotDebug2) > Tolerance)
-			) {
-				printf("%1.5e %1.5e\n", dDotDebug1, dDotDebug2);
-				_EXCEPTIONT("Logic error");
-			}
-		}
+	// node11 is coplanar with the second arc
+	} else if (fabs(dDot11) < Tolerance) {
+		nodeLine = node11;
 
-		// Find the positive intersection node
-		Real dMagLine = nodeLine.Magnitude();
+	// node12 is coplanar with the second arc
+	} else if (fabs(dDot12) < Tolerance) {
+		nodeLine = node12;
 
-		nodeLine.x /= dMagLine;
-		nodeLine.y /= dMagLine;
-		nodeLine.z /= dMagLine;
+	// node21 is coplanar with the first arc
+	} else if (fabs(dDot21) < Tolerance) {
+		nodeLine = node21;
 
-		// Check whether each podal point falls within the range
-		// of the first edge
-		Real dAngle11;
-		Real dAngle12;
+	// node22 is coplanar with the first arc
+	} else if (fabs(dDot22) < Tolerance) {
+		nodeLine = node22;
 
-		Real dAngle1 = 1.0 - DotProduct(node11, node12);
-		Real dAngle2 = 1.0 - DotProduct(node21, node22);
+	// Line of intersection is the cross product of cross products
+	} else {
+		nodeLine = CrossProduct(nodeN11xN12, nodeN21xN22);
 
-		// Check positive node
-		dAngle11 = 1.0 - DotProduct(nodeLine, node11);
-		dAngle12 = 1.0 - DotProduct(nodeLine, node12);
+		// Verify coplanarity
+		Real dDotDebug1 = DotProduct(nodeLine, nodeN11xN12);
+		Real dDotDebug2 = DotProduct(nodeLine, nodeN21xN22);
 
-		if ((dAngle11 < dAngle1 + Tolerance) &&
-			(dAngle12 < dAngle1 + Tolerance)
+		if ((fabs(dDotDebug1) > Tolerance) ||
+			(fabs(dDotDebug2) > Tolerance)
 		) {
-			nodeIntersections.push_back(nodeLine);
-			return false;
+			_EXCEPTION2("Logic error: line of intersection is not coplanar "
+				"with both arcs (%1.5e %1.5e)", dDotDebug1, dDotDebug2);
 		}
+	}
 
-		// Check negative node
-		nodeLine.x *= (-1.0);
-		nodeLine.y *= (-1.0);
-		nodeLine.z *= (-1.0);
+	// Find the positive intersection node
+	Real dMagLine = nodeLine.Magnitude();
 
-		dAngle11 = 1.0 - DotProduct(nodeLine, node11);
-		dAngle12 = 1.0 - DotProduct(nodeLine, node12);
+	nodeLine.x /= dMagLine;
+	nodeLine.y /= dMagLine;
+	nodeLine.z /= dMagLine;
 
-		if ((dAngle11 < dAngle1 + Tolerance) &&
-			(dAngle12 < dAngle1 + Tolerance)
-		) {
-			nodeIntersections.push_back(nodeLine);
-			return false;
-		}
+	// Check whether each podal point falls within the range
+	// of the first edge
+	Real dAngle11;
+	Real dAngle12;
 
-		// No intersections
+	Real dAngle1 = 1.0 - DotProduct(node11, node12);
+
+	// Check positive node
+	dAngle11 = 1.0 - DotProduct(nodeLine, node11);
+	dAngle12 = 1.0 - DotProduct(nodeLine, node12);
+
+	if ((dAngle11 < dAngle1 + Tolerance) &&
+		(dAngle12 < dAngle1 + Tolerance)
+	) {
+		nodeIntersection = nodeLine;
+		return 1;
+	}
+
+	// Check negative node
+	nodeLine.x *= (-1.0);
+	nodeLine.y *= (-1.0);
+	nodeLine.z *= (-1.0);
+
+	dAngle11 = 1.0 - DotProduct(nodeLine, node11);
+	dAngle12 = 1.0 - DotProduct(nodeLine, node12);
+
+	if ((dAngle11 < dAngle1 + Tolerance) &&
+		(dAngle12 < dAngle1 + Tolerance)
+	) {
+		nodeIntersection = nodeLine;
+		return 1;
+	}
+
+	// No intersections
+	return 0;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Determine if the great circle arc [nodeBegin, nodeEnd] lies strictly
+///		on one side of the plane through the origin with normal
+///		nodePlaneNormal, where dDotBegin and dDotEnd are the dot products of
+///		the endpoints with nodePlaneNormal.  The margin accounts for the
+///		tolerance used by CalculateEdgeIntersections, which accepts lines of
+///		intersection lying up to Tolerance / |nodeArcNormal| beyond the
+///		endpoints of the arc, so that no intersection with an arc in this
+///		plane can be reported when this function returns true.
+///	</summary>
+static inline bool IsArcSeparatedFromPlane(
+	const Node & nodeBegin,
+	const Node & nodeEnd,
+	const Node & nodeArcNormal,
+	const Node & nodePlaneNormal,
+	Real dDotBegin,
+	Real dDotEnd
+) {
+	static const Real Tolerance = ReferenceTolerance;
+
+	// Endpoints must be on the same side of the plane
+	if ((dDotBegin > 0.0) != (dDotEnd > 0.0)) {
 		return false;
+	}
 
-	} else {
-		_EXCEPTIONT("Not implemented");
+	Real dMargin = fabs(dDotBegin);
+	if (fabs(dDotEnd) < dMargin) {
+		dMargin = fabs(dDotEnd);
+	}
+	dMargin -= Tolerance;
+
+	if (dMargin <= 0.0) {
+		return false;
 	}
+
+	// The bound on the overshoot beyond the endpoints requires the arc
+	// to subtend less than ninety degrees
+	if (DotProduct(nodeBegin, nodeEnd) <= Tolerance) {
+		return false;
+	}
+
+	// dMargin > 8 Tolerance |nodePlaneNormal| / |nodeArcNormal|
+	return (
+		dMargin * dMargin * DotProduct(nodeArcNormal, nodeArcNormal)
+		> 64.0 * Tolerance * Tolerance
+			* DotProduct(nodePlaneNormal, nodePlaneNormal));
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -397,6 +461,16 @@ bool MeshUtilitiesFuzzy::CalculateEdgeIntersections(
 		node21.Print("n21");
 		node22.Print("n22");
 */
+		// Neither arc can intersect the other if one of them lies strictly
+		// on one side of the plane of the other
+		if (IsArcSeparatedFromPlane(
+				node11, node12, nodeN11xN12, nodeN21xN22, dDot11, dDot12) ||
+			IsArcSeparatedFromPlane(
+				node21, node22, nodeN21xN22, nodeN11xN12, dDot21, dDot22)
+		) {
+			return false;
+		}
+
 		// A line which is coincident with both planes
 		Node nodeLine;
 
@@ -1070,6 +1144,54 @@ bool MeshUtilitiesFuzzy::CalculateEdgeIntersections(
 
 ///////////////////////////////////////////////////////////////////////////////
 
+void MeshUtilitiesFuzzy::FindEdgeIntersectionCandidates(
+	const Node & nodeBegin,
+	const Node & nodeEnd,
+	Edge::Type typeBegin,
+	const Face & face,
+	const NodeVector & nodevec,
+	std::vector<bool> & vecCandidate
+) const {
+	const int nEdges = static_cast<int>(face.edges.size());
+
+	vecCandidate.assign(nEdges, true);
+
+	if (typeBegin != Edge::Type_GreatCircleArc) {
+		return;
+	}
+
+	// The normal to the plane of the first arc is shared by all edges
+	Node nodeN11xN12(CrossProduct(nodeBegin, nodeEnd));
+
+	for (int j = 0; j < nEdges; j++) {
+		const Edge & edge = face.edges[j];
+
+		if ((edge.type != Edge::Type_GreatCircleArc) || (edge[0] == edge[1])) {
+			continue;
+		}
+
+		const Node & node21 = nodevec[edge[0]];
+		const Node & node22 = nodevec[edge[1]];
+
+		Node nodeN21xN22(CrossProduct(node21, node22));
+
+		Real dDot11 = DotProduct(nodeN21xN22, nodeBegin);
+		Real dDot12 = DotProduct(nodeN21xN22, nodeEnd);
+		Real dDot21 = DotProduct(nodeN11xN12, node21);
+		Real dDot22 = DotProduct(nodeN11xN12, node22);
+
+		if (IsArcSeparatedFromPlane(
+				nodeBegin, nodeEnd, nodeN11xN12, nodeN21xN22, dDot11, dDot12) ||
+			IsArcSeparatedFromPlane(
+				node21, node22, nodeN21xN22, nodeN11xN12, dDot21, dDot22)
+		) {
+			vecCandidate[j] = false;
+		}
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
 int MeshUtilitiesFuzzy::FindFaceNearNode(
 	const Mesh & mesh,
 	int ixNode,
@@ -1082,7 +1204,7 @@ int MeshUtilitiesFuzzy::FindFaceNearNode(
 	const Node & nodeBegin = mesh.nodes[ixNode];
 
 	// Get the set of faces adjacent this node
-	const std::set<int> & setNearbyFaces = mesh.revnodearray[ixNode];
+	ReverseNodeArray::FaceRange setNearbyFaces = mesh.revnodearray[ixNode];
 
 	if (setNearbyFaces.size() < 3) {
 		_EXCEPTIONT("Insufficient Faces at Corner; at least three Faces expected");
@@ -1103,7 +1225,7 @@ int MeshUtilitiesFuzzy::FindFaceNearNode(
 		- ScalarProduct(dDotNeNb, nodeBegin);
 */
 	// Loop through all faces
-	std::set<int>::const_iterator iter = setNearbyFaces.begin();
+	ReverseNodeArray::FaceRange::const_iterator iter = setNearbyFaces.begin();
 	for (; iter != setNearbyFaces.end(); iter++) {
 
 		const Face & face = mesh.faces[*iter];
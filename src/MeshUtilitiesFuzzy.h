@@ -62,6 +62,29 @@ public:
 		const Node & nodeTest
 	) const;
 
+	///	<summary>
+	///		Determine if a node is to the right or left of a great circle
+	///		arc with normal nodeNormal (the cross product of its endpoints),
+	///		as FindNodeEdgeSide.  Clipping against a fixed arc computes the
+	///		normal once rather than on every call.
+	///	</summary>
+	inline int FindNodeGreatCircleSide(
+		const Node & nodeNormal,
+		const Node & nodeTest
+	) const {
+		static const Real Tolerance = ReferenceTolerance;
+
+		Real dDotNorm = DotProduct(nodeNormal, nodeTest);
+
+		if (dDotNorm <= - Tolerance) {
+			return (-1);
+		}
+		if (dDotNorm < Tolerance) {
+			return (0);
+		}
+		return (+1);
+	}
+
 	///	<summary>
 	///		Determine if face contains node, and whether
 	///		the Node is along an edge or at a corner.
@@ -96,6 +119,27 @@ public:
 		std::vector<Node> & nodeIntersections
 	);
 
+	///	<summary>
+	///		Calculate the intersection of the great circle arc connecting
+	///		nodeFirstBegin and nodeFirstEnd with the great circle arc
+	///		connecting nodeSecondBegin and nodeSecondEnd, whose normal
+	///		nodeSecondNormal has already been computed, as
+	///		CalculateEdgeIntersectionsSemiClip.  The caller is responsible
+	///		for verifying that the nodes of the second arc are distinct.
+	///	</summary>
+	///	<returns>
+	///		-1 if the arcs are coincident, 0 if they do not intersect and
+	///		1 if they intersect at nodeIntersection.
+	///	</returns>
+	int CalculateGreatCircleIntersectionSemiClip(
+		const Node & nodeFirstBegin,
+		const Node & nodeFirstEnd,
+		const Node & nodeSecondBegin,
+		const Node & nodeSecondEnd,
+		const Node & nodeSecondNormal,
+		Node & nodeIntersection
+	);
+
 	///	<summary>
 	///		Calculate all intersections between the Edge connecting
 	///		nodeFirstBegin and nodeFirstEnd with type typeFirst and the Edge
@@ -119,6 +163,22 @@ public:
 		bool fIncludeFirstBeginNode = false
 	);
 
+	///	<summary>
+	///		Flag the edges of face which may intersect the edge connecting
+	///		nodeBegin and nodeEnd with type typeBegin.  Pairs of great circle
+	///		arcs are rejected when both endpoints of one arc lie on the same
+	///		side of the plane of the other arc, by a margin for which
+	///		CalculateEdgeIntersections cannot report an intersection.
+	///	</summary>
+	void FindEdgeIntersectionCandidates(
+		const Node & nodeBegin,
+		const Node & nodeEnd,
+		Edge::Type typeBegin,
+		const Face & face,
+		const NodeVector & nodevec,
+		std::vector<bool> & vecCandidate
+	) const;
+
 	///	<summary>
 	///		Find the Face that is near ixNode in the direction of nodeEnd.
 	///	</summary>
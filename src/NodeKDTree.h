@@ -0,0 +1,465 @@
+///////////////////////////////////////////////////////////////////////////////
+///
+///	\file    NodeKDTree.h
+///	\author  agent
+///	\version October 14, 2026
+///
+///	<remarks>
+///		Copyright 2026 agent
+///
+///		This file is distributed as part of the Tempest source code package.
+///		Permission is granted to use, copy, modify and distribute this
+///		source code and its documentation under the terms of the GNU General
+///		Public License.  This software is provided "as is" without express
+///		or implied warranty.
+///	</remarks>
+
+#ifndef _NODEKDTREE_H_
+#define _NODEKDTREE_H_
+
+#include "GridElements.h"
+#include "Exception.h"
+
+#include <vector>
+#include <algorithm>
+#include <limits>
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		A static three-dimensional kd-tree over Nodes, each carrying a
+///		value of type DataType.  The tree is bulk built by median splits
+///		along the axis of largest extent and stored implicitly in a single
+///		contiguous array: the entries of the subtree over [ixBegin, ixEnd)
+///		have their splitting entry at the midpoint of the range.  Queries
+///		allocate nothing on the heap beyond the caller's output vectors.
+///	</summary>
+template <typename DataType = int>
+class NodeKDTree {
+
+public:
+	///	<summary>
+	///		Default constructor.
+	///	</summary>
+	NodeKDTree()
+	{ }
+
+	///	<summary>
+	///		Constructor that builds the tree over nodes, with the index of
+	///		each Node as its value.
+	///	</summary>
+	NodeKDTree(
+		const NodeVector & vecNodes
+	) {
+		Build(vecNodes);
+	}
+
+public:
+	///	<summary>
+	///		Build the tree over vecNodes, with the index of each Node as its
+	///		value.  Only valid when DataType can be constructed from int.
+	///	</summary>
+	void Build(
+		const NodeVector & vecNodes
+	) {
+		std::vector<DataType> vecData(vecNodes.size());
+		for (int i = 0; i < vecNodes.size(); i++) {
+			vecData[i] = DataType(i);
+		}
+		Build(vecNodes, vecData);
+	}
+
+	///	<summary>
+	///		Build the tree over vecNodes with associated values vecData.
+	///	</summary>
+	void Build(
+		const NodeVector & vecNodes,
+		const std::vector<DataType> & vecData
+	) {
+		if (vecNodes.size() != vecData.size()) {
+			_EXCEPTIONT("Node and data vectors must have the same length");
+		}
+
+		m_vecEntries.resize(vecNodes.size());
+		for (int i = 0; i < vecNodes.size(); i++) {
+			m_vecEntries[i].node = vecNodes[i];
+			m_vecEntries[i].data = vecData[i];
+			m_vecEntries[i].iAxis = 0;
+		}
+
+		BuildRange(0, static_cast<int>(m_vecEntries.size()));
+	}
+
+	///	<summary>
+	///		Clear the contents of the tree.
+	///	</summary>
+	void Clear() {
+		m_vecEntries.clear();
+	}
+
+	///	<summary>
+	///		Get the number of Nodes in the tree.
+	///	</summary>
+	int GetSize() const {
+		return static_cast<int>(m_vecEntries.size());
+	}
+
+public:
+	///	<summary>
+	///		Find the Node nearest to node.  Returns false if the tree is
+	///		empty.  The squared distance is returned if pdDistSq is not NULL.
+	///	</summary>
+	bool FindNearest(
+		const Node & node,
+		DataType & data,
+		Real * pdDistSq = NULL
+	) const {
+		if (m_vecEntries.size() == 0) {
+			return false;
+		}
+
+		int ixBest = (-1);
+		Real dBestDistSq = std::numeric_limits<Real>::max();
+
+		NearestRange(
+			0, static_cast<int>(m_vecEntries.size()),
+			node, ixBest, dBestDistSq);
+
+		data = m_vecEntries[ixBest].data;
+		if (pdDistSq != NULL) {
+			(*pdDistSq) = dBestDistSq;
+		}
+		return true;
+	}
+
+	///	<summary>
+	///		Find the (up to) nK Nodes nearest to node, ordered by increasing
+	///		distance.  Squared distances are returned if pvecDistSq is not
+	///		NULL.
+	///	</summary>
+	void FindKNearest(
+		const Node & node,
+		int nK,
+		std::vector<DataType> & vecData,
+		std::vector<Real> * pvecDistSq = NULL
+	) const {
+		vecData.clear();
+		if (pvecDistSq != NULL) {
+			pvecDistSq->clear();
+		}
+		if ((nK < 1) || (m_vecEntries.size() == 0)) {
+			return;
+		}
+
+		// Max-heap of (squared distance, entry index) of the best entries
+		std::vector< std::pair<Real, int> > vecHeap;
+		vecHeap.reserve(nK);
+
+		KNearestRange(
+			0, static_cast<int>(m_vecEntries.size()),
+			node, nK, vecHeap);
+
+		std::sort_heap(vecHeap.begin(), vecHeap.end());
+
+		vecData.resize(vecHeap.size());
+		for (int i = 0; i < vecHeap.size(); i++) {
+			vecData[i] = m_vecEntries[vecHeap[i].second].data;
+		}
+		if (pvecDistSq != NULL) {
+			pvecDistSq->resize(vecHeap.size());
+			for (int i = 0; i < vecHeap.size(); i++) {
+				(*pvecDistSq)[i] = vecHeap[i].first;
+			}
+		}
+	}
+
+	///	<summary>
+	///		Find all Nodes within (Cartesian) distance dRadius of node.
+	///		Values are returned in no particular order.
+	///	</summary>
+	void FindInRadius(
+		const Node & node,
+		Real dRadius,
+		std::vector<DataType> & vecData
+	) const {
+		vecData.clear();
+		if (m_vecEntries.size() == 0) {
+			return;
+		}
+
+		RadiusRange(
+			0, static_cast<int>(m_vecEntries.size()),
+			node, dRadius * dRadius, vecData);
+	}
+
+	///	<summary>
+	///		Find the Node nearest to each Node of vecQuery.  Queries are
+	///		processed in parallel when nThreads is greater than one.
+	///	</summary>
+	void FindNearest(
+		const NodeVector & vecQuery,
+		std::vector<DataType> & vecData,
+		int nThreads = 1
+	) const {
+		if (nThreads < 1) {
+			_EXCEPTIONT("Thread count must be at least 1");
+		}
+		if (m_vecEntries.size() == 0) {
+			_EXCEPTIONT("Nearest Node query on empty NodeKDTree");
+		}
+
+		const int nQuery = static_cast<int>(vecQuery.size());
+
+		vecData.resize(nQuery);
+
+#pragma omp parallel for schedule(static) num_threads(nThreads)
+		for (int i = 0; i < nQuery; i++) {
+			int ixBest = (-1);
+			Real dBestDistSq = std::numeric_limits<Real>::max();
+
+			NearestRange(
+				0, static_cast<int>(m_vecEntries.size()),
+				vecQuery[i], ixBest, dBestDistSq);
+
+			vecData[i] = m_vecEntries[ixBest].data;
+		}
+	}
+
+protected:
+	///	<summary>
+	///		Squared distance between two Nodes.
+	///	</summary>
+	static Real DistSq(
+		const Node & node0,
+		const Node & node1
+	) {
+		Real dx = node0.x - node1.x;
+		Real dy = node0.y - node1.y;
+		Real dz = node0.z - node1.z;
+		return (dx * dx + dy * dy + dz * dz);
+	}
+
+	///	<summary>
+	///		Coordinate of node along the given axis.
+	///	</summary>
+	static Real Coord(
+		const Node & node,
+		int iAxis
+	) {
+		if (iAxis == 0) {
+			return node.x;
+		} else if (iAxis == 1) {
+			return node.y;
+		}
+		return node.z;
+	}
+
+	///	<summary>
+	///		An entry of the tree.
+	///	</summary>
+	struct Entry {
+		Node node;
+		DataType data;
+		int iAxis;
+	};
+
+	///	<summary>
+	///		Comparator ordering entries along one axis.
+	///	</summary>
+	class EntryAxisComparator {
+	public:
+		EntryAxisComparator(int iAxis) : m_iAxis(iAxis) { }
+
+		bool operator()(const Entry & a, const Entry & b) const {
+			return (Coord(a.node, m_iAxis) < Coord(b.node, m_iAxis));
+		}
+
+	protected:
+		int m_iAxis;
+	};
+
+	///	<summary>
+	///		Recursively arrange m_vecEntries[ixBegin, ixEnd) into a subtree.
+	///	</summary>
+	void BuildRange(
+		int ixBegin,
+		int ixEnd
+	) {
+		if (ixEnd - ixBegin <= 1) {
+			return;
+		}
+
+		// Axis of largest extent
+		Node nodeMin = m_vecEntries[ixBegin].node;
+		Node nodeMax = nodeMin;
+		for (int i = ixBegin + 1; i < ixEnd; i++) {
+			const Node & node = m_vecEntries[i].node;
+			nodeMin.x = std::min(nodeMin.x, node.x);
+			nodeMin.y = std::min(nodeMin.y, node.y);
+			nodeMin.z = std::min(nodeMin.z, node.z);
+			nodeMax.x = std::max(nodeMax.x, node.x);
+			nodeMax.y = std::max(nodeMax.y, node.y);
+			nodeMax.z = std::max(nodeMax.z, node.z);
+		}
+
+		Node nodeExtent = nodeMax - nodeMin;
+
+		int iAxis = 0;
+		if ((nodeExtent.y >= nodeExtent.x) && (nodeExtent.y >= nodeExtent.z)) {
+			iAxis = 1;
+		} else if ((nodeExtent.z >= nodeExtent.x) && (nodeExtent.z >= nodeExtent.y)) {
+			iAxis = 2;
+		}
+
+		int ixMid = ixBegin + (ixEnd - ixBegin) / 2;
+
+		std::nth_element(
+			m_vecEntries.begin() + ixBegin,
+			m_vecEntries.begin() + ixMid,
+			m_vecEntries.begin() + ixEnd,
+			EntryAxisComparator(iAxis));
+
+		m_vecEntries[ixMid].iAxis = iAxis;
+
+		BuildRange(ixBegin, ixMid);
+		BuildRange(ixMid + 1, ixEnd);
+	}
+
+	///	<summary>
+	///		Nearest neighbor search over the subtree [ixBegin, ixEnd).
+	///	</summary>
+	void NearestRange(
+		int ixBegin,
+		int ixEnd,
+		const Node & node,
+		int & ixBest,
+		Real & dBestDistSq
+	) const {
+		if (ixBegin >= ixEnd) {
+			return;
+		}
+
+		int ixMid = ixBegin + (ixEnd - ixBegin) / 2;
+		const Entry & entry = m_vecEntries[ixMid];
+
+		Real dDistSq = DistSq(node, entry.node);
+		if (dDistSq < dBestDistSq) {
+			dBestDistSq = dDistSq;
+			ixBest = ixMid;
+		}
+
+		if (ixEnd - ixBegin == 1) {
+			return;
+		}
+
+		Real dDelta = Coord(node, entry.iAxis) - Coord(entry.node, entry.iAxis);
+
+		if (dDelta < 0.0) {
+			NearestRange(ixBegin, ixMid, node, ixBest, dBestDistSq);
+			if (dDelta * dDelta < dBestDistSq) {
+				NearestRange(ixMid + 1, ixEnd, node, ixBest, dBestDistSq);
+			}
+		} else {
+			NearestRange(ixMid + 1, ixEnd, node, ixBest, dBestDistSq);
+			if (dDelta * dDelta < dBestDistSq) {
+				NearestRange(ixBegin, ixMid, node, ixBest, dBestDistSq);
+			}
+		}
+	}
+
+	///	<summary>
+	///		k-nearest neighbor search over the subtree [ixBegin, ixEnd).
+	///	</summary>
+	void KNearestRange(
+		int ixBegin,
+		int ixEnd,
+		const Node & node,
+		int nK,
+		std::vector< std::pair<Real, int> > & vecHeap
+	) const {
+		if (ixBegin >= ixEnd) {
+			return;
+		}
+
+		int ixMid = ixBegin + (ixEnd - ixBegin) / 2;
+		const Entry & entry = m_vecEntries[ixMid];
+
+		Real dDistSq = DistSq(node, entry.node);
+		if (static_cast<int>(vecHeap.size()) < nK) {
+			vecHeap.push_back(std::pair<Real, int>(dDistSq, ixMid));
+			std::push_heap(vecHeap.begin(), vecHeap.end());
+
+		} else if (dDistSq < vecHeap.front().first) {
+			std::pop_heap(vecHeap.begin(), vecHeap.end());
+			vecHeap.back() = std::pair<Real, int>(dDistSq, ixMid);
+			std::push_heap(vecHeap.begin(), vecHeap.end());
+		}
+
+		if (ixEnd - ixBegin == 1) {
+			return;
+		}
+
+		Real dDelta = Coord(node, entry.iAxis) - Coord(entry.node, entry.iAxis);
+
+		int ixNearBegin = ixBegin;
+		int ixNearEnd = ixMid;
+		int ixFarBegin = ixMid + 1;
+		int ixFarEnd = ixEnd;
+		if (dDelta >= 0.0) {
+			std::swap(ixNearBegin, ixFarBegin);
+			std::swap(ixNearEnd, ixFarEnd);
+		}
+
+		KNearestRange(ixNearBegin, ixNearEnd, node, nK, vecHeap);
+
+		if ((static_cast<int>(vecHeap.size()) < nK) || (dDelta * dDelta < vecHeap.front().first)) {
+			KNearestRange(ixFarBegin, ixFarEnd, node, nK, vecHeap);
+		}
+	}
+
+	///	<summary>
+	///		Radius search over the subtree [ixBegin, ixEnd).
+	///	</summary>
+	void RadiusRange(
+		int ixBegin,
+		int ixEnd,
+		const Node & node,
+		Real dRadiusSq,
+		std::vector<DataType> & vecData
+	) const {
+		if (ixBegin >= ixEnd) {
+			return;
+		}
+
+		int ixMid = ixBegin + (ixEnd - ixBegin) / 2;
+		const Entry & entry = m_vecEntries[ixMid];
+
+		if (DistSq(node, entry.node) <= dRadiusSq) {
+			vecData.push_back(entry.data);
+		}
+
+		if (ixEnd - ixBegin == 1) {
+			return;
+		}
+
+		Real dDelta = Coord(node, entry.iAxis) - Coord(entry.node, entry.iAxis);
+
+		if ((dDelta <= 0.0) || (dDelta * dDelta <= dRadiusSq)) {
+			RadiusRange(ixBegin, ixMid, node, dRadiusSq, vecData);
+		}
+		if ((dDelta >= 0.0) || (dDelta * dDelta <= dRadiusSq)) {
+			RadiusRange(ixMid + 1, ixEnd, node, dRadiusSq, vecData);
+		}
+	}
+
+protected:
+	///	<summary>
+	///		Entries of the tree in implicit tree order.
+	///	</summary>
+	std::vector<Entry> m_vecEntries;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+#endif
+
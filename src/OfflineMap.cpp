@@ -15,6 +15,7 @@
 ///	</remarks>
 
 #include "OfflineMap.h"
+#include "OfflineMapCache.h"
 
 #include "netcdfcpp.h"
 #include "NetCDFUtilities.h"
@@ -27,12 +28,24 @@
 #include "DataArray2D.h"
 
 #include <cmath>
+#include <cstring>
+#include <algorithm>
+#include <limits>
+#include <set>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
 
 ///////////////////////////////////////////////////////////////////////////////
 
 void OfflineMap::InitializeSourceDimensionsFromFile(
 	const std::string & strSourceMesh
 ) {
+	m_strSourceCoordinateFile = "";
+
+	m_nSourceGridOffset = 0;
+	m_nSourceGridFullSize = 0;
+
 	// Open the source mesh
 	NcFile ncSourceMesh(strSourceMesh.c_str(), NcFile::ReadOnly);
 	if (!ncSourceMesh.is_valid()) {
@@ -187,6 +200,9 @@ void OfflineMap::InitializeSourceDimensions(
   const std::vector<std::string>& p_srcDimNames,
   const std::vector<int>& p_srcDimSizes
 ) {
+  m_nSourceGridOffset = 0;
+  m_nSourceGridFullSize = 0;
+
   m_vecSourceDimNames.clear();
   m_vecSourceDimNames.resize(p_srcDimNames.size());
   std::copy(p_srcDimNames.begin(), p_srcDimNames.end(), m_vecSourceDimNames.begin());
@@ -203,6 +219,8 @@ void OfflineMap::InitializeSourceDimensions(
 void OfflineMap::InitializeTargetDimensionsFromFile(
 	const std::string & strTargetMesh
 ) {
+	m_strTargetCoordinateFile = "";
+
 	// Open the source mesh
 	NcFile ncTargetMesh(strTargetMesh.c_str(), NcFile::ReadOnly);
 	if (!ncTargetMesh.is_valid()) {
@@ -373,6 +391,14 @@ void OfflineMap::InitializeTargetDimensions(
 
 ///////////////////////////////////////////////////////////////////////////////
 
+///	<summary>
+///		Number of Faces or finite element nodes whose coordinates are
+///		converted together by one thread.
+///	</summary>
+static const int CoordinateBlockSize = 1024;
+
+///////////////////////////////////////////////////////////////////////////////
+
 void OfflineMap::InitializeCoordinatesFromMeshFV(
 	const Mesh & mesh,
 	DataArray1D<double> & dCenterLon,
@@ -406,77 +432,128 @@ void OfflineMap::InitializeCoordinatesFromMeshFV(
 	dCenterLon.Allocate(nFaces);
 	dCenterLat.Allocate(nFaces);
 
-	// Store coordinates of each Node and Face centerpoint
-	for (int i = 0; i < nFaces; i++) {
+	// Store coordinates of each Node and Face centerpoint, converting
+	// blocks of Faces at once
+	const int nBlocks =
+		(nFaces + CoordinateBlockSize - 1) / CoordinateBlockSize;
+
+	bool fError = false;
+
+#pragma omp parallel for schedule(dynamic) num_threads(m_nThreads)
+	for (int b = 0; b < nBlocks; b++) {
+		const int iBegin = b * CoordinateBlockSize;
+		const int iEnd = std::min(iBegin + CoordinateBlockSize, nFaces);
+		const int nBlockFaces = iEnd - iBegin;
+
+		// Vertices of each Face in the layout of dVertexLon, followed by
+		// the centerpoint of each Face
+		const int nVertices = nBlockFaces * nNodesPerFace;
+
+		std::vector<double> dX(nVertices + nBlockFaces);
+		std::vector<double> dY(nVertices + nBlockFaces);
+		std::vector<double> dZ(nVertices + nBlockFaces);
+
+		for (int i = iBegin; i < iEnd; i++) {
+
+			const Face & face = mesh.faces[i];
+
+			int nNodes = face.edges.size();
+
+			const int ixVertex = (i - iBegin) * nNodesPerFace;
 
-		const Face & face = mesh.faces[i];
+			double dXc = 0.0;
+			double dYc = 0.0;
+			double dZc = 0.0;
 
-		int nNodes = face.edges.size();
+			for (int j = 0; j < nNodes; j++) {
+				const Node & node = mesh.nodes[face[j]];
 
-		double dXc = 0.0;
-		double dYc = 0.0;
-		double dZc = 0.0;
+				dX[ixVertex + j] = node.x;
+				dY[ixVertex + j] = node.y;
+				dZ[ixVertex + j] = node.z;
 
-		for (int j = 0; j < nNodes; j++) {
-			const Node & node = mesh.nodes[face[j]];
+				dXc += node.x;
+				dYc += node.y;
+				dZc += node.z;
+			}
+
+			// Unused vertices are converted at the north pole and reset
+			for (int j = nNodes; j < nNodesPerFace; j++) {
+				dX[ixVertex + j] = 0.0;
+				dY[ixVertex + j] = 0.0;
+				dZ[ixVertex + j] = 1.0;
+			}
 
-			double dX = node.x;
-			double dY = node.y;
-			double dZ = node.z;
+			dXc /= static_cast<double>(nNodes);
+			dYc /= static_cast<double>(nNodes);
+			dZc /= static_cast<double>(nNodes);
 
-			dXc += dX;
-			dYc += dY;
-			dZc += dZ;
+			double dMag = sqrt(dXc * dXc + dYc * dYc + dZc * dZc);
 
-			XYZtoRLL_Deg(
-				dX, dY, dZ,
-				dVertexLon[i][j],
-				dVertexLat[i][j]);
+			dX[nVertices + i - iBegin] = dXc / dMag;
+			dY[nVertices + i - iBegin] = dYc / dMag;
+			dZ[nVertices + i - iBegin] = dZc / dMag;
 		}
 
-		if ((fLatLon) && (nNodes == 3)) {
-			dVertexLon[i][3] = dVertexLon[i][0];
-			dVertexLat[i][3] = dVertexLat[i][0];
+		if (nVertices != 0) {
+			XYZtoRLL_Deg_Batch(
+				nVertices,
+				&(dX[0]),
+				&(dY[0]),
+				&(dZ[0]),
+				dVertexLon(iBegin),
+				dVertexLat(iBegin));
 		}
 
-		dXc /= static_cast<double>(nNodes);
-		dYc /= static_cast<double>(nNodes);
-		dZc /= static_cast<double>(nNodes);
+		XYZtoRLL_Deg_Batch(
+			nBlockFaces,
+			&(dX[nVertices]),
+			&(dY[nVertices]),
+			&(dZ[nVertices]),
+			&(dCenterLon[iBegin]),
+			&(dCenterLat[iBegin]));
+
+		for (int i = iBegin; i < iEnd; i++) {
 
-		double dMag = sqrt(dXc * dXc + dYc * dYc + dZc * dZc);
+			int nNodes = mesh.faces[i].edges.size();
 
-		dXc /= dMag;
-		dYc /= dMag;
-		dZc /= dMag;
+			for (int j = nNodes; j < nNodesPerFace; j++) {
+				dVertexLon[i][j] = 0.0;
+				dVertexLat[i][j] = 0.0;
+			}
 
-		XYZtoRLL_Deg(
-			dXc,
-			dYc,
-			dZc,
-			dCenterLon[i],
-			dCenterLat[i]);
+			if ((fLatLon) && (nNodes == 3)) {
+				dVertexLon[i][3] = dVertexLon[i][0];
+				dVertexLat[i][3] = dVertexLat[i][0];
+			}
 
-		// Modify vertex coordinates of polar volumes on latlon grid
-		if (fLatLon) {
+			// Modify vertex coordinates of polar volumes on latlon grid
+			if (fLatLon) {
 
-			// Change longitudes of polar volumes
-			int nNodesMod = dVertexLat.GetColumns();
-			for (int j = 0; j < nNodesMod; j++) {
-				if (fabs(fabs(dVertexLat[i][j]) - 90.0) < 1.0e-12) {
-					int jn = (j + 1) % nNodesMod;
-					int jp = (j + nNodesMod - 1) % nNodesMod;
+				// Change longitudes of polar volumes
+				int nNodesMod = dVertexLat.GetColumns();
+				for (int j = 0; j < nNodesMod; j++) {
+					if (fabs(fabs(dVertexLat[i][j]) - 90.0) < 1.0e-12) {
+						int jn = (j + 1) % nNodesMod;
+						int jp = (j + nNodesMod - 1) % nNodesMod;
 
-					if (fabs(fabs(dVertexLat[i][jn]) - 90.0) > 1.0e-12) {
-						dVertexLon[i][j] = dVertexLon[i][jn];
-					} else if (fabs(fabs(dVertexLat[i][jp]) - 90.0) > 1.0e-12) {
-						dVertexLon[i][j] = dVertexLon[i][jp];
-					} else {
-						_EXCEPTIONT("Logic error");
+						if (fabs(fabs(dVertexLat[i][jn]) - 90.0) > 1.0e-12) {
+							dVertexLon[i][j] = dVertexLon[i][jn];
+						} else if (fabs(fabs(dVertexLat[i][jp]) - 90.0) > 1.0e-12) {
+							dVertexLon[i][j] = dVertexLon[i][jp];
+						} else {
+#pragma omp atomic write
+							fError = true;
+						}
 					}
 				}
 			}
 		}
 	}
+
+	if (fError) {
+		_EXCEPTIONT("Logic error");
+	}
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -517,30 +594,80 @@ void OfflineMap::InitializeCoordinatesFromMeshFE(
 	DataArray1D<double> dG;
 	GetDefaultNodalLocations(nP, dG);
 
+	// Each node shared between elements takes its location from the last
+	// element and GLL point referencing it, in the order of the loops
+	// below, so that the result does not depend on the thread count
+	std::vector<int> vecNodeFace(iMaxNodeIx, -1);
+	std::vector<int> vecNodeGLL(iMaxNodeIx, 0);
+
 	for (int i = 0; i < dataGLLnodes.GetRows(); i++) {
 	for (int j = 0; j < dataGLLnodes.GetColumns(); j++) {
 	for (int k = 0; k < dataGLLnodes.GetSubColumns(); k++) {
-		const Face & face = mesh.faces[k];
-
-		Node node;
-
-		ApplyLocalMap(
-			face,
-			mesh.nodes,
-			dG[j],
-			dG[i],
-			node);
-
 		int iNode = dataGLLnodes[i][j][k] - 1;
 
-		XYZtoRLL_Deg(
-			node.x,
-			node.y,
-			node.z,
-			dCenterLon[iNode],
-			dCenterLat[iNode]);
+		vecNodeFace[iNode] = k;
+		vecNodeGLL[iNode] = i * dataGLLnodes.GetColumns() + j;
+	}
 	}
 	}
+
+	// Convert blocks of nodes at once
+	const int nBlocks =
+		(iMaxNodeIx + CoordinateBlockSize - 1) / CoordinateBlockSize;
+
+	const int nGLLColumns = dataGLLnodes.GetColumns();
+
+#pragma omp parallel for schedule(dynamic) num_threads(m_nThreads)
+	for (int b = 0; b < nBlocks; b++) {
+		const int iBegin = b * CoordinateBlockSize;
+		const int iEnd = std::min(iBegin + CoordinateBlockSize, iMaxNodeIx);
+		const int nBlockNodes = iEnd - iBegin;
+
+		std::vector<double> dX(nBlockNodes);
+		std::vector<double> dY(nBlockNodes);
+		std::vector<double> dZ(nBlockNodes);
+
+		for (int iNode = iBegin; iNode < iEnd; iNode++) {
+
+			// Nodes referenced by no element are left at zero
+			if (vecNodeFace[iNode] == (-1)) {
+				dX[iNode - iBegin] = 0.0;
+				dY[iNode - iBegin] = 0.0;
+				dZ[iNode - iBegin] = 1.0;
+				continue;
+			}
+
+			const int i = vecNodeGLL[iNode] / nGLLColumns;
+			const int j = vecNodeGLL[iNode] % nGLLColumns;
+
+			Node node;
+
+			ApplyLocalMap(
+				mesh.faces[vecNodeFace[iNode]],
+				mesh.nodes,
+				dG[j],
+				dG[i],
+				node);
+
+			dX[iNode - iBegin] = node.x;
+			dY[iNode - iBegin] = node.y;
+			dZ[iNode - iBegin] = node.z;
+		}
+
+		XYZtoRLL_Deg_Batch(
+			nBlockNodes,
+			&(dX[0]),
+			&(dY[0]),
+			&(dZ[0]),
+			&(dCenterLon[iBegin]),
+			&(dCenterLat[iBegin]));
+
+		for (int iNode = iBegin; iNode < iEnd; iNode++) {
+			if (vecNodeFace[iNode] == (-1)) {
+				dCenterLon[iNode] = 0.0;
+				dCenterLat[iNode] = 0.0;
+			}
+		}
 	}
 }
 
@@ -703,6 +830,8 @@ void OfflineMap::InitializeRectilinearCoordinateVector(
 void OfflineMap::InitializeSourceCoordinatesFromMeshFV(
 	const Mesh & meshSource
 ) {
+	RequireSourceCoordinates();
+
 	// Check if these arrays have been read from file
 	if ((m_dSourceVertexLon.IsAttached()) ||
 		(m_dSourceVertexLat.IsAttached()) ||
@@ -784,6 +913,8 @@ void OfflineMap::InitializeSourceCoordinatesFromMeshFV(
 void OfflineMap::InitializeTargetCoordinatesFromMeshFV(
 	const Mesh & meshTarget
 ) {
+	RequireTargetCoordinates();
+
 	// Check if these arrays have been read from file
 	if ((m_dTargetVertexLon.IsAttached()) ||
 		(m_dTargetVertexLat.IsAttached()) ||
@@ -900,6 +1031,8 @@ void OfflineMap::InitializeSourceCoordinatesFromMeshFE(
 	int nP,
 	const DataArray3D<int> & dataGLLnodesSource
 ) {
+	m_strSourceCoordinateFile = "";
+
 	InitializeCoordinatesFromMeshFE(
 		meshSource,
 		nP,
@@ -917,6 +1050,8 @@ void OfflineMap::InitializeTargetCoordinatesFromMeshFE(
 	int nP,
 	const DataArray3D<int> & dataGLLnodesTarget
 ) {
+	m_strTargetCoordinateFile = "";
+
 	InitializeCoordinatesFromMeshFE(
 		meshTarget,
 		nP,
@@ -1032,7 +1167,7 @@ void OfflineMap::PreserveAllVariables(
 				NcDim * dimA = var->get_dim(var->num_dims()-2);
 				NcDim * dimB = var->get_dim(var->num_dims()-1);
 
-				if (dimA->size() == m_vecSourceDimSizes[0]) {
+				if (dimA->size() == GetSourceGridFullSize()) {
 					continue;
 				}
 				if (dimB->size() == m_vecSourceDimSizes[1]) {
@@ -1047,7 +1182,7 @@ void OfflineMap::PreserveAllVariables(
 			}
 
 		} else {
-			int nSourceCount = m_dSourceAreas.GetRows();
+			int nSourceCount = GetSourceGridFullSize();
 
 			if (var->num_dims() >= 1) {
 				NcDim * dim = var->get_dim(var->num_dims()-1);
@@ -1073,15 +1208,584 @@ void OfflineMap::PreserveAllVariables(
 
 ///////////////////////////////////////////////////////////////////////////////
 
+///	<summary>
+///		Compute the area-weighted mass and the extrema of a data slice,
+///		accumulating in double precision.
+///	</summary>
+template <typename T>
+static void ComputeSliceStatistics(
+	const T * data,
+	const DataArray1D<double> & dAreas,
+	int nCount,
+	double & dMass,
+	double & dMin,
+	double & dMax
+) {
+	dMass = 0.0;
+	dMin = static_cast<double>(data[0]);
+	dMax = static_cast<double>(data[0]);
+	for (int i = 0; i < nCount; i++) {
+		const double dValue = static_cast<double>(data[i]);
+
+		dMass += dValue * dAreas[i];
+		if (dValue < dMin) {
+			dMin = dValue;
+		}
+		if (dValue > dMax) {
+			dMax = dValue;
+		}
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		A block of consecutive data slices of one variable in Apply().
+///	</summary>
+struct OfflineMapSliceBlock {
+
+	///	<summary>
+	///		Allocate the buffers for the types of the source and target
+	///		variables (one slice per row) and the per-slice diagnostics.
+	///	</summary>
+	void Allocate(
+		int nBatchSize,
+		int nSourceSliceSize,
+		int nTargetSliceSize,
+		bool fSourceDouble,
+		bool fTargetDouble
+	) {
+		if (fSourceDouble) {
+			dataInDouble.Allocate(nBatchSize, nSourceSliceSize);
+		} else {
+			dataIn.Allocate(nBatchSize, nSourceSliceSize);
+		}
+
+		// Output slices are first touched by the threads that remap them
+		if (fTargetDouble) {
+			dataOutDouble.Allocate(nBatchSize, nTargetSliceSize, false);
+		} else {
+			dataOut.Allocate(nBatchSize, nTargetSliceSize, false);
+		}
+
+		dSourceMass.Allocate(nBatchSize);
+		dSourceMin.Allocate(nBatchSize);
+		dSourceMax.Allocate(nBatchSize);
+		dTargetMass.Allocate(nBatchSize);
+		dTargetMin.Allocate(nBatchSize);
+		dTargetMax.Allocate(nBatchSize);
+	}
+
+	///	<summary>
+	///		Set the slices of the block to those of block iBlock of a
+	///		variable with nTotal slices.
+	///	</summary>
+	void SetRange(
+		int iBlock,
+		int nBatchSize,
+		int nTotal
+	) {
+		tBegin = iBlock * nBatchSize;
+		nBatch = std::min(nBatchSize, nTotal - tBegin);
+	}
+
+	///	<summary>
+	///		Index of the first slice and number of slices in the block.
+	///	</summary>
+	int tBegin;
+	int nBatch;
+
+	///	<summary>
+	///		Source and target data (only the buffers of the variable's
+	///		types are allocated).
+	///	</summary>
+	DataArray2D<float> dataIn;
+	DataArray2D<float> dataOut;
+	DataArray2D<double> dataInDouble;
+	DataArray2D<double> dataOutDouble;
+
+	///	<summary>
+	///		Per-slice diagnostics.
+	///	</summary>
+	DataArray1D<double> dSourceMass;
+	DataArray1D<double> dSourceMin;
+	DataArray1D<double> dSourceMax;
+	DataArray1D<double> dTargetMass;
+	DataArray1D<double> dTargetMin;
+	DataArray1D<double> dTargetMax;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		NetCDF reads and writes of blocks of slices of one variable in
+///		Apply().  All methods must be called from the same thread.
+///	</summary>
+class OfflineMapSliceIO {
+
+public:
+	///	<summary>
+	///		Constructor.  Slices are read from index lSourceOffset of the
+	///		first source grid dimension of var.
+	///	</summary>
+	OfflineMapSliceIO(
+		NcVar * var,
+		NcVar * varOut,
+		const DataArray1D<long> & vecDimSizes,
+		DataArray1D<long> & nCountsIn,
+		DataArray1D<long> & nCountsOut,
+		DataArray1D<long> & nGet,
+		DataArray1D<long> & nPut,
+		bool fSourceDouble,
+		bool fTargetDouble,
+		long lSourceOffset
+	) :
+		m_var(var),
+		m_varOut(varOut),
+		m_vecDimSizes(vecDimSizes),
+		m_lSourceOffset(lSourceOffset),
+		m_nCountsIn(nCountsIn),
+		m_nCountsOut(nCountsOut),
+		m_nGet(nGet),
+		m_nPut(nPut),
+		m_fSourceDouble(fSourceDouble),
+		m_fTargetDouble(fTargetDouble)
+	{ }
+
+public:
+	///	<summary>
+	///		Read the slices of a block.
+	///	</summary>
+	void Read(
+		OfflineMapSliceBlock & block
+	) {
+		for (int b = 0; b < block.nBatch; b++) {
+			SetCursor(block.tBegin + b, m_nCountsIn);
+			m_nCountsIn[m_vecDimSizes.GetRows()] = m_lSourceOffset;
+
+			m_var->set_cur(&(m_nCountsIn[0]));
+
+			if (m_fSourceDouble) {
+				m_var->get(block.dataInDouble(b), &(m_nGet[0]));
+			} else {
+				m_var->get(block.dataIn(b), &(m_nGet[0]));
+			}
+		}
+	}
+
+	///	<summary>
+	///		Announce the diagnostics of a remapped block and write its
+	///		slices.
+	///	</summary>
+	void Write(
+		const OfflineMapSliceBlock & block
+	) {
+		for (int b = 0; b < block.nBatch; b++) {
+			SetCursor(block.tBegin + b, m_nCountsOut);
+
+			Announce("Source Mass: %1.15e Min %1.10e Max %1.10e",
+				block.dSourceMass[b], block.dSourceMin[b], block.dSourceMax[b]);
+			Announce("Target Mass: %1.15e Min %1.10e Max %1.10e",
+				block.dTargetMass[b], block.dTargetMin[b], block.dTargetMax[b]);
+
+			m_varOut->set_cur(&(m_nCountsOut[0]));
+			if (m_fTargetDouble) {
+				m_varOut->put(block.dataOutDouble(b), &(m_nPut[0]));
+			} else {
+				m_varOut->put(block.dataOut(b), &(m_nPut[0]));
+			}
+		}
+	}
+
+protected:
+	///	<summary>
+	///		Convert a slice index to the start indices of the free
+	///		dimensions of the variable.
+	///	</summary>
+	void SetCursor(
+		int t,
+		DataArray1D<long> & nCounts
+	) const {
+		long tt = static_cast<long>(t);
+		for (int d = m_vecDimSizes.GetRows()-1; d >= 0; d--) {
+			nCounts[d] = tt % m_vecDimSizes[d];
+			tt /= m_vecDimSizes[d];
+		}
+		for (int d = m_vecDimSizes.GetRows(); d < nCounts.GetRows(); d++) {
+			nCounts[d] = 0;
+		}
+	}
+
+protected:
+	NcVar * m_var;
+	NcVar * m_varOut;
+	const DataArray1D<long> & m_vecDimSizes;
+	long m_lSourceOffset;
+	DataArray1D<long> & m_nCountsIn;
+	DataArray1D<long> & m_nCountsOut;
+	DataArray1D<long> & m_nGet;
+	DataArray1D<long> & m_nPut;
+	bool m_fSourceDouble;
+	bool m_fTargetDouble;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		A thread that remaps blocks of slices in order as they are posted
+///		by the thread performing NetCDF I/O.  Block i is stored in
+///		pBlocks[i % nSlots].  The destructor stops and joins the thread,
+///		so that an Exception on the calling thread is safe.
+///	</summary>
+class OfflineMapRemapWorker {
+
+public:
+	///	<summary>
+	///		Constructor.  Starts the thread.
+	///	</summary>
+	OfflineMapRemapWorker(
+		OfflineMap & mapRemap,
+		OfflineMapSliceBlock * pBlocks,
+		int nSlots,
+		int nBlocks,
+		float flFillValue,
+		double dFillValue
+	) :
+		m_mapRemap(mapRemap),
+		m_pBlocks(pBlocks),
+		m_nSlots(nSlots),
+		m_nBlocks(nBlocks),
+		m_flFillValue(flFillValue),
+		m_dFillValue(dFillValue),
+		m_nPosted(0),
+		m_nRemapped(0),
+		m_fAbort(false),
+		m_fFailed(false),
+		m_excFailure(__FILE__, __LINE__)
+	{
+		m_thread = std::thread(&OfflineMapRemapWorker::Run, this);
+	}
+
+	///	<summary>
+	///		Destructor.
+	///	</summary>
+	~OfflineMapRemapWorker() {
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_fAbort = true;
+		}
+		m_cv.notify_all();
+
+		if (m_thread.joinable()) {
+			m_thread.join();
+		}
+	}
+
+public:
+	///	<summary>
+	///		Mark the next block as read and ready for remapping.
+	///	</summary>
+	void Post() {
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_nPosted++;
+		}
+		m_cv.notify_all();
+	}
+
+	///	<summary>
+	///		Wait until block iBlock has been remapped.  An Exception thrown
+	///		while remapping is rethrown on the calling thread.
+	///	</summary>
+	void WaitRemapped(
+		int iBlock
+	) {
+		std::unique_lock<std::mutex> lock(m_mutex);
+		while ((m_nRemapped <= iBlock) && (!m_fFailed)) {
+			m_cv.wait(lock);
+		}
+		if (m_fFailed) {
+			throw m_excFailure;
+		}
+	}
+
+protected:
+	///	<summary>
+	///		Thread body.
+	///	</summary>
+	void Run() {
+		for (int i = 0; i < m_nBlocks; i++) {
+			{
+				std::unique_lock<std::mutex> lock(m_mutex);
+				while ((m_nPosted <= i) && (!m_fAbort)) {
+					m_cv.wait(lock);
+				}
+				if (m_fAbort) {
+					return;
+				}
+			}
+
+			try {
+				m_mapRemap.RemapSliceBlock(
+					m_pBlocks[i % m_nSlots], m_flFillValue, m_dFillValue);
+
+			} catch(Exception & e) {
+				Fail(e);
+				return;
+
+			} catch(...) {
+				Fail(Exception(__FILE__, __LINE__,
+					"Unknown error while remapping data"));
+				return;
+			}
+
+			{
+				std::lock_guard<std::mutex> lock(m_mutex);
+				m_nRemapped++;
+			}
+			m_cv.notify_all();
+		}
+	}
+
+	///	<summary>
+	///		Record a failure and wake the calling thread.
+	///	</summary>
+	void Fail(
+		const Exception & e
+	) {
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_excFailure = e;
+			m_fFailed = true;
+		}
+		m_cv.notify_all();
+	}
+
+protected:
+	OfflineMap & m_mapRemap;
+	OfflineMapSliceBlock * m_pBlocks;
+	int m_nSlots;
+	int m_nBlocks;
+	float m_flFillValue;
+	double m_dFillValue;
+
+	std::mutex m_mutex;
+	std::condition_variable m_cv;
+	int m_nPosted;
+	int m_nRemapped;
+	bool m_fAbort;
+	bool m_fFailed;
+	Exception m_excFailure;
+
+	std::thread m_thread;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Get the _FillValue attribute of a source variable of Apply().
+///	</summary>
+static void GetApplyFillValue(
+	NcVar * var,
+	float & flFillValue,
+	double & dFillValue
+) {
+	for (int a = 0; a < var->num_atts(); a++) {
+		NcAtt * att = var->get_att(a);
+		if (strcmp(att->name(), "_FillValue") == 0) {
+			if (att->type() == ncDouble) {
+				dFillValue = att->as_double(0);
+			} else if (att->type() == ncFloat) {
+				flFillValue = att->as_float(0);
+			} else {
+				_EXCEPTIONT("Invalid type for _FillValue");
+			}
+		}
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+NcVar * OfflineMap::AddApplyTargetVariable(
+	NcFile & ncSource,
+	NcFile & ncTarget,
+	NcVar * var,
+	NcDim * dim0,
+	NcDim * dim1,
+	bool fTargetDouble,
+	DataArray1D<long> & vecDimSizes,
+	DataArray1D<long> & nCountsIn,
+	DataArray1D<long> & nCountsOut,
+	DataArray1D<long> & nGet,
+	DataArray1D<long> & nPut
+) {
+	const int nSourceCount = m_dSourceAreas.GetRows();
+	const int nTargetCount = m_dTargetAreas.GetRows();
+
+	const bool fSourceRectilinear = (m_vecSourceDimSizes.size() == 2);
+	const bool fTargetRectilinear = (m_vecTargetDimSizes.size() == 2);
+
+	// Construct an array of dimensions for this variable
+	DataArray1D<NcDim *> vecDims(var->num_dims());
+
+	DataArray1D<NcDim *> vecDimsOut;
+	if (fTargetRectilinear) {
+
+		if (fSourceRectilinear) {
+			vecDimsOut.Allocate(var->num_dims());
+		} else {
+			vecDimsOut.Allocate(var->num_dims()+1);
+		}
+
+		vecDimsOut[vecDimsOut.GetRows()-2] = dim0;
+		vecDimsOut[vecDimsOut.GetRows()-1] = dim1;
+	} else {
+		if (fSourceRectilinear) {
+			if (var->num_dims() == 1) {
+				_EXCEPTIONT("Rectilinear source data stored in 1D format");
+			}
+
+			vecDimsOut.Allocate(var->num_dims()-1);
+		} else {
+			vecDimsOut.Allocate(var->num_dims());
+		}
+
+		vecDimsOut[vecDimsOut.GetRows()-1] = dim0;
+	}
+
+	int nFreeDims = var->num_dims() - m_vecSourceDimSizes.size();
+
+	// Add any missing dimension variables to target file
+	vecDimSizes.Allocate(nFreeDims);
+
+	for (int d = 0; d < nFreeDims; d++) {
+		vecDims[d] = var->get_dim(d);
+
+		long nDimSize = vecDims[d]->size();
+		std::string strDimName = vecDims[d]->name();
+
+		vecDimSizes[d] = nDimSize;
+
+		vecDimsOut[d] =
+			NcFile_GetDimIfExists(
+				ncTarget,
+				strDimName.c_str(),
+				nDimSize);
+
+		// Copy over associated variable, if it exists
+		NcVar * varAssocDimSource =
+			ncSource.get_var(strDimName.c_str());
+		if (varAssocDimSource != NULL) {
+			NcVar * varAssocDimTarget =
+				ncTarget.get_var(strDimName.c_str());
+			if (varAssocDimTarget == NULL) {
+				CopyNcVar(ncSource, ncTarget, strDimName);
+			}
+
+			NcAtt * attAssocDimBounds =
+				varAssocDimSource->get_att("bounds");
+			if (attAssocDimBounds != NULL) {
+				NcVar * varAssocDimBoundsSource =
+					ncSource.get_var(attAssocDimBounds->as_string(0));
+				NcVar * varAssocDimBoundsTarget =
+					ncTarget.get_var(attAssocDimBounds->as_string(0));
+				if ((varAssocDimBoundsSource != NULL) &&
+				    (varAssocDimBoundsTarget == NULL)
+				) {
+					CopyNcVar(
+						ncSource, ncTarget,
+						attAssocDimBounds->as_string(0));
+				}
+			}
+		}
+	}
+
+	// Create new output variable
+	NcVar * varOut;
+	if (fTargetDouble) {
+		varOut =
+			ncTarget.add_var(
+				var->name(),
+				ncDouble,
+				vecDimsOut.GetRows(),
+				(const NcDim**)&(vecDimsOut[0]));
+
+	} else {
+		varOut =
+			ncTarget.add_var(
+				var->name(),
+				ncFloat,
+				vecDimsOut.GetRows(),
+				(const NcDim**)&(vecDimsOut[0]));
+	}
+
+	if (varOut == NULL) {
+		_EXCEPTION1("Cannot create variable \"%s\" in output file",
+			var->name());
+	}
+
+	CopyNcVarAttributes(var, varOut);
+
+	// Source and output counts
+	nCountsIn.Allocate(vecDims.GetRows());
+	nCountsOut.Allocate(vecDimsOut.GetRows());
+
+	// Get size
+	nGet.Allocate(nCountsIn.GetRows());
+	for (int d = 0; d < nGet.GetRows()-1; d++) {
+		nGet[d] = 1;
+	}
+	if (fSourceRectilinear) {
+		nGet[nGet.GetRows()-2] = m_vecSourceDimSizes[0];
+		nGet[nGet.GetRows()-1] = m_vecSourceDimSizes[1];
+	} else {
+		nGet[nGet.GetRows()-1] = nSourceCount;
+	}
+
+	// Put size
+	nPut.Allocate(nCountsOut.GetRows());
+	for (int d = 0; d < nPut.GetRows()-1; d++) {
+		nPut[d] = 1;
+	}
+	if (fTargetRectilinear) {
+		nPut[nPut.GetRows()-2] = m_vecTargetDimSizes[0];
+		nPut[nPut.GetRows()-1] = m_vecTargetDimSizes[1];
+	} else {
+		nPut[nPut.GetRows()-1] = nTargetCount;
+	}
+
+	return varOut;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
 void OfflineMap::Apply(
 	const std::string & strSourceDataFile,
 	const std::string & strTargetDataFile,
 	const std::vector<std::string> & vecVariables,
 	const std::string & strNColName,
 	bool fTargetDouble,
-	bool fAppend
+	bool fAppend,
+	const std::vector< std::pair<std::string, std::string> > & vecVectorVariables
 ) {
 
+	// Components of vector variables
+	std::set<std::string> setVectorComponents;
+	for (int v = 0; v < vecVectorVariables.size(); v++) {
+		if (vecVectorVariables[v].first == vecVectorVariables[v].second) {
+			_EXCEPTION1("Vector variable \"%s\" has identical components",
+				vecVectorVariables[v].first.c_str());
+		}
+		if (!setVectorComponents.insert(vecVectorVariables[v].first).second) {
+			_EXCEPTION1("Variable \"%s\" appears in more than one vector",
+				vecVectorVariables[v].first.c_str());
+		}
+		if (!setVectorComponents.insert(vecVectorVariables[v].second).second) {
+			_EXCEPTION1("Variable \"%s\" appears in more than one vector",
+				vecVectorVariables[v].second.c_str());
+		}
+	}
+
 	// Check variable list for "lat" and "lon"
 	for (int v = 0; v < vecVariables.size(); v++) {
 		if (vecVariables[v] == "lat") {
@@ -1090,6 +1794,16 @@ void OfflineMap::Apply(
 		if (vecVariables[v] == "lon") {
 			_EXCEPTIONT("Longitude variable \"lon\" in variable list will be overwritten on output");
 		}
+		if (setVectorComponents.find(vecVariables[v]) != setVectorComponents.end()) {
+			_EXCEPTION1("Variable \"%s\" is both a scalar and a vector component",
+				vecVariables[v].c_str());
+		}
+	}
+	if (setVectorComponents.find("lat") != setVectorComponents.end()) {
+		_EXCEPTIONT("Latitude variable \"lat\" in vector list will be overwritten on output");
+	}
+	if (setVectorComponents.find("lon") != setVectorComponents.end()) {
+		_EXCEPTIONT("Longitude variable \"lon\" in vector list will be overwritten on output");
 	}
 
 	// Open source data file
@@ -1149,23 +1863,17 @@ void OfflineMap::Apply(
 		}
 	}
 
-	DataArray1D<float> dataIn;
-	if (m_vecSourceDimSizes.size() == 1) {
-		dataIn.Allocate(nSourceCount);
-	} else {
-		dataIn.Allocate(m_vecSourceDimSizes[0] * m_vecSourceDimSizes[1]);
+	// Size of the data slices on the source and target grids
+	int nSourceSliceSize = nSourceCount;
+	if (m_vecSourceDimSizes.size() != 1) {
+		nSourceSliceSize = m_vecSourceDimSizes[0] * m_vecSourceDimSizes[1];
 	}
 
-	DataArray1D<float> dataOut;
-	if (m_vecTargetDimSizes.size() == 1) {
-		dataOut.Allocate(nTargetCount);
-	} else {
-		dataOut.Allocate(m_vecTargetDimSizes[0] * m_vecTargetDimSizes[1]);
+	int nTargetSliceSize = nTargetCount;
+	if (m_vecTargetDimSizes.size() != 1) {
+		nTargetSliceSize = m_vecTargetDimSizes[0] * m_vecTargetDimSizes[1];
 	}
 
-	DataArray1D<double> dataInDouble(nSourceCount);
-	DataArray1D<double> dataOutDouble(nTargetCount);
-
 	// Target
 	if (!fAppend) {
 		CopyNcFileAttributes(&ncSource, &ncTarget);
@@ -1207,7 +1915,7 @@ void OfflineMap::Apply(
 					NcDim * dimA = var->get_dim(var->num_dims()-2);
 					NcDim * dimB = var->get_dim(var->num_dims()-1);
 
-					if (dimA->size() != m_vecSourceDimSizes[0]) {
+					if (dimA->size() != GetSourceGridFullSize()) {
 						continue;
 					}
 					if (dimB->size() != m_vecSourceDimSizes[1]) {
@@ -1222,7 +1930,7 @@ void OfflineMap::Apply(
 				} else {
 					NcDim * dim = var->get_dim(var->num_dims()-1);
 
-					if (dim->size() != nSourceCount) {
+					if (dim->size() != GetSourceGridFullSize()) {
 						continue;
 					}
 
@@ -1240,6 +1948,13 @@ void OfflineMap::Apply(
 				}
 			}
 
+			// Components of vector variables are remapped together
+			if (setVectorComponents.find(var->name()) !=
+			    setVectorComponents.end()
+			) {
+				continue;
+			}
+
 			vecVariableList.push_back(var->name());
 		}
 	}
@@ -1342,6 +2057,8 @@ void OfflineMap::Apply(
 	} else if (!fTargetRectilinear) {
 		NcVar * varLon = ncTarget.get_var("lon");
 		if (varLon == NULL) {
+			RequireTargetCoordinates();
+
 			varLon = ncTarget.add_var("lon", ncDouble, dim0);
 			if (m_dTargetCenterLon.GetRows() != dim0->size()) {
 				_EXCEPTION2("TargetCenterLon / NCol dimension size mismatch (%i, %i)",
@@ -1369,6 +2086,8 @@ void OfflineMap::Apply(
 
 		NcVar * varLat = ncTarget.get_var("lat");
 		if (varLat == NULL) {
+			RequireTargetCoordinates();
+
 			varLat = ncTarget.add_var("lat", ncDouble, dim0);
 			if (m_dTargetCenterLat.GetRows() != dim0->size()) {
 				_EXCEPTION2("TargetCenterLat / NCol dimension size mismatch (%i, %i)",
@@ -1398,6 +2117,8 @@ void OfflineMap::Apply(
 	} else {
 		NcVar * varLon = ncTarget.get_var("lon");
 		if (varLon == NULL) {
+			RequireTargetCoordinates();
+
 			varLon = ncTarget.add_var("lon", ncDouble, dim0, dim1);
 			if (m_dTargetCenterLon.GetRows() != dim0->size() * dim1->size()) {
 				_EXCEPTION3("TargetCenterLon / NCol dimension size mismatch (%i, %i x %i)",
@@ -1432,6 +2153,8 @@ void OfflineMap::Apply(
 
 		NcVar * varLat = ncTarget.get_var("lat");
 		if (varLat == NULL) {
+			RequireTargetCoordinates();
+
 			varLat = ncTarget.add_var("lat", ncDouble, dim0, dim1);
 			if (m_dTargetCenterLat.GetRows() != dim0->size() * dim1->size()) {
 				_EXCEPTION3("TargetCenterLat / NCol dimension size mismatch (%i, %i x %i)",
@@ -1465,6 +2188,18 @@ void OfflineMap::Apply(
 		}
 	}
 
+	// Upload the weights once for all variables
+	if (m_fDeviceApply) {
+		if (m_fSinglePrecision) {
+			m_mapRemapDevice.Upload(
+				m_mapRemapSingle, nTargetCount, nSourceCount);
+		} else {
+			m_mapRemap.Freeze();
+			m_mapRemapDevice.Upload(
+				m_mapRemap, nTargetCount, nSourceCount);
+		}
+	}
+
 	// Loop through all variables
 	for (int v = 0; v < vecVariableList.size(); v++) {
 		NcVar * var = ncSource.get_var(vecVariableList[v].c_str());
@@ -1478,292 +2213,789 @@ void OfflineMap::Apply(
 		// Check for _FillValue
 		float flFillValue = 0.0f;
 		double dFillValue = 0.0;
-		for (int a = 0; a < var->num_atts(); a++) {
-			NcAtt * att = var->get_att(a);
-			if (strcmp(att->name(), "_FillValue") == 0) {
-				if (att->type() == ncDouble) {
-					dFillValue = att->as_double(0);
-				} else if (att->type() == ncFloat) {
-					flFillValue = att->as_float(0);
-				} else {
-					_EXCEPTIONT("Invalid type for _FillValue");
-				}
-			}
-		}
+		GetApplyFillValue(var, flFillValue, dFillValue);
 
-		// Construct an array of dimensions for this variable
-		int nVarTotalEntries = 1;
+		// Create the output variable
+		DataArray1D<long> vecDimSizes;
+		DataArray1D<long> nCountsIn;
+		DataArray1D<long> nCountsOut;
+		DataArray1D<long> nGet;
+		DataArray1D<long> nPut;
 
-		DataArray1D<NcDim *> vecDims(var->num_dims());
+		NcVar * varOut =
+			AddApplyTargetVariable(
+				ncSource, ncTarget, var, dim0, dim1, fTargetDouble,
+				vecDimSizes, nCountsIn, nCountsOut, nGet, nPut);
 
-		DataArray1D<NcDim *> vecDimsOut;
-		if (fTargetRectilinear) {
+		int nVarTotalEntries = 1;
+		for (int d = 0; d < vecDimSizes.GetRows(); d++) {
+			nVarTotalEntries *= static_cast<int>(vecDimSizes[d]);
+		}
 
-			if (fSourceRectilinear) {
-				vecDimsOut.Allocate(var->num_dims());
-			} else {
-				vecDimsOut.Allocate(var->num_dims()+1);
-			}
+		// Number of slices gathered into each block; the map is streamed
+		// from memory once per block
+		int nBatchSize = m_nBatchSize;
+		if (nBatchSize < m_nThreads) {
+			nBatchSize = m_nThreads;
+		}
+		if (nBatchSize > nVarTotalEntries) {
+			nBatchSize = nVarTotalEntries;
+		}
 
-			vecDimsOut[vecDimsOut.GetRows()-2] = dim0;
-			vecDimsOut[vecDimsOut.GetRows()-1] = dim1;
-		} else {
-			if (fSourceRectilinear) {
-				if (var->num_dims() == 1) {
-					_EXCEPTIONT("Rectilinear source data stored in 1D format");
-				}
+		// Verify variable type
+		if ((var->type() != ncFloat) && (var->type() != ncDouble)) {
+			_EXCEPTIONT("Invalid variable type");
+		}
 
-				vecDimsOut.Allocate(var->num_dims()-1);
-			} else {
-				vecDimsOut.Allocate(var->num_dims());
-			}
+		// Blocks of slices; with asynchronous I/O two blocks are in flight
+		bool fSourceDouble = (var->type() == ncDouble);
+
+		const int nBlocks = (nVarTotalEntries + nBatchSize - 1) / nBatchSize;
 
-			vecDimsOut[vecDimsOut.GetRows()-1] = dim0;
+		int nSlots = 1;
+		if (m_fAsyncIO && (nBlocks > 1)) {
+			nSlots = 2;
 		}
 
-		int nFreeDims = var->num_dims() - m_vecSourceDimSizes.size();
+		OfflineMapSliceBlock blocks[2];
+		for (int s = 0; s < nSlots; s++) {
+			blocks[s].Allocate(
+				nBatchSize, nSourceSliceSize, nTargetSliceSize,
+				fSourceDouble, fTargetDouble);
+		}
 
-		// Add any missing dimension variables to target file
-		DataArray1D<long> vecDimSizes(nFreeDims);
+		OfflineMapSliceIO io(
+			var, varOut, vecDimSizes,
+			nCountsIn, nCountsOut, nGet, nPut,
+			fSourceDouble, fTargetDouble,
+			static_cast<long>(m_nSourceGridOffset));
 
-		for (int d = 0; d < nFreeDims; d++) {
-			vecDims[d] = var->get_dim(d);
+		// Read, remap and write each block in turn
+		if (nSlots == 1) {
+			for (int i = 0; i < nBlocks; i++) {
+				blocks[0].SetRange(i, nBatchSize, nVarTotalEntries);
 
-			long nDimSize = vecDims[d]->size();
-			std::string strDimName = vecDims[d]->name();
+				io.Read(blocks[0]);
+				RemapSliceBlock(blocks[0], flFillValue, dFillValue);
+				io.Write(blocks[0]);
+			}
 
-			vecDimSizes[d] = nDimSize;
-			nVarTotalEntries *= nDimSize;
+		// Read block i+1 and write block i-1 while block i is remapped
+		} else {
+			OfflineMapRemapWorker worker(
+				*this, blocks, nSlots, nBlocks, flFillValue, dFillValue);
 
-			vecDimsOut[d] =
-				NcFile_GetDimIfExists(
-					ncTarget,
-					strDimName.c_str(),
-					nDimSize);
+			blocks[0].SetRange(0, nBatchSize, nVarTotalEntries);
+			io.Read(blocks[0]);
+			worker.Post();
 
-			// Copy over associated variable, if it exists
-			NcVar * varAssocDimSource =
-				ncSource.get_var(strDimName.c_str());
-			if (varAssocDimSource != NULL) {
-				NcVar * varAssocDimTarget =
-					ncTarget.get_var(strDimName.c_str());
-				if (varAssocDimTarget == NULL) {
-					CopyNcVar(ncSource, ncTarget, strDimName);
-				}
+			for (int i = 1; i < nBlocks; i++) {
+				OfflineMapSliceBlock & blockNext = blocks[i % nSlots];
+				blockNext.SetRange(i, nBatchSize, nVarTotalEntries);
+				io.Read(blockNext);
+				worker.Post();
 
-				NcAtt * attAssocDimBounds =
-					varAssocDimSource->get_att("bounds");
-				if (attAssocDimBounds != NULL) {
-					NcVar * varAssocDimBoundsSource =
-						ncSource.get_var(attAssocDimBounds->as_string(0));
-					NcVar * varAssocDimBoundsTarget =
-						ncTarget.get_var(attAssocDimBounds->as_string(0));
-					if ((varAssocDimBoundsSource != NULL) &&
-					    (varAssocDimBoundsTarget == NULL)
-					) {
-						CopyNcVar(
-							ncSource, ncTarget,
-							attAssocDimBounds->as_string(0));
-					}
-				}
+				worker.WaitRemapped(i-1);
+				io.Write(blocks[(i-1) % nSlots]);
 			}
+
+			worker.WaitRemapped(nBlocks-1);
+			io.Write(blocks[(nBlocks-1) % nSlots]);
 		}
+		AnnounceEndBlock(NULL);
+	}
 
-		// Create new output variable
-		NcVar * varOut;
-		if (fTargetDouble) {
-			varOut =
-				ncTarget.add_var(
-					vecVariableList[v].c_str(),
-					ncDouble,
-					vecDimsOut.GetRows(),
-					(const NcDim**)&(vecDimsOut[0]));
+	// Loop through all vector variables; the eastward and northward
+	// components are remapped together as three Cartesian components
+	for (int v = 0; v < vecVectorVariables.size(); v++) {
+		const std::string & strVarU = vecVectorVariables[v].first;
+		const std::string & strVarV = vecVectorVariables[v].second;
 
-		} else {
-			varOut =
-				ncTarget.add_var(
-					vecVariableList[v].c_str(),
-					ncFloat,
-					vecDimsOut.GetRows(),
-					(const NcDim**)&(vecDimsOut[0]));
+		NcVar * varU = ncSource.get_var(strVarU.c_str());
+		if (varU == NULL) {
+			_EXCEPTION1("Variable \"%s\" does not exist in source file",
+				strVarU.c_str());
+		}
+		NcVar * varV = ncSource.get_var(strVarV.c_str());
+		if (varV == NULL) {
+			_EXCEPTION1("Variable \"%s\" does not exist in source file",
+				strVarV.c_str());
 		}
 
-		if (varOut == NULL) {
-			_EXCEPTION1("Cannot create variable \"%s\" in output file",
-				vecVariableList[v].c_str());
+		std::string strVectorName = strVarU + ", " + strVarV;
+		AnnounceStartBlock(strVectorName.c_str());
+
+		// Verify variable types
+		if ((varU->type() != ncFloat) && (varU->type() != ncDouble)) {
+			_EXCEPTIONT("Invalid variable type");
+		}
+		if ((varV->type() != ncFloat) && (varV->type() != ncDouble)) {
+			_EXCEPTIONT("Invalid variable type");
 		}
 
-		CopyNcVarAttributes(var, varOut);
+		// Check for _FillValue; components are read in double precision
+		float flFillValueU = 0.0f;
+		double dFillValueU = 0.0;
+		GetApplyFillValue(varU, flFillValueU, dFillValueU);
+		if (varU->type() == ncFloat) {
+			dFillValueU = static_cast<double>(flFillValueU);
+		}
 
-		// Source and output counts
-		DataArray1D<long> nCountsIn(vecDims.GetRows());
-		DataArray1D<long> nCountsOut(vecDimsOut.GetRows());
+		float flFillValueV = 0.0f;
+		double dFillValueV = 0.0;
+		GetApplyFillValue(varV, flFillValueV, dFillValueV);
+		if (varV->type() == ncFloat) {
+			dFillValueV = static_cast<double>(flFillValueV);
+		}
 
-		// Get size
-		DataArray1D<long> nGet(nCountsIn.GetRows());
-		for (int d = 0; d < nGet.GetRows()-1; d++) {
-			nGet[d] = 1;
+		// Create the output variables
+		DataArray1D<long> vecDimSizesU;
+		DataArray1D<long> nCountsInU;
+		DataArray1D<long> nCountsOutU;
+		DataArray1D<long> nGetU;
+		DataArray1D<long> nPutU;
+
+		NcVar * varOutU =
+			AddApplyTargetVariable(
+				ncSource, ncTarget, varU, dim0, dim1, fTargetDouble,
+				vecDimSizesU, nCountsInU, nCountsOutU, nGetU, nPutU);
+
+		DataArray1D<long> vecDimSizesV;
+		DataArray1D<long> nCountsInV;
+		DataArray1D<long> nCountsOutV;
+		DataArray1D<long> nGetV;
+		DataArray1D<long> nPutV;
+
+		NcVar * varOutV =
+			AddApplyTargetVariable(
+				ncSource, ncTarget, varV, dim0, dim1, fTargetDouble,
+				vecDimSizesV, nCountsInV, nCountsOutV, nGetV, nPutV);
+
+		if (vecDimSizesU.GetRows() != vecDimSizesV.GetRows()) {
+			_EXCEPTION2("Vector components \"%s\" and \"%s\" have different "
+				"dimensions", strVarU.c_str(), strVarV.c_str());
 		}
-		if (fSourceRectilinear) {
-			nGet[nGet.GetRows()-2] = m_vecSourceDimSizes[0];
-			nGet[nGet.GetRows()-1] = m_vecSourceDimSizes[1];
-		} else {
-			nGet[nGet.GetRows()-1] = nSourceCount;
+
+		int nVarTotalEntries = 1;
+		for (int d = 0; d < vecDimSizesU.GetRows(); d++) {
+			if (vecDimSizesU[d] != vecDimSizesV[d]) {
+				_EXCEPTION2("Vector components \"%s\" and \"%s\" have "
+					"different dimensions", strVarU.c_str(), strVarV.c_str());
+			}
+			nVarTotalEntries *= static_cast<int>(vecDimSizesU[d]);
 		}
 
-		// Put size
-		DataArray1D<long> nPut(nCountsOut.GetRows());
-		for (int d = 0; d < nPut.GetRows()-1; d++) {
-			nPut[d] = 1;
+		// Number of slices gathered into each block; each block of both
+		// components is remapped in a single pass over the map
+		int nBatchSize = m_nBatchSize;
+		if (nBatchSize < m_nThreads) {
+			nBatchSize = m_nThreads;
 		}
-		if (fTargetRectilinear) {
-			nPut[nPut.GetRows()-2] = m_vecTargetDimSizes[0];
-			nPut[nPut.GetRows()-1] = m_vecTargetDimSizes[1];
-		} else {
-			nPut[nPut.GetRows()-1] = nTargetCount;
+		if (nBatchSize > nVarTotalEntries) {
+			nBatchSize = nVarTotalEntries;
 		}
 
-		// Loop through all entries
-		for (int t = 0; t < nVarTotalEntries; t++) {
+		const int nBlocks = (nVarTotalEntries + nBatchSize - 1) / nBatchSize;
 
-			long tt = static_cast<long>(t);
-			for (int d = vecDimSizes.GetRows()-1; d >= 0; d--) {
-				nCountsIn[d]  = tt % vecDimSizes[d];
-				nCountsOut[d] = tt % vecDimSizes[d];
-				tt /= vecDimSizes[d];
-			}
+		OfflineMapSliceBlock blockU;
+		OfflineMapSliceBlock blockV;
+		blockU.Allocate(
+			nBatchSize, nSourceSliceSize, nTargetSliceSize, true, true);
+		blockV.Allocate(
+			nBatchSize, nSourceSliceSize, nTargetSliceSize, true, true);
 
-			for (int d = vecDimSizes.GetRows(); d < nCountsIn.GetRows(); d++) {
-				nCountsIn[d] = 0;
-			}
-			for (int d = vecDimSizes.GetRows(); d < nCountsOut.GetRows(); d++) {
-				nCountsOut[d] = 0;
-			}
+		// NetCDF converts to and from the types of the variables
+		OfflineMapSliceIO ioU(
+			varU, varOutU, vecDimSizesU,
+			nCountsInU, nCountsOutU, nGetU, nPutU,
+			true, true,
+			static_cast<long>(m_nSourceGridOffset));
 
-			// Get the data
-			var->set_cur(&(nCountsIn[0]));
+		OfflineMapSliceIO ioV(
+			varV, varOutV, vecDimSizesV,
+			nCountsInV, nCountsOutV, nGetV, nPutV,
+			true, true,
+			static_cast<long>(m_nSourceGridOffset));
 
-			// Load data as Float, cast to Double
-			if (var->type() == ncFloat) {
-				var->get(&(dataIn[0]), &(nGet[0]));
+		// Read, remap and write each block in turn
+		for (int i = 0; i < nBlocks; i++) {
+			blockU.SetRange(i, nBatchSize, nVarTotalEntries);
+			blockV.SetRange(i, nBatchSize, nVarTotalEntries);
 
-				if (flFillValue != 0.0f) {
-					for (int i = 0; i < nSourceCount; i++) {
-						if (dataIn[i] == flFillValue) {
-							dataInDouble[i] = 0.0;
-						} else {
-							dataInDouble[i] = static_cast<double>(dataIn[i]);
-						}
-					}
+			ioU.Read(blockU);
+			ioV.Read(blockV);
 
-				} else {
-					for (int i = 0; i < nSourceCount; i++) {
-						dataInDouble[i] = static_cast<double>(dataIn[i]);
-					}
-				}
+			RemapVectorSliceBlock(blockU, blockV, dFillValueU, dFillValueV);
 
-			// Load data as Double
-			} else if (var->type() == ncDouble) {
-				var->get(&(dataInDouble[0]), &(nGet[0]));
+			ioU.Write(blockU);
+			ioV.Write(blockV);
+		}
+		AnnounceEndBlock(NULL);
+	}
 
-				if (dFillValue != 0.0) {
-					for (int i = 0; i < nSourceCount; i++) {
-						if (dataInDouble[i] == dFillValue) {
-							dataInDouble[i] = 0.0;
-						}
-					}
-				}
+	m_mapRemapDevice.Release();
+}
 
-			} else {
-				_EXCEPTIONT("Invalid variable type");
-			}
+///////////////////////////////////////////////////////////////////////////////
+
+void OfflineMap::RemapSliceBlock(
+	OfflineMapSliceBlock & block,
+	float flFillValue,
+	double dFillValue
+) {
+	const bool fSourceDouble = block.dataInDouble.IsAttached();
+	const bool fTargetDouble = block.dataOutDouble.IsAttached();
+
+	// Type conversion is performed in the sparse product
+	if (fSourceDouble && fTargetDouble) {
+		ApplyToSliceBlock(
+			block.dataInDouble(0), block.dataOutDouble(0),
+			block.nBatch, dFillValue,
+			block.dSourceMass, block.dSourceMin, block.dSourceMax,
+			block.dTargetMass, block.dTargetMin, block.dTargetMax);
+
+	} else if (fSourceDouble) {
+		ApplyToSliceBlock(
+			block.dataInDouble(0), block.dataOut(0),
+			block.nBatch, dFillValue,
+			block.dSourceMass, block.dSourceMin, block.dSourceMax,
+			block.dTargetMass, block.dTargetMin, block.dTargetMax);
+
+	} else if (fTargetDouble) {
+		ApplyToSliceBlock(
+			block.dataIn(0), block.dataOutDouble(0),
+			block.nBatch, flFillValue,
+			block.dSourceMass, block.dSourceMin, block.dSourceMax,
+			block.dTargetMass, block.dTargetMin, block.dTargetMax);
 
-			// Announce input mass
-			double dSourceMass = 0.0;
-			double dSourceMin  = dataInDouble[0];
-			double dSourceMax  = dataInDouble[0];
+	} else {
+		ApplyToSliceBlock(
+			block.dataIn(0), block.dataOut(0),
+			block.nBatch, flFillValue,
+			block.dSourceMass, block.dSourceMin, block.dSourceMax,
+			block.dTargetMass, block.dTargetMin, block.dTargetMax);
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+template <typename InType, typename OutType>
+void OfflineMap::ApplyToSliceBlock(
+	InType * pDataIn,
+	OutType * pDataOut,
+	int nBatch,
+	InType valueFill,
+	DataArray1D<double> & dSourceMass,
+	DataArray1D<double> & dSourceMin,
+	DataArray1D<double> & dSourceMax,
+	DataArray1D<double> & dTargetMass,
+	DataArray1D<double> & dTargetMin,
+	DataArray1D<double> & dTargetMax
+) {
+	const int nSourceCount = static_cast<int>(m_dSourceAreas.GetRows());
+	const int nTargetCount = static_cast<int>(m_dTargetAreas.GetRows());
+
+	// Weights are uploaded to the device by Apply() when requested
+	const bool fDevice = m_mapRemapDevice.IsUploaded();
+
+	// The strided kernel traverses the CSR arrays directly, each thread
+	// in its own NUMA domain
+	if (!fDevice) {
+		if (m_fSinglePrecision) {
+			m_mapRemapSingle.Distribute(m_nThreads);
+		} else {
+			m_mapRemap.Freeze();
+			m_mapRemap.Distribute(m_nThreads);
+		}
+	}
+
+	// Zero fill values in place and compute input mass
+#pragma omp parallel for num_threads(m_nThreads) schedule(static, 1)
+	for (int b = 0; b < nBatch; b++) {
+		InType * pSlice = pDataIn + b * nSourceCount;
+
+		if (valueFill != static_cast<InType>(0)) {
 			for (int i = 0; i < nSourceCount; i++) {
-				dSourceMass += dataInDouble[i] * m_dSourceAreas[i];
-				if (dataInDouble[i] < dSourceMin) {
-					dSourceMin = dataInDouble[i];
+				if (pSlice[i] == valueFill) {
+					pSlice[i] = static_cast<InType>(0);
 				}
-				if (dataInDouble[i] > dSourceMax) {
-					dSourceMax = dataInDouble[i];
-				}
-			}
-/*
-			for (int d = 0; d < nCountsIn.GetRows(); d++) {
-				printf("%li ", nCountsIn[d]);
-			}
-			printf(" : ");
-			for (int d = 0; d < nCountsOut.GetRows(); d++) {
-				printf("%li ", nCountsOut[d]);
 			}
-			printf("\n");
-*/
-			Announce("Source Mass: %1.15e Min %1.10e Max %1.10e",
-				dSourceMass, dSourceMin, dSourceMax);
-
-			// Apply the offline map to the data
-			m_mapRemap.Apply(dataInDouble, dataOutDouble);
-
-			// Announce output mass
-			double dTargetMass = 0.0;
-			double dTargetMin  = dataOutDouble[0];
-			double dTargetMax  = dataOutDouble[0];
-			for (int i = 0; i < nTargetCount; i++) {
-				dTargetMass += dataOutDouble[i] * m_dTargetAreas[i];
-				if (dataOutDouble[i] < dTargetMin) {
-					dTargetMin = dataOutDouble[i];
-				}
-				if (dataOutDouble[i] > dTargetMax) {
-					dTargetMax = dataOutDouble[i];
+		}
+
+		ComputeSliceStatistics(
+			pSlice, m_dSourceAreas, nSourceCount,
+			dSourceMass[b], dSourceMin[b], dSourceMax[b]);
+	}
+
+	// Apply the offline map to all slices of the block, accumulating in
+	// double and writing the output type directly
+	if (fDevice) {
+		m_mapRemapDevice.Apply<InType, OutType>(
+			pDataIn, pDataOut, nBatch, m_nThreads);
+
+	} else if (m_fSinglePrecision) {
+		m_mapRemapSingle.Apply<InType, double, OutType>(
+			pDataIn, nSourceCount, 1,
+			pDataOut, nTargetCount, 1,
+			nBatch, nTargetCount, m_nThreads);
+	} else {
+		m_mapRemap.Apply<InType, double, OutType>(
+			pDataIn, nSourceCount, 1,
+			pDataOut, nTargetCount, 1,
+			nBatch, nTargetCount, m_nThreads);
+	}
+
+	// Compute output mass
+#pragma omp parallel for num_threads(m_nThreads) schedule(static, 1)
+	for (int b = 0; b < nBatch; b++) {
+		ComputeSliceStatistics(
+			pDataOut + b * nTargetCount, m_dTargetAreas, nTargetCount,
+			dTargetMass[b], dTargetMin[b], dTargetMax[b]);
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+template <typename ValueType>
+void OfflineMap::ApplyToArray(
+	const ValueType * pSource,
+	int nSourceCells,
+	ptrdiff_t sSourceFieldStride,
+	ptrdiff_t sSourceCellStride,
+	ValueType * pTarget,
+	int nTargetCells,
+	ptrdiff_t sTargetFieldStride,
+	ptrdiff_t sTargetCellStride,
+	int nFields
+) {
+	if (nFields < 0) {
+		_EXCEPTION1("Invalid number of fields (%i)", nFields);
+	}
+	if (nFields == 0) {
+		return;
+	}
+	if ((pSource == NULL) || (pTarget == NULL)) {
+		_EXCEPTIONT("NULL source or target array");
+	}
+	if (nSourceCells != m_dSourceAreas.GetRows()) {
+		_EXCEPTION2("Source array size (%i) does not match map source "
+			"grid size (%i)", nSourceCells, m_dSourceAreas.GetRows());
+	}
+	if (nTargetCells != m_dTargetAreas.GetRows()) {
+		_EXCEPTION2("Target array size (%i) does not match map target "
+			"grid size (%i)", nTargetCells, m_dTargetAreas.GetRows());
+	}
+
+	// Single precision weights are always frozen
+	if (m_fSinglePrecision) {
+		if (m_mapRemapSingle.GetColumns() > nSourceCells) {
+			_EXCEPTION2("Map column count (%i) exceeds source grid size (%i)",
+				m_mapRemapSingle.GetColumns(), nSourceCells);
+		}
+
+		m_mapRemapSingle.Distribute(m_nThreads);
+
+		m_mapRemapSingle.Apply<ValueType, double>(
+			pSource, sSourceFieldStride, sSourceCellStride,
+			pTarget, sTargetFieldStride, sTargetCellStride,
+			nFields, nTargetCells, m_nThreads);
+
+		return;
+	}
+
+	if (m_mapRemap.GetColumns() > nSourceCells) {
+		_EXCEPTION2("Map column count (%i) exceeds source grid size (%i)",
+			m_mapRemap.GetColumns(), nSourceCells);
+	}
+
+	// The strided kernel traverses the CSR arrays directly, each thread
+	// in its own NUMA domain
+	m_mapRemap.Freeze();
+	m_mapRemap.Distribute(m_nThreads);
+
+	m_mapRemap.Apply(
+		pSource, sSourceFieldStride, sSourceCellStride,
+		pTarget, sTargetFieldStride, sTargetCellStride,
+		nFields, nTargetCells, m_nThreads);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void OfflineMap::Apply(
+	const double * pSource,
+	int nSourceCells,
+	ptrdiff_t sSourceFieldStride,
+	ptrdiff_t sSourceCellStride,
+	double * pTarget,
+	int nTargetCells,
+	ptrdiff_t sTargetFieldStride,
+	ptrdiff_t sTargetCellStride,
+	int nFields
+) {
+	ApplyToArray(
+		pSource, nSourceCells, sSourceFieldStride, sSourceCellStride,
+		pTarget, nTargetCells, sTargetFieldStride, sTargetCellStride,
+		nFields);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void OfflineMap::Apply(
+	const float * pSource,
+	int nSourceCells,
+	ptrdiff_t sSourceFieldStride,
+	ptrdiff_t sSourceCellStride,
+	float * pTarget,
+	int nTargetCells,
+	ptrdiff_t sTargetFieldStride,
+	ptrdiff_t sTargetCellStride,
+	int nFields
+) {
+	ApplyToArray(
+		pSource, nSourceCells, sSourceFieldStride, sSourceCellStride,
+		pTarget, nTargetCells, sTargetFieldStride, sTargetCellStride,
+		nFields);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void OfflineMap::ApplyVector(
+	const double * pSourceU,
+	const double * pSourceV,
+	int nSourceCells,
+	double * pTargetU,
+	double * pTargetV,
+	int nTargetCells,
+	int nFields
+) {
+	if (nFields < 0) {
+		_EXCEPTION1("Invalid number of fields (%i)", nFields);
+	}
+	if (nFields == 0) {
+		return;
+	}
+	if ((pSourceU == NULL) || (pSourceV == NULL) ||
+	    (pTargetU == NULL) || (pTargetV == NULL)
+	) {
+		_EXCEPTIONT("NULL source or target array");
+	}
+
+	RequireSourceCoordinates();
+	RequireTargetCoordinates();
+
+	if ((m_dSourceCenterLon.GetRows() != nSourceCells) ||
+	    (m_dSourceCenterLat.GetRows() != nSourceCells)
+	) {
+		_EXCEPTION1("Map source center coordinates do not match source "
+			"array size (%i); vector fields cannot be remapped",
+			nSourceCells);
+	}
+	if ((m_dTargetCenterLon.GetRows() != nTargetCells) ||
+	    (m_dTargetCenterLat.GetRows() != nTargetCells)
+	) {
+		_EXCEPTION1("Map target center coordinates do not match target "
+			"array size (%i); vector fields cannot be remapped",
+			nTargetCells);
+	}
+
+	// Cartesian components of the fields, with component c of field f
+	// stored in slice 3 * f + c
+	const ptrdiff_t sSourceSliceStride = static_cast<ptrdiff_t>(nSourceCells);
+	const ptrdiff_t sTargetSliceStride = static_cast<ptrdiff_t>(nTargetCells);
+
+	DataArray1D<double> dSourceXYZ;
+	dSourceXYZ.Allocate(3 * nFields * sSourceSliceStride, false);
+
+	DataArray1D<double> dTargetXYZ;
+	dTargetXYZ.Allocate(3 * nFields * sTargetSliceStride, false);
+
+	// Project the eastward and northward components onto the Cartesian
+	// axes at the source cell centers
+#pragma omp parallel for num_threads(m_nThreads) schedule(static)
+	for (int i = 0; i < nSourceCells; i++) {
+		const double dLon = m_dSourceCenterLon[i] / 180.0 * M_PI;
+		const double dLat = m_dSourceCenterLat[i] / 180.0 * M_PI;
+
+		const double dSinLon = sin(dLon);
+		const double dCosLon = cos(dLon);
+		const double dSinLat = sin(dLat);
+		const double dCosLat = cos(dLat);
+
+		for (int f = 0; f < nFields; f++) {
+			const double dU = pSourceU[f * sSourceSliceStride + i];
+			const double dV = pSourceV[f * sSourceSliceStride + i];
+
+			double * pXYZ = &(dSourceXYZ[3 * f * sSourceSliceStride + i]);
+
+			pXYZ[0] = - dU * dSinLon - dV * dSinLat * dCosLon;
+			pXYZ[sSourceSliceStride] = dU * dCosLon - dV * dSinLat * dSinLon;
+			pXYZ[2 * sSourceSliceStride] = dV * dCosLat;
+		}
+	}
+
+	// Remap all components of all fields in a single pass over the map
+	ApplyToArray<double>(
+		&(dSourceXYZ[0]), nSourceCells, sSourceSliceStride, 1,
+		&(dTargetXYZ[0]), nTargetCells, sTargetSliceStride, 1,
+		3 * nFields);
+
+	// Project the Cartesian components back onto the eastward and
+	// northward directions at the target cell centers; any radial
+	// component introduced by the remapping is discarded
+#pragma omp parallel for num_threads(m_nThreads) schedule(static)
+	for (int j = 0; j < nTargetCells; j++) {
+		const double dLon = m_dTargetCenterLon[j] / 180.0 * M_PI;
+		const double dLat = m_dTargetCenterLat[j] / 180.0 * M_PI;
+
+		const double dSinLon = sin(dLon);
+		const double dCosLon = cos(dLon);
+		const double dSinLat = sin(dLat);
+		const double dCosLat = cos(dLat);
+
+		for (int f = 0; f < nFields; f++) {
+			const double * pXYZ =
+				&(dTargetXYZ[3 * f * sTargetSliceStride + j]);
+
+			const double dX = pXYZ[0];
+			const double dY = pXYZ[sTargetSliceStride];
+			const double dZ = pXYZ[2 * sTargetSliceStride];
+
+			pTargetU[f * sTargetSliceStride + j] =
+				- dX * dSinLon + dY * dCosLon;
+			pTargetV[f * sTargetSliceStride + j] =
+				- dX * dSinLat * dCosLon - dY * dSinLat * dSinLon + dZ * dCosLat;
+		}
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void OfflineMap::RemapVectorSliceBlock(
+	OfflineMapSliceBlock & blockU,
+	OfflineMapSliceBlock & blockV,
+	double dFillValueU,
+	double dFillValueV
+) {
+	const int nSourceCount = static_cast<int>(m_dSourceAreas.GetRows());
+	const int nTargetCount = static_cast<int>(m_dTargetAreas.GetRows());
+
+	const int nBatch = blockU.nBatch;
+
+	// Zero both components where either is a fill value and compute the
+	// input mass of each component
+#pragma omp parallel for num_threads(m_nThreads) schedule(static, 1)
+	for (int b = 0; b < nBatch; b++) {
+		double * pSliceU = blockU.dataInDouble(b);
+		double * pSliceV = blockV.dataInDouble(b);
+
+		if ((dFillValueU != 0.0) || (dFillValueV != 0.0)) {
+			for (int i = 0; i < nSourceCount; i++) {
+				if ((pSliceU[i] == dFillValueU) || (pSliceV[i] == dFillValueV)) {
+					pSliceU[i] = 0.0;
+					pSliceV[i] = 0.0;
 				}
 			}
-			Announce("Target Mass: %1.15e Min %1.10e Max %1.10e",
-				dTargetMass, dTargetMin, dTargetMax);
+		}
+
+		ComputeSliceStatistics(
+			pSliceU, m_dSourceAreas, nSourceCount,
+			blockU.dSourceMass[b], blockU.dSourceMin[b], blockU.dSourceMax[b]);
+		ComputeSliceStatistics(
+			pSliceV, m_dSourceAreas, nSourceCount,
+			blockV.dSourceMass[b], blockV.dSourceMin[b], blockV.dSourceMax[b]);
+	}
 
-			// Write the data
-			if (fTargetDouble) {
-				varOut->set_cur(&(nCountsOut[0]));
-				varOut->put(&(dataOutDouble[0]), &(nPut[0]));
+	ApplyVector(
+		blockU.dataInDouble(0), blockV.dataInDouble(0), nSourceCount,
+		blockU.dataOutDouble(0), blockV.dataOutDouble(0), nTargetCount,
+		nBatch);
+
+	// Compute output mass
+#pragma omp parallel for num_threads(m_nThreads) schedule(static, 1)
+	for (int b = 0; b < nBatch; b++) {
+		ComputeSliceStatistics(
+			blockU.dataOutDouble(b), m_dTargetAreas, nTargetCount,
+			blockU.dTargetMass[b], blockU.dTargetMin[b], blockU.dTargetMax[b]);
+		ComputeSliceStatistics(
+			blockV.dataOutDouble(b), m_dTargetAreas, nTargetCount,
+			blockV.dTargetMass[b], blockV.dTargetMin[b], blockV.dTargetMax[b]);
+	}
+}
 
-			} else {
-				// Cast the data to float
-				for (int i = 0; i < dataOut.GetRows(); i++) {
-					dataOut[i] = static_cast<float>(dataOutDouble[i]);
-				}
+///////////////////////////////////////////////////////////////////////////////
 
-				// Write the data as float
-				varOut->set_cur(&(nCountsOut[0]));
-				varOut->put(&(dataOut[0]), &(nPut[0]));
-			}
+///	<summary>
+///		Number of sparse matrix entries in each NetCDF-4 chunk of row, col
+///		and S, which is also the number of entries read or written per
+///		get() or put() of a partial read or a write.
+///	</summary>
+static const int SparseMatrixChunkSize = 262144;
+
+///	<summary>
+///		Round a value to the given number of mantissa bits (BitRound), with
+///		ties rounded away from zero.  A bit count of zero leaves the value
+///		unchanged.
+///	</summary>
+static inline double QuantizeMantissa(
+	double dValue,
+	int nBits
+) {
+	const int nDropBits = 52 - nBits;
+	if ((nBits == 0) || (nDropBits <= 0)) {
+		return dValue;
+	}
+
+	unsigned long long ullBits;
+	memcpy(&ullBits, &dValue, sizeof(double));
+
+	ullBits += (1ULL << (nDropBits - 1));
+	ullBits &= ~((1ULL << nDropBits) - 1ULL);
+
+	memcpy(&dValue, &ullBits, sizeof(double));
+	return dValue;
+}
+
+///	<summary>
+///		Chunk a NetCDF-4 sparse matrix variable along n_s and enable the
+///		shuffle and deflate filters if nDeflateLevel is nonzero.
+///	</summary>
+static void DefineSparseMatrixStorage(
+	NcFile & ncMap,
+	NcVar * var,
+	int nS,
+	int nDeflateLevel
+) {
+	size_t sChunkSize = static_cast<size_t>(std::min(nS, SparseMatrixChunkSize));
+
+	int iStatus = nc_def_var_chunking(
+		ncMap.id(), var->id(), NC_CHUNKED, &sChunkSize);
+	if (iStatus != NC_NOERR) {
+		_EXCEPTION2("Unable to chunk variable \"%s\": %s",
+			var->name(), nc_strerror(iStatus));
+	}
+
+	if (nDeflateLevel != 0) {
+		iStatus = nc_def_var_deflate(
+			ncMap.id(), var->id(), 1, 1, nDeflateLevel);
+		if (iStatus != NC_NOERR) {
+			_EXCEPTION2("Unable to compress variable \"%s\": %s",
+				var->name(), nc_strerror(iStatus));
 		}
-		AnnounceEndBlock(NULL);
 	}
 }
 
 ///////////////////////////////////////////////////////////////////////////////
 
-void OfflineMap::Read(
-	const std::string & strSource,
-	std::map<std::string, std::string> * pmapAttributes,
-	NcFile::FileFormat * peFileFormat
+///	<summary>
+///		Define the fractional coverage arrays and the sparse matrix of a
+///		map file with nS entries.
+///	</summary>
+static void DefineSparseMatrixVariables(
+	NcFile & ncMap,
+	NcDim * dimNA,
+	NcDim * dimNB,
+	int nS,
+	NcFile::FileFormat eOutputFormat,
+	int nDeflateLevel,
+	int nQuantizeBits,
+	NcVar *& varFracA,
+	NcVar *& varFracB,
+	NcVar *& varRow,
+	NcVar *& varCol,
+	NcVar *& varS
 ) {
-	NcFile ncMap(strSource.c_str(), NcFile::ReadOnly);
-	if (!ncMap.is_valid()) {
-		_EXCEPTION1("Unable to open input map file \"%s\"",
-			strSource.c_str());
+	// Define fractional coverage arrays
+	varFracA = ncMap.add_var("frac_a", ncDouble, dimNA);
+	varFracA->add_att("name", "fraction of target coverage of source dof");
+	varFracA->add_att("units", "unitless");
+
+	varFracB = ncMap.add_var("frac_b", ncDouble, dimNB);
+	varFracB->add_att("name", "fraction of source coverage of target dof");
+	varFracB->add_att("units", "unitless");
+
+	// Define sparse matrix
+	NcDim * dimNS = ncMap.add_dim("n_s", nS);
+
+	varRow = ncMap.add_var("row", ncInt, dimNS);
+	varRow->add_att("name", "sparse matrix target dof index");
+	varRow->add_att("first_index", "1");
+
+	varCol = ncMap.add_var("col", ncInt, dimNS);
+	varCol->add_att("name", "sparse matrix source dof index");
+	varCol->add_att("first_index", "1");
+
+	varS = ncMap.add_var("S", ncDouble, dimNS);
+	varS->add_att("name", "sparse matrix coefficient");
+
+	if (nQuantizeBits != 0) {
+		varS->add_att("quantized_mantissa_bits", nQuantizeBits);
 	}
 
-	// Read netcdf file format
-	NcFile::FileFormat eFileFormat = ncMap.get_format();
+	// Chunking and compression are only available in NetCDF-4 files
+	if ((eOutputFormat == NcFile::Netcdf4) ||
+	    (eOutputFormat == NcFile::Netcdf4Classic)
+	) {
+		if (nS != 0) {
+			DefineSparseMatrixStorage(ncMap, varRow, nS, nDeflateLevel);
+			DefineSparseMatrixStorage(ncMap, varCol, nS, nDeflateLevel);
+			DefineSparseMatrixStorage(ncMap, varS, nS, nDeflateLevel);
+		}
 
-	if (peFileFormat != NULL) {
-		*peFileFormat = eFileFormat;
+	} else if (nDeflateLevel != 0) {
+		Announce("WARNING: Deflate requires NetCDF-4 output; "
+			"map written without compression");
 	}
+}
 
-	// Read input dimensions entries
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Comparator for sorting (column, entry) pairs by column.
+///	</summary>
+static bool CompareFirstOfPair(
+	const std::pair<int, double> & a,
+	const std::pair<int, double> & b
+) {
+	return (a.first < b.first);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Index of the first entry of a row-sorted map file with target row
+///		(zero-based) greater than or equal to iRow, or nS if there is none.
+///	</summary>
+static int FindFirstEntryInRow(
+	NcVar * varRow,
+	int nS,
+	int iRow
+) {
+	int ixLow = 0;
+	int ixHigh = nS;
+
+	while (ixLow < ixHigh) {
+		const int ixMid = ixLow + (ixHigh - ixLow) / 2;
+
+		int iRowMid;
+		varRow->set_cur((long)ixMid);
+		varRow->get(&iRowMid, 1);
+
+		if (iRowMid - 1 < iRow) {
+			ixLow = ixMid + 1;
+		} else {
+			ixHigh = ixMid;
+		}
+	}
+
+	return ixLow;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void OfflineMap::ReadGridDimensions(
+	NcFile & ncMap,
+	const std::string & strSource
+) {
 	NcDim * dimSrcGridRank = ncMap.get_dim("src_grid_rank");
 	if (dimSrcGridRank == NULL) {
 		_EXCEPTION1("Map file \"%s\" does not contain variable"
@@ -1818,6 +3050,17 @@ void OfflineMap::Read(
 		}
 	}
 
+	// Range of the source data spanned by the source grid of a sub-map
+	m_nSourceGridOffset = 0;
+	m_nSourceGridFullSize = 0;
+
+	NcAtt * attSubsetStart = varSrcGridDims->get_att("subset_start");
+	NcAtt * attSubsetFullSize = varSrcGridDims->get_att("subset_full_size");
+	if ((attSubsetStart != NULL) && (attSubsetFullSize != NULL)) {
+		m_nSourceGridOffset = attSubsetStart->as_int(0);
+		m_nSourceGridFullSize = attSubsetFullSize->as_int(0);
+	}
+
 	for (int i = 0; i < nDstGridDims/2; i++) {
 		int iTemp = m_vecTargetDimSizes[i];
 		m_vecTargetDimSizes[i] = m_vecTargetDimSizes[nDstGridDims - i - 1];
@@ -1835,113 +3078,99 @@ void OfflineMap::Read(
 			m_vecTargetDimNames[i] = szDim;
 		}
 	}
+}
 
-	// Source and Target mesh resolutions
-	NcDim * dimNA = ncMap.get_dim("n_a");
-	if (dimNA == NULL) {
-		_EXCEPTIONT("Input map missing dimension \"n_a\"");
+///////////////////////////////////////////////////////////////////////////////
+
+void OfflineMap::ReadCoordinates(
+	NcFile & ncMap,
+	const std::string & strSource,
+	const std::string & strSide,
+	DataArray1D<double> & dCenterLon,
+	DataArray1D<double> & dCenterLat,
+	DataArray2D<double> & dVertexLon,
+	DataArray2D<double> & dVertexLat
+) {
+	const std::string strDimN = "n_" + strSide;
+	const std::string strDimNV = "nv_" + strSide;
+
+	NcDim * dimN = ncMap.get_dim(strDimN.c_str());
+	if (dimN == NULL) {
+		_EXCEPTION1("Input map missing dimension \"%s\"", strDimN.c_str());
 	}
 
-	NcDim * dimNB = ncMap.get_dim("n_b");
-	if (dimNB == NULL) {
-		_EXCEPTIONT("Input map missing dimension \"n_b\"");
+	NcDim * dimNV = ncMap.get_dim(strDimNV.c_str());
+	if (dimNV == NULL) {
+		_EXCEPTION1("Input map missing dimension \"%s\"", strDimNV.c_str());
 	}
 
-	int nA = dimNA->size();
-	int nB = dimNB->size();
+	const int nN = dimN->size();
+	const int nNV = dimNV->size();
 
-	NcDim * dimNVA = ncMap.get_dim("nv_a");
-	if (dimNA == NULL) {
-		_EXCEPTIONT("Input map missing dimension \"nv_a\"");
-	}
+	const std::string strVarNames[4] = {
+		"yc_" + strSide, "xc_" + strSide, "yv_" + strSide, "xv_" + strSide };
 
-	NcDim * dimNVB = ncMap.get_dim("nv_b");
-	if (dimNB == NULL) {
-		_EXCEPTIONT("Input map missing dimension \"nv_b\"");
+	NcVar * vars[4];
+	for (int v = 0; v < 4; v++) {
+		vars[v] = ncMap.get_var(strVarNames[v].c_str());
+		if (vars[v] == NULL) {
+			_EXCEPTION2("Map file \"%s\" does not contain variable \"%s\":"
+				"\nPossibly an earlier version of map",
+				strSource.c_str(), strVarNames[v].c_str());
+		}
 	}
 
-	int nVA = dimNVA->size();
-	int nVB = dimNVB->size();
+	dCenterLat.Allocate(nN);
+	dCenterLon.Allocate(nN);
 
-	// Read coordinates
-	NcVar * varYCA = ncMap.get_var("yc_a");
-	NcVar * varYCB = ncMap.get_var("yc_b");
+	dVertexLat.Allocate(nN, nNV);
+	dVertexLon.Allocate(nN, nNV);
 
-	NcVar * varXCA = ncMap.get_var("xc_a");
-	NcVar * varXCB = ncMap.get_var("xc_b");
+	vars[0]->get(&(dCenterLat[0]), nN);
+	vars[1]->get(&(dCenterLon[0]), nN);
 
-	NcVar * varYVA = ncMap.get_var("yv_a");
-	NcVar * varYVB = ncMap.get_var("yv_b");
+	vars[2]->get(&(dVertexLat[0][0]), nN, nNV);
+	vars[3]->get(&(dVertexLon[0][0]), nN, nNV);
+}
 
-	NcVar * varXVA = ncMap.get_var("xv_a");
-	NcVar * varXVB = ncMap.get_var("xv_b");
+///////////////////////////////////////////////////////////////////////////////
 
-	if (varYCA == NULL) {
-		_EXCEPTION1("Map file \"%s\" does not contain variable \"yc_a\":"
-			"\nPossibly an earlier version of map",
-			strSource.c_str());
-	}
-	if (varYCB == NULL) {
-		_EXCEPTION1("Map file \"%s\" does not contain variable \"yc_b\":"
-			"\nPossibly an earlier version of map",
-			strSource.c_str());
-	}
-	if (varXCA == NULL) {
-		_EXCEPTION1("Map file \"%s\" does not contain variable \"xc_a\":"
-			"\nPossibly an earlier version of map",
-			strSource.c_str());
-	}
-	if (varXCB == NULL) {
-		_EXCEPTION1("Map file \"%s\" does not contain variable \"xc_b\":"
-			"\nPossibly an earlier version of map",
-			strSource.c_str());
-	}
-	if (varYVA == NULL) {
-		_EXCEPTION1("Map file \"%s\" does not contain variable \"yv_a\":"
-			"\nPossibly an earlier version of map",
-			strSource.c_str());
-	}
-	if (varYVB == NULL) {
-		_EXCEPTION1("Map file \"%s\" does not contain variable \"yv_b\":"
-			"\nPossibly an earlier version of map",
-			strSource.c_str());
-	}
-	if (varXVA == NULL) {
-		_EXCEPTION1("Map file \"%s\" does not contain variable \"xv_a\":"
-			"\nPossibly an earlier version of map",
-			strSource.c_str());
+void OfflineMap::ReadPendingCoordinates(
+	bool fSource
+) {
+	std::string & strFile =
+		fSource ? m_strSourceCoordinateFile : m_strTargetCoordinateFile;
+	const std::string & strSide =
+		fSource ? m_strSourceCoordinateSide : m_strTargetCoordinateSide;
+
+	if (strFile == "") {
+		return;
 	}
-	if (varXVB == NULL) {
-		_EXCEPTION1("Map file \"%s\" does not contain variable \"xv_b\":"
-			"\nPossibly an earlier version of map",
-			strSource.c_str());
+
+	NcFile ncMap(strFile.c_str(), NcFile::ReadOnly);
+	if (!ncMap.is_valid()) {
+		_EXCEPTION1("Unable to open input map file \"%s\"",
+			strFile.c_str());
 	}
 
-	m_dSourceCenterLat.Allocate(nA);
-	m_dTargetCenterLat.Allocate(nB);
+	if (fSource) {
+		ReadCoordinates(ncMap, strFile, strSide,
+			m_dSourceCenterLon, m_dSourceCenterLat,
+			m_dSourceVertexLon, m_dSourceVertexLat);
+	} else {
+		ReadCoordinates(ncMap, strFile, strSide,
+			m_dTargetCenterLon, m_dTargetCenterLat,
+			m_dTargetVertexLon, m_dTargetVertexLat);
+	}
 
-	m_dSourceCenterLon.Allocate(nA);
-	m_dTargetCenterLon.Allocate(nB);
+	strFile = "";
+}
 
-	m_dSourceVertexLat.Allocate(nA, nVA);
-	m_dTargetVertexLat.Allocate(nB, nVB);
+///////////////////////////////////////////////////////////////////////////////
 
-	m_dSourceVertexLon.Allocate(nA, nVA);
-	m_dTargetVertexLon.Allocate(nB, nVB);
-
-	varYCA->get(&(m_dSourceCenterLat[0]), nA);
-	varYCB->get(&(m_dTargetCenterLat[0]), nB);
-
-	varXCA->get(&(m_dSourceCenterLon[0]), nA);
-	varXCB->get(&(m_dTargetCenterLon[0]), nB);
-
-	varYVA->get(&(m_dSourceVertexLat[0][0]), nA, nVA);
-	varYVB->get(&(m_dTargetVertexLat[0][0]), nB, nVB);
-
-	varXVA->get(&(m_dSourceVertexLon[0][0]), nA, nVA);
-	varXVB->get(&(m_dTargetVertexLon[0][0]), nB, nVB);
-
-	// Read vector centers and bounds
+void OfflineMap::ReadTargetVectorCoordinates(
+	NcFile & ncMap
+) {
 	NcDim * dimLatB = ncMap.get_dim("lat_b");
 	NcDim * dimLonB = ncMap.get_dim("lon_b");
 
@@ -1966,8 +3195,19 @@ void OfflineMap::Read(
 		varLonBounds->get(&(m_dVectorTargetBoundsLon[0][0]),
 			dimLonB->size(), 2);
 	}
+}
 
+///////////////////////////////////////////////////////////////////////////////
+
+void OfflineMap::ReadAreasAndMasks(
+	NcFile & ncMap,
+	const std::string & strSource,
+	int nA,
+	int nB
+) {
 	// Read areas
+	m_fCoverageCached = false;
+
 	m_dSourceAreas.Allocate(nA);
 	m_dTargetAreas.Allocate(nB);
 
@@ -1997,8 +3237,19 @@ void OfflineMap::Read(
 		m_iTargetMask.Allocate(nB);
 		varMaskB->get(&(m_iTargetMask[0]), nB);
 	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void OfflineMap::ReadSparseMatrix(
+	NcFile & ncMap,
+	const std::string & strSource,
+	int iTargetRowBegin,
+	int iTargetRowEnd,
+	const std::vector<int> * pvecTargetRows
+) {
+	m_fCoverageCached = false;
 
-	// Read SparseMatrix entries
 	NcDim * dimNS = ncMap.get_dim("n_s");
 	if (dimNS == NULL) {
 		_EXCEPTION1("Map file \"%s\" does not contain dimension \"n_s\"",
@@ -2012,40 +3263,204 @@ void OfflineMap::Read(
 	}
 
 	NcVar * varCol = ncMap.get_var("col");
-	if (varRow == NULL) {
+	if (varCol == NULL) {
 		_EXCEPTION1("Map file \"%s\" does not contain variable \"col\"",
 			strSource.c_str());
 	}
 
 	NcVar * varS = ncMap.get_var("S");
-	if (varRow == NULL) {
+	if (varS == NULL) {
 		_EXCEPTION1("Map file \"%s\" does not contain variable \"S\"",
 			strSource.c_str());
 	}
 
 	int nS = dimNS->size();
 
-	DataArray1D<int> vecRow(nS);
-	DataArray1D<int> vecCol(nS);
-	DataArray1D<double> vecS(nS);
+	// Weights read from file are always stored in double precision
+	m_mapRemapSingle.Clear();
+	m_fSinglePrecision = false;
+
+	m_mapRemap.Clear();
+	m_pWeightsImage.reset();
+
+	// Read all entries
+	if (iTargetRowEnd < 0) {
+		DataArray1D<int> vecRow(nS);
+		DataArray1D<int> vecCol(nS);
+		DataArray1D<double> vecS(nS);
+
+		varRow->set_cur((long)0);
+		varRow->get(&(vecRow[0]), nS);
+
+		varCol->set_cur((long)0);
+		varCol->get(&(vecCol[0]), nS);
+
+		varS->set_cur((long)0);
+		varS->get(&(vecS[0]), nS);
+
+		// Decrement vecRow and vecCol
+		for (int i = 0; i < vecRow.GetRows(); i++) {
+			vecRow[i]--;
+			vecCol[i]--;
+		}
+
+		// Set the entries of the map
+		m_mapRemap.SetEntries(vecRow, vecCol, vecS);
+		return;
+	}
+
+	// Locate the entries of the row range in a row-sorted file
+	const int ixBegin = FindFirstEntryInRow(varRow, nS, iTargetRowBegin);
+	const int ixEnd = FindFirstEntryInRow(varRow, nS, iTargetRowEnd);
+
+	// Read the entries of the row range one chunk at a time
+	std::vector<int> vecRowSelected;
+	std::vector<int> vecColSelected;
+	std::vector<double> vecSSelected;
+
+	const int nChunkMax = std::min(ixEnd - ixBegin, SparseMatrixChunkSize);
+
+	std::vector<int> vecRowChunk(std::max(nChunkMax, 1));
+	std::vector<int> vecColChunk(vecRowChunk.size());
+	std::vector<double> vecSChunk(vecRowChunk.size());
+
+	int iRowPrev = iTargetRowBegin;
+
+	for (int ix = ixBegin; ix < ixEnd; ix += SparseMatrixChunkSize) {
+		const int nChunk = std::min(SparseMatrixChunkSize, ixEnd - ix);
+
+		varRow->set_cur((long)ix);
+		varRow->get(&(vecRowChunk[0]), nChunk);
+
+		varCol->set_cur((long)ix);
+		varCol->get(&(vecColChunk[0]), nChunk);
 
-	varRow->set_cur((long)0);
-	varRow->get(&(vecRow[0]), nS);
+		varS->set_cur((long)ix);
+		varS->get(&(vecSChunk[0]), nChunk);
 
-	varCol->set_cur((long)0);
-	varCol->get(&(vecCol[0]), nS);
+		for (int k = 0; k < nChunk; k++) {
+			const int iRow = vecRowChunk[k] - 1;
 
-	varS->set_cur((long)0);
-	varS->get(&(vecS[0]), nS);
+			if ((iRow < iRowPrev) || (iRow >= iTargetRowEnd)) {
+				_EXCEPTION1("Map file \"%s\" is not sorted by row, "
+					"which is required to read a subset of rows",
+					strSource.c_str());
+			}
+			iRowPrev = iRow;
+
+			if ((pvecTargetRows != NULL) &&
+			    (!std::binary_search(
+					pvecTargetRows->begin(), pvecTargetRows->end(), iRow))
+			) {
+				continue;
+			}
 
-	// Decrement vecRow and vecCol
-	for (int i = 0; i < vecRow.GetRows(); i++) {
-		vecRow[i]--;
-		vecCol[i]--;
+			vecRowSelected.push_back(iRow);
+			vecColSelected.push_back(vecColChunk[k] - 1);
+			vecSSelected.push_back(vecSChunk[k]);
+		}
 	}
 
 	// Set the entries of the map
+	DataArray1D<int> vecRow(vecRowSelected.size());
+	DataArray1D<int> vecCol(vecRowSelected.size());
+	DataArray1D<double> vecS(vecRowSelected.size());
+
+	for (size_t i = 0; i < vecRowSelected.size(); i++) {
+		vecRow[i] = vecRowSelected[i];
+		vecCol[i] = vecColSelected[i];
+		vecS[i] = vecSSelected[i];
+	}
+
 	m_mapRemap.SetEntries(vecRow, vecCol, vecS);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void OfflineMap::Read(
+	const std::string & strSource,
+	std::map<std::string, std::string> * pmapAttributes,
+	NcFile::FileFormat * peFileFormat
+) {
+	ReadMapFile(strSource, pmapAttributes, peFileFormat, true);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void OfflineMap::ReadGrid(
+	const std::string & strSource,
+	std::map<std::string, std::string> * pmapAttributes,
+	NcFile::FileFormat * peFileFormat
+) {
+	ReadMapFile(strSource, pmapAttributes, peFileFormat, false);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void OfflineMap::ReadMapFile(
+	const std::string & strSource,
+	std::map<std::string, std::string> * pmapAttributes,
+	NcFile::FileFormat * peFileFormat,
+	bool fReadSparseMatrix
+) {
+	NcFile ncMap(strSource.c_str(), NcFile::ReadOnly);
+	if (!ncMap.is_valid()) {
+		_EXCEPTION1("Unable to open input map file \"%s\"",
+			strSource.c_str());
+	}
+
+	// Read netcdf file format
+	NcFile::FileFormat eFileFormat = ncMap.get_format();
+
+	if (peFileFormat != NULL) {
+		*peFileFormat = eFileFormat;
+	}
+
+	// Read input dimensions entries
+	ReadGridDimensions(ncMap, strSource);
+
+	// Source and Target mesh resolutions
+	NcDim * dimNA = ncMap.get_dim("n_a");
+	if (dimNA == NULL) {
+		_EXCEPTIONT("Input map missing dimension \"n_a\"");
+	}
+
+	NcDim * dimNB = ncMap.get_dim("n_b");
+	if (dimNB == NULL) {
+		_EXCEPTIONT("Input map missing dimension \"n_b\"");
+	}
+
+	int nA = dimNA->size();
+	int nB = dimNB->size();
+
+	// Read coordinates
+	ReadCoordinates(ncMap, strSource, "a",
+		m_dSourceCenterLon, m_dSourceCenterLat,
+		m_dSourceVertexLon, m_dSourceVertexLat);
+
+	ReadCoordinates(ncMap, strSource, "b",
+		m_dTargetCenterLon, m_dTargetCenterLat,
+		m_dTargetVertexLon, m_dTargetVertexLat);
+
+	m_strSourceCoordinateFile = "";
+	m_strTargetCoordinateFile = "";
+
+	// Read vector centers and bounds
+	ReadTargetVectorCoordinates(ncMap);
+
+	// Read areas and masks
+	ReadAreasAndMasks(ncMap, strSource, nA, nB);
+
+	// Read SparseMatrix entries
+	if (fReadSparseMatrix) {
+		ReadSparseMatrix(ncMap, strSource, 0, -1, NULL);
+
+	} else {
+		m_mapRemap.Clear();
+		m_mapRemapSingle.Clear();
+		m_fSinglePrecision = false;
+		m_pWeightsImage.reset();
+	}
 
 	// Load file attributes
 	if (pmapAttributes != NULL) {
@@ -2066,23 +3481,384 @@ void OfflineMap::Read(
 
 ///////////////////////////////////////////////////////////////////////////////
 
-void OfflineMap::Write(
-	const std::string & strTarget,
-	const std::map<std::string, std::string> & mapAttributes,
-	NcFile::FileFormat eOutputFormat
+void OfflineMap::ReadWeights(
+	const std::string & strSource
 ) {
-	// Temporarily change error reporting
-	NcError error_temp(NcError::verbose_fatal);
+	ReadWeightsForRows(strSource, 0, -1, NULL);
+}
 
-	// Open an output file
-	NcFile ncMap(strTarget.c_str(), NcFile::Replace, NULL, 0, eOutputFormat);
+///////////////////////////////////////////////////////////////////////////////
+
+void OfflineMap::ReadWeights(
+	const std::string & strSource,
+	int iTargetRowBegin,
+	int iTargetRowEnd
+) {
+	if ((iTargetRowBegin < 0) || (iTargetRowEnd < iTargetRowBegin)) {
+		_EXCEPTION2("Invalid target row range [%i, %i)",
+			iTargetRowBegin, iTargetRowEnd);
+	}
+
+	ReadWeightsForRows(strSource, iTargetRowBegin, iTargetRowEnd, NULL);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void OfflineMap::ReadWeights(
+	const std::string & strSource,
+	const std::vector<int> & vecTargetRows
+) {
+	std::vector<int> vecTargetRowsSorted(vecTargetRows);
+	std::sort(vecTargetRowsSorted.begin(), vecTargetRowsSorted.end());
+	vecTargetRowsSorted.erase(
+		std::unique(vecTargetRowsSorted.begin(), vecTargetRowsSorted.end()),
+		vecTargetRowsSorted.end());
+
+	if (vecTargetRowsSorted.size() == 0) {
+		ReadWeightsForRows(strSource, 0, 0, NULL);
+		return;
+	}
+	if (vecTargetRowsSorted[0] < 0) {
+		_EXCEPTION1("Invalid target row (%i)", vecTargetRowsSorted[0]);
+	}
+
+	ReadWeightsForRows(
+		strSource,
+		vecTargetRowsSorted.front(),
+		vecTargetRowsSorted.back() + 1,
+		&vecTargetRowsSorted);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void OfflineMap::ReadWeightsForRows(
+	const std::string & strSource,
+	int iTargetRowBegin,
+	int iTargetRowEnd,
+	const std::vector<int> * pvecTargetRows
+) {
+	NcFile ncMap(strSource.c_str(), NcFile::ReadOnly);
 	if (!ncMap.is_valid()) {
-		_EXCEPTION1("Unable to open output map file \"%s\"",
-			strTarget.c_str());
+		_EXCEPTION1("Unable to open input map file \"%s\"",
+			strSource.c_str());
 	}
 
-	// Attributes
-	ncMap.add_att("Title", "TempestRemap Offline Regridding Weight Generator");
+	// Read input dimensions entries
+	ReadGridDimensions(ncMap, strSource);
+
+	// Source and Target mesh resolutions
+	NcDim * dimNA = ncMap.get_dim("n_a");
+	if (dimNA == NULL) {
+		_EXCEPTIONT("Input map missing dimension \"n_a\"");
+	}
+
+	NcDim * dimNB = ncMap.get_dim("n_b");
+	if (dimNB == NULL) {
+		_EXCEPTIONT("Input map missing dimension \"n_b\"");
+	}
+
+	int nA = dimNA->size();
+	int nB = dimNB->size();
+
+	if (iTargetRowEnd > nB) {
+		_EXCEPTION2("Target row range exceeds target mesh size (%i > %i)",
+			iTargetRowEnd, nB);
+	}
+
+	// Center and vertex coordinates are read on first access
+	m_dSourceCenterLon.Deallocate();
+	m_dSourceCenterLat.Deallocate();
+	m_dSourceVertexLon.Deallocate();
+	m_dSourceVertexLat.Deallocate();
+	m_dTargetCenterLon.Deallocate();
+	m_dTargetCenterLat.Deallocate();
+	m_dTargetVertexLon.Deallocate();
+	m_dTargetVertexLat.Deallocate();
+
+	// Target centers are written to the output of Apply()
+	const char * szCoordinateVars[2] = { "yc_b", "xc_b" };
+
+	for (int v = 0; v < 2; v++) {
+		if (ncMap.get_var(szCoordinateVars[v]) == NULL) {
+			_EXCEPTION2("Map file \"%s\" does not contain variable \"%s\":"
+				"\nPossibly an earlier version of map",
+				strSource.c_str(), szCoordinateVars[v]);
+		}
+	}
+
+	m_strSourceCoordinateFile = strSource;
+	m_strSourceCoordinateSide = "a";
+	m_strTargetCoordinateFile = strSource;
+	m_strTargetCoordinateSide = "b";
+
+	// Read vector centers and bounds
+	ReadTargetVectorCoordinates(ncMap);
+
+	// Read areas and masks
+	ReadAreasAndMasks(ncMap, strSource, nA, nB);
+
+	// Read SparseMatrix entries
+	ReadSparseMatrix(
+		ncMap, strSource, iTargetRowBegin, iTargetRowEnd, pvecTargetRows);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void OfflineMap::ReadWeightsCached(
+	const std::string & strSource,
+	const std::string & strCacheDir
+) {
+	const std::string strImage =
+		OfflineMapImage::GetImagePath(strCacheDir, strSource);
+
+	std::shared_ptr<OfflineMapImage> pImage(new OfflineMapImage);
+
+	// Attach an existing image built from the current map file
+	try {
+		if (pImage->Open(strImage)) {
+			if (pImage->IsCurrent()) {
+				Announce("Attaching map image \"%s\"", strImage.c_str());
+				AttachWeightsImage(pImage);
+				return;
+			}
+			Announce("Map image \"%s\" is out of date", strImage.c_str());
+			pImage->Close();
+		}
+
+	} catch(Exception & e) {
+		Announce("%s", e.ToString().c_str());
+		pImage->Close();
+	}
+
+	// Read the map file and build its image
+	ReadWeights(strSource);
+
+	try {
+		Announce("Building map image \"%s\"", strImage.c_str());
+		WriteWeightsImage(strImage, strSource);
+
+	} catch(Exception & e) {
+		Announce("WARNING: Map image not written; %s", e.ToString().c_str());
+		return;
+	}
+
+	// Attach the new image, so that this process shares its pages too
+	if (pImage->Open(strImage)) {
+		AttachWeightsImage(pImage);
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void OfflineMap::WriteWeightsImage(
+	const std::string & strImage,
+	const std::string & strSource
+) {
+	if (m_fSinglePrecision) {
+		_EXCEPTIONT("Map images hold double precision weights");
+	}
+
+	m_mapRemap.Freeze();
+
+	const int nA = static_cast<int>(m_dSourceAreas.GetRows());
+	const int nB = static_cast<int>(m_dTargetAreas.GetRows());
+
+	if ((m_iSourceMask.GetRows() != 0) && (m_iSourceMask.GetRows() != nA)) {
+		_EXCEPTIONT("Source mask and areas differ in size");
+	}
+	if ((m_iTargetMask.GetRows() != 0) && (m_iTargetMask.GetRows() != nB)) {
+		_EXCEPTIONT("Target mask and areas differ in size");
+	}
+
+	// Identify the source map
+	OfflineMapImageHeader header;
+	OfflineMapImage::InitializeHeader(header);
+
+	std::string strAbsolutePath;
+	OfflineMapImage::GetFileStatus(strSource, strAbsolutePath, header);
+
+	header.uSourceChecksum =
+		OfflineMapImage::ComputeFileChecksum(strAbsolutePath);
+
+	header.nA = nA;
+	header.nB = nB;
+	header.nRows = m_mapRemap.GetRows();
+	header.nCols = m_mapRemap.GetColumns();
+	header.sNonZeros = m_mapRemap.GetNonZeroCount();
+	header.nSourceDims = static_cast<int32_t>(m_vecSourceDimSizes.size());
+	header.nTargetDims = static_cast<int32_t>(m_vecTargetDimSizes.size());
+	header.fSourceMask = (m_iSourceMask.GetRows() != 0)?(1):(0);
+	header.fTargetMask = (m_iTargetMask.GetRows() != 0)?(1):(0);
+	header.nVectorLat =
+		static_cast<int32_t>(m_dVectorTargetCenterLat.GetRows());
+	header.nVectorLon =
+		static_cast<int32_t>(m_dVectorTargetCenterLon.GetRows());
+	header.nSourcePathLength = static_cast<int32_t>(strAbsolutePath.length());
+	header.nSourceGridOffset = m_nSourceGridOffset;
+	header.nSourceGridFullSize = m_nSourceGridFullSize;
+
+	// Grid dimensions, source followed by target
+	std::vector<int32_t> vecDimSizes;
+	std::vector<char> vecDimNames(
+		(header.nSourceDims + header.nTargetDims)
+			* OfflineMapImageDimNameLength, '\0');
+
+	for (int side = 0; side < 2; side++) {
+		const std::vector<int> & vecSizes =
+			(side == 0)?(m_vecSourceDimSizes):(m_vecTargetDimSizes);
+		const std::vector<std::string> & vecNames =
+			(side == 0)?(m_vecSourceDimNames):(m_vecTargetDimNames);
+
+		for (size_t d = 0; d < vecSizes.size(); d++) {
+			if (vecNames[d].length() >= OfflineMapImageDimNameLength) {
+				_EXCEPTION1("Grid dimension name \"%s\" too long for map image",
+					vecNames[d].c_str());
+			}
+			memcpy(
+				&(vecDimNames[vecDimSizes.size() * OfflineMapImageDimNameLength]),
+				vecNames[d].c_str(),
+				vecNames[d].length());
+			vecDimSizes.push_back(vecSizes[d]);
+		}
+	}
+
+	const void * pSections[OfflineMapImageSection_Count];
+
+	pSections[OfflineMapImageSection_SourcePath] = strAbsolutePath.c_str();
+	pSections[OfflineMapImageSection_DimSizes] =
+		(vecDimSizes.size() == 0)?(NULL):(&(vecDimSizes[0]));
+	pSections[OfflineMapImageSection_DimNames] =
+		(vecDimNames.size() == 0)?(NULL):(&(vecDimNames[0]));
+	pSections[OfflineMapImageSection_SourceAreas] =
+		static_cast<const double *>(m_dSourceAreas);
+	pSections[OfflineMapImageSection_TargetAreas] =
+		static_cast<const double *>(m_dTargetAreas);
+	pSections[OfflineMapImageSection_SourceMask] =
+		static_cast<const int *>(m_iSourceMask);
+	pSections[OfflineMapImageSection_TargetMask] =
+		static_cast<const int *>(m_iTargetMask);
+	pSections[OfflineMapImageSection_VectorCenterLat] =
+		static_cast<const double *>(m_dVectorTargetCenterLat);
+	pSections[OfflineMapImageSection_VectorCenterLon] =
+		static_cast<const double *>(m_dVectorTargetCenterLon);
+	pSections[OfflineMapImageSection_VectorBoundsLat] =
+		(header.nVectorLat == 0)?(NULL):(&(m_dVectorTargetBoundsLat[0][0]));
+	pSections[OfflineMapImageSection_VectorBoundsLon] =
+		(header.nVectorLon == 0)?(NULL):(&(m_dVectorTargetBoundsLon[0][0]));
+	pSections[OfflineMapImageSection_RowPtr] =
+		static_cast<const int *>(m_mapRemap.GetRowPointers());
+	pSections[OfflineMapImageSection_ColIx] =
+		static_cast<const int *>(m_mapRemap.GetColumnIndices());
+	pSections[OfflineMapImageSection_Values] =
+		static_cast<const double *>(m_mapRemap.GetValues());
+
+	OfflineMapImage::Write(strImage, header, pSections);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void OfflineMap::AttachWeightsImage(
+	const std::shared_ptr<OfflineMapImage> & pImage
+) {
+	const OfflineMapImageHeader & header = pImage->GetHeader();
+
+	// Grid dimensions
+	pImage->GetDimensions(true, m_vecSourceDimSizes, m_vecSourceDimNames);
+	m_nSourceGridOffset = header.nSourceGridOffset;
+	m_nSourceGridFullSize = header.nSourceGridFullSize;
+	pImage->GetDimensions(false, m_vecTargetDimSizes, m_vecTargetDimNames);
+
+	// Center and vertex coordinates are read on first access
+	m_dSourceCenterLon.Deallocate();
+	m_dSourceCenterLat.Deallocate();
+	m_dSourceVertexLon.Deallocate();
+	m_dSourceVertexLat.Deallocate();
+	m_dTargetCenterLon.Deallocate();
+	m_dTargetCenterLat.Deallocate();
+	m_dTargetVertexLon.Deallocate();
+	m_dTargetVertexLat.Deallocate();
+
+	m_strSourceCoordinateFile = pImage->GetSourcePath();
+	m_strSourceCoordinateSide = "a";
+	m_strTargetCoordinateFile = m_strSourceCoordinateFile;
+	m_strTargetCoordinateSide = "b";
+
+	// Vector centers and bounds, areas and masks are copied
+	if ((header.nVectorLat != 0) && (header.nVectorLon != 0)) {
+		m_dVectorTargetCenterLat.Allocate(header.nVectorLat);
+		m_dVectorTargetCenterLon.Allocate(header.nVectorLon);
+		m_dVectorTargetBoundsLat.Allocate(header.nVectorLat, 2);
+		m_dVectorTargetBoundsLon.Allocate(header.nVectorLon, 2);
+
+		memcpy(&(m_dVectorTargetCenterLat[0]),
+			pImage->GetSection<const double>(
+				OfflineMapImageSection_VectorCenterLat),
+			pImage->GetSectionSize(OfflineMapImageSection_VectorCenterLat));
+		memcpy(&(m_dVectorTargetCenterLon[0]),
+			pImage->GetSection<const double>(
+				OfflineMapImageSection_VectorCenterLon),
+			pImage->GetSectionSize(OfflineMapImageSection_VectorCenterLon));
+		memcpy(&(m_dVectorTargetBoundsLat[0][0]),
+			pImage->GetSection<const double>(
+				OfflineMapImageSection_VectorBoundsLat),
+			pImage->GetSectionSize(OfflineMapImageSection_VectorBoundsLat));
+		memcpy(&(m_dVectorTargetBoundsLon[0][0]),
+			pImage->GetSection<const double>(
+				OfflineMapImageSection_VectorBoundsLon),
+			pImage->GetSectionSize(OfflineMapImageSection_VectorBoundsLon));
+	}
+
+	m_fCoverageCached = false;
+
+	m_dSourceAreas.Allocate(header.nA);
+	m_dTargetAreas.Allocate(header.nB);
+
+	if (header.nA != 0) {
+		memcpy(&(m_dSourceAreas[0]),
+			pImage->GetSection<const double>(OfflineMapImageSection_SourceAreas),
+			pImage->GetSectionSize(OfflineMapImageSection_SourceAreas));
+	}
+	if (header.nB != 0) {
+		memcpy(&(m_dTargetAreas[0]),
+			pImage->GetSection<const double>(OfflineMapImageSection_TargetAreas),
+			pImage->GetSectionSize(OfflineMapImageSection_TargetAreas));
+	}
+
+	if ((header.fSourceMask != 0) && (header.nA != 0)) {
+		m_iSourceMask.Allocate(header.nA);
+		memcpy(&(m_iSourceMask[0]),
+			pImage->GetSection<const int>(OfflineMapImageSection_SourceMask),
+			pImage->GetSectionSize(OfflineMapImageSection_SourceMask));
+	}
+	if ((header.fTargetMask != 0) && (header.nB != 0)) {
+		m_iTargetMask.Allocate(header.nB);
+		memcpy(&(m_iTargetMask[0]),
+			pImage->GetSection<const int>(OfflineMapImageSection_TargetMask),
+			pImage->GetSectionSize(OfflineMapImageSection_TargetMask));
+	}
+
+	// The weights are attached in place
+	m_mapRemapSingle.Clear();
+	m_fSinglePrecision = false;
+
+	m_mapRemap.AttachFrozen(
+		header.nRows,
+		header.nCols,
+		static_cast<size_t>(header.sNonZeros),
+		pImage->GetSection<int>(OfflineMapImageSection_RowPtr),
+		pImage->GetSection<int>(OfflineMapImageSection_ColIx),
+		pImage->GetSection<double>(OfflineMapImageSection_Values));
+
+	m_pWeightsImage = pImage;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void OfflineMap::WriteGrid(
+	NcFile & ncMap
+) {
+	RequireSourceCoordinates();
+	RequireTargetCoordinates();
 
 	// Map dimensions
 	int nA = (int)(m_dSourceAreas.GetRows());
@@ -2118,6 +3894,11 @@ void OfflineMap::Write(
 		}
 	}
 
+	if (m_nSourceGridFullSize != 0) {
+		varSrcGridDims->add_att("subset_start", m_nSourceGridOffset);
+		varSrcGridDims->add_att("subset_full_size", m_nSourceGridFullSize);
+	}
+
 	if ((nDstGridDims == 1) && (m_vecTargetDimSizes[0] != nB)) {
 		varDstGridDims->put(&nB, 1);
 		varDstGridDims->add_att("name0", "num_dof");
@@ -2277,64 +4058,377 @@ void OfflineMap::Write(
 		varMaskB->put(&(m_iTargetMask[0]), nB);
 		varMaskB->add_att("units", "unitless");
 	}
+}
 
-	// Write SparseMatrix entries
-	DataArray1D<int> vecRow;
-	DataArray1D<int> vecCol;
-	DataArray1D<double> vecS;
+///////////////////////////////////////////////////////////////////////////////
 
-	m_mapRemap.GetEntries(vecRow, vecCol, vecS);
+void OfflineMap::Write(
+	const std::string & strTarget,
+	const std::map<std::string, std::string> & mapAttributes,
+	NcFile::FileFormat eOutputFormat
+) {
+	if (m_fSinglePrecision) {
+		_EXCEPTIONT("Write() requires double precision weights");
+	}
 
-	// Calculate and write fractional coverage arrays
-	{
-		DataArray1D<double> dFracA(nA);
-		DataArray1D<double> dFracB(nB);
-	
-		for (int i = 0; i < vecS.GetRows(); i++) {
-			dFracA[vecCol[i]] += vecS[i] / m_dSourceAreas[vecCol[i]] * m_dTargetAreas[vecRow[i]];
-			dFracB[vecRow[i]] += vecS[i];
-		}
+	// Deferred coordinates are read before the output replaces any file
+	RequireSourceCoordinates();
+	RequireTargetCoordinates();
 
-		NcVar * varFracA = ncMap.add_var("frac_a", ncDouble, dimNA);
-		varFracA->put(&(dFracA[0]), nA);
-		varFracA->add_att("name", "fraction of target coverage of source dof");
-		varFracA->add_att("units", "unitless");
+	// Temporarily change error reporting
+	NcError error_temp(NcError::verbose_fatal);
 
-		NcVar * varFracB = ncMap.add_var("frac_b", ncDouble, dimNB);
-		varFracB->put(&(dFracB[0]), nB);
-		varFracB->add_att("name", "fraction of source coverage of target dof");
-		varFracB->add_att("units", "unitless");
+	// Open an output file
+	NcFile ncMap(strTarget.c_str(), NcFile::Replace, NULL, 0, eOutputFormat);
+	if (!ncMap.is_valid()) {
+		_EXCEPTION1("Unable to open output map file \"%s\"",
+			strTarget.c_str());
 	}
 
-	// Increment vecRow and vecCol
-	for (int i = 0; i < vecRow.GetRows(); i++) {
-		vecRow[i]++;
-		vecCol[i]++;
-	}
+	// Attributes
+	ncMap.add_att("Title", "TempestRemap Offline Regridding Weight Generator");
 
-	// Write out data
-	int nS = vecRow.GetRows();
-	NcDim * dimNS = ncMap.add_dim("n_s", nS);
+	// Dimensions, coordinates, areas and masks
+	WriteGrid(ncMap);
 
-	NcVar * varRow = ncMap.add_var("row", ncInt, dimNS);
-	varRow->add_att("name", "sparse matrix target dof index");
-	varRow->add_att("first_index", "1");
+	// Map dimensions
+	int nA = (int)(m_dSourceAreas.GetRows());
+	int nB = (int)(m_dTargetAreas.GetRows());
 
-	NcVar * varCol = ncMap.add_var("col", ncInt, dimNS);
-	varCol->add_att("name", "sparse matrix source dof index");
-	varCol->add_att("first_index", "1");
+	NcDim * dimNA = ncMap.get_dim("n_a");
+	NcDim * dimNB = ncMap.get_dim("n_b");
 
-	NcVar * varS = ncMap.add_var("S", ncDouble, dimNS);
-	varS->add_att("name", "sparse matrix coefficient");
+	// Write SparseMatrix entries from the compressed form of the map
+	m_mapRemap.Freeze();
+
+	const DataArray1D<int> & vecRowPtr = m_mapRemap.GetRowPointers();
+	const DataArray1D<int> & vecColIx = m_mapRemap.GetColumnIndices();
+	const DataArray1D<double> & vecValues = m_mapRemap.GetValues();
+
+	const int nRows = m_mapRemap.GetRows();
+	const int nS = static_cast<int>(vecValues.GetRows());
+
+	// Define fractional coverage arrays and sparse matrix
+	NcVar * varFracA;
+	NcVar * varFracB;
+	NcVar * varRow;
+	NcVar * varCol;
+	NcVar * varS;
+
+	DefineSparseMatrixVariables(
+		ncMap, dimNA, dimNB, nS, eOutputFormat,
+		m_nDeflateLevel, m_nQuantizeBits,
+		varFracA, varFracB, varRow, varCol, varS);
+
+	// Fractional coverage is computed while the sparse matrix is written,
+	// unless it has been retained from Verify()
+	const bool fCoverageCached = HasCachedCoverage(nA, nB);
+
+	DataArray1D<double> dFracA(fCoverageCached ? 0 : nA);
+	DataArray1D<double> dFracB(fCoverageCached ? 0 : nB);
+
+	const DataArray1D<double> & dFracAOut =
+		fCoverageCached ? m_dCoverageFracA : dFracA;
+	const DataArray1D<double> & dFracBOut =
+		fCoverageCached ? m_dCoverageFracB : dFracB;
+
+#pragma omp parallel sections num_threads((m_nThreads > 1) ? 2 : 1)
+	{
+#pragma omp section
+		if (!fCoverageCached) {
+			for (int i = 0; i < nRows; i++) {
+				for (int k = vecRowPtr[i]; k < vecRowPtr[i+1]; k++) {
+					const int iCol = vecColIx[k];
+					const double dS =
+						QuantizeMantissa(vecValues[k], m_nQuantizeBits);
+
+					dFracA[iCol] +=
+						dS / m_dSourceAreas[iCol] * m_dTargetAreas[i];
+					dFracB[i] += dS;
+				}
+			}
+		}
+
+#pragma omp section
+		{
+			// Entries are converted to one-based indices one chunk at a time
+			std::vector<int> vecRow(std::min(nS, SparseMatrixChunkSize));
+			std::vector<int> vecCol(vecRow.size());
+			std::vector<double> vecS(vecRow.size());
+
+			int iRow = 0;
+			for (int ixBegin = 0; ixBegin < nS; ixBegin += SparseMatrixChunkSize) {
+				const int nChunk = std::min(SparseMatrixChunkSize, nS - ixBegin);
+
+				for (int k = 0; k < nChunk; k++) {
+					while (vecRowPtr[iRow+1] <= ixBegin + k) {
+						iRow++;
+					}
+					vecRow[k] = iRow + 1;
+					vecCol[k] = vecColIx[ixBegin + k] + 1;
+					vecS[k] = QuantizeMantissa(
+						vecValues[ixBegin + k], m_nQuantizeBits);
+				}
+
+				varRow->set_cur((long)ixBegin);
+				varRow->put(&(vecRow[0]), nChunk);
+
+				varCol->set_cur((long)ixBegin);
+				varCol->put(&(vecCol[0]), nChunk);
+
+				varS->set_cur((long)ixBegin);
+				varS->put(&(vecS[0]), nChunk);
+			}
+		}
+	}
+
+	varFracA->put(&(dFracAOut[0]), nA);
+	varFracB->put(&(dFracBOut[0]), nB);
+
+	// Add global attributes
+	std::map<std::string, std::string>::const_iterator iterAttributes =
+		mapAttributes.begin();
+	for (; iterAttributes != mapAttributes.end(); iterAttributes++) {
+		ncMap.add_att(
+			iterAttributes->first.c_str(),
+			iterAttributes->second.c_str());
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void OfflineMap::WriteTransposeOfFile(
+	const std::string & strInputMap,
+	const std::string & strTarget,
+	const std::map<std::string, std::string> & mapAttributes,
+	NcFile::FileFormat eOutputFormat,
+	size_t sMaxEntries
+) {
+	if (sMaxEntries < 1) {
+		_EXCEPTIONT("At least one entry must be held in memory");
+	}
+
+	// Deferred coordinates are read before the output replaces any file
+	RequireSourceCoordinates();
+	RequireTargetCoordinates();
+
+	// Map dimensions of the transpose
+	const int nA = (int)(m_dSourceAreas.GetRows());
+	const int nB = (int)(m_dTargetAreas.GetRows());
+
+	// Open the input map
+	NcFile ncInput(strInputMap.c_str(), NcFile::ReadOnly);
+	if (!ncInput.is_valid()) {
+		_EXCEPTION1("Unable to open input map file \"%s\"",
+			strInputMap.c_str());
+	}
+
+	NcDim * dimInputNA = ncInput.get_dim("n_a");
+	NcDim * dimInputNB = ncInput.get_dim("n_b");
+	NcDim * dimInputNS = ncInput.get_dim("n_s");
+	if ((dimInputNA == NULL) || (dimInputNB == NULL) || (dimInputNS == NULL)) {
+		_EXCEPTION1("Map file \"%s\" missing dimension \"n_a\", "
+			"\"n_b\" or \"n_s\"", strInputMap.c_str());
+	}
+	if ((dimInputNA->size() != nB) || (dimInputNB->size() != nA)) {
+		_EXCEPTION1("Map file \"%s\" is not the transpose of this map",
+			strInputMap.c_str());
+	}
+
+	NcVar * varInputRow = ncInput.get_var("row");
+	NcVar * varInputCol = ncInput.get_var("col");
+	NcVar * varInputS = ncInput.get_var("S");
+	if ((varInputRow == NULL) || (varInputCol == NULL) || (varInputS == NULL)) {
+		_EXCEPTION1("Map file \"%s\" missing variable \"row\", "
+			"\"col\" or \"S\"", strInputMap.c_str());
+	}
+
+	const int nS = dimInputNS->size();
+
+	std::vector<int> vecRowChunk(std::max(std::min(nS, SparseMatrixChunkSize), 1));
+	std::vector<int> vecColChunk(vecRowChunk.size());
+	std::vector<double> vecSChunk(vecRowChunk.size());
+
+	// Count the entries in each row of the transpose
+	DataArray1D<int> vecRowPtr(nB + 1);
 
-	varRow->set_cur((long)0);
-	varRow->put(&(vecRow[0]), nS);
+	for (int ix = 0; ix < nS; ix += SparseMatrixChunkSize) {
+		const int nChunk = std::min(SparseMatrixChunkSize, nS - ix);
 
-	varCol->set_cur((long)0);
-	varCol->put(&(vecCol[0]), nS);
+		varInputCol->set_cur((long)ix);
+		varInputCol->get(&(vecColChunk[0]), nChunk);
 
-	varS->set_cur((long)0);
-	varS->put(&(vecS[0]), nS);
+		for (int k = 0; k < nChunk; k++) {
+			const int iRow = vecColChunk[k] - 1;
+			if ((iRow < 0) || (iRow >= nB)) {
+				_EXCEPTION2("Map file \"%s\" column index out of range (%i)",
+					strInputMap.c_str(), vecColChunk[k]);
+			}
+			vecRowPtr[iRow+1]++;
+		}
+	}
+	for (int i = 0; i < nB; i++) {
+		vecRowPtr[i+1] += vecRowPtr[i];
+	}
+
+	// Temporarily change error reporting
+	NcError error_temp(NcError::verbose_fatal);
+
+	// Open an output file
+	NcFile ncMap(strTarget.c_str(), NcFile::Replace, NULL, 0, eOutputFormat);
+	if (!ncMap.is_valid()) {
+		_EXCEPTION1("Unable to open output map file \"%s\"",
+			strTarget.c_str());
+	}
+
+	// Attributes
+	ncMap.add_att("Title", "TempestRemap Offline Regridding Weight Generator");
+
+	// Dimensions, coordinates, areas and masks
+	WriteGrid(ncMap);
+
+	// Define fractional coverage arrays and sparse matrix
+	NcVar * varFracA;
+	NcVar * varFracB;
+	NcVar * varRow;
+	NcVar * varCol;
+	NcVar * varS;
+
+	DefineSparseMatrixVariables(
+		ncMap, ncMap.get_dim("n_a"), ncMap.get_dim("n_b"), nS, eOutputFormat,
+		m_nDeflateLevel, m_nQuantizeBits,
+		varFracA, varFracB, varRow, varCol, varS);
+
+	DataArray1D<double> dFracA(nA);
+	DataArray1D<double> dFracB(nB);
+
+	// Transpose one band of rows of the transpose at a time
+	std::vector<int> vecBandColIx;
+	std::vector<double> vecBandValues;
+	std::vector<int> vecBandNext;
+	std::vector< std::pair<int, double> > vecRowEntries;
+
+	int iBandBegin = 0;
+	while (iBandBegin < nB) {
+		int iBandEnd = iBandBegin + 1;
+		while ((iBandEnd < nB) &&
+		       (static_cast<size_t>(vecRowPtr[iBandEnd+1] - vecRowPtr[iBandBegin])
+		           <= sMaxEntries)
+		) {
+			iBandEnd++;
+		}
+
+		const int ixBandBegin = vecRowPtr[iBandBegin];
+		const int nBandEntries = vecRowPtr[iBandEnd] - ixBandBegin;
+
+		vecBandColIx.resize(nBandEntries);
+		vecBandValues.resize(nBandEntries);
+		vecBandNext.resize(iBandEnd - iBandBegin);
+		for (int i = iBandBegin; i < iBandEnd; i++) {
+			vecBandNext[i - iBandBegin] = vecRowPtr[i] - ixBandBegin;
+		}
+
+		// Gather and rescale the entries of the band from the input map
+		for (int ix = 0; (ix < nS) && (nBandEntries != 0); ix += SparseMatrixChunkSize) {
+			const int nChunk = std::min(SparseMatrixChunkSize, nS - ix);
+
+			varInputRow->set_cur((long)ix);
+			varInputRow->get(&(vecRowChunk[0]), nChunk);
+
+			varInputCol->set_cur((long)ix);
+			varInputCol->get(&(vecColChunk[0]), nChunk);
+
+			varInputS->set_cur((long)ix);
+			varInputS->get(&(vecSChunk[0]), nChunk);
+
+			for (int k = 0; k < nChunk; k++) {
+				const int iRow = vecColChunk[k] - 1;
+				if ((iRow < iBandBegin) || (iRow >= iBandEnd)) {
+					continue;
+				}
+
+				const int iCol = vecRowChunk[k] - 1;
+				if ((iCol < 0) || (iCol >= nA)) {
+					_EXCEPTION2("Map file \"%s\" row index out of range (%i)",
+						strInputMap.c_str(), vecRowChunk[k]);
+				}
+
+				const int ixEntry = vecBandNext[iRow - iBandBegin]++;
+				vecBandColIx[ixEntry] = iCol;
+				vecBandValues[ixEntry] =
+					vecSChunk[k] * (m_dSourceAreas[iCol] / m_dTargetAreas[iRow]);
+			}
+		}
+
+		// Entries of a row-sorted input map are already sorted by column;
+		// otherwise sort each row of the band
+		for (int i = iBandBegin; i < iBandEnd; i++) {
+			const int ixBegin = vecRowPtr[i] - ixBandBegin;
+			const int ixEnd = vecRowPtr[i+1] - ixBandBegin;
+
+			bool fSorted = true;
+			for (int k = ixBegin + 1; k < ixEnd; k++) {
+				if (vecBandColIx[k] < vecBandColIx[k-1]) {
+					fSorted = false;
+					break;
+				}
+			}
+			if (fSorted) {
+				continue;
+			}
+
+			vecRowEntries.resize(ixEnd - ixBegin);
+			for (int k = ixBegin; k < ixEnd; k++) {
+				vecRowEntries[k - ixBegin] =
+					std::pair<int, double>(vecBandColIx[k], vecBandValues[k]);
+			}
+			std::stable_sort(
+				vecRowEntries.begin(), vecRowEntries.end(),
+				CompareFirstOfPair);
+			for (int k = ixBegin; k < ixEnd; k++) {
+				vecBandColIx[k] = vecRowEntries[k - ixBegin].first;
+				vecBandValues[k] = vecRowEntries[k - ixBegin].second;
+			}
+		}
+
+		// Write the band one chunk at a time
+		int iRow = iBandBegin;
+		for (int ixChunk = 0; ixChunk < nBandEntries; ixChunk += SparseMatrixChunkSize) {
+			const int nChunk = std::min(SparseMatrixChunkSize, nBandEntries - ixChunk);
+
+			for (int k = 0; k < nChunk; k++) {
+				const int ixEntry = ixChunk + k;
+				while (vecRowPtr[iRow+1] <= ixBandBegin + ixEntry) {
+					iRow++;
+				}
+
+				const int iCol = vecBandColIx[ixEntry];
+				const double dS =
+					QuantizeMantissa(vecBandValues[ixEntry], m_nQuantizeBits);
+
+				dFracA[iCol] += dS / m_dSourceAreas[iCol] * m_dTargetAreas[iRow];
+				dFracB[iRow] += dS;
+
+				vecRowChunk[k] = iRow + 1;
+				vecColChunk[k] = iCol + 1;
+				vecSChunk[k] = dS;
+			}
+
+			varRow->set_cur((long)(ixBandBegin + ixChunk));
+			varRow->put(&(vecRowChunk[0]), nChunk);
+
+			varCol->set_cur((long)(ixBandBegin + ixChunk));
+			varCol->put(&(vecColChunk[0]), nChunk);
+
+			varS->set_cur((long)(ixBandBegin + ixChunk));
+			varS->put(&(vecSChunk[0]), nChunk);
+		}
+
+		iBandBegin = iBandEnd;
+	}
+
+	varFracA->put(&(dFracA[0]), nA);
+	varFracB->put(&(dFracB[0]), nB);
 
 	// Add global attributes
 	std::map<std::string, std::string>::const_iterator iterAttributes =
@@ -2349,8 +4443,19 @@ void OfflineMap::Write(
 ///////////////////////////////////////////////////////////////////////////////
 
 void OfflineMap::SetTranspose(
-	const OfflineMap & mapIn
+	const OfflineMap & mapIn,
+	int nThreads
 ) {
+	if (mapIn.m_fSinglePrecision) {
+		_EXCEPTIONT("SetTranspose() requires double precision weights");
+	}
+
+	m_fCoverageCached = false;
+
+	// The result is stored in double precision
+	m_mapRemapSingle.Clear();
+	m_fSinglePrecision = false;
+
 	m_dSourceAreas = mapIn.m_dTargetAreas;
 	m_dTargetAreas = mapIn.m_dSourceAreas;
 
@@ -2362,6 +4467,12 @@ void OfflineMap::SetTranspose(
 	m_dTargetCenterLon = mapIn.m_dSourceCenterLon;
 	m_dTargetCenterLat = mapIn.m_dSourceCenterLat;
 
+	// Deferred coordinates stay deferred, from the opposite side
+	m_strSourceCoordinateFile = mapIn.m_strTargetCoordinateFile;
+	m_strSourceCoordinateSide = mapIn.m_strTargetCoordinateSide;
+	m_strTargetCoordinateFile = mapIn.m_strSourceCoordinateFile;
+	m_strTargetCoordinateSide = mapIn.m_strSourceCoordinateSide;
+
 	m_dSourceVertexLon = mapIn.m_dTargetVertexLon;
 	m_dSourceVertexLat = mapIn.m_dTargetVertexLat;
 	m_dVectorSourceCenterLon = mapIn.m_dVectorTargetCenterLon;
@@ -2379,57 +4490,614 @@ void OfflineMap::SetTranspose(
 	m_vecSourceDimSizes = mapIn.m_vecTargetDimSizes;
 	m_vecSourceDimNames = mapIn.m_vecTargetDimNames;
 
+	m_nSourceGridOffset = 0;
+	m_nSourceGridFullSize = 0;
+
 	m_vecTargetDimSizes = mapIn.m_vecSourceDimSizes;
 	m_vecTargetDimNames = mapIn.m_vecSourceDimNames;
 
-	DataArray1D<int> dataRows;
-	DataArray1D<int> dataCols;
-	DataArray1D<double> dataEntries;
+	// Transpose the compressed form of the map, rescaling each entry by
+	// the ratio of the target area to the source area
+	m_mapRemap.SetTranspose(
+		mapIn.m_mapRemap,
+		&(mapIn.m_dTargetAreas),
+		&(mapIn.m_dSourceAreas),
+		nThreads);
+}
 
-	mapIn.m_mapRemap.GetEntries(dataRows, dataCols, dataEntries);
-/*
-	DataArray1D<double> dTargetCoverage(mapIn.m_dTargetAreas.GetRows());
-	for (size_t s = 0; s < dataEntries.GetRows(); s++) {
-		dTargetCoverage[dataRows[s]] +=
-			mapIn.m_dTargetAreas[dataRows[s]];
+///////////////////////////////////////////////////////////////////////////////
+
+void OfflineMap::SetComposition(
+	const OfflineMap & mapFirst,
+	const OfflineMap & mapSecond,
+	int nThreads
+) {
+	if (mapFirst.m_fSinglePrecision || mapSecond.m_fSinglePrecision) {
+		_EXCEPTIONT("SetComposition() requires double precision weights");
 	}
-*/
-	for (size_t s = 0; s < dataEntries.GetRows(); s++) {
-		dataEntries[s] *=
-			mapIn.m_dTargetAreas[dataRows[s]]
-			/ mapIn.m_dSourceAreas[dataCols[s]];
+
+	m_fCoverageCached = false;
+
+	// The result is stored in double precision
+	m_mapRemapSingle.Clear();
+	m_fSinglePrecision = false;
+
+	// Verify the intermediate meshes agree
+	const int nIntermediateFirst =
+		static_cast<int>(mapFirst.m_dTargetAreas.GetRows());
+	const int nIntermediateSecond =
+		static_cast<int>(mapSecond.m_dSourceAreas.GetRows());
+
+	if (nIntermediateFirst != nIntermediateSecond) {
+		_EXCEPTION2("Target mesh of first map (%i) does not match "
+			"source mesh of second map (%i)",
+			nIntermediateFirst, nIntermediateSecond);
+	}
+	if ((mapFirst.m_mapRemap.GetRows() > nIntermediateFirst) ||
+	    (mapSecond.m_mapRemap.GetColumns() > nIntermediateSecond)
+	) {
+		_EXCEPTIONT("Map entries exceed the size of the intermediate mesh");
 	}
 
-	m_mapRemap.SetEntries(dataCols, dataRows, dataEntries);
+	// Source metadata from the first map
+	m_dSourceAreas = mapFirst.m_dSourceAreas;
+	m_iSourceMask = mapFirst.m_iSourceMask;
+
+	m_dSourceCenterLon = mapFirst.m_dSourceCenterLon;
+	m_dSourceCenterLat = mapFirst.m_dSourceCenterLat;
+	m_strSourceCoordinateFile = mapFirst.m_strSourceCoordinateFile;
+	m_strSourceCoordinateSide = mapFirst.m_strSourceCoordinateSide;
+	m_dSourceVertexLon = mapFirst.m_dSourceVertexLon;
+	m_dSourceVertexLat = mapFirst.m_dSourceVertexLat;
+	m_dVectorSourceCenterLon = mapFirst.m_dVectorSourceCenterLon;
+	m_dVectorSourceCenterLat = mapFirst.m_dVectorSourceCenterLat;
+	m_dVectorSourceBoundsLon = mapFirst.m_dVectorSourceBoundsLon;
+	m_dVectorSourceBoundsLat = mapFirst.m_dVectorSourceBoundsLat;
+
+	m_vecSourceDimSizes = mapFirst.m_vecSourceDimSizes;
+	m_vecSourceDimNames = mapFirst.m_vecSourceDimNames;
+
+	m_nSourceGridOffset = mapFirst.m_nSourceGridOffset;
+	m_nSourceGridFullSize = mapFirst.m_nSourceGridFullSize;
+
+	// Target metadata from the second map
+	m_dTargetAreas = mapSecond.m_dTargetAreas;
+	m_iTargetMask = mapSecond.m_iTargetMask;
+
+	m_dTargetCenterLon = mapSecond.m_dTargetCenterLon;
+	m_dTargetCenterLat = mapSecond.m_dTargetCenterLat;
+	m_strTargetCoordinateFile = mapSecond.m_strTargetCoordinateFile;
+	m_strTargetCoordinateSide = mapSecond.m_strTargetCoordinateSide;
+	m_dTargetVertexLon = mapSecond.m_dTargetVertexLon;
+	m_dTargetVertexLat = mapSecond.m_dTargetVertexLat;
+	m_dVectorTargetCenterLon = mapSecond.m_dVectorTargetCenterLon;
+	m_dVectorTargetCenterLat = mapSecond.m_dVectorTargetCenterLat;
+	m_dVectorTargetBoundsLon = mapSecond.m_dVectorTargetBoundsLon;
+	m_dVectorTargetBoundsLat = mapSecond.m_dVectorTargetBoundsLat;
+
+	m_vecTargetDimSizes = mapSecond.m_vecTargetDimSizes;
+	m_vecTargetDimNames = mapSecond.m_vecTargetDimNames;
+
+	// Composed operator
+	m_mapRemap.SetProduct(mapSecond.m_mapRemap, mapFirst.m_mapRemap, nThreads);
 }
 
 ///////////////////////////////////////////////////////////////////////////////
 
-bool OfflineMap::IsConsistent(
-	double dTolerance
+///	<summary>
+///		Copy the entries [iBegin, iBegin + nCount) of daIn to daOut, or
+///		leave daOut empty if daIn is empty.
+///	</summary>
+template <typename T>
+static void CopyRange(
+	const DataArray1D<T> & daIn,
+	int iBegin,
+	int nCount,
+	DataArray1D<T> & daOut
+) {
+	if (daIn.GetRows() == 0) {
+		daOut.Deallocate();
+		return;
+	}
+	if (daIn.GetRows() < static_cast<size_t>(iBegin + nCount)) {
+		_EXCEPTION3("Range [%i, %i) exceeds array size %lu",
+			iBegin, iBegin + nCount, daIn.GetRows());
+	}
+	daOut.Allocate(nCount);
+	for (int i = 0; i < nCount; i++) {
+		daOut[i] = daIn[iBegin + i];
+	}
+}
+
+///	<summary>
+///		Copy the rows [iBegin, iBegin + nCount) of daIn to daOut, or leave
+///		daOut empty if daIn is empty.
+///	</summary>
+static void CopyRange(
+	const DataArray2D<double> & daIn,
+	int iBegin,
+	int nCount,
+	DataArray2D<double> & daOut
+) {
+	if (daIn.GetRows() == 0) {
+		daOut.Deallocate();
+		return;
+	}
+	if (daIn.GetRows() < static_cast<size_t>(iBegin + nCount)) {
+		_EXCEPTION3("Range [%i, %i) exceeds array size %lu",
+			iBegin, iBegin + nCount, daIn.GetRows());
+	}
+	daOut.Allocate(nCount, daIn.GetColumns());
+	for (int i = 0; i < nCount; i++) {
+	for (size_t j = 0; j < daIn.GetColumns(); j++) {
+		daOut[i][j] = daIn[iBegin + i][j];
+	}
+	}
+}
+
+///	<summary>
+///		Copy the entries vecRows of daIn to daOut, or leave daOut empty if
+///		daIn is empty.
+///	</summary>
+template <typename T>
+static void CopyRows(
+	const DataArray1D<T> & daIn,
+	const std::vector<int> & vecRows,
+	DataArray1D<T> & daOut
+) {
+	if (daIn.GetRows() == 0) {
+		daOut.Deallocate();
+		return;
+	}
+	daOut.Allocate(vecRows.size());
+	for (size_t i = 0; i < vecRows.size(); i++) {
+		daOut[i] = daIn[vecRows[i]];
+	}
+}
+
+///	<summary>
+///		Copy the rows vecRows of daIn to daOut, or leave daOut empty if
+///		daIn is empty.
+///	</summary>
+static void CopyRows(
+	const DataArray2D<double> & daIn,
+	const std::vector<int> & vecRows,
+	DataArray2D<double> & daOut
+) {
+	if (daIn.GetRows() == 0) {
+		daOut.Deallocate();
+		return;
+	}
+	daOut.Allocate(vecRows.size(), daIn.GetColumns());
+	for (size_t i = 0; i < vecRows.size(); i++) {
+	for (size_t j = 0; j < daIn.GetColumns(); j++) {
+		daOut[i][j] = daIn[vecRows[i]][j];
+	}
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void OfflineMap::SetSubMap(
+	const OfflineMap & mapIn,
+	const std::vector<int> & vecTargetRows
 ) {
+	if (mapIn.m_fSinglePrecision) {
+		_EXCEPTIONT("SetSubMap() requires double precision weights");
+	}
+	if (&mapIn == this) {
+		_EXCEPTIONT("SetSubMap() cannot be applied to the map itself");
+	}
+
+	const int nB = static_cast<int>(mapIn.m_dTargetAreas.GetRows());
+	const int nSubB = static_cast<int>(vecTargetRows.size());
+
+	if (nSubB == 0) {
+		_EXCEPTIONT("No target rows selected for sub-map");
+	}
+
+	std::vector<char> fSelected(nB, 0);
+	for (int s = 0; s < nSubB; s++) {
+		const int i = vecTargetRows[s];
+		if ((i < 0) || (i >= nB)) {
+			_EXCEPTION2("Target row %i out of range [0, %i)", i, nB);
+		}
+		if (fSelected[i]) {
+			_EXCEPTION1("Target row %i selected more than once", i);
+		}
+		fSelected[i] = 1;
+	}
+
+	// Operate on the compressed form of the map
+	SparseMatrix<double> mapRemapFrozen;
+	const SparseMatrix<double> * pmapRemap = &(mapIn.m_mapRemap);
+	if (!pmapRemap->IsFrozen()) {
+		mapRemapFrozen = mapIn.m_mapRemap;
+		mapRemapFrozen.Freeze();
+		pmapRemap = &mapRemapFrozen;
+	}
+
+	const DataArray1D<int> & vecRowPtr = pmapRemap->GetRowPointers();
+	const DataArray1D<int> & vecColIx = pmapRemap->GetColumnIndices();
+	const DataArray1D<double> & vecValues = pmapRemap->GetValues();
+
+	const int nRows = pmapRemap->GetRows();
+
+	// Range of source columns referenced by the selected rows
+	int iColMin = std::numeric_limits<int>::max();
+	int iColMax = (-1);
+	size_t sSubEntries = 0;
+
+	for (int s = 0; s < nSubB; s++) {
+		const int i = vecTargetRows[s];
+		if (i >= nRows) {
+			continue;
+		}
+		for (int k = vecRowPtr[i]; k < vecRowPtr[i+1]; k++) {
+			iColMin = std::min(iColMin, vecColIx[k]);
+			iColMax = std::max(iColMax, vecColIx[k]);
+		}
+		sSubEntries += vecRowPtr[i+1] - vecRowPtr[i];
+	}
+
+	if (iColMax < 0) {
+		_EXCEPTIONT("Selected target rows of sub-map have no entries");
+	}
+
+	// Extend the range to whole entries of the first source dimension
+	if (mapIn.m_vecSourceDimSizes.size() == 0) {
+		_EXCEPTIONT("Source grid dimensions of map undefined");
+	}
+
+	int nStride = 1;
+	for (size_t d = 1; d < mapIn.m_vecSourceDimSizes.size(); d++) {
+		nStride *= mapIn.m_vecSourceDimSizes[d];
+	}
+
+	const int iFirst = iColMin / nStride;
+	const int nSubFirst = iColMax / nStride - iFirst + 1;
+	const int iColBegin = iFirst * nStride;
+	const int nSubA = nSubFirst * nStride;
+
+	mapIn.RequireSourceCoordinates();
+	mapIn.RequireTargetCoordinates();
+
+	m_fCoverageCached = false;
+
+	// The result is stored in double precision
+	m_mapRemapSingle.Clear();
+	m_fSinglePrecision = false;
+
+	// Source grid restricted to the range of the first dimension
+	CopyRange(mapIn.m_dSourceAreas, iColBegin, nSubA, m_dSourceAreas);
+	CopyRange(mapIn.m_iSourceMask, iColBegin, nSubA, m_iSourceMask);
+	CopyRange(mapIn.m_dSourceCenterLon, iColBegin, nSubA, m_dSourceCenterLon);
+	CopyRange(mapIn.m_dSourceCenterLat, iColBegin, nSubA, m_dSourceCenterLat);
+	CopyRange(mapIn.m_dSourceVertexLon, iColBegin, nSubA, m_dSourceVertexLon);
+	CopyRange(mapIn.m_dSourceVertexLat, iColBegin, nSubA, m_dSourceVertexLat);
+
+	m_strSourceCoordinateFile = "";
+	m_strSourceCoordinateSide = "";
+
+	m_vecSourceDimSizes = mapIn.m_vecSourceDimSizes;
+	m_vecSourceDimNames = mapIn.m_vecSourceDimNames;
+	m_vecSourceDimSizes[0] = nSubFirst;
+
+	m_nSourceGridOffset = mapIn.m_nSourceGridOffset + iFirst;
+	m_nSourceGridFullSize = mapIn.GetSourceGridFullSize();
+
+	m_dVectorSourceCenterLon = mapIn.m_dVectorSourceCenterLon;
+	m_dVectorSourceCenterLat = mapIn.m_dVectorSourceCenterLat;
+	m_dVectorSourceBoundsLon = mapIn.m_dVectorSourceBoundsLon;
+	m_dVectorSourceBoundsLat = mapIn.m_dVectorSourceBoundsLat;
+
+	if (m_vecSourceDimNames[0] == "lat") {
+		CopyRange(mapIn.m_dVectorSourceCenterLat,
+			iFirst, nSubFirst, m_dVectorSourceCenterLat);
+		CopyRange(mapIn.m_dVectorSourceBoundsLat,
+			iFirst, nSubFirst, m_dVectorSourceBoundsLat);
+	} else if (m_vecSourceDimNames[0] == "lon") {
+		CopyRange(mapIn.m_dVectorSourceCenterLon,
+			iFirst, nSubFirst, m_dVectorSourceCenterLon);
+		CopyRange(mapIn.m_dVectorSourceBoundsLon,
+			iFirst, nSubFirst, m_dVectorSourceBoundsLon);
+	}
+
+	// Selected target cells
+	CopyRows(mapIn.m_dTargetAreas, vecTargetRows, m_dTargetAreas);
+	CopyRows(mapIn.m_iTargetMask, vecTargetRows, m_iTargetMask);
+	CopyRows(mapIn.m_dTargetCenterLon, vecTargetRows, m_dTargetCenterLon);
+	CopyRows(mapIn.m_dTargetCenterLat, vecTargetRows, m_dTargetCenterLat);
+	CopyRows(mapIn.m_dTargetVertexLon, vecTargetRows, m_dTargetVertexLon);
+	CopyRows(mapIn.m_dTargetVertexLat, vecTargetRows, m_dTargetVertexLat);
+
+	m_strTargetCoordinateFile = "";
+	m_strTargetCoordinateSide = "";
+
+	m_dVectorTargetCenterLon.Deallocate();
+	m_dVectorTargetCenterLat.Deallocate();
+	m_dVectorTargetBoundsLon.Deallocate();
+	m_dVectorTargetBoundsLat.Deallocate();
+
+	// A rectangular block of a rectilinear target grid, selected in
+	// order, remains rectilinear
+	bool fTargetBlock = false;
+
+	if (mapIn.m_vecTargetDimSizes.size() == 2) {
+		const int nDim1 = mapIn.m_vecTargetDimSizes[1];
+
+		int iMin = std::numeric_limits<int>::max();
+		int iMax = (-1);
+		int jMin = std::numeric_limits<int>::max();
+		int jMax = (-1);
+		for (int s = 0; s < nSubB; s++) {
+			iMin = std::min(iMin, vecTargetRows[s] / nDim1);
+			iMax = std::max(iMax, vecTargetRows[s] / nDim1);
+			jMin = std::min(jMin, vecTargetRows[s] % nDim1);
+			jMax = std::max(jMax, vecTargetRows[s] % nDim1);
+		}
+
+		const int nBlock0 = iMax - iMin + 1;
+		const int nBlock1 = jMax - jMin + 1;
+
+		if (nBlock0 * nBlock1 == nSubB) {
+			fTargetBlock = true;
+			for (int s = 0; s < nSubB; s++) {
+				if (vecTargetRows[s] !=
+				    (iMin + s / nBlock1) * nDim1 + jMin + s % nBlock1
+				) {
+					fTargetBlock = false;
+					break;
+				}
+			}
+		}
+
+		if (fTargetBlock) {
+			m_vecTargetDimSizes.resize(2);
+			m_vecTargetDimSizes[0] = nBlock0;
+			m_vecTargetDimSizes[1] = nBlock1;
+			m_vecTargetDimNames = mapIn.m_vecTargetDimNames;
+
+			const int iBlockBegin[2] = {iMin, jMin};
+			for (int d = 0; d < 2; d++) {
+				if (m_vecTargetDimNames[d] == "lat") {
+					CopyRange(mapIn.m_dVectorTargetCenterLat,
+						iBlockBegin[d], m_vecTargetDimSizes[d],
+						m_dVectorTargetCenterLat);
+					CopyRange(mapIn.m_dVectorTargetBoundsLat,
+						iBlockBegin[d], m_vecTargetDimSizes[d],
+						m_dVectorTargetBoundsLat);
+				}
+				if (m_vecTargetDimNames[d] == "lon") {
+					CopyRange(mapIn.m_dVectorTargetCenterLon,
+						iBlockBegin[d], m_vecTargetDimSizes[d],
+						m_dVectorTargetCenterLon);
+					CopyRange(mapIn.m_dVectorTargetBoundsLon,
+						iBlockBegin[d], m_vecTargetDimSizes[d],
+						m_dVectorTargetBoundsLon);
+				}
+			}
+		}
+	}
+
+	if (!fTargetBlock) {
+		m_vecTargetDimSizes.resize(1);
+		m_vecTargetDimSizes[0] = nSubB;
+		m_vecTargetDimNames.resize(1);
+		if (mapIn.m_vecTargetDimNames.size() == 1) {
+			m_vecTargetDimNames[0] = mapIn.m_vecTargetDimNames[0];
+		} else {
+			m_vecTargetDimNames[0] = "num_elem";
+		}
+	}
+
+	// Selected rows of the map, with source columns renumbered
+	DataArray1D<int> dataRows(sSubEntries);
+	DataArray1D<int> dataCols(sSubEntries);
+	DataArray1D<double> dataEntries(sSubEntries);
+
+	size_t ix = 0;
+	for (int s = 0; s < nSubB; s++) {
+		const int i = vecTargetRows[s];
+		if (i >= nRows) {
+			continue;
+		}
+		for (int k = vecRowPtr[i]; k < vecRowPtr[i+1]; k++) {
+			dataRows[ix] = s;
+			dataCols[ix] = vecColIx[k] - iColBegin;
+			dataEntries[ix] = vecValues[k];
+			ix++;
+		}
+	}
+
+	m_mapRemap.SetEntries(dataRows, dataCols, dataEntries);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void OfflineMap::GetTargetRowsInBox(
+	double dLonMin,
+	double dLonMax,
+	double dLatMin,
+	double dLatMax,
+	std::vector<int> & vecTargetRows
+) const {
+	if (dLatMin > dLatMax) {
+		_EXCEPTION2("Minimum latitude (%1.5f) exceeds maximum latitude (%1.5f)",
+			dLatMin, dLatMax);
+	}
+
+	RequireTargetCoordinates();
+
+	const int nB = static_cast<int>(m_dTargetAreas.GetRows());
+
+	if ((m_dTargetCenterLon.GetRows() != nB) ||
+	    (m_dTargetCenterLat.GetRows() != nB)
+	) {
+		_EXCEPTIONT("Target cell centers of map not available");
+	}
+
+	// Longitudes are measured eastward from dLonMin
+	const bool fAllLon = (dLonMax - dLonMin >= 360.0);
+
+	double dLonWidth = fmod(dLonMax - dLonMin, 360.0);
+	if (dLonWidth < 0.0) {
+		dLonWidth += 360.0;
+	}
+
+	vecTargetRows.clear();
+	for (int i = 0; i < nB; i++) {
+		if ((m_dTargetCenterLat[i] < dLatMin) ||
+		    (m_dTargetCenterLat[i] > dLatMax)
+		) {
+			continue;
+		}
+
+		double dLon = fmod(m_dTargetCenterLon[i] - dLonMin, 360.0);
+		if (dLon < 0.0) {
+			dLon += 360.0;
+		}
+		if (fAllLon || (dLon <= dLonWidth)) {
+			vecTargetRows.push_back(i);
+		}
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void OfflineMap::ConvertToSinglePrecision(
+	bool fReportAccuracy
+) {
+	if (m_fSinglePrecision) {
+		return;
+	}
+
+	m_fCoverageCached = false;
+
+	m_mapRemap.Freeze();
+
+	m_mapRemapSingle.SetConverted(m_mapRemap);
 
-	// Get map entries
-	DataArray1D<int> dataRows;
-	DataArray1D<int> dataCols;
-	DataArray1D<double> dataEntries;
+	// Estimate the error introduced by rounding the weights
+	if (fReportAccuracy) {
+		AnnounceStartBlock("Estimating single precision weight error");
 
-	m_mapRemap.GetEntries(dataRows, dataCols, dataEntries);
+		const DataArray1D<int> & vecRowPtr = m_mapRemap.GetRowPointers();
+		const DataArray1D<double> & vecValues = m_mapRemap.GetValues();
+		const DataArray1D<float> & vecValuesSingle =
+			m_mapRemapSingle.GetValues();
 
-	// Calculate row sums
-	DataArray1D<double> dRowSums(m_mapRemap.GetRows());
+		double dMaxWeightError = 0.0;
+		double dMaxRowSumError = 0.0;
+		for (int i = 0; i < m_mapRemap.GetRows(); i++) {
+			double dRowSum = 0.0;
+			double dRowSumSingle = 0.0;
+			for (int k = vecRowPtr[i]; k < vecRowPtr[i+1]; k++) {
+				const double dSingle = static_cast<double>(vecValuesSingle[k]);
 
-	for (int i = 0; i < dataRows.GetRows(); i++) {
-		dRowSums[dataRows[i]] += dataEntries[i];
+				dRowSum += vecValues[k];
+				dRowSumSingle += dSingle;
+
+				if (fabs(dSingle - vecValues[k]) > dMaxWeightError) {
+					dMaxWeightError = fabs(dSingle - vecValues[k]);
+				}
+			}
+			if (fabs(dRowSumSingle - dRowSum) > dMaxRowSumError) {
+				dMaxRowSumError = fabs(dRowSumSingle - dRowSum);
+			}
+		}
+
+		Announce("Max weight error:    %1.5e", dMaxWeightError);
+		Announce("Max row sum error:   %1.5e", dMaxRowSumError);
+
+		// Apply both operators to a reproducible pseudo-random field
+		// with values in [1,2)
+		const int nCols = m_mapRemap.GetColumns();
+		const int nRows = m_mapRemap.GetRows();
+
+		if ((nCols > 0) && (nRows > 0)) {
+			DataArray1D<double> dDataIn(nCols);
+			DataArray1D<double> dDataOut(nRows);
+			DataArray1D<double> dDataOutSingle(nRows);
+
+			unsigned int uSeed = 12345u;
+			for (int i = 0; i < nCols; i++) {
+				uSeed = 1664525u * uSeed + 1013904223u;
+				dDataIn[i] = 1.0 + static_cast<double>(uSeed >> 8) / 16777216.0;
+			}
+
+			m_mapRemap.Apply(
+				&(dDataIn[0]), nCols, 1,
+				&(dDataOut[0]), nRows, 1,
+				1, nRows, m_nThreads);
+
+			m_mapRemapSingle.Apply<double, double>(
+				&(dDataIn[0]), nCols, 1,
+				&(dDataOutSingle[0]), nRows, 1,
+				1, nRows, m_nThreads);
+
+			double dL2Error = 0.0;
+			double dL2Norm = 0.0;
+			double dLinfError = 0.0;
+			double dLinfNorm = 0.0;
+			for (int i = 0; i < nRows; i++) {
+				const double dError = fabs(dDataOutSingle[i] - dDataOut[i]);
+
+				dL2Error += dError * dError;
+				dL2Norm += dDataOut[i] * dDataOut[i];
+				if (dError > dLinfError) {
+					dLinfError = dError;
+				}
+				if (fabs(dDataOut[i]) > dLinfNorm) {
+					dLinfNorm = fabs(dDataOut[i]);
+				}
+			}
+
+			if (dL2Norm > 0.0) {
+				Announce("Relative L2 error:   %1.5e",
+					sqrt(dL2Error / dL2Norm));
+			}
+			if (dLinfNorm > 0.0) {
+				Announce("Relative Linf error: %1.5e",
+					dLinfError / dLinfNorm);
+			}
+		}
+
+		AnnounceEndBlock(NULL);
 	}
 
+	// Release the double precision weights
+	m_mapRemap.Clear();
+
+	m_fSinglePrecision = true;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+bool OfflineMap::IsConsistent(
+	double dTolerance
+) {
+	if (m_fSinglePrecision) {
+		_EXCEPTIONT("IsConsistent() requires double precision weights");
+	}
+
+	// Operate on the compressed form of the map
+	m_mapRemap.Freeze();
+
+	const DataArray1D<int> & vecRowPtr = m_mapRemap.GetRowPointers();
+	const DataArray1D<double> & vecValues = m_mapRemap.GetValues();
+
 	// Verify all row sums are equal to 1
 	bool fConsistent = true;
-	for (int i = 0; i < dRowSums.GetRows(); i++) {
-		if (fabs(dRowSums[i] - 1.0) > dTolerance) {
+	for (int i = 0; i < m_mapRemap.GetRows(); i++) {
+		double dRowSum = 0.0;
+		for (int k = vecRowPtr[i]; k < vecRowPtr[i+1]; k++) {
+			dRowSum += vecValues[k];
+		}
+		if (fabs(dRowSum - 1.0) > dTolerance) {
 			fConsistent = false;
 			Announce("OfflineMap is not consistent in row %i (%1.15e)",
-				i, dRowSums[i]);
+				i, dRowSum);
 		}
 	}
 
@@ -2441,6 +5109,10 @@ bool OfflineMap::IsConsistent(
 bool OfflineMap::IsConservative(
 	double dTolerance
 ) {
+	if (m_fSinglePrecision) {
+		_EXCEPTIONT("IsConservative() requires double precision weights");
+	}
+
 /*
 	if (vecSourceAreas.GetRows() != m_mapRemap.GetColumns()) {
 		_EXCEPTIONT("vecSourceAreas / mapRemap dimension mismatch");
@@ -2449,19 +5121,21 @@ bool OfflineMap::IsConservative(
 		_EXCEPTIONT("vecTargetAreas / mapRemap dimension mismatch");
 	}
 */
-	// Get map entries
-	DataArray1D<int> dataRows;
-	DataArray1D<int> dataCols;
-	DataArray1D<double> dataEntries;
+	// Operate on the compressed form of the map
+	m_mapRemap.Freeze();
 
-	m_mapRemap.GetEntries(dataRows, dataCols, dataEntries);
+	const DataArray1D<int> & vecRowPtr = m_mapRemap.GetRowPointers();
+	const DataArray1D<int> & vecColIx = m_mapRemap.GetColumnIndices();
+	const DataArray1D<double> & vecValues = m_mapRemap.GetValues();
 
 	// Calculate column sums
 	DataArray1D<double> dColumnSums(m_mapRemap.GetColumns());
 
-	for (int i = 0; i < dataRows.GetRows(); i++) {
-		dColumnSums[dataCols[i]] +=
-			dataEntries[i] * m_dTargetAreas[dataRows[i]];
+	for (int i = 0; i < m_mapRemap.GetRows(); i++) {
+		const double dTargetArea = m_dTargetAreas[i];
+		for (int k = vecRowPtr[i]; k < vecRowPtr[i+1]; k++) {
+			dColumnSums[vecColIx[k]] += vecValues[k] * dTargetArea;
+		}
 	}
 
 	// Verify all column sums equal the input Jacobian
@@ -2483,24 +5157,25 @@ bool OfflineMap::IsConservative(
 bool OfflineMap::IsMonotone(
 	double dTolerance
 ) {
+	if (m_fSinglePrecision) {
+		_EXCEPTIONT("IsMonotone() requires double precision weights");
+	}
 
-	// Get map entries
-	DataArray1D<int> dataRows;
-	DataArray1D<int> dataCols;
-	DataArray1D<double> dataEntries;
+	// Operate on the compressed form of the map
+	m_mapRemap.Freeze();
 
-	m_mapRemap.GetEntries(dataRows, dataCols, dataEntries);
+	const DataArray1D<double> & vecValues = m_mapRemap.GetValues();
 
 	// Verify all entries are in the range [0,1]
 	bool fMonotone = true;
-	for (int i = 0; i < dataRows.GetRows(); i++) {
-		if ((dataEntries[i] < -dTolerance) ||
-			(dataEntries[i] > 1.0 + dTolerance)
+	for (int i = 0; i < vecValues.GetRows(); i++) {
+		if ((vecValues[i] < -dTolerance) ||
+			(vecValues[i] > 1.0 + dTolerance)
 		) {
 			fMonotone = false;
 
 			Announce("OfflineMap is not monotone in entry (%i): %1.15e",
-				i, dataEntries[i]);
+				i, vecValues[i]);
 		}
 	}
 
@@ -2509,3 +5184,712 @@ bool OfflineMap::IsMonotone(
 
 ///////////////////////////////////////////////////////////////////////////////
 
+///	<summary>
+///		Insert an offender into a list ordered by decreasing error, which
+///		retains at most OfflineMapVerification::MaxOffenders entries.
+///	</summary>
+static void InsertOffender(
+	std::vector<OfflineMapVerification::Offender> & vecOffenders,
+	int iRow,
+	int iCol,
+	double dValue,
+	double dError
+) {
+	if ((vecOffenders.size() == OfflineMapVerification::MaxOffenders) &&
+	    (dError <= vecOffenders.back().dError)
+	) {
+		return;
+	}
+
+	OfflineMapVerification::Offender offender;
+	offender.iRow = iRow;
+	offender.iCol = iCol;
+	offender.dValue = dValue;
+	offender.dError = dError;
+
+	size_t ix = vecOffenders.size();
+	while ((ix > 0) && (vecOffenders[ix-1].dError < dError)) {
+		ix--;
+	}
+	vecOffenders.insert(vecOffenders.begin() + ix, offender);
+
+	if (vecOffenders.size() > OfflineMapVerification::MaxOffenders) {
+		vecOffenders.pop_back();
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+bool OfflineMap::Verify(
+	double dConsistencyTolerance,
+	double dConservationTolerance,
+	bool fCheckMonotone,
+	double dMonotoneTolerance,
+	OfflineMapVerification * pVerification
+) {
+	if (m_fSinglePrecision) {
+		_EXCEPTIONT("Verify() requires double precision weights");
+	}
+
+	// Operate on the compressed form of the map
+	m_mapRemap.Freeze();
+
+	const DataArray1D<int> & vecRowPtr = m_mapRemap.GetRowPointers();
+	const DataArray1D<int> & vecColIx = m_mapRemap.GetColumnIndices();
+	const DataArray1D<double> & vecValues = m_mapRemap.GetValues();
+
+	const int nRows = m_mapRemap.GetRows();
+	const int nCols = m_mapRemap.GetColumns();
+
+	const int nA = static_cast<int>(m_dSourceAreas.GetRows());
+	const int nB = static_cast<int>(m_dTargetAreas.GetRows());
+
+	if ((nRows > nB) || (nCols > nA)) {
+		_EXCEPTION4("OfflineMap (%i x %i) larger than its target / source "
+			"areas (%i x %i)", nRows, nCols, nB, nA);
+	}
+
+	m_fCoverageCached = false;
+	m_dCoverageFracA.Allocate(nA);
+	m_dCoverageFracB.Allocate(nB);
+
+	// Each block verifies a range of rows and a range of columns.  Column
+	// sums are accumulated in row order by the block that owns the column,
+	// so the fractional coverage is identical to that computed by Write().
+	const int nBlocks = m_nThreads;
+
+	std::vector<OfflineMapVerification> vecBlockResults(nBlocks);
+
+#pragma omp parallel for num_threads(m_nThreads) schedule(static, 1)
+	for (int b = 0; b < nBlocks; b++) {
+		OfflineMapVerification & result = vecBlockResults[b];
+
+		result.dMinWeight = std::numeric_limits<double>::max();
+		result.dMaxWeight = -std::numeric_limits<double>::max();
+
+		// Row sums, weight range and monotonicity
+		const int iRowBegin = static_cast<int>(
+			static_cast<long long>(nB) * b / nBlocks);
+		const int iRowEnd = static_cast<int>(
+			static_cast<long long>(nB) * (b+1) / nBlocks);
+
+		for (int i = iRowBegin; i < iRowEnd; i++) {
+			if ((i >= nRows) || (vecRowPtr[i] == vecRowPtr[i+1])) {
+				result.nEmptyTargetRows++;
+			}
+			if (i >= nRows) {
+				continue;
+			}
+
+			double dRowSum = 0.0;
+			for (int k = vecRowPtr[i]; k < vecRowPtr[i+1]; k++) {
+				const double dS = vecValues[k];
+
+				dRowSum += dS;
+
+				result.dMinWeight = std::min(result.dMinWeight, dS);
+				result.dMaxWeight = std::max(result.dMaxWeight, dS);
+
+				if (fCheckMonotone &&
+				    ((dS < -dMonotoneTolerance) ||
+				     (dS > 1.0 + dMonotoneTolerance))
+				) {
+					result.nNonMonotoneEntries++;
+					InsertOffender(result.vecNonMonotoneEntries,
+						i, vecColIx[k], dS, std::max(-dS, dS - 1.0));
+				}
+			}
+
+			m_dCoverageFracB[i] = dRowSum;
+
+			const double dError = fabs(dRowSum - 1.0);
+			if (dError > dConsistencyTolerance) {
+				result.nInconsistentRows++;
+				InsertOffender(result.vecInconsistentRows,
+					i, (-1), dRowSum, dError);
+			}
+		}
+
+		// Area-weighted column sums and source coverage
+		const int iColBegin = static_cast<int>(
+			static_cast<long long>(nA) * b / nBlocks);
+		const int iColEnd = static_cast<int>(
+			static_cast<long long>(nA) * (b+1) / nBlocks);
+
+		std::vector<double> dColumnSums(iColEnd - iColBegin, 0.0);
+		std::vector<bool> fCovered(iColEnd - iColBegin, false);
+
+		for (int i = 0; i < nRows; i++) {
+			if (vecRowPtr[i] == vecRowPtr[i+1]) {
+				continue;
+			}
+
+			const int * pColBegin = &(vecColIx[0]) + vecRowPtr[i];
+			const int * pColEnd = &(vecColIx[0]) + vecRowPtr[i+1];
+
+			int k = vecRowPtr[i];
+			if (iColBegin > 0) {
+				k += static_cast<int>(
+					std::lower_bound(pColBegin, pColEnd, iColBegin) - pColBegin);
+			}
+
+			const double dTargetArea = m_dTargetAreas[i];
+			for (; k < vecRowPtr[i+1]; k++) {
+				const int iCol = vecColIx[k];
+				if (iCol >= iColEnd) {
+					break;
+				}
+
+				dColumnSums[iCol - iColBegin] += vecValues[k] * dTargetArea;
+				fCovered[iCol - iColBegin] = true;
+
+				m_dCoverageFracA[iCol] +=
+					vecValues[k] / m_dSourceAreas[iCol] * dTargetArea;
+			}
+		}
+
+		for (int j = iColBegin; j < iColEnd; j++) {
+			if (!fCovered[j - iColBegin]) {
+				result.nUncoveredSourceColumns++;
+			}
+			if (j >= nCols) {
+				continue;
+			}
+
+			const double dError =
+				fabs(dColumnSums[j - iColBegin] - m_dSourceAreas[j]);
+			if (dError > dConservationTolerance) {
+				result.nNonConservativeColumns++;
+				InsertOffender(result.vecNonConservativeColumns,
+					(-1), j, dColumnSums[j - iColBegin], dError);
+			}
+		}
+	}
+
+	// Combine the results of all blocks
+	OfflineMapVerification verification;
+
+	verification.dMinWeight = std::numeric_limits<double>::max();
+	verification.dMaxWeight = -std::numeric_limits<double>::max();
+
+	for (int b = 0; b < nBlocks; b++) {
+		const OfflineMapVerification & result = vecBlockResults[b];
+
+		verification.nInconsistentRows += result.nInconsistentRows;
+		verification.nNonConservativeColumns += result.nNonConservativeColumns;
+		verification.nNonMonotoneEntries += result.nNonMonotoneEntries;
+		verification.nEmptyTargetRows += result.nEmptyTargetRows;
+		verification.nUncoveredSourceColumns += result.nUncoveredSourceColumns;
+
+		verification.dMinWeight =
+			std::min(verification.dMinWeight, result.dMinWeight);
+		verification.dMaxWeight =
+			std::max(verification.dMaxWeight, result.dMaxWeight);
+
+		for (size_t i = 0; i < result.vecInconsistentRows.size(); i++) {
+			const OfflineMapVerification::Offender & o =
+				result.vecInconsistentRows[i];
+			InsertOffender(verification.vecInconsistentRows,
+				o.iRow, o.iCol, o.dValue, o.dError);
+		}
+		for (size_t i = 0; i < result.vecNonConservativeColumns.size(); i++) {
+			const OfflineMapVerification::Offender & o =
+				result.vecNonConservativeColumns[i];
+			InsertOffender(verification.vecNonConservativeColumns,
+				o.iRow, o.iCol, o.dValue, o.dError);
+		}
+		for (size_t i = 0; i < result.vecNonMonotoneEntries.size(); i++) {
+			const OfflineMapVerification::Offender & o =
+				result.vecNonMonotoneEntries[i];
+			InsertOffender(verification.vecNonMonotoneEntries,
+				o.iRow, o.iCol, o.dValue, o.dError);
+		}
+	}
+
+	if (vecValues.GetRows() == 0) {
+		verification.dMinWeight = 0.0;
+		verification.dMaxWeight = 0.0;
+	}
+
+	verification.fConsistent = (verification.nInconsistentRows == 0);
+	verification.fConservative = (verification.nNonConservativeColumns == 0);
+	verification.fMonotone = (verification.nNonMonotoneEntries == 0);
+
+	m_fCoverageCached = true;
+
+	// Summary table
+	Announce("Consistency  : %i of %i rows fail (tolerance %1.1e)",
+		verification.nInconsistentRows, nRows, dConsistencyTolerance);
+	for (size_t i = 0; i < verification.vecInconsistentRows.size(); i++) {
+		const OfflineMapVerification::Offender & o =
+			verification.vecInconsistentRows[i];
+		Announce("  row %i: sum %1.15e (error %1.5e)",
+			o.iRow, o.dValue, o.dError);
+	}
+
+	Announce("Conservation : %i of %i columns fail (tolerance %1.1e)",
+		verification.nNonConservativeColumns, nCols, dConservationTolerance);
+	for (size_t i = 0; i < verification.vecNonConservativeColumns.size(); i++) {
+		const OfflineMapVerification::Offender & o =
+			verification.vecNonConservativeColumns[i];
+		Announce("  column %i: sum %1.15e / %1.15e (error %1.5e)",
+			o.iCol, o.dValue, m_dSourceAreas[o.iCol], o.dError);
+	}
+
+	if (fCheckMonotone) {
+		Announce("Monotonicity : %i of %i entries fail (tolerance %1.1e)",
+			verification.nNonMonotoneEntries,
+			static_cast<int>(vecValues.GetRows()),
+			dMonotoneTolerance);
+		for (size_t i = 0; i < verification.vecNonMonotoneEntries.size(); i++) {
+			const OfflineMapVerification::Offender & o =
+				verification.vecNonMonotoneEntries[i];
+			Announce("  entry (%i, %i): %1.15e",
+				o.iRow, o.iCol, o.dValue);
+		}
+	}
+
+	Announce("Weights      : [%1.15e, %1.15e]",
+		verification.dMinWeight, verification.dMaxWeight);
+	Announce("Coverage     : %i of %i target rows empty, "
+		"%i of %i source columns uncovered",
+		verification.nEmptyTargetRows, nB,
+		verification.nUncoveredSourceColumns, nA);
+
+	if (pVerification != NULL) {
+		*pVerification = verification;
+	}
+
+	return (verification.fConsistent
+		&& verification.fConservative
+		&& verification.fMonotone);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+bool OfflineMap::HasCachedCoverage(
+	int nA,
+	int nB
+) const {
+	return (m_fCoverageCached
+		&& (m_nQuantizeBits == 0)
+		&& (m_dCoverageFracA.GetRows() == nA)
+		&& (m_dCoverageFracB.GetRows() == nB));
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Largest residual of the row sums, relative to the magnitude of the
+///		target row sum, and of the area-weighted column sums, relative to
+///		the area-weighted magnitude of the column, as used by Prune().
+///	</summary>
+static double PruneResidualError(
+	const std::vector<double> & dResidual,
+	const std::vector<double> & dRowTargets,
+	const std::vector<double> & dColWeight
+) {
+	const int nRows = static_cast<int>(dRowTargets.size());
+	const int nCols = static_cast<int>(dColWeight.size());
+
+	double dError = 0.0;
+	for (int i = 0; i < nRows; i++) {
+		dError = std::max(dError,
+			fabs(dResidual[i]) / std::max(1.0, fabs(dRowTargets[i])));
+	}
+	for (int j = 0; j < nCols; j++) {
+		if (dColWeight[j] != 0.0) {
+			dError = std::max(dError,
+				fabs(dResidual[nRows + j]) / dColWeight[j]);
+		}
+	}
+	return dError;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Apply the normal operator of the row and column correction used by
+///		Prune().  The multipliers dP of the rows and columns are expanded
+///		to the correction dS_ij = w_ij (p_i + a_i p_j) of each entry, whose
+///		row sums and area-weighted column sums are returned in dQ.
+///	</summary>
+static void ApplyPruneCorrection(
+	const DataArray1D<int> & vecRowPtr,
+	const DataArray1D<int> & dataCols,
+	const std::vector<double> & dWeights,
+	const DataArray1D<double> & dTargetAreas,
+	int nCols,
+	const std::vector<double> & dP,
+	std::vector<double> & dQ,
+	int nThreads
+) {
+	const int nRows = static_cast<int>(vecRowPtr.GetRows()) - 1;
+
+#pragma omp parallel for num_threads(nThreads)
+	for (int i = 0; i < nRows; i++) {
+		double dRowSum = 0.0;
+		for (int k = vecRowPtr[i]; k < vecRowPtr[i+1]; k++) {
+			dRowSum += dWeights[k]
+				* (dP[i] + dTargetAreas[i] * dP[nRows + dataCols[k]]);
+		}
+		dQ[i] = dRowSum;
+	}
+
+	std::fill(dQ.begin() + nRows, dQ.begin() + nRows + nCols, 0.0);
+	for (int i = 0; i < nRows; i++) {
+		for (int k = vecRowPtr[i]; k < vecRowPtr[i+1]; k++) {
+			const int j = dataCols[k];
+			dQ[nRows + j] += dTargetAreas[i] * dWeights[k]
+				* (dP[i] + dTargetAreas[i] * dP[nRows + j]);
+		}
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void OfflineMap::Prune(
+	double dThreshold,
+	bool fDropMasked,
+	double dTolerance,
+	int nMaxIterations,
+	OfflineMapPruneSummary * pSummary
+) {
+	if (m_fSinglePrecision) {
+		_EXCEPTIONT("Prune() requires double precision weights");
+	}
+	if (dThreshold < 0.0) {
+		_EXCEPTIONT("Prune() threshold must be nonnegative");
+	}
+
+	AnnounceStartBlock("Pruning map weights");
+
+	// Operate on the compressed form of the map
+	m_mapRemap.Freeze();
+
+	const DataArray1D<int> & vecRowPtr = m_mapRemap.GetRowPointers();
+	const DataArray1D<int> & vecColIx = m_mapRemap.GetColumnIndices();
+	const DataArray1D<double> & vecValues = m_mapRemap.GetValues();
+
+	const int nRows = m_mapRemap.GetRows();
+	const int nCols = m_mapRemap.GetColumns();
+
+	const int nA = static_cast<int>(m_dSourceAreas.GetRows());
+	const int nB = static_cast<int>(m_dTargetAreas.GetRows());
+
+	if ((nRows > nB) || (nCols > nA)) {
+		_EXCEPTION4("OfflineMap (%i x %i) larger than its target / source "
+			"areas (%i x %i)", nRows, nCols, nB, nA);
+	}
+
+	const bool fSourceMask =
+		fDropMasked && (m_iSourceMask.GetRows() == static_cast<size_t>(nA));
+	const bool fTargetMask =
+		fDropMasked && (m_iTargetMask.GetRows() == static_cast<size_t>(nB));
+
+	OfflineMapPruneSummary summary;
+
+	const size_t sEntries = vecValues.GetRows();
+	summary.sNonZerosBefore = sEntries;
+
+	// Row and area-weighted column sums of the map before pruning
+	std::vector<double> dRowSums(nRows, 0.0);
+	std::vector<double> dColSums(nCols, 0.0);
+
+	// Row and area-weighted column sums restricted to unmasked entries,
+	// which are restored after small entries are removed
+	std::vector<double> dRowTargets(nRows, 0.0);
+	std::vector<double> dColTargets(nCols, 0.0);
+
+	// Entries that are retained, and the largest entry in each column
+	std::vector<char> fKeep(sEntries, 1);
+	std::vector<int> ixColMax(nCols, (-1));
+
+	for (int i = 0; i < nRows; i++) {
+		const bool fRowMasked = fTargetMask && (m_iTargetMask[i] == 0);
+
+		for (int k = vecRowPtr[i]; k < vecRowPtr[i+1]; k++) {
+			const int j = vecColIx[k];
+			const double dS = vecValues[k];
+
+			dRowSums[i] += dS;
+			dColSums[j] += dS * m_dTargetAreas[i];
+
+			if (fRowMasked || (fSourceMask && (m_iSourceMask[j] == 0))) {
+				fKeep[k] = 0;
+				summary.sDroppedMasked++;
+				continue;
+			}
+
+			dRowTargets[i] += dS;
+			dColTargets[j] += dS * m_dTargetAreas[i];
+
+			if ((ixColMax[j] == (-1)) ||
+			    (fabs(dS) > fabs(vecValues[ixColMax[j]]))
+			) {
+				ixColMax[j] = k;
+			}
+		}
+	}
+
+	for (int i = 0; i < nRows; i++) {
+		if (vecRowPtr[i] == vecRowPtr[i+1]) {
+			continue;
+		}
+		summary.dConsistencyErrorBefore =
+			std::max(summary.dConsistencyErrorBefore,
+				fabs(dRowSums[i] - 1.0));
+	}
+	for (int j = 0; j < nCols; j++) {
+		summary.dConservationErrorBefore =
+			std::max(summary.dConservationErrorBefore,
+				fabs(dColSums[j] - m_dSourceAreas[j]));
+	}
+
+	// Remove small entries, retaining the largest entry in each row and
+	// each column so that no nonempty row or column is emptied
+	for (int i = 0; i < nRows; i++) {
+		int ixRowMax = (-1);
+		for (int k = vecRowPtr[i]; k < vecRowPtr[i+1]; k++) {
+			if (fKeep[k] &&
+			    ((ixRowMax == (-1)) ||
+			     (fabs(vecValues[k]) > fabs(vecValues[ixRowMax])))
+			) {
+				ixRowMax = k;
+			}
+		}
+		for (int k = vecRowPtr[i]; k < vecRowPtr[i+1]; k++) {
+			if (fKeep[k] &&
+			    (fabs(vecValues[k]) < dThreshold) &&
+			    (k != ixRowMax) &&
+			    (k != ixColMax[vecColIx[k]])
+			) {
+				fKeep[k] = 0;
+				summary.sDroppedSmall++;
+			}
+		}
+	}
+
+	// Compact the retained entries
+	const size_t sKept =
+		sEntries - summary.sDroppedSmall - summary.sDroppedMasked;
+
+	DataArray1D<int> dataRows(sKept);
+	DataArray1D<int> dataCols(sKept);
+	DataArray1D<double> dataEntries(sKept);
+	DataArray1D<int> vecKeptRowPtr(nRows + 1);
+
+	{
+		size_t ix = 0;
+		for (int i = 0; i < nRows; i++) {
+			vecKeptRowPtr[i] = static_cast<int>(ix);
+			for (int k = vecRowPtr[i]; k < vecRowPtr[i+1]; k++) {
+				if (fKeep[k]) {
+					dataRows[ix] = i;
+					dataCols[ix] = vecColIx[k];
+					dataEntries[ix] = vecValues[k];
+					ix++;
+				}
+			}
+		}
+		vecKeptRowPtr[nRows] = static_cast<int>(ix);
+	}
+
+	const DataArray1D<double> dataOriginal(dataEntries);
+
+	// Restore the row sums and the area-weighted column sums with the
+	// correction of least weighted norm on the retained sparsity pattern,
+	// dS_ij = |S_ij| (alpha_i + a_i beta_j), which rescales each row and
+	// column in proportion to the magnitude of its entries.  The
+	// multipliers are found by preconditioned conjugate gradients, which is
+	// restarted from the true residual to remove accumulated rounding.  If
+	// the pruned pattern cannot satisfy all constraints the iterate with
+	// the smallest residual is used, and passes stop once they no longer
+	// reduce the true residual.
+	const int nUnknowns = nRows + nCols;
+	const int nMaxPasses = 4;
+
+	std::vector<double> dWeights(sKept);
+	std::vector<double> dDiagonal(nUnknowns);
+	std::vector<double> dResidual(nUnknowns);
+	std::vector<double> dColWeight(nCols);
+	std::vector<double> dX(nUnknowns);
+	std::vector<double> dXBest(nUnknowns);
+	std::vector<double> dZ(nUnknowns);
+	std::vector<double> dP(nUnknowns);
+	std::vector<double> dQ(nUnknowns);
+
+	DataArray1D<double> dataPrevious;
+	double dPreviousError = std::numeric_limits<double>::max();
+
+	for (int iPass = 0; ; iPass++) {
+		std::fill(dDiagonal.begin() + nRows, dDiagonal.end(), 0.0);
+		std::fill(dResidual.begin() + nRows, dResidual.end(), 0.0);
+		std::fill(dColWeight.begin(), dColWeight.end(), 0.0);
+
+		for (int i = 0; i < nRows; i++) {
+			double dRowSum = 0.0;
+			double dRowWeight = 0.0;
+			for (int k = vecKeptRowPtr[i]; k < vecKeptRowPtr[i+1]; k++) {
+				const int j = dataCols[k];
+				dWeights[k] = fabs(dataEntries[k]);
+
+				dRowSum += dataEntries[k];
+				dRowWeight += dWeights[k];
+
+				dResidual[nRows + j] += dataEntries[k] * m_dTargetAreas[i];
+				dColWeight[j] += dWeights[k] * m_dTargetAreas[i];
+				dDiagonal[nRows + j] +=
+					dWeights[k] * m_dTargetAreas[i] * m_dTargetAreas[i];
+			}
+			dResidual[i] = dRowTargets[i] - dRowSum;
+			dDiagonal[i] = dRowWeight;
+		}
+		for (int j = 0; j < nCols; j++) {
+			dResidual[nRows + j] = dColTargets[j] - dResidual[nRows + j];
+		}
+
+		double dError =
+			PruneResidualError(dResidual, dRowTargets, dColWeight);
+
+		if (dError <= dTolerance) {
+			break;
+		}
+		if (dError >= dPreviousError) {
+			dataEntries = dataPrevious;
+			dError = dPreviousError;
+		}
+		if ((dError == dPreviousError) ||
+		    (iPass == nMaxPasses) ||
+		    (summary.nIterations >= nMaxIterations)
+		) {
+			Announce("WARNING: Row / column sums not restored to within "
+				"tolerance (%1.5e)", dError);
+			break;
+		}
+
+		dataPrevious = dataEntries;
+		dPreviousError = dError;
+
+		// Jacobi-preconditioned conjugate gradients
+		double dBestError = dError;
+		for (int n = 0; n < nUnknowns; n++) {
+			dX[n] = 0.0;
+			dXBest[n] = 0.0;
+			dZ[n] = (dDiagonal[n] != 0.0)?(dResidual[n] / dDiagonal[n]):(0.0);
+			dP[n] = dZ[n];
+		}
+
+		double dRZ = 0.0;
+		for (int n = 0; n < nUnknowns; n++) {
+			dRZ += dResidual[n] * dZ[n];
+		}
+
+		while (summary.nIterations < nMaxIterations) {
+			summary.nIterations++;
+
+			ApplyPruneCorrection(
+				vecKeptRowPtr, dataCols, dWeights,
+				m_dTargetAreas, nCols, dP, dQ, m_nThreads);
+
+			double dPQ = 0.0;
+			for (int n = 0; n < nUnknowns; n++) {
+				dPQ += dP[n] * dQ[n];
+			}
+			if (dPQ <= 0.0) {
+				break;
+			}
+
+			const double dAlpha = dRZ / dPQ;
+			for (int n = 0; n < nUnknowns; n++) {
+				dX[n] += dAlpha * dP[n];
+				dResidual[n] -= dAlpha * dQ[n];
+			}
+
+			dError = PruneResidualError(dResidual, dRowTargets, dColWeight);
+			if (dError < dBestError) {
+				dBestError = dError;
+				dXBest = dX;
+			}
+			if (dError <= 0.1 * dTolerance) {
+				break;
+			}
+
+			double dRZNew = 0.0;
+			for (int n = 0; n < nUnknowns; n++) {
+				dZ[n] = (dDiagonal[n] != 0.0)?(dResidual[n] / dDiagonal[n]):(0.0);
+				dRZNew += dResidual[n] * dZ[n];
+			}
+
+			const double dBeta = dRZNew / dRZ;
+			for (int n = 0; n < nUnknowns; n++) {
+				dP[n] = dZ[n] + dBeta * dP[n];
+			}
+			dRZ = dRZNew;
+		}
+
+		// Apply the correction
+#pragma omp parallel for num_threads(m_nThreads)
+		for (int i = 0; i < nRows; i++) {
+			for (int k = vecKeptRowPtr[i]; k < vecKeptRowPtr[i+1]; k++) {
+				dataEntries[k] += dWeights[k] * (dXBest[i]
+					+ m_dTargetAreas[i] * dXBest[nRows + dataCols[k]]);
+			}
+		}
+	}
+
+	// Errors of the pruned map
+	std::vector<double> dColCurrent(nCols, 0.0);
+	std::vector<char> fColNonEmpty(nCols, 0);
+
+	for (int i = 0; i < nRows; i++) {
+		if (vecKeptRowPtr[i] == vecKeptRowPtr[i+1]) {
+			continue;
+		}
+		double dRowSum = 0.0;
+		for (int k = vecKeptRowPtr[i]; k < vecKeptRowPtr[i+1]; k++) {
+			dRowSum += dataEntries[k];
+			dColCurrent[dataCols[k]] += dataEntries[k] * m_dTargetAreas[i];
+			fColNonEmpty[dataCols[k]] = 1;
+
+			summary.dMaxWeightChange = std::max(summary.dMaxWeightChange,
+				fabs(dataEntries[k] - dataOriginal[k]));
+		}
+		summary.dConsistencyErrorAfter =
+			std::max(summary.dConsistencyErrorAfter, fabs(dRowSum - 1.0));
+	}
+	for (int j = 0; j < nCols; j++) {
+		if (fColNonEmpty[j]) {
+			summary.dConservationErrorAfter =
+				std::max(summary.dConservationErrorAfter,
+					fabs(dColCurrent[j] - m_dSourceAreas[j]));
+		}
+	}
+
+	// Replace the map
+	m_fCoverageCached = false;
+	m_mapRemap.SetEntries(dataRows, dataCols, dataEntries);
+
+	summary.sNonZerosAfter = m_mapRemap.GetNonZeroCount();
+
+	Announce("Threshold    : %1.5e%s", dThreshold,
+		(fDropMasked)?(" (masked rows / columns dropped)"):(""));
+	Announce("Non-zeros    : %lu -> %lu (%lu small, %lu masked removed)",
+		summary.sNonZerosBefore, summary.sNonZerosAfter,
+		summary.sDroppedSmall, summary.sDroppedMasked);
+	Announce("Consistency  : %1.5e -> %1.5e",
+		summary.dConsistencyErrorBefore, summary.dConsistencyErrorAfter);
+	Announce("Conservation : %1.5e -> %1.5e",
+		summary.dConservationErrorBefore, summary.dConservationErrorAfter);
+	Announce("Rescaling    : %i iterations, max weight change %1.5e",
+		summary.nIterations, summary.dMaxWeightChange);
+
+	AnnounceEndBlock("Done");
+
+	if (pSummary != NULL) {
+		*pSummary = summary;
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
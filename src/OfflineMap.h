@@ -18,15 +18,157 @@
 #define _OFFLINEMAP_H_
 
 #include "SparseMatrix.h"
+#include "SparseMatrixDevice.h"
 #include "DataArray1D.h"
 #include "DataArray2D.h"
 #include "DataArray3D.h"
 #include "netcdfcpp.h"
 #include <string>
 #include <vector>
+#include <memory>
+#include <utility>
 
 class Mesh;
 
+struct OfflineMapSliceBlock;
+
+class OfflineMapRemapWorker;
+
+class OfflineMapImage;
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		The results of a verification pass over an OfflineMap, produced by
+///		OfflineMap::Verify().
+///	</summary>
+struct OfflineMapVerification {
+
+	///	<summary>
+	///		Maximum number of offenders retained for each property.
+	///	</summary>
+	static const int MaxOffenders = 5;
+
+	///	<summary>
+	///		A row, column or entry of the map that fails a property.  The
+	///		column is (-1) for rows and the row is (-1) for columns.
+	///	</summary>
+	struct Offender {
+		int iRow;
+		int iCol;
+		double dValue;
+		double dError;
+	};
+
+	///	<summary>
+	///		Constructor.
+	///	</summary>
+	OfflineMapVerification() :
+		fConsistent(true),
+		fConservative(true),
+		fMonotone(true),
+		nInconsistentRows(0),
+		nNonConservativeColumns(0),
+		nNonMonotoneEntries(0),
+		nEmptyTargetRows(0),
+		nUncoveredSourceColumns(0),
+		dMinWeight(0.0),
+		dMaxWeight(0.0)
+	{ }
+
+	///	<summary>
+	///		Flags indicating the map is consistent, conservative and
+	///		monotone.  fMonotone is true if monotonicity was not checked.
+	///	</summary>
+	bool fConsistent;
+	bool fConservative;
+	bool fMonotone;
+
+	///	<summary>
+	///		Number of rows, columns and entries failing each property.
+	///	</summary>
+	int nInconsistentRows;
+	int nNonConservativeColumns;
+	int nNonMonotoneEntries;
+
+	///	<summary>
+	///		Number of target rows and source columns without entries.
+	///	</summary>
+	int nEmptyTargetRows;
+	int nUncoveredSourceColumns;
+
+	///	<summary>
+	///		Range of the weights of the map.
+	///	</summary>
+	double dMinWeight;
+	double dMaxWeight;
+
+	///	<summary>
+	///		The worst offenders for each property, by decreasing error.
+	///	</summary>
+	std::vector<Offender> vecInconsistentRows;
+	std::vector<Offender> vecNonConservativeColumns;
+	std::vector<Offender> vecNonMonotoneEntries;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		A summary of the entries removed by OfflineMap::Prune() and of the
+///		consistency and conservation of the map before and after.
+///	</summary>
+struct OfflineMapPruneSummary {
+
+	///	<summary>
+	///		Constructor.
+	///	</summary>
+	OfflineMapPruneSummary() :
+		sNonZerosBefore(0),
+		sNonZerosAfter(0),
+		sDroppedSmall(0),
+		sDroppedMasked(0),
+		nIterations(0),
+		dConsistencyErrorBefore(0.0),
+		dConsistencyErrorAfter(0.0),
+		dConservationErrorBefore(0.0),
+		dConservationErrorAfter(0.0),
+		dMaxWeightChange(0.0)
+	{ }
+
+	///	<summary>
+	///		Number of entries before and after pruning.
+	///	</summary>
+	size_t sNonZerosBefore;
+	size_t sNonZerosAfter;
+
+	///	<summary>
+	///		Number of entries removed for being below the threshold and for
+	///		lying in a masked row or column.
+	///	</summary>
+	size_t sDroppedSmall;
+	size_t sDroppedMasked;
+
+	///	<summary>
+	///		Number of conjugate gradient iterations used to restore the row
+	///		and column sums.
+	///	</summary>
+	int nIterations;
+
+	///	<summary>
+	///		Largest deviation of a row sum from one, and of an area-weighted
+	///		column sum from the source area, over nonempty rows and columns.
+	///	</summary>
+	double dConsistencyErrorBefore;
+	double dConsistencyErrorAfter;
+	double dConservationErrorBefore;
+	double dConservationErrorAfter;
+
+	///	<summary>
+	///		Largest change of a retained weight.
+	///	</summary>
+	double dMaxWeightChange;
+};
+
 ///////////////////////////////////////////////////////////////////////////////
 
 ///	<summary>
@@ -35,6 +177,23 @@ class Mesh;
 class OfflineMap {
 
 public:
+	///	<summary>
+	///		Default constructor.
+	///	</summary>
+	OfflineMap() :
+		m_nSourceGridOffset(0),
+		m_nSourceGridFullSize(0),
+		m_flFillValueOverride(0.0f),
+		m_nThreads(1),
+		m_nBatchSize(16),
+		m_nDeflateLevel(0),
+		m_nQuantizeBits(0),
+		m_fCoverageCached(false),
+		m_fSinglePrecision(false),
+		m_fAsyncIO(false),
+		m_fDeviceApply(false)
+	{ }
+
 	///	<summary>
 	///		An empty virtual destructor.
 	///	</summary>
@@ -72,6 +231,26 @@ public:
         const std::vector<int>& p_tgtDimSizes
     );
 
+	///	<summary>
+	///		Get the dimension sizes and names of the source grid.
+	///	</summary>
+	const std::vector<int> & GetSourceDimensionSizes() const {
+		return m_vecSourceDimSizes;
+	}
+	const std::vector<std::string> & GetSourceDimensionNames() const {
+		return m_vecSourceDimNames;
+	}
+
+	///	<summary>
+	///		Get the dimension sizes and names of the target grid.
+	///	</summary>
+	const std::vector<int> & GetTargetDimensionSizes() const {
+		return m_vecTargetDimSizes;
+	}
+	const std::vector<std::string> & GetTargetDimensionNames() const {
+		return m_vecTargetDimNames;
+	}
+
 private:
 	///	<summary>
 	///		Initialize the coordinate arrays for a finite-volume mesh.
@@ -155,6 +334,7 @@ public:
 	///	</summary>
 	DataArray1D<double>& GetSourceCenterLon()
 	{
+		RequireSourceCoordinates();
 		return m_dSourceCenterLon;
 	}
 
@@ -163,6 +343,7 @@ public:
 	///	</summary>
 	const DataArray1D<double>& GetSourceCenterLon() const
 	{
+		RequireSourceCoordinates();
 		return m_dSourceCenterLon;
 	}
 
@@ -171,6 +352,7 @@ public:
 	///	</summary>
 	DataArray1D<double>& GetSourceCenterLat()
 	{
+		RequireSourceCoordinates();
 		return m_dSourceCenterLat;
 	}
 
@@ -179,6 +361,7 @@ public:
 	///	</summary>
 	const DataArray1D<double>& GetSourceCenterLat() const
 	{
+		RequireSourceCoordinates();
 		return m_dSourceCenterLat;
 	}
 
@@ -187,6 +370,7 @@ public:
 	///	</summary>
 	DataArray1D<double>& GetTargetCenterLon()
 	{
+		RequireTargetCoordinates();
 		return m_dTargetCenterLon;
 	}
 
@@ -195,6 +379,7 @@ public:
 	///	</summary>
 	const DataArray1D<double>& GetTargetCenterLon() const
 	{
+		RequireTargetCoordinates();
 		return m_dTargetCenterLon;
 	}
 
@@ -203,6 +388,7 @@ public:
 	///	</summary>
 	DataArray1D<double>& GetTargetCenterLat()
 	{
+		RequireTargetCoordinates();
 		return m_dTargetCenterLat;
 	}
 
@@ -211,6 +397,7 @@ public:
 	///	</summary>
 	const DataArray1D<double>& GetTargetCenterLat() const
 	{
+		RequireTargetCoordinates();
 		return m_dTargetCenterLat;
 	}
 
@@ -219,6 +406,7 @@ public:
 	///	</summary>
 	DataArray2D<double>& GetSourceVertexLon()
 	{
+		RequireSourceCoordinates();
 		return m_dSourceVertexLon;
 	}
 
@@ -227,6 +415,7 @@ public:
 	///	</summary>
 	const DataArray2D<double>& GetSourceVertexLon() const
 	{
+		RequireSourceCoordinates();
 		return m_dSourceVertexLon;
 	}
 
@@ -235,6 +424,7 @@ public:
 	///	</summary>
 	DataArray2D<double>& GetTargetVertexLon()
 	{
+		RequireTargetCoordinates();
 		return m_dTargetVertexLon;
 	}
 
@@ -243,6 +433,7 @@ public:
 	///	</summary>
 	const DataArray2D<double>& GetTargetVertexLon() const
 	{
+		RequireTargetCoordinates();
 		return m_dTargetVertexLon;
 	}
 
@@ -251,6 +442,7 @@ public:
 	///	</summary>
 	DataArray2D<double>& GetSourceVertexLat()
 	{
+		RequireSourceCoordinates();
 		return m_dSourceVertexLat;
 	}
 
@@ -259,6 +451,7 @@ public:
 	///	</summary>
 	const DataArray2D<double>& GetSourceVertexLat() const
 	{
+		RequireSourceCoordinates();
 		return m_dSourceVertexLat;
 	}
 
@@ -267,6 +460,7 @@ public:
 	///	</summary>
 	DataArray2D<double>& GetTargetVertexLat()
 	{
+		RequireTargetCoordinates();
 		return m_dTargetVertexLat;
 	}
 
@@ -275,6 +469,7 @@ public:
 	///	</summary>
 	const DataArray2D<double>& GetTargetVertexLat() const
 	{
+		RequireTargetCoordinates();
 		return m_dTargetVertexLat;
 	}
 
@@ -300,7 +495,11 @@ public:
 
 public:
 	///	<summary>
-	///		Apply the offline map to a data file.
+	///		Apply the offline map to a data file.  Each pair of
+	///		vecVectorVariables names the eastward and northward components
+	///		of a vector variable, which are remapped with ApplyVector().
+	///		If vecVariables is empty all remappable variables other than
+	///		vector components are remapped as scalars.
 	///	</summary>
 	void Apply(
 		const std::string & strSourceDataFile,
@@ -308,9 +507,153 @@ public:
 		const std::vector<std::string> & vecVariables,
 		const std::string & strNColName,
 		bool fTargetDouble = false,
-		bool fAppend = false
+		bool fAppend = false,
+		const std::vector< std::pair<std::string, std::string> > &
+			vecVectorVariables =
+				std::vector< std::pair<std::string, std::string> >()
+	);
+
+	///	<summary>
+	///		Apply the offline map to nFields fields held in caller-owned
+	///		memory, without any NetCDF I/O.  Cell i of source field f is
+	///		located at pSource[f * sSourceFieldStride + i * sSourceCellStride]
+	///		and cell j of target field f is written to
+	///		pTarget[f * sTargetFieldStride + j * sTargetCellStride].  Strides
+	///		are given in elements.  nSourceCells and nTargetCells must match
+	///		the source and target grids of the map.  Fill values and masks
+	///		are not treated specially.
+	///	</summary>
+	void Apply(
+		const double * pSource,
+		int nSourceCells,
+		ptrdiff_t sSourceFieldStride,
+		ptrdiff_t sSourceCellStride,
+		double * pTarget,
+		int nTargetCells,
+		ptrdiff_t sTargetFieldStride,
+		ptrdiff_t sTargetCellStride,
+		int nFields
+	);
+
+	///	<summary>
+	///		As above, for single precision fields.  Products are accumulated
+	///		in double precision.
+	///	</summary>
+	void Apply(
+		const float * pSource,
+		int nSourceCells,
+		ptrdiff_t sSourceFieldStride,
+		ptrdiff_t sSourceCellStride,
+		float * pTarget,
+		int nTargetCells,
+		ptrdiff_t sTargetFieldStride,
+		ptrdiff_t sTargetCellStride,
+		int nFields
 	);
 
+	///	<summary>
+	///		Apply the offline map to nFields vector fields held in
+	///		caller-owned memory, given by their eastward (U) and northward
+	///		(V) components.  Field f occupies cells [f * nSourceCells,
+	///		(f+1) * nSourceCells) of pSourceU and pSourceV, and likewise on
+	///		the target.  The components are converted to three Cartesian
+	///		components at the source cell centers, all of which are
+	///		remapped in a single pass over the map, and projected back onto
+	///		the eastward and northward directions at the target cell
+	///		centers.  The map must hold the source and target center
+	///		coordinates.
+	///	</summary>
+	void ApplyVector(
+		const double * pSourceU,
+		const double * pSourceV,
+		int nSourceCells,
+		double * pTargetU,
+		double * pTargetV,
+		int nTargetCells,
+		int nFields
+	);
+
+protected:
+	///	<summary>
+	///		Create the variable of the target file of Apply() that holds
+	///		the remapped source variable var, adding its free dimensions
+	///		(and their coordinate variables) to the target file.  The sizes
+	///		of the free dimensions and the cursors and counts used to read
+	///		and write one slice are returned.
+	///	</summary>
+	NcVar * AddApplyTargetVariable(
+		NcFile & ncSource,
+		NcFile & ncTarget,
+		NcVar * var,
+		NcDim * dim0,
+		NcDim * dim1,
+		bool fTargetDouble,
+		DataArray1D<long> & vecDimSizes,
+		DataArray1D<long> & nCountsIn,
+		DataArray1D<long> & nCountsOut,
+		DataArray1D<long> & nGet,
+		DataArray1D<long> & nPut
+	);
+
+	///	<summary>
+	///		Remap the blocks of the eastward and northward components of a
+	///		vector variable read by Apply() in double precision.  Both
+	///		components are set to zero where either is a fill value.
+	///	</summary>
+	void RemapVectorSliceBlock(
+		OfflineMapSliceBlock & blockU,
+		OfflineMapSliceBlock & blockV,
+		double dFillValueU,
+		double dFillValueV
+	);
+
+	///	<summary>
+	///		Remap a block of data slices read by Apply(), dispatching on the
+	///		types of its buffers.
+	///	</summary>
+	void RemapSliceBlock(
+		OfflineMapSliceBlock & block,
+		float flFillValue,
+		double dFillValue
+	);
+
+	///	<summary>
+	///		Remap a block of nBatch contiguous data slices read by Apply(),
+	///		replacing fill values in the input by zero and computing the
+	///		mass and extrema of each input and output slice.  Type
+	///		conversion is performed within the sparse product.
+	///	</summary>
+	template <typename InType, typename OutType>
+	void ApplyToSliceBlock(
+		InType * pDataIn,
+		OutType * pDataOut,
+		int nBatch,
+		InType valueFill,
+		DataArray1D<double> & dSourceMass,
+		DataArray1D<double> & dSourceMin,
+		DataArray1D<double> & dSourceMax,
+		DataArray1D<double> & dTargetMass,
+		DataArray1D<double> & dTargetMin,
+		DataArray1D<double> & dTargetMax
+	);
+
+	///	<summary>
+	///		Implementation of Apply() on caller-owned memory.
+	///	</summary>
+	template <typename ValueType>
+	void ApplyToArray(
+		const ValueType * pSource,
+		int nSourceCells,
+		ptrdiff_t sSourceFieldStride,
+		ptrdiff_t sSourceCellStride,
+		ValueType * pTarget,
+		int nTargetCells,
+		ptrdiff_t sTargetFieldStride,
+		ptrdiff_t sTargetCellStride,
+		int nFields
+	);
+
+public:
 	///	<summary>
 	///		Read the OfflineMap from a NetCDF file.
 	///	</summary>
@@ -320,6 +663,192 @@ public:
 		NcFile::FileFormat * peFileFormat = NULL
 	);
 
+	///	<summary>
+	///		Read the OfflineMap from a NetCDF file without the sparse matrix,
+	///		which is left empty.  Used with SetTranspose() and
+	///		WriteTransposeOfFile() to transpose maps that do not fit in
+	///		memory.
+	///	</summary>
+	void ReadGrid(
+		const std::string & strSource,
+		std::map<std::string, std::string> * pmapAttributes = NULL,
+		NcFile::FileFormat * peFileFormat = NULL
+	);
+
+	///	<summary>
+	///		Read only the parts of the OfflineMap from a NetCDF file that are
+	///		needed by Apply(): dimensions, areas, masks, vector coordinates
+	///		and the sparse matrix.  The center and vertex coordinates of the
+	///		source and target meshes are read from strSource on first
+	///		access, so the file must not be modified while this OfflineMap
+	///		is in use.
+	///	</summary>
+	void ReadWeights(
+		const std::string & strSource
+	);
+
+	///	<summary>
+	///		As ReadWeights(), but only load the sparse matrix entries in
+	///		target rows [iTargetRowBegin, iTargetRowEnd) (zero-based).  The
+	///		entries of the map file must be sorted by row; only the entries
+	///		of the row range are read from the file.
+	///	</summary>
+	void ReadWeights(
+		const std::string & strSource,
+		int iTargetRowBegin,
+		int iTargetRowEnd
+	);
+
+	///	<summary>
+	///		As ReadWeights(), but only load the sparse matrix entries in the
+	///		given target rows (zero-based).  The entries of the map file must
+	///		be sorted by row; entries outside the span of the given rows are
+	///		not read from the file.
+	///	</summary>
+	void ReadWeights(
+		const std::string & strSource,
+		const std::vector<int> & vecTargetRows
+	);
+
+	///	<summary>
+	///		As ReadWeights(), but attach the weights of the binary image of
+	///		strSource in the cache directory strCacheDir.  The image is
+	///		memory mapped, so that all processes on a node that apply the
+	///		same map share one copy of the weights.  If the image is missing
+	///		or the size or modification time of strSource has changed since
+	///		it was built, strSource is read and the image is rebuilt; if the
+	///		image cannot be written the weights read from strSource are used.
+	///	</summary>
+	void ReadWeightsCached(
+		const std::string & strSource,
+		const std::string & strCacheDir
+	);
+
+	///	<summary>
+	///		Write a binary image of the weights, grid dimensions, areas,
+	///		masks and vector coordinates of this OfflineMap to strImage, for
+	///		use by ReadWeightsCached().  The OfflineMap must hold the
+	///		contents of the map file strSource, which identifies the image.
+	///	</summary>
+	void WriteWeightsImage(
+		const std::string & strImage,
+		const std::string & strSource
+	);
+
+protected:
+	///	<summary>
+	///		Attach the weights, grid dimensions, areas, masks and vector
+	///		coordinates of an open map image.  The center and vertex
+	///		coordinates are read from the source map on first access.
+	///	</summary>
+	void AttachWeightsImage(
+		const std::shared_ptr<OfflineMapImage> & pImage
+	);
+
+protected:
+	///	<summary>
+	///		Read the src_grid_dims and dst_grid_dims entries of a map file.
+	///	</summary>
+	void ReadGridDimensions(
+		NcFile & ncMap,
+		const std::string & strSource
+	);
+
+	///	<summary>
+	///		Read the target latitude-longitude vectors and bounds of a map
+	///		file, if present.
+	///	</summary>
+	void ReadTargetVectorCoordinates(
+		NcFile & ncMap
+	);
+
+	///	<summary>
+	///		Read the areas and masks of a map file.
+	///	</summary>
+	void ReadAreasAndMasks(
+		NcFile & ncMap,
+		const std::string & strSource,
+		int nA,
+		int nB
+	);
+
+	///	<summary>
+	///		Read the sparse matrix of a map file.  If iTargetRowEnd is
+	///		negative all entries are read; otherwise only entries in target
+	///		rows [iTargetRowBegin, iTargetRowEnd) of a row-sorted file are
+	///		read, optionally restricted to the sorted list pvecTargetRows.
+	///	</summary>
+	void ReadSparseMatrix(
+		NcFile & ncMap,
+		const std::string & strSource,
+		int iTargetRowBegin,
+		int iTargetRowEnd,
+		const std::vector<int> * pvecTargetRows
+	);
+
+	///	<summary>
+	///		Implementation of Read() and ReadGrid().
+	///	</summary>
+	void ReadMapFile(
+		const std::string & strSource,
+		std::map<std::string, std::string> * pmapAttributes,
+		NcFile::FileFormat * peFileFormat,
+		bool fReadSparseMatrix
+	);
+
+	///	<summary>
+	///		Read the center and vertex coordinates of side strSide ("a" or
+	///		"b") of the map file ncMap.
+	///	</summary>
+	void ReadCoordinates(
+		NcFile & ncMap,
+		const std::string & strSource,
+		const std::string & strSide,
+		DataArray1D<double> & dCenterLon,
+		DataArray1D<double> & dCenterLat,
+		DataArray2D<double> & dVertexLon,
+		DataArray2D<double> & dVertexLat
+	);
+
+	///	<summary>
+	///		Read the pending source (if fSource) or target coordinates from
+	///		the map file they were deferred to.
+	///	</summary>
+	void ReadPendingCoordinates(
+		bool fSource
+	);
+
+	///	<summary>
+	///		Ensure the source coordinates are loaded, reading them from the
+	///		map file if they were deferred.
+	///	</summary>
+	void RequireSourceCoordinates() const {
+		if (m_strSourceCoordinateFile != "") {
+			const_cast<OfflineMap *>(this)->ReadPendingCoordinates(true);
+		}
+	}
+
+	///	<summary>
+	///		Ensure the target coordinates are loaded, reading them from the
+	///		map file if they were deferred.
+	///	</summary>
+	void RequireTargetCoordinates() const {
+		if (m_strTargetCoordinateFile != "") {
+			const_cast<OfflineMap *>(this)->ReadPendingCoordinates(false);
+		}
+	}
+
+	///	<summary>
+	///		Implementation of ReadWeights().
+	///	</summary>
+	void ReadWeightsForRows(
+		const std::string & strSource,
+		int iTargetRowBegin,
+		int iTargetRowEnd,
+		const std::vector<int> * pvecTargetRows
+	);
+
+public:
 	///	<summary>
 	///		Write the OfflineMap to a NetCDF file, with attribute map.
 	///	</summary>
@@ -330,12 +859,112 @@ public:
 	);
 
 	///	<summary>
-	///		Initialize a map that is the transverse of the given map.
+	///		Write the transpose of the sparse matrix of the map file
+	///		strInputMap to a NetCDF file, with attribute map, without loading
+	///		the sparse matrix into memory.  This OfflineMap must hold the
+	///		transpose of the grid of strInputMap, as obtained from
+	///		ReadGrid() followed by SetTranspose().  The columns of the input
+	///		map are transposed in bands of at most sMaxEntries entries (or
+	///		one column, if larger), reading the input sparse matrix once
+	///		for each band.  For a map file without repeated entries the
+	///		output is identical to that of Write() after SetTranspose() of
+	///		the full map.
+	///	</summary>
+	void WriteTransposeOfFile(
+		const std::string & strInputMap,
+		const std::string & strTarget,
+		const std::map<std::string, std::string> & mapAttributes,
+		NcFile::FileFormat eFileFormat,
+		size_t sMaxEntries
+	);
+
+protected:
+	///	<summary>
+	///		Write the dimensions, coordinates, areas and masks of the
+	///		OfflineMap to an open NetCDF file.
+	///	</summary>
+	void WriteGrid(
+		NcFile & ncMap
+	);
+
+public:
+	///	<summary>
+	///		Initialize a map that is the transverse of the given map.  The
+	///		sparse matrix is transposed directly in compressed form, with
+	///		the area rescaling applied as entries are placed, using nThreads
+	///		threads.
 	///	</summary>
 	void SetTranspose(
-		const OfflineMap & mapIn
+		const OfflineMap & mapIn,
+		int nThreads = 1
+	);
+
+	///	<summary>
+	///		Initialize a map that is the composition of two maps, equivalent
+	///		to applying mapFirst and then mapSecond.  The target mesh of
+	///		mapFirst must be the source mesh of mapSecond.
+	///	</summary>
+	void SetComposition(
+		const OfflineMap & mapFirst,
+		const OfflineMap & mapSecond,
+		int nThreads = 1
+	);
+
+	///	<summary>
+	///		Initialize a map that is the restriction of mapIn to the given
+	///		target rows (zero-based), renumbered in the order given.  The
+	///		source grid is restricted to the smallest range of its first
+	///		(slowest varying) dimension that contains every source column
+	///		referenced by these rows, and Apply() reads only this range of
+	///		each source variable.  If the rows form a rectangular block of
+	///		a rectilinear target grid, in order, the target grid remains
+	///		rectilinear.
+	///	</summary>
+	void SetSubMap(
+		const OfflineMap & mapIn,
+		const std::vector<int> & vecTargetRows
 	);
 
+	///	<summary>
+	///		Get the target rows (zero-based) whose cell centers lie in the
+	///		longitude-latitude box [dLonMin, dLonMax] x [dLatMin, dLatMax],
+	///		in degrees.  Longitudes are compared modulo 360, so the box may
+	///		span the prime meridian.
+	///	</summary>
+	void GetTargetRowsInBox(
+		double dLonMin,
+		double dLonMax,
+		double dLatMin,
+		double dLatMax,
+		std::vector<int> & vecTargetRows
+	) const;
+
+	///	<summary>
+	///		Get the index along the first source dimension of the source
+	///		data at which the source grid of this map begins.
+	///	</summary>
+	int GetSourceGridOffset() const {
+		return m_nSourceGridOffset;
+	}
+
+	///	<summary>
+	///		Get the size of the first source dimension of the source data,
+	///		which is the number of source degrees of freedom if the source
+	///		grid has one dimension.
+	///	</summary>
+	int GetSourceGridFullSize() const {
+		if (m_nSourceGridFullSize != 0) {
+			return m_nSourceGridFullSize;
+		}
+		if (m_vecSourceDimSizes.size() == 1) {
+			return static_cast<int>(m_dSourceAreas.GetRows());
+		}
+		if (m_vecSourceDimSizes.size() == 0) {
+			return 0;
+		}
+		return m_vecSourceDimSizes[0];
+	}
+
 public:
 	///	<summary>
 	///		Determine if the map is first-order accurate.
@@ -358,11 +987,62 @@ public:
 		double dTolerance
 	);
 
+	///	<summary>
+	///		Verify consistency, conservation and (if fCheckMonotone is set)
+	///		monotonicity of the map, and the coverage of the source and
+	///		target meshes, in a single pass over the compressed map with
+	///		m_nThreads threads.  A summary of the failures and the worst
+	///		offenders is announced and, if pVerification is not NULL,
+	///		returned.  The fractional coverage arrays are retained and
+	///		reused by Write() until the map is modified.  Returns true if
+	///		all checked properties hold.
+	///	</summary>
+	virtual bool Verify(
+		double dConsistencyTolerance,
+		double dConservationTolerance,
+		bool fCheckMonotone,
+		double dMonotoneTolerance,
+		OfflineMapVerification * pVerification = NULL
+	);
+
+	///	<summary>
+	///		Remove the weights of magnitude below dThreshold and, if
+	///		fDropMasked is set, all weights in rows and columns whose target
+	///		or source mask is zero.  The largest weight of each row and of
+	///		each column is always retained.  The row sums and area-weighted
+	///		column sums of the map restricted to the unmasked rows and
+	///		columns are then restored by rescaling each row and column in
+	///		proportion to the magnitude of its weights, using the smallest
+	///		such correction, to within dTolerance (relative to the
+	///		area-weighted magnitude of each column) or until nMaxIterations
+	///		conjugate gradient iterations are reached.  A summary is
+	///		announced and, if pSummary is not NULL, returned.
+	///	</summary>
+	void Prune(
+		double dThreshold,
+		bool fDropMasked,
+		double dTolerance = 1.0e-14,
+		int nMaxIterations = 500,
+		OfflineMapPruneSummary * pSummary = NULL
+	);
+
+protected:
+	///	<summary>
+	///		Determine if the fractional coverage arrays retained by
+	///		Verify() can be written for source and target meshes of nA and
+	///		nB elements.
+	///	</summary>
+	bool HasCachedCoverage(
+		int nA,
+		int nB
+	) const;
+
 public:
 	///	<summary>
 	///		Get the vector of areas associated with the source mesh.
 	///	</summary>
 	DataArray1D<double> & GetSourceAreas() {
+		m_fCoverageCached = false;
 		return m_dSourceAreas;
 	}
 
@@ -377,6 +1057,7 @@ public:
 	///		Get the vector of areas associated with the target mesh.
 	///	</summary>
 	DataArray1D<double> & GetTargetAreas() {
+		m_fCoverageCached = false;
 		return m_dTargetAreas;
 	}
 
@@ -391,6 +1072,7 @@ public:
 	///		Set the vector of areas associated with the source mesh.
 	///	</summary>
 	void SetSourceAreas(const DataArray1D<double> & dSourceAreas) {
+		m_fCoverageCached = false;
 		m_dSourceAreas = dSourceAreas;
 	}
 
@@ -398,6 +1080,7 @@ public:
 	///		Set the vector of areas associated with the target mesh.
 	///	</summary>
 	void SetTargetAreas(const DataArray1D<double> & dTargetAreas) {
+		m_fCoverageCached = false;
 		m_dTargetAreas = dTargetAreas;
 	}
 
@@ -442,9 +1125,31 @@ public:
 	///		Get the SparseMatrix representation of the OfflineMap.
 	///	</summary>
 	SparseMatrix<double> & GetSparseMatrix() {
+		m_fCoverageCached = false;
 		return m_mapRemap;
 	}
 
+	///	<summary>
+	///		Convert the weights of this map to single precision storage,
+	///		releasing the double precision weights.  Subsequent calls to
+	///		Apply() read weights as float and accumulate in double.  If
+	///		fReportAccuracy is true the error introduced by the conversion
+	///		is estimated against the double precision weights and announced.
+	///		Operations that modify, verify or write the weights require
+	///		double precision weights and are not available after conversion.
+	///	</summary>
+	void ConvertToSinglePrecision(
+		bool fReportAccuracy = true
+	);
+
+	///	<summary>
+	///		Determine if the weights of this map are stored in single
+	///		precision.
+	///	</summary>
+	bool IsSinglePrecision() const {
+		return m_fSinglePrecision;
+	}
+
 	/// <summary>
 	///		Determine if dimension information has been initialized.
 	///	</summary>
@@ -472,6 +1177,95 @@ public:
 		m_flFillValueOverride = flFillValueOverride;
 	}
 
+	///	<summary>
+	///		Set the number of threads used to remap data slices in Apply()
+	///		and to initialize coordinates from a mesh.  NetCDF reads and
+	///		writes are always performed by a single thread.
+	///	</summary>
+	void SetThreadCount(int nThreads) {
+		if (nThreads < 1) {
+			_EXCEPTION1("Invalid thread count (%i)", nThreads);
+		}
+		m_nThreads = nThreads;
+	}
+
+	///	<summary>
+	///		Get the number of threads used to remap data slices.
+	///	</summary>
+	int GetThreadCount() const {
+		return m_nThreads;
+	}
+
+	///	<summary>
+	///		Set the number of data slices gathered into each block that is
+	///		passed to the batched SparseMatrix::Apply().
+	///	</summary>
+	void SetBatchSize(int nBatchSize) {
+		if (nBatchSize < 1) {
+			_EXCEPTION1("Invalid batch size (%i)", nBatchSize);
+		}
+		m_nBatchSize = nBatchSize;
+	}
+
+	///	<summary>
+	///		Get the number of data slices gathered into each block.
+	///	</summary>
+	int GetBatchSize() const {
+		return m_nBatchSize;
+	}
+
+	///	<summary>
+	///		Overlap NetCDF reads and writes in Apply() with remapping.  When
+	///		enabled, two blocks of slices are in flight: the next block is
+	///		read and the previous block is written while the current block
+	///		is remapped on a separate thread.  All NetCDF calls remain on
+	///		the calling thread.
+	///	</summary>
+	void SetAsyncIO(bool fAsyncIO) {
+		m_fAsyncIO = fAsyncIO;
+	}
+
+	///	<summary>
+	///		Remap data slices in Apply() on a GPU.  The weights are uploaded
+	///		once per call to Apply() and each block of slices is remapped
+	///		by a single sparse matrix-matrix product on the device.
+	///		Throws an Exception if no device is available.
+	///	</summary>
+	void SetDeviceApply(bool fDeviceApply) {
+		if (fDeviceApply && !SparseMatrixDevice::IsAvailable()) {
+			_EXCEPTIONT("No device available to apply the map "
+				"(requires a build with TEMPEST_CUSPARSE and a GPU)");
+		}
+		m_fDeviceApply = fDeviceApply;
+	}
+
+	///	<summary>
+	///		Set the compression of the sparse matrix in NetCDF-4 map files
+	///		written by Write().  A nonzero nDeflateLevel enables the shuffle
+	///		and deflate filters on row, col and S.  A nonzero nQuantizeBits
+	///		rounds each entry of S to the given number of mantissa bits,
+	///		which is lossy but greatly improves the deflate ratio.
+	///	</summary>
+	void SetWriteCompression(int nDeflateLevel, int nQuantizeBits = 0) {
+		if ((nDeflateLevel < 0) || (nDeflateLevel > 9)) {
+			_EXCEPTION1("Invalid deflate level (%i)", nDeflateLevel);
+		}
+		if ((nQuantizeBits < 0) || (nQuantizeBits > 52)) {
+			_EXCEPTION1("Invalid number of quantized mantissa bits (%i)",
+				nQuantizeBits);
+		}
+		m_nDeflateLevel = nDeflateLevel;
+		m_nQuantizeBits = nQuantizeBits;
+	}
+
+	///	<summary>
+	///		Get the compression set with SetWriteCompression().
+	///	</summary>
+	void GetWriteCompression(int & nDeflateLevel, int & nQuantizeBits) const {
+		nDeflateLevel = m_nDeflateLevel;
+		nQuantizeBits = m_nQuantizeBits;
+	}
+
 protected:
 	///	<summary>
 	///		The SparseMatrix representing this operator.
@@ -559,6 +1353,22 @@ protected:
 	///	</summary>
 	DataArray2D<double> m_dTargetVertexLat;
 
+	///	<summary>
+	///		Map file from which the source center and vertex coordinates
+	///		are read on first access, or empty if they are loaded, and the
+	///		side ("a" or "b") of the file they are read from.
+	///	</summary>
+	std::string m_strSourceCoordinateFile;
+	std::string m_strSourceCoordinateSide;
+
+	///	<summary>
+	///		Map file from which the target center and vertex coordinates
+	///		are read on first access, or empty if they are loaded, and the
+	///		side ("a" or "b") of the file they are read from.
+	///	</summary>
+	std::string m_strTargetCoordinateFile;
+	std::string m_strTargetCoordinateSide;
+
 	///	<summary>
 	///		Vector containing cell center longitude along "lon" dimension.
 	///	</sumamry>
@@ -590,6 +1400,15 @@ protected:
 	///	</summary>
 	std::vector<std::string> m_vecSourceDimNames;
 
+	///	<summary>
+	///		For a sub-map, the index along the first source dimension of
+	///		the source data at which the source grid of this map begins,
+	///		and the size of that dimension in the source data.  The full
+	///		size is zero if the source grid is not a sub-range.
+	///	</summary>
+	int m_nSourceGridOffset;
+	int m_nSourceGridFullSize;
+
 	///	<summary>
 	///		Vector of dimension sizes for target.
 	///	</summary>
@@ -604,6 +1423,76 @@ protected:
 	///		The fill value override.
 	///	</summary>
 	float m_flFillValueOverride;
+
+	///	<summary>
+	///		The number of threads used to remap data slices.
+	///	</summary>
+	int m_nThreads;
+
+	///	<summary>
+	///		The number of data slices remapped per traversal of the map.
+	///	</summary>
+	int m_nBatchSize;
+
+	///	<summary>
+	///		The deflate level applied to the sparse matrix on output.
+	///	</summary>
+	int m_nDeflateLevel;
+
+	///	<summary>
+	///		The number of mantissa bits of S retained on output, or zero
+	///		if S is written without quantization.
+	///	</summary>
+	int m_nQuantizeBits;
+
+	///	<summary>
+	///		A flag indicating m_dCoverageFracA and m_dCoverageFracB hold the
+	///		fractional coverage of the current map, as computed by Verify().
+	///	</summary>
+	bool m_fCoverageCached;
+
+	///	<summary>
+	///		Fractional coverage of the source and target meshes.
+	///	</summary>
+	DataArray1D<double> m_dCoverageFracA;
+	DataArray1D<double> m_dCoverageFracB;
+
+	///	<summary>
+	///		The single precision SparseMatrix representing this operator,
+	///		populated by ConvertToSinglePrecision().
+	///	</summary>
+	SparseMatrix<float> m_mapRemapSingle;
+
+	///	<summary>
+	///		A flag indicating the weights are stored in m_mapRemapSingle.
+	///	</summary>
+	bool m_fSinglePrecision;
+
+	///	<summary>
+	///		A flag indicating NetCDF I/O in Apply() is overlapped with
+	///		remapping.
+	///	</summary>
+	bool m_fAsyncIO;
+
+	///	<summary>
+	///		A flag indicating data slices in Apply() are remapped on a GPU.
+	///	</summary>
+	bool m_fDeviceApply;
+
+	///	<summary>
+	///		The device copy of the weights used by Apply(), uploaded for
+	///		the duration of each call when m_fDeviceApply is set.
+	///	</summary>
+	SparseMatrixDevice m_mapRemapDevice;
+
+	///	<summary>
+	///		The map image whose weights are attached to m_mapRemap by
+	///		ReadWeightsCached(), which is unmapped when the last OfflineMap
+	///		referring to it is destroyed.
+	///	</summary>
+	std::shared_ptr<OfflineMapImage> m_pWeightsImage;
+
+	friend class OfflineMapRemapWorker;
 };
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,595 @@
+///////////////////////////////////////////////////////////////////////////////
+///
+///	\file    OfflineMapCache.cpp
+///	\author  agent
+///	\version October 14, 2026
+///
+///	<remarks>
+///		Copyright 2026 agent
+///
+///		This file is distributed as part of the Tempest source code package.
+///		Permission is granted to use, copy, modify and distribute this
+///		source code and its documentation under the terms of the GNU General
+///		Public License.  This software is provided "as is" without express
+///		or implied warranty.
+///	</remarks>
+
+#include "OfflineMapCache.h"
+#include "Exception.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Magic number at the beginning of a map image.
+///	</summary>
+static const char OfflineMapImageMagic[8] =
+	{ 'T', 'R', 'M', 'A', 'P', 'I', 'M', 'G' };
+
+///	<summary>
+///		Byte order marker of a map image, which is stored in native order.
+///	</summary>
+static const uint32_t OfflineMapImageByteOrder = 0x01020304;
+
+///	<summary>
+///		Alignment of the sections of a map image, in bytes.
+///	</summary>
+static const size_t OfflineMapImageAlignment = 64;
+
+///	<summary>
+///		Offset basis and prime of the 64-bit FNV-1a hash.
+///	</summary>
+static const uint64_t FNV1aOffsetBasis = 14695981039346656037ULL;
+static const uint64_t FNV1aPrime = 1099511628211ULL;
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Update a 64-bit FNV-1a hash with sBytes bytes of data.
+///	</summary>
+static uint64_t FNV1aUpdate(
+	uint64_t uHash,
+	const void * pData,
+	size_t sBytes
+) {
+	const unsigned char * p = reinterpret_cast<const unsigned char *>(pData);
+	for (size_t i = 0; i < sBytes; i++) {
+		uHash ^= static_cast<uint64_t>(p[i]);
+		uHash *= FNV1aPrime;
+	}
+	return uHash;
+}
+
+///	<summary>
+///		Round sBytes up to a multiple of OfflineMapImageAlignment.
+///	</summary>
+static size_t AlignImageOffset(
+	size_t sBytes
+) {
+	return ((sBytes + OfflineMapImageAlignment - 1)
+		/ OfflineMapImageAlignment) * OfflineMapImageAlignment;
+}
+
+///	<summary>
+///		Store the size, modification time, device and inode of a source
+///		map file in the source fields of header.
+///	</summary>
+static void SetSourceStatus(
+	const struct stat & statSource,
+	OfflineMapImageHeader & header
+) {
+	header.uSourceSize = static_cast<uint64_t>(statSource.st_size);
+	header.iSourceMTime = static_cast<int64_t>(statSource.st_mtime);
+#if defined(__APPLE__)
+	header.iSourceMTimeNSec =
+		static_cast<int64_t>(statSource.st_mtimespec.tv_nsec);
+#else
+	header.iSourceMTimeNSec =
+		static_cast<int64_t>(statSource.st_mtim.tv_nsec);
+#endif
+	header.uSourceDevice = static_cast<uint64_t>(statSource.st_dev);
+	header.uSourceInode = static_cast<uint64_t>(statSource.st_ino);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// OfflineMapImage
+///////////////////////////////////////////////////////////////////////////////
+
+OfflineMapImage::OfflineMapImage() :
+	m_pData(NULL),
+	m_sSize(0)
+{
+	for (int s = 0; s < OfflineMapImageSection_Count; s++) {
+		m_sOffsets[s] = 0;
+		m_sSizes[s] = 0;
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+OfflineMapImage::~OfflineMapImage() {
+	Close();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+bool OfflineMapImage::Open(
+	const std::string & strImage
+) {
+	Close();
+
+	int fd = open(strImage.c_str(), O_RDONLY);
+	if (fd < 0) {
+		if (errno == ENOENT) {
+			return false;
+		}
+		_EXCEPTION2("Unable to open map image \"%s\" (%s)",
+			strImage.c_str(), strerror(errno));
+	}
+
+	struct stat statImage;
+	if (fstat(fd, &statImage) != 0) {
+		close(fd);
+		_EXCEPTION1("Unable to stat map image \"%s\"", strImage.c_str());
+	}
+
+	const size_t sSize = static_cast<size_t>(statImage.st_size);
+	if (sSize < sizeof(OfflineMapImageHeader)) {
+		close(fd);
+		_EXCEPTION1("Map image \"%s\" is truncated", strImage.c_str());
+	}
+
+	// Private writable mapping: pages are shared with other processes
+	// until they are modified
+	void * pData =
+		mmap(NULL, sSize, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+	close(fd);
+
+	if (pData == MAP_FAILED) {
+		_EXCEPTION2("Unable to map image \"%s\" (%s)",
+			strImage.c_str(), strerror(errno));
+	}
+
+	m_strImage = strImage;
+	m_pData = reinterpret_cast<char *>(pData);
+	m_sSize = sSize;
+
+	// Validate the header
+	const OfflineMapImageHeader & header = GetHeader();
+
+	if (memcmp(header.szMagic, OfflineMapImageMagic, 8) != 0) {
+		Close();
+		_EXCEPTION1("File \"%s\" is not a map image", strImage.c_str());
+	}
+	if ((header.uVersion != OfflineMapImageVersion) ||
+	    (header.uByteOrder != OfflineMapImageByteOrder)
+	) {
+		Close();
+		_EXCEPTION1("Map image \"%s\" has an incompatible version or "
+			"byte order", strImage.c_str());
+	}
+	if ((header.nA < 0) || (header.nB < 0) ||
+	    (header.nRows < 0) || (header.nCols < 0) ||
+	    (header.nSourceDims < 0) || (header.nTargetDims < 0) ||
+	    (header.nVectorLat < 0) || (header.nVectorLon < 0) ||
+	    (header.nSourcePathLength < 0)
+	) {
+		Close();
+		_EXCEPTION1("Map image \"%s\" has an invalid header",
+			strImage.c_str());
+	}
+
+	const size_t sImageSize = ComputeLayout(header, m_sOffsets, m_sSizes);
+	if ((sImageSize != header.uImageSize) || (sImageSize != m_sSize)) {
+		Close();
+		_EXCEPTION1("Map image \"%s\" is truncated or corrupt",
+			strImage.c_str());
+	}
+
+	const int * pRowPtr = GetSection<int>(OfflineMapImageSection_RowPtr);
+	if ((pRowPtr[0] != 0) ||
+	    (static_cast<uint64_t>(pRowPtr[header.nRows]) != header.sNonZeros)
+	) {
+		Close();
+		_EXCEPTION1("Map image \"%s\" has invalid row pointers",
+			strImage.c_str());
+	}
+
+	return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void OfflineMapImage::Close() {
+	if (m_pData != NULL) {
+		munmap(m_pData, m_sSize);
+	}
+
+	m_strImage = "";
+	m_pData = NULL;
+	m_sSize = 0;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+bool OfflineMapImage::IsCurrent() const {
+	if (!IsOpen()) {
+		_EXCEPTIONT("Map image must be open");
+	}
+
+	const std::string strSource = GetSourcePath();
+
+	struct stat statSource;
+	if (stat(strSource.c_str(), &statSource) != 0) {
+		return false;
+	}
+
+	// A rewrite of the same size within one second is only detected by
+	// the nanosecond part of the modification time, and a replacement
+	// by rename only by the inode
+	OfflineMapImageHeader headerSource;
+	SetSourceStatus(statSource, headerSource);
+
+	const OfflineMapImageHeader & header = GetHeader();
+
+	return (
+		(headerSource.uSourceSize == header.uSourceSize) &&
+		(headerSource.iSourceMTime == header.iSourceMTime) &&
+		(headerSource.iSourceMTimeNSec == header.iSourceMTimeNSec) &&
+		(headerSource.uSourceDevice == header.uSourceDevice) &&
+		(headerSource.uSourceInode == header.uSourceInode));
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+std::string OfflineMapImage::GetSourcePath() const {
+	if (!IsOpen()) {
+		_EXCEPTIONT("Map image must be open");
+	}
+
+	return std::string(
+		GetSection<const char>(OfflineMapImageSection_SourcePath),
+		GetHeader().nSourcePathLength);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void OfflineMapImage::GetDimensions(
+	bool fSource,
+	std::vector<int> & vecDimSizes,
+	std::vector<std::string> & vecDimNames
+) const {
+	if (!IsOpen()) {
+		_EXCEPTIONT("Map image must be open");
+	}
+
+	const OfflineMapImageHeader & header = GetHeader();
+
+	const int nDims = fSource ? header.nSourceDims : header.nTargetDims;
+	const int ixBegin = fSource ? 0 : header.nSourceDims;
+
+	const int32_t * pDimSizes =
+		GetSection<const int32_t>(OfflineMapImageSection_DimSizes);
+	const char * pDimNames =
+		GetSection<const char>(OfflineMapImageSection_DimNames);
+
+	vecDimSizes.resize(nDims);
+	vecDimNames.resize(nDims);
+
+	for (int d = 0; d < nDims; d++) {
+		const char * szName =
+			pDimNames + (ixBegin + d) * OfflineMapImageDimNameLength;
+
+		vecDimSizes[d] = pDimSizes[ixBegin + d];
+		vecDimNames[d] = std::string(szName,
+			strnlen(szName, OfflineMapImageDimNameLength));
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+uint64_t OfflineMapImage::ComputePayloadChecksum() const {
+	if (!IsOpen()) {
+		_EXCEPTIONT("Map image must be open");
+	}
+
+	const size_t sHeaderSize = AlignImageOffset(sizeof(OfflineMapImageHeader));
+
+	return FNV1aUpdate(
+		FNV1aOffsetBasis, m_pData + sHeaderSize, m_sSize - sHeaderSize);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void OfflineMapImage::Write(
+	const std::string & strImage,
+	OfflineMapImageHeader & header,
+	const void * const pSections[OfflineMapImageSection_Count]
+) {
+	size_t sOffsets[OfflineMapImageSection_Count];
+	size_t sSizes[OfflineMapImageSection_Count];
+
+	header.uImageSize = ComputeLayout(header, sOffsets, sSizes);
+	header.uPayloadChecksum = FNV1aOffsetBasis;
+
+	for (int s = 0; s < OfflineMapImageSection_Count; s++) {
+		if ((sSizes[s] != 0) && (pSections[s] == NULL)) {
+			_EXCEPTION1("Missing data for section %i of map image", s);
+		}
+	}
+
+	// Create the cache directory if it does not exist
+	const size_t ixSlash = strImage.rfind('/');
+	if ((ixSlash != std::string::npos) && (ixSlash != 0)) {
+		const std::string strCacheDir = strImage.substr(0, ixSlash);
+		if ((mkdir(strCacheDir.c_str(), 0777) != 0) && (errno != EEXIST)) {
+			_EXCEPTION2("Unable to create cache directory \"%s\" (%s)",
+				strCacheDir.c_str(), strerror(errno));
+		}
+	}
+
+	// Temporary file in the same directory, so that it can be renamed
+	char szSuffix[32];
+	snprintf(szSuffix, sizeof(szSuffix), ".tmp.%ld",
+		static_cast<long>(getpid()));
+	const std::string strTemp = strImage + szSuffix;
+
+	FILE * fp = fopen(strTemp.c_str(), "wb");
+	if (fp == NULL) {
+		_EXCEPTION2("Unable to create map image \"%s\" (%s)",
+			strTemp.c_str(), strerror(errno));
+	}
+
+	// The header is rewritten once the payload checksum is known
+	bool fSuccess =
+		(fwrite(&header, sizeof(OfflineMapImageHeader), 1, fp) == 1);
+
+	static const char szPadding[OfflineMapImageAlignment] = { 0 };
+
+	size_t sPosition = sizeof(OfflineMapImageHeader);
+	const size_t sHeaderSize = AlignImageOffset(sizeof(OfflineMapImageHeader));
+
+	for (int s = 0; (s <= OfflineMapImageSection_Count) && fSuccess; s++) {
+		const size_t sTarget =
+			(s == OfflineMapImageSection_Count)
+			? static_cast<size_t>(header.uImageSize) : sOffsets[s];
+
+		const size_t sPadding = sTarget - sPosition;
+		if (sPadding != 0) {
+			fSuccess = (fwrite(szPadding, 1, sPadding, fp) == sPadding);
+			if (sPosition >= sHeaderSize) {
+				header.uPayloadChecksum =
+					FNV1aUpdate(header.uPayloadChecksum, szPadding, sPadding);
+			}
+			sPosition = sTarget;
+		}
+
+		if ((s == OfflineMapImageSection_Count) || (sSizes[s] == 0)) {
+			continue;
+		}
+
+		fSuccess = fSuccess &&
+			(fwrite(pSections[s], 1, sSizes[s], fp) == sSizes[s]);
+		header.uPayloadChecksum =
+			FNV1aUpdate(header.uPayloadChecksum, pSections[s], sSizes[s]);
+		sPosition += sSizes[s];
+	}
+
+	fSuccess = fSuccess &&
+		(fseek(fp, 0, SEEK_SET) == 0) &&
+		(fwrite(&header, sizeof(OfflineMapImageHeader), 1, fp) == 1);
+
+	fSuccess = (fclose(fp) == 0) && fSuccess;
+
+	if (!fSuccess) {
+		remove(strTemp.c_str());
+		_EXCEPTION1("Error writing map image \"%s\"", strTemp.c_str());
+	}
+
+	if (rename(strTemp.c_str(), strImage.c_str()) != 0) {
+		remove(strTemp.c_str());
+		_EXCEPTION2("Unable to rename map image to \"%s\" (%s)",
+			strImage.c_str(), strerror(errno));
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void OfflineMapImage::InitializeHeader(
+	OfflineMapImageHeader & header
+) {
+	memset(&header, 0, sizeof(OfflineMapImageHeader));
+	memcpy(header.szMagic, OfflineMapImageMagic, 8);
+	header.uVersion = OfflineMapImageVersion;
+	header.uByteOrder = OfflineMapImageByteOrder;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void OfflineMapImage::GetFileStatus(
+	const std::string & strFile,
+	std::string & strAbsolutePath,
+	OfflineMapImageHeader & header
+) {
+	char szPath[PATH_MAX];
+	if (realpath(strFile.c_str(), szPath) == NULL) {
+		_EXCEPTION2("Unable to resolve path of \"%s\" (%s)",
+			strFile.c_str(), strerror(errno));
+	}
+
+	struct stat statFile;
+	if (stat(szPath, &statFile) != 0) {
+		_EXCEPTION1("Unable to stat \"%s\"", szPath);
+	}
+
+	strAbsolutePath = szPath;
+	SetSourceStatus(statFile, header);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+uint64_t OfflineMapImage::ComputeFileChecksum(
+	const std::string & strFile
+) {
+	FILE * fp = fopen(strFile.c_str(), "rb");
+	if (fp == NULL) {
+		_EXCEPTION1("Unable to open \"%s\"", strFile.c_str());
+	}
+
+	std::vector<char> vecBuffer(1 << 20);
+
+	uint64_t uHash = FNV1aOffsetBasis;
+	for (;;) {
+		const size_t sRead = fread(&(vecBuffer[0]), 1, vecBuffer.size(), fp);
+		uHash = FNV1aUpdate(uHash, &(vecBuffer[0]), sRead);
+		if (sRead < vecBuffer.size()) {
+			break;
+		}
+	}
+
+	const bool fError = (ferror(fp) != 0);
+	fclose(fp);
+
+	if (fError) {
+		_EXCEPTION1("Error reading \"%s\"", strFile.c_str());
+	}
+
+	return uHash;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+std::string OfflineMapImage::GetImagePath(
+	const std::string & strCacheDir,
+	const std::string & strSource
+) {
+	std::string strAbsolutePath;
+	OfflineMapImageHeader header;
+	GetFileStatus(strSource, strAbsolutePath, header);
+
+	std::string strBase = strAbsolutePath;
+	const size_t ixSlash = strBase.rfind('/');
+	if (ixSlash != std::string::npos) {
+		strBase = strBase.substr(ixSlash + 1);
+	}
+
+	char szHash[32];
+	snprintf(szHash, sizeof(szHash), ".%016llx",
+		static_cast<unsigned long long>(
+			FNV1aUpdate(FNV1aOffsetBasis,
+				strAbsolutePath.c_str(), strAbsolutePath.length())));
+
+	std::string strImage = strCacheDir;
+	if ((strImage.length() != 0) && (strImage[strImage.length()-1] != '/')) {
+		strImage += "/";
+	}
+
+	return (strImage + strBase + szHash + OfflineMapImageExtension);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+std::string OfflineMapImage::GetDefaultCacheDirectory() {
+	const char * szCacheDir = getenv("TEMPEST_MAP_CACHE");
+	if ((szCacheDir != NULL) && (szCacheDir[0] != '\0')) {
+		return std::string(szCacheDir);
+	}
+	return std::string("/dev/shm/tempestremap");
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void OfflineMapImage::ListImages(
+	const std::string & strCacheDir,
+	std::vector<std::string> & vecImages
+) {
+	vecImages.clear();
+
+	DIR * pDir = opendir(strCacheDir.c_str());
+	if (pDir == NULL) {
+		if (errno == ENOENT) {
+			return;
+		}
+		_EXCEPTION2("Unable to open cache directory \"%s\" (%s)",
+			strCacheDir.c_str(), strerror(errno));
+	}
+
+	const std::string strExtension(OfflineMapImageExtension);
+
+	struct dirent * pEntry;
+	while ((pEntry = readdir(pDir)) != NULL) {
+		const std::string strName(pEntry->d_name);
+		if ((strName.length() > strExtension.length()) &&
+		    (strName.compare(
+				strName.length() - strExtension.length(),
+				strExtension.length(),
+				strExtension) == 0)
+		) {
+			vecImages.push_back(strCacheDir + "/" + strName);
+		}
+	}
+
+	closedir(pDir);
+
+	std::sort(vecImages.begin(), vecImages.end());
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+size_t OfflineMapImage::ComputeLayout(
+	const OfflineMapImageHeader & header,
+	size_t sOffsets[OfflineMapImageSection_Count],
+	size_t sSizes[OfflineMapImageSection_Count]
+) {
+	const size_t nDims =
+		static_cast<size_t>(header.nSourceDims + header.nTargetDims);
+	const size_t sNonZeros = static_cast<size_t>(header.sNonZeros);
+
+	sSizes[OfflineMapImageSection_SourcePath] =
+		static_cast<size_t>(header.nSourcePathLength) + 1;
+	sSizes[OfflineMapImageSection_DimSizes] = nDims * sizeof(int32_t);
+	sSizes[OfflineMapImageSection_DimNames] =
+		nDims * OfflineMapImageDimNameLength;
+	sSizes[OfflineMapImageSection_SourceAreas] = header.nA * sizeof(double);
+	sSizes[OfflineMapImageSection_TargetAreas] = header.nB * sizeof(double);
+	sSizes[OfflineMapImageSection_SourceMask] =
+		(header.fSourceMask != 0) ? (header.nA * sizeof(int)) : 0;
+	sSizes[OfflineMapImageSection_TargetMask] =
+		(header.fTargetMask != 0) ? (header.nB * sizeof(int)) : 0;
+	sSizes[OfflineMapImageSection_VectorCenterLat] =
+		header.nVectorLat * sizeof(double);
+	sSizes[OfflineMapImageSection_VectorCenterLon] =
+		header.nVectorLon * sizeof(double);
+	sSizes[OfflineMapImageSection_VectorBoundsLat] =
+		2 * header.nVectorLat * sizeof(double);
+	sSizes[OfflineMapImageSection_VectorBoundsLon] =
+		2 * header.nVectorLon * sizeof(double);
+	sSizes[OfflineMapImageSection_RowPtr] =
+		(static_cast<size_t>(header.nRows) + 1) * sizeof(int);
+	sSizes[OfflineMapImageSection_ColIx] = sNonZeros * sizeof(int);
+	sSizes[OfflineMapImageSection_Values] = sNonZeros * sizeof(double);
+
+	size_t sOffset = AlignImageOffset(sizeof(OfflineMapImageHeader));
+	for (int s = 0; s < OfflineMapImageSection_Count; s++) {
+		sOffsets[s] = sOffset;
+		sOffset = AlignImageOffset(sOffset + sSizes[s]);
+	}
+
+	return sOffset;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
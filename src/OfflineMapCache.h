@@ -0,0 +1,320 @@
+///////////////////////////////////////////////////////////////////////////////
+///
+///	\file    OfflineMapCache.h
+///	\author  agent
+///	\version October 14, 2026
+///
+///	<remarks>
+///		Copyright 2026 agent
+///
+///		This file is distributed as part of the Tempest source code package.
+///		Permission is granted to use, copy, modify and distribute this
+///		source code and its documentation under the terms of the GNU General
+///		Public License.  This software is provided "as is" without express
+///		or implied warranty.
+///	</remarks>
+
+#ifndef _OFFLINEMAPCACHE_H_
+#define _OFFLINEMAPCACHE_H_
+
+#include <string>
+#include <vector>
+#include <cstddef>
+#include <stdint.h>
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Version of the binary map image format.
+///	</summary>
+static const uint32_t OfflineMapImageVersion = 3;
+
+///	<summary>
+///		Maximum length of a grid dimension name stored in a map image,
+///		including the terminating null character.
+///	</summary>
+static const size_t OfflineMapImageDimNameLength = 64;
+
+///	<summary>
+///		Extension of map image files in a cache directory.
+///	</summary>
+static const char OfflineMapImageExtension[] = ".trmap";
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Sections of a map image, stored in this order after the header and
+///		each aligned to 64 bytes.
+///	</summary>
+enum OfflineMapImageSection {
+	OfflineMapImageSection_SourcePath = 0,
+	OfflineMapImageSection_DimSizes,
+	OfflineMapImageSection_DimNames,
+	OfflineMapImageSection_SourceAreas,
+	OfflineMapImageSection_TargetAreas,
+	OfflineMapImageSection_SourceMask,
+	OfflineMapImageSection_TargetMask,
+	OfflineMapImageSection_VectorCenterLat,
+	OfflineMapImageSection_VectorCenterLon,
+	OfflineMapImageSection_VectorBoundsLat,
+	OfflineMapImageSection_VectorBoundsLon,
+	OfflineMapImageSection_RowPtr,
+	OfflineMapImageSection_ColIx,
+	OfflineMapImageSection_Values,
+	OfflineMapImageSection_Count
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Header of a map image.  The source map is identified by its
+///		absolute path, size, modification time (with nanoseconds), device,
+///		inode and checksum at the time the image was built.  Section sizes follow from the counts; grid
+///		dimension sizes are stored for the source mesh followed by the
+///		target mesh, and a mask or vector section is empty if absent.
+///	</summary>
+struct OfflineMapImageHeader {
+	char szMagic[8];
+	uint32_t uVersion;
+	uint32_t uByteOrder;
+
+	uint64_t uSourceSize;
+	int64_t iSourceMTime;
+	int64_t iSourceMTimeNSec;
+	uint64_t uSourceDevice;
+	uint64_t uSourceInode;
+	uint64_t uSourceChecksum;
+	uint64_t uPayloadChecksum;
+	uint64_t uImageSize;
+
+	int32_t nA;
+	int32_t nB;
+	int32_t nRows;
+	int32_t nCols;
+	uint64_t sNonZeros;
+
+	int32_t nSourceDims;
+	int32_t nTargetDims;
+	int32_t fSourceMask;
+	int32_t fTargetMask;
+	int32_t nVectorLat;
+	int32_t nVectorLon;
+	int32_t nSourcePathLength;
+	int32_t nSourceGridOffset;
+	int32_t nSourceGridFullSize;
+	int32_t iReserved;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		A persistent, read-only binary image of the weights of an offline
+///		map in compressed sparse row form, together with the grid
+///		dimensions, areas, masks and vector coordinates needed to apply it.
+///		Images are memory mapped, so that processes on a node that attach
+///		the same image file (typically in /dev/shm) share one copy of the
+///		weights in the page cache.  Pages are mapped copy-on-write, so a
+///		process that modifies its weights never affects other processes.
+///	</summary>
+class OfflineMapImage {
+
+public:
+	///	<summary>
+	///		Constructor.
+	///	</summary>
+	OfflineMapImage();
+
+	///	<summary>
+	///		Destructor, which unmaps the image.
+	///	</summary>
+	~OfflineMapImage();
+
+private:
+	///	<summary>
+	///		Images are not copyable.
+	///	</summary>
+	OfflineMapImage(const OfflineMapImage &);
+	OfflineMapImage & operator=(const OfflineMapImage &);
+
+public:
+	///	<summary>
+	///		Map the image file strImage and validate its header and size.
+	///		Returns false, leaving the image closed, if the file does not
+	///		exist; throws an Exception if it is not a valid image.
+	///	</summary>
+	bool Open(
+		const std::string & strImage
+	);
+
+	///	<summary>
+	///		Unmap the image.
+	///	</summary>
+	void Close();
+
+	///	<summary>
+	///		Determine if the image is mapped.
+	///	</summary>
+	bool IsOpen() const {
+		return (m_pData != NULL);
+	}
+
+	///	<summary>
+	///		Determine if the image was built from the current contents of
+	///		its source map, as identified by the size and modification time
+	///		of the source map file.
+	///	</summary>
+	bool IsCurrent() const;
+
+	///	<summary>
+	///		Get the header of the image.
+	///	</summary>
+	const OfflineMapImageHeader & GetHeader() const {
+		return *reinterpret_cast<const OfflineMapImageHeader *>(m_pData);
+	}
+
+	///	<summary>
+	///		Get the absolute path of the source map of the image.
+	///	</summary>
+	std::string GetSourcePath() const;
+
+	///	<summary>
+	///		Get the grid dimension sizes and names of the source (if
+	///		fSource) or target mesh.
+	///	</summary>
+	void GetDimensions(
+		bool fSource,
+		std::vector<int> & vecDimSizes,
+		std::vector<std::string> & vecDimNames
+	) const;
+
+	///	<summary>
+	///		Get a pointer to a section of the image.
+	///	</summary>
+	template <typename T>
+	T * GetSection(
+		OfflineMapImageSection eSection
+	) const {
+		return reinterpret_cast<T *>(m_pData + m_sOffsets[eSection]);
+	}
+
+	///	<summary>
+	///		Get the size of a section of the image, in bytes.
+	///	</summary>
+	size_t GetSectionSize(
+		OfflineMapImageSection eSection
+	) const {
+		return m_sSizes[eSection];
+	}
+
+	///	<summary>
+	///		Compute the checksum of the image payload, which follows the
+	///		header.
+	///	</summary>
+	uint64_t ComputePayloadChecksum() const;
+
+public:
+	///	<summary>
+	///		Write an image to strImage.  The header must hold all counts and
+	///		the identification of the source map; the image size and
+	///		payload checksum are filled in.  pSections holds a pointer to
+	///		the data of each section.  The directory of strImage is created
+	///		if it does not exist.  The image is written to a temporary
+	///		file that is renamed into place, so processes attaching the
+	///		image concurrently never see a partial file.
+	///	</summary>
+	static void Write(
+		const std::string & strImage,
+		OfflineMapImageHeader & header,
+		const void * const pSections[OfflineMapImageSection_Count]
+	);
+
+	///	<summary>
+	///		Initialize the magic, version and byte order of a header and set
+	///		all counts to zero.
+	///	</summary>
+	static void InitializeHeader(
+		OfflineMapImageHeader & header
+	);
+
+	///	<summary>
+	///		Get the absolute path of the file strFile and store its size,
+	///		modification time, device and inode in the source fields of
+	///		header.
+	///	</summary>
+	static void GetFileStatus(
+		const std::string & strFile,
+		std::string & strAbsolutePath,
+		OfflineMapImageHeader & header
+	);
+
+	///	<summary>
+	///		Compute the checksum (64-bit FNV-1a) of the contents of the
+	///		file strFile.
+	///	</summary>
+	static uint64_t ComputeFileChecksum(
+		const std::string & strFile
+	);
+
+	///	<summary>
+	///		Get the path of the image of map strSource in the cache
+	///		directory strCacheDir.  The name is formed from the base name of
+	///		the map and a hash of its absolute path, so maps with the same
+	///		name in different directories do not collide.
+	///	</summary>
+	static std::string GetImagePath(
+		const std::string & strCacheDir,
+		const std::string & strSource
+	);
+
+	///	<summary>
+	///		Get the default cache directory, which is $TEMPEST_MAP_CACHE
+	///		if set and otherwise /dev/shm/tempestremap.
+	///	</summary>
+	static std::string GetDefaultCacheDirectory();
+
+	///	<summary>
+	///		Get the paths of all images in the cache directory strCacheDir.
+	///	</summary>
+	static void ListImages(
+		const std::string & strCacheDir,
+		std::vector<std::string> & vecImages
+	);
+
+protected:
+	///	<summary>
+	///		Compute the offsets and sizes of the sections of an image with
+	///		the given header, returning the total size of the image.
+	///	</summary>
+	static size_t ComputeLayout(
+		const OfflineMapImageHeader & header,
+		size_t sOffsets[OfflineMapImageSection_Count],
+		size_t sSizes[OfflineMapImageSection_Count]
+	);
+
+protected:
+	///	<summary>
+	///		Path of the mapped image file.
+	///	</summary>
+	std::string m_strImage;
+
+	///	<summary>
+	///		Mapped data of the image, or NULL if closed.
+	///	</summary>
+	char * m_pData;
+
+	///	<summary>
+	///		Size of the mapped image, in bytes.
+	///	</summary>
+	size_t m_sSize;
+
+	///	<summary>
+	///		Offsets and sizes of the sections of the image, in bytes.
+	///	</summary>
+	size_t m_sOffsets[OfflineMapImageSection_Count];
+	size_t m_sSizes[OfflineMapImageSection_Count];
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+#endif
+
@@ -0,0 +1,411 @@
+///////////////////////////////////////////////////////////////////////////////
+///
+///	\file    OfflineMapGenerator.cpp
+///	\author  agent
+///	\version October 14, 2026
+///
+///	<remarks>
+///		Copyright 2026 agent
+///
+///		This file is distributed as part of the Tempest source code package.
+///		Permission is granted to use, copy, modify and distribute this
+///		source code and its documentation under the terms of the GNU General
+///		Public License.  This software is provided "as is" without express
+///		or implied warranty.
+///	</remarks>
+
+#include "OfflineMapGenerator.h"
+#include "FiniteElementTools.h"
+#include "LinearRemapNonConservative.h"
+
+#include "Announce.h"
+#include "Exception.h"
+#include "OmpExceptionCapture.h"
+#include "STLStringHelper.h"
+
+#include <algorithm>
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Disable announcement output for the lifetime of this object, then
+///		restore the previous setting (including when an Exception is
+///		thrown).
+///	</summary>
+class AnnounceOutputSuppressor {
+
+public:
+	///	<summary>
+	///		Constructor.
+	///	</summary>
+	AnnounceOutputSuppressor() :
+		m_fPreviousOutputEnabled(AnnounceGetOutputEnabled())
+	{
+		AnnounceSetOutputEnabled(false);
+	}
+
+	///	<summary>
+	///		Destructor.
+	///	</summary>
+	~AnnounceOutputSuppressor() {
+		AnnounceSetOutputEnabled(m_fPreviousOutputEnabled);
+	}
+
+protected:
+	///	<summary>
+	///		Output setting on construction.
+	///	</summary>
+	bool m_fPreviousOutputEnabled;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Silence announcements on the calling thread for the lifetime of
+///		this object, then restore the previous setting.
+///	</summary>
+class AnnounceThreadSilencer {
+
+public:
+	///	<summary>
+	///		Constructor.
+	///	</summary>
+	AnnounceThreadSilencer() :
+		m_fPreviousThreadSilenced(AnnounceGetThreadSilenced())
+	{
+		AnnounceSetThreadSilenced(true);
+	}
+
+	///	<summary>
+	///		Destructor.
+	///	</summary>
+	~AnnounceThreadSilencer() {
+		AnnounceSetThreadSilenced(m_fPreviousThreadSilenced);
+	}
+
+protected:
+	///	<summary>
+	///		Setting on construction.
+	///	</summary>
+	bool m_fPreviousThreadSilenced;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// OfflineMapResult
+///////////////////////////////////////////////////////////////////////////////
+
+void OfflineMapResult::FromOfflineMap(
+	OfflineMap & mapRemap
+) {
+	SparseMatrix<double> & smatRemap = mapRemap.GetSparseMatrix();
+
+	smatRemap.Freeze();
+
+	const DataArray1D<double> & dSourceAreas = mapRemap.GetSourceAreas();
+	const DataArray1D<double> & dTargetAreas = mapRemap.GetTargetAreas();
+
+	nSourceCount = static_cast<int>(dSourceAreas.GetRows());
+	nTargetCount = static_cast<int>(dTargetAreas.GetRows());
+
+	if (smatRemap.GetRows() > nTargetCount) {
+		_EXCEPTION2("Map row count (%i) exceeds target grid size (%i)",
+			smatRemap.GetRows(), nTargetCount);
+	}
+	if (smatRemap.GetColumns() > nSourceCount) {
+		_EXCEPTION2("Map column count (%i) exceeds source grid size (%i)",
+			smatRemap.GetColumns(), nSourceCount);
+	}
+
+	const DataArray1D<int> & vecMapRowPtr = smatRemap.GetRowPointers();
+	const DataArray1D<int> & vecMapColIx = smatRemap.GetColumnIndices();
+	const DataArray1D<double> & vecMapValues = smatRemap.GetValues();
+
+	const int nRows = smatRemap.GetRows();
+	const size_t sEntries = smatRemap.GetNonZeroCount();
+
+	// Rows beyond the last nonzero row of the map are empty
+	vecRowPtr.resize(nTargetCount + 1);
+	vecRowPtr[0] = 0;
+	for (int i = 0; i < nTargetCount; i++) {
+		if (i < nRows) {
+			vecRowPtr[i+1] = vecMapRowPtr[i+1];
+		} else {
+			vecRowPtr[i+1] = static_cast<int>(sEntries);
+		}
+	}
+
+	vecColIx.resize(sEntries);
+	vecValues.resize(sEntries);
+	for (size_t k = 0; k < sEntries; k++) {
+		vecColIx[k] = vecMapColIx[k];
+		vecValues[k] = vecMapValues[k];
+	}
+
+	vecSourceAreas.resize(nSourceCount);
+	for (int i = 0; i < nSourceCount; i++) {
+		vecSourceAreas[i] = dSourceAreas[i];
+	}
+
+	vecTargetAreas.resize(nTargetCount);
+	for (int i = 0; i < nTargetCount; i++) {
+		vecTargetAreas[i] = dTargetAreas[i];
+	}
+
+	// Fractional coverage, as written to frac_a and frac_b by
+	// OfflineMap::Write()
+	vecSourceFrac.assign(nSourceCount, 0.0);
+	vecTargetFrac.assign(nTargetCount, 0.0);
+
+	for (int i = 0; i < nRows; i++) {
+		for (int k = vecRowPtr[i]; k < vecRowPtr[i+1]; k++) {
+			const int iCol = vecColIx[k];
+
+			vecSourceFrac[iCol] +=
+				vecValues[k] / vecSourceAreas[iCol] * vecTargetAreas[i];
+			vecTargetFrac[i] += vecValues[k];
+		}
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// OfflineMapGenerator
+///////////////////////////////////////////////////////////////////////////////
+
+OfflineMapGenerator::OfflineMapGenerator(
+	const OfflineMapOptions & options
+) :
+	m_options(options),
+	m_fSourcePrepared(false)
+{ }
+
+///////////////////////////////////////////////////////////////////////////////
+
+void OfflineMapGenerator::SetSourceMesh(
+	const Mesh & meshSource
+) {
+	AnnounceOutputSuppressor suppressor;
+
+	if (m_options.nThreads < 1) {
+		_EXCEPTIONT("Thread count must be at least 1");
+	}
+	if (m_options.fSourceConcave) {
+		_EXCEPTIONT("OfflineMapGenerator does not support concave "
+			"source meshes");
+	}
+
+	std::string strSourceType = m_options.strSourceType;
+	std::string strTargetType = m_options.strTargetType;
+	STLStringHelper::ToLower(strSourceType);
+	STLStringHelper::ToLower(strTargetType);
+
+	m_fSourcePrepared = false;
+	m_dataSource.clear();
+
+	m_meshSource = meshSource;
+	m_meshSource.RemoveZeroEdges();
+
+	m_meshSource.CalculateFaceAreas(false, m_options.nThreads);
+	m_meshSource.ConstructReverseNodeArray(m_options.nThreads);
+	m_meshSource.ConstructEdgeMap(false);
+	m_meshSource.ConstructFaceNeighbors(m_options.nThreads);
+
+	ConstructOverlapSeedKDTree(m_meshSource, m_treeSource);
+
+	// Finite volume source meshes share their reconstruction stencils and
+	// optionally their fit arrays, so that Generate() does not modify the
+	// source mesh
+	if (strSourceType == "fv") {
+		ConstructReconstructionStencils(
+			m_meshSource, m_options.nPin, m_options.nThreads);
+
+		if (m_options.fCacheSourceFitArrays) {
+			m_dataSource.cacheFitArrays.Construct(
+				m_meshSource,
+				m_options.nPin,
+				GetFVFitArrayTriQuadRuleOrder(
+					(strTargetType != "fv"), m_options.fVolumetric),
+				m_options.nThreads);
+		}
+
+	// Finite element source meshes share their meta data
+	} else if (m_options.strSourceMeta == "") {
+		m_dataSource.dNumericalArea =
+			GenerateMetaData(
+				m_meshSource,
+				m_options.nPin,
+				m_options.fBubble,
+				m_dataSource.dataGLLNodes,
+				m_dataSource.dataGLLJacobian,
+				m_options.nThreads);
+
+		m_dataSource.nP = m_options.nPin;
+		m_dataSource.fBubble = m_options.fBubble;
+	}
+
+	m_fSourcePrepared = true;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void OfflineMapGenerator::Generate(
+	const Mesh & meshTarget,
+	OfflineMap & mapRemap
+) {
+	AnnounceOutputSuppressor suppressor;
+
+	GenerateWithOptions(meshTarget, mapRemap, m_options);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void OfflineMapGenerator::Generate(
+	const std::vector<const Mesh *> & vecTargets,
+	const std::vector<OfflineMap *> & vecMaps,
+	int nConcurrentTargets
+) {
+	if (vecTargets.size() != vecMaps.size()) {
+		_EXCEPTION2("Number of target meshes (%i) does not match "
+			"number of maps (%i)",
+			static_cast<int>(vecTargets.size()),
+			static_cast<int>(vecMaps.size()));
+	}
+	if (nConcurrentTargets < 1) {
+		_EXCEPTIONT("Concurrent target count must be at least 1");
+	}
+
+	const int nTargets = static_cast<int>(vecTargets.size());
+
+	for (int i = 0; i < nTargets; i++) {
+		if ((vecTargets[i] == NULL) || (vecMaps[i] == NULL)) {
+			_EXCEPTION1("NULL target mesh or map at index %i", i);
+		}
+	}
+
+	nConcurrentTargets = std::min(nConcurrentTargets, nTargets);
+
+	// Sequential generation uses all threads for each map.  Face
+	// reordering restores the areas of the source mesh after each map, so
+	// maps are also generated sequentially in that case.
+	if ((nConcurrentTargets <= 1) || m_options.fReorderFaces) {
+		AnnounceOutputSuppressor suppressor;
+
+		for (int i = 0; i < nTargets; i++) {
+			GenerateWithOptions(*(vecTargets[i]), *(vecMaps[i]), m_options);
+		}
+		return;
+	}
+
+	// Divide the threads between the concurrent maps
+	OfflineMapOptions optionsTarget = m_options;
+	optionsTarget.nThreads =
+		std::max(1, m_options.nThreads / nConcurrentTargets);
+
+	// Cache files would be written by several maps at once
+	optionsTarget.strSourceMetaCache = "";
+	optionsTarget.strTargetMetaCache = "";
+	optionsTarget.strSourcePrepared = "";
+
+	OmpExceptionCapture capture;
+
+#pragma omp parallel for schedule(dynamic) num_threads(nConcurrentTargets)
+	for (int i = 0; i < nTargets; i++) {
+		AnnounceThreadSilencer silencer;
+
+		capture.Run([&]() {
+			GenerateWithOptions(*(vecTargets[i]), *(vecMaps[i]), optionsTarget);
+		});
+	}
+
+	capture.Rethrow();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void OfflineMapGenerator::GenerateWithOptions(
+	const Mesh & meshTarget,
+	OfflineMap & mapRemap,
+	const OfflineMapOptions & options
+) const {
+	if (!m_fSourcePrepared) {
+		_EXCEPTIONT("SetSourceMesh() must be called before Generate()");
+	}
+	if (options.fTargetConcave) {
+		_EXCEPTIONT("OfflineMapGenerator does not support concave "
+			"target meshes");
+	}
+
+	// Overlap mesh method
+	std::string strMethod = options.strOverlapMethod;
+	STLStringHelper::ToLower(strMethod);
+
+	OverlapMeshMethod method;
+	if (strMethod == "fuzzy") {
+		method = OverlapMeshMethod_Fuzzy;
+	} else if (strMethod == "exact") {
+		method = OverlapMeshMethod_Exact;
+	} else if (strMethod == "mixed") {
+		method = OverlapMeshMethod_Mixed;
+	} else if (strMethod == "bvh") {
+		method = OverlapMeshMethod_BVH;
+	} else {
+		_EXCEPTION1("Invalid overlap mesh method (%s), "
+			"expected [fuzzy|exact|mixed|bvh]", strMethod.c_str());
+	}
+
+	// Prepare the target mesh
+	Mesh meshTargetPrepared = meshTarget;
+	meshTargetPrepared.RemoveZeroEdges();
+	meshTargetPrepared.ConstructEdgeMap(false);
+
+	// Overlap the target mesh with the source mesh, reusing the KD tree
+	// over the source mesh, and then restore the source mesh as the first
+	// mesh of the overlap.  Non-conservative maps need no overlap mesh.
+	Mesh meshOverlap;
+	meshOverlap.type = Mesh::MeshType_Overlap;
+
+	if (ParseNonConservativeMethod(options.strMethod)
+		== NonConservativeMethod_Conservative
+	) {
+		GenerateOverlapMesh_v2(
+			meshTargetPrepared,
+			m_meshSource,
+			m_treeSource,
+			meshOverlap,
+			method,
+			options.fAllowNoOverlap,
+			false,
+			options.nThreads);
+
+		meshOverlap.ExchangeFirstAndSecondMesh();
+	}
+
+	// Compute the weights, reusing the overlap Face areas computed by
+	// GenerateOverlapMesh_v2 and the data shared by all maps from the
+	// source mesh.  The source mesh is not modified since its derived
+	// structures are current.
+	GenerateOfflineMapWithOptions(
+		mapRemap,
+		const_cast<Mesh &>(m_meshSource),
+		meshTargetPrepared,
+		meshOverlap,
+		options,
+		true,
+		true,
+		&m_dataSource);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void OfflineMapGenerator::Generate(
+	const Mesh & meshTarget,
+	OfflineMapResult & result
+) {
+	OfflineMap mapRemap;
+
+	Generate(meshTarget, mapRemap);
+
+	result.FromOfflineMap(mapRemap);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
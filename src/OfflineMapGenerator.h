@@ -0,0 +1,465 @@
+///////////////////////////////////////////////////////////////////////////////
+///
+///	\file    OfflineMapGenerator.h
+///	\author  agent
+///	\version October 14, 2026
+///
+///	<remarks>
+///		Copyright 2026 agent
+///
+///		This file is distributed as part of the Tempest source code package.
+///		Permission is granted to use, copy, modify and distribute this
+///		source code and its documentation under the terms of the GNU General
+///		Public License.  This software is provided "as is" without express
+///		or implied warranty.
+///	</remarks>
+
+#ifndef _OFFLINEMAPGENERATOR_H_
+#define _OFFLINEMAPGENERATOR_H_
+
+#include "GridElements.h"
+#include "OverlapMesh.h"
+#include "OfflineMap.h"
+#include "NodeKDTree.h"
+#include "LinearRemapFV.h"
+#include "DataArray3D.h"
+
+#include <string>
+#include <vector>
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Options controlling the generation of an offline map.  The defaults
+///		match those of the GenerateOfflineMap executable.
+///	</summary>
+struct OfflineMapOptions {
+
+	///	<summary>
+	///		Constructor.
+	///	</summary>
+	OfflineMapOptions() :
+		strSourceType("fv"),
+		strTargetType("fv"),
+		nPin(4),
+		nPout(4),
+		fBubble(false),
+		nMonotoneType(0),
+		fVolumetric(false),
+		fNoConservation(false),
+		fNoCheck(false),
+		fSourceConcave(false),
+		fTargetConcave(false),
+		strOverlapMethod("exact"),
+		fAllowNoOverlap(false),
+		fReorderFaces(false),
+		fCacheSourceFitArrays(false),
+		dPruneThreshold(0.0),
+		fPruneMasked(false),
+		strMethod("conserve"),
+		fRestart(false),
+		dCheckpointInterval(600.0),
+		nThreads(1)
+	{ }
+
+	///	<summary>
+	///		Discretization of the source and target meshes [fv|cgll|dgll].
+	///	</summary>
+	std::string strSourceType;
+	std::string strTargetType;
+
+	///	<summary>
+	///		Optional metadata files for finite element meshes.
+	///	</summary>
+	std::string strSourceMeta;
+	std::string strTargetMeta;
+
+	///	<summary>
+	///		Optional cache files for generated finite element meta data.  Meta
+	///		data is read from these files if they match the mesh, and is
+	///		otherwise generated and written to them.
+	///	</summary>
+	std::string strSourceMetaCache;
+	std::string strTargetMetaCache;
+
+	///	<summary>
+	///		Optional prepared mesh file for a finite volume source mesh.
+	///		Reconstruction stencils are read from this file if it matches
+	///		the mesh, and are otherwise generated and written to it.
+	///	</summary>
+	std::string strSourcePrepared;
+
+	///	<summary>
+	///		Polynomial order on the source and target meshes.
+	///	</summary>
+	int nPin;
+	int nPout;
+
+	///	<summary>
+	///		Use bubble on interior of spectral element nodes.
+	///	</summary>
+	bool fBubble;
+
+	///	<summary>
+	///		Monotonicity type (0 for none).
+	///	</summary>
+	int nMonotoneType;
+
+	///	<summary>
+	///		Use volumetric remapping for finite element targets.
+	///	</summary>
+	bool fVolumetric;
+
+	///	<summary>
+	///		Do not enforce conservation.
+	///	</summary>
+	bool fNoConservation;
+
+	///	<summary>
+	///		Do not verify consistency and conservation of the map.
+	///	</summary>
+	bool fNoCheck;
+
+	///	<summary>
+	///		The source or target mesh contains concave faces.
+	///	</summary>
+	bool fSourceConcave;
+	bool fTargetConcave;
+
+	///	<summary>
+	///		Overlap mesh method [fuzzy|exact|mixed|bvh], used only when the
+	///		overlap mesh is generated by OfflineMapGenerator.
+	///	</summary>
+	std::string strOverlapMethod;
+
+	///	<summary>
+	///		Allow source faces with no overlap, used only when the overlap
+	///		mesh is generated by OfflineMapGenerator.
+	///	</summary>
+	bool fAllowNoOverlap;
+
+	///	<summary>
+	///		Compute finite volume to finite volume maps on copies of the
+	///		meshes reordered along a Hilbert curve for locality.  The map
+	///		is returned in the original face ordering.
+	///	</summary>
+	bool fReorderFaces;
+
+	///	<summary>
+	///		Build the fit arrays of a finite volume source mesh once in
+	///		OfflineMapGenerator::SetSourceMesh() and reuse them for every
+	///		target mesh.  This trades memory for time when many maps are
+	///		generated from one source mesh.
+	///	</summary>
+	bool fCacheSourceFitArrays;
+
+	///	<summary>
+	///		Remove weights of magnitude below this threshold from the map
+	///		and restore its row and column sums (see OfflineMap::Prune()).
+	///	</summary>
+	double dPruneThreshold;
+
+	///	<summary>
+	///		Remove weights in masked rows and columns from the map.
+	///	</summary>
+	bool fPruneMasked;
+
+	///	<summary>
+	///		Map method [conserve|nn|bilin|patch].  Methods other than
+	///		conserve generate non-conservative maps from a finite volume
+	///		source mesh without using the overlap mesh.
+	///	</summary>
+	std::string strMethod;
+
+	///	<summary>
+	///		File in which the partial map is checkpointed while a finite
+	///		volume to finite volume map is computed, or empty for none.
+	///	</summary>
+	std::string strCheckpointFile;
+
+	///	<summary>
+	///		Resume from the records of strCheckpointFile.
+	///	</summary>
+	bool fRestart;
+
+	///	<summary>
+	///		Interval between checkpoint records (in seconds).
+	///	</summary>
+	double dCheckpointInterval;
+
+	///	<summary>
+	///		Number of threads.
+	///	</summary>
+	int nThreads;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		An offline map in compressed row form, together with the areas and
+///		fractional coverage of the source and target degrees of freedom.
+///		All indices are zero-based.  Row i of the map occupies entries
+///		[vecRowPtr[i], vecRowPtr[i+1]) of vecColIx and vecValues.
+///	</summary>
+struct OfflineMapResult {
+
+	///	<summary>
+	///		Number of source and target degrees of freedom.
+	///	</summary>
+	int nSourceCount;
+	int nTargetCount;
+
+	///	<summary>
+	///		CSR row pointers (nTargetCount + 1 entries).
+	///	</summary>
+	std::vector<int> vecRowPtr;
+
+	///	<summary>
+	///		CSR column indices.
+	///	</summary>
+	std::vector<int> vecColIx;
+
+	///	<summary>
+	///		CSR values.
+	///	</summary>
+	std::vector<double> vecValues;
+
+	///	<summary>
+	///		Areas of the source and target degrees of freedom.
+	///	</summary>
+	std::vector<double> vecSourceAreas;
+	std::vector<double> vecTargetAreas;
+
+	///	<summary>
+	///		Fraction of target coverage of each source degree of freedom
+	///		(frac_a) and of source coverage of each target degree of
+	///		freedom (frac_b).
+	///	</summary>
+	std::vector<double> vecSourceFrac;
+	std::vector<double> vecTargetFrac;
+
+	///	<summary>
+	///		Fill this result from an OfflineMap, freezing its SparseMatrix.
+	///	</summary>
+	void FromOfflineMap(
+		OfflineMap & mapRemap
+	);
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Data derived from a source mesh which does not depend on the target
+///		mesh, so it can be shared by all maps from that source mesh.
+///	</summary>
+struct OfflineMapSourceData {
+
+	///	<summary>
+	///		Constructor.
+	///	</summary>
+	OfflineMapSourceData() :
+		nP(0),
+		fBubble(false),
+		dNumericalArea(0.0)
+	{ }
+
+	///	<summary>
+	///		Remove all data.
+	///	</summary>
+	void clear() {
+		cacheFitArrays.clear();
+		nP = 0;
+		fBubble = false;
+		dNumericalArea = 0.0;
+		dataGLLNodes.Detach();
+		dataGLLJacobian.Detach();
+	}
+
+	///	<summary>
+	///		Fit arrays of a finite volume source mesh (may be empty).
+	///	</summary>
+	FVFitArrayCache cacheFitArrays;
+
+	///	<summary>
+	///		Order and bubble flag of the finite element meta data (nP is
+	///		zero if no meta data is present).
+	///	</summary>
+	int nP;
+	bool fBubble;
+
+	///	<summary>
+	///		Numerical area of the finite element source mesh.
+	///	</summary>
+	double dNumericalArea;
+
+	///	<summary>
+	///		Meta data of a finite element source mesh.
+	///	</summary>
+	DataArray3D<int> dataGLLNodes;
+	DataArray3D<double> dataGLLJacobian;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Generate the offline map from meshInput to meshOutput with the given
+///		overlap mesh, without any file output.  Errors are reported by
+///		throwing an Exception.  If fInputPrepared is true the face areas,
+///		reverse node array and edge map of meshInput must be current and
+///		are not recomputed.  If fOverlapPrepared is true the face areas of
+///		meshOverlap must be current, as left by GenerateOverlapMesh_v2, and
+///		are not recomputed.  Source data in pSourceData is used in place of
+///		recomputing it where it matches meshInput and the options; in that
+///		case meshInput is not modified.
+///	</summary>
+void GenerateOfflineMapWithOptions(
+	OfflineMap & mapRemap,
+	Mesh & meshInput,
+	Mesh & meshOutput,
+	Mesh & meshOverlap,
+	const OfflineMapOptions & options,
+	bool fInputPrepared = false,
+	bool fOverlapPrepared = false,
+	const OfflineMapSourceData * pSourceData = NULL
+);
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		A reusable handle for generating offline maps from a fixed source
+///		mesh to many target meshes entirely in memory, as needed by a
+///		coupler at startup.  The source mesh and its derived structures
+///		(face areas, edge map, reverse node array, reconstruction stencils,
+///		finite element meta data, optionally the reconstruction fit arrays
+///		and the KD tree used to seed the overlap search) are prepared once,
+///		so each call to Generate() only prepares the target mesh, computes
+///		the overlap mesh and computes the weights.  No files are read or
+///		written and no announcements are made.
+///	</summary>
+class OfflineMapGenerator {
+
+public:
+	///	<summary>
+	///		Constructor.
+	///	</summary>
+	OfflineMapGenerator(
+		const OfflineMapOptions & options = OfflineMapOptions()
+	);
+
+public:
+	///	<summary>
+	///		Set the options used by subsequent calls to Generate().
+	///		Options that affect the prepared source mesh take effect at the
+	///		next call to SetSourceMesh().
+	///	</summary>
+	void SetOptions(
+		const OfflineMapOptions & options
+	) {
+		m_options = options;
+	}
+
+	///	<summary>
+	///		Get the current options.
+	///	</summary>
+	const OfflineMapOptions & GetOptions() const {
+		return m_options;
+	}
+
+	///	<summary>
+	///		Copy and prepare the source mesh.
+	///	</summary>
+	void SetSourceMesh(
+		const Mesh & meshSource
+	);
+
+	///	<summary>
+	///		Determine if a source mesh has been prepared.
+	///	</summary>
+	bool HasSourceMesh() const {
+		return m_fSourcePrepared;
+	}
+
+	///	<summary>
+	///		Generate the offline map from the source mesh to meshTarget.
+	///		mapRemap should be newly constructed, since dimension
+	///		information that is already initialized is not replaced.
+	///	</summary>
+	void Generate(
+		const Mesh & meshTarget,
+		OfflineMap & mapRemap
+	);
+
+	///	<summary>
+	///		Generate the offline map from the source mesh to meshTarget in
+	///		compressed row form.
+	///	</summary>
+	void Generate(
+		const Mesh & meshTarget,
+		OfflineMapResult & result
+	);
+
+	///	<summary>
+	///		Generate the offline maps from the source mesh to each of
+	///		vecTargets, with up to nConcurrentTargets maps generated at once.
+	///		The threads of the options are divided between the concurrent
+	///		maps; nested loops only use more than one thread each if nested
+	///		OpenMP parallelism is enabled.  The maps do not depend on the
+	///		degree of concurrency.
+	///	</summary>
+	void Generate(
+		const std::vector<const Mesh *> & vecTargets,
+		const std::vector<OfflineMap *> & vecMaps,
+		int nConcurrentTargets = 1
+	);
+
+	///	<summary>
+	///		Get the data shared by all maps from the source mesh.
+	///	</summary>
+	const OfflineMapSourceData & GetSourceData() const {
+		return m_dataSource;
+	}
+
+protected:
+	///	<summary>
+	///		Generate the offline map from the source mesh to meshTarget
+	///		with the given options, without changing announcement output.
+	///	</summary>
+	void GenerateWithOptions(
+		const Mesh & meshTarget,
+		OfflineMap & mapRemap,
+		const OfflineMapOptions & options
+	) const;
+
+protected:
+	///	<summary>
+	///		Options for map generation.
+	///	</summary>
+	OfflineMapOptions m_options;
+
+	///	<summary>
+	///		The prepared source mesh.
+	///	</summary>
+	Mesh m_meshSource;
+
+	///	<summary>
+	///		KD tree over the first corner of each source face.  The source
+	///		mesh is used as the second mesh of the overlap so that this
+	///		tree can be reused for every target mesh.
+	///	</summary>
+	NodeKDTree<int> m_treeSource;
+
+	///	<summary>
+	///		Data shared by all maps from the source mesh.
+	///	</summary>
+	OfflineMapSourceData m_dataSource;
+
+	///	<summary>
+	///		A flag indicating the source mesh has been prepared.
+	///	</summary>
+	bool m_fSourcePrepared;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+#endif
+
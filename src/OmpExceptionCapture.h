@@ -0,0 +1,135 @@
+///////////////////////////////////////////////////////////////////////////////
+///
+///	\file    OmpExceptionCapture.h
+///	\author  agent
+///	\version October 15, 2026
+///
+///	<remarks>
+///		Copyright 2026 agent
+///
+///		This file is distributed as part of the Tempest source code package.
+///		Permission is granted to use, copy, modify and distribute this
+///		source code and its documentation under the terms of the GNU General
+///		Public License.  This software is provided "as is" without express
+///		or implied warranty.
+///	</remarks>
+
+#ifndef _OMPEXCEPTIONCAPTURE_H_
+#define _OMPEXCEPTIONCAPTURE_H_
+
+#include "Exception.h"
+
+#include <climits>
+#include <string>
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Capture of an exception thrown within an OpenMP parallel region,
+///		which must not propagate out of the region, so that it can be
+///		rethrown on the calling thread after the region.  If several
+///		iterations fail, the error of the lowest index is kept so that the
+///		error reported does not depend on the number of threads.
+///	</summary>
+class OmpExceptionCapture {
+
+public:
+	///	<summary>
+	///		Constructor.
+	///	</summary>
+	OmpExceptionCapture() :
+		m_iError(0),
+		m_ixError(INT_MAX)
+	{ }
+
+	///	<summary>
+	///		Call fn(), capturing any exception it throws.
+	///	</summary>
+	template <typename F>
+	void Run(const F & fn) {
+		Run(INT_MAX, fn);
+	}
+
+	///	<summary>
+	///		Call fn() for iteration ix, capturing any exception it throws.
+	///	</summary>
+	template <typename F>
+	void Run(int ix, const F & fn) {
+		try {
+			fn();
+
+		} catch(Exception & e) {
+			Capture(ix, e.ToString());
+
+		} catch(...) {
+			Capture(ix, "Unknown exception");
+		}
+	}
+
+	///	<summary>
+	///		Record the error strError of iteration ix.
+	///	</summary>
+	void Capture(
+		int ix,
+		const std::string & strError
+	) {
+#pragma omp critical(OmpExceptionCapture)
+		{
+			if ((m_iError == 0) || (ix < m_ixError)) {
+				m_ixError = ix;
+				m_strError = strError;
+			}
+#pragma omp atomic write
+			m_iError = 1;
+		}
+	}
+
+	///	<summary>
+	///		Determine if an error has been captured, so that remaining
+	///		iterations may be skipped.
+	///	</summary>
+	bool HasError() const {
+		int iError;
+#pragma omp atomic read
+		iError = m_iError;
+		return (iError != 0);
+	}
+
+	///	<summary>
+	///		Get the index of the iteration whose error is kept.
+	///	</summary>
+	int GetErrorIndex() const {
+		return m_ixError;
+	}
+
+	///	<summary>
+	///		Throw an Exception with the captured error, if any.  Called
+	///		after the parallel region.
+	///	</summary>
+	void Rethrow() const {
+		if (m_iError != 0) {
+			_EXCEPTION1("%s", m_strError.c_str());
+		}
+	}
+
+private:
+	///	<summary>
+	///		Flag indicating an error has been captured.
+	///	</summary>
+	int m_iError;
+
+	///	<summary>
+	///		Index of the iteration whose error is kept.
+	///	</summary>
+	int m_ixError;
+
+	///	<summary>
+	///		The error that is kept.
+	///	</summary>
+	std::string m_strError;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+#endif
+
@@ -18,14 +18,31 @@
 #include "OverlapMesh.h"
 #include "MeshUtilitiesFuzzy.h"
 #include "MeshUtilitiesExact.h"
+#include "FaceLocator.h"
+#include "StructuredOverlapMesh.h"
 
 #include "Announce.h"
 
-#include "kdtree.h"
+#include "CheckpointFile.h"
+#include "NodeKDTree.h"
+#include "OmpExceptionCapture.h"
+#include "OverlapMeshStreamWriter.h"
+#include "SphericalCapTree.h"
 
 #include <unistd.h>
 #include <iostream>
 #include <queue>
+#include <algorithm>
+#include <limits>
+#include <string>
+#include <vector>
+#include <cstdio>
+#include <cstdlib>
+
+#if defined(OVERLAPMESH_INSTRUMENT)
+#include <chrono>
+#include <cmath>
+#endif
 
 ///////////////////////////////////////////////////////////////////////////////
 
@@ -35,6 +52,36 @@
 
 ///////////////////////////////////////////////////////////////////////////////
 
+///	<summary>
+///		Profiling counters.
+///	</summary>
+static const int s_iCounterEdgeIntersections =
+	AnnounceRegisterCounter("edge intersections");
+
+static const int s_iCounterOverlapSourceFaces =
+	AnnounceRegisterCounter("overlap source faces");
+
+static const int s_iCounterOverlapFaces =
+	AnnounceRegisterCounter("overlap faces");
+
+static const int s_iCounterOverlapPairs =
+	AnnounceRegisterCounter("overlap candidate pairs");
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Add to a field of the OverlapFaceProfile of a workspace.  This
+///		expands to nothing unless OVERLAPMESH_INSTRUMENT is defined.
+///	</summary>
+#if defined(OVERLAPMESH_INSTRUMENT)
+#define OVERLAPMESH_PROFILE_ADD(workspace, field, n) \
+	((workspace).profile.field += (n))
+#else
+#define OVERLAPMESH_PROFILE_ADD(workspace, field, n)
+#endif
+
+///////////////////////////////////////////////////////////////////////////////
+
 ///	<summary>
 ///		Enumerator defining a type of intersection.
 ///	</summary>
@@ -139,6 +186,7 @@ template <
 void GeneratePath(
 	const Mesh & meshSource,
 	const Mesh & meshTarget,
+	const FaceLocator & locatorTarget,
 	const std::vector<int> & vecTargetNodeMap,
 	int ixCurrentSourceFace,
 	PathSegmentVector & vecTracedPath,
@@ -165,6 +213,7 @@ void GeneratePath(
 	FindFaceStruct aFindFaceStruct;
 	utils.FindFaceFromNode(
 		meshTarget,
+		locatorTarget,
 		nodeCurrent,
 		aFindFaceStruct);
 
@@ -235,6 +284,9 @@ void GeneratePath(
 
 		NodeIntersectType nodeLastIntersection = nodeSourceBegin;
 
+		// Flags for edges of the target face which may be intersected
+		std::vector<bool> vecCandidateTargetEdge;
+
 		// Repeat until we hit the end of this edge
 		for (;;) {
 
@@ -259,6 +311,15 @@ void GeneratePath(
 
 			std::vector<NodeIntersectType> nodeIntersections;
 
+			// Edges of the target face which may intersect this edge
+			utils.FindEdgeIntersectionCandidates(
+				nodevecOverlap[edgeSourceCurrent[0]],
+				nodevecOverlap[edgeSourceCurrent[1]],
+				edgeSourceCurrent.type,
+				faceTargetCurrent,
+				nodevecTarget,
+				vecCandidateTargetEdge);
+
 			for (int j = 0; j < faceTargetCurrent.edges.size(); j++) {
 				const Edge & edgeTargetCurrent =
 					faceTargetCurrent.edges[j];
@@ -267,6 +328,12 @@ void GeneratePath(
 				if (edgeTargetCurrent[0] == edgeTargetCurrent[1]) {
 					_EXCEPTIONT("Zero Edge detected");
 				}
+
+				// Edge cannot intersect
+				if (!vecCandidateTargetEdge[j]) {
+					fCoincidentEdge = false;
+					continue;
+				}
 /*
 				fCoincidentEdge =
 					utilsFuzzy.CalculateEdgeIntersections(
@@ -303,6 +370,8 @@ void GeneratePath(
 							nodeIntersections);
 				}
 
+				AnnounceCount(s_iCounterEdgeIntersections);
+
 				for (int i = 0; i < nodeIntersections.size(); i++) {
 					bool fEqualNodes =
 						utils.AreNodesEqual(
@@ -1213,6 +1282,9 @@ void GenerateOverlapMesh_v1(
 	}
 	meshOverlap.faces.reserve(2 * nMaximumFaceCount);
 */
+	// Build a spatial index for locating Nodes on the target Mesh
+	FaceLocator locatorTarget(meshTarget);
+
 	// Loop through all Faces on the first Mesh
 	int ixCurrentSourceFace = 0;
 
@@ -1231,6 +1303,7 @@ void GenerateOverlapMesh_v1(
 			GeneratePath<MeshUtilitiesFuzzy, Node>(
 				meshSource,
 				meshTarget,
+				locatorTarget,
 				vecTargetNodeMap,
 				ixCurrentSourceFace,
 				vecTracedPath,
@@ -1251,6 +1324,7 @@ void GenerateOverlapMesh_v1(
 			GeneratePath<MeshUtilitiesExact, NodeExact>(
 				meshSource,
 				meshTarget,
+				locatorTarget,
 				vecTargetNodeMap,
 				ixCurrentSourceFace,
 				vecTracedPath,
@@ -1275,6 +1349,7 @@ void GenerateOverlapMesh_v1(
 				GeneratePath<MeshUtilitiesFuzzy, Node>(
 					meshSource,
 					meshTarget,
+					locatorTarget,
 					vecTargetNodeMap,
 					ixCurrentSourceFace,
 					vecTracedPath,
@@ -1304,6 +1379,7 @@ void GenerateOverlapMesh_v1(
 				GeneratePath<MeshUtilitiesExact, NodeExact>(
 					meshSource,
 					meshTarget,
+					locatorTarget,
 					vecTargetNodeMap,
 					ixCurrentSourceFace,
 					vecTracedPath,
@@ -1351,6 +1427,201 @@ void GenerateOverlapMesh_v1(
 
 ///////////////////////////////////////////////////////////////////////////////
 
+///	<summary>
+///		Maximum number of edges of the source and target faces clipped by
+///		GenerateOverlapFaceGreatCircle.  Larger faces use the general
+///		clipping path.
+///	</summary>
+static const int OverlapClipMaxEdges = 8;
+
+///	<summary>
+///		Capacity of the polygon buffers of GenerateOverlapFaceGreatCircle.
+///		A convex polygon gains at most one node per clip edge; polygons that
+///		would exceed the capacity use the general clipping path.
+///	</summary>
+static const int OverlapClipMaxNodes = 2 * OverlapClipMaxEdges;
+
+///	<summary>
+///		Selects the clipping kernel of GenerateOverlapFace for each class of
+///		MeshUtilities.  GenerateOverlapFaceGreatCircle uses the great circle
+///		entry points of MeshUtilitiesFuzzy, so it is only used with that
+///		class.
+///	</summary>
+template <class MeshUtilities>
+struct OverlapClipKernel {
+	static const bool HasGreatCircleKernel = false;
+};
+
+template <>
+struct OverlapClipKernel<MeshUtilitiesFuzzy> {
+	static const bool HasGreatCircleKernel = true;
+};
+
+///	<summary>
+///		Sutherland-Hodgman clipping of target face iTargetFace by source
+///		face iSourceFace when all source edges are great circle arcs and
+///		both faces have at most OverlapClipMaxEdges edges.  The normal of
+///		each clip edge is computed once and passed to the great circle
+///		entry points of MeshUtilitiesFuzzy, and polygons are held in
+///		fixed-size arrays.  The result is identical to the general path
+///		with MeshUtilitiesFuzzy.  Returns false, leaving workspace.nodevecOutput
+///		unspecified, if the faces are not supported.
+///	</summary>
+static bool GenerateOverlapFaceGreatCircle(
+	const Mesh & meshSource,
+	const Mesh & meshTarget,
+	int iSourceFace,
+	int iTargetFace,
+	OverlapFaceWorkspace & workspace
+) {
+	const NodeVector & nodesTarget = meshTarget.nodes;
+	const NodeVector & nodesSource = meshSource.nodes;
+
+	const EdgeVector & evecTarget = meshTarget.faces[iTargetFace].edges;
+	const EdgeVector & evecSource = meshSource.faces[iSourceFace].edges;
+
+	const int nSourceEdges = static_cast<int>(evecSource.size());
+	const int nTargetEdges = static_cast<int>(evecTarget.size());
+
+	MeshUtilitiesFuzzy utils;
+
+	if ((nSourceEdges > OverlapClipMaxEdges) ||
+		(nTargetEdges > OverlapClipMaxEdges)
+	) {
+		return false;
+	}
+	for (int i = 0; i < nSourceEdges; i++) {
+		if (evecSource[i].type != Edge::Type_GreatCircleArc) {
+			return false;
+		}
+	}
+
+	// Normal of each clip edge
+	Node nodeNormal[OverlapClipMaxEdges];
+	for (int i = 0; i < nSourceEdges; i++) {
+		nodeNormal[i] =
+			CrossProduct(
+				nodesSource[evecSource[i][0]],
+				nodesSource[evecSource[i][1]]);
+	}
+
+	// Input and output polygons alternate between the two buffers
+	Node nodeBuffer[2][OverlapClipMaxNodes];
+	int nBufferNodes[2];
+
+	int iOutput = 0;
+	for (int i = 0; i < nTargetEdges; i++) {
+		nodeBuffer[iOutput][i] = nodesTarget[evecTarget[i][0]];
+	}
+	nBufferNodes[iOutput] = nTargetEdges;
+
+	Node nodeIntersection;
+
+	for (int i = 0; i < nSourceEdges; i++) {
+
+		// All points outside of source polygon
+		if (nBufferNodes[iOutput] == 0) {
+			break;
+		}
+
+		const Node * pInput = nodeBuffer[iOutput];
+		const int nInput = nBufferNodes[iOutput];
+
+		iOutput = 1 - iOutput;
+		Node * pOutput = nodeBuffer[iOutput];
+		int nOutput = 0;
+
+		const Node & node21 = nodesSource[evecSource[i][0]];
+		const Node & node22 = nodesSource[evecSource[i][1]];
+
+		// The clip edge is checked for coincident nodes at its first
+		// intersection, as by the general path
+		bool fCheckedClipEdge = false;
+
+		Node nodeS = pInput[nInput-1];
+		int iNodeEdgeSideS = utils.FindNodeGreatCircleSide(nodeNormal[i], nodeS);
+
+		for (int iNodeE = 0; iNodeE < nInput; iNodeE++) {
+			const Node & nodeE = pInput[iNodeE];
+
+			// Each node adds at most two nodes to the output
+			if (nOutput + 2 > OverlapClipMaxNodes) {
+				return false;
+			}
+
+			int iNodeEdgeSideE = utils.FindNodeGreatCircleSide(nodeNormal[i], nodeE);
+
+			if (iNodeEdgeSideE >= 0) {
+				if (iNodeEdgeSideS < 0) {
+					OVERLAPMESH_PROFILE_ADD(workspace, nEdgeIntersections, 1);
+
+					if (!fCheckedClipEdge) {
+						if (utils.AreNodesEqual(node21, node22)) {
+							_EXCEPTIONT("Coincident nodes used to define edge");
+						}
+						fCheckedClipEdge = true;
+					}
+
+					int iIntersect =
+						utils.CalculateGreatCircleIntersectionSemiClip(
+							nodeS, nodeE,
+							node21, node22, nodeNormal[i],
+							nodeIntersection);
+
+					if (iIntersect != 1) {
+						_EXCEPTIONT("Logic error");
+					}
+
+					pOutput[nOutput++] = nodeIntersection;
+				}
+
+				pOutput[nOutput++] = nodeE;
+
+			} else if (iNodeEdgeSideS >= 0) {
+				OVERLAPMESH_PROFILE_ADD(workspace, nEdgeIntersections, 1);
+
+				if (!fCheckedClipEdge) {
+					if (utils.AreNodesEqual(node21, node22)) {
+						_EXCEPTIONT("Coincident nodes used to define edge");
+					}
+					fCheckedClipEdge = true;
+				}
+
+				int iIntersect =
+					utils.CalculateGreatCircleIntersectionSemiClip(
+						nodeS, nodeE,
+						node21, node22, nodeNormal[i],
+						nodeIntersection);
+
+				if (iIntersect == 1) {
+					pOutput[nOutput++] = nodeIntersection;
+				} else if (iIntersect == 0) {
+					_EXCEPTIONT("Logic error");
+				}
+			}
+
+			nodeS = nodeE;
+			iNodeEdgeSideS = iNodeEdgeSideE;
+		}
+
+		nBufferNodes[iOutput] = nOutput;
+	}
+
+	// If the overlap consists of fewer than three nodes, ignore
+	NodeVector & nodevecOutput = workspace.nodevecOutput;
+	nodevecOutput.clear();
+	if (nBufferNodes[iOutput] >= 3) {
+		nodevecOutput.insert(
+			nodevecOutput.end(),
+			nodeBuffer[iOutput],
+			nodeBuffer[iOutput] + nBufferNodes[iOutput]);
+	}
+
+	return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
 template <
 	class MeshUtilities,
 	class NodeIntersectType
@@ -1360,8 +1631,16 @@ void GenerateOverlapFace(
 	const Mesh & meshTarget,
 	int iSourceFace,
 	int iTargetFace,
-    NodeVector & nodevecOutput
+	OverlapFaceWorkspace & workspace
 ) {
+	// Clip with the fixed-size kernel where it applies
+	if (OverlapClipKernel<MeshUtilities>::HasGreatCircleKernel &&
+		GenerateOverlapFaceGreatCircle(
+			meshSource, meshTarget, iSourceFace, iTargetFace, workspace)
+	) {
+		return;
+	}
+
 /*
   // Sutherland–Hodgman algorithm (pseudocode)
   List outputList = subjectPolygon;
@@ -1394,7 +1673,12 @@ void GenerateOverlapFace(
 	const EdgeVector & evecTarget = faceTarget.edges;
 	const EdgeVector & evecSource = faceSource.edges;
 
+	NodeVector & nodevecOutput = workspace.nodevecOutput;
+	NodeVector & nodevecInput = workspace.nodevecInput;
+	std::vector<Node> & vecIntersections = workspace.vecIntersections;
+
 	// List outputList = subjectPolygon
+	nodevecOutput.clear();
 	for (int i = 0; i < evecTarget.size(); i++) {
 		nodevecOutput.push_back(nodesTarget[evecTarget[i][0]]);
 	}
@@ -1408,7 +1692,7 @@ void GenerateOverlapFace(
 		}
 
 		// List inputList = outputList;
-		NodeVector nodevecInput = nodevecOutput;
+		nodevecInput.swap(nodevecOutput);
 
 		// outputList.clear();
 		nodevecOutput.clear();
@@ -1446,7 +1730,8 @@ void GenerateOverlapFace(
 				if (iNodeEdgeSideS < 0) {
 
 					// outputList.add(ComputeIntersection(S,E,clipEdge));
-					std::vector<Node> vecIntersections;
+					OVERLAPMESH_PROFILE_ADD(workspace, nEdgeIntersections, 1);
+
 					bool fCoincident =
 						utils.CalculateEdgeIntersectionsSemiClip(
 							nodeS,
@@ -1486,7 +1771,8 @@ void GenerateOverlapFace(
 			} else if (iNodeEdgeSideS >= 0) {
 
 				// outputList.add(ComputeIntersection(S,E,clipEdge));
-				std::vector<Node> vecIntersections;
+				OVERLAPMESH_PROFILE_ADD(workspace, nEdgeIntersections, 1);
+
 				bool fCoincident =
 					utils.CalculateEdgeIntersectionsSemiClip(
 						nodeS,
@@ -1553,6 +1839,112 @@ void GenerateOverlapFace(
 
 ///////////////////////////////////////////////////////////////////////////////
 
+template <
+	class MeshUtilities,
+	class NodeIntersectType
+>
+void GenerateOverlapFace(
+	const Mesh & meshSource,
+	const Mesh & meshTarget,
+	int iSourceFace,
+	int iTargetFace,
+    NodeVector & nodevecOutput
+) {
+	OverlapFaceWorkspace workspace;
+
+	GenerateOverlapFace<MeshUtilities, NodeIntersectType>(
+		meshSource,
+		meshTarget,
+		iSourceFace,
+		iTargetFace,
+		workspace);
+
+	nodevecOutput.insert(
+		nodevecOutput.end(),
+		workspace.nodevecOutput.begin(),
+		workspace.nodevecOutput.end());
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+// Instantiations used outside of this file
+template void GenerateOverlapFace<MeshUtilitiesFuzzy, Node>(
+	const Mesh & meshSource,
+	const Mesh & meshTarget,
+	int iSourceFace,
+	int iTargetFace,
+	NodeVector & nodevecOutput);
+
+template void GenerateOverlapFace<MeshUtilitiesFuzzy, Node>(
+	const Mesh & meshSource,
+	const Mesh & meshTarget,
+	int iSourceFace,
+	int iTargetFace,
+	OverlapFaceWorkspace & workspace);
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Get the FaceNeighborTable of meshTarget, so that breadth-first
+///		searches over the target mesh do not look up the EdgeMap.  The
+///		table of meshTarget is used if it has been constructed, and is
+///		otherwise constructed into faceneighborsLocal.
+///	</summary>
+static const FaceNeighborTable & GetTargetFaceNeighbors(
+	const Mesh & meshTarget,
+	FaceNeighborTable & faceneighborsLocal,
+	int nThreads
+) {
+	if (meshTarget.faceneighbors.size() == meshTarget.faces.size()) {
+		return meshTarget.faceneighbors;
+	}
+
+	meshTarget.ConstructFaceNeighbors(faceneighborsLocal, nThreads);
+
+	return faceneighborsLocal;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Begin a breadth-first search over a target mesh with nTargetFaces
+///		Faces, emptying the visited set and queue of the workspace.
+///	</summary>
+inline void BeginTargetFaceSearch(
+	OverlapFaceWorkspace & workspace,
+	int nTargetFaces
+) {
+	if (workspace.vecTargetFaceVisited.size() != nTargetFaces) {
+		workspace.vecTargetFaceVisited.assign(nTargetFaces, 0);
+		workspace.uTargetFaceGeneration = 0;
+	}
+
+	workspace.uTargetFaceGeneration++;
+	if (workspace.uTargetFaceGeneration == 0) {
+		std::fill(
+			workspace.vecTargetFaceVisited.begin(),
+			workspace.vecTargetFaceVisited.end(), 0);
+		workspace.uTargetFaceGeneration = 1;
+	}
+
+	workspace.vecTargetFaceQueue.clear();
+}
+
+///	<summary>
+///		Queue target Face f if it has not been visited in this search.
+///	</summary>
+inline void QueueTargetFace(
+	OverlapFaceWorkspace & workspace,
+	int f
+) {
+	if (workspace.vecTargetFaceVisited[f] != workspace.uTargetFaceGeneration) {
+		workspace.vecTargetFaceVisited[f] = workspace.uTargetFaceGeneration;
+		workspace.vecTargetFaceQueue.push_back(f);
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
 ///	<summary>
 ///		Find the Face in meshTarget containing node, searching near
 ///		meshTarget Face with index ixTargetFaceSeed.
@@ -1565,7 +1957,9 @@ int FindFaceContainingNode(
 	const Mesh & meshSource,
 	const Mesh & meshTarget,
 	int ixSourceFaceSeed,
-	int ixTargetFaceSeed
+	int ixTargetFaceSeed,
+	const FaceNeighborTable & faceneighborsTarget,
+	OverlapFaceWorkspace & workspace
 ) {
 	if (ixSourceFaceSeed > meshSource.faces.size()) {
 		_EXCEPTIONT("SourceFaceSeed greater than Source mesh size");
@@ -1584,27 +1978,20 @@ int FindFaceContainingNode(
 	const Node & node =
 		meshSource.nodes[meshSource.faces[ixSourceFaceSeed][0]];
 
-	const EdgeMap & edgemapTarget = meshTarget.edgemap;
-
 	MeshUtilities utils;
 
 	Face::NodeLocation loc;
 	int ixLocation;
 
-	std::set<int> setExaminedTargetFaces;
-	std::queue<int> queueTargetFaces;
-
-	queueTargetFaces.push(ixTargetFaceSeed);
-	setExaminedTargetFaces.insert(ixTargetFaceSeed);
+	BeginTargetFaceSearch(
+		workspace, static_cast<int>(meshTarget.faces.size()));
+	QueueTargetFace(workspace, ixTargetFaceSeed);
 
-	while (!queueTargetFaces.empty()) {
+	for (size_t q = 0; q < workspace.vecTargetFaceQueue.size(); q++) {
 
-		int ixCurrentTargetFace = queueTargetFaces.front();
-		queueTargetFaces.pop();
+		int ixCurrentTargetFace = workspace.vecTargetFaceQueue[q];
 
-		if (ixCurrentTargetFace == InvalidFace) {
-			continue;
-		}
+		OVERLAPMESH_PROFILE_ADD(workspace, nSeedFacesVisited, 1);
 
 		const Face & faceTarget = meshTarget.faces[ixCurrentTargetFace];
 
@@ -1622,50 +2009,29 @@ int FindFaceContainingNode(
 
 		// Node on boundary of target face; check for overlap
 		if (loc != Face::NodeLocation_Exterior) {
-			NodeVector nodevecOverlap;
-
 			GenerateOverlapFace<MeshUtilities, Node>(
 				meshSource,
 				meshTarget,
 				ixSourceFaceSeed,
 				ixCurrentTargetFace,
-				nodevecOverlap
+				workspace
 			);
 
-			if (nodevecOverlap.size() > 2) {
+			if (workspace.nodevecOutput.size() > 2) {
 				return ixCurrentTargetFace;
 			}
 		}
 
 		// Add all neighboring Faces into the queue of Target Faces
 		for (int i = 0; i < faceTarget.edges.size(); i++) {
-			EdgeMapConstIterator iter =
-				edgemapTarget.find(faceTarget.edges[i]);
-
-			if (iter == edgemapTarget.end()) {
-				_EXCEPTIONT("Missing Edge in Target EdgeMap");
-			}
+			int iPushFace =
+				faceneighborsTarget.GetNeighbor(ixCurrentTargetFace, i);
 
-			const FacePair & facepair = iter->second;
-
-			int iPushFace;
-			if (facepair[0] == ixCurrentTargetFace) {
-				iPushFace = facepair[1];
-
-			} else if (facepair[1] == ixCurrentTargetFace) {
-				iPushFace = facepair[0];
-
-			} else {
-				_EXCEPTIONT("EdgeMap error");
+			if (iPushFace == InvalidFace) {
+				continue;
 			}
 
-			std::set<int>::const_iterator iterFace =
-				setExaminedTargetFaces.find(iPushFace);
-
-			if (iterFace == setExaminedTargetFaces.end()) {
-				queueTargetFaces.push(iPushFace);
-				setExaminedTargetFaces.insert(iPushFace);
-			}
+			QueueTargetFace(workspace, iPushFace);
 		}
 	}
 
@@ -1675,15 +2041,22 @@ int FindFaceContainingNode(
 
 ///////////////////////////////////////////////////////////////////////////////
 
-void GenerateOverlapMeshFromFace(
+///	<summary>
+///		Generate the overlap faces of source face ixSourceFace.  Returns
+///		the first overlapping target face, or InvalidFace if none was found.
+///	</summary>
+int GenerateOverlapMeshFromFace(
 	const Mesh & meshSource,
 	const Mesh & meshTarget,
 	int ixSourceFace,
 	Mesh & meshOverlap,
 	NodeMap & nodemapOverlap,
+	std::vector<double> & vecOverlapFaceArea,
 	OverlapMeshMethod method,
     int ixTargetFaceSeed,
 	bool fAllowNoOverlap,
+	const FaceNeighborTable & faceneighborsTarget,
+	OverlapFaceWorkspace & workspace,
     const bool fVerbose = true
 ) {
 	// Verify the EdgeMap exists in both meshSource and meshTarget
@@ -1696,16 +2069,10 @@ void GenerateOverlapMeshFromFace(
 			" to GenerateOverlapFace");
 	}
 
-	// Set of Faces on the Target Mesh that overlap ixSourceFace
-	std::set<int> setExaminedTargetFaces;
-
 	// Get the two NodeVectors
 	const NodeVector & nodevecSource = meshSource.nodes;
 	const NodeVector & nodevecTarget = meshTarget.nodes;
 
-	// EdgeMap
-	const EdgeMap & edgemapTarget = meshTarget.edgemap;
-
 	// Find the starting face on the target mesh
 	MeshUtilitiesFuzzy utils;
 /*
@@ -1725,12 +2092,14 @@ void GenerateOverlapMeshFromFace(
 			meshSource,
 			meshTarget,
 			ixSourceFace,
-			ixTargetFaceSeed);
+			ixTargetFaceSeed,
+			faceneighborsTarget,
+			workspace);
 
 	if (ixCurrentTargetFace == InvalidFace) {
 		if (fAllowNoOverlap) {
 			Announce("WARNING: No overlapping face found");
-			return;
+			return InvalidFace;
 		}
 		Announce("ERROR: No overlapping face found");
 		Announce("This may be caused by mesh B being a subset of mesh A");
@@ -1741,6 +2110,8 @@ void GenerateOverlapMeshFromFace(
     if (fVerbose) {
 		Announce("First overlap match %i", ixCurrentTargetFace);
 	}
+
+	const int ixFirstTargetFace = ixCurrentTargetFace;
 /*
 	// Verify starting Node is not on the Exterior
 	if (aFindFaceStruct.loc == Face::NodeLocation_Exterior) {
@@ -1750,11 +2121,13 @@ void GenerateOverlapMeshFromFace(
 	// Current target Face
 	int ixCurrentTargetFace = aFindFaceStruct.vecFaceIndices[0];
 */
-	std::queue<int> queueTargetFaces;
-	queueTargetFaces.push(ixCurrentTargetFace);
-	setExaminedTargetFaces.insert(ixCurrentTargetFace);
+	// Faces on the Target Mesh that overlap ixSourceFace are found by a
+	// breadth-first search from the first overlapping face
+	BeginTargetFaceSearch(
+		workspace, static_cast<int>(meshTarget.faces.size()));
+	QueueTargetFace(workspace, ixCurrentTargetFace);
 
-	while (!queueTargetFaces.empty()) {
+	for (size_t q = 0; q < workspace.vecTargetFaceQueue.size(); q++) {
 /*
 	meshSource.nodes[meshSource.faces[ixSourceFace][0]].Print("S");
 	meshTarget.nodes[meshTarget.faces[ixCurrentTargetFace][0]].Print("T");
@@ -1768,25 +2141,27 @@ void GenerateOverlapMeshFromFace(
 	}
 */
 		// Get the next target face
-		ixCurrentTargetFace = queueTargetFaces.front();
-		queueTargetFaces.pop();
+		ixCurrentTargetFace = workspace.vecTargetFaceQueue[q];
 
 		if (ixCurrentTargetFace == InvalidFace) {
 			_EXCEPTIONT("Logic error");
 		}
+
+		OVERLAPMESH_PROFILE_ADD(workspace, nTargetFacesVisited, 1);
+
 		const Face & faceTarget = meshTarget.faces[ixCurrentTargetFace];
 
 		// Find the overlap polygon
-		NodeVector nodevecOutput;
-
 		GenerateOverlapFace<MeshUtilitiesFuzzy, Node>(
 			meshSource,
 			meshTarget,
 			ixSourceFace,
 			ixCurrentTargetFace,
-			nodevecOutput
+			workspace
 		);
 
+		const NodeVector & nodevecOutput = workspace.nodevecOutput;
+
 		if (nodevecOutput.size() == 0) {
 
 		} else if (nodevecOutput.size() < 3) {
@@ -1796,37 +2171,14 @@ void GenerateOverlapMeshFromFace(
 
 			// Add all neighboring Faces into the queue of Target Faces
 			for (int i = 0; i < faceTarget.edges.size(); i++) {
-				EdgeMapConstIterator iter =
-					edgemapTarget.find(faceTarget.edges[i]);
-
-				if (iter == edgemapTarget.end()) {
-					_EXCEPTIONT("Missing Edge in Target EdgeMap");
-				}
-
-				const FacePair & facepair = iter->second;
-
-				int iPushFace;
-				if (facepair[0] == ixCurrentTargetFace) {
-					iPushFace = facepair[1];
-
-				} else if (facepair[1] == ixCurrentTargetFace) {
-					iPushFace = facepair[0];
-
-				} else {
-					_EXCEPTIONT("EdgeMap error");
-				}
+				int iPushFace =
+					faceneighborsTarget.GetNeighbor(ixCurrentTargetFace, i);
 
 				if (iPushFace == InvalidFace) {
 					continue;
 				}
 
-				std::set<int>::const_iterator iterFace =
-					setExaminedTargetFaces.find(iPushFace);
-
-				if (iterFace == setExaminedTargetFaces.end()) {
-					queueTargetFaces.push(iPushFace);
-					setExaminedTargetFaces.insert(iPushFace);
-				}
+				QueueTargetFace(workspace, iPushFace);
 			}
 
             if (fVerbose) {
@@ -1834,7 +2186,8 @@ void GenerateOverlapMeshFromFace(
 			}
 
 			// Calculate face area
-			Face faceTemp(nodevecOutput.size());
+			Face & faceTemp = workspace.faceOutput;
+			faceTemp.edges.resize(nodevecOutput.size());
 			for (int i = 0; i < nodevecOutput.size(); i++) {
 				faceTemp.SetNode(i, i);
 			}
@@ -1851,8 +2204,10 @@ void GenerateOverlapMeshFromFace(
 */
 			}
 
-			// Insert Face into meshOverlap
-			Face faceNew(nodevecOutput.size());
+			// Insert Face into meshOverlap, constructing it in place
+			meshOverlap.faces.push_back(Face(nodevecOutput.size()));
+
+			Face & faceNew = meshOverlap.faces.back();
 			for (int i = 0; i < nodevecOutput.size(); i++) {
 #if defined(OVERLAPMESH_RETAIN_REPEATED_NODES)
 				faceNew.SetNode(i, meshOverlap.nodes.size());
@@ -1862,8 +2217,10 @@ void GenerateOverlapMeshFromFace(
 					= nodemapOverlap.find(nodevecOutput[i]);
 
 				if (iter != nodemapOverlap.end()) {
+					OVERLAPMESH_PROFILE_ADD(workspace, nNodeMapHits, 1);
 					faceNew.SetNode(i, iter->second);
 				} else {
+					OVERLAPMESH_PROFILE_ADD(workspace, nNodeMapMisses, 1);
 					int iNextNodeMapOverlapIx = nodemapOverlap.size();
 					faceNew.SetNode(i, iNextNodeMapOverlapIx);
 					nodemapOverlap.insert(
@@ -1871,93 +2228,803 @@ void GenerateOverlapMeshFromFace(
 				}
 #endif
 			}
-			meshOverlap.faces.push_back(faceNew);
 
 			meshOverlap.vecSourceFaceIx.push_back(ixSourceFace);
 			meshOverlap.vecTargetFaceIx.push_back(ixCurrentTargetFace);
+
+			// Retain the area, which is not recomputed for the overlap mesh
+			vecOverlapFaceArea.push_back(dArea);
 		}
 	}
+
+	return ixFirstTargetFace;
 }
 
 ///////////////////////////////////////////////////////////////////////////////
 
-void GenerateOverlapMesh_v2(
-	const Mesh & meshSource,
-	const Mesh & meshTarget,
-	Mesh & meshOverlap,
-    OverlapMeshMethod method,
-	const bool fAllowNoOverlap,
-    const bool fVerbose
-) {
-#if defined(OVERLAPMESH_RETAIN_REPEATED_NODES)
-	NodeMap nodemapOverlap;
-#endif
-#if defined(OVERLAPMESH_USE_UNSORTED_MAP)
-	NodeMap nodemapOverlap;
-#endif
-#if defined(OVERLAPMESH_USE_NODE_MULTIMAP)
-	NodeMap nodemapOverlap(ReferenceTolerance, OVERLAPMESH_BIN_WIDTH);
-#endif
+///	<summary>
+///		Maximum number of source faces in each chunk of work when the overlap
+///		mesh is generated with more than one thread.  Chunks with source faces
+///		of above average cost are made smaller.  Chunk boundaries do not
+///		depend on the thread count.
+///	</summary>
+static const int OverlapMeshChunkSize = 256;
 
-	// Create a KD tree for fast searching of the target mesh
-	kdtree * kdTarget = kd_create(3);
+///////////////////////////////////////////////////////////////////////////////
 
-	for (int i = 0; i < meshTarget.faces.size(); i++) {
-		int ixNodeCorner = meshTarget.faces[i][0];
-		kd_insert3(
-			kdTarget,
-			meshTarget.nodes[ixNodeCorner].x,
-			meshTarget.nodes[ixNodeCorner].y,
-			meshTarget.nodes[ixNodeCorner].z,
-			(void*)(&(meshTarget.faces[i])));
-	}
+#if defined(OVERLAPMESH_INSTRUMENT)
 
-	// Generate Overlap mesh for each Face
-	for (int i = 0; i < meshSource.faces.size(); i++) {
-        if (fVerbose) {
-			std::string strAnnounce = "Source Face " + std::to_string((long long)i);
-			AnnounceStartBlock(strAnnounce.c_str());
+///	<summary>
+///		Wall time in seconds, used to time each source face.
+///	</summary>
+static double OverlapProfileWallTime() {
+	return std::chrono::duration<double>(
+		std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+///	<summary>
+///		Announce a histogram with power of two bins.  Bin b holds values
+///		in [2^(b-1), 2^b) times dScale, with bin 0 holding values below
+///		dScale.
+///	</summary>
+static void AnnounceOverlapProfileHistogram(
+	const char * szTitle,
+	const char * szUnits,
+	const std::vector<double> & vecValues,
+	double dScale
+) {
+	std::vector<int> vecBins;
+	for (size_t i = 0; i < vecValues.size(); i++) {
+		int iBin = 0;
+		double dBinUpper = dScale;
+		while (vecValues[i] >= dBinUpper) {
+			iBin++;
+			dBinUpper *= 2.0;
 		}
-		if (!fVerbose && ((i % 1000) == 0)) {
-			std::string strAnnounce = "Source Face " + std::to_string((long long)i);
-			Announce(strAnnounce.c_str());
+		if (iBin >= vecBins.size()) {
+			vecBins.resize(iBin + 1, 0);
 		}
+		vecBins[iBin]++;
+	}
 
-		// Find a Target face near this source face
-		int ixNodeCorner = meshSource.faces[i][0];
-
-		kdres * kdresTarget =
-			kd_nearest3(
-				kdTarget,
-				meshSource.nodes[ixNodeCorner].x,
-				meshSource.nodes[ixNodeCorner].y,
-				meshSource.nodes[ixNodeCorner].z);
-
-		Face * pFace = (Face *)(kd_res_item_data(kdresTarget));
-
-		int iTargetFaceSeed = pFace - &(meshTarget.faces[0]);
-
-        if (fVerbose) {
-			Announce("Nearest target face %i", iTargetFaceSeed);
+	AnnounceStartBlock(szTitle);
+	for (int b = 0; b < vecBins.size(); b++) {
+		if (vecBins[b] == 0) {
+			continue;
 		}
+		double dBinLower = (b == 0)?(0.0):(std::ldexp(dScale, b - 1));
+		double dBinUpper = std::ldexp(dScale, b);
+		Announce("[%1.3g, %1.3g) %s: %i", dBinLower, dBinUpper, szUnits, vecBins[b]);
+	}
+	AnnounceEndBlock(NULL);
+}
 
-		// Generate the overlap mesh associated with this source face
-		GenerateOverlapMeshFromFace(
+///	<summary>
+///		Announce totals, histograms and the slowest source faces from the
+///		per-face profile of source faces [ixSourceFaceBegin,
+///		ixSourceFaceEnd), add the totals to the Announce counters and
+///		write the records as CSV to the file named by the
+///		TEMPESTREMAP_OVERLAP_PROFILE environment variable.
+///	</summary>
+static void ReportOverlapFaceProfile(
+	const std::vector<OverlapFaceProfile> & vecFaceProfile,
+	int ixSourceFaceBegin,
+	int ixSourceFaceEnd
+) {
+	static const int s_iCounterTargetFacesVisited =
+		AnnounceRegisterCounter("overlap target faces visited");
+	static const int s_iCounterSeedFacesVisited =
+		AnnounceRegisterCounter("overlap seed faces visited");
+	static const int s_iCounterNodeMapHits =
+		AnnounceRegisterCounter("overlap node map hits");
+	static const int s_iCounterNodeMapMisses =
+		AnnounceRegisterCounter("overlap node map misses");
+
+	const int nFaces = ixSourceFaceEnd - ixSourceFaceBegin;
+	if (nFaces <= 0) {
+		return;
+	}
+
+	// Totals
+	long long lTargetFacesVisited = 0;
+	long long lSeedFacesVisited = 0;
+	long long lSeedTreeQueries = 0;
+	long long lEdgeIntersections = 0;
+	long long lNodeMapHits = 0;
+	long long lNodeMapMisses = 0;
+	int nSeedFallbacks = 0;
+	double dTotalTime = 0.0;
+
+	std::vector<double> vecTime(nFaces);
+	std::vector<double> vecTargetFacesVisited(nFaces);
+
+	for (int i = ixSourceFaceBegin; i < ixSourceFaceEnd; i++) {
+		const OverlapFaceProfile & profile = vecFaceProfile[i];
+
+		lTargetFacesVisited += profile.nTargetFacesVisited;
+		lSeedFacesVisited += profile.nSeedFacesVisited;
+		lSeedTreeQueries += profile.nSeedTreeQueries;
+		lEdgeIntersections += profile.nEdgeIntersections;
+		lNodeMapHits += profile.nNodeMapHits;
+		lNodeMapMisses += profile.nNodeMapMisses;
+		if (profile.nSeedFacesVisited > 1) {
+			nSeedFallbacks++;
+		}
+		dTotalTime += profile.dTime;
+
+		vecTime[i - ixSourceFaceBegin] = profile.dTime;
+		vecTargetFacesVisited[i - ixSourceFaceBegin] =
+			static_cast<double>(profile.nTargetFacesVisited);
+	}
+
+	AnnounceCount(s_iCounterTargetFacesVisited, lTargetFacesVisited);
+	AnnounceCount(s_iCounterSeedFacesVisited, lSeedFacesVisited);
+	AnnounceCount(s_iCounterEdgeIntersections, lEdgeIntersections);
+	AnnounceCount(s_iCounterNodeMapHits, lNodeMapHits);
+	AnnounceCount(s_iCounterNodeMapMisses, lNodeMapMisses);
+
+	// Median time
+	std::vector<double> vecSortedTime(vecTime);
+	std::nth_element(
+		vecSortedTime.begin(),
+		vecSortedTime.begin() + nFaces / 2,
+		vecSortedTime.end());
+	double dMedianTime = vecSortedTime[nFaces / 2];
+
+	AnnounceStartBlock("Overlap face profile");
+	Announce("Source faces: %i", nFaces);
+	Announce("Target faces visited: %lli (%1.2f per source face)",
+		lTargetFacesVisited,
+		static_cast<double>(lTargetFacesVisited) / static_cast<double>(nFaces));
+	Announce("Edge intersections: %lli", lEdgeIntersections);
+	Announce("Seed search fallbacks: %i (%lli faces searched)",
+		nSeedFallbacks, lSeedFacesVisited);
+	Announce("Seed tree queries: %lli", lSeedTreeQueries);
+	Announce("NodeMap hits / misses: %lli / %lli",
+		lNodeMapHits, lNodeMapMisses);
+	Announce("Time: %1.6f s total, %1.3e s median, %1.3e s mean",
+		dTotalTime, dMedianTime, dTotalTime / static_cast<double>(nFaces));
+
+	AnnounceOverlapProfileHistogram(
+		"Target faces visited per source face", "faces",
+		vecTargetFacesVisited, 1.0);
+
+	if (dMedianTime > 0.0) {
+		std::vector<double> vecRelativeTime(nFaces);
+		for (int i = 0; i < nFaces; i++) {
+			vecRelativeTime[i] = vecTime[i] / dMedianTime;
+		}
+		AnnounceOverlapProfileHistogram(
+			"Time per source face relative to median", "x median",
+			vecRelativeTime, 1.0);
+	}
+
+	// Slowest source faces
+	const int nSlowest = std::min(nFaces, 10);
+
+	std::vector<int> vecFaceIx(nFaces);
+	for (int i = 0; i < nFaces; i++) {
+		vecFaceIx[i] = ixSourceFaceBegin + i;
+	}
+	std::partial_sort(
+		vecFaceIx.begin(),
+		vecFaceIx.begin() + nSlowest,
+		vecFaceIx.end(),
+		[&vecFaceProfile](int a, int b) {
+			return (vecFaceProfile[a].dTime > vecFaceProfile[b].dTime);
+		});
+
+	AnnounceStartBlock("Slowest source faces");
+	for (int i = 0; i < nSlowest; i++) {
+		const OverlapFaceProfile & profile = vecFaceProfile[vecFaceIx[i]];
+		Announce("Face %i: %1.3e s, %i target faces, %i intersections, "
+			"%i seed faces",
+			vecFaceIx[i],
+			profile.dTime,
+			profile.nTargetFacesVisited,
+			profile.nEdgeIntersections,
+			profile.nSeedFacesVisited);
+	}
+	AnnounceEndBlock(NULL);
+
+	// Per-face records for partitioning and load balancing
+	const char * szProfileFile = getenv("TEMPESTREMAP_OVERLAP_PROFILE");
+	if ((szProfileFile != NULL) && (szProfileFile[0] != '\0')) {
+		FILE * fp = fopen(szProfileFile, "w");
+		if (fp == NULL) {
+			_EXCEPTION1("Unable to open overlap profile file \"%s\"",
+				szProfileFile);
+		}
+
+		fprintf(fp, "source_face,time,target_faces_visited,"
+			"edge_intersections,seed_faces_visited,"
+			"nodemap_hits,nodemap_misses,seed_tree_queries\n");
+
+		for (int i = ixSourceFaceBegin; i < ixSourceFaceEnd; i++) {
+			const OverlapFaceProfile & profile = vecFaceProfile[i];
+			fprintf(fp, "%i,%1.6e,%i,%i,%i,%i,%i,%i\n",
+				i,
+				profile.dTime,
+				profile.nTargetFacesVisited,
+				profile.nEdgeIntersections,
+				profile.nSeedFacesVisited,
+				profile.nNodeMapHits,
+				profile.nNodeMapMisses,
+				profile.nSeedTreeQueries);
+		}
+
+		fclose(fp);
+
+		Announce("Per-face profile written to %s", szProfileFile);
+	}
+
+	AnnounceEndBlock(NULL);
+}
+
+#endif
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Find a face on the target mesh near the first corner of the given
+///		source face, to seed the search for overlapping faces.
+///	</summary>
+static int FindTargetFaceSeed(
+	const Mesh & meshSource,
+	const NodeKDTree<int> & treeTarget,
+	int ixSourceFace
+) {
+	int ixNodeCorner = meshSource.faces[ixSourceFace][0];
+
+	int iTargetFaceSeed;
+	if (!treeTarget.FindNearest(meshSource.nodes[ixNodeCorner], iTargetFaceSeed)) {
+		_EXCEPTIONT("Target mesh contains no faces");
+	}
+
+	return iTargetFaceSeed;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Number of target faces searched from a reused seed, in addition to
+///		the number of overlap faces of the previous source face, before the
+///		KD tree is queried instead.
+///	</summary>
+static const int OverlapSeedReuseMaxFaces = 64;
+
+///	<summary>
+///		Find the target face whose interior contains the first corner of
+///		source face ixSourceFace by a breadth-first search from target
+///		face ixTargetFacePrev, visiting at most nMaxFaces faces.  A target
+///		face containing the corner in its interior is also the face found
+///		from the KD tree seed, so the overlap is unchanged.  Returns
+///		InvalidFace if no such face is found or the corner lies on the
+///		boundary of a target face.
+///	</summary>
+static int FindReusedTargetFaceSeed(
+	const Mesh & meshSource,
+	const Mesh & meshTarget,
+	const FaceNeighborTable & faceneighborsTarget,
+	int ixSourceFace,
+	int ixTargetFacePrev,
+	int nMaxFaces,
+	OverlapFaceWorkspace & workspace
+) {
+	const Node & node =
+		meshSource.nodes[meshSource.faces[ixSourceFace][0]];
+
+	MeshUtilitiesFuzzy utils;
+
+	Face::NodeLocation loc;
+	int ixLocation;
+
+	BeginTargetFaceSearch(
+		workspace, static_cast<int>(meshTarget.faces.size()));
+	QueueTargetFace(workspace, ixTargetFacePrev);
+
+	for (size_t q = 0; q < workspace.vecTargetFaceQueue.size(); q++) {
+		if (q >= nMaxFaces) {
+			break;
+		}
+
+		int ixCurrentTargetFace = workspace.vecTargetFaceQueue[q];
+
+		const Face & faceTarget = meshTarget.faces[ixCurrentTargetFace];
+
+		utils.ContainsNode(
+			faceTarget,
+			meshTarget.nodes,
+			node,
+			loc,
+			ixLocation);
+
+		if (loc == Face::NodeLocation_Interior) {
+			return ixCurrentTargetFace;
+		}
+		if (loc != Face::NodeLocation_Exterior) {
+			break;
+		}
+
+		for (int i = 0; i < faceTarget.edges.size(); i++) {
+			int iPushFace =
+				faceneighborsTarget.GetNeighbor(ixCurrentTargetFace, i);
+
+			if (iPushFace == InvalidFace) {
+				continue;
+			}
+
+			QueueTargetFace(workspace, iPushFace);
+		}
+	}
+
+	return InvalidFace;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Find the seed of the search for target faces overlapping source
+///		face ixSourceFace.  If ixTargetFacePrev is not InvalidFace the search
+///		first reuses this first overlapping target face of the previous
+///		source face, which had nOverlapFacesPrev overlap faces, and the KD
+///		tree is only queried if that fails.
+///	</summary>
+static int FindOverlapTargetFaceSeed(
+	const Mesh & meshSource,
+	const Mesh & meshTarget,
+	const NodeKDTree<int> & treeTarget,
+	const FaceNeighborTable & faceneighborsTarget,
+	int ixSourceFace,
+	int ixTargetFacePrev,
+	int nOverlapFacesPrev,
+	OverlapFaceWorkspace & workspace
+) {
+	if (ixTargetFacePrev != InvalidFace) {
+		int iTargetFaceSeed =
+			FindReusedTargetFaceSeed(
+				meshSource,
+				meshTarget,
+				faceneighborsTarget,
+				ixSourceFace,
+				ixTargetFacePrev,
+				OverlapSeedReuseMaxFaces + nOverlapFacesPrev,
+				workspace);
+
+		if (iTargetFaceSeed != InvalidFace) {
+			return iTargetFaceSeed;
+		}
+	}
+
+	OVERLAPMESH_PROFILE_ADD(workspace, nSeedTreeQueries, 1);
+
+	return FindTargetFaceSeed(meshSource, treeTarget, ixSourceFace);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Generate the overlap faces associated with the contiguous range of
+///		source faces [ixSourceFaceBegin, ixSourceFaceEnd).  Node indices in
+///		meshChunk are local to the chunk and meshChunk.nodes and
+///		meshChunk.vecFaceArea are populated on return.  Seeds are only
+///		reused within the chunk when fReuseSeeds is true, so the first
+///		source face of each chunk queries the KD tree.  If
+///		OVERLAPMESH_INSTRUMENT is defined the profile of each source face
+///		is stored in vecFaceProfile.
+///	</summary>
+static void GenerateOverlapMeshChunk(
+	const Mesh & meshSource,
+	const Mesh & meshTarget,
+	const NodeKDTree<int> & treeTarget,
+	const FaceNeighborTable & faceneighborsTarget,
+	int ixSourceFaceBegin,
+	int ixSourceFaceEnd,
+	Mesh & meshChunk,
+	OverlapMeshMethod method,
+	const bool fAllowNoOverlap,
+	const bool fReuseSeeds,
+	std::vector<OverlapFaceProfile> & vecFaceProfile
+) {
+#if defined(OVERLAPMESH_RETAIN_REPEATED_NODES)
+	NodeMap nodemapChunk;
+#endif
+#if defined(OVERLAPMESH_USE_UNSORTED_MAP)
+	NodeMap nodemapChunk;
+#endif
+#if defined(OVERLAPMESH_USE_NODE_MULTIMAP)
+	NodeMap nodemapChunk(ReferenceTolerance, OVERLAPMESH_BIN_WIDTH);
+#endif
+#if defined(OVERLAPMESH_USE_NODE_HASH)
+	NodeMap nodemapChunk(ReferenceTolerance, OVERLAPMESH_HASH_CELL_WIDTH);
+#endif
+
+	OverlapFaceWorkspace workspace;
+
+	std::vector<double> vecChunkFaceArea;
+
+	// First overlapping target face and overlap face count of the
+	// previous source face
+	int ixTargetFacePrev = InvalidFace;
+	int nOverlapFacesPrev = 0;
+
+	for (int i = ixSourceFaceBegin; i < ixSourceFaceEnd; i++) {
+#if defined(OVERLAPMESH_INSTRUMENT)
+		workspace.profile = OverlapFaceProfile();
+		double dTimeBegin = OverlapProfileWallTime();
+#endif
+
+		int iTargetFaceSeed =
+			FindOverlapTargetFaceSeed(
+				meshSource,
+				meshTarget,
+				treeTarget,
+				faceneighborsTarget,
+				i,
+				ixTargetFacePrev,
+				nOverlapFacesPrev,
+				workspace);
+
+		const size_t sOverlapFacesBegin = meshChunk.faces.size();
+
+		int ixFirstTargetFace = GenerateOverlapMeshFromFace(
 			meshSource,
 			meshTarget,
 			i,
-			meshOverlap,
-			nodemapOverlap,
+			meshChunk,
+			nodemapChunk,
+			vecChunkFaceArea,
 			method,
-            iTargetFaceSeed,
+			iTargetFaceSeed,
 			fAllowNoOverlap,
-            fVerbose);
+			faceneighborsTarget,
+			workspace,
+			false);
+
+		if (fReuseSeeds) {
+			ixTargetFacePrev = ixFirstTargetFace;
+			nOverlapFacesPrev =
+				static_cast<int>(meshChunk.faces.size() - sOverlapFacesBegin);
+		}
+
+#if defined(OVERLAPMESH_INSTRUMENT)
+		workspace.profile.dTime = OverlapProfileWallTime() - dTimeBegin;
+		vecFaceProfile[i] = workspace.profile;
+#endif
+	}
+
+	AnnounceCount(s_iCounterOverlapSourceFaces,
+		ixSourceFaceEnd - ixSourceFaceBegin);
+	AnnounceCount(s_iCounterOverlapFaces, meshChunk.faces.size());
+
+	meshChunk.vecFaceArea.Allocate(vecChunkFaceArea.size());
+	for (int f = 0; f < vecChunkFaceArea.size(); f++) {
+		meshChunk.vecFaceArea[f] = vecChunkFaceArea[f];
+	}
+
+#if !defined(OVERLAPMESH_RETAIN_REPEATED_NODES)
+	meshChunk.nodes.resize(nodemapChunk.size());
+
+	NodeMapConstIterator iter = nodemapChunk.begin();
+	for (; iter != nodemapChunk.end(); iter++) {
+		meshChunk.nodes[iter->second] = iter->first;
+	}
+#endif
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Append the faces of meshChunk to meshOverlap, deduplicating nodes
+///		against nodemapOverlap, and the face areas of meshChunk to
+///		vecOverlapFaceArea.  Local nodes are visited in index order,
+///		which is the order of first use within the chunk, so merging chunks
+///		in source face order assigns the same global node indices as
+///		processing every source face serially.
+///	</summary>
+static void MergeOverlapMeshChunk(
+	const Mesh & meshChunk,
+	Mesh & meshOverlap,
+	NodeMap & nodemapOverlap,
+	std::vector<double> & vecOverlapFaceArea
+) {
+	std::vector<int> vecLocalToGlobal(meshChunk.nodes.size());
+
+#if defined(OVERLAPMESH_RETAIN_REPEATED_NODES)
+	for (int i = 0; i < meshChunk.nodes.size(); i++) {
+		vecLocalToGlobal[i] = meshOverlap.nodes.size();
+		meshOverlap.nodes.push_back(meshChunk.nodes[i]);
+	}
+#else
+	for (int i = 0; i < meshChunk.nodes.size(); i++) {
+		NodeMapConstIterator iter = nodemapOverlap.find(meshChunk.nodes[i]);
+
+		if (iter != nodemapOverlap.end()) {
+			vecLocalToGlobal[i] = iter->second;
+		} else {
+			int iNextNodeMapOverlapIx = nodemapOverlap.size();
+			vecLocalToGlobal[i] = iNextNodeMapOverlapIx;
+			nodemapOverlap.insert(
+				NodeMapPair(meshChunk.nodes[i], iNextNodeMapOverlapIx));
+		}
+	}
+#endif
+
+	for (int f = 0; f < meshChunk.faces.size(); f++) {
+		const Face & faceChunk = meshChunk.faces[f];
+
+		Face faceNew(faceChunk.edges.size());
+		for (int i = 0; i < faceChunk.edges.size(); i++) {
+			faceNew.SetNode(i, vecLocalToGlobal[faceChunk[i]]);
+		}
+		meshOverlap.faces.push_back(faceNew);
+
+		meshOverlap.vecSourceFaceIx.push_back(meshChunk.vecSourceFaceIx[f]);
+		meshOverlap.vecTargetFaceIx.push_back(meshChunk.vecTargetFaceIx[f]);
+
+		vecOverlapFaceArea.push_back(meshChunk.vecFaceArea[f]);
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Estimate the relative cost of generating the overlap faces of each
+///		source face in [ixSourceFaceBegin, ixSourceFaceEnd).  If the
+///		environment variable TEMPESTREMAP_OVERLAP_COST names a per-face
+///		profile written by a previous run (see OVERLAPMESH_INSTRUMENT) the
+///		recorded times are used.  Otherwise the cost is estimated from the
+///		ratio of the area of the source face to the area of the nearby
+///		target face, which approximates the number of target faces that
+///		will be clipped.
+///	</summary>
+static void EstimateOverlapFaceCost(
+	const Mesh & meshSource,
+	const Mesh & meshTarget,
+	const NodeKDTree<int> & treeTarget,
+	int ixSourceFaceBegin,
+	int ixSourceFaceEnd,
+	const int nThreads,
+	std::vector<double> & vecFaceCost
+) {
+	const int nFaces = ixSourceFaceEnd - ixSourceFaceBegin;
+
+	vecFaceCost.resize(nFaces);
+
+	// Costs from a previous run
+	const char * szCostFile = getenv("TEMPESTREMAP_OVERLAP_COST");
+	if ((szCostFile != NULL) && (szCostFile[0] != '\0')) {
+		FILE * fp = fopen(szCostFile, "r");
+		if (fp == NULL) {
+			_EXCEPTION1("Unable to open overlap cost file \"%s\"", szCostFile);
+		}
+
+		std::vector<bool> vecFound(nFaces, false);
+		int nFound = 0;
+
+		char szLine[1024];
+		while (fgets(szLine, sizeof(szLine), fp) != NULL) {
+			int ixFace;
+			double dTime;
+			if (sscanf(szLine, "%i,%lf", &ixFace, &dTime) != 2) {
+				continue;
+			}
+			if ((ixFace < ixSourceFaceBegin) || (ixFace >= ixSourceFaceEnd)) {
+				continue;
+			}
+			vecFaceCost[ixFace - ixSourceFaceBegin] = std::max(dTime, 0.0);
+			if (!vecFound[ixFace - ixSourceFaceBegin]) {
+				vecFound[ixFace - ixSourceFaceBegin] = true;
+				nFound++;
+			}
+		}
+
+		fclose(fp);
+
+		if (nFound == nFaces) {
+			Announce("Overlap face costs read from %s", szCostFile);
+			return;
+		}
+
+		Announce("WARNING: Overlap cost file \"%s\" does not cover all "
+			"source faces; estimating costs from face areas", szCostFile);
+	}
+
+	// Costs from the ratio of face areas
+#pragma omp parallel for schedule(static) num_threads(nThreads)
+	for (int i = 0; i < nFaces; i++) {
+		const int ixSourceFace = ixSourceFaceBegin + i;
+
+		const int ixTargetFaceSeed =
+			FindTargetFaceSeed(meshSource, treeTarget, ixSourceFace);
+
+		const double dSourceArea =
+			CalculateFaceArea(
+				meshSource.faces[ixSourceFace], meshSource.nodes);
+		const double dTargetArea =
+			CalculateFaceArea(
+				meshTarget.faces[ixTargetFaceSeed], meshTarget.nodes);
+
+		if (dTargetArea > 0.0) {
+			vecFaceCost[i] = 1.0 + dSourceArea / dTargetArea;
+		} else {
+			vecFaceCost[i] = 1.0;
+		}
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Generate the overlap faces associated with the contiguous range of
+///		source faces [ixSourceFaceBegin, ixSourceFaceEnd) using nThreads
+///		threads and append them to meshOverlap.  The range is divided into
+///		chunks of contiguous source faces of roughly equal estimated cost,
+///		so that faces overlapping many target faces (such as those near the
+///		poles of a latitude-longitude mesh) are spread over many chunks.
+///		Chunks are processed in rounds, most expensive first, from a queue
+///		shared by all threads, and merged in source face order, so that
+///		overlap faces remain contiguous per source face and node numbering
+///		is the same as if every source face had been processed serially.
+///		If OVERLAPMESH_INSTRUMENT is defined the profile of each source face
+///		is stored in vecFaceProfile, which must span all source faces.
+///	</summary>
+static void GenerateOverlapMeshRange(
+	const Mesh & meshSource,
+	const Mesh & meshTarget,
+	const NodeKDTree<int> & treeTarget,
+	int ixSourceFaceBegin,
+	int ixSourceFaceEnd,
+	Mesh & meshOverlap,
+	NodeMap & nodemapOverlap,
+	std::vector<double> & vecOverlapFaceArea,
+	OverlapMeshMethod method,
+	const bool fAllowNoOverlap,
+	const int nThreads,
+	const bool fReuseSeeds,
+	std::vector<OverlapFaceProfile> & vecFaceProfile
+) {
+	const int nFaces = ixSourceFaceEnd - ixSourceFaceBegin;
+	if (nFaces <= 0) {
+		return;
+	}
+
+	// Neighbors of each target face, shared by all threads
+	FaceNeighborTable faceneighborsLocal;
+	const FaceNeighborTable & faceneighborsTarget =
+		GetTargetFaceNeighbors(meshTarget, faceneighborsLocal, nThreads);
+
+	// Estimate the cost of each source face
+	std::vector<double> vecFaceCost;
+	EstimateOverlapFaceCost(
+		meshSource,
+		meshTarget,
+		treeTarget,
+		ixSourceFaceBegin,
+		ixSourceFaceEnd,
+		nThreads,
+		vecFaceCost);
+
+	double dTotalCost = 0.0;
+	for (int i = 0; i < nFaces; i++) {
+		dTotalCost += vecFaceCost[i];
+	}
+
+	// Divide the range into chunks of at most OverlapMeshChunkSize faces
+	// with cost no greater than that of OverlapMeshChunkSize faces of mean
+	// cost.  Chunk boundaries do not depend on the number of threads.
+	const double dMaxChunkCost =
+		dTotalCost * static_cast<double>(OverlapMeshChunkSize)
+			/ static_cast<double>(nFaces);
+
+	std::vector<int> vecChunkBegin;
+	std::vector<double> vecChunkCost;
+
+	{
+		double dChunkCost = 0.0;
+		int nChunkFaces = 0;
+		for (int i = 0; i < nFaces; i++) {
+			if ((nChunkFaces != 0) && (
+				(nChunkFaces == OverlapMeshChunkSize) ||
+				(dChunkCost + vecFaceCost[i] > dMaxChunkCost))
+			) {
+				vecChunkCost.push_back(dChunkCost);
+				dChunkCost = 0.0;
+				nChunkFaces = 0;
+			}
+			if (nChunkFaces == 0) {
+				vecChunkBegin.push_back(ixSourceFaceBegin + i);
+			}
+			dChunkCost += vecFaceCost[i];
+			nChunkFaces++;
+		}
+		vecChunkCost.push_back(dChunkCost);
+		vecChunkBegin.push_back(ixSourceFaceEnd);
+	}
+
+	const int nChunks = static_cast<int>(vecChunkCost.size());
+
+	// Bound the number of unmerged chunks held in memory at once
+	const int nChunksPerRound = 4 * nThreads;
+
+	std::vector<Mesh> vecMeshChunk;
+	std::vector<int> vecChunkOrder;
+
+	for (int c0 = 0; c0 < nChunks; c0 += nChunksPerRound) {
+		const int c1 = std::min(c0 + nChunksPerRound, nChunks);
+
+		Announce("Source Face %i", vecChunkBegin[c0]);
+
+		vecMeshChunk.clear();
+		vecMeshChunk.resize(c1 - c0);
+
+		// Process the most expensive chunks of the round first, so that
+		// the remaining cheap chunks fill in around them
+		vecChunkOrder.resize(c1 - c0);
+		for (int c = c0; c < c1; c++) {
+			vecChunkOrder[c - c0] = c;
+		}
+		std::stable_sort(
+			vecChunkOrder.begin(),
+			vecChunkOrder.end(),
+			[&vecChunkCost](int a, int b) {
+				return (vecChunkCost[a] > vecChunkCost[b]);
+			});
+
+		OmpExceptionCapture capture;
+
+#pragma omp parallel for schedule(dynamic, 1) num_threads(nThreads)
+		for (int n = 0; n < c1 - c0; n++) {
+			const int c = vecChunkOrder[n];
+
+			capture.Run([&]() {
+				GenerateOverlapMeshChunk(
+					meshSource,
+					meshTarget,
+					treeTarget,
+					faceneighborsTarget,
+					vecChunkBegin[c],
+					vecChunkBegin[c+1],
+					vecMeshChunk[c - c0],
+					method,
+					fAllowNoOverlap,
+					fReuseSeeds,
+					vecFaceProfile);
+			});
+		}
+
+		capture.Rethrow();
 
-		if (fVerbose) {
-			AnnounceEndBlock(NULL);
+		for (int c = 0; c < vecMeshChunk.size(); c++) {
+			MergeOverlapMeshChunk(
+				vecMeshChunk[c], meshOverlap, nodemapOverlap,
+				vecOverlapFaceArea);
+
+			// Release the chunk; DataArray1D cannot be assigned an
+			// unattached array once attached
+			vecMeshChunk[c].vecFaceArea.Detach();
+			vecMeshChunk[c] = Mesh();
 		}
 	}
+}
 
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Replace parent indices of the overlap mesh if the source or target
+///		mesh has a MultiFaceMap, insert all Nodes from nodemapOverlap
+///		into meshOverlap.nodes and set the Face areas of meshOverlap from
+///		the areas computed during generation.  Returns the total area of
+///		meshOverlap.
+///	</summary>
+static double FinalizeOverlapMesh(
+	const Mesh & meshSource,
+	const Mesh & meshTarget,
+	Mesh & meshOverlap,
+	const NodeMap & nodemapOverlap,
+	const std::vector<double> & vecOverlapFaceArea,
+	int nThreads
+) {
 	// Replace parent indices if meshSource has a MultiFaceMap
 	if (meshSource.vecMultiFaceMap.size() != 0) {
 		for (int f = 0; f < meshOverlap.faces.size(); f++) {
@@ -1990,9 +3057,6 @@ void GenerateOverlapMesh_v2(
 		}
 	}
 
-	// Destroy the KD tree
-	kd_free(kdTarget);
-
 #if !defined(OVERLAPMESH_RETAIN_REPEATED_NODES)
 	// Insert all Nodes from nodemapOverlap into meshOverlap.nodes
 	meshOverlap.nodes.resize(nodemapOverlap.size());
@@ -2003,9 +3067,234 @@ void GenerateOverlapMesh_v2(
 	}
 #endif
 
-/*
-	// Check concavity of overlap mesh
-	AnnounceStartBlock("Testing concavity of overlap mesh");
+	// Areas are only available if every face was generated here
+	if (vecOverlapFaceArea.size() != meshOverlap.faces.size()) {
+		return meshOverlap.CalculateFaceAreas(false, nThreads);
+	}
+
+	meshOverlap.vecFaceArea.Allocate(vecOverlapFaceArea.size());
+	for (int f = 0; f < vecOverlapFaceArea.size(); f++) {
+		meshOverlap.vecFaceArea[f] = vecOverlapFaceArea[f];
+	}
+
+	return meshOverlap.SumFaceAreas(nThreads);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void ConstructOverlapSeedKDTree(
+	const Mesh & meshTarget,
+	NodeKDTree<int> & treeTarget
+) {
+	NodeVector vecTargetCorners(meshTarget.faces.size());
+	for (int i = 0; i < meshTarget.faces.size(); i++) {
+		vecTargetCorners[i] = meshTarget.nodes[meshTarget.faces[i][0]];
+	}
+
+	treeTarget.Build(vecTargetCorners);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void GenerateOverlapMesh_v2(
+	const Mesh & meshSource,
+	const Mesh & meshTarget,
+	Mesh & meshOverlap,
+    OverlapMeshMethod method,
+	const bool fAllowNoOverlap,
+    const bool fVerbose,
+	const int nThreads,
+	const bool fReuseSeeds
+) {
+	// Create a KD tree over the first corner of each target face
+	NodeKDTree<int> treeTarget;
+	ConstructOverlapSeedKDTree(meshTarget, treeTarget);
+
+	GenerateOverlapMesh_v2(
+		meshSource,
+		meshTarget,
+		treeTarget,
+		meshOverlap,
+		method,
+		fAllowNoOverlap,
+		fVerbose,
+		nThreads,
+		fReuseSeeds);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void GenerateOverlapMesh_v2(
+	const Mesh & meshSource,
+	const Mesh & meshTarget,
+	const NodeKDTree<int> & treeTarget,
+	Mesh & meshOverlap,
+    OverlapMeshMethod method,
+	const bool fAllowNoOverlap,
+    const bool fVerbose,
+	const int nThreads,
+	const bool fReuseSeeds
+) {
+	if (treeTarget.GetSize() != meshTarget.faces.size()) {
+		_EXCEPTIONT("KD tree does not match target mesh");
+	}
+	if (nThreads < 1) {
+		_EXCEPTIONT("Thread count must be at least 1");
+	}
+
+	// Candidate pairs from a bounding volume hierarchy need no seeds
+	if (method == OverlapMeshMethod_BVH) {
+		GenerateOverlapMesh_BVH(
+			meshSource,
+			meshTarget,
+			meshOverlap,
+			fAllowNoOverlap,
+			nThreads);
+		return;
+	}
+
+#if defined(OVERLAPMESH_USE_STRUCTURED)
+	// Overlap of structured meshes in closed form
+	if (GenerateStructuredOverlapMesh(meshSource, meshTarget, meshOverlap)) {
+		double dTotalAreaOverlap = meshOverlap.CalculateFaceAreas(false, nThreads);
+		Announce("Overlap Mesh Geometric Area: %1.15e (%1.15e)", dTotalAreaOverlap, 4.0 * M_PI);
+		return;
+	}
+#endif
+
+#if defined(OVERLAPMESH_RETAIN_REPEATED_NODES)
+	NodeMap nodemapOverlap;
+#endif
+#if defined(OVERLAPMESH_USE_UNSORTED_MAP)
+	NodeMap nodemapOverlap;
+#endif
+#if defined(OVERLAPMESH_USE_NODE_MULTIMAP)
+	NodeMap nodemapOverlap(ReferenceTolerance, OVERLAPMESH_BIN_WIDTH);
+#endif
+#if defined(OVERLAPMESH_USE_NODE_HASH)
+	NodeMap nodemapOverlap(ReferenceTolerance, OVERLAPMESH_HASH_CELL_WIDTH);
+#endif
+
+	// Area of each overlap face, computed as the face is generated
+	std::vector<double> vecOverlapFaceArea;
+
+	// Work done on each source face
+	std::vector<OverlapFaceProfile> vecFaceProfile;
+#if defined(OVERLAPMESH_INSTRUMENT)
+	vecFaceProfile.resize(meshSource.faces.size());
+#endif
+
+	// Generate Overlap mesh for each Face
+	if (nThreads == 1) {
+		OverlapFaceWorkspace workspace;
+
+		FaceNeighborTable faceneighborsLocal;
+		const FaceNeighborTable & faceneighborsTarget =
+			GetTargetFaceNeighbors(meshTarget, faceneighborsLocal, 1);
+
+		// First overlapping target face and overlap face count of the
+		// previous source face
+		int ixTargetFacePrev = InvalidFace;
+		int nOverlapFacesPrev = 0;
+
+		for (int i = 0; i < meshSource.faces.size(); i++) {
+#if defined(OVERLAPMESH_INSTRUMENT)
+			workspace.profile = OverlapFaceProfile();
+			double dTimeBegin = OverlapProfileWallTime();
+#endif
+			if (fVerbose) {
+				std::string strAnnounce = "Source Face " + std::to_string((long long)i);
+				AnnounceStartBlock(strAnnounce.c_str());
+			}
+			if (!fVerbose && ((i % 1000) == 0)) {
+				std::string strAnnounce = "Source Face " + std::to_string((long long)i);
+				Announce(strAnnounce.c_str());
+			}
+
+			// Find a Target face near this source face
+			int iTargetFaceSeed =
+				FindOverlapTargetFaceSeed(
+					meshSource,
+					meshTarget,
+					treeTarget,
+					faceneighborsTarget,
+					i,
+					ixTargetFacePrev,
+					nOverlapFacesPrev,
+					workspace);
+
+			if (fVerbose) {
+				Announce("Nearest target face %i", iTargetFaceSeed);
+			}
+
+			const size_t sOverlapFacesBegin = meshOverlap.faces.size();
+
+			// Generate the overlap mesh associated with this source face
+			int ixFirstTargetFace = GenerateOverlapMeshFromFace(
+				meshSource,
+				meshTarget,
+				i,
+				meshOverlap,
+				nodemapOverlap,
+				vecOverlapFaceArea,
+				method,
+				iTargetFaceSeed,
+				fAllowNoOverlap,
+				faceneighborsTarget,
+				workspace,
+				fVerbose);
+
+			if (fReuseSeeds) {
+				ixTargetFacePrev = ixFirstTargetFace;
+				nOverlapFacesPrev = static_cast<int>(
+					meshOverlap.faces.size() - sOverlapFacesBegin);
+			}
+
+#if defined(OVERLAPMESH_INSTRUMENT)
+			workspace.profile.dTime = OverlapProfileWallTime() - dTimeBegin;
+			vecFaceProfile[i] = workspace.profile;
+#endif
+
+			if (fVerbose) {
+				AnnounceEndBlock(NULL);
+			}
+		}
+
+	// Generate the overlap mesh in chunks of contiguous source faces, then
+	// merge the chunks in source face order so that overlap faces remain
+	// contiguous per source face and node numbering is reproducible
+	} else {
+		Announce("Generating overlap mesh with %i threads", nThreads);
+
+		GenerateOverlapMeshRange(
+			meshSource,
+			meshTarget,
+			treeTarget,
+			0,
+			static_cast<int>(meshSource.faces.size()),
+			meshOverlap,
+			nodemapOverlap,
+			vecOverlapFaceArea,
+			method,
+			fAllowNoOverlap,
+			nThreads,
+			fReuseSeeds,
+			vecFaceProfile);
+	}
+
+#if defined(OVERLAPMESH_INSTRUMENT)
+	ReportOverlapFaceProfile(
+		vecFaceProfile, 0, static_cast<int>(meshSource.faces.size()));
+#endif
+
+	double dTotalAreaOverlap =
+		FinalizeOverlapMesh(
+			meshSource, meshTarget, meshOverlap, nodemapOverlap,
+			vecOverlapFaceArea, nThreads);
+
+/*
+	// Check concavity of overlap mesh
+	AnnounceStartBlock("Testing concavity of overlap mesh");
 	for (int i = 0; i < meshOverlap.faces.size(); i++) {
 		bool fIsConcave = meshOverlap.IsFaceConcave(i);
 		if (fIsConcave) {
@@ -2014,12 +3303,1698 @@ void GenerateOverlapMesh_v2(
 	}
 	AnnounceEndBlock("Done");
 */
-	// Calculate Face areas
 	//if (fVerbose) {
-	double dTotalAreaOverlap = meshOverlap.CalculateFaceAreas(false);
 	Announce("Overlap Mesh Geometric Area: %1.15e (%1.15e)", dTotalAreaOverlap, 4.0 * M_PI);
 	//}
 }
 
 ///////////////////////////////////////////////////////////////////////////////
 
+///	<summary>
+///		Estimated memory used by each overlap face generated in a window,
+///		including its nodes, the node map and the chunks it was merged
+///		from.
+///	</summary>
+static const double OverlapStreamBytesPerFace = 512.0;
+
+///	<summary>
+///		Estimated memory used by each node held across windows.
+///	</summary>
+static const double OverlapStreamBytesPerBoundaryNode = 128.0;
+
+///	<summary>
+///		Distance from the edge of a source face within which an overlap
+///		node may be shared with another source face.  This is much larger
+///		than the tolerance used to identify nodes, so every node that
+///		could be identified with a node of another source face is caught.
+///	</summary>
+static const double OverlapStreamEdgeTolerance = 1.0e-10;
+
+///	<summary>
+///		An overlap node that may be shared with source faces that have not
+///		yet been processed, with its index in the output and the last
+///		source face that may share it.
+///	</summary>
+struct OverlapStreamBoundaryNode {
+	Node node;
+	int ix;
+	int ixLastSourceFace;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Get the last source face that may share an overlap node generated
+///		from source face ixSourceFace, or -1 if the node is interior to
+///		ixSourceFace.  A node on an edge of ixSourceFace may be shared by
+///		any source face containing either endpoint of the edge, and
+///		vecSourceNodeLastFace holds the last source face containing each
+///		source node.  Source faces are convex, so a node within tolerance
+///		of the great circle (or line of latitude) through an edge lies on
+///		that edge.
+///	</summary>
+static int OverlapNodeLastSourceFace(
+	const Mesh & meshSource,
+	const std::vector<int> & vecSourceNodeLastFace,
+	int ixSourceFace,
+	const Node & node
+) {
+	const Face & face = meshSource.faces[ixSourceFace];
+	const int nEdges = static_cast<int>(face.edges.size());
+
+	int ixLast = -1;
+
+	for (int k = 0; k < nEdges; k++) {
+		const Node & node0 = meshSource.nodes[face[k]];
+		const Node & node1 = meshSource.nodes[face[(k+1) % nEdges]];
+
+		bool fOnEdge;
+		if (face.edges[k].type == Edge::Type_ConstantLatitude) {
+			fOnEdge =
+				(fabs(node.z - node0.z) < OverlapStreamEdgeTolerance);
+
+		} else {
+			const Node nodeNormal = CrossProduct(node0, node1);
+			const Real dMag = nodeNormal.Magnitude();
+
+			fOnEdge = (dMag == 0.0) ||
+				(fabs(DotProduct(node, nodeNormal))
+					< OverlapStreamEdgeTolerance * dMag);
+		}
+
+		if (fOnEdge) {
+			ixLast = std::max(ixLast, vecSourceNodeLastFace[face[k]]);
+			ixLast = std::max(ixLast,
+				vecSourceNodeLastFace[face[(k+1) % nEdges]]);
+		}
+	}
+
+	return ixLast;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void GenerateOverlapMesh_Streamed(
+	const Mesh & meshSource,
+	const Mesh & meshTarget,
+	const std::string & strOverlapFile,
+	NcFile::FileFormat eFileFormat,
+	OverlapMeshMethod method,
+	const bool fAllowNoOverlap,
+	const double dMemoryBudgetMB,
+	const int nThreads,
+	const bool fReuseSeeds
+) {
+	if (nThreads < 1) {
+		_EXCEPTIONT("Thread count must be at least 1");
+	}
+	if (!(dMemoryBudgetMB > 0.0)) {
+		_EXCEPTION1("Memory budget (%1.2f MB) must be positive",
+			dMemoryBudgetMB);
+	}
+	if (method == OverlapMeshMethod_BVH) {
+		_EXCEPTIONT("Streamed overlap mesh generation does not support "
+			"the \"bvh\" method");
+	}
+
+	const int nSourceFaces = static_cast<int>(meshSource.faces.size());
+	const int nTargetFaces = static_cast<int>(meshTarget.faces.size());
+
+	// Create a KD tree over the first corner of each target face
+	NodeKDTree<int> treeTarget;
+	ConstructOverlapSeedKDTree(meshTarget, treeTarget);
+
+	// Last source face containing each source node
+	std::vector<int> vecSourceNodeLastFace(meshSource.nodes.size(), -1);
+	for (int f = 0; f < nSourceFaces; f++) {
+		const Face & face = meshSource.faces[f];
+		for (int k = 0; k < face.edges.size(); k++) {
+			vecSourceNodeLastFace[face[k]] = f;
+		}
+	}
+
+	OverlapMeshStreamWriter writer;
+	writer.Open(strOverlapFile, eFileFormat);
+
+	// Nodes that may be shared with source faces of later windows, with
+	// nodemapBoundary mapping each to its entry of vecBoundary
+	std::vector<OverlapStreamBoundaryNode> vecBoundary;
+
+#if defined(OVERLAPMESH_RETAIN_REPEATED_NODES)
+	NodeMap nodemapBoundary;
+#endif
+#if defined(OVERLAPMESH_USE_UNSORTED_MAP)
+	NodeMap nodemapBoundary;
+#endif
+#if defined(OVERLAPMESH_USE_NODE_MULTIMAP)
+	NodeMap nodemapBoundary(ReferenceTolerance, OVERLAPMESH_BIN_WIDTH);
+#endif
+#if defined(OVERLAPMESH_USE_NODE_HASH)
+	NodeMap nodemapBoundary(ReferenceTolerance, OVERLAPMESH_HASH_CELL_WIDTH);
+#endif
+
+	// Work done on each source face
+	std::vector<OverlapFaceProfile> vecFaceProfile;
+#if defined(OVERLAPMESH_INSTRUMENT)
+	vecFaceProfile.resize(nSourceFaces);
+#endif
+
+	const double dBudgetBytes = dMemoryBudgetMB * 1024.0 * 1024.0;
+
+	// Overlap faces per source face, initially estimated from the mesh
+	// sizes and then measured from the windows already processed
+	double dFacesPerSourceFace = 1.0;
+	if (nSourceFaces != 0) {
+		dFacesPerSourceFace =
+			static_cast<double>(nSourceFaces + nTargetFaces)
+				/ static_cast<double>(nSourceFaces);
+	}
+
+	bool fBudgetWarning = false;
+
+	// Process windows of contiguous source faces sized to fit the budget
+	for (int ixBegin = 0; ixBegin < nSourceFaces;) {
+
+		const double dAvailableBytes =
+			dBudgetBytes - OverlapStreamBytesPerBoundaryNode
+				* static_cast<double>(vecBoundary.size());
+
+		double dWindowFaces =
+			dAvailableBytes / (OverlapStreamBytesPerFace * dFacesPerSourceFace);
+
+		if (dWindowFaces < static_cast<double>(OverlapMeshChunkSize)) {
+			dWindowFaces = static_cast<double>(OverlapMeshChunkSize);
+
+			if (!fBudgetWarning) {
+				Announce("WARNING: Memory budget (%1.2f MB) is too small; "
+					"using windows of %i source faces",
+					dMemoryBudgetMB, OverlapMeshChunkSize);
+				fBudgetWarning = true;
+			}
+		}
+
+		const int ixEnd =
+			static_cast<int>(std::min(
+				static_cast<double>(ixBegin) + dWindowFaces,
+				static_cast<double>(nSourceFaces)));
+
+		char szWindow[128];
+		snprintf(szWindow, sizeof(szWindow),
+			"Source faces [%i, %i)", ixBegin, ixEnd);
+		AnnounceStartBlock(szWindow);
+
+		// Generate the overlap mesh of this window in memory
+		Mesh meshWindow;
+
+#if defined(OVERLAPMESH_RETAIN_REPEATED_NODES)
+		NodeMap nodemapWindow;
+#endif
+#if defined(OVERLAPMESH_USE_UNSORTED_MAP)
+		NodeMap nodemapWindow;
+#endif
+#if defined(OVERLAPMESH_USE_NODE_MULTIMAP)
+		NodeMap nodemapWindow(ReferenceTolerance, OVERLAPMESH_BIN_WIDTH);
+#endif
+#if defined(OVERLAPMESH_USE_NODE_HASH)
+		NodeMap nodemapWindow(ReferenceTolerance, OVERLAPMESH_HASH_CELL_WIDTH);
+#endif
+
+		std::vector<double> vecWindowFaceArea;
+
+		GenerateOverlapMeshRange(
+			meshSource,
+			meshTarget,
+			treeTarget,
+			ixBegin,
+			ixEnd,
+			meshWindow,
+			nodemapWindow,
+			vecWindowFaceArea,
+			method,
+			fAllowNoOverlap,
+			nThreads,
+			fReuseSeeds,
+			vecFaceProfile);
+
+		const int nWindowFaces = static_cast<int>(meshWindow.faces.size());
+
+#if defined(OVERLAPMESH_RETAIN_REPEATED_NODES)
+		// Nodes are never identified, so every node is written as is
+		std::vector<int> vecLocalToGlobal(meshWindow.nodes.size());
+		for (int i = 0; i < meshWindow.nodes.size(); i++) {
+			vecLocalToGlobal[i] = writer.AddNode(meshWindow.nodes[i]);
+		}
+#else
+		meshWindow.nodes.resize(nodemapWindow.size());
+
+		NodeMapConstIterator iter = nodemapWindow.begin();
+		for (; iter != nodemapWindow.end(); iter++) {
+			meshWindow.nodes[iter->second] = iter->first;
+		}
+		nodemapWindow.clear();
+
+		const int nWindowNodes = static_cast<int>(meshWindow.nodes.size());
+
+		// Source face of the first overlap face containing each node
+		std::vector<int> vecNodeSourceFace(nWindowNodes, -1);
+		for (int f = 0; f < nWindowFaces; f++) {
+			const Face & face = meshWindow.faces[f];
+			for (int k = 0; k < face.edges.size(); k++) {
+				if (vecNodeSourceFace[face[k]] == -1) {
+					vecNodeSourceFace[face[k]] =
+						meshWindow.vecSourceFaceIx[f];
+				}
+			}
+		}
+
+		// Last source face that may share each node
+		std::vector<int> vecNodeLastFace(nWindowNodes, -1);
+
+#pragma omp parallel for schedule(static) num_threads(nThreads)
+		for (int i = 0; i < nWindowNodes; i++) {
+			if (vecNodeSourceFace[i] != -1) {
+				vecNodeLastFace[i] =
+					OverlapNodeLastSourceFace(
+						meshSource,
+						vecSourceNodeLastFace,
+						vecNodeSourceFace[i],
+						meshWindow.nodes[i]);
+			}
+		}
+
+		// Assign output indices in the order nodes were first used, which
+		// matches the numbering of GenerateOverlapMesh_v2.  Nodes on the
+		// edges of source faces are identified with nodes of previous
+		// windows and kept if later windows may share them.
+		std::vector<int> vecLocalToGlobal(nWindowNodes);
+		for (int i = 0; i < nWindowNodes; i++) {
+			const Node & node = meshWindow.nodes[i];
+
+			if (vecNodeLastFace[i] < 0) {
+				vecLocalToGlobal[i] = writer.AddNode(node);
+				continue;
+			}
+
+			NodeMapConstIterator iterBoundary = nodemapBoundary.find(node);
+			if (iterBoundary != nodemapBoundary.end()) {
+				vecLocalToGlobal[i] = vecBoundary[iterBoundary->second].ix;
+
+				// The node may now be shared beyond its previous last face
+				int & ixLast = vecBoundary[iterBoundary->second].ixLastSourceFace;
+				ixLast = std::max(ixLast, vecNodeLastFace[i]);
+				continue;
+			}
+
+			vecLocalToGlobal[i] = writer.AddNode(node);
+
+			if (vecNodeLastFace[i] >= ixEnd) {
+				OverlapStreamBoundaryNode boundary;
+				boundary.node = node;
+				boundary.ix = vecLocalToGlobal[i];
+				boundary.ixLastSourceFace = vecNodeLastFace[i];
+
+				nodemapBoundary.insert(
+					NodeMapPair(node, static_cast<int>(vecBoundary.size())));
+				vecBoundary.push_back(boundary);
+			}
+		}
+#endif
+
+		// Append faces in order, replacing parent indices if either mesh
+		// has a MultiFaceMap
+		for (int f = 0; f < nWindowFaces; f++) {
+			const Face & faceWindow = meshWindow.faces[f];
+
+			Face faceNew(faceWindow.edges.size());
+			for (int k = 0; k < faceWindow.edges.size(); k++) {
+				faceNew.SetNode(k, vecLocalToGlobal[faceWindow[k]]);
+				faceNew.edges[k].type = faceWindow.edges[k].type;
+			}
+
+			int ixSourceFace = meshWindow.vecSourceFaceIx[f];
+			if (meshSource.vecMultiFaceMap.size() != 0) {
+				ixSourceFace = meshSource.vecMultiFaceMap[ixSourceFace];
+			}
+
+			int ixTargetFace = meshWindow.vecTargetFaceIx[f];
+			if (meshTarget.vecMultiFaceMap.size() != 0) {
+				ixTargetFace = meshTarget.vecMultiFaceMap[ixTargetFace];
+			}
+
+			writer.AddFace(
+				faceNew, ixSourceFace, ixTargetFace, vecWindowFaceArea[f]);
+		}
+
+#if !defined(OVERLAPMESH_RETAIN_REPEATED_NODES)
+		// Retire boundary nodes that no later source face may share
+		{
+			size_t sKept = 0;
+			for (size_t i = 0; i < vecBoundary.size(); i++) {
+				if (vecBoundary[i].ixLastSourceFace >= ixEnd) {
+					vecBoundary[sKept++] = vecBoundary[i];
+				}
+			}
+
+			if (sKept != vecBoundary.size()) {
+				vecBoundary.resize(sKept);
+				std::vector<OverlapStreamBoundaryNode>(vecBoundary).swap(vecBoundary);
+
+				nodemapBoundary.clear();
+				for (size_t i = 0; i < vecBoundary.size(); i++) {
+					nodemapBoundary.insert(
+						NodeMapPair(vecBoundary[i].node, static_cast<int>(i)));
+				}
+			}
+		}
+#endif
+
+		Announce("%i overlap faces, %i nodes written; %i nodes held",
+			writer.GetFaceCount(),
+			writer.GetNodeCount(),
+			static_cast<int>(vecBoundary.size()));
+		AnnounceEndBlock(NULL);
+
+		// Resize the next window from the faces generated so far
+		dFacesPerSourceFace =
+			std::max(1.0,
+				static_cast<double>(writer.GetFaceCount())
+					/ static_cast<double>(ixEnd));
+
+		ixBegin = ixEnd;
+	}
+
+#if defined(OVERLAPMESH_INSTRUMENT)
+	ReportOverlapFaceProfile(vecFaceProfile, 0, nSourceFaces);
+#endif
+
+	const double dTotalAreaOverlap = writer.GetTotalArea();
+
+	AnnounceStartBlock("Writing overlap mesh");
+	writer.Close();
+	AnnounceEndBlock(NULL);
+
+	Announce("Overlap Mesh Geometric Area: %1.15e (%1.15e)", dTotalAreaOverlap, 4.0 * M_PI);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Number of source faces generated between opportunities to write a
+///		checkpoint, per thread.
+///	</summary>
+static const int OverlapCheckpointFacesPerThread = 4 * OverlapMeshChunkSize;
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Get the number of Nodes of an overlap mesh under construction.
+///	</summary>
+static int OverlapNodeCount(
+	const Mesh & meshOverlap,
+	const NodeMap & nodemapOverlap
+) {
+#if defined(OVERLAPMESH_RETAIN_REPEATED_NODES)
+	return static_cast<int>(meshOverlap.nodes.size());
+#else
+	return static_cast<int>(nodemapOverlap.size());
+#endif
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Append a checkpoint record of the overlap faces generated from
+///		source faces [ixSourceBegin, ixSourceEnd), which begin at overlap
+///		face ixFaceBegin and introduce the Nodes from index nNodesBegin.
+///	</summary>
+static void WriteOverlapCheckpointRecord(
+	CheckpointFile & checkpoint,
+	const Mesh & meshOverlap,
+	const NodeMap & nodemapOverlap,
+	const std::vector<double> & vecOverlapFaceArea,
+	int ixSourceBegin,
+	int ixSourceEnd,
+	int ixFaceBegin,
+	int nNodesBegin
+) {
+	const int nNodesEnd = OverlapNodeCount(meshOverlap, nodemapOverlap);
+	const int nFacesEnd = static_cast<int>(meshOverlap.faces.size());
+
+	// Nodes introduced by these source faces, in index order
+	NodeVector nodesNew(nNodesEnd - nNodesBegin);
+#if defined(OVERLAPMESH_RETAIN_REPEATED_NODES)
+	for (int i = nNodesBegin; i < nNodesEnd; i++) {
+		nodesNew[i - nNodesBegin] = meshOverlap.nodes[i];
+	}
+#else
+	NodeMapConstIterator iter = nodemapOverlap.begin();
+	for (; iter != nodemapOverlap.end(); iter++) {
+		if (iter->second >= nNodesBegin) {
+			nodesNew[iter->second - nNodesBegin] = iter->first;
+		}
+	}
+#endif
+
+	std::vector<char> vecRecord;
+	CheckpointFile::Put<int>(vecRecord, ixSourceBegin);
+	CheckpointFile::Put<int>(vecRecord, ixSourceEnd);
+	CheckpointFile::Put<int>(vecRecord, nNodesEnd - nNodesBegin);
+	CheckpointFile::Put<int>(vecRecord, nFacesEnd - ixFaceBegin);
+
+	for (int i = 0; i < nodesNew.size(); i++) {
+		CheckpointFile::Put<double>(vecRecord, nodesNew[i].x);
+		CheckpointFile::Put<double>(vecRecord, nodesNew[i].y);
+		CheckpointFile::Put<double>(vecRecord, nodesNew[i].z);
+	}
+
+	for (int f = ixFaceBegin; f < nFacesEnd; f++) {
+		const Face & face = meshOverlap.faces[f];
+
+		CheckpointFile::Put<int>(vecRecord, static_cast<int>(face.edges.size()));
+		for (int k = 0; k < face.edges.size(); k++) {
+			CheckpointFile::Put<int>(vecRecord, face[k]);
+			CheckpointFile::Put<int>(vecRecord, static_cast<int>(face.edges[k].type));
+		}
+		CheckpointFile::Put<int>(vecRecord, meshOverlap.vecSourceFaceIx[f]);
+		CheckpointFile::Put<int>(vecRecord, meshOverlap.vecTargetFaceIx[f]);
+		CheckpointFile::Put<double>(vecRecord, vecOverlapFaceArea[f]);
+	}
+
+	checkpoint.WriteRecord(vecRecord);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Restore the overlap faces and Nodes of a checkpoint record written
+///		by WriteOverlapCheckpointRecord().  Returns the end of the range of
+///		source faces covered by the record.
+///	</summary>
+static int ReadOverlapCheckpointRecord(
+	const std::vector<char> & vecRecord,
+	int ixSourceBegin,
+	Mesh & meshOverlap,
+	NodeMap & nodemapOverlap,
+	std::vector<double> & vecOverlapFaceArea
+) {
+	size_t sPos = 0;
+
+	const int ixRecordBegin = CheckpointFile::Get<int>(vecRecord, sPos);
+	const int ixRecordEnd = CheckpointFile::Get<int>(vecRecord, sPos);
+	const int nNewNodes = CheckpointFile::Get<int>(vecRecord, sPos);
+	const int nNewFaces = CheckpointFile::Get<int>(vecRecord, sPos);
+
+	if ((ixRecordBegin != ixSourceBegin) || (ixRecordEnd <= ixRecordBegin)) {
+		_EXCEPTION2("Checkpoint record for source faces beginning at %i "
+			"found where %i was expected", ixRecordBegin, ixSourceBegin);
+	}
+
+	int nNodes = OverlapNodeCount(meshOverlap, nodemapOverlap);
+
+	for (int i = 0; i < nNewNodes; i++) {
+		Node node;
+		node.x = CheckpointFile::Get<double>(vecRecord, sPos);
+		node.y = CheckpointFile::Get<double>(vecRecord, sPos);
+		node.z = CheckpointFile::Get<double>(vecRecord, sPos);
+
+#if defined(OVERLAPMESH_RETAIN_REPEATED_NODES)
+		meshOverlap.nodes.push_back(node);
+#else
+		nodemapOverlap.insert(NodeMapPair(node, nNodes));
+#endif
+		nNodes++;
+	}
+
+	if (OverlapNodeCount(meshOverlap, nodemapOverlap) != nNodes) {
+		_EXCEPTIONT("Checkpoint record contains coincident nodes");
+	}
+
+	for (int f = 0; f < nNewFaces; f++) {
+		const int nEdges = CheckpointFile::Get<int>(vecRecord, sPos);
+		if (nEdges < 3) {
+			_EXCEPTIONT("Checkpoint record contains an invalid face");
+		}
+
+		Face face(nEdges);
+		for (int k = 0; k < nEdges; k++) {
+			const int ixNode = CheckpointFile::Get<int>(vecRecord, sPos);
+			if ((ixNode < 0) || (ixNode >= nNodes)) {
+				_EXCEPTIONT("Checkpoint record contains an invalid node index");
+			}
+			face.SetNode(k, ixNode);
+			face.edges[k].type =
+				static_cast<Edge::Type>(CheckpointFile::Get<int>(vecRecord, sPos));
+		}
+		meshOverlap.faces.push_back(face);
+
+		meshOverlap.vecSourceFaceIx.push_back(
+			CheckpointFile::Get<int>(vecRecord, sPos));
+		meshOverlap.vecTargetFaceIx.push_back(
+			CheckpointFile::Get<int>(vecRecord, sPos));
+		vecOverlapFaceArea.push_back(
+			CheckpointFile::Get<double>(vecRecord, sPos));
+	}
+
+	if (sPos != vecRecord.size()) {
+		_EXCEPTIONT("Checkpoint record has trailing data");
+	}
+
+	return ixRecordEnd;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void GenerateOverlapMesh_Checkpointed(
+	const Mesh & meshSource,
+	const Mesh & meshTarget,
+	Mesh & meshOverlap,
+	OverlapMeshMethod method,
+	const bool fAllowNoOverlap,
+	const std::string & strCheckpointFile,
+	const bool fRestart,
+	const double dCheckpointInterval,
+	const int nThreads,
+	const bool fReuseSeeds
+) {
+	if (nThreads < 1) {
+		_EXCEPTIONT("Thread count must be at least 1");
+	}
+	if (method == OverlapMeshMethod_BVH) {
+		_EXCEPTIONT("Checkpointed overlap mesh generation does not support "
+			"the \"bvh\" method");
+	}
+
+	const int nSourceFaces = static_cast<int>(meshSource.faces.size());
+
+	// The key identifies the contents of the meshes and the method of
+	// the checkpoint
+	char szKey[256];
+	snprintf(szKey, sizeof(szKey),
+		"overlap method=%i source=%016llx target=%016llx",
+		static_cast<int>(method),
+		meshSource.CalculateContentHash(),
+		meshTarget.CalculateContentHash());
+
+	CheckpointFile checkpoint;
+	checkpoint.Open(strCheckpointFile, szKey, fRestart, dCheckpointInterval);
+
+	// Create a KD tree over the first corner of each target face
+	NodeKDTree<int> treeTarget;
+	ConstructOverlapSeedKDTree(meshTarget, treeTarget);
+
+#if defined(OVERLAPMESH_RETAIN_REPEATED_NODES)
+	NodeMap nodemapOverlap;
+#endif
+#if defined(OVERLAPMESH_USE_UNSORTED_MAP)
+	NodeMap nodemapOverlap;
+#endif
+#if defined(OVERLAPMESH_USE_NODE_MULTIMAP)
+	NodeMap nodemapOverlap(ReferenceTolerance, OVERLAPMESH_BIN_WIDTH);
+#endif
+#if defined(OVERLAPMESH_USE_NODE_HASH)
+	NodeMap nodemapOverlap(ReferenceTolerance, OVERLAPMESH_HASH_CELL_WIDTH);
+#endif
+
+	std::vector<double> vecOverlapFaceArea;
+
+	std::vector<OverlapFaceProfile> vecFaceProfile;
+#if defined(OVERLAPMESH_INSTRUMENT)
+	vecFaceProfile.resize(nSourceFaces);
+#endif
+
+	// Restore the source faces completed before a restart
+	int ixSourceBegin = 0;
+
+	std::vector<char> vecRecord;
+	while (checkpoint.ReadRecord(vecRecord)) {
+		ixSourceBegin =
+			ReadOverlapCheckpointRecord(
+				vecRecord,
+				ixSourceBegin,
+				meshOverlap,
+				nodemapOverlap,
+				vecOverlapFaceArea);
+	}
+
+	if (ixSourceBegin > nSourceFaces) {
+		_EXCEPTIONT("Checkpoint file covers more source faces than the "
+			"source mesh");
+	}
+	if (ixSourceBegin != 0) {
+		Announce("Restarting from source face %i (%i overlap faces)",
+			ixSourceBegin, static_cast<int>(meshOverlap.faces.size()));
+	}
+
+	// Generate the remaining source faces in windows, since the overlap
+	// mesh of a range of source faces does not depend on how the range is
+	// divided, and checkpoint every window completed since the last
+	// checkpoint once the interval has passed
+	const int nWindowFaces = OverlapCheckpointFacesPerThread * nThreads;
+
+	int ixCheckpointSource = ixSourceBegin;
+	int ixCheckpointFace = static_cast<int>(meshOverlap.faces.size());
+	int nCheckpointNodes = OverlapNodeCount(meshOverlap, nodemapOverlap);
+
+	for (int ix = ixSourceBegin; ix < nSourceFaces; ix += nWindowFaces) {
+		const int ixEnd = std::min(ix + nWindowFaces, nSourceFaces);
+
+		GenerateOverlapMeshRange(
+			meshSource,
+			meshTarget,
+			treeTarget,
+			ix,
+			ixEnd,
+			meshOverlap,
+			nodemapOverlap,
+			vecOverlapFaceArea,
+			method,
+			fAllowNoOverlap,
+			nThreads,
+			fReuseSeeds,
+			vecFaceProfile);
+
+		if ((ixEnd < nSourceFaces) && checkpoint.IsDue()) {
+			WriteOverlapCheckpointRecord(
+				checkpoint,
+				meshOverlap,
+				nodemapOverlap,
+				vecOverlapFaceArea,
+				ixCheckpointSource,
+				ixEnd,
+				ixCheckpointFace,
+				nCheckpointNodes);
+
+			Announce("Checkpoint written at source face %i", ixEnd);
+
+			ixCheckpointSource = ixEnd;
+			ixCheckpointFace = static_cast<int>(meshOverlap.faces.size());
+			nCheckpointNodes = OverlapNodeCount(meshOverlap, nodemapOverlap);
+		}
+	}
+
+#if defined(OVERLAPMESH_INSTRUMENT)
+	ReportOverlapFaceProfile(vecFaceProfile, ixSourceBegin, nSourceFaces);
+#endif
+
+	double dTotalAreaOverlap =
+		FinalizeOverlapMesh(
+			meshSource, meshTarget, meshOverlap, nodemapOverlap,
+			vecOverlapFaceArea, nThreads);
+
+	Announce("Overlap Mesh Geometric Area: %1.15e (%1.15e)", dTotalAreaOverlap, 4.0 * M_PI);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Angular padding added to the SphericalCap of each Face, so that
+///		faces that only touch are candidate pairs.
+///	</summary>
+static const double FaceCapPadding = 1.0e-8;
+
+///	<summary>
+///		Number of interior points of each constant latitude edge included
+///		in the SphericalCap of its Face.  Every point of the edge lies within half
+///		the spacing of the samples of one of them.
+///	</summary>
+static const int FaceCapLatitudeSamples = 7;
+
+///	<summary>
+///		Number of source faces whose candidate pairs are gathered and
+///		clipped together.
+///	</summary>
+static const int OverlapPairRoundFaces = 4096;
+
+///	<summary>
+///		Number of candidate pairs (or source faces when ordering) in each
+///		unit of work distributed cyclically over threads.
+///	</summary>
+static const int OverlapPairBlockSize = 256;
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Compute a SphericalCap containing every Face of mesh.  Faces whose
+///		vertices do not lie within a hemisphere are given a cap covering
+///		the sphere.
+///	</summary>
+static void ConstructFaceCaps(
+	const Mesh & mesh,
+	std::vector<SphericalCap> & vecCaps,
+	int nThreads
+) {
+	const int nFaces = static_cast<int>(mesh.faces.size());
+
+	vecCaps.resize(nFaces);
+
+#pragma omp parallel for schedule(static) num_threads(nThreads)
+	for (int f = 0; f < nFaces; f++) {
+		const Face & face = mesh.faces[f];
+		const int nEdges = static_cast<int>(face.edges.size());
+
+		SphericalCap & cap = vecCaps[f];
+
+		Node nodeSum(0.0, 0.0, 0.0);
+		for (int i = 0; i < nEdges; i++) {
+			nodeSum = nodeSum + mesh.nodes[face[i]];
+		}
+
+		const Real dMag = nodeSum.Magnitude();
+		if ((nEdges == 0) || (dMag < 1.0e-12)) {
+			cap.nodeCenter = (nEdges == 0)?(Node(0.0, 0.0, 1.0)):(mesh.nodes[face[0]]);
+			cap.dRadius = M_PI;
+			continue;
+		}
+
+		cap.nodeCenter = nodeSum / dMag;
+
+		// Smallest dot product of the center with a point of the face, and
+		// the distance from the sampled points to the rest of the boundary
+		double dMinDot = 1.0;
+		double dSampleGap = 0.0;
+		for (int i = 0; i < nEdges; i++) {
+			const Node & node0 = mesh.nodes[face[i]];
+			dMinDot = std::min(dMinDot, DotProduct(cap.nodeCenter, node0));
+
+			// Constant latitude edges bow away from the great circle arc
+			// through their endpoints, so points along them are included
+			if (face.edges[i].type != Edge::Type_ConstantLatitude) {
+				continue;
+			}
+
+			const Node & node1 = mesh.nodes[face[(i+1) % nEdges]];
+
+			const double dLon0 = atan2(node0.y, node0.x);
+			double dDeltaLon = atan2(node1.y, node1.x) - dLon0;
+			if (dDeltaLon > M_PI) {
+				dDeltaLon -= 2.0 * M_PI;
+			}
+			if (dDeltaLon < -M_PI) {
+				dDeltaLon += 2.0 * M_PI;
+			}
+
+			const double dR = sqrt(node0.x * node0.x + node0.y * node0.y);
+
+			dSampleGap = std::max(dSampleGap,
+				0.5 * dR * fabs(dDeltaLon)
+				/ static_cast<double>(FaceCapLatitudeSamples + 1));
+
+			for (int s = 1; s <= FaceCapLatitudeSamples; s++) {
+				const double dLon = dLon0 + dDeltaLon
+					* static_cast<double>(s)
+					/ static_cast<double>(FaceCapLatitudeSamples + 1);
+
+				Node nodeSample(dR * cos(dLon), dR * sin(dLon), node0.z);
+				dMinDot = std::min(dMinDot,
+					DotProduct(cap.nodeCenter, nodeSample));
+			}
+		}
+
+		// A cap of radius less than pi/2 containing the vertices of a face
+		// with great circle edges contains the face
+		if (dMinDot <= 0.0) {
+			cap.dRadius = M_PI;
+		} else {
+			cap.dRadius =
+				acos(std::min(dMinDot, 1.0)) + dSampleGap
+				+ FaceCapPadding;
+		}
+		if (cap.dRadius >= 0.5 * M_PI) {
+			cap.dRadius = M_PI;
+		}
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		The overlap polygon of one candidate pair, stored in the node
+///		buffer of the block of pairs that contains it.
+///	</summary>
+struct OverlapPairClip {
+
+	///	<summary>
+	///		Number of nodes of the overlap polygon (zero if the faces do
+	///		not overlap).
+	///	</summary>
+	int nNodes;
+
+	///	<summary>
+	///		Index of the first node of the polygon in the node buffer.
+	///	</summary>
+	int ixFirstNode;
+
+	///	<summary>
+	///		Area of the overlap polygon, if it has at least three nodes.
+	///	</summary>
+	double dArea;
+};
+
+///	<summary>
+///		An overlap face of a source face, in the order in which it is added
+///		to the overlap mesh.
+///	</summary>
+struct OverlapPairFace {
+
+	///	<summary>
+	///		Target face.
+	///	</summary>
+	int ixTargetFace;
+
+	///	<summary>
+	///		Number of nodes of the overlap face.
+	///	</summary>
+	int nNodes;
+
+	///	<summary>
+	///		First node of the overlap face, in the node buffer of its block
+	///		of candidate pairs.
+	///	</summary>
+	const Node * pNodes;
+
+	///	<summary>
+	///		Area of the overlap face.
+	///	</summary>
+	double dArea;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Compute the area of the polygon nodevecOutput of workspace.
+///	</summary>
+static double CalculateOverlapPolygonArea(
+	OverlapFaceWorkspace & workspace
+) {
+	const NodeVector & nodevecOutput = workspace.nodevecOutput;
+
+	Face & faceTemp = workspace.faceOutput;
+	faceTemp.edges.resize(nodevecOutput.size());
+	for (int i = 0; i < nodevecOutput.size(); i++) {
+		faceTemp.SetNode(i, i);
+	}
+
+	return CalculateFaceArea(faceTemp, nodevecOutput);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Run fWork(p, workspace) on threads p = 0, ..., nThreads-1, each with
+///		its own workspace, rethrowing the first Exception on the calling
+///		thread.
+///	</summary>
+template <typename WorkType>
+static void RunOverlapPairWork(
+	std::vector<OverlapFaceWorkspace> & vecWorkspace,
+	const int nThreads,
+	WorkType fWork
+) {
+	OmpExceptionCapture capture;
+
+#pragma omp parallel for schedule(static, 1) num_threads(nThreads)
+	for (int p = 0; p < nThreads; p++) {
+		capture.Run([&]() {
+			fWork(p, vecWorkspace[p]);
+		});
+	}
+
+	capture.Rethrow();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Generate the overlap faces of source faces [ixSourceFaceBegin,
+///		ixSourceFaceEnd) from candidate pairs of faces with intersecting
+///		bounding caps, appending them to meshOverlap in source face order.
+///		Candidate pairs are gathered from a SphericalCapTree over the target
+///		faces and clipped in bulk on nThreads threads.  If fOrderBySearch is
+///		true, the overlap faces of each source face are ordered by the
+///		breadth-first search of GenerateOverlapMeshFromFace, so the result
+///		is identical to GenerateOverlapMesh_v2; meshTarget must then have
+///		an EdgeMap.  Otherwise they are ordered by target face index and no
+///		connectivity of either mesh is used.
+///	</summary>
+static void GenerateOverlapMeshFromCandidates(
+	const Mesh & meshSource,
+	const Mesh & meshTarget,
+	int ixSourceFaceBegin,
+	int ixSourceFaceEnd,
+	Mesh & meshOverlap,
+	NodeMap & nodemapOverlap,
+	std::vector<double> & vecOverlapFaceArea,
+	const bool fAllowNoOverlap,
+	const int nThreads,
+	const bool fOrderBySearch
+) {
+	const int nTargetFaces = static_cast<int>(meshTarget.faces.size());
+
+	// Neighbors of each target face and KD tree used to find the first
+	// overlapping target face, as in GenerateOverlapMesh_v2
+	FaceNeighborTable faceneighborsLocal;
+	NodeKDTree<int> treeTarget;
+
+	const FaceNeighborTable & faceneighborsTarget =
+		(fOrderBySearch)
+		?(GetTargetFaceNeighbors(meshTarget, faceneighborsLocal, nThreads))
+		:(faceneighborsLocal);
+
+	if (fOrderBySearch) {
+		ConstructOverlapSeedKDTree(meshTarget, treeTarget);
+	}
+
+	// Bounding caps of all faces and a bounding volume hierarchy over the
+	// caps of the target faces
+	std::vector<SphericalCap> vecSourceCaps;
+	std::vector<SphericalCap> vecTargetCaps;
+	ConstructFaceCaps(meshSource, vecSourceCaps, nThreads);
+	ConstructFaceCaps(meshTarget, vecTargetCaps, nThreads);
+
+	SphericalCapTree treeTargetCaps(vecTargetCaps);
+
+	std::vector<OverlapFaceWorkspace> vecWorkspace(nThreads);
+
+	size_t sTotalPairs = 0;
+
+	for (int i0 = ixSourceFaceBegin; i0 < ixSourceFaceEnd; i0 += OverlapPairRoundFaces) {
+		const int i1 = std::min(i0 + OverlapPairRoundFaces, ixSourceFaceEnd);
+		const int nRoundFaces = i1 - i0;
+
+		Announce("Source Face %i", i0);
+
+		const int nFaceBlocks =
+			(nRoundFaces + OverlapPairBlockSize - 1) / OverlapPairBlockSize;
+
+		// Phase 1: candidate target faces of each source face, whose caps
+		// intersect the cap of the source face
+		std::vector< std::vector<int> > vecFaceCandidates(nRoundFaces);
+
+		RunOverlapPairWork(vecWorkspace, nThreads,
+			[&](int p, OverlapFaceWorkspace & workspace) {
+				for (int b = p; b < nFaceBlocks; b += nThreads) {
+					const int f1 = std::min(
+						(b + 1) * OverlapPairBlockSize, nRoundFaces);
+
+					for (int f = b * OverlapPairBlockSize; f < f1; f++) {
+						std::vector<int> & vecCandidates = vecFaceCandidates[f];
+
+						treeTargetCaps.FindIntersecting(
+							vecSourceCaps[i0 + f], vecCandidates);
+
+						std::sort(vecCandidates.begin(), vecCandidates.end());
+					}
+				}
+			});
+
+		// Flatten the candidate pairs in source face order
+		std::vector<size_t> vecFaceFirstPair(nRoundFaces + 1);
+		vecFaceFirstPair[0] = 0;
+		for (int f = 0; f < nRoundFaces; f++) {
+			vecFaceFirstPair[f+1] =
+				vecFaceFirstPair[f] + vecFaceCandidates[f].size();
+		}
+
+		const size_t sPairs = vecFaceFirstPair[nRoundFaces];
+
+		std::vector<int> vecPairSourceFace(sPairs);
+		std::vector<int> vecPairTargetFace(sPairs);
+		for (int f = 0; f < nRoundFaces; f++) {
+			for (size_t n = 0; n < vecFaceCandidates[f].size(); n++) {
+				vecPairSourceFace[vecFaceFirstPair[f] + n] = i0 + f;
+				vecPairTargetFace[vecFaceFirstPair[f] + n] =
+					vecFaceCandidates[f][n];
+			}
+			std::vector<int>().swap(vecFaceCandidates[f]);
+		}
+
+		sTotalPairs += sPairs;
+		AnnounceCount(s_iCounterOverlapPairs, sPairs);
+
+		// Phase 2: clip all candidate pairs
+		const size_t sPairBlocks =
+			(sPairs + OverlapPairBlockSize - 1) / OverlapPairBlockSize;
+
+		std::vector<OverlapPairClip> vecPairClip(sPairs);
+		std::vector<NodeVector> vecPairBlockNodes(sPairBlocks);
+
+		RunOverlapPairWork(vecWorkspace, nThreads,
+			[&](int p, OverlapFaceWorkspace & workspace) {
+				for (size_t b = p; b < sPairBlocks; b += nThreads) {
+					const size_t k1 = std::min(
+						(b + 1) * OverlapPairBlockSize, sPairs);
+
+					NodeVector & nodevecBlock = vecPairBlockNodes[b];
+
+					for (size_t k = b * OverlapPairBlockSize; k < k1; k++) {
+						GenerateOverlapFace<MeshUtilitiesFuzzy, Node>(
+							meshSource,
+							meshTarget,
+							vecPairSourceFace[k],
+							vecPairTargetFace[k],
+							workspace);
+
+						const NodeVector & nodevecOutput =
+							workspace.nodevecOutput;
+
+						OverlapPairClip & clip = vecPairClip[k];
+						clip.nNodes = static_cast<int>(nodevecOutput.size());
+						clip.ixFirstNode = static_cast<int>(nodevecBlock.size());
+						clip.dArea = 0.0;
+
+						if (nodevecOutput.size() >= 3) {
+							clip.dArea = CalculateOverlapPolygonArea(workspace);
+						}
+
+						nodevecBlock.insert(
+							nodevecBlock.end(),
+							nodevecOutput.begin(),
+							nodevecOutput.end());
+					}
+				}
+			});
+
+		// Phase 3: order the overlap faces of each source face
+		std::vector< std::vector<OverlapPairFace> > vecFaceOverlaps(nRoundFaces);
+		std::vector<char> vecFaceNoOverlap(nRoundFaces, 0);
+
+		RunOverlapPairWork(vecWorkspace, nThreads,
+			[&](int p, OverlapFaceWorkspace & workspace) {
+				for (int b = p; b < nFaceBlocks; b += nThreads) {
+					const int f1 = std::min(
+						(b + 1) * OverlapPairBlockSize, nRoundFaces);
+
+					for (int f = b * OverlapPairBlockSize; f < f1; f++) {
+						const int ixSourceFace = i0 + f;
+
+						std::vector<OverlapPairFace> & vecOverlaps =
+							vecFaceOverlaps[f];
+
+						// Candidates in order of target face index
+						if (!fOrderBySearch) {
+							for (size_t k = vecFaceFirstPair[f]; k < vecFaceFirstPair[f+1]; k++) {
+								const OverlapPairClip & clip = vecPairClip[k];
+
+								if (clip.nNodes == 0) {
+									continue;
+								}
+								if (clip.nNodes < 3) {
+									_EXCEPTIONT("Overlap polygon consists of "
+										"fewer than 3 nodes");
+								}
+								if (clip.dArea < 1.0e-13) {
+									continue;
+								}
+
+								OverlapPairFace face;
+								face.ixTargetFace = vecPairTargetFace[k];
+								face.nNodes = clip.nNodes;
+								face.pNodes =
+									&(vecPairBlockNodes[k / OverlapPairBlockSize]
+										[clip.ixFirstNode]);
+								face.dArea = clip.dArea;
+
+								vecOverlaps.push_back(face);
+							}
+
+							if (vecOverlaps.size() == 0) {
+								vecFaceNoOverlap[f] = 1;
+							}
+							continue;
+						}
+
+						// Candidates in the order of the breadth-first search
+						// of GenerateOverlapMesh_v2.  Target faces that are
+						// not candidates lie outside the cap of the source
+						// face and so do not overlap it.
+
+						const int ixTargetFaceSeed =
+							FindTargetFaceSeed(
+								meshSource, treeTarget, ixSourceFace);
+
+						const int ixFirstTargetFace =
+							FindFaceContainingNode<MeshUtilitiesFuzzy, Node>(
+								meshSource,
+								meshTarget,
+								ixSourceFace,
+								ixTargetFaceSeed,
+								faceneighborsTarget,
+								workspace);
+
+						if (ixFirstTargetFace == InvalidFace) {
+							vecFaceNoOverlap[f] = 1;
+							continue;
+						}
+
+						std::vector<int>::const_iterator iterCandBegin =
+							vecPairTargetFace.begin() + vecFaceFirstPair[f];
+						std::vector<int>::const_iterator iterCandEnd =
+							vecPairTargetFace.begin() + vecFaceFirstPair[f+1];
+
+						BeginTargetFaceSearch(workspace, nTargetFaces);
+						QueueTargetFace(workspace, ixFirstTargetFace);
+
+						for (size_t q = 0; q < workspace.vecTargetFaceQueue.size(); q++) {
+							const int ixTargetFace =
+								workspace.vecTargetFaceQueue[q];
+
+							std::vector<int>::const_iterator iterCand =
+								std::lower_bound(
+									iterCandBegin, iterCandEnd, ixTargetFace);
+
+							if ((iterCand == iterCandEnd) ||
+							    (*iterCand != ixTargetFace)
+							) {
+								continue;
+							}
+
+							const size_t k = iterCand - vecPairTargetFace.begin();
+							const OverlapPairClip & clip = vecPairClip[k];
+
+							if (clip.nNodes == 0) {
+								continue;
+							}
+							if (clip.nNodes < 3) {
+								_EXCEPTIONT("Overlap polygon consists of "
+									"fewer than 3 nodes");
+							}
+
+							// Add all neighboring Faces into the queue
+							const Face & faceTarget =
+								meshTarget.faces[ixTargetFace];
+
+							for (int i = 0; i < faceTarget.edges.size(); i++) {
+								int iPushFace =
+									faceneighborsTarget.GetNeighbor(
+										ixTargetFace, i);
+
+								if (iPushFace == InvalidFace) {
+									continue;
+								}
+
+								QueueTargetFace(workspace, iPushFace);
+							}
+
+							if (clip.dArea < 1.0e-13) {
+								continue;
+							}
+
+							OverlapPairFace face;
+							face.ixTargetFace = ixTargetFace;
+							face.nNodes = clip.nNodes;
+							face.pNodes =
+								&(vecPairBlockNodes[k / OverlapPairBlockSize]
+									[clip.ixFirstNode]);
+							face.dArea = clip.dArea;
+
+							vecOverlaps.push_back(face);
+						}
+					}
+				}
+			});
+
+		// Merge the overlap faces in source face order, assigning nodes as
+		// GenerateOverlapMeshFromFace does
+		for (int f = 0; f < nRoundFaces; f++) {
+			const int ixSourceFace = i0 + f;
+
+			if (vecFaceNoOverlap[f]) {
+				if (fAllowNoOverlap) {
+					Announce("WARNING: No overlapping face found");
+					continue;
+				}
+				Announce("ERROR: No overlapping face found");
+				Announce("This may be caused by mesh B being a subset of mesh A");
+				Announce("Try swapping order of mesh A and B, or override with --allow_no_overlap");
+				_EXCEPTIONT("Exiting");
+			}
+
+			const std::vector<OverlapPairFace> & vecOverlaps =
+				vecFaceOverlaps[f];
+
+			for (int n = 0; n < vecOverlaps.size(); n++) {
+				const OverlapPairFace & face = vecOverlaps[n];
+
+				const Node * pNodes = face.pNodes;
+
+				meshOverlap.faces.push_back(Face(face.nNodes));
+
+				Face & faceNew = meshOverlap.faces.back();
+				for (int i = 0; i < face.nNodes; i++) {
+#if defined(OVERLAPMESH_RETAIN_REPEATED_NODES)
+					faceNew.SetNode(i, meshOverlap.nodes.size());
+					meshOverlap.nodes.push_back(pNodes[i]);
+#else
+					NodeMapConstIterator iter = nodemapOverlap.find(pNodes[i]);
+
+					if (iter != nodemapOverlap.end()) {
+						faceNew.SetNode(i, iter->second);
+					} else {
+						int iNextNodeMapOverlapIx = nodemapOverlap.size();
+						faceNew.SetNode(i, iNextNodeMapOverlapIx);
+						nodemapOverlap.insert(
+							NodeMapPair(pNodes[i], iNextNodeMapOverlapIx));
+					}
+#endif
+				}
+
+				meshOverlap.vecSourceFaceIx.push_back(ixSourceFace);
+				meshOverlap.vecTargetFaceIx.push_back(face.ixTargetFace);
+
+				vecOverlapFaceArea.push_back(face.dArea);
+			}
+		}
+
+		AnnounceCount(s_iCounterOverlapSourceFaces, nRoundFaces);
+	}
+
+	AnnounceCount(s_iCounterOverlapFaces, meshOverlap.faces.size());
+
+	Announce("Clipped %lu candidate pairs", sTotalPairs);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void GenerateOverlapMesh_Pairs(
+	const Mesh & meshSource,
+	const Mesh & meshTarget,
+	Mesh & meshOverlap,
+	OverlapMeshMethod method,
+	const bool fAllowNoOverlap,
+	const int nThreads
+) {
+	if (nThreads < 1) {
+		_EXCEPTIONT("Thread count must be at least 1");
+	}
+
+	// Verify the EdgeMap exists in both meshSource and meshTarget
+	if (meshSource.edgemap.size() == 0) {
+		_EXCEPTIONT("EdgeMap in meshSource must be constructed prior"
+			" to GenerateOverlapMesh_Pairs");
+	}
+	if (meshTarget.edgemap.size() == 0) {
+		_EXCEPTIONT("EdgeMap in meshTarget must be constructed prior"
+			" to GenerateOverlapMesh_Pairs");
+	}
+
+	Announce("Generating overlap mesh from candidate pairs with %i threads",
+		nThreads);
+
+#if defined(OVERLAPMESH_RETAIN_REPEATED_NODES)
+	NodeMap nodemapOverlap;
+#endif
+#if defined(OVERLAPMESH_USE_UNSORTED_MAP)
+	NodeMap nodemapOverlap;
+#endif
+#if defined(OVERLAPMESH_USE_NODE_MULTIMAP)
+	NodeMap nodemapOverlap(ReferenceTolerance, OVERLAPMESH_BIN_WIDTH);
+#endif
+#if defined(OVERLAPMESH_USE_NODE_HASH)
+	NodeMap nodemapOverlap(ReferenceTolerance, OVERLAPMESH_HASH_CELL_WIDTH);
+#endif
+
+	std::vector<double> vecOverlapFaceArea;
+
+	GenerateOverlapMeshFromCandidates(
+		meshSource,
+		meshTarget,
+		0,
+		static_cast<int>(meshSource.faces.size()),
+		meshOverlap,
+		nodemapOverlap,
+		vecOverlapFaceArea,
+		fAllowNoOverlap,
+		nThreads,
+		true);
+
+	double dTotalAreaOverlap =
+		FinalizeOverlapMesh(
+			meshSource, meshTarget, meshOverlap, nodemapOverlap,
+			vecOverlapFaceArea, nThreads);
+
+	Announce("Overlap Mesh Geometric Area: %1.15e (%1.15e)", dTotalAreaOverlap, 4.0 * M_PI);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void GenerateOverlapMesh_BVH(
+	const Mesh & meshSource,
+	const Mesh & meshTarget,
+	Mesh & meshOverlap,
+	const bool fAllowNoOverlap,
+	const int nThreads
+) {
+	if (nThreads < 1) {
+		_EXCEPTIONT("Thread count must be at least 1");
+	}
+
+	Announce("Generating overlap mesh from a bounding volume hierarchy "
+		"with %i threads", nThreads);
+
+#if defined(OVERLAPMESH_RETAIN_REPEATED_NODES)
+	NodeMap nodemapOverlap;
+#endif
+#if defined(OVERLAPMESH_USE_UNSORTED_MAP)
+	NodeMap nodemapOverlap;
+#endif
+#if defined(OVERLAPMESH_USE_NODE_MULTIMAP)
+	NodeMap nodemapOverlap(ReferenceTolerance, OVERLAPMESH_BIN_WIDTH);
+#endif
+#if defined(OVERLAPMESH_USE_NODE_HASH)
+	NodeMap nodemapOverlap(ReferenceTolerance, OVERLAPMESH_HASH_CELL_WIDTH);
+#endif
+
+	std::vector<double> vecOverlapFaceArea;
+
+	GenerateOverlapMeshFromCandidates(
+		meshSource,
+		meshTarget,
+		0,
+		static_cast<int>(meshSource.faces.size()),
+		meshOverlap,
+		nodemapOverlap,
+		vecOverlapFaceArea,
+		fAllowNoOverlap,
+		nThreads,
+		false);
+
+	double dTotalAreaOverlap =
+		FinalizeOverlapMesh(
+			meshSource, meshTarget, meshOverlap, nodemapOverlap,
+			vecOverlapFaceArea, nThreads);
+
+	Announce("Overlap Mesh Geometric Area: %1.15e (%1.15e)", dTotalAreaOverlap, 4.0 * M_PI);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+#if defined(TEMPEST_MPIOMP)
+
+///	<summary>
+///		Tags of the messages used to gather the overlap mesh on the root
+///		processor.
+///	</summary>
+enum OverlapMeshMessageTag {
+	OverlapMeshMessageTag_Counts = 100,
+	OverlapMeshMessageTag_Nodes,
+	OverlapMeshMessageTag_Faces,
+	OverlapMeshMessageTag_Areas
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Pack the nodes and faces of an overlap mesh into flat buffers.  Each
+///		face is stored as its number of nodes, followed by its node indices,
+///		its source face index and its target face index.  The area of each
+///		face is stored in vecAreaData.
+///	</summary>
+static void PackOverlapMesh(
+	const Mesh & mesh,
+	const std::vector<double> & vecFaceArea,
+	std::vector<double> & vecNodeData,
+	std::vector<int> & vecFaceData,
+	std::vector<double> & vecAreaData
+) {
+	const size_t sMaxCount =
+		static_cast<size_t>(std::numeric_limits<int>::max());
+
+	size_t sFaceData = 0;
+	for (int f = 0; f < mesh.faces.size(); f++) {
+		sFaceData += mesh.faces[f].edges.size() + 3;
+	}
+
+	if ((3 * mesh.nodes.size() > sMaxCount) || (sFaceData > sMaxCount)) {
+		_EXCEPTION1("Overlap mesh on this processor is too large to send "
+			"(%lu faces); use more processors", mesh.faces.size());
+	}
+
+	vecNodeData.resize(3 * mesh.nodes.size());
+	for (int i = 0; i < mesh.nodes.size(); i++) {
+		vecNodeData[3*i  ] = mesh.nodes[i].x;
+		vecNodeData[3*i+1] = mesh.nodes[i].y;
+		vecNodeData[3*i+2] = mesh.nodes[i].z;
+	}
+
+	vecFaceData.clear();
+	vecFaceData.reserve(sFaceData);
+	for (int f = 0; f < mesh.faces.size(); f++) {
+		const Face & face = mesh.faces[f];
+
+		vecFaceData.push_back(static_cast<int>(face.edges.size()));
+		for (int i = 0; i < face.edges.size(); i++) {
+			vecFaceData.push_back(face[i]);
+		}
+		vecFaceData.push_back(mesh.vecSourceFaceIx[f]);
+		vecFaceData.push_back(mesh.vecTargetFaceIx[f]);
+	}
+
+	vecAreaData = vecFaceArea;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Unpack an overlap mesh from the buffers built by PackOverlapMesh.
+///	</summary>
+static void UnpackOverlapMesh(
+	const std::vector<double> & vecNodeData,
+	const std::vector<int> & vecFaceData,
+	const std::vector<double> & vecAreaData,
+	Mesh & mesh
+) {
+	mesh.nodes.resize(vecNodeData.size() / 3);
+	for (int i = 0; i < mesh.nodes.size(); i++) {
+		mesh.nodes[i] = Node(
+			vecNodeData[3*i  ],
+			vecNodeData[3*i+1],
+			vecNodeData[3*i+2]);
+	}
+
+	size_t ix = 0;
+	while (ix < vecFaceData.size()) {
+		const int nEdges = vecFaceData[ix++];
+
+		mesh.faces.push_back(Face(nEdges));
+
+		Face & face = mesh.faces.back();
+		for (int i = 0; i < nEdges; i++) {
+			face.SetNode(i, vecFaceData[ix++]);
+		}
+
+		mesh.vecSourceFaceIx.push_back(vecFaceData[ix++]);
+		mesh.vecTargetFaceIx.push_back(vecFaceData[ix++]);
+	}
+
+	if (vecAreaData.size() != mesh.faces.size()) {
+		_EXCEPTIONT("Overlap mesh face areas do not match faces");
+	}
+	mesh.vecFaceArea.Allocate(vecAreaData.size());
+	for (int f = 0; f < vecAreaData.size(); f++) {
+		mesh.vecFaceArea[f] = vecAreaData[f];
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void GenerateOverlapMesh_MPI(
+	const Mesh & meshSource,
+	const Mesh & meshTarget,
+	Mesh & meshOverlap,
+	OverlapMeshMethod method,
+	const bool fAllowNoOverlap,
+	const int nThreads,
+	MPI_Comm comm,
+	const bool fReuseSeeds
+) {
+	if (nThreads < 1) {
+		_EXCEPTIONT("Thread count must be at least 1");
+	}
+
+	int nRank;
+	int nSize;
+
+	MPI_Comm_rank(comm, &nRank);
+	MPI_Comm_size(comm, &nSize);
+
+	// Contiguous block of source faces assigned to this processor
+	const long long lSourceFaces =
+		static_cast<long long>(meshSource.faces.size());
+
+	const int ixSourceFaceBegin =
+		static_cast<int>(lSourceFaces * nRank / nSize);
+	const int ixSourceFaceEnd =
+		static_cast<int>(lSourceFaces * (nRank + 1) / nSize);
+
+	Announce("Generating overlap mesh on %i processors with %i threads each",
+		nSize, nThreads);
+
+#if defined(OVERLAPMESH_RETAIN_REPEATED_NODES)
+	NodeMap nodemapOverlap;
+#endif
+#if defined(OVERLAPMESH_USE_UNSORTED_MAP)
+	NodeMap nodemapOverlap;
+#endif
+#if defined(OVERLAPMESH_USE_NODE_MULTIMAP)
+	NodeMap nodemapOverlap(ReferenceTolerance, OVERLAPMESH_BIN_WIDTH);
+#endif
+#if defined(OVERLAPMESH_USE_NODE_HASH)
+	NodeMap nodemapOverlap(ReferenceTolerance, OVERLAPMESH_HASH_CELL_WIDTH);
+#endif
+
+	// Generate the overlap mesh associated with the local block.  The
+	// root processor builds directly into meshOverlap; all other
+	// processors pack their block for sending to the root.
+	std::vector<double> vecNodeData;
+	std::vector<int> vecFaceData;
+	std::vector<double> vecAreaData;
+
+	// Area of each overlap face, computed as the face is generated
+	std::vector<double> vecOverlapFaceArea;
+
+	int iLocalError = 0;
+	std::string strError;
+
+	try {
+		NodeKDTree<int> treeTarget;
+		ConstructOverlapSeedKDTree(meshTarget, treeTarget);
+
+		std::vector<OverlapFaceProfile> vecFaceProfile;
+#if defined(OVERLAPMESH_INSTRUMENT)
+		vecFaceProfile.resize(meshSource.faces.size());
+#endif
+
+		if (method == OverlapMeshMethod_BVH) {
+			GenerateOverlapMeshFromCandidates(
+				meshSource,
+				meshTarget,
+				ixSourceFaceBegin,
+				ixSourceFaceEnd,
+				meshOverlap,
+				nodemapOverlap,
+				vecOverlapFaceArea,
+				fAllowNoOverlap,
+				nThreads,
+				false);
+
+		} else {
+			GenerateOverlapMeshRange(
+				meshSource,
+				meshTarget,
+				treeTarget,
+				ixSourceFaceBegin,
+				ixSourceFaceEnd,
+				meshOverlap,
+				nodemapOverlap,
+				vecOverlapFaceArea,
+				method,
+				fAllowNoOverlap,
+				nThreads,
+				fReuseSeeds,
+				vecFaceProfile);
+		}
+
+#if defined(OVERLAPMESH_INSTRUMENT)
+		// Only the profile of the block on the root processor is announced
+		ReportOverlapFaceProfile(
+			vecFaceProfile, ixSourceFaceBegin, ixSourceFaceEnd);
+#endif
+
+		if (nRank != 0) {
+#if !defined(OVERLAPMESH_RETAIN_REPEATED_NODES)
+			meshOverlap.nodes.resize(nodemapOverlap.size());
+
+			NodeMapConstIterator iter = nodemapOverlap.begin();
+			for (; iter != nodemapOverlap.end(); iter++) {
+				meshOverlap.nodes[iter->second] = iter->first;
+			}
+#endif
+			PackOverlapMesh(
+				meshOverlap, vecOverlapFaceArea,
+				vecNodeData, vecFaceData, vecAreaData);
+
+			meshOverlap.nodes.clear();
+			meshOverlap.faces.clear();
+			meshOverlap.vecSourceFaceIx.clear();
+			meshOverlap.vecTargetFaceIx.clear();
+			nodemapOverlap.clear();
+			vecOverlapFaceArea.clear();
+		}
+
+	} catch(Exception & e) {
+		iLocalError = 1;
+		strError = e.ToString();
+
+	} catch(...) {
+		iLocalError = 1;
+		strError = "Unknown exception";
+	}
+
+	// Fail on all processors together, rather than leaving the root
+	// waiting on a processor that will never send
+	int iGlobalError;
+	MPI_Allreduce(&iLocalError, &iGlobalError, 1, MPI_INT, MPI_MAX, comm);
+
+	if (iGlobalError) {
+		if (iLocalError) {
+			_EXCEPTION1("%s", strError.c_str());
+		}
+		_EXCEPTIONT("Overlap mesh generation failed on another processor");
+	}
+
+	// Send the local block to the root processor
+	if (nRank != 0) {
+		int nCounts[3];
+		nCounts[0] = static_cast<int>(vecNodeData.size());
+		nCounts[1] = static_cast<int>(vecFaceData.size());
+		nCounts[2] = static_cast<int>(vecAreaData.size());
+
+		MPI_Send(nCounts, 3, MPI_INT,
+			0, OverlapMeshMessageTag_Counts, comm);
+		MPI_Send(vecNodeData.data(), nCounts[0], MPI_DOUBLE,
+			0, OverlapMeshMessageTag_Nodes, comm);
+		MPI_Send(vecFaceData.data(), nCounts[1], MPI_INT,
+			0, OverlapMeshMessageTag_Faces, comm);
+		MPI_Send(vecAreaData.data(), nCounts[2], MPI_DOUBLE,
+			0, OverlapMeshMessageTag_Areas, comm);
+
+		return;
+	}
+
+	// Merge blocks on the root in processor order, which is source face
+	// order, so the overlap mesh matches the one built by a single process
+	for (int p = 1; p < nSize; p++) {
+		int nCounts[3];
+
+		MPI_Recv(nCounts, 3, MPI_INT,
+			p, OverlapMeshMessageTag_Counts, comm, MPI_STATUS_IGNORE);
+
+		vecNodeData.resize(nCounts[0]);
+		vecFaceData.resize(nCounts[1]);
+		vecAreaData.resize(nCounts[2]);
+
+		MPI_Recv(vecNodeData.data(), nCounts[0], MPI_DOUBLE,
+			p, OverlapMeshMessageTag_Nodes, comm, MPI_STATUS_IGNORE);
+		MPI_Recv(vecFaceData.data(), nCounts[1], MPI_INT,
+			p, OverlapMeshMessageTag_Faces, comm, MPI_STATUS_IGNORE);
+		MPI_Recv(vecAreaData.data(), nCounts[2], MPI_DOUBLE,
+			p, OverlapMeshMessageTag_Areas, comm, MPI_STATUS_IGNORE);
+
+		Mesh meshBlock;
+		UnpackOverlapMesh(vecNodeData, vecFaceData, vecAreaData, meshBlock);
+
+		MergeOverlapMeshChunk(
+			meshBlock, meshOverlap, nodemapOverlap, vecOverlapFaceArea);
+	}
+
+	double dTotalAreaOverlap =
+		FinalizeOverlapMesh(
+			meshSource, meshTarget, meshOverlap, nodemapOverlap,
+			vecOverlapFaceArea, nThreads);
+
+	Announce("Overlap Mesh Geometric Area: %1.15e (%1.15e)", dTotalAreaOverlap, 4.0 * M_PI);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+#endif
@@ -20,16 +20,25 @@
 #include "Defines.h"
 
 #include "GridElements.h"
+#include "NodeKDTree.h"
+
+#if defined(TEMPEST_MPIOMP)
+#include <mpi.h>
+#endif
 
 ///////////////////////////////////////////////////////////////////////////////
 
 ///	<summary>
-///		Method to use to generate overlap mesh
+///		Method to use to generate overlap mesh.  OverlapMeshMethod_BVH
+///		clips candidate pairs found with a bounding volume hierarchy over
+///		the target faces, and so supports meshes with holes or disconnected
+///		pieces.
 ///	</summary>
 enum OverlapMeshMethod {
 	OverlapMeshMethod_Fuzzy,
 	OverlapMeshMethod_Exact,
-	OverlapMeshMethod_Mixed
+	OverlapMeshMethod_Mixed,
+	OverlapMeshMethod_BVH
 };
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -48,6 +57,127 @@ void GenerateOverlapMesh_v1(
 
 ///////////////////////////////////////////////////////////////////////////////
 
+///	<summary>
+///		Work done while generating the overlap faces of one source face,
+///		recorded when OVERLAPMESH_INSTRUMENT is defined.
+///	</summary>
+struct OverlapFaceProfile {
+
+	///	<summary>
+	///		Constructor.
+	///	</summary>
+	OverlapFaceProfile() :
+		nTargetFacesVisited(0),
+		nSeedFacesVisited(0),
+		nSeedTreeQueries(0),
+		nEdgeIntersections(0),
+		nNodeMapHits(0),
+		nNodeMapMisses(0),
+		dTime(0.0)
+	{ }
+
+	///	<summary>
+	///		Target faces clipped against the source face.
+	///	</summary>
+	int nTargetFacesVisited;
+
+	///	<summary>
+	///		Target faces searched to find the first overlapping target face.
+	///		A value greater than one indicates the seed from the KD tree did
+	///		not contain the first corner of the source face.
+	///	</summary>
+	int nSeedFacesVisited;
+
+	///	<summary>
+	///		Queries of the KD tree for a seed target face.  Zero when the
+	///		seed was reused from the previous source face.
+	///	</summary>
+	int nSeedTreeQueries;
+
+	///	<summary>
+	///		Edge intersections computed while clipping.
+	///	</summary>
+	int nEdgeIntersections;
+
+	///	<summary>
+	///		Overlap nodes found in and inserted into the NodeMap.  With more
+	///		than one thread this is the NodeMap of the chunk of source faces.
+	///	</summary>
+	int nNodeMapHits;
+	int nNodeMapMisses;
+
+	///	<summary>
+	///		Wall time (in seconds).
+	///	</summary>
+	double dTime;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Scratch buffers used while clipping overlap polygons.  Buffers are
+///		cleared but never released between uses, so after the first few
+///		Faces polygon construction no longer allocates from the heap.  A
+///		workspace must not be shared between threads.
+///	</summary>
+struct OverlapFaceWorkspace {
+
+	///	<summary>
+	///		Constructor.
+	///	</summary>
+	OverlapFaceWorkspace() :
+		uTargetFaceGeneration(0)
+	{ }
+
+	///	<summary>
+	///		Overlap polygon produced by GenerateOverlapFace.
+	///	</summary>
+	NodeVector nodevecOutput;
+
+	///	<summary>
+	///		Polygon from the previous clipping stage.
+	///	</summary>
+	NodeVector nodevecInput;
+
+	///	<summary>
+	///		Intersections of a polygon edge with a clipping edge.
+	///	</summary>
+	std::vector<Node> vecIntersections;
+
+	///	<summary>
+	///		Face referencing nodevecOutput, used to compute its area.
+	///	</summary>
+	Face faceOutput;
+
+	///	<summary>
+	///		Generation at which each target Face was last visited by a
+	///		breadth-first search, so that the visited set of a new search is
+	///		emptied by incrementing uTargetFaceGeneration.
+	///	</summary>
+	std::vector<unsigned int> vecTargetFaceVisited;
+
+	///	<summary>
+	///		Generation of the current breadth-first search.
+	///	</summary>
+	unsigned int uTargetFaceGeneration;
+
+	///	<summary>
+	///		Queue of target Faces of the current breadth-first search.  Each
+	///		Face is queued at most once per search, so the queue is a vector
+	///		consumed from a moving head and never wrapped.
+	///	</summary>
+	std::vector<int> vecTargetFaceQueue;
+
+#if defined(OVERLAPMESH_INSTRUMENT)
+	///	<summary>
+	///		Work done on the current source face.
+	///	</summary>
+	OverlapFaceProfile profile;
+#endif
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
 ///	<summary>
 ///		Compute the overlap polygon between two Faces.
 ///	</summary>
@@ -63,11 +193,47 @@ void GenerateOverlapFace(
     NodeVector & nodevecOutput
 );
 
+///	<summary>
+///		Compute the overlap polygon between two Faces, storing the result
+///		in workspace.nodevecOutput and using the other buffers of the
+///		workspace for temporaries.
+///	</summary>
+template <
+	class MeshUtilities,
+	class NodeIntersectType
+>
+void GenerateOverlapFace(
+	const Mesh & meshSource,
+	const Mesh & meshTarget,
+	int iSourceFace,
+	int iTargetFace,
+	OverlapFaceWorkspace & workspace
+);
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Build the KD tree over the first corner of each face of meshTarget
+///		that is used to seed the overlap search from each source face.
+///	</summary>
+void ConstructOverlapSeedKDTree(
+	const Mesh & meshTarget,
+	NodeKDTree<int> & treeTarget
+);
+
 ///////////////////////////////////////////////////////////////////////////////
 
 ///	<summary>
 ///		Generate the mesh obtained by overlapping meshes meshSource and
-///		meshTarget.
+///		meshTarget.  With nThreads > 1 source faces are processed in
+///		parallel and merged in source face order, so faces and nodes are
+///		ordered as in the serial result independent of the thread count.
+///		If fReuseSeeds is true the search from each source face is seeded
+///		from the first overlapping target face of the previous source
+///		face, and the KD tree is only queried if that search fails.  This
+///		is effective when consecutive source faces are neighbors, as in
+///		structured meshes or meshes reordered with Mesh::ReorderFaces().
+///		The overlap mesh is unchanged.
 ///	</summary>
 void GenerateOverlapMesh_v2(
 	const Mesh & meshSource,
@@ -75,10 +241,146 @@ void GenerateOverlapMesh_v2(
 	Mesh & meshOverlap,
     OverlapMeshMethod method,
 	const bool fAllowNoOverlap,
-    const bool verbose = true
+    const bool verbose = true,
+	const int nThreads = 1,
+	const bool fReuseSeeds = false
 );
 
 ///////////////////////////////////////////////////////////////////////////////
 
+///	<summary>
+///		As above, using a KD tree over meshTarget that was built with
+///		ConstructOverlapSeedKDTree(), so that the tree can be reused when
+///		many source meshes are overlapped with the same target mesh.
+///	</summary>
+void GenerateOverlapMesh_v2(
+	const Mesh & meshSource,
+	const Mesh & meshTarget,
+	const NodeKDTree<int> & treeTarget,
+	Mesh & meshOverlap,
+    OverlapMeshMethod method,
+	const bool fAllowNoOverlap,
+    const bool verbose = true,
+	const int nThreads = 1,
+	const bool fReuseSeeds = false
+);
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Generate the overlap mesh of meshSource and meshTarget and write it
+///		to strOverlapFile without holding it in memory.  Source faces are
+///		processed in windows of contiguous faces sized so that each window
+///		fits within dMemoryBudgetMB, and the overlap faces of each window
+///		are spooled to disk as it completes.  Only nodes on the edges of
+///		source faces that may be shared with later windows are held
+///		between windows.  Windows are spatially coherent if consecutive
+///		source faces are neighbors, as after Mesh::ReorderFaces(), which
+///		minimizes the nodes held.  The file is identical in content to
+///		that written from the result of GenerateOverlapMesh_v2.
+///	</summary>
+void GenerateOverlapMesh_Streamed(
+	const Mesh & meshSource,
+	const Mesh & meshTarget,
+	const std::string & strOverlapFile,
+	NcFile::FileFormat eFileFormat,
+	OverlapMeshMethod method,
+	const bool fAllowNoOverlap,
+	const double dMemoryBudgetMB,
+	const int nThreads = 1,
+	const bool fReuseSeeds = false
+);
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Generate the overlap mesh of meshSource and meshTarget as in
+///		GenerateOverlapMesh_v2, recording completed ranges of source faces
+///		in strCheckpointFile at most every dCheckpointInterval seconds.  If
+///		fRestart is true generation resumes after the last range recorded
+///		in strCheckpointFile, and meshOverlap is identical to the result of
+///		an uninterrupted run.  The checkpoint file is left in place and
+///		should be removed once the overlap mesh has been written.
+///	</summary>
+void GenerateOverlapMesh_Checkpointed(
+	const Mesh & meshSource,
+	const Mesh & meshTarget,
+	Mesh & meshOverlap,
+	OverlapMeshMethod method,
+	const bool fAllowNoOverlap,
+	const std::string & strCheckpointFile,
+	const bool fRestart,
+	const double dCheckpointInterval,
+	const int nThreads = 1,
+	const bool fReuseSeeds = false
+);
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Generate the overlap mesh of meshSource and meshTarget in bulk.
+///		Target faces whose bounding caps intersect the cap of each source
+///		face are first gathered as candidate pairs, all candidate pairs are
+///		then clipped in blocks on nThreads threads, and the resulting
+///		polygons are finally compacted into meshOverlap.  Faces, nodes,
+///		vecSourceFaceIx and vecTargetFaceIx are identical to the result of
+///		GenerateOverlapMesh_v2.
+///	</summary>
+void GenerateOverlapMesh_Pairs(
+	const Mesh & meshSource,
+	const Mesh & meshTarget,
+	Mesh & meshOverlap,
+	OverlapMeshMethod method,
+	const bool fAllowNoOverlap,
+	const int nThreads = 1
+);
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Generate the overlap mesh of meshSource and meshTarget by clipping
+///		each source face against the target faces whose bounding caps
+///		intersect its own, found with a bounding volume hierarchy.  No
+///		seeds, EdgeMap or face neighbors are needed, so either mesh may
+///		have holes or disconnected pieces.  Overlap faces are ordered by
+///		source face and then by target face, independent of nThreads.
+///		Source faces with no overlap are an error unless fAllowNoOverlap.
+///		GenerateOverlapMesh_v2 calls this function for OverlapMeshMethod_BVH.
+///	</summary>
+void GenerateOverlapMesh_BVH(
+	const Mesh & meshSource,
+	const Mesh & meshTarget,
+	Mesh & meshOverlap,
+	const bool fAllowNoOverlap,
+	const int nThreads = 1
+);
+
+///////////////////////////////////////////////////////////////////////////////
+
+#if defined(TEMPEST_MPIOMP)
+///	<summary>
+///		Generate the overlap mesh of meshSource and meshTarget across all
+///		processors of comm.  Every processor must hold both meshes in full.
+///		Source faces are divided into one contiguous block per processor,
+///		each block is overlapped with nThreads threads, and the blocks are
+///		merged on the root processor in source face order.  On return
+///		meshOverlap is populated on the root processor only, where it is
+///		identical to the result of GenerateOverlapMesh_v2.  fReuseSeeds
+///		is as in GenerateOverlapMesh_v2.
+///	</summary>
+void GenerateOverlapMesh_MPI(
+	const Mesh & meshSource,
+	const Mesh & meshTarget,
+	Mesh & meshOverlap,
+	OverlapMeshMethod method,
+	const bool fAllowNoOverlap,
+	const int nThreads,
+	MPI_Comm comm,
+	const bool fReuseSeeds = false
+);
+
+///////////////////////////////////////////////////////////////////////////////
+#endif
+
 #endif
 
@@ -0,0 +1,596 @@
+///////////////////////////////////////////////////////////////////////////////
+///
+///	\file    OverlapMeshStreamWriter.cpp
+///	\author  agent
+///	\version October 15, 2026
+///
+///	<remarks>
+///		Copyright 2026 agent
+///
+///		This file is distributed as part of the Tempest source code package.
+///		Permission is granted to use, copy, modify and distribute this
+///		source code and its documentation under the terms of the GNU General
+///		Public License.  This software is provided "as is" without express
+///		or implied warranty.
+///	</remarks>
+
+#include "OverlapMeshStreamWriter.h"
+#include "Announce.h"
+#include "Exception.h"
+
+#include <cstring>
+#include <ctime>
+#include <vector>
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Number of Faces of each block, or Nodes, buffered before they are
+///		written to the Exodus file.
+///	</summary>
+static const int StreamWriteChunkSize = 65536;
+
+///	<summary>
+///		Size of the stdio buffer of each spool file.
+///	</summary>
+static const size_t StreamSpoolBufferSize = 1 << 20;
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Write sBytes bytes to a spool file.
+///	</summary>
+static void WriteSpool(
+	FILE * fp,
+	const void * pData,
+	size_t sBytes
+) {
+	if (fwrite(pData, 1, sBytes, fp) != sBytes) {
+		_EXCEPTIONT("Unable to write to overlap mesh spool file");
+	}
+}
+
+///	<summary>
+///		Read sBytes bytes from a spool file.
+///	</summary>
+static void ReadSpool(
+	FILE * fp,
+	void * pData,
+	size_t sBytes
+) {
+	if (fread(pData, 1, sBytes, fp) != sBytes) {
+		_EXCEPTIONT("Unable to read from overlap mesh spool file");
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+OverlapMeshStreamWriter::OverlapMeshStreamWriter() :
+	m_eFileFormat(NcFile::Classic),
+	m_fpNodes(NULL),
+	m_fpFaces(NULL),
+	m_nNodes(0),
+	m_nFaces(0),
+	m_dTotalArea(0.0)
+{ }
+
+///////////////////////////////////////////////////////////////////////////////
+
+OverlapMeshStreamWriter::~OverlapMeshStreamWriter() {
+	RemoveSpools();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void OverlapMeshStreamWriter::RemoveSpools() {
+	if (m_fpNodes != NULL) {
+		fclose(m_fpNodes);
+		m_fpNodes = NULL;
+		remove(m_strNodeSpool.c_str());
+	}
+	if (m_fpFaces != NULL) {
+		fclose(m_fpFaces);
+		m_fpFaces = NULL;
+		remove(m_strFaceSpool.c_str());
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void OverlapMeshStreamWriter::Open(
+	const std::string & strFile,
+	NcFile::FileFormat eFileFormat
+) {
+	RemoveSpools();
+
+	m_strFile = strFile;
+	m_eFileFormat = eFileFormat;
+
+	m_nNodes = 0;
+	m_nFaces = 0;
+	m_mapBlockSizes.clear();
+	m_dTotalArea = 0.0;
+
+	// Spools are placed alongside the output file, which is expected to
+	// be on a file system with room for the overlap mesh
+	m_strNodeSpool = strFile + ".nodes.spool";
+	m_strFaceSpool = strFile + ".faces.spool";
+
+	m_fpNodes = fopen(m_strNodeSpool.c_str(), "w+b");
+	if (m_fpNodes == NULL) {
+		_EXCEPTION1("Unable to open spool file \"%s\"",
+			m_strNodeSpool.c_str());
+	}
+	m_fpFaces = fopen(m_strFaceSpool.c_str(), "w+b");
+	if (m_fpFaces == NULL) {
+		RemoveSpools();
+		_EXCEPTION1("Unable to open spool file \"%s\"",
+			m_strFaceSpool.c_str());
+	}
+
+	setvbuf(m_fpNodes, NULL, _IOFBF, StreamSpoolBufferSize);
+	setvbuf(m_fpFaces, NULL, _IOFBF, StreamSpoolBufferSize);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+int OverlapMeshStreamWriter::AddNode(
+	const Node & node
+) {
+	if (m_fpNodes == NULL) {
+		_EXCEPTIONT("OverlapMeshStreamWriter is not open");
+	}
+
+	double dXYZ[3];
+	dXYZ[0] = static_cast<double>(node.x);
+	dXYZ[1] = static_cast<double>(node.y);
+	dXYZ[2] = static_cast<double>(node.z);
+
+	WriteSpool(m_fpNodes, dXYZ, sizeof(dXYZ));
+
+	return (m_nNodes++);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void OverlapMeshStreamWriter::AddFace(
+	const Face & face,
+	int ixSourceFace,
+	int ixTargetFace,
+	double dArea
+) {
+	if (m_fpFaces == NULL) {
+		_EXCEPTIONT("OverlapMeshStreamWriter is not open");
+	}
+
+	const int nEdges = static_cast<int>(face.edges.size());
+
+	std::vector<int> vecData(2 * nEdges + 3);
+	vecData[0] = nEdges;
+	for (int k = 0; k < nEdges; k++) {
+		if ((face[k] < 0) || (face[k] >= m_nNodes)) {
+			_EXCEPTION2("Face node index (%i) out of range [0, %i)",
+				face[k], m_nNodes);
+		}
+		vecData[1 + k] = face[k];
+		vecData[1 + nEdges + k] = static_cast<int>(face.edges[k].type);
+	}
+	vecData[2 * nEdges + 1] = ixSourceFace;
+	vecData[2 * nEdges + 2] = ixTargetFace;
+
+	WriteSpool(m_fpFaces, &(vecData[0]), vecData.size() * sizeof(int));
+	WriteSpool(m_fpFaces, &dArea, sizeof(double));
+
+	m_mapBlockSizes[nEdges]++;
+	m_nFaces++;
+	m_dTotalArea += dArea;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void OverlapMeshStreamWriter::Close() {
+	const int ParamFour = 4;
+	const int ParamLenString = 33;
+
+	if ((m_fpNodes == NULL) || (m_fpFaces == NULL)) {
+		_EXCEPTIONT("OverlapMeshStreamWriter is not open");
+	}
+
+	if ((fflush(m_fpNodes) != 0) || (fflush(m_fpFaces) != 0)) {
+		_EXCEPTIONT("Unable to write to overlap mesh spool file");
+	}
+	rewind(m_fpNodes);
+	rewind(m_fpFaces);
+
+	// Temporarily change error reporting
+	NcError error_temp(NcError::verbose_fatal);
+
+	// Block sizes and the block of each Face size
+	const int nBlocks = static_cast<int>(m_mapBlockSizes.size());
+
+	std::vector<int> vecBlockSizes;
+	std::vector<int> vecBlockSizeFaces;
+	std::map<int, int> mapBlockIndex;
+	{
+		AnnounceStartBlock("Nodes per element");
+		std::map<int, int>::const_iterator iter = m_mapBlockSizes.begin();
+		for (; iter != m_mapBlockSizes.end(); iter++) {
+			mapBlockIndex[iter->first] = vecBlockSizes.size();
+			vecBlockSizes.push_back(iter->first);
+			vecBlockSizeFaces.push_back(iter->second);
+
+			Announce("Block %i (%i nodes): %i",
+				static_cast<int>(vecBlockSizes.size()),
+				iter->first, iter->second);
+		}
+		AnnounceEndBlock(NULL);
+	}
+
+	// Output to a NetCDF Exodus file
+	NcFile ncOut(m_strFile.c_str(), NcFile::Replace, NULL, 0, m_eFileFormat);
+	if (!ncOut.is_valid()) {
+		_EXCEPTION1("Unable to open grid file \"%s\" for writing",
+			m_strFile.c_str());
+	}
+
+	// All variables are defined before any data is written, so that the
+	// header of a classic format file is never resized
+
+	// Auxiliary Exodus dimensions
+	NcDim * dimLenString = ncOut.add_dim("len_string", ParamLenString);
+	ncOut.add_dim("len_line", 81);
+	NcDim * dimFour = ncOut.add_dim("four", ParamFour);
+	NcDim * dimTime = ncOut.add_dim("time_step");
+	NcDim * dimDimension = ncOut.add_dim("num_dim", 3);
+	NcDim * dimNodes = ncOut.add_dim("num_nodes", m_nNodes);
+	ncOut.add_dim("num_elem", m_nFaces);
+	NcDim * dimNumQARec = ncOut.add_dim("num_qa_rec", 1);
+
+	// Global attributes
+	ncOut.add_att("api_version", 5.00f);
+	ncOut.add_att("version", 5.00f);
+	ncOut.add_att("floating_point_word_size", 8);
+	ncOut.add_att("file_size", 0);
+
+	// Current time
+	char szDate[ParamLenString];
+	char szTime[ParamLenString];
+	{
+		time_t t = time(0);
+		struct tm * timestruct = localtime(&t);
+
+		strftime(szDate, sizeof(szDate), "%m/%d/%Y", timestruct);
+		strftime(szTime, sizeof(szTime), "%X", timestruct);
+
+		char szTitle[128];
+		snprintf(szTitle, sizeof(szTitle), "tempest(%s) %s: %s",
+			m_strFile.c_str(), szDate, szTime);
+		ncOut.add_att("title", szTitle);
+	}
+
+	// Time_whole (unused)
+	NcVar * varTimeWhole = ncOut.add_var("time_whole", ncDouble, dimTime);
+	if (varTimeWhole == NULL) {
+		_EXCEPTIONT("Error creating variable \"time_whole\"");
+	}
+
+	// QA records
+	NcVar * varQARecords =
+		ncOut.add_var("qa_records", ncChar,
+			dimNumQARec, dimFour, dimLenString);
+
+	if (varQARecords == NULL) {
+		_EXCEPTIONT("Error creating variable \"qa_records\"");
+	}
+
+	// Coordinate names
+	NcVar * varCoordNames =
+		ncOut.add_var("coor_names", ncChar, dimDimension, dimLenString);
+
+	if (varCoordNames == NULL) {
+		_EXCEPTIONT("Error creating variable \"coor_names\"");
+	}
+
+	// Element blocks
+	NcDim * dimNumElementBlocks = ncOut.add_dim("num_el_blk", nBlocks);
+	if (dimNumElementBlocks == NULL) {
+		_EXCEPTIONT("Error creating dimension \"num_el_blk\"");
+	}
+
+	std::vector<NcDim *> vecElementBlockDim(nBlocks);
+	std::vector<NcDim *> vecNodesPerElementDim(nBlocks);
+	std::vector<NcDim *> vecAttBlockDim(nBlocks);
+
+	char szBuffer[ParamLenString];
+	for (int n = 0; n < nBlocks; n++) {
+		snprintf(szBuffer, sizeof(szBuffer), "num_el_in_blk%i", n+1);
+		vecElementBlockDim[n] = ncOut.add_dim(szBuffer, vecBlockSizeFaces[n]);
+		if (vecElementBlockDim[n] == NULL) {
+			_EXCEPTION1("Error creating dimension \"%s\"", szBuffer);
+		}
+
+		snprintf(szBuffer, sizeof(szBuffer), "num_nod_per_el%i", n+1);
+		vecNodesPerElementDim[n] = ncOut.add_dim(szBuffer, vecBlockSizes[n]);
+		if (vecNodesPerElementDim[n] == NULL) {
+			_EXCEPTION1("Error creating dimension \"%s\"", szBuffer);
+		}
+
+		snprintf(szBuffer, sizeof(szBuffer), "num_att_in_blk%i", n+1);
+		vecAttBlockDim[n] = ncOut.add_dim(szBuffer, 1);
+		if (vecAttBlockDim[n] == NULL) {
+			_EXCEPTION1("Error creating dimension \"%s\"", szBuffer);
+		}
+	}
+
+	// Element block names, status and property
+	NcVar * varElementBlockNames =
+		ncOut.add_var("eb_names", ncChar, dimNumElementBlocks, dimLenString);
+	if (varElementBlockNames == NULL) {
+		_EXCEPTIONT("Error creating dimension \"eb_names\"");
+	}
+
+	NcVar * varElementBlockStatus =
+		ncOut.add_var("eb_status", ncInt, dimNumElementBlocks);
+	if (varElementBlockStatus == NULL) {
+		_EXCEPTIONT("Error creating variable \"eb_status\"");
+	}
+
+	NcVar * varElementProperty =
+		ncOut.add_var("eb_prop1", ncInt, dimNumElementBlocks);
+	if (varElementProperty == NULL) {
+		_EXCEPTIONT("Error creating variable \"eb_prop1\"");
+	}
+	varElementProperty->add_att("name", "ID");
+
+	// Face-specific variables
+	std::vector<NcVar *> vecAttribVar(nBlocks);
+	std::vector<NcVar *> vecConnectVar(nBlocks);
+	std::vector<NcVar *> vecGlobalIdVar(nBlocks);
+	std::vector<NcVar *> vecEdgeTypeVar(nBlocks);
+	std::vector<NcVar *> vecFaceParentAVar(nBlocks);
+	std::vector<NcVar *> vecFaceParentBVar(nBlocks);
+	std::vector<NcVar *> vecFaceAreaVar(nBlocks);
+
+	for (int n = 0; n < nBlocks; n++) {
+		snprintf(szBuffer, sizeof(szBuffer), "attrib%i", n+1);
+		vecAttribVar[n] =
+			ncOut.add_var(szBuffer, ncDouble,
+				vecElementBlockDim[n], vecAttBlockDim[n]);
+		if (vecAttribVar[n] == NULL) {
+			_EXCEPTION1("Error creating variable \"%s\"", szBuffer);
+		}
+
+		snprintf(szBuffer, sizeof(szBuffer), "connect%i", n+1);
+		vecConnectVar[n] =
+			ncOut.add_var(szBuffer, ncInt,
+				vecElementBlockDim[n], vecNodesPerElementDim[n]);
+		if (vecConnectVar[n] == NULL) {
+			_EXCEPTION1("Error creating variable \"%s\"", szBuffer);
+		}
+
+		char szConnectAttrib[ParamLenString];
+		snprintf(szConnectAttrib, sizeof(szConnectAttrib),
+			"SHELL%i", vecBlockSizes[n]);
+		vecConnectVar[n]->add_att("elem_type", szConnectAttrib);
+
+		snprintf(szBuffer, sizeof(szBuffer), "global_id%i", n+1);
+		vecGlobalIdVar[n] =
+			ncOut.add_var(szBuffer, ncInt, vecElementBlockDim[n]);
+		if (vecGlobalIdVar[n] == NULL) {
+			_EXCEPTION1("Error creating variable \"%s\"", szBuffer);
+		}
+
+		snprintf(szBuffer, sizeof(szBuffer), "edge_type%i", n+1);
+		vecEdgeTypeVar[n] =
+			ncOut.add_var(szBuffer, ncInt,
+				vecElementBlockDim[n], vecNodesPerElementDim[n]);
+		if (vecEdgeTypeVar[n] == NULL) {
+			_EXCEPTION1("Error creating variable \"%s\"", szBuffer);
+		}
+
+		snprintf(szBuffer, sizeof(szBuffer), "el_parent_a%i", n+1);
+		vecFaceParentAVar[n] =
+			ncOut.add_var(szBuffer, ncInt, vecElementBlockDim[n]);
+		if (vecFaceParentAVar[n] == NULL) {
+			_EXCEPTION1("Error creating variable \"%s\"", szBuffer);
+		}
+
+		snprintf(szBuffer, sizeof(szBuffer), "el_parent_b%i", n+1);
+		vecFaceParentBVar[n] =
+			ncOut.add_var(szBuffer, ncInt, vecElementBlockDim[n]);
+		if (vecFaceParentBVar[n] == NULL) {
+			_EXCEPTION1("Error creating variable \"%s\"", szBuffer);
+		}
+
+		snprintf(szBuffer, sizeof(szBuffer), "el_area%i", n+1);
+		vecFaceAreaVar[n] =
+			ncOut.add_var(szBuffer, ncDouble, vecElementBlockDim[n]);
+		if (vecFaceAreaVar[n] == NULL) {
+			_EXCEPTION1("Error creating variable \"%s\"", szBuffer);
+		}
+	}
+
+	// Node list
+	NcVar * varNodes =
+		ncOut.add_var("coord", ncDouble, dimDimension, dimNodes);
+	if (varNodes == NULL) {
+		_EXCEPTIONT("Error creating variable \"coord\"");
+	}
+
+	// Header data
+	{
+		char szQARecord[ParamFour][ParamLenString]
+			= {"Tempest", "14.0", "", ""};
+
+		strcpy(szQARecord[2], szDate);
+		strcpy(szQARecord[3], szTime);
+
+		varQARecords->set_cur(0, 0, 0);
+		varQARecords->put(&(szQARecord[0][0]), 1, 4, ParamLenString);
+
+		char szCoordNames[3][ParamLenString] = {"x", "y", "z"};
+
+		varCoordNames->set_cur(0, 0, 0);
+		varCoordNames->put(&(szCoordNames[0][0]), 3, ParamLenString);
+	}
+
+	if (nBlocks != 0) {
+		std::vector<int> vecStatus(nBlocks, 1);
+		std::vector<int> vecProp(nBlocks);
+		for (int n = 0; n < nBlocks; n++) {
+			vecProp[n] = n+1;
+		}
+
+		varElementBlockStatus->put(&(vecStatus[0]), nBlocks);
+		varElementProperty->put(&(vecProp[0]), nBlocks);
+	}
+
+	// Attributes
+	{
+		std::vector<double> dAttrib(StreamWriteChunkSize, 1.0);
+
+		for (int n = 0; n < nBlocks; n++) {
+			for (int i = 0; i < vecBlockSizeFaces[n]; i += StreamWriteChunkSize) {
+				const int nChunk =
+					std::min(StreamWriteChunkSize, vecBlockSizeFaces[n] - i);
+
+				vecAttribVar[n]->set_cur((long)i);
+				vecAttribVar[n]->put(&(dAttrib[0]), nChunk);
+			}
+		}
+	}
+
+	// Faces, buffered per block and written whenever a buffer fills
+	{
+		std::vector< std::vector<int> > vecConnect(nBlocks);
+		std::vector< std::vector<int> > vecEdgeType(nBlocks);
+		std::vector< std::vector<int> > vecGlobalId(nBlocks);
+		std::vector< std::vector<int> > vecFaceParentA(nBlocks);
+		std::vector< std::vector<int> > vecFaceParentB(nBlocks);
+		std::vector< std::vector<double> > vecFaceArea(nBlocks);
+
+		// Faces of each block written and buffered
+		std::vector<int> vecBlockWritten(nBlocks, 0);
+		std::vector<int> vecBlockBuffered(nBlocks, 0);
+
+		for (int n = 0; n < nBlocks; n++) {
+			const int nChunkMax =
+				std::min(vecBlockSizeFaces[n], StreamWriteChunkSize);
+
+			vecConnect[n].resize(nChunkMax * vecBlockSizes[n]);
+			vecEdgeType[n].resize(nChunkMax * vecBlockSizes[n]);
+			vecGlobalId[n].resize(nChunkMax);
+			vecFaceParentA[n].resize(nChunkMax);
+			vecFaceParentB[n].resize(nChunkMax);
+			vecFaceArea[n].resize(nChunkMax);
+		}
+
+		// Write the buffered faces of block m
+		auto WriteBlock = [&](int m) {
+			const int nChunk = vecBlockBuffered[m];
+			const long lBegin = (long)vecBlockWritten[m];
+
+			vecConnectVar[m]->set_cur(lBegin, 0);
+			vecConnectVar[m]->put(
+				&(vecConnect[m][0]), nChunk, vecBlockSizes[m]);
+
+			vecGlobalIdVar[m]->set_cur(lBegin);
+			vecGlobalIdVar[m]->put(&(vecGlobalId[m][0]), nChunk);
+
+			vecEdgeTypeVar[m]->set_cur(lBegin, 0);
+			vecEdgeTypeVar[m]->put(
+				&(vecEdgeType[m][0]), nChunk, vecBlockSizes[m]);
+
+			vecFaceParentAVar[m]->set_cur(lBegin);
+			vecFaceParentAVar[m]->put(&(vecFaceParentA[m][0]), nChunk);
+
+			vecFaceParentBVar[m]->set_cur(lBegin);
+			vecFaceParentBVar[m]->put(&(vecFaceParentB[m][0]), nChunk);
+
+			vecFaceAreaVar[m]->set_cur(lBegin);
+			vecFaceAreaVar[m]->put(&(vecFaceArea[m][0]), nChunk);
+
+			vecBlockWritten[m] += nChunk;
+			vecBlockBuffered[m] = 0;
+		};
+
+		std::vector<int> vecData;
+
+		for (int i = 0; i < m_nFaces; i++) {
+			int nEdges;
+			ReadSpool(m_fpFaces, &nEdges, sizeof(int));
+
+			std::map<int, int>::const_iterator iterBlock =
+				mapBlockIndex.find(nEdges);
+			if (iterBlock == mapBlockIndex.end()) {
+				_EXCEPTION1("Invalid face size (%i) in spool file", nEdges);
+			}
+
+			const int n = iterBlock->second;
+			const int j = vecBlockBuffered[n];
+
+			vecData.resize(2 * nEdges + 2);
+			ReadSpool(m_fpFaces, &(vecData[0]), vecData.size() * sizeof(int));
+
+			for (int k = 0; k < nEdges; k++) {
+				vecConnect[n][j * nEdges + k] = vecData[k] + 1;
+				vecEdgeType[n][j * nEdges + k] = vecData[nEdges + k];
+			}
+			vecGlobalId[n][j] = i + 1;
+			vecFaceParentA[n][j] = vecData[2 * nEdges] + 1;
+			vecFaceParentB[n][j] = vecData[2 * nEdges + 1] + 1;
+
+			ReadSpool(m_fpFaces, &(vecFaceArea[n][j]), sizeof(double));
+
+			vecBlockBuffered[n]++;
+
+			if (vecBlockBuffered[n] == vecFaceArea[n].size()) {
+				WriteBlock(n);
+			}
+		}
+
+		for (int n = 0; n < nBlocks; n++) {
+			if (vecBlockBuffered[n] != 0) {
+				WriteBlock(n);
+			}
+		}
+
+		for (int n = 0; n < nBlocks; n++) {
+			if (vecBlockWritten[n] != vecBlockSizeFaces[n]) {
+				_EXCEPTION3("Block %i has %i faces in spool file, "
+					"expected %i", n+1, vecBlockWritten[n],
+					vecBlockSizeFaces[n]);
+			}
+		}
+	}
+
+	// Nodes
+	{
+		const int nChunkMax = std::min(m_nNodes, StreamWriteChunkSize);
+
+		std::vector<double> dXYZ(3 * nChunkMax);
+		std::vector<double> dCoord(nChunkMax);
+
+		for (int iBegin = 0; iBegin < m_nNodes; iBegin += StreamWriteChunkSize) {
+			const int nChunk = std::min(StreamWriteChunkSize, m_nNodes - iBegin);
+
+			ReadSpool(m_fpNodes, &(dXYZ[0]), 3 * nChunk * sizeof(double));
+
+			for (int d = 0; d < 3; d++) {
+				for (int j = 0; j < nChunk; j++) {
+					dCoord[j] = dXYZ[3 * j + d];
+				}
+
+				varNodes->set_cur((long)d, (long)iBegin);
+				varNodes->put(&(dCoord[0]), 1, nChunk);
+			}
+		}
+	}
+
+	ncOut.close();
+
+	RemoveSpools();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
@@ -0,0 +1,170 @@
+///////////////////////////////////////////////////////////////////////////////
+///
+///	\file    OverlapMeshStreamWriter.h
+///	\author  agent
+///	\version October 15, 2026
+///
+///	<remarks>
+///		Copyright 2026 agent
+///
+///		This file is distributed as part of the Tempest source code package.
+///		Permission is granted to use, copy, modify and distribute this
+///		source code and its documentation under the terms of the GNU General
+///		Public License.  This software is provided "as is" without express
+///		or implied warranty.
+///	</remarks>
+
+#ifndef _OVERLAPMESHSTREAMWRITER_H_
+#define _OVERLAPMESHSTREAMWRITER_H_
+
+#include "GridElements.h"
+#include "netcdfcpp.h"
+
+#include <cstdio>
+#include <map>
+#include <string>
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		A writer for overlap meshes that do not fit in memory.  Nodes and
+///		Faces are appended one at a time to binary spool files alongside
+///		the output file, and Close() writes the Exodus file in the layout
+///		of Mesh::Write() in a single pass over each spool.  Only the count
+///		of Faces of each size is held in memory.
+///	</summary>
+///	<remarks>
+///		Exodus element blocks group Faces by their number of nodes and
+///		need their sizes when they are defined, so Faces cannot be
+///		appended to the Exodus file directly along an unlimited dimension.
+///	</remarks>
+class OverlapMeshStreamWriter {
+
+public:
+	///	<summary>
+	///		Constructor.
+	///	</summary>
+	OverlapMeshStreamWriter();
+
+	///	<summary>
+	///		Destructor; removes the spool files if Close() was not called.
+	///	</summary>
+	~OverlapMeshStreamWriter();
+
+private:
+	///	<summary>
+	///		Copy constructor (not implemented).
+	///	</summary>
+	OverlapMeshStreamWriter(const OverlapMeshStreamWriter &);
+
+	///	<summary>
+	///		Assignment operator (not implemented).
+	///	</summary>
+	OverlapMeshStreamWriter & operator=(const OverlapMeshStreamWriter &);
+
+public:
+	///	<summary>
+	///		Begin writing an overlap mesh to strFile.
+	///	</summary>
+	void Open(
+		const std::string & strFile,
+		NcFile::FileFormat eFileFormat = NcFile::Classic
+	);
+
+	///	<summary>
+	///		Append a Node and return its index.
+	///	</summary>
+	int AddNode(
+		const Node & node
+	);
+
+	///	<summary>
+	///		Append a Face, whose node indices are those returned by
+	///		AddNode(), along with its source face, target face and area.
+	///	</summary>
+	void AddFace(
+		const Face & face,
+		int ixSourceFace,
+		int ixTargetFace,
+		double dArea
+	);
+
+	///	<summary>
+	///		Write the Exodus file and remove the spool files.
+	///	</summary>
+	void Close();
+
+public:
+	///	<summary>
+	///		Get the number of Nodes appended so far.
+	///	</summary>
+	int GetNodeCount() const {
+		return m_nNodes;
+	}
+
+	///	<summary>
+	///		Get the number of Faces appended so far.
+	///	</summary>
+	int GetFaceCount() const {
+		return m_nFaces;
+	}
+
+	///	<summary>
+	///		Get the total area of the Faces appended so far.
+	///	</summary>
+	double GetTotalArea() const {
+		return m_dTotalArea;
+	}
+
+protected:
+	///	<summary>
+	///		Close and remove the spool files.
+	///	</summary>
+	void RemoveSpools();
+
+protected:
+	///	<summary>
+	///		Output file name and format.
+	///	</summary>
+	std::string m_strFile;
+	NcFile::FileFormat m_eFileFormat;
+
+	///	<summary>
+	///		Spool file names.
+	///	</summary>
+	std::string m_strNodeSpool;
+	std::string m_strFaceSpool;
+
+	///	<summary>
+	///		Spool of Node coordinates, in index order.
+	///	</summary>
+	FILE * m_fpNodes;
+
+	///	<summary>
+	///		Spool of Faces, each stored as its number of nodes, its node
+	///		indices, its edge types, its source face, its target face and
+	///		its area.
+	///	</summary>
+	FILE * m_fpFaces;
+
+	///	<summary>
+	///		Number of Nodes and Faces appended.
+	///	</summary>
+	int m_nNodes;
+	int m_nFaces;
+
+	///	<summary>
+	///		Number of Faces with each number of nodes.
+	///	</summary>
+	std::map<int, int> m_mapBlockSizes;
+
+	///	<summary>
+	///		Total area of all Faces.
+	///	</summary>
+	double m_dTotalArea;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+#endif
+
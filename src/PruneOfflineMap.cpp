@@ -0,0 +1,154 @@
+///////////////////////////////////////////////////////////////////////////////
+///
+///	\file    PruneOfflineMap.cpp
+///	\author  agent
+///	\version October 15, 2026
+///
+///	<remarks>
+///		Copyright 2026 agent
+///
+///		This file is distributed as part of the Tempest source code package.
+///		Permission is granted to use, copy, modify and distribute this
+///		source code and its documentation under the terms of the GNU General
+///		Public License.  This software is provided "as is" without express
+///		or implied warranty.
+///	</remarks>
+
+#include "CommandLine.h"
+#include "Announce.h"
+#include "OfflineMap.h"
+
+#include "netcdfcpp.h"
+
+#include <cmath>
+#include <cstdio>
+#include <iostream>
+
+///////////////////////////////////////////////////////////////////////////////
+
+typedef std::map<std::string, std::string> AttributeMap;
+typedef AttributeMap::value_type AttributePair;
+
+///////////////////////////////////////////////////////////////////////////////
+
+int main(int argc, char** argv) {
+
+	NcError error(NcError::silent_nonfatal);
+
+try {
+	// Map file for input
+	std::string strInputMapFile;
+
+	// Map file for output
+	std::string strOutputMapFile;
+
+	// Weights of magnitude below this threshold are removed
+	double dThreshold;
+
+	// Remove weights in masked rows and columns
+	bool fDropMasked;
+
+	// Tolerance on the restored row and column sums
+	double dTolerance;
+
+	// Maximum number of iterations used to restore row and column sums
+	int nMaxIterations;
+
+	// Do not verify the mesh
+	bool fNoCheck;
+
+	// Check monotonicity
+	bool fCheckMonotone;
+
+	// Number of threads
+	int nThreads;
+
+	// Parse the command line
+	BeginCommandLine()
+		CommandLineString(strInputMapFile, "in", "");
+		CommandLineString(strOutputMapFile, "out", "");
+		CommandLineDouble(dThreshold, "threshold", 1.0e-12);
+		CommandLineBool(fDropMasked, "drop_masked");
+		CommandLineDouble(dTolerance, "tol", 1.0e-14);
+		CommandLineInt(nMaxIterations, "max_iter", 500);
+		CommandLineBool(fNoCheck, "nocheck");
+		CommandLineBool(fCheckMonotone, "checkmono");
+		CommandLineInt(nThreads, "nthreads", 1);
+
+		ParseCommandLine(argc, argv);
+	EndCommandLine(argv)
+
+	// Check arguments
+	if (strInputMapFile == "") {
+		_EXCEPTIONT("Input map file (--in) must be specified");
+	}
+	if (strOutputMapFile == "") {
+		_EXCEPTIONT("Output map file (--out) must be specified");
+	}
+	if (dThreshold < 0.0) {
+		_EXCEPTIONT("--threshold must be nonnegative");
+	}
+	if (nMaxIterations < 0) {
+		_EXCEPTIONT("--max_iter must be nonnegative");
+	}
+	if (nThreads < 1) {
+		_EXCEPTIONT("--nthreads must be at least 1");
+	}
+
+	// Atribute map
+	AttributeMap mapAttributes;
+
+	// Load map from file
+	AnnounceStartBlock("Loading input map");
+	OfflineMap mapRemap;
+	NcFile::FileFormat eFileFormat;
+	mapRemap.Read(strInputMapFile, &mapAttributes, &eFileFormat);
+	AnnounceEndBlock("Done");
+
+	// Prune the map
+	mapRemap.SetThreadCount(nThreads);
+	mapRemap.Prune(dThreshold, fDropMasked, dTolerance, nMaxIterations);
+
+	// Verify map
+	if (!fNoCheck) {
+		AnnounceStartBlock("Verifying map");
+		mapRemap.Verify(1.0e-8, 1.0e-8, fCheckMonotone, 1.0e-12);
+		AnnounceEndBlock("Done");
+	}
+
+	// Record the pruning parameters
+	char szThreshold[32];
+	snprintf(szThreshold, sizeof(szThreshold), "%1.5e", dThreshold);
+	mapAttributes["prune_threshold"] = szThreshold;
+	if (fDropMasked) {
+		mapAttributes["prune_masked"] = "true";
+	}
+
+	// Find version name
+	AttributeMap::iterator iterVersion = mapAttributes.find("version");
+	if (iterVersion == mapAttributes.end()) {
+		mapAttributes.insert(
+			AttributePair("version", "PruneOfflineMap 1.0 : 2026-10-15"));
+	} else {
+		iterVersion->second =
+			"PruneOfflineMap 1.0 : 2026-10-15 :: " + iterVersion->second;
+	}
+
+	// Write map to file
+	AnnounceStartBlock("Writing pruned map");
+	mapRemap.Write(strOutputMapFile, mapAttributes, eFileFormat);
+	AnnounceEndBlock("Done");
+
+	return (0);
+
+} catch(Exception & e) {
+	Announce(e.ToString().c_str());
+	return (-1);
+
+} catch(...) {
+	return (-2);
+}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
@@ -0,0 +1,172 @@
+///////////////////////////////////////////////////////////////////////////////
+///
+///	\file    ReproducibleSum.h
+///	\author  agent
+///	\version October 14, 2026
+///
+///	<remarks>
+///		Copyright 2026 agent
+///
+///		This file is distributed as part of the Tempest source code package.
+///		Permission is granted to use, copy, modify and distribute this
+///		source code and its documentation under the terms of the GNU General
+///		Public License.  This software is provided "as is" without express
+///		or implied warranty.
+///	</remarks>
+
+#ifndef _REPRODUCIBLESUM_H_
+#define _REPRODUCIBLESUM_H_
+
+#include <vector>
+#include <cstddef>
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Number of terms combined at each level of a reproducible reduction
+///		tree.
+///	</summary>
+static const size_t ReproducibleSumFanIn = 10;
+
+///	<summary>
+///		Number of terms in each block of a reproducible reduction.  Blocks
+///		are reduced independently (and in parallel) and the block results
+///		are then combined by the same tree.  This is a power of the fan-in,
+///		so that a block sum is exactly a node of the tree over all terms.
+///	</summary>
+static const size_t ReproducibleSumBlockSize = 10000;
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Reduce vec in place to its first element by a fixed tree, in which
+///		each level combines consecutive groups of ReproducibleSumFanIn
+///		values in order using fCombine(a, b), which accumulates b into a.
+///		The grouping depends only on the size of vec.
+///	</summary>
+template <typename T, typename Combine>
+void ReproducibleTreeReduce(
+	std::vector<T> & vec,
+	Combine fCombine
+) {
+	while (vec.size() > 1) {
+		const size_t sNext = (vec.size() - 1) / ReproducibleSumFanIn + 1;
+
+		for (size_t i = 0; i < sNext; i++) {
+			const size_t ixRef = ReproducibleSumFanIn * i;
+			if (i != ixRef) {
+				vec[i] = vec[ixRef];
+			}
+			for (size_t j = 1; j < ReproducibleSumFanIn; j++) {
+				if (ixRef + j >= vec.size()) {
+					break;
+				}
+				fCombine(vec[i], vec[ixRef + j]);
+			}
+		}
+
+		vec.resize(sNext);
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Reduce sCount terms whose results are independent of the number of
+///		threads.  The terms are divided into blocks of
+///		ReproducibleSumBlockSize, fBlockReduce(sBegin, sEnd) computes the
+///		result of one block and the block results are combined by
+///		ReproducibleTreeReduce() using fCombine.
+///	</summary>
+template <typename T, typename BlockReduce, typename Combine>
+T ReproducibleReduce(
+	size_t sCount,
+	int nThreads,
+	BlockReduce fBlockReduce,
+	Combine fCombine
+) {
+	if (sCount == 0) {
+		return T();
+	}
+
+	const long lBlocks = static_cast<long>(
+		(sCount - 1) / ReproducibleSumBlockSize + 1);
+
+	std::vector<T> vecBlockResults(lBlocks);
+
+#pragma omp parallel for num_threads(nThreads) schedule(static) if (lBlocks > 1)
+	for (long b = 0; b < lBlocks; b++) {
+		const size_t sBegin = static_cast<size_t>(b) * ReproducibleSumBlockSize;
+		size_t sEnd = sBegin + ReproducibleSumBlockSize;
+		if (sEnd > sCount) {
+			sEnd = sCount;
+		}
+		vecBlockResults[b] = fBlockReduce(sBegin, sEnd);
+	}
+
+	ReproducibleTreeReduce(vecBlockResults, fCombine);
+
+	return vecBlockResults[0];
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Combiner of a reproducible reduction by addition.
+///	</summary>
+struct ReproducibleSumAdd {
+	template <typename T>
+	void operator()(T & a, const T & b) const {
+		a += b;
+	}
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Sum sCount values of pData by the fixed tree of
+///		ReproducibleTreeReduce(), so that the result is bitwise identical for
+///		any number of threads.
+///	</summary>
+template <typename T>
+T ReproducibleSum(
+	const T * pData,
+	size_t sCount,
+	int nThreads = 1
+) {
+	struct BlockSum {
+		const T * pData;
+
+		T operator()(size_t sBegin, size_t sEnd) const {
+			std::vector<T> vecPartial(
+				(sEnd - sBegin - 1) / ReproducibleSumFanIn + 1);
+
+			// First level of the tree is summed directly from the data
+			for (size_t i = 0; i < vecPartial.size(); i++) {
+				const size_t ixRef = sBegin + ReproducibleSumFanIn * i;
+				vecPartial[i] = pData[ixRef];
+				for (size_t j = 1; j < ReproducibleSumFanIn; j++) {
+					if (ixRef + j >= sEnd) {
+						break;
+					}
+					vecPartial[i] += pData[ixRef + j];
+				}
+			}
+
+			ReproducibleTreeReduce(vecPartial, ReproducibleSumAdd());
+
+			return vecPartial[0];
+		}
+	};
+
+	BlockSum fBlockSum;
+	fBlockSum.pData = pData;
+
+	return ReproducibleReduce<T>(
+		sCount, nThreads, fBlockSum, ReproducibleSumAdd());
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+#endif
+
@@ -17,13 +17,23 @@
 #include "CommandLine.h"
 #include "GridElements.h"
 #include "Exception.h"
+#include "OmpExceptionCapture.h"
 #include "Announce.h"
 #include "order32.h"
 
 #include "netcdfcpp.h"
 
+#include <algorithm>
 #include <cmath>
+#include <cstring>
 #include <iostream>
+#include <limits>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
 ///////////////////////////////////////////////////////////////////////////////
 
@@ -106,6 +116,123 @@ double SwapEndianDouble(const double num) {
 
 ///////////////////////////////////////////////////////////////////////////////
 
+///	<summary>
+///		Reverse the byte order of each of the nValues values of type T in
+///		the contiguous array pValues, in place.
+///	</summary>
+template <typename T>
+void SwapEndianArray(
+	T * pValues,
+	size_t nValues
+) {
+	unsigned char * pBytes = reinterpret_cast<unsigned char *>(pValues);
+
+	for (size_t i = 0; i < nValues; i++) {
+		unsigned char * p = pBytes + i * sizeof(T);
+		for (size_t b = 0; b < sizeof(T) / 2; b++) {
+			const unsigned char c = p[b];
+			p[b] = p[sizeof(T) - b - 1];
+			p[sizeof(T) - b - 1] = c;
+		}
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		A read-only memory mapping of a file.
+///	</summary>
+class SHPFileMapping {
+
+public:
+	///	<summary>
+	///		Map the file strFile.
+	///	</summary>
+	SHPFileMapping(
+		const std::string & strFile
+	) :
+		m_pData(NULL),
+		m_sSize(0)
+	{
+		int fd = open(strFile.c_str(), O_RDONLY);
+		if (fd < 0) {
+			_EXCEPTION1("Unable to open input file \"%s\"", strFile.c_str());
+		}
+
+		struct stat statFile;
+		if (fstat(fd, &statFile) != 0) {
+			close(fd);
+			_EXCEPTION1("Unable to stat input file \"%s\"", strFile.c_str());
+		}
+
+		m_sSize = static_cast<size_t>(statFile.st_size);
+		if (m_sSize != 0) {
+			void * pData = mmap(NULL, m_sSize, PROT_READ, MAP_PRIVATE, fd, 0);
+			if (pData == MAP_FAILED) {
+				close(fd);
+				_EXCEPTION1("Unable to map input file \"%s\"", strFile.c_str());
+			}
+			m_pData = reinterpret_cast<const char *>(pData);
+		}
+
+		close(fd);
+	}
+
+	///	<summary>
+	///		Destructor, which unmaps the file.
+	///	</summary>
+	~SHPFileMapping() {
+		if (m_pData != NULL) {
+			munmap(const_cast<char *>(m_pData), m_sSize);
+		}
+	}
+
+	///	<summary>
+	///		Get the size of the file, in bytes.
+	///	</summary>
+	size_t GetSize() const {
+		return m_sSize;
+	}
+
+	///	<summary>
+	///		Copy sBytes bytes at offset sOffset of the file to pDest.
+	///	</summary>
+	void Read(
+		size_t sOffset,
+		void * pDest,
+		size_t sBytes
+	) const {
+		if ((sOffset > m_sSize) || (sBytes > m_sSize - sOffset)) {
+			_EXCEPTIONT("Attempting to read beyond the end of the shapefile");
+		}
+		memcpy(pDest, m_pData + sOffset, sBytes);
+	}
+
+protected:
+	///	<summary>
+	///		Mapped data of the file.
+	///	</summary>
+	const char * m_pData;
+
+	///	<summary>
+	///		Size of the file, in bytes.
+	///	</summary>
+	size_t m_sSize;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Location of a polygon record in the shapefile and of its Face and
+///		nodes in the Mesh.
+///	</summary>
+struct SHPPolygonRecord {
+	int32_t iNumber;
+	int32_t nNumPoints;
+	size_t sPointsOffset;
+	int ixFirstNode;
+};
+
 int main(int argc, char** argv) {
 
 	NcError error(NcError::silent_nonfatal);
@@ -132,6 +259,12 @@ try {
 	// Calculate and display area of mesh
 	bool fCalculateArea;
 
+	// Display the header of each polygon
+	bool fVerbose;
+
+	// Number of threads used to convert polygons
+	int nThreads;
+
 	// Parse the command line
 	BeginCommandLine()
 		CommandLineString(strInputFile, "in", "");
@@ -141,6 +274,8 @@ try {
 		CommandLineInt(iPolygonFirst, "polygon_first", (-1));
 		CommandLineInt(iPolygonLast, "polygon_last", (-1));
 		CommandLineBool(fCalculateArea, "calculatearea");
+		CommandLineBool(fVerbose, "verbose");
+		CommandLineInt(nThreads, "nthreads", 1);
 
 		ParseCommandLine(argc, argv);
 	EndCommandLine(argv)
@@ -153,26 +288,36 @@ try {
 		_EXCEPTIONT("No output file specified");
 		return (-1);
 	}
+	if (nThreads < 1) {
+		_EXCEPTIONT("--nthreads must be at least 1");
+	}
 
 	AnnounceBanner();
 
 	// Load shapefile
 	AnnounceStartBlock("Loading shapefile");
 
-	std::ifstream shpfile(
-		strInputFile.c_str(), std::ios::in | std::ios::binary);
+	const bool fLittleEndian = (O32_HOST_ORDER == O32_LITTLE_ENDIAN);
+	if (!fLittleEndian && (O32_HOST_ORDER != O32_BIG_ENDIAN)) {
+		_EXCEPTIONT("Invalid system Endian");
+	}
+
+	SHPFileMapping shpfile(strInputFile);
+
+	if (shpfile.GetSize() < sizeof(SHPHeader) + sizeof(SHPBounds)) {
+		_EXCEPTIONT("Input file does not appear to be a ESRI Shapefile: "
+			"File too short");
+	}
 
 	SHPHeader shphead;
-	shpfile.read((char*)(&shphead), sizeof(SHPHeader));
+	shpfile.Read(0, &shphead, sizeof(SHPHeader));
 
-	if (O32_HOST_ORDER == O32_LITTLE_ENDIAN) {
+	if (fLittleEndian) {
 		shphead.iFileCode = SwapEndianInt32(shphead.iFileCode);
 		shphead.iFileLength = SwapEndianInt32(shphead.iFileLength);
-	} else if (O32_HOST_ORDER == O32_BIG_ENDIAN) {
+	} else {
 		shphead.iVersion = SwapEndianInt32(shphead.iVersion);
 		shphead.iShapeType = SwapEndianInt32(shphead.iShapeType);
-	} else {
-		_EXCEPTIONT("Invalid system Endian");
 	}
 
 	if (shphead.iFileCode != SHPFileCodeRef) {
@@ -187,59 +332,57 @@ try {
 	}
 
 	SHPBounds shpbounds;
-	shpfile.read((char*)(&shpbounds), sizeof(SHPBounds));
-
-	if (O32_HOST_ORDER == O32_BIG_ENDIAN) {
-		shpbounds.dXmin = SwapEndianDouble(shpbounds.dXmin);
-		shpbounds.dYmin = SwapEndianDouble(shpbounds.dYmin);
-		shpbounds.dXmax = SwapEndianDouble(shpbounds.dXmax);
-		shpbounds.dYmax = SwapEndianDouble(shpbounds.dXmax);
+	shpfile.Read(sizeof(SHPHeader), &shpbounds, sizeof(SHPBounds));
 
-		shpbounds.dZmin = SwapEndianDouble(shpbounds.dZmin);
-		shpbounds.dZmax = SwapEndianDouble(shpbounds.dZmax);
-
-		shpbounds.dMmin = SwapEndianDouble(shpbounds.dMmin);
-		shpbounds.dMmax = SwapEndianDouble(shpbounds.dMmax);
+	if (!fLittleEndian) {
+		SwapEndianArray(&(shpbounds.dXmin), 8);
 	}
 
-	// Current position (in 16-bit words)
-	int32_t iCurrentPosition = 50;
+	// End of the records (the file length is given in 16-bit words)
+	const size_t sFileEnd = std::min(
+		shpfile.GetSize(), 2 * static_cast<size_t>(shphead.iFileLength));
 
-	int32_t iPolygonIx = 1;
+	// Locate all polygon records, reading only the record and polygon
+	// headers, so that all Faces and nodes can be allocated at once
+	std::vector<SHPPolygonRecord> vecRecords;
 
-	// Exodus mesh
-	Mesh mesh;
+	int nTotalNodes = 0;
+	int nMultiPartPolygons = 0;
 
-	// Load records
-	while (iCurrentPosition < shphead.iFileLength) {
+	size_t sPosition = sizeof(SHPHeader) + sizeof(SHPBounds);
+
+	while (sPosition + sizeof(SHPRecordHeader) <= sFileEnd) {
 
 		// Read the record header
 		SHPRecordHeader shprechead;
-		shpfile.read((char*)(&shprechead), sizeof(SHPRecordHeader));
-		if (shpfile.eof()) {
-			break;
-		}
+		shpfile.Read(sPosition, &shprechead, sizeof(SHPRecordHeader));
 
-		if (O32_HOST_ORDER == O32_LITTLE_ENDIAN) {
+		if (fLittleEndian) {
 			shprechead.iNumber = SwapEndianInt32(shprechead.iNumber);
 			shprechead.nLength = SwapEndianInt32(shprechead.nLength);
 		}
 
-		char szBuffer[128];
-		sprintf(szBuffer, "Polygon %i", shprechead.iNumber);
-		iPolygonIx++;
-		AnnounceStartBlock(szBuffer);
+		const size_t sContent = sPosition + sizeof(SHPRecordHeader);
+		const size_t sContentLength = 2 * static_cast<size_t>(shprechead.nLength);
 
-		iCurrentPosition += shprechead.nLength;
+		if ((shprechead.nLength < 0) || (sContent + sContentLength > sFileEnd)) {
+			Announce("WARNING: Record %i truncated; ignoring remaining records",
+				shprechead.iNumber);
+			break;
+		}
+
+		sPosition = sContent + sContentLength;
 
 		// Read the shape type
-		int32_t iShapeType;
-		shpfile.read((char*)(&iShapeType), sizeof(int32_t));
-		if (shpfile.eof()) {
-			break;
+		if (sContentLength < sizeof(int32_t) + sizeof(SHPPolygonHeader)) {
+			_EXCEPTION1("Input file error: Record %i too short for a polygon",
+				shprechead.iNumber);
 		}
 
-		if (O32_HOST_ORDER == O32_BIG_ENDIAN) {
+		int32_t iShapeType;
+		shpfile.Read(sContent, &iShapeType, sizeof(int32_t));
+
+		if (!fLittleEndian) {
 			iShapeType = SwapEndianInt32(iShapeType);
 		}
 		if (iShapeType != SHPPolygonType) {
@@ -248,126 +391,162 @@ try {
 
 		// Read the polygon header
 		SHPPolygonHeader shppolyhead;
-		shpfile.read((char*)(&shppolyhead), sizeof(SHPPolygonHeader));
-		if (shpfile.eof()) {
-			break;
-		}
+		shpfile.Read(
+			sContent + sizeof(int32_t), &shppolyhead, sizeof(SHPPolygonHeader));
 
-		if (O32_HOST_ORDER == O32_BIG_ENDIAN) {
-			shppolyhead.dXmin = SwapEndianDouble(shppolyhead.dXmin);
-			shppolyhead.dYmin = SwapEndianDouble(shppolyhead.dYmin);
-			shppolyhead.dXmax = SwapEndianDouble(shppolyhead.dXmax);
-			shppolyhead.dYmax = SwapEndianDouble(shppolyhead.dYmax);
-			shppolyhead.nNumParts = SwapEndianInt32(shppolyhead.nNumParts);
-			shppolyhead.nNumPoints = SwapEndianInt32(shppolyhead.nNumPoints);
+		if (!fLittleEndian) {
+			SwapEndianArray(&(shppolyhead.dXmin), 4);
+			SwapEndianArray(&(shppolyhead.nNumParts), 2);
 		}
 
 		// Sanity check
-		if (shppolyhead.nNumParts > 0x1000000) {
+		if ((shppolyhead.nNumParts < 0) || (shppolyhead.nNumParts > 0x1000000)) {
 			_EXCEPTION1("Polygon NumParts exceeds sanity bound (%i)",
 				shppolyhead.nNumParts);
 		}
-		if (shppolyhead.nNumPoints > 0x1000000) {
+		if ((shppolyhead.nNumPoints < 0) || (shppolyhead.nNumPoints > 0x1000000)) {
 			_EXCEPTION1("Polygon NumPoints exceeds sanity bound (%i)",
 				shppolyhead.nNumPoints);
 		}
-		Announce("containing %i part(s) with %i points",
-			shppolyhead.nNumParts,
-			shppolyhead.nNumPoints);
-		Announce("Xmin: %3.5f", shppolyhead.dXmin);
-		Announce("Ymin: %3.5f", shppolyhead.dYmin);
-		Announce("Xmax: %3.5f", shppolyhead.dXmax);
-		Announce("Ymax: %3.5f", shppolyhead.dYmax);
 
-		if (shppolyhead.nNumParts != 1) {
-			Announce("WARNING: Only polygons with 1 part currently supported"
-				" in Exodus format; ignoring remaining parts");
-			//_EXCEPTIONT("Only polygons with 1 part currently supported"
-			//	" in Exodus format");
-		}
+		const size_t sPointsOffset =
+			sContent + sizeof(int32_t) + sizeof(SHPPolygonHeader)
+			+ shppolyhead.nNumParts * sizeof(int32_t);
 
-		DataArray1D<int32_t> iParts(shppolyhead.nNumParts);
-		shpfile.read((char*)&(iParts[0]),
-			shppolyhead.nNumParts * sizeof(int32_t));
-		if (shpfile.eof()) {
-			break;
+		if (sPointsOffset + shppolyhead.nNumPoints * 2 * sizeof(double)
+		        > sContent + sContentLength
+		) {
+			_EXCEPTION1("Input file error: Record %i too short for its points",
+				shprechead.iNumber);
 		}
 
-		DataArray1D<double> dPoints(shppolyhead.nNumPoints * 2);
-		shpfile.read((char*)&(dPoints[0]),
-			shppolyhead.nNumPoints * 2 * sizeof(double));
-		if (shpfile.eof()) {
-			break;
+		if ((iPolygonFirst != (-1)) && (shprechead.iNumber < iPolygonFirst)) {
+			continue;
 		}
-
-		if (O32_HOST_ORDER == O32_BIG_ENDIAN) {
-			for (int i = 0; i < shppolyhead.nNumParts; i++) {
-				iParts[i] = SwapEndianInt32(iParts[i]);
-			}
-			for (int i = 0; i < shppolyhead.nNumPoints * 2; i++) {
-				dPoints[i] = SwapEndianDouble(dPoints[i]);
-			}
+		if ((iPolygonLast != (-1)) && (shprechead.iNumber > iPolygonLast)) {
+			continue;
 		}
 
-		if ((iPolygonFirst != (-1)) && (shprechead.iNumber < iPolygonFirst)) {
+		if (fVerbose) {
+			char szBuffer[128];
+			sprintf(szBuffer, "Polygon %i", shprechead.iNumber);
+			AnnounceStartBlock(szBuffer);
+			Announce("containing %i part(s) with %i points",
+				shppolyhead.nNumParts,
+				shppolyhead.nNumPoints);
+			Announce("Xmin: %3.5f", shppolyhead.dXmin);
+			Announce("Ymin: %3.5f", shppolyhead.dYmin);
+			Announce("Xmax: %3.5f", shppolyhead.dXmax);
+			Announce("Ymax: %3.5f", shppolyhead.dYmax);
 			AnnounceEndBlock("Done");
-			continue;
 		}
 
-		if ((iPolygonLast != (-1)) && (shprechead.iNumber > iPolygonLast)) {
-			AnnounceEndBlock("Done");
-			continue;
+		if (shppolyhead.nNumParts != 1) {
+			nMultiPartPolygons++;
+		}
+
+		if (nTotalNodes > std::numeric_limits<int>::max() - shppolyhead.nNumPoints) {
+			_EXCEPTIONT("Shapefile has too many points for a Mesh");
 		}
 
-		// Convert to Exodus mesh.  Note that shapefile polygons are specified
-		// in clockwise order, whereas Exodus files request polygons to be
-		// specified in counter-clockwise order.  Hence we need to reorient
-		// the alignment of Faces.
-		int nFaces = mesh.faces.size();
-		int nNodes = mesh.nodes.size();
-		mesh.faces.resize(nFaces+1);
-		mesh.nodes.resize(nNodes + shppolyhead.nNumPoints);
-
-		mesh.faces[nFaces] = Face(shppolyhead.nNumPoints);
-
-		// Convert from longitude/latitude to XYZ
-		if (strXYUnits == "lonlat") {
-			for (int i = 0; i < shppolyhead.nNumPoints; i++) {
-				double dLonRad = dPoints[2*i] / 180.0 * M_PI;
-				double dLatRad = dPoints[2*i+1] / 180.0 * M_PI;
-
-				mesh.nodes[nNodes+i].x = cos(dLatRad) * cos(dLonRad);
-				mesh.nodes[nNodes+i].y = cos(dLatRad) * sin(dLonRad);
-				mesh.nodes[nNodes+i].z = sin(dLatRad);
-
-				mesh.faces[nFaces].SetNode(
-					shppolyhead.nNumPoints - i - 1, nNodes + i);
+		SHPPolygonRecord rec;
+		rec.iNumber = shprechead.iNumber;
+		rec.nNumPoints = shppolyhead.nNumPoints;
+		rec.sPointsOffset = sPointsOffset;
+		rec.ixFirstNode = nTotalNodes;
+		vecRecords.push_back(rec);
+
+		nTotalNodes += shppolyhead.nNumPoints;
+	}
+
+	const int nPolygons = static_cast<int>(vecRecords.size());
+
+	Announce("%i polygons with %i points", nPolygons, nTotalNodes);
+
+	if (nMultiPartPolygons != 0) {
+		Announce("WARNING: Only polygons with 1 part currently supported"
+			" in Exodus format; ignoring remaining parts of %i polygon(s)",
+			nMultiPartPolygons);
+	}
+
+	if (strXYUnits != "lonlat") {
+		_EXCEPTION1("Invalid units \"%s\"", strXYUnits.c_str());
+	}
+
+	// Exodus mesh
+	Mesh mesh;
+	mesh.faces.resize(nPolygons);
+	mesh.nodes.resize(nTotalNodes);
+
+	std::vector<double> vecArea;
+	if (fCalculateArea) {
+		vecArea.resize(nPolygons);
+	}
+
+	// Convert to Exodus mesh.  Note that shapefile polygons are specified
+	// in clockwise order, whereas Exodus files request polygons to be
+	// specified in counter-clockwise order.  Hence we need to reorient
+	// the alignment of Faces.  Each polygon writes its own Face and nodes,
+	// so polygons are converted in parallel.
+	OmpExceptionCapture capture;
+
+#pragma omp parallel num_threads(nThreads)
+	{
+		std::vector<double> dPoints;
+
+#pragma omp for schedule(dynamic, 16)
+		for (int p = 0; p < nPolygons; p++) {
+			if (capture.HasError()) {
+				continue;
 			}
+			capture.Run([&]() {
+				const SHPPolygonRecord & rec = vecRecords[p];
 
-		} else {
-			_EXCEPTION1("Invalid units \"%s\"", strXYUnits.c_str());
-		}
+				// Copy out the contiguous point array, which need not be
+				// aligned in the file, and convert it in bulk
+				dPoints.resize(2 * static_cast<size_t>(rec.nNumPoints) + 1);
+				shpfile.Read(rec.sPointsOffset, &(dPoints[0]),
+					2 * rec.nNumPoints * sizeof(double));
+
+				if (!fLittleEndian) {
+					SwapEndianArray(&(dPoints[0]), 2 * rec.nNumPoints);
+				}
+
+				// Convert from longitude/latitude to XYZ
+				Face face(rec.nNumPoints);
 
-		// Calculate Face area
-		if (fCalculateArea) {
-			double dArea =
-				CalculateFaceArea_Concave(
-					mesh.faces[nFaces], mesh.nodes);
+				for (int i = 0; i < rec.nNumPoints; i++) {
+					double dLonRad = dPoints[2*i] / 180.0 * M_PI;
+					double dLatRad = dPoints[2*i+1] / 180.0 * M_PI;
 
-			Announce("Area: %1.15e sr", dArea);
+					Node & node = mesh.nodes[rec.ixFirstNode + i];
+					node.x = cos(dLatRad) * cos(dLonRad);
+					node.y = cos(dLatRad) * sin(dLonRad);
+					node.z = sin(dLatRad);
+
+					face.SetNode(rec.nNumPoints - i - 1, rec.ixFirstNode + i);
+				}
+
+				mesh.faces[p] = face;
+
+				// Calculate Face area
+				if (fCalculateArea) {
+					vecArea[p] = CalculateFaceArea_Concave(face, mesh.nodes);
+				}
+			});
 		}
+	}
 
-/*
-		Face face5(5);
-		face5.SetNode(0, 37);
-		face5.SetNode(1, 32);
-		face5.SetNode(2, 28);
-		face5.SetNode(3, 27);
-		face5.SetNode(4, 26);
+	capture.Rethrow();
 
-		mesh.faces[0] = face5;
-*/
-		AnnounceEndBlock("Done");
+	if (fCalculateArea) {
+		double dTotalArea = 0.0;
+		for (int p = 0; p < nPolygons; p++) {
+			Announce("Polygon %i area: %1.15e sr",
+				vecRecords[p].iNumber, vecArea[p]);
+			dTotalArea += vecArea[p];
+		}
+		Announce("Total area: %1.15e sr", dTotalArea);
 	}
 
 	AnnounceEndBlock("Done");
@@ -19,8 +19,37 @@
 
 #include "Defines.h"
 #include "DataArray1D.h"
+#include "DataArray2D.h"
+#include "Announce.h"
 
 #include <map>
+#include <vector>
+#include <algorithm>
+#include <limits>
+#include <cstddef>
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		A (row, column, value) entry of a SparseMatrix, used to buffer
+///		contributions that are later accumulated with AddEntries().
+///	</summary>
+template <typename DataType>
+struct SparseMatrixEntry {
+	SparseMatrixEntry(
+		int a_iRow,
+		int a_iCol,
+		DataType a_value
+	) :
+		iRow(a_iRow),
+		iCol(a_iCol),
+		value(a_value)
+	{ }
+
+	int iRow;
+	int iCol;
+	DataType value;
+};
 
 ///////////////////////////////////////////////////////////////////////////////
 
@@ -44,14 +73,361 @@ public:
 	///	</summary>
 	SparseMatrix() :
 		m_nRows(0),
-		m_nCols(0)
+		m_nCols(0),
+		m_fFrozen(false),
+		m_fExternalStorage(false),
+		m_nDistributedThreads(0)
 	{ }
 
+	///	<summary>
+	///		Copy constructor.  The copy always owns its storage.
+	///	</summary>
+	SparseMatrix(const SparseMatrix<DataType> & smat) :
+		m_nRows(smat.m_nRows),
+		m_nCols(smat.m_nCols),
+		m_mapEntries(smat.m_mapEntries),
+		m_fFrozen(smat.m_fFrozen),
+		m_vecRowPtr(smat.m_vecRowPtr),
+		m_vecColIx(smat.m_vecColIx),
+		m_vecValues(smat.m_vecValues),
+		m_fExternalStorage(false),
+		m_nDistributedThreads(0)
+	{ }
+
+	///	<summary>
+	///		Move constructor, which takes the storage of smat and leaves it
+	///		empty.
+	///	</summary>
+	SparseMatrix(SparseMatrix<DataType> && smat) :
+		m_nRows(smat.m_nRows),
+		m_nCols(smat.m_nCols),
+		m_fFrozen(smat.m_fFrozen),
+		m_fExternalStorage(smat.m_fExternalStorage),
+		m_nDistributedThreads(smat.m_nDistributedThreads)
+	{
+		m_mapEntries.swap(smat.m_mapEntries);
+		m_vecRowPtr.Swap(smat.m_vecRowPtr);
+		m_vecColIx.Swap(smat.m_vecColIx);
+		m_vecValues.Swap(smat.m_vecValues);
+		smat.Clear();
+	}
+
+	///	<summary>
+	///		Assignment operator.  External storage of this SparseMatrix is
+	///		released rather than overwritten, and the result always owns
+	///		its storage.
+	///	</summary>
+	SparseMatrix<DataType> & operator=(const SparseMatrix<DataType> & smat) {
+		if (this == &smat) {
+			return (*this);
+		}
+
+		ReleaseStorage();
+
+		m_nRows = smat.m_nRows;
+		m_nCols = smat.m_nCols;
+		m_mapEntries = smat.m_mapEntries;
+		m_fFrozen = smat.m_fFrozen;
+		m_vecRowPtr = smat.m_vecRowPtr;
+		m_vecColIx = smat.m_vecColIx;
+		m_vecValues = smat.m_vecValues;
+		m_nDistributedThreads = 0;
+
+		return (*this);
+	}
+
+	///	<summary>
+	///		Move assignment operator, which takes the storage of smat and
+	///		leaves it empty.
+	///	</summary>
+	SparseMatrix<DataType> & operator=(SparseMatrix<DataType> && smat) {
+		if (this == &smat) {
+			return (*this);
+		}
+
+		Clear();
+
+		m_nRows = smat.m_nRows;
+		m_nCols = smat.m_nCols;
+		m_mapEntries.swap(smat.m_mapEntries);
+		m_fFrozen = smat.m_fFrozen;
+		m_vecRowPtr.Swap(smat.m_vecRowPtr);
+		m_vecColIx.Swap(smat.m_vecColIx);
+		m_vecValues.Swap(smat.m_vecValues);
+		m_fExternalStorage = smat.m_fExternalStorage;
+		m_nDistributedThreads = smat.m_nDistributedThreads;
+
+		smat.Clear();
+
+		return (*this);
+	}
+
+public:
+	///	<summary>
+	///		Determine if the SparseMatrix has been frozen into compressed
+	///		sparse row (CSR) form.
+	///	</summary>
+	bool IsFrozen() const {
+		return m_fFrozen;
+	}
+
+	///	<summary>
+	///		Determine if the CSR arrays of the frozen SparseMatrix are held
+	///		in external storage attached by AttachFrozen().
+	///	</summary>
+	bool HasExternalStorage() const {
+		return m_fExternalStorage;
+	}
+
+	///	<summary>
+	///		Freeze the SparseMatrix, converting the assembly map into
+	///		contiguous row pointer / column index / value arrays.  The
+	///		assembly map is released.
+	///	</summary>
+	void Freeze() {
+		if (m_fFrozen) {
+			return;
+		}
+
+		m_vecRowPtr.Allocate(m_nRows + 1);
+		m_vecColIx.Allocate(m_mapEntries.size());
+		m_vecValues.Allocate(m_mapEntries.size());
+
+		// Entries of the map are already sorted by (row, column)
+		size_t ix = 0;
+		SparseMapConstIterator iter = m_mapEntries.begin();
+		for (; iter != m_mapEntries.end(); iter++) {
+			m_vecRowPtr[iter->first.first + 1]++;
+			m_vecColIx[ix] = iter->first.second;
+			m_vecValues[ix] = iter->second;
+			ix++;
+		}
+		for (int i = 0; i < m_nRows; i++) {
+			m_vecRowPtr[i+1] += m_vecRowPtr[i];
+		}
+
+		SparseMap mapEmpty;
+		m_mapEntries.swap(mapEmpty);
+
+		m_fFrozen = true;
+		m_nDistributedThreads = 0;
+	}
+
+	///	<summary>
+	///		Thaw the SparseMatrix, returning it to the assembly phase.
+	///	</summary>
+	void Thaw() {
+		if (!m_fFrozen) {
+			return;
+		}
+
+		m_mapEntries.clear();
+
+		for (int i = 0; i < m_nRows; i++) {
+			for (int k = m_vecRowPtr[i]; k < m_vecRowPtr[i+1]; k++) {
+				m_mapEntries.insert(
+						m_mapEntries.end(),
+						SparseMapPair(
+							IndexType(i, m_vecColIx[k]), m_vecValues[k]));
+			}
+		}
+
+		ReleaseStorage();
+
+		m_fFrozen = false;
+		m_nDistributedThreads = 0;
+	}
+
+	///	<summary>
+	///		Remove all entries and release all storage.
+	///	</summary>
+	void Clear() {
+		m_mapEntries.clear();
+
+		ReleaseStorage();
+
+		m_nRows = 0;
+		m_nCols = 0;
+
+		m_fFrozen = false;
+		m_nDistributedThreads = 0;
+	}
+
+	///	<summary>
+	///		Set this SparseMatrix to an nRows x nCols matrix in frozen form
+	///		whose CSR arrays are the external arrays pRowPtr (nRows + 1
+	///		entries), pColIx and pValues (sNonZeros entries each), which
+	///		are not copied.  The external arrays must outlive their use by
+	///		this SparseMatrix; they are released, never freed, by any
+	///		operation that replaces the entries.
+	///	</summary>
+	void AttachFrozen(
+		int nRows,
+		int nCols,
+		size_t sNonZeros,
+		int * pRowPtr,
+		int * pColIx,
+		DataType * pValues
+	) {
+		if ((nRows < 0) || (nCols < 0)) {
+			_EXCEPTION2("Invalid SparseMatrix dimensions (%i x %i)",
+				nRows, nCols);
+		}
+		if (pRowPtr == NULL) {
+			_EXCEPTIONT("Missing row pointers in AttachFrozen");
+		}
+		if ((sNonZeros != 0) && ((pColIx == NULL) || (pValues == NULL))) {
+			_EXCEPTIONT("Missing column indices or values in AttachFrozen");
+		}
+
+		Clear();
+
+		m_nRows = nRows;
+		m_nCols = nCols;
+
+		m_vecRowPtr.SetSize(nRows + 1);
+		m_vecRowPtr.AttachToData(pRowPtr);
+
+		if (sNonZeros != 0) {
+			m_vecColIx.SetSize(sNonZeros);
+			m_vecColIx.AttachToData(pColIx);
+
+			m_vecValues.SetSize(sNonZeros);
+			m_vecValues.AttachToData(pValues);
+		}
+
+		m_fFrozen = true;
+		m_fExternalStorage = true;
+		m_nDistributedThreads = 0;
+	}
+
+	///	<summary>
+	///		Partition the rows of the frozen SparseMatrix into nParts
+	///		contiguous ranges of approximately equal cost, where the cost
+	///		of a row is its number of nonzeros plus one, so that maps with
+	///		very uneven row lengths are balanced across threads.  Range p
+	///		is [vecRowBegin[p], vecRowBegin[p+1]).
+	///	</summary>
+	void GetRowPartition(
+		int nParts,
+		std::vector<int> & vecRowBegin
+	) const {
+		if (!m_fFrozen) {
+			_EXCEPTIONT("SparseMatrix must be frozen to partition rows");
+		}
+		if (nParts < 1) {
+			_EXCEPTION1("Invalid number of partitions (%i)", nParts);
+		}
+
+		const int * pRowPtr = m_vecRowPtr;
+
+		const long lTotalCost =
+			static_cast<long>(pRowPtr[m_nRows]) + static_cast<long>(m_nRows);
+
+		vecRowBegin.resize(nParts + 1);
+		vecRowBegin[0] = 0;
+		for (int p = 1; p < nParts; p++) {
+			const long lCost = (lTotalCost * p) / nParts;
+
+			// First row at which the cumulative cost reaches lCost
+			int iLow = vecRowBegin[p-1];
+			int iHigh = m_nRows;
+			while (iLow < iHigh) {
+				const int iMid = iLow + (iHigh - iLow) / 2;
+				if (static_cast<long>(pRowPtr[iMid]) + iMid < lCost) {
+					iLow = iMid + 1;
+				} else {
+					iHigh = iMid;
+				}
+			}
+			vecRowBegin[p] = iLow;
+		}
+		vecRowBegin[nParts] = m_nRows;
+	}
+
+	///	<summary>
+	///		Reallocate the CSR arrays of the frozen SparseMatrix so that
+	///		the pages holding the rows applied by each of nThreads threads
+	///		are first touched by that thread, placing them in the thread's
+	///		NUMA domain.  Applies with the same thread count then traverse
+	///		local memory.  Has no effect if the SparseMatrix is already
+	///		distributed over nThreads threads, or if its arrays are held in
+	///		external storage, which may be shared with other processes.
+	///	</summary>
+	void Distribute(
+		int nThreads
+	) {
+		if (!m_fFrozen) {
+			_EXCEPTIONT("SparseMatrix must be frozen to Distribute");
+		}
+		if (nThreads < 1) {
+			_EXCEPTION1("Invalid thread count (%i)", nThreads);
+		}
+		if ((m_nDistributedThreads == nThreads) || m_fExternalStorage) {
+			return;
+		}
+
+		std::vector<int> vecRowBegin;
+		GetRowPartition(nThreads, vecRowBegin);
+
+		const size_t sEntries = GetNonZeroCount();
+
+		DataArray1D<int> vecRowPtr;
+		DataArray1D<int> vecColIx;
+		DataArray1D<DataType> vecValues;
+
+		vecRowPtr.Allocate(m_nRows + 1, false);
+		vecColIx.Allocate(sEntries, false);
+		vecValues.Allocate(sEntries, false);
+
+		const int * pRowPtrOld = m_vecRowPtr;
+		const int * pColIxOld = m_vecColIx;
+		const DataType * pValuesOld = m_vecValues;
+
+		int * pRowPtr = vecRowPtr;
+		int * pColIx = vecColIx;
+		DataType * pValues = vecValues;
+
+		// Same schedule as the apply kernels, so partition p is copied by
+		// the thread that applies it
+#pragma omp parallel for num_threads(nThreads) schedule(static, 1)
+		for (int p = 0; p < nThreads; p++) {
+			for (int i = vecRowBegin[p]; i < vecRowBegin[p+1]; i++) {
+				pRowPtr[i] = pRowPtrOld[i];
+				for (int k = pRowPtrOld[i]; k < pRowPtrOld[i+1]; k++) {
+					pColIx[k] = pColIxOld[k];
+					pValues[k] = pValuesOld[k];
+				}
+			}
+		}
+		pRowPtr[m_nRows] = pRowPtrOld[m_nRows];
+
+		m_vecRowPtr.Swap(vecRowPtr);
+		m_vecColIx.Swap(vecColIx);
+		m_vecValues.Swap(vecValues);
+
+		m_nDistributedThreads = nThreads;
+	}
+
 public:
 	///	<summary>
-	///		Accessor.
+	///		Accessor.  If the SparseMatrix is frozen and the entry already
+	///		exists it is modified in place; otherwise the SparseMatrix is
+	///		returned to the assembly phase.
 	///	</summary>
 	DataType & operator()(int iRow, int iCol) {
+		if (m_fFrozen) {
+			if ((iRow >= 0) && (iRow < m_nRows) && (GetNonZeroCount() != 0)) {
+				const int * pBegin = &(m_vecColIx[0]) + m_vecRowPtr[iRow];
+				const int * pEnd = &(m_vecColIx[0]) + m_vecRowPtr[iRow+1];
+				const int * pFound = std::lower_bound(pBegin, pEnd, iCol);
+				if ((pFound != pEnd) && (*pFound == iCol)) {
+					return m_vecValues[pFound - &(m_vecColIx[0])];
+				}
+			}
+			Thaw();
+		}
+
 		SparseMapIterator iter = m_mapEntries.find(IndexType(iRow, iCol));
 		if (iter == m_mapEntries.end()) {
 			if (iRow >= m_nRows) {
@@ -72,6 +448,233 @@ public:
 		}
 	}
 
+	///	<summary>
+	///		Add each of the given entries to the SparseMatrix, in order.
+	///	</summary>
+	void AddEntries(
+		const std::vector< SparseMatrixEntry<DataType> > & vecEntries
+	) {
+		static const int iCounterNonzeros =
+			AnnounceRegisterCounter("nonzeros inserted");
+
+		AnnounceCount(iCounterNonzeros, vecEntries.size());
+
+		for (size_t i = 0; i < vecEntries.size(); i++) {
+			(*this)(vecEntries[i].iRow, vecEntries[i].iCol) +=
+				vecEntries[i].value;
+		}
+	}
+
+	///	<summary>
+	///		Add the entries of each of vecEntryBuffers in turn and freeze
+	///		the SparseMatrix.  The buffers are released.
+	///	</summary>
+	void AssembleEntries(
+		std::vector< std::vector< SparseMatrixEntry<DataType> > > & vecEntryBuffers,
+		int nThreads = 1
+	) {
+		AssembleEntries(vecEntryBuffers, 0, vecEntryBuffers.size(), nThreads);
+	}
+
+	///	<summary>
+	///		Assemble vecEntryBuffers[ixBegin..ixEnd) with AssembleEntries()
+	///		if they hold at least as many entries as the SparseMatrix has
+	///		nonzeros, and return the index after the last buffer assembled.
+	///		Kernels that compute their entries in rounds call this after
+	///		each round, so that the entries held in buffers stay within the
+	///		size of the map while assembly remains linear in the number of
+	///		entries.
+	///	</summary>
+	size_t AssembleEntriesIfBuffered(
+		std::vector< std::vector< SparseMatrixEntry<DataType> > > & vecEntryBuffers,
+		size_t ixBegin,
+		size_t ixEnd,
+		int nThreads = 1
+	) {
+		size_t sEntries = 0;
+		for (size_t b = ixBegin; b < ixEnd; b++) {
+			sEntries += vecEntryBuffers[b].size();
+		}
+
+		if ((sEntries == 0) || (sEntries < GetNonZeroCount())) {
+			return ixBegin;
+		}
+
+		AssembleEntries(vecEntryBuffers, ixBegin, ixEnd, nThreads);
+
+		return ixEnd;
+	}
+
+	///	<summary>
+	///		Add the entries of each of vecEntryBuffers[ixBegin..ixEnd) in
+	///		turn and freeze the SparseMatrix.  The result is identical to
+	///		calling AddEntries() on each buffer followed by Freeze(), but if
+	///		the SparseMatrix is empty or frozen the CSR arrays are built
+	///		directly, with a stable counting sort of the entries by row
+	///		(after the entries already in that row) followed by a sort by
+	///		column and reduction of repeated entries within each row on
+	///		nThreads threads.  Entries may therefore be assembled in several
+	///		calls with the same result as one call.  The buffers are
+	///		released.
+	///	</summary>
+	void AssembleEntries(
+		std::vector< std::vector< SparseMatrixEntry<DataType> > > & vecEntryBuffers,
+		size_t ixBegin,
+		size_t ixEnd,
+		int nThreads
+	) {
+		typedef std::pair<int, DataType> ColumnValuePair;
+
+		static const int iCounterNonzeros =
+			AnnounceRegisterCounter("nonzeros inserted");
+
+		if (nThreads < 1) {
+			_EXCEPTIONT("Thread count must be at least 1");
+		}
+
+		// Entries already in the assembly map precede the buffers
+		if (!m_fFrozen && (GetNonZeroCount() != 0)) {
+			for (size_t b = ixBegin; b < ixEnd; b++) {
+				AddEntries(vecEntryBuffers[b]);
+
+				std::vector< SparseMatrixEntry<DataType> >().swap(
+					vecEntryBuffers[b]);
+			}
+			Freeze();
+			return;
+		}
+
+		// Dimensions and row counts
+		int nRows = m_nRows;
+		int nCols = m_nCols;
+		size_t sEntries = 0;
+
+		for (size_t b = ixBegin; b < ixEnd; b++) {
+			const std::vector< SparseMatrixEntry<DataType> > & vecEntries =
+				vecEntryBuffers[b];
+
+			for (size_t i = 0; i < vecEntries.size(); i++) {
+				if (vecEntries[i].iRow >= nRows) {
+					nRows = vecEntries[i].iRow + 1;
+				}
+				if (vecEntries[i].iCol >= nCols) {
+					nCols = vecEntries[i].iCol + 1;
+				}
+			}
+			sEntries += vecEntries.size();
+		}
+
+		AnnounceCount(iCounterNonzeros, sEntries);
+
+		// Entries already in the frozen SparseMatrix precede the buffers
+		const int nPreviousRows = (m_fFrozen)?(m_nRows):(0);
+
+		std::vector<size_t> vecRowBegin(nRows + 1, 0);
+		for (int i = 0; i < nPreviousRows; i++) {
+			vecRowBegin[i + 1] = m_vecRowPtr[i + 1] - m_vecRowPtr[i];
+		}
+		for (size_t b = ixBegin; b < ixEnd; b++) {
+			const std::vector< SparseMatrixEntry<DataType> > & vecEntries =
+				vecEntryBuffers[b];
+
+			for (size_t i = 0; i < vecEntries.size(); i++) {
+				vecRowBegin[vecEntries[i].iRow + 1]++;
+			}
+		}
+		for (int i = 0; i < nRows; i++) {
+			vecRowBegin[i+1] += vecRowBegin[i];
+		}
+
+		// Stable counting sort of entries by row, releasing each buffer
+		// once it has been sorted
+		std::vector<ColumnValuePair> vecSorted(vecRowBegin[nRows]);
+		{
+			std::vector<size_t> vecNext(
+				vecRowBegin.begin(), vecRowBegin.begin() + nRows);
+
+			for (int i = 0; i < nPreviousRows; i++) {
+				for (int k = m_vecRowPtr[i]; k < m_vecRowPtr[i + 1]; k++) {
+					vecSorted[vecNext[i]++] =
+						ColumnValuePair(m_vecColIx[k], m_vecValues[k]);
+				}
+			}
+
+			for (size_t b = ixBegin; b < ixEnd; b++) {
+				const std::vector< SparseMatrixEntry<DataType> > & vecEntries =
+					vecEntryBuffers[b];
+
+				for (size_t i = 0; i < vecEntries.size(); i++) {
+					vecSorted[vecNext[vecEntries[i].iRow]++] =
+						ColumnValuePair(vecEntries[i].iCol, vecEntries[i].value);
+				}
+
+				std::vector< SparseMatrixEntry<DataType> >().swap(
+					vecEntryBuffers[b]);
+			}
+		}
+
+		// Sort each row by column and sum repeated entries in order
+		std::vector<int> vecRowNonZeros(nRows, 0);
+
+#pragma omp parallel for schedule(dynamic, 1024) num_threads(nThreads)
+		for (int i = 0; i < nRows; i++) {
+			const size_t kBegin = vecRowBegin[i];
+			const size_t kEnd = vecRowBegin[i+1];
+
+			if (kBegin == kEnd) {
+				continue;
+			}
+
+			std::stable_sort(
+				vecSorted.begin() + kBegin,
+				vecSorted.begin() + kEnd,
+				CompareColumnValue);
+
+			size_t ix = kBegin;
+			vecSorted[ix].second = (DataType)(0) + vecSorted[kBegin].second;
+
+			for (size_t k = kBegin + 1; k < kEnd; k++) {
+				if (vecSorted[k].first == vecSorted[ix].first) {
+					vecSorted[ix].second += vecSorted[k].second;
+				} else {
+					ix++;
+					vecSorted[ix].first = vecSorted[k].first;
+					vecSorted[ix].second = (DataType)(0) + vecSorted[k].second;
+				}
+			}
+
+			vecRowNonZeros[i] = static_cast<int>(ix - kBegin + 1);
+		}
+
+		// Build the CSR arrays
+		ReleaseStorage();
+
+		m_nRows = nRows;
+		m_nCols = nCols;
+
+		m_vecRowPtr.Allocate(nRows + 1);
+		for (int i = 0; i < nRows; i++) {
+			m_vecRowPtr[i+1] = m_vecRowPtr[i] + vecRowNonZeros[i];
+		}
+
+		const size_t sNonZeros = m_vecRowPtr[nRows];
+
+		m_vecColIx.Allocate(sNonZeros, false);
+		m_vecValues.Allocate(sNonZeros, false);
+
+#pragma omp parallel for schedule(dynamic, 1024) num_threads(nThreads)
+		for (int i = 0; i < nRows; i++) {
+			const size_t kBegin = vecRowBegin[i];
+			for (int k = 0; k < vecRowNonZeros[i]; k++) {
+				m_vecColIx[m_vecRowPtr[i] + k] = vecSorted[kBegin + k].first;
+				m_vecValues[m_vecRowPtr[i] + k] = vecSorted[kBegin + k].second;
+			}
+		}
+
+		m_fFrozen = true;
+		m_nDistributedThreads = 0;
+	}
+
 	///	<summary>
 	///		Get the number of rows in the SparseMatrix.
 	///	</summary>
@@ -86,6 +689,46 @@ public:
 		return m_nCols;
 	}
 
+	///	<summary>
+	///		Get the number of nonzero entries in the SparseMatrix.
+	///	</summary>
+	size_t GetNonZeroCount() const {
+		if (m_fFrozen) {
+			return m_vecValues.GetRows();
+		}
+		return m_mapEntries.size();
+	}
+
+	///	<summary>
+	///		Get the CSR row pointer array (only valid once frozen).
+	///	</summary>
+	const DataArray1D<int> & GetRowPointers() const {
+		if (!m_fFrozen) {
+			_EXCEPTIONT("SparseMatrix must be frozen prior to CSR access");
+		}
+		return m_vecRowPtr;
+	}
+
+	///	<summary>
+	///		Get the CSR column index array (only valid once frozen).
+	///	</summary>
+	const DataArray1D<int> & GetColumnIndices() const {
+		if (!m_fFrozen) {
+			_EXCEPTIONT("SparseMatrix must be frozen prior to CSR access");
+		}
+		return m_vecColIx;
+	}
+
+	///	<summary>
+	///		Get the CSR value array (only valid once frozen).
+	///	</summary>
+	const DataArray1D<DataType> & GetValues() const {
+		if (!m_fFrozen) {
+			_EXCEPTIONT("SparseMatrix must be frozen prior to CSR access");
+		}
+		return m_vecValues;
+	}
+
 	///	<summary>
 	///		Get the entries of the SparseMatrix.
 	///	</summary>
@@ -94,6 +737,21 @@ public:
 		DataArray1D<int> & dataCols,
 		DataArray1D<DataType> & dataEntries
 	) const {
+		if (m_fFrozen) {
+			dataRows.Allocate(m_vecValues.GetRows());
+			dataCols.Allocate(m_vecValues.GetRows());
+			dataEntries.Allocate(m_vecValues.GetRows());
+
+			for (int i = 0; i < m_nRows; i++) {
+				for (int k = m_vecRowPtr[i]; k < m_vecRowPtr[i+1]; k++) {
+					dataRows[k] = i;
+					dataCols[k] = m_vecColIx[k];
+					dataEntries[k] = m_vecValues[k];
+				}
+			}
+			return;
+		}
+
 		dataRows.Allocate(m_mapEntries.size());
 		dataCols.Allocate(m_mapEntries.size());
 		dataEntries.Allocate(m_mapEntries.size());
@@ -111,7 +769,9 @@ public:
 	}
 
 	///	<summary>
-	///		Set the entries of the SparseMatrix in bulk.
+	///		Set the entries of the SparseMatrix in bulk.  The SparseMatrix
+	///		is built directly in frozen form.  If an entry is repeated only
+	///		the first instance is retained.
 	///	</summary>
 	void SetEntries(
 		const DataArray1D<int> & dataRows,
@@ -130,19 +790,361 @@ public:
 
 		m_mapEntries.clear();
 
-		for (unsigned i = 0; i < dataRows.GetRows(); i++) {
+		ReleaseStorage();
+
+		const size_t sEntries = dataRows.GetRows();
+
+		for (size_t i = 0; i < sEntries; i++) {
 			if (dataRows[i] >= m_nRows) {
 				m_nRows = dataRows[i] + 1;
 			}
 			if (dataCols[i] >= m_nCols) {
 				m_nCols = dataCols[i] + 1;
 			}
+		}
+
+		// Stable counting sort of entries by row
+		DataArray1D<int> vecRowPtr(m_nRows + 1);
+		for (size_t i = 0; i < sEntries; i++) {
+			vecRowPtr[dataRows[i] + 1]++;
+		}
+		for (int i = 0; i < m_nRows; i++) {
+			vecRowPtr[i+1] += vecRowPtr[i];
+		}
+
+		std::vector< std::pair<int, size_t> > vecSorted(sEntries);
+		{
+			std::vector<int> vecNext(&(vecRowPtr[0]), &(vecRowPtr[0]) + m_nRows);
+			for (size_t i = 0; i < sEntries; i++) {
+				vecSorted[vecNext[dataRows[i]]++] =
+					std::pair<int, size_t>(dataCols[i], i);
+			}
+		}
+
+		// Sort by column within each row and remove repeated entries
+		m_vecRowPtr.Allocate(m_nRows + 1);
+		m_vecColIx.Allocate(sEntries);
+		m_vecValues.Allocate(sEntries);
+
+		size_t ix = 0;
+		for (int i = 0; i < m_nRows; i++) {
+			std::stable_sort(
+				vecSorted.begin() + vecRowPtr[i],
+				vecSorted.begin() + vecRowPtr[i+1],
+				CompareColumn);
+
+			for (int k = vecRowPtr[i]; k < vecRowPtr[i+1]; k++) {
+				if ((ix != m_vecRowPtr[i]) &&
+				    (m_vecColIx[ix-1] == vecSorted[k].first)
+				) {
+					continue;
+				}
+				m_vecColIx[ix] = vecSorted[k].first;
+				m_vecValues[ix] = dataEntries[vecSorted[k].second];
+				ix++;
+			}
+			m_vecRowPtr[i+1] = ix;
+		}
+
+		// Shrink storage if repeated entries were removed
+		if (ix != sEntries) {
+			DataArray1D<int> vecColIx(m_vecColIx);
+			DataArray1D<DataType> vecValues(m_vecValues);
+
+			m_vecColIx.Allocate(ix);
+			m_vecValues.Allocate(ix);
+			for (size_t k = 0; k < ix; k++) {
+				m_vecColIx[k] = vecColIx[k];
+				m_vecValues[k] = vecValues[k];
+			}
+		}
+
+		m_fFrozen = true;
+		m_nDistributedThreads = 0;
+	}
+
+	///	<summary>
+	///		Set this SparseMatrix to a copy of smat with each entry
+	///		converted to DataType, built directly in frozen form.
+	///	</summary>
+	template <typename OtherType>
+	void SetConverted(
+		const SparseMatrix<OtherType> & smat
+	) {
+		if (!smat.IsFrozen()) {
+			SparseMatrix<OtherType> smatFrozen(smat);
+			smatFrozen.Freeze();
+			SetConverted(smatFrozen);
+			return;
+		}
+
+		const DataArray1D<int> & vecRowPtr = smat.GetRowPointers();
+		const DataArray1D<int> & vecColIx = smat.GetColumnIndices();
+		const DataArray1D<OtherType> & vecValues = smat.GetValues();
+
+		Clear();
+
+		m_nRows = smat.GetRows();
+		m_nCols = smat.GetColumns();
+
+		m_vecRowPtr = vecRowPtr;
+		m_vecColIx = vecColIx;
+
+		m_vecValues.Allocate(vecValues.GetRows());
+		for (size_t k = 0; k < vecValues.GetRows(); k++) {
+			m_vecValues[k] = static_cast<DataType>(vecValues[k]);
+		}
+
+		m_fFrozen = true;
+		m_nDistributedThreads = 0;
+	}
+
+	///	<summary>
+	///		Set this SparseMatrix to the product smatA * smatB, built row by
+	///		row in frozen form (Gustavson's algorithm).  Each entry of the
+	///		product is accumulated in a fixed order, so the result does not
+	///		depend on the number of threads.
+	///	</summary>
+	void SetProduct(
+		const SparseMatrix<DataType> & smatA,
+		const SparseMatrix<DataType> & smatB,
+		int nThreads = 1
+	) {
+		// Operands must be distinct from this object and frozen
+		if ((this == &smatA) || (this == &smatB)) {
+			SparseMatrix<DataType> smatProduct;
+			smatProduct.SetProduct(smatA, smatB, nThreads);
+			(*this) = smatProduct;
+			return;
+		}
+		if (!smatA.m_fFrozen) {
+			SparseMatrix<DataType> smatAFrozen(smatA);
+			smatAFrozen.Freeze();
+			SetProduct(smatAFrozen, smatB, nThreads);
+			return;
+		}
+		if (!smatB.m_fFrozen) {
+			SparseMatrix<DataType> smatBFrozen(smatB);
+			smatBFrozen.Freeze();
+			SetProduct(smatA, smatBFrozen, nThreads);
+			return;
+		}
+
+		const int nRows = smatA.m_nRows;
+		const int nCols = smatB.m_nCols;
+		const int nInner = smatB.m_nRows;
+
+		const int * pRowPtrA = smatA.m_vecRowPtr;
+		const int * pColIxA = smatA.m_vecColIx;
+		const DataType * pValuesA = smatA.m_vecValues;
+
+		const int * pRowPtrB = smatB.m_vecRowPtr;
+		const int * pColIxB = smatB.m_vecColIx;
+		const DataType * pValuesB = smatB.m_vecValues;
+
+		// Symbolic phase: count the nonzeros in each row of the product
+		std::vector<size_t> vecRowNonZeros(nRows + 1, 0);
+
+#pragma omp parallel num_threads(nThreads)
+		{
+			std::vector<int> vecMarker(nCols, -1);
+
+#pragma omp for schedule(dynamic, 256)
+			for (int i = 0; i < nRows; i++) {
+				size_t sNonZeros = 0;
+				for (int ka = pRowPtrA[i]; ka < pRowPtrA[i+1]; ka++) {
+					const int j = pColIxA[ka];
+					if (j >= nInner) {
+						continue;
+					}
+					for (int kb = pRowPtrB[j]; kb < pRowPtrB[j+1]; kb++) {
+						if (vecMarker[pColIxB[kb]] != i) {
+							vecMarker[pColIxB[kb]] = i;
+							sNonZeros++;
+						}
+					}
+				}
+				vecRowNonZeros[i+1] = sNonZeros;
+			}
+		}
+
+		for (int i = 0; i < nRows; i++) {
+			vecRowNonZeros[i+1] += vecRowNonZeros[i];
+		}
+		if (vecRowNonZeros[nRows] >
+		    static_cast<size_t>(std::numeric_limits<int>::max())
+		) {
+			_EXCEPTION1("SparseMatrix product has too many nonzeros (%lu)",
+				vecRowNonZeros[nRows]);
+		}
+
+		m_nRows = nRows;
+		m_nCols = nCols;
+		m_mapEntries.clear();
+
+		ReleaseStorage();
+
+		m_vecRowPtr.Allocate(nRows + 1);
+		m_vecColIx.Allocate(vecRowNonZeros[nRows]);
+		m_vecValues.Allocate(vecRowNonZeros[nRows]);
+
+		for (int i = 0; i <= nRows; i++) {
+			m_vecRowPtr[i] = static_cast<int>(vecRowNonZeros[i]);
+		}
+
+		int * pColIx = m_vecColIx;
+		DataType * pValues = m_vecValues;
+
+		// Numeric phase: accumulate each row into a dense work array
+#pragma omp parallel num_threads(nThreads)
+		{
+			std::vector<int> vecMarker(nCols, -1);
+			std::vector<DataType> vecAccumulator(nCols);
+
+#pragma omp for schedule(dynamic, 256)
+			for (int i = 0; i < nRows; i++) {
+				const int ixBegin = static_cast<int>(vecRowNonZeros[i]);
+
+				int ix = ixBegin;
+				for (int ka = pRowPtrA[i]; ka < pRowPtrA[i+1]; ka++) {
+					const int j = pColIxA[ka];
+					if (j >= nInner) {
+						continue;
+					}
+					const DataType dValueA = pValuesA[ka];
+					for (int kb = pRowPtrB[j]; kb < pRowPtrB[j+1]; kb++) {
+						const int iCol = pColIxB[kb];
+						if (vecMarker[iCol] != i) {
+							vecMarker[iCol] = i;
+							vecAccumulator[iCol] = dValueA * pValuesB[kb];
+							pColIx[ix++] = iCol;
+						} else {
+							vecAccumulator[iCol] += dValueA * pValuesB[kb];
+						}
+					}
+				}
+
+				std::sort(pColIx + ixBegin, pColIx + ix);
+
+				for (int k = ixBegin; k < ix; k++) {
+					pValues[k] = vecAccumulator[pColIx[k]];
+				}
+			}
+		}
+
+		m_fFrozen = true;
+		m_nDistributedThreads = 0;
+	}
+
+	///	<summary>
+	///		Set this SparseMatrix to the transpose of smat, built directly in
+	///		frozen form by a counting sort of the entries of smat by column.
+	///		If pRowScale and pColScale are given, entry (j,i) of the result
+	///		is smat(i,j) * ((*pRowScale)[i] / (*pColScale)[j]).  Rows of smat
+	///		are divided among threads and the entries of each column are
+	///		placed in row order, so the result does not depend on the number
+	///		of threads.
+	///	</summary>
+	void SetTranspose(
+		const SparseMatrix<DataType> & smat,
+		const DataArray1D<double> * pRowScale = NULL,
+		const DataArray1D<double> * pColScale = NULL,
+		int nThreads = 1
+	) {
+		// Operand must be distinct from this object and frozen
+		if (this == &smat) {
+			SparseMatrix<DataType> smatTranspose;
+			smatTranspose.SetTranspose(smat, pRowScale, pColScale, nThreads);
+			(*this) = smatTranspose;
+			return;
+		}
+		if (!smat.m_fFrozen) {
+			SparseMatrix<DataType> smatFrozen(smat);
+			smatFrozen.Freeze();
+			SetTranspose(smatFrozen, pRowScale, pColScale, nThreads);
+			return;
+		}
+		if (nThreads < 1) {
+			_EXCEPTION1("Invalid thread count (%i)", nThreads);
+		}
+		if ((pRowScale == NULL) != (pColScale == NULL)) {
+			_EXCEPTIONT("Row and column scaling must be given together");
+		}
+		if ((pRowScale != NULL) && (
+		    (pRowScale->GetRows() < static_cast<size_t>(smat.m_nRows)) ||
+		    (pColScale->GetRows() < static_cast<size_t>(smat.m_nCols)))
+		) {
+			_EXCEPTIONT("Scaling arrays are smaller than the SparseMatrix");
+		}
+
+		const int nRows = smat.m_nCols;
+		const int nCols = smat.m_nRows;
+		const size_t sEntries = smat.GetNonZeroCount();
+
+		const int * pRowPtrIn = smat.m_vecRowPtr;
+		const int * pColIxIn = smat.m_vecColIx;
+		const DataType * pValuesIn = smat.m_vecValues;
+
+		std::vector<int> vecRowBegin;
+		smat.GetRowPartition(nThreads, vecRowBegin);
+
+		// Count the entries of each column of smat in each partition
+		std::vector< std::vector<int> > vecCount(nThreads);
+
+#pragma omp parallel for num_threads(nThreads) schedule(static, 1)
+		for (int p = 0; p < nThreads; p++) {
+			vecCount[p].resize(nRows, 0);
+			for (int k = pRowPtrIn[vecRowBegin[p]]; k < pRowPtrIn[vecRowBegin[p+1]]; k++) {
+				vecCount[p][pColIxIn[k]]++;
+			}
+		}
+
+		// Offsets of each partition within each row of the transpose
+		m_nRows = nRows;
+		m_nCols = nCols;
+		m_mapEntries.clear();
+
+		ReleaseStorage();
+
+		m_vecRowPtr.Allocate(nRows + 1);
+		m_vecColIx.Allocate(sEntries, false);
+		m_vecValues.Allocate(sEntries, false);
+
+		int ix = 0;
+		for (int j = 0; j < nRows; j++) {
+			m_vecRowPtr[j] = ix;
+			for (int p = 0; p < nThreads; p++) {
+				const int nCount = vecCount[p][j];
+				vecCount[p][j] = ix;
+				ix += nCount;
+			}
+		}
+		m_vecRowPtr[nRows] = ix;
 
-			m_mapEntries.insert(
-				SparseMapPair(
-					IndexType(dataRows[i], dataCols[i]),
-						dataEntries[i]));
+		int * pColIx = m_vecColIx;
+		DataType * pValues = m_vecValues;
+
+		// Scatter the entries of each partition
+#pragma omp parallel for num_threads(nThreads) schedule(static, 1)
+		for (int p = 0; p < nThreads; p++) {
+			std::vector<int> & vecNext = vecCount[p];
+			for (int i = vecRowBegin[p]; i < vecRowBegin[p+1]; i++) {
+				for (int k = pRowPtrIn[i]; k < pRowPtrIn[i+1]; k++) {
+					const int j = pColIxIn[k];
+					const int ixOut = vecNext[j]++;
+					pColIx[ixOut] = i;
+					if (pRowScale != NULL) {
+						pValues[ixOut] = static_cast<DataType>(
+							pValuesIn[k] * ((*pRowScale)[i] / (*pColScale)[j]));
+					} else {
+						pValues[ixOut] = pValuesIn[k];
+					}
+				}
+			}
 		}
+
+		m_fFrozen = true;
+		m_nDistributedThreads = 0;
 	}
 
 public:
@@ -163,6 +1165,17 @@ public:
 */
 		dataVectorOut.Zero();
 
+		if (m_fFrozen) {
+			for (int i = 0; i < m_nRows; i++) {
+				DataType dSum = static_cast<DataType>(0);
+				for (int k = m_vecRowPtr[i]; k < m_vecRowPtr[i+1]; k++) {
+					dSum += m_vecValues[k] * dataVectorIn[m_vecColIx[k]];
+				}
+				dataVectorOut[i] = dSum;
+			}
+			return;
+		}
+
 		SparseMapConstIterator iter = m_mapEntries.begin();
 		for (; iter != m_mapEntries.end(); iter++) {
 			dataVectorOut[iter->first.first] +=
@@ -170,6 +1183,268 @@ public:
 		}
 	}
 
+	///	<summary>
+	///		Apply the sparse matrix to a block of vectors.  Each row of
+	///		dataBlockIn is one input vector (GetColumns() entries) and each
+	///		row of dataBlockOut receives the corresponding output vector
+	///		(GetRows() entries).  The matrix is traversed once per block of
+	///		ApplyBlockSize vectors rather than once per vector.
+	///	</summary>
+	void Apply(
+		const DataArray2D<DataType> & dataBlockIn,
+		DataArray2D<DataType> & dataBlockOut,
+		int nThreads = 1
+	) const {
+		if (dataBlockIn.GetRows() != dataBlockOut.GetRows()) {
+			_EXCEPTIONT("Mismatch in number of vectors in block Apply");
+		}
+
+		const int nVectors = static_cast<int>(dataBlockIn.GetRows());
+
+		if (nVectors == 0) {
+			return;
+		}
+
+		dataBlockOut.Zero();
+
+		// Assembly form: stream the map once for all vectors
+		if (!m_fFrozen) {
+			SparseMapConstIterator iter = m_mapEntries.begin();
+			for (; iter != m_mapEntries.end(); iter++) {
+				const int iRow = iter->first.first;
+				const int iCol = iter->first.second;
+				for (int v = 0; v < nVectors; v++) {
+					dataBlockOut(v)[iRow] += iter->second * dataBlockIn(v)[iCol];
+				}
+			}
+			return;
+		}
+
+		// Frozen form: register-blocked traversal of the CSR arrays
+		int v = 0;
+		for (; v + 8 <= nVectors; v += 8) {
+			ApplyBlock<8>(dataBlockIn, dataBlockOut, v, nThreads);
+		}
+		if (v + 4 <= nVectors) {
+			ApplyBlock<4>(dataBlockIn, dataBlockOut, v, nThreads);
+			v += 4;
+		}
+		if (v + 2 <= nVectors) {
+			ApplyBlock<2>(dataBlockIn, dataBlockOut, v, nThreads);
+			v += 2;
+		}
+		if (v + 1 <= nVectors) {
+			ApplyBlock<1>(dataBlockIn, dataBlockOut, v, nThreads);
+		}
+	}
+
+	///	<summary>
+	///		Apply the frozen sparse matrix to nVectors vectors stored in
+	///		caller-owned memory.  Entry i of input vector v is located at
+	///		pIn[v * sVectorStrideIn + i * sEntryStrideIn], and similarly for
+	///		the output; strides are given in elements and may be arbitrary,
+	///		so that column-major or sliced arrays can be used without a
+	///		copy.  Products are accumulated in AccumType, so that a single
+	///		precision matrix may be applied with a double precision
+	///		accumulator, and the output may be of a different type than the
+	///		input, so that no conversion pass is needed.  nOutRows entries
+	///		are written per output vector; rows beyond GetRows() are set to
+	///		zero.  The input and output must not overlap.
+	///	</summary>
+	template <
+		typename ValueType,
+		typename AccumType = DataType,
+		typename OutType = ValueType>
+	void Apply(
+		const ValueType * pIn,
+		ptrdiff_t sVectorStrideIn,
+		ptrdiff_t sEntryStrideIn,
+		OutType * pOut,
+		ptrdiff_t sVectorStrideOut,
+		ptrdiff_t sEntryStrideOut,
+		int nVectors,
+		int nOutRows,
+		int nThreads = 1
+	) const {
+		if (!m_fFrozen) {
+			_EXCEPTIONT("SparseMatrix must be frozen to Apply to strided data");
+		}
+		if (nOutRows < m_nRows) {
+			_EXCEPTION2("Output vectors too short for SparseMatrix (%i < %i)",
+				nOutRows, m_nRows);
+		}
+
+		int v = 0;
+		for (; v + 8 <= nVectors; v += 8) {
+			ApplyStridedBlock<8, ValueType, AccumType, OutType>(
+				pIn + v * sVectorStrideIn, sVectorStrideIn, sEntryStrideIn,
+				pOut + v * sVectorStrideOut, sVectorStrideOut, sEntryStrideOut,
+				nThreads);
+		}
+		if (v + 4 <= nVectors) {
+			ApplyStridedBlock<4, ValueType, AccumType, OutType>(
+				pIn + v * sVectorStrideIn, sVectorStrideIn, sEntryStrideIn,
+				pOut + v * sVectorStrideOut, sVectorStrideOut, sEntryStrideOut,
+				nThreads);
+			v += 4;
+		}
+		if (v + 2 <= nVectors) {
+			ApplyStridedBlock<2, ValueType, AccumType, OutType>(
+				pIn + v * sVectorStrideIn, sVectorStrideIn, sEntryStrideIn,
+				pOut + v * sVectorStrideOut, sVectorStrideOut, sEntryStrideOut,
+				nThreads);
+			v += 2;
+		}
+		if (v + 1 <= nVectors) {
+			ApplyStridedBlock<1, ValueType, AccumType, OutType>(
+				pIn + v * sVectorStrideIn, sVectorStrideIn, sEntryStrideIn,
+				pOut + v * sVectorStrideOut, sVectorStrideOut, sEntryStrideOut,
+				nThreads);
+		}
+
+		// Zero rows of the output that have no entries in the matrix
+		if (nOutRows > m_nRows) {
+			for (v = 0; v < nVectors; v++) {
+				OutType * pOutV = pOut + v * sVectorStrideOut;
+				for (int i = m_nRows; i < nOutRows; i++) {
+					pOutV[i * sEntryStrideOut] = static_cast<OutType>(0);
+				}
+			}
+		}
+	}
+
+protected:
+	///	<summary>
+	///		Apply the frozen sparse matrix to nBlock consecutive vectors
+	///		of a block, starting at vector iFirst.
+	///	</summary>
+	template <int nBlock>
+	void ApplyBlock(
+		const DataArray2D<DataType> & dataBlockIn,
+		DataArray2D<DataType> & dataBlockOut,
+		int iFirst,
+		int nThreads
+	) const {
+		const DataType * pIn[nBlock];
+		DataType * pOut[nBlock];
+		for (int b = 0; b < nBlock; b++) {
+			pIn[b] = dataBlockIn(iFirst + b);
+			pOut[b] = dataBlockOut(iFirst + b);
+		}
+
+		const int * pRowPtr = m_vecRowPtr;
+		const int * pColIx = m_vecColIx;
+		const DataType * pValues = m_vecValues;
+
+		std::vector<int> vecRowBegin;
+		GetRowPartition(nThreads, vecRowBegin);
+
+#pragma omp parallel for num_threads(nThreads) schedule(static, 1)
+		for (int p = 0; p < nThreads; p++) {
+			for (int i = vecRowBegin[p]; i < vecRowBegin[p+1]; i++) {
+				DataType dSum[nBlock];
+				for (int b = 0; b < nBlock; b++) {
+					dSum[b] = static_cast<DataType>(0);
+				}
+				for (int k = pRowPtr[i]; k < pRowPtr[i+1]; k++) {
+					const DataType dValue = pValues[k];
+					const int iCol = pColIx[k];
+					for (int b = 0; b < nBlock; b++) {
+						dSum[b] += dValue * pIn[b][iCol];
+					}
+				}
+				for (int b = 0; b < nBlock; b++) {
+					pOut[b][i] = dSum[b];
+				}
+			}
+		}
+	}
+
+	///	<summary>
+	///		Apply the frozen sparse matrix to nBlock strided vectors in
+	///		caller-owned memory.
+	///	</summary>
+	template <
+		int nBlock,
+		typename ValueType,
+		typename AccumType,
+		typename OutType>
+	void ApplyStridedBlock(
+		const ValueType * pIn,
+		ptrdiff_t sVectorStrideIn,
+		ptrdiff_t sEntryStrideIn,
+		OutType * pOut,
+		ptrdiff_t sVectorStrideOut,
+		ptrdiff_t sEntryStrideOut,
+		int nThreads
+	) const {
+		const int * pRowPtr = m_vecRowPtr;
+		const int * pColIx = m_vecColIx;
+		const DataType * pValues = m_vecValues;
+
+		std::vector<int> vecRowBegin;
+		GetRowPartition(nThreads, vecRowBegin);
+
+#pragma omp parallel for num_threads(nThreads) schedule(static, 1)
+		for (int p = 0; p < nThreads; p++) {
+			for (int i = vecRowBegin[p]; i < vecRowBegin[p+1]; i++) {
+				AccumType dSum[nBlock];
+				for (int b = 0; b < nBlock; b++) {
+					dSum[b] = static_cast<AccumType>(0);
+				}
+				for (int k = pRowPtr[i]; k < pRowPtr[i+1]; k++) {
+					const AccumType dValue = static_cast<AccumType>(pValues[k]);
+					const ValueType * pInCol = pIn + pColIx[k] * sEntryStrideIn;
+					for (int b = 0; b < nBlock; b++) {
+						dSum[b] += dValue *
+							static_cast<AccumType>(pInCol[b * sVectorStrideIn]);
+					}
+				}
+				OutType * pOutRow = pOut + i * sEntryStrideOut;
+				for (int b = 0; b < nBlock; b++) {
+					pOutRow[b * sVectorStrideOut] = static_cast<OutType>(dSum[b]);
+				}
+			}
+		}
+	}
+
+protected:
+	///	<summary>
+	///		Release the CSR arrays, detaching rather than freeing external
+	///		storage, and leave them empty.
+	///	</summary>
+	void ReleaseStorage() {
+		m_vecRowPtr.Detach();
+		m_vecColIx.Detach();
+		m_vecValues.Detach();
+
+		m_vecRowPtr.SetSize(0);
+		m_vecColIx.SetSize(0);
+		m_vecValues.SetSize(0);
+
+		m_fExternalStorage = false;
+	}
+
+	///	<summary>
+	///		Comparator for sorting (column, entry) pairs by column.
+	///	</summary>
+	static bool CompareColumn(
+		const std::pair<int, size_t> & a,
+		const std::pair<int, size_t> & b
+	) {
+		return (a.first < b.first);
+	}
+
+	///	<summary>
+	///		Comparator for sorting (column, value) pairs by column.
+	///	</summary>
+	static bool CompareColumnValue(
+		const std::pair<int, DataType> & a,
+		const std::pair<int, DataType> & b
+	) {
+		return (a.first < b.first);
+	}
+
 protected:
 	///	<summary>
 	///		Number of rows in the sparse matrix.
@@ -182,9 +1457,41 @@ protected:
 	int m_nCols;
 
 	///	<summary>
-	///		Entries of the sparse matrix.
+	///		Entries of the sparse matrix during the assembly phase.
 	///	</summary>
 	SparseMap m_mapEntries;
+
+	///	<summary>
+	///		A flag indicating the sparse matrix is in frozen (CSR) form.
+	///	</summary>
+	bool m_fFrozen;
+
+	///	<summary>
+	///		CSR row pointers (size m_nRows + 1).
+	///	</summary>
+	DataArray1D<int> m_vecRowPtr;
+
+	///	<summary>
+	///		CSR column indices.
+	///	</summary>
+	DataArray1D<int> m_vecColIx;
+
+	///	<summary>
+	///		CSR values.
+	///	</summary>
+	DataArray1D<DataType> m_vecValues;
+
+	///	<summary>
+	///		A flag indicating the CSR arrays are attached to external
+	///		storage that is not owned by this SparseMatrix.
+	///	</summary>
+	bool m_fExternalStorage;
+
+	///	<summary>
+	///		Number of threads the CSR arrays were distributed over by
+	///		Distribute(), or zero.
+	///	</summary>
+	int m_nDistributedThreads;
 };
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,411 @@
+///////////////////////////////////////////////////////////////////////////////
+///
+///	\file    SparseMatrixDevice.cpp
+///	\author  agent
+///	\version October 14, 2026
+///
+///	<remarks>
+///		Copyright 2026 agent
+///
+///		This file is distributed as part of the Tempest source code package.
+///		Permission is granted to use, copy, modify and distribute this
+///		source code and its documentation under the terms of the GNU General
+///		Public License.  This software is provided "as is" without express
+///		or implied warranty.
+///	</remarks>
+
+#include "SparseMatrixDevice.h"
+
+#include <cstring>
+
+#if defined(TEMPEST_CUSPARSE)
+#include <cuda_runtime.h>
+#include <cusparse.h>
+#endif
+
+///////////////////////////////////////////////////////////////////////////////
+
+#if defined(TEMPEST_CUSPARSE)
+
+#define _CUDACHECK(call) \
+	{ \
+		cudaError_t errCuda = (call); \
+		if (errCuda != cudaSuccess) { \
+			_EXCEPTION2("CUDA error in %s: %s", \
+				#call, cudaGetErrorString(errCuda)); \
+		} \
+	}
+
+#define _CUSPARSECHECK(call) \
+	{ \
+		cusparseStatus_t errCusparse = (call); \
+		if (errCusparse != CUSPARSE_STATUS_SUCCESS) { \
+			_EXCEPTION2("cuSPARSE error in %s: %s", \
+				#call, cusparseGetErrorString(errCusparse)); \
+		} \
+	}
+
+///////////////////////////////////////////////////////////////////////////////
+
+struct SparseMatrixDevice::DeviceState {
+
+	///	<summary>
+	///		Constructor.
+	///	</summary>
+	DeviceState() :
+		stream(NULL),
+		handle(NULL),
+		matA(NULL),
+		pRowPtr(NULL),
+		pColIx(NULL),
+		pValues(NULL),
+		pIn(NULL),
+		pOut(NULL),
+		pBuffer(NULL),
+		sBufferSize(0)
+	{ }
+
+	///	<summary>
+	///		Stream on which all copies and products are issued.
+	///	</summary>
+	cudaStream_t stream;
+
+	///	<summary>
+	///		cuSPARSE handle bound to stream.
+	///	</summary>
+	cusparseHandle_t handle;
+
+	///	<summary>
+	///		Descriptor of the CSR matrix.
+	///	</summary>
+	cusparseSpMatDescr_t matA;
+
+	///	<summary>
+	///		CSR arrays.
+	///	</summary>
+	int * pRowPtr;
+	int * pColIx;
+	double * pValues;
+
+	///	<summary>
+	///		Dense input and output vectors, one vector per column.
+	///	</summary>
+	double * pIn;
+	double * pOut;
+
+	///	<summary>
+	///		Work buffer of cusparseSpMM().
+	///	</summary>
+	void * pBuffer;
+	size_t sBufferSize;
+};
+
+#endif
+
+///////////////////////////////////////////////////////////////////////////////
+
+SparseMatrixDevice::SparseMatrixDevice() :
+	m_nRows(0),
+	m_nCols(0),
+	m_sNonZeros(0),
+	m_fUploaded(false),
+	m_nStagingVectors(0),
+	m_pHostIn(NULL),
+	m_pHostOut(NULL),
+	m_pDevice(NULL)
+{ }
+
+///////////////////////////////////////////////////////////////////////////////
+
+SparseMatrixDevice::SparseMatrixDevice(
+	const SparseMatrixDevice &
+) :
+	m_nRows(0),
+	m_nCols(0),
+	m_sNonZeros(0),
+	m_fUploaded(false),
+	m_nStagingVectors(0),
+	m_pHostIn(NULL),
+	m_pHostOut(NULL),
+	m_pDevice(NULL)
+{ }
+
+///////////////////////////////////////////////////////////////////////////////
+
+SparseMatrixDevice & SparseMatrixDevice::operator=(
+	const SparseMatrixDevice & smat
+) {
+	if (&smat != this) {
+		Release();
+	}
+	return (*this);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+SparseMatrixDevice::~SparseMatrixDevice() {
+	try {
+		Release();
+	} catch(...) {
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+bool SparseMatrixDevice::IsAvailable() {
+#if defined(TEMPEST_CUSPARSE)
+	int nDevices = 0;
+	if (cudaGetDeviceCount(&nDevices) != cudaSuccess) {
+		return false;
+	}
+	return (nDevices > 0);
+#else
+	return false;
+#endif
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void SparseMatrixDevice::Release() {
+#if defined(TEMPEST_CUSPARSE)
+	if (m_pDevice != NULL) {
+		DeviceState & dev = *m_pDevice;
+
+		if (dev.stream != NULL) {
+			cudaStreamSynchronize(dev.stream);
+		}
+		if (dev.matA != NULL) {
+			cusparseDestroySpMat(dev.matA);
+		}
+		if (dev.handle != NULL) {
+			cusparseDestroy(dev.handle);
+		}
+		cudaFree(dev.pRowPtr);
+		cudaFree(dev.pColIx);
+		cudaFree(dev.pValues);
+		cudaFree(dev.pIn);
+		cudaFree(dev.pOut);
+		cudaFree(dev.pBuffer);
+		if (dev.stream != NULL) {
+			cudaStreamDestroy(dev.stream);
+		}
+
+		delete m_pDevice;
+		m_pDevice = NULL;
+	}
+	if (m_pHostIn != NULL) {
+		cudaFreeHost(m_pHostIn);
+	}
+	if (m_pHostOut != NULL) {
+		cudaFreeHost(m_pHostOut);
+	}
+#endif
+
+	m_nRows = 0;
+	m_nCols = 0;
+	m_sNonZeros = 0;
+	m_fUploaded = false;
+	m_nStagingVectors = 0;
+	m_pHostIn = NULL;
+	m_pHostOut = NULL;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void SparseMatrixDevice::UploadCSR(
+	int nRows,
+	int nCols,
+	size_t sNonZeros,
+	const int * pRowPtr,
+	const int * pColIx,
+	const double * pValues
+) {
+#if defined(TEMPEST_CUSPARSE)
+	Release();
+
+	m_pDevice = new DeviceState;
+	DeviceState & dev = *m_pDevice;
+
+	_CUDACHECK(cudaStreamCreate(&(dev.stream)));
+	_CUSPARSECHECK(cusparseCreate(&(dev.handle)));
+	_CUSPARSECHECK(cusparseSetStream(dev.handle, dev.stream));
+
+	// One-time upload of the CSR arrays
+	const size_t sRowPtrBytes = sizeof(int) * (static_cast<size_t>(nRows) + 1);
+
+	_CUDACHECK(cudaMalloc(
+		reinterpret_cast<void **>(&(dev.pRowPtr)), sRowPtrBytes));
+	_CUDACHECK(cudaMemcpy(
+		dev.pRowPtr, pRowPtr, sRowPtrBytes, cudaMemcpyHostToDevice));
+
+	if (sNonZeros != 0) {
+		_CUDACHECK(cudaMalloc(
+			reinterpret_cast<void **>(&(dev.pColIx)),
+			sizeof(int) * sNonZeros));
+		_CUDACHECK(cudaMalloc(
+			reinterpret_cast<void **>(&(dev.pValues)),
+			sizeof(double) * sNonZeros));
+		_CUDACHECK(cudaMemcpy(
+			dev.pColIx, pColIx, sizeof(int) * sNonZeros,
+			cudaMemcpyHostToDevice));
+		_CUDACHECK(cudaMemcpy(
+			dev.pValues, pValues, sizeof(double) * sNonZeros,
+			cudaMemcpyHostToDevice));
+
+		_CUSPARSECHECK(cusparseCreateCsr(
+			&(dev.matA),
+			nRows,
+			nCols,
+			static_cast<int64_t>(sNonZeros),
+			dev.pRowPtr,
+			dev.pColIx,
+			dev.pValues,
+			CUSPARSE_INDEX_32I,
+			CUSPARSE_INDEX_32I,
+			CUSPARSE_INDEX_BASE_ZERO,
+			CUDA_R_64F));
+	}
+
+	m_nRows = nRows;
+	m_nCols = nCols;
+	m_sNonZeros = sNonZeros;
+	m_fUploaded = true;
+#else
+	(void)nRows;
+	(void)nCols;
+	(void)sNonZeros;
+	(void)pRowPtr;
+	(void)pColIx;
+	(void)pValues;
+	_EXCEPTIONT("SparseMatrixDevice requires a build with TEMPEST_CUSPARSE");
+#endif
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void SparseMatrixDevice::ReserveStaging(
+	int nVectors
+) {
+	if (nVectors <= m_nStagingVectors) {
+		return;
+	}
+
+#if defined(TEMPEST_CUSPARSE)
+	DeviceState & dev = *m_pDevice;
+
+	// Buffers may still be in use by an earlier product
+	_CUDACHECK(cudaStreamSynchronize(dev.stream));
+
+	if (m_pHostIn != NULL) {
+		_CUDACHECK(cudaFreeHost(m_pHostIn));
+		m_pHostIn = NULL;
+	}
+	if (m_pHostOut != NULL) {
+		_CUDACHECK(cudaFreeHost(m_pHostOut));
+		m_pHostOut = NULL;
+	}
+	_CUDACHECK(cudaFree(dev.pIn));
+	_CUDACHECK(cudaFree(dev.pOut));
+	dev.pIn = NULL;
+	dev.pOut = NULL;
+	m_nStagingVectors = 0;
+
+	const size_t sInBytes =
+		sizeof(double) * static_cast<size_t>(nVectors) * m_nCols;
+	const size_t sOutBytes =
+		sizeof(double) * static_cast<size_t>(nVectors) * m_nRows;
+
+	_CUDACHECK(cudaMallocHost(
+		reinterpret_cast<void **>(&m_pHostIn), sInBytes));
+	_CUDACHECK(cudaMallocHost(
+		reinterpret_cast<void **>(&m_pHostOut), sOutBytes));
+	_CUDACHECK(cudaMalloc(
+		reinterpret_cast<void **>(&(dev.pIn)), sInBytes));
+	_CUDACHECK(cudaMalloc(
+		reinterpret_cast<void **>(&(dev.pOut)), sOutBytes));
+
+	m_nStagingVectors = nVectors;
+#else
+	_EXCEPTIONT("SparseMatrixDevice requires a build with TEMPEST_CUSPARSE");
+#endif
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void SparseMatrixDevice::ApplyStaged(
+	int nVectors
+) {
+#if defined(TEMPEST_CUSPARSE)
+	DeviceState & dev = *m_pDevice;
+
+	const size_t sInBytes =
+		sizeof(double) * static_cast<size_t>(nVectors) * m_nCols;
+	const size_t sOutBytes =
+		sizeof(double) * static_cast<size_t>(nVectors) * m_nRows;
+
+	// A matrix without entries maps every vector to zero
+	if (m_sNonZeros == 0) {
+		memset(m_pHostOut, 0, sOutBytes);
+		return;
+	}
+
+	_CUDACHECK(cudaMemcpyAsync(
+		dev.pIn, m_pHostIn, sInBytes,
+		cudaMemcpyHostToDevice, dev.stream));
+
+	// Vectors are the columns of column-major dense matrices
+	cusparseDnMatDescr_t matB;
+	cusparseDnMatDescr_t matC;
+
+	_CUSPARSECHECK(cusparseCreateDnMat(
+		&matB, m_nCols, nVectors, m_nCols,
+		dev.pIn, CUDA_R_64F, CUSPARSE_ORDER_COL));
+	_CUSPARSECHECK(cusparseCreateDnMat(
+		&matC, m_nRows, nVectors, m_nRows,
+		dev.pOut, CUDA_R_64F, CUSPARSE_ORDER_COL));
+
+	double dAlpha = 1.0;
+	double dBeta = 0.0;
+
+	size_t sBufferSize = 0;
+	_CUSPARSECHECK(cusparseSpMM_bufferSize(
+		dev.handle,
+		CUSPARSE_OPERATION_NON_TRANSPOSE,
+		CUSPARSE_OPERATION_NON_TRANSPOSE,
+		&dAlpha, dev.matA, matB, &dBeta, matC,
+		CUDA_R_64F, CUSPARSE_SPMM_CSR_ALG1,
+		&sBufferSize));
+
+	if (sBufferSize > dev.sBufferSize) {
+		_CUDACHECK(cudaStreamSynchronize(dev.stream));
+		_CUDACHECK(cudaFree(dev.pBuffer));
+		dev.pBuffer = NULL;
+		dev.sBufferSize = 0;
+		_CUDACHECK(cudaMalloc(&(dev.pBuffer), sBufferSize));
+		dev.sBufferSize = sBufferSize;
+	}
+
+	_CUSPARSECHECK(cusparseSpMM(
+		dev.handle,
+		CUSPARSE_OPERATION_NON_TRANSPOSE,
+		CUSPARSE_OPERATION_NON_TRANSPOSE,
+		&dAlpha, dev.matA, matB, &dBeta, matC,
+		CUDA_R_64F, CUSPARSE_SPMM_CSR_ALG1,
+		dev.pBuffer));
+
+	_CUDACHECK(cudaMemcpyAsync(
+		m_pHostOut, dev.pOut, sOutBytes,
+		cudaMemcpyDeviceToHost, dev.stream));
+
+	_CUDACHECK(cudaStreamSynchronize(dev.stream));
+
+	_CUSPARSECHECK(cusparseDestroyDnMat(matB));
+	_CUSPARSECHECK(cusparseDestroyDnMat(matC));
+#else
+	(void)nVectors;
+	_EXCEPTIONT("SparseMatrixDevice requires a build with TEMPEST_CUSPARSE");
+#endif
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
@@ -0,0 +1,251 @@
+///////////////////////////////////////////////////////////////////////////////
+///
+///	\file    SparseMatrixDevice.h
+///	\author  agent
+///	\version October 14, 2026
+///
+///	<remarks>
+///		Copyright 2026 agent
+///
+///		This file is distributed as part of the Tempest source code package.
+///		Permission is granted to use, copy, modify and distribute this
+///		source code and its documentation under the terms of the GNU General
+///		Public License.  This software is provided "as is" without express
+///		or implied warranty.
+///	</remarks>
+
+#ifndef _SPARSEMATRIXDEVICE_H_
+#define _SPARSEMATRIXDEVICE_H_
+
+#include "SparseMatrix.h"
+#include "Exception.h"
+
+#include <cstddef>
+#include <vector>
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		A copy of a frozen SparseMatrix in GPU memory, applied to blocks of
+///		vectors with cuSPARSE.  The CSR arrays are uploaded once by Upload()
+///		and vectors are staged through pinned host buffers that are reused
+///		across calls to Apply().  Weights are stored and products are
+///		accumulated in double precision on the device, using the
+///		deterministic non-transposed CSR algorithm of cusparseSpMM(), so
+///		results are bitwise reproducible from run to run but may differ
+///		from the CPU path in the last bits.
+///
+///		Device support requires building with TEMPEST_CUSPARSE.  Otherwise
+///		IsAvailable() returns false and Upload() throws an Exception.
+///	</summary>
+class SparseMatrixDevice {
+
+public:
+	///	<summary>
+	///		Constructor.
+	///	</summary>
+	SparseMatrixDevice();
+
+	///	<summary>
+	///		Copy constructor.  Device resources are never shared, so the
+	///		copy is not uploaded.
+	///	</summary>
+	SparseMatrixDevice(const SparseMatrixDevice &);
+
+	///	<summary>
+	///		Assignment operator.  Releases this matrix, which is left not
+	///		uploaded.
+	///	</summary>
+	SparseMatrixDevice & operator=(const SparseMatrixDevice &);
+
+	///	<summary>
+	///		Destructor.
+	///	</summary>
+	~SparseMatrixDevice();
+
+public:
+	///	<summary>
+	///		Determine if this build supports device application and a
+	///		device is present.
+	///	</summary>
+	static bool IsAvailable();
+
+	///	<summary>
+	///		Upload the frozen SparseMatrix smat to the device as an nRows x
+	///		nCols matrix, which must contain every entry of smat.  Weights
+	///		are converted to double precision.  Any previously uploaded
+	///		matrix is released.
+	///	</summary>
+	template <typename DataType>
+	void Upload(
+		const SparseMatrix<DataType> & smat,
+		int nRows,
+		int nCols
+	) {
+		if ((nRows < smat.GetRows()) || (nCols < smat.GetColumns())) {
+			_EXCEPTION4("Device matrix (%i x %i) smaller than SparseMatrix "
+				"(%i x %i)", nRows, nCols, smat.GetRows(), smat.GetColumns());
+		}
+
+		const DataArray1D<int> & vecRowPtr = smat.GetRowPointers();
+		const DataArray1D<int> & vecColIx = smat.GetColumnIndices();
+		const DataArray1D<DataType> & vecValues = smat.GetValues();
+
+		// Rows of the device matrix beyond those of smat are empty
+		const int nSourceRows = smat.GetRows();
+		const size_t sNonZeros = vecValues.GetRows();
+
+		std::vector<int> vecDeviceRowPtr(nRows + 1);
+		for (int i = 0; i <= nSourceRows; i++) {
+			vecDeviceRowPtr[i] = vecRowPtr[i];
+		}
+		for (int i = nSourceRows + 1; i <= nRows; i++) {
+			vecDeviceRowPtr[i] = static_cast<int>(sNonZeros);
+		}
+
+		std::vector<double> vecDeviceValues(sNonZeros);
+		for (size_t k = 0; k < sNonZeros; k++) {
+			vecDeviceValues[k] = static_cast<double>(vecValues[k]);
+		}
+
+		UploadCSR(
+			nRows,
+			nCols,
+			sNonZeros,
+			&(vecDeviceRowPtr[0]),
+			(sNonZeros == 0)?(NULL):(&(vecColIx[0])),
+			(sNonZeros == 0)?(NULL):(&(vecDeviceValues[0])));
+	}
+
+	///	<summary>
+	///		Determine if a matrix has been uploaded.
+	///	</summary>
+	bool IsUploaded() const {
+		return m_fUploaded;
+	}
+
+	///	<summary>
+	///		Release the device matrix and the staging buffers.
+	///	</summary>
+	void Release();
+
+	///	<summary>
+	///		Apply the uploaded matrix to nVectors contiguous input vectors
+	///		of GetColumns() entries each, writing nVectors contiguous
+	///		output vectors of GetRows() entries each.  Conversion to and
+	///		from the staging buffers is performed on nThreads threads.
+	///	</summary>
+	template <typename InType, typename OutType>
+	void Apply(
+		const InType * pIn,
+		OutType * pOut,
+		int nVectors,
+		int nThreads = 1
+	) {
+		if (!m_fUploaded) {
+			_EXCEPTIONT("SparseMatrixDevice must be uploaded prior to Apply");
+		}
+		if (nVectors <= 0) {
+			return;
+		}
+
+		ReserveStaging(nVectors);
+
+		const ptrdiff_t sInSize =
+			static_cast<ptrdiff_t>(nVectors) * m_nCols;
+		const ptrdiff_t sOutSize =
+			static_cast<ptrdiff_t>(nVectors) * m_nRows;
+
+#pragma omp parallel for num_threads(nThreads) schedule(static)
+		for (ptrdiff_t i = 0; i < sInSize; i++) {
+			m_pHostIn[i] = static_cast<double>(pIn[i]);
+		}
+
+		ApplyStaged(nVectors);
+
+#pragma omp parallel for num_threads(nThreads) schedule(static)
+		for (ptrdiff_t i = 0; i < sOutSize; i++) {
+			pOut[i] = static_cast<OutType>(m_pHostOut[i]);
+		}
+	}
+
+	///	<summary>
+	///		Get the number of rows of the uploaded matrix.
+	///	</summary>
+	int GetRows() const {
+		return m_nRows;
+	}
+
+	///	<summary>
+	///		Get the number of columns of the uploaded matrix.
+	///	</summary>
+	int GetColumns() const {
+		return m_nCols;
+	}
+
+protected:
+	///	<summary>
+	///		Upload CSR arrays with 32-bit zero-based indices.
+	///	</summary>
+	void UploadCSR(
+		int nRows,
+		int nCols,
+		size_t sNonZeros,
+		const int * pRowPtr,
+		const int * pColIx,
+		const double * pValues
+	);
+
+	///	<summary>
+	///		Ensure the pinned host and device buffers hold nVectors input
+	///		and output vectors.
+	///	</summary>
+	void ReserveStaging(
+		int nVectors
+	);
+
+	///	<summary>
+	///		Copy nVectors staged input vectors to the device, apply the
+	///		matrix and copy the output vectors back to the staging buffer.
+	///	</summary>
+	void ApplyStaged(
+		int nVectors
+	);
+
+protected:
+	///	<summary>
+	///		Dimensions and number of nonzero entries of the matrix.
+	///	</summary>
+	int m_nRows;
+	int m_nCols;
+	size_t m_sNonZeros;
+
+	///	<summary>
+	///		A flag indicating a matrix has been uploaded.
+	///	</summary>
+	bool m_fUploaded;
+
+	///	<summary>
+	///		Number of vectors the staging buffers can hold.
+	///	</summary>
+	int m_nStagingVectors;
+
+	///	<summary>
+	///		Pinned host staging buffers for input and output vectors.
+	///	</summary>
+	double * m_pHostIn;
+	double * m_pHostOut;
+
+	///	<summary>
+	///		Device arrays, library handles and descriptors, defined only
+	///		when built with TEMPEST_CUSPARSE.
+	///	</summary>
+	struct DeviceState;
+
+	DeviceState * m_pDevice;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+#endif
+
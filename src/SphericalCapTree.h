@@ -0,0 +1,336 @@
+///////////////////////////////////////////////////////////////////////////////
+///
+///	\file    SphericalCapTree.h
+///	\author  agent
+///	\version October 14, 2026
+///
+///	<remarks>
+///		Copyright 2026 agent
+///
+///		This file is distributed as part of the Tempest source code package.
+///		Permission is granted to use, copy, modify and distribute this
+///		source code and its documentation under the terms of the GNU General
+///		Public License.  This software is provided "as is" without express
+///		or implied warranty.
+///	</remarks>
+
+#ifndef _SPHERICALCAPTREE_H_
+#define _SPHERICALCAPTREE_H_
+
+#include "GridElements.h"
+#include "Exception.h"
+
+#include <vector>
+#include <algorithm>
+#include <cmath>
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		A spherical cap on the unit sphere, given by its unit center and its
+///		angular radius.  A radius of at least pi covers the sphere.
+///	</summary>
+struct SphericalCap {
+
+	///	<summary>
+	///		Unit vector at the center of the cap.
+	///	</summary>
+	Node nodeCenter;
+
+	///	<summary>
+	///		Angular radius of the cap (in radians).
+	///	</summary>
+	double dRadius;
+
+	///	<summary>
+	///		Angle between the centers of this cap and another.
+	///	</summary>
+	double AngleTo(
+		const SphericalCap & cap
+	) const {
+		return atan2(
+			CrossProduct(nodeCenter, cap.nodeCenter).Magnitude(),
+			DotProduct(nodeCenter, cap.nodeCenter));
+	}
+
+	///	<summary>
+	///		Determine if this cap intersects another.
+	///	</summary>
+	bool Intersects(
+		const SphericalCap & cap
+	) const {
+		const double dRadiusSum = dRadius + cap.dRadius;
+		if (dRadiusSum >= M_PI) {
+			return true;
+		}
+		return (AngleTo(cap) <= dRadiusSum);
+	}
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		A static bounding volume hierarchy over SphericalCaps.  The tree is
+///		bulk built by median splits of the cap centers along the axis of
+///		largest extent, and each tree node stores a cap bounding all caps
+///		beneath it.  Queries return every cap that intersects a given cap,
+///		and need no connectivity between the bounded objects.
+///	</summary>
+class SphericalCapTree {
+
+public:
+	///	<summary>
+	///		Maximum number of caps in a leaf of the tree.
+	///	</summary>
+	static const int LeafSize = 8;
+
+	///	<summary>
+	///		Maximum depth of the tree, which bounds the traversal stack.
+	///	</summary>
+	static const int MaxDepth = 60;
+
+public:
+	///	<summary>
+	///		Default constructor.
+	///	</summary>
+	SphericalCapTree()
+	{ }
+
+	///	<summary>
+	///		Constructor that builds the tree over vecCaps.
+	///	</summary>
+	SphericalCapTree(
+		const std::vector<SphericalCap> & vecCaps
+	) {
+		Build(vecCaps);
+	}
+
+	///	<summary>
+	///		Build the tree over vecCaps, with the index of each cap as its
+	///		value.
+	///	</summary>
+	void Build(
+		const std::vector<SphericalCap> & vecCaps
+	) {
+		m_vecCaps = vecCaps;
+
+		m_vecIndex.resize(vecCaps.size());
+		for (int i = 0; i < vecCaps.size(); i++) {
+			m_vecIndex[i] = i;
+		}
+
+		m_vecTreeNodes.clear();
+		if (vecCaps.size() == 0) {
+			return;
+		}
+
+		m_vecTreeNodes.reserve(2 * (vecCaps.size() / LeafSize + 1));
+
+		BuildRange(0, static_cast<int>(vecCaps.size()), 0);
+	}
+
+	///	<summary>
+	///		Get the number of caps in the tree.
+	///	</summary>
+	size_t GetSize() const {
+		return m_vecCaps.size();
+	}
+
+	///	<summary>
+	///		Get the cap with the given index.
+	///	</summary>
+	const SphericalCap & GetCap(
+		int ix
+	) const {
+		return m_vecCaps[ix];
+	}
+
+	///	<summary>
+	///		Find the indices of all caps that intersect cap.  Indices are
+	///		returned in no particular order.
+	///	</summary>
+	void FindIntersecting(
+		const SphericalCap & cap,
+		std::vector<int> & vecIndices
+	) const {
+		vecIndices.clear();
+		if (m_vecTreeNodes.size() == 0) {
+			return;
+		}
+
+		int ixStack[MaxDepth + 2];
+		int nStack = 0;
+
+		ixStack[nStack++] = 0;
+
+		while (nStack > 0) {
+			const TreeNode & treenode = m_vecTreeNodes[ixStack[--nStack]];
+
+			if (!treenode.cap.Intersects(cap)) {
+				continue;
+			}
+
+			if (treenode.ixLeft == (-1)) {
+				for (int i = treenode.ixBegin; i < treenode.ixEnd; i++) {
+					const int ix = m_vecIndex[i];
+					if (m_vecCaps[ix].Intersects(cap)) {
+						vecIndices.push_back(ix);
+					}
+				}
+				continue;
+			}
+
+			ixStack[nStack++] = treenode.ixRight;
+			ixStack[nStack++] = treenode.ixLeft;
+		}
+	}
+
+protected:
+	///	<summary>
+	///		A node of the tree, bounding the caps m_vecIndex[ixBegin, ixEnd).
+	///	</summary>
+	struct TreeNode {
+		SphericalCap cap;
+		int ixBegin;
+		int ixEnd;
+		int ixLeft;
+		int ixRight;
+	};
+
+	///	<summary>
+	///		Comparator of cap indices along one coordinate axis of the cap
+	///		centers.
+	///	</summary>
+	struct IndexAxisComparator {
+		const std::vector<SphericalCap> & vecCaps;
+		int iAxis;
+
+		IndexAxisComparator(
+			const std::vector<SphericalCap> & a_vecCaps,
+			int a_iAxis
+		) :
+			vecCaps(a_vecCaps),
+			iAxis(a_iAxis)
+		{ }
+
+		bool operator()(int ixA, int ixB) const {
+			return (Coord(vecCaps[ixA].nodeCenter, iAxis)
+				< Coord(vecCaps[ixB].nodeCenter, iAxis));
+		}
+	};
+
+	///	<summary>
+	///		Get one coordinate of a Node.
+	///	</summary>
+	static Real Coord(
+		const Node & node,
+		int iAxis
+	) {
+		if (iAxis == 0) {
+			return node.x;
+		} else if (iAxis == 1) {
+			return node.y;
+		}
+		return node.z;
+	}
+
+	///	<summary>
+	///		Recursively build the subtree over m_vecIndex[ixBegin, ixEnd) at
+	///		depth iDepth, returning the index of its root.
+	///	</summary>
+	int BuildRange(
+		int ixBegin,
+		int ixEnd,
+		int iDepth
+	) {
+		const int ixTreeNode = static_cast<int>(m_vecTreeNodes.size());
+		m_vecTreeNodes.push_back(TreeNode());
+
+		TreeNode treenode;
+		treenode.ixBegin = ixBegin;
+		treenode.ixEnd = ixEnd;
+		treenode.ixLeft = (-1);
+		treenode.ixRight = (-1);
+
+		// Bounding cap centered on the mean of the cap centers
+		Node nodeSum(0.0, 0.0, 0.0);
+		Node nodeMin = m_vecCaps[m_vecIndex[ixBegin]].nodeCenter;
+		Node nodeMax = nodeMin;
+		for (int i = ixBegin; i < ixEnd; i++) {
+			const Node & node = m_vecCaps[m_vecIndex[i]].nodeCenter;
+			nodeSum = nodeSum + node;
+			nodeMin.x = std::min(nodeMin.x, node.x);
+			nodeMin.y = std::min(nodeMin.y, node.y);
+			nodeMin.z = std::min(nodeMin.z, node.z);
+			nodeMax.x = std::max(nodeMax.x, node.x);
+			nodeMax.y = std::max(nodeMax.y, node.y);
+			nodeMax.z = std::max(nodeMax.z, node.z);
+		}
+
+		const Real dMag = nodeSum.Magnitude();
+		if (dMag < 1.0e-12) {
+			treenode.cap.nodeCenter = m_vecCaps[m_vecIndex[ixBegin]].nodeCenter;
+			treenode.cap.dRadius = M_PI;
+
+		} else {
+			treenode.cap.nodeCenter = nodeSum / dMag;
+			treenode.cap.dRadius = 0.0;
+			for (int i = ixBegin; i < ixEnd; i++) {
+				const SphericalCap & cap = m_vecCaps[m_vecIndex[i]];
+				treenode.cap.dRadius = std::max(treenode.cap.dRadius,
+					treenode.cap.AngleTo(cap) + cap.dRadius);
+			}
+			treenode.cap.dRadius =
+				std::min(treenode.cap.dRadius + 1.0e-12, M_PI);
+		}
+
+		// Split along the axis of largest extent
+		if ((ixEnd - ixBegin > LeafSize) && (iDepth < MaxDepth)) {
+			Node nodeExtent = nodeMax - nodeMin;
+
+			int iAxis = 0;
+			if ((nodeExtent.y >= nodeExtent.x) && (nodeExtent.y >= nodeExtent.z)) {
+				iAxis = 1;
+			} else if ((nodeExtent.z >= nodeExtent.x) && (nodeExtent.z >= nodeExtent.y)) {
+				iAxis = 2;
+			}
+
+			const int ixMid = ixBegin + (ixEnd - ixBegin) / 2;
+
+			std::nth_element(
+				m_vecIndex.begin() + ixBegin,
+				m_vecIndex.begin() + ixMid,
+				m_vecIndex.begin() + ixEnd,
+				IndexAxisComparator(m_vecCaps, iAxis));
+
+			treenode.ixLeft = BuildRange(ixBegin, ixMid, iDepth + 1);
+			treenode.ixRight = BuildRange(ixMid, ixEnd, iDepth + 1);
+		}
+
+		m_vecTreeNodes[ixTreeNode] = treenode;
+
+		return ixTreeNode;
+	}
+
+protected:
+	///	<summary>
+	///		Caps in the tree, in their original order.
+	///	</summary>
+	std::vector<SphericalCap> m_vecCaps;
+
+	///	<summary>
+	///		Indices of the caps, arranged so that each tree node bounds a
+	///		contiguous range.
+	///	</summary>
+	std::vector<int> m_vecIndex;
+
+	///	<summary>
+	///		Nodes of the tree, with the root first.
+	///	</summary>
+	std::vector<TreeNode> m_vecTreeNodes;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+#endif
+
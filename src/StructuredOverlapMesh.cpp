@@ -0,0 +1,994 @@
+///////////////////////////////////////////////////////////////////////////////
+///
+///	\file    StructuredOverlapMesh.cpp
+///	\author  agent
+///	\version October 14, 2026
+///
+///	<remarks>
+///		Copyright 2026 agent
+///
+///		This file is distributed as part of the Tempest source code package.
+///		Permission is granted to use, copy, modify and distribute this
+///		source code and its documentation under the terms of the GNU General
+///		Public License.  This software is provided "as is" without express
+///		or implied warranty.
+///	</remarks>
+
+#include "StructuredOverlapMesh.h"
+
+#include "Announce.h"
+#include "Exception.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Tolerance (in radians, or in units of grid cells for cubed sphere
+///		indices) used to identify coordinates of structured meshes.
+///	</summary>
+static const double StructuredTolerance = 1.0e-9;
+
+///////////////////////////////////////////////////////////////////////////////
+// Cubed sphere meshes
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Layout of an equiangular gnomonic cubed sphere mesh.  Faces are
+///		indexed on the grid by (p * nResolution + j) * nResolution + i where
+///		p is the panel and (i, j) are equiangular indices on the panel.
+///	</summary>
+struct CubedSphereLayout {
+
+	///	<summary>
+	///		Number of faces along each edge of a panel.
+	///	</summary>
+	int nResolution;
+
+	///	<summary>
+	///		Face at each grid index.
+	///	</summary>
+	std::vector<int> vecGridFace;
+
+	///	<summary>
+	///		Grid index of each face.
+	///	</summary>
+	std::vector<int> vecFaceGrid;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Determine if mesh is an equiangular gnomonic cubed sphere mesh with
+///		great circle arc edges and, if so, its layout.  Panels are
+///		identified by the dominant component of the face centroid, and the
+///		equiangular coordinates on a panel are taken from the remaining two
+///		components, so the layout does not depend on the ordering of nodes
+///		or faces.
+///	</summary>
+static bool IdentifyCubedSphereMesh(
+	const Mesh & mesh,
+	CubedSphereLayout & layout
+) {
+	const int nFaces = static_cast<int>(mesh.faces.size());
+	if ((nFaces == 0) || (nFaces % 6 != 0)) {
+		return false;
+	}
+
+	const int nResolution =
+		static_cast<int>(sqrt(static_cast<double>(nFaces / 6)) + 0.5);
+
+	if (6 * nResolution * nResolution != nFaces) {
+		return false;
+	}
+
+	const double dDelta = 0.5 * M_PI / static_cast<double>(nResolution);
+
+	layout.nResolution = nResolution;
+	layout.vecGridFace.assign(nFaces, -1);
+	layout.vecFaceGrid.resize(nFaces);
+
+	for (int k = 0; k < nFaces; k++) {
+		const Face & face = mesh.faces[k];
+
+		if (face.edges.size() != 4) {
+			return false;
+		}
+
+		// Panel containing the face centroid
+		double dCentroid[3] = { 0.0, 0.0, 0.0 };
+		for (int n = 0; n < 4; n++) {
+			if (face.edges[n].type != Edge::Type_GreatCircleArc) {
+				return false;
+			}
+			const Node & node = mesh.nodes[face[n]];
+			dCentroid[0] += node.x;
+			dCentroid[1] += node.y;
+			dCentroid[2] += node.z;
+		}
+
+		int iAxis = 0;
+		for (int d = 1; d < 3; d++) {
+			if (fabs(dCentroid[d]) > fabs(dCentroid[iAxis])) {
+				iAxis = d;
+			}
+		}
+
+		const double dSign = (dCentroid[iAxis] > 0.0)?(1.0):(-1.0);
+		const int iPanel = 2 * iAxis + ((dSign > 0.0)?(0):(1));
+
+		// Equiangular indices of the corners on the panel
+		int iCornerI[4];
+		int iCornerJ[4];
+
+		for (int n = 0; n < 4; n++) {
+			const Node & node = mesh.nodes[face[n]];
+			const double dC[3] = { node.x, node.y, node.z };
+
+			const double dMajor = dSign * dC[iAxis];
+			if (dMajor <= 0.0) {
+				return false;
+			}
+
+			const double dAlpha = atan(dC[(iAxis+1)%3] / dMajor);
+			const double dBeta  = atan(dC[(iAxis+2)%3] / dMajor);
+
+			const double dI = (dAlpha + 0.25 * M_PI) / dDelta;
+			const double dJ = (dBeta  + 0.25 * M_PI) / dDelta;
+
+			iCornerI[n] = static_cast<int>(floor(dI + 0.5));
+			iCornerJ[n] = static_cast<int>(floor(dJ + 0.5));
+
+			if ((fabs(dI - static_cast<double>(iCornerI[n])) > StructuredTolerance * nResolution) ||
+			    (fabs(dJ - static_cast<double>(iCornerJ[n])) > StructuredTolerance * nResolution)
+			) {
+				return false;
+			}
+		}
+
+		// Corners must be the four corners of one grid cell
+		const int iMin = *std::min_element(iCornerI, iCornerI + 4);
+		const int jMin = *std::min_element(iCornerJ, iCornerJ + 4);
+
+		if ((iMin < 0) || (iMin >= nResolution) ||
+		    (jMin < 0) || (jMin >= nResolution)
+		) {
+			return false;
+		}
+
+		int iCornerMask = 0;
+		for (int n = 0; n < 4; n++) {
+			const int di = iCornerI[n] - iMin;
+			const int dj = iCornerJ[n] - jMin;
+			if ((di > 1) || (dj > 1)) {
+				return false;
+			}
+			iCornerMask |= (1 << (di + 2 * dj));
+		}
+		if (iCornerMask != 0xF) {
+			return false;
+		}
+
+		const int iGrid = (iPanel * nResolution + jMin) * nResolution + iMin;
+		if (layout.vecGridFace[iGrid] != (-1)) {
+			return false;
+		}
+
+		layout.vecGridFace[iGrid] = k;
+		layout.vecFaceGrid[k] = iGrid;
+	}
+
+	return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Generate the overlap mesh of two cubed sphere meshes whose
+///		resolutions are integer multiples of one another.  The overlap
+///		faces are the faces of the finer mesh.
+///	</summary>
+static void GenerateCubedSphereOverlapMesh(
+	const Mesh & meshSource,
+	const CubedSphereLayout & layoutSource,
+	const Mesh & meshTarget,
+	const CubedSphereLayout & layoutTarget,
+	Mesh & meshOverlap
+) {
+	const bool fSourceFine =
+		(layoutSource.nResolution >= layoutTarget.nResolution);
+
+	const int nFine =
+		(fSourceFine)?(layoutSource.nResolution):(layoutTarget.nResolution);
+	const int nCoarse =
+		(fSourceFine)?(layoutTarget.nResolution):(layoutSource.nResolution);
+	const int nRatio = nFine / nCoarse;
+
+	meshOverlap.nodes = (fSourceFine)?(meshSource.nodes):(meshTarget.nodes);
+
+	for (int s = 0; s < meshSource.faces.size(); s++) {
+		const int iGrid = layoutSource.vecFaceGrid[s];
+		const int nRes = layoutSource.nResolution;
+
+		const int i = iGrid % nRes;
+		const int j = (iGrid / nRes) % nRes;
+		const int p = iGrid / (nRes * nRes);
+
+		// Source face lies within one target face
+		if (fSourceFine) {
+			const int iTargetGrid =
+				(p * nCoarse + j / nRatio) * nCoarse + i / nRatio;
+
+			meshOverlap.faces.push_back(meshSource.faces[s]);
+			meshOverlap.vecSourceFaceIx.push_back(s);
+			meshOverlap.vecTargetFaceIx.push_back(
+				layoutTarget.vecGridFace[iTargetGrid]);
+
+		// Source face contains nRatio x nRatio target faces
+		} else {
+			for (int dj = 0; dj < nRatio; dj++) {
+			for (int di = 0; di < nRatio; di++) {
+				const int iTargetGrid =
+					(p * nFine + j * nRatio + dj) * nFine + i * nRatio + di;
+				const int t = layoutTarget.vecGridFace[iTargetGrid];
+
+				meshOverlap.faces.push_back(meshTarget.faces[t]);
+				meshOverlap.vecSourceFaceIx.push_back(s);
+				meshOverlap.vecTargetFaceIx.push_back(t);
+			}
+			}
+		}
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Latitude-longitude meshes
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Layout of a latitude-longitude mesh.  Faces are indexed on the grid
+///		by j * nLon + i, where cell i spans longitudes [vecLonEdges[i],
+///		vecLonEdges[i+1]] (with vecLonEdges[nLon] taken as vecLonEdges[0]
+///		+ 2 pi for a global mesh) and cell j spans latitudes
+///		[vecLatEdges[j], vecLatEdges[j+1]].
+///	</summary>
+struct LatLonLayout {
+
+	///	<summary>
+	///		True if the mesh spans all longitudes.
+	///	</summary>
+	bool fGlobal;
+
+	///	<summary>
+	///		True if edges along parallels are lines of constant latitude,
+	///		false if they are great circle arcs.
+	///	</summary>
+	bool fConstantLatitude;
+
+	///	<summary>
+	///		Number of cells in longitude and latitude.
+	///	</summary>
+	int nLon;
+	int nLat;
+
+	///	<summary>
+	///		Longitude edges in [0, 2 pi), ascending.  There are nLon edges
+	///		for a global mesh and nLon+1 edges for a regional mesh.
+	///	</summary>
+	std::vector<double> vecLonEdges;
+
+	///	<summary>
+	///		Latitude edges, ascending (nLat+1 edges).
+	///	</summary>
+	std::vector<double> vecLatEdges;
+
+	///	<summary>
+	///		Face at each grid index.
+	///	</summary>
+	std::vector<int> vecGridFace;
+
+	///	<summary>
+	///		Grid index of each face.
+	///	</summary>
+	std::vector<int> vecFaceGrid;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Sort a vector of coordinates and merge coordinates that agree to
+///		within StructuredTolerance.
+///	</summary>
+static void SortAndMergeCoordinates(
+	std::vector<double> & vecCoord
+) {
+	std::sort(vecCoord.begin(), vecCoord.end());
+
+	int nUnique = 0;
+	for (int i = 0; i < vecCoord.size(); i++) {
+		if ((nUnique == 0) ||
+		    (vecCoord[i] - vecCoord[nUnique-1] > StructuredTolerance)
+		) {
+			vecCoord[nUnique] = vecCoord[i];
+			nUnique++;
+		}
+	}
+	vecCoord.resize(nUnique);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Find the index of dCoord in the sorted vector vecCoord, or -1 if it
+///		does not agree with any entry to within StructuredTolerance.
+///	</summary>
+static int FindCoordinate(
+	const std::vector<double> & vecCoord,
+	double dCoord
+) {
+	std::vector<double>::const_iterator iter =
+		std::lower_bound(
+			vecCoord.begin(),
+			vecCoord.end(),
+			dCoord - StructuredTolerance);
+
+	if ((iter != vecCoord.end()) && (fabs(*iter - dCoord) <= StructuredTolerance)) {
+		return static_cast<int>(iter - vecCoord.begin());
+	}
+	return (-1);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Determine if mesh is a latitude-longitude mesh and, if so, its
+///		layout.  Every face must be bounded by two meridians and two
+///		parallels, or by two meridians and one parallel with a pole, and
+///		the faces must cover each cell of the tensor grid of longitude and
+///		latitude edges exactly once.
+///	</summary>
+static bool IdentifyLatLonMesh(
+	const Mesh & mesh,
+	LatLonLayout & layout
+) {
+	const int nFaces = static_cast<int>(mesh.faces.size());
+	if (nFaces == 0) {
+		return false;
+	}
+
+	// Longitude and latitude of each node used by a face
+	const int nNodes = static_cast<int>(mesh.nodes.size());
+
+	std::vector<bool> vecNodeUsed(nNodes, false);
+	for (int k = 0; k < nFaces; k++) {
+		const Face & face = mesh.faces[k];
+		if ((face.edges.size() != 3) && (face.edges.size() != 4)) {
+			return false;
+		}
+		for (int n = 0; n < face.edges.size(); n++) {
+			vecNodeUsed[face[n]] = true;
+		}
+	}
+
+	std::vector<double> vecNodeLon(nNodes, 0.0);
+	std::vector<double> vecNodeLat(nNodes, 0.0);
+	std::vector<bool> vecNodePole(nNodes, false);
+
+	std::vector<double> vecLonEdges;
+	std::vector<double> vecLatEdges;
+
+	for (int i = 0; i < nNodes; i++) {
+		if (!vecNodeUsed[i]) {
+			continue;
+		}
+
+		const Node & node = mesh.nodes[i];
+		const double dR = sqrt(node.x * node.x + node.y * node.y);
+
+		vecNodeLat[i] = atan2(node.z, dR);
+		vecLatEdges.push_back(vecNodeLat[i]);
+
+		if (dR < StructuredTolerance) {
+			vecNodePole[i] = true;
+			vecNodeLat[i] = (node.z > 0.0)?(0.5 * M_PI):(-0.5 * M_PI);
+			vecLatEdges.back() = vecNodeLat[i];
+
+		} else {
+			double dLon = atan2(node.y, node.x);
+			if (dLon < 0.0) {
+				dLon += 2.0 * M_PI;
+			}
+			if (dLon > 2.0 * M_PI - StructuredTolerance) {
+				dLon = 0.0;
+			}
+			vecNodeLon[i] = dLon;
+			vecLonEdges.push_back(dLon);
+		}
+	}
+
+	SortAndMergeCoordinates(vecLonEdges);
+	SortAndMergeCoordinates(vecLatEdges);
+
+	const int nLat = static_cast<int>(vecLatEdges.size()) - 1;
+	const int nUniqueLon = static_cast<int>(vecLonEdges.size());
+
+	if ((nLat < 1) || (nUniqueLon < 2)) {
+		return false;
+	}
+
+	// Determine if longitudes wrap from the number of faces
+	int nLon;
+	if ((nUniqueLon >= 3) && (nFaces == nUniqueLon * nLat)) {
+		layout.fGlobal = true;
+		nLon = nUniqueLon;
+
+	} else if (nFaces == (nUniqueLon - 1) * nLat) {
+		layout.fGlobal = false;
+		nLon = nUniqueLon - 1;
+
+	} else {
+		return false;
+	}
+
+	layout.nLon = nLon;
+	layout.nLat = nLat;
+	layout.vecGridFace.assign(nFaces, -1);
+	layout.vecFaceGrid.resize(nFaces);
+
+	int nConstantLatitudeEdges = 0;
+	int nGreatCircleParallelEdges = 0;
+
+	std::vector<int> vecLocalLon(4);
+	std::vector<int> vecLocalLat(4);
+
+	for (int k = 0; k < nFaces; k++) {
+		const Face & face = mesh.faces[k];
+		const int nEdges = static_cast<int>(face.edges.size());
+
+		// Grid indices of each node
+		int jMin = nLat;
+		int jMax = 0;
+		int iLonA = (-1);
+		int iLonB = (-1);
+
+		for (int n = 0; n < nEdges; n++) {
+			const int ixNode = face[n];
+
+			vecLocalLat[n] = FindCoordinate(vecLatEdges, vecNodeLat[ixNode]);
+			jMin = std::min(jMin, vecLocalLat[n]);
+			jMax = std::max(jMax, vecLocalLat[n]);
+
+			if (vecNodePole[ixNode]) {
+				vecLocalLon[n] = (-1);
+				continue;
+			}
+
+			vecLocalLon[n] = FindCoordinate(vecLonEdges, vecNodeLon[ixNode]);
+			if (vecLocalLon[n] == (-1)) {
+				return false;
+			}
+
+			if ((iLonA == (-1)) || (iLonA == vecLocalLon[n])) {
+				iLonA = vecLocalLon[n];
+			} else if ((iLonB == (-1)) || (iLonB == vecLocalLon[n])) {
+				iLonB = vecLocalLon[n];
+			} else {
+				return false;
+			}
+		}
+
+		if ((jMin < 0) || (jMax != jMin + 1) || (iLonB == (-1))) {
+			return false;
+		}
+
+		// Western longitude index of the cell
+		int i;
+		if (layout.fGlobal) {
+			if ((iLonA + 1) % nLon == iLonB) {
+				i = iLonA;
+			} else if ((iLonB + 1) % nLon == iLonA) {
+				i = iLonB;
+			} else {
+				return false;
+			}
+		} else {
+			if (abs(iLonA - iLonB) != 1) {
+				return false;
+			}
+			i = std::min(iLonA, iLonB);
+		}
+
+		// Each non-polar node must be a distinct corner of the cell, and
+		// polar nodes must lie on a polar edge of the cell
+		const bool fSouthPole =
+			(jMin == 0) && (vecLatEdges[0] == -0.5 * M_PI);
+		const bool fNorthPole =
+			(jMax == nLat) && (vecLatEdges[nLat] == 0.5 * M_PI);
+
+		int iCornerMask = 0;
+		int nPoleNodes = 0;
+		for (int n = 0; n < nEdges; n++) {
+			const int ixNode = face[n];
+			if (vecNodePole[ixNode]) {
+				nPoleNodes++;
+				if (!((fSouthPole && (vecLocalLat[n] == jMin)) ||
+				      (fNorthPole && (vecLocalLat[n] == jMax)))
+				) {
+					return false;
+				}
+				continue;
+			}
+
+			const int di = (vecLocalLon[n] == i)?(0):(1);
+			const int dj = vecLocalLat[n] - jMin;
+			const int iBit = 1 << (di + 2 * dj);
+
+			if (iCornerMask & iBit) {
+				return false;
+			}
+			iCornerMask |= iBit;
+		}
+
+		int iExpectedMask = 0xF;
+		if (fSouthPole && (iCornerMask & 0x3) == 0) {
+			iExpectedMask = 0xC;
+		} else if (fNorthPole && (iCornerMask & 0xC) == 0) {
+			iExpectedMask = 0x3;
+		}
+		if (iCornerMask != iExpectedMask) {
+			return false;
+		}
+		if ((iExpectedMask == 0xF) != (nPoleNodes == 0)) {
+			return false;
+		}
+
+		// Meridians must be great circle arcs; parallels are classified
+		int nParallelEdges = 0;
+		for (int n = 0; n < nEdges; n++) {
+			const int ixNode0 = face[n];
+			const int ixNode1 = face[(n+1) % nEdges];
+			if (ixNode0 == ixNode1) {
+				continue;
+			}
+
+			const Edge::Type type = face.edges[n].type;
+
+			const bool fParallel =
+				!vecNodePole[ixNode0] && !vecNodePole[ixNode1]
+				&& (vecLocalLat[n] == vecLocalLat[(n+1) % nEdges]);
+
+			if (fParallel) {
+				nParallelEdges++;
+				if (type == Edge::Type_ConstantLatitude) {
+					nConstantLatitudeEdges++;
+				} else if (type == Edge::Type_GreatCircleArc) {
+					nGreatCircleParallelEdges++;
+				} else {
+					return false;
+				}
+
+			} else {
+				if (type != Edge::Type_GreatCircleArc) {
+					return false;
+				}
+				if (!vecNodePole[ixNode0] && !vecNodePole[ixNode1] &&
+				    (vecLocalLon[n] != vecLocalLon[(n+1) % nEdges])
+				) {
+					return false;
+				}
+			}
+		}
+
+		if (nParallelEdges != ((iExpectedMask == 0xF)?(2):(1))) {
+			return false;
+		}
+
+		const int iGrid = jMin * nLon + i;
+		if (layout.vecGridFace[iGrid] != (-1)) {
+			return false;
+		}
+		layout.vecGridFace[iGrid] = k;
+		layout.vecFaceGrid[k] = iGrid;
+	}
+
+	if ((nConstantLatitudeEdges != 0) && (nGreatCircleParallelEdges != 0)) {
+		return false;
+	}
+
+	layout.fConstantLatitude = (nConstantLatitudeEdges != 0);
+	layout.vecLonEdges.swap(vecLonEdges);
+	layout.vecLatEdges.swap(vecLatEdges);
+
+	return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		One-dimensional overlap of two sets of cells.  Overlap cell k spans
+///		[vecEdges[k], vecEdges[k+1]] and lies in cell vecFirstCell[k] of the
+///		first set and vecSecondCell[k] of the second set.
+///	</summary>
+struct StructuredOverlap1D {
+	std::vector<double> vecEdges;
+	std::vector<int> vecFirstCell;
+	std::vector<int> vecSecondCell;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Find the cell of the non-periodic sorted edges vecEdges containing
+///		dCoord.
+///	</summary>
+static int FindStructuredCell(
+	const std::vector<double> & vecEdges,
+	double dCoord
+) {
+	return static_cast<int>(
+		std::upper_bound(vecEdges.begin(), vecEdges.end(), dCoord)
+			- vecEdges.begin()) - 1;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Overlap two non-periodic sets of cells with the same extent.
+///	</summary>
+static void GenerateStructuredOverlap1D(
+	const std::vector<double> & vecFirstEdges,
+	const std::vector<double> & vecSecondEdges,
+	StructuredOverlap1D & overlap
+) {
+	overlap.vecEdges = vecFirstEdges;
+	overlap.vecEdges.insert(
+		overlap.vecEdges.end(), vecSecondEdges.begin(), vecSecondEdges.end());
+	SortAndMergeCoordinates(overlap.vecEdges);
+
+	const int nCells = static_cast<int>(overlap.vecEdges.size()) - 1;
+	overlap.vecFirstCell.resize(nCells);
+	overlap.vecSecondCell.resize(nCells);
+
+	for (int k = 0; k < nCells; k++) {
+		const double dMid =
+			0.5 * (overlap.vecEdges[k] + overlap.vecEdges[k+1]);
+		overlap.vecFirstCell[k] = FindStructuredCell(vecFirstEdges, dMid);
+		overlap.vecSecondCell[k] = FindStructuredCell(vecSecondEdges, dMid);
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Overlap two periodic sets of longitude cells.  Edges of the overlap
+///		are relative to the first edge of the first set, and the final
+///		overlap cell ends at 2 pi.
+///	</summary>
+static void GenerateStructuredOverlapPeriodic1D(
+	const std::vector<double> & vecFirstEdges,
+	const std::vector<double> & vecSecondEdges,
+	StructuredOverlap1D & overlap
+) {
+	const double dOrigin = vecFirstEdges[0];
+
+	// Edges relative to the origin
+	std::vector<double> vecFirstRelative(vecFirstEdges.size());
+	for (int i = 0; i < vecFirstEdges.size(); i++) {
+		vecFirstRelative[i] = vecFirstEdges[i] - dOrigin;
+	}
+
+	std::vector< std::pair<double, int> > vecSecondRelative(vecSecondEdges.size());
+	for (int i = 0; i < vecSecondEdges.size(); i++) {
+		double dRel = fmod(vecSecondEdges[i] - dOrigin + 4.0 * M_PI, 2.0 * M_PI);
+		if (dRel > 2.0 * M_PI - StructuredTolerance) {
+			dRel = 0.0;
+		}
+		vecSecondRelative[i] = std::pair<double, int>(dRel, i);
+	}
+	std::sort(vecSecondRelative.begin(), vecSecondRelative.end());
+
+	std::vector<double> vecSecondSorted(vecSecondRelative.size());
+	for (int i = 0; i < vecSecondRelative.size(); i++) {
+		vecSecondSorted[i] = vecSecondRelative[i].first;
+	}
+
+	overlap.vecEdges = vecFirstRelative;
+	overlap.vecEdges.insert(
+		overlap.vecEdges.end(), vecSecondSorted.begin(), vecSecondSorted.end());
+	SortAndMergeCoordinates(overlap.vecEdges);
+
+	const int nCells = static_cast<int>(overlap.vecEdges.size());
+	overlap.vecEdges.push_back(2.0 * M_PI);
+
+	overlap.vecFirstCell.resize(nCells);
+	overlap.vecSecondCell.resize(nCells);
+
+	for (int k = 0; k < nCells; k++) {
+		const double dMid =
+			0.5 * (overlap.vecEdges[k] + overlap.vecEdges[k+1]);
+
+		overlap.vecFirstCell[k] = FindStructuredCell(vecFirstRelative, dMid);
+
+		// Cells of the second set that wrap past the origin
+		int iSorted = FindStructuredCell(vecSecondSorted, dMid);
+		if (iSorted < 0) {
+			iSorted = static_cast<int>(vecSecondSorted.size()) - 1;
+		}
+		overlap.vecSecondCell[k] = vecSecondRelative[iSorted].second;
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Generate the overlap mesh of two latitude-longitude meshes as the
+///		tensor product of the longitude and latitude overlaps.
+///	</summary>
+static void GenerateLatLonOverlapMesh(
+	const LatLonLayout & layoutSource,
+	const LatLonLayout & layoutTarget,
+	Mesh & meshOverlap
+) {
+	// One-dimensional overlaps
+	StructuredOverlap1D overlapLon;
+	StructuredOverlap1D overlapLat;
+
+	double dLonOrigin = 0.0;
+	if (layoutSource.fGlobal) {
+		GenerateStructuredOverlapPeriodic1D(
+			layoutSource.vecLonEdges, layoutTarget.vecLonEdges, overlapLon);
+		dLonOrigin = layoutSource.vecLonEdges[0];
+	} else {
+		GenerateStructuredOverlap1D(
+			layoutSource.vecLonEdges, layoutTarget.vecLonEdges, overlapLon);
+	}
+
+	GenerateStructuredOverlap1D(
+		layoutSource.vecLatEdges, layoutTarget.vecLatEdges, overlapLat);
+
+	const int nLonEdges = static_cast<int>(overlapLon.vecEdges.size());
+	const int nLatEdges = static_cast<int>(overlapLat.vecEdges.size());
+	const int nLonCells = nLonEdges - 1;
+	const int nLatCells = nLatEdges - 1;
+
+	// Overlap cells within each source cell
+	std::vector< std::vector<int> > vecSourceLonCells(layoutSource.nLon);
+	for (int k = 0; k < nLonCells; k++) {
+		vecSourceLonCells[overlapLon.vecFirstCell[k]].push_back(k);
+	}
+	std::vector< std::vector<int> > vecSourceLatCells(layoutSource.nLat);
+	for (int k = 0; k < nLatCells; k++) {
+		vecSourceLatCells[overlapLat.vecFirstCell[k]].push_back(k);
+	}
+
+	// Nodes at the overlap grid points; the last longitude edge of a
+	// global mesh coincides with the first
+	const bool fSouthPole = (overlapLat.vecEdges[0] == -0.5 * M_PI);
+	const bool fNorthPole = (overlapLat.vecEdges[nLatCells] == 0.5 * M_PI);
+
+	int ixSouthPole = (-1);
+	int ixNorthPole = (-1);
+	if (fSouthPole) {
+		ixSouthPole = static_cast<int>(meshOverlap.nodes.size());
+		meshOverlap.nodes.push_back(Node(0.0, 0.0, -1.0));
+	}
+	if (fNorthPole) {
+		ixNorthPole = static_cast<int>(meshOverlap.nodes.size());
+		meshOverlap.nodes.push_back(Node(0.0, 0.0, +1.0));
+	}
+
+	const int nLonNodes = (layoutSource.fGlobal)?(nLonCells):(nLonEdges);
+
+	std::vector<int> vecGridNode(nLonNodes * nLatEdges, -1);
+
+	for (int j = 0; j < nLatEdges; j++) {
+		if ((j == 0) && fSouthPole) {
+			continue;
+		}
+		if ((j == nLatCells) && fNorthPole) {
+			continue;
+		}
+
+		const double dLat = overlapLat.vecEdges[j];
+
+		for (int i = 0; i < nLonNodes; i++) {
+			const double dLon = dLonOrigin + overlapLon.vecEdges[i];
+
+			vecGridNode[j * nLonNodes + i] =
+				static_cast<int>(meshOverlap.nodes.size());
+
+			meshOverlap.nodes.push_back(Node(
+				cos(dLat) * cos(dLon),
+				cos(dLat) * sin(dLon),
+				sin(dLat)));
+		}
+	}
+
+	const Edge::Type typeParallel =
+		(layoutSource.fConstantLatitude)?
+			(Edge::Type_ConstantLatitude):(Edge::Type_GreatCircleArc);
+
+	// Overlap faces in source face order
+	for (int s = 0; s < layoutSource.vecFaceGrid.size(); s++) {
+		const int iSourceGrid = layoutSource.vecFaceGrid[s];
+		const int iSourceLon = iSourceGrid % layoutSource.nLon;
+		const int iSourceLat = iSourceGrid / layoutSource.nLon;
+
+		const std::vector<int> & vecLatCells = vecSourceLatCells[iSourceLat];
+		const std::vector<int> & vecLonCells = vecSourceLonCells[iSourceLon];
+
+		for (int jj = 0; jj < vecLatCells.size(); jj++) {
+			const int j = vecLatCells[jj];
+
+		for (int ii = 0; ii < vecLonCells.size(); ii++) {
+			const int i = vecLonCells[ii];
+			const int iNext = (i + 1) % nLonNodes;
+
+			const int t = layoutTarget.vecGridFace[
+				overlapLat.vecSecondCell[j] * layoutTarget.nLon
+				+ overlapLon.vecSecondCell[i]];
+
+			if ((j == 0) && fSouthPole) {
+				Face face(3);
+				face.SetNode(0, ixSouthPole);
+				face.SetNode(1, vecGridNode[(j+1) * nLonNodes + iNext]);
+				face.SetNode(2, vecGridNode[(j+1) * nLonNodes + i]);
+				face.edges[1].type = typeParallel;
+				meshOverlap.faces.push_back(face);
+
+			} else if ((j == nLatCells - 1) && fNorthPole) {
+				Face face(3);
+				face.SetNode(0, vecGridNode[j * nLonNodes + i]);
+				face.SetNode(1, vecGridNode[j * nLonNodes + iNext]);
+				face.SetNode(2, ixNorthPole);
+				face.edges[0].type = typeParallel;
+				meshOverlap.faces.push_back(face);
+
+			} else {
+				Face face(4);
+				face.SetNode(0, vecGridNode[j * nLonNodes + i]);
+				face.SetNode(1, vecGridNode[j * nLonNodes + iNext]);
+				face.SetNode(2, vecGridNode[(j+1) * nLonNodes + iNext]);
+				face.SetNode(3, vecGridNode[(j+1) * nLonNodes + i]);
+				face.edges[0].type = typeParallel;
+				face.edges[2].type = typeParallel;
+				meshOverlap.faces.push_back(face);
+			}
+
+			meshOverlap.vecSourceFaceIx.push_back(s);
+			meshOverlap.vecTargetFaceIx.push_back(t);
+		}
+		}
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Determine if the overlap of two latitude-longitude meshes is the
+///		tensor product of their longitude and latitude overlaps.  This
+///		requires the meshes to have the same extent and either lines of
+///		constant latitude for parallels or the same longitudes, since great
+///		circle arcs between different pairs of meridians cross.
+///	</summary>
+static bool AreLatLonMeshesCompatible(
+	const LatLonLayout & layoutSource,
+	const LatLonLayout & layoutTarget
+) {
+	if (layoutSource.fGlobal != layoutTarget.fGlobal) {
+		return false;
+	}
+	if (layoutSource.fConstantLatitude != layoutTarget.fConstantLatitude) {
+		return false;
+	}
+
+	// Same latitude extent
+	if ((fabs(layoutSource.vecLatEdges.front() - layoutTarget.vecLatEdges.front()) > StructuredTolerance) ||
+	    (fabs(layoutSource.vecLatEdges.back() - layoutTarget.vecLatEdges.back()) > StructuredTolerance)
+	) {
+		return false;
+	}
+
+	// A single cell spanning both poles is not supported
+	if ((layoutSource.vecLatEdges.front() == -0.5 * M_PI) &&
+	    (layoutSource.vecLatEdges.back() == 0.5 * M_PI) &&
+	    ((layoutSource.nLat == 1) || (layoutTarget.nLat == 1))
+	) {
+		return false;
+	}
+
+	// Same longitude extent
+	if (!layoutSource.fGlobal) {
+		if ((fabs(layoutSource.vecLonEdges.front() - layoutTarget.vecLonEdges.front()) > StructuredTolerance) ||
+		    (fabs(layoutSource.vecLonEdges.back() - layoutTarget.vecLonEdges.back()) > StructuredTolerance)
+		) {
+			return false;
+		}
+	}
+
+	// Great circle parallels require identical longitudes
+	if (!layoutSource.fConstantLatitude) {
+		if (layoutSource.vecLonEdges.size() != layoutTarget.vecLonEdges.size()) {
+			return false;
+		}
+		for (int i = 0; i < layoutSource.vecLonEdges.size(); i++) {
+			if (fabs(layoutSource.vecLonEdges[i] - layoutTarget.vecLonEdges[i]) > StructuredTolerance) {
+				return false;
+			}
+		}
+	}
+
+	return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+bool GenerateStructuredOverlapMesh(
+	const Mesh & meshSource,
+	const Mesh & meshTarget,
+	Mesh & meshOverlap
+) {
+	if ((meshOverlap.faces.size() != 0) || (meshOverlap.nodes.size() != 0)) {
+		return false;
+	}
+	if ((meshSource.vecMultiFaceMap.size() != 0) ||
+	    (meshTarget.vecMultiFaceMap.size() != 0)
+	) {
+		return false;
+	}
+
+	// Nested cubed sphere meshes
+	{
+		CubedSphereLayout layoutSource;
+		CubedSphereLayout layoutTarget;
+
+		if (IdentifyCubedSphereMesh(meshSource, layoutSource) &&
+		    IdentifyCubedSphereMesh(meshTarget, layoutTarget)
+		) {
+			const int nMax = std::max(layoutSource.nResolution, layoutTarget.nResolution);
+			const int nMin = std::min(layoutSource.nResolution, layoutTarget.nResolution);
+
+			if (nMax % nMin == 0) {
+				Announce("Generating overlap of nested cubed sphere meshes "
+					"(%i, %i) in closed form",
+					layoutSource.nResolution, layoutTarget.nResolution);
+
+				GenerateCubedSphereOverlapMesh(
+					meshSource, layoutSource,
+					meshTarget, layoutTarget,
+					meshOverlap);
+
+				return true;
+			}
+			return false;
+		}
+	}
+
+	// Latitude-longitude meshes
+	{
+		LatLonLayout layoutSource;
+		LatLonLayout layoutTarget;
+
+		if (IdentifyLatLonMesh(meshSource, layoutSource) &&
+		    IdentifyLatLonMesh(meshTarget, layoutTarget) &&
+		    AreLatLonMeshesCompatible(layoutSource, layoutTarget)
+		) {
+			Announce("Generating overlap of latitude-longitude meshes "
+				"(%i x %i, %i x %i) in closed form",
+				layoutSource.nLon, layoutSource.nLat,
+				layoutTarget.nLon, layoutTarget.nLat);
+
+			GenerateLatLonOverlapMesh(
+				layoutSource, layoutTarget, meshOverlap);
+
+			return true;
+		}
+	}
+
+	return false;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
@@ -0,0 +1,52 @@
+///////////////////////////////////////////////////////////////////////////////
+///
+///	\file    StructuredOverlapMesh.h
+///	\author  agent
+///	\version October 14, 2026
+///
+///	<remarks>
+///		Copyright 2026 agent
+///
+///		This file is distributed as part of the Tempest source code package.
+///		Permission is granted to use, copy, modify and distribute this
+///		source code and its documentation under the terms of the GNU General
+///		Public License.  This software is provided "as is" without express
+///		or implied warranty.
+///	</remarks>
+
+#ifndef _STRUCTUREDOVERLAPMESH_H_
+#define _STRUCTUREDOVERLAPMESH_H_
+
+#include "GridElements.h"
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Generate the overlap mesh of two structured meshes in closed form,
+///		without tracing or clipping edges.  Two cases are supported:
+///
+///		Cubed sphere meshes with the equiangular gnomonic layout of
+///		GenerateCSMesh whose resolutions are integer multiples of one
+///		another.  Each face of the finer mesh then lies in exactly one face
+///		of the coarser mesh and is itself an overlap face.
+///
+///		Latitude-longitude meshes covering the same longitude and latitude
+///		range, which are either bounded by lines of constant latitude or
+///		share the same longitudes.  Overlap faces are then the tensor
+///		product of the one-dimensional longitude and latitude overlaps.
+///
+///		The structure is detected from the mesh geometry, so meshes read
+///		from file are recognized.  Overlap faces are contiguous per source
+///		face and in source face order.  Returns false, leaving meshOverlap
+///		unchanged, if the pair of meshes is not supported.
+///	</summary>
+bool GenerateStructuredOverlapMesh(
+	const Mesh & meshSource,
+	const Mesh & meshTarget,
+	Mesh & meshOverlap
+);
+
+///////////////////////////////////////////////////////////////////////////////
+
+#endif
+
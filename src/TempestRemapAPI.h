@@ -4,6 +4,7 @@
 #include "DataArray3D.h"
 #include "GridElements.h"
 #include "OfflineMap.h"
+#include "OfflineMapGenerator.h"
 #include "netcdfcpp.h"
 #include <string>
 
@@ -14,7 +15,8 @@ extern "C" {
 						 int nResolution,
 						 bool fAlt,
 						 std::string strOutputFile,
-						 std::string strOutputFormat );
+						 std::string strOutputFormat,
+						 int nThreads = 1 );
 
 	// Generate a Latitude-Longitude mesh
 	int GenerateRLLMesh ( Mesh& meshOut,
@@ -41,14 +43,16 @@ extern "C" {
 						  double dYLLCorner,
 						  double dCellSize,
 						  std::string strOutputFile,
-						  bool fVerbose );
+						  bool fVerbose,
+						  int nThreads = 1 );
 
 	// Generate a Icosahedral-Sphere mesh
 	int GenerateICOMesh ( Mesh& meshOut,
 						  int nResolution,
 						  bool fDual,
 						  std::string strOutputFile,
-						  std::string strOutputFormat );
+						  std::string strOutputFormat,
+						  int nThreads = 1 );
 
 	// Generate Lambert-Conic mesh
 	int GenerateLambertConfConicMesh ( Mesh& meshOut,
@@ -56,7 +60,8 @@ extern "C" {
 									   double dLon0, double dLat0,
 									   double dLat1, double dLat2,
 									   double dXLL, double dYLL, double dDX,
-									   std::string strOutputFile );
+									   std::string strOutputFile,
+									   int nThreads = 1 );
 
 	// Compute the overlap mesh given a source and target mesh file names
 	int GenerateOverlapMesh ( std::string strMeshA, std::string strMeshB,
@@ -66,10 +71,23 @@ extern "C" {
                               bool fHasConcaveFacesA = false,
                               bool fHasConcaveFacesB = false,
                               bool fAllowNoOverlap = false,
-                              bool fVerbose = true );
+                              bool fVerbose = true,
+                              int nThreads = 1,
+                              bool fCachePrepared = false,
+                              int nOutputDeflate = 0,
+                              bool fReuseSeeds = false,
+                              bool fCandidatePairs = false,
+                              double dValidateSample = 1.0,
+                              bool fCompactOutput = false,
+                              double dStreamMemoryMB = 0.0,
+                              std::string strCheckpointFile = "",
+                              bool fRestart = false,
+                              double dCheckpointInterval = 600.0 );
 
 	// Compute the overlap mesh given a source and target mesh objects
 	// An overload method which takes as arguments the source and target meshes that are pre-loaded into memory
+	// If dStreamMemoryMB is positive the overlap mesh is streamed to strOverlapMesh within that memory budget
+	// and meshOverlap is left empty
 	int GenerateOverlapWithMeshes ( Mesh& meshA, Mesh& meshB,
 									Mesh& meshOverlap,
 									std::string strOverlapMesh,
@@ -78,7 +96,16 @@ extern "C" {
 									bool fHasConcaveFacesA = false,
 									bool fHasConcaveFacesB = false,
 									bool fAllowNoOverlap = false,
-									bool fVerbose = true );
+									bool fVerbose = true,
+									int nThreads = 1,
+									int nOutputDeflate = 0,
+									bool fReuseSeeds = false,
+									bool fCandidatePairs = false,
+									bool fCompactOutput = false,
+									double dStreamMemoryMB = 0.0,
+									std::string strCheckpointFile = "",
+									bool fRestart = false,
+									double dCheckpointInterval = 600.0 );
 
 	// New version of the implementation to compute the overlap mesh given a source and target mesh file names
 	int GenerateOverlapMesh_v1 ( std::string strMeshA, std::string strMeshB,
@@ -91,6 +118,9 @@ extern "C" {
 							  DataArray3D<int>& dataGLLnodes,
 							  DataArray3D<double>& dataGLLJacobian );
 
+	// If dMemoryLimitMB is positive the peak memory of each stage is estimated
+	// once the input and output meshes are loaded, and the thread count, face
+	// reordering and batch size of offlineMapOut are reduced to fit the limit
 	int GenerateOfflineMap ( OfflineMap& offlineMapOut,
 							 std::string strInputMesh, std::string strOutputMesh,
 							 std::string strOverlapMesh,
@@ -104,8 +134,27 @@ extern "C" {
 							 std::string strNColName = "", bool fOutputDouble = false,
                                                          std::string strOutputFormat ="Classic",
 							 std::string strPreserveVariables = "", bool fPreserveAll = false, double dFillValueOverride = 0.0,
-							 bool fInputConcave = false, bool fOutputConcave = false );
+							 bool fInputConcave = false, bool fOutputConcave = false,
+							 int nThreads = 1, bool fReorderFaces = false,
+							 bool fCachePrepared = false,
+							 double dPruneThreshold = 0.0, bool fPruneMasked = false,
+							 std::string strMapCacheDir = "",
+							 std::string strMethod = "conserve",
+							 std::string strCheckpointFile = "",
+							 bool fRestart = false,
+							 double dCheckpointInterval = 600.0,
+							 double dMemoryLimitMB = 0.0 );
 
+	// Face areas already stored in meshOverlap, such as those read from
+	// an overlap mesh file, are used without being recomputed
+	// If strMapCacheDir is set a map generated from identical meshes and
+	// options is linked from that directory to strOutputMap without being
+	// regenerated (leaving mapRemap empty), and new maps are added to it
+	// If strMethod is nn, bilin or patch a non-conservative map is generated
+	// from a finite volume input mesh and meshOverlap is not used
+	// If strCheckpointFile is set the partial finite volume to finite volume
+	// map is recorded every dCheckpointInterval seconds, and fRestart
+	// resumes from the records of an interrupted run
 	int GenerateOfflineMapWithMeshes ( OfflineMap& mapRemap,
 									   Mesh& meshInput, Mesh& meshOutput, Mesh& meshOverlap,
 									   std::string strInputMeta, std::string strOutputMeta,
@@ -116,10 +165,74 @@ extern "C" {
 									   std::string strVariables = "", std::string strOutputMap = "",
 									   std::string strInputData = "", std::string strOutputData = "",
 									   std::string strNColName = "", bool fOutputDouble = false,
+									   std::string strOutputFormat = "Classic",
 									   std::string strPreserveVariables = "", bool fPreserveAll = false, double dFillValueOverride = 0.0,
-									   bool fInputConcave = false, bool fOutputConcave = false );
+									   bool fInputConcave = false, bool fOutputConcave = false,
+									   int nThreads = 1, bool fReorderFaces = false,
+									   std::string strInputMetaCache = "", std::string strOutputMetaCache = "",
+									   std::string strInputPrepared = "",
+									   double dPruneThreshold = 0.0, bool fPruneMasked = false,
+									   std::string strMapCacheDir = "",
+									   std::string strMethod = "conserve",
+									   std::string strCheckpointFile = "",
+									   bool fRestart = false,
+									   double dCheckpointInterval = 600.0 );
+
+	// Generate the overlap mesh and the offline map in a single pass, keeping
+	// the overlap mesh in memory and writing it only if strOverlapMesh is set
+	int GenerateRemapWeights ( OfflineMap& mapRemap,
+							   std::string strInputMesh, std::string strOutputMesh,
+							   std::string strOverlapMesh = "",
+							   std::string strOverlapMethod = "exact",
+							   std::string strInputMeta = "", std::string strOutputMeta = "",
+							   std::string strInputType = "fv", std::string strOutputType = "fv",
+							   int nPin = 4, int nPout = 4,
+							   bool fBubble = false, int fMonotoneTypeID = 0,
+							   bool fVolumetric = false, bool fNoConservation = false, bool fNoCheck = false,
+							   bool fInputConcave = false, bool fOutputConcave = false,
+							   bool fAllowNoOverlap = false,
+							   std::string strOutputMap = "",
+							   std::string strOutputFormat = "Netcdf4",
+							   int nThreads = 1, bool fReorderFaces = false );
+
+	// Generate offline maps from one input mesh to each of a comma-separated
+	// list of output meshes, written to the corresponding comma-separated
+	// list of map files.  The input mesh is prepared once for all maps and
+	// up to nConcurrentTargets maps are generated at once
+	int GenerateRemapWeightsMultiTarget ( std::string strInputMesh,
+										  std::string strOutputMeshes,
+										  std::string strOutputMaps,
+										  std::string strOverlapMethod = "exact",
+										  std::string strInputMeta = "",
+										  std::string strInputType = "fv", std::string strOutputType = "fv",
+										  int nPin = 4, int nPout = 4,
+										  bool fBubble = false, int fMonotoneTypeID = 0,
+										  bool fVolumetric = false, bool fNoConservation = false, bool fNoCheck = false,
+										  bool fAllowNoOverlap = false,
+										  std::string strOutputFormat = "Netcdf4",
+										  int nOutputDeflate = 0, int nOutputQuantizeBits = 0,
+										  int nThreads = 1, int nConcurrentTargets = 1,
+										  bool fCacheFitArrays = false );
+
+	// Update a finite volume to finite volume offline map after a set of
+	// source or target faces has changed
+	int GenerateOfflineMapUpdate ( OfflineMap& mapRemap,
+								   std::string strInputMap,
+								   std::string strInputMesh, std::string strOutputMesh,
+								   std::string strOverlapMesh,
+								   std::string strChangedSourceFaces = "",
+								   std::string strChangedTargetFaces = "",
+								   int nPin = 4, bool fNoCheck = false,
+								   std::string strOutputMap = "",
+								   std::string strOutputFormat = "Netcdf4",
+								   bool fInputConcave = false, bool fOutputConcave = false,
+								   int nThreads = 1 );
 
-	// Apply an offline map to a datafile
+	// Apply an offline map to a datafile; if strMapCache is given the
+	// weights are attached from a map image in that directory, shared
+	// with other processes on the node.  strVectorVariables lists vector
+	// variables as eastward:northward component pairs (e.g. "U:V"), which
+	// are remapped through their Cartesian components
 	int ApplyOfflineMap(
 		std::string strInputData,
 		std::string strInputMap,
@@ -132,11 +245,100 @@ extern "C" {
 		bool fOutputDouble,
 		std::string strPreserveVariables,
 		bool fPreserveAll,
-		double dFillValueOverride
+		double dFillValueOverride,
+		int nThreads = 1,
+		std::string strInputMapNext = "",
+		bool fSinglePrecision = false,
+		bool fAsyncIO = false,
+		bool fDeviceApply = false,
+		std::string strMapCache = "",
+		std::string strVectorVariables = ""
+	);
+
+	// Apply an offline map to a batch of data files, read from a list
+	// file (lines of input and optional output file) and/or matched by a
+	// glob pattern, with unnamed outputs placed in strOutputDir.  The map
+	// is read once; under MPI files are handed out dynamically to ranks
+	int ApplyOfflineMapBatch(
+		std::string strInputDataList,
+		std::string strInputDataGlob,
+		std::string strOutputDir,
+		std::string strInputMap,
+		std::string strVariables,
+		std::string strNColName,
+		bool fOutputDouble,
+		std::string strPreserveVariables,
+		bool fPreserveAll,
+		double dFillValueOverride,
+		int nThreads = 1,
+		std::string strInputMapNext = "",
+		bool fSinglePrecision = false,
+		bool fAsyncIO = false,
+		bool fDeviceApply = false,
+		std::string strMapCache = "",
+		std::string strVectorVariables = ""
+	);
+
+	// Apply a loaded offline map to double precision fields held in
+	// caller-owned memory (strides in elements, no NetCDF I/O).  The array
+	// entry points use nThreads without changing the thread count of
+	// mapRemap, and return 0 on success, -1 on Exception, -2 otherwise
+	int ApplyOfflineMapToArray(
+		OfflineMap& mapRemap,
+		const double* pSource,
+		int nSourceCells,
+		ptrdiff_t sSourceFieldStride,
+		ptrdiff_t sSourceCellStride,
+		double* pTarget,
+		int nTargetCells,
+		ptrdiff_t sTargetFieldStride,
+		ptrdiff_t sTargetCellStride,
+		int nFields,
+		int nThreads = 1
+	);
+
+	// Apply a loaded offline map to single precision fields held in
+	// caller-owned memory (strides in elements, no NetCDF I/O)
+	int ApplyOfflineMapToArrayFloat(
+		OfflineMap& mapRemap,
+		const float* pSource,
+		int nSourceCells,
+		ptrdiff_t sSourceFieldStride,
+		ptrdiff_t sSourceCellStride,
+		float* pTarget,
+		int nTargetCells,
+		ptrdiff_t sTargetFieldStride,
+		ptrdiff_t sTargetCellStride,
+		int nFields,
+		int nThreads = 1
+	);
+
+	// Apply a loaded offline map to nFields double precision vector fields
+	// given by their eastward and northward components, each field stored
+	// contiguously, remapping the Cartesian components in a single pass
+	int ApplyOfflineMapVectorToArray(
+		OfflineMap& mapRemap,
+		const double* pSourceU,
+		const double* pSourceV,
+		int nSourceCells,
+		double* pTargetU,
+		double* pTargetV,
+		int nTargetCells,
+		int nFields,
+		int nThreads = 1
 	);
 
 	int GenerateConnectivityData ( Mesh& meshIn, std::vector< std::set<int> >& vecConnectivity );
 
+	// Generate the zero-based face adjacency of a mesh in compressed row
+	// form, with neighbors across edges or (fNodeAdjacency) across nodes;
+	// the edge map is not needed
+	int GenerateConnectivityDataCSR ( Mesh& meshIn,
+									  std::vector<int>& vecRowPtr,
+									  std::vector<int>& vecNeighbors,
+									  bool fNodeAdjacency = false,
+									  int nThreads = 1 );
+
 }
 
 #endif // TEMPESTREMAP_API_H
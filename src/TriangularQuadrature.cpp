@@ -16,6 +16,7 @@
 
 #include "TriangularQuadrature.h"
 #include "GaussQuadrature.h"
+#include "KeyedCache.h"
 
 #include <cstring>
 
@@ -234,3 +235,15 @@ TriangularQuadratureRule::TriangularQuadratureRule(
 
 ///////////////////////////////////////////////////////////////////////////////
 
+const TriangularQuadratureRule & TriangularQuadratureRule::Get(
+	int nOrder
+) {
+	static KeyedCache<int, TriangularQuadratureRule> s_cache;
+
+	return s_cache.Get(nOrder, [&]() -> TriangularQuadratureRule {
+		return TriangularQuadratureRule(nOrder);
+	});
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
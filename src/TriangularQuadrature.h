@@ -40,6 +40,16 @@ public:
 		int nOrder
 	);
 
+	///	<summary>
+	///		Return the TriangularQuadratureRule of the given order from a
+	///		process-wide cache.  The returned rule is constructed on first
+	///		use and remains valid for the lifetime of the program.  This
+	///		function may be called concurrently from multiple threads.
+	///	</summary>
+	static const TriangularQuadratureRule & Get(
+		int nOrder
+	);
+
 	///	<summary>
 	///		Get the number of points in the rule.
 	///	</summary>
@@ -18,9 +18,12 @@
 #include "CommandLine.h"
 #include "Exception.h"
 #include "GridElements.h"
+#include "OfflineMap.h"
+#include "OfflineMapCache.h"
 #include "OverlapMesh.h"
 
 #include <cmath>
+#include <cstdio>
 
 ///////////////////////////////////////////////////////////////////////////////
 
@@ -266,6 +269,85 @@ void TestEdgeIntersections04() {
 
 ///////////////////////////////////////////////////////////////////////////////
 
+void TestMapImageRoundTrip() {
+
+	const std::string strCacheDir = ".";
+	const std::string strSource = "UnitTestMapImage.dat";
+
+	// The image identifies, but does not read, its source map
+	FILE * fp = fopen(strSource.c_str(), "w");
+	if (fp == NULL) {
+		_EXCEPTIONT("TEST FAILED");
+	}
+	fprintf(fp, "UnitTest\n");
+	fclose(fp);
+
+	const std::string strImage =
+		OfflineMapImage::GetImagePath(strCacheDir, strSource);
+
+	DataArray1D<double> dAreas(2);
+	dAreas[0] = 0.5;
+	dAreas[1] = 1.5;
+
+	// (a) Map with entries
+	OfflineMap mapOut;
+	mapOut.SetSourceAreas(dAreas);
+	mapOut.SetTargetAreas(dAreas);
+
+	SparseMatrix<double> & smatOut = mapOut.GetSparseMatrix();
+	smatOut(0,0) = 0.25;
+	smatOut(0,1) = 0.75;
+	smatOut(1,1) = 1.0;
+
+	mapOut.WriteWeightsImage(strImage, strSource);
+
+	OfflineMap mapIn;
+	mapIn.ReadWeightsCached(strSource, strCacheDir);
+
+	const SparseMatrix<double> & smatIn = mapIn.GetSparseMatrix();
+
+	printf("(a) %lu nonzeros attached\n", smatIn.GetNonZeroCount());
+
+	if (!smatIn.IsFrozen() || (smatIn.GetNonZeroCount() != 3)) {
+		_EXCEPTIONT("TEST FAILED");
+	}
+
+	DataArray1D<int> dataRows;
+	DataArray1D<int> dataCols;
+	DataArray1D<double> dataEntries;
+	smatIn.GetEntries(dataRows, dataCols, dataEntries);
+
+	for (int k = 0; k < 3; k++) {
+		if (dataEntries[k] != smatOut(dataRows[k], dataCols[k])) {
+			_EXCEPTIONT("TEST FAILED");
+		}
+	}
+
+	// (b) Map without entries, attached in place of the map with entries
+	OfflineMap mapEmpty;
+	mapEmpty.SetSourceAreas(dAreas);
+	mapEmpty.SetTargetAreas(dAreas);
+	mapEmpty.WriteWeightsImage(strImage, strSource);
+
+	mapIn.ReadWeightsCached(strSource, strCacheDir);
+
+	printf("(b) %lu nonzeros attached\n", smatIn.GetNonZeroCount());
+
+	if ((smatIn.GetRows() != 0) || (smatIn.GetNonZeroCount() != 0)) {
+		_EXCEPTIONT("TEST FAILED");
+	}
+
+	smatIn.GetEntries(dataRows, dataCols, dataEntries);
+	if (dataEntries.GetRows() != 0) {
+		_EXCEPTIONT("TEST FAILED");
+	}
+
+	remove(strImage.c_str());
+	remove(strSource.c_str());
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
 int main(int argc, char** argv) {
 
 try {
@@ -283,6 +365,10 @@ try {
 	AnnounceBanner();
 	TestEdgeIntersections04();
 
+	// Test map images
+	AnnounceBanner();
+	TestMapImageRoundTrip();
+
 	AnnounceBanner();
 
 } catch(Exception & e) {
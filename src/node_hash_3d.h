@@ -0,0 +1,557 @@
+///////////////////////////////////////////////////////////////////////////////
+///
+///	\file    node_hash_3d.h
+///	\author  agent
+///	\version October 15, 2026
+///
+///	<remarks>
+///		Copyright 2026 agent
+///
+///		This file is distributed as part of the Tempest source code package.
+///		Permission is granted to use, copy, modify and distribute this
+///		source code and its documentation under the terms of the GNU General
+///		Public License.  This software is provided "as is" without express
+///		or implied warranty.
+///	</remarks>
+
+#ifndef _NODEHASH3D_H_
+#define _NODEHASH3D_H_
+
+#include <vector>
+#include <utility>
+#include <cmath>
+#include <cstddef>
+#include <algorithm>
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		Cell geometry shared by the spatial hashes in this file.  Nodes are
+///		binned into cubic cells of width cell_width, and two Nodes within
+///		tolerance of each other either share a cell or lie in neighboring
+///		cells along the axes for which they are within tolerance of the
+///		cell boundary.
+///	</summary>
+class node_cells_3d {
+protected:
+	///	<summary>
+	///		Index of a cell along each axis.
+	///	</summary>
+	struct cell_type {
+		long long i;
+		long long j;
+		long long k;
+	};
+
+protected:
+	///	<summary>
+	///		Constructor.
+	///	</summary>
+	node_cells_3d(
+		double tolerance,
+		double cell_width
+	) :
+		m_tolerance(tolerance),
+		m_cell_width(cell_width)
+	{ }
+
+	///	<summary>
+	///		Cell containing the given Node.
+	///	</summary>
+	template <class NodeType>
+	cell_type node_to_cell(
+		const NodeType & node
+	) const {
+		cell_type cell;
+		cell.i = static_cast<long long>(floor(node.x / m_cell_width));
+		cell.j = static_cast<long long>(floor(node.y / m_cell_width));
+		cell.k = static_cast<long long>(floor(node.z / m_cell_width));
+		return cell;
+	}
+
+	///	<summary>
+	///		Range of cells along one axis that may contain a coordinate
+	///		within tolerance of x, which lies in cell ix.
+	///	</summary>
+	void cell_range(
+		double x,
+		long long ix,
+		long long & ix_begin,
+		long long & ix_end
+	) const {
+		const double lower = static_cast<double>(ix) * m_cell_width;
+		const double upper = static_cast<double>(ix + 1) * m_cell_width;
+
+		ix_begin = ix;
+		ix_end = ix;
+
+		// Twice the tolerance guards against rounding in the cell bounds
+		if (x - lower < 2.0 * m_tolerance) {
+			ix_begin--;
+		}
+		if (upper - x < 2.0 * m_tolerance) {
+			ix_end++;
+		}
+	}
+
+	///	<summary>
+	///		Nonzero 64-bit hash of a cell.
+	///	</summary>
+	static unsigned long long hash_cell(
+		const cell_type & cell
+	) {
+		unsigned long long h =
+			  static_cast<unsigned long long>(cell.i) * 0x9E3779B97F4A7C15ULL
+			^ static_cast<unsigned long long>(cell.j) * 0xC2B2AE3D27D4EB4FULL
+			^ static_cast<unsigned long long>(cell.k) * 0x165667B19E3779F9ULL;
+
+		// Finalizer from splitmix64
+		h ^= (h >> 30);
+		h *= 0xBF58476D1CE4E5B9ULL;
+		h ^= (h >> 27);
+		h *= 0x94D049BB133111EBULL;
+		h ^= (h >> 31);
+
+		return (h == 0) ? 1 : h;
+	}
+
+	///	<summary>
+	///		Hashes of the cells that may hold a Node equal to the given Node,
+	///		starting with the cell containing it.  Returns the number of
+	///		cells, which is between 1 and 8.
+	///	</summary>
+	template <class NodeType>
+	int neighbor_cell_hashes(
+		const NodeType & node,
+		unsigned long long hashes[8]
+	) const {
+		const cell_type cell = node_to_cell(node);
+
+		// Range of cells along each axis that may hold an equal Node
+		long long range_begin[3];
+		long long range_end[3];
+
+		cell_range(node.x, cell.i, range_begin[0], range_end[0]);
+		cell_range(node.y, cell.j, range_begin[1], range_end[1]);
+		cell_range(node.z, cell.k, range_begin[2], range_end[2]);
+
+		int count = 1;
+		hashes[0] = hash_cell(cell);
+
+		cell_type cell_probe;
+		for (cell_probe.i = range_begin[0]; cell_probe.i <= range_end[0]; cell_probe.i++) {
+		for (cell_probe.j = range_begin[1]; cell_probe.j <= range_end[1]; cell_probe.j++) {
+		for (cell_probe.k = range_begin[2]; cell_probe.k <= range_end[2]; cell_probe.k++) {
+			if ((cell_probe.i != cell.i) ||
+			    (cell_probe.j != cell.j) ||
+			    (cell_probe.k != cell.k)
+			) {
+				hashes[count++] = hash_cell(cell_probe);
+			}
+		}
+		}
+		}
+
+		return count;
+	}
+
+protected:
+	///	<summary>
+	///		The internal floating point tolerance for comparing two Nodes.
+	///	</summary>
+	const double m_tolerance;
+
+	///	<summary>
+	///		The width of each cell.
+	///	</summary>
+	const double m_cell_width;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		An open-addressing spatial hash from Nodes to data with floating
+///		point tolerance.  Nodes are binned into cubic cells of width
+///		cell_width and each cell is hashed into a linearly probed table.
+///		A lookup also probes the neighboring cells along each axis for
+///		which the Node lies within tolerance of the cell boundary, so two
+///		Nodes compare equal exactly when NodeType::operator== says they
+///		do, and no coincident Nodes are ever stored.
+///	</summary>
+///	<remarks>
+///		Entries are stored contiguously in insertion order, and iteration
+///		visits them in that order.  As with std::unordered_map, insertion
+///		may invalidate iterators.  Concurrent calls to find() are safe;
+///		insertion requires exclusive access, so threads that build Nodes
+///		concurrently should each fill their own node_hash_3d.
+///	</remarks>
+template <
+	class NodeType,
+	class DataType
+> class node_hash_3d : protected node_cells_3d {
+public:
+	typedef std::pair<NodeType, DataType> value_type;
+
+	typedef typename std::vector<value_type>::const_iterator const_iterator;
+
+protected:
+	///	<summary>
+	///		A slot of the hash table.  A hash of zero marks an empty slot.
+	///	</summary>
+	struct slot_type {
+		unsigned long long hash;
+		size_t ix;
+	};
+
+	///	<summary>
+	///		Initial number of slots in the table (a power of two).
+	///	</summary>
+	static const size_t initial_slot_count = 64;
+
+public:
+	///	<summary>
+	///		Constructor.
+	///	</summary>
+	node_hash_3d(
+		double tolerance = 1.0e-12,
+		double cell_width = 1.0e-6
+	) :
+		node_cells_3d(tolerance, cell_width),
+		m_slots(initial_slot_count)
+	{
+		clear_slots();
+	}
+
+public:
+	///	<summary>
+	///		Begin const_iterator of this class.
+	///	</summary>
+	const_iterator begin() const {
+		return m_values.begin();
+	}
+
+	///	<summary>
+	///		End const_iterator of this class.
+	///	</summary>
+	const_iterator end() const {
+		return m_values.end();
+	}
+
+	///	<summary>
+	///		Number of Nodes stored in this object.
+	///	</summary>
+	size_t size() const {
+		return m_values.size();
+	}
+
+	///	<summary>
+	///		Remove all Nodes from this object.
+	///	</summary>
+	void clear() {
+		m_values.clear();
+		m_slots.resize(initial_slot_count);
+		clear_slots();
+	}
+
+	///	<summary>
+	///		Reserve space for the given number of Nodes.
+	///	</summary>
+	void reserve(
+		size_t count
+	) {
+		m_values.reserve(count);
+
+		size_t slot_count = m_slots.size();
+		while (slot_count < 2 * count) {
+			slot_count *= 2;
+		}
+		if (slot_count != m_slots.size()) {
+			rehash(slot_count);
+		}
+	}
+
+	///	<summary>
+	///		Insert a given <NodeType, DataType> pair if no equal Node is
+	///		already present.  Returns an iterator to the stored pair and
+	///		whether an insertion took place.
+	///	</summary>
+	std::pair<const_iterator, bool> insert(
+		const value_type & value
+	) {
+		const_iterator iter = find(value.first);
+		if (iter != end()) {
+			return std::pair<const_iterator, bool>(iter, false);
+		}
+
+		// Keep the load factor at or below one half
+		if (2 * (m_values.size() + 1) > m_slots.size()) {
+			rehash(2 * m_slots.size());
+		}
+
+		m_values.push_back(value);
+		insert_slot(hash_cell(node_to_cell(value.first)), m_values.size()-1);
+
+		return std::pair<const_iterator, bool>(end() - 1, true);
+	}
+
+	///	<summary>
+	///		Find a given Node.
+	///	</summary>
+	const_iterator find(
+		const NodeType & node
+	) const {
+		unsigned long long hashes[8];
+		const int count = neighbor_cell_hashes(node, hashes);
+
+		for (int c = 0; c < count; c++) {
+			size_t ix = find_in_cell(hashes[c], node);
+			if (ix != m_values.size()) {
+				return m_values.begin() + ix;
+			}
+		}
+
+		return m_values.end();
+	}
+
+protected:
+	///	<summary>
+	///		Index into m_values of a Node equal to node stored in the cell
+	///		with the given hash, or m_values.size() if there is none.
+	///	</summary>
+	size_t find_in_cell(
+		unsigned long long hash,
+		const NodeType & node
+	) const {
+		const size_t mask = m_slots.size() - 1;
+
+		size_t ix = static_cast<size_t>(hash) & mask;
+		for (;;) {
+			const slot_type & slot = m_slots[ix];
+			if (slot.hash == 0) {
+				return m_values.size();
+			}
+			if ((slot.hash == hash) && (m_values[slot.ix].first == node)) {
+				return slot.ix;
+			}
+			ix = (ix + 1) & mask;
+		}
+	}
+
+	///	<summary>
+	///		Store the index of an entry in the first free slot for its hash.
+	///	</summary>
+	void insert_slot(
+		unsigned long long hash,
+		size_t ix_value
+	) {
+		const size_t mask = m_slots.size() - 1;
+
+		size_t ix = static_cast<size_t>(hash) & mask;
+		while (m_slots[ix].hash != 0) {
+			ix = (ix + 1) & mask;
+		}
+
+		m_slots[ix].hash = hash;
+		m_slots[ix].ix = ix_value;
+	}
+
+	///	<summary>
+	///		Mark all slots as empty.
+	///	</summary>
+	void clear_slots() {
+		for (size_t i = 0; i < m_slots.size(); i++) {
+			m_slots[i].hash = 0;
+			m_slots[i].ix = 0;
+		}
+	}
+
+	///	<summary>
+	///		Rebuild the table with the given number of slots.
+	///	</summary>
+	void rehash(
+		size_t slot_count
+	) {
+		m_slots.resize(slot_count);
+		clear_slots();
+
+		for (size_t i = 0; i < m_values.size(); i++) {
+			insert_slot(hash_cell(node_to_cell(m_values[i].first)), i);
+		}
+	}
+
+private:
+	///	<summary>
+	///		Stored <NodeType, DataType> pairs in insertion order.
+	///	</summary>
+	std::vector<value_type> m_values;
+
+	///	<summary>
+	///		Open-addressing table of indices into m_values.
+	///	</summary>
+	std::vector<slot_type> m_slots;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+///	<summary>
+///		A read-only spatial binning of a vector of Nodes with floating
+///		point tolerance, sharing its cell geometry with node_hash_3d.  The
+///		Nodes are hashed by cell in parallel and counting sorted into
+///		buckets, within which they are kept in index order, so that the
+///		lowest-index Node equal to a given Node can be found by probing the
+///		same neighboring cells as node_hash_3d::find().
+///	</summary>
+///	<remarks>
+///		The vector of Nodes must outlive this object and not be modified
+///		while it is in use.  Concurrent calls to find_first() are safe.
+///	</remarks>
+template <
+	class NodeType
+> class node_bins_3d : protected node_cells_3d {
+
+public:
+	///	<summary>
+	///		Constructor.
+	///	</summary>
+	node_bins_3d(
+		const std::vector<NodeType> & nodes,
+		double tolerance = 1.0e-12,
+		double cell_width = 1.0e-6,
+		int nthreads = 1
+	) :
+		node_cells_3d(tolerance, cell_width),
+		m_nodes(nodes),
+		m_hashes(nodes.size())
+	{
+		const long count = static_cast<long>(nodes.size());
+
+		// Hash each Node by cell
+#pragma omp parallel for num_threads(nthreads)
+		for (long i = 0; i < count; i++) {
+			m_hashes[i] = hash_cell(node_to_cell(nodes[i]));
+		}
+
+		// Use at least as many buckets as Nodes (a power of two)
+		size_t bucket_count = 1;
+		while (bucket_count < nodes.size()) {
+			bucket_count *= 2;
+		}
+		m_mask = bucket_count - 1;
+
+		// Counting sort of Node indices by bucket
+		m_offsets.resize(bucket_count + 1, 0);
+		for (size_t i = 0; i < nodes.size(); i++) {
+			m_offsets[(m_hashes[i] & m_mask) + 1]++;
+		}
+		for (size_t b = 0; b < bucket_count; b++) {
+			m_offsets[b+1] += m_offsets[b];
+		}
+
+		std::vector<size_t> fill(m_offsets.begin(), m_offsets.end() - 1);
+
+		m_entries.resize(nodes.size());
+		for (size_t i = 0; i < nodes.size(); i++) {
+			m_entries[fill[m_hashes[i] & m_mask]++] = i;
+		}
+	}
+
+public:
+	///	<summary>
+	///		Number of Nodes binned by this object.
+	///	</summary>
+	size_t size() const {
+		return m_nodes.size();
+	}
+
+	///	<summary>
+	///		Index of the first Node, among the first ix_end Nodes, that is
+	///		equal to the given Node, or size() if there is none.
+	///	</summary>
+	size_t find_first(
+		const NodeType & node,
+		size_t ix_end
+	) const {
+		return find_first_if(node, ix_end, accept_all());
+	}
+
+	///	<summary>
+	///		Index of the first Node, among the first ix_end Nodes, that is
+	///		equal to the given Node and whose index satisfies pred, or size()
+	///		if there is none.
+	///	</summary>
+	template <class Predicate>
+	size_t find_first_if(
+		const NodeType & node,
+		size_t ix_end,
+		Predicate pred
+	) const {
+		unsigned long long hashes[8];
+		const int count = neighbor_cell_hashes(node, hashes);
+
+		size_t ix_first = std::min(ix_end, m_nodes.size());
+
+		for (int c = 0; c < count; c++) {
+			const size_t b = static_cast<size_t>(hashes[c]) & m_mask;
+
+			for (size_t e = m_offsets[b]; e < m_offsets[b+1]; e++) {
+				const size_t ix = m_entries[e];
+				if (ix >= ix_first) {
+					break;
+				}
+				if ((m_hashes[ix] == hashes[c]) &&
+				    (m_nodes[ix] == node) &&
+				    (pred(ix))
+				) {
+					ix_first = ix;
+					break;
+				}
+			}
+		}
+
+		if (ix_first >= std::min(ix_end, m_nodes.size())) {
+			return m_nodes.size();
+		}
+		return ix_first;
+	}
+
+protected:
+	///	<summary>
+	///		Predicate accepting every Node index.
+	///	</summary>
+	struct accept_all {
+		bool operator()(size_t) const {
+			return true;
+		}
+	};
+
+private:
+	///	<summary>
+	///		The binned Nodes.
+	///	</summary>
+	const std::vector<NodeType> & m_nodes;
+
+	///	<summary>
+	///		Hash of the cell containing each Node.
+	///	</summary>
+	std::vector<unsigned long long> m_hashes;
+
+	///	<summary>
+	///		Bucket mask (number of buckets minus one).
+	///	</summary>
+	size_t m_mask;
+
+	///	<summary>
+	///		Offset of each bucket in m_entries.
+	///	</summary>
+	std::vector<size_t> m_offsets;
+
+	///	<summary>
+	///		Node indices sorted by bucket, in index order within a bucket.
+	///	</summary>
+	std::vector<size_t> m_entries;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+#endif //_NODEHASH3D_H_
+
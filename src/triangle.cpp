@@ -644,17 +644,20 @@ struct memorypool {
 
 
 /* Global constants.                                                         */
+/*                                                                           */
+/*  These are set by every call to triangulate(), and so are thread_local so */
+/*  that separate threads may triangulate concurrently.                      */
 
-REAL splitter;       /* Used to split REAL factors for exact multiplication. */
-REAL epsilon;                             /* Floating-point machine epsilon. */
-REAL resulterrbound;
-REAL ccwerrboundA, ccwerrboundB, ccwerrboundC;
-REAL iccerrboundA, iccerrboundB, iccerrboundC;
-REAL o3derrboundA, o3derrboundB, o3derrboundC;
+thread_local REAL splitter;       /* Used to split REAL factors for exact multiplication. */
+thread_local REAL epsilon;                             /* Floating-point machine epsilon. */
+thread_local REAL resulterrbound;
+thread_local REAL ccwerrboundA, ccwerrboundB, ccwerrboundC;
+thread_local REAL iccerrboundA, iccerrboundB, iccerrboundC;
+thread_local REAL o3derrboundA, o3derrboundB, o3derrboundC;
 
 /* Random number seed is not constant, but I've made it global anyway.       */
 
-unsigned long randomseed;                     /* Current random number seed. */
+thread_local unsigned long randomseed;                     /* Current random number seed. */
 
 
 /* Mesh data structure.  Triangle operates on only one mesh, but the mesh    */
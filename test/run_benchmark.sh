@@ -0,0 +1,10 @@
+#!/bin/sh
+
+# Finite volume to finite volume, fuzzy vs exact overlap, np=2..4
+../bin/BenchmarkRemap --src_mesh cs --src_res 32 --tgt_mesh rll --tgt_res 90 --in_type fv --out_type fv --in_np 2,3,4 --out_np 1 --method fuzzy,exact --repeat 3 --out benchmark_fvtofv_cs32_rll90.json
+
+# Finite volume to spectral element
+../bin/BenchmarkRemap --src_mesh rll --src_res 90 --tgt_mesh cs --tgt_res 30 --in_type fv --out_type cgll --in_np 2 --out_np 2,3,4 --method exact --repeat 3 --out benchmark_fvtogll_rll90_cs30.json
+
+# Spectral element to spectral element
+../bin/BenchmarkRemap --src_mesh cs --src_res 30 --tgt_mesh cs --tgt_res 16 --in_type cgll --out_type cgll --in_np 2,3,4 --out_np 4 --method exact --repeat 3 --out benchmark_glltogll_cs30_cs16.json
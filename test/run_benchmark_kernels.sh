@@ -0,0 +1,7 @@
+#!/bin/sh
+
+# All kernels on a cubed-sphere / latitude-longitude overlap
+../bin/BenchmarkKernels --src_mesh cs --src_res 32 --tgt_mesh rll --tgt_res 90 --repeat 5 --fields 8 --out benchmark_kernels_cs32_rll90.json
+
+# Geometric kernels on nested cubed-sphere meshes (many coincident edges)
+../bin/BenchmarkKernels --src_mesh cs --src_res 16 --tgt_mesh cs --tgt_res 32 --kernels edge_intersections,contains_node,overlap_face --repeat 5 --out benchmark_kernels_cs16_cs32.json
@@ -0,0 +1,33 @@
+#!/bin/sh
+
+rm -rf testdata_composedmap_cs_diffnorms_1.txt
+rm -rf testdata_composedmap_cs_diffnorms_2.txt
+
+time ../bin/GenerateCSMesh --res 30 --file outCSne30.g
+time ../bin/GenerateCSMesh --res 15 --file outCSne15.g
+time ../bin/GenerateICOMesh --res 72 --file outICO72.g
+time ../bin/GenerateOverlapMesh --a outCSne30.g --b outICO72.g --out overlap_CSne30_ICO72.g
+time ../bin/GenerateOverlapMesh --a outICO72.g --b outCSne15.g --out overlap_ICO72_CSne15.g
+
+time ../bin/GenerateTestData --mesh outCSne30.g --test 1 --out testdata_CSne30_1.nc
+time ../bin/GenerateTestData --mesh outCSne30.g --test 2 --out testdata_CSne30_2.nc
+
+time ../bin/GenerateOfflineMap --in_mesh outCSne30.g --out_mesh outICO72.g --ov_mesh overlap_CSne30_ICO72.g --in_np 2 --in_type fv --out_type fv --out_map map_CSne30_ICO72_np2.nc
+time ../bin/GenerateOfflineMap --in_mesh outICO72.g --out_mesh outCSne15.g --ov_mesh overlap_ICO72_CSne15.g --in_np 2 --in_type fv --out_type fv --out_map map_ICO72_CSne15_np2.nc
+
+# GenerateComposedMap verifies the consistency and conservation of the composed map
+time ../bin/GenerateComposedMap --map1 map_CSne30_ICO72_np2.nc --map2 map_ICO72_CSne15_np2.nc --out map_CSne30_CSne15_composed.nc
+
+# Two maps applied one after the other
+time ../bin/ApplyOfflineMap --map map_CSne30_ICO72_np2.nc --var Psi --in_data testdata_CSne30_1.nc --out_data testdata_CSne30_ICO72_np2_1.nc
+time ../bin/ApplyOfflineMap --map map_ICO72_CSne15_np2.nc --var Psi --in_data testdata_CSne30_ICO72_np2_1.nc --out_data testdata_CSne30_ICO72_CSne15_np2_1.nc
+time ../bin/ApplyOfflineMap --map map_CSne30_ICO72_np2.nc --var Psi --in_data testdata_CSne30_2.nc --out_data testdata_CSne30_ICO72_np2_2.nc
+time ../bin/ApplyOfflineMap --map map_ICO72_CSne15_np2.nc --var Psi --in_data testdata_CSne30_ICO72_np2_2.nc --out_data testdata_CSne30_ICO72_CSne15_np2_2.nc
+
+# Composed map
+time ../bin/ApplyOfflineMap --map map_CSne30_CSne15_composed.nc --var Psi --in_data testdata_CSne30_1.nc --out_data testdata_CSne30_CSne15_composed_1.nc
+time ../bin/ApplyOfflineMap --map map_CSne30_CSne15_composed.nc --var Psi --in_data testdata_CSne30_2.nc --out_data testdata_CSne30_CSne15_composed_2.nc
+
+../bin/CalculateDiffNorms --a testdata_CSne30_CSne15_composed_1.nc --b testdata_CSne30_ICO72_CSne15_np2_1.nc --mesh outCSne15.g --outfile testdata_composedmap_cs_diffnorms_1.txt
+../bin/CalculateDiffNorms --a testdata_CSne30_CSne15_composed_2.nc --b testdata_CSne30_ICO72_CSne15_np2_2.nc --mesh outCSne15.g --outfile testdata_composedmap_cs_diffnorms_2.txt
+
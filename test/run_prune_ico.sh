@@ -0,0 +1,35 @@
+#!/bin/sh
+
+rm -rf testdata_prune_ico_diffnorms_1.txt
+rm -rf testdata_prune_ico_diffnorms_4.txt
+
+time ../bin/GenerateCSMesh --res 15 --file outCSne15.g
+time ../bin/GenerateICOMesh --res 72 --file outICO72.g
+time ../bin/GenerateOverlapMesh --a outCSne15.g --b outICO72.g --out overlap_CSne15_ICO72.g
+
+time ../bin/GenerateTestData --mesh outCSne15.g --test 1 --out testdata_CSne15_1.nc
+time ../bin/GenerateTestData --mesh outCSne15.g --test 4 --out testdata_CSne15_4.nc
+time ../bin/GenerateTestData --mesh outICO72.g --test 1 --out testdata_ICO72_1.nc
+
+time ../bin/GenerateOfflineMap --in_mesh outCSne15.g --out_mesh outICO72.g --ov_mesh overlap_CSne15_ICO72.g --in_np 2 --in_type fv --out_type fv --out_map map_CSne15_ICO72_np2.nc
+
+# PruneOfflineMap verifies the consistency and conservation of the pruned map
+time ../bin/PruneOfflineMap --in map_CSne15_ICO72_np2.nc --out map_CSne15_ICO72_np2_pruned.nc --threshold 1.0e-3
+
+time ../bin/ApplyOfflineMap --map map_CSne15_ICO72_np2.nc --var Psi --in_data testdata_CSne15_1.nc --out_data testdata_CSne15_ICO72_np2_1.nc
+time ../bin/ApplyOfflineMap --map map_CSne15_ICO72_np2_pruned.nc --var Psi --in_data testdata_CSne15_1.nc --out_data testdata_CSne15_ICO72_np2_pruned_1.nc
+time ../bin/ApplyOfflineMap --map map_CSne15_ICO72_np2.nc --var Psi --in_data testdata_CSne15_4.nc --out_data testdata_CSne15_ICO72_np2_4.nc
+time ../bin/ApplyOfflineMap --map map_CSne15_ICO72_np2_pruned.nc --var Psi --in_data testdata_CSne15_4.nc --out_data testdata_CSne15_ICO72_np2_pruned_4.nc
+
+# Pruned and full maps against the analytic field
+../bin/CalculateDiffNorms --a testdata_CSne15_ICO72_np2_1.nc --b testdata_ICO72_1.nc --mesh outICO72.g --outfile testdata_prune_ico_diffnorms_1.txt
+../bin/CalculateDiffNorms --a testdata_CSne15_ICO72_np2_pruned_1.nc --b testdata_ICO72_1.nc --mesh outICO72.g --outfile testdata_prune_ico_diffnorms_1.txt
+
+# Column sums are preserved, so the global integrals (L1 sums of the positive
+# reference field) of the pruned and full map output agree
+../bin/CalculateDiffNorms --a testdata_CSne15_ICO72_np2_pruned_1.nc --b testdata_CSne15_ICO72_np2_1.nc --mesh outICO72.g
+../bin/CalculateDiffNorms --a testdata_CSne15_ICO72_np2_1.nc --b testdata_CSne15_ICO72_np2_pruned_1.nc --mesh outICO72.g
+
+# Row sums are preserved, so a constant field is remapped as by the full map
+../bin/CalculateDiffNorms --a testdata_CSne15_ICO72_np2_pruned_4.nc --b testdata_CSne15_ICO72_np2_4.nc --mesh outICO72.g --outfile testdata_prune_ico_diffnorms_4.txt
+
@@ -0,0 +1,29 @@
+#!/bin/sh
+
+rm -rf testdata_submap_rll_diffnorms_1.txt
+
+time ../bin/GenerateCSMesh --res 30 --file outCSne30.g
+time ../bin/GenerateRLLMesh --lon 360 --lat 180 --file outRLL1deg.g
+time ../bin/GenerateRLLMesh --lon 60 --lat 30 --lon_begin 0 --lon_end 60 --lat_begin 0 --lat_end 30 --file outRLL1deg_box.g
+time ../bin/GenerateOverlapMesh --a outCSne30.g --b outRLL1deg.g --out overlap_CSne30_RLL1deg.g
+time ../bin/GenerateOverlapMesh --a outRLL1deg.g --b outRLL1deg.g --out overlap_RLL1deg_RLL1deg.g
+
+time ../bin/GenerateTestData --mesh outCSne30.g --test 1 --out testdata_CSne30_1.nc
+
+time ../bin/GenerateOfflineMap --in_mesh outCSne30.g --out_mesh outRLL1deg.g --ov_mesh overlap_CSne30_RLL1deg.g --in_np 2 --in_type fv --out_type fv --out_map map_CSne30_RLL1deg_np2.nc
+
+# Identity map, whose sub-map selects the same target cells from remapped data
+time ../bin/GenerateOfflineMap --in_mesh outRLL1deg.g --out_mesh outRLL1deg.g --ov_mesh overlap_RLL1deg_RLL1deg.g --in_np 1 --in_type fv --out_type fv --out_map map_RLL1deg_RLL1deg.nc
+
+time ../bin/GenerateSubMap --in map_CSne30_RLL1deg_np2.nc --out map_CSne30_RLL1deg_np2_box.nc --box 0,60,0,30
+time ../bin/GenerateSubMap --in map_RLL1deg_RLL1deg.nc --out map_RLL1deg_RLL1deg_box.nc --box 0,60,0,30
+
+# Full map followed by the selection of the target cells in the box
+time ../bin/ApplyOfflineMap --map map_CSne30_RLL1deg_np2.nc --var Psi --in_data testdata_CSne30_1.nc --out_data testdata_CSne30_RLL1deg_np2_1.nc
+time ../bin/ApplyOfflineMap --map map_RLL1deg_RLL1deg_box.nc --var Psi --in_data testdata_CSne30_RLL1deg_np2_1.nc --out_data testdata_CSne30_RLL1deg_np2_box_full_1.nc
+
+# Sub-map
+time ../bin/ApplyOfflineMap --map map_CSne30_RLL1deg_np2_box.nc --var Psi --in_data testdata_CSne30_1.nc --out_data testdata_CSne30_RLL1deg_np2_box_1.nc
+
+../bin/CalculateDiffNorms --a testdata_CSne30_RLL1deg_np2_box_1.nc --b testdata_CSne30_RLL1deg_np2_box_full_1.nc --mesh outRLL1deg_box.g --outfile testdata_submap_rll_diffnorms_1.txt
+